@@ -1,6 +1,9 @@
 #!/bin/bash
 
-cargo build --release 
+# The Renode model needs RX without DMA: ./build.sh --features renode
+# BlackPill with a second shell on USB CDC-ACM: ./build.sh --features usb-cdc
+# BlackPill in STOP mode while the shell is idle: ./build.sh --features low-power
+cargo build --release "$@"
 
 # Create binary file for Renode
 cargo objcopy --release -- -O binary target/thumbv7em-none-eabihf/release/stm32f4-embassy-shell.bin
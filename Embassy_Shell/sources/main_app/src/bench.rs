@@ -0,0 +1,193 @@
+// bench.rs
+//
+// `bench` command: on-target microbenchmarks in DWT cycles, the executor
+// rows of the C++ shells' bench (same names and columns, compared by
+// ushell_core/tools/bench_matrix.py).
+//
+//   bench 0         every benchmark, one line each
+//   bench <n>       only the n-th
+//
+// The command runs in the shell task and must not wait, so it only hands the
+// request to `bench_task`, whose lines follow the prompt. Each benchmark runs
+// BENCH_SAMPLES times: min, median and max cycles, less the cost of reading
+// the counter twice.
+//
+//   queue round trip   a Signal to `bench_peer_task` and its answer back:
+//                      two wakes, two polls
+//   ctx switch         a Signal to `bench_peer_task` until it is polled
+//   irq->task          a software pended IRQ (SPI2, unused) whose handler
+//                      signals the same task, until it is polled: entry,
+//                      handler, executor
+
+use core::sync::atomic::{AtomicU32, Ordering};
+
+use cortex_m::peripheral::DWT;
+use embassy_executor::Spawner;
+use embassy_stm32::interrupt;
+use embassy_stm32::interrupt::InterruptExt;
+use embassy_sync::blocking_mutex::raw::CriticalSectionRawMutex;
+use embassy_sync::signal::Signal;
+use embassy_time::{with_timeout, Duration};
+use ushell2::log_simple;
+
+/// Odd: the median is a sample.
+const BENCH_SAMPLES: usize = 31;
+
+const BENCH_NAMES: [&str; 3] = ["queue round trip", "ctx switch", "irq->task"];
+
+/// The SYSCLK of main(): 96 MHz with the usb-cdc clock tree, else the 16 MHz HSI.
+#[cfg(feature = "usb-cdc")]
+const CPU_MHZ: u32 = 96;
+#[cfg(not(feature = "usb-cdc"))]
+const CPU_MHZ: u32 = 16;
+
+const REPLY_TIMEOUT: Duration = Duration::from_millis(100);
+
+#[derive(Clone, Copy)]
+enum Request {
+    Echo(u32),
+    Wake,
+}
+
+/// `bench <n>` for `bench_task`.
+static BENCH_REQUEST: Signal<CriticalSectionRawMutex, u32> = Signal::new();
+
+/// To `bench_peer_task`, from `bench_task` or from the SPI2 handler.
+static PEER_REQUEST: Signal<CriticalSectionRawMutex, Request> = Signal::new();
+
+/// The answers of `bench_peer_task`.
+static PEER_REPLY: Signal<CriticalSectionRawMutex, u32> = Signal::new();
+
+/// CYCCNT of the signal or of the pend.
+static WAKE_STAMP: AtomicU32 = AtomicU32::new(0);
+
+// ============================================================================
+// Setup and command
+// ============================================================================
+
+/// Start the cycle counter, enable the IRQ and spawn the two bench tasks.
+pub fn bench_init(spawner: &Spawner) {
+    // Safety: DCB and DWT are used here only, the rest of the core
+    // peripherals are not touched.
+    let mut core = unsafe { cortex_m::Peripherals::steal() };
+    core.DCB.enable_trace();
+    core.DWT.enable_cycle_counter();
+
+    // Safety: the SPI2 handler below only signals, SPI2 itself is unused.
+    unsafe { interrupt::SPI2.enable() };
+
+    spawner
+        .spawn(bench_task())
+        .expect("Failed to spawn bench_task");
+    spawner
+        .spawn(bench_peer_task())
+        .expect("Failed to spawn bench_peer_task");
+}
+
+/// bench 0 runs every benchmark, bench n only the n-th.
+pub fn bench(index: u32) {
+    if index as usize > BENCH_NAMES.len() {
+        log_simple!("bench: 1..{}, 0 for all", BENCH_NAMES.len());
+        return;
+    }
+    BENCH_REQUEST.signal(index);
+}
+
+// ============================================================================
+// Tasks and IRQ
+// ============================================================================
+
+#[embassy_executor::task]
+async fn bench_task() {
+    let mut samples = [0u32; BENCH_SAMPLES];
+
+    loop {
+        let index = BENCH_REQUEST.wait().await as usize;
+        let overhead = calibrate();
+
+        log_simple!(
+            "{:>2} {:<18} {:>8} {:>8} {:>8}  (cycles at {} MHz, {} samples)",
+            "#", "bench", "min", "median", "max", CPU_MHZ, BENCH_SAMPLES
+        );
+        for (i, name) in BENCH_NAMES.iter().enumerate() {
+            if index != 0 && index - 1 != i {
+                continue;
+            }
+            let mut failed = false;
+            for sample in samples.iter_mut() {
+                match run(i).await {
+                    Some(cycles) => *sample = cycles.saturating_sub(overhead),
+                    None => {
+                        failed = true;
+                        break;
+                    }
+                }
+            }
+            if failed {
+                log_simple!("{:>2} {:<18} {:>8}", i + 1, name, "failed");
+                continue;
+            }
+            samples.sort_unstable();
+            log_simple!(
+                "{:>2} {:<18} {:>8} {:>8} {:>8}",
+                i + 1, name, samples[0], samples[BENCH_SAMPLES / 2], samples[BENCH_SAMPLES - 1]
+            );
+        }
+    }
+}
+
+/// Echoes, or answers the cycles since the wake stamp.
+#[embassy_executor::task]
+async fn bench_peer_task() {
+    loop {
+        let reply = match PEER_REQUEST.wait().await {
+            Request::Echo(value) => value,
+            Request::Wake => DWT::cycle_count().wrapping_sub(WAKE_STAMP.load(Ordering::Relaxed)),
+        };
+        PEER_REPLY.signal(reply);
+    }
+}
+
+#[interrupt]
+fn SPI2() {
+    PEER_REQUEST.signal(Request::Wake);
+}
+
+// ============================================================================
+// The benchmarks
+// ============================================================================
+
+/// Two reads of the counter back to back, taken off every sample.
+fn calibrate() -> u32 {
+    (0..8)
+        .map(|_| {
+            let start = DWT::cycle_count();
+            DWT::cycle_count().wrapping_sub(start)
+        })
+        .min()
+        .unwrap_or(0)
+}
+
+/// One sample of the i-th benchmark, `None` if it could not be taken.
+async fn run(i: usize) -> Option<u32> {
+    PEER_REPLY.reset();
+    match i {
+        0 => {
+            let start = DWT::cycle_count();
+            PEER_REQUEST.signal(Request::Echo(start));
+            let echo = with_timeout(REPLY_TIMEOUT, PEER_REPLY.wait()).await.ok()?;
+            let cycles = DWT::cycle_count().wrapping_sub(start);
+            (echo == start).then_some(cycles)
+        }
+        1 => {
+            WAKE_STAMP.store(DWT::cycle_count(), Ordering::Relaxed);
+            PEER_REQUEST.signal(Request::Wake);
+            with_timeout(REPLY_TIMEOUT, PEER_REPLY.wait()).await.ok()
+        }
+        _ => {
+            WAKE_STAMP.store(DWT::cycle_count(), Ordering::Relaxed);
+            interrupt::SPI2.pend();
+            with_timeout(REPLY_TIMEOUT, PEER_REPLY.wait()).await.ok()
+        }
+    }
+}
@@ -0,0 +1,150 @@
+// load.rs
+//
+// `load` command: the CPU load from the idle count, the meter of the C++
+// shells' load_meter (same lines).
+//
+//   load 0          the load of the last second, the 10 s and 60 s averages
+//
+// `load_task` counts its turns: each one yields to the executor, which polls
+// every woken task before the next turn, so a busy second counts less. The
+// first second calibrates what an idle second counts (raised when a later one
+// counts more), the load is the part of it the second did not count. Seconds
+// without a turn (a task which did not yield) are full load. The averages are
+// exponential ones, updated once a second.
+//
+// The counting keeps the executor from sleeping: no wfe while the meter runs,
+// so the `low-power` build does not spawn it.
+
+#![cfg_attr(feature = "low-power", allow(dead_code))]
+
+use core::cell::Cell;
+use core::future::Future;
+use core::pin::Pin;
+use core::task::{Context, Poll};
+
+use embassy_executor::Spawner;
+use embassy_sync::blocking_mutex::raw::CriticalSectionRawMutex;
+use embassy_sync::blocking_mutex::Mutex;
+use embassy_time::{Duration, Instant};
+use ushell2::log_simple;
+
+/// (1 - e^(-1/n)) * 1024: the part of the difference a second adds to the n s average.
+const ALPHA_10: i32 = 97;
+const ALPHA_60: i32 = 17;
+
+/// The 60 s average has settled after a gap this long.
+const SECONDS_MAX: u32 = 300;
+
+#[derive(Clone, Copy)]
+struct Meter {
+    calib: u32,     // turns in an idle second, 0 before the first one
+    turns: u32,     // of the last second
+    load: u32,      // of the last second, per mille
+    avg10: i32,     // per mille << 10
+    avg60: i32,
+    seconds: u32,   // since the calibration
+}
+
+static METER: Mutex<CriticalSectionRawMutex, Cell<Meter>> = Mutex::new(Cell::new(Meter {
+    calib: 0, turns: 0, load: 0, avg10: 0, avg60: 0, seconds: 0,
+}));
+
+/// Pending once: the task is woken again at once, behind the others.
+struct YieldNow(bool);
+
+impl Future for YieldNow {
+    type Output = ();
+
+    fn poll(mut self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<()> {
+        if self.0 {
+            return Poll::Ready(());
+        }
+        self.0 = true;
+        cx.waker().wake_by_ref();
+        Poll::Pending
+    }
+}
+
+fn average(avg: &mut i32, sample: u32, alpha: i32) {
+    *avg += (((sample as i32) << 10) - *avg) * alpha / 1024;
+}
+
+/// The turns of `seconds` (more than one: the task did not run in between).
+fn second(turns: u32, seconds: u32) {
+    METER.lock(|cell| {
+        let mut m = cell.get();
+        let per_second = turns / seconds;
+        let first = m.calib == 0;
+
+        if per_second > m.calib {
+            m.calib = per_second;
+        }
+        let full = m.calib as u64 * seconds as u64;
+        let idle = (turns as u64 * 1000 + full / 2) / full.max(1);
+        m.load = if idle < 1000 { 1000 - idle as u32 } else { 0 };
+        m.turns = per_second;
+
+        if first {
+            m.avg10 = (m.load as i32) << 10;
+            m.avg60 = (m.load as i32) << 10;
+        }
+        for _ in 0..seconds.min(SECONDS_MAX) {
+            average(&mut m.avg10, m.load, ALPHA_10);
+            average(&mut m.avg60, m.load, ALPHA_60);
+        }
+        m.seconds += seconds;
+        cell.set(m);
+    });
+}
+
+#[embassy_executor::task]
+async fn load_task() {
+    let mut start = Instant::now();
+    let mut turns: u32 = 0;
+
+    loop {
+        turns = turns.wrapping_add(1);
+        let seconds = start.elapsed().as_secs() as u32;
+        if seconds > 0 {
+            second(turns, seconds);
+            start += Duration::from_secs(seconds as u64);
+            turns = 0;
+        }
+        YieldNow(false).await;
+    }
+}
+
+/// From main, with the other tasks.
+pub fn load_init(spawner: &Spawner) {
+    #[cfg(not(feature = "low-power"))]
+    spawner
+        .spawn(load_task())
+        .expect("Failed to spawn load_task");
+    #[cfg(feature = "low-power")]
+    let _ = spawner;
+}
+
+/// load 0 prints the loads; there is no LCD on this board.
+pub fn load(action: u32) {
+    if action != 0 {
+        log_simple!("load: no LCD, 0 prints");
+        return;
+    }
+    if cfg!(feature = "low-power") {
+        log_simple!("load: no meter in the low-power build");
+        return;
+    }
+    let m = METER.lock(|cell| cell.get());
+
+    if m.calib == 0 {
+        log_simple!("load: calibrating, the first second");
+        return;
+    }
+    let avg10 = ((m.avg10 + 512) >> 10) as u32;
+    let avg60 = ((m.avg60 + 512) >> 10) as u32;
+    log_simple!(
+        "Load: {}.{} % (1 s)  {}.{} % (10 s)  {}.{} % (60 s)",
+        m.load / 10, m.load % 10, avg10 / 10, avg10 % 10, avg60 / 10, avg60 % 10
+    );
+    log_simple!("Idle turns: {}/s of {}/s, over {} s", m.turns, m.calib, m.seconds);
+}
@@ -17,9 +17,9 @@ use ushell_dispatcher::{generate_commands_dispatcher, generate_shortcuts_dispatc
 use ushell_usercode::commands as uc;
 use ushell_usercode::shortcuts as us;
 
-use ushell2::runner::{run_shell, AsyncReader, ShellConfig};
+use ushell2::runner::{run_shell, ShellConfig, WaitReader};
 use ushell2::{log_info, log_simple};
-use ushell2::logger::{init_logger, LogLevel, LoggerConfig};
+use ushell2::logger::{drain_logs, init_logger, set_drain_notify, LogLevel, LoggerConfig};
 
 use uart_hal::{
     uart_flush, uart_write,
@@ -28,6 +28,24 @@ use uart_hal::{
     UartWriter,
 };
 
+mod bench;
+mod load;
+
+#[cfg(feature = "usb-cdc")]
+use embassy_futures::join::join;
+#[cfg(feature = "usb-cdc")]
+use usb_hal::{usb_cdc_init, usb_cdc_task, usb_device_task, usb_flush, usb_write, USB_RX_CHANNEL};
+
+#[cfg(feature = "low-power")]
+use embassy_time::{Duration, Instant};
+#[cfg(feature = "low-power")]
+use uart_hal::UART_RX_ACTIVITY;
+
+#[cfg(all(feature = "low-power", feature = "renode"))]
+compile_error!("low-power: Renode models neither STOP mode nor the RTC wake-up");
+#[cfg(all(feature = "low-power", feature = "usb-cdc"))]
+compile_error!("low-power: the OTG FS core loses its 48 MHz in STOP mode");
+
 // ============================================================================
 // Shell Configuration Constants
 // All of these are tuning knobs for the shell runtime. Adjust as needed.
@@ -39,6 +57,16 @@ pub const MAX_HEXSTR_LEN: usize = 64;
 pub const MAX_HISTORY_CAPACITY: usize = 256;
 pub const MAX_ERROR_BUFFER_SIZE: usize = 32;
 
+// The low-power executor stops the core only when the next timer is further
+// away than the RTC wake-up can serve; `awake_task` keeps a timer this close
+// while the shell is in use, so its input goes to the DMA ring at full speed.
+#[cfg(feature = "low-power")]
+const AWAKE_TICK: Duration = Duration::from_millis(50);
+// Awake this long after the last byte, then STOP until the next one (whose
+// start bit wakes the core; that first byte is lost).
+#[cfg(feature = "low-power")]
+const AWAKE_AFTER_INPUT: Duration = Duration::from_secs(30);
+
 // ============================================================================
 // Shell Dispatcher Code Generation
 // ============================================================================
@@ -67,28 +95,136 @@ bind_interrupts!(struct Irqs {
 // at the call site. The underlying value is only written once, at startup.
 // ============================================================================
 
-static UART_WRITER: StaticCell<UartWriter> = StaticCell::new();
+static CONSOLE_WRITER: StaticCell<ConsoleWriter> = StaticCell::new();
 
 // Signal sent from `main` to `shell_task` once hardware is fully configured.
 static SYSTEM_READY: Signal<CriticalSectionRawMutex, ()> = Signal::new();
 
+// Raised after each log line is committed to the ushell2 log ring; the
+// blocking UART writes of the lines are done by `log_drain_task`, not by
+// the task which logs.
+static LOG_PENDING: Signal<CriticalSectionRawMutex, ()> = Signal::new();
+
+fn wake_log_drain() {
+    LOG_PENDING.signal(());
+}
+
+// The log writer: every console gets the log lines, and with them the output
+// of the commands (they log it), whichever session ran them.
+struct ConsoleWriter(UartWriter);
+
+impl core::fmt::Write for ConsoleWriter {
+    fn write_str(&mut self, s: &str) -> core::fmt::Result {
+        #[cfg(feature = "usb-cdc")]
+        {
+            usb_write(s.as_bytes());
+        }
+        core::fmt::Write::write_str(&mut self.0, s)
+    }
+}
+
+// The OTG FS core needs 48 MHz: BlackPill 25 MHz HSE / 25 * 192 = 192 MHz VCO,
+// P / 2 = 96 MHz SYSCLK, Q / 4 = 48 MHz USB
+#[cfg(feature = "usb-cdc")]
+fn usb_clock_config() -> embassy_stm32::Config {
+    use embassy_stm32::rcc::*;
+    use embassy_stm32::time::Hertz;
+
+    let mut config = embassy_stm32::Config::default();
+    config.rcc.hse = Some(Hse {
+        freq: Hertz(25_000_000),
+        mode: HseMode::Oscillator,
+    });
+    config.rcc.pll_src = PllSource::HSE;
+    config.rcc.pll = Some(Pll {
+        prediv: PllPreDiv::DIV25,
+        mul: PllMul::MUL192,
+        divp: Some(PllPDiv::DIV2),
+        divq: Some(PllQDiv::DIV4),
+        divr: None,
+    });
+    config.rcc.ahb_pre = AHBPrescaler::DIV1;
+    config.rcc.apb1_pre = APBPrescaler::DIV2; // 48 MHz, at most 50
+    config.rcc.apb2_pre = APBPrescaler::DIV1;
+    config.rcc.sys = Sysclk::PLL1_P;
+    config
+}
+
+// The RTC runs the time of the low-power executor through STOP: the LSE of
+// the BlackPill, and no debug clocks in STOP (a probe keeps them, not the core).
+#[cfg(feature = "low-power")]
+fn low_power_config() -> embassy_stm32::Config {
+    use embassy_stm32::rcc::LsConfig;
+
+    let mut config = embassy_stm32::Config::default();
+    config.rcc.ls = LsConfig::default_lse();
+    config.enable_debug_during_sleep = false;
+    config
+}
+
 // ============================================================================
 // Main Entry Point
+//
+// The `low-power` build runs embassy-stm32's low-power executor: when every
+// task waits and the next timer is far enough away, it sets the RTC wake-up
+// alarm and enters STOP instead of a plain wfe.
 // ============================================================================
 
+#[cfg(not(feature = "low-power"))]
 #[embassy_executor::main]
 async fn main(spawner: Spawner) {
+    app_main(spawner).await;
+}
+
+#[cfg(feature = "low-power")]
+#[cortex_m_rt::entry]
+fn main() -> ! {
+    embassy_stm32::low_power::Executor::take().run(|spawner| {
+        spawner
+            .spawn(app_task(spawner))
+            .expect("Failed to spawn app_task");
+    })
+}
+
+#[cfg(feature = "low-power")]
+#[embassy_executor::task]
+async fn app_task(spawner: Spawner) {
+    app_main(spawner).await;
+}
+
+async fn app_main(spawner: Spawner) {
+    #[cfg(not(any(feature = "usb-cdc", feature = "low-power")))]
     let p = embassy_stm32::init(Default::default());
+    #[cfg(feature = "usb-cdc")]
+    let p = embassy_stm32::init(usb_clock_config());
+    #[cfg(feature = "low-power")]
+    let p = {
+        use embassy_stm32::rtc::{Rtc, RtcConfig};
+
+        static RTC: StaticCell<Rtc> = StaticCell::new();
+
+        let p = embassy_stm32::init(low_power_config());
+        let rtc = RTC.init(Rtc::new(p.RTC, RtcConfig::default()));
+        embassy_stm32::low_power::stop_with_rtc(rtc);
+        p
+    };
 
     let config = Config::default();
 
+    // RX DMA1_CH5 is run circular by uart_rx_task; with the `renode` feature
+    // there is no RX DMA (the Renode USART does not request it), RX is polled
+    #[cfg(not(feature = "renode"))]
+    let rx_dma = p.DMA1_CH5;
+    #[cfg(feature = "renode")]
+    let rx_dma = embassy_stm32::dma::NoDma;
+
     let uart = Uart::new(
         p.USART2,
         p.PA3, // RX
         p.PA2, // TX
         Irqs,
         p.DMA1_CH6,                          // TX DMA
-        embassy_stm32::dma::NoDma,           // No RX DMA — works better in Renode
+        rx_dma,                              // RX DMA (uart_hal::UartRxDma)
         config,
     )
     .expect("Failed to initialize USART2");
@@ -104,9 +240,9 @@ async fn main(spawner: Spawner) {
         *GLOBAL_UART_RX.rx.get() = Some(rx);
     }
 
-    // Initialize the logger using a safely-allocated static UartWriter.
-    // UART_WRITER.init() panics if called more than once, which is what we want.
-    let writer = UART_WRITER.init(UartWriter::new());
+    // Initialize the logger using a safely-allocated static ConsoleWriter.
+    // CONSOLE_WRITER.init() panics if called more than once, which is what we want.
+    let writer = CONSOLE_WRITER.init(ConsoleWriter(UartWriter::new()));
     init_logger(
         LoggerConfig {
             color_entire_line: true,
@@ -114,18 +250,45 @@ async fn main(spawner: Spawner) {
         },
         writer,
     );
+    set_drain_notify(Some(wake_log_drain));
 
     log_simple!("System initialized");
+    #[cfg(not(feature = "renode"))]
+    log_simple!("UART configured with async shell (RX DMA ring)");
+    #[cfg(feature = "renode")]
     log_simple!("UART configured with async shell (nb_read)");
 
     // Spawn tasks. `expect` gives a more debuggable panic than `unwrap` if
     // the executor runs out of task slots. This panics via `panic_halt`.
+    spawner
+        .spawn(log_drain_task())
+        .expect("Failed to spawn log_drain_task");
     spawner
         .spawn(blink_led(p.PC13))
         .expect("Failed to spawn blink_led");
     spawner
         .spawn(uart_rx_task())
         .expect("Failed to spawn uart_rx_task");
+    #[cfg(feature = "low-power")]
+    {
+        spawner
+            .spawn(awake_task())
+            .expect("Failed to spawn awake_task");
+        log_simple!("Low-power: STOP {} s after the last byte", AWAKE_AFTER_INPUT.as_secs());
+    }
+    #[cfg(feature = "usb-cdc")]
+    {
+        let (usb, class) = usb_cdc_init(p.USB_OTG_FS, p.PA12, p.PA11);
+        spawner
+            .spawn(usb_device_task(usb))
+            .expect("Failed to spawn usb_device_task");
+        spawner
+            .spawn(usb_cdc_task(class))
+            .expect("Failed to spawn usb_cdc_task");
+        log_simple!("USB CDC-ACM console enabled");
+    }
+    bench::bench_init(&spawner);
+    load::load_init(&spawner);
     spawner
         .spawn(shell_task())
         .expect("Failed to spawn shell_task");
@@ -136,6 +299,41 @@ async fn main(spawner: Spawner) {
     log_info!("All tasks spawned successfully");
 }
 
+// ============================================================================
+// Log Drain Task
+// ============================================================================
+
+#[embassy_executor::task]
+async fn log_drain_task() {
+    loop {
+        LOG_PENDING.wait().await;
+        drain_logs();
+    }
+}
+
+// ============================================================================
+// Awake Task (low-power)
+//
+// From the start and after each input, a short timer keeps the executor out
+// of STOP; AWAKE_AFTER_INPUT without any lets it go. The blink and the other
+// timers then wake it from STOP through the RTC, coming input through EXTI3.
+// ============================================================================
+
+#[cfg(feature = "low-power")]
+#[embassy_executor::task]
+async fn awake_task() {
+    loop {
+        let mut last = Instant::now();
+        while last.elapsed() < AWAKE_AFTER_INPUT {
+            Timer::after(AWAKE_TICK).await;
+            if UART_RX_ACTIVITY.try_take().is_some() {
+                last = Instant::now();
+            }
+        }
+        UART_RX_ACTIVITY.wait().await;
+    }
+}
+
 // ============================================================================
 // LED Blinker Task
 // ============================================================================
@@ -170,18 +368,17 @@ async fn shell_task() {
     log_simple!("Starting async shell...");
     log_simple!("Type '##' for available commands");
 
-    let reader = AsyncReader::new(
-        // Non-blocking: try to pull a byte from the RX channel
+    // Sleeps until uart_rx_task has a byte in the RX channel: the shell
+    // task is woken by input only, never by a timer, and then takes all
+    // that is queued behind that byte in one go
+    let reader = WaitReader::new(
+        || UART_RX_CHANNEL.receive(),
         || UART_RX_CHANNEL.try_receive().ok(),
-        // Yield for 50 µs between empty reads to avoid busy-looping
-        || Timer::after_micros(50),
-        // Yield to the executor after 100 consecutive empty reads —
-        // a good balance between latency and cooperative scheduling
-        100,
     );
 
     let config = ShellConfig {
         get_commands: commands::get_commands,
+        get_name_lcp: commands::get_name_lcp,
         get_datatypes: commands::get_datatypes,
         get_shortcuts: shortcuts::get_shortcuts,
         is_shortcut: shortcuts::is_supported_shortcut,
@@ -194,15 +391,41 @@ async fn shell_task() {
     // Run Shell
     // ====================================================================
 
-    run_shell::<
+    let uart_session = run_shell::<
         { commands::MAX_COMMANDS_PER_LETTER }, // max autocomplete candidates per letter
         { commands::MAX_FUNCTION_NAME_LEN },   // function name buffer size
         { MAX_INPUT_LEN },                     // input line buffer size
         { MAX_HISTORY_CAPACITY },              // history ring buffer capacity
         { MAX_ERROR_BUFFER_SIZE },             // error message buffer size
         _,                                     // reader type — inferred
-    >(uart_write, uart_flush, reader, config)
-    .await;
+    >(uart_write, uart_flush, reader, config);
+
+    #[cfg(not(feature = "usb-cdc"))]
+    {
+        uart_session.await;
+    }
+
+    // A second session on the USB console, in this same task: same command
+    // tables, its own input line, history and autocomplete. `#q` on one ends
+    // it, the other one goes on.
+    #[cfg(feature = "usb-cdc")]
+    {
+        let usb_reader = WaitReader::new(
+            || USB_RX_CHANNEL.receive(),
+            || USB_RX_CHANNEL.try_receive().ok(),
+        );
+
+        let usb_session = run_shell::<
+            { commands::MAX_COMMANDS_PER_LETTER },
+            { commands::MAX_FUNCTION_NAME_LEN },
+            { MAX_INPUT_LEN },
+            { MAX_HISTORY_CAPACITY },
+            { MAX_ERROR_BUFFER_SIZE },
+            _,
+        >(usb_write, usb_flush, usb_reader, config);
+
+        join(uart_session, usb_session).await;
+    }
 
     log_info!("Shell exited");
 }
@@ -5,25 +5,51 @@
 //   - GlobalUartTx / GlobalUartRx: static UART half-owners
 //   - UartWriter: implements core::fmt::Write over blocking TX
 //   - uart_write / uart_flush helpers for shell TX closures
-//   - uart_rx_task: async task that feeds a byte channel from nb_read()
+//   - uart_rx_task: async task that feeds a byte channel from the DMA ring
+//     (circular DMA1_CH5, woken on IDLE line or half / full transfer)
 //   - UART_RX_CHANNEL: the shared channel between RX task and shell reader
+//
+// Feature `rx-nb-poll`: no RX DMA, nb_read() polled every 100 µs instead
+// (for Renode, whose USART model does not drive the RX DMA request).
+//
+// Feature `rx-wake`: the USART has no clock in STOP mode, a falling edge of
+// the RX pin (EXTI line 3) wakes the core instead, and UART_RX_ACTIVITY
+// tells the application when input came in (main_app `low-power`).
 
 #![no_std]
 
 use core::cell::UnsafeCell;
 use core::option::Option::{self, None, Some};
-use core::result::Result::Ok;
+use core::result::Result::{Err, Ok};
+use core::sync::atomic::{AtomicU32, Ordering};
 
 use embassy_stm32::{peripherals};
 use embassy_sync::blocking_mutex::raw::CriticalSectionRawMutex;
 use embassy_sync::channel::Channel;
 use embassy_time::Timer;
+#[cfg(feature = "rx-nb-poll")]
 use nb;
+#[cfg(feature = "rx-wake")]
+use embassy_sync::signal::Signal;
+
+#[cfg(all(feature = "rx-wake", feature = "rx-nb-poll"))]
+compile_error!("rx-wake needs the RX DMA ring: a 100 µs poll never lets the core stop");
 
 // ============================================================================
 // Global Storage
 // ============================================================================
 
+/// RX DMA channel of USART2 as passed to `Uart::new()` (DMA1 stream 5 on the F411).
+#[cfg(not(feature = "rx-nb-poll"))]
+pub type UartRxDma = peripherals::DMA1_CH5;
+#[cfg(feature = "rx-nb-poll")]
+pub type UartRxDma = embassy_stm32::dma::NoDma;
+
+/// Size of the circular RX DMA buffer. The task is woken at each half, so
+/// it must take half of it in one go before the DMA wraps: 128 bytes are
+/// 11 ms at 115200 baud.
+pub const UART_RX_DMA_SIZE: usize = 256;
+
 pub struct GlobalUartTx {
     pub tx: UnsafeCell<
         Option<
@@ -35,11 +61,7 @@ pub struct GlobalUartTx {
 pub struct GlobalUartRx {
     pub rx: UnsafeCell<
         Option<
-            embassy_stm32::usart::UartRx<
-                'static,
-                peripherals::USART2,
-                embassy_stm32::dma::NoDma,
-            >,
+            embassy_stm32::usart::UartRx<'static, peripherals::USART2, UartRxDma>,
         >,
     >,
 }
@@ -59,6 +81,36 @@ pub static GLOBAL_UART_RX: GlobalUartRx = GlobalUartRx {
 /// Fed by `uart_rx_task`, consumed by the shell's `AsyncReader`.
 pub static UART_RX_CHANNEL: Channel<CriticalSectionRawMutex, u8, 1024> = Channel::new();
 
+/// RX errors (overrun, framing, noise) since the start; the bytes of the
+/// DMA ring at that moment are lost.
+static UART_RX_ERRORS: AtomicU32 = AtomicU32::new(0);
+
+pub fn uart_rx_errors() -> u32 {
+    UART_RX_ERRORS.load(Ordering::Relaxed)
+}
+
+/// Raised by `uart_rx_task` for each chunk it takes from the DMA ring, and
+/// for each RX error: the byte whose start bit woke the core from STOP comes
+/// in half sampled, as garbage or as a framing error, but it counts as input.
+#[cfg(feature = "rx-wake")]
+pub static UART_RX_ACTIVITY: Signal<CriticalSectionRawMutex, ()> = Signal::new();
+
+/// EXTI line 3 on PA3, falling edge: the start bit of the next byte wakes the
+/// core from STOP. Embassy's EXTI3 handler masks the line again when it
+/// fires (no waker is registered for it), so it is armed before each read.
+/// The pin stays in its USART alternate function, the EXTI samples its input.
+#[cfg(feature = "rx-wake")]
+fn rx_wake_arm() {
+    use embassy_stm32::pac;
+
+    critical_section::with(|_| {
+        pac::SYSCFG.exticr(0).modify(|w| w.set_exti(3, 0)); // port A
+        pac::EXTI.ftsr(0).modify(|w| w.set_line(3, true));
+        pac::EXTI.rtsr(0).modify(|w| w.set_line(3, false));
+        pac::EXTI.imr(0).modify(|w| w.set_line(3, true));
+    });
+}
+
 // ============================================================================
 // UartWriter — core::fmt::Write over blocking TX
 // ============================================================================
@@ -119,11 +171,66 @@ pub fn uart_flush() {
 // ============================================================================
 // UART RX Task
 //
+// The DMA writes the input into a circular buffer on its own; the task sleeps
+// in read() until the line goes idle (end of a burst, a key) or the DMA is
+// half / fully through the buffer, then hands the received slice on to
+// UART_RX_CHANNEL. Nothing runs while no byte comes in, and a paste at full
+// baud rate is taken without loss as long as the shell drains the channel.
+// An error (overrun, framing) stops the ring; the next read() restarts it.
+// ============================================================================
+
+#[cfg(not(feature = "rx-nb-poll"))]
+#[embassy_executor::task]
+pub async fn uart_rx_task() {
+    static mut RX_DMA_BUF: [u8; UART_RX_DMA_SIZE] = [0; UART_RX_DMA_SIZE];
+
+    // Brief delay for UART initialization
+    Timer::after_millis(100).await;
+
+    let rx = unsafe { (*GLOBAL_UART_RX.rx.get()).take() };
+
+    if let Some(rx) = rx {
+        // Safety: the only reference to RX_DMA_BUF, this task is spawned once.
+        let dma_buf = unsafe { &mut *core::ptr::addr_of_mut!(RX_DMA_BUF) };
+        let mut ring = rx.into_ring_buffered(dma_buf);
+        let mut chunk = [0u8; UART_RX_DMA_SIZE / 2];
+
+        loop {
+            #[cfg(feature = "rx-wake")]
+            rx_wake_arm();
+
+            let result = ring.read(&mut chunk).await;
+
+            #[cfg(feature = "rx-wake")]
+            UART_RX_ACTIVITY.signal(());
+
+            match result {
+                Ok(len) => {
+                    for &byte in &chunk[..len] {
+                        // Waits while the channel is full; the DMA keeps
+                        // receiving into the ring meanwhile
+                        UART_RX_CHANNEL.send(byte).await;
+                    }
+                }
+                Err(_) => {
+                    UART_RX_ERRORS.fetch_add(1, Ordering::Relaxed);
+                }
+            }
+        }
+    }
+    // If RX was never initialized we simply exit the task silently.
+    // Log from the call site if you need diagnostics.
+}
+
+// ============================================================================
+// UART RX Task (rx-nb-poll)
+//
 // Uses nb_read() (non-blocking) to drain the UART FIFO and push bytes into
 // UART_RX_CHANNEL. Yields via Timer when no data is available so that other
 // embassy tasks (LED, shell, …) get CPU time.
 // ============================================================================
 
+#[cfg(feature = "rx-nb-poll")]
 #[embassy_executor::task]
 pub async fn uart_rx_task() {
     // Brief delay for UART initialization
@@ -144,6 +251,7 @@ pub async fn uart_rx_task() {
                 }
                 Err(nb::Error::Other(_)) => {
                     // RX error — brief back-off
+                    UART_RX_ERRORS.fetch_add(1, Ordering::Relaxed);
                     Timer::after_millis(10).await;
                 }
             }
@@ -0,0 +1,230 @@
+// usb_hal/src/lib.rs
+//
+// USB CDC-ACM transport for the async shell on STM32 + Embassy: a second
+// console next to the USART2 one of uart_hal, same shape.
+// Provides:
+//   - usb_cdc_init(): OTG FS driver (PA12 D+ / PA11 D-), one CDC-ACM function
+//   - usb_device_task: runs the USB device stack (enumeration, control requests)
+//   - usb_cdc_task: bulk OUT -> USB_RX_CHANNEL, USB_TX_PIPE -> bulk IN
+//   - usb_write / usb_flush helpers for shell TX closures
+//   - USB_RX_CHANNEL: the shared channel between usb_cdc_task and the shell reader
+//
+// The OTG FS core needs its 48 MHz clock from the PLL Q output: the caller
+// configures the RCC before embassy_stm32::init() (main_app, feature usb-cdc).
+
+#![no_std]
+
+use core::option::Option::Some;
+use core::result::Result::{Err, Ok};
+use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+
+use embassy_futures::join::join;
+use embassy_stm32::usb_otg::{self, Driver};
+use embassy_stm32::{bind_interrupts, peripherals};
+use embassy_sync::blocking_mutex::raw::CriticalSectionRawMutex;
+use embassy_sync::channel::Channel;
+use embassy_sync::pipe::Pipe;
+use embassy_usb::class::cdc_acm::{CdcAcmClass, Receiver, Sender, State};
+use embassy_usb::{Builder, UsbDevice};
+use static_cell::StaticCell;
+
+bind_interrupts!(struct Irqs {
+    OTG_FS => usb_otg::InterruptHandler<peripherals::USB_OTG_FS>;
+});
+
+// ============================================================================
+// Global Storage
+// ============================================================================
+
+pub type UsbDriver = Driver<'static, peripherals::USB_OTG_FS>;
+
+/// Max packet size of the CDC bulk endpoints (full speed).
+pub const USB_CDC_PACKET_SIZE: usize = 64;
+
+/// Shell output queued for the bulk IN endpoint. The shell writes without
+/// waiting, so the longest burst it makes in one go (the `##` listing)
+/// must fit; the rest of a longer one is dropped and counted.
+pub const USB_TX_PIPE_SIZE: usize = 2048;
+
+/// USB RX byte channel.
+/// Fed by `usb_cdc_task`, consumed by the shell's `WaitReader`.
+pub static USB_RX_CHANNEL: Channel<CriticalSectionRawMutex, u8, 256> = Channel::new();
+
+static USB_TX_PIPE: Pipe<CriticalSectionRawMutex, USB_TX_PIPE_SIZE> = Pipe::new();
+
+/// The host configured the CDC function; output is discarded while not.
+static USB_CONNECTED: AtomicBool = AtomicBool::new(false);
+
+/// Output bytes dropped because the TX pipe was full.
+static USB_TX_DROPPED: AtomicU32 = AtomicU32::new(0);
+
+pub fn usb_tx_dropped() -> u32 {
+    USB_TX_DROPPED.load(Ordering::Relaxed)
+}
+
+pub fn usb_connected() -> bool {
+    USB_CONNECTED.load(Ordering::Relaxed)
+}
+
+// ============================================================================
+// Device setup
+// ============================================================================
+
+/// Build the OTG FS driver and the USB device with one CDC-ACM function;
+/// spawn `usb_device_task` with the first and `usb_cdc_task` with the second.
+/// Panics if called more than once (the static buffers are taken).
+pub fn usb_cdc_init(
+    otg: peripherals::USB_OTG_FS,
+    dp: peripherals::PA12,
+    dm: peripherals::PA11,
+) -> (UsbDevice<'static, UsbDriver>, CdcAcmClass<'static, UsbDriver>) {
+    static EP_OUT_BUFFER: StaticCell<[u8; 256]> = StaticCell::new();
+    static DEVICE_DESCRIPTOR: StaticCell<[u8; 256]> = StaticCell::new();
+    static CONFIG_DESCRIPTOR: StaticCell<[u8; 256]> = StaticCell::new();
+    static BOS_DESCRIPTOR: StaticCell<[u8; 256]> = StaticCell::new();
+    static CONTROL_BUF: StaticCell<[u8; 64]> = StaticCell::new();
+    static CDC_STATE: StaticCell<State<'static>> = StaticCell::new();
+
+    // BlackPill: VBUS is not wired to PA9
+    let mut otg_config = usb_otg::Config::default();
+    otg_config.vbus_detection = false;
+
+    let driver = Driver::new_fs(
+        otg,
+        Irqs,
+        dp,
+        dm,
+        EP_OUT_BUFFER.init([0; 256]),
+        otg_config,
+    );
+
+    let mut config = embassy_usb::Config::new(0xc0de, 0xcafe);
+    config.manufacturer = Some("uSTM32Template");
+    config.product = Some("Embassy shell");
+    config.serial_number = Some("00000001");
+    config.max_power = 100;
+    config.max_packet_size_0 = 64;
+
+    // IAD, so that Windows binds its CDC driver to the function
+    config.device_class = 0xEF;
+    config.device_sub_class = 0x02;
+    config.device_protocol = 0x01;
+    config.composite_with_iads = true;
+
+    let mut builder = Builder::new(
+        driver,
+        config,
+        DEVICE_DESCRIPTOR.init([0; 256]),
+        CONFIG_DESCRIPTOR.init([0; 256]),
+        BOS_DESCRIPTOR.init([0; 256]),
+        &mut [], // no MS OS descriptors
+        CONTROL_BUF.init([0; 64]),
+    );
+
+    let class = CdcAcmClass::new(
+        &mut builder,
+        CDC_STATE.init(State::new()),
+        USB_CDC_PACKET_SIZE as u16,
+    );
+
+    (builder.build(), class)
+}
+
+// ============================================================================
+// TX helper closures (pass these to run_shell)
+// ============================================================================
+
+/// Queue bytes for the USB console, without waiting: nothing is sent while
+/// no host has the port configured, and what does not fit in the pipe is
+/// dropped (counted by `usb_tx_dropped()`).
+pub fn usb_write(bytes: &[u8]) {
+    if !USB_CONNECTED.load(Ordering::Relaxed) {
+        return;
+    }
+    let mut rest = bytes;
+    while !rest.is_empty() {
+        match USB_TX_PIPE.try_write(rest) {
+            Ok(n) => rest = &rest[n..],
+            Err(_) => {
+                USB_TX_DROPPED.fetch_add(rest.len() as u32, Ordering::Relaxed);
+                return;
+            }
+        }
+    }
+}
+
+/// Flush USB TX: `usb_cdc_task` sends as soon as bytes are queued.
+pub fn usb_flush() {}
+
+// ============================================================================
+// USB Tasks
+//
+// usb_device_task answers the host (enumeration, CDC line coding); it runs
+// for ever. usb_cdc_task moves the bytes: each OUT packet goes to
+// USB_RX_CHANNEL, the queued output goes out a packet at a time. Both sleep
+// while nothing moves; a disconnect (cable, bus reset) drops the pending
+// output and waits for the host to configure the port again.
+// ============================================================================
+
+#[embassy_executor::task]
+pub async fn usb_device_task(mut usb: UsbDevice<'static, UsbDriver>) -> ! {
+    usb.run().await
+}
+
+#[embassy_executor::task]
+pub async fn usb_cdc_task(class: CdcAcmClass<'static, UsbDriver>) {
+    let (mut tx, mut rx) = class.split();
+    join(usb_rx_loop(&mut rx), usb_tx_loop(&mut tx)).await;
+}
+
+async fn usb_rx_loop(rx: &mut Receiver<'static, UsbDriver>) {
+    let mut packet = [0u8; USB_CDC_PACKET_SIZE];
+
+    loop {
+        rx.wait_connection().await;
+        USB_CONNECTED.store(true, Ordering::Relaxed);
+
+        // an Enter of its own: the session draws its prompt on the new
+        // console (its banner went out while nobody was connected)
+        USB_RX_CHANNEL.send(b'\r').await;
+
+        loop {
+            match rx.read_packet(&mut packet).await {
+                Ok(len) => {
+                    for &byte in &packet[..len] {
+                        // Waits while the channel is full; the host is
+                        // NAKed meanwhile, no input is lost
+                        USB_RX_CHANNEL.send(byte).await;
+                    }
+                }
+                Err(_) => break, // disabled: cable out or bus reset
+            }
+        }
+
+        USB_CONNECTED.store(false, Ordering::Relaxed);
+        USB_TX_PIPE.clear();
+    }
+}
+
+async fn usb_tx_loop(tx: &mut Sender<'static, UsbDriver>) {
+    let mut packet = [0u8; USB_CDC_PACKET_SIZE];
+
+    loop {
+        tx.wait_connection().await;
+
+        loop {
+            let len = USB_TX_PIPE.read(&mut packet).await;
+            if tx.write_packet(&packet[..len]).await.is_err() {
+                break;
+            }
+            // a full packet does not end a transfer: a zero length one
+            // does, when no more output follows it right now
+            if len == USB_CDC_PACKET_SIZE
+                && USB_TX_PIPE.is_empty()
+                && tx.write_packet(&[]).await.is_err()
+            {
+                break;
+            }
+        }
+    }
+}
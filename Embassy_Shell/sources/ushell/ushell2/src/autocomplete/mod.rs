@@ -119,6 +119,68 @@ impl<'a, const NAC: usize, const FNL: usize> Autocomplete<'a, NAC, FNL> {
         }
     }
 
+    /// Updates the input string from a sorted command table and its prefix index,
+    /// with the same completion as `update_input()`.
+    ///
+    /// `lcp[i]` is the length of the common prefix of `commands[i]` and `commands[i - 1]`
+    /// (the generated `get_name_lcp()`). The first match is found by binary search, the
+    /// run of matches ends at the first `lcp` below the input length, and the smallest
+    /// `lcp` inside the run is their common prefix: no name is scanned or compared past
+    /// the search, whatever the size of the table.
+    ///
+    /// # Arguments
+    /// * `new_input` - The new input string to filter against
+    /// * `commands` - The (name, descriptor) pairs, sorted by name
+    /// * `lcp` - The prefix index of `commands`, one value per entry
+    ///
+    pub fn update_input_indexed(
+        &mut self,
+        new_input: &str,
+        commands: &'a [(&'a str, &'a str)],
+        lcp: &[u8],
+    ) {
+        self.input.clear();
+        let _ = self.input.push_str(new_input);
+        self.filtered.clear();
+        self.candidates.clear();
+        self.first_char_loaded = None;
+        self.tab_index = 0;
+
+        let prefix = self.input.as_str();
+        if prefix.is_empty() || lcp.len() != commands.len() {
+            return;
+        }
+
+        let first = commands.partition_point(|&(name, _)| name < prefix);
+        let first_name = match commands.get(first) {
+            Some(&(name, _)) if name.starts_with(prefix) => name,
+            _ => return, // No match: input unchanged
+        };
+
+        let mut common = first_name.len();
+        let mut end = first + 1;
+        while end < commands.len() && lcp[end] as usize >= prefix.len() {
+            common = common.min(lcp[end] as usize);
+            end += 1;
+        }
+
+        for &(name, _) in &commands[first..end] {
+            if self.filtered.push(name).is_err() {
+                break; // Stop if we exceed capacity
+            }
+        }
+
+        self.input.clear();
+        if end - first == 1 {
+            // Single match: auto-complete with trailing space
+            let _ = self.input.push_str(first_name);
+            let _ = self.input.push(' ');
+        } else {
+            // Multiple matches: the smallest neighbour prefix of the run
+            let _ = self.input.push_str(first_name.get(..common).unwrap_or(first_name));
+        }
+    }
+
     /// Cycles forward through filtered candidates and adds a trailing space.
     ///
     pub fn cycle_forward(&mut self) {
@@ -526,4 +588,62 @@ mod tests {
             }
         }
     }
+
+    //----------------------------
+    // Sorted table with the prefix index
+    //----------------------------
+
+    const TABLE: &[(&str, &str)] = &[
+        ("alpha", "v"), ("alpine", "v"), ("beta", "v"),
+        ("gambit", "v"), ("gamma", "v"), ("gamut", "v"), ("zeta", "v"),
+    ];
+    const TABLE_LCP: &[u8] = &[0, 3, 0, 0, 3, 3, 0];
+
+    #[test]
+    fn test_indexed_matches_the_scan() {
+        let inputs = [
+            "a", "al", "alp", "alph", "alpi", "b", "g", "ga", "gam", "gamb", "gamm", "gamu",
+            "gx", "x", "z", "zeta", "zetas",
+        ];
+
+        for inp in inputs {
+            let mut scan = Autocomplete::<NAC, FNL>::new();
+            let mut indexed = Autocomplete::<NAC, FNL>::new();
+            scan.update_input(inp, get_commands_for_char);
+            indexed.update_input_indexed(inp, TABLE, TABLE_LCP);
+
+            assert_eq!(indexed.current_input(), scan.current_input(), "input {}", inp);
+
+            let mut a: Vec<&str, NAC> = scan.filtered.clone();
+            let b: Vec<&str, NAC> = indexed.filtered.clone();
+            a.sort_unstable();
+            assert_eq!(a, b, "input {}", inp);
+        }
+    }
+
+    #[test]
+    fn test_indexed_cycle_in_table_order() {
+        let mut ac = Autocomplete::<NAC, FNL>::new();
+        ac.update_input_indexed("ga", TABLE, TABLE_LCP);
+        assert_eq!(ac.current_input(), "gam");
+        assert_eq!(ac.filtered_candidates(), &["gambit", "gamma", "gamut"]);
+
+        ac.cycle_forward();
+        assert_eq!(ac.current_input(), "gamma ");
+        ac.cycle_backward();
+        ac.cycle_backward();
+        assert_eq!(ac.current_input(), "gamut ");
+    }
+
+    #[test]
+    fn test_indexed_without_index_keeps_input() {
+        let mut ac = Autocomplete::<NAC, FNL>::new();
+        ac.update_input_indexed("al", TABLE, &[]);
+        assert_eq!(ac.current_input(), "al");
+        assert!(ac.filtered_candidates().is_empty());
+
+        ac.update_input_indexed("", TABLE, TABLE_LCP);
+        assert_eq!(ac.current_input(), "");
+        assert!(ac.filtered_candidates().is_empty());
+    }
 }
@@ -12,6 +12,13 @@ use core::default::Default;
 
 const METADATA_SIZE: usize = 4; // 2 bytes leading + 2 bytes trailing length
 
+/// Entries tracked by the offsets index of the parser's history (feature
+/// `history-index`, the oldest are dropped beyond), 0 without it.
+#[cfg(feature = "history-index")]
+pub const HISTORY_INDEX_DEPTH: usize = 32;
+#[cfg(not(feature = "history-index"))]
+pub const HISTORY_INDEX_DEPTH: usize = 0;
+
 /// A fixed-size, circular history buffer for storing strings.
 ///
 /// Uses embedded metadata design
@@ -22,8 +29,12 @@ const METADATA_SIZE: usize = 4; // 2 bytes leading + 2 bytes trailing length
 ///
 /// Generic parameters:
 /// - `HTC`: History Total Capacity (bytes in buffer)
+/// - `HIX`: History IndeX depth, 0 (default) for none. Otherwise a ring of the
+///   start offsets of up to `HIX` entries is kept next to the buffer, so an
+///   indexed access (up/down, `#l`) does not walk the length records from the
+///   oldest entry; pushing entry `HIX + 1` drops the oldest one.
 ///
-pub struct History<const HTC: usize> {
+pub struct History<const HTC: usize, const HIX: usize = 0> {
     /// Circular buffer containing all history entries with embedded metadata
     data: [u8; HTC],
     /// Next write position (head)
@@ -34,11 +45,17 @@ pub struct History<const HTC: usize> {
     entry_size: usize,
     /// Current navigation index (for up/down arrow keys)
     current_index: usize,
+    /// Bytes taken by the entries, metadata included
+    data_used: usize,
+    /// Start offsets of the entries (HIX > 0), the oldest at `index_first`
+    index: [u16; HIX],
+    /// Slot of the oldest entry in `index`
+    index_first: usize,
 }
 
 /// Default
 ///
-impl<const HTC: usize> Default for History<HTC> {
+impl<const HTC: usize, const HIX: usize> Default for History<HTC, HIX> {
     /// Returns a new, empty history buffer.
     fn default() -> Self {
         Self::new()
@@ -47,15 +64,25 @@ impl<const HTC: usize> Default for History<HTC> {
 
 /// Implement History
 ///
-impl<const HTC: usize> History<HTC> {
+impl<const HTC: usize, const HIX: usize> History<HTC, HIX> {
+    /// The offsets of the index are 16 bit, like the lengths.
+    const INDEX_FITS: () = assert!(
+        HIX == 0 || HTC <= 65536,
+        "History: HTC must not exceed 64K with the index"
+    );
+
     /// Creates a new, empty history buffer.
     pub fn new() -> Self {
+        let () = Self::INDEX_FITS;
         let instance = Self {
             data: [0; HTC],
             data_head: 0,
             entry_oldest: 0,
             entry_size: 0,
             current_index: 0,
+            data_used: 0,
+            index: [0; HIX],
+            index_first: 0,
         };
         #[cfg(feature = "history-persistence")]
         let instance = {
@@ -95,21 +122,22 @@ impl<const HTC: usize> History<HTC> {
             return false;
         }
 
-        // Remove oldest entries until we have enough space
-        let mut used = self.calculate_used_space();
-        while self.entry_size > 0 && (HTC - used) < needed {
-            let oldest_len = self.read_length_at(self.entry_oldest);
-            let oldest_size = Self::entry_total_size(oldest_len);
-
+        // Remove oldest entries until we have enough space (and a free index slot)
+        while self.entry_size > 0
+            && ((HTC - self.data_used) < needed || (HIX > 0 && self.entry_size >= HIX))
+        {
             self.remove_oldest_entry();
-            used -= oldest_size;
         }
 
         // Double-check we have space
-        if (HTC - used) < needed {
+        if (HTC - self.data_used) < needed {
             return false;
         }
 
+        if HIX > 0 {
+            self.index[(self.index_first + self.entry_size) % HIX] = self.data_head as u16;
+        }
+
         // Write entry with embedded metadata: [len_hi][len_lo][data...][len_hi][len_lo]
         let mut write_pos = self.data_head;
 
@@ -129,6 +157,7 @@ impl<const HTC: usize> History<HTC> {
 
         // Update head position and counts
         self.data_head = write_pos;
+        self.data_used += needed;
         self.entry_size += 1;
         self.current_index = self.entry_size - 1;
 
@@ -243,7 +272,7 @@ impl<const HTC: usize> History<HTC> {
     /// Returns the number of free bytes remaining in the buffer.
     ///
     pub fn get_free_space(&self) -> usize {
-        HTC - self.calculate_used_space()
+        HTC - self.data_used
     }
 
     /// Gets an entry by index and writes it into the provided buffer.
@@ -270,12 +299,7 @@ impl<const HTC: usize> History<HTC> {
             return None;
         }
 
-        // Find the position of the entry at the given index
-        let mut pos = self.entry_oldest;
-        for _ in 0..index {
-            pos = self.find_next_entry_pos(pos);
-        }
-
+        let pos = self.entry_pos_at_index(index);
         let actual_len = self.get_entry_at_pos_into_buffer(pos, buffer, buffer.len());
         Some(actual_len)
     }
@@ -308,12 +332,7 @@ impl<const HTC: usize> History<HTC> {
             return None;
         }
 
-        // Find the position of the entry at the given index
-        let mut pos = self.entry_oldest;
-        for _ in 0..index {
-            pos = self.find_next_entry_pos(pos);
-        }
-
+        let pos = self.entry_pos_at_index(index);
         let len = self.read_length_at(pos) as usize;
         let data_pos = (pos + 2) % HTC;
 
@@ -377,10 +396,28 @@ impl<const HTC: usize> History<HTC> {
         self.entry_oldest = 0;
         self.entry_size = 0;
         self.current_index = 0;
+        self.data_used = 0;
+        self.index_first = 0;
     }
 
     // ==================== PRIVATE HELPERS ====================
 
+    /// Returns the buffer position of the entry at `index` (< entry_size):
+    /// from the offsets index, or by walking from the oldest entry without it.
+    ///
+    #[inline]
+    fn entry_pos_at_index(&self, index: usize) -> usize {
+        if HIX > 0 {
+            return self.index[(self.index_first + index) % HIX] as usize;
+        }
+
+        let mut pos = self.entry_oldest;
+        for _ in 0..index {
+            pos = self.find_next_entry_pos(pos);
+        }
+        pos
+    }
+
     /// Gets the entry at a specific position in the buffer by writing into the provided buffer.
     ///
     /// # Parameters
@@ -467,36 +504,22 @@ impl<const HTC: usize> History<HTC> {
         // Move oldest pointer forward
         self.entry_oldest = (self.entry_oldest + size) % HTC;
         self.entry_size -= 1;
+        self.data_used -= size;
+        if HIX > 0 {
+            self.index_first = (self.index_first + 1) % HIX;
+        }
 
         // If buffer is now empty, reset pointers
         if self.entry_size == 0 {
             self.data_head = 0;
             self.entry_oldest = 0;
             self.current_index = 0;
+            self.index_first = 0;
         } else if self.current_index >= self.entry_size {
             self.current_index = self.entry_size - 1;
         }
     }
 
-    /// Calculates the total used space in the buffer.
-    ///    
-    fn calculate_used_space(&self) -> usize {
-        if self.entry_size == 0 {
-            return 0;
-        }
-
-        let mut total = 0;
-        let mut pos = self.entry_oldest;
-
-        for _ in 0..self.entry_size {
-            let len = self.read_length_at(pos);
-            total += Self::entry_total_size(len);
-            pos = self.find_next_entry_pos(pos);
-        }
-
-        total
-    }
-
     /// Finds the position of the next entry after the given position.
     ///    
     #[inline]
@@ -532,3 +555,90 @@ impl<const HTC: usize> History<HTC> {
         }
     }
 }
+
+// ==================== TESTS =======================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn entry<const HTC: usize, const HIX: usize>(h: &History<HTC, HIX>, index: usize) -> [u8; 16] {
+        let mut buf = [0u8; 16];
+        h.get_into_buffer(index, &mut buf).expect("index in range");
+        buf
+    }
+
+    fn is<const HTC: usize, const HIX: usize>(h: &History<HTC, HIX>, index: usize, s: &str) -> bool {
+        let buf = entry(h, index);
+        &buf[..s.len()] == s.as_bytes() && buf[s.len()..].iter().all(|&b| b == 0)
+    }
+
+    #[test]
+    fn test_push_and_index() {
+        let mut h: History<64, 8> = History::new();
+        assert!(h.push("one"));
+        assert!(h.push("two"));
+        assert!(h.push("three"));
+        assert_eq!(h.len(), 3);
+        assert!(is(&h, 0, "one"));
+        assert!(is(&h, 2, "three"));
+        assert_eq!(h.get_free_space(), 64 - (3 + 3 + 5 + 3 * METADATA_SIZE));
+        assert!(h.get_into_buffer(3, &mut [0u8; 4]).is_none());
+    }
+
+    #[test]
+    fn test_index_full_drops_oldest() {
+        let mut h: History<256, 3> = History::new();
+        for s in ["a", "b", "c", "d", "e"] {
+            assert!(h.push(s));
+        }
+        assert_eq!(h.len(), 3);
+        assert!(is(&h, 0, "c"));
+        assert!(is(&h, 2, "e"));
+        assert_eq!(h.get_free_space(), 256 - 3 * (1 + METADATA_SIZE));
+    }
+
+    #[test]
+    fn test_eviction_wraps_like_the_walk() {
+        // every entry through a wrapping buffer: the index agrees with the walk
+        let mut indexed: History<40, 16> = History::new();
+        let mut walked: History<40> = History::new();
+        let words = ["alpha", "be", "gamma12", "d", "epsilon", "zeta", "eta9", "theta", "i"];
+
+        for round in 0..5 {
+            for w in words.iter() {
+                let mut line = [0u8; 12];
+                line[..w.len()].copy_from_slice(w.as_bytes());
+                line[w.len()] = b'0' + round;
+                let s = core::str::from_utf8(&line[..w.len() + 1]).unwrap();
+                assert_eq!(indexed.push(s), walked.push(s));
+                assert_eq!(indexed.len(), walked.len());
+                assert_eq!(indexed.get_free_space(), walked.get_free_space());
+                for i in 0..walked.len() {
+                    assert_eq!(entry(&indexed, i), entry(&walked, i));
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_duplicate_rejected() {
+        let mut h: History<64, 4> = History::new();
+        assert!(h.push("ls"));
+        assert!(!h.push("  ls "));
+        assert_eq!(h.len(), 1);
+    }
+
+    #[test]
+    fn test_clear_resets_index() {
+        let mut h: History<32, 2> = History::new();
+        assert!(h.push("x1"));
+        assert!(h.push("x2"));
+        assert!(h.push("x3"));
+        h.clear();
+        assert!(h.is_empty());
+        assert_eq!(h.get_free_space(), 32);
+        assert!(h.push("y"));
+        assert!(is(&h, 0, "y"));
+    }
+}
@@ -1,6 +1,40 @@
 use crate::heapless::String;
 use core::iter::Iterator;
 
+/// What changed in an `InputBuffer` since the last frame was drawn, taken by
+/// [`InputBuffer::take_edit`]; the renderer sends only that.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Edit {
+    /// The characters are as drawn (the cursor may have moved).
+    None,
+    /// One character was inserted at `at`, nothing else changed.
+    Insert { at: usize },
+    /// `count` characters were taken out at `at`, nothing else changed.
+    Delete { at: usize, count: usize },
+    /// The characters from this index on may differ.
+    From(usize),
+}
+
+impl Edit {
+    /// One edit standing for `self` followed by `next`.
+    fn then(self, next: Edit) -> Edit {
+        match (self, next) {
+            (Edit::None, next) => next,
+            (prev, Edit::None) => prev,
+            (prev, next) => Edit::From(prev.first().min(next.first())),
+        }
+    }
+
+    /// The first index which may differ (`usize::MAX` for `Edit::None`).
+    pub(crate) fn first(self) -> usize {
+        match self {
+            Edit::None => usize::MAX,
+            Edit::Insert { at } | Edit::Delete { at, .. } => at,
+            Edit::From(from) => from,
+        }
+    }
+}
+
 /// A fixed-size, heapless character buffer for managing user input and cursor movement.
 ///
 /// `InputBuffer` is ideal for embedded or resource-constrained environments where dynamic memory allocation is not desired.
@@ -12,6 +46,7 @@ pub struct InputBuffer<const IML: usize> {
     buffer: [char; IML],
     length: usize,
     cursor_pos: usize,
+    edit: Edit,
 }
 
 impl<const IML: usize> InputBuffer<IML> {
@@ -26,9 +61,30 @@ impl<const IML: usize> InputBuffer<IML> {
             buffer: ['\0'; IML],
             length: 0,
             cursor_pos: 0,
+            edit: Edit::None,
         }
     }
 
+    #[inline]
+    fn mark(&mut self, edit: Edit) {
+        self.edit = self.edit.then(edit);
+    }
+
+    /// Returns what changed since the last call (the last frame drawn) and
+    /// starts over from `Edit::None`.
+    ///
+    /// # Example
+    /// ```
+    /// let mut buf: InputBuffer<8> = InputBuffer::new();
+    /// buf.insert('a');
+    /// assert_eq!(buf.take_edit(), Edit::Insert { at: 0 });
+    /// assert_eq!(buf.take_edit(), Edit::None);
+    /// ```
+    #[inline]
+    pub fn take_edit(&mut self) -> Edit {
+        core::mem::replace(&mut self.edit, Edit::None)
+    }
+
     /// Inserts a character at the current cursor position.
     ///
     /// Shifts subsequent characters to the right.
@@ -47,6 +103,7 @@ impl<const IML: usize> InputBuffer<IML> {
             self.buffer[i + 1] = self.buffer[i];
         }
         self.buffer[self.cursor_pos] = ch;
+        self.mark(Edit::Insert { at: self.cursor_pos });
         self.length += 1;
         self.cursor_pos += 1;
         true
@@ -72,6 +129,7 @@ impl<const IML: usize> InputBuffer<IML> {
         self.length -= 1;
         self.cursor_pos -= 1;
         self.buffer[self.length] = '\0';
+        self.mark(Edit::Delete { at: self.cursor_pos, count: 1 });
         true
     }
 
@@ -141,6 +199,7 @@ impl<const IML: usize> InputBuffer<IML> {
             }
             self.buffer[self.length - 1] = '\0';
             self.length -= 1;
+            self.mark(Edit::Delete { at: self.cursor_pos, count: 1 });
         }
     }
 
@@ -175,6 +234,9 @@ impl<const IML: usize> InputBuffer<IML> {
     /// buf.clear();
     /// ```
     pub fn clear(&mut self) {
+        if self.length != 0 {
+            self.mark(Edit::From(0));
+        }
         for i in 0..self.length {
             self.buffer[i] = '\0';
         }
@@ -225,6 +287,16 @@ impl<const IML: usize> InputBuffer<IML> {
     pub fn overwrite(&mut self, input: &str) {
         let new_len = input.len().min(IML);
 
+        // only what follows the common prefix is redrawn
+        let same = self.buffer[..self.length]
+            .iter()
+            .zip(input.chars())
+            .take_while(|(a, b)| *a == b)
+            .count();
+        if same != self.length || same != new_len {
+            self.mark(Edit::From(same));
+        }
+
         // Write new content
         for (i, c) in input.chars().take(IML).enumerate() {
             self.buffer[i] = c;
@@ -312,6 +384,7 @@ impl<const IML: usize> InputBuffer<IML> {
             self.buffer[i] = '\0';
         }
 
+        self.mark(Edit::Delete { at: 0, count: self.cursor_pos });
         self.length = shift;
         self.cursor_pos = 0;
     }
@@ -333,6 +406,7 @@ impl<const IML: usize> InputBuffer<IML> {
         for i in self.cursor_pos..self.length {
             self.buffer[i] = '\0';
         }
+        self.mark(Edit::From(self.cursor_pos));
         self.length = self.cursor_pos;
     }
 
@@ -877,4 +951,51 @@ mod tests {
         assert_eq!(buf.cursor(), 0);
         assert_eq!(buf.to_string().as_str(), "");
     }
+
+    // ============================================================================
+    // Edits since the last frame
+    // ============================================================================
+
+    #[test]
+    fn test_take_edit_single_ops() {
+        let mut buf: InputBuffer<16> = InputBuffer::new();
+        buf.overwrite("hello");
+        buf.take_edit();
+
+        buf.move_home();
+        assert_eq!(buf.take_edit(), Edit::None);
+        buf.insert('x');
+        assert_eq!(buf.take_edit(), Edit::Insert { at: 0 });
+        buf.delete();
+        assert_eq!(buf.take_edit(), Edit::Delete { at: 1, count: 1 });
+        buf.backspace();
+        assert_eq!(buf.take_edit(), Edit::Delete { at: 0, count: 1 });
+        buf.move_end();
+        buf.move_left();
+        buf.delete_to_start();
+        assert_eq!(buf.take_edit(), Edit::Delete { at: 0, count: 3 });
+    }
+
+    #[test]
+    fn test_take_edit_merges_and_overwrite_prefix() {
+        let mut buf: InputBuffer<16> = InputBuffer::new();
+        buf.overwrite("status");
+        buf.take_edit();
+
+        buf.overwrite("stats");
+        assert_eq!(buf.take_edit(), Edit::From(4));
+        buf.overwrite("stats");
+        assert_eq!(buf.take_edit(), Edit::None);
+
+        buf.move_home();
+        buf.move_right();
+        buf.move_right();
+        buf.insert('a');
+        buf.backspace();
+        buf.delete_to_end();
+        assert_eq!(buf.take_edit(), Edit::From(2));
+
+        buf.clear();
+        assert_eq!(buf.take_edit(), Edit::From(0));
+    }
 }
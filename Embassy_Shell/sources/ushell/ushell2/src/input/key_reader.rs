@@ -196,12 +196,17 @@ pub mod platform {
 #[cfg(not(feature = "hosted"))]
 pub mod embedded {
     use super::Key;
-    use heapless::Vec;
-
-    /// Simple VT100/ANSI escape sequence parser for embedded
+    use crate::input::key_table::{ACT_CHAR, ACT_KEY, ACT_NONE, CLASS, GROUND, KEYS, NEXT};
+
+    /// VT100/ANSI key decoder for embedded, a state machine driven by the generated
+    /// `key_table` (the escape sequences of `ushell_core_escape.cfg`, shared with the C++
+    /// core): a byte is its class, then the next state and the action of the transition,
+    /// two loads from flash whatever the sequence on its way.
+    ///
+    /// An unknown CSI is skipped up to its final byte, a control byte ends a sequence and
+    /// is decoded as a key, so is a byte not in the table right after the ESC (Alt+key).
     pub struct AnsiKeyParser {
-        escape_buffer: Vec<u8, 8>,
-        in_escape: bool,
+        state: u8,
     }
 
     impl Default for AnsiKeyParser {
@@ -212,93 +217,18 @@ pub mod embedded {
 
     impl AnsiKeyParser {
         pub const fn new() -> Self {
-            Self {
-                escape_buffer: Vec::new(),
-                in_escape: false,
-            }
+            Self { state: GROUND }
         }
 
         /// Parse a single byte and return a Key if complete
         #[inline]
         pub fn parse_byte(&mut self, byte: u8) -> Option<Key> {
-            match byte {
-                // Escape sequence start
-                0x1B => {
-                    self.in_escape = true;
-                    self.escape_buffer.clear();
-                    let _ = self.escape_buffer.push(byte);
-                    None
-                }
-
-                // If we're in an escape sequence
-                _ if self.in_escape => {
-                    let _ = self.escape_buffer.push(byte);
-                    self.try_complete_escape()
-                }
-
-                // Control characters
-                0x15 => Some(Key::CtrlU), // Ctrl+U
-                0x0B => Some(Key::CtrlK), // Ctrl+K
-                0x04 => Some(Key::CtrlD), // Ctrl+D
-                0x0E => Some(Key::CtrlN), // Ctrl+N
-                0x10 => Some(Key::CtrlP), // Ctrl+P
-                b'\r' | b'\n' => Some(Key::Enter),
-                b'\t' => Some(Key::Tab),
-                0x7F | 0x08 => Some(Key::Backspace),
-
-                // Printable characters
-                c if (0x20..0x7F).contains(&c) => Some(Key::Char(c as char)),
-
-                _ => None,
-            }
-        }
-
-        #[inline]
-        fn try_complete_escape(&mut self) -> Option<Key> {
-            let buf = &self.escape_buffer[..];
-
-            // Common VT100 sequences: ESC [ X
-            if buf.len() >= 3 && buf[0] == 0x1B && buf[1] == b'[' {
-                let result = match buf[2] {
-                    b'A' => Some(Key::ArrowUp),
-                    b'B' => Some(Key::ArrowDown),
-                    b'C' => Some(Key::ArrowRight),
-                    b'D' => Some(Key::ArrowLeft),
-                    b'H' => Some(Key::Home),
-                    b'F' => Some(Key::End),
-                    b'Z' => Some(Key::ShiftTab),
-
-                    // Extended sequences: ESC [ N ~
-                    b'1' | b'2' | b'3' | b'4' | b'5' | b'6' => {
-                        if buf.len() >= 4 && buf[3] == b'~' {
-                            match buf[2] {
-                                b'1' => Some(Key::Home),
-                                b'2' => Some(Key::Insert),
-                                b'3' => Some(Key::Delete),
-                                b'4' => Some(Key::End),
-                                b'5' => Some(Key::PageUp),
-                                b'6' => Some(Key::PageDown),
-                                _ => None,
-                            }
-                        } else {
-                            None // Wait for more bytes
-                        }
-                    }
-                    _ => Some(Key::Char(buf[2] as char)),
-                };
-
-                if result.is_some() {
-                    self.in_escape = false;
-                    self.escape_buffer.clear();
-                }
-                result
-            } else if buf.len() >= 4 {
-                // Escape sequence too long, reset
-                self.in_escape = false;
-                self.escape_buffer.clear();
-                None
-            } else {
-                None // Wait for more bytes
+            let step = NEXT[self.state as usize][CLASS[byte as usize] as usize];
+            self.state = step as u8;
+            match (step >> 8) as u8 {
+                ACT_NONE => None,
+                ACT_CHAR => Some(Key::Char(byte as char)),
+                action => Some(KEYS[(action - ACT_KEY) as usize]),
             }
         }
     }
@@ -417,6 +347,53 @@ mod tests {
         assert_eq!(parser.parse_byte(b'F'), Some(Key::End));
     }
 
+    #[cfg(not(feature = "hosted"))]
+    fn parse_all(parser: &mut embedded::AnsiKeyParser, bytes: &[u8]) -> Option<Key> {
+        let mut key = None;
+        for &byte in bytes {
+            assert_eq!(key, None);
+            key = parser.parse_byte(byte);
+        }
+        key
+    }
+
+    #[cfg(not(feature = "hosted"))]
+    #[test]
+    fn test_ansi_parser_table_sequences() {
+        let mut parser = embedded::AnsiKeyParser::new();
+
+        assert_eq!(parse_all(&mut parser, b"\x1BOA"), Some(Key::ArrowUp));
+        assert_eq!(parse_all(&mut parser, b"\x1BOF"), Some(Key::End));
+        assert_eq!(parse_all(&mut parser, b"\x1B[Z"), Some(Key::ShiftTab));
+        assert_eq!(parse_all(&mut parser, b"\x1B[6~"), Some(Key::PageDown));
+        assert_eq!(parse_all(&mut parser, b"\x1B[1;5C"), Some(Key::ArrowRight));
+        assert_eq!(parse_all(&mut parser, b"\x1B[~"), Some(Key::Delete));
+        assert_eq!(parser.parse_byte(b'x'), Some(Key::Char('x')));
+    }
+
+    #[cfg(not(feature = "hosted"))]
+    #[test]
+    fn test_ansi_parser_unknown_sequences() {
+        let mut parser = embedded::AnsiKeyParser::new();
+
+        // an unknown CSI is skipped up to its final byte
+        assert_eq!(parse_all(&mut parser, b"\x1B[15;2~"), None);
+        assert_eq!(parser.parse_byte(b'a'), Some(Key::Char('a')));
+
+        // ESC and a plain key (Alt+key): the key
+        assert_eq!(parse_all(&mut parser, b"\x1Bq"), Some(Key::Char('q')));
+
+        // a control byte ends the sequence and is a key
+        assert_eq!(parse_all(&mut parser, b"\x1B[1\r"), Some(Key::Enter));
+
+        // a new ESC restarts the sequence
+        assert_eq!(parse_all(&mut parser, b"\x1B[\x1B[D"), Some(Key::ArrowLeft));
+
+        // bytes above ASCII are dropped
+        assert_eq!(parser.parse_byte(0xC3), None);
+        assert_eq!(parser.parse_byte(b'\n'), Some(Key::Enter));
+    }
+
     #[test]
     fn test_key_matching() {
         fn is_arrow_key(key: &Key) -> bool {
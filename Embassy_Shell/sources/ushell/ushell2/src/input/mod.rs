@@ -1,4 +1,6 @@
 pub mod buffer;
 pub mod key_reader;
+#[cfg(not(feature = "hosted"))]
+pub mod key_table;
 pub mod parser;
 pub mod renderer;
@@ -1,6 +1,11 @@
 // A minimal logger that works in both no_std and std environments
 // Supports colored output based on severity level
 // Now integrated with shell's Writer trait for unified output
+//
+// no_std: a line is formatted straight into a record of a lock-free ring
+// (ring.rs), then drained to the writer of init_logger() — right away by the
+// logging context, or by a drain task of the application when one is set
+// with set_drain_notify(). No critical section is held while formatting.
 
 #![cfg_attr(not(feature = "hosted"), no_std)]
 #![allow(unexpected_cfgs)]
@@ -13,10 +18,7 @@ const DEFAULT_BUFFER_SIZE: usize = 128;
 use std::sync::{Mutex, Once};
 
 #[cfg(not(feature = "hosted"))]
-use core::cell::RefCell;
-
-#[cfg(not(feature = "hosted"))]
-use critical_section::Mutex;
+pub mod ring;
 
 // Re-export dependencies needed by macros
 #[cfg(not(feature = "hosted"))]
@@ -166,10 +168,12 @@ impl Default for LoggerConfig {
 
 // ============================================================================
 // Buffer size configuration - stored globally
+// (no_std: the longest message of a line, the size of its ring record)
 // ============================================================================
 
+use core::sync::atomic::{AtomicU32, Ordering};
 #[cfg(not(feature = "hosted"))]
-use core::sync::atomic::{AtomicUsize, Ordering};
+use core::sync::atomic::AtomicUsize;
 
 #[cfg(not(feature = "hosted"))]
 static BUFFER_SIZE: AtomicUsize = AtomicUsize::new(DEFAULT_BUFFER_SIZE);
@@ -186,6 +190,15 @@ pub fn get_buffer_size() -> usize {
     BUFFER_SIZE.load(Ordering::Relaxed)
 }
 
+/// Log lines written to the terminal since the start (wrapping): the shell
+/// redraws its input line when this moved since its last frame.
+static LINES_OUT: AtomicU32 = AtomicU32::new(0);
+
+#[inline]
+pub fn lines_out() -> u32 {
+    LINES_OUT.load(Ordering::Relaxed)
+}
+
 // ============================================================================
 // For hosted environments (std) - use a global static logger
 // ============================================================================
@@ -217,11 +230,13 @@ impl GlobalLogger {
         } else {
             println!("[{}] {}", level, message);
         }
+        LINES_OUT.fetch_add(1, Ordering::Relaxed);
     }
 
     #[inline]
     fn log_simple(&self, message: &str) {
         println!("{}", message);
+        LINES_OUT.fetch_add(1, Ordering::Relaxed);
     }
 }
 
@@ -270,99 +285,195 @@ pub fn log_simple_message(message: &str) {
 }
 
 // ============================================================================
-// For no_std environments - use a global logger with writer
+// For no_std environments - lines through the log ring to a global writer
 // ============================================================================
 
 #[cfg(not(feature = "hosted"))]
-struct GlobalLoggerWrapper {
-    config: LoggerConfig,
-    writer: &'static mut dyn LogWriter,
-}
+use core::sync::atomic::{AtomicBool, AtomicU8};
 
 #[cfg(not(feature = "hosted"))]
-impl GlobalLoggerWrapper {
-    fn new(config: LoggerConfig, writer: &'static mut dyn LogWriter) -> Self {
-        Self { config, writer }
-    }
+struct GlobalWriter(core::cell::UnsafeCell<Option<&'static mut dyn LogWriter>>);
 
-    fn log(&mut self, level: LogLevel, message: &str) {
-        if !level.is_enabled(self.config.min_level) {
-            return;
-        }
+// Safety: set once by init_logger() before any line is logged, then only
+// used by the context holding the drain of the ring.
+#[cfg(not(feature = "hosted"))]
+unsafe impl Sync for GlobalWriter {}
 
-        self.writer
-            .write_log(level, message, self.config.color_entire_line);
-    }
+#[cfg(not(feature = "hosted"))]
+static GLOBAL_WRITER: GlobalWriter = GlobalWriter(core::cell::UnsafeCell::new(None));
 
-    #[inline]
-    fn log_simple(&mut self, message: &str) {
-        self.writer.write_simple(message);
-    }
-}
+#[cfg(not(feature = "hosted"))]
+static LOGGER_READY: AtomicBool = AtomicBool::new(false);
+
+#[cfg(not(feature = "hosted"))]
+static MIN_LEVEL: AtomicU8 = AtomicU8::new(LogLevel::Info as u8);
+
+#[cfg(not(feature = "hosted"))]
+static COLOR_ENTIRE_LINE: AtomicBool = AtomicBool::new(false);
 
+/// fn() to wake the drain task, as usize (0: the logging context drains)
 #[cfg(not(feature = "hosted"))]
-static GLOBAL_LOGGER: Mutex<RefCell<Option<GlobalLoggerWrapper>>> = Mutex::new(RefCell::new(None));
+static DRAIN_NOTIFY: AtomicUsize = AtomicUsize::new(0);
 
+/// Room of a record beyond the message: color, "[", label, "] ", reset, EOL.
+#[cfg(not(feature = "hosted"))]
+const LINE_OVERHEAD: usize = 24;
+
+/// Suffix kept free at the end of a record: reset and "\r\n".
+#[cfg(not(feature = "hosted"))]
+const LINE_SUFFIX: usize = 6;
+
+/// Call once at start, before any task logs. `writer` is only ever used by
+/// the context draining the ring.
 #[cfg(not(feature = "hosted"))]
 pub fn init_logger(config: LoggerConfig, writer: &'static mut dyn LogWriter) {
-    critical_section::with(|cs| {
-        *GLOBAL_LOGGER.borrow_ref_mut(cs) = Some(GlobalLoggerWrapper::new(config, writer));
-    });
+    // Safety: one call, before any line is logged (nothing drains yet).
+    unsafe {
+        *GLOBAL_WRITER.0.get() = Some(writer);
+    }
+    MIN_LEVEL.store(config.min_level as u8, Ordering::Relaxed);
+    COLOR_ENTIRE_LINE.store(config.color_entire_line, Ordering::Relaxed);
+    LOGGER_READY.store(true, Ordering::Release);
 }
 
 #[cfg(not(feature = "hosted"))]
 pub fn set_color_entire_line(enabled: bool) {
-    critical_section::with(|cs| {
-        if let Some(logger) = GLOBAL_LOGGER.borrow_ref_mut(cs).as_mut() {
-            logger.config.color_entire_line = enabled;
-        }
-    });
+    COLOR_ENTIRE_LINE.store(enabled, Ordering::Relaxed);
 }
 
 #[cfg(not(feature = "hosted"))]
 pub fn set_min_level(level: LogLevel) {
-    critical_section::with(|cs| {
-        if let Some(logger) = GLOBAL_LOGGER.borrow_ref_mut(cs).as_mut() {
-            logger.config.min_level = level;
+    MIN_LEVEL.store(level as u8, Ordering::Relaxed);
+}
+
+/// Drain the ring from a task of its own: `notify` is called after each line
+/// is committed (from the logging context, an ISR maybe) and must only wake
+/// that task, which then calls [`drain_logs`]. `None`: the logging context
+/// drains the ring itself.
+#[cfg(not(feature = "hosted"))]
+pub fn set_drain_notify(notify: Option<fn()>) {
+    DRAIN_NOTIFY.store(notify.map_or(0, |f| f as usize), Ordering::Release);
+}
+
+/// Write the committed lines to the writer of [`init_logger`]; false if
+/// there was none to write, or another context is draining (it takes them).
+#[cfg(not(feature = "hosted"))]
+pub fn drain_logs() -> bool {
+    if !LOGGER_READY.load(Ordering::Acquire) {
+        return false;
+    }
+    // Safety: the writer is only used inside ring::drain(), one context at a time.
+    let writer = unsafe { (*GLOBAL_WRITER.0.get()).as_mut() };
+    match writer {
+        Some(writer) => {
+            let any = ring::drain(|line| writer.write_bytes(line));
+            if any {
+                writer.flush();
+                LINES_OUT.fetch_add(1, Ordering::Relaxed);
+            }
+            any
         }
-    });
+        None => false,
+    }
 }
 
+/// Lines lost because the log ring was full.
 #[cfg(not(feature = "hosted"))]
-pub fn log_with_level(level: LogLevel, message: &str) {
-    critical_section::with(|cs| {
-        if let Some(logger) = GLOBAL_LOGGER.borrow_ref_mut(cs).as_mut() {
-            logger.log(level, message);
+#[inline]
+pub fn dropped_logs() -> u32 {
+    ring::dropped()
+}
+
+#[cfg(not(feature = "hosted"))]
+#[inline]
+fn line_committed() {
+    match DRAIN_NOTIFY.load(Ordering::Acquire) {
+        0 => {
+            drain_logs();
         }
-    });
+        f => {
+            // Safety: stored from a fn() by set_drain_notify()
+            let notify: fn() = unsafe { core::mem::transmute::<usize, fn()>(f) };
+            notify();
+        }
+    }
+}
+
+/// Format a line into the log ring: the label when `level` is given, the
+/// message of up to `msg_len` bytes (longer, it is cut), the line end.
+#[cfg(not(feature = "hosted"))]
+#[doc(hidden)]
+pub fn log_args(level: Option<LogLevel>, msg_len: usize, args: fmt::Arguments<'_>) {
+    if !LOGGER_READY.load(Ordering::Acquire) {
+        return;
+    }
+    if let Some(level) = level {
+        if (level as u8) > MIN_LEVEL.load(Ordering::Relaxed) {
+            return;
+        }
+    }
+
+    let mut slot = match ring::reserve(msg_len + LINE_OVERHEAD) {
+        Some(slot) => slot,
+        None => return,
+    };
+    let color_entire_line = COLOR_ENTIRE_LINE.load(Ordering::Relaxed);
+
+    slot.keep(LINE_SUFFIX);
+    match level {
+        Some(level) if color_entire_line => {
+            let _ = write!(slot, "{}[{}] ", level.color(), level.label());
+        }
+        Some(level) => {
+            let _ = write!(slot, "[{}] ", level);
+        }
+        None => {}
+    }
+    let _ = slot.write_fmt(args);
+    slot.release();
+    if level.is_some() && color_entire_line {
+        let _ = Write::write_str(&mut slot, RESET);
+    }
+    let _ = Write::write_str(&mut slot, "\r\n");
+    drop(slot); // commit
+
+    line_committed();
+}
+
+#[cfg(not(feature = "hosted"))]
+pub fn log_with_level(level: LogLevel, message: &str) {
+    log_args(Some(level), message.len(), format_args!("{}", message));
 }
 
 #[cfg(not(feature = "hosted"))]
 #[inline]
 pub fn log_simple_message(message: &str) {
-    critical_section::with(|cs| {
-        if let Some(logger) = GLOBAL_LOGGER.borrow_ref_mut(cs).as_mut() {
-            logger.log_simple(message);
-        }
-    });
+    log_args(None, message.len(), format_args!("{}", message));
 }
 
 // ============================================================================
 // Get a reference to the global writer for shell use
 // ============================================================================
 
+/// Run `f` on the writer of [`init_logger`], after the lines logged so far.
+/// `None` while the writer is busy with the log ring in another context.
 #[cfg(not(feature = "hosted"))]
 pub fn with_global_writer<F, R>(f: F) -> Option<R>
 where
     F: FnOnce(&mut dyn UnifiedWriter) -> R,
 {
-    critical_section::with(|cs| {
-        if let Some(logger) = GLOBAL_LOGGER.borrow_ref_mut(cs).as_mut() {
-            Some(f(logger.writer))
-        } else {
-            None
-        }
+    if !LOGGER_READY.load(Ordering::Acquire) {
+        return None;
+    }
+    drain_logs();
+    // Safety: the drain lock makes this context the only user of the writer.
+    let result = ring::with_drain_lock(|| {
+        unsafe { (*GLOBAL_WRITER.0.get()).as_mut() }.map(|writer| f(&mut **writer))
     })
+    .flatten();
+    // lines committed while the writer was held
+    drain_logs();
+    result
 }
 
 // ============================================================================
@@ -435,63 +546,20 @@ impl<W: LogWriter> Logger<W> {
 }
 
 // ============================================================================
-// Unified Macros for both environments - with dynamic buffer sizing
+// Unified Macros for both environments
+// (no_std: formatted straight into the log ring, no stack buffer)
 // ============================================================================
 
-#[cfg(not(feature = "hosted"))]
-#[doc(hidden)]
-pub const fn select_buffer_size(size: usize) -> usize {
-    match size {
-        0..=64 => 64,
-        65..=128 => 128,
-        129..=256 => 256,
-        257..=512 => 512,
-        513..=1024 => 1024,
-        1025..=2048 => 2048,
-        _ => 4096,
-    }
-}
-
-// Internal helper macros for different buffer sizes
-#[cfg(not(feature = "hosted"))]
-#[doc(hidden)]
-#[macro_export]
-macro_rules! __log_with_size {
-    ($level:expr, $size:literal, $($arg:tt)*) => {{
-        use $crate::FmtWrite as _;
-        let mut msg_buf = $crate::heapless::String::<$size>::new();
-        let _ = ::core::write!(&mut msg_buf, $($arg)*);
-        $crate::log_with_level($level, msg_buf.as_str());
-    }};
-}
-
-#[cfg(not(feature = "hosted"))]
-#[doc(hidden)]
-#[macro_export]
-macro_rules! __log_simple_with_size {
-    ($size:literal, $($arg:tt)*) => {{
-        use $crate::FmtWrite as _;
-        let mut msg_buf = $crate::heapless::String::<$size>::new();
-        let _ = ::core::write!(&mut msg_buf, $($arg)*);
-        $crate::log_simple_message(msg_buf.as_str());
-    }};
-}
-
 #[macro_export]
 macro_rules! log {
     ($level:expr, $($arg:tt)*) => {{
         #[cfg(not(feature = "hosted"))]
         {
-            let size = $crate::get_buffer_size();
-            match size {
-                0..=64 => $crate::__log_with_size!($level, 64, $($arg)*),
-                65..=128 => $crate::__log_with_size!($level, 128, $($arg)*),
-                129..=256 => $crate::__log_with_size!($level, 256, $($arg)*),
-                257..=512 => $crate::__log_with_size!($level, 512, $($arg)*),
-                513..=1024 => $crate::__log_with_size!($level, 1024, $($arg)*),
-                1025..=2048 => $crate::__log_with_size!($level, 2048, $($arg)*),
-                _ => $crate::__log_with_size!($level, 4096, $($arg)*),
-            }
+            $crate::logger::log_args(
+                ::core::option::Option::Some($level),
+                $crate::get_buffer_size(),
+                ::core::format_args!($($arg)*),
+            );
         }
         #[cfg(feature = "hosted")]
         {
@@ -506,10 +574,11 @@ macro_rules! log_with_buffer_size {
     ($level:expr, $size:literal, $($arg:tt)*) => {{
         #[cfg(not(feature = "hosted"))]
         {
-            use $crate::FmtWrite as _;
-            let mut msg_buf = $crate::heapless::String::<$size>::new();
-            let _ = ::core::write!(&mut msg_buf, $($arg)*);
-            $crate::log_with_level($level, msg_buf.as_str());
+            $crate::logger::log_args(
+                ::core::option::Option::Some($level),
+                $size,
+                ::core::format_args!($($arg)*),
+            );
         }
         #[cfg(feature = "hosted")]
         {
@@ -567,17 +636,11 @@ macro_rules! log_simple {
     ($($arg:tt)*) => {{
         #[cfg(not(feature = "hosted"))]
         {
-            // Buffer size selection based on initialization
-            let size = $crate::get_buffer_size();
-            match size {
-                0..=64 => $crate::__log_simple_with_size!(64, $($arg)*),
-                65..=128 => $crate::__log_simple_with_size!(128, $($arg)*),
-                129..=256 => $crate::__log_simple_with_size!(256, $($arg)*),
-                257..=512 => $crate::__log_simple_with_size!(512, $($arg)*),
-                513..=1024 => $crate::__log_simple_with_size!(1024, $($arg)*),
-                1025..=2048 => $crate::__log_simple_with_size!(2048, $($arg)*),
-                _ => $crate::__log_simple_with_size!(4096, $($arg)*),
-            }
+            $crate::logger::log_args(
+                ::core::option::Option::None,
+                $crate::get_buffer_size(),
+                ::core::format_args!($($arg)*),
+            );
         }
         #[cfg(feature = "hosted")]
         {
@@ -592,10 +655,11 @@ macro_rules! log_simple_with_buffer_size {
     ($size:literal, $($arg:tt)*) => {{
         #[cfg(not(feature = "hosted"))]
         {
-            use $crate::FmtWrite as _;
-            let mut msg_buf = $crate::heapless::String::<$size>::new();
-            let _ = ::core::write!(&mut msg_buf, $($arg)*);
-            $crate::log_simple_message(msg_buf.as_str());
+            $crate::logger::log_args(
+                ::core::option::Option::None,
+                $size,
+                ::core::format_args!($($arg)*),
+            );
         }
         #[cfg(feature = "hosted")]
         {
@@ -0,0 +1,223 @@
+// Lock-free multi-producer byte ring for the no_std logger
+//
+// A producer reserves a record (CAS on the head), formats the line straight
+// into it and commits it; the drain (one at a time) hands the committed
+// records to the log writer in order, then frees them. No interrupt is
+// masked and no stack buffer is taken while a line is formatted.
+//
+// Record: a 4-byte header, then the line; 4-byte aligned, contiguous (a
+// record which would cross the end of the ring is preceded by a pad record
+// up to the end). Header: bit 31 committed, bits 16..30 the bytes of the
+// line, bits 0..15 the size of the record. A record is reserved for the
+// longest line; the part the line did not use is skipped by the drain.
+//
+// The drain zeroes what it frees, so a header still 0 is a record reserved
+// and not committed yet: the drain stops there and the records behind it
+// wait for it (lines come out in reservation order).
+
+use core::cell::UnsafeCell;
+use core::fmt;
+use core::sync::atomic::{AtomicBool, AtomicU32, AtomicUsize, Ordering};
+
+/// Size of the ring in bytes (a power of two, at most 32768).
+pub const LOG_RING_SIZE: usize = 1024;
+
+const HEADER: usize = 4;
+const COMMITTED: u32 = 1 << 31;
+
+const _: () = assert!(LOG_RING_SIZE.is_power_of_two() && LOG_RING_SIZE <= 32768);
+
+#[repr(C, align(4))]
+struct RingBuf(UnsafeCell<[u8; LOG_RING_SIZE]>);
+
+// Safety: a byte range is written by the one producer which reserved it,
+// then read and zeroed by the one drain; the head / tail / header atomics
+// order the hand-overs.
+unsafe impl Sync for RingBuf {}
+
+static RING: RingBuf = RingBuf(UnsafeCell::new([0; LOG_RING_SIZE]));
+
+/// Bytes reserved since the start (wrapping); the next record starts here.
+static HEAD: AtomicUsize = AtomicUsize::new(0);
+
+/// Bytes freed by the drain since the start (wrapping).
+static TAIL: AtomicUsize = AtomicUsize::new(0);
+
+/// Held by the one context draining.
+static DRAINING: AtomicBool = AtomicBool::new(false);
+
+/// Lines lost because the ring was full.
+static DROPPED: AtomicU32 = AtomicU32::new(0);
+
+#[inline]
+const fn align4(n: usize) -> usize {
+    (n + 3) & !3
+}
+
+#[inline]
+fn header_at(pos: usize) -> &'static AtomicU32 {
+    // Safety: pos is 4-aligned and inside the ring, the ring is 4-aligned;
+    // AtomicU32 has the layout of u32.
+    unsafe { &*((RING.0.get() as *const u8).add(pos) as *const AtomicU32) }
+}
+
+/// A reserved record, formatted into through `fmt::Write`; committed on
+/// drop, a line which does not fit is cut (at a char boundary).
+pub struct Slot {
+    pos: usize,
+    size: usize,
+    len: usize,
+    limit: usize,
+}
+
+impl Slot {
+    #[inline]
+    fn payload(&mut self) -> &mut [u8] {
+        // Safety: [pos + HEADER, pos + size) is this record's, reserved by
+        // us and not visible to the drain before the commit.
+        unsafe {
+            let base = (RING.0.get() as *mut u8).add(self.pos + HEADER);
+            core::slice::from_raw_parts_mut(base, self.size - HEADER)
+        }
+    }
+
+    /// Keep `n` bytes at the end for the suffix of the line (reset, EOL).
+    #[inline]
+    pub fn keep(&mut self, n: usize) {
+        self.limit = (self.size - HEADER).saturating_sub(n);
+    }
+
+    /// Lift [`Slot::keep`]: the suffix goes into the room kept for it.
+    #[inline]
+    pub fn release(&mut self) {
+        self.limit = self.size - HEADER;
+    }
+
+    fn put(&mut self, s: &str) -> fmt::Result {
+        let room = self.limit.saturating_sub(self.len);
+        let mut n = s.len().min(room);
+        while !s.is_char_boundary(n) {
+            n -= 1;
+        }
+        let start = self.len;
+        self.payload()[start..start + n].copy_from_slice(&s.as_bytes()[..n]);
+        self.len += n;
+        if n < s.len() { Err(fmt::Error) } else { Ok(()) }
+    }
+}
+
+impl fmt::Write for Slot {
+    #[inline]
+    fn write_str(&mut self, s: &str) -> fmt::Result {
+        self.put(s)
+    }
+}
+
+impl Drop for Slot {
+    fn drop(&mut self) {
+        let header = COMMITTED | ((self.len as u32) << 16) | self.size as u32;
+        header_at(self.pos).store(header, Ordering::Release);
+    }
+}
+
+/// Reserve a record for a line of up to `line_len` bytes; `None` (the line
+/// is counted as dropped) while the ring has no room for it.
+pub fn reserve(line_len: usize) -> Option<Slot> {
+    let size = align4(HEADER + line_len).min(LOG_RING_SIZE / 2);
+    let mut head = HEAD.load(Ordering::Relaxed);
+
+    loop {
+        let pos = head & (LOG_RING_SIZE - 1);
+        // up to the end of the ring first if the record would cross it
+        let pad = if pos + size > LOG_RING_SIZE { LOG_RING_SIZE - pos } else { 0 };
+        let tail = TAIL.load(Ordering::Acquire);
+
+        if head.wrapping_sub(tail) + pad + size > LOG_RING_SIZE {
+            DROPPED.fetch_add(1, Ordering::Relaxed);
+            return None;
+        }
+
+        match HEAD.compare_exchange_weak(
+            head,
+            head.wrapping_add(pad + size),
+            Ordering::Acquire,
+            Ordering::Relaxed,
+        ) {
+            Ok(_) => {
+                if pad != 0 {
+                    header_at(pos).store(COMMITTED | pad as u32, Ordering::Release);
+                }
+                let pos = (pos + pad) & (LOG_RING_SIZE - 1);
+                return Some(Slot { pos, size, len: 0, limit: size - HEADER });
+            }
+            Err(now) => head = now,
+        }
+    }
+}
+
+/// Hand the committed records to `out` in order and free them; a no-op
+/// (false) while another context drains. Records committed meanwhile by a
+/// context this one preempted or which preempted it are taken too.
+pub fn drain(mut out: impl FnMut(&[u8])) -> bool {
+    let mut any = false;
+
+    loop {
+        if DRAINING.swap(true, Ordering::Acquire) {
+            return any;
+        }
+
+        loop {
+            let tail = TAIL.load(Ordering::Relaxed);
+            if tail == HEAD.load(Ordering::Acquire) {
+                break;
+            }
+            let pos = tail & (LOG_RING_SIZE - 1);
+            let header = header_at(pos).load(Ordering::Acquire);
+            if header & COMMITTED == 0 {
+                break; // reserved, still being formatted
+            }
+            let size = (header & 0xFFFF) as usize;
+            let len = ((header >> 16) & 0x7FFF) as usize;
+
+            // Safety: [pos, pos + size) was committed and is ours until
+            // TAIL moves past it.
+            unsafe {
+                let base = (RING.0.get() as *mut u8).add(pos);
+                if len != 0 {
+                    out(core::slice::from_raw_parts(base.add(HEADER), len));
+                    any = true;
+                }
+                core::ptr::write_bytes(base, 0, size);
+            }
+            TAIL.store(tail.wrapping_add(size), Ordering::Release);
+        }
+
+        DRAINING.store(false, Ordering::Release);
+
+        // a record committed after the check above, whose own drain found
+        // DRAINING held, is taken by another round
+        let tail = TAIL.load(Ordering::Relaxed);
+        if tail == HEAD.load(Ordering::Acquire)
+            || header_at(tail & (LOG_RING_SIZE - 1)).load(Ordering::Acquire) & COMMITTED == 0
+        {
+            return any;
+        }
+    }
+}
+
+/// Run `f` holding the drain (the log writer is the caller's); `None`
+/// while another context drains.
+pub fn with_drain_lock<R>(f: impl FnOnce() -> R) -> Option<R> {
+    if DRAINING.swap(true, Ordering::Acquire) {
+        return None;
+    }
+    let result = f();
+    DRAINING.store(false, Ordering::Release);
+    Some(result)
+}
+
+/// Lines lost because the ring was full, since the start.
+#[inline]
+pub fn dropped() -> u32 {
+    DROPPED.load(Ordering::Relaxed)
+}
@@ -14,7 +14,18 @@
 //! - **Async mode** (`async` feature): `UartReader::read_byte()` returns `impl Future`
 //! - **Sync mode** (no feature): `UartReader::read_byte()` polls a function pointer
 //!
+//! `run_shell()` takes the input a burst at a time through `UartReader::read_chunk()`
+//! (a paste, an escape sequence), so the executor is entered once per burst, not per byte.
+//!
 //! This provides a unified `run_shell()` function that works in both environments.
+//!
+//! ## Several sessions
+//!
+//! A `run_shell()` future owns its session: input buffer, history, autocomplete
+//! state and key parser. Several of them, each on its own transport (its own
+//! write/flush functions and reader), run side by side in one task when joined
+//! (`embassy_futures::join`); they share the command tables of one `ShellConfig`
+//! (`Copy`) and the logger.
 
 #![no_std]
 #![no_implicit_prelude]
@@ -63,6 +74,63 @@ pub trait UartReader {
 
     #[cfg(not(feature = "async"))]
     fn read_byte(&mut self) -> Option<u8>;
+
+    /// Read the bytes there are into `buf`, returns how many (at most `buf.len()`).
+    ///
+    /// # Async Mode (`async` feature)
+    /// Resolves once at least one byte is in `buf`, or to 0 where `read_byte()`
+    /// would resolve to `None`.
+    ///
+    /// # Sync Mode (default)
+    /// Returns immediately, 0 if no data.
+    ///
+    /// The default takes one byte from `read_byte()`; a reader with a buffer
+    /// behind it hands on all it has.
+    #[cfg(feature = "async")]
+    fn read_chunk(&mut self, buf: &mut [u8]) -> impl core::future::Future<Output = usize> {
+        async move {
+            match self.read_byte().await {
+                Some(byte) if !buf.is_empty() => {
+                    buf[0] = byte;
+                    1
+                }
+                _ => 0,
+            }
+        }
+    }
+
+    #[cfg(not(feature = "async"))]
+    fn read_chunk(&mut self, buf: &mut [u8]) -> usize {
+        match self.read_byte() {
+            Some(byte) if !buf.is_empty() => {
+                buf[0] = byte;
+                1
+            }
+            _ => 0,
+        }
+    }
+}
+
+/// Bytes `run_shell()` takes from the reader at a time.
+pub const READ_CHUNK_SIZE: usize = 32;
+
+/// Fill `buf` from a non-blocking read function, returns the count.
+#[inline]
+fn drain_into<F>(try_read_fn: &mut F, buf: &mut [u8]) -> usize
+where
+    F: FnMut() -> Option<u8>,
+{
+    let mut count = 0;
+    while count < buf.len() {
+        match try_read_fn() {
+            Some(byte) => {
+                buf[count] = byte;
+                count += 1;
+            }
+            None => break,
+        }
+    }
+    count
 }
 
 // ============================================================================
@@ -109,6 +177,11 @@ mod sync_impl {
         fn read_byte(&mut self) -> Option<u8> {
             (self.read_fn)()
         }
+
+        #[inline]
+        fn read_chunk(&mut self, buf: &mut [u8]) -> usize {
+            super::drain_into(&mut self.read_fn, buf)
+        }
     }
 }
 
@@ -194,6 +267,84 @@ mod async_impl {
 
             None
         }
+
+        async fn read_chunk(&mut self, buf: &mut [u8]) -> usize {
+            let count = drain_into(&mut self.try_read_fn, buf);
+            if count > 0 {
+                self.empty_count = 0;
+                return count;
+            }
+
+            // Same yield rule as read_byte(), counted per empty chunk
+            self.empty_count += 1;
+            if self.empty_count >= self.yield_threshold {
+                ((self.yield_fn)()).await;
+                self.empty_count = 0;
+            }
+
+            0
+        }
+    }
+
+    /// Async UART reader that sleeps until a byte is there.
+    ///
+    /// The future of `read_fn` resolves to the next byte (e.g. `channel.receive()`),
+    /// so the shell task is only woken by input: no polling, no timer while idle.
+    /// A chunk is the byte it woke for plus what `try_read_fn` has behind it.
+    pub struct WaitReader<F, R, T>
+    where
+        F: FnMut() -> R,
+        R: core::future::Future<Output = u8>,
+        T: FnMut() -> Option<u8>,
+    {
+        read_fn: F,
+        try_read_fn: T,
+    }
+
+    impl<F, R, T> WaitReader<F, R, T>
+    where
+        F: FnMut() -> R,
+        R: core::future::Future<Output = u8>,
+        T: FnMut() -> Option<u8>,
+    {
+        /// Create a new waiting reader.
+        ///
+        /// # Parameters
+        ///
+        /// - `read_fn`: Function returning a Future of the next byte (e.g., channel.receive())
+        /// - `try_read_fn`: Non-blocking read of the same source (e.g., channel.try_receive())
+        ///
+        /// # Example
+        ///
+        /// ```no_run
+        /// let reader = WaitReader::new(
+        ///     || RX_CHANNEL.receive(),
+        ///     || RX_CHANNEL.try_receive().ok(),
+        /// );
+        /// ```
+        #[inline]
+        pub const fn new(read_fn: F, try_read_fn: T) -> Self {
+            Self { read_fn, try_read_fn }
+        }
+    }
+
+    impl<F, R, T> UartReader for WaitReader<F, R, T>
+    where
+        F: FnMut() -> R,
+        R: core::future::Future<Output = u8>,
+        T: FnMut() -> Option<u8>,
+    {
+        async fn read_byte(&mut self) -> Option<u8> {
+            Some((self.read_fn)().await)
+        }
+
+        async fn read_chunk(&mut self, buf: &mut [u8]) -> usize {
+            if buf.is_empty() {
+                return 0;
+            }
+            buf[0] = (self.read_fn)().await;
+            1 + drain_into(&mut self.try_read_fn, &mut buf[1..])
+        }
     }
 }
 
@@ -201,8 +352,12 @@ mod async_impl {
 // Shell Configuration
 // ============================================================================
 
+/// The command tables and prompt of a shell; copied into each session.
+#[derive(::core::clone::Clone, ::core::marker::Copy)]
 pub struct ShellConfig<const IML: usize, const EBS: usize> {
     pub get_commands: fn() -> &'static [(&'static str, &'static str)],
+    /// The prefix index of the command table (`commands::get_name_lcp`), `|| &[]` for none.
+    pub get_name_lcp: fn() -> &'static [u8],
     pub get_datatypes: fn() -> &'static str,
     pub get_shortcuts: fn() -> &'static str,
     pub is_shortcut: fn(&str) -> bool,
@@ -271,12 +426,14 @@ pub async fn run_shell<
 
     // Get static data references once before loop instead of calling every iteration
     let commands = (config.get_commands)();
+    let name_lcp = (config.get_name_lcp)();
     let datatypes = (config.get_datatypes)();
     let shortcuts = (config.get_shortcuts)();
 
     let mut parser = InputParser::<CallbackWriter<fn(&[u8]), fn()>, NAC, FNL, IML, HTC>::new(
         writer,
         commands,
+        name_lcp,
         datatypes,
         shortcuts,
         config.prompt,
@@ -284,34 +441,38 @@ pub async fn run_shell<
 
     let mut key_parser = AnsiKeyParser::new();
     let mut pending_key: Option<Key> = None;
+    let mut chunk = [0u8; READ_CHUNK_SIZE];
 
     loop {
-        // Async read - yields to executor when no data available
-        if let Some(byte) = reader.read_byte().await {
-            if let Some(key) = key_parser.parse_byte(byte) {
-                pending_key = Some(key);
+        // Async read - yields to executor until a burst of input is there
+        let count = reader.read_chunk(&mut chunk).await;
+
+        for &byte in &chunk[..count] {
+            pending_key = key_parser.parse_byte(byte);
+            if pending_key.is_none() {
+                continue;
             }
-        }
 
-        // Process pending key
-        let continue_running = parser.parse_input(
-            || pending_key.take(),
-            |s: &str| {
-                write_fn(s.as_bytes());
-            },
-            |input: &String<IML>| {
-                // Pass input as &str to avoid potential string copies
-                exec::<EBS>(
-                    input.as_str(),
-                    config.is_shortcut,
-                    config.command_dispatcher,
-                    config.shortcut_dispatcher,
-                )
-            },
-        );
-
-        if !continue_running {
-            break;
+            // Process the key
+            let continue_running = parser.parse_input(
+                || pending_key.take(),
+                |s: &str| {
+                    write_fn(s.as_bytes());
+                },
+                |input: &String<IML>| {
+                    // Pass input as &str to avoid potential string copies
+                    exec::<EBS>(
+                        input.as_str(),
+                        config.is_shortcut,
+                        config.command_dispatcher,
+                        config.shortcut_dispatcher,
+                    )
+                },
+            );
+
+            if !continue_running {
+                return;
+            }
         }
     }
 }
@@ -334,12 +495,14 @@ pub fn run_shell<
 
     // Get static data references once before loop
     let commands = (config.get_commands)();
+    let name_lcp = (config.get_name_lcp)();
     let datatypes = (config.get_datatypes)();
     let shortcuts = (config.get_shortcuts)();
 
     let mut parser = InputParser::<CallbackWriter<fn(&[u8]), fn()>, NAC, FNL, IML, HTC>::new(
         writer,
         commands,
+        name_lcp,
         datatypes,
         shortcuts,
         config.prompt,
@@ -347,35 +510,39 @@ pub fn run_shell<
 
     let mut key_parser = AnsiKeyParser::new();
     let mut pending_key: Option<Key> = None;
+    let mut chunk = [0u8; READ_CHUNK_SIZE];
 
     loop {
-        // Sync read - polls without yielding
-        if let Some(byte) = reader.read_byte() {
-            if let Some(key) = key_parser.parse_byte(byte) {
-                pending_key = Some(key);
+        // Sync read - polls without yielding, all the input there is
+        let count = reader.read_chunk(&mut chunk);
+
+        for &byte in &chunk[..count] {
+            pending_key = key_parser.parse_byte(byte);
+            if pending_key.is_none() {
+                continue;
             }
-        }
 
-        // Process pending key
-        // Avoid closure allocation in write callback
-        let continue_running = parser.parse_input(
-            || pending_key.take(),
-            |s: &str| {
-                write_fn(s.as_bytes());
-            },
-            |input: &String<IML>| {
-                // Pass input as &str to avoid potential string copies
-                exec::<EBS>(
-                    input.as_str(),
-                    config.is_shortcut,
-                    config.command_dispatcher,
-                    config.shortcut_dispatcher,
-                )
-            },
-        );
-
-        if !continue_running {
-            break;
+            // Process the key
+            // Avoid closure allocation in write callback
+            let continue_running = parser.parse_input(
+                || pending_key.take(),
+                |s: &str| {
+                    write_fn(s.as_bytes());
+                },
+                |input: &String<IML>| {
+                    // Pass input as &str to avoid potential string copies
+                    exec::<EBS>(
+                        input.as_str(),
+                        config.is_shortcut,
+                        config.command_dispatcher,
+                        config.shortcut_dispatcher,
+                    )
+                },
+            );
+
+            if !continue_running {
+                return;
+            }
         }
     }
 }
@@ -413,4 +580,4 @@ fn exec<const EBS: usize>(
 pub use sync_impl::PollingReader as SyncReader;
 
 #[cfg(feature = "async")]
-pub use async_impl::AsyncReader;
+pub use async_impl::{AsyncReader, WaitReader};
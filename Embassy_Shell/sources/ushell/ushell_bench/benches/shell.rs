@@ -0,0 +1,211 @@
+//! The hot paths of the shell on the host, per table size where it matters:
+//!
+//!   dispatch        the lines of the table (every descriptor), then an unknown name
+//!   shortcuts       the shortcuts of ushell_usercode, with and without a parameter
+//!   tokenize        the same lines into a token array
+//!   parse_hexstr    hex strings of 4 .. 64 bytes
+//!   history         push into a full ring, and the oldest entry read back, with and
+//!                   without the offsets index (`history-index`)
+//!   autocomplete    a one letter and a longer prefix, by first letter scan and by the
+//!                   prefix index of the table
+//!   renderer        typing at the end and in the middle of a line, a full redraw
+//!
+//! cargo bench keeps the last run in target/criterion and reports the change against it;
+//! `-- --save-baseline <name>` / `-- --baseline <name>` compare with a named one (README.md).
+
+use std::hint::black_box;
+
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use heapless::String;
+
+use ushell2::autocomplete::Autocomplete;
+use ushell2::history::{History, HISTORY_INDEX_DEPTH};
+use ushell2::input::buffer::Edit;
+use ushell2::input::renderer::DisplayRenderer;
+use ushell_bench::{shortcuts, Sink, ERROR_BUFFER_SIZE, TABLES};
+
+const HISTORY_BYTES: usize = 512;
+const NAC: usize = 64;
+const FNL: usize = 16;
+
+fn bench_dispatch(c: &mut Criterion) {
+    let mut group = c.benchmark_group("dispatch");
+    for table in &TABLES {
+        group.throughput(Throughput::Elements(table.lines.len() as u64));
+        group.bench_with_input(BenchmarkId::new("hit", table.size), table, |b, table| {
+            b.iter(|| {
+                for line in table.lines {
+                    let mut error = String::<ERROR_BUFFER_SIZE>::new();
+                    let _ = black_box((table.dispatch)(black_box(line), &mut error));
+                }
+            })
+        });
+        group.throughput(Throughput::Elements(1));
+        group.bench_with_input(BenchmarkId::new("miss", table.size), table, |b, table| {
+            b.iter(|| {
+                let mut error = String::<ERROR_BUFFER_SIZE>::new();
+                let _ = black_box((table.dispatch)(black_box("zcmd9999 1 2"), &mut error));
+            })
+        });
+    }
+    group.finish();
+}
+
+fn bench_shortcuts(c: &mut Criterion) {
+    const LINES: [&str; 4] = ["++", "+l led 1", ".z", "-w 0x20 0x7F"];
+    let mut group = c.benchmark_group("shortcuts");
+    group.throughput(Throughput::Elements(LINES.len() as u64));
+    group.bench_function("hit", |b| {
+        b.iter(|| {
+            for line in LINES {
+                let mut error = String::<ERROR_BUFFER_SIZE>::new();
+                let _ = black_box(shortcuts::dispatch(black_box(line), &mut error));
+            }
+        })
+    });
+    group.finish();
+}
+
+fn bench_tokenize(c: &mut Criterion) {
+    let table = &TABLES[0];
+    let mut group = c.benchmark_group("tokenize");
+    group.throughput(Throughput::Elements(table.lines.len() as u64));
+    group.bench_function("lines", |b| {
+        b.iter(|| {
+            let mut out = [""; 8];
+            for line in table.lines {
+                black_box((table.tokenize)(black_box(line), &mut out));
+            }
+        })
+    });
+    group.finish();
+}
+
+fn bench_parse_hexstr(c: &mut Criterion) {
+    let table = &TABLES[0];
+    let mut group = c.benchmark_group("parse_hexstr");
+    for bytes in [4usize, 16, 64] {
+        let text: std::string::String = (0..bytes).map(|i| format!("{:02X}", i * 37 % 256)).collect();
+        group.throughput(Throughput::Bytes(bytes as u64));
+        group.bench_with_input(BenchmarkId::from_parameter(bytes), &text, |b, text| {
+            b.iter(|| black_box((table.parse_hexstr)(black_box(text))))
+        });
+    }
+    group.finish();
+}
+
+/// Distinct lines (the history drops a duplicate of any entry), far more than it holds.
+fn history_lines() -> Vec<std::string::String> {
+    (0..4096).map(|i| format!("write file{i}.bin {} 0x{:02X}", i * 7, i % 256)).collect()
+}
+
+fn bench_history_of<const HIX: usize>(c: &mut Criterion, label: &str, lines: &[std::string::String]) {
+    let mut group = c.benchmark_group("history");
+
+    group.bench_function(BenchmarkId::new("push", label), |b| {
+        let mut history = History::<HISTORY_BYTES, HIX>::new();
+        let mut next = 0usize;
+        b.iter(|| {
+            black_box(history.push(black_box(&lines[next % lines.len()])));
+            next += 1;
+        })
+    });
+
+    let mut history = History::<HISTORY_BYTES, HIX>::new();
+    for line in lines.iter().take(256) {
+        history.push(line);
+    }
+    group.bench_function(BenchmarkId::new("get_oldest", label), |b| {
+        let mut buffer = [0u8; 64];
+        b.iter(|| black_box(history.get_into_buffer(black_box(0), &mut buffer)))
+    });
+    group.finish();
+}
+
+fn bench_history(c: &mut Criterion) {
+    let lines = history_lines();
+    bench_history_of::<0>(c, "scan", &lines);
+    if HISTORY_INDEX_DEPTH > 0 {
+        bench_history_of::<HISTORY_INDEX_DEPTH>(c, "index", &lines);
+    }
+}
+
+fn bench_autocomplete(c: &mut Criterion) {
+    let mut group = c.benchmark_group("autocomplete");
+    for table in &TABLES {
+        for prefix in ["m", "mcmd00"] {
+            let id = format!("{}/{prefix}", table.size);
+            group.bench_function(BenchmarkId::new("scan", &id), |b| {
+                let mut ac = Autocomplete::<NAC, FNL>::new();
+                b.iter(|| {
+                    ac.reset();
+                    ac.update_input(black_box(prefix), |first| table.names_starting_with(first));
+                    black_box(ac.current_input().len())
+                })
+            });
+            group.bench_function(BenchmarkId::new("indexed", &id), |b| {
+                let mut ac = Autocomplete::<NAC, FNL>::new();
+                let (commands, lcp) = ((table.commands)(), (table.name_lcp)());
+                b.iter(|| {
+                    ac.update_input_indexed(black_box(prefix), commands, lcp);
+                    black_box(ac.current_input().len())
+                })
+            });
+        }
+    }
+    group.finish();
+}
+
+fn bench_renderer(c: &mut Criterion) {
+    const PROMPT: &str = ">> ";
+    let line: Vec<char> = "write file0042.bin 4096 0x7F \"a quoted argument\"".chars().collect();
+    let mut group = c.benchmark_group("renderer");
+    group.throughput(Throughput::Elements(line.len() as u64));
+
+    group.bench_function("type_at_end", |b| {
+        let mut renderer = DisplayRenderer::new(Sink::default());
+        b.iter(|| {
+            renderer.prompt_shown();
+            for at in 0..line.len() {
+                renderer.render_edit(PROMPT, &line[..=at], at + 1, Edit::Insert { at });
+            }
+        })
+    });
+
+    group.bench_function("type_in_middle", |b| {
+        let mut renderer = DisplayRenderer::new(Sink::default());
+        let tail = line.len() / 2;
+        b.iter(|| {
+            renderer.prompt_shown();
+            renderer.render_edit(PROMPT, &line[line.len() - tail..], 0, Edit::From(0));
+            // the first half typed in front of the tail, the cursor before it
+            let mut shown: Vec<char> = line[line.len() - tail..].to_vec();
+            for (at, &ch) in line[..line.len() - tail].iter().enumerate() {
+                shown.insert(at, ch);
+                renderer.render_edit(PROMPT, &shown, at + 1, Edit::Insert { at });
+            }
+        })
+    });
+
+    group.throughput(Throughput::Elements(1));
+    group.bench_function("redraw", |b| {
+        let mut renderer = DisplayRenderer::new(Sink::default());
+        b.iter(|| {
+            renderer.invalidate();
+            renderer.render_edit(PROMPT, black_box(&line), line.len(), Edit::None);
+        })
+    });
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_dispatch,
+    bench_shortcuts,
+    bench_tokenize,
+    bench_parse_hexstr,
+    bench_history,
+    bench_autocomplete,
+    bench_renderer
+);
+criterion_main!(benches);
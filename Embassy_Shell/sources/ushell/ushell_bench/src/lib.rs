@@ -0,0 +1,124 @@
+//! Host benchmarks of the shell crates: the synthetic command tables of `build.rs`, the
+//! dispatchers `generate_commands_dispatcher!` makes of them, and one view of each for
+//! `benches/shell.rs`.
+//!
+//! The crate is a member of the workspace but not a default one: the firmware builds leave
+//! it out, `cargo bench` builds it for the host (README.md).
+
+use heapless::String;
+
+pub const MAX_HEXSTR_LEN: usize = 64;
+pub const ERROR_BUFFER_SIZE: usize = 32;
+
+include!(concat!(env!("OUT_DIR"), "/tables.rs"));
+
+/// The handlers of `shortcuts.cfg`, the shortcuts of ushell_usercode.
+pub mod sc {
+    macro_rules! handlers {
+        ($($name:ident),*) => { $( pub fn $name(param: &str) { core::hint::black_box(param); } )* };
+    }
+    handlers!(plus_plus, plus_l, plus_m, plus_question_mark, plus_tilde, dot_dot, dot_z, dot_k,
+              minus_dot, minus_t, minus_u, minus_w);
+}
+
+ushell_dispatcher::generate_shortcuts_dispatcher! {
+    mod shortcuts;
+    error_buffer_size = crate::ERROR_BUFFER_SIZE;
+    path              = "src/shortcuts.cfg"
+}
+
+/// One generated table, whatever its size.
+pub struct Table {
+    pub size: usize,
+    /// Command lines for commands spread over the table, every descriptor.
+    pub lines: &'static [&'static str],
+    pub dispatch: for<'a> fn(&'a str, &'a mut String<ERROR_BUFFER_SIZE>) -> Result<(), &'a str>,
+    pub tokenize: for<'a> fn(&'a str, &mut [&'a str]) -> Option<usize>,
+    pub parse_hexstr: fn(&str) -> Option<heapless::Vec<u8, MAX_HEXSTR_LEN>>,
+    pub names: fn() -> &'static [&'static str],
+    pub commands: fn() -> &'static [(&'static str, &'static str)],
+    pub name_lcp: fn() -> &'static [u8],
+}
+
+macro_rules! table {
+    ($size:literal, $f:ident, $t:ident) => {
+        Table {
+            size: $size,
+            lines: $f::LINES,
+            dispatch: $t::dispatch,
+            tokenize: |line, out| $t::tokenize(line, out).ok(),
+            parse_hexstr: $t::parse_hexstr,
+            names: $t::get_function_names,
+            commands: $t::get_commands,
+            name_lcp: $t::get_name_lcp,
+        }
+    };
+}
+
+/// The tables, smallest first.
+pub static TABLES: [Table; 3] = [
+    table!(10, f10, t10),
+    table!(100, f100, t100),
+    table!(1000, f1000, t1000),
+];
+
+impl Table {
+    /// The names starting with `first`, for `Autocomplete::update_input` (the names are
+    /// sorted, they are one run).
+    pub fn names_starting_with(&self, first: char) -> &'static [&'static str] {
+        let names = (self.names)();
+        let start = names.partition_point(|n| n.chars().next() < Some(first));
+        let end = names.partition_point(|n| n.chars().next() <= Some(first));
+        &names[start..end]
+    }
+}
+
+/// A writer which takes the output of the renderer and drops it.
+#[derive(Default)]
+pub struct Sink {
+    pub bytes: usize,
+}
+
+impl core::fmt::Write for Sink {
+    fn write_str(&mut self, s: &str) -> core::fmt::Result {
+        self.bytes += core::hint::black_box(s).len();
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_lines_dispatch() {
+        for table in &TABLES {
+            assert_eq!((table.names)().len(), table.size);
+            for line in table.lines {
+                let mut error = String::<ERROR_BUFFER_SIZE>::new();
+                assert_eq!((table.dispatch)(line, &mut error), Ok(()), "{line}");
+            }
+        }
+    }
+
+    #[test]
+    fn test_shortcuts_dispatch() {
+        let mut error = String::<ERROR_BUFFER_SIZE>::new();
+        assert_eq!(shortcuts::dispatch("+l  led 1 ", &mut error), Ok(()));
+        assert_eq!(shortcuts::dispatch("-w", &mut error), Ok(()));
+        assert!(shortcuts::dispatch("+x 1", &mut error).unwrap_err().contains("+x"));
+        assert!(shortcuts::dispatch("é1", &mut error).is_err());
+        assert!(shortcuts::dispatch("+", &mut error).is_err());
+        assert!(shortcuts::is_supported_shortcut(" ."));
+        assert!(!shortcuts::is_supported_shortcut("x"));
+        assert!(!shortcuts::is_supported_shortcut("\u{7f}"));
+    }
+
+    #[test]
+    fn test_names_starting_with() {
+        let names = TABLES[2].names_starting_with('m');
+        assert!(!names.is_empty());
+        assert!(names.iter().all(|n| n.starts_with('m')));
+        assert_eq!(names.len(), (TABLES[2].names)().iter().filter(|n| n.starts_with('m')).count());
+    }
+}
@@ -89,6 +89,19 @@ struct HostCounts {
     hexstr_c: usize,
 }
 
+/// Common prefix length of each sorted name with the previous one, 0 for the first.
+fn name_lcp_table<'n>(names: impl Iterator<Item = &'n str>) -> Vec<u8> {
+    let mut prev: &[u8] = &[];
+    names
+        .map(|name| {
+            let bytes = name.as_bytes();
+            let lcp = prev.iter().zip(bytes).take_while(|(a, b)| a == b).count();
+            prev = bytes;
+            lcp as u8
+        })
+        .collect()
+}
+
 /// Component-wise maximum between two `HostCounts`.
 fn host_counts_max(a: HostCounts, b: HostCounts) -> HostCounts {
     macro_rules! m {
@@ -274,6 +287,19 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
         }
     };
 
+    // Common prefix of each name with the one before it (sorted order, 0 for the first):
+    // the names starting with a prefix are a run of the table, ended by the first value
+    // below the prefix length, and the smallest value inside the run is their common prefix.
+    if function_name_max_len > 256 {
+        return syn::Error::new(
+            Span::call_site(),
+            "Command names longer than 255 bytes do not fit the autocomplete prefix index.",
+        )
+        .to_compile_error()
+        .into();
+    }
+    let name_lcp: Vec<u8> = name_lcp_table(entries.iter().map(|e| e.name_str.as_str()));
+
     // Compute per-spec counts for each primitive type and the overall max arity.
     let mut max_counts = HostCounts::default();
     let mut max_arity: usize = 0;
@@ -373,13 +399,12 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
     let max_hexstr = max_counts.hexstr_c;
     let max_arity_num = max_arity;
 
-    // Generate per-descriptor parsers that fill `CallCtx` from `&[&str]`.
+    // Generate per-descriptor parsers that fill `CallCtx` from the `Tokens` of the line.
     let mut parsers: Vec<TokenStream2> = Vec::new();
     for (sid, spec) in unique_desc.iter().enumerate() {
         let fn_ident = format_ident!("__parse_spec_{}", sid);
         let header = quote! {
-            // `k` indexes into the argument tokens slice; individual idx_* track per-type positions.
-            let mut k = 0usize;
+            // the arguments are taken from `args` one by one; idx_* track per-type positions.
             // per-type indices
             let mut idx_b=0usize; let mut idx_w=0usize; let mut idx_d=0usize; let mut idx_q=0usize; let mut idx_x=0usize;
             let mut idx_B=0usize; let mut idx_W=0usize; let mut idx_D=0usize; let mut idx_Q=0usize; let mut idx_X=0usize;
@@ -393,60 +418,60 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
             let stmt = match ch {
                 // unsigned
                 'B' => {
-                    quote! { ctx.u8s   [idx_b] = parse_u8   (args[k]).ok_or(DispatchError::BadUnsigned)?; idx_b+=1; k+=1; }
+                    quote! { ctx.u8s   [idx_b] = parse_u8   (next_arg(args)).ok_or(DispatchError::BadUnsigned)?; idx_b+=1; }
                 }
                 'W' => {
-                    quote! { ctx.u16s  [idx_w] = parse_u16  (args[k]).ok_or(DispatchError::BadUnsigned)?; idx_w+=1; k+=1; }
+                    quote! { ctx.u16s  [idx_w] = parse_u16  (next_arg(args)).ok_or(DispatchError::BadUnsigned)?; idx_w+=1; }
                 }
                 'D' => {
-                    quote! { ctx.u32s  [idx_d] = parse_u32  (args[k]).ok_or(DispatchError::BadUnsigned)?; idx_d+=1; k+=1; }
+                    quote! { ctx.u32s  [idx_d] = parse_u32  (next_arg(args)).ok_or(DispatchError::BadUnsigned)?; idx_d+=1; }
                 }
                 'Q' => {
-                    quote! { ctx.u64s  [idx_q] = parse_u64  (args[k]).ok_or(DispatchError::BadUnsigned)?; idx_q+=1; k+=1; }
+                    quote! { ctx.u64s  [idx_q] = parse_u64  (next_arg(args)).ok_or(DispatchError::BadUnsigned)?; idx_q+=1; }
                 }
                 'X' => {
-                    quote! { ctx.u128s [idx_x] = parse_u128 (args[k]).ok_or(DispatchError::BadUnsigned)?; idx_x+=1; k+=1; }
+                    quote! { ctx.u128s [idx_x] = parse_u128 (next_arg(args)).ok_or(DispatchError::BadUnsigned)?; idx_x+=1; }
                 }
                 // signed
                 'b' => {
-                    quote! { ctx.i8s   [idx_B] = parse_i8   (args[k]).ok_or(DispatchError::BadSigned  )?; idx_B+=1; k+=1; }
+                    quote! { ctx.i8s   [idx_B] = parse_i8   (next_arg(args)).ok_or(DispatchError::BadSigned  )?; idx_B+=1; }
                 }
                 'w' => {
-                    quote! { ctx.i16s  [idx_W] = parse_i16  (args[k]).ok_or(DispatchError::BadSigned  )?; idx_W+=1; k+=1; }
+                    quote! { ctx.i16s  [idx_W] = parse_i16  (next_arg(args)).ok_or(DispatchError::BadSigned  )?; idx_W+=1; }
                 }
                 'd' => {
-                    quote! { ctx.i32s  [idx_D] = parse_i32  (args[k]).ok_or(DispatchError::BadSigned  )?; idx_D+=1; k+=1; }
+                    quote! { ctx.i32s  [idx_D] = parse_i32  (next_arg(args)).ok_or(DispatchError::BadSigned  )?; idx_D+=1; }
                 }
                 'q' => {
-                    quote! { ctx.i64s  [idx_Q] = parse_i64  (args[k]).ok_or(DispatchError::BadSigned  )?; idx_Q+=1; k+=1; }
+                    quote! { ctx.i64s  [idx_Q] = parse_i64  (next_arg(args)).ok_or(DispatchError::BadSigned  )?; idx_Q+=1; }
                 }
                 'x' => {
-                    quote! { ctx.i128s [idx_X] = parse_i128 (args[k]).ok_or(DispatchError::BadSigned  )?; idx_X+=1; k+=1; }
+                    quote! { ctx.i128s [idx_X] = parse_i128 (next_arg(args)).ok_or(DispatchError::BadSigned  )?; idx_X+=1; }
                 }
                 // sized
                 'Z' => {
-                    quote! { ctx.usizes[idx_z] = parse_usize(args[k]).ok_or(DispatchError::BadUnsigned)?; idx_z+=1; k+=1; }
+                    quote! { ctx.usizes[idx_z] = parse_usize(next_arg(args)).ok_or(DispatchError::BadUnsigned)?; idx_z+=1; }
                 }
                 'z' => {
-                    quote! { ctx.isizes[idx_Z] = parse_isize(args[k]).ok_or(DispatchError::BadSigned  )?; idx_Z+=1; k+=1; }
+                    quote! { ctx.isizes[idx_Z] = parse_isize(next_arg(args)).ok_or(DispatchError::BadSigned  )?; idx_Z+=1; }
                 }
                 // floats
                 'f' => {
-                    quote! { ctx.f32s  [idx_f] = parse_f::<f32  >(args[k]).ok_or(DispatchError::BadFloat)?; idx_f+=1; k+=1; }
+                    quote! { ctx.f32s  [idx_f] = parse_f::<f32  >(next_arg(args)).ok_or(DispatchError::BadFloat)?; idx_f+=1; }
                 }
                 'F' => {
-                    quote! { ctx.f64s  [idx_F] = parse_f::<f64  >(args[k]).ok_or(DispatchError::BadFloat)?; idx_F+=1; k+=1; }
+                    quote! { ctx.f64s  [idx_F] = parse_f::<f64  >(next_arg(args)).ok_or(DispatchError::BadFloat)?; idx_F+=1; }
                 }
                 //  bool, char, string, hexstring
                 't' => {
-                    quote! { ctx.bools [idx_t] = parse_bool(args[k]).ok_or(DispatchError::BadBool)?; idx_t+=1; k+=1; }
+                    quote! { ctx.bools [idx_t] = parse_bool(next_arg(args)).ok_or(DispatchError::BadBool)?; idx_t+=1; }
                 }
                 'c' => {
-                    quote! { ctx.chars [idx_c] = parse_char(args[k]).ok_or(DispatchError::BadChar)?; idx_c+=1; k+=1; }
+                    quote! { ctx.chars [idx_c] = parse_char(next_arg(args)).ok_or(DispatchError::BadChar)?; idx_c+=1; }
                 }
-                's' => quote! { ctx.strs  [idx_s] = args[k]; idx_s+=1; k+=1; },
+                's' => quote! { ctx.strs  [idx_s] = next_arg(args); idx_s+=1; },
                 'h' => {
-                    quote! { ctx.hexstrs[idx_h]= parse_hexstr(args[k]).ok_or(DispatchError::BadHexStr)?; idx_h+=1; k+=1; }
+                    quote! { ctx.hexstrs[idx_h]= check_hexstr(next_arg(args)).ok_or(DispatchError::BadHexStr)?; idx_h+=1; }
                 }
                 _ => quote! {},
             };
@@ -454,9 +479,9 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
         }
         parsers.push(quote! {
 
-            /// Parse arguments for this descriptor into `CallCtx`.
+            /// Parse arguments for this descriptor into `CallCtx`, as they come out of `args`.
             #[inline(always)]
-            fn #fn_ident<'a>(ctx: &mut CallCtx<'a>, args: &[&'a str]) -> Result<(), DispatchError> {
+            fn #fn_ident<'a>(ctx: &mut CallCtx<'a>, args: &mut Tokens<'a>) -> Result<(), DispatchError> {
                 #header
                 #(#stmts)*
                 Ok(())
@@ -464,10 +489,12 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
         });
     }
 
-    // Generate per-function wrappers and entries + match arms for lookup
+    // Generate per-function wrappers and entries + lookup buckets
     let mut wrappers: Vec<TokenStream2> = Vec::new();
     let mut entry_inits: Vec<TokenStream2> = Vec::new();
-    let mut match_arms: Vec<TokenStream2> = Vec::new();
+    // (name length, first byte) -> the names sharing it, with their ENTRIES index
+    let mut buckets: std::collections::BTreeMap<(usize, u8), Vec<(LitStr, usize)>> =
+        std::collections::BTreeMap::new();
 
     // Pairs of (function name, descriptor) for diagnostics / UI
     let name_spec_pairs: Vec<TokenStream2> = entries
@@ -496,6 +523,8 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
         // Build type list and extraction expressions according to the descriptor order.
         let mut arg_types: Vec<TokenStream2> = Vec::new();
         let mut arg_exprs: Vec<TokenStream2> = Vec::new();
+        // hex arguments are decoded by the wrapper, into buffers of its own frame
+        let mut hex_decodes: Vec<TokenStream2> = Vec::new();
         let mut idx_b = 0usize;
         let mut idx_w = 0usize;
         let mut idx_d = 0usize;
@@ -612,8 +641,14 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                     idx_s += 1;
                 }
                 'h' => {
+                    let buf_ident = format_ident!("__hex_{}", idx_h);
+                    let len_ident = format_ident!("__hex_len_{}", idx_h);
+                    hex_decodes.push(quote! {
+                        let mut #buf_ident = [0u8; MAX_HEXSTR_LEN];
+                        let #len_ident = decode_hexstr(ctx.hexstrs[#idx_h], &mut #buf_ident);
+                    });
                     arg_types.push(quote! { &[u8] });
-                    arg_exprs.push(quote! { &ctx.hexstrs[#idx_h] });
+                    arg_exprs.push(quote! { &#buf_ident[..#len_ident] });
                     idx_h += 1;
                 }
                 _ => {}
@@ -637,6 +672,7 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
             /// Wrapper that extracts arguments from `CallCtx` and calls the target function.
             #[inline(always)]
             fn #wrapper_ident<'__ctx>(ctx: &mut CallCtx<'__ctx>, _av: ArgsView<'__ctx>) -> Result<(), DispatchError> {
+                #( #hex_decodes )*
                 let _ = #path( #(#arg_exprs),* );
                 Ok(())
             }
@@ -652,9 +688,34 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
             }
         });
 
-        match_arms.push(quote! { #name_lit => Some(&ENTRIES[#pos]), });
+        if let Some(&first) = e.name_str.as_bytes().first() {
+            buckets
+                .entry((e.name_str.len(), first))
+                .or_default()
+                .push((name_lit.clone(), pos));
+        }
     }
 
+    // One arm per (length, first byte): rustc turns a match on two integers into
+    // a jump table / binary search, so the lookup does not grow with the table;
+    // the string compares left are those of the names colliding in a bucket.
+    let bucket_arms: Vec<TokenStream2> = buckets
+        .iter()
+        .map(|(&(len, first), names)| {
+            let len_lit = proc_macro2::Literal::usize_unsuffixed(len);
+            let first_lit = proc_macro2::Literal::u8_suffixed(first);
+            let tests = names.iter().map(|(lit, pos)| {
+                quote! { if name == #lit { return Some(&ENTRIES[#pos]); } }
+            });
+            quote! {
+                (#len_lit, #first_lit) => {
+                    #( #tests )*
+                    None
+                }
+            }
+        })
+        .collect();
+
     let max_hexstr_len_expr = if let Some(expr) = &hexstr_size {
         quote! { #expr }
     } else {
@@ -775,8 +836,8 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                 /// Required positional arity.
                 pub arity: u8,
 
-                /// Descriptor-specific parser filling `CallCtx` from `&[&str]`.
-                pub parser: for<'ctx> fn(&mut CallCtx<'ctx>, &[&'ctx str]) -> Result<(), DispatchError>,
+                /// Descriptor-specific parser filling `CallCtx` from the argument tokens.
+                pub parser: for<'ctx> fn(&mut CallCtx<'ctx>, &mut Tokens<'ctx>) -> Result<(), DispatchError>,
 
                 /// Wrapper invoking the target function.
                 pub caller: for<'ctx> fn(&mut CallCtx<'ctx>, ArgsView<'ctx>) -> Result<(), DispatchError>,
@@ -785,9 +846,10 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                 pub spec_idx: u16,
             }
 
-            /// A lightweight view over the raw tokens for advanced callers.
+            /// A lightweight view over the raw tokens for advanced callers: the arguments,
+            /// split again on iteration (nothing is stored).
             pub struct ArgsView<'a> {
-                pub tokens: &'a [&'a str],
+                pub tokens: Tokens<'a>,
                 pub len: usize,
             }
 
@@ -846,7 +908,8 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                 pub bools:  [bool;  MAX_BOOL],
                 pub chars:  [char;  MAX_CHAR],
                 pub strs:   [&'a str; MAX_STR],
-                pub hexstrs: [heapless::Vec<u8, MAX_HEXSTR_LEN>; MAX_HEXSTR],
+                /// validated, still hexlified: the wrapper of the function decodes them
+                pub hexstrs: [&'a str; MAX_HEXSTR],
             }
 
             impl<'a> CallCtx<'a> {
@@ -875,7 +938,7 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                         bools:  [false; MAX_BOOL],
                         chars:  ['\0'; MAX_CHAR],
                         strs:   ["";   MAX_STR],
-                        hexstrs: core::array::from_fn(|_| heapless::Vec::new()),
+                        hexstrs: ["";   MAX_HEXSTR],
                     }
                 }
             }
@@ -894,11 +957,17 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                 #( #entry_inits ),*
             ];
 
-            /// Fast string-table lookup (match on string literal).
+            /// Fast string-table lookup: bucketed by (length, first byte), then the names
+            /// of the bucket compared (one in most tables).
             #[inline(always)]
             fn find_entry(name: &str) -> Option<&'static Entry> {
-                match name {
-                    #( #match_arms )*
+                let bytes = name.as_bytes();
+                let first = match bytes.first() {
+                    Some(&b) => b,
+                    None => return None,
+                };
+                match (bytes.len(), first) {
+                    #( #bucket_arms )*
                     _ => None,
                 }
             }
@@ -914,6 +983,17 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                 NAME_AND_SPEC
             }
 
+            /// Length of the common prefix of each name of `NAME_AND_SPEC` with the one
+            /// before it (0 for the first); the autocomplete takes the run of a prefix
+            /// and its common prefix from it, without comparing names.
+            pub static NAME_LCP: &[u8] = &[ #( #name_lcp ),* ];
+
+            /// Return the prefix index of `get_commands()`. No allocations.
+            #[inline(always)]
+            pub fn get_name_lcp() -> &'static [u8] {
+                NAME_LCP
+            }
+
             /// Return descriptor help string (character to type mapping).
             #[inline(always)]
             pub fn get_datatypes() -> &'static str {
@@ -923,49 +1003,115 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
             /// Parse a hexlified string (even-length, non-empty, valid hex).
             #[inline(always)]
             pub fn parse_hexstr(s: &str) -> Option<heapless::Vec<u8, MAX_HEXSTR_LEN>> {
-                if s.len() % 2 != 0 || s.is_empty() || (s.len() / 2) > MAX_HEXSTR_LEN {
+                let s = check_hexstr(s)?;
+                let mut buf = [0u8; MAX_HEXSTR_LEN];
+                let len = decode_hexstr(s, &mut buf);
+                heapless::Vec::from_slice(&buf[..len]).ok()
+            }
+
+            /// `s` if it is a hexlified string of at most `MAX_HEXSTR_LEN` bytes (even-length,
+            /// non-empty, valid hex), checked without decoding.
+            #[inline(always)]
+            fn check_hexstr(s: &str) -> Option<&str> {
+                let bytes = s.as_bytes();
+                if bytes.len() % 2 != 0 || bytes.is_empty() || (bytes.len() / 2) > MAX_HEXSTR_LEN {
                     return None;
                 }
-                (0..s.len())
-                    .step_by(2)
-                    .map(|i| u8::from_str_radix(&s[i..i+2], 16).ok())
-                    .collect()
+                if bytes.iter().all(|b| b.is_ascii_hexdigit()) { Some(s) } else { None }
             }
 
-            // Quotes-aware tokenizer (no heap). Caller provides the buffer.
+            /// Decode a string accepted by `check_hexstr` into `out`, returns the byte count.
+            #[inline(always)]
+            fn decode_hexstr(s: &str, out: &mut [u8]) -> usize {
+                #[inline(always)]
+                const fn nibble(b: u8) -> u8 {
+                    match b {
+                        b'0'..=b'9' => b - b'0',
+                        b'a'..=b'f' => b - b'a' + 10,
+                        _ => b.wrapping_sub(b'A').wrapping_add(10),
+                    }
+                }
+                let mut len = 0usize;
+                for (pair, slot) in s.as_bytes().chunks_exact(2).zip(out.iter_mut()) {
+                    *slot = (nibble(pair[0]) << 4) | nibble(pair[1]);
+                    len += 1;
+                }
+                len
+            }
+
+            /// Quotes-aware tokenizer (no heap, nothing stored): an iterator over the tokens of
+            /// the line, each split off when it is asked for.
             /// Splits by ASCII space or tab. A pair of `"` quotes groups a token (quotes
-            /// Returns `Empty` if no tokens were produced.
-            pub fn tokenize<'a>(line: &'a str, out: &mut [&'a str]) -> Result<usize, DispatchError> {
-                let bytes = line.as_bytes();
-                let mut i = 0usize;
-                let mut n = 0usize;
+            /// excluded); what follows the closing quote up to the next whitespace is dropped.
+            #[derive(Clone)]
+            pub struct Tokens<'a> {
+                line: &'a str,
+                pos: usize,
+            }
+
+            impl<'a> Tokens<'a> {
+                #[inline(always)]
+                pub const fn new(line: &'a str) -> Self {
+                    Self { line, pos: 0 }
+                }
+            }
+
+            impl<'a> Iterator for Tokens<'a> {
+                type Item = &'a str;
+
+                fn next(&mut self) -> Option<&'a str> {
+                    let line = self.line;
+                    let bytes = line.as_bytes();
+                    let mut i = self.pos;
 
-                while i < bytes.len() {
                     // Skip leading spaces
                     while i < bytes.len() && is_space(bytes[i]) { i += 1; }
-                    if i >= bytes.len() { break; }
+                    if i >= bytes.len() {
+                        self.pos = i;
+                        return None;
+                    }
 
-                    if bytes[i] == b'"' {
+                    let tok = if bytes[i] == b'"' {
                         // Quoted token
                         let start = i + 1;
                         i = start;
                         while i < bytes.len() && bytes[i] != b'"' { i += 1; }
-                        if n < out.len() { out[n] = &line[start..i]; n += 1; }
+                        let tok = &line[start..i];
                         if i < bytes.len() { i += 1; }
                         // Consume trailing non-space until next whitespace to match original behavior.
                         while i < bytes.len() && !is_space(bytes[i]) { i += 1; }
+                        tok
                     } else {
                         // Unquoted token
                         let start = i;
                         while i < bytes.len() && !is_space(bytes[i]) { i += 1; }
-                        if n < out.len() { out[n] = &line[start..i]; n += 1; }
-                    }
+                        &line[start..i]
+                    };
+
+                    self.pos = i;
+                    Some(tok)
+                }
+            }
+
+            /// The tokens of `line` into `out` (those past `out.len()` are counted, not stored).
+            /// Returns `Empty` if no tokens were produced.
+            pub fn tokenize<'a>(line: &'a str, out: &mut [&'a str]) -> Result<usize, DispatchError> {
+                let mut n = 0usize;
+                for tok in Tokens::new(line) {
+                    if n < out.len() { out[n] = tok; }
+                    n += 1;
                 }
 
                 if n == 0 { return Err(DispatchError::Empty); }
                 Ok(n)
             }
 
+            /// The next argument; the arity was checked before the parser runs.
+            #[inline(always)]
+            fn next_arg<'a>(args: &mut Tokens<'a>) -> &'a str {
+                args.next().unwrap_or("")
+            }
+
             /// ASCII space or tab.
             #[inline(always)]
             const fn is_space(b: u8) -> bool { b == b' ' || b == b'\t' }
@@ -1009,27 +1155,20 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                 };
             }
 
+            /// Parse and run one command line. The arguments are parsed straight from the
+            /// line, no token array.
             #[inline(always)]
             pub fn dispatch<'a>(line: &'a str, error_buffer: &'a mut heapless::String<ERROR_BUFFER_SIZE>) -> Result<(), &'a str> {
-                // + 2 in order to detect if more args than expected are provided..
-                let mut toks: [&str; 2 + MAX_ARITY] = [""; 2 + MAX_ARITY];
-                dispatch_with_buf(line, &mut toks, error_buffer)
-            }
+                let mut toks = Tokens::new(line);
 
-            /// Embedded-friendly entry point: caller supplies the token buffer.
-            #[inline(always)]
-            pub fn dispatch_with_buf<'a>(line: &'a str, toks: &mut [&'a str], error_buffer: &'a mut heapless::String<ERROR_BUFFER_SIZE>) -> Result<(), &'a str> {
-                let len = match tokenize(line, toks) {
-                    Ok(len) => len,
-                    Err(e) => {
-                        format_error(e, error_buffer);
+                let name = match toks.next() {
+                    Some(name) => name,
+                    None => {
+                        format_error(DispatchError::Empty, error_buffer);
                         return Err(error_buffer.as_str());
                     }
                 };
 
-                let name = toks[0];
-                let got_arity = (len - 1) as u16;
-
                 let ent = match find_entry(name) {
                     Some(ent) => ent,
                     None => {
@@ -1038,23 +1177,23 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                     }
                 };
 
-                if got_arity != ent.arity as u16 {
+                // Count the arguments first (a second scan, nothing stored), so the arity
+                // is reported before a parse error, as ever.
+                let got_arity = toks.clone().count();
+                if got_arity != ent.arity as usize {
                     format_error(DispatchError::WrongArity { expected: ent.arity }, error_buffer);
                     return Err(error_buffer.as_str());
                 }
 
-                // Fill CallCtx from raw &str tokens (no heap).
+                // Fill CallCtx from the tokens as they are split (no heap, no array).
                 let mut ctx = CallCtx::new();
-                let args_tokens: &[&str] = &toks[1..len];
+                let args = ArgsView { tokens: toks.clone(), len: got_arity };
 
-                if let Err(e) = (ent.parser)(&mut ctx, args_tokens) {
+                if let Err(e) = (ent.parser)(&mut ctx, &mut toks) {
                     format_error(e, error_buffer);
                     return Err(error_buffer.as_str());
                 }
 
-                // Provide a view for advanced use (currently unused by wrappers).
-                let args = ArgsView { tokens: args_tokens, len: len - 1 };
-
                 match (ent.caller)(&mut ctx, args) {
                     Ok(()) => Ok(()),
                     Err(e) => {
@@ -1063,6 +1202,13 @@ pub fn generate_dispatcher_from_dsl(input: TokenStream) -> TokenStream {
                     }
                 }
             }
+
+            /// Former entry point with a caller supplied token buffer. The line is no longer
+            /// split into an array, `toks` is left untouched: this is `dispatch()`.
+            #[inline(always)]
+            pub fn dispatch_with_buf<'a>(line: &'a str, _toks: &mut [&'a str], error_buffer: &'a mut heapless::String<ERROR_BUFFER_SIZE>) -> Result<(), &'a str> {
+                dispatch(line, error_buffer)
+            }
         }
     };
 
@@ -1523,6 +1669,14 @@ mod tests {
         assert_eq!(entries[2].name_str, "zebra");
     }
 
+    #[test]
+    fn test_name_lcp_table() {
+        let names = ["adc", "add", "address", "bench", "bench2", "led"];
+        let lcp = name_lcp_table(names.iter().copied());
+        assert_eq!(lcp, vec![0, 2, 3, 0, 5, 0]);
+        assert!(name_lcp_table(core::iter::empty()).is_empty());
+    }
+
     // ============================================================================
     // Descriptor Character Analysis Tests
     // ============================================================================
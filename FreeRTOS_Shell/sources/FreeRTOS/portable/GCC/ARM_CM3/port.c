@@ -34,6 +34,14 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+/* Timing hooks of the outermost critical section, called with interrupts masked. */
+#ifndef traceCRITICAL_ENTER
+    #define traceCRITICAL_ENTER()
+#endif
+#ifndef traceCRITICAL_EXIT
+    #define traceCRITICAL_EXIT()
+#endif
+
 /* Prototype of all Interrupt Service Routines (ISRs). */
 typedef void ( * portISR_t )( void );
 
@@ -436,6 +444,7 @@ void vPortEnterCritical( void )
     if( uxCriticalNesting == 1 )
     {
         configASSERT( ( portNVIC_INT_CTRL_REG & portVECTACTIVE_MASK ) == 0 );
+        traceCRITICAL_ENTER();
     }
 }
 /*-----------------------------------------------------------*/
@@ -447,6 +456,7 @@ void vPortExitCritical( void )
 
     if( uxCriticalNesting == 0 )
     {
+        traceCRITICAL_EXIT();
         portENABLE_INTERRUPTS();
     }
 }
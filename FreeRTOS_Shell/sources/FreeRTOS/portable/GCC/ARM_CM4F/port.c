@@ -34,6 +34,14 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+/* Timing hooks of the outermost critical section, called with interrupts masked. */
+#ifndef traceCRITICAL_ENTER
+    #define traceCRITICAL_ENTER()
+#endif
+#ifndef traceCRITICAL_EXIT
+    #define traceCRITICAL_EXIT()
+#endif
+
 #ifndef __ARM_FP
     #error This port can only be used when the project options are configured to enable hardware floating point support.
 #endif
@@ -485,6 +493,7 @@ void vPortEnterCritical( void )
     if( uxCriticalNesting == 1 )
     {
         configASSERT( ( portNVIC_INT_CTRL_REG & portVECTACTIVE_MASK ) == 0 );
+        traceCRITICAL_ENTER();
     }
 }
 /*-----------------------------------------------------------*/
@@ -496,6 +505,7 @@ void vPortExitCritical( void )
 
     if( uxCriticalNesting == 0 )
     {
+        traceCRITICAL_EXIT();
         portENABLE_INTERRUPTS();
     }
 }
@@ -0,0 +1,536 @@
+/*
+ * heap_tlsf.c - Two-Level Segregated Fit heap, a drop-in for heap_4.c
+ *
+ *   cmake -DFREERTOS_HEAP=heap_tlsf ...
+ *
+ * The free blocks are kept in FL x SL size classes: the first level is the
+ * power of two of the size, the second splits it into heapSL_COUNT linear
+ * steps. One bitmap per level tells which lists have a block, so a malloc is
+ * two find-first-set instructions and a list head, a free a merge with the two
+ * physical neighbours: both take the same time whatever the free list looks
+ * like (heap_4 walks it, first fit). A block taken from a class is at least as
+ * large as the request (the size is rounded up to the next class for the
+ * search), the rest is split off and goes back to its own class.
+ *
+ * Every block starts with an 8 byte header, the size (bit 0: free) and the
+ * block physically before it; a free block keeps its list links in the
+ * payload. The heap ends with a used block of size 0, so the neighbour of
+ * the last block needs no bounds check.
+ *
+ * Besides the HeapStats_t of heap_4, vPortGetTlsfFragStats() (heap_tlsf.h)
+ * reports the fragmentation, 1 - largest free block / free total, now and the
+ * worst since the reset (or xPortResetHeapMinimumEverFreeHeapSize()). The
+ * worst is updated at every malloc/free from the lower bound of the highest
+ * non-empty class, which keeps them constant time; it is off by at most one
+ * second level step (1/8 of the size).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_tlsf.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* ================================================
+            size classes
+==================================================*/
+
+#define heapALIGN_LOG2          ( 3 )                               /* 8 byte blocks, portBYTE_ALIGNMENT */
+#define heapSL_LOG2             ( 3 )
+#define heapSL_COUNT            ( 1 << heapSL_LOG2 )
+#define heapFL_SHIFT            ( heapSL_LOG2 + heapALIGN_LOG2 )
+#define heapSMALL_BLOCK         ( ( size_t ) 1 << heapFL_SHIFT )    /* below: first level 0, linear */
+#define heapFL_MAX              ( 17 )                              /* blocks below 128K */
+#define heapFL_COUNT            ( heapFL_MAX - heapFL_SHIFT + 1 )
+
+#define heapHEADER_SIZE         ( sizeof( TlsfBlock_t ) - ( 2 * sizeof( void * ) ) )
+#define heapMIN_BLOCK           ( sizeof( TlsfBlock_t ) )            /* room for the list links */
+#define heapBLOCK_FREE          ( ( size_t ) 1 )
+#define heapSIZE_MASK           ( ~( size_t ) ( ( 1 << heapALIGN_LOG2 ) - 1 ) )
+
+#define heapSIZE_MAX            ( ~( ( size_t ) 0 ) )
+
+_Static_assert( ( 1 << heapALIGN_LOG2 ) == portBYTE_ALIGNMENT, "heap_tlsf assumes 8 byte alignment" );
+_Static_assert( configTOTAL_HEAP_SIZE < ( ( size_t ) 1 << heapFL_MAX ), "configTOTAL_HEAP_SIZE too large for heapFL_MAX" );
+_Static_assert( heapSL_COUNT <= 32, "the second level bitmap is 32 bit" );
+
+/* ================================================
+            data
+==================================================*/
+
+typedef struct TLSF_BLOCK
+{
+    struct TLSF_BLOCK * pxPrevPhys;     /* the block before this one in memory, NULL for the first */
+    size_t xSize;                       /* header included, bit 0: free */
+    struct TLSF_BLOCK * pxNextFree;     /* free blocks only, in the payload */
+    struct TLSF_BLOCK * pxPrevFree;
+} TlsfBlock_t;
+
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+PRIVILEGED_DATA static uint32_t ulFlBitmap = 0U;
+PRIVILEGED_DATA static uint32_t ulSlBitmap[ heapFL_COUNT ];
+PRIVILEGED_DATA static TlsfBlock_t * pxBlocks[ heapFL_COUNT ][ heapSL_COUNT ];
+PRIVILEGED_DATA static TlsfBlock_t * pxFirst = NULL;        /* NULL until the first malloc */
+
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+PRIVILEGED_DATA static uint32_t ulFragWorst = 0U;           /* per mille */
+PRIVILEGED_DATA static size_t xFragWorstFree = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xFragWorstLargest = ( size_t ) 0U;
+
+/* ================================================
+            private functions
+==================================================*/
+
+static inline uint32_t prvFls( uint32_t ulValue )
+{
+    return 31U - ( uint32_t ) __builtin_clz( ulValue );
+}
+
+static inline uint32_t prvFfs( uint32_t ulValue )
+{
+    return ( uint32_t ) __builtin_ctz( ulValue );
+}
+
+static inline size_t prvSize( const TlsfBlock_t * pxBlock )
+{
+    return pxBlock->xSize & heapSIZE_MASK;
+}
+
+static inline TlsfBlock_t * prvNextPhys( const TlsfBlock_t * pxBlock )
+{
+    return ( TlsfBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + prvSize( pxBlock ) );
+}
+
+/* the class of a size */
+static void prvMapping( size_t xSize, uint32_t * pulFl, uint32_t * pulSl )
+{
+    if( xSize < heapSMALL_BLOCK )
+    {
+        *pulFl = 0U;
+        *pulSl = ( uint32_t ) ( xSize >> heapALIGN_LOG2 );
+    }
+    else
+    {
+        const uint32_t ulFls = prvFls( ( uint32_t ) xSize );
+        *pulSl = ( uint32_t ) ( xSize >> ( ulFls - heapSL_LOG2 ) ) ^ ( 1U << heapSL_LOG2 );
+        *pulFl = ulFls - ( heapFL_SHIFT - 1U );
+    }
+}
+
+/* smallest size of a class */
+static size_t prvClassSize( uint32_t ulFl, uint32_t ulSl )
+{
+    if( ulFl == 0U )
+    {
+        return ( size_t ) ulSl << heapALIGN_LOG2;
+    }
+
+    const uint32_t ulLog2 = ulFl + ( heapFL_SHIFT - 1U );
+    return ( ( size_t ) 1 << ulLog2 ) + ( ( size_t ) ulSl << ( ulLog2 - heapSL_LOG2 ) );
+}
+
+static void prvInsert( TlsfBlock_t * pxBlock )
+{
+    uint32_t ulFl, ulSl;
+
+    prvMapping( prvSize( pxBlock ), &ulFl, &ulSl );
+    pxBlock->xSize |= heapBLOCK_FREE;
+    pxBlock->pxPrevFree = NULL;
+    pxBlock->pxNextFree = pxBlocks[ ulFl ][ ulSl ];
+    if( pxBlock->pxNextFree != NULL )
+    {
+        pxBlock->pxNextFree->pxPrevFree = pxBlock;
+    }
+    pxBlocks[ ulFl ][ ulSl ] = pxBlock;
+    ulFlBitmap |= ( 1U << ulFl );
+    ulSlBitmap[ ulFl ] |= ( 1U << ulSl );
+}
+
+static void prvRemove( TlsfBlock_t * pxBlock )
+{
+    uint32_t ulFl, ulSl;
+
+    prvMapping( prvSize( pxBlock ), &ulFl, &ulSl );
+    if( pxBlock->pxPrevFree != NULL )
+    {
+        pxBlock->pxPrevFree->pxNextFree = pxBlock->pxNextFree;
+    }
+    else
+    {
+        pxBlocks[ ulFl ][ ulSl ] = pxBlock->pxNextFree;
+        if( pxBlock->pxNextFree == NULL )
+        {
+            ulSlBitmap[ ulFl ] &= ~( 1U << ulSl );
+            if( ulSlBitmap[ ulFl ] == 0U )
+            {
+                ulFlBitmap &= ~( 1U << ulFl );
+            }
+        }
+    }
+    if( pxBlock->pxNextFree != NULL )
+    {
+        pxBlock->pxNextFree->pxPrevFree = pxBlock->pxPrevFree;
+    }
+    pxBlock->xSize &= ~heapBLOCK_FREE;
+}
+
+/* a free block of at least xSize, out of its list; NULL if none */
+static TlsfBlock_t * prvTake( size_t xSize )
+{
+    uint32_t ulFl, ulSl;
+
+    /* rounded up to the next class: any block of the class found is large enough */
+    if( xSize >= heapSMALL_BLOCK )
+    {
+        xSize += ( ( size_t ) 1 << ( prvFls( ( uint32_t ) xSize ) - heapSL_LOG2 ) ) - 1U;
+    }
+    prvMapping( xSize, &ulFl, &ulSl );
+    if( ulFl >= heapFL_COUNT )
+    {
+        return NULL;
+    }
+
+    uint32_t ulSlMap = ulSlBitmap[ ulFl ] & ( ~0U << ulSl );
+    if( ulSlMap == 0U )
+    {
+        const uint32_t ulFlMap = ( ulFl + 1U < 32U ) ? ( ulFlBitmap & ( ~0U << ( ulFl + 1U ) ) ) : 0U;
+        if( ulFlMap == 0U )
+        {
+            return NULL;
+        }
+        ulFl = prvFfs( ulFlMap );
+        ulSlMap = ulSlBitmap[ ulFl ];
+    }
+    ulSl = prvFfs( ulSlMap );
+
+    TlsfBlock_t * pxBlock = pxBlocks[ ulFl ][ ulSl ];
+    prvRemove( pxBlock );
+    return pxBlock;
+}
+
+/* the lower bound of the largest free block: the smallest size of the highest class in use */
+static size_t prvLargestBound( void )
+{
+    if( ulFlBitmap == 0U )
+    {
+        return 0U;
+    }
+
+    const uint32_t ulFl = prvFls( ulFlBitmap );
+    return prvClassSize( ulFl, prvFls( ulSlBitmap[ ulFl ] ) );
+}
+
+static uint32_t prvFragPermille( size_t xLargest, size_t xFree )
+{
+    return ( xFree > 0U ) ? ( uint32_t ) ( 1000U - ( ( ( uint64_t ) xLargest * 1000U ) / xFree ) ) : 0U;
+}
+
+/* after each malloc/free, in constant time */
+static void prvFragUpdate( void )
+{
+    const size_t xLargest = prvLargestBound();
+    const uint32_t ulFrag = prvFragPermille( xLargest, xFreeBytesRemaining );
+
+    if( ulFrag > ulFragWorst )
+    {
+        ulFragWorst = ulFrag;
+        xFragWorstFree = xFreeBytesRemaining;
+        xFragWorstLargest = xLargest;
+    }
+}
+
+static void prvHeapInit( void )
+{
+    uint8_t * pucStart = ucHeap;
+    size_t xTotal = configTOTAL_HEAP_SIZE;
+
+    /* an application heap may not be aligned */
+    const size_t xMisalign = ( ( size_t ) pucStart ) & ( portBYTE_ALIGNMENT - 1U );
+    if( xMisalign != 0U )
+    {
+        pucStart += portBYTE_ALIGNMENT - xMisalign;
+        xTotal -= portBYTE_ALIGNMENT - xMisalign;
+    }
+    xTotal &= heapSIZE_MASK;
+
+    pxFirst = ( TlsfBlock_t * ) pucStart;
+    pxFirst->pxPrevPhys = NULL;
+    pxFirst->xSize = xTotal - heapHEADER_SIZE;
+
+    TlsfBlock_t * pxSentinel = prvNextPhys( pxFirst );
+    pxSentinel->pxPrevPhys = pxFirst;
+    pxSentinel->xSize = 0U;                 /* used, never merged */
+
+    prvInsert( pxFirst );
+    xFreeBytesRemaining = prvSize( pxFirst );
+    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+}
+
+/* ================================================
+            public functions
+==================================================*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    void * pvReturn = NULL;
+
+    if( ( xWantedSize > 0U ) && ( xWantedSize <= ( heapSIZE_MAX - heapHEADER_SIZE - portBYTE_ALIGNMENT ) ) )
+    {
+        size_t xSize = ( xWantedSize + heapHEADER_SIZE + ( portBYTE_ALIGNMENT - 1U ) ) & heapSIZE_MASK;
+        if( xSize < heapMIN_BLOCK )
+        {
+            xSize = heapMIN_BLOCK;
+        }
+
+        vTaskSuspendAll();
+        {
+            if( pxFirst == NULL )
+            {
+                prvHeapInit();
+            }
+
+            TlsfBlock_t * pxBlock = prvTake( xSize );
+            if( pxBlock != NULL )
+            {
+                /* the rest is an own free block if it can hold the links */
+                const size_t xBlockSize = prvSize( pxBlock );
+                if( xBlockSize - xSize >= heapMIN_BLOCK )
+                {
+                    TlsfBlock_t * pxRest = ( TlsfBlock_t * ) ( ( ( uint8_t * ) pxBlock ) + xSize );
+                    pxRest->pxPrevPhys = pxBlock;
+                    pxRest->xSize = xBlockSize - xSize;
+                    prvNextPhys( pxRest )->pxPrevPhys = pxRest;
+                    pxBlock->xSize = xSize;
+                    prvInsert( pxRest );
+                }
+
+                xFreeBytesRemaining -= prvSize( pxBlock );
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                xNumberOfSuccessfulAllocations++;
+                prvFragUpdate();
+
+                pvReturn = ( ( uint8_t * ) pxBlock ) + heapHEADER_SIZE;
+            }
+
+            traceMALLOC( pvReturn, xWantedSize );
+        }
+        ( void ) xTaskResumeAll();
+    }
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    if( pv == NULL )
+    {
+        return;
+    }
+
+    TlsfBlock_t * pxBlock = ( TlsfBlock_t * ) ( ( ( uint8_t * ) pv ) - heapHEADER_SIZE );
+
+    configASSERT( ( ( uint8_t * ) pxBlock >= &( ucHeap[ 0 ] ) ) && ( ( uint8_t * ) pxBlock < &( ucHeap[ configTOTAL_HEAP_SIZE ] ) ) );
+    configASSERT( ( pxBlock->xSize & heapBLOCK_FREE ) == 0U );
+
+    vTaskSuspendAll();
+    {
+        const size_t xSize = prvSize( pxBlock );
+
+        xFreeBytesRemaining += xSize;
+        xNumberOfSuccessfulFrees++;
+        traceFREE( pv, xSize );
+
+        /* merged with the free neighbours, the sentinel is never free */
+        TlsfBlock_t * pxPrev = pxBlock->pxPrevPhys;
+        if( ( pxPrev != NULL ) && ( ( pxPrev->xSize & heapBLOCK_FREE ) != 0U ) )
+        {
+            prvRemove( pxPrev );
+            pxPrev->xSize += xSize;
+            pxBlock = pxPrev;
+        }
+
+        TlsfBlock_t * pxNext = prvNextPhys( pxBlock );
+        if( ( pxNext->xSize & heapBLOCK_FREE ) != 0U )
+        {
+            prvRemove( pxNext );
+            pxBlock->xSize += prvSize( pxNext );
+        }
+        prvNextPhys( pxBlock )->pxPrevPhys = pxBlock;
+
+        prvInsert( pxBlock );
+        prvFragUpdate();
+    }
+    ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+/* the worst fragmentation starts again too */
+void xPortResetHeapMinimumEverFreeHeapSize( void )
+{
+    taskENTER_CRITICAL();
+    {
+        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+        ulFragWorst = 0U;
+        xFragWorstFree = xFreeBytesRemaining;
+        xFragWorstLargest = xFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( ( xNum == 0U ) || ( xSize <= ( heapSIZE_MAX / xNum ) ) )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+/* a walk over the free lists: the exact largest block and the counts, for the shell */
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = SIZE_MAX;
+
+    vTaskSuspendAll();
+    {
+        for( uint32_t ulFl = 0U; ulFl < heapFL_COUNT; ulFl++ )
+        {
+            for( uint32_t ulSl = 0U; ulSl < heapSL_COUNT; ulSl++ )
+            {
+                for( const TlsfBlock_t * pxBlock = pxBlocks[ ulFl ][ ulSl ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+                {
+                    const size_t xSize = prvSize( pxBlock );
+
+                    xBlocks++;
+                    if( xSize > xMaxSize )
+                    {
+                        xMaxSize = xSize;
+                    }
+                    if( xSize < xMinSize )
+                    {
+                        xMinSize = xSize;
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetTlsfFragStats( TlsfFragStats_t * pxStats )
+{
+    HeapStats_t xHeap;
+
+    vPortGetHeapStats( &xHeap );
+    pxStats->xFree = xHeap.xAvailableHeapSpaceInBytes;
+    pxStats->xLargest = xHeap.xSizeOfLargestFreeBlockInBytes;
+    pxStats->ulFragPermille = prvFragPermille( pxStats->xLargest, pxStats->xFree );
+
+    taskENTER_CRITICAL();
+    {
+        pxStats->ulWorstPermille = ulFragWorst;
+        pxStats->xWorstFree = xFragWorstFree;
+        pxStats->xWorstLargest = xFragWorstLargest;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reset the state in this file. This state is normally initialized at start up.
+ * This function must be called by the application before restarting the
+ * scheduler.
+ */
+void vPortHeapResetState( void )
+{
+    pxFirst = NULL;
+    ulFlBitmap = 0U;
+    ( void ) memset( ulSlBitmap, 0, sizeof( ulSlBitmap ) );
+    ( void ) memset( pxBlocks, 0, sizeof( pxBlocks ) );
+
+    xFreeBytesRemaining = ( size_t ) 0U;
+    xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+    xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+    xNumberOfSuccessfulFrees = ( size_t ) 0U;
+    ulFragWorst = 0U;
+    xFragWorstFree = ( size_t ) 0U;
+    xFragWorstLargest = ( size_t ) 0U;
+}
+/*-----------------------------------------------------------*/
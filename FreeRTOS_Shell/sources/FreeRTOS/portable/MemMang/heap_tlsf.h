@@ -0,0 +1,34 @@
+/*
+ * heap_tlsf.h - the fragmentation telemetry of heap_tlsf.c
+ *
+ * On the include path when FREERTOS_HEAP is heap_tlsf, which also defines
+ * HEAP_TLSF=1 for the image.
+ */
+
+#ifndef HEAP_TLSF_H
+#define HEAP_TLSF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    size_t xFree;               /* free bytes, headers of the free blocks included */
+    size_t xLargest;            /* largest free block */
+    uint32_t ulFragPermille;    /* 1000 * (1 - largest / free), 0 for an empty heap */
+    uint32_t ulWorstPermille;   /* the highest since the reset, from the class bound */
+    size_t xWorstFree;          /* free bytes and largest block (class bound) at the worst */
+    size_t xWorstLargest;
+} TlsfFragStats_t;
+
+void vPortGetTlsfFragStats( TlsfFragStats_t * pxStats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEAP_TLSF_H */
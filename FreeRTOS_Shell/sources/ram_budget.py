@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""
+RAM budget per module from the GNU ld map file (post-link step of the build)
+Usage: python3 ram_budget.py stm32app.map [--elf stm32app.elf --nm arm-none-eabi-nm] [--top 10] [--budget BYTES]
+
+The .data/.bss input sections located in the RAM region are summed per module:
+the CMake target of the object (CMakeFiles/<target>.dir/...) or the archive it
+comes from (libc_nano.a -> c_nano). What the linker adds itself (alignment fill,
+reserved stack/heap) is shown per output section. With --elf the largest RAM
+symbols are listed too (shell buffers, history, AO stacks and queues ...).
+A non zero --budget fails (exit code 1) when the image uses more RAM.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+RE_REGION  = re.compile(r'^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+RE_OUTPUT  = re.compile(r'^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+RE_INPUT   = re.compile(r'^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+RE_WRAPPED = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+RE_TARGET  = re.compile(r'CMakeFiles/([^/]+)\.dir/')
+RE_ARCHIVE = re.compile(r'([^/\\]+)\.a\(')
+
+
+def module_of(path):
+    m = RE_TARGET.search(path)
+    if m:
+        return m.group(1)
+    m = RE_ARCHIVE.search(path)
+    if m:
+        name = m.group(1)
+        return name[3:] if name.startswith('lib') else name
+    return path.replace('\\', '/').rsplit('/', 1)[-1]
+
+
+def ram_region(lines):
+    """origin and length of the RAM region from the Memory Configuration"""
+    for line in lines:
+        m = RE_REGION.match(line)
+        if m and m.group(1).lower() in ('ram', 'sram'):
+            return int(m.group(2), 16), int(m.group(3), 16)
+    return None
+
+
+def parse_map(lines, origin, length):
+    """bytes per module (data, bss) and the part of each output section no module accounts for"""
+    modules = defaultdict(lambda: [0, 0])
+    sections = {}
+    in_map = False
+    out_name = None
+    pending = None
+
+    def in_ram(addr, size):
+        return (size > 0) and (origin <= addr < origin + length)
+
+    def add_input(name, addr, size, path):
+        if (out_name is None) or not in_ram(addr, size):
+            return
+        kind = 1 if ('bss' in name or name == 'COMMON') else 0
+        modules[module_of(path)][kind] += size
+        sections[out_name][1] += size
+
+    for line in lines:
+        if not in_map:
+            in_map = line.startswith('Linker script and memory map')
+            continue
+        line = line.rstrip('\n')
+
+        if pending is not None:
+            m = RE_WRAPPED.match(line)
+            if m:
+                add_input(pending, int(m.group(1), 16), int(m.group(2), 16), m.group(3))
+            pending = None
+            continue
+
+        m = RE_OUTPUT.match(line)
+        if m:
+            addr, size = int(m.group(2), 16), int(m.group(3), 16)
+            out_name = m.group(1) if in_ram(addr, size) else None
+            if out_name is not None:
+                sections[out_name] = [size, 0]
+            continue
+        if re.match(r'^\.\S+$', line):           # output section name alone, values on the next line
+            out_name = None
+            continue
+
+        m = RE_INPUT.match(line)
+        if m:
+            add_input(m.group(1), int(m.group(2), 16), int(m.group(3), 16), m.group(4))
+            continue
+        m = re.match(r'^ (\.\S+|COMMON)$', line)  # input section name alone
+        if m:
+            pending = m.group(1)
+
+    linker = {name: size - used for name, (size, used) in sections.items() if size > used}
+    return modules, linker
+
+
+def top_symbols(elf, nm, origin, length, count):
+    """largest symbols located in RAM, from nm"""
+    try:
+        out = subprocess.run([nm, '-S', '--size-sort', '-C', elf],
+                             capture_output=True, text=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f"ram_budget: nm failed: {e}")
+        return []
+    symbols = []
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) == 4 and parts[2] in 'bBdD':
+            addr, size = int(parts[0], 16), int(parts[1], 16)
+            if origin <= addr < origin + length:
+                symbols.append((size, parts[3]))
+    return sorted(symbols, reverse=True)[:count]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='RAM budget per module from a GNU ld map file')
+    parser.add_argument('map')
+    parser.add_argument('--elf', help='image for the largest symbols list')
+    parser.add_argument('--nm', default='arm-none-eabi-nm')
+    parser.add_argument('--top', type=int, default=10, help='largest symbols shown')
+    parser.add_argument('--budget', type=int, default=0, help='max RAM bytes, 0 for no check')
+    args = parser.parse_args()
+
+    with open(args.map, encoding='utf-8', errors='replace') as f:
+        lines = f.readlines()
+
+    region = ram_region(lines)
+    if region is None:
+        print("ram_budget: no RAM region in the map file")
+        return 1
+    origin, length = region
+    modules, linker = parse_map(lines, origin, length)
+
+    used = sum(d + b for d, b in modules.values()) + sum(linker.values())
+
+    print(f"RAM budget: {used} of {length} bytes ({100.0 * used / length:.1f} %), {length - used} free")
+    print(f"  {'module':<24} {'data':>7} {'bss':>7} {'total':>7}   %")
+    for name, (data, bss) in sorted(modules.items(), key=lambda kv: -(kv[1][0] + kv[1][1])):
+        total = data + bss
+        print(f"  {name:<24} {data:>7} {bss:>7} {total:>7} {100.0 * total / length:5.1f}")
+    for name, size in sorted(linker.items(), key=lambda kv: -kv[1]):
+        print(f"  {'(linker) ' + name:<24} {'':>7} {'':>7} {size:>7} {100.0 * size / length:5.1f}")
+
+    if args.elf and args.top > 0:
+        print("  largest symbols:")
+        for size, name in top_symbols(args.elf, args.nm, origin, length, args.top):
+            print(f"  {size:>7}  {name}")
+
+    if (args.budget > 0) and (used > args.budget):
+        print(f"ram_budget: {used} bytes used, over the budget of {args.budget}")
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -6,58 +6,67 @@
 #include <task.h>
 
 #include "ushell_core.h"
+#include "ushell_core_log.h"
 #include "uart_access.h"
+#include "flash_history.h"
+#include "settings.h"
+#include "power_mgr.h"
+#include "isr_prof.h"
+#include "input_lat.h"
+#include "trace_rec.h"
+#include "probe.h"
+#include "boot_time.h"
+#include "mono_time.h"
+#include "startup.h"
+#include "clock_profile.h"
+#include "bench.h"
+#include "watchdog.h"
 
 #include "LcdAO.hpp"
 #include "LedAO.hpp"
 #include "ButtonAO.hpp"
+#include "ShellAO.hpp"
+#include "AdcAO.hpp"
 #include "ao_defs.hpp"
 
 
 // ── Active Object instances ────────────────────────────────────
 
 static LedAO    ledAO(LED_0);
-static LcdAO    lcdAO(LCD_0);
-
-// ── Blink task ─────────────────────────────────────────────────
-//
-// No longer touches GPIO directly — posts to LedAO and LcdAO.
-// This task is intentionally kept as a plain FreeRTOS task since
-// its only job is to drive periodic events into the two AOs.
-//
-static void vTaskBlink(void *pvParameters)
-{
-    (void)pvParameters;
-
-    bool ledOn = false;
-
-    for (;;)
-    {
-        // Toggle LED via LedAO
-        const Event ev = { SIG_LED_TOGGLE, 0 };
-        ledAO.getAO()->post(ev);
-
-        // Update LCD via LcdAO
-        lcdAO.print(1, 0, ledOn ? "LED: OFF        "
-                                : "LED: ON         ");
-        ledOn = !ledOn;
+static LcdAO    lcdAO(lcdTuned(LCD_0), lcdAoTuned(LCD_AO_DEFAULTS));   // lcd.* of the settings store
+static AdcAO    adcAO(ADC_0);     // stopped until adc 2 (it holds STOP off while it runs)
 
-        vTaskDelay(pdMS_TO_TICKS(2000));
-    }
+// ── Shell ──────────────────────────────────────────────────────
+#if (AO_SHELL == 1)
+static void onShellStart(Microshell *pShell)
+{
+    pShell->SetHistoryStore(flash_history_store());
+    boot_time_mark(BOOT_TIME_PROMPT);
 }
 
-
-// ── Shell task ─────────────────────────────────────────────────
+static ShellAO  shellAO(pluginEntry(), "root", onShellStart);
+#else
 static void vTaskShell(void *pvParameters)
 {
     (void)pvParameters;
-    Microshell::getShellPtr(pluginEntry(), "root")->Run();
+    Microshell *pShell = Microshell::getShellPtr(pluginEntry(), "root");
+    pShell->SetHistoryStore(flash_history_store());
+    boot_time_mark(BOOT_TIME_PROMPT);
+    pShell->Run();
 }
+#endif
 
 // ── FreeRTOS hooks ─────────────────────────────────────────────
-void vApplicationIdleHook(void)          
-{ 
-    __asm volatile("wfi"); 
+void vApplicationIdleHook(void)
+{
+    startup_run_late();     // the INIT_LATE entries, once: the shell is up and waits (cmd_sched)
+    flash_history_idle();   // queued history entries to flash once the shell is quiet
+                            // the tickless idle sleeps next, in STOP when it can (power_mgr)
+}
+
+void vApplicationTickHook(void)
+{
+    mono_time_tick();       // the DWT epoch of mono_time_us(), before the counter wraps
 }
 
 
@@ -65,11 +74,17 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
 {
     (void)xTask;
     (void)pcTaskName;
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    watchdog_fault(WATCHDOG_CAUSE_STACK, pcTaskName);   // the name for wdg after the reset
+#endif
     while (1);
 }
 
 void vApplicationMallocFailedHook(void)
 {
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    watchdog_fault(WATCHDOG_CAUSE_MALLOC, NULL);
+#endif
     while(1) {
         gpio_toggle(GPIOC, GPIO13);
         for(int i = 0; i < 5000000; i++) {
@@ -81,7 +96,7 @@ void vApplicationMallocFailedHook(void)
 // ── Hardware init ──────────────────────────────────────────────
 static void setup_clock(void)
 {
-    rcc_clock_setup_pll(&rcc_hse_configs[RCC_CLOCK_HSE8_72MHZ]);
+    clock_profile_setup(CLOCK_PROFILE_PERF);    // 72 MHz, clkprof switches it at run time
 }
 
 static void setup_gpio(void)
@@ -98,21 +113,62 @@ static void setup_gpio(void)
 // ── Main ───────────────────────────────────────────────────────
 int main(void)
 {
+    watchdog_init();        // the reset cause, before anything clears it; the IWDG starts with the scheduler
+    boot_time_init();       // boottime: stages from here to the prompt
+    mono_time_init();       // mono_time_us() from the reset on, before the clock changes
+    uShellLog::SetLevel((uint8_t)settings_get(SETTING_LOG_LEVEL));    // log.level of the settings store
     setup_clock();
+    boot_time_mark(BOOT_TIME_CLOCK);
+    isr_prof_init();        // before the first interrupt is enabled
+    input_lat_init();       // the button stages (inputlat), the PB14 marker
+    trace_rec_init();
+    probe_init();           // the pins of USHELL_PROBE=GPIO, nothing otherwise
     setup_gpio();
     uart_setup();
+    boot_time_mark(BOOT_TIME_HW);
 
-    static ButtonAO buttonAO_0(BUTTON_0);
-    static ButtonAO buttonAO_1(BUTTON_1);
+    static ButtonAO buttonAO_0(buttonTuned(BUTTON_0), buttonAoTuned(BUTTON_AO_DEFAULTS));  // btn.* (set / get)
+    static ButtonAO buttonAO_1(buttonTuned(BUTTON_1), buttonAoTuned(BUTTON_AO_DEFAULTS));
 
     buttonAO_0.init();
     buttonAO_1.init();
     ledAO.init();
     lcdAO.init();
+    adcAO.init();
+    adcAO.tap(adcTelemetry);    // the frames on TELEMETRY_ADC, once chan turns it on
+    bench_init();           // the bench AO and echo task, nothing without BENCH
+#if (AO_SHELL == 1)
+    shellAO.init();         // the UART RX interrupt feeds it, no shell task
+#endif
+
+    AO_BUS.attach(AO_SLOT_LED_0, ledAO.getAO());
 
-    xTaskCreate(vTaskBlink, "Blink", 128,  NULL, 2, NULL);
+    // The heartbeat: 2 s on, 2 s off, from the LedAO timer (no blink task)
+    static const LedPattern HEARTBEAT = { 4000, 50, 0, false };
+    ledAO.setPattern(HEARTBEAT);
+    lcdAO.print(1, 0, "LED: heartbeat  ");
+
+    power_mgr_init(clock_profile_scale(clock_profile_get()));  // STOP between events, EXTI buttons and UART RX wake it
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+    AoKernel::start();      // runs the ButtonAOs, the LedAO, the LcdAO, the AdcAO (and the ShellAO)
+#endif
+    boot_time_mark(BOOT_TIME_AO);   // the LCD comes up in the LcdAO, after the prompt
+
+#if (AO_SHELL == 0)
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
     xTaskCreate(vTaskShell, "Shell", 512, NULL, 1, NULL);
+#else
+    static StackType_t  shellStack[512];
+    static StaticTask_t shellTcb;
+
+    xTaskCreateStatic(vTaskShell, "Shell", 512, NULL, 1, shellStack, &shellTcb);
+#endif
+    static watchdog_src_s shellWatch;   // the ShellAO beats as an AO instead
+    watchdog_watch(&shellWatch, "Shell", uart_activity(), WATCHDOG_SHELL_STALL_MS);
+#endif
 
+    boot_time_mark(BOOT_TIME_SCHEDULER);
     vTaskStartScheduler();
 
     while (1);
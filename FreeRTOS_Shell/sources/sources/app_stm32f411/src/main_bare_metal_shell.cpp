@@ -1,13 +1,80 @@
 #include "libopencm3/stm32/rcc.h"
 #include "libopencm3/stm32/gpio.h"
+#include "libopencm3/cm3/systick.h"
 
 #include "ushell_core.h"
 #include "uart_access.h"
 
+#include "ActiveObject.hpp"
+#include "ShellAO.hpp"
+#include "TimeEvent.hpp"
+
+/*
+    No RTOS: built with AO_PORT=AO_PORT_BARE_METAL (AoPort.hpp), the AOs run to completion
+    in the AoKernel superloop of main() and the core sleeps in wfi between their events.
+    The shell is the ShellAO, fed from the UART RX interrupt, next to the blink AO.
+*/
+
+#if (AO_PORT != AO_PORT_BARE_METAL)
+#error "main_bare_metal_shell: AO_PORT=AO_PORT_BARE_METAL"
+#endif
+
+#define BLINK_MS    (500U)
+
+// ── Blink: PC13 toggled from a TimeEvent, no delay loop ─────────
+class BlinkAO {
+public:
+    BlinkAO() : m_tick(SIG_TIMEOUT) {}
+
+    void init()
+    {
+        rcc_periph_clock_enable(RCC_GPIOC);
+        gpio_mode_setup(GPIOC, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO13);
+        gpio_set_output_options(GPIOC, GPIO_OTYPE_PP, GPIO_OSPEED_2MHZ, GPIO13);
+
+        TimeEvent::initService();
+        m_ao.init("Blink", &BlinkAO::dispatch, this, 2, 0, 2);
+        m_tick.arm(&m_ao, AO_MS_TO_TICKS(BLINK_MS));
+    }
+
+private:
+    StaticActiveObject<1, 2> m_ao;
+    TimeEvent                m_tick;
+
+    static void dispatch(void *instance, const Event &e)
+    {
+        BlinkAO *self = static_cast<BlinkAO *>(instance);
+        if (e.signal == SIG_TIMEOUT) {
+            gpio_toggle(GPIOC, GPIO13);
+            self->m_tick.arm(&self->m_ao, AO_MS_TO_TICKS(BLINK_MS));
+        }
+    }
+};
+
+static BlinkAO  blinkAO;
+static ShellAO  shellAO(pluginEntry(), "root");
+
+// The superloop tick (AoPort::now(), the TimeEvent service)
+extern "C" void sys_tick_handler(void)
+{
+    AoPort::tickFromISR();
+}
+
+static void setup_tick(void)
+{
+    systick_set_frequency(AO_BARE_METAL_TICK_HZ, rcc_ahb_frequency);
+    systick_counter_enable();
+    systick_interrupt_enable();
+}
 
 int main(void)
 {
     uart_setup();
-    Microshell::getShellPtr(pluginEntry(), "root")->Run();
+    setup_tick();
+
+    blinkAO.init();
+    shellAO.init();         // the prompt at the first dispatch
+
+    AoKernel::start();      // does not return
     return 0;
-}
\ No newline at end of file
+}
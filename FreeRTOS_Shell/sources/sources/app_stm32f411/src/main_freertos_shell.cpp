@@ -6,19 +6,27 @@
 
 #include "ushell_core.h"
 #include "ushell_core_printout.h"
+#include "ushell_core_log.h"
 #include "uart_access.h"
+#include "flash_history.h"
+#include "settings.h"
+#include "isr_prof.h"
+#include "trace_rec.h"
+#include "probe.h"
+#include "boot_time.h"
+#include "mono_time.h"
+#include "startup.h"
+#include "clock_profile.h"
+#include "bench.h"
+#include "watchdog.h"
 
 
 static void setup_clock(void) {
-    /* Setup 100MHz from 8MHz HSE crystal */
-    rcc_clock_setup_pll(&rcc_hse_8mhz_3v3[RCC_CLOCK_3V3_84MHZ]);
-    
-    /* Alternative: Use 25MHz HSE (common on some F411 boards)
-     * rcc_clock_setup_pll(&rcc_hse_25mhz_3v3[RCC_CLOCK_3V3_84MHZ]);
-     */
-    
-    /* Alternative: Use internal 16MHz oscillator
-     * rcc_clock_setup_pll(&rcc_hsi_configs[RCC_CLOCK_3V3_84MHZ]);
+    /* 100MHz from the 8MHz HSE crystal (96MHz with USB CDC), clkprof switches it at run time */
+    clock_profile_setup(CLOCK_PROFILE_PERF);
+
+    /* Alternative: a 25MHz HSE (common on some F411 boards) takes the rcc_hse_25mhz_3v3
+     * table as the base of the presets in clock_profile.cpp
      */
 }
 
@@ -45,11 +53,29 @@ void vTaskBlink(void *pvParameters) {
 void vTaskShell(void *pvParameters) {
     (void)pvParameters;
     
-    Microshell::getShellPtr(pluginEntry(), "root")->Run();
+    Microshell *pShell = Microshell::getShellPtr(pluginEntry(), "root");
+    pShell->SetHistoryStore(flash_history_store());
+    boot_time_mark(BOOT_TIME_PROMPT);
+    pShell->Run();
+}
+
+void vApplicationIdleHook(void) {
+    /* the INIT_LATE entries, once: the shell is up and waits (cmd_sched) */
+    startup_run_late();
+    /* queued history entries to flash once the shell is quiet */
+    flash_history_idle();
+}
+
+void vApplicationTickHook(void) {
+    /* the DWT epoch of mono_time_us(), before the counter wraps */
+    mono_time_tick();
 }
 
 void vApplicationMallocFailedHook(void) {
     /* Called if a call to pvPortMalloc() fails */
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    watchdog_fault(WATCHDOG_CAUSE_MALLOC, NULL);
+#endif
     while (1);
 }
 
@@ -57,21 +83,47 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
     (void)xTask;
     (void)pcTaskName;
     /* Called if a task overflows its stack */
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    watchdog_fault(WATCHDOG_CAUSE_STACK, pcTaskName);   /* the name for wdg after the reset */
+#endif
     while (1);
 }
 
 int main(void) {
+    watchdog_init();        // the reset cause, before anything clears it; the IWDG starts with the scheduler
+    boot_time_init();       // boottime: stages from here to the prompt
+    mono_time_init();       // mono_time_us() from the reset on, before the clock changes
+    uShellLog::SetLevel((uint8_t)settings_get(SETTING_LOG_LEVEL));    // log.level of the settings store
     setup_clock();
+    boot_time_mark(BOOT_TIME_CLOCK);
+    isr_prof_init();        // before the first interrupt is enabled
+    trace_rec_init();
+    probe_init();           // the pins of USHELL_PROBE=GPIO, nothing otherwise
     setup_gpio();
     uart_setup();
+    boot_time_mark(BOOT_TIME_HW);
+
+    bench_init();           // the bench AO and echo task, nothing without BENCH
 
     // Ensure FreeRTOS can manage interrupts properly
     //NVIC_SetPriorityGrouping(NVIC_PRIGROUP_GROUP4_NOSUB); // 4 bits for pre-emption priority
 
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
     xTaskCreate(vTaskBlink, "Blink", 128, NULL, 2, NULL);
     xTaskCreate(vTaskShell, "Shell", 1024, NULL, 1, NULL);
+#else
+    static StackType_t  blinkStack[128];
+    static StaticTask_t blinkTcb;
+    static StackType_t  shellStack[1024];
+    static StaticTask_t shellTcb;
 
-    
+    xTaskCreateStatic(vTaskBlink, "Blink", 128, NULL, 2, blinkStack, &blinkTcb);
+    xTaskCreateStatic(vTaskShell, "Shell", 1024, NULL, 1, shellStack, &shellTcb);
+#endif
+    static watchdog_src_s shellWatch;
+    watchdog_watch(&shellWatch, "Shell", uart_activity(), WATCHDOG_SHELL_STALL_MS);
+
+    boot_time_mark(BOOT_TIME_SCHEDULER);
     vTaskStartScheduler();
     
     /* Should never reach here */
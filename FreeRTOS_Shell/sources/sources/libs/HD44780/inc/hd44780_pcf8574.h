@@ -10,7 +10,7 @@
  *
  * PCF8574 → HD44780 pin mapping (standard backpack wiring):
  *   P0 → RS   (Register Select)
- *   P1 → RW   (Read/Write, tied LOW = write only)
+ *   P1 → RW   (Read/Write, LOW = write; wired on most backpacks)
  *   P2 → EN   (Enable strobe)
  *   P3 → BL   (Backlight, active HIGH)
  *   P4 → D4
@@ -18,11 +18,52 @@
  *   P6 → D6
  *   P7 → D7
  *
- * I2C1 pins on STM32F103:
+ * I2C1 pins (i2c_master, interrupt driven):
  *   PB6 → SCL
  *   PB7 → SDA
  *   (Requires 4.7kΩ pull-up resistors to 3.3V on both lines)
  *
+ * The PCF8574 latches every byte of a transaction, so the bytes of an
+ * operation (three per nibble: data, data|EN, data) are queued and sent
+ * as one transfer; the ~90 us per byte at 100 kHz covers the EN pulse
+ * and the 37 us command time. setCursor() only queues its bytes, they go
+ * out with the next print() or write(): a row update is one transaction
+ * for the move and the whole string. The task sleeps while the bus
+ * transfers.
+ *
+ * Busy flag (busy_flag = true, RW wired to P1): clear() and home() poll
+ * D7 over an I2C read instead of waiting the 1.52 ms worst case, one
+ * poll is ~0.5 ms of bus time. A read error waits the fixed time; a
+ * flag that never clears (RW tied low, D7 reads high) turns polling
+ * off. The other commands are shorter than the next write, no wait.
+ *
+ * Custom characters: the 8 CGRAM slots are shown by the codes 8..15
+ * (0..7 alias them, but 0 ends a string). glyph() returns the code for
+ * a caller's glyph id, its bitmap written over the least recently used
+ * slot when it is not loaded, and findGlyph() the code if it is; both
+ * count as a use. A slot written over changes every cell showing it.
+ * The loads are queued like setCursor() and leave the address in
+ * CGRAM: a setCursor() must follow before the next print().
+ *
+ * Shifts: a display of one or two lines has 40 characters of DDRAM per
+ * line, the visible window starts at shift(). setCursor() takes any of
+ * the 40 columns; shiftDisplay() moves the window by one over every
+ * line at once (one instruction, the DDRAM is not rewritten), clear()
+ * and home() take it back to 0. On four lines the rows 0/2 and 1/3
+ * share a DDRAM line: lineLength() is the width, a shift moves the text
+ * of a row into the other one. shiftCursor() moves the address by one.
+ * Both are queued like setCursor().
+ *
+ * Warm start: a reset of the MCU alone (pin, watchdog, software) leaves
+ * the display powered, in 4-bit mode, its DDRAM and CGRAM as they were.
+ * resync() brings the controller back to a known state without the
+ * power up wait and without a clear: the three 0x3 nibbles (the first
+ * one may end a byte cut by the reset, at worst a return home), the
+ * 4-bit switch, the modes and a home, ~2 ms against the ~47 ms of
+ * init(). The glyph slots read as free, their codes on the display too
+ * are unknown to the driver. lcd_warm_record() is the .noinit copy of
+ * what a display showed (linker scripts), kept by the LcdAO.
+ *
  * PCF8574  default I2C address: 0x27  (A2=A1=A0=1)
  * PCF8574A default I2C address: 0x3F  (A2=A1=A0=1)
  */
@@ -40,11 +81,37 @@
 #define LCD_COLS  16
 #define LCD_ROWS   2
 
+/* bytes per transfer: a cursor move and a full row, six per character */
+#define LCD_I2C_BUFFER  (6 * (LCD_COLS + 1))
+
+#define LCD_DDRAM_LINE   40     /* DDRAM characters per line, one or two lines */
+
+#define LCD_CGRAM_SLOTS  8
+#define LCD_CGRAM_CODE   8      /* first character code of the slots */
+
+#define LCD_WARM_CELLS   80     /* the DDRAM, two lines of LCD_DDRAM_LINE */
+
+/* a display across a reset of the MCU: its config, the window and its frames */
+typedef struct {
+    uint32_t magic;
+    uint8_t  addr;
+    uint8_t  rows;
+    uint8_t  line;
+    uint8_t  shift;
+    char     frame[LCD_WARM_CELLS];     /* wanted */
+    char     shown[LCD_WARM_CELLS];     /* on the DDRAM */
+    uint32_t check;
+} LcdWarmRecord;
+
+/* the record in .noinit, random after a power on: check it before use */
+LcdWarmRecord &lcd_warm_record(void);
+
 class HD44780_PCF8574 {
 public:
     HD44780_PCF8574(uint8_t i2c_address = 0x27,
                     uint8_t cols = LCD_COLS,
-                    uint8_t rows = LCD_ROWS);
+                    uint8_t rows = LCD_ROWS,
+                    bool    busy_flag = false);
 
     /**
      * Initialise I2C and the LCD.
@@ -54,32 +121,77 @@ public:
      */
     bool init(void);
 
+    /**
+     * Warm start: the controller back in 4-bit mode, DDRAM kept, the
+     * window at 0.
+     * @return false if the PCF8574 did not acknowledge
+     */
+    bool resync(void);
+
     void clear(void);
     void home(void);
-    void setCursor(uint8_t col, uint8_t row);
+    void setCursor(uint8_t col, uint8_t row);     // sent with the next print() / write() / flush(), col < lineLength()
     void print(const char *str);
+    void print(const char *buf, uint8_t len);     // len characters, no terminator
     void write(char c);
     void setBacklight(bool on);
     void displayOn(bool on);
     void cursorOn(bool on);
     void blinkOn(bool on);
 
+    /** Move the window over the DDRAM by one, the text goes left (left) or right, queued. */
+    void shiftDisplay(bool left);
+
+    /** Move the DDRAM address by one, queued. */
+    void shiftCursor(bool right);
+
+    /** First DDRAM column of the window, 0 .. LCD_DDRAM_LINE - 1. */
+    uint8_t shift(void) const { return _shift; }
+
+    /** Columns per row: LCD_DDRAM_LINE on one or two lines, else the width. */
+    uint8_t lineLength(void) const { return (_rows <= 2) ? LCD_DDRAM_LINE : _cols; }
+
+    /** Write a 5x8 bitmap (8 rows, bit 4 leftmost) to CGRAM slot 0..7, queued. */
+    void createChar(uint8_t slot, const uint8_t *bitmap);
+
+    /** Code showing glyph id, loaded over the least recently used slot if needed. */
+    char glyph(uint8_t id, const uint8_t *bitmap);
+
+    /** Code showing glyph id if it is loaded, else 0. */
+    char findGlyph(uint8_t id);
+
+    /** Send what is queued (a lone setCursor()). */
+    bool flush(void) { return i2c_flush(); }
+
     /** True if the last I2C transaction succeeded. */
     bool ok(void) const { return _i2c_ok; }
 
+    /** I2C address of the backpack. */
+    uint8_t address(void) const { return _addr; }
+
 private:
     uint8_t _addr;
     uint8_t _cols;
     uint8_t _rows;
     uint8_t _backlight;
     uint8_t _displayCtrl;
+    uint8_t _shift;             // window over the DDRAM line, shiftDisplay()
     bool    _i2c_ok;
+    bool    _busyFlag;          // poll D7 after clear / home
+    uint8_t _buf[LCD_I2C_BUFFER];
+    uint8_t _len;
+    uint8_t _glyphId[LCD_CGRAM_SLOTS];    // caller's id per slot, 0xFF free
+    uint32_t _glyphUse[LCD_CGRAM_SLOTS];  // _glyphClock at the last use
+    uint32_t _glyphClock;
 
-    void i2c_setup(void);
-    bool i2c_write_byte(uint8_t data);
+    void i2c_put(uint8_t data);
+    bool i2c_flush(void);
 
     void lcd_send(uint8_t value, uint8_t mode);
     void lcd_write4bits(uint8_t nibble);
     void lcd_pulse_enable(uint8_t data);
     void command(uint8_t cmd);
+    void wait_ready(uint32_t us);
+    bool read_busy(bool *busy);
+    bool probe(void);
 };
@@ -1,7 +1,12 @@
 #include "hd44780_pcf8574.h"
+#include "i2c_master.h"
+#include "probe.h"
+#if defined(USE_POSIX_SIM)
+#include <time.h>
+#else
 #include <libopencm3/stm32/rcc.h>
-#include <libopencm3/stm32/gpio.h>
-#include <libopencm3/stm32/i2c.h>
+#include <libopencm3/cm3/dwt.h>
+#endif
 #include <FreeRTOS.h>
 #include <task.h>
 
@@ -16,7 +21,9 @@
 #define HD_RETURNHOME       0x02
 #define HD_ENTRYMODESET     0x04
 #define HD_DISPLAYCONTROL   0x08
+#define HD_CURSORSHIFT      0x10
 #define HD_FUNCTIONSET      0x20
+#define HD_SETCGRAMADDR     0x40
 #define HD_SETDDRAMADDR     0x80
 
 #define HD_ENTRY_LEFT       0x02
@@ -26,14 +33,69 @@
 #define HD_CURSOR_ON        0x02
 #define HD_BLINK_ON         0x01
 
+#define HD_SHIFT_DISPLAY    0x08
+#define HD_SHIFT_RIGHT      0x04
+
 #define HD_4BITMODE         0x00
 #define HD_2LINE            0x08
 #define HD_5x8DOTS          0x00
 
-#define I2C_TIMEOUT         100000UL
+/* ── Datasheet timings (after the EN falling edge) ───────────────────────── */
+/* The other commands take 37 us, less than the next nibble's three bytes */
+#define HD_POWERUP_US       40000UL     /* Vcc above 2.7 V */
+#define HD_RESET1_US        4100UL      /* after the 1st 0x30 */
+#define HD_RESET2_US        100UL       /* after the 2nd and 3rd 0x30 */
+#define HD_CLEAR_US         1520UL      /* clear display, return home */
+#define HD_BUSY_TIMEOUT_US  (4 * HD_CLEAR_US)   /* a slow controller, else not wired */
+
+/* RW high and D4..D7 released (PCF8574 quasi-bidirectional: a 1 is a weak pull-up) */
+#define HD_READ_PORT        (LCD_D4 | LCD_D5 | LCD_D6 | LCD_D7 | LCD_RW)
+
+#define HD_GLYPH_FREE       0xFF
 
 static const uint8_t ROW_OFFSETS[] = { 0x00, 0x40, 0x14, 0x54 };
 
+/* in the .noinit RAM at the top of the SRAM, not cleared at the start up (linker scripts) */
+static_assert(sizeof(LcdWarmRecord) <= 256U, "256 of the 512 bytes of the .noinit region, the rest for watchdog and crash_dump");
+
+__attribute__((section(".noinit"))) static LcdWarmRecord s_warmRecord;
+
+LcdWarmRecord &lcd_warm_record(void)
+{
+    return s_warmRecord;
+}
+
+/* DWT cycles; the POSIX simulation counts the ns of the monotonic clock, a 1 GHz core */
+#if defined(USE_POSIX_SIM)
+static uint32_t lcd_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+#define LCD_CYCLES_PER_US   (1000UL)
+#else
+#define lcd_cycles()        DWT_CYCCNT
+#define LCD_CYCLES_PER_US   (rcc_ahb_frequency / 1000000UL)
+#endif
+
+/*
+ * Wait at least us: DWT cycles below a tick, the task sleeps above it (so
+ * it is never short by up to a tick). Counted from the end of the transfer.
+ */
+static void lcd_wait_us(uint32_t us)
+{
+    if (us >= (1000000UL / configTICK_RATE_HZ)) {
+        vTaskDelay((TickType_t)((us * configTICK_RATE_HZ + 999999UL) / 1000000UL) + 1);
+        return;
+    }
+
+    const uint32_t start  = lcd_cycles();
+    const uint32_t cycles = LCD_CYCLES_PER_US * us;
+    while ((lcd_cycles() - start) < cycles) {
+    }
+}
+
 #if (1 == DEBUG_ACTIVE)
 static void dbg_byte(const char *label, uint8_t val)
 {
@@ -51,90 +113,57 @@ static void dbg_byte(const char *label, uint8_t val)
 
 
 /* ── Constructor ─────────────────────────────────────────────────────────── */
-HD44780_PCF8574::HD44780_PCF8574(uint8_t i2c_address, uint8_t cols, uint8_t rows)
+HD44780_PCF8574::HD44780_PCF8574(uint8_t i2c_address, uint8_t cols, uint8_t rows, bool busy_flag)
     : _addr(i2c_address),
       _cols(cols),
       _rows(rows),
       _backlight(LCD_BL),
       _displayCtrl(HD_DISPLAY_ON),
-      _i2c_ok(false)
-{}
-
-/* ── I2C hardware setup ──────────────────────────────────────────────────── */
-void HD44780_PCF8574::i2c_setup(void)
+      _shift(0),
+      _i2c_ok(false),
+      _busyFlag(busy_flag),
+      _len(0),
+      _glyphClock(0)
 {
-    rcc_periph_clock_enable(RCC_I2C1);
-    rcc_periph_clock_enable(RCC_GPIOB);
-
-    gpio_set_mode(GPIOB,
-                  GPIO_MODE_OUTPUT_50_MHZ,
-                  GPIO_CNF_OUTPUT_ALTFN_OPENDRAIN,
-                  GPIO6 | GPIO7);
-
-    rcc_periph_reset_pulse(RST_I2C1);
-    i2c_peripheral_disable(I2C1);
-
-    i2c_set_clock_frequency(I2C1, 36);
-    i2c_set_standard_mode(I2C1);
-    i2c_set_ccr(I2C1, 180);
-    i2c_set_trise(I2C1, 37);
-
-    i2c_peripheral_enable(I2C1);
+    for (uint8_t i = 0; i < LCD_CGRAM_SLOTS; i++) {
+        _glyphId[i]  = HD_GLYPH_FREE;
+        _glyphUse[i] = 0;
+    }
 }
 
-/* ── Low-level I2C byte write ────────────────────────────────────────────── */
-bool HD44780_PCF8574::i2c_write_byte(uint8_t data)
+/* ── I2C byte queue ──────────────────────────────────────────────────────── */
+void HD44780_PCF8574::i2c_put(uint8_t data)
 {
-    uint32_t t;
-
-    t = I2C_TIMEOUT;
-    while (I2C_SR2(I2C1) & I2C_SR2_BUSY)
-        if (--t == 0) { _i2c_ok = false; return false; }
-
-    i2c_send_start(I2C1);
-
-    t = I2C_TIMEOUT;
-    while (!((I2C_SR1(I2C1) & I2C_SR1_SB) && (I2C_SR2(I2C1) & I2C_SR2_MSL)))
-        if (--t == 0) { _i2c_ok = false; return false; }
-
-    i2c_send_7bit_address(I2C1, _addr, I2C_WRITE);
-
-    t = I2C_TIMEOUT;
-    while (!(I2C_SR1(I2C1) & I2C_SR1_ADDR)) {
-        if (I2C_SR1(I2C1) & I2C_SR1_AF) {
-            I2C_SR1(I2C1) &= ~I2C_SR1_AF;
-            i2c_send_stop(I2C1);
-            _i2c_ok = false;
-            return false;
-        }
-        if (--t == 0) { i2c_send_stop(I2C1); _i2c_ok = false; return false; }
+    if (_len == sizeof(_buf)) {
+        i2c_flush();
     }
-    (void)I2C_SR2(I2C1);
-
-    i2c_send_data(I2C1, data);
-
-    t = I2C_TIMEOUT;
-    while (!(I2C_SR1(I2C1) & (I2C_SR1_BTF | I2C_SR1_TxE)))
-        if (--t == 0) { i2c_send_stop(I2C1); _i2c_ok = false; return false; }
+    _buf[_len++] = data;
+}
 
-    i2c_send_stop(I2C1);
-    _i2c_ok = true;
-    return true;
+/* One transaction for the queued bytes, the task blocks until the STOP */
+bool HD44780_PCF8574::i2c_flush(void)
+{
+    if (_len == 0) {
+        return _i2c_ok;
+    }
+    PROBE(LCD_I2C_BEGIN);
+    _i2c_ok = (I2C_MASTER_OK == i2c_master_write(_addr, _buf, _len));
+    PROBE(LCD_I2C_END);
+    _len = 0;
+    return _i2c_ok;
 }
 
 /* ── EN strobe ───────────────────────────────────────────────────────────── */
 void HD44780_PCF8574::lcd_pulse_enable(uint8_t data)
 {
-    i2c_write_byte(data | LCD_EN);
-    vTaskDelay(pdMS_TO_TICKS(5));
-    i2c_write_byte(data & ~LCD_EN);
-    vTaskDelay(pdMS_TO_TICKS(5));
+    i2c_put(data | LCD_EN);
+    i2c_put(data & ~LCD_EN);
 }
 
 /* ── Send one nibble ─────────────────────────────────────────────────────── */
 void HD44780_PCF8574::lcd_write4bits(uint8_t nibble)
 {
-    i2c_write_byte(nibble | _backlight);
+    i2c_put(nibble | _backlight);
     lcd_pulse_enable(nibble | _backlight);
 }
 
@@ -150,17 +179,80 @@ void HD44780_PCF8574::lcd_send(uint8_t value, uint8_t mode)
 void HD44780_PCF8574::command(uint8_t cmd)
 {
     lcd_send(cmd, 0);
+    i2c_flush();
+}
+
+/* ── Busy flag: D7 with RS=0, RW=1; the 2nd nibble is clocked and dropped ─ */
+bool HD44780_PCF8574::read_busy(bool *busy)
+{
+    const uint8_t port = HD_READ_PORT | _backlight;
+    uint8_t       in   = 0;
+
+    i2c_put(port);
+    i2c_put(port | LCD_EN);
+    if (!i2c_flush() || (I2C_MASTER_OK != i2c_master_read_byte(_addr, &in))) {
+        return false;
+    }
+    i2c_put(port);
+    i2c_put(port | LCD_EN);
+    i2c_put(port);
+    if (!i2c_flush()) {
+        return false;
+    }
+    *busy = (0 != (in & LCD_D7));
+    return true;
+}
+
+/* Until the controller is ready: polled, or the worst case us */
+void HD44780_PCF8574::wait_ready(uint32_t us)
+{
+    if (_busyFlag) {
+        const uint32_t start   = lcd_cycles();
+        const uint32_t timeout = LCD_CYCLES_PER_US * HD_BUSY_TIMEOUT_US;
+        bool           busy    = true;
+
+        while (read_busy(&busy) && busy) {
+            if ((lcd_cycles() - start) > timeout) {
+                _busyFlag = false;      // never clears: RW is not wired
+                break;
+            }
+        }
+        if (!busy) {
+            return;
+        }
+    }
+    lcd_wait_us(us);
 }
 
 /* ── Public API ──────────────────────────────────────────────────────────── */
 
+/* The bus up and the backpack acknowledging, the glyph slots free */
+bool HD44780_PCF8574::probe(void)
+{
+    i2c_master_setup();
+#if !defined(USE_POSIX_SIM)
+    dwt_enable_cycle_counter();
+#endif
+
+    _len   = 0;
+    _shift = 0;
+    for (uint8_t i = 0; i < LCD_CGRAM_SLOTS; i++) {
+        _glyphId[i] = HD_GLYPH_FREE;    /* CGRAM is undefined after power up */
+    }
+    i2c_put(_backlight);
+    return i2c_flush();
+}
+
 bool HD44780_PCF8574::init(void)
 {
-    i2c_setup();
-    vTaskDelay(pdMS_TO_TICKS(100));
+    /* Vcc came up with the MCU: only the rest of the power up time since the scheduler started */
+    const uint32_t up_us = (uint32_t)(((uint64_t)xTaskGetTickCount() * 1000000UL) / configTICK_RATE_HZ);
+    if (up_us < HD_POWERUP_US) {
+        lcd_wait_us(HD_POWERUP_US - up_us);
+    }
 
     /* Probe */
-    if (!i2c_write_byte(_backlight)) {
+    if (!probe()) {
 #if (1 == DEBUG_ACTIVE)
         uSHELL_PRINTF("LCD: probe FAIL\n");
 #endif /*(1 == DEBUG_ACTIVE)*/
@@ -171,8 +263,6 @@ bool HD44780_PCF8574::init(void)
     uSHELL_PRINTF("LCD: probe OK\n");
 #endif /*(1 == DEBUG_ACTIVE)*/
 
-    vTaskDelay(pdMS_TO_TICKS(10));
-
     /*
      * Print expected byte sequence so you can match against oscilloscope.
      * Each write4bits(0xXX) sends three I2C bytes to PCF8574:
@@ -197,9 +287,9 @@ bool HD44780_PCF8574::init(void)
     uSHELL_PRINTF("LCD: reset\n");
 #endif /*(1 == DEBUG_ACTIVE)*/
 
-    lcd_write4bits(0x30); vTaskDelay(pdMS_TO_TICKS(10));
-    lcd_write4bits(0x30); vTaskDelay(pdMS_TO_TICKS(5));
-    lcd_write4bits(0x30); vTaskDelay(pdMS_TO_TICKS(5));
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET1_US);
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET2_US);
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET2_US);
 
     /* 4-bit mode */
 #if (1 == DEBUG_ACTIVE)
@@ -207,7 +297,7 @@ bool HD44780_PCF8574::init(void)
 #endif /*(1 == DEBUG_ACTIVE)*/
 
     lcd_write4bits(0x20);
-    vTaskDelay(pdMS_TO_TICKS(5));
+    i2c_flush();
 
     /* Function set: 4-bit, 2 line, 5x8 */
 #if (1 == DEBUG_ACTIVE)
@@ -215,7 +305,6 @@ bool HD44780_PCF8574::init(void)
 #endif /*(1 == DEBUG_ACTIVE)*/
 
     command(HD_FUNCTIONSET | HD_4BITMODE | HD_2LINE | HD_5x8DOTS); /* 0x28 */
-    vTaskDelay(pdMS_TO_TICKS(5));
 
     /* Display on, cursor off, blink off */
     _displayCtrl = HD_DISPLAY_ON;
@@ -224,13 +313,11 @@ bool HD44780_PCF8574::init(void)
 #endif /*(1 == DEBUG_ACTIVE)*/
 
     command(HD_DISPLAYCONTROL | _displayCtrl);  /* 0x0C */
-    vTaskDelay(pdMS_TO_TICKS(5));
 
     clear();  /* 0x01 */
 
     /* Entry mode */
     command(HD_ENTRYMODESET | HD_ENTRY_LEFT | HD_ENTRY_SHIFTDEC); /* 0x06 */
-    vTaskDelay(pdMS_TO_TICKS(5));
 
 #if (1 == DEBUG_ACTIVE)    
     uSHELL_PRINTF("LCD: init done\n");
@@ -239,39 +326,76 @@ bool HD44780_PCF8574::init(void)
     return _i2c_ok;
 }
 
+/*
+ * Warm start, the controller powered through the reset: in 4-bit mode
+ * with the phase unknown. A first 0x3 nibble ends a byte cut in half
+ * (at worst a return home, hence the clear time), the next two are
+ * function sets to 8-bit mode whatever it ended, then the usual switch.
+ * No power up wait and no clear: the DDRAM is what the display shows.
+ */
+bool HD44780_PCF8574::resync(void)
+{
+    if (!probe()) {
+        return false;
+    }
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_CLEAR_US);
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET2_US);
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET2_US);
+    lcd_write4bits(0x20);
+    i2c_flush();
+
+    command(HD_FUNCTIONSET | HD_4BITMODE | HD_2LINE | HD_5x8DOTS);
+    command(HD_DISPLAYCONTROL | _displayCtrl);
+    command(HD_ENTRYMODESET | HD_ENTRY_LEFT | HD_ENTRY_SHIFTDEC);
+    home();     /* the window at 0, the DDRAM kept */
+    return _i2c_ok;
+}
+
 void HD44780_PCF8574::clear(void)
 {
     command(HD_CLEARDISPLAY);
-    vTaskDelay(pdMS_TO_TICKS(10));
+    wait_ready(HD_CLEAR_US);
+    _shift = 0;
 }
 
 void HD44780_PCF8574::home(void)
 {
     command(HD_RETURNHOME);
-    vTaskDelay(pdMS_TO_TICKS(10));
+    wait_ready(HD_CLEAR_US);
+    _shift = 0;
 }
 
 void HD44780_PCF8574::setCursor(uint8_t col, uint8_t row)
 {
     if (row >= _rows) row = _rows - 1;
-    if (col >= _cols) col = _cols - 1;
-    command(HD_SETDDRAMADDR | (col + ROW_OFFSETS[row]));
+    if (col >= lineLength()) col = lineLength() - 1;
+    lcd_send(HD_SETDDRAMADDR | (col + ROW_OFFSETS[row]), 0);   /* queued, see header */
 }
 
 void HD44780_PCF8574::write(char c)
 {
     lcd_send(static_cast<uint8_t>(c), LCD_RS);
+    i2c_flush();
 }
 
+/* The whole string in one transaction (after a queued cursor move) */
 void HD44780_PCF8574::print(const char *str)
 {
-    while (*str) write(*str++);
+    while (*str) lcd_send(static_cast<uint8_t>(*str++), LCD_RS);
+    i2c_flush();
+}
+
+void HD44780_PCF8574::print(const char *buf, uint8_t len)
+{
+    while (len--) lcd_send(static_cast<uint8_t>(*buf++), LCD_RS);
+    i2c_flush();
 }
 
 void HD44780_PCF8574::setBacklight(bool on)
 {
     _backlight = on ? LCD_BL : 0;
-    i2c_write_byte(_backlight);
+    i2c_put(_backlight);
+    i2c_flush();
 }
 
 void HD44780_PCF8574::displayOn(bool on)
@@ -294,3 +418,62 @@ void HD44780_PCF8574::blinkOn(bool on)
     else    _displayCtrl &= ~HD_BLINK_ON;
     command(HD_DISPLAYCONTROL | _displayCtrl);
 }
+
+/* The text goes left: the window starts one column further */
+void HD44780_PCF8574::shiftDisplay(bool left)
+{
+    lcd_send(HD_CURSORSHIFT | HD_SHIFT_DISPLAY | (left ? 0 : HD_SHIFT_RIGHT), 0);   /* queued */
+    _shift = left ? (uint8_t)((_shift + 1) % LCD_DDRAM_LINE)
+                  : (uint8_t)((_shift + LCD_DDRAM_LINE - 1) % LCD_DDRAM_LINE);
+}
+
+void HD44780_PCF8574::shiftCursor(bool right)
+{
+    lcd_send(HD_CURSORSHIFT | (right ? HD_SHIFT_RIGHT : 0), 0);                    /* queued */
+}
+
+/* ── CGRAM glyphs ────────────────────────────────────────────────────────── */
+
+void HD44780_PCF8574::createChar(uint8_t slot, const uint8_t *bitmap)
+{
+    lcd_send(HD_SETCGRAMADDR | ((slot & 0x07) << 3), 0);
+    for (uint8_t i = 0; i < 8; i++) {
+        lcd_send(bitmap[i] & 0x1F, LCD_RS);
+    }
+}
+
+char HD44780_PCF8574::findGlyph(uint8_t id)
+{
+    for (uint8_t i = 0; i < LCD_CGRAM_SLOTS; i++) {
+        if (_glyphId[i] == id) {
+            _glyphUse[i] = ++_glyphClock;
+            return (char)(LCD_CGRAM_CODE + i);
+        }
+    }
+    return 0;
+}
+
+/* A free slot first, else the one unused for longest */
+char HD44780_PCF8574::glyph(uint8_t id, const uint8_t *bitmap)
+{
+    const char code = findGlyph(id);
+    if (code != 0) {
+        return code;
+    }
+
+    uint8_t slot = 0;
+    for (uint8_t i = 0; i < LCD_CGRAM_SLOTS; i++) {
+        if (_glyphId[i] == HD_GLYPH_FREE) {
+            slot = i;
+            break;
+        }
+        if ((_glyphClock - _glyphUse[i]) > (_glyphClock - _glyphUse[slot])) {
+            slot = i;
+        }
+    }
+
+    createChar(slot, bitmap);
+    _glyphId[slot]  = id;
+    _glyphUse[slot] = ++_glyphClock;
+    return (char)(LCD_CGRAM_CODE + slot);
+}
@@ -0,0 +1,70 @@
+#ifndef ADC_ACQ_H
+#define ADC_ACQ_H
+
+#include <stdint.h>
+
+/*
+    ADC1 acquisition: a scan of up to ADC_ACQ_MAX_CHANNELS inputs (a set) at each TIM3 update,
+    written by a circular DMA into a buffer of two halves of ADC_ACQ_HALF_SETS sets each.
+
+        adc_acq_start(au8Channels, 4U, 8000U, onHalf);      from a task, or before the scheduler
+
+    The CPU does not touch a sample: TIM3 TRGO starts the scan, the DMA moves each conversion.
+    At half transfer the first half is complete and handed to the hook while the DMA fills the
+    second one, at transfer complete the other way round, i.e. one interrupt per
+    ADC_ACQ_HALF_SETS sets. The hook runs in the DMA interrupt (a kernel aware priority, the
+    FromISR calls are allowed): it hands the half over (AdcAO posts itself an event), the reader
+    has the time of one half, ADC_ACQ_HALF_SETS / rate, before the DMA writes it again, and
+    gives it back with adc_acq_release(). A half handed over again while still held counts an
+    overrun: its data changed under the reader.
+
+    The channels are the ADC inputs: 0..7 on PA0..PA7 and 8, 9 on PB0, PB1 (set to analog here),
+    16 the temperature sensor, 17 VREFINT. 12 bit, right aligned; the sample time is long
+    enough for a source of ~10 kOhm (ADC_ACQ_SAMPLE_TIME). The rate is what TIM3 can divide
+    its clock to, adc_acq_rate() has the one in use; a clock profile switch takes it from the
+    new APB1 clock (adc_acq_clock_changed()). STOP is held off while it runs (power_mgr_lock()).
+
+    TIM3, DMA1 channel 1 (F1) or DMA2 stream 0 (F4), the ADC1 and its inputs are taken.
+*/
+
+#define ADC_ACQ_MAX_CHANNELS    4U
+#define ADC_ACQ_HALF_SETS       32U         /* sets per half, per interrupt */
+#define ADC_ACQ_MAX_RATE_HZ     20000U      /* sets per second, 4 channels in the scan time */
+
+#define ADC_ACQ_TEMPERATURE     16U
+#define ADC_ACQ_VREFINT         17U
+
+/* from the DMA interrupt: the sets of one half, ADC_ACQ_HALF_SETS x u8Channels samples */
+typedef void (*adc_acq_hook_t)(const uint16_t *pu16Sets, uint8_t u8Half);
+
+typedef struct {
+    uint32_t u32Halves;     /* halves handed over */
+    uint32_t u32Overruns;   /* of those, the ones still held by the reader */
+} adc_acq_stats_s;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 0, or -1 if a channel, the count or the rate is out of range; a running acquisition is
+   stopped first */
+int adc_acq_start(const uint8_t *pu8Channels, uint8_t u8Channels, uint32_t u32RateHz, adc_acq_hook_t pfHook);
+
+void adc_acq_stop(void);
+
+/* the reader is done with a half it was handed */
+void adc_acq_release(uint8_t u8Half);
+
+/* sets per second as TIM3 divides, 0 while stopped */
+uint32_t adc_acq_rate(void);
+
+/* TIM3 again from the APB1 clock (clock_profile_set()), nothing while stopped */
+void adc_acq_clock_changed(void);
+
+void adc_acq_get_stats(adc_acq_stats_s *psStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADC_ACQ_H */
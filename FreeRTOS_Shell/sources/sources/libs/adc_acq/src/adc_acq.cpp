@@ -0,0 +1,294 @@
+#include "adc_acq.h"
+#include "isr_prof.h"
+#include "ram_func.h"
+#include "power_mgr.h"
+#include "libopencm3/stm32/rcc.h"
+#include "libopencm3/stm32/gpio.h"
+#include "libopencm3/stm32/adc.h"
+#include "libopencm3/stm32/dma.h"
+#include "libopencm3/stm32/timer.h"
+#include "libopencm3/cm3/nvic.h"
+
+#include <FreeRTOS.h>
+
+/* ADC1 request: DMA1 channel 1 (F1), DMA2 stream 0 channel 0 (F4) */
+#if defined(STM32F1)
+#define ADC_ACQ_DMA                 DMA1
+#define ADC_ACQ_DMA_CH              DMA_CHANNEL1
+#define ADC_ACQ_DMA_RCC             RCC_DMA1
+#define ADC_ACQ_DMA_IRQ             NVIC_DMA1_CHANNEL1_IRQ
+#define ADC_ACQ_DMA_ISR             dma1_channel1_isr
+#define ADC_ACQ_SAMPLE_TIME         ADC_SMPR_SMP_55DOT5CYC      /* 5.7 us with the 12.5 of the conversion at 12 MHz */
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+#define ADC_ACQ_DMA                 DMA2
+#define ADC_ACQ_DMA_CH              DMA_STREAM0
+#define ADC_ACQ_DMA_RCC             RCC_DMA2
+#define ADC_ACQ_DMA_IRQ             NVIC_DMA2_STREAM0_IRQ
+#define ADC_ACQ_DMA_ISR             dma2_stream0_isr
+#define ADC_ACQ_SAMPLE_TIME         ADC_SMPR_SMP_84CYC          /* 3.8 us with the 12 of the conversion at 25 MHz */
+#endif /*defined(STM32F4)*/
+
+#define ADC_ACQ_IRQ_PRIORITY        ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+
+static uint16_t s_au16Buffer[2U * ADC_ACQ_HALF_SETS * ADC_ACQ_MAX_CHANNELS];
+static uint8_t s_u8Channels = 0U;
+static uint32_t s_u32Requested = 0U;        /* sets per second asked for, 0 while stopped */
+static uint32_t s_u32Rate = 0U;             /* as TIM3 divides */
+static adc_acq_hook_t s_pfHook = nullptr;
+static uint8_t s_u8Held = 0U;               /* bit n: half n is with the reader */
+static adc_acq_stats_s s_sStats;
+
+
+/*--------------------------------------------------*/
+/* TIM3 runs at the APB1 clock, twice that when APB1 is divided */
+static uint32_t s_timer_clock(void)
+{
+    return (rcc_apb1_frequency == rcc_ahb_frequency) ? rcc_apb1_frequency : (2U * rcc_apb1_frequency);
+}
+
+/*--------------------------------------------------*/
+static void s_timer_rate(void)
+{
+    const uint32_t u32Clock = s_timer_clock();
+    const uint32_t u32Ticks = u32Clock / s_u32Requested;
+    const uint32_t u32Prescaler = (u32Ticks - 1U) / 65536U;
+    const uint32_t u32Period = (u32Ticks / (u32Prescaler + 1U)) - 1U;
+
+    timer_set_prescaler(TIM3, u32Prescaler);
+    timer_set_period(TIM3, u32Period);
+    s_u32Rate = u32Clock / ((u32Prescaler + 1U) * (u32Period + 1U));
+}
+
+/*--------------------------------------------------*/
+static void s_analog_input(uint8_t u8Channel)
+{
+    if (u8Channel >= 10U) {
+        return;     /* internal: temperature, VREFINT */
+    }
+    const uint32_t u32Port = (u8Channel < 8U) ? GPIOA : GPIOB;
+    const uint16_t u16Pin = (uint16_t)(1U << ((u8Channel < 8U) ? u8Channel : (u8Channel - 8U)));
+
+    rcc_periph_clock_enable((u8Channel < 8U) ? RCC_GPIOA : RCC_GPIOB);
+#if defined(STM32F1)
+    gpio_set_mode(u32Port, GPIO_MODE_INPUT, GPIO_CNF_INPUT_ANALOG, u16Pin);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    gpio_mode_setup(u32Port, GPIO_MODE_ANALOG, GPIO_PUPD_NONE, u16Pin);
+#endif /*defined(STM32F4)*/
+}
+
+/*--------------------------------------------------*/
+static void s_adc_setup(uint8_t *pu8Channels, uint8_t u8Channels)
+{
+    bool bInternal = false;
+
+    rcc_periph_clock_enable(RCC_ADC1);
+    adc_power_off(ADC1);
+    for (uint8_t i = 0U; i < u8Channels; ++i) {
+        s_analog_input(pu8Channels[i]);
+        bInternal = bInternal || (pu8Channels[i] >= ADC_ACQ_TEMPERATURE);
+    }
+
+#if defined(STM32F1)
+    rcc_periph_reset_pulse(RST_ADC1);
+    adc_enable_scan_mode(ADC1);
+    adc_set_single_conversion_mode(ADC1);
+    adc_set_right_aligned(ADC1);
+    adc_set_sample_time_on_all_channels(ADC1, ADC_ACQ_SAMPLE_TIME);
+    adc_set_regular_sequence(ADC1, u8Channels, pu8Channels);
+    adc_enable_external_trigger_regular(ADC1, ADC_CR2_EXTSEL_TIM3_TRGO);
+    if (bInternal) {
+        adc_enable_temperature_sensor();
+    }
+    adc_enable_dma(ADC1);
+    adc_power_on(ADC1);
+    for (volatile uint32_t u32Wait = 0U; u32Wait < 100U; ++u32Wait) {
+        /* tSTAB, 1 us before the calibration */
+    }
+    adc_reset_calibration(ADC1);
+    adc_calibrate(ADC1);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    adc_set_clk_prescale(ADC_CCR_ADCPRE_BY4);       /* 25 MHz from the 100 MHz APB2, 36 MHz at most */
+    adc_enable_scan_mode(ADC1);
+    adc_set_single_conversion_mode(ADC1);
+    adc_set_resolution(ADC1, ADC_CR1_RES_12BIT);
+    adc_set_right_aligned(ADC1);
+    adc_set_sample_time_on_all_channels(ADC1, ADC_ACQ_SAMPLE_TIME);
+    adc_set_regular_sequence(ADC1, u8Channels, pu8Channels);
+    adc_eoc_after_group(ADC1);
+    adc_set_dma_continue(ADC1);                     /* the requests go on after the last transfer (circular) */
+    adc_enable_external_trigger_regular(ADC1, ADC_CR2_EXTSEL_TIM3_TRGO, ADC_CR2_EXTEN_RISING_EDGE);
+    if (bInternal) {
+        adc_enable_temperature_sensor();
+    }
+    adc_enable_dma(ADC1);
+    adc_power_on(ADC1);
+#endif /*defined(STM32F4)*/
+}
+
+/*--------------------------------------------------*/
+static void s_dma_setup(uint32_t u32Samples)
+{
+    rcc_periph_clock_enable(ADC_ACQ_DMA_RCC);
+
+#if defined(STM32F1)
+    dma_channel_reset(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+    dma_set_read_from_peripheral(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+    dma_set_peripheral_size(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_CCR_PSIZE_16BIT);
+    dma_set_memory_size(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_CCR_MSIZE_16BIT);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    dma_stream_reset(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+    dma_channel_select(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_SxCR_CHSEL_0);
+    dma_set_transfer_mode(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_SxCR_DIR_PERIPHERAL_TO_MEM);
+    dma_set_peripheral_size(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_SxCR_PSIZE_16BIT);
+    dma_set_memory_size(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_SxCR_MSIZE_16BIT);
+#endif /*defined(STM32F4)*/
+
+    dma_set_peripheral_address(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, (uint32_t)(uintptr_t)&ADC_DR(ADC1));
+    dma_set_memory_address(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, (uint32_t)(uintptr_t)s_au16Buffer);
+    dma_set_number_of_data(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, (uint16_t)u32Samples);
+    dma_enable_memory_increment_mode(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+    dma_enable_circular_mode(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+    dma_enable_half_transfer_interrupt(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+    dma_enable_transfer_complete_interrupt(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+
+    nvic_set_priority(ADC_ACQ_DMA_IRQ, ADC_ACQ_IRQ_PRIORITY);
+    nvic_enable_irq(ADC_ACQ_DMA_IRQ);
+
+#if defined(STM32F1)
+    dma_enable_channel(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    dma_enable_stream(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+#endif /*defined(STM32F4)*/
+}
+
+/*--------------------------------------------------*/
+/* TRGO at each update: one scan per period */
+static void s_timer_setup(void)
+{
+    rcc_periph_clock_enable(RCC_TIM3);
+    rcc_periph_reset_pulse(RST_TIM3);
+    s_timer_rate();
+    timer_generate_event(TIM3, TIM_EGR_UG);     /* the prescaler loaded, before TRGO follows the updates */
+    timer_set_master_mode(TIM3, TIM_CR2_MMS_UPDATE);
+    timer_enable_counter(TIM3);
+}
+
+/*--------------------------------------------------*/
+static RAM_FUNC void s_hand_over(uint8_t u8Half)
+{
+    const uint8_t u8Bit = (uint8_t)(1U << u8Half);
+
+    s_sStats.u32Halves++;
+    if (0U != (__atomic_fetch_or(&s_u8Held, u8Bit, __ATOMIC_RELAXED) & u8Bit)) {
+        s_sStats.u32Overruns++;
+    }
+    s_pfHook(&s_au16Buffer[(uint32_t)u8Half * ADC_ACQ_HALF_SETS * s_u8Channels], u8Half);
+}
+
+
+/*--------------------------------------------------*/
+/* half transfer: the first half is complete, transfer complete: the second one; both when late */
+extern "C" RAM_FUNC void ADC_ACQ_DMA_ISR(void)
+{
+    ISR_PROF_ENTER(ISR_PROF_ADC_DMA);
+    if (dma_get_interrupt_flag(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_HTIF)) {
+        dma_clear_interrupt_flags(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_HTIF);
+        s_hand_over(0U);
+    }
+    if (dma_get_interrupt_flag(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_TCIF)) {
+        dma_clear_interrupt_flags(ADC_ACQ_DMA, ADC_ACQ_DMA_CH, DMA_TCIF);
+        s_hand_over(1U);
+    }
+    ISR_PROF_EXIT(ISR_PROF_ADC_DMA);
+}
+
+
+/*--------------------------------------------------*/
+int adc_acq_start(const uint8_t *pu8Channels, uint8_t u8Channels, uint32_t u32RateHz, adc_acq_hook_t pfHook)
+{
+    uint8_t au8Sequence[ADC_ACQ_MAX_CHANNELS];
+
+    if ((0U == u8Channels) || (u8Channels > ADC_ACQ_MAX_CHANNELS) || (nullptr == pfHook) ||
+        (0U == u32RateHz) || (u32RateHz > ADC_ACQ_MAX_RATE_HZ)) {
+        return -1;
+    }
+    for (uint8_t i = 0U; i < u8Channels; ++i) {
+        if ((pu8Channels[i] > ADC_ACQ_VREFINT) || ((pu8Channels[i] >= 10U) && (pu8Channels[i] < ADC_ACQ_TEMPERATURE))) {
+            return -1;
+        }
+        au8Sequence[i] = pu8Channels[i];
+    }
+
+    adc_acq_stop();
+    s_u8Channels   = u8Channels;
+    s_u32Requested = u32RateHz;
+    s_pfHook       = pfHook;
+    s_u8Held       = 0U;
+
+    power_mgr_lock();       /* STOP would halt TIM3 and the ADC */
+    s_adc_setup(au8Sequence, u8Channels);
+    s_dma_setup(2U * ADC_ACQ_HALF_SETS * u8Channels);
+    s_timer_setup();
+    return 0;
+}
+
+/*--------------------------------------------------*/
+void adc_acq_stop(void)
+{
+    if (0U == s_u32Requested) {
+        return;
+    }
+    timer_disable_counter(TIM3);
+    nvic_disable_irq(ADC_ACQ_DMA_IRQ);
+#if defined(STM32F1)
+    dma_disable_channel(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    dma_disable_stream(ADC_ACQ_DMA, ADC_ACQ_DMA_CH);
+#endif /*defined(STM32F4)*/
+    adc_disable_dma(ADC1);
+    adc_power_off(ADC1);
+
+    s_u32Requested = 0U;
+    s_u32Rate = 0U;
+    power_mgr_unlock();
+}
+
+/*--------------------------------------------------*/
+void adc_acq_release(uint8_t u8Half)
+{
+    __atomic_fetch_and(&s_u8Held, (uint8_t)~(1U << u8Half), __ATOMIC_RELAXED);
+}
+
+/*--------------------------------------------------*/
+uint32_t adc_acq_rate(void)
+{
+    return s_u32Rate;
+}
+
+/*--------------------------------------------------*/
+void adc_acq_clock_changed(void)
+{
+    if (0U == s_u32Requested) {
+        return;
+    }
+    timer_disable_counter(TIM3);
+    s_timer_rate();
+    timer_set_counter(TIM3, 0U);
+    timer_enable_counter(TIM3);
+}
+
+/*--------------------------------------------------*/
+void adc_acq_get_stats(adc_acq_stats_s *psStats)
+{
+    *psStats = s_sStats;
+}
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+CSV of the points from a terminal capture of the shell command adc 1 (the AdcAO stream)
+Usage: python3 adc_decode.py capture.bin points.csv   (the capture is read as bytes)
+
+    AD <inputs> <decimation> <points per frame> <rate>
+    <frames: AD F0, seq (u32), points x inputs x avg/min/max (u16), CRC32 of seq and points>
+    AD END <frames> <lost>
+
+All little endian. The text around the stream (the echo of the command, the prompt) is
+skipped. A frame with a wrong CRC is reported and dropped; a gap in seq is a frame the
+AdcAO lost (pool or stream queue full). One CSV row per point: its time in seconds from
+the first frame, then avg, min, max of each input.
+"""
+
+import argparse
+import binascii
+import re
+import struct
+import sys
+
+HEADER = re.compile(rb'AD (\d+) (\d+) (\d+) (\d+)\r?\n')
+TRAILER = re.compile(rb'\r?\n?AD END (\d+) (\d+)')
+SYNC = b'\xAD\xF0'
+
+
+class DecodeError(Exception):
+    pass
+
+
+def decode(capture):
+    header = HEADER.search(capture)
+    if header is None:
+        raise DecodeError("no AD header in the capture")
+    inputs, decimation, points, rate = (int(g) for g in header.groups())
+    size = 2 + 4 + points * inputs * 6 + 4
+    pos, frames, bad = header.end(), [], 0
+
+    # the frame size is fixed, the trailer follows the last one
+    while capture[pos:pos + 2] == SYNC and pos + size <= len(capture):
+        body = capture[pos + 2:pos + size - 4]
+        stored, = struct.unpack_from('<I', capture, pos + size - 4)
+        if stored == binascii.crc32(body):
+            seq, = struct.unpack_from('<I', body, 0)
+            frames.append((seq, struct.unpack_from(f'<{points * inputs * 3}H', body, 4)))
+        else:
+            bad += 1
+        pos += size
+
+    trailer = TRAILER.match(capture, pos)
+    if trailer is None:
+        raise DecodeError(f"no AD END line after {len(frames) + bad} frames, the capture is cut")
+    if int(trailer.group(1)) != len(frames) + bad:
+        raise DecodeError(f"{len(frames) + bad} frames decoded, {trailer.group(1).decode()} sent")
+    return (inputs, decimation, points, rate), frames, bad, int(trailer.group(2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('capture')
+    parser.add_argument('csv')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        capture = f.read()
+    try:
+        (inputs, decimation, points, rate), frames, bad, lost = decode(capture)
+    except (DecodeError, ValueError, struct.error) as error:
+        sys.exit(f"adc_decode: {error}")
+
+    period = decimation / rate
+    first = frames[0][0] if frames else 0
+    with open(args.csv, 'w') as f:
+        f.write('t,' + ','.join(f'in{i}_{k}' for i in range(inputs) for k in ('avg', 'min', 'max')) + '\n')
+        for seq, values in frames:
+            for p in range(points):
+                row = values[p * inputs * 3:(p + 1) * inputs * 3]
+                t = ((seq - first) * points + p) * period
+                f.write(f'{t:.6f},' + ','.join(str(v) for v in row) + '\n')
+
+    gaps = sum(b[0] - a[0] - 1 for a, b in zip(frames, frames[1:]))
+    print(f"{len(frames)} frames, {len(frames) * points} points of {inputs} inputs at {rate / decimation:g} Hz, "
+          f"{gaps} missing in seq ({lost} lost on the target), {bad} bad CRC")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,17 @@
+#ifndef U_ADC_CONFIG_HPP
+#define U_ADC_CONFIG_HPP
+
+#include <stdint.h>
+#include "adc_acq.h"
+
+// The inputs of the scan (adc_acq.h: 0..9 pins, 16 temperature,
+// 17 VREFINT), sets per second, and the sets averaged into one
+// point (a divisor of ADC_ACQ_HALF_SETS)
+struct AdcConfig {
+    uint8_t   channels[ADC_ACQ_MAX_CHANNELS];
+    uint8_t   count;
+    uint32_t  rateHz;
+    uint8_t   decimation;
+};
+
+#endif /* U_ADC_CONFIG_HPP */
@@ -1,18 +1,98 @@
 #ifndef U_AO_CONFIG_HPP
 #define U_AO_CONFIG_HPP
 
-#include "FreeRTOS.h"
+#include "AoPort.hpp"
+
+// 1: the ActiveObjects have no task of their own, AoKernel runs them
+//    all to completion from one task (highest priority ready first),
+//    from main() bare metal (AO_PORT_BARE_METAL, always 1)
+// 0: one task and stack per ActiveObject (FreeRTOS only with 1)
+#ifndef AO_COOPERATIVE_KERNEL
+#if (AO_PORT == AO_PORT_BARE_METAL)
+#define AO_COOPERATIVE_KERNEL   1
+#else
+#define AO_COOPERATIVE_KERNEL   0
+#endif
+#endif
+
+// 1: per-AO post/drop/queue depth/dispatch time counters (aostat command)
+#ifndef AO_STATS
+#define AO_STATS                1
+#endif
+
+// 1: every AO in one list (AoRegistry.hpp) with its queue, task and
+//    counters, for the ao command (occupancy, state, live drains)
+#ifndef AO_REGISTRY
+#define AO_REGISTRY             1
+#endif
+
+// 1: posts and dispatches go to the event trace (trace_rec, on with
+//    TRACE_REC): the AO id, the signal and the cycle time
+#ifndef AO_TRACE
+#if defined(TRACE_REC) && (TRACE_REC == 1)
+#define AO_TRACE                1
+#else
+#define AO_TRACE                0
+#endif
+#endif
+
+// 1: each AO task beats for the watchdog supervisor (watchdog.h), a
+//    count it advances around its wait for an event: odd while it
+//    waits, so a dispatch which never returns is a count that stays
+//    even; the AoKernel beats as one under AO_COOPERATIVE_KERNEL. On
+//    with WATCHDOG
+#ifndef AO_HEARTBEAT
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+#define AO_HEARTBEAT            1
+#else
+#define AO_HEARTBEAT            0
+#endif
+#endif
+
+// 1: ButtonAO stamps each edge in its EXTI ISR with the DWT cycle
+//    counter: SIG_BUTTON_PRESSED carries the edge CYCCNT, RELEASED and
+//    LONG_PRESS the hold time in microseconds (edge to edge), and the
+//    long press is decided on it. A hold wraps after 2^32 cycles
+//    (~59 s at 72 MHz). 0: hold times in ticks, taken at dispatch
+#ifndef AO_BUTTON_EDGE_TIMESTAMPS
+#define AO_BUTTON_EDGE_TIMESTAMPS   0
+#endif
+
+// 1: the shell is an AO (ShellAO.hpp) fed by SIG_UART_RX, it shares
+//    the event loop (the AoKernel task under AO_COOPERATIVE_KERNEL);
+//    0: a shell task of its own, blocked in Microshell::Run()
+#ifndef AO_SHELL
+#define AO_SHELL                0
+#endif
+
+// Resolution of the TimeEvent service (its timer ticks only while armed)
+#ifndef AO_TIME_EVENT_MS
+#define AO_TIME_EVENT_MS        10U
+#endif
+
+// Frame of a breathing LedPattern: its duty steps by AO_TIME_EVENT_MS,
+// so a frame has LED_BREATH_FRAME_MS / AO_TIME_EVENT_MS + 1 levels
+#ifndef LED_BREATH_FRAME_MS
+#define LED_BREATH_FRAME_MS     50U
+#endif
 
 // Passed to init() so callers can tune priorities/stack per instance
 struct AoConfig {
-    const char  *name;
-    UBaseType_t  priority;
-    uint32_t     stackWords;
-    uint8_t      queueDepth;
+    const char        *name;
+    AoPort::Priority   priority;    // higher is more urgent, any AO_PORT
+    uint32_t           stackWords;
+    uint8_t            queueDepth;
 };
 
 // Sensible defaults — override per instance as needed
 static constexpr AoConfig BUTTON_AO_DEFAULTS = { "ButtonAO", 3, 96, 8  };
-static constexpr AoConfig LED_AO_DEFAULTS    = { "LedAO",    2, 128, 8  };
+static constexpr AoConfig LED_AO_DEFAULTS    = { "LedAO",    2, 128, 0  };   // signals, no queue
+static constexpr AoConfig BUTTON_SCAN_DEFAULTS = { "KeyScan", 3, 128, 0  };   // a task, no queue
+static constexpr AoConfig BENCH_AO_DEFAULTS  = { "BenchAO",  2, 96,  1  };   // above the shell (bench)
+static constexpr AoConfig SHELL_AO_DEFAULTS  = { "ShellAO",  1, 512, 4  };   // the stack of the shell task
+
+// The AoKernel task (AO_COOPERATIVE_KERNEL): its stack runs every
+// dispatch, so it needs the largest of the AO stacks (LcdAO); no queue
+static constexpr AoConfig AO_KERNEL_DEFAULTS = { "AoKernel", 3, 512, 0  };
 
 #endif /*U_AO_CONFIG_HPP*/
\ No newline at end of file
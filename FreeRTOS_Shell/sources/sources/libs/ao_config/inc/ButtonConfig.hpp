@@ -4,14 +4,14 @@
 #include "GpioPin.hpp"
 #include "ExtiConfig.hpp"
 #include "GpioEvent.hpp"        
-#include "FreeRTOS.h"
+#include "AoPort.hpp"
 
 struct ButtonConfig {
     GpioPin           pin;
     ExtiConfig        exti;    
-    TickType_t        debounceTicks;
-    TickType_t        longPressTicks;
-    TickType_t        doubleClickTicks;
+    AoPort::Tick      debounceTicks;
+    AoPort::Tick      longPressTicks;
+    AoPort::Tick      doubleClickTicks;
     bool              activeLow;
     ButtonCallbackFn  callback;         
 };
@@ -0,0 +1,36 @@
+#ifndef U_BUTTON_SCAN_CONFIG_HPP
+#define U_BUTTON_SCAN_CONFIG_HPP
+
+#include "GpioPin.hpp"
+#include "GpioEvent.hpp"
+#include "AoPort.hpp"
+
+// Callback fired by ButtonScan on every cooked event, same signals
+// and param as ButtonCallbackFn; key is the index of the button:
+// inputs[key] direct, row * inputCount + column for a matrix (for
+// SIG_BUTTON_CHORD the lowest key of the chord)
+typedef void (*KeyCallbackFn)(Signal   sig,
+                              uint8_t  key,
+                              uint32_t param);
+
+struct ButtonScanConfig {
+    const GpioPin    *inputs;           // direct buttons, or the matrix columns
+    uint8_t           inputCount;
+    const GpioPin    *rows;             // matrix rows driven one at a time, NULL: direct
+    uint8_t           rowCount;
+    AoPort::Tick      scanTicks;        // sample period, a level holds 4 samples to count
+    AoPort::Tick      longPressTicks;
+    AoPort::Tick      doubleClickTicks; // window for the next click of a multi-click
+    uint8_t           maxClicks;        // clicks counted (2: double click), the Nth reports at once
+    AoPort::Tick      repeatDelayTicks; // held this long: SIG_BUTTON_REPEAT starts
+    AoPort::Tick      repeatTicks;      // then every repeatTicks, 0: no hold-repeat
+    const uint64_t   *chords;           // masks of keys (bit = key), NULL: none
+    uint8_t           chordCount;
+    bool              activeLow;        // direct: a closed key reads low (matrix: always)
+    KeyCallbackFn     callback;
+};
+
+// Mask of a chord of two keys, for ButtonScanConfig::chords
+#define BUTTON_SCAN_CHORD2(a, b)    ((1ULL << (a)) | (1ULL << (b)))
+
+#endif /* U_BUTTON_SCAN_CONFIG_HPP */
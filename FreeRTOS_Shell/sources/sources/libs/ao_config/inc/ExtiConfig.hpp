@@ -15,7 +15,8 @@ struct ExtiConfig {
     uint8_t             lineNumber; // numeric 0-15, used by registry
 };
 
-// Helpers for readability in GpioConfig.hpp
+// Helpers for readability in GpioConfig.hpp; a ButtonAO wants BOTH,
+// with FALLING alone it sees no release (a bounce of it at best)
 #define EXTI_CFG_FALLING(line, nvicIrq_, prio) \
     { EXTI##line, EXTI_TRIGGER_FALLING, nvicIrq_, prio, line }
 
@@ -17,9 +17,10 @@
 
 
     // ── Buttons: EXTI ─────────────────────────────────────────────
-    //                                   line  nvic_irq            prio
-#define EXTI_BUTTON_0   EXTI_CFG_FALLING(12,   NVIC_EXTI15_10_IRQ, configMAX_SYSCALL_INTERRUPT_PRIORITY)
-#define EXTI_BUTTON_1   EXTI_CFG_FALLING(13,   NVIC_EXTI15_10_IRQ, configMAX_SYSCALL_INTERRUPT_PRIORITY)
+    // Both edges: the release is an edge too (ButtonAO)
+    //                                line  nvic_irq            prio
+#define EXTI_BUTTON_0   EXTI_CFG_BOTH(12,   NVIC_EXTI15_10_IRQ, configMAX_SYSCALL_INTERRUPT_PRIORITY)
+#define EXTI_BUTTON_1   EXTI_CFG_BOTH(13,   NVIC_EXTI15_10_IRQ, configMAX_SYSCALL_INTERRUPT_PRIORITY)
 
 
 #elif defined(USE_STM32HAL)
@@ -29,6 +30,13 @@
     #define GPIO_BUTTON_0   { GPIOB, GPIO_PIN_12 }
     #define GPIO_BUTTON_1   { GPIOB, GPIO_PIN_13 }
 
+#elif defined(USE_POSIX_SIM)     // the simulated ports of GpioPin.hpp, no EXTI
+
+    #define GPIO_LED_0    	{ GPIOC, GPIO13 }
+
+    #define GPIO_BUTTON_0   { GPIOB, GPIO12 }
+    #define GPIO_BUTTON_1   { GPIOB, GPIO13 }
+
 #else
     #error "GPIO: no variant set"
 #endif
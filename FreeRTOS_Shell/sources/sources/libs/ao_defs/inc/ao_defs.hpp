@@ -5,12 +5,57 @@
 #include "GpioConfig.hpp"
 #include "LcdConfig.hpp"
 #include "LedConfig.hpp"
+#if !defined(USE_POSIX_SIM)
 #include "ButtonConfig.hpp"
+#include "AdcConfig.hpp"
+#include "AoConfig.hpp"
+#endif
+#include "EventBus.hpp"
 
+// Subscriber slots on AO_BUS — attach() each AO to its slot before use
+enum AoSlot : uint8_t {
+    AO_SLOT_LED_0 = 0,
+
+    AO_SLOT_COUNT
+};
+
+// The POSIX simulation (sources/sim_posix) has the LED and the LCD only: no EXTI, no ADC
+#if !defined(USE_POSIX_SIM)
 extern const ButtonConfig BUTTON_0;
 extern const ButtonConfig BUTTON_1;
+#endif
 
 extern const LcdConfig LCD_0;
 extern const LedConfig LED_0;
+#if !defined(USE_POSIX_SIM)
+extern const AdcConfig ADC_0;
+#endif
+
+#if !defined(USE_POSIX_SIM)
+// The configurations above with the values of the settings store over them (settings.cfg,
+// set / get), for the constructors: the btn.* times and lcd.addr, the queue depths at most
+// the ones of aoCfg (the static queues are sized for the defaults)
+ButtonConfig buttonTuned(const ButtonConfig &cfg);
+AoConfig     buttonAoTuned(const AoConfig &aoCfg);
+LcdConfig    lcdTuned(const LcdConfig &cfg);
+AoConfig     lcdAoTuned(const AoConfig &aoCfg);
+#endif
+
+extern EventBus AO_BUS;
+
+// Telemetry channels of uart_access (chan <mask>, tools/chan_demux.py),
+// the payloads little endian
+enum TelemetryChannel : uint8_t {
+    TELEMETRY_ADC    = 1,   // AdcAO frame: seq u32, inputs u8, decimation u8, points x inputs x avg/min/max u16
+    TELEMETRY_BUTTON = 2,   // button callback: button u8, signal u8, param u32, tick u32
+    TELEMETRY_AOSTAT = 3,   // aostat 2: tick u32, then per AO posts, drops, peak, dispatches, cyc max u32
+    TELEMETRY_STATS  = 4,   // stats 0: the snapshot of every counter, layout STATS_VERSION (ao_defs.cpp)
+};
+
+#if !defined(USE_POSIX_SIM)
+// The AdcAO tap: each frame on TELEMETRY_ADC while the channel is on
+struct AdcFrame;
+void adcTelemetry(const AdcFrame *frame);
+#endif
 
 #endif /*U_AO_DEFS_HPP*/
\ No newline at end of file
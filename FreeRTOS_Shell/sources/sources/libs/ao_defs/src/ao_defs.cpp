@@ -1,11 +1,28 @@
 #include "ao_defs.hpp"
+#if !defined(USE_POSIX_SIM)
+#include "AdcAO.hpp"
+#endif
+#include "uart_access.h"
+#include "checksum.h"
 #include "ushell_core_printout.h"
+#include "ushell_core_log.h"
+#include "ushell_core_datatypes.h"
+#if !defined(USE_POSIX_SIM)
+#include "settings.h"
+#endif
 
+#include <FreeRTOS.h>
+#include <task.h>
 
+#include <string.h>
+
+
+#if !defined(USE_POSIX_SIM)
 // -- buttons callbacks forward declaration -----------------------------------
 
 static void onButtonEvent_0(Signal sig, const GpioPin &btn, uint32_t param);
 static void onButtonEvent_1(Signal sig, const GpioPin &btn, uint32_t param);
+static void buttonTelemetry(uint8_t u8Button, Signal sig, uint32_t param);
 
 
 // -- buttons configuration ---------------------------------------------------
@@ -13,9 +30,9 @@ static void onButtonEvent_1(Signal sig, const GpioPin &btn, uint32_t param);
 const ButtonConfig BUTTON_0 = {
     .pin              = GPIO_BUTTON_0,
     .exti             = EXTI_BUTTON_0,
-    .debounceTicks    = pdMS_TO_TICKS(20),
-    .longPressTicks   = pdMS_TO_TICKS(1000),
-    .doubleClickTicks = pdMS_TO_TICKS(300),
+    .debounceTicks    = AO_MS_TO_TICKS(20),
+    .longPressTicks   = AO_MS_TO_TICKS(1000),
+    .doubleClickTicks = AO_MS_TO_TICKS(300),
     .activeLow        = true,
     .callback         = onButtonEvent_0
 };
@@ -23,12 +40,13 @@ const ButtonConfig BUTTON_0 = {
 const ButtonConfig BUTTON_1 = {
     .pin              = GPIO_BUTTON_1,
     .exti             = EXTI_BUTTON_1,      
-    .debounceTicks    = pdMS_TO_TICKS(20),
-    .longPressTicks   = pdMS_TO_TICKS(1000),
-    .doubleClickTicks = pdMS_TO_TICKS(300),
+    .debounceTicks    = AO_MS_TO_TICKS(20),
+    .longPressTicks   = AO_MS_TO_TICKS(1000),
+    .doubleClickTicks = AO_MS_TO_TICKS(300),
     .activeLow        = true,
     .callback         = onButtonEvent_1
 };
+#endif /*!defined(USE_POSIX_SIM)*/
 
 
 // -- LCD configuration -------------------------------------------------------
@@ -36,7 +54,8 @@ const ButtonConfig BUTTON_1 = {
 const LcdConfig LCD_0 = {
     .i2cAddress = 0x27,
     .cols       = 16,
-    .rows       = 2
+    .rows       = 2,
+    .busyFlag   = false
 };
 
 
@@ -48,36 +67,122 @@ const LedConfig LED_0 = {
 };
 
 
+#if !defined(USE_POSIX_SIM)
+// -- ADC configuration -------------------------------------------------------
+
+const AdcConfig ADC_0 = {
+    .channels   = { 0, 1, ADC_ACQ_TEMPERATURE, ADC_ACQ_VREFINT },  // PA0, PA1
+    .count      = 4,
+    .rateHz     = 4000,     // 125 points per input per second
+    .decimation = 32        // one point per DMA half
+};
+
+
+// -- settings over the configurations ----------------------------------------
+
+static uint8_t queueTuned(const AoConfig &aoCfg, settingId_e eId)
+{
+    const uint32_t u32Depth = settings_get(eId);
+    return (u32Depth < aoCfg.queueDepth) ? (uint8_t)u32Depth : aoCfg.queueDepth;
+}
+
+ButtonConfig buttonTuned(const ButtonConfig &cfg)
+{
+    ButtonConfig tuned = cfg;
+    tuned.debounceTicks    = AO_MS_TO_TICKS(settings_get(SETTING_BTN_DEBOUNCE_MS));
+    tuned.longPressTicks   = AO_MS_TO_TICKS(settings_get(SETTING_BTN_LONG_MS));
+    tuned.doubleClickTicks = AO_MS_TO_TICKS(settings_get(SETTING_BTN_DCLICK_MS));
+    return tuned;
+}
+
+AoConfig buttonAoTuned(const AoConfig &aoCfg)
+{
+    AoConfig tuned = aoCfg;
+    tuned.queueDepth = queueTuned(aoCfg, SETTING_BTN_QUEUE);
+    return tuned;
+}
+
+LcdConfig lcdTuned(const LcdConfig &cfg)
+{
+    LcdConfig tuned = cfg;
+    tuned.i2cAddress = (uint8_t)settings_get(SETTING_LCD_ADDR);
+    return tuned;
+}
+
+AoConfig lcdAoTuned(const AoConfig &aoCfg)
+{
+    AoConfig tuned = aoCfg;
+    tuned.queueDepth = queueTuned(aoCfg, SETTING_LCD_QUEUE);
+    return tuned;
+}
+#endif /*!defined(USE_POSIX_SIM)*/
+
+
+// -- event bus: who receives which signal -----------------------------------
+
+static_assert(AO_SLOT_COUNT <= EVENT_BUS_MAX_SLOTS, "too many AO slots");
+
+static constexpr SubscriberMask TO_LED_0 = EVENT_BUS_SLOT(AO_SLOT_LED_0);
+
+static const SubscriberMask AO_SUBSCRIBERS[] = {
+    0,          // SIG_NONE
+    0,          // SIG_RAW_EDGE             (ButtonAO internal)
+    0,          // SIG_BUTTON_PRESSED
+    0,          // SIG_BUTTON_RELEASED
+    0,          // SIG_BUTTON_SINGLE_CLICK
+    0,          // SIG_BUTTON_DOUBLE_CLICK
+    0,          // SIG_BUTTON_LONG_PRESS
+    0,          // SIG_BUTTON_MULTI_CLICK
+    0,          // SIG_BUTTON_REPEAT
+    0,          // SIG_BUTTON_CHORD
+    TO_LED_0,   // SIG_LED_ON
+    TO_LED_0,   // SIG_LED_OFF
+    TO_LED_0,   // SIG_LED_TOGGLE
+    0,          // SIG_LED_PATTERN          (posted to the LedAO itself)
+    0,          // SIG_TIMEOUT              (posted to the AO itself)
+    0,          // SIG_BENCH_PING           (posted to the bench AO)
+    0,          // SIG_UART_RX              (posted to the ShellAO)
+    0,          // SIG_ADC_HALF             (posted to the AdcAO itself)
+    0,          // SIG_ADC_START            (posted to the AdcAO itself)
+    0,          // SIG_ADC_FRAME            (AdcAO::subscribe(), a pool reference each)
+};
+
+static_assert(sizeof(AO_SUBSCRIBERS) / sizeof(AO_SUBSCRIBERS[0]) == SIG_COUNT,
+              "one subscriber mask per signal");
+
+EventBus AO_BUS(AO_SUBSCRIBERS);
+
+
+#if !defined(USE_POSIX_SIM)
 // -- buttons callbacks implementation ----------------------------------------
 
 static void onButtonEvent_0(Signal sig, const GpioPin &btn, uint32_t param)
 {
     (void)btn;      // Ignored here — use it to multiplex if >1 button
-    (void)param;    // Available for long-press duration etc.
 
-//  const Event e = { SIG_LED_TOGGLE, 0 };   // default
+    buttonTelemetry(0, sig, param);   // every signal, with the hold time of a release
 
     switch (sig)
     {
         case SIG_BUTTON_SINGLE_CLICK:
         {
-            //const Event ev = { SIG_LED_TOGGLE, 0 };
-            //ledAO.getAO()->post(ev);  
-            uSHELL_PRINTF("0: SINGLE_CLICK\n");
+            const Event ev = { SIG_LED_TOGGLE, 0 };
+            AO_BUS.publish(ev);
+            uSHELL_LOG_INFO("0: SINGLE_CLICK");
             break;
         }
         case SIG_BUTTON_DOUBLE_CLICK:
         {
-            //const Event ev = { SIG_LED_OFF, 0 };
-            //ledAO.getAO()->post(ev);
-            uSHELL_PRINTF("0: DOUBLE_CLICK\n");
+            const Event ev = { SIG_LED_OFF, 0 };
+            AO_BUS.publish(ev);
+            uSHELL_LOG_INFO("0: DOUBLE_CLICK");
             break;
         }
         case SIG_BUTTON_LONG_PRESS:
         {
-            // const Event ev = { SIG_LED_ON, 0 };
-            //ledAO.getAO()->post(ev);
-            uSHELL_PRINTF("0: LONG_PRESS\n");
+            const Event ev = { SIG_LED_ON, 0 };
+            AO_BUS.publish(ev);
+            uSHELL_LOG_INFO("0: LONG_PRESS");
             break;
         }
         default:
@@ -88,34 +193,453 @@ static void onButtonEvent_0(Signal sig, const GpioPin &btn, uint32_t param)
 static void onButtonEvent_1(Signal sig, const GpioPin &btn, uint32_t param)
 {
     (void)btn;      // Ignored here — use it to multiplex if >1 button
-    (void)param;    // Available for long-press duration etc.
 
-//  const Event e = { SIG_LED_TOGGLE, 0 };   // default
+    buttonTelemetry(1, sig, param);   // every signal, with the hold time of a release
 
     switch (sig)
     {
         case SIG_BUTTON_SINGLE_CLICK:
         {
-            //const Event ev = { SIG_LED_TOGGLE, 0 };
-            //ledAO.getAO()->post(ev);  
-            uSHELL_PRINTF("1: SINGLE_CLICK\n");
+            const Event ev = { SIG_LED_TOGGLE, 0 };
+            AO_BUS.publish(ev);
+            uSHELL_LOG_INFO("1: SINGLE_CLICK");
             break;
         }
         case SIG_BUTTON_DOUBLE_CLICK:
         {
-            //const Event ev = { SIG_LED_OFF, 0 };
-            //ledAO.getAO()->post(ev);
-            uSHELL_PRINTF("1: DOUBLE_CLICK\n");
+            const Event ev = { SIG_LED_OFF, 0 };
+            AO_BUS.publish(ev);
+            uSHELL_LOG_INFO("1: DOUBLE_CLICK");
             break;
         }
         case SIG_BUTTON_LONG_PRESS:
         {
-            // const Event ev = { SIG_LED_ON, 0 };
-            //ledAO.getAO()->post(ev);
-            uSHELL_PRINTF("1: LONG_PRESS\n");
+            const Event ev = { SIG_LED_ON, 0 };
+            AO_BUS.publish(ev);
+            uSHELL_LOG_INFO("1: LONG_PRESS");
             break;
         }
         default:
             break;      // PRESSED / RELEASED ignored here
     }
-}
\ No newline at end of file
+}
+#endif /*!defined(USE_POSIX_SIM)*/
+
+
+// -- telemetry ---------------------------------------------------------------
+
+static uint32_t putLe32(uint8_t *pu8Dst, uint32_t u32Value)
+{
+    for (uint32_t i = 0U; i < 4U; ++i) {
+        pu8Dst[i] = (uint8_t)(u32Value >> (8U * i));
+    }
+    return 4U;
+}
+
+#if !defined(USE_POSIX_SIM)
+static void buttonTelemetry(uint8_t u8Button, Signal sig, uint32_t param)
+{
+    if (0 == uart_channel_on(TELEMETRY_BUTTON)) {
+        return;
+    }
+    uint8_t au8Payload[2U + 4U + 4U];
+    au8Payload[0] = u8Button;
+    au8Payload[1] = (uint8_t)sig;
+    (void)putLe32(&au8Payload[2], param);
+    (void)putLe32(&au8Payload[6], (uint32_t)xTaskGetTickCount());
+    (void)uart_channel_write(TELEMETRY_BUTTON, au8Payload, sizeof(au8Payload));
+}
+
+/* in the AdcAO task, the only writer of the buffer; every frame goes out (adc 0 0 formats the
+   last point only), at ADC_ACQ_MAX_RATE_HZ it is the baud rate which drops some */
+void adcTelemetry(const AdcFrame *f)
+{
+    static uint8_t s_au8Payload[4U + 2U + (ADC_FRAME_POINTS * ADC_ACQ_MAX_CHANNELS * 6U)];
+    static_assert(sizeof(s_au8Payload) <= UART_CHANNEL_PAYLOAD_MAX, "an AdcFrame per telemetry frame");
+
+    if (0 == uart_channel_on(TELEMETRY_ADC)) {
+        return;
+    }
+    uint32_t u32Len = putLe32(s_au8Payload, f->seq);
+    s_au8Payload[u32Len++] = f->channels;
+    s_au8Payload[u32Len++] = f->decimation;
+    for (uint32_t p = 0U; p < ADC_FRAME_POINTS; ++p) {
+        for (uint32_t ch = 0U; ch < f->channels; ++ch) {
+            const uint16_t au16Point[3] = { f->point[p][ch].avg, f->point[p][ch].min, f->point[p][ch].max };
+            for (uint16_t u16 : au16Point) {
+                s_au8Payload[u32Len++] = (uint8_t)u16;
+                s_au8Payload[u32Len++] = (uint8_t)(u16 >> 8);
+            }
+        }
+    }
+    (void)uart_channel_write(TELEMETRY_ADC, s_au8Payload, (uint16_t)u32Len);
+}
+#endif /*!defined(USE_POSIX_SIM)*/
+
+
+// -- shell command -----------------------------------------------------------
+
+/* aostat 0 prints the counters of every AO, aostat 1 prints and resets them, aostat 2 sends
+   them on TELEMETRY_AOSTAT (every 1000 "aostat 2"), the AOs in the order of aostat 0 */
+extern "C" int aostat(uint32_t u32Reset)
+{
+#if (AO_STATS == 1)
+    if (2U == u32Reset) {
+        uint8_t au8Payload[UART_CHANNEL_PAYLOAD_MAX];
+        uint32_t u32Len = putLe32(au8Payload, (uint32_t)xTaskGetTickCount());
+
+        for (AoStats *s = AoStats::first(); (s != NULL) && (u32Len + 20U <= sizeof(au8Payload)); s = s->next) {
+            u32Len += putLe32(&au8Payload[u32Len], s->posts);
+            u32Len += putLe32(&au8Payload[u32Len], s->drops);
+            u32Len += putLe32(&au8Payload[u32Len], s->maxDepth);
+            u32Len += putLe32(&au8Payload[u32Len], s->dispatches);
+            u32Len += putLe32(&au8Payload[u32Len], s->cycMax);
+        }
+        if (0 != uart_channel_write(TELEMETRY_AOSTAT, au8Payload, (uint16_t)u32Len)) {
+            uSHELL_PRINTF("aostat: channel %u off or full (chan)\n", (unsigned)TELEMETRY_AOSTAT);
+            return -1;
+        }
+        return 0;
+    }
+
+    uSHELL_PRINTF("%-10s %8s %6s %5s %8s %8s %8s %8s\n",
+                  "AO", "posts", "drops", "depth", "disp", "cyc min", "cyc avg", "cyc max");
+
+    for (AoStats *s = AoStats::first(); s != NULL; s = s->next) {
+        const uint32_t avg = (s->dispatches != 0) ? (uint32_t)(s->cycSum / s->dispatches) : 0;
+        const uint32_t min = (s->dispatches != 0) ? s->cycMin : 0;
+
+        uSHELL_PRINTF("%-10s %8u %6u %5u %8u %8u %8u %8u\n",
+                      s->name, (unsigned)s->posts, (unsigned)s->drops, (unsigned)s->maxDepth,
+                      (unsigned)s->dispatches, (unsigned)min, (unsigned)avg, (unsigned)s->cycMax);
+        if (u32Reset != 0) {
+            s->reset();
+        }
+    }
+#else
+    (void)u32Reset;
+    uSHELL_PRINTF("aostat: built with AO_STATS 0\n");
+#endif
+    return 0;
+}
+
+/* ao 0 lists every AO: priority, task state, queue used and size (0: signal
+   transport), peak depth and the counters; ao n drains the n-th AO queue */
+extern "C" int ao(uint32_t u32Index)
+{
+#if (AO_REGISTRY == 1)
+    uint32_t n = 0;
+
+    if (u32Index == 0) {
+        uSHELL_PRINTF("%2s %-10s %4s %-8s %4s %4s %5s %8s %6s %8s\n",
+                      "#", "AO", "prio", "state", "used", "size", "peak", "posts", "drops", "disp");
+    }
+    for (AoRegistry *r = AoRegistry::first(); r != NULL; r = r->next) {
+        if (++n == u32Index) {
+            if (r->drain == NULL) {
+                uSHELL_PRINTF((r->queue != NULL) ? "ao: %s, typed slots, not drained\n"
+                                                 : "ao: %s, no queue\n", r->name);
+                return 0;
+            }
+            uSHELL_PRINTF("ao: %s, %u events drained\n", r->name, (unsigned)r->drain(r->ao));
+            return 0;
+        }
+        if (u32Index != 0) {
+            continue;
+        }
+
+        const char *state = (r->task != NULL) ? AoPort::taskState(r->task) : "AoKernel";
+#if (AO_STATS == 1)
+        const AoStats *s = r->stats;
+        uSHELL_PRINTF("%2u %-10s %4u %-8s %4u %4u %5u %8u %6u %8u\n",
+                      (unsigned)n, r->name, (unsigned)r->priority, state,
+                      (unsigned)r->waiting(), (unsigned)r->depth, (unsigned)s->maxDepth,
+                      (unsigned)s->posts, (unsigned)s->drops, (unsigned)s->dispatches);
+#else
+        uSHELL_PRINTF("%2u %-10s %4u %-8s %4u %4u\n",
+                      (unsigned)n, r->name, (unsigned)r->priority, state,
+                      (unsigned)r->waiting(), (unsigned)r->depth);
+#endif
+    }
+    if (u32Index > n) {
+        uSHELL_PRINTF("ao: %u AOs, no %u\n", (unsigned)n, (unsigned)u32Index);
+    }
+#else
+    (void)u32Index;
+    uSHELL_PRINTF("ao: built with AO_REGISTRY 0\n");
+#endif
+    return 0;
+}
+
+#if !defined(USE_POSIX_SIM)
+/* The snapshot of stats 0 on TELEMETRY_STATS, one frame, little endian, the offsets fixed for a
+   STATS_VERSION (a new field is a new version, tools/chan_demux.py decodes them):
+
+     0 version u8, flags u8 (STATS_*), tasks u8, AOs u8, seq u32, tick u32
+    12 heap: free, min ever free, largest block, mallocs, frees u32
+    32 uart: tx dropped, isr dropped, telemetry frames dropped u32
+    44 commands: calls, errors, max handler cycles u32 (uSHELL_IMPLEMENTS_COMMAND_STATS)
+    56 per task: number u8, state u8, priority u8, stack free words u16
+       per AO: queue used u8, peak u8, posts u32, drops u32
+
+   the tasks by xTaskNumber and the AOs in the order of ao 0, named by stats 1 */
+#define STATS_VERSION               (1U)
+#define STATS_HEADER_SIZE           (56U)
+#define STATS_TASK_SIZE             (5U)
+#define STATS_AO_SIZE               (10U)
+#define STATS_MAX_TASKS             (12U)       /* the snapshot scratch, static */
+
+#define STATS_HEAP                  (0x01U)     /* the heap fields are valid */
+#define STATS_TASKS                 (0x02U)     /* the tasks are there */
+#define STATS_AOS                   (0x04U)     /* the AOs are there */
+#define STATS_COMMANDS              (0x08U)     /* the command fields are valid */
+#define STATS_TASKS_CUT             (0x10U)     /* more tasks than STATS_MAX_TASKS or the frame */
+#define STATS_AOS_CUT               (0x20U)     /* more AOs than the rest of the frame */
+
+static_assert(STATS_HEADER_SIZE + (STATS_MAX_TASKS * STATS_TASK_SIZE) <= UART_CHANNEL_PAYLOAD_MAX,
+              "the tasks of the scratch in one frame");
+
+#if (configUSE_TRACE_FACILITY == 1)
+static TaskStatus_t s_asStatsTasks[STATS_MAX_TASKS];
+#endif
+static uint32_t s_u32StatsSeq = 0U;
+
+/* the tasks into the scratch (0 when it is too small), a scheduler suspension */
+static uint32_t statsTasks(void)
+{
+#if (configUSE_TRACE_FACILITY == 1)
+    return (uint32_t)uxTaskGetSystemState(s_asStatsTasks, STATS_MAX_TASKS, NULL);
+#else
+    return 0U;
+#endif
+}
+
+static uint32_t statsSnapshot(uint8_t *pu8Dst)
+{
+    uint8_t u8Flags = 0U;
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    HeapStats_t sHeap;
+    vPortGetHeapStats(&sHeap);
+    (void)putLe32(&pu8Dst[12], (uint32_t)sHeap.xAvailableHeapSpaceInBytes);
+    (void)putLe32(&pu8Dst[16], (uint32_t)sHeap.xMinimumEverFreeBytesRemaining);
+    (void)putLe32(&pu8Dst[20], (uint32_t)sHeap.xSizeOfLargestFreeBlockInBytes);
+    (void)putLe32(&pu8Dst[24], (uint32_t)sHeap.xNumberOfSuccessfulAllocations);
+    (void)putLe32(&pu8Dst[28], (uint32_t)sHeap.xNumberOfSuccessfulFrees);
+    u8Flags |= STATS_HEAP;
+#else
+    memset(&pu8Dst[12], 0, 20U);
+#endif
+    (void)putLe32(&pu8Dst[32], uart_tx_dropped());
+    (void)putLe32(&pu8Dst[36], uart_isr_dropped());
+    (void)putLe32(&pu8Dst[40], uart_channel_dropped());
+
+    uint32_t u32Calls = 0U;
+    uint32_t u32Errors = 0U;
+    uint32_t u32ExecMax = 0U;
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+    const uShellInst_s *psInst = pluginEntry();
+    for (int i = 0; i < psInst->iNrFunctions; ++i) {
+        const cmdStats_s *psCmd = &psInst->psCmdStatsArray[i];
+        u32Calls  += psCmd->u32Calls;
+        u32Errors += psCmd->u32Errors;
+        u32ExecMax = (psCmd->u32ExecMax > u32ExecMax) ? psCmd->u32ExecMax : u32ExecMax;
+    }
+    u8Flags |= STATS_COMMANDS;
+#endif
+    (void)putLe32(&pu8Dst[44], u32Calls);
+    (void)putLe32(&pu8Dst[48], u32Errors);
+    (void)putLe32(&pu8Dst[52], u32ExecMax);
+
+    uint32_t u32Len = STATS_HEADER_SIZE;
+
+    uint32_t u32Tasks = 0U;
+#if (configUSE_TRACE_FACILITY == 1)
+    const uint32_t u32Found = statsTasks();
+    u8Flags |= (0U != u32Found) ? STATS_TASKS : STATS_TASKS_CUT;
+    for (; u32Tasks < u32Found; ++u32Tasks) {
+        const TaskStatus_t *psTask = &s_asStatsTasks[u32Tasks];
+        pu8Dst[u32Len++] = (uint8_t)psTask->xTaskNumber;
+        pu8Dst[u32Len++] = (uint8_t)psTask->eCurrentState;
+        pu8Dst[u32Len++] = (uint8_t)psTask->uxCurrentPriority;
+        pu8Dst[u32Len++] = (uint8_t)psTask->usStackHighWaterMark;
+        pu8Dst[u32Len++] = (uint8_t)(psTask->usStackHighWaterMark >> 8);
+    }
+#endif
+
+    uint32_t u32Aos = 0U;
+#if (AO_REGISTRY == 1) && (AO_STATS == 1)
+    u8Flags |= STATS_AOS;
+    for (const AoRegistry *r = AoRegistry::first(); r != NULL; r = r->next) {
+        if (u32Len + STATS_AO_SIZE > UART_CHANNEL_PAYLOAD_MAX) {
+            u8Flags |= STATS_AOS_CUT;
+            break;
+        }
+        const uint32_t u32Used = r->waiting();
+        pu8Dst[u32Len++] = (uint8_t)((u32Used > 0xFFU) ? 0xFFU : u32Used);
+        pu8Dst[u32Len++] = (uint8_t)((r->stats->maxDepth > 0xFFU) ? 0xFFU : r->stats->maxDepth);
+        u32Len += putLe32(&pu8Dst[u32Len], r->stats->posts);
+        u32Len += putLe32(&pu8Dst[u32Len], r->stats->drops);
+        u32Aos++;
+    }
+#endif
+
+    pu8Dst[0] = (uint8_t)STATS_VERSION;
+    pu8Dst[1] = u8Flags;
+    pu8Dst[2] = (uint8_t)u32Tasks;
+    pu8Dst[3] = (uint8_t)u32Aos;
+    (void)putLe32(&pu8Dst[4], s_u32StatsSeq++);
+    (void)putLe32(&pu8Dst[8], (uint32_t)xTaskGetTickCount());
+    return u32Len;
+}
+
+/* stats 0 sends the snapshot on TELEMETRY_STATS (a host polls it, chan 0x11 first), stats 1
+   prints its layout version and the names of its task numbers and AO rows */
+extern "C" int stats(uint32_t u32Legend)
+{
+    if (0U == u32Legend) {
+        uint8_t au8Payload[UART_CHANNEL_PAYLOAD_MAX];
+        const uint32_t u32Len = statsSnapshot(au8Payload);
+
+        if (0 != uart_channel_write(TELEMETRY_STATS, au8Payload, (uint16_t)u32Len)) {
+            uSHELL_PRINTF("stats: channel %u off or full (chan)\n", (unsigned)TELEMETRY_STATS);
+            return -1;
+        }
+        return 0;
+    }
+
+    uSHELL_PRINTF("stats: layout %u on channel %u, %u bytes and up\n",
+                  (unsigned)STATS_VERSION, (unsigned)TELEMETRY_STATS, (unsigned)STATS_HEADER_SIZE);
+#if (configUSE_TRACE_FACILITY == 1)
+    const uint32_t u32Found = statsTasks();
+    if (0U == u32Found) {
+        uSHELL_PRINTF("stats: %u tasks, STATS_MAX_TASKS too small\n", (unsigned)uxTaskGetNumberOfTasks());
+    }
+    for (uint32_t i = 0U; i < u32Found; ++i) {
+        uSHELL_PRINTF("  task %3u %s\n", (unsigned)s_asStatsTasks[i].xTaskNumber, s_asStatsTasks[i].pcTaskName);
+    }
+#endif
+#if (AO_REGISTRY == 1) && (AO_STATS == 1)
+    uint32_t n = 0U;
+    for (const AoRegistry *r = AoRegistry::first(); r != NULL; r = r->next) {
+        uSHELL_PRINTF("  ao   %3u %s\n", (unsigned)n++, r->name);
+    }
+#endif
+    return 0;
+}
+#endif /*!defined(USE_POSIX_SIM)*/
+
+#if !defined(USE_POSIX_SIM)
+/* frames of the stream: 0xAD 0xF0, seq, the points of the inputs (avg, min, max), CRC32, all
+   little endian; tools/adc_decode.py of adc_acq reads them back */
+static void adcStreamFrame(const AdcFrame *f)
+{
+    uint8_t au8Frame[2U + 4U + (ADC_FRAME_POINTS * ADC_ACQ_MAX_CHANNELS * 6U) + 4U];
+    uint32_t u32Len = 0U;
+
+    au8Frame[u32Len++] = 0xADU;
+    au8Frame[u32Len++] = 0xF0U;
+    for (uint32_t i = 0U; i < 4U; ++i) {
+        au8Frame[u32Len++] = (uint8_t)(f->seq >> (8U * i));
+    }
+    for (uint32_t p = 0U; p < ADC_FRAME_POINTS; ++p) {
+        for (uint32_t ch = 0U; ch < f->channels; ++ch) {
+            const uint16_t au16Point[3] = { f->point[p][ch].avg, f->point[p][ch].min, f->point[p][ch].max };
+            for (uint16_t u16 : au16Point) {
+                au8Frame[u32Len++] = (uint8_t)u16;
+                au8Frame[u32Len++] = (uint8_t)(u16 >> 8);
+            }
+        }
+    }
+    const uint32_t u32Crc = checksum_crc32(0U, &au8Frame[2], u32Len - 2U);
+    for (uint32_t i = 0U; i < 4U; ++i) {
+        au8Frame[u32Len++] = (uint8_t)(u32Crc >> (8U * i));
+    }
+    uSHELL_WRITE((const char *)au8Frame, (int)u32Len);
+}
+
+/* adc 0 0: rate, counters and the last point of each input; adc 1 n: n frames in binary
+   (0: until a key); adc 2 r: start at r sets per second (1: the ADC_0 rate), 0 stops */
+extern "C" int adc(uint32_t u32Mode, uint32_t u32Arg)
+{
+    AdcAO *pAdc = AdcAO::instance();
+
+    if (NULL == pAdc) {
+        uSHELL_PRINTF("adc: no AdcAO in this image\n");
+        return -1;
+    }
+    const AdcConfig &cfg = pAdc->config();
+
+    switch (u32Mode) {
+        case 0:
+        {
+            adc_acq_stats_s sStats;
+            AdcPoint asPoint[ADC_ACQ_MAX_CHANNELS];
+            uint32_t u32Lost;
+
+            adc_acq_get_stats(&sStats);
+            pAdc->last(asPoint, &u32Lost);
+            uSHELL_PRINTF("adc: %u sets/s, %u inputs, decimation %u, halves %u, overruns %u, frames lost %u\n",
+                          (unsigned)adc_acq_rate(), (unsigned)cfg.count, (unsigned)cfg.decimation,
+                          (unsigned)sStats.u32Halves, (unsigned)sStats.u32Overruns, (unsigned)u32Lost);
+            for (uint8_t ch = 0U; ch < cfg.count; ++ch) {
+                uSHELL_PRINTF("  in%-2u avg %4u min %4u max %4u\n", (unsigned)cfg.channels[ch],
+                              (unsigned)asPoint[ch].avg, (unsigned)asPoint[ch].min, (unsigned)asPoint[ch].max);
+            }
+            return 0;
+        }
+        case 1:
+        {
+#if (AO_COOPERATIVE_KERNEL == 1) && (AO_SHELL == 1)
+            (void)u32Arg;
+            uSHELL_PRINTF("adc: the ShellAO shares the AoKernel task, no stream\n");
+            return -1;
+#else
+            if (0U == adc_acq_rate()) {
+                uSHELL_PRINTF("adc: stopped, adc 2 1 starts it\n");
+                return -1;
+            }
+            uint32_t u32Frames = 0U;
+            uint32_t u32Lost;
+            AdcPoint asPoint[ADC_ACQ_MAX_CHANNELS];
+            uint8_t u8Key;
+
+            pAdc->last(asPoint, &u32Lost);
+            const uint32_t u32LostBefore = u32Lost;
+            uSHELL_PRINTF("AD %u %u %u %u\n", (unsigned)cfg.count, (unsigned)cfg.decimation,
+                          (unsigned)ADC_FRAME_POINTS, (unsigned)adc_acq_rate());
+            pAdc->streamOpen();
+            while (((0U == u32Arg) || (u32Frames < u32Arg)) && (uart_read(&u8Key, 1, 0) <= 0)) {
+                AdcFrame *f = pAdc->take(AO_MS_TO_TICKS(100));
+                if (NULL != f) {
+                    adcStreamFrame(f);
+                    pAdc->release(f);
+                    ++u32Frames;
+                } else if (0U == adc_acq_rate()) {
+                    break;      /* stopped meanwhile */
+                }
+            }
+            pAdc->streamClose();
+            pAdc->last(asPoint, &u32Lost);
+            uSHELL_PRINTF("\nAD END %u %u\n", (unsigned)u32Frames, (unsigned)(u32Lost - u32LostBefore));
+            return 0;
+#endif
+        }
+        case 2:
+            if (u32Arg > ADC_ACQ_MAX_RATE_HZ) {
+                uSHELL_PRINTF("adc: %u sets/s at most\n", (unsigned)ADC_ACQ_MAX_RATE_HZ);
+                return -1;
+            }
+            if (0U == u32Arg) {
+                pAdc->stop();
+            } else {
+                pAdc->start((1U == u32Arg) ? ADC_0.rateHz : u32Arg);
+            }
+            return 0;
+
+        default:
+            uSHELL_PRINTF("usage: adc <0 show | 1 stream <frames, 0 until a key> | 2 start <rate, 1 default, 0 stop>>\n");
+            return -1;
+    }
+}
+#endif /*!defined(USE_POSIX_SIM)*/
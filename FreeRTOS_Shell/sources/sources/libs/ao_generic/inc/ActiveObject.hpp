@@ -1,66 +1,838 @@
 #ifndef U_ACTIVE_OBJECT_HPP
 #define U_ACTIVE_OBJECT_HPP
 
+#include <type_traits>
 #include "GpioEvent.hpp"
-#include "FreeRTOS.h"
-#include "task.h"
-#include "queue.h"
+#include "AoConfig.hpp"
+#include "AoStats.hpp"
+#include "AoRegistry.hpp"
+#include "AoPort.hpp"
+#include "ram_func.h"
+#include "probe.h"
+#if (AO_TRACE == 1)
+#include "trace_rec.h"
+#endif
+#if (AO_HEARTBEAT == 1)
+#include "watchdog.h"
+#endif
 
 typedef void (*DispatchFn)(void *instance, const Event &e);
 
-class ActiveObject {
+#if (AO_COOPERATIVE_KERNEL == 1)
+#if (AO_PORT != AO_PORT_FREERTOS) && (AO_PORT != AO_PORT_BARE_METAL)
+#error "AO_COOPERATIVE_KERNEL: FreeRTOS or bare metal only"
+#endif
+#if (AO_PORT == AO_PORT_BARE_METAL) && (AO_HEARTBEAT == 1)
+#error "AO_HEARTBEAT: the watchdog supervisor needs FreeRTOS"
+#endif
+
+// ─────────────────────────────────────────────────────────────────
+// AoKernel
+//
+// Cooperative (QV-style) kernel: one task runs every ActiveObject.
+// A post sets the AO's bit in the ready bitmap and notifies the
+// task, which dispatches one event of the highest priority ready
+// AO at a time, run to completion. Nothing ready: it blocks on the
+// notification and the idle hook sleeps in wfi. The bits follow
+// the AO priority (bit 0 highest, equal priorities in init order).
+// A dispatch that blocks (vTaskDelay) holds up the other AOs.
+// The AOs are of any event type, reached through two trampolines.
+//
+// Bare metal (AO_PORT_BARE_METAL) it is the superloop of main():
+// start() does not return, it runs the expired timer (TimeEvent)
+// and the ready AOs, and sleeps in wfi when neither is left.
+// ─────────────────────────────────────────────────────────────────
+class AoKernel {
+public:
+    static constexpr uint8_t MAX_AOS = 32;
+
+    typedef bool (*StepFn)(void *ao);
+
+    // From BasicActiveObject::init(), before start(). dispatchOne is
+    // false when there was nothing to dispatch, isEmpty true when
+    // nothing is left; readyBit is (re)assigned here
+    static void add(void        *ao,
+                    StepFn       dispatchOne,
+                    StepFn       isEmpty,
+                    uint32_t    *readyBit,
+                    AoPort::Priority priority);
+
+    // Call once, after the AOs init() and before vTaskStartScheduler();
+    // bare metal, instead of it (no return)
+    static void start(const AoConfig &cfg = AO_KERNEL_DEFAULTS);
+
+    static void ready(uint32_t bit)
+    {
+        AoPort::enterCritical();
+        s_ready |= bit;
+        AoPort::exitCritical();
+#if (AO_PORT == AO_PORT_FREERTOS)
+        if (s_task != NULL) {
+            xTaskNotifyGive(s_task);
+        }
+#endif
+    }
+
+    static void readyFromISR(uint32_t bit, AoPort::Woken *pxHigherPriorityTaskWoken)
+    {
+        const AoPort::IsrMask mask = AoPort::enterCriticalFromISR();
+        s_ready |= bit;
+        AoPort::exitCriticalFromISR(mask);
+#if (AO_PORT == AO_PORT_FREERTOS)
+        if (s_task != NULL) {
+            vTaskNotifyGiveFromISR(s_task, pxHigherPriorityTaskWoken);
+        }
+#else
+        (void)pxHigherPriorityTaskWoken;    // the wfi ends with the ISR
+#endif
+    }
+
+private:
+    struct Entry {
+        void        *ao;
+        StepFn       dispatchOne;
+        StepFn       isEmpty;
+        uint32_t    *readyBit;
+        AoPort::Priority priority;
+    };
+
+    static inline Entry              s_aos[MAX_AOS];
+    static inline uint8_t            s_count = 0;
+    static inline uint32_t           s_ready = 0;    // under a critical section
+#if (AO_PORT == AO_PORT_FREERTOS)
+    static inline TaskHandle_t       s_task  = NULL;
+#else
+    static inline bool               s_task  = false;   // started
+#endif
+#if (AO_HEARTBEAT == 1)
+    static inline volatile uint32_t  s_beat  = 0;    // the AoKernel task, for all its AOs
+    static inline watchdog_src_s     s_watch;
+#endif
+#if (AO_PORT == AO_PORT_FREERTOS) && (configSUPPORT_STATIC_ALLOCATION == 1)
+    static inline StackType_t        s_stack[AO_KERNEL_DEFAULTS.stackWords];
+    static inline StaticTask_t       s_taskBuffer;
+#endif
+
+    static void run(void *pvParams);
+};
+#endif
+
+// ─────────────────────────────────────────────────────────────────
+// BasicActiveObject
+//
+// Queue + task + dispatch, templated on the queued item: the queue
+// slots are sizeof(TEvent) and the handler gets a const TEvent &,
+// so a typed AO (LcdAO: a pool pointer per slot) shares the event
+// loop with the Event ones. The signal transport and the coalescing
+// post need the Event signal: ActiveObject only.
+// ─────────────────────────────────────────────────────────────────
+template <typename TEvent>
+class BasicActiveObject {
 public:
-    ActiveObject()
+    typedef void (*Handler)(void *instance, const TEvent &e);
+
+    static constexpr bool HAS_SIGNALS = std::is_same_v<TEvent, Event>;
+
+    BasicActiveObject()
         : m_queue(NULL)
         , m_task(NULL)
         , m_dispatchFn(NULL)
         , m_owner(NULL)
+        , m_pending(0)
+        , m_urgent(0)
+        , m_depth(0)
+#if (AO_TRACE == 1)
+        , m_traceId(TRACE_REC_NO_ID)
+#endif
+#if (AO_COOPERATIVE_KERNEL == 1)
+        , m_readyBit(0)
+        , m_signals(0)
+#endif
+#if (AO_HEARTBEAT == 1) && (AO_COOPERATIVE_KERNEL == 0)
+        , m_beat(0)
+#endif
     {}
 
-    void init(const char  *name,
-              DispatchFn   dispatchFn,
-              void        *ownerInstance,
-              UBaseType_t  priority,
-              uint32_t     stackWords,
-              uint8_t      queueDepth)
+#if (AO_PORT_DYNAMIC == 1)
+    void init(const char        *name,
+              Handler            dispatchFn,
+              void              *ownerInstance,
+              AoPort::Priority   priority,
+              uint32_t           stackWords,
+              uint8_t            queueDepth)
     {
         m_dispatchFn = dispatchFn;
         m_owner      = ownerInstance;
 
-        m_queue = xQueueCreate(queueDepth, sizeof(Event));
-        configASSERT(m_queue != NULL);
+        m_queue = AoPort::queueCreate(queueDepth, sizeof(TEvent));
+        AO_ASSERT(m_queue != NULL);
+        m_depth = queueDepth;
+        addName(name);
 
-        xTaskCreate(eventLoop, name, stackWords, this, priority, &m_task);
-        configASSERT(m_task != NULL);
+#if (AO_COOPERATIVE_KERNEL == 1)
+        (void)name;         // runs in the AoKernel task
+        (void)stackWords;
+        addToKernel(priority);
+#else
+        m_task = AoPort::taskCreate(eventLoop, name, stackWords, this, priority);
+        AO_ASSERT(m_task != NULL);
+#endif
+        addToRegistry(name, priority, queueDepth);
     }
 
-    void post(const Event &e)
+    // Signal transport, no queue: for AOs whose events are only a
+    // signal (below 32, param is 0 at dispatch). A post sets the bit
+    // in the task signal set (AoPort); the pending signals dispatch in
+    // signal order, each once however often it was posted
+    void initSignals(const char        *name,
+                     Handler            dispatchFn,
+                     void              *ownerInstance,
+                     AoPort::Priority   priority,
+                     uint32_t           stackWords)
     {
-        xQueueSend(m_queue, &e, 0);
+        static_assert(HAS_SIGNALS, "signal transport: Event AOs only");
+
+        m_dispatchFn = dispatchFn;
+        m_owner      = ownerInstance;
+        AoPort::signalsInit(&m_signalSet);
+        addName(name);
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+        (void)name;         // runs in the AoKernel task
+        (void)stackWords;
+        addToKernel(priority);
+#else
+        m_task = AoPort::taskCreate(signalLoop, name, stackWords, this, priority);
+        AO_ASSERT(m_task != NULL);
+#endif
+        addToRegistry(name, priority, 0);
+    }
+#endif
+
+    // Priority lane: the signals of the mask (below 32) are posted to
+    // the front of the queue, dispatched right after the event in
+    // progress whatever is queued behind them (the last urgent one
+    // first). The other posts leave them the last slot, a backlog
+    // drops those one earlier and never an urgent one. For a queue of
+    // 2 slots at least; the signal transport dispatches in signal order
+    void setUrgent(uint32_t signals)
+    {
+        static_assert(HAS_SIGNALS, "priority lane: Event AOs only");
+        m_urgent = signals;
     }
 
-    void postFromISR(const Event &e, BaseType_t *pxHigherPriorityTaskWoken)
+    // Non-blocking: false when dropped (queue full)
+    bool post(const TEvent &e)
     {
-        xQueueSendFromISR(m_queue, &e, pxHigherPriorityTaskWoken);
+        if constexpr (HAS_SIGNALS) {
+            if (m_queue == NULL) {
+                postSignal(e.signal);
+                return true;
+            }
+        }
+
+        const bool queued = isUrgent(e) ? AoPort::sendToFront(m_queue, &e)
+                                        : (hasRoom(m_urgent == 0 ? 0 : AoPort::waiting(m_queue)) &&
+                                           AoPort::send(m_queue, &e));
+
+#if (AO_STATS == 1)
+        m_stats.onPost(queued);
+#endif
+#if (AO_TRACE == 1)
+        if (queued) {
+            trace_rec_event(TRACE_AO_POST, m_traceId, signalOf(e));
+        }
+#endif
+#if (AO_COOPERATIVE_KERNEL == 1)
+        if (queued) {
+            AoKernel::ready(m_readyBit);
+        }
+#endif
+        return queued;
+    }
+
+    bool postFromISR(const TEvent &e, AoPort::Woken *pxHigherPriorityTaskWoken)
+    {
+        if constexpr (HAS_SIGNALS) {
+            if (m_queue == NULL) {
+                postSignalFromISR(e.signal, pxHigherPriorityTaskWoken);
+                return true;
+            }
+        }
+
+        const bool queued = isUrgent(e) ? AoPort::sendToFrontFromISR(m_queue, &e, pxHigherPriorityTaskWoken)
+                                        : (hasRoom(m_urgent == 0 ? 0 : AoPort::waitingFromISR(m_queue)) &&
+                                           AoPort::sendFromISR(m_queue, &e, pxHigherPriorityTaskWoken));
+
+#if (AO_STATS == 1)
+        m_stats.onPost(queued);
+#endif
+#if (AO_TRACE == 1)
+        if (queued) {
+            trace_rec_event(TRACE_AO_POST, m_traceId, signalOf(e));
+        }
+#endif
+#if (AO_COOPERATIVE_KERNEL == 1)
+        if (queued) {
+            AoKernel::readyFromISR(m_readyBit, pxHigherPriorityTaskWoken);
+        }
+#endif
+        return queued;
     }
 
+    // A post given up before the queue (no pool block): counted as a
+    // drop. Task or ISR
+    void dropped()
+    {
+#if (AO_STATS == 1)
+        m_stats.onPost(false);
+#endif
+    }
+
+    // Coalescing post for bursts (bouncing edges, signals below 32):
+    // while e.signal is pending, another one is merged into it — no
+    // queue slot, no wakeup. It stays pending until the AO calls
+    // clearPending(), at dispatch or later to merge a whole burst.
+    // false when merged or dropped: a post the queue refuses (full, or
+    // its last slot kept for the priority lane) leaves the signal not
+    // pending, else no event would ever clear it and every later edge
+    // would merge into nothing; the next edge posts again.
+    bool postCoalescedFromISR(const Event &e, AoPort::Woken *pxHigherPriorityTaskWoken)
+    {
+        static_assert(HAS_SIGNALS, "coalescing post: Event AOs only");
+
+        const uint32_t bit = 1UL << e.signal;
+        AO_ASSERT(e.signal < 32);
+
+        AoPort::IsrMask mask = AoPort::enterCriticalFromISR();
+        const bool merged = ((m_pending & bit) != 0);
+        m_pending |= bit;
+        AoPort::exitCriticalFromISR(mask);
+
+        if (merged) {
+            return false;
+        }
+        if (!postFromISR(e, pxHigherPriorityTaskWoken)) {
+            mask = AoPort::enterCriticalFromISR();
+            m_pending &= ~bit;
+            AoPort::exitCriticalFromISR(mask);
+            return false;
+        }
+        return true;
+    }
+
+    // AO side: the next postCoalescedFromISR() of sig is queued again
+    void clearPending(Signal sig)
+    {
+        AoPort::enterCritical();
+        m_pending &= ~(1UL << sig);
+        AoPort::exitCritical();
+    }
+
+protected:
+#if (AO_PORT_STATIC == 1)
+    // Same as init(), the queue and task memory is the caller's
+    // (no stack or task buffer with AO_COOPERATIVE_KERNEL)
+    void initStatic(const char           *name,
+                    Handler               dispatchFn,
+                    void                 *ownerInstance,
+                    AoPort::Priority      priority,
+                    uint32_t              stackWords,
+                    AoPort::Stack        *stack,
+                    AoPort::TaskBuffer   *taskBuffer,
+                    uint8_t               queueDepth,
+                    uint8_t              *queueStorage,
+                    AoPort::QueueBuffer  *queueBuffer)
+    {
+        m_dispatchFn = dispatchFn;
+        m_owner      = ownerInstance;
+
+        m_queue = AoPort::queueCreateStatic(queueBuffer, queueStorage, queueDepth,
+                                            sizeof(TEvent), name);
+        AO_ASSERT(m_queue != NULL);
+        m_depth = queueDepth;
+        addName(name);
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+        (void)name;         // runs in the AoKernel task
+        (void)stackWords;
+        (void)stack;
+        (void)taskBuffer;
+        addToKernel(priority);
+#else
+        m_task = AoPort::taskCreateStatic(taskBuffer, stack, eventLoop, name,
+                                          stackWords, this, priority);
+        AO_ASSERT(m_task != NULL);
+#endif
+        addToRegistry(name, priority, queueDepth);
+    }
+
+    // Same as initSignals(), the task memory is the caller's
+    void initSignalsStatic(const char           *name,
+                           Handler               dispatchFn,
+                           void                 *ownerInstance,
+                           AoPort::Priority      priority,
+                           uint32_t              stackWords,
+                           AoPort::Stack        *stack,
+                           AoPort::TaskBuffer   *taskBuffer)
+    {
+        static_assert(HAS_SIGNALS, "signal transport: Event AOs only");
+
+        m_dispatchFn = dispatchFn;
+        m_owner      = ownerInstance;
+        AoPort::signalsInit(&m_signalSet);
+        addName(name);
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+        (void)name;         // runs in the AoKernel task
+        (void)stackWords;
+        (void)stack;
+        (void)taskBuffer;
+        addToKernel(priority);
+#else
+        m_task = AoPort::taskCreateStatic(taskBuffer, stack, signalLoop, name,
+                                          stackWords, this, priority);
+        AO_ASSERT(m_task != NULL);
+#endif
+        addToRegistry(name, priority, 0);
+    }
+#endif
+
 private:
-    QueueHandle_t  m_queue;
-    TaskHandle_t   m_task;
-    DispatchFn     m_dispatchFn;
+    AoPort::Queue  m_queue;
+    AoPort::Task   m_task;
+    Handler        m_dispatchFn;
     void          *m_owner;
+    uint32_t       m_pending;       // coalesced signals, under a critical section
+    uint32_t       m_urgent;        // signals of the priority lane (setUrgent())
+    uint8_t        m_depth;
+#if (AO_STATS == 1)
+    AoStats        m_stats;
+#endif
+#if (AO_REGISTRY == 1)
+    AoRegistry     m_reg;
+#endif
+    [[no_unique_address]] AoPort::Signals m_signalSet;    // signal transport
+
+    bool isUrgent(const TEvent &e) const
+    {
+        if constexpr (HAS_SIGNALS) {
+            return (e.signal < 32) && ((m_urgent & (1UL << e.signal)) != 0);
+        } else {
+            (void)e;
+            return false;
+        }
+    }
 
-    static void eventLoop(void *pvParams)
+    // The last slot is the urgent ones' while there is a lane
+    bool hasRoom(uint32_t waiting) const
     {
-        ActiveObject *self = static_cast<ActiveObject *>(pvParams);
-        Event e;
+        return (m_urgent == 0) || ((waiting + 1U) < m_depth);
+    }
+
+    void postSignal(Signal sig)
+    {
+        AO_ASSERT(sig < 32);
+#if (AO_STATS == 1)
+        m_stats.onPost(true);   // never dropped, merged at worst
+#endif
+#if (AO_TRACE == 1)
+        trace_rec_event(TRACE_AO_POST, m_traceId, (uint16_t)sig);
+#endif
+#if (AO_COOPERATIVE_KERNEL == 1)
+        AoPort::enterCritical();
+        m_signals |= 1UL << sig;
+        AoPort::exitCritical();
+        AoKernel::ready(m_readyBit);
+#else
+        AoPort::signalsSet(m_task, &m_signalSet, 1UL << sig);
+#endif
+    }
+
+    void postSignalFromISR(Signal sig, AoPort::Woken *pxHigherPriorityTaskWoken)
+    {
+        AO_ASSERT(sig < 32);
+#if (AO_STATS == 1)
+        m_stats.onPost(true);
+#endif
+#if (AO_TRACE == 1)
+        trace_rec_event(TRACE_AO_POST, m_traceId, (uint16_t)sig);
+#endif
+#if (AO_COOPERATIVE_KERNEL == 1)
+        const AoPort::IsrMask mask = AoPort::enterCriticalFromISR();
+        m_signals |= 1UL << sig;
+        AoPort::exitCriticalFromISR(mask);
+        AoKernel::readyFromISR(m_readyBit, pxHigherPriorityTaskWoken);
+#else
+        AoPort::signalsSetFromISR(m_task, &m_signalSet, 1UL << sig, pxHigherPriorityTaskWoken);
+#endif
+    }
+
+    // Stats and trace id under the AO name (the task name, unless the
+    // AoKernel runs it)
+    void addName(const char *name)
+    {
+#if (AO_STATS == 1)
+        m_stats.add(name);
+#endif
+#if (AO_TRACE == 1)
+        m_traceId = trace_rec_id(TRACE_KIND_AO, this, name);
+#endif
+#if (AO_HEARTBEAT == 1) && (AO_COOPERATIVE_KERNEL == 0)
+        watchdog_watch(&m_watch, name, &m_beat, WATCHDOG_AO_STALL_MS);
+#endif
+        (void)name;
+    }
+
+    // Listed once the queue and task exist. Only an Event queue can
+    // be drained: the slots of a typed AO may own pool blocks
+    void addToRegistry(const char *name, AoPort::Priority priority, uint32_t depth)
+    {
+#if (AO_REGISTRY == 1)
+        AoRegistry::DrainFn drain = NULL;
+        if constexpr (HAS_SIGNALS) {
+            if (m_queue != NULL) {
+                drain = &BasicActiveObject::drainQueue;
+            }
+        }
+        m_reg.add(name, priority, m_queue, depth, m_task, this, drain);
+#if (AO_STATS == 1)
+        m_reg.stats = &m_stats;
+#endif
+#else
+        (void)name;
+        (void)priority;
+        (void)depth;
+#endif
+    }
+
+#if (AO_REGISTRY == 1)
+    // From another task: the queued events are dropped undispatched, and
+    // the coalesced signals cleared, or their next posts would stay merged
+    static uint32_t drainQueue(void *ao)
+    {
+        BasicActiveObject *self = static_cast<BasicActiveObject *>(ao);
+        TEvent e;
+        uint32_t n = 0;
+
+        while (AoPort::receive(self->m_queue, &e, 0)) {
+            ++n;
+        }
+        AoPort::enterCritical();
+        self->m_pending = 0;
+        AoPort::exitCritical();
+        return n;
+    }
+#endif
+
+#if (AO_HEARTBEAT == 1) && (AO_COOPERATIVE_KERNEL == 0)
+    volatile uint32_t  m_beat;      // odd while the task waits for an event
+    watchdog_src_s     m_watch;
+#endif
+
+    void beat()
+    {
+#if (AO_HEARTBEAT == 1) && (AO_COOPERATIVE_KERNEL == 0)
+        watchdog_beat(&m_beat);
+#endif
+    }
+
+#if (AO_TRACE == 1)
+    uint8_t        m_traceId;
+
+    static uint16_t signalOf(const TEvent &e)
+    {
+        if constexpr (HAS_SIGNALS) {
+            return (uint16_t)e.signal;
+        } else {
+            (void)e;
+            return 0;       // a typed AO: no signal
+        }
+    }
+#endif
+
+    // A received event to its handler (timed with AO_STATS, traced
+    // with AO_TRACE, the AO probe point), waiting is what is left behind it
+    RAM_FUNC void dispatchEvent(const TEvent &e, uint32_t waiting)
+    {
+#if (AO_TRACE == 1)
+        const uint16_t sig = signalOf(e);
+        trace_rec_event(TRACE_AO_BEGIN, m_traceId, sig);
+#endif
+        PROBE(AO_BEGIN);
+#if (AO_STATS == 1)
+        m_stats.onReceive(waiting);
+        const uint32_t t0 = AoStats::cycles();
+        m_dispatchFn(m_owner, e);
+        m_stats.onDispatch(t0);
+#else
+        (void)waiting;
+        m_dispatchFn(m_owner, e);
+#endif
+        PROBE(AO_END);
+#if (AO_TRACE == 1)
+        trace_rec_event(TRACE_AO_END, m_traceId, sig);
+#endif
+    }
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+    uint32_t       m_readyBit;
+    uint32_t       m_signals;       // signal transport, under a critical section
+
+    void addToKernel(AoPort::Priority priority)
+    {
+        AoKernel::add(this, &BasicActiveObject::stepOne, &BasicActiveObject::stepIsEmpty,
+                      &m_readyBit, priority);
+    }
+
+    static bool stepOne(void *ao)     { return static_cast<BasicActiveObject *>(ao)->dispatchOne(); }
+    static bool stepIsEmpty(void *ao) { return static_cast<BasicActiveObject *>(ao)->isEmpty(); }
+
+    // One event, run to completion; false when there was none
+    bool dispatchOne()
+    {
+        if constexpr (HAS_SIGNALS) {
+            if (m_queue == NULL) {
+                Event e = { SIG_NONE, 0 };
+
+                AoPort::enterCritical();
+                const uint32_t bits = m_signals;
+                if (bits != 0) {
+                    e.signal   = (Signal)__builtin_ctz(bits);
+                    m_signals &= bits - 1;
+                }
+                AoPort::exitCritical();
+                if (bits == 0) {
+                    return false;
+                }
+                dispatchEvent(e, (uint32_t)__builtin_popcount(bits) - 1);
+                return true;
+            }
+        }
+
+        TEvent e;
+        if (!AoPort::receive(m_queue, &e, 0)) {
+            return false;
+        }
+        dispatchEvent(e, AoPort::waiting(m_queue));
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return (m_queue == NULL) ? (m_signals == 0)
+                                 : (AoPort::waiting(m_queue) == 0);
+    }
+#else
+    RAM_FUNC static void eventLoop(void *pvParams)
+    {
+        BasicActiveObject *self = static_cast<BasicActiveObject *>(pvParams);
+        TEvent e;
+
+        for (;;) {
+            self->beat();
+            const bool received = AoPort::receive(self->m_queue, &e, AoPort::WAIT_FOREVER);
+            self->beat();
+            if (received) {
+                self->dispatchEvent(e, AoPort::waiting(self->m_queue));
+            }
+        }
+    }
+
+    RAM_FUNC static void signalLoop(void *pvParams)
+    {
+        BasicActiveObject *self = static_cast<BasicActiveObject *>(pvParams);
 
         for (;;) {
-            if (xQueueReceive(self->m_queue, &e, portMAX_DELAY) == pdPASS) {
-                self->m_dispatchFn(self->m_owner, e);
+            self->beat();
+            uint32_t bits = AoPort::signalsWait(&self->m_signalSet);
+            self->beat();
+            for (; bits != 0; bits &= bits - 1) {
+                const Event e = { (Signal)__builtin_ctz(bits), 0 };
+                self->dispatchEvent(e, (uint32_t)__builtin_popcount(bits) - 1);
+            }
+        }
+    }
+#endif
+};
+
+// The generic Event AO (signal + param)
+typedef BasicActiveObject<Event> ActiveObject;
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+inline void AoKernel::add(void        *ao,
+                          StepFn       dispatchOne,
+                          StepFn       isEmpty,
+                          uint32_t    *readyBit,
+                          AoPort::Priority priority)
+{
+    AO_ASSERT(!s_task);
+    AO_ASSERT(s_count < MAX_AOS);
+
+    // Keep s_aos sorted, highest priority first
+    uint8_t i = s_count++;
+    while ((i > 0) && (s_aos[i - 1].priority < priority)) {
+        s_aos[i] = s_aos[i - 1];
+        --i;
+    }
+    s_aos[i] = { ao, dispatchOne, isEmpty, readyBit, priority };
+
+    for (i = 0; i < s_count; ++i) {
+        *s_aos[i].readyBit = 1UL << i;
+    }
+}
+
+inline void AoKernel::start(const AoConfig &cfg)
+{
+    // Bits of posts made while the AOs were still being added are
+    // stale: look at every queue once
+    s_ready = (s_count < 32) ? ((1UL << s_count) - 1) : 0xFFFFFFFFUL;
+
+#if (AO_PORT == AO_PORT_BARE_METAL)
+    (void)cfg;
+    s_task = true;
+    run(NULL);
+#else
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    configASSERT(cfg.stackWords <= AO_KERNEL_DEFAULTS.stackWords);
+    s_task = xTaskCreateStatic(run, cfg.name, AO_KERNEL_DEFAULTS.stackWords,
+                               NULL, cfg.priority, s_stack, &s_taskBuffer);
+#else
+    xTaskCreate(run, cfg.name, cfg.stackWords, NULL, cfg.priority, &s_task);
+#endif
+    configASSERT(s_task != NULL);
+#if (AO_HEARTBEAT == 1)
+    watchdog_watch(&s_watch, cfg.name, &s_beat, WATCHDOG_AO_STALL_MS);
+#endif
+#endif
+}
+
+inline void AoKernel::run(void *pvParams)
+{
+    (void)pvParams;
+
+    for (;;) {
+#if (AO_PORT == AO_PORT_BARE_METAL)
+        AoPort::runTimer();
+
+        // Masked from the check to the wfi: a post in between ends it
+        const AoPort::IsrMask mask = AoPort::enterCriticalFromISR();
+        const uint32_t ready = s_ready;
+        if ((ready == 0) && !AoPort::timerDue()) {
+            __asm__ volatile ("wfi");
+        }
+        AoPort::exitCriticalFromISR(mask);
+
+        if (ready == 0) {
+            continue;
+        }
+#else
+        AoPort::enterCritical();
+        const uint32_t ready = s_ready;
+        AoPort::exitCritical();
+
+        if (ready == 0) {
+#if (AO_HEARTBEAT == 1)
+            watchdog_beat(&s_beat);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            watchdog_beat(&s_beat);
+#else
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#endif
+            continue;
+        }
+#endif
+
+        const Entry &ao = s_aos[__builtin_ctz(ready)];
+
+        if (!ao.dispatchOne(ao.ao) || ao.isEmpty(ao.ao)) {
+            // A post between the check and the clear sets the bit again
+            AoPort::enterCritical();
+            if (ao.isEmpty(ao.ao)) {
+                s_ready &= ~*ao.readyBit;
             }
+            AoPort::exitCritical();
         }
     }
+}
+#endif
+
+#if (AO_PORT_STATIC == 1)
+// ─────────────────────────────────────────────────────────────────
+// StaticActiveObject
+//
+// ActiveObject with its TCB, stack and queue storage embedded: no
+// heap, sized at compile time, and the memory shows in the linker
+// map under the owning instance. init() keeps the signature of
+// ActiveObject::init(); the sizes it is given must fit the template.
+// With AO_COOPERATIVE_KERNEL only the queue storage is embedded.
+// A TEvent other than Event makes a typed AO of that slot size.
+// ─────────────────────────────────────────────────────────────────
+template <uint32_t StackWords, uint8_t QueueDepth, typename TEvent = Event>
+class StaticActiveObject : public BasicActiveObject<TEvent> {
+public:
+    typedef typename BasicActiveObject<TEvent>::Handler Handler;
+
+    void init(const char        *name,
+              Handler            dispatchFn,
+              void              *ownerInstance,
+              AoPort::Priority   priority,
+              uint32_t           stackWords,
+              uint8_t            queueDepth)
+    {
+        AO_ASSERT(stackWords <= StackWords);
+        AO_ASSERT(queueDepth <= QueueDepth);
+        (void)stackWords;   // only checked when AO_ASSERT is on
+        (void)queueDepth;
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+        this->initStatic(name, dispatchFn, ownerInstance, priority,
+                         StackWords, NULL, NULL,
+                         QueueDepth, m_queueStorage, &m_queueBuffer);
+#else
+        this->initStatic(name, dispatchFn, ownerInstance, priority,
+                         StackWords, m_stack, &m_taskBuffer,
+                         QueueDepth, m_queueStorage, &m_queueBuffer);
+#endif
+    }
+
+private:
+#if (AO_COOPERATIVE_KERNEL == 0)
+    AO_PORT_STACK_MEMBER(m_stack, StackWords);
+    AoPort::TaskBuffer   m_taskBuffer;
+#endif
+    alignas(4) uint8_t   m_queueStorage[AoPort::queueStorageSize(QueueDepth, sizeof(TEvent))];
+    AoPort::QueueBuffer  m_queueBuffer;
+};
+
+// Same for the signal transport (initSignals()): no queue storage
+template <uint32_t StackWords>
+class StaticSignalActiveObject : public ActiveObject {
+public:
+    void initSignals(const char        *name,
+                     DispatchFn         dispatchFn,
+                     void              *ownerInstance,
+                     AoPort::Priority   priority,
+                     uint32_t           stackWords)
+    {
+        AO_ASSERT(stackWords <= StackWords);
+        (void)stackWords;   // only checked when AO_ASSERT is on
+
+#if (AO_COOPERATIVE_KERNEL == 1)
+        initSignalsStatic(name, dispatchFn, ownerInstance, priority,
+                          StackWords, NULL, NULL);
+#else
+        initSignalsStatic(name, dispatchFn, ownerInstance, priority,
+                          StackWords, m_stack, &m_taskBuffer);
+#endif
+    }
+
+#if (AO_COOPERATIVE_KERNEL == 0)
+private:
+    AO_PORT_STACK_MEMBER(m_stack, StackWords);
+    AoPort::TaskBuffer   m_taskBuffer;
+#endif
 };
+#endif
 
 #endif /*U_ACTIVE_OBJECT_HPP*/
@@ -0,0 +1,347 @@
+#ifndef U_ADC_AO_HPP
+#define U_ADC_AO_HPP
+
+#include "AdcConfig.hpp"
+#include "AoConfig.hpp"
+#include "EventPool.hpp"
+#include "ActiveObject.hpp"
+#include "AoPort.hpp"
+#include "adc_acq.h"
+
+// Points per frame, frames in the pool: the one being filled, the
+// stream queue and a subscriber each
+#define ADC_FRAME_POINTS        8U
+#define ADC_FRAME_POOL          4U
+#define ADC_STREAM_DEPTH        2U
+#define ADC_AO_MAX_SUBSCRIBERS  2U
+
+// ── Default AO config for the ADC ──────────────────────────────
+// Defined here so AoConfig.hpp stays generic (no ADC dependency);
+// a queue slot per half and one for a start or a stop
+static constexpr AoConfig ADC_AO_DEFAULTS = { "AdcAO", 3, 160, 4 };
+
+// avg/min/max of the decimation sets of one input
+struct AdcPoint {
+    uint16_t avg;
+    uint16_t min;
+    uint16_t max;
+};
+
+struct AdcFrame {
+    uint32_t seq;           // frames since the start, a gap is a lost one
+    uint8_t  channels;
+    uint8_t  decimation;
+    AdcPoint point[ADC_FRAME_POINTS][ADC_ACQ_MAX_CHANNELS];
+};
+
+// ─────────────────────────────────────────────────────────────────
+// AdcAO
+//
+// Sampling without the CPU: adc_acq scans the inputs at each TIM3
+// update into a ping-pong DMA buffer, the half which completed is
+// posted here as SIG_ADC_HALF (one ISR per ADC_ACQ_HALF_SETS sets).
+// The dispatch folds every decimation sets into an avg/min/max point
+// per input and fills pool frames of ADC_FRAME_POINTS points; a full
+// frame is published as a pool event: SIG_ADC_FRAME with the AdcFrame
+// pointer as param to each subscribe()d AO, which release()s it, and
+// to the stream queue of the adc command while it reads. A frame
+// nobody can take (pool empty, queue full) is counted as lost. A tap
+// sees each frame first, in the AO task, and must not wait (the
+// telemetry channel of uart_access).
+//
+// start() and stop() are posted, the AO task owns the acquisition;
+// it is stopped until the first start() (STOP is held off while it
+// runs). A half must be folded before the DMA comes back to it: at
+// the ADC_ACQ_MAX_RATE_HZ that is 1.6 ms, adc_acq counts the ones
+// which were not.
+// ─────────────────────────────────────────────────────────────────
+class AdcAO {
+public:
+    typedef void (*Tap)(const AdcFrame *frame);
+
+    AdcAO(const AdcConfig &adcCfg,
+          const AoConfig  &aoCfg = ADC_AO_DEFAULTS)
+        : m_cfg(adcCfg)
+        , m_aoCfg(aoCfg)
+        , m_halves{}
+        , m_frame(NULL)
+        , m_points(0)
+        , m_seq(0)
+        , m_lost(0)
+        , m_last{}
+        , m_subscribers{}
+        , m_stream(NULL)
+        , m_streaming(false)
+        , m_tap(NULL)
+    {}
+
+    // Call once before the scheduler starts
+    void init()
+    {
+        AO_ASSERT((m_cfg.count != 0) && (m_cfg.count <= ADC_ACQ_MAX_CHANNELS));
+        AO_ASSERT((m_cfg.decimation != 0) && ((ADC_ACQ_HALF_SETS % m_cfg.decimation) == 0));
+
+        m_ao.init(m_aoCfg.name,
+                  &AdcAO::dispatch,
+                  this,
+                  m_aoCfg.priority,
+                  m_aoCfg.stackWords,
+                  m_aoCfg.queueDepth);
+#if (AO_PORT_STATIC == 1)
+        m_stream = AoPort::queueCreateStatic(&m_streamBuffer, m_streamStorage, ADC_STREAM_DEPTH,
+                                             sizeof(AdcFrame *), "AdcStream");
+#else
+        m_stream = AoPort::queueCreate(ADC_STREAM_DEPTH, sizeof(AdcFrame *));
+#endif
+        AO_ASSERT(m_stream != NULL);
+        s_instance = this;
+    }
+
+    static AdcAO *instance() { return s_instance; }
+
+    ActiveObject *getAO() { return &m_ao; }
+
+    const AdcConfig &config() const { return m_cfg; }
+
+    // Any task: (re)start at rateHz sets per second (0: the AdcConfig
+    // rate, or the last one given), or stop (param UINT32_MAX)
+    void start(uint32_t rateHz = 0)
+    {
+        const Event e = { SIG_ADC_START, rateHz };
+        m_ao.post(e);
+    }
+
+    void stop()
+    {
+        const Event e = { SIG_ADC_START, UINT32_MAX };
+        m_ao.post(e);
+    }
+
+    // Before start(): a SIG_ADC_FRAME per frame to ao, who calls
+    // release() on it
+    void subscribe(ActiveObject *ao)
+    {
+        for (ActiveObject *&slot : m_subscribers) {
+            if (slot == NULL) {
+                slot = ao;
+                return;
+            }
+        }
+        AO_ASSERT(false);
+    }
+
+    void release(AdcFrame *frame) { m_pool.release(frame); }
+
+    // Any time, NULL removes it
+    void tap(Tap fn) { m_tap = fn; }
+
+    // The stream queue of a reader task (the adc command): frames are
+    // queued between open and close, take() waits for the next one
+    void streamOpen()
+    {
+        m_streaming = true;
+    }
+
+    AdcFrame *take(AoPort::Tick wait)
+    {
+        AdcFrame *frame = NULL;
+        return AoPort::receive(m_stream, &frame, wait) ? frame : NULL;
+    }
+
+    void streamClose()
+    {
+        m_streaming = false;
+        for (AdcFrame *frame = take(0); frame != NULL; frame = take(0)) {
+            m_pool.release(frame);
+        }
+    }
+
+    // The last point of each input and the frames lost, any task
+    void last(AdcPoint (&point)[ADC_ACQ_MAX_CHANNELS], uint32_t *lost)
+    {
+        AoPort::enterCritical();
+        for (uint8_t ch = 0; ch < ADC_ACQ_MAX_CHANNELS; ++ch) {
+            point[ch] = m_last[ch];
+        }
+        *lost = m_lost;
+        AoPort::exitCritical();
+    }
+
+private:
+#if (AO_PORT_STATIC == 1)
+    // Embedded at the default sizes, a custom AoConfig may ask for less
+    StaticActiveObject<ADC_AO_DEFAULTS.stackWords, ADC_AO_DEFAULTS.queueDepth> m_ao;
+    alignas(4) uint8_t   m_streamStorage[AoPort::queueStorageSize(ADC_STREAM_DEPTH, sizeof(AdcFrame *))];
+    AoPort::QueueBuffer  m_streamBuffer;
+#else
+    ActiveObject         m_ao;
+#endif
+    AdcConfig            m_cfg;
+    AoConfig             m_aoCfg;
+    const uint16_t      *m_halves[2];   // the DMA halves, from the first hook
+    AdcFrame            *m_frame;       // being filled
+    uint8_t              m_points;
+    uint32_t             m_seq;
+    uint32_t             m_lost;        // with m_last, under a critical section
+    AdcPoint             m_last[ADC_ACQ_MAX_CHANNELS];
+    ActiveObject        *m_subscribers[ADC_AO_MAX_SUBSCRIBERS];
+    AoPort::Queue        m_stream;
+    volatile bool        m_streaming;
+    Tap volatile         m_tap;
+    EventPool<AdcFrame, ADC_FRAME_POOL> m_pool;
+
+    static inline AdcAO *s_instance = NULL;
+
+    // ── DMA interrupt (adc_acq hook) ───────────────────────────
+    static void onHalf(const uint16_t *sets, uint8_t half)
+    {
+        AoPort::Woken xHigherPriorityTaskWoken = 0;
+        const Event e = { SIG_ADC_HALF, half };
+
+        // Queue full: the half stays held, adc_acq counts an overrun
+        // when it comes round again
+        s_instance->m_halves[half] = sets;
+        (void)s_instance->m_ao.postFromISR(e, &xHigherPriorityTaskWoken);
+        AoPort::yieldFromISR(xHigherPriorityTaskWoken);
+    }
+
+    // ── Trampoline ─────────────────────────────────────────────
+    static void dispatch(void *instance, const Event &e)
+    {
+        static_cast<AdcAO *>(instance)->handleEvent(e);
+    }
+
+    void handleEvent(const Event &e)
+    {
+        switch (e.signal) {
+            case SIG_ADC_HALF:
+                fold(m_halves[e.param]);
+                adc_acq_release((uint8_t)e.param);
+                break;
+
+            case SIG_ADC_START:
+                restart(e.param);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void restart(uint32_t rateHz)
+    {
+        adc_acq_stop();
+        if (m_frame != NULL) {
+            m_pool.release(m_frame);
+            m_frame = NULL;
+        }
+        m_points = 0;
+        m_seq    = 0;
+        if (rateHz == UINT32_MAX) {
+            return;
+        }
+        if (rateHz != 0) {
+            m_cfg.rateHz = rateHz;
+        }
+        (void)adc_acq_start(m_cfg.channels, m_cfg.count, m_cfg.rateHz, &AdcAO::onHalf);
+    }
+
+    // The decimation kernel: one pass over the half, sets interleaved
+    // by input
+    void fold(const uint16_t *sets)
+    {
+        const uint8_t  n     = m_cfg.count;
+        const uint8_t  decim = m_cfg.decimation;
+
+        for (uint32_t s0 = 0; s0 < ADC_ACQ_HALF_SETS; s0 += decim) {
+            AdcPoint point[ADC_ACQ_MAX_CHANNELS];
+
+            for (uint8_t ch = 0; ch < n; ++ch) {
+                const uint16_t *v   = &sets[(s0 * n) + ch];
+                uint32_t        sum = 0;
+                uint16_t        lo  = UINT16_MAX;
+                uint16_t        hi  = 0;
+
+                for (uint8_t i = 0; i < decim; ++i, v += n) {
+                    sum += *v;
+                    if (*v < lo) lo = *v;
+                    if (*v > hi) hi = *v;
+                }
+                point[ch] = { (uint16_t)(sum / decim), lo, hi };
+            }
+            add(point);
+        }
+    }
+
+    void add(const AdcPoint (&point)[ADC_ACQ_MAX_CHANNELS])
+    {
+        AoPort::enterCritical();
+        for (uint8_t ch = 0; ch < m_cfg.count; ++ch) {
+            m_last[ch] = point[ch];
+        }
+        AoPort::exitCritical();
+
+        // A frame the pool has no block for is skipped whole: a gap in seq
+        if (m_points == 0) {
+            m_frame = m_pool.alloc();
+            if (m_frame != NULL) {
+                m_frame->seq        = m_seq;
+                m_frame->channels   = m_cfg.count;
+                m_frame->decimation = m_cfg.decimation;
+            }
+        }
+        if (m_frame != NULL) {
+            for (uint8_t ch = 0; ch < m_cfg.count; ++ch) {
+                m_frame->point[m_points][ch] = point[ch];
+            }
+        }
+        if (++m_points < ADC_FRAME_POINTS) {
+            return;
+        }
+        m_points = 0;
+        if (m_frame != NULL) {
+            publish(m_frame);
+            m_frame = NULL;
+        } else {
+            ++m_seq;
+            lose();
+        }
+    }
+
+    // A reference per taker, the AO's own one last
+    void publish(AdcFrame *frame)
+    {
+        ++m_seq;
+        const Tap tap = m_tap;
+        if (tap != NULL) {
+            tap(frame);
+        }
+        for (ActiveObject *ao : m_subscribers) {
+            if (ao == NULL) {
+                continue;
+            }
+            m_pool.ref(frame);
+            const Event e = { SIG_ADC_FRAME, (uint32_t)(uintptr_t)frame };
+            if (!ao->post(e)) {
+                m_pool.release(frame);
+            }
+        }
+        if (m_streaming) {
+            m_pool.ref(frame);
+            if (!AoPort::send(m_stream, &frame)) {
+                m_pool.release(frame);
+                lose();
+            }
+        }
+        m_pool.release(frame);
+    }
+
+    void lose()
+    {
+        AoPort::enterCritical();
+        ++m_lost;
+        AoPort::exitCritical();
+    }
+};
+
+#endif /* U_ADC_AO_HPP */
@@ -0,0 +1,755 @@
+#ifndef U_AO_PORT_HPP
+#define U_AO_PORT_HPP
+
+#include <stdint.h>
+
+// ─────────────────────────────────────────────────────────────────
+// AoPort
+//
+// The kernel services the AOs use, so ActiveObject, EventPool,
+// TimeEvent, LcdAO, ButtonAO and LedAO build unchanged on FreeRTOS,
+// ThreadX or Zephyr: queue, task, one-shot timer, a 32-bit signal
+// set per task, critical sections and ticks. Pick the kernel with
+// AO_PORT (FreeRTOS by default). AoPort::Priority grows with the
+// urgency on every kernel, as in FreeRTOS; ThreadX and Zephyr are
+// mapped from it. ThreadX and Zephyr have no dynamic variant: the
+// memory of every object is the caller's (the Static* AOs).
+// AO_PORT_BARE_METAL has no kernel at all: the AoKernel superloop
+// (AO_COOPERATIVE_KERNEL) runs the AOs from main().
+// ─────────────────────────────────────────────────────────────────
+#define AO_PORT_FREERTOS    1
+#define AO_PORT_THREADX     2
+#define AO_PORT_ZEPHYR      3
+#define AO_PORT_BARE_METAL  4
+
+#ifndef AO_PORT
+#define AO_PORT             AO_PORT_FREERTOS
+#endif
+
+#if (AO_PORT == AO_PORT_FREERTOS)
+// ── FreeRTOS ────────────────────────────────────────────────────
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+#define AO_ASSERT(x)            configASSERT(x)
+#define AO_PORT_DYNAMIC         configSUPPORT_DYNAMIC_ALLOCATION
+#define AO_PORT_STATIC          configSUPPORT_STATIC_ALLOCATION
+#define AO_MS_TO_TICKS(ms)      pdMS_TO_TICKS(ms)
+#define AO_PORT_STACK_MEMBER(name, words)   StackType_t name[words]
+
+class AoPort {
+public:
+    typedef TickType_t      Tick;
+    typedef UBaseType_t     Priority;
+    typedef BaseType_t      Woken;          // set by the FromISR calls
+    typedef UBaseType_t     IsrMask;
+    typedef QueueHandle_t   Queue;
+    typedef StaticQueue_t   QueueBuffer;
+    typedef TaskHandle_t    Task;
+    typedef StaticTask_t    TaskBuffer;
+    typedef StackType_t     Stack;
+    typedef TimerHandle_t   Timer;
+    typedef StaticTimer_t   TimerBuffer;
+    typedef TimerHandle_t   TimerArg;       // what a timer callback gets
+    typedef void (*TaskFn)(void *arg);
+    typedef void (*TimerFn)(TimerArg);
+    struct Signals {};                      // the task notification value
+
+    static constexpr Tick     WAIT_FOREVER = portMAX_DELAY;
+    static constexpr uint32_t TICK_HZ      = configTICK_RATE_HZ;
+
+    static constexpr uint32_t queueStorageSize(uint32_t depth, uint32_t itemSize)
+    {
+        return depth * itemSize;
+    }
+
+    // ── Critical sections ──────────────────────────────────────
+    static void    enterCritical()              { taskENTER_CRITICAL(); }
+    static void    exitCritical()               { taskEXIT_CRITICAL(); }
+    static IsrMask enterCriticalFromISR()       { return taskENTER_CRITICAL_FROM_ISR(); }
+    static void    exitCriticalFromISR(IsrMask m) { taskEXIT_CRITICAL_FROM_ISR(m); }
+    static void    yieldFromISR(Woken woken)    { portYIELD_FROM_ISR(woken); }
+
+    // ── Time ───────────────────────────────────────────────────
+    static Tick now()                           { return xTaskGetTickCount(); }
+    static void delay(Tick ticks)               { vTaskDelay(ticks); }
+    // Periodic wake-up without drift: *last is the previous wake time
+    static void delayUntil(Tick *last, Tick period) { vTaskDelayUntil(last, period); }
+
+    // ── Queues (copy items of a fixed size, never block to send) ─
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    static Queue queueCreate(uint32_t depth, uint32_t itemSize)
+    {
+        return xQueueCreate(depth, itemSize);
+    }
+#endif
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    static Queue queueCreateStatic(QueueBuffer *buffer, uint8_t *storage,
+                                   uint32_t depth, uint32_t itemSize, const char *name)
+    {
+        (void)name;
+        return xQueueCreateStatic(depth, itemSize, storage, buffer);
+    }
+#endif
+    static bool send(Queue q, const void *item)
+    {
+        return xQueueSend(q, item, 0) == pdPASS;
+    }
+    static bool sendFromISR(Queue q, const void *item, Woken *woken)
+    {
+        return xQueueSendFromISR(q, item, woken) == pdPASS;
+    }
+    // Before the events queued: received next
+    static bool sendToFront(Queue q, const void *item)
+    {
+        return xQueueSendToFront(q, item, 0) == pdPASS;
+    }
+    static bool sendToFrontFromISR(Queue q, const void *item, Woken *woken)
+    {
+        return xQueueSendToFrontFromISR(q, item, woken) == pdPASS;
+    }
+    static bool receive(Queue q, void *item, Tick wait)
+    {
+        return xQueueReceive(q, item, wait) == pdPASS;
+    }
+    static uint32_t waiting(Queue q)
+    {
+        return uxQueueMessagesWaiting(q);
+    }
+    static uint32_t waitingFromISR(Queue q)
+    {
+        return uxQueueMessagesWaitingFromISR(q);
+    }
+
+    // ── Tasks ──────────────────────────────────────────────────
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    static Task taskCreate(TaskFn fn, const char *name, uint32_t stackWords,
+                           void *arg, Priority priority)
+    {
+        Task task = NULL;
+        xTaskCreate(fn, name, stackWords, arg, priority, &task);
+        return task;
+    }
+#endif
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    static Task taskCreateStatic(TaskBuffer *buffer, Stack *stack, TaskFn fn, const char *name,
+                                 uint32_t stackWords, void *arg, Priority priority)
+    {
+        return xTaskCreateStatic(fn, name, stackWords, arg, priority, stack, buffer);
+    }
+#endif
+    // For the ao command: what the task is doing right now
+    static const char *taskState(Task t)
+    {
+        static const char *const names[] = { "run", "ready", "blocked", "suspend", "deleted", "invalid" };
+        const eTaskState s = eTaskGetState(t);
+        return names[((unsigned)s < 6U) ? (unsigned)s : 5U];
+    }
+
+    // ── Signal set of a task (bits OR-ed in, taken all at once) ─
+    static void signalsInit(Signals *s)         { (void)s; }
+    static void signalsSet(Task t, Signals *s, uint32_t bits)
+    {
+        (void)s;
+        xTaskNotify(t, bits, eSetBits);
+    }
+    static void signalsSetFromISR(Task t, Signals *s, uint32_t bits, Woken *woken)
+    {
+        (void)s;
+        xTaskNotifyFromISR(t, bits, eSetBits, woken);
+    }
+    // From the task itself: blocks until a bit is set, returns and clears them
+    static uint32_t signalsWait(Signals *s)
+    {
+        uint32_t bits = 0;
+        (void)s;
+        while (xTaskNotifyWait(0, 0xFFFFFFFFUL, &bits, portMAX_DELAY) != pdPASS) {}
+        return bits;
+    }
+
+    // ── One-shot timer, the callback runs in the timer task ─────
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    static Timer timerCreateStatic(TimerBuffer *buffer, const char *name, Tick period, TimerFn fn)
+    {
+        return xTimerCreateStatic(name, period, pdFALSE, NULL, fn, buffer);
+    }
+#else
+    static Timer timerCreate(const char *name, Tick period, TimerFn fn)
+    {
+        return xTimerCreate(name, period, pdFALSE, NULL, fn);
+    }
+#endif
+    static void timerStart(Timer t)             { xTimerReset(t, 0); }
+
+private:
+    AoPort();
+};
+
+#elif (AO_PORT == AO_PORT_THREADX)
+// ── ThreadX ─────────────────────────────────────────────────────
+#include "tx_api.h"
+
+#define AO_ASSERT(x)            do { if (!(x)) { for (;;) {} } } while (0)
+#define AO_PORT_DYNAMIC         0
+#define AO_PORT_STATIC          1
+#define AO_MS_TO_TICKS(ms)      ((ULONG)(((uint64_t)(ms) * TX_TIMER_TICKS_PER_SECOND) / 1000U))
+#define AO_PORT_STACK_MEMBER(name, words)   ULONG name[words]
+
+class AoPort {
+public:
+    typedef ULONG           Tick;
+    typedef UINT            Priority;
+    typedef int32_t         Woken;          // ThreadX switches by itself
+    typedef UINT            IsrMask;
+    typedef TX_QUEUE       *Queue;
+    typedef TX_QUEUE        QueueBuffer;
+    typedef void (*TaskFn)(void *arg);
+    struct TaskBuffer { TX_THREAD thread; TaskFn fn; void *arg; };
+    typedef TaskBuffer     *Task;
+    typedef ULONG           Stack;
+    typedef TX_TIMER       *Timer;
+    typedef TX_TIMER        TimerBuffer;
+    typedef ULONG           TimerArg;
+    typedef void (*TimerFn)(TimerArg);
+    typedef TX_EVENT_FLAGS_GROUP Signals;
+
+    static constexpr Tick     WAIT_FOREVER = TX_WAIT_FOREVER;
+    static constexpr uint32_t TICK_HZ      = TX_TIMER_TICKS_PER_SECOND;
+
+    // Messages are whole ULONGs
+    static constexpr uint32_t queueStorageSize(uint32_t depth, uint32_t itemSize)
+    {
+        return depth * ((itemSize + 3U) / 4U) * 4U;
+    }
+
+    static void    enterCritical()              { s_mask = tx_interrupt_control(TX_INT_DISABLE); }
+    static void    exitCritical()               { tx_interrupt_control(s_mask); }
+    static IsrMask enterCriticalFromISR()       { return tx_interrupt_control(TX_INT_DISABLE); }
+    static void    exitCriticalFromISR(IsrMask m) { tx_interrupt_control(m); }
+    static void    yieldFromISR(Woken woken)    { (void)woken; }
+
+    static Tick now()                           { return tx_time_get(); }
+    static void delay(Tick ticks)               { tx_thread_sleep(ticks); }
+    static void delayUntil(Tick *last, Tick period)
+    {
+        const Tick left = *last + period - tx_time_get();
+        *last += period;
+        if ((left != 0) && (left <= period)) {
+            tx_thread_sleep(left);
+        }
+    }
+
+    static Queue queueCreateStatic(QueueBuffer *buffer, uint8_t *storage,
+                                   uint32_t depth, uint32_t itemSize, const char *name)
+    {
+        const UINT words = (itemSize + 3U) / 4U;
+        return (tx_queue_create(buffer, (CHAR *)name, words, storage,
+                                queueStorageSize(depth, itemSize)) == TX_SUCCESS) ? buffer : NULL;
+    }
+    static bool send(Queue q, const void *item)
+    {
+        return tx_queue_send(q, (VOID *)item, TX_NO_WAIT) == TX_SUCCESS;
+    }
+    static bool sendFromISR(Queue q, const void *item, Woken *woken)
+    {
+        (void)woken;
+        return send(q, item);
+    }
+    static bool sendToFront(Queue q, const void *item)
+    {
+        return tx_queue_front_send(q, (VOID *)item, TX_NO_WAIT) == TX_SUCCESS;
+    }
+    static bool sendToFrontFromISR(Queue q, const void *item, Woken *woken)
+    {
+        (void)woken;
+        return sendToFront(q, item);
+    }
+    static bool receive(Queue q, void *item, Tick wait)
+    {
+        return tx_queue_receive(q, item, wait) == TX_SUCCESS;
+    }
+    static uint32_t waiting(Queue q)
+    {
+        ULONG enqueued = 0;
+        tx_queue_info_get(q, NULL, &enqueued, NULL, NULL, NULL, NULL);
+        return enqueued;
+    }
+    static uint32_t waitingFromISR(Queue q)
+    {
+        return waiting(q);
+    }
+
+    static Task taskCreateStatic(TaskBuffer *buffer, Stack *stack, TaskFn fn, const char *name,
+                                 uint32_t stackWords, void *arg, Priority priority)
+    {
+        const UINT prio = nativePriority(priority);
+        buffer->fn  = fn;
+        buffer->arg = arg;
+        return (tx_thread_create(&buffer->thread, (CHAR *)name, entry, (ULONG)(uintptr_t)buffer,
+                                 stack, stackWords * sizeof(ULONG), prio, prio,
+                                 TX_NO_TIME_SLICE, TX_AUTO_START) == TX_SUCCESS) ? buffer : NULL;
+    }
+    static const char *taskState(Task t)
+    {
+        UINT state = TX_READY;
+        tx_thread_info_get(&t->thread, NULL, &state, NULL, NULL, NULL, NULL, NULL, NULL);
+        switch (state) {
+            case TX_READY:      return (tx_thread_identify() == &t->thread) ? "run" : "ready";
+            case TX_SUSPENDED:  return "suspend";
+            case TX_COMPLETED:
+            case TX_TERMINATED: return "deleted";
+            default:            return "blocked";   // sleep, queue, event flags, mutex...
+        }
+    }
+
+    static void signalsInit(Signals *s)         { tx_event_flags_create(s, (CHAR *)"AoSignals"); }
+    static void signalsSet(Task t, Signals *s, uint32_t bits)
+    {
+        (void)t;
+        tx_event_flags_set(s, bits, TX_OR);
+    }
+    static void signalsSetFromISR(Task t, Signals *s, uint32_t bits, Woken *woken)
+    {
+        (void)woken;
+        signalsSet(t, s, bits);
+    }
+    static uint32_t signalsWait(Signals *s)
+    {
+        ULONG bits = 0;
+        while (tx_event_flags_get(s, 0xFFFFFFFFUL, TX_OR_CLEAR, &bits, TX_WAIT_FOREVER) != TX_SUCCESS) {}
+        return bits;
+    }
+
+    // The callback runs in the ThreadX timer context
+    static Timer timerCreateStatic(TimerBuffer *buffer, const char *name, Tick period, TimerFn fn)
+    {
+        s_timerPeriod = period;
+        return (tx_timer_create(buffer, (CHAR *)name, fn, 0, period, 0,
+                                TX_NO_ACTIVATE) == TX_SUCCESS) ? buffer : NULL;
+    }
+    static void timerStart(Timer t)
+    {
+        tx_timer_deactivate(t);
+        tx_timer_change(t, s_timerPeriod, 0);
+        tx_timer_activate(t);
+    }
+
+private:
+    AoPort();
+
+    static inline UINT  s_mask        = 0;  // enterCritical() does not nest
+    static inline Tick  s_timerPeriod = 1;  // one service timer (TimeEvent)
+
+    // 0 is the most urgent ThreadX priority
+    static UINT nativePriority(Priority p)
+    {
+        return (p < TX_MAX_PRIORITIES) ? (TX_MAX_PRIORITIES - 1U - p) : 0U;
+    }
+
+    static void entry(ULONG input)
+    {
+        TaskBuffer *b = (TaskBuffer *)(uintptr_t)input;
+        b->fn(b->arg);
+    }
+};
+
+#elif (AO_PORT == AO_PORT_ZEPHYR)
+// ── Zephyr ──────────────────────────────────────────────────────
+#include <zephyr/kernel.h>
+#include <zephyr/version.h>
+
+#define AO_ASSERT(x)            __ASSERT_NO_MSG(x)
+#define AO_PORT_DYNAMIC         0
+#define AO_PORT_STATIC          1
+#define AO_MS_TO_TICKS(ms)      ((uint32_t)k_ms_to_ticks_ceil32(ms))
+#define AO_PORT_STACK_MEMBER(name, words)   K_KERNEL_STACK_MEMBER(name, (words) * 4U)
+
+class AoPort {
+public:
+    typedef uint32_t        Tick;
+    typedef int             Priority;
+    typedef int32_t         Woken;          // Zephyr switches by itself
+    typedef unsigned int    IsrMask;
+    typedef struct k_msgq  *Queue;
+    typedef struct k_msgq   QueueBuffer;
+    typedef void (*TaskFn)(void *arg);
+    struct TaskBuffer { struct k_thread thread; TaskFn fn; void *arg; };
+    typedef TaskBuffer     *Task;
+    typedef k_thread_stack_t Stack;
+    typedef struct k_timer *Timer;
+    typedef struct k_timer  TimerBuffer;
+    typedef struct k_timer *TimerArg;
+    typedef void (*TimerFn)(TimerArg);
+    typedef struct k_event  Signals;
+
+    static constexpr Tick     WAIT_FOREVER = UINT32_MAX;
+    static constexpr uint32_t TICK_HZ      = CONFIG_SYS_CLOCK_TICKS_PER_SEC;
+
+    static constexpr uint32_t queueStorageSize(uint32_t depth, uint32_t itemSize)
+    {
+        return depth * itemSize;
+    }
+
+    static void    enterCritical()              { s_key = irq_lock(); }
+    static void    exitCritical()               { irq_unlock(s_key); }
+    static IsrMask enterCriticalFromISR()       { return irq_lock(); }
+    static void    exitCriticalFromISR(IsrMask m) { irq_unlock(m); }
+    static void    yieldFromISR(Woken woken)    { (void)woken; }
+
+    static Tick now()                           { return (Tick)k_uptime_ticks(); }
+    static void delay(Tick ticks)               { k_sleep(K_TICKS(ticks)); }
+    static void delayUntil(Tick *last, Tick period)
+    {
+        const Tick left = *last + period - now();
+        *last += period;
+        if ((left != 0) && (left <= period)) {
+            k_sleep(K_TICKS(left));
+        }
+    }
+
+    static Queue queueCreateStatic(QueueBuffer *buffer, uint8_t *storage,
+                                   uint32_t depth, uint32_t itemSize, const char *name)
+    {
+        (void)name;
+        k_msgq_init(buffer, (char *)storage, itemSize, depth);
+        return buffer;
+    }
+    static bool send(Queue q, const void *item)
+    {
+        return k_msgq_put(q, item, K_NO_WAIT) == 0;
+    }
+    static bool sendFromISR(Queue q, const void *item, Woken *woken)
+    {
+        (void)woken;
+        return send(q, item);
+    }
+    // k_msgq_put_front() from Zephyr 4.1 on, before it the urgent events queue at the tail
+    static bool sendToFront(Queue q, const void *item)
+    {
+#if (KERNEL_VERSION_NUMBER >= ZEPHYR_VERSION(4, 1, 0))
+        return k_msgq_put_front(q, item) == 0;
+#else
+        return send(q, item);
+#endif
+    }
+    static bool sendToFrontFromISR(Queue q, const void *item, Woken *woken)
+    {
+        (void)woken;
+        return sendToFront(q, item);
+    }
+    static bool receive(Queue q, void *item, Tick wait)
+    {
+        return k_msgq_get(q, item, (wait == WAIT_FOREVER) ? K_FOREVER : K_TICKS(wait)) == 0;
+    }
+    static uint32_t waiting(Queue q)
+    {
+        return k_msgq_num_used_get(q);
+    }
+    static uint32_t waitingFromISR(Queue q)
+    {
+        return waiting(q);
+    }
+
+    static Task taskCreateStatic(TaskBuffer *buffer, Stack *stack, TaskFn fn, const char *name,
+                                 uint32_t stackWords, void *arg, Priority priority)
+    {
+        buffer->fn  = fn;
+        buffer->arg = arg;
+        k_thread_create(&buffer->thread, stack, stackWords * 4U, entry, buffer, NULL, NULL,
+                        nativePriority(priority), 0, K_NO_WAIT);
+        k_thread_name_set(&buffer->thread, name);
+        return buffer;
+    }
+    // k_thread_state_str() into one buffer: printed before the next call
+    static const char *taskState(Task t)
+    {
+        static char buf[16];
+        return k_thread_state_str(&t->thread, buf, sizeof(buf));
+    }
+
+    static void signalsInit(Signals *s)         { k_event_init(s); }
+    static void signalsSet(Task t, Signals *s, uint32_t bits)
+    {
+        (void)t;
+        k_event_post(s, bits);
+    }
+    static void signalsSetFromISR(Task t, Signals *s, uint32_t bits, Woken *woken)
+    {
+        (void)woken;
+        signalsSet(t, s, bits);
+    }
+    static uint32_t signalsWait(Signals *s)
+    {
+        const uint32_t bits = k_event_wait(s, 0xFFFFFFFFUL, false, K_FOREVER);
+        k_event_clear(s, bits);     // one set meanwhile merges into these
+        return bits;
+    }
+
+    // The callback runs in the system clock ISR
+    static Timer timerCreateStatic(TimerBuffer *buffer, const char *name, Tick period, TimerFn fn)
+    {
+        (void)name;
+        s_timerPeriod = period;
+        k_timer_init(buffer, fn, NULL);
+        return buffer;
+    }
+    static void timerStart(Timer t)             { k_timer_start(t, K_TICKS(s_timerPeriod), K_NO_WAIT); }
+
+private:
+    AoPort();
+
+    static inline unsigned int s_key        = 0;    // enterCritical() does not nest
+    static inline Tick         s_timerPeriod = 1;   // one service timer (TimeEvent)
+
+    // Lower is more urgent in Zephyr, preemptible range
+    static int nativePriority(Priority p)
+    {
+        return (p < CONFIG_NUM_PREEMPT_PRIORITIES) ? (CONFIG_NUM_PREEMPT_PRIORITIES - 1 - p) : 0;
+    }
+
+    static void entry(void *p1, void *p2, void *p3)
+    {
+        (void)p2;
+        (void)p3;
+        TaskBuffer *b = static_cast<TaskBuffer *>(p1);
+        b->fn(b->arg);
+    }
+};
+
+#elif (AO_PORT == AO_PORT_BARE_METAL)
+// ── Bare metal ──────────────────────────────────────────────────
+// No task: AoKernel::start() runs every AO from main() and sleeps in
+// wfi while none is ready. The tick is SysTick, the application's
+// sys_tick_handler() calls tickFromISR(). The timer callback runs in
+// the superloop before the next dispatch, as in a timer task. The
+// critical sections mask the interrupts (PRIMASK) and nest.
+#include <string.h>
+
+#ifndef AO_BARE_METAL_TICK_HZ
+#define AO_BARE_METAL_TICK_HZ   1000U
+#endif
+
+#define AO_ASSERT(x)            do { if (!(x)) { for (;;) {} } } while (0)
+#define AO_PORT_DYNAMIC         0
+#define AO_PORT_STATIC          1
+#define AO_MS_TO_TICKS(ms)      ((uint32_t)(((uint64_t)(ms) * AO_BARE_METAL_TICK_HZ + 999U) / 1000U))
+#define AO_PORT_STACK_MEMBER(name, words)   uint32_t name[1]
+
+class AoPort {
+public:
+    typedef uint32_t        Tick;
+    typedef uint32_t        Priority;
+    typedef int32_t         Woken;          // nothing to switch to
+    typedef uint32_t        IsrMask;        // PRIMASK
+    struct QueueBuffer {
+        uint8_t            *storage;
+        uint16_t            itemSize;
+        uint8_t             depth;
+        uint8_t             head;
+        volatile uint8_t    count;
+    };
+    typedef QueueBuffer    *Queue;
+    typedef void (*TaskFn)(void *arg);
+    typedef void           *Task;           // always NULL, the superloop
+    typedef uint8_t         TaskBuffer;
+    typedef uint32_t        Stack;
+    struct TimerBuffer;
+    typedef TimerBuffer    *Timer;
+    typedef TimerBuffer    *TimerArg;
+    typedef void (*TimerFn)(TimerArg);
+    struct TimerBuffer {
+        TimerFn             fn;
+        Tick                period;
+        Tick                due;
+        volatile bool       armed;
+    };
+    struct Signals {};                      // AoKernel keeps the signals
+
+    static constexpr Tick     WAIT_FOREVER = UINT32_MAX;
+    static constexpr uint32_t TICK_HZ      = AO_BARE_METAL_TICK_HZ;
+
+    static constexpr uint32_t queueStorageSize(uint32_t depth, uint32_t itemSize)
+    {
+        return depth * itemSize;
+    }
+
+    static void enterCritical()
+    {
+        const IsrMask m = enterCriticalFromISR();
+        if (s_nesting++ == 0) {
+            s_mask = m;
+        }
+    }
+    static void exitCritical()
+    {
+        if (--s_nesting == 0) {
+            exitCriticalFromISR(s_mask);
+        }
+    }
+    static IsrMask enterCriticalFromISR()
+    {
+        IsrMask m;
+        __asm__ volatile ("mrs %0, primask\n\tcpsid i" : "=r"(m) :: "memory");
+        return m;
+    }
+    static void exitCriticalFromISR(IsrMask m)
+    {
+        __asm__ volatile ("msr primask, %0" :: "r"(m) : "memory");
+    }
+    static void yieldFromISR(Woken woken)    { (void)woken; }
+
+    static Tick now()                           { return s_ticks; }
+    // Holds the superloop: the other AOs wait meanwhile
+    static void delay(Tick ticks)
+    {
+        const Tick start = s_ticks;
+        while ((Tick)(s_ticks - start) < ticks) {
+            __asm__ volatile ("wfi");
+        }
+    }
+    static void delayUntil(Tick *last, Tick period)
+    {
+        const Tick left = *last + period - now();
+        *last += period;
+        if ((left != 0) && (left <= period)) {
+            delay(left);
+        }
+    }
+
+    static Queue queueCreateStatic(QueueBuffer *buffer, uint8_t *storage,
+                                   uint32_t depth, uint32_t itemSize, const char *name)
+    {
+        (void)name;
+        buffer->storage  = storage;
+        buffer->itemSize = (uint16_t)itemSize;
+        buffer->depth    = (uint8_t)depth;
+        buffer->head     = 0;
+        buffer->count    = 0;
+        return buffer;
+    }
+    static bool send(Queue q, const void *item)
+    {
+        const IsrMask m = enterCriticalFromISR();
+        const bool room = (q->count < q->depth);
+        if (room) {
+            const uint32_t tail = (q->head + q->count) % q->depth;
+            memcpy(&q->storage[tail * q->itemSize], item, q->itemSize);
+            q->count = (uint8_t)(q->count + 1U);
+        }
+        exitCriticalFromISR(m);
+        return room;
+    }
+    static bool sendFromISR(Queue q, const void *item, Woken *woken)
+    {
+        (void)woken;
+        return send(q, item);
+    }
+    // The slot before the head: received next
+    static bool sendToFront(Queue q, const void *item)
+    {
+        const IsrMask m = enterCriticalFromISR();
+        const bool room = (q->count < q->depth);
+        if (room) {
+            q->head = (uint8_t)((q->head + q->depth - 1U) % q->depth);
+            memcpy(&q->storage[q->head * q->itemSize], item, q->itemSize);
+            q->count = (uint8_t)(q->count + 1U);
+        }
+        exitCriticalFromISR(m);
+        return room;
+    }
+    static bool sendToFrontFromISR(Queue q, const void *item, Woken *woken)
+    {
+        (void)woken;
+        return sendToFront(q, item);
+    }
+    // wait is spent in wfi, the superloop holds meanwhile
+    static bool receive(Queue q, void *item, Tick wait)
+    {
+        const Tick start = s_ticks;
+        for (;;) {
+            const IsrMask m = enterCriticalFromISR();
+            const bool any = (q->count > 0);
+            if (any) {
+                memcpy(item, &q->storage[q->head * q->itemSize], q->itemSize);
+                q->head = (uint8_t)((q->head + 1U) % q->depth);
+                q->count = (uint8_t)(q->count - 1U);
+            } else if ((wait != 0) && ((wait == WAIT_FOREVER) || ((Tick)(s_ticks - start) < wait))) {
+                __asm__ volatile ("wfi");   // a pending irq ends it masked too
+                exitCriticalFromISR(m);
+                continue;
+            }
+            exitCriticalFromISR(m);
+            return any;
+        }
+    }
+    static uint32_t waiting(Queue q)
+    {
+        return q->count;
+    }
+    static uint32_t waitingFromISR(Queue q)
+    {
+        return q->count;
+    }
+
+    static const char *taskState(Task t)
+    {
+        (void)t;
+        return "run";
+    }
+
+    static void signalsInit(Signals *s)         { (void)s; }
+
+    // The callback runs in the superloop (runTimer())
+    static Timer timerCreateStatic(TimerBuffer *buffer, const char *name, Tick period, TimerFn fn)
+    {
+        (void)name;
+        buffer->fn     = fn;
+        buffer->period = period;
+        buffer->armed  = false;
+        s_timer = buffer;
+        return buffer;
+    }
+    static void timerStart(Timer t)
+    {
+        enterCritical();
+        t->due   = s_ticks + t->period;
+        t->armed = true;
+        exitCritical();
+    }
+
+    // ── Superloop side ─────────────────────────────────────────
+    // From sys_tick_handler()
+    static void tickFromISR()                   { s_ticks = s_ticks + 1U; }
+
+    // The timer expired: not armed any more, its callback called
+    static void runTimer()
+    {
+        if (timerDue()) {
+            s_timer->armed = false;
+            s_timer->fn(s_timer);
+        }
+    }
+
+    // Masked (enterCriticalFromISR()), nothing ready: a timer to run
+    static bool timerDue()
+    {
+        const Timer t = s_timer;
+        return (t != NULL) && t->armed && ((int32_t)(s_ticks - t->due) >= 0);
+    }
+
+private:
+    AoPort();
+
+    static inline volatile Tick  s_ticks   = 0;
+    static inline uint32_t       s_nesting = 0;
+    static inline IsrMask        s_mask    = 0;
+    static inline TimerBuffer   *s_timer   = NULL;  // one service timer (TimeEvent)
+};
+
+#else
+#error "AO_PORT: AO_PORT_FREERTOS, AO_PORT_THREADX, AO_PORT_ZEPHYR or AO_PORT_BARE_METAL"
+#endif
+
+#endif /* U_AO_PORT_HPP */
@@ -0,0 +1,67 @@
+#ifndef U_AO_REGISTRY_HPP
+#define U_AO_REGISTRY_HPP
+
+#include <stdint.h>
+#include "AoConfig.hpp"
+#include "AoStats.hpp"
+#include "AoPort.hpp"
+
+#if (AO_REGISTRY == 1)
+// ─────────────────────────────────────────────────────────────────
+// AoRegistry
+//
+// Every ActiveObject, wherever its instance lives (file static,
+// main() static, a member), listed from init() once its queue and
+// task exist: name, priority, queue and its capacity, task, and the
+// AoStats counters. The list is only added to, before the scheduler
+// runs, so the ao shell command walks it without a lock. drain
+// empties the queue from another task, NULL where dropping the
+// items is not safe (a typed AO owns what its slots point to) or
+// there is no queue (signal transport).
+// ─────────────────────────────────────────────────────────────────
+struct AoRegistry {
+    typedef uint32_t (*DrainFn)(void *ao);
+
+    const char        *name;
+    AoPort::Priority   priority;
+    AoPort::Queue      queue;       // NULL: signal transport
+    uint32_t           depth;       // queue capacity
+    AoPort::Task       task;        // NULL: runs in the AoKernel task
+#if (AO_STATS == 1)
+    AoStats           *stats;
+#endif
+    void              *ao;
+    DrainFn            drain;
+    AoRegistry        *next;
+
+    void add(const char *aoName, AoPort::Priority aoPriority,
+             AoPort::Queue aoQueue, uint32_t aoDepth, AoPort::Task aoTask,
+             void *instance, DrainFn drainFn)
+    {
+        name     = aoName;
+        priority = aoPriority;
+        queue    = aoQueue;
+        depth    = aoDepth;
+        task     = aoTask;
+        ao       = instance;
+        drain    = drainFn;
+
+        next    = NULL;
+        *s_last = this;             // in init order
+        s_last  = &next;
+    }
+
+    uint32_t waiting() const
+    {
+        return (queue != NULL) ? AoPort::waiting(queue) : 0;
+    }
+
+    static AoRegistry *first() { return s_first; }
+
+private:
+    static inline AoRegistry  *s_first = NULL;
+    static inline AoRegistry **s_last  = &s_first;
+};
+#endif
+
+#endif /* U_AO_REGISTRY_HPP */
@@ -0,0 +1,100 @@
+#ifndef U_AO_STATS_HPP
+#define U_AO_STATS_HPP
+
+#include <stdint.h>
+#include "AoConfig.hpp"
+
+#if (AO_STATS == 1)
+#if defined(USE_LIBOPENCM3)
+#include <libopencm3/cm3/dwt.h>
+#elif defined(USE_POSIX_SIM)
+#include <time.h>
+#endif
+
+// ─────────────────────────────────────────────────────────────────
+// AoStats
+//
+// Per-AO counters, to size AoConfig::queueDepth from data: posts,
+// posts dropped on a full queue, the deepest the queue got, and the
+// dispatch time in DWT cycles. The producers count with atomics
+// (tasks and ISRs), the rest is written by the AO task only. Every
+// instance is listed from init() for the aostat shell command.
+// ─────────────────────────────────────────────────────────────────
+struct AoStats {
+    const char *name;
+    uint32_t    posts;
+    uint32_t    drops;
+    uint32_t    maxDepth;
+    uint32_t    dispatches;
+    uint32_t    cycMin;
+    uint32_t    cycMax;
+    uint64_t    cycSum;
+    AoStats    *next;
+
+    void add(const char *aoName)
+    {
+        name = aoName;
+        reset();
+        next = s_first;
+        s_first = this;
+#if defined(USE_LIBOPENCM3)
+        dwt_enable_cycle_counter();
+#endif
+    }
+
+    void reset()
+    {
+        posts      = 0;
+        drops      = 0;
+        maxDepth   = 0;
+        dispatches = 0;
+        cycMin     = UINT32_MAX;
+        cycMax     = 0;
+        cycSum     = 0;
+    }
+
+    void onPost(bool queued)
+    {
+        __atomic_fetch_add(queued ? &posts : &drops, 1U, __ATOMIC_RELAXED);
+    }
+
+    // After a receive: what is left, plus the one just taken
+    void onReceive(uint32_t waiting)
+    {
+        if ((waiting + 1U) > maxDepth) {
+            maxDepth = waiting + 1U;
+        }
+    }
+
+    static uint32_t cycles()
+    {
+#if defined(USE_LIBOPENCM3)
+        return DWT_CYCCNT;
+#elif defined(USE_POSIX_SIM)
+        // the POSIX simulation: nanoseconds of the monotonic clock, a 1 GHz core
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#else
+        return 0;
+#endif
+    }
+
+    void onDispatch(uint32_t startCycles)
+    {
+        const uint32_t c = cycles() - startCycles;
+
+        ++dispatches;
+        cycSum += c;
+        if (c < cycMin) cycMin = c;
+        if (c > cycMax) cycMax = c;
+    }
+
+    static AoStats *first() { return s_first; }
+
+private:
+    static inline AoStats *s_first = NULL;
+};
+#endif
+
+#endif /* U_AO_STATS_HPP */
@@ -5,43 +5,43 @@
 #include "AoConfig.hpp"
 #include "ButtonConfig.hpp"
 #include "ButtonRegistry.hpp"
+#include "StateMachine.hpp"
+#include "TimeEvent.hpp"
+#include "input_lat.h"
 
 #if defined(USE_LIBOPENCM3)
 extern "C" {
-    #include <libopencm3/stm32/rcc.h>    // ← rcc_periph_clock_enable, rcc_periph_clken
+    #include <libopencm3/stm32/rcc.h>    // ← rcc_periph_clock_enable, rcc_for_port (GpioPin.hpp)
     #include <libopencm3/stm32/gpio.h>   // ← gpio_set_mode, gpio_set
     #include <libopencm3/stm32/exti.h>   // ← exti_select_source, exti_set_trigger
     #include <libopencm3/cm3/nvic.h>     // ← nvic_enable_irq, nvic_set_priority
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+    #include <libopencm3/cm3/dwt.h>      // ← dwt_enable_cycle_counter, DWT_CYCCNT
+#endif
 }
-
-
-static inline rcc_periph_clken rcc_for_port(uint32_t port) {
-    if (port == GPIOA) return RCC_GPIOA;
-    if (port == GPIOB) return RCC_GPIOB;
-    if (port == GPIOC) return RCC_GPIOC;
-    return RCC_GPIOD;
-}    
 #endif 
 
 class ButtonAO {
 public:
-
-    // ── State machine states ───────────────────────────────────
-    enum State : uint8_t {
-        ST_IDLE,
-        ST_PRESSED1,        // First press, finger down
-        ST_WAIT_SECOND,     // First release, waiting for second press
-        ST_PRESSED2,        // Second press, finger down
-    };
+    typedef StateMachine<ButtonAO> Sm;
 
     // ── Constructor ────────────────────────────────────────────
     ButtonAO(const ButtonConfig &btnCfg,
              const AoConfig     &aoCfg = BUTTON_AO_DEFAULTS)
         : m_cfg(btnCfg)
         , m_aoCfg(aoCfg)
-        , m_state(ST_IDLE)
+        , m_sm(this)
+        , m_down(false)
         , m_pressTimestamp(0)
-        , m_releaseTimestamp(0)
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+        , m_edgeCycles(0)
+        , m_pressCycles(0)
+#endif
+#if defined(INPUT_LAT) && (INPUT_LAT == 1)
+        , m_lat()
+#endif
+        , m_debounceTimeout(SIG_TIMEOUT, TMR_DEBOUNCE)
+        , m_clickTimeout(SIG_TIMEOUT, TMR_CLICK)
     {}
 
     void init()
@@ -64,6 +64,15 @@ public:
         nvic_enable_irq(m_cfg.exti.nvicIrq);
         nvic_set_priority(m_cfg.exti.nvicIrq, m_cfg.exti.nvicPrio);
 
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+        dwt_enable_cycle_counter();
+#endif
+
+        // ── Timeouts post SIG_TIMEOUT back to the AO ───────────────
+        TimeEvent::initService();
+
+        m_sm.start(&ST_IDLE);
+
         // ── Register with ISR dispatcher ───────────────────────────
         ButtonRegistry::registerButton(m_cfg.exti.lineNumber, this);
 
@@ -75,24 +84,68 @@ public:
                   m_aoCfg.queueDepth);
     }
 
-    // Call this from the GPIO EXTI ISR
+    // Call this from the GPIO EXTI ISR, on both edges (EXTI_CFG_BOTH):
+    // press and release each post, the AO sleeps in between. The bounce
+    // edges until the debounce expires merge into the first one: one
+    // post per burst, stamped with the cycle count of that first edge
+    // (and its stages for inputlat with INPUT_LAT)
     void onISR()
     {
-        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        const uint32_t latEdge = INPUT_LAT_STAMP();
+        AoPort::Woken xHigherPriorityTaskWoken = 0;
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+        const Event e = { SIG_RAW_EDGE, DWT_CYCCNT };
+#else
         const Event e = { SIG_RAW_EDGE, 0 };
+#endif
 
-        m_ao.postFromISR(e, &xHigherPriorityTaskWoken);
-        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        if (m_ao.postCoalescedFromISR(e, &xHigherPriorityTaskWoken)) {
+            INPUT_LAT_POSTED(&m_lat, latEdge);
+            AoPort::yieldFromISR(xHigherPriorityTaskWoken);
+        } else {
+            INPUT_LAT_COALESCED();
+        }
     }
 
 private:
+    // ── Timer ids (SIG_TIMEOUT param) ──────────────────────────
+    enum TimerId : uint32_t {
+        TMR_DEBOUNCE,       // the pin settled after an edge
+        TMR_CLICK,          // the double-click window closed
+    };
+
+#if (AO_PORT_STATIC == 1)
+    // Embedded at the default sizes, a custom AoConfig may ask for less
+    StaticActiveObject<BUTTON_AO_DEFAULTS.stackWords, BUTTON_AO_DEFAULTS.queueDepth> m_ao;
+#else
     ActiveObject  m_ao;
+#endif
     ButtonConfig  m_cfg;        // Owns the callback + pin identity
     AoConfig      m_aoCfg;
 
-    State         m_state;
-    TickType_t    m_pressTimestamp;
-    TickType_t    m_releaseTimestamp;
+    Sm            m_sm;
+    bool          m_down;       // debounced level
+    AoPort::Tick  m_pressTimestamp;
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+    uint32_t      m_edgeCycles;     // first edge of the burst being debounced
+    uint32_t      m_pressCycles;    // edge of the press
+#endif
+#if defined(INPUT_LAT) && (INPUT_LAT == 1)
+    input_lat_burst_s m_lat;        // the stages of the burst being debounced (inputlat)
+#endif
+    TimeEvent     m_debounceTimeout;
+    TimeEvent     m_clickTimeout;
+
+    // ── States ─────────────────────────────────────────────────
+    static const Sm::State      ST_IDLE;         // Waiting for any activity
+    static const Sm::State      ST_PRESSED1;     // First press, finger down
+    static const Sm::State      ST_WAIT_SECOND;  // First release, waiting for second press
+    static const Sm::State      ST_PRESSED2;     // Second press, finger down
+
+    static const Sm::Transition IDLE_T[];
+    static const Sm::Transition PRESSED1_T[];
+    static const Sm::Transition WAIT_SECOND_T[];
+    static const Sm::Transition PRESSED2_T[];
 
     // ── Trampoline ─────────────────────────────────────────────
     static void dispatch(void *instance, const Event &e)
@@ -108,104 +161,163 @@ private:
     }
 
     // Fire callback — passes button identity so handler knows which button
-    void notify(Signal sig, uint32_t param = 0) const
+    void notify(Signal sig, uint32_t param = 0)
     {
         if (m_cfg.callback != NULL) {
+            INPUT_LAT_NOTIFY_BEGIN(&m_lat);
             m_cfg.callback(sig, m_cfg.pin, param);
+            INPUT_LAT_NOTIFY_END(&m_lat);
         }
     }
 
-    // ── State machine ──────────────────────────────────────────
-    void handleEvent(const Event &e)
+    AoPort::Tick held() const
     {
-        if (e.signal != SIG_RAW_EDGE) return;
+        return AoPort::now() - m_pressTimestamp;
+    }
 
-        vTaskDelay(m_cfg.debounceTicks);
-        const bool pressed = isPressed();
+    // Hold time reported with RELEASED / LONG_PRESS, e is the release
+    uint32_t holdParam(const Event &e) const
+    {
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+        return (e.param - m_pressCycles) / (rcc_ahb_frequency / 1000000U);
+#else
+        (void)e;
+        return (uint32_t)held();
+#endif
+    }
 
-        switch (m_state)
+    // ── Edges → debounced PRESSED / RELEASED for the state machine
+    void handleEvent(const Event &e)
+    {
+        switch (e.signal)
         {
-            // ── Waiting for any activity ───────────────────────
-            case ST_IDLE:
-            {
-                if (pressed) {
-                    m_pressTimestamp = xTaskGetTickCount();
-                    m_state = ST_PRESSED1;
-                    notify(SIG_BUTTON_PRESSED);
-                }
+            case SIG_RAW_EDGE:
+                INPUT_LAT_DEQUEUED(&m_lat);
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+                m_edgeCycles = e.param;
+#endif
+                m_debounceTimeout.arm(&m_ao, m_cfg.debounceTicks);   // sample once it settles
                 break;
-            }
-
-            // ── Finger down (first press) ──────────────────────
-            case ST_PRESSED1:
-            {
-                if (!pressed)
-                {
-                    const TickType_t held = xTaskGetTickCount() - m_pressTimestamp;
-
-                    notify(SIG_BUTTON_RELEASED, (uint32_t)held);
 
-                    if (held >= m_cfg.longPressTicks)
-                    {
-                        notify(SIG_BUTTON_LONG_PRESS, (uint32_t)held);
-                        m_state = ST_IDLE;
+            case SIG_TIMEOUT:
+                if (e.param == TMR_DEBOUNCE) {
+                    m_ao.clearPending(SIG_RAW_EDGE);    // edges post again
+                    const bool pressed = isPressed();
+                    INPUT_LAT_DEBOUNCED(&m_lat, pressed != m_down);
+                    if (pressed != m_down) {
+                        m_down = pressed;
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+                        const Event ev = { pressed ? SIG_BUTTON_PRESSED : SIG_BUTTON_RELEASED,
+                                           m_edgeCycles };
+#else
+                        const Event ev = { pressed ? SIG_BUTTON_PRESSED : SIG_BUTTON_RELEASED, 0 };
+#endif
+                        m_sm.dispatch(ev);
+                        INPUT_LAT_BURST_END(&m_lat);
                     }
-                    else
-                    {
-                        m_releaseTimestamp = xTaskGetTickCount();
-                        m_state = ST_WAIT_SECOND;
-                        waitForSecondClick();
-                    }
-                }
-                break;
-            }
-
-            // ── Second press detected ──────────────────────────
-            case ST_PRESSED2:
-            {
-                if (!pressed) {
-                    notify(SIG_BUTTON_DOUBLE_CLICK);
-                    m_state = ST_IDLE;
+                } else {
+                    m_sm.dispatch(e);
                 }
                 break;
-            }
 
             default:
                 break;
         }
     }
 
-    // ── Double-click window — blocking poll inside the AO task ─
-    void waitForSecondClick()
+    // ── Guards / actions ───────────────────────────────────────
+    bool isLongPress(const Event &e) const
     {
-        const TickType_t deadline = m_releaseTimestamp + m_cfg.doubleClickTicks;
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+        return (uint64_t)holdParam(e) * AoPort::TICK_HZ >= (uint64_t)m_cfg.longPressTicks * 1000000U;
+#else
+        (void)e;
+        return held() >= m_cfg.longPressTicks;
+#endif
+    }
 
-        for (;;)
-        {
-            const TickType_t now       = xTaskGetTickCount();
-            const TickType_t remaining = (deadline > now) ? (deadline - now) : 0;
-
-            if (remaining == 0)
-            {
-                notify(SIG_BUTTON_SINGLE_CLICK);
-                m_state = ST_IDLE;
-                return;
-            }
-
-            vTaskDelay(pdMS_TO_TICKS(10));
-
-            if (isPressed())
-            {
-                vTaskDelay(m_cfg.debounceTicks);
-
-                if (isPressed()) {
-                    notify(SIG_BUTTON_PRESSED);
-                    m_state = ST_PRESSED2;
-                    return;
-                }
-            }
-        }
+    void onPress(const Event &e)
+    {
+        m_pressTimestamp = AoPort::now();
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+        m_pressCycles = e.param;
+        notify(SIG_BUTTON_PRESSED, e.param);
+#else
+        (void)e;
+        notify(SIG_BUTTON_PRESSED);
+#endif
     }
+
+    void onLongRelease(const Event &e)
+    {
+        const uint32_t t = holdParam(e);
+        notify(SIG_BUTTON_RELEASED, t);
+        notify(SIG_BUTTON_LONG_PRESS, t);
+    }
+
+    void onShortRelease(const Event &e)
+    {
+        notify(SIG_BUTTON_RELEASED, holdParam(e));
+    }
+
+    void onSecondPress(const Event &e)
+    {
+#if (AO_BUTTON_EDGE_TIMESTAMPS == 1)
+        notify(SIG_BUTTON_PRESSED, e.param);
+#else
+        (void)e;
+        notify(SIG_BUTTON_PRESSED);
+#endif
+    }
+
+    void onSingleClick(const Event &)
+    {
+        notify(SIG_BUTTON_SINGLE_CLICK);
+    }
+
+    void onDoubleClick(const Event &)
+    {
+        notify(SIG_BUTTON_DOUBLE_CLICK);
+    }
+
+    void startClickWindow()
+    {
+        m_clickTimeout.arm(&m_ao, m_cfg.doubleClickTicks);
+    }
+
+    void stopClickWindow()
+    {
+        m_clickTimeout.disarm();
+    }
+};
+
+// ── Transition tables ──────────────────────────────────────────
+inline const ButtonAO::Sm::Transition ButtonAO::IDLE_T[] = {
+    { SIG_BUTTON_PRESSED,  NULL,                   &ButtonAO::onPress,        &ST_PRESSED1    },
+    { SIG_NONE,            NULL,                   NULL,                      NULL            }
 };
 
-#endif /* U_BUTTON_AO_HPP */
\ No newline at end of file
+inline const ButtonAO::Sm::Transition ButtonAO::PRESSED1_T[] = {
+    { SIG_BUTTON_RELEASED, &ButtonAO::isLongPress, &ButtonAO::onLongRelease,  &ST_IDLE        },
+    { SIG_BUTTON_RELEASED, NULL,                   &ButtonAO::onShortRelease, &ST_WAIT_SECOND },
+    { SIG_NONE,            NULL,                   NULL,                      NULL            }
+};
+
+inline const ButtonAO::Sm::Transition ButtonAO::WAIT_SECOND_T[] = {
+    { SIG_BUTTON_PRESSED,  NULL,                   &ButtonAO::onSecondPress,  &ST_PRESSED2    },
+    { SIG_TIMEOUT,         NULL,                   &ButtonAO::onSingleClick,  &ST_IDLE        },
+    { SIG_NONE,            NULL,                   NULL,                      NULL            }
+};
+
+inline const ButtonAO::Sm::Transition ButtonAO::PRESSED2_T[] = {
+    { SIG_BUTTON_RELEASED, NULL,                   &ButtonAO::onDoubleClick,  &ST_IDLE        },
+    { SIG_NONE,            NULL,                   NULL,                      NULL            }
+};
+
+//                                                            parent  entry                         exit                         transitions
+inline const ButtonAO::Sm::State ButtonAO::ST_IDLE        = { NULL,   NULL,                         NULL,                        IDLE_T        };
+inline const ButtonAO::Sm::State ButtonAO::ST_PRESSED1    = { NULL,   NULL,                         NULL,                        PRESSED1_T    };
+inline const ButtonAO::Sm::State ButtonAO::ST_WAIT_SECOND = { NULL,   &ButtonAO::startClickWindow,  &ButtonAO::stopClickWindow,  WAIT_SECOND_T };
+inline const ButtonAO::Sm::State ButtonAO::ST_PRESSED2    = { NULL,   NULL,                         NULL,                        PRESSED2_T    };
+
+#endif /* U_BUTTON_AO_HPP */
@@ -0,0 +1,336 @@
+#ifndef U_BUTTON_SCAN_HPP
+#define U_BUTTON_SCAN_HPP
+
+#include <stdint.h>
+#include "AoConfig.hpp"
+#include "AoPort.hpp"
+#include "ButtonScanConfig.hpp"
+
+#if defined(USE_LIBOPENCM3)
+extern "C" {
+    #include <libopencm3/stm32/rcc.h>    // ← rcc_periph_clock_enable
+    #include <libopencm3/stm32/gpio.h>   // ← gpio_set_mode, gpio_set
+}
+#endif
+
+// ─────────────────────────────────────────────────────────────────
+// ButtonScan
+//
+// Scan-mode buttons: one task samples every input (or every key of
+// a row/column matrix) each scanTicks, no EXTI line and no task per
+// button, up to MAX_KEYS. Debouncing is a 2-bit vertical counter,
+// all keys at once in a few 64-bit operations: a key changes state
+// after 4 equal samples in a row. The debounced edges then go
+// through one gesture recogniser, timed by the scan itself (no
+// timers), and come out as SIG_BUTTON_* signals through the callback:
+//   - press / release / long press, as ButtonAO
+//   - clicks counted up to maxClicks: SINGLE, DOUBLE, then
+//     MULTI_CLICK with the count, when the window closes or at once
+//     on the last one
+//   - hold-repeat: REPEAT after repeatDelayTicks, then every
+//     repeatTicks; a press that repeated is no click
+//   - chords: all keys of a chords[] mask down together report
+//     CHORD once; their own click / long press events are cancelled
+//     until they are all released (PRESSED / RELEASED still fire)
+// ─────────────────────────────────────────────────────────────────
+class ButtonScan {
+public:
+    static constexpr uint8_t MAX_KEYS   = 64;
+    static constexpr uint8_t MAX_CHORDS = 32;
+
+    ButtonScan(const ButtonScanConfig &scanCfg,
+               const AoConfig         &aoCfg = BUTTON_SCAN_DEFAULTS)
+        : m_cfg(scanCfg)
+        , m_aoCfg(aoCfg)
+        , m_keys(0)
+        , m_state(0)
+        , m_cnt0(0)
+        , m_cnt1(0)
+        , m_waiting(0)
+        , m_holding(0)
+        , m_chordsOn(0)
+        , m_task(NULL)
+    {}
+
+    // Call once before the scheduler starts
+    void init()
+    {
+        const uint8_t rows = (m_cfg.rows != NULL) ? m_cfg.rowCount : 1;
+
+        m_keys = (uint8_t)(rows * m_cfg.inputCount);
+        AO_ASSERT((m_keys > 0) && (m_keys <= MAX_KEYS));
+        AO_ASSERT(m_cfg.maxClicks >= 1);
+        AO_ASSERT(m_cfg.chordCount <= MAX_CHORDS);
+
+        for (uint8_t k = 0; k < MAX_KEYS; ++k) {
+            m_key[k] = Key();
+        }
+
+        // ── GPIO hardware init ─────────────────────────────────────
+        for (uint8_t i = 0; i < m_cfg.inputCount; ++i) {
+            setupInput(m_cfg.inputs[i]);
+        }
+        if (m_cfg.rows != NULL) {
+            for (uint8_t r = 0; r < m_cfg.rowCount; ++r) {
+                setupRow(m_cfg.rows[r]);
+            }
+        }
+
+#if (AO_PORT_STATIC == 1)
+        // Embedded at the default size, a custom AoConfig may ask for less
+        AO_ASSERT(m_aoCfg.stackWords <= BUTTON_SCAN_DEFAULTS.stackWords);
+        m_task = AoPort::taskCreateStatic(&m_taskBuffer, m_stack, scanLoop, m_aoCfg.name,
+                                          BUTTON_SCAN_DEFAULTS.stackWords, this,
+                                          m_aoCfg.priority);
+#else
+        m_task = AoPort::taskCreate(scanLoop, m_aoCfg.name, m_aoCfg.stackWords,
+                                    this, m_aoCfg.priority);
+#endif
+        AO_ASSERT(m_task != NULL);
+    }
+
+    // Debounced level of a key (scan task view)
+    bool isPressed(uint8_t key) const
+    {
+        return (key < m_keys) && (((m_state >> key) & 1U) != 0);
+    }
+
+private:
+    // ── Per key gesture state ──────────────────────────────────
+    enum Phase : uint8_t {
+        PH_IDLE,            // Waiting for any activity
+        PH_DOWN,            // Finger down, clicks before this press counted
+        PH_UP,              // Released after a click, waiting for the next one
+        PH_CHORD,           // Part of a chord, no gesture until released
+    };
+
+    struct Key {
+        Phase         phase   = PH_IDLE;
+        uint8_t       clicks  = 0;
+        uint16_t      repeats = 0;
+        AoPort::Tick  stamp   = 0;      // press, or release while PH_UP
+        AoPort::Tick  next    = 0;      // next REPEAT, ticks after stamp
+    };
+
+    ButtonScanConfig  m_cfg;
+    AoConfig          m_aoCfg;
+    uint8_t           m_keys;
+    uint64_t          m_state;      // debounced, bit set: pressed
+    uint64_t          m_cnt0;       // vertical counter, low bit per key
+    uint64_t          m_cnt1;       // vertical counter, high bit per key
+    uint64_t          m_waiting;    // keys in PH_UP
+    uint64_t          m_holding;    // keys held from a first press (hold-repeat)
+    uint32_t          m_chordsOn;   // chords reported, until all their keys are up
+    Key               m_key[MAX_KEYS];
+    AoPort::Task      m_task;
+#if (AO_PORT_STATIC == 1)
+    AO_PORT_STACK_MEMBER(m_stack, BUTTON_SCAN_DEFAULTS.stackWords);
+    AoPort::TaskBuffer m_taskBuffer;
+#endif
+
+    static void setupInput(const GpioPin &p)
+    {
+#if defined(USE_LIBOPENCM3)
+        rcc_periph_clock_enable(rcc_for_port(p.port));
+        gpio_set_mode(p.port, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, p.pin);
+        gpio_set(p.port, p.pin);            // internal pull-up
+#else
+        (void)p;                            // configured by the HAL board init
+#endif
+    }
+
+    // Idle high, driven low while its row is read
+    static void setupRow(const GpioPin &p)
+    {
+#if defined(USE_LIBOPENCM3)
+        rcc_periph_clock_enable(rcc_for_port(p.port));
+        gpio_set_mode(p.port, GPIO_MODE_OUTPUT_2_MHZ, GPIO_CNF_OUTPUT_OPENDRAIN, p.pin);
+#endif
+        p.setHigh();
+    }
+
+    bool closed(const GpioPin &p) const
+    {
+        return m_cfg.activeLow ? p.isLow() : p.isHigh();
+    }
+
+    // One raw sample, bit k set: key k closed
+    uint64_t sample() const
+    {
+        uint64_t raw = 0;
+
+        if (m_cfg.rows == NULL) {
+            for (uint8_t i = 0; i < m_cfg.inputCount; ++i) {
+                if (closed(m_cfg.inputs[i])) raw |= 1ULL << i;
+            }
+            return raw;
+        }
+
+        for (uint8_t r = 0; r < m_cfg.rowCount; ++r) {
+            const GpioPin &row = m_cfg.rows[r];
+            const uint8_t  base = (uint8_t)(r * m_cfg.inputCount);
+
+            row.setLow();
+            (void)row.isLow();              // lets the columns settle
+            for (uint8_t c = 0; c < m_cfg.inputCount; ++c) {
+                if (m_cfg.inputs[c].isLow()) raw |= 1ULL << (base + c);
+            }
+            row.setHigh();
+        }
+        return raw;
+    }
+
+    // Vertical counter: a key differing from its debounced state counts
+    // up each sample (reset when equal), and toggles at the 4th
+    uint64_t debounce(uint64_t raw)
+    {
+        const uint64_t delta  = raw ^ m_state;
+
+        m_cnt1 = (m_cnt1 ^ m_cnt0) & delta;
+        m_cnt0 = ~m_cnt0 & delta;
+
+        const uint64_t toggle = delta & ~(m_cnt0 | m_cnt1);
+        m_state ^= toggle;
+        return toggle;
+    }
+
+    void notify(Signal sig, uint8_t key, uint32_t param = 0) const
+    {
+        if (m_cfg.callback != NULL) {
+            m_cfg.callback(sig, key, param);
+        }
+    }
+
+    void reportClicks(uint8_t k, uint8_t clicks) const
+    {
+        if (clicks == 1) {
+            notify(SIG_BUTTON_SINGLE_CLICK, k);
+        } else if (clicks == 2) {
+            notify(SIG_BUTTON_DOUBLE_CLICK, k);
+        } else {
+            notify(SIG_BUTTON_MULTI_CLICK, k, clicks);
+        }
+    }
+
+    void onPress(uint8_t k, AoPort::Tick now)
+    {
+        Key &key = m_key[k];
+        const uint64_t bit = 1ULL << k;
+
+        if (key.phase == PH_IDLE) {
+            key.clicks = 0;
+            if (m_cfg.repeatTicks != 0) {
+                m_holding |= bit;       // hold-repeat from a first press only
+            }
+        }
+        m_waiting  &= ~bit;
+        key.phase   = PH_DOWN;
+        key.repeats = 0;
+        key.stamp   = now;
+        key.next    = m_cfg.repeatDelayTicks;
+        notify(SIG_BUTTON_PRESSED, k);
+    }
+
+    void onRelease(uint8_t k, AoPort::Tick now)
+    {
+        Key &key = m_key[k];
+        const uint64_t     bit = 1ULL << k;
+        const AoPort::Tick t   = now - key.stamp;
+
+        m_holding &= ~bit;
+        notify(SIG_BUTTON_RELEASED, k, (uint32_t)t);
+
+        if (key.phase != PH_DOWN) {     // PH_CHORD
+            key.phase = PH_IDLE;
+            return;
+        }
+        if ((key.clicks == 0) && (key.repeats != 0)) {
+            key.phase = PH_IDLE;        // a hold-repeat, not a click
+            return;
+        }
+        if ((key.clicks == 0) && (t >= m_cfg.longPressTicks)) {
+            notify(SIG_BUTTON_LONG_PRESS, k, (uint32_t)t);
+            key.phase = PH_IDLE;
+            return;
+        }
+
+        ++key.clicks;
+        if (key.clicks >= m_cfg.maxClicks) {
+            key.phase = PH_IDLE;
+            reportClicks(k, key.clicks);
+        } else {
+            key.phase  = PH_UP;
+            key.stamp  = now;
+            m_waiting |= bit;
+        }
+    }
+
+    // Chords complete this scan: report, and take their keys out of
+    // the single-key gestures
+    void checkChords()
+    {
+        for (uint8_t i = 0; i < m_cfg.chordCount; ++i) {
+            const uint64_t mask = m_cfg.chords[i];
+            const uint32_t bit  = 1UL << i;
+            const uint64_t down = m_state & mask;
+
+            if (down == 0) {
+                m_chordsOn &= ~bit;
+            } else if ((down == mask) && ((m_chordsOn & bit) == 0)) {
+                m_chordsOn |= bit;
+                m_waiting  &= ~mask;
+                m_holding  &= ~mask;
+                for (uint64_t m = mask; m != 0; m &= m - 1) {
+                    m_key[__builtin_ctzll(m)].phase = PH_CHORD;
+                }
+                notify(SIG_BUTTON_CHORD, (uint8_t)__builtin_ctzll(mask), i);
+            }
+        }
+    }
+
+    void scanOnce(AoPort::Tick now)
+    {
+        for (uint64_t t = debounce(sample()); t != 0; t &= t - 1) {
+            const uint8_t k = (uint8_t)__builtin_ctzll(t);
+            if (((m_state >> k) & 1U) != 0) {
+                onPress(k, now);
+            } else {
+                onRelease(k, now);
+            }
+        }
+        checkChords();
+
+        // Click windows that closed: the clicks so far
+        for (uint64_t w = m_waiting; w != 0; w &= w - 1) {
+            const uint8_t k = (uint8_t)__builtin_ctzll(w);
+            if ((now - m_key[k].stamp) >= m_cfg.doubleClickTicks) {
+                m_waiting &= ~(1ULL << k);
+                m_key[k].phase = PH_IDLE;
+                reportClicks(k, m_key[k].clicks);
+            }
+        }
+
+        // Keys held long enough to repeat
+        for (uint64_t h = m_holding; h != 0; h &= h - 1) {
+            const uint8_t k = (uint8_t)__builtin_ctzll(h);
+            Key &key = m_key[k];
+            if ((now - key.stamp) >= key.next) {
+                key.next += m_cfg.repeatTicks;
+                notify(SIG_BUTTON_REPEAT, k, ++key.repeats);
+            }
+        }
+    }
+
+    static void scanLoop(void *pvParams)
+    {
+        ButtonScan  *self = static_cast<ButtonScan *>(pvParams);
+        AoPort::Tick last = AoPort::now();
+
+        for (;;) {
+            AoPort::delayUntil(&last, self->m_cfg.scanTicks);
+            self->scanOnce(last);
+        }
+    }
+};
+
+#endif /* U_BUTTON_SCAN_HPP */
@@ -0,0 +1,65 @@
+#ifndef U_EVENT_BUS_HPP
+#define U_EVENT_BUS_HPP
+
+#include <stdint.h>
+#include "ActiveObject.hpp"
+
+// Bit n set: the AO attached to slot n receives the signal
+typedef uint32_t SubscriberMask;
+
+#define EVENT_BUS_MAX_SLOTS     32U
+#define EVENT_BUS_SLOT(n)       ((SubscriberMask)1U << (n))
+
+// ─────────────────────────────────────────────────────────────────
+// EventBus
+//
+// Publish/subscribe between AOs. The table has one SubscriberMask
+// per Signal, fixed at compile time; AOs attach() to their slot at
+// init. publish() posts the event to every subscriber of its signal
+// and to nobody else, so a producer does not know its consumers.
+// An Event is 8 bytes, each subscriber queue gets its own copy.
+// ─────────────────────────────────────────────────────────────────
+class EventBus {
+public:
+    explicit EventBus(const SubscriberMask (&table)[SIG_COUNT])
+        : m_table(table)
+        , m_slots()
+    {}
+
+    void attach(uint8_t slot, ActiveObject *ao)
+    {
+        AO_ASSERT(slot < EVENT_BUS_MAX_SLOTS);
+        m_slots[slot] = ao;
+    }
+
+    void publish(const Event &e)
+    {
+        for (SubscriberMask m = subscribers(e); m != 0; m &= m - 1) {
+            ActiveObject *ao = m_slots[__builtin_ctz(m)];
+            if (ao != NULL) {
+                ao->post(e);
+            }
+        }
+    }
+
+    void publishFromISR(const Event &e, AoPort::Woken *pxHigherPriorityTaskWoken)
+    {
+        for (SubscriberMask m = subscribers(e); m != 0; m &= m - 1) {
+            ActiveObject *ao = m_slots[__builtin_ctz(m)];
+            if (ao != NULL) {
+                ao->postFromISR(e, pxHigherPriorityTaskWoken);
+            }
+        }
+    }
+
+private:
+    const SubscriberMask *m_table;
+    ActiveObject         *m_slots[EVENT_BUS_MAX_SLOTS];
+
+    SubscriberMask subscribers(const Event &e) const
+    {
+        return (e.signal < SIG_COUNT) ? m_table[e.signal] : 0;
+    }
+};
+
+#endif /* U_EVENT_BUS_HPP */
@@ -0,0 +1,103 @@
+#ifndef U_EVENT_POOL_HPP
+#define U_EVENT_POOL_HPP
+
+#include <stdint.h>
+#include "AoPort.hpp"
+
+// ─────────────────────────────────────────────────────────────────
+// EventPool
+//
+// Fixed blocks of T with a reference count each, so a queue carries
+// a T* (4 bytes) instead of a copy of the payload. alloc() hands out
+// a block held once; ref() adds a holder before the same block is
+// posted to one more queue, and the last release() puts it back.
+// An empty pool returns NULL: the event is dropped, as on a full
+// queue. The FromISR variants are for interrupt context.
+// ─────────────────────────────────────────────────────────────────
+template <typename T, uint8_t N>
+class EventPool {
+public:
+    EventPool()
+        : m_free(0)
+    {
+        for (uint8_t i = 0; i < N; ++i) {
+            m_blocks[i].refs = 0;
+            m_blocks[i].next = i + 1;
+        }
+    }
+
+    T *alloc()
+    {
+        AoPort::enterCritical();
+        T *p = take();
+        AoPort::exitCritical();
+        return p;
+    }
+
+    T *allocFromISR()
+    {
+        const AoPort::IsrMask mask = AoPort::enterCriticalFromISR();
+        T *p = take();
+        AoPort::exitCriticalFromISR(mask);
+        return p;
+    }
+
+    void ref(T *p)
+    {
+        AoPort::enterCritical();
+        ++block(p)->refs;
+        AoPort::exitCritical();
+    }
+
+    void release(T *p)
+    {
+        AoPort::enterCritical();
+        give(p);
+        AoPort::exitCritical();
+    }
+
+    void releaseFromISR(T *p)
+    {
+        const AoPort::IsrMask mask = AoPort::enterCriticalFromISR();
+        give(p);
+        AoPort::exitCriticalFromISR(mask);
+    }
+
+private:
+    struct Block {
+        T        payload;   // first, a T* is the address of its block
+        uint8_t  refs;
+        uint8_t  next;      // free list link, N ends it
+    };
+
+    Block    m_blocks[N];
+    uint8_t  m_free;
+
+    static Block *block(T *p)
+    {
+        return reinterpret_cast<Block *>(p);
+    }
+
+    T *take()
+    {
+        if (m_free >= N) {
+            return NULL;
+        }
+        Block *b = &m_blocks[m_free];
+        m_free  = b->next;
+        b->refs = 1;
+        return &b->payload;
+    }
+
+    void give(T *p)
+    {
+        Block *b = block(p);
+        AO_ASSERT(b->refs > 0);
+        if (--b->refs == 0) {
+            b->next = m_free;
+            m_free  = static_cast<uint8_t>(b - m_blocks);
+        }
+    }
+};
+
+#endif /* U_EVENT_POOL_HPP */
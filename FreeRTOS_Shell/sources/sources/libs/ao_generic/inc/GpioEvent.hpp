@@ -13,10 +13,26 @@ enum Signal : uint8_t {
     SIG_BUTTON_SINGLE_CLICK,    // Confirmed single click (delayed by window)
     SIG_BUTTON_DOUBLE_CLICK,    // Two clicks within window
     SIG_BUTTON_LONG_PRESS,      // Held >= longPressTicks
+    SIG_BUTTON_MULTI_CLICK,     // 3+ clicks within windows, param = count (ButtonScan)
+    SIG_BUTTON_REPEAT,          // Still held, every repeatTicks, param = count (ButtonScan)
+    SIG_BUTTON_CHORD,           // All keys of a chord down, param = chord index (ButtonScan)
 
     SIG_LED_ON,
     SIG_LED_OFF,
     SIG_LED_TOGGLE,
+    SIG_LED_PATTERN,            // LedAO::setPattern() (posted to the LedAO itself)
+
+    SIG_TIMEOUT,                // AO timer expired, param = which timer
+
+    SIG_BENCH_PING,             // bench AO (bench command), param = CYCCNT of the post
+
+    SIG_UART_RX,                // ShellAO: input in the UART ring or from feed()
+
+    SIG_ADC_HALF,               // AdcAO: a DMA half complete, param = which (adc_acq hook)
+    SIG_ADC_START,              // AdcAO::start(), param = rate in Hz, UINT32_MAX stops
+    SIG_ADC_FRAME,              // AdcAO subscribers: param = the AdcFrame *, to release()
+
+    SIG_COUNT                   // Keep last — sizes the subscriber table
 };
 
 struct Event {
@@ -28,6 +44,7 @@ struct Event {
 // sig       — what happened (PRESSED, RELEASED, SINGLE_CLICK, ...)
 // buttonPin — which button fired (port + pin = unique identity)
 // param     — hold duration in ticks for LONG_PRESS/RELEASED, 0 otherwise
+//             (AO_BUTTON_EDGE_TIMESTAMPS: in µs, and the edge CYCCNT for PRESSED)
 typedef void (*ButtonCallbackFn)(Signal         sig,
                                  const GpioPin &buttonPin,
                                  uint32_t       param);
@@ -3,8 +3,16 @@
 
 #if defined(USE_LIBOPENCM3)             // ← consistent use of defined()
 #include <libopencm3/stm32/gpio.h>
+#include <libopencm3/stm32/rcc.h>
 #include <stdint.h>
 
+static inline rcc_periph_clken rcc_for_port(uint32_t port) {
+    if (port == GPIOA) return RCC_GPIOA;
+    if (port == GPIOB) return RCC_GPIOB;
+    if (port == GPIOC) return RCC_GPIOC;
+    return RCC_GPIOD;
+}
+
 struct GpioPin {
     uint32_t port;
     uint16_t pin;
@@ -16,6 +24,42 @@ struct GpioPin {
     bool isHigh()  const { return gpio_get(port, pin) != 0;  }
 };
 
+// Several pins of one port in one BSRR store: the pins set and the pins cleared change in the
+// same bus cycle (LED banks, parallel buses), an ISR on the same port cannot interleave
+struct GpioPort {
+    uint32_t port;
+
+    void write(uint16_t mask, uint16_t value) const {
+        GPIO_BSRR(port) = (uint32_t)(mask & value) | ((uint32_t)(mask & (uint16_t)~value) << 16);
+    }
+    void set(uint16_t mask)    const { GPIO_BSRR(port) = mask;                     }
+    void clear(uint16_t mask)  const { GPIO_BSRR(port) = (uint32_t)mask << 16;     }
+    void toggle(uint16_t mask) const { write(mask, (uint16_t)~GPIO_ODR(port));     }
+    uint16_t read()            const { return (uint16_t)GPIO_IDR(port);            }
+};
+
+// width contiguous pins from shift, the value written or read right aligned
+struct GpioBus {
+    GpioPort port;
+    uint8_t  shift;
+    uint8_t  width;
+
+    uint16_t mask()               const { return (uint16_t)(((1U << width) - 1U) << shift); }
+    void     write(uint16_t value) const { port.write(mask(), (uint16_t)(value << shift));  }
+    uint16_t read()               const { return (uint16_t)((port.read() & mask()) >> shift); }
+};
+
+// pin known at compile time: each call inlines to one store (one load for the reads)
+template <uint32_t Port, uint16_t Pin>
+struct GpioPinT {
+    static void setHigh() { GPIO_BSRR(Port) = Pin;                        }
+    static void setLow()  { GPIO_BSRR(Port) = (uint32_t)Pin << 16;        }
+    static void toggle()  { GpioPort{Port}.toggle(Pin);                   }
+    static bool isLow()   { return (GPIO_IDR(Port) & Pin) == 0;           }
+    static bool isHigh()  { return (GPIO_IDR(Port) & Pin) != 0;           }
+    static constexpr GpioPin pin() { return GpioPin{Port, Pin};           }
+};
+
 #elif defined(USE_STM32HAL)             // ← consistent use of defined()
 
 #if defined(STM32F4)
@@ -37,8 +81,114 @@ struct GpioPin {
     bool isHigh()  const { return HAL_GPIO_ReadPin(port, pin) == GPIO_PIN_SET;   }
 };
 
+// Several pins of one port in one BSRR store (see the libopencm3 variant)
+struct GpioPort {
+    GPIO_TypeDef *port;
+
+    void write(uint16_t mask, uint16_t value) const {
+        port->BSRR = (uint32_t)(mask & value) | ((uint32_t)(mask & (uint16_t)~value) << 16);
+    }
+    void set(uint16_t mask)    const { port->BSRR = mask;                          }
+    void clear(uint16_t mask)  const { port->BSRR = (uint32_t)mask << 16;          }
+    void toggle(uint16_t mask) const { write(mask, (uint16_t)~port->ODR);          }
+    uint16_t read()            const { return (uint16_t)port->IDR;                 }
+};
+
+struct GpioBus {
+    GpioPort port;
+    uint8_t  shift;
+    uint8_t  width;
+
+    uint16_t mask()               const { return (uint16_t)(((1U << width) - 1U) << shift); }
+    void     write(uint16_t value) const { port.write(mask(), (uint16_t)(value << shift));  }
+    uint16_t read()               const { return (uint16_t)((port.read() & mask()) >> shift); }
+};
+
+// the port as its base address (GPIOA_BASE ...): a pointer is not a template argument
+template <uintptr_t PortBase, uint16_t Pin>
+struct GpioPinT {
+    static GPIO_TypeDef *port() { return reinterpret_cast<GPIO_TypeDef *>(PortBase); }
+
+    static void setHigh() { port()->BSRR = Pin;                           }
+    static void setLow()  { port()->BSRR = (uint32_t)Pin << 16;           }
+    static void toggle()  { GpioPort{port()}.toggle(Pin);                 }
+    static bool isLow()   { return (port()->IDR & Pin) == 0;              }
+    static bool isHigh()  { return (port()->IDR & Pin) != 0;              }
+    static GpioPin pin()  { return GpioPin{port(), Pin};                  }
+};
+
+#elif defined(USE_POSIX_SIM)             // POSIX simulation (sources/sim_posix)
+
+#include <stdint.h>
+
+// The ports of the simulation in memory (sim_gpio.cpp): a write changes the output register
+// and reports the pins which changed (the LED on the console of the simulation), a read
+// gives the output register back. Same names as libopencm3, GpioConfig.hpp is shared
+enum : uint32_t { GPIOA = 0, GPIOB, GPIOC, GPIOD, GPIO_SIM_PORTS };
+
+#define GPIO0   (1U << 0)
+#define GPIO1   (1U << 1)
+#define GPIO2   (1U << 2)
+#define GPIO3   (1U << 3)
+#define GPIO4   (1U << 4)
+#define GPIO5   (1U << 5)
+#define GPIO6   (1U << 6)
+#define GPIO7   (1U << 7)
+#define GPIO8   (1U << 8)
+#define GPIO9   (1U << 9)
+#define GPIO10  (1U << 10)
+#define GPIO11  (1U << 11)
+#define GPIO12  (1U << 12)
+#define GPIO13  (1U << 13)
+#define GPIO14  (1U << 14)
+#define GPIO15  (1U << 15)
+
+extern "C" void     gpio_sim_write(uint32_t port, uint16_t mask, uint16_t value);
+extern "C" uint16_t gpio_sim_read(uint32_t port);
+
+struct GpioPin {
+    uint32_t port;
+    uint16_t pin;
+
+    void setHigh() const { gpio_sim_write(port, pin, pin);                          }
+    void setLow()  const { gpio_sim_write(port, pin, 0);                            }
+    void toggle()  const { gpio_sim_write(port, pin, (uint16_t)~gpio_sim_read(port)); }
+    bool isLow()   const { return (gpio_sim_read(port) & pin) == 0;                 }
+    bool isHigh()  const { return (gpio_sim_read(port) & pin) != 0;                 }
+};
+
+struct GpioPort {
+    uint32_t port;
+
+    void write(uint16_t mask, uint16_t value) const { gpio_sim_write(port, mask, value);     }
+    void set(uint16_t mask)    const { gpio_sim_write(port, mask, mask);                     }
+    void clear(uint16_t mask)  const { gpio_sim_write(port, mask, 0);                        }
+    void toggle(uint16_t mask) const { write(mask, (uint16_t)~gpio_sim_read(port));          }
+    uint16_t read()            const { return gpio_sim_read(port);                           }
+};
+
+struct GpioBus {
+    GpioPort port;
+    uint8_t  shift;
+    uint8_t  width;
+
+    uint16_t mask()               const { return (uint16_t)(((1U << width) - 1U) << shift); }
+    void     write(uint16_t value) const { port.write(mask(), (uint16_t)(value << shift));  }
+    uint16_t read()               const { return (uint16_t)((port.read() & mask()) >> shift); }
+};
+
+template <uint32_t Port, uint16_t Pin>
+struct GpioPinT {
+    static void setHigh() { gpio_sim_write(Port, Pin, Pin);               }
+    static void setLow()  { gpio_sim_write(Port, Pin, 0);                 }
+    static void toggle()  { GpioPort{Port}.toggle(Pin);                   }
+    static bool isLow()   { return (gpio_sim_read(Port) & Pin) == 0;      }
+    static bool isHigh()  { return (gpio_sim_read(Port) & Pin) != 0;      }
+    static constexpr GpioPin pin() { return GpioPin{Port, Pin};           }
+};
+
 #else
-    #error "GpioPin: define either USE_LIBOPENCM3 or USE_STM32HAL"
+    #error "GpioPin: define USE_LIBOPENCM3, USE_STM32HAL or USE_POSIX_SIM"
 #endif
 
 #endif /* U_GPIO_PIN_HPP */
\ No newline at end of file
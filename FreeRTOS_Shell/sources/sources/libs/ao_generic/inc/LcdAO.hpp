@@ -4,54 +4,184 @@
 #include "LcdConfig.hpp"
 #include "LcdMessage.hpp"
 #include "AoConfig.hpp"
+#include "EventPool.hpp"
+#include "ActiveObject.hpp"
 #include "hd44780_pcf8574.h"
-#include "FreeRTOS.h"
-#include "task.h"
-#include "queue.h"
+#include "AoPort.hpp"
+#include "boot_time.h"
+#include "watchdog.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// Frame buffer size, the largest HD44780 (20x4); LcdConfig is clipped.
+// A frame holds the DDRAM (80 cells): the 40 columns of a row of one
+// or two lines, the visible ones of four
+#define LCD_FB_ROWS  4
+#define LCD_FB_COLS  20
+#define LCD_FB_CELLS 80
+
+// A display which did not answer is tried again at a message this long
+// after the last attempt
+#define LCD_RETRY_MS 2000
+
+#define LCD_WARM_MAGIC 0x4C434457UL     // "LCDW", lcd_warm_record()
 
 // ── Default AO config for LCD ──────────────────────────────────
 // Defined here so AoConfig.hpp stays generic (no LCD dependency)
-static const AoConfig LCD_AO_DEFAULTS = { "LcdAO", 3, 512, 8 };
+static constexpr AoConfig LCD_AO_DEFAULTS = { "LcdAO", 3, 512, 8 };
 
 // ─────────────────────────────────────────────────────────────────
 // LcdAO
 //
-// Does NOT use the generic ActiveObject base — its queue carries
-// LcdMessage (row + col + text), not the generic Event type.
-// The structural pattern (composed queue + task + trampoline) is
-// identical to ActiveObject, just typed differently.
+// A typed ActiveObject: its queue carries LcdMessage pointers, not
+// the generic Event, and shares the event loop of every other AO.
+// The messages live in a pool: a print is filled in place and
+// queued for 4 bytes. The display is brought up at the first
+// message, the splash queued by init(), in the background of the
+// boot: the shell prompt does not wait for it. A display which does
+// not answer never blocks the loop (the other AOs share it with the
+// cooperative kernel): the messages still go to the frame buffer and
+// the bring-up is tried again at a message LCD_RETRY_MS later, which
+// draws the whole frame.
+//
+// A message only writes the frame buffer (clipped to the row, up to
+// column 39 on one or two lines); the
+// refresh after it compares the frame with what the display shows
+// and sends the changed runs, one cursor move each (runs one char
+// apart are merged, the move costs as much as the char). Re-posting
+// the same text costs no I2C traffic. An I2C error re-initialises
+// the display at the next message and redraws the whole frame.
+//
+// Latest value wins: a post for the row/col of a message still in
+// the queue is written over that message (as if both were shown in
+// turn) instead of taking a queue slot, so a fast producer of one
+// spot never fills the queue with stale text.
+//
+// Formatting: printf() formats into a pool message, in place, and
+// num() / bar() post a field (LcdMessage.hpp), a value the LcdAO
+// renders straight into the frame buffer when it shows it: one format
+// pass per update and no text buffer of the caller. A field merges
+// with a queued one of its spot, kind and width only.
+//
+// Bars: bar() and spark() show glyph ids (LcdMessage.hpp), a changed
+// level redraws the one or two cells it moved. The glyphs go to the 8
+// CGRAM slots of the display as they are shown, the least recently
+// used one is written over; the cells it showed are redrawn next, so
+// more than 8 different glyphs on a display at once cannot all show.
+//
+// Displays: LcdAO<N> drives N backpacks on the one I2C bus, each with
+// its own frame buffers, retry and glyph slots, all from the one task
+// (LcdAO lcd(LCD_0) is one, LcdAO panel(LCD_PANEL) an array of them).
+// The calls above are for display 0, display(n) gives them for n.
+// Only a display which had a message is compared; the refresh sends
+// one changed run of each in turn, so the redraw of a whole display
+// does not hold back the update of another.
+//
+// Marquee: on one or two lines a row has 40 columns, past the visible
+// ones; scroll(steps) moves the window of the display over them, one
+// instruction byte per step and no cell rewritten. It moves every row
+// of the display (the controller shifts them together) and wraps at
+// 40; scrolls still queued add up. A four line display ignores it.
+//
+// Warm start: the frames of display 0 are kept in .noinit after each
+// message (lcd_warm_record()). After a reset which left the supply up
+// (watchdog_warm_reset()) and a record of the same display, init()
+// takes them back instead of queueing the splash, and the bring-up is
+// a resync() of the controller, no power up wait and no clear: the
+// display keeps showing its text through the reset, and the first
+// refresh only sends what differs from it (the glyphs, their slots
+// lost with the driver state). A resync which fails falls back to the
+// full init at the next retry.
 // ─────────────────────────────────────────────────────────────────
+template <uint8_t N = 1>
 class LcdAO {
+    static_assert((N >= 1) && (N <= 8), "1 to 8 displays on the bus");
+    static_assert((LCD_FB_CELLS >= 2 * LCD_DDRAM_LINE) && (LCD_FB_CELLS >= LCD_FB_ROWS * LCD_FB_COLS), "a frame is the DDRAM");
+    static_assert(LCD_FB_CELLS == LCD_WARM_CELLS, "a frame is a warm record frame");
+
 public:
 
     LcdAO(const LcdConfig &lcdCfg,
           const AoConfig  &aoCfg = LCD_AO_DEFAULTS)
-        : m_lcdCfg(lcdCfg)
-        , m_aoCfg(aoCfg)
-        , m_queue(NULL)
-        , m_task(NULL)
-        , m_lcd(lcdCfg.i2cAddress, lcdCfg.cols, lcdCfg.rows)
-    {}
-
-    // Call once before vTaskStartScheduler()
+        : m_aoCfg(aoCfg)
+        , m_queued{}
+    {
+        static_assert(N == 1, "one LcdConfig per display");
+        setup(m_screens[0], lcdCfg);
+    }
+
+    LcdAO(const LcdConfig (&lcdCfgs)[N],
+          const AoConfig  &aoCfg = LCD_AO_DEFAULTS)
+        : m_aoCfg(aoCfg)
+        , m_queued{}
+    {
+        for (uint8_t d = 0; d < N; ++d) {
+            setup(m_screens[d], lcdCfgs[d]);
+        }
+    }
+
+    // Call once before the scheduler starts
     void init()
     {
-        m_queue = xQueueCreate(m_aoCfg.queueDepth, sizeof(LcdMessage));
-        configASSERT(m_queue != NULL);
+        m_ao.init(m_aoCfg.name,
+                  &LcdAO::dispatch,
+                  this,
+                  m_aoCfg.priority,
+                  m_aoCfg.stackWords,
+                  m_aoCfg.queueDepth);
+
+        if (!warmStart()) {
+            print(0, 0, "System Ready");
+            print(0, 1, "STM32F103");
+        }
+    }
+
+    // Zero-copy: a pool message to fill in place, NULL if none is free
+    LcdMessage *alloc()
+    {
+        return m_pool.alloc();
+    }
+    // Takes over a message from alloc() — non-blocking (merged into a
+    // queued one for the same spot, dropped if the queue is full)
+    void post(LcdMessage *msg)
+    {
+        AoPort::enterCritical();
+        const bool merged = mergeOrTrack(msg);
+        AoPort::exitCritical();
 
-        xTaskCreate(eventLoop,
-                    m_aoCfg.name,
-                    m_aoCfg.stackWords,
-                    this,
-                    m_aoCfg.priority,
-                    &m_task);
-        configASSERT(m_task != NULL);
+        if (merged) {
+            m_pool.release(msg);
+        } else if (!m_ao.post(msg)) {
+            AoPort::enterCritical();
+            untrack(msg);
+            AoPort::exitCritical();
+            m_pool.release(msg);
+        }
     }
 
-    // Post from any task — non-blocking (drops if queue full)
+    // Post a copy from any task — non-blocking (drops if queue or pool full)
     void post(const LcdMessage &msg)
     {
-        xQueueSend(m_queue, &msg, 0);
+        AoPort::enterCritical();
+        LcdMessage *q = findQueued(msg);
+        if (q != NULL) {
+            overlay(*q, msg);
+        }
+        AoPort::exitCritical();
+        if (q != NULL) {
+            return;
+        }
+
+        LcdMessage *p = m_pool.alloc();
+        if (p != NULL) {
+            *p = msg;
+            post(p);
+        } else {
+            m_ao.dropped();
+        }
     }
 
     // Convenience: build and post in one call
@@ -60,48 +190,590 @@ public:
         post(LcdMessage::make(row, col, text));
     }
 
+    // Formatted into a pool message (vsnprintf, the uart_access one on
+    // the target), cut at LCD_MSG_LEN - 1; dropped if the pool is empty
+    __attribute__((format(printf, 4, 5)))
+    void printf(uint8_t row, uint8_t col, const char *fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        vprintfTo(0, row, col, fmt, args);
+        va_end(args);
+    }
+
+    // Number field, value / 10^decimals right aligned in width cells
+    void num(uint8_t row, uint8_t col, uint8_t width, int32_t value, uint8_t decimals = 0)
+    {
+        post(LcdMessage::num(row, col, width, value, decimals));
+    }
+
+    // Horizontal bar, value of max over width cells (LcdMessage::bar)
+    void bar(uint8_t row, uint8_t col, uint8_t width, uint32_t value, uint32_t max)
+    {
+        post(LcdMessage::bar(row, col, width, value, max));
+    }
+
+    // Sparkline of n samples, each of max (LcdMessage::spark)
+    void spark(uint8_t row, uint8_t col, const uint8_t *samples, uint8_t n, uint8_t max)
+    {
+        post(LcdMessage::spark(row, col, samples, n, max));
+    }
+
+    // Display window moved by steps columns, > 0 the text goes left
+    void scroll(int16_t steps)
+    {
+        post(LcdMessage::scroll(steps));
+    }
+
+    // The same calls for display n (clipped to the last one)
+    class Display {
+    public:
+        void print(uint8_t row, uint8_t col, const char *text)
+        {
+            to(LcdMessage::make(row, col, text));
+        }
+
+        __attribute__((format(printf, 4, 5)))
+        void printf(uint8_t row, uint8_t col, const char *fmt, ...)
+        {
+            va_list args;
+            va_start(args, fmt);
+            m_owner.vprintfTo(m_index, row, col, fmt, args);
+            va_end(args);
+        }
+
+        void num(uint8_t row, uint8_t col, uint8_t width, int32_t value, uint8_t decimals = 0)
+        {
+            to(LcdMessage::num(row, col, width, value, decimals));
+        }
+
+        void bar(uint8_t row, uint8_t col, uint8_t width, uint32_t value, uint32_t max)
+        {
+            to(LcdMessage::bar(row, col, width, value, max));
+        }
+
+        void spark(uint8_t row, uint8_t col, const uint8_t *samples, uint8_t n, uint8_t max)
+        {
+            to(LcdMessage::spark(row, col, samples, n, max));
+        }
+
+        void scroll(int16_t steps)
+        {
+            to(LcdMessage::scroll(steps));
+        }
+
+    private:
+        friend class LcdAO;
+        Display(LcdAO &owner, uint8_t index) : m_owner(owner), m_index(index) {}
+
+        void to(LcdMessage msg)
+        {
+            msg.display = m_index;
+            m_owner.post(msg);
+        }
+
+        LcdAO  &m_owner;
+        uint8_t m_index;
+    };
+
+    Display display(uint8_t n)
+    {
+        return Display(*this, (n < N) ? n : (uint8_t)(N - 1));
+    }
+
     // Post from ISR
     void postFromISR(const LcdMessage &msg,
-                     BaseType_t       *pxHigherPriorityTaskWoken)
+                     AoPort::Woken    *pxHigherPriorityTaskWoken)
     {
-        xQueueSendFromISR(m_queue, &msg, pxHigherPriorityTaskWoken);
+        AoPort::IsrMask mask = AoPort::enterCriticalFromISR();
+        LcdMessage *q = findQueued(msg);
+        if (q != NULL) {
+            overlay(*q, msg);
+        }
+        AoPort::exitCriticalFromISR(mask);
+        if (q != NULL) {
+            return;
+        }
+
+        LcdMessage *p = m_pool.allocFromISR();
+        if (p == NULL) {
+            m_ao.dropped();
+            return;
+        }
+        *p = msg;
+
+        mask = AoPort::enterCriticalFromISR();
+        const bool merged = mergeOrTrack(p);
+        AoPort::exitCriticalFromISR(mask);
+
+        if (merged) {
+            m_pool.releaseFromISR(p);
+        } else if (!m_ao.postFromISR(p, pxHigherPriorityTaskWoken)) {
+            mask = AoPort::enterCriticalFromISR();
+            untrack(p);
+            AoPort::exitCriticalFromISR(mask);
+            m_pool.releaseFromISR(p);
+        }
     }
 
 private:
-    LcdConfig        m_lcdCfg;
+    // One display: its driver and the frame it should show
+    struct Screen {
+        HD44780_PCF8574 lcd;
+        uint8_t      rows;
+        uint8_t      line;          // columns of a row in the frame
+        uint8_t      shift;         // window over the DDRAM line, scroll()
+        bool         ready;         // display initialised
+        bool         warm;          // frames taken back, a resync() brings it up
+        bool         tried;         // lastTry is set
+        bool         dirty;         // frame may differ from shown
+        bool         stale;         // a glyph load staled cells of shown
+        uint8_t      pass;          // of the refresh over the frame
+        uint8_t      nextRow;       // where the refresh goes on
+        uint8_t      nextCol;
+        AoPort::Tick lastTry;       // last bring-up attempt
+        char         frame[LCD_FB_CELLS];   // wanted, rows of line cells
+        char         shown[LCD_FB_CELLS];   // on the display
+    };
+
+#if (AO_PORT_STATIC == 1)
+    // Embedded at the default sizes, a custom AoConfig may ask for less
+    StaticActiveObject<LCD_AO_DEFAULTS.stackWords, LCD_AO_DEFAULTS.queueDepth,
+                       LcdMessage *> m_ao;
+#else
+    BasicActiveObject<LcdMessage *> m_ao;
+#endif
     AoConfig         m_aoCfg;
-    QueueHandle_t    m_queue;
-    TaskHandle_t     m_task;
-    HD44780_PCF8574  m_lcd;
+    Screen           m_screens[N];
+    // one more than the queue holds: the message being printed
+    EventPool<LcdMessage, LCD_AO_DEFAULTS.queueDepth + 1> m_pool;
+    // the messages in the queue, under the critical section
+    LcdMessage      *m_queued[LCD_AO_DEFAULTS.queueDepth];
 
-    // ── Private task — owns all LCD hardware access ────────────
-    static void eventLoop(void *pvParams)
+    static void setup(Screen &s, const LcdConfig &cfg)
     {
-        LcdAO *self = static_cast<LcdAO *>(pvParams);
-        self->run();
+        s.lcd     = HD44780_PCF8574(cfg.i2cAddress, cfg.cols, cfg.rows, cfg.busyFlag);
+        s.rows    = cfg.rows < LCD_FB_ROWS ? cfg.rows : LCD_FB_ROWS;
+        s.line    = (s.rows <= 2) ? LCD_DDRAM_LINE : (cfg.cols < LCD_FB_COLS ? cfg.cols : LCD_FB_COLS);
+        s.shift   = 0;
+        s.ready   = false;
+        s.warm    = false;
+        s.tried   = false;
+        s.dirty   = false;
+        s.stale   = false;
+        s.pass    = 0;
+        s.nextRow = 0;
+        s.nextCol = 0;
+        s.lastTry = 0;
+        fill(s.frame, ' ');
+        fill(s.shown, ' ');
     }
 
-    void run()
+    void vprintfTo(uint8_t display, uint8_t row, uint8_t col, const char *fmt, va_list args)
     {
-        // ── Hardware init with retry ───────────────────────────
-        while (!m_lcd.init()) {
-            vTaskDelay(pdMS_TO_TICKS(2000));
+        LcdMessage *msg = m_pool.alloc();
+        if (msg == NULL) {
+            m_ao.dropped();
+            return;
         }
+        msg->row     = row;
+        msg->col     = col;
+        msg->display = display;
+        msg->kind    = LCD_KIND_TEXT;
+        msg->width   = 0;
+        vsnprintf(msg->text, sizeof(msg->text), fmt, args);
+        post(msg);
+    }
 
-        m_lcd.clear();
-        m_lcd.setCursor(0, 0);
-        m_lcd.print("System Ready");
-        m_lcd.setCursor(0, 1);
-        m_lcd.print("STM32F103");
+    // ── Trampoline — the AO task owns all LCD hardware access ──
+    static void dispatch(void *instance, LcdMessage * const &msg)
+    {
+        static_cast<LcdAO *>(instance)->show(msg);
+    }
 
-        // ── Event loop ─────────────────────────────────────────
-        LcdMessage msg;
+    // ── Queued message table (callers hold the critical section) ──
+    // The one msg is written over: its display and spot, its kind, a field of its width
+    LcdMessage *findQueued(const LcdMessage &msg) const
+    {
+        for (LcdMessage *q : m_queued) {
+            if ((q != NULL) && (q->display == msg.display) && (q->row == msg.row) && (q->col == msg.col) && (q->kind == msg.kind) &&
+                ((msg.kind == LCD_KIND_TEXT) || (q->width == msg.width))) {
+                return q;
+            }
+        }
+        return NULL;
+    }
 
+    // Written over the queued message for its spot (true), or listed
+    bool mergeOrTrack(LcdMessage *msg)
+    {
+        LcdMessage *q = findQueued(*msg);
+        if (q != NULL) {
+            overlay(*q, *msg);
+            return true;
+        }
+        for (LcdMessage *&slot : m_queued) {
+            if (slot == NULL) {
+                slot = msg;
+                break;
+            }
+        }
+        return false;
+    }
+
+    void untrack(LcdMessage *msg)
+    {
+        for (LcdMessage *&slot : m_queued) {
+            if (slot == msg) {
+                slot = NULL;
+            }
+        }
+    }
+
+    // dst then src at the same spot: src's text, dst's tail past it; a
+    // field covers the same cells, the latest value; scrolls add up
+    static void overlay(LcdMessage &dst, const LcdMessage &src)
+    {
+        if (src.kind == LCD_KIND_SCROLL) {
+            dst.shift.steps = (int16_t)((dst.shift.steps + src.shift.steps) % LCD_DDRAM_LINE);
+            return;
+        }
+        if (src.kind != LCD_KIND_TEXT) {
+            dst = src;
+            return;
+        }
+        uint8_t n = 0;
+        while (dst.text[n] != '\0') {
+            ++n;
+        }
+        uint8_t i = 0;
+        for (; src.text[i] != '\0'; ++i) {
+            dst.text[i] = src.text[i];
+        }
+        if (i >= n) {
+            dst.text[i] = '\0';
+        }
+    }
+
+    void show(LcdMessage *msg)
+    {
+        // Out of the table first: later posts for the spot queue anew
+        AoPort::enterCritical();
+        untrack(msg);
+        AoPort::exitCritical();
+
+        Screen &s = m_screens[(msg->display < N) ? msg->display : (N - 1)];
+        if (msg->kind == LCD_KIND_SCROLL) {
+            if (s.rows <= 2) {
+                const int16_t steps = (int16_t)(msg->shift.steps % LCD_DDRAM_LINE);
+                s.shift = (uint8_t)((s.shift + LCD_DDRAM_LINE + steps) % LCD_DDRAM_LINE);
+                s.dirty = true;
+            }
+        } else if ((msg->row < s.rows) && (msg->col < s.line)) {
+            char         *cells = &s.frame[msg->row * s.line + msg->col];
+            const uint8_t room  = (uint8_t)(s.line - msg->col);
+            if (msg->kind == LCD_KIND_NUMBER) {
+                renderNumber(cells, room, *msg);
+            } else if (msg->kind == LCD_KIND_BAR) {
+                renderBar(cells, room, *msg);
+            } else {
+                for (uint8_t i = 0; (i < room) && (msg->text[i] != '\0'); ++i) {
+                    cells[i] = msg->text[i];
+                }
+            }
+            s.dirty = true;
+        }
+        m_pool.release(msg);
+
+        bringUp(s);
+        refresh();
+        keep();
+    }
+
+    // ── Warm start, display 0 (.noinit, lcd_warm_record()) ──────
+    static uint32_t warmCheck(const LcdWarmRecord &r)
+    {
+        const uint8_t *bytes = (const uint8_t *)&r;
+        uint32_t       sum   = 0;
+
+        for (size_t i = 0; i < offsetof(LcdWarmRecord, check); ++i) {
+            sum = ((sum << 1) | (sum >> 31)) ^ bytes[i];
+        }
+        return ~sum;
+    }
+
+    // The frames of a record of this display after a reset which
+    // left it powered, a message queued for the bring-up
+    bool warmStart()
+    {
+#if defined(USE_POSIX_SIM)
+        return false;
+#else
+        const LcdWarmRecord &r = lcd_warm_record();
+        Screen              &s = m_screens[0];
+
+        if ((watchdog_warm_reset() == 0) || (r.magic != LCD_WARM_MAGIC) || (r.check != warmCheck(r)) ||
+            (r.addr != s.lcd.address()) || (r.rows != s.rows) || (r.line != s.line) ||
+            (r.shift >= LCD_DDRAM_LINE)) {
+            return false;
+        }
+        memcpy(s.frame, r.frame, sizeof(s.frame));
+        memcpy(s.shown, r.shown, sizeof(s.shown));
+        s.shift = r.shift;
+        s.warm  = true;
+        scroll(0);
+        return true;
+#endif
+    }
+
+    // What display 0 shows, no record while its state is unknown
+    void keep()
+    {
+        LcdWarmRecord &r = lcd_warm_record();
+        const Screen  &s = m_screens[0];
+
+        if (!s.ready) {
+            r.magic = 0;
+            return;
+        }
+        r.magic = LCD_WARM_MAGIC;
+        r.addr  = s.lcd.address();
+        r.rows  = s.rows;
+        r.line  = s.line;
+        r.shift = s.lcd.shift();
+        memcpy(r.frame, s.frame, sizeof(r.frame));
+        memcpy(r.shown, s.shown, sizeof(r.shown));
+        r.check = warmCheck(r);
+    }
+
+    // ── Fields, rendered in the frame buffer (room: cells to its end) ──
+    // Right aligned from the last cell of the field, the cells past the
+    // end of the row are skipped
+    static void renderNumber(char *cells, uint8_t room, const LcdMessage &msg)
+    {
+        const bool  negative = msg.number.value < 0;
+        uint32_t    value    = negative ? (0U - (uint32_t)msg.number.value) : (uint32_t)msg.number.value;
+        const int   decimals = msg.number.decimals;
+        int         i        = (int)msg.width - 1;
+
+        for (int digits = 0; (value != 0) || (digits <= decimals); ++digits) {
+            if ((digits == decimals) && (decimals > 0)) {
+                putCell(cells, room, i--, '.');
+            }
+            putCell(cells, room, i--, (char)('0' + (value % 10U)));
+            value /= 10U;
+        }
+        if (negative) {
+            putCell(cells, room, i--, '-');
+        }
+        if (i < -1) {
+            for (i = 0; i < (int)msg.width; ++i) {
+                putCell(cells, room, i, '*');       // does not fit
+            }
+            return;
+        }
+        for (; i >= 0; --i) {
+            putCell(cells, room, i, ' ');
+        }
+    }
+
+    static void renderBar(char *cells, uint8_t room, const LcdMessage &msg)
+    {
+        const uint32_t steps = (uint32_t)msg.width * 5;
+        uint32_t lit = (msg.level.max == 0) ? 0 :
+                       (msg.level.value >= msg.level.max ? steps : (msg.level.value * steps) / msg.level.max);
+
+        for (uint8_t i = 0; (i < msg.width) && (i < room); i++) {
+            if (lit >= 5) {
+                cells[i] = LCD_CHAR_FULL;
+                lit -= 5;
+            } else if (lit > 0) {
+                cells[i] = (char)(LCD_GLYPH_HBAR + lit - 1);
+                lit = 0;
+            } else {
+                cells[i] = ' ';
+            }
+        }
+    }
+
+    static void putCell(char *cells, uint8_t room, int i, char ch)
+    {
+        if ((i >= 0) && (i < (int)room)) {
+            cells[i] = ch;
+        }
+    }
+
+    // ── Hardware init, at most once per LCD_RETRY_MS ───────────
+    bool bringUp(Screen &s)
+    {
+        if (s.ready) {
+            return true;
+        }
+        const AoPort::Tick now = AoPort::now();
+        if (s.tried && ((AoPort::Tick)(now - s.lastTry) < AO_MS_TO_TICKS(LCD_RETRY_MS))) {
+            return false;
+        }
+        s.tried   = true;
+        s.lastTry = now;
+
+        s.ready = s.warm ? s.lcd.resync() : s.lcd.init();
+        if (s.ready && !s.warm) {
+            s.lcd.clear();
+            fill(s.shown, ' ');
+        }
+        s.warm = false;             // a retry is the full init
+        if (s.ready) {
+            s.dirty = true;
+            boot_time_mark(BOOT_TIME_LCD);
+        }
+        return s.ready;
+    }
+
+    // One changed run of every dirty display in turn, until none is
+    // left; a display with an I2C error stays dirty for its re-init
+    void refresh()
+    {
+        bool sent = true;
+        while (sent) {
+            sent = false;
+            for (Screen &s : m_screens) {
+                if (s.dirty && s.ready && sendRun(s)) {
+                    sent = true;
+                }
+            }
+        }
+    }
+
+    // The window where scroll() wants it, the shorter way round, in one
+    // transfer; the driver counts the shifts (clear() is 0)
+    static void moveWindow(Screen &s)
+    {
+        const uint8_t left = (uint8_t)((s.shift + LCD_DDRAM_LINE - s.lcd.shift()) % LCD_DDRAM_LINE);
+        if (left == 0) {
+            return;
+        }
+        for (uint8_t n = (left <= LCD_DDRAM_LINE / 2) ? left : (uint8_t)(LCD_DDRAM_LINE - left); n > 0; --n) {
+            s.lcd.shiftDisplay(left <= LCD_DDRAM_LINE / 2);
+        }
+        s.lcd.flush();
+    }
+
+    // The next run of frame which differs from shown, from where the
+    // last one ended; at the end of the frame once more from the start
+    // if a glyph load staled cells already drawn. False once it is
+    // done (dirty cleared) or on an I2C error
+    bool sendRun(Screen &s)
+    {
+        if ((s.rows <= 2) && (s.lcd.shift() != s.shift)) {
+            moveWindow(s);
+            if (!s.lcd.ok()) {
+                s.ready = false;
+                restart(s);
+                return false;
+            }
+        }
         for (;;) {
-            if (xQueueReceive(m_queue, &msg, portMAX_DELAY) == pdTRUE) {
-                m_lcd.setCursor(msg.col, msg.row);
-                m_lcd.print(msg.text);
+            for (uint8_t r = s.nextRow; r < s.rows; ++r, s.nextCol = 0) {
+                const char *want = &s.frame[r * s.line];
+                char       *have = &s.shown[r * s.line];
+
+                for (uint8_t c = s.nextCol; c < s.line; ++c) {
+                    if (shownAs(s, want[c]) == have[c]) {
+                        continue;
+                    }
+                    // Extend over single unchanged chars, cheaper than a move
+                    const uint8_t start = c;
+                    uint8_t       end   = c + 1;
+                    for (uint8_t k = end; k < s.line; ++k) {
+                        if (shownAs(s, want[k]) != have[k]) {
+                            end = k + 1;
+                        } else if ((k + 1 < s.line) && (shownAs(s, want[k + 1]) != have[k + 1])) {
+                            continue;
+                        } else {
+                            break;
+                        }
+                    }
+
+                    // Glyph loads first, they leave the address in CGRAM
+                    char out[LCD_DDRAM_LINE];
+                    for (uint8_t k = start; k < end; ++k) {
+                        out[k - start] = load(s, want[k]);
+                    }
+                    s.lcd.setCursor(start, r);
+                    s.lcd.print(out, (uint8_t)(end - start));
+                    if (!s.lcd.ok()) {
+                        s.ready = false;        // state unknown: redraw after re-init
+                        restart(s);
+                        return false;
+                    }
+                    for (uint8_t k = start; k < end; ++k) {
+                        have[k] = out[k - start];
+                    }
+                    s.nextRow = r;
+                    s.nextCol = end;
+                    return true;
+                }
             }
+
+            if (!s.stale || (s.pass > 0)) {
+                s.dirty = false;
+                restart(s);
+                return false;
+            }
+            s.stale   = false;
+            s.pass    = 1;
+            s.nextRow = 0;
+            s.nextCol = 0;
+        }
+    }
+
+    static void restart(Screen &s)
+    {
+        s.stale   = false;
+        s.pass    = 0;
+        s.nextRow = 0;
+        s.nextCol = 0;
+    }
+
+    static bool isGlyph(char ch)
+    {
+        const uint8_t id = (uint8_t)ch - LCD_GLYPH_FIRST;
+        return id < LCD_GLYPH_COUNT;
+    }
+
+    // The code a frame char is sent as; 0 for a glyph not loaded, which
+    // differs from anything shown
+    static char shownAs(Screen &s, char ch)
+    {
+        return isGlyph(ch) ? s.lcd.findGlyph((uint8_t)ch - LCD_GLYPH_FIRST) : ch;
+    }
+
+    // Same, loading the glyph; the cells of the slot it took are staled
+    static char load(Screen &s, char ch)
+    {
+        if (!isGlyph(ch)) {
+            return ch;
+        }
+        const uint8_t id   = (uint8_t)ch - LCD_GLYPH_FIRST;
+        char          code = s.lcd.findGlyph(id);
+        if (code != 0) {
+            return code;
+        }
+
+        code = s.lcd.glyph(id, LCD_GLYPHS[id]);
+        for (uint8_t i = 0; i < s.rows * s.line; ++i) {
+            if (s.shown[i] == code) {
+                s.shown[i] = LCD_GLYPH_FIRST;    // never sent
+                s.stale = true;
+            }
+        }
+        return code;
+    }
+
+    static void fill(char (&fb)[LCD_FB_CELLS], char ch)
+    {
+        for (uint8_t i = 0; i < LCD_FB_CELLS; ++i) {
+            fb[i] = ch;
         }
     }
 };
@@ -5,17 +5,77 @@
 
 #define LCD_MSG_LEN  32     // Max characters per message
 
+// ── Bar glyphs ─────────────────────────────────────────────────
+// The HD44780 codes 0x10..0x1F show nothing: in a message text they
+// are glyph ids, LcdAO loads the bitmap into CGRAM when it shows one.
+#define LCD_GLYPH_FIRST   0x10
+#define LCD_GLYPH_HBAR    0x10      // + 0..3: 1..4 left columns lit
+#define LCD_GLYPH_VBAR    0x14      // + 0..6: 1..7 bottom rows lit
+#define LCD_GLYPH_COUNT   11
+#define LCD_CHAR_FULL     '\xFF'    // ROM block, every dot lit
+
+inline constexpr uint8_t LCD_GLYPHS[LCD_GLYPH_COUNT][8] = {
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 },
+    { 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18 },
+    { 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C },
+    { 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+};
+
+// ── Kinds ──────────────────────────────────────────────────────
+// A text is copied into the frame buffer as it is; a field holds a
+// value which LcdAO renders straight into the frame buffer, over its
+// width cells, when it shows the message
+enum LcdKind : uint8_t {
+    LCD_KIND_TEXT = 0,
+    LCD_KIND_NUMBER,        // number, right aligned, decimals after a '.'
+    LCD_KIND_BAR,           // horizontal bar, value of max in 5 steps per cell
+    LCD_KIND_SCROLL         // the display window moved, no text (LcdAO.hpp)
+};
+
 struct LcdMessage {
     uint8_t row;
     uint8_t col;
-    char    text[LCD_MSG_LEN];
+    uint8_t display;        // of an LcdAO with several, 0 by the builders
+    uint8_t kind;           // LcdKind
+    uint8_t width;          // cells of a field
+    union {
+        char text[LCD_MSG_LEN];
+        struct {
+            int32_t value;
+            uint8_t decimals;
+        } number;
+        struct {
+            uint32_t value;
+            uint32_t max;
+        } level;
+        struct {
+            int16_t steps;  // > 0: the text goes left
+        } shift;
+    };
 
     // Convenience constructor — safe string copy, no strncpy dependency
     static LcdMessage make(uint8_t row, uint8_t col, const char *str)
     {
         LcdMessage m;
-        m.row = row;
-        m.col = col;
+        fill(m, row, col, str);
+        return m;
+    }
+
+    // Same, in place (e.g. a block of the LcdAO pool)
+    static void fill(LcdMessage &m, uint8_t row, uint8_t col, const char *str)
+    {
+        m.row     = row;
+        m.col     = col;
+        m.display = 0;
+        m.kind    = LCD_KIND_TEXT;
+        m.width   = 0;
 
         uint8_t i = 0;
         while (str[i] && i < LCD_MSG_LEN - 1) {
@@ -23,7 +83,73 @@ struct LcdMessage {
             i++;
         }
         m.text[i] = '\0';
+    }
+
+    // Number field over width cells: value / 10^decimals, '*' in every
+    // cell if it does not fit
+    static LcdMessage num(uint8_t row, uint8_t col, uint8_t width,
+                          int32_t value, uint8_t decimals = 0)
+    {
+        LcdMessage m;
+        m.row             = row;
+        m.col             = col;
+        m.display         = 0;
+        m.kind            = LCD_KIND_NUMBER;
+        m.width           = width;
+        m.number.value    = value;
+        m.number.decimals = decimals;
+        return m;
+    }
 
+    // Horizontal bar field over width cells, value of max in 5 steps per cell
+    static LcdMessage bar(uint8_t row, uint8_t col, uint8_t width,
+                          uint32_t value, uint32_t max)
+    {
+        LcdMessage m;
+        m.row         = row;
+        m.col         = col;
+        m.display     = 0;
+        m.kind        = LCD_KIND_BAR;
+        m.width       = width;
+        m.level.value = value;
+        m.level.max   = max;
+        return m;
+    }
+
+    // Scroll of the whole display by steps columns, > 0 to the left
+    static LcdMessage scroll(int16_t steps)
+    {
+        LcdMessage m;
+        m.row         = 0;
+        m.col         = 0;
+        m.display     = 0;
+        m.kind        = LCD_KIND_SCROLL;
+        m.width       = 0;
+        m.shift.steps = steps;
+        return m;
+    }
+
+    // Sparkline, one cell per sample, each of max in 8 steps
+    static LcdMessage spark(uint8_t row, uint8_t col, const uint8_t *samples,
+                            uint8_t n, uint8_t max)
+    {
+        LcdMessage m;
+        m.row     = row;
+        m.col     = col;
+        m.display = 0;
+        m.kind    = LCD_KIND_TEXT;
+        m.width   = 0;
+        if (n > LCD_MSG_LEN - 1) {
+            n = LCD_MSG_LEN - 1;
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            const uint32_t level = (max == 0) ? 0 :
+                (samples[i] >= max ? 8 : ((uint32_t)samples[i] * 8) / max);
+            m.text[i] = (level == 0) ? ' ' :
+                        (level == 8) ? LCD_CHAR_FULL : (char)(LCD_GLYPH_VBAR + level - 1);
+        }
+        m.text[n] = '\0';
         return m;
     }
 };
@@ -4,58 +4,216 @@
 #include "ActiveObject.hpp"
 #include "LedConfig.hpp"
 #include "AoConfig.hpp"
+#include "StateMachine.hpp"
+#include "TimeEvent.hpp"
+
+// ─────────────────────────────────────────────────────────────────
+// LedPattern
+//
+// Blink: periodMs split into dutyPct on, the rest off. Breathe: the
+// duty ramps 0 → 100 → 0 over periodMs, in frames of
+// LED_BREATH_FRAME_MS. The LED is off after repeat periods (0: for
+// ever); SIG_LED_ON / OFF / TOGGLE end a pattern at once. Each phase
+// is a TimeEvent, so the LED costs no CPU between its transitions.
+// The on board LEDs (PC13) have no timer channel: a breath is a
+// slow software PWM, its steps are visible
+// ─────────────────────────────────────────────────────────────────
+struct LedPattern {
+    uint16_t periodMs;
+    uint8_t  dutyPct;       // blink only, 0..100
+    uint8_t  repeat;        // periods, 0 for ever
+    bool     breathe;
+};
 
 class LedAO {
 public:
+    typedef StateMachine<LedAO> Sm;
+
     LedAO(const LedConfig &ledCfg,
           const AoConfig  &aoCfg = LED_AO_DEFAULTS)
         : m_cfg(ledCfg)
         , m_aoCfg(aoCfg)
-        , m_state(false)
+        , m_sm(this)
+        , m_step(SIG_TIMEOUT, 0)
+        , m_next()
+        , m_pattern()
+        , m_elapsedMs(0)
+        , m_onMs(0)
+        , m_count(0)
+        , m_lit(false)
     {}
 
     void init()
     {
-        m_ao.init(m_aoCfg.name,
-                  &LedAO::dispatch,
-                  this,
-                  m_aoCfg.priority,
-                  m_aoCfg.stackWords,
-                  m_aoCfg.queueDepth);
+        TimeEvent::initService();
+        m_sm.start(&ST_OFF);
+
+        // Only bare signals: the task signal set, no queue
+        m_ao.initSignals(m_aoCfg.name,
+                         &LedAO::dispatch,
+                         this,
+                         m_aoCfg.priority,
+                         m_aoCfg.stackWords);
     }
 
     ActiveObject *getAO() { return &m_ao; }
 
+    // Any task: the pattern starts over at its next dispatch, a
+    // pattern already running is replaced
+    void setPattern(const LedPattern &pattern)
+    {
+        AoPort::enterCritical();
+        m_next = pattern;
+        AoPort::exitCritical();
+
+        const Event e = { SIG_LED_PATTERN, 0 };
+        m_ao.post(e);
+    }
+
 private:
+#if (AO_PORT_STATIC == 1)
+    // Embedded at the default sizes, a custom AoConfig may ask for less
+    StaticSignalActiveObject<LED_AO_DEFAULTS.stackWords> m_ao;
+#else
     ActiveObject m_ao;
+#endif
     LedConfig    m_cfg;
     AoConfig     m_aoCfg;
-    bool         m_state;
+    Sm           m_sm;
+    TimeEvent    m_step;        // end of the current phase of the pattern
+    LedPattern   m_next;        // from setPattern(), under a critical section
+    LedPattern   m_pattern;
+    uint16_t     m_elapsedMs;   // into the period, at the start of the frame
+    uint16_t     m_onMs;        // of the frame
+    uint8_t      m_count;       // periods done
+    bool         m_lit;         // in the on phase of the frame
+
+    static const Sm::State      ST_OFF;
+    static const Sm::State      ST_ON;
+    static const Sm::State      ST_PATTERN;
+
+    static const Sm::Transition OFF_T[];
+    static const Sm::Transition ON_T[];
+    static const Sm::Transition PATTERN_T[];
 
     static void dispatch(void *instance, const Event &e)
     {
-        static_cast<LedAO *>(instance)->handleEvent(e);
+        static_cast<LedAO *>(instance)->m_sm.dispatch(e);
     }
 
     void setLed(bool on)
     {
-        m_state = on;
         if (on)
             m_cfg.activeHigh ? m_cfg.pin.setHigh() : m_cfg.pin.setLow();
         else
             m_cfg.activeHigh ? m_cfg.pin.setLow()  : m_cfg.pin.setHigh();
     }
 
-    void handleEvent(const Event &e)
+    void enterOn()  { setLed(true);  }
+    void enterOff() { setLed(false); }
+
+    // ── Pattern ────────────────────────────────────────────────
+    uint16_t frameMs() const
     {
-        switch (e.signal)
-        {
-            case SIG_LED_ON:     setLed(true);       break;
-            case SIG_LED_OFF:    setLed(false);      break;
-            case SIG_LED_TOGGLE: setLed(!m_state);   break;
-            default:                                 break;
+        return m_pattern.breathe ? (uint16_t)LED_BREATH_FRAME_MS : m_pattern.periodMs;
+    }
+
+    void enterPattern()
+    {
+        AoPort::enterCritical();
+        m_pattern = m_next;
+        AoPort::exitCritical();
+
+        if (m_pattern.periodMs < frameMs()) {
+            m_pattern.periodMs = frameMs();
         }
+        m_elapsedMs = 0;
+        m_count     = 0;
+        startFrame();
+    }
+
+    void exitPattern() { m_step.disarm(); }
+
+    // The on part first, a phase of 0 ms is skipped
+    void startFrame()
+    {
+        const uint32_t frame = frameMs();
+
+        if (m_pattern.breathe) {
+            const uint32_t half = m_pattern.periodMs / 2U;
+            const uint32_t t    = m_elapsedMs;
+            const uint32_t ramp = (t < half) ? t : (m_pattern.periodMs - t);
+            m_onMs = (uint16_t)((half > 0) ? (frame * ramp) / half : frame);
+        } else {
+            const uint32_t duty = (m_pattern.dutyPct > 100U) ? 100U : m_pattern.dutyPct;
+            m_onMs = (uint16_t)((frame * duty) / 100U);
+        }
+        m_lit = (m_onMs > 0);
+        setLed(m_lit);
+        m_step.arm(&m_ao, AO_MS_TO_TICKS(m_lit ? m_onMs : frame));
+    }
+
+    bool frameEnds() const
+    {
+        return !m_lit || (m_onMs >= frameMs());
+    }
+
+    // The last frame of the last period ends
+    bool isDone(const Event &) const
+    {
+        return frameEnds() && (m_pattern.repeat != 0) &&
+               ((uint32_t)m_elapsedMs + frameMs() >= m_pattern.periodMs) &&
+               ((uint32_t)m_count + 1U >= m_pattern.repeat);
+    }
+
+    void onStep(const Event &)
+    {
+        if (!frameEnds()) {
+            m_lit = false;
+            setLed(false);
+            m_step.arm(&m_ao, AO_MS_TO_TICKS(frameMs() - m_onMs));
+            return;
+        }
+        m_elapsedMs = (uint16_t)(m_elapsedMs + frameMs());
+        if (m_elapsedMs >= m_pattern.periodMs) {
+            m_elapsedMs = 0;
+            if (m_count < 0xFFU) {
+                ++m_count;
+            }
+        }
+        startFrame();
     }
 };
 
-#endif /* U_LED_AO_HPP */
\ No newline at end of file
+// ── Transition tables ──────────────────────────────────────────
+inline const LedAO::Sm::Transition LedAO::OFF_T[] = {
+    { SIG_LED_ON,      NULL, NULL, &ST_ON      },
+    { SIG_LED_TOGGLE,  NULL, NULL, &ST_ON      },
+    { SIG_LED_PATTERN, NULL, NULL, &ST_PATTERN },
+    { SIG_NONE,        NULL, NULL, NULL        }
+};
+
+inline const LedAO::Sm::Transition LedAO::ON_T[] = {
+    { SIG_LED_OFF,     NULL, NULL, &ST_OFF     },
+    { SIG_LED_TOGGLE,  NULL, NULL, &ST_OFF     },
+    { SIG_LED_PATTERN, NULL, NULL, &ST_PATTERN },
+    { SIG_NONE,        NULL, NULL, NULL        }
+};
+
+// A new pattern re-enters the state: it starts over
+inline const LedAO::Sm::Transition LedAO::PATTERN_T[] = {
+    { SIG_TIMEOUT,     &LedAO::isDone, NULL,            &ST_OFF     },
+    { SIG_TIMEOUT,     NULL,           &LedAO::onStep,  NULL        },
+    { SIG_LED_ON,      NULL,           NULL,            &ST_ON      },
+    { SIG_LED_OFF,     NULL,           NULL,            &ST_OFF     },
+    { SIG_LED_TOGGLE,  NULL,           NULL,            &ST_OFF     },
+    { SIG_LED_PATTERN, NULL,           NULL,            &ST_PATTERN },
+    { SIG_NONE,        NULL,           NULL,            NULL        }
+};
+
+//                                                  parent  entry                 exit                 transitions
+inline const LedAO::Sm::State LedAO::ST_OFF     = { NULL,   &LedAO::enterOff,     NULL,                OFF_T     };
+inline const LedAO::Sm::State LedAO::ST_ON      = { NULL,   &LedAO::enterOn,      NULL,                ON_T      };
+inline const LedAO::Sm::State LedAO::ST_PATTERN = { NULL,   &LedAO::enterPattern, &LedAO::exitPattern, PATTERN_T };
+
+#endif /* U_LED_AO_HPP */
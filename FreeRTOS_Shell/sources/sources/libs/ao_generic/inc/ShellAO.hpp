@@ -0,0 +1,286 @@
+#ifndef U_SHELL_AO_HPP
+#define U_SHELL_AO_HPP
+
+#include <string.h>
+#include "ActiveObject.hpp"
+#include "AoConfig.hpp"
+#include "TimeEvent.hpp"
+#include "ushell_core.h"
+#include "uart_access.h"
+
+// Bytes taken from the UART ring per Feed(), a longer burst is fed
+// over several dispatches (another event is posted for the rest)
+#define SHELL_AO_CHUNK      32
+
+// Bytes feed() keeps for the next dispatch, from the other tasks
+#define SHELL_AO_FEED_SIZE  64
+
+// Input poll of the backends without an RX interrupt (RTT)
+#define SHELL_AO_POLL_MS    20U
+
+// ─────────────────────────────────────────────────────────────────
+// ShellAO
+//
+// The shell as an ActiveObject (AO_SHELL): no task blocked in
+// Microshell::Run(), the input arrives as SIG_UART_RX and goes to
+// Microshell::Feed() a chunk at a time, in the event loop of the
+// other AOs (the AoKernel task with AO_COOPERATIVE_KERNEL).
+//
+// The RX interrupt (uart_rx_set_hook) posts one SIG_UART_RX per
+// burst, coalesced while it is queued; the dispatch takes the chunk
+// from the ring with uart_read(.., 0), it never waits. feed() queues
+// a chunk of any other producer (a button typing a command line);
+// post() and postFromISR() queue a whole line with Microshell::Post(),
+// run above the line in edition instead of typed into it.
+// A lone ESC is dropped by a SIG_TIMEOUT uSHELL_ESCAPE_TIMEOUT_MS
+// after the chunk it ended. A backend without an RX interrupt is
+// polled every SHELL_AO_POLL_MS by a TimeEvent.
+//
+// Run to completion still holds the loop for a whole command: a
+// handler which waits (a confirmation, the rest of a binary frame,
+// mwrite) blocks in the transport as under Run(), the AOs which
+// share the loop wait with it. Under WATCHDOG a command is one
+// dispatch, it has WATCHDOG_AO_STALL_MS.
+// ─────────────────────────────────────────────────────────────────
+class ShellAO {
+public:
+    // In the AO, before the first prompt (SetHistoryStore(), ...)
+    typedef void (*StartFn)(Microshell *shell);
+
+    ShellAO(uShellInst_s   *shellInst,
+            const char     *promptExt,
+            StartFn         onStart = NULL,
+            const AoConfig &aoCfg   = SHELL_AO_DEFAULTS)
+        : m_shellInst(shellInst)
+        , m_promptExt(promptExt)
+        , m_onStart(onStart)
+        , m_aoCfg(aoCfg)
+        , m_shell(NULL)
+        , m_polled(false)
+        , m_stopped(false)
+        , m_fedLen(0)
+        , m_escape(SIG_TIMEOUT, TMR_ESCAPE)
+        , m_poll(SIG_TIMEOUT, TMR_POLL)
+    {}
+
+    // Call once before the scheduler starts; the banner and the
+    // prompt follow at the first dispatch
+    void init()
+    {
+        TimeEvent::initService();
+
+        m_ao.init(m_aoCfg.name,
+                  &ShellAO::dispatch,
+                  this,
+                  m_aoCfg.priority,
+                  m_aoCfg.stackWords,
+                  m_aoCfg.queueDepth);
+
+        s_instance = this;
+        m_polled = (uart_rx_set_hook(&ShellAO::onRx) != 0);
+
+        const Event e = { SIG_UART_RX, 0 };
+        m_ao.post(e);
+    }
+
+    ActiveObject *getAO() { return &m_ao; }
+
+    // Any task: len bytes of input, as if typed ("led 1\n"); false
+    // when they do not fit the bytes not yet taken
+    bool feed(const char *buf, uint32_t len)
+    {
+        bool fits;
+
+        AoPort::enterCritical();
+        fits = (len <= SHELL_AO_FEED_SIZE - m_fedLen);
+        if (fits) {
+            memcpy(&m_fed[m_fedLen], buf, len);
+            m_fedLen += len;
+        }
+        AoPort::exitCritical();
+
+        if (!fits) {
+            m_ao.dropped();
+            return false;
+        }
+        // A full queue already holds an event which takes them
+        const Event e = { SIG_UART_RX, 0 };
+        (void)m_ao.post(e);
+        return true;
+    }
+
+#if (uSHELL_IMPLEMENTS_POSTED_COMMANDS == 1)
+    // Any task: a command line for the shell, run at the next
+    // dispatch; false when the queue of the shell is full
+    bool post(const char *line)
+    {
+        if (!Microshell::getShellPtr(m_shellInst, m_promptExt)->Post(line)) {
+            m_ao.dropped();
+            return false;
+        }
+        const Event e = { SIG_UART_RX, 0 };
+        (void)m_ao.post(e);
+        return true;
+    }
+
+    // An interrupt: the same, the event merged with the one of the RX
+    bool postFromISR(const char *line)
+    {
+        AoPort::Woken xHigherPriorityTaskWoken = 0;
+        const Event e = { SIG_UART_RX, 0 };
+
+        if (!Microshell::getShellPtr(m_shellInst, m_promptExt)->Post(line)) {
+            return false;
+        }
+        if (m_ao.postCoalescedFromISR(e, &xHigherPriorityTaskWoken)) {
+            AoPort::yieldFromISR(xHigherPriorityTaskWoken);
+        }
+        return true;
+    }
+#endif
+
+private:
+    // ── Timer ids (SIG_TIMEOUT param) ──────────────────────────
+    enum TimerId : uint32_t {
+        TMR_ESCAPE,         // the gap after a lone ESC
+        TMR_POLL,           // input poll, backend without RX interrupt
+    };
+
+#if (AO_PORT_STATIC == 1)
+    // Embedded at the default sizes, a custom AoConfig may ask for less
+    StaticActiveObject<SHELL_AO_DEFAULTS.stackWords, SHELL_AO_DEFAULTS.queueDepth> m_ao;
+#else
+    ActiveObject  m_ao;
+#endif
+    uShellInst_s *m_shellInst;
+    const char   *m_promptExt;
+    StartFn       m_onStart;
+    AoConfig      m_aoCfg;
+    Microshell   *m_shell;      // at the first dispatch
+    bool          m_polled;     // no RX hook: m_poll reads the input
+    bool          m_stopped;    // the exit command ran
+    uint32_t      m_fedLen;     // under a critical section, with m_fed
+    char          m_fed[SHELL_AO_FEED_SIZE];
+    TimeEvent     m_escape;
+    TimeEvent     m_poll;
+
+    static inline ShellAO *s_instance = NULL;
+
+    // ── RX interrupt ───────────────────────────────────────────
+    // One post per burst: merged while the last one is queued
+    static void onRx()
+    {
+        AoPort::Woken xHigherPriorityTaskWoken = 0;
+        const Event e = { SIG_UART_RX, 0 };
+
+        if (s_instance->m_ao.postCoalescedFromISR(e, &xHigherPriorityTaskWoken)) {
+            AoPort::yieldFromISR(xHigherPriorityTaskWoken);
+        }
+    }
+
+    // ── Trampoline ─────────────────────────────────────────────
+    static void dispatch(void *instance, const Event &e)
+    {
+        static_cast<ShellAO *>(instance)->handleEvent(e);
+    }
+
+    void handleEvent(const Event &e)
+    {
+        if (m_stopped) {
+            return;
+        }
+        if (m_shell == NULL) {
+            start();
+        }
+
+        switch (e.signal) {
+            case SIG_UART_RX:
+                // Cleared first: a burst from now on posts again
+                m_ao.clearPending(SIG_UART_RX);
+#if (uSHELL_IMPLEMENTS_POSTED_COMMANDS == 1)
+                m_shell->RunPosted();
+#endif
+                takeFed();
+                takeUart();
+                break;
+
+            case SIG_TIMEOUT:
+                if (e.param == TMR_ESCAPE) {
+                    feedShell(NULL, 0);
+                } else {
+                    takeUart();
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        if (m_stopped) {
+            m_escape.disarm();
+            m_poll.disarm();
+            return;
+        }
+        // The rest of a sequence split over two chunks disarms it
+        if (m_shell->FeedPending()) {
+            m_escape.arm(&m_ao, AO_MS_TO_TICKS(uSHELL_ESCAPE_TIMEOUT_MS));
+        } else {
+            m_escape.disarm();
+        }
+        if (m_polled && !m_poll.isArmed()) {
+            m_poll.arm(&m_ao, AO_MS_TO_TICKS(SHELL_AO_POLL_MS));
+        }
+    }
+
+    void start()
+    {
+        m_shell = Microshell::getShellPtr(m_shellInst, m_promptExt);
+        if (m_onStart != NULL) {
+            m_onStart(m_shell);
+        }
+        m_shell->Start();
+    }
+
+    void feedShell(const char *buf, uint32_t len)
+    {
+        if (!m_shell->Feed(buf, len)) {
+            m_stopped = true;
+            (void)uart_rx_set_hook(NULL);
+        }
+    }
+
+    // The bytes of feed(), all at once
+    void takeFed()
+    {
+        char     buf[SHELL_AO_FEED_SIZE];
+        uint32_t len;
+
+        AoPort::enterCritical();
+        len = m_fedLen;
+        memcpy(buf, m_fed, len);
+        m_fedLen = 0;
+        AoPort::exitCritical();
+
+        if (len > 0) {
+            feedShell(buf, len);
+        }
+    }
+
+    // One chunk of the ring; a full one leaves the rest to an event
+    // of its own, the other AOs run in between
+    void takeUart()
+    {
+        uint8_t   buf[SHELL_AO_CHUNK];
+        const int len = uart_read(buf, (int)sizeof(buf), 0);
+
+        if (len > 0) {
+            feedShell(reinterpret_cast<const char *>(buf), (uint32_t)len);
+        }
+        if ((len == (int)sizeof(buf)) && !m_stopped) {
+            const Event e = { SIG_UART_RX, 0 };
+            (void)m_ao.post(e);
+        }
+    }
+};
+
+#endif /* U_SHELL_AO_HPP */
@@ -0,0 +1,156 @@
+#ifndef U_STATE_MACHINE_HPP
+#define U_STATE_MACHINE_HPP
+
+#include <stdint.h>
+#include "GpioEvent.hpp"
+#include "AoPort.hpp"
+
+// ─────────────────────────────────────────────────────────────────
+// StateMachine
+//
+// Table-driven hierarchical state machine run by an AO dispatch.
+// Each State is a const table: its parent (NULL at the top), entry
+// and exit actions, and its transitions, ended by SIG_NONE. An
+// event goes to the current state, then up the parents, until a
+// row matches its signal and its guard; a row without target is an
+// internal transition (action only). A transition exits up to the
+// common ancestor, runs the action, and enters down to the target.
+// Handlers run to completion and must not block: delays are timer
+// events posted back to the AO.
+//
+//     inline const T::Sm::Transition T::IDLE_T[] = {
+//         { SIG_X,    &T::guard, &T::action, &T::ST_NEXT },
+//         { SIG_NONE, NULL,      NULL,       NULL        }
+//     };
+//     inline const T::Sm::State T::ST_IDLE = { NULL, &T::enter, NULL, IDLE_T };
+// ─────────────────────────────────────────────────────────────────
+template <typename T>
+class StateMachine {
+public:
+    typedef bool (T::*GuardFn)(const Event &e) const;
+    typedef void (T::*ActionFn)(const Event &e);
+    typedef void (T::*EntryExitFn)();
+
+    struct State;
+
+    struct Transition {
+        Signal        signal;
+        GuardFn       guard;        // NULL: always taken
+        ActionFn      action;       // NULL: none
+        const State  *target;       // NULL: internal, no exit/entry
+    };
+
+    struct State {
+        const State       *parent;
+        EntryExitFn        entry;
+        EntryExitFn        exit;
+        const Transition  *transitions;
+    };
+
+    static constexpr uint8_t MAX_DEPTH = 8;
+
+    explicit StateMachine(T *owner)
+        : m_owner(owner)
+        , m_state(NULL)
+    {}
+
+    // Enter the initial state, from its top parent down
+    void start(const State *initial)
+    {
+        enterDown(NULL, initial);
+        m_state = initial;
+    }
+
+    // false when no state handled the event (ignored)
+    bool dispatch(const Event &e)
+    {
+        for (const State *s = m_state; s != NULL; s = s->parent) {
+            for (const Transition *t = s->transitions; t->signal != SIG_NONE; ++t) {
+                if ((t->signal != e.signal) ||
+                    ((t->guard != NULL) && !(m_owner->*t->guard)(e))) {
+                    continue;
+                }
+                if (t->target == NULL) {
+                    if (t->action != NULL) {
+                        (m_owner->*t->action)(e);
+                    }
+                } else {
+                    transition(s, t, e);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const State *state() const { return m_state; }
+
+    bool isIn(const State *s) const
+    {
+        for (const State *c = m_state; c != NULL; c = c->parent) {
+            if (c == s) return true;
+        }
+        return false;
+    }
+
+private:
+    T            *m_owner;
+    const State  *m_state;
+
+    static bool contains(const State *outer, const State *inner)
+    {
+        for (; inner != NULL; inner = inner->parent) {
+            if (inner == outer) return true;
+        }
+        return false;
+    }
+
+    // Deepest state holding both, never one of them: a transition to
+    // self or to an ancestor exits and re-enters it
+    static const State *commonAncestor(const State *source, const State *target)
+    {
+        const State *a = source->parent;
+        while ((a != NULL) && !contains(a, target)) {
+            a = a->parent;
+        }
+        if ((a != NULL) && (a == target)) {
+            a = a->parent;
+        }
+        return a;
+    }
+
+    void enterDown(const State *from, const State *to)
+    {
+        const State *path[MAX_DEPTH];
+        uint8_t      n = 0;
+
+        for (const State *s = to; s != from; s = s->parent) {
+            AO_ASSERT(n < MAX_DEPTH);
+            path[n++] = s;
+        }
+        while (n > 0) {
+            const State *s = path[--n];
+            if (s->entry != NULL) {
+                (m_owner->*s->entry)();
+            }
+        }
+    }
+
+    void transition(const State *source, const Transition *t, const Event &e)
+    {
+        const State *lca = commonAncestor(source, t->target);
+
+        for (const State *s = m_state; s != lca; s = s->parent) {
+            if (s->exit != NULL) {
+                (m_owner->*s->exit)();
+            }
+        }
+        if (t->action != NULL) {
+            (m_owner->*t->action)(e);
+        }
+        enterDown(lca, t->target);
+        m_state = t->target;
+    }
+};
+
+#endif /* U_STATE_MACHINE_HPP */
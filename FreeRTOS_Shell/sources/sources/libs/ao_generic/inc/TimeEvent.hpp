@@ -0,0 +1,161 @@
+#ifndef U_TIME_EVENT_HPP
+#define U_TIME_EVENT_HPP
+
+#include <stdint.h>
+#include "ActiveObject.hpp"
+#include "AoConfig.hpp"
+#include "AoPort.hpp"
+
+// ─────────────────────────────────────────────────────────────────
+// TimeEvent
+//
+// One-shot timeout posted to an AO: arm() it from a handler instead
+// of blocking, the event arrives in the AO queue when it expires.
+// All TimeEvents share one kernel software timer (AoPort), which ticks
+// every AO_TIME_EVENT_MS while any of them is armed and is stopped
+// otherwise, so waiting costs no CPU and no task. Arming an armed
+// TimeEvent restarts it; an expiry already queued is not taken back
+// by disarm(), the state machine ignores it where it does not fit.
+// ─────────────────────────────────────────────────────────────────
+class TimeEvent {
+public:
+    TimeEvent(Signal signal, uint32_t param = 0)
+        : m_ao(NULL)
+        , m_next(NULL)
+        , m_left(0)
+        , m_armed(false)
+    {
+        m_event.signal = signal;
+        m_event.param  = param;
+    }
+
+    // Once, before the first arm() (repeated calls do nothing)
+    static void initService()
+    {
+        if (s_timer != NULL) {
+            return;
+        }
+#if (AO_PORT_STATIC == 1)
+        s_timer = AoPort::timerCreateStatic(&s_timerBuffer, "TimeEvt",
+                                            AO_MS_TO_TICKS(AO_TIME_EVENT_MS), onTick);
+#else
+        s_timer = AoPort::timerCreate("TimeEvt", AO_MS_TO_TICKS(AO_TIME_EVENT_MS), onTick);
+#endif
+        AO_ASSERT(s_timer != NULL);
+    }
+
+    // Post to ao after ticks (rounded up to the service resolution)
+    void arm(ActiveObject *ao, AoPort::Tick ticks)
+    {
+        const AoPort::Tick period = AO_MS_TO_TICKS(AO_TIME_EVENT_MS);
+        bool start;
+
+        AO_ASSERT(s_timer != NULL);
+
+        AoPort::enterCritical();
+        if (!m_armed) {
+            m_next  = s_armed;
+            s_armed = this;
+            m_armed = true;
+        }
+        m_ao   = ao;
+        m_left = (ticks + period - 1) / period;
+        if (m_left == 0) {
+            m_left = 1;
+        }
+        start     = !s_running;
+        s_running = true;
+        AoPort::exitCritical();
+
+        if (start) {
+            AoPort::timerStart(s_timer);
+        }
+    }
+
+    void disarm()
+    {
+        AoPort::enterCritical();
+        unlink();
+        AoPort::exitCritical();
+    }
+
+    bool isArmed() const { return m_armed; }
+
+private:
+    ActiveObject *m_ao;
+    TimeEvent    *m_next;
+    AoPort::Tick  m_left;       // service ticks to go
+    bool          m_armed;
+    Event         m_event;
+
+    // The armed ones and the service timer, under a critical section
+    static inline TimeEvent           *s_armed   = NULL;
+    static inline bool                 s_running = false;
+    static inline AoPort::Timer        s_timer   = NULL;
+#if (AO_PORT_STATIC == 1)
+    static inline AoPort::TimerBuffer  s_timerBuffer;
+#endif
+
+    void unlink()
+    {
+        if (!m_armed) {
+            return;
+        }
+        for (TimeEvent **pp = &s_armed; *pp != NULL; pp = &(*pp)->m_next) {
+            if (*pp == this) {
+                *pp = m_next;
+                break;
+            }
+        }
+        m_next  = NULL;
+        m_armed = false;
+    }
+
+    // Timer task context. One-shot, restarted while any is armed: the
+    // service never stops under an arm() racing with the last expiry
+    static void onTick(AoPort::TimerArg arg)
+    {
+        (void)arg;
+
+        AoPort::enterCritical();
+        for (TimeEvent *te = s_armed; te != NULL; te = te->m_next) {
+            if (te->m_left > 0) {
+                --te->m_left;
+            }
+        }
+        AoPort::exitCritical();
+
+        // Post the expired ones one at a time, outside the critical section
+        for (;;) {
+            ActiveObject *ao = NULL;
+            Event         e;
+
+            AoPort::enterCritical();
+            for (TimeEvent *te = s_armed; te != NULL; te = te->m_next) {
+                if (te->m_left == 0) {
+                    ao = te->m_ao;
+                    e  = te->m_event;
+                    te->unlink();
+                    break;
+                }
+            }
+            AoPort::exitCritical();
+
+            if (ao == NULL) {
+                break;
+            }
+            ao->post(e);
+        }
+
+        AoPort::enterCritical();
+        s_running = (s_armed != NULL);
+        const bool restart = s_running;
+        AoPort::exitCritical();
+
+        if (restart) {
+            AoPort::timerStart(s_timer);
+        }
+    }
+};
+
+#endif /* U_TIME_EVENT_HPP */
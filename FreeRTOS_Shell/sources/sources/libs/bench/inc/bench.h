@@ -0,0 +1,52 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/*
+    On-target microbenchmarks in DWT cycles, built with -DUSHELL_BENCH=ON (BENCH 1).
+
+        bench 0         every benchmark, one line each
+        bench <n>       only the n-th
+
+    Each benchmark runs BENCH_SAMPLES times from the shell task and prints the min, median
+    and max cycles, less the cost of reading the counter twice. The interrupts stay enabled:
+    the min and the median are the code, the max also has the ISRs that hit a sample.
+
+        asc2int hex / dec       asc2int() of "0x1234ABCD" / "4294967295"
+        hexlify 16B             hexlify() of 16 bytes
+        unhexlify 16B           unhexlify() of 32 hex digits
+        strtok_ex 4 tok         strtok_ex() through "bench 1 0x20 text"
+        lookup hit / miss       Microshell::FindCommand(), the parser's table lookup
+        queue round trip        xQueueSend() to an echo task of higher priority and
+                                xQueueReceive() of its answer: two switches, two copies
+        ctx switch              xTaskNotifyGive() to a task of higher priority until it runs:
+                                the give and one switch
+        irq->task               a software pended IRQ (SPI2, unused) whose handler notifies
+                                the same task, until it runs: entry, handler, switch
+        ao post->dispatch       ActiveObject::post() to the bench AO until its handler runs
+        uart_printf 32B         a 32 byte line queued to the UART (the TX ring empty before)
+        i2c lcd char            the 6 PCF8574 bytes of one character at the LCD address, EN
+                                held low: the bus time of a character, the display untouched
+
+    The names and the columns are the same on the other shells (ThreadX, Zephyr, Embassy,
+    RTIC), which have the rows their kernel has: the lines of the builds compare one to one
+    (ushell_core/tools/bench_matrix.py). bench_init() creates the echo and wake tasks, their
+    two queues and the bench AO, and enables the IRQ. Without BENCH the command only says
+    so and bench_init() is empty.
+*/
+
+#define BENCH_SAMPLES   31U     /* odd: the median is a sample */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* with the other AOs, before AoKernel::start() and the scheduler */
+void bench_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H */
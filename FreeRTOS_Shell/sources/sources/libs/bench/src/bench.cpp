@@ -0,0 +1,367 @@
+#include "bench.h"
+#include "ushell_core_printout.h"
+
+#if defined(BENCH) && (BENCH == 1)
+#include "ushell_core.h"
+#include "ushell_core_utils.h"
+#include "uart_access.h"
+#include "i2c_master.h"
+#include "hd44780_pcf8574.h"
+#include "ActiveObject.hpp"
+#include "ao_defs.hpp"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include <libopencm3/cm3/dwt.h>
+#include <libopencm3/cm3/nvic.h>
+
+#include <string.h>
+
+#define BENCH_ECHO_STACK    96U
+#define BENCH_ECHO_PRIO     3U      /* above the shell task: the send switches to it at once */
+#define BENCH_IRQ           NVIC_SPI2_IRQ   /* no SPI2 in the firmware: pended by software only */
+#define BENCH_REPLY_MS      100U
+
+#define BENCH_START()       const uint32_t u32BenchStart = DWT_CYCCNT
+#define BENCH_STOP()        (DWT_CYCCNT - u32BenchStart)
+
+typedef struct {
+    const char *pstrName;
+    bool (*pfRun)(uint32_t *pu32Cycles);    /* one sample, false if it could not be taken */
+} bench_s;
+
+static uint32_t s_au32Samples[BENCH_SAMPLES];
+static uint32_t s_u32Overhead = 0U;
+static volatile uint32_t s_u32Sink;         /* the results of the pure functions are kept */
+
+static QueueHandle_t s_hPing = NULL;
+static QueueHandle_t s_hPong = NULL;        /* the answers of the echo task and of the bench AO */
+static StaticQueue_t s_sPingBuffer;
+static StaticQueue_t s_sPongBuffer;
+static uint8_t s_au8PingStorage[sizeof(uint32_t)];
+static uint8_t s_au8PongStorage[sizeof(uint32_t)];
+static StackType_t s_axEchoStack[BENCH_ECHO_STACK];
+static StaticTask_t s_sEchoTcb;
+static StackType_t s_axWakeStack[BENCH_ECHO_STACK];
+static StaticTask_t s_sWakeTcb;
+static TaskHandle_t s_hWake = NULL;
+static volatile uint32_t s_u32WakeStamp;    /* CYCCNT of the give or of the pend */
+
+#if (AO_PORT_STATIC == 1)
+static StaticActiveObject<BENCH_AO_DEFAULTS.stackWords, BENCH_AO_DEFAULTS.queueDepth> s_benchAO;
+#else
+static ActiveObject s_benchAO;
+#endif
+
+
+// -- echo task and bench AO --------------------------------------------------
+
+static void s_echo_task(void *pvParameters)
+{
+    (void)pvParameters;
+    uint32_t u32Value;
+
+    for (;;) {
+        if (pdTRUE == xQueueReceive(s_hPing, &u32Value, portMAX_DELAY)) {
+            (void)xQueueSend(s_hPong, &u32Value, portMAX_DELAY);
+        }
+    }
+}
+
+
+/* woken by a notification of the shell task or of the bench IRQ, answers the cycles since */
+static void s_wake_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        const uint32_t u32Cycles = DWT_CYCCNT - s_u32WakeStamp;
+        (void)xQueueSend(s_hPong, &u32Cycles, 0);
+    }
+}
+
+
+extern "C" void spi2_isr(void)
+{
+    BaseType_t xWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_hWake, &xWoken);
+    portYIELD_FROM_ISR(xWoken);
+}
+
+
+/* SIG_BENCH_PING: param is the CYCCNT of the post */
+static void s_bench_dispatch(void *instance, const Event &e)
+{
+    (void)instance;
+    const uint32_t u32Cycles = DWT_CYCCNT - e.param;
+    (void)xQueueSend(s_hPong, &u32Cycles, 0);
+}
+
+
+// -- the benchmarks ----------------------------------------------------------
+
+static bool s_asc2int_hex(uint32_t *pu32Cycles)
+{
+    BIGNUM_T number = 0;
+    BENCH_START();
+    const bool bOk = asc2int("0x1234ABCD", &number);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)number;
+    return bOk;
+}
+
+
+static bool s_asc2int_dec(uint32_t *pu32Cycles)
+{
+    BIGNUM_T number = 0;
+    BENCH_START();
+    const bool bOk = asc2int("4294967295", &number);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)number;
+    return bOk;
+}
+
+
+static const uint8_t s_au8Bytes[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+
+static bool s_hexlify(uint32_t *pu32Cycles)
+{
+    char acHex[(2U * sizeof(s_au8Bytes)) + 1U];
+    BENCH_START();
+    hexlify(s_au8Bytes, sizeof(s_au8Bytes), acHex);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)acHex[0];
+    return true;
+}
+
+
+static bool s_unhexlify(uint32_t *pu32Cycles)
+{
+    uint8_t au8Bytes[sizeof(s_au8Bytes)];
+    size_t szLen = 0U;
+    BENCH_START();
+    const bool bOk = unhexlify("00112233445566778899aabbccddeeff", au8Bytes, &szLen);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = au8Bytes[0];
+    return bOk;
+}
+
+
+static bool s_strtok_ex(uint32_t *pu32Cycles)
+{
+    char acLine[] = "bench 1 0x20 text";    /* strtok_ex() writes into it, a copy per sample */
+    char *pstrSave = NULL;
+    uint32_t u32Tokens = 0U;
+    BENCH_START();
+    for (char *pstrTok = strtok_ex(acLine, " ", &pstrSave); NULL != pstrTok; pstrTok = strtok_ex(NULL, " ", &pstrSave)) {
+        u32Tokens++;
+    }
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = u32Tokens;
+    return (4U == u32Tokens);
+}
+
+
+/* the shell is already up: it is the caller */
+static bool s_lookup_hit(uint32_t *pu32Cycles)
+{
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+    BENCH_START();
+    const int iIndex = pShell->FindCommand("bench");
+    *pu32Cycles = BENCH_STOP();
+    return (iIndex >= 0);
+}
+
+
+static bool s_lookup_miss(uint32_t *pu32Cycles)
+{
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+    BENCH_START();
+    const int iIndex = pShell->FindCommand("nosuchcmd");
+    *pu32Cycles = BENCH_STOP();
+    return (uSHELL_ERR_FUNCTION_NOT_FOUND == iIndex);
+}
+
+
+static bool s_queue_round_trip(uint32_t *pu32Cycles)
+{
+    uint32_t u32Value = 0U;
+    BENCH_START();
+    (void)xQueueSend(s_hPing, &u32BenchStart, portMAX_DELAY);
+    const BaseType_t xOk = xQueueReceive(s_hPong, &u32Value, pdMS_TO_TICKS(BENCH_REPLY_MS));
+    *pu32Cycles = BENCH_STOP();
+    return (pdTRUE == xOk) && (u32Value == u32BenchStart);
+}
+
+
+/* the cycles are the wake task's, measured when it runs */
+static bool s_ctx_switch(uint32_t *pu32Cycles)
+{
+    s_u32WakeStamp = DWT_CYCCNT;
+    xTaskNotifyGive(s_hWake);
+    return (pdTRUE == xQueueReceive(s_hPong, pu32Cycles, pdMS_TO_TICKS(BENCH_REPLY_MS)));
+}
+
+
+static bool s_irq_to_task(uint32_t *pu32Cycles)
+{
+    s_u32WakeStamp = DWT_CYCCNT;
+    nvic_generate_software_interrupt(BENCH_IRQ);
+    return (pdTRUE == xQueueReceive(s_hPong, pu32Cycles, pdMS_TO_TICKS(BENCH_REPLY_MS)));
+}
+
+
+/* the cycles are the AO's, measured in its handler */
+static bool s_ao_dispatch(uint32_t *pu32Cycles)
+{
+    const Event ev = { SIG_BENCH_PING, DWT_CYCCNT };
+    if (false == s_benchAO.post(ev)) {
+        return false;
+    }
+    return (pdTRUE == xQueueReceive(s_hPong, pu32Cycles, pdMS_TO_TICKS(BENCH_REPLY_MS)));
+}
+
+
+static bool s_uart_printf(uint32_t *pu32Cycles)
+{
+    uart_flush();
+    BENCH_START();
+    uSHELL_PRINTF("\r  uart_printf sample %8u ", (unsigned)u32BenchStart);   /* 32 bytes */
+    *pu32Cycles = BENCH_STOP();
+    return true;
+}
+
+
+/* data, data|EN, data per nibble with EN cleared in every byte: the LCD ignores them */
+static bool s_i2c_lcd_char(uint32_t *pu32Cycles)
+{
+    static const uint8_t au8Char[6] = { LCD_BL | LCD_RS, LCD_BL | LCD_RS, LCD_BL | LCD_RS,
+                                        LCD_BL | LCD_RS, LCD_BL | LCD_RS, LCD_BL | LCD_RS };
+    BENCH_START();
+    const int iRet = i2c_master_write(LCD_0.i2cAddress, au8Char, sizeof(au8Char));
+    *pu32Cycles = BENCH_STOP();
+    return (I2C_MASTER_OK == iRet);
+}
+
+
+static const bench_s s_asBenches[] = {
+    { "asc2int hex",        s_asc2int_hex      },
+    { "asc2int dec",        s_asc2int_dec      },
+    { "hexlify 16B",        s_hexlify          },
+    { "unhexlify 16B",      s_unhexlify        },
+    { "strtok_ex 4 tok",    s_strtok_ex        },
+    { "lookup hit",         s_lookup_hit       },
+    { "lookup miss",        s_lookup_miss      },
+    { "queue round trip",   s_queue_round_trip },
+    { "ctx switch",         s_ctx_switch       },
+    { "irq->task",          s_irq_to_task      },
+    { "ao post->dispatch",  s_ao_dispatch      },
+    { "uart_printf 32B",    s_uart_printf      },
+    { "i2c lcd char",       s_i2c_lcd_char     },
+};
+
+#define BENCH_COUNT     (sizeof(s_asBenches) / sizeof(s_asBenches[0]))
+
+
+/* two reads of the counter back to back, taken off every sample */
+static void s_calibrate(void)
+{
+    s_u32Overhead = UINT32_MAX;
+    for (uint32_t i = 0U; i < 8U; i++) {
+        BENCH_START();
+        const uint32_t u32Cycles = BENCH_STOP();
+        if (u32Cycles < s_u32Overhead) {
+            s_u32Overhead = u32Cycles;
+        }
+    }
+}
+
+
+static void s_sort(uint32_t *pu32Values, uint32_t u32Count)
+{
+    for (uint32_t i = 1U; i < u32Count; i++) {
+        const uint32_t u32Value = pu32Values[i];
+        uint32_t j = i;
+        while ((j > 0U) && (pu32Values[j - 1U] > u32Value)) {
+            pu32Values[j] = pu32Values[j - 1U];
+            j--;
+        }
+        pu32Values[j] = u32Value;
+    }
+}
+
+
+static void s_run(uint32_t u32Index)
+{
+    const bench_s &sBench = s_asBenches[u32Index];
+
+    for (uint32_t i = 0U; i < BENCH_SAMPLES; i++) {
+        uint32_t u32Cycles = 0U;
+        if (false == sBench.pfRun(&u32Cycles)) {
+            uSHELL_PRINTF("\r%2u %-18s %8s\n", (unsigned)(u32Index + 1U), sBench.pstrName, "failed");
+            return;
+        }
+        s_au32Samples[i] = (u32Cycles > s_u32Overhead) ? (u32Cycles - s_u32Overhead) : 0U;
+    }
+    s_sort(s_au32Samples, BENCH_SAMPLES);
+
+    uSHELL_PRINTF("\r%2u %-18s %8u %8u %8u\n", (unsigned)(u32Index + 1U), sBench.pstrName,
+                  (unsigned)s_au32Samples[0], (unsigned)s_au32Samples[BENCH_SAMPLES / 2U],
+                  (unsigned)s_au32Samples[BENCH_SAMPLES - 1U]);
+}
+#endif /*defined(BENCH) && (BENCH == 1)*/
+
+
+/*--------------------------------------------------*/
+void bench_init(void)
+{
+#if defined(BENCH) && (BENCH == 1)
+    dwt_enable_cycle_counter();
+
+    s_hPing = xQueueCreateStatic(1U, sizeof(uint32_t), s_au8PingStorage, &s_sPingBuffer);
+    s_hPong = xQueueCreateStatic(1U, sizeof(uint32_t), s_au8PongStorage, &s_sPongBuffer);
+    (void)xTaskCreateStatic(s_echo_task, "BenchEcho", BENCH_ECHO_STACK, NULL, BENCH_ECHO_PRIO,
+                            s_axEchoStack, &s_sEchoTcb);
+    s_hWake = xTaskCreateStatic(s_wake_task, "BenchWake", BENCH_ECHO_STACK, NULL, BENCH_ECHO_PRIO,
+                                s_axWakeStack, &s_sWakeTcb);
+
+    /* kernel aware: the ISR gives from below configMAX_SYSCALL_INTERRUPT_PRIORITY */
+    nvic_set_priority(BENCH_IRQ, configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    nvic_enable_irq(BENCH_IRQ);
+
+    s_benchAO.init(BENCH_AO_DEFAULTS.name, &s_bench_dispatch, NULL, BENCH_AO_DEFAULTS.priority,
+                   BENCH_AO_DEFAULTS.stackWords, BENCH_AO_DEFAULTS.queueDepth);
+#endif /*defined(BENCH) && (BENCH == 1)*/
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* bench 0 runs every benchmark, bench n only the n-th */
+extern "C" int bench(uint32_t u32Index)
+{
+#if defined(BENCH) && (BENCH == 1)
+    if (u32Index > BENCH_COUNT) {
+        uSHELL_PRINTF("bench: 1..%u, 0 for all\n", (unsigned)BENCH_COUNT);
+        return -1;
+    }
+
+    s_calibrate();
+    uSHELL_PRINTF("%2s %-18s %8s %8s %8s  (cycles at %u MHz, %u samples)\n", "#", "bench",
+                  "min", "median", "max", (unsigned)(configCPU_CLOCK_HZ / 1000000UL), (unsigned)BENCH_SAMPLES);
+    for (uint32_t i = 0U; i < BENCH_COUNT; i++) {
+        if ((0U == u32Index) || ((u32Index - 1U) == i)) {
+            s_run(i);
+        }
+    }
+#else
+    (void)u32Index;
+    uSHELL_PRINTF("bench: built with BENCH 0\n");
+#endif /*defined(BENCH) && (BENCH == 1)*/
+    return 0;
+}
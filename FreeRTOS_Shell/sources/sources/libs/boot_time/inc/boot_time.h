@@ -0,0 +1,61 @@
+#ifndef BOOT_TIME_H
+#define BOOT_TIME_H
+
+#include <stdint.h>
+
+/*
+    Boot stages timed from the start of main() with the DWT cycle counter.
+
+        int main(void)
+        {
+            boot_time_init();                       // first, the clock is still the reset one
+            setup_clock();
+            boot_time_mark(BOOT_TIME_CLOCK);
+            ...
+        }
+
+    Every interval is converted with the AHB frequency seen at its start, so the
+    switch to the PLL lands in the interval which configures it. The reset handler
+    (.data copy, .bss clear, constructors, libs/startup) is before main(): it starts the
+    cycle counter, boot_time_init() takes its count as the time of the reset handler.
+    A stage is stamped once, the repeated marks are ignored.
+
+    The shell command boottime prints the stages and the time to the prompt
+    against BOOT_TIME_PROMPT_BUDGET_US.
+*/
+
+#define BOOT_TIME_PROMPT_BUDGET_US  50000UL
+
+typedef enum {
+    BOOT_TIME_MAIN,         /* boot_time_init() */
+    BOOT_TIME_CLOCK,        /* PLL running */
+    BOOT_TIME_HW,           /* GPIO, UART, profilers */
+    BOOT_TIME_AO,           /* active objects created, their peripherals come up in the background */
+    BOOT_TIME_SCHEDULER,    /* vTaskStartScheduler() */
+    BOOT_TIME_PROMPT,       /* the shell task prints its prompt */
+    BOOT_TIME_LCD,          /* the display answered */
+    BOOT_TIME_LATE,         /* the .init_late entries ran (startup_run_late()) */
+    BOOT_TIME_STAGES
+} boot_time_stage_e;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* enables the cycle counter and stamps BOOT_TIME_MAIN */
+void boot_time_init(void);
+
+/* stamps eStage, from any task (not from an ISR) */
+void boot_time_mark(boot_time_stage_e eStage);
+
+/* microseconds from main() to eStage, 0 while not reached */
+uint32_t boot_time_us(boot_time_stage_e eStage);
+
+/* microseconds of the reset handler, before main() */
+uint32_t boot_time_reset_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_TIME_H */
@@ -0,0 +1,129 @@
+#include "boot_time.h"
+#include "ushell_core_printout.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if defined(USE_POSIX_SIM)
+#include <time.h>
+
+/* the POSIX simulation: the ns of the monotonic clock, a 1 GHz core without a reset handler */
+static uint32_t boot_time_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+#define BOOT_TIME_HZ        (1000000000UL)
+#else
+#include <libopencm3/cm3/dwt.h>
+#include <libopencm3/stm32/rcc.h>
+
+#define boot_time_cycles()  DWT_CYCCNT
+#define BOOT_TIME_HZ        rcc_ahb_frequency
+#endif
+
+static const char *const s_apstrNames[BOOT_TIME_STAGES] = {
+    "main", "clock", "hw", "ao", "scheduler", "prompt", "lcd", "late"
+};
+
+static uint32_t s_au32Us[BOOT_TIME_STAGES];
+static uint32_t s_u32Reached = 0U;      /* one bit per stage */
+
+/* the last stamp: its cycle count and the frequency the time after it runs at */
+static uint32_t s_u32LastCycles = 0U;
+static uint32_t s_u32LastHz     = 0U;
+static uint32_t s_u32LastUs     = 0U;
+
+static uint32_t s_u32ResetUs    = 0U;   /* the reset handler, on the reset clock */
+
+
+extern "C" void boot_time_init(void)
+{
+#if !defined(USE_POSIX_SIM)
+    /* counting since the reset handler started it (libs/startup), the clock is still the reset one */
+    if (0U != (DWT_CTRL & DWT_CTRL_CYCCNTENA)) {
+        s_u32ResetUs = DWT_CYCCNT / (rcc_ahb_frequency / 1000000UL);
+    }
+    dwt_enable_cycle_counter();
+#endif
+
+    s_u32LastCycles = boot_time_cycles();
+    s_u32LastHz     = BOOT_TIME_HZ;
+    s_u32LastUs     = 0U;
+    s_au32Us[BOOT_TIME_MAIN] = 0U;
+    s_u32Reached = (1UL << BOOT_TIME_MAIN);
+}
+
+
+extern "C" void boot_time_mark(boot_time_stage_e eStage)
+{
+    taskENTER_CRITICAL();
+    if (0U == (s_u32Reached & (1UL << eStage))) {
+        const uint32_t u32Now = boot_time_cycles();
+        const uint32_t u32Mhz = s_u32LastHz / 1000000UL;
+
+        s_u32LastUs    += (u32Now - s_u32LastCycles) / ((0U != u32Mhz) ? u32Mhz : 1U);
+        s_u32LastCycles = u32Now;
+        s_u32LastHz     = BOOT_TIME_HZ;
+
+        s_au32Us[eStage] = s_u32LastUs;
+        s_u32Reached    |= (1UL << eStage);
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+extern "C" uint32_t boot_time_us(boot_time_stage_e eStage)
+{
+    return (0U != (s_u32Reached & (1UL << eStage))) ? s_au32Us[eStage] : 0U;
+}
+
+
+extern "C" uint32_t boot_time_reset_us(void)
+{
+    return s_u32ResetUs;
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* boottime prints the stages in the order they were reached */
+extern "C" int boottime(void)
+{
+    uSHELL_PRINTF("%-10s %9s %9s  (us from main)\n", "stage", "at", "+");
+    uSHELL_PRINTF("%-10s %9s %9u  (.data, .bss, constructors)\n", "reset", "", (unsigned)s_u32ResetUs);
+
+    uint32_t u32Printed = 0U;
+    uint32_t u32Prev    = 0U;
+
+    for (uint32_t n = 0U; n < BOOT_TIME_STAGES; n++) {
+        uint32_t u32Next = BOOT_TIME_STAGES;
+
+        for (uint32_t i = 0U; i < BOOT_TIME_STAGES; i++) {
+            const uint32_t u32Bit = (1UL << i);
+            if ((0U != (s_u32Reached & u32Bit)) && (0U == (u32Printed & u32Bit)) &&
+                ((BOOT_TIME_STAGES == u32Next) || (s_au32Us[i] < s_au32Us[u32Next]))) {
+                u32Next = i;
+            }
+        }
+        if (BOOT_TIME_STAGES == u32Next) {
+            break;
+        }
+        u32Printed |= (1UL << u32Next);
+        uSHELL_PRINTF("%-10s %9u %9u\n", s_apstrNames[u32Next],
+                      (unsigned)s_au32Us[u32Next], (unsigned)(s_au32Us[u32Next] - u32Prev));
+        u32Prev = s_au32Us[u32Next];
+    }
+
+    for (uint32_t i = 0U; i < BOOT_TIME_STAGES; i++) {
+        if (0U == (s_u32Reached & (1UL << i))) {
+            uSHELL_PRINTF("%-10s %9s\n", s_apstrNames[i], "pending");
+        }
+    }
+
+    const uint32_t u32Prompt = boot_time_us(BOOT_TIME_PROMPT);
+    uSHELL_PRINTF("time to prompt: %u us, budget %u us: %s\n", (unsigned)u32Prompt,
+                  (unsigned)BOOT_TIME_PROMPT_BUDGET_US, (u32Prompt <= BOOT_TIME_PROMPT_BUDGET_US) ? "OK" : "OVER");
+    return 0;
+}
@@ -13,6 +13,9 @@ public:
     static void      registerButton(uint8_t lineNumber, ButtonAO *ao);
     static ButtonAO *find(uint8_t lineNumber);
 
+    // ISR fast path: lineNumber is a pending EXTI bit, below MAX_EXTI_LINES
+    static ButtonAO *at(uint8_t lineNumber) { return s_slots[lineNumber]; }
+
 private:
     static ButtonAO *s_slots[MAX_EXTI_LINES];
 };
@@ -0,0 +1,50 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+    CRC32 and CRC16 of memory, for the framed transfers, the flash records and the shell.
+
+        crc = checksum_crc32(0, pu8Data, szLen);                  binascii.crc32(data)
+        crc = checksum_crc32(crc, pu8More, szMore);               binascii.crc32(more, crc)
+        crc16 = checksum_crc16(CHECKSUM_CRC16_INIT, pu8Data, szLen);  binascii.crc_hqx(data, 0xFFFF)
+
+    CRC32 is the one of IEEE 802.3 / zlib (reflected 0xEDB88320), CRC16 the CCITT one
+    (0x1021, MSB first, no final xor: CRC-16/CCITT-FALSE started from 0xFFFF).
+
+    On the F103 and the F411 checksum_crc32() runs the words through the CRC unit. The unit
+    computes the MPEG-2 variant (0x04C11DB7, MSB first, from 0xFFFFFFFF): each word goes in
+    bit reversed (RBIT) and the register comes out bit reversed, which is the reflected CRC.
+    The unit can not be loaded, so a running CRC is put in with one word computed backwards
+    from it. That happens every CHECKSUM_HW_WORDS words: the unit is held in a critical
+    section only that long, any task or ISR may use the API. The bytes after the last word
+    go through the table. A word costs ~4 cycles against ~20 for the table.
+
+    checksum_crc32_sw() is the table on any part (1K of flash), with the same results; built
+    with -DUSHELL_CRC_SOFTWARE=ON (CHECKSUM_SOFTWARE) checksum_crc32() is that as well. The
+    F1 / F4 CRC unit has no CRC16, it is always the table (512 bytes).
+*/
+
+#define CHECKSUM_CRC16_INIT     0xFFFFU
+#define CHECKSUM_HW_WORDS       64U     /* words in the unit per critical section (~300 cycles) */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CRC32 continued from u32Crc (0 to start), the CRC unit when there is one */
+uint32_t checksum_crc32(uint32_t u32Crc, const uint8_t *pu8Data, size_t szLen);
+
+/* the same by the table */
+uint32_t checksum_crc32_sw(uint32_t u32Crc, const uint8_t *pu8Data, size_t szLen);
+
+/* CRC16 continued from u16Crc (CHECKSUM_CRC16_INIT to start) */
+uint16_t checksum_crc16(uint16_t u16Crc, const uint8_t *pu8Data, size_t szLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHECKSUM_H */
@@ -0,0 +1,135 @@
+#include "checksum.h"
+
+#include <string.h>
+
+#if (defined(STM32F1) || defined(STM32F4)) && !defined(CHECKSUM_SOFTWARE)
+#define CHECKSUM_HW
+#include <libopencm3/stm32/rcc.h>
+#include <libopencm3/stm32/crc.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#endif /* (defined(STM32F1) || defined(STM32F4)) && !defined(CHECKSUM_SOFTWARE) */
+
+#define CHECKSUM_CRC32_POLY         0xEDB88320UL    /* reflected */
+#define CHECKSUM_CRC32_POLY_MSB     0x04C11DB7UL    /* the CRC unit */
+#define CHECKSUM_CRC16_POLY         0x1021U
+
+typedef struct {
+    uint32_t vu32Crc32[256];
+    uint16_t vu16Crc16[256];
+} checksumTables_s;
+
+static constexpr checksumTables_s checksum_build_tables(void) {
+    checksumTables_s sTables{};
+    for (uint32_t i = 0U; i < 256U; ++i) {
+        uint32_t u32Crc = i;
+        uint16_t u16Crc = (uint16_t)(i << 8);
+        for (int iBit = 0; iBit < 8; ++iBit) {
+            u32Crc = (0U != (u32Crc & 1U)) ? ((u32Crc >> 1) ^ CHECKSUM_CRC32_POLY) : (u32Crc >> 1);
+            u16Crc = (0U != (u16Crc & 0x8000U)) ? (uint16_t)((u16Crc << 1) ^ CHECKSUM_CRC16_POLY) : (uint16_t)(u16Crc << 1);
+        }
+        sTables.vu32Crc32[i] = u32Crc;
+        sTables.vu16Crc16[i] = u16Crc;
+    }
+    return sTables;
+}
+
+static constexpr checksumTables_s s_sTables = checksum_build_tables();
+
+
+/*--------------------------------------------------*/
+/* the reflected register, without the inversions at both ends */
+static uint32_t s_crc32_table(uint32_t u32Reg, const uint8_t *pu8Data, size_t szLen)
+{
+    while (szLen--) {
+        u32Reg = (u32Reg >> 8) ^ s_sTables.vu32Crc32[(u32Reg ^ *pu8Data++) & 0xFFU];
+    }
+    return u32Reg;
+}
+
+#if defined(CHECKSUM_HW)
+static bool s_bClock = false;
+
+/*--------------------------------------------------*/
+static inline uint32_t s_rbit(uint32_t u32Value)
+{
+    uint32_t u32Result;
+    __asm__ ("rbit %0, %1" : "=r" (u32Result) : "r" (u32Value));
+    return u32Result;
+}
+
+/*--------------------------------------------------*/
+/* the word which takes the unit from its reset value (0xFFFFFFFF) to u32State: 32 steps of
+   the shift register run backwards (the polynomial has its x^0 term, a step is invertible) */
+static uint32_t s_unit_preload(uint32_t u32State)
+{
+    for (int iBit = 0; iBit < 32; ++iBit) {
+        u32State = (0U != (u32State & 1U)) ? (((u32State ^ CHECKSUM_CRC32_POLY_MSB) >> 1) | 0x80000000UL) : (u32State >> 1);
+    }
+    return u32State ^ 0xFFFFFFFFUL;
+}
+
+/*--------------------------------------------------*/
+/* szWords words through the unit, the register in and out reflected (the unit's bit reversed) */
+static uint32_t s_crc32_unit(uint32_t u32Reg, const uint8_t *pu8Data, size_t szWords)
+{
+    if (false == s_bClock) {
+        rcc_periph_clock_enable(RCC_CRC);
+        s_bClock = true;
+    }
+
+    while (0U != szWords) {
+        const size_t szRun = (szWords < CHECKSUM_HW_WORDS) ? szWords : CHECKSUM_HW_WORDS;
+        const uint32_t u32State = s_rbit(u32Reg);
+        const uint32_t u32Preload = s_unit_preload(u32State);
+
+        const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+        crc_reset();
+        if (0xFFFFFFFFUL != u32State) {
+            CRC_DR = u32Preload;
+        }
+        for (size_t i = 0U; i < szRun; ++i, pu8Data += 4) {
+            uint32_t u32Word;
+            memcpy(&u32Word, pu8Data, sizeof(u32Word));
+            CRC_DR = s_rbit(u32Word);
+        }
+        u32Reg = s_rbit(CRC_DR);
+        taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+
+        szWords -= szRun;
+    }
+    return u32Reg;
+}
+#endif /* defined(CHECKSUM_HW) */
+
+
+/* ================================================
+            public interfaces definition
+==================================================*/
+
+/*--------------------------------------------------*/
+uint32_t checksum_crc32(uint32_t u32Crc, const uint8_t *pu8Data, size_t szLen)
+{
+#if defined(CHECKSUM_HW)
+    const size_t szWords = szLen / 4U;
+    uint32_t u32Reg = s_crc32_unit(~u32Crc, pu8Data, szWords);
+    return ~s_crc32_table(u32Reg, &pu8Data[szWords * 4U], szLen % 4U);
+#else
+    return ~s_crc32_table(~u32Crc, pu8Data, szLen);
+#endif /* defined(CHECKSUM_HW) */
+}
+
+/*--------------------------------------------------*/
+uint32_t checksum_crc32_sw(uint32_t u32Crc, const uint8_t *pu8Data, size_t szLen)
+{
+    return ~s_crc32_table(~u32Crc, pu8Data, szLen);
+}
+
+/*--------------------------------------------------*/
+uint16_t checksum_crc16(uint16_t u16Crc, const uint8_t *pu8Data, size_t szLen)
+{
+    while (szLen--) {
+        u16Crc = (uint16_t)((u16Crc << 8) ^ s_sTables.vu16Crc16[((u16Crc >> 8) ^ *pu8Data++) & 0xFFU]);
+    }
+    return u16Crc;
+}
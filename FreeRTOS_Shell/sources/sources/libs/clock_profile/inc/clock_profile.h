@@ -0,0 +1,63 @@
+#ifndef CLOCK_PROFILE_H
+#define CLOCK_PROFILE_H
+
+#include <stdint.h>
+#include <libopencm3/stm32/rcc.h>
+
+/*
+    System clock presets, switched at run time from a task (the shell command clkprof).
+
+                        STM32F103 (8 MHz HSE)       STM32F411 (8 MHz HSE)
+        PERF            72 MHz, 2 WS                100 MHz, 3 WS (96 MHz with USB CDC)
+        BALANCED        48 MHz, 1 WS                84 MHz, 2 WS
+        LOW_POWER       16 MHz, 0 WS                16 MHz, 0 WS, VOS scale 3 (18 MHz with USB CDC)
+
+        int main(void)
+        {
+            clock_profile_setup(CLOCK_PROFILE_PERF);                  instead of rcc_clock_setup_pll()
+            ...
+            power_mgr_init(clock_profile_scale(CLOCK_PROFILE_PERF));
+        }
+
+        clock_profile_set(CLOCK_PROFILE_LOW_POWER);                   idle for a while
+        clock_profile_set(CLOCK_PROFILE_PERF);                        a burst of work
+
+    A switch waits for the UART output and the I2C transfer running, moves the core to the HSI
+    and relocks the PLL (rcc_clock_setup_pll() orders the flash wait states and the voltage
+    scale around the frequency change), then everything derived from the clock is programmed
+    again: the SysTick reload (the kernel tick stays at configTICK_RATE_HZ, configCPU_CLOCK_HZ
+    reads rcc_ahb_frequency), the USART BRR at the current baud rate, the I2C CCR and TRISE,
+    the epoch of mono_time and the configuration power_mgr restores after STOP. The kernel tick stops for the PLL lock
+    (~0.2 ms, with the critical section held); bytes received meanwhile may be lost.
+
+    With the USB CDC console the 48 MHz USB clock comes from the same PLL: the profile is
+    chosen at boot only, clock_profile_set() refuses to stop the PLL under the host.
+*/
+
+typedef enum {
+    CLOCK_PROFILE_PERF,         /* maximum core clock */
+    CLOCK_PROFILE_BALANCED,     /* one wait state less */
+    CLOCK_PROFILE_LOW_POWER,    /* 16 MHz, idle */
+    CLOCK_PROFILES
+} clock_profile_e;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the clock only, before the peripherals and the scheduler */
+void clock_profile_setup(clock_profile_e eProfile);
+
+/* from a task: 0, or -1 if eProfile is out of range or the switch is not possible */
+int clock_profile_set(clock_profile_e eProfile);
+
+clock_profile_e clock_profile_get(void);
+
+/* the libopencm3 configuration of a profile (power_mgr_init()) */
+const struct rcc_clock_scale *clock_profile_scale(clock_profile_e eProfile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_PROFILE_H */
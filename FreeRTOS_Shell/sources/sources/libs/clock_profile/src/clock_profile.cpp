@@ -0,0 +1,216 @@
+#include "clock_profile.h"
+#include "uart_access.h"
+#include "i2c_master.h"
+#include "power_mgr.h"
+#include "adc_acq.h"
+#include "mono_time.h"
+#include "ushell_core_printout.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <libopencm3/stm32/flash.h>
+#include <libopencm3/cm3/systick.h>
+
+static const char *const s_apstrNames[CLOCK_PROFILES] = {
+    "perf", "balanced", "low power"
+};
+
+static struct rcc_clock_scale s_asScale[CLOCK_PROFILES];
+static bool s_bBuilt = false;
+static clock_profile_e s_eProfile = CLOCK_PROFILES;    /* none before clock_profile_setup() */
+
+
+/* the presets, from the libopencm3 table of the board's 8 MHz HSE */
+static void s_build(void)
+{
+    if (true == s_bBuilt) {
+        return;
+    }
+
+#if defined(STM32F1)
+    const struct rcc_clock_scale &sBase = rcc_hse_configs[RCC_CLOCK_HSE8_72MHZ];
+
+    s_asScale[CLOCK_PROFILE_PERF] = sBase;
+
+    struct rcc_clock_scale &sBalanced = s_asScale[CLOCK_PROFILE_BALANCED];
+    sBalanced = sBase;
+    sBalanced.pll_mul          = RCC_CFGR_PLLMUL_PLL_CLK_MUL6;
+    sBalanced.flash_waitstates = FLASH_ACR_LATENCY_1WS;
+    sBalanced.ahb_frequency    = 48000000U;
+    sBalanced.apb1_frequency   = 24000000U;
+    sBalanced.apb2_frequency   = 48000000U;
+
+    struct rcc_clock_scale &sLow = s_asScale[CLOCK_PROFILE_LOW_POWER];
+    sLow = sBase;
+    sLow.pll_mul          = RCC_CFGR_PLLMUL_PLL_CLK_MUL2;
+    sLow.ppre1            = RCC_CFGR_PPRE_NODIV;
+    sLow.flash_waitstates = FLASH_ACR_LATENCY_0WS;
+    sLow.ahb_frequency    = 16000000U;
+    sLow.apb1_frequency   = 16000000U;
+    sLow.apb2_frequency   = 16000000U;
+#else
+    /* VCO input 1 MHz (PLLM 8); with USB CDC PLLQ keeps the 48 MHz of the OTG_FS clock */
+    const struct rcc_clock_scale &sBase = rcc_hse_8mhz_3v3[RCC_CLOCK_3V3_84MHZ];
+
+    struct rcc_clock_scale &sPerf = s_asScale[CLOCK_PROFILE_PERF];
+    sPerf = sBase;
+#if defined(UART_ACCESS_USB_CDC)
+    sPerf.plln           = 384U;            /* 96 MHz, USB 384 / 8 */
+    sPerf.pllq           = 8U;
+    sPerf.ahb_frequency  = 96000000U;
+    sPerf.apb1_frequency = 48000000U;
+    sPerf.apb2_frequency = 96000000U;
+#else
+    sPerf.plln           = 400U;            /* 100 MHz */
+    sPerf.pllq           = 9U;
+    sPerf.ahb_frequency  = 100000000U;
+    sPerf.apb1_frequency = 50000000U;
+    sPerf.apb2_frequency = 100000000U;
+#endif /*defined(UART_ACCESS_USB_CDC)*/
+    sPerf.pllp           = 4U;
+    sPerf.flash_config   = FLASH_ACR_DCEN | FLASH_ACR_ICEN | FLASH_ACR_LATENCY_3WS;
+
+    s_asScale[CLOCK_PROFILE_BALANCED] = sBase;
+
+    struct rcc_clock_scale &sLow = s_asScale[CLOCK_PROFILE_LOW_POWER];
+    sLow = sBase;
+#if defined(UART_ACCESS_USB_CDC)
+    sLow.plln           = 144U;             /* 18 MHz, USB 144 / 3 */
+    sLow.pllq           = 3U;
+    sLow.ahb_frequency  = 18000000U;
+    sLow.apb1_frequency = 18000000U;
+    sLow.apb2_frequency = 18000000U;
+#else
+    sLow.plln           = 128U;             /* 16 MHz */
+    sLow.pllq           = 8U;
+    sLow.ahb_frequency  = 16000000U;
+    sLow.apb1_frequency = 16000000U;
+    sLow.apb2_frequency = 16000000U;
+#endif /*defined(UART_ACCESS_USB_CDC)*/
+    sLow.pllp           = 8U;
+    sLow.ppre1          = RCC_CFGR_PPRE_NODIV;
+    sLow.voltage_scale  = PWR_SCALE3;       /* up to 64 MHz */
+    sLow.flash_config   = FLASH_ACR_DCEN | FLASH_ACR_ICEN | FLASH_ACR_LATENCY_0WS;
+#endif /*defined(STM32F1)*/
+
+    s_bBuilt = true;
+}
+
+
+/* the core on the HSI and the PLL stopped, it only takes a new configuration while off */
+static void s_leave_pll(void)
+{
+    rcc_osc_on(RCC_HSI);
+    rcc_wait_for_osc_ready(RCC_HSI);
+#if defined(STM32F1)
+    rcc_set_sysclk_source(RCC_CFGR_SW_SYSCLKSEL_HSICLK);
+#else
+    rcc_set_sysclk_source(RCC_CFGR_SW_HSI);
+#endif /*defined(STM32F1)*/
+    rcc_osc_off(RCC_PLL);
+}
+
+
+static void s_apply(clock_profile_e eProfile)
+{
+    s_leave_pll();
+    rcc_clock_setup_pll(&s_asScale[eProfile]);
+#if defined(STM32F4)
+    flash_prefetch_enable();    /* the ART caches come with the configuration, the prefetch does not */
+#endif /*defined(STM32F4)*/
+    mono_time_rebase(0U);       /* the cycles from here on at the new rate */
+    s_eProfile = eProfile;
+}
+
+
+/*--------------------------------------------------*/
+void clock_profile_setup(clock_profile_e eProfile)
+{
+    if (eProfile >= CLOCK_PROFILES) {
+        eProfile = CLOCK_PROFILE_PERF;
+    }
+    s_build();
+    s_apply(eProfile);
+}
+
+
+/*--------------------------------------------------*/
+int clock_profile_set(clock_profile_e eProfile)
+{
+    if ((eProfile >= CLOCK_PROFILES) || (CLOCK_PROFILES == s_eProfile)) {
+        return -1;
+    }
+    if (eProfile == s_eProfile) {
+        return 0;
+    }
+#if defined(UART_ACCESS_USB_CDC)
+    return -1;
+#else
+    const uint32_t u32Baud = uart_get_baudrate();
+
+    uart_flush();
+    i2c_master_suspend();
+
+    /* the tick is not counted meanwhile: the kernel sees the switch as one late tick */
+    taskENTER_CRITICAL();
+    s_apply(eProfile);
+    systick_set_reload((rcc_ahb_frequency / configTICK_RATE_HZ) - 1U);
+    STK_CVR = 0U;
+    taskEXIT_CRITICAL();
+
+    power_mgr_set_clock(&s_asScale[eProfile]);
+    i2c_master_resume();
+    adc_acq_clock_changed();                /* TIM3 from the new APB1 clock */
+    if (0U != u32Baud) {
+        (void)uart_set_baudrate(u32Baud);   /* BRR from the new APB2 clock */
+    }
+    return 0;
+#endif /*defined(UART_ACCESS_USB_CDC)*/
+}
+
+
+/*--------------------------------------------------*/
+clock_profile_e clock_profile_get(void)
+{
+    return s_eProfile;
+}
+
+
+/*--------------------------------------------------*/
+const struct rcc_clock_scale *clock_profile_scale(clock_profile_e eProfile)
+{
+    if (eProfile >= CLOCK_PROFILES) {
+        return nullptr;
+    }
+    s_build();
+    return &s_asScale[eProfile];
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* clkprof 0 lists the profiles, 1..3 switches to one of them */
+extern "C" int clkprof(uint32_t u32Profile)
+{
+    if (0U == u32Profile) {
+        s_build();
+        uSHELL_PRINTF("  %-10s %5s %5s %5s  (MHz)\n", "profile", "core", "apb1", "apb2");
+        for (uint32_t i = 0U; i < CLOCK_PROFILES; i++) {
+            const struct rcc_clock_scale &sScale = s_asScale[i];
+            uSHELL_PRINTF("%u %-10s %5u %5u %5u%s\n", (unsigned)(i + 1U), s_apstrNames[i],
+                          (unsigned)(sScale.ahb_frequency  / 1000000U),
+                          (unsigned)(sScale.apb1_frequency / 1000000U),
+                          (unsigned)(sScale.apb2_frequency / 1000000U),
+                          (i == (uint32_t)s_eProfile) ? "  *" : "");
+        }
+        return 0;
+    }
+
+    if ((u32Profile > CLOCK_PROFILES) || (0 != clock_profile_set((clock_profile_e)(u32Profile - 1U)))) {
+        uSHELL_PRINTF("clkprof: profile %u not available\n", (unsigned)u32Profile);
+        return -1;
+    }
+    uSHELL_PRINTF("clkprof: %s, %u MHz\n", s_apstrNames[s_eProfile], (unsigned)(rcc_ahb_frequency / 1000000U));
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef CMD_SCHED_H
+#define CMD_SCHED_H
+
+#include <stdint.h>
+
+/*
+    Periodic shell commands: a command line parsed once and run again every N ms on target,
+    the link carries its output only instead of a command and a parse per poll.
+
+        every 500 "adc 0 0"     run adc 0 0 every 500 ms, in the first free slot
+        sched 0                 the slots: period, runs, overruns, last result, line
+        sched <n>               stop the n-th
+
+    every parses the line with Microshell::Prepare() into the slot (the line is kept with
+    it, its strings point there) and starts an auto reload software timer of its own. The
+    timer callback runs in the timer service task and only sets the bit of its slot in the
+    notification of the scheduler task, which calls Microshell::RunPrepared(): a command
+    may take its time or block without holding up the other timers. A period which comes
+    while the last run has not started yet is an overrun (counted, the run is not queued
+    twice). Each run is framed by two tagged lines for the host:
+
+        @<slot> <run>
+        <the output of the command>
+        @<slot> => <result>
+
+    The scheduler task has the priority of the shell and prints from outside the console
+    task: its lines go out whole, above the prompt (uart_access.h). The commands run
+    while the shell takes other lines, so the ones to poll with are those which read a
+    state (adc 0 0, ao 0, sysinfo); a command which reads the console itself (adc 1, mwrite)
+    is not for a slot. No stats and no scratch arena for the prepared runs
+    (Microshell::RunPrepared()).
+*/
+
+#define CMD_SCHED_SLOTS         3U
+#define CMD_SCHED_MIN_MS        10U     /* the shortest period */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the scheduler task and the timers: an INIT_LATE entry (startup.h), once the shell is up */
+void cmd_sched_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMD_SCHED_H */
@@ -0,0 +1,164 @@
+#include "cmd_sched.h"
+#include "ushell_core.h"
+#include "ushell_core_printout.h"
+#include "startup.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include <string.h>
+
+#define CMD_SCHED_STACK     384U
+#define CMD_SCHED_PRIO      1U      /* the shell's */
+
+typedef struct {
+    preparedCmd_s   sCmd;           /* the line and its parse */
+    TimerHandle_t   hTimer;
+    StaticTimer_t   sTimerBuffer;
+    uint32_t        u32PeriodMs;    /* 0: free */
+    uint32_t        u32Runs;
+    uint32_t        u32Overruns;    /* periods while the last run waited for the task */
+    int             iLastResult;
+} cmd_sched_slot_s;
+
+static cmd_sched_slot_s s_asSlots[CMD_SCHED_SLOTS];
+
+static TaskHandle_t s_hTask = NULL;
+static StackType_t s_axStack[CMD_SCHED_STACK];
+static StaticTask_t s_sTcb;
+
+
+/*--------------------------------------------------*/
+/* the parse left a NUL after each token of the line, they are printed with a space */
+static void s_print_line(const preparedCmd_s *psCmd)
+{
+    size_t szEnd = sizeof(psCmd->vstrLine);
+    while ((szEnd > 0U) && ('\0' == psCmd->vstrLine[szEnd - 1U])) {
+        szEnd--;
+    }
+    for (size_t i = 0U; i < szEnd; i += strlen(&psCmd->vstrLine[i]) + 1U) {
+        if ('\0' != psCmd->vstrLine[i]) {
+            uSHELL_PRINTF("%s ", &psCmd->vstrLine[i]);
+        }
+    }
+    uSHELL_PRINTF("\n");
+}
+
+/*--------------------------------------------------*/
+/* timer service task: the bit of the slot, the run is the scheduler task's */
+static void s_timer_cb(TimerHandle_t hTimer)
+{
+    const uint32_t u32Slot = (uint32_t)(uintptr_t)pvTimerGetTimerID(hTimer);
+    uint32_t u32Pending = 0U;
+
+    (void)xTaskNotifyAndQuery(s_hTask, 1UL << u32Slot, eSetBits, &u32Pending);
+    if (0U != (u32Pending & (1UL << u32Slot))) {
+        s_asSlots[u32Slot].u32Overruns++;
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_task(void *pvParameters)
+{
+    (void)pvParameters;
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+
+    for (;;) {
+        uint32_t u32Bits = 0U;
+        (void)xTaskNotifyWait(0U, UINT32_MAX, &u32Bits, portMAX_DELAY);
+
+        for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+            cmd_sched_slot_s *psSlot = &s_asSlots[i];
+
+            /* stopped between the period and the run */
+            if ((0U == (u32Bits & (1UL << i))) || (0U == psSlot->u32PeriodMs)) {
+                continue;
+            }
+            psSlot->u32Runs++;
+            uSHELL_PRINTF("\r@%u %u\n", (unsigned)(i + 1U), (unsigned)psSlot->u32Runs);
+            psSlot->iLastResult = pShell->RunPrepared(&psSlot->sCmd);
+            uSHELL_PRINTF("\r@%u => %d\n", (unsigned)(i + 1U), psSlot->iLastResult);
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+void cmd_sched_init(void)
+{
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        /* the period is set at the start, pdMS_TO_TICKS(CMD_SCHED_MIN_MS) until then */
+        s_asSlots[i].hTimer = xTimerCreateStatic("Sched", pdMS_TO_TICKS(CMD_SCHED_MIN_MS), pdTRUE,
+                                                 (void *)(uintptr_t)i, s_timer_cb, &s_asSlots[i].sTimerBuffer);
+    }
+    s_hTask = xTaskCreateStatic(s_task, "Sched", CMD_SCHED_STACK, NULL, CMD_SCHED_PRIO, s_axStack, &s_sTcb);
+}
+INIT_LATE(cmd_sched_init);
+
+
+// -- shell commands ----------------------------------------------------------
+
+/* every <ms> "<command>": the slot taken, or the parse error of the line */
+extern "C" int every(uint32_t u32PeriodMs, char *pstrCommand)
+{
+    if (NULL == s_hTask) {
+        uSHELL_PRINTF("every: not started yet (the late init)\n");
+        return -1;
+    }
+    if (u32PeriodMs < CMD_SCHED_MIN_MS) {
+        uSHELL_PRINTF("every: %u ms at least\n", (unsigned)CMD_SCHED_MIN_MS);
+        return -1;
+    }
+
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        cmd_sched_slot_s *psSlot = &s_asSlots[i];
+        if (0U != psSlot->u32PeriodMs) {
+            continue;
+        }
+
+        const int iRetVal = Microshell::getShellPtr(NULL, NULL)->Prepare(pstrCommand, &psSlot->sCmd);
+        if (uSHELL_ERR_OK != iRetVal) {
+            uSHELL_PRINTF("every: \"%s\" does not parse (%d)\n", pstrCommand, iRetVal);
+            return iRetVal;
+        }
+        psSlot->u32Runs     = 0U;
+        psSlot->u32Overruns = 0U;
+        psSlot->iLastResult = 0;
+        psSlot->u32PeriodMs = u32PeriodMs;
+        (void)xTimerChangePeriod(psSlot->hTimer, pdMS_TO_TICKS(u32PeriodMs), portMAX_DELAY);   /* and starts it */
+        uSHELL_PRINTF("every: slot %u, each %u ms: ", (unsigned)(i + 1U), (unsigned)u32PeriodMs);
+        s_print_line(&psSlot->sCmd);
+        return (int)(i + 1U);
+    }
+    uSHELL_PRINTF("every: the %u slots are taken (sched <n> stops one)\n", (unsigned)CMD_SCHED_SLOTS);
+    return -1;
+}
+
+/* sched 0 lists the slots, sched n stops the n-th */
+extern "C" int sched(uint32_t u32Slot)
+{
+    if (u32Slot > CMD_SCHED_SLOTS) {
+        uSHELL_PRINTF("sched: 1..%u, 0 for the list\n", (unsigned)CMD_SCHED_SLOTS);
+        return -1;
+    }
+
+    if (0U != u32Slot) {
+        cmd_sched_slot_s *psSlot = &s_asSlots[u32Slot - 1U];
+        if (NULL != psSlot->hTimer) {
+            (void)xTimerStop(psSlot->hTimer, portMAX_DELAY);
+        }
+        psSlot->u32PeriodMs = 0U;
+        return 0;
+    }
+
+    uSHELL_PRINTF("%2s %8s %8s %8s %6s  %s\n", "#", "ms", "runs", "overrun", "result", "command");
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        const cmd_sched_slot_s *psSlot = &s_asSlots[i];
+        if (0U != psSlot->u32PeriodMs) {
+            uSHELL_PRINTF("%2u %8u %8u %8u %6d  ", (unsigned)(i + 1U), (unsigned)psSlot->u32PeriodMs,
+                          (unsigned)psSlot->u32Runs, (unsigned)psSlot->u32Overruns, psSlot->iLastResult);
+            s_print_line(&psSlot->sCmd);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,303 @@
+#include "crash_dump.h"
+#include "ushell_core_printout.h"
+#include "uart_access.h"
+
+#if defined(CRASH_DUMP) && (CRASH_DUMP == 1)
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <libopencm3/cm3/scb.h>
+#include <libopencm3/cm3/scs.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#define CRASH_DUMP_MAGIC        0x43525348UL    /* "CRSH" */
+#define CRASH_DUMP_SRAM_BASE    0x20000000UL
+#define CRASH_DUMP_FLASH_BASE   0x08000000UL
+#define CRASH_DUMP_MAX_LINES    8U              /* addresses on the addr2line line */
+
+#define EXC_RETURN_PSP          (1UL << 2)      /* the frame is on the PSP */
+#define EXC_RETURN_THREAD       (1UL << 3)      /* the fault interrupted the thread mode */
+#define EXC_RETURN_BASIC_FRAME  (1UL << 4)      /* 0: the FPU extended frame */
+#define XPSR_STACK_ALIGN        (1UL << 9)      /* a padding word above the frame */
+#define XPSR_THUMB              (1UL << 24)     /* set in any stacked xPSR */
+
+static_assert(CRASH_DUMP_NAME_LEN >= configMAX_TASK_NAME_LEN, "the task names do not fit the dump");
+
+/* linker script symbols: the top of the SRAM (below .noinit), the end of the code in flash */
+extern "C" uint32_t _stack;
+extern "C" uint32_t _etext;
+
+/* the last fault, in .noinit (linker scripts) */
+typedef struct {
+    uint32_t u32Magic;
+    uint32_t u32Count;                          /* faults since the dump was valid the last time */
+    uint32_t au32Frame[8];                      /* r0 r1 r2 r3 r12 lr pc xpsr */
+    uint32_t au32Regs[8];                       /* r4 .. r11 */
+    uint32_t u32Sp;                             /* of the faulting context, above its frame */
+    uint32_t u32ExcReturn;
+    uint32_t u32Cfsr;
+    uint32_t u32Hfsr;
+    uint32_t u32Mmfar;
+    uint32_t u32Bfar;
+    char     acTask[CRASH_DUMP_NAME_LEN];
+    uint32_t u32NrStack;
+    uint32_t au32Stack[CRASH_DUMP_STACK_WORDS];
+    uint32_t u32Check;
+} crash_dump_s;
+
+static_assert(sizeof(crash_dump_s) <= 224U, "the .noinit region of the linker scripts is 512 bytes, 32 for the watchdog, 256 for the LCD");
+
+__attribute__((section(".noinit"))) static crash_dump_s s_sDump;
+
+/* the fault status bits, the names of the ARMv7-M reference manual */
+typedef struct {
+    uint8_t     u8Bit;
+    const char *pcName;
+} crashBit_s;
+
+static const crashBit_s s_asCfsrBits[] = {
+    {  0U, "IACCVIOL"    }, {  1U, "DACCVIOL"  }, {  3U, "MUNSTKERR"   }, {  4U, "MSTKERR"   },
+    {  5U, "MLSPERR"     }, {  7U, "MMARVALID" }, {  8U, "IBUSERR"     }, {  9U, "PRECISERR" },
+    { 10U, "IMPRECISERR" }, { 11U, "UNSTKERR"  }, { 12U, "STKERR"      }, { 13U, "LSPERR"    },
+    { 15U, "BFARVALID"   }, { 16U, "UNDEFINSTR"}, { 17U, "INVSTATE"    }, { 18U, "INVPC"     },
+    { 19U, "NOCP"        }, { 24U, "UNALIGNED" }, { 25U, "DIVBYZERO"   }
+};
+
+static const crashBit_s s_asHfsrBits[] = {
+    {  1U, "VECTTBL" }, { 30U, "FORCED" }, { 31U, "DEBUGEVT" }
+};
+
+
+/*--------------------------------------------------*/
+/* the words before u32Check, rotated and xored: a power on leaves a random SRAM */
+static uint32_t s_check(const crash_dump_s *psDump)
+{
+    const uint32_t *pu32Word = (const uint32_t *)(const void *)psDump;
+    uint32_t u32Sum = 0U;
+
+    for (uint32_t i = 0U; i < (offsetof(crash_dump_s, u32Check) / sizeof(uint32_t)); i++) {
+        u32Sum = ((u32Sum << 1) | (u32Sum >> 31)) ^ pu32Word[i];
+    }
+    return ~u32Sum;
+}
+
+/*--------------------------------------------------*/
+static bool s_valid(void)
+{
+    return (CRASH_DUMP_MAGIC == s_sDump.u32Magic) && (s_check(&s_sDump) == s_sDump.u32Check);
+}
+
+/*--------------------------------------------------*/
+/* u32Size bytes at a word aligned u32Address inside the SRAM: read without a second fault */
+static bool s_in_sram(uint32_t u32Address, uint32_t u32Size)
+{
+    const uint32_t u32Top = (uint32_t)(uintptr_t)&_stack;
+
+    return (0U == (u32Address & 3U)) && (u32Address >= CRASH_DUMP_SRAM_BASE) && (u32Address <= u32Top) &&
+           (u32Size <= (u32Top - u32Address));
+}
+
+/*--------------------------------------------------*/
+/* a Thumb return address: odd, inside the code in flash */
+static bool s_is_code(uint32_t u32Word)
+{
+    return (0U != (u32Word & 1U)) && (u32Word >= CRASH_DUMP_FLASH_BASE) && (u32Word < (uint32_t)(uintptr_t)&_etext);
+}
+
+/*--------------------------------------------------*/
+/* the name of the task on the PSP, copied only when its TCB is in the SRAM */
+static void s_task_name(char *pcName)
+{
+    const TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+
+    if (s_in_sram((uint32_t)(uintptr_t)xTask, sizeof(uint32_t))) {
+        const char *pcTask = pcTaskGetName(xTask);
+        for (uint32_t i = 0U; (i < (CRASH_DUMP_NAME_LEN - 1U)) && ('\0' != pcTask[i]); i++) {
+            pcName[i] = pcTask[i];
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_print_bits(const char *pcReg, uint32_t u32Value, const crashBit_s *psBits, uint32_t u32NrBits)
+{
+    uSHELL_PRINTF("  %-5s %.8x", pcReg, (unsigned)u32Value);
+    for (uint32_t i = 0U; i < u32NrBits; i++) {
+        if (0U != (u32Value & (1UL << psBits[i].u8Bit))) {
+            uSHELL_PRINTF(" %s", psBits[i].pcName);
+        }
+    }
+    uSHELL_PRINTF("\n");
+}
+
+/*--------------------------------------------------*/
+/* where the fault was taken: an ISR from the stacked IPSR, a task, or main() */
+static void s_print_context(void)
+{
+    const uint32_t u32Exception = s_sDump.au32Frame[7] & 0x1FFU;
+
+    if (0U == (s_sDump.u32ExcReturn & EXC_RETURN_THREAD)) {
+        if (u32Exception >= 16U) {
+            uSHELL_PRINTF("HardFault in IRQ %u (exception %u)\n", (unsigned)(u32Exception - 16U), (unsigned)u32Exception);
+        } else {
+            uSHELL_PRINTF("HardFault in exception %u\n", (unsigned)u32Exception);
+        }
+    } else if (0U != (s_sDump.u32ExcReturn & EXC_RETURN_PSP)) {
+        uSHELL_PRINTF("HardFault in task %s\n", ('\0' != s_sDump.acTask[0]) ? s_sDump.acTask : "?");
+    } else {
+        uSHELL_PRINTF("HardFault in main, before the scheduler\n");
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_print(void)
+{
+    const uint32_t *pu32F = s_sDump.au32Frame;
+    const uint32_t *pu32R = s_sDump.au32Regs;
+    uint32_t u32Lines = 0U;
+
+    uSHELL_PRINTF("crash: %u fault(s) since the dump was cleared\n", (unsigned)s_sDump.u32Count);
+    s_print_context();
+    if (0U == (pu32F[7] & XPSR_THUMB)) {
+        uSHELL_PRINTF("  the frame was not readable (sp %x), only the fault registers\n", (unsigned)s_sDump.u32Sp);
+    } else {
+        uSHELL_PRINTF("  pc  %.8x  lr  %.8x  xpsr %.8x\n", (unsigned)pu32F[6], (unsigned)pu32F[5], (unsigned)pu32F[7]);
+        uSHELL_PRINTF("  r0  %.8x  r1  %.8x  r2   %.8x  r3  %.8x  r12 %.8x\n",
+                      (unsigned)pu32F[0], (unsigned)pu32F[1], (unsigned)pu32F[2], (unsigned)pu32F[3], (unsigned)pu32F[4]);
+        uSHELL_PRINTF("  sp  %.8x  exc_return %.8x\n", (unsigned)s_sDump.u32Sp, (unsigned)s_sDump.u32ExcReturn);
+    }
+    uSHELL_PRINTF("  r4  %.8x  r5  %.8x  r6   %.8x  r7  %.8x\n", (unsigned)pu32R[0], (unsigned)pu32R[1], (unsigned)pu32R[2], (unsigned)pu32R[3]);
+    uSHELL_PRINTF("  r8  %.8x  r9  %.8x  r10  %.8x  r11 %.8x\n", (unsigned)pu32R[4], (unsigned)pu32R[5], (unsigned)pu32R[6], (unsigned)pu32R[7]);
+    s_print_bits("CFSR", s_sDump.u32Cfsr, s_asCfsrBits, sizeof(s_asCfsrBits) / sizeof(s_asCfsrBits[0]));
+    s_print_bits("HFSR", s_sDump.u32Hfsr, s_asHfsrBits, sizeof(s_asHfsrBits) / sizeof(s_asHfsrBits[0]));
+    if (0U != (s_sDump.u32Cfsr & (1UL << 7))) {
+        uSHELL_PRINTF("  MMFAR %.8x\n", (unsigned)s_sDump.u32Mmfar);
+    }
+    if (0U != (s_sDump.u32Cfsr & (1UL << 15))) {
+        uSHELL_PRINTF("  BFAR  %.8x\n", (unsigned)s_sDump.u32Bfar);
+    }
+
+    uSHELL_PRINTF("stack, %u words above the sp ('<' a return address):\n", (unsigned)s_sDump.u32NrStack);
+    for (uint32_t i = 0U; i < s_sDump.u32NrStack; i++) {
+        if (0U == (i % 4U)) {
+            uSHELL_PRINTF("  %.8x:", (unsigned)(s_sDump.u32Sp + (i * sizeof(uint32_t))));
+        }
+        uSHELL_PRINTF(" %.8x%c", (unsigned)s_sDump.au32Stack[i], s_is_code(s_sDump.au32Stack[i]) ? '<' : ' ');
+        if ((3U == (i % 4U)) || ((i + 1U) == s_sDump.u32NrStack)) {
+            uSHELL_PRINTF("\n");
+        }
+    }
+
+    uSHELL_PRINTF("arm-none-eabi-addr2line -fpe stm32app.elf");
+    if (0U != (pu32F[7] & XPSR_THUMB)) {
+        uSHELL_PRINTF(" %x %x", (unsigned)pu32F[6], (unsigned)(pu32F[5] & ~1UL));
+    }
+    for (uint32_t i = 0U; (i < s_sDump.u32NrStack) && (u32Lines < CRASH_DUMP_MAX_LINES); i++) {
+        if (s_is_code(s_sDump.au32Stack[i])) {
+            uSHELL_PRINTF(" %x", (unsigned)(s_sDump.au32Stack[i] & ~1UL));
+            u32Lines++;
+        }
+    }
+    uSHELL_PRINTF("\n");
+}
+
+
+/*--------------------------------------------------*/
+/* from hard_fault_handler(): the exception frame, EXC_RETURN, r4..r11 pushed on the MSP */
+extern "C" __attribute__((noreturn, used)) void crash_dump_save(const uint32_t *pu32Frame, uint32_t u32ExcReturn,
+                                                                const uint32_t *pu32Regs)
+{
+    const uint32_t u32Count = s_valid() ? (s_sDump.u32Count + 1U) : 1U;
+    const uint32_t u32Frame = (uint32_t)(uintptr_t)pu32Frame;
+
+    memset(&s_sDump, 0, sizeof(s_sDump));
+    s_sDump.u32Magic     = CRASH_DUMP_MAGIC;
+    s_sDump.u32Count     = u32Count;
+    s_sDump.u32ExcReturn = u32ExcReturn;
+    s_sDump.u32Cfsr      = SCB_CFSR;
+    s_sDump.u32Hfsr      = SCB_HFSR;
+    s_sDump.u32Mmfar     = SCB_MMFAR;
+    s_sDump.u32Bfar      = SCB_BFAR;
+    memcpy(s_sDump.au32Regs, pu32Regs, sizeof(s_sDump.au32Regs));
+
+    /* a stacking fault (STKERR, MSTKERR) or a wild sp leaves no frame to read */
+    s_sDump.u32Sp = u32Frame;
+    if (s_in_sram(u32Frame, sizeof(s_sDump.au32Frame))) {
+        memcpy(s_sDump.au32Frame, pu32Frame, sizeof(s_sDump.au32Frame));
+        const uint32_t u32FrameWords = (0U != (u32ExcReturn & EXC_RETURN_BASIC_FRAME)) ? 8U : 26U;
+        s_sDump.u32Sp = u32Frame + (u32FrameWords * sizeof(uint32_t)) +
+                        ((0U != (s_sDump.au32Frame[7] & XPSR_STACK_ALIGN)) ? sizeof(uint32_t) : 0U);
+        if (s_in_sram(s_sDump.u32Sp, 0U)) {
+            const uint32_t u32Left = ((uint32_t)(uintptr_t)&_stack - s_sDump.u32Sp) / sizeof(uint32_t);
+            s_sDump.u32NrStack = (u32Left < CRASH_DUMP_STACK_WORDS) ? u32Left : CRASH_DUMP_STACK_WORDS;
+            memcpy(s_sDump.au32Stack, (const void *)(uintptr_t)s_sDump.u32Sp, s_sDump.u32NrStack * sizeof(uint32_t));
+        }
+    }
+    if ((0U != (u32ExcReturn & EXC_RETURN_THREAD)) && (0U != (u32ExcReturn & EXC_RETURN_PSP))) {
+        s_task_name(s_sDump.acTask);
+    }
+    s_sDump.u32Check = s_check(&s_sDump);
+    __asm volatile ("dsb" ::: "memory");
+
+    if (0U != (SCS_DHCSR & SCS_DHCSR_C_DEBUGEN)) {
+        __asm volatile ("bkpt #0");     /* a debugger attached: stop at the fault, the dump is saved */
+    }
+    scb_reset_system();
+}
+
+/*--------------------------------------------------*/
+/* the frame of the faulting context (MSP or PSP, EXC_RETURN bit 2) and r4..r11 as they were */
+extern "C" __attribute__((naked)) void hard_fault_handler(void)
+{
+    __asm volatile (
+        "tst    lr, #4          \n"
+        "ite    eq              \n"
+        "mrseq  r0, msp         \n"
+        "mrsne  r0, psp         \n"
+        "mov    r1, lr          \n"
+        "push   {r4-r11}        \n"
+        "mov    r2, sp          \n"
+        "b      crash_dump_save \n"
+    );
+}
+#endif /*defined(CRASH_DUMP) && (CRASH_DUMP == 1)*/
+
+
+// -- shell command -----------------------------------------------------------
+
+/* crash 0: print the dump, crash 1: clear it, crash 2: take a fault */
+extern "C" int crash(uint32_t u32Action)
+{
+#if defined(CRASH_DUMP) && (CRASH_DUMP == 1)
+    switch (u32Action) {
+        case 0U:
+            if (false == s_valid()) {
+                uSHELL_PRINTF("crash: no dump\n");
+                return 0;
+            }
+            s_print();
+            break;
+
+        case 1U:
+            memset(&s_sDump, 0, sizeof(s_sDump));
+            uSHELL_PRINTF("crash: cleared\n");
+            break;
+
+        case 2U:
+            uSHELL_PRINTF("crash: UDF, the dump is there after the reset\n");
+            uart_flush();
+            __builtin_trap();
+            break;
+
+        default:
+            uSHELL_PRINTF("crash: 0 print, 1 clear, 2 fault\n");
+            return -1;
+    }
+#else
+    (void)u32Action;
+    uSHELL_PRINTF("crash: built with CRASH_DUMP 0\n");
+#endif /*defined(CRASH_DUMP) && (CRASH_DUMP == 1)*/
+    return 0;
+}
@@ -0,0 +1,114 @@
+#ifndef DEFER_LOG_H
+#define DEFER_LOG_H
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/*
+    Deferred logging: a log site stores the id of its format string and the raw arguments,
+    the text is rebuilt on the host by tools/dlog_decode.py from the same ELF.
+
+        DLOG("adc %u: %d mV\r\n", u32Channel, i32MilliVolt);
+
+    The format strings go to the .deflog section which the linker script keeps as INFO
+    (in the ELF for the decoder, not in flash), located at 0 so the address of a string
+    is its id. Use DLOG() in plain functions only, not in inline functions or templates.
+
+    Frame in the ring: LEN | ID (2) | TICKS (4) | ARGS, LEN counts the bytes after it.
+    Arguments are packed by their C++ type, little endian:
+        integers up to 32 bit, pointers -> 4 bytes
+        64 bit integers                 -> 8 bytes
+        float, double                   -> 4 bytes (float)
+        const char *                    -> length byte + characters (up to DLOG_MAX_STRING)
+    so the conversions must match: %d %i %u %x %X %c %p take 4 bytes, %lld %llu %llx 8,
+    %f 4 and %s a string.
+
+    The shell command dlog drains the ring as "DL:<hex>" lines.
+*/
+
+#define DLOG_BUFFER_SIZE        1024U   /* ring size, power of two */
+#define DLOG_MAX_FRAME          64U     /* largest frame without the LEN byte */
+#define DLOG_MAX_STRING         16U     /* longest %s argument, longer ones are cut */
+
+#define DLOG(fmt, ...)                                                                      \
+    do {                                                                                    \
+        __attribute__((section(".deflog"), used)) static const char s_acDlogFmt[] = fmt;    \
+        dlog_log((uint16_t)(uintptr_t)s_acDlogFmt __VA_OPT__(,) __VA_ARGS__);               \
+    } while (0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* queue one frame (ID onwards), dropped and counted if the ring has no room (ISR safe) */
+void dlog_commit(const uint8_t *pu8Frame, uint32_t u32Len);
+
+/* take the oldest frame (ID onwards), returns its length or 0 when the ring is empty */
+uint32_t dlog_read(uint8_t *pu8Frame, uint32_t u32Size);
+
+uint32_t dlog_dropped(void);
+uint32_t dlog_ticks(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+typedef struct {
+    uint8_t au8Data[DLOG_MAX_FRAME];
+    uint32_t u32Len;
+} dlog_frame_s;
+
+
+static inline void dlog_put(dlog_frame_s &sFrame, const void *pvData, uint32_t u32Len)
+{
+    if ((sFrame.u32Len + u32Len) <= DLOG_MAX_FRAME) {
+        memcpy(&sFrame.au8Data[sFrame.u32Len], pvData, u32Len);
+    }
+    sFrame.u32Len += u32Len;   /* an oversized frame is refused by dlog_commit() */
+}
+
+
+template <typename T>
+static inline void dlog_pack(dlog_frame_s &sFrame, T tArg)
+{
+    if constexpr (std::is_convertible_v<T, const char *>) {
+        const char *pstrArg = (nullptr != tArg) ? (const char *)tArg : "(null)";
+        const uint8_t u8Len = (uint8_t)strnlen(pstrArg, DLOG_MAX_STRING);
+        dlog_put(sFrame, &u8Len, 1U);
+        dlog_put(sFrame, pstrArg, u8Len);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        const float fArg = (float)tArg;
+        dlog_put(sFrame, &fArg, 4U);
+    } else if constexpr (std::is_pointer_v<T>) {
+        const uint32_t u32Arg = (uint32_t)(uintptr_t)tArg;
+        dlog_put(sFrame, &u32Arg, 4U);
+    } else {
+        static_assert(std::is_integral_v<T> || std::is_enum_v<T>, "DLOG: unsupported argument type");
+        static_assert(sizeof(T) <= 8U, "DLOG: argument wider than 64 bit");
+        if constexpr (sizeof(T) == 8U) {
+            const uint64_t u64Arg = (uint64_t)tArg;
+            dlog_put(sFrame, &u64Arg, 8U);
+        } else {
+            const uint32_t u32Arg = (uint32_t)(int64_t)tArg;   /* sign extended like the C promotions */
+            dlog_put(sFrame, &u32Arg, 4U);
+        }
+    }
+}
+
+
+template <typename... Args>
+static inline void dlog_log(uint16_t u16Id, Args... tArgs)
+{
+    dlog_frame_s sFrame;
+    const uint32_t u32Ticks = dlog_ticks();
+
+    sFrame.u32Len = 0U;
+    dlog_put(sFrame, &u16Id, 2U);
+    dlog_put(sFrame, &u32Ticks, 4U);
+    (dlog_pack(sFrame, tArgs), ...);
+    dlog_commit(sFrame.au8Data, sFrame.u32Len);
+}
+
+#endif /* DEFER_LOG_H */
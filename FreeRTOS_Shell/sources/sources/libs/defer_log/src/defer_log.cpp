@@ -0,0 +1,136 @@
+#include "defer_log.h"
+#include "ushell_core_printout.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+static_assert(0U == (DLOG_BUFFER_SIZE & (DLOG_BUFFER_SIZE - 1U)), "DLOG_BUFFER_SIZE must be a power of two");
+static_assert(DLOG_MAX_FRAME < 256U, "DLOG_MAX_FRAME must fit the LEN byte");
+
+/* ring of LEN | frame records, head and tail run free and are masked on access */
+static uint8_t s_au8Ring[DLOG_BUFFER_SIZE];
+static volatile uint32_t s_u32Head    = 0U;
+static volatile uint32_t s_u32Tail    = 0U;
+static volatile uint32_t s_u32Dropped = 0U;
+
+
+/* PRIMASK based so it works from tasks, ISRs and before the scheduler starts */
+static inline uint32_t s_dlog_lock(void)
+{
+    uint32_t u32Primask;
+    __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (u32Primask) :: "memory");
+    return u32Primask;
+}
+
+static inline void s_dlog_unlock(uint32_t u32Primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (u32Primask) : "memory");
+}
+
+
+static void s_ring_copy_in(uint32_t u32Pos, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    const uint32_t u32Idx   = u32Pos & (DLOG_BUFFER_SIZE - 1U);
+    const uint32_t u32First = (u32Len < (DLOG_BUFFER_SIZE - u32Idx)) ? u32Len : (DLOG_BUFFER_SIZE - u32Idx);
+
+    memcpy(&s_au8Ring[u32Idx], pu8Data, u32First);
+    memcpy(&s_au8Ring[0], pu8Data + u32First, u32Len - u32First);
+}
+
+
+static void s_ring_copy_out(uint32_t u32Pos, uint8_t *pu8Data, uint32_t u32Len)
+{
+    const uint32_t u32Idx   = u32Pos & (DLOG_BUFFER_SIZE - 1U);
+    const uint32_t u32First = (u32Len < (DLOG_BUFFER_SIZE - u32Idx)) ? u32Len : (DLOG_BUFFER_SIZE - u32Idx);
+
+    memcpy(pu8Data, &s_au8Ring[u32Idx], u32First);
+    memcpy(pu8Data + u32First, &s_au8Ring[0], u32Len - u32First);
+}
+
+
+
+/*-----------------------------------------------------------------------------*/
+void dlog_commit(const uint8_t *pu8Frame, uint32_t u32Len)
+{
+    const uint32_t u32Primask = s_dlog_lock();
+    const uint32_t u32Head = s_u32Head;
+
+    if ((u32Len > DLOG_MAX_FRAME) || ((u32Len + 1U) > (DLOG_BUFFER_SIZE - (u32Head - s_u32Tail)))) {
+        s_u32Dropped = s_u32Dropped + 1U;
+    } else {
+        const uint8_t u8Len = (uint8_t)u32Len;
+        s_ring_copy_in(u32Head, &u8Len, 1U);
+        s_ring_copy_in(u32Head + 1U, pu8Frame, u32Len);
+        s_u32Head = u32Head + 1U + u32Len;
+    }
+
+    s_dlog_unlock(u32Primask);
+}
+
+
+/*-----------------------------------------------------------------------------*/
+uint32_t dlog_read(uint8_t *pu8Frame, uint32_t u32Size)
+{
+    uint32_t u32Len = 0U;
+    const uint32_t u32Primask = s_dlog_lock();
+    const uint32_t u32Tail = s_u32Tail;
+
+    if (u32Tail != s_u32Head) {
+        uint8_t u8Len;
+        s_ring_copy_out(u32Tail, &u8Len, 1U);
+        if (u8Len <= u32Size) {
+            s_ring_copy_out(u32Tail + 1U, pu8Frame, u8Len);
+            u32Len = u8Len;
+        }
+        s_u32Tail = u32Tail + 1U + u8Len;   /* a frame that does not fit the caller is skipped */
+    }
+
+    s_dlog_unlock(u32Primask);
+    return u32Len;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+uint32_t dlog_dropped(void)
+{
+    return s_u32Dropped;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+uint32_t dlog_ticks(void)
+{
+    uint32_t u32Ipsr;
+    __asm volatile ("mrs %0, ipsr" : "=r" (u32Ipsr));
+
+    return (0U != u32Ipsr) ? (uint32_t)xTaskGetTickCountFromISR() : (uint32_t)xTaskGetTickCount();
+}
+
+
+/*-----------------------------------------------------------------------------*/
+/* shell command: print the queued frames for tools/dlog_decode.py */
+extern "C" int dlog(void)
+{
+    static const char acHex[] = "0123456789ABCDEF";
+    uint8_t au8Frame[DLOG_MAX_FRAME];
+    char acLine[2U * (DLOG_MAX_FRAME + 1U) + 1U];
+    uint32_t u32Len;
+
+    while (0U != (u32Len = dlog_read(au8Frame, sizeof(au8Frame)))) {
+        acLine[0] = acHex[u32Len >> 4];
+        acLine[1] = acHex[u32Len & 0x0FU];
+        for (uint32_t i = 0U; i < u32Len; ++i) {
+            acLine[2U + 2U * i]      = acHex[au8Frame[i] >> 4];
+            acLine[2U + 2U * i + 1U] = acHex[au8Frame[i] & 0x0FU];
+        }
+        acLine[2U + 2U * u32Len] = '\0';
+        uSHELL_PRINTF("DL:%s\r\n", acLine);
+    }
+
+    if (0U != s_u32Dropped) {
+        uSHELL_PRINTF("dlog: %u frames dropped\r\n", (unsigned)s_u32Dropped);
+    }
+
+    return 0;
+}
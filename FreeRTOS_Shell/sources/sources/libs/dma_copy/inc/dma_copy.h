@@ -0,0 +1,57 @@
+#ifndef DMA_COPY_H
+#define DMA_COPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+    Memory to memory copy and fill by DMA, for the large buffers: the caller goes on while the
+    DMA moves the bytes.
+
+        if (0 == dma_memcpy(pvDst, pvSrc, szLen, nullptr, nullptr)) {      from a task
+            ... work which touches neither buffer ...
+            dma_copy_wait(10U);
+        }
+
+    One transfer at a time on DMA1 channel 2 (F1) or DMA2 stream 1 (F4, only DMA2 does memory
+    to memory), free of the UART and the ADC ones; a start while one runs returns -1. Below
+    DMA_COPY_MIN_BYTES the CPU copies (memcpy / memset) at once: the set up of the channel and
+    the interrupt cost more than the bytes. Words when both addresses and the length are
+    multiples of 4, bytes otherwise; more than 65535 items go in parts, chained from the
+    interrupt. A fill reads one word of the service with the source increment off.
+
+    The end is the done hook (from the DMA interrupt, a kernel aware priority: the FromISR calls
+    are allowed; from the caller below the threshold) and dma_copy_wait(). Both buffers are the
+    DMA's until then. The DMA shares the bus matrix with the CPU: the caller runs on, slowed
+    where both hit the same SRAM. STOP is held off while a transfer runs (power_mgr_lock()).
+
+    dmacopy <bytes> compares memcpy with the DMA copy of as many bytes of the flash into SRAM,
+    and counts the cycles the caller had while the DMA ran.
+*/
+
+#define DMA_COPY_MIN_BYTES      64U         /* shorter ones are CPU copies */
+#define DMA_COPY_MAX_ITEMS      65535U      /* per part, NDTR */
+
+/* the transfer ended: from the DMA interrupt, or the caller below DMA_COPY_MIN_BYTES */
+typedef void (*dma_copy_done_t)(void *pvArg);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 0 started (or done below the threshold), -1 while a transfer runs; pfDone may be null */
+int dma_memcpy(void *pvDst, const void *pvSrc, size_t szLen, dma_copy_done_t pfDone, void *pvArg);
+int dma_memset(void *pvDst, uint8_t u8Value, size_t szLen, dma_copy_done_t pfDone, void *pvArg);
+
+/* 1 while a transfer runs */
+int dma_copy_busy(void);
+
+/* from a task: 0 when the last transfer ended, -1 on a bus error or still running after
+   u32TimeoutMs */
+int dma_copy_wait(uint32_t u32TimeoutMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_COPY_H */
@@ -0,0 +1,288 @@
+#include "dma_copy.h"
+#include "isr_prof.h"
+#include "ram_func.h"
+#include "power_mgr.h"
+#include "ushell_core_printout.h"
+#include "libopencm3/stm32/rcc.h"
+#include "libopencm3/stm32/dma.h"
+#include "libopencm3/cm3/nvic.h"
+#include <libopencm3/cm3/dwt.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+#include <string.h>
+
+/* memory to memory: DMA1 channel 2 (F1), DMA2 stream 1 channel 0 (F4) */
+#if defined(STM32F1)
+#define DMA_COPY_DMA                DMA1
+#define DMA_COPY_CH                 DMA_CHANNEL2
+#define DMA_COPY_RCC                RCC_DMA1
+#define DMA_COPY_IRQ                NVIC_DMA1_CHANNEL2_IRQ
+#define DMA_COPY_ISR                dma1_channel2_isr
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+#define DMA_COPY_DMA                DMA2
+#define DMA_COPY_CH                 DMA_STREAM1
+#define DMA_COPY_RCC                RCC_DMA2
+#define DMA_COPY_IRQ                NVIC_DMA2_STREAM1_IRQ
+#define DMA_COPY_ISR                dma2_stream1_isr
+#endif /*defined(STM32F4)*/
+
+#define DMA_COPY_IRQ_PRIORITY       ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+#define DMA_COPY_BENCH_BYTES        512U    /* dmacopy: the SRAM it copies into */
+#define DMA_COPY_FLASH_BASE         0x08000000UL
+
+static volatile bool s_bBusy = false;
+static bool s_bReady = false;               /* clock, interrupt and semaphore set up */
+static int s_iResult = 0;                   /* of the last transfer, -1 after a bus error */
+static uint32_t s_u32Dst = 0U;
+static uint32_t s_u32Src = 0U;
+static uint32_t s_u32Left = 0U;             /* items after the part on its way */
+static uint32_t s_u32Part = 0U;             /* items of the part on its way */
+static uint32_t s_u32Size = 1U;             /* bytes per item */
+static bool s_bFill = false;
+static uint32_t s_u32Fill = 0U;             /* the source of a fill, the byte in the 4 lanes */
+static dma_copy_done_t s_pfDone = nullptr;
+static void *s_pvArg = nullptr;
+
+static SemaphoreHandle_t s_xDone = nullptr;
+static StaticSemaphore_t s_xDoneBuffer;
+
+
+/*--------------------------------------------------*/
+/* one part of at most DMA_COPY_MAX_ITEMS items, the source as the "peripheral" of the channel */
+static RAM_FUNC void s_start_part(void)
+{
+    s_u32Part = (s_u32Left > DMA_COPY_MAX_ITEMS) ? DMA_COPY_MAX_ITEMS : s_u32Left;
+    s_u32Left -= s_u32Part;
+
+#if defined(STM32F1)
+    dma_channel_reset(DMA_COPY_DMA, DMA_COPY_CH);
+    dma_enable_mem2mem_mode(DMA_COPY_DMA, DMA_COPY_CH);
+    dma_set_read_from_peripheral(DMA_COPY_DMA, DMA_COPY_CH);
+    dma_set_peripheral_size(DMA_COPY_DMA, DMA_COPY_CH, (4U == s_u32Size) ? DMA_CCR_PSIZE_32BIT : DMA_CCR_PSIZE_8BIT);
+    dma_set_memory_size(DMA_COPY_DMA, DMA_COPY_CH, (4U == s_u32Size) ? DMA_CCR_MSIZE_32BIT : DMA_CCR_MSIZE_8BIT);
+    dma_set_priority(DMA_COPY_DMA, DMA_COPY_CH, DMA_CCR_PL_LOW);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    dma_stream_reset(DMA_COPY_DMA, DMA_COPY_CH);
+    dma_channel_select(DMA_COPY_DMA, DMA_COPY_CH, DMA_SxCR_CHSEL_0);
+    dma_set_transfer_mode(DMA_COPY_DMA, DMA_COPY_CH, DMA_SxCR_DIR_MEM_TO_MEM);
+    dma_set_peripheral_size(DMA_COPY_DMA, DMA_COPY_CH, (4U == s_u32Size) ? DMA_SxCR_PSIZE_32BIT : DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(DMA_COPY_DMA, DMA_COPY_CH, (4U == s_u32Size) ? DMA_SxCR_MSIZE_32BIT : DMA_SxCR_MSIZE_8BIT);
+    dma_set_priority(DMA_COPY_DMA, DMA_COPY_CH, DMA_SxCR_PL_LOW);
+    dma_enable_fifo_mode(DMA_COPY_DMA, DMA_COPY_CH);                     /* no direct mode memory to memory */
+    dma_set_fifo_threshold(DMA_COPY_DMA, DMA_COPY_CH, DMA_SxFCR_FTH_4_4_FULL);
+#endif /*defined(STM32F4)*/
+
+    if (false == s_bFill) {
+        dma_enable_peripheral_increment_mode(DMA_COPY_DMA, DMA_COPY_CH);
+    }
+    dma_enable_memory_increment_mode(DMA_COPY_DMA, DMA_COPY_CH);
+    dma_set_peripheral_address(DMA_COPY_DMA, DMA_COPY_CH, s_u32Src);
+    dma_set_memory_address(DMA_COPY_DMA, DMA_COPY_CH, s_u32Dst);
+    dma_set_number_of_data(DMA_COPY_DMA, DMA_COPY_CH, (uint16_t)s_u32Part);
+    dma_enable_transfer_complete_interrupt(DMA_COPY_DMA, DMA_COPY_CH);
+    dma_enable_transfer_error_interrupt(DMA_COPY_DMA, DMA_COPY_CH);
+
+    __asm volatile ("dsb" ::: "memory");        /* the caller's stores into the source are out first */
+#if defined(STM32F1)
+    dma_enable_channel(DMA_COPY_DMA, DMA_COPY_CH);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    dma_enable_stream(DMA_COPY_DMA, DMA_COPY_CH);
+#endif /*defined(STM32F4)*/
+}
+
+/*--------------------------------------------------*/
+/* the channel is claimed for the caller: false while a transfer runs */
+static bool s_claim(void)
+{
+    bool bClaimed = false;
+
+    taskENTER_CRITICAL();
+    if (false == s_bBusy) {
+        s_bBusy = true;
+        bClaimed = true;
+        if (false == s_bReady) {
+            rcc_periph_clock_enable(DMA_COPY_RCC);
+            s_xDone = xSemaphoreCreateBinaryStatic(&s_xDoneBuffer);
+            nvic_set_priority(DMA_COPY_IRQ, DMA_COPY_IRQ_PRIORITY);
+            nvic_enable_irq(DMA_COPY_IRQ);
+            s_bReady = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return bClaimed;
+}
+
+/*--------------------------------------------------*/
+static void s_start(void *pvDst, uint32_t u32Src, size_t szLen, bool bFill, dma_copy_done_t pfDone, void *pvArg)
+{
+    const uint32_t u32Dst = (uint32_t)(uintptr_t)pvDst;
+
+    s_u32Size = (0U == ((u32Dst | (bFill ? 0U : u32Src) | (uint32_t)szLen) & 3U)) ? 4U : 1U;
+    s_u32Dst  = u32Dst;
+    s_u32Src  = u32Src;
+    s_u32Left = (uint32_t)szLen / s_u32Size;
+    s_bFill   = bFill;
+    s_pfDone  = pfDone;
+    s_pvArg   = pvArg;
+    s_iResult = 0;
+
+    (void)xSemaphoreTake(s_xDone, 0U);      /* given by a transfer nobody waited for */
+    power_mgr_lock();                       /* STOP would halt the DMA */
+    s_start_part();
+}
+
+
+/*--------------------------------------------------*/
+/* transfer complete: the next part, or the end; transfer error: the end, the rest is not copied */
+extern "C" RAM_FUNC void DMA_COPY_ISR(void)
+{
+    ISR_PROF_ENTER(ISR_PROF_DMA_COPY);
+    bool bEnd = false;
+
+    if (dma_get_interrupt_flag(DMA_COPY_DMA, DMA_COPY_CH, DMA_TEIF)) {
+        dma_clear_interrupt_flags(DMA_COPY_DMA, DMA_COPY_CH, DMA_TEIF | DMA_TCIF);
+        s_iResult = -1;
+        bEnd = true;
+    } else if (dma_get_interrupt_flag(DMA_COPY_DMA, DMA_COPY_CH, DMA_TCIF)) {
+        dma_clear_interrupt_flags(DMA_COPY_DMA, DMA_COPY_CH, DMA_TCIF);
+        s_u32Dst += s_u32Part * s_u32Size;
+        if (false == s_bFill) {
+            s_u32Src += s_u32Part * s_u32Size;
+        }
+        if (0U != s_u32Left) {
+            s_start_part();
+        } else {
+            bEnd = true;
+        }
+    }
+
+    if (bEnd) {
+        BaseType_t xWoken = pdFALSE;
+
+#if defined(STM32F1)
+        dma_disable_channel(DMA_COPY_DMA, DMA_COPY_CH);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+        dma_disable_stream(DMA_COPY_DMA, DMA_COPY_CH);
+#endif /*defined(STM32F4)*/
+        power_mgr_unlock();
+        s_bBusy = false;
+        if (nullptr != s_pfDone) {
+            s_pfDone(s_pvArg);
+        }
+        (void)xSemaphoreGiveFromISR(s_xDone, &xWoken);
+        portYIELD_FROM_ISR(xWoken);
+    }
+    ISR_PROF_EXIT(ISR_PROF_DMA_COPY);
+}
+
+
+/*--------------------------------------------------*/
+int dma_memcpy(void *pvDst, const void *pvSrc, size_t szLen, dma_copy_done_t pfDone, void *pvArg)
+{
+    if (false == s_claim()) {
+        return -1;
+    }
+    if (szLen < DMA_COPY_MIN_BYTES) {
+        memcpy(pvDst, pvSrc, szLen);
+        s_iResult = 0;
+        s_bBusy = false;
+        if (nullptr != pfDone) {
+            pfDone(pvArg);
+        }
+        return 0;
+    }
+    s_start(pvDst, (uint32_t)(uintptr_t)pvSrc, szLen, false, pfDone, pvArg);
+    return 0;
+}
+
+/*--------------------------------------------------*/
+int dma_memset(void *pvDst, uint8_t u8Value, size_t szLen, dma_copy_done_t pfDone, void *pvArg)
+{
+    if (false == s_claim()) {
+        return -1;
+    }
+    if (szLen < DMA_COPY_MIN_BYTES) {
+        memset(pvDst, u8Value, szLen);
+        s_iResult = 0;
+        s_bBusy = false;
+        if (nullptr != pfDone) {
+            pfDone(pvArg);
+        }
+        return 0;
+    }
+    s_u32Fill = 0x01010101UL * u8Value;
+    s_start(pvDst, (uint32_t)(uintptr_t)&s_u32Fill, szLen, true, pfDone, pvArg);
+    return 0;
+}
+
+/*--------------------------------------------------*/
+int dma_copy_busy(void)
+{
+    return s_bBusy ? 1 : 0;
+}
+
+/*--------------------------------------------------*/
+int dma_copy_wait(uint32_t u32TimeoutMs)
+{
+    if ((true == s_bBusy) && (pdTRUE != xSemaphoreTake(s_xDone, pdMS_TO_TICKS(u32TimeoutMs)))) {
+        return -1;
+    }
+    return s_iResult;
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* dmacopy <bytes>: memcpy against the DMA copy of the start of the flash into SRAM, the cycles
+   of each, the DMA ones split into the start (until dma_memcpy() returns) and those the caller
+   had until the end; then a DMA fill of the same bytes */
+extern "C" int dmacopy(uint32_t u32Bytes)
+{
+    static uint8_t s_au8Buffer[DMA_COPY_BENCH_BYTES] __attribute__((aligned(4)));
+    const void *pvFlash = (const void *)(uintptr_t)DMA_COPY_FLASH_BASE;
+
+    if ((0U == u32Bytes) || (u32Bytes > DMA_COPY_BENCH_BYTES)) {
+        u32Bytes = DMA_COPY_BENCH_BYTES;
+    }
+    dwt_enable_cycle_counter();
+
+    uint32_t u32Start = DWT_CYCCNT;
+    memcpy(s_au8Buffer, pvFlash, u32Bytes);
+    const uint32_t u32CpuCycles = DWT_CYCCNT - u32Start;
+
+    memset(s_au8Buffer, 0, u32Bytes);
+    u32Start = DWT_CYCCNT;
+    if (0 != dma_memcpy(s_au8Buffer, pvFlash, u32Bytes, nullptr, nullptr)) {
+        uSHELL_PRINTF("dmacopy: a transfer is running\n");
+        return -1;
+    }
+    const uint32_t u32StartCycles = DWT_CYCCNT - u32Start;
+    while (0 != dma_copy_busy()) {
+        /* the cycles the caller has */
+    }
+    const uint32_t u32DmaCycles = DWT_CYCCNT - u32Start;
+    const bool bCopied = (0 == dma_copy_wait(0U)) && (0 == memcmp(s_au8Buffer, pvFlash, u32Bytes));
+
+    u32Start = DWT_CYCCNT;
+    bool bFilled = (0 == dma_memset(s_au8Buffer, 0xA5U, u32Bytes, nullptr, nullptr)) && (0 == dma_copy_wait(10U));
+    const uint32_t u32FillCycles = DWT_CYCCNT - u32Start;
+    for (uint32_t i = 0U; bFilled && (i < u32Bytes); ++i) {
+        bFilled = (0xA5U == s_au8Buffer[i]);
+    }
+
+    uSHELL_PRINTF("%u bytes%s: memcpy %u cycles, dma %u (start %u, caller free %u)%s, dma fill %u%s\n",
+                  (unsigned)u32Bytes, (u32Bytes < DMA_COPY_MIN_BYTES) ? " (CPU below the threshold)" : "",
+                  (unsigned)u32CpuCycles, (unsigned)u32DmaCycles, (unsigned)u32StartCycles,
+                  (unsigned)(u32DmaCycles - u32StartCycles), bCopied ? "" : " MISMATCH",
+                  (unsigned)u32FillCycles, bFilled ? "" : " MISMATCH");
+    return (bCopied && bFilled) ? 0 : -1;
+}
@@ -0,0 +1,48 @@
+#ifndef FLASH_HISTORY_H
+#define FLASH_HISTORY_H
+
+#include <stdint.h>
+#include "ushell_core_datatypes.h"
+
+/*
+    Shell history kept in the internal flash as an append-only log, restored at reset.
+
+        pShell->SetHistoryStore(flash_history_store());      before Run()
+        void vApplicationIdleHook(void) { flash_history_idle(); }
+
+    A push only queues the entry in RAM; the idle hook programs the queued records once the
+    shell has been quiet for FLASH_HISTORY_IDLE_MS, so the writes are batched and the shell
+    task never waits for the flash. The records fill the whole area, which is erased only
+    when full (every location is written once per erase cycle); the newest entries that fit
+    FLASH_HISTORY_CARRY_SIZE are copied back after the erase, a clear (#c) erases it at idle.
+
+    Area, kept out of rom by the linker scripts:
+        STM32F411   sector 7, 128K at 0x08060000    (erase ~1-2 s)
+        STM32F103   last 2 pages, 2K at 0x0801F800  (erase ~40 ms)
+    The code fetch from flash stalls while it erases or programs.
+
+    Record: HDR (0xA5 << 8 | LEN) | data, padded to halfwords | COMMIT (0x0000), halfwords
+    little endian; a record with the COMMIT still erased (reset while programming) is skipped.
+*/
+
+#if defined(STM32F4)
+#define FLASH_HISTORY_BASE          0x08060000U
+#define FLASH_HISTORY_SIZE          0x00020000U
+#define FLASH_HISTORY_SECTOR        7U
+#else /* STM32F1 */
+#define FLASH_HISTORY_BASE          0x0801F800U
+#define FLASH_HISTORY_SIZE          0x00000800U
+#define FLASH_HISTORY_PAGE          0x00000400U
+#endif /* defined(STM32F4) */
+
+#define FLASH_HISTORY_QUEUE_SIZE    256U    /* entries pushed and not yet programmed (LEN | data) */
+#define FLASH_HISTORY_CARRY_SIZE    256U    /* newest entries kept over an erase (LEN | data) */
+#define FLASH_HISTORY_IDLE_MS       500U    /* quiet time before the queue is programmed */
+
+/* the store to attach to the shell, scans the area on the first call */
+const uShellHistoryStore_s *flash_history_store(void);
+
+/* program the queued entries, erase when needed (from the idle hook, may stall the flash) */
+void flash_history_idle(void);
+
+#endif /* FLASH_HISTORY_H */
@@ -0,0 +1,258 @@
+#include "flash_history.h"
+
+#include <string.h>
+#include <libopencm3/stm32/flash.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+#define FLASH_HISTORY_END       (FLASH_HISTORY_BASE + FLASH_HISTORY_SIZE)
+#define FLASH_HISTORY_TAG       0xA5U
+#define FLASH_HISTORY_ERASED    0xFFFFU
+#define FLASH_HISTORY_COMMIT    0x0000U
+
+/* HDR | data padded to halfwords | COMMIT */
+#define FLASH_HISTORY_RECORD(len)   (2U + (((len) + 1U) & ~1U) + 2U)
+
+static_assert(uSHELL_MAX_INPUT_BUF_LEN <= 256U, "history entries must fit the LEN byte");
+static_assert(FLASH_HISTORY_QUEUE_SIZE >= uSHELL_MAX_INPUT_BUF_LEN, "FLASH_HISTORY_QUEUE_SIZE must hold the longest entry");
+static_assert((3U * FLASH_HISTORY_CARRY_SIZE + FLASH_HISTORY_RECORD(uSHELL_MAX_INPUT_BUF_LEN)) <= FLASH_HISTORY_SIZE,
+              "the carried entries and a new one must fit the erased area");
+
+/* LEN | data records pushed by the shell task, programmed by the idle task */
+static uint8_t s_au8Queue[FLASH_HISTORY_QUEUE_SIZE];
+static volatile uint32_t s_u32QueueLen    = 0U;
+static volatile uint32_t s_u32Generation  = 0U;   /* bumped by a clear, the queue restarts */
+static volatile bool s_bErase             = false;
+static volatile TickType_t s_xLastPush    = 0;
+
+/* LEN | data of the newest records while the area is erased */
+static uint8_t s_au8Carry[FLASH_HISTORY_CARRY_SIZE];
+
+/* first free address of the area, 0 before the scan */
+static uint32_t s_u32End = 0U;
+
+
+static inline uint16_t s_read_half(uint32_t u32Addr)
+{
+    return *(volatile const uint16_t *)(uintptr_t)u32Addr;
+}
+
+
+/* LEN of the record at u32Addr, 0 at the end of the log (erased or broken header) */
+static uint32_t s_record_len(uint32_t u32Addr)
+{
+    if ((u32Addr + 4U) > FLASH_HISTORY_END) {
+        return 0U;
+    }
+
+    const uint16_t u16Hdr = s_read_half(u32Addr);
+    const uint32_t u32Len = u16Hdr & 0xFFU;
+
+    if (((u16Hdr >> 8) != FLASH_HISTORY_TAG) || ((u32Addr + FLASH_HISTORY_RECORD(u32Len)) > FLASH_HISTORY_END)) {
+        return 0U;
+    }
+    return u32Len;
+}
+
+
+static inline bool s_record_committed(uint32_t u32Addr, uint32_t u32Len)
+{
+    return FLASH_HISTORY_COMMIT == s_read_half(u32Addr + FLASH_HISTORY_RECORD(u32Len) - 2U);
+}
+
+
+static void s_scan(void)
+{
+    uint32_t u32Addr = FLASH_HISTORY_BASE;
+    uint32_t u32Len;
+
+    while (0U != (u32Len = s_record_len(u32Addr))) {
+        u32Addr += FLASH_HISTORY_RECORD(u32Len);
+    }
+
+    /* not erased after the last record: nothing is appended there, the next flush compacts */
+    s_u32End = ((u32Addr < FLASH_HISTORY_END) && (FLASH_HISTORY_ERASED == s_read_half(u32Addr))) ? u32Addr : FLASH_HISTORY_END;
+}
+
+
+/* header first, commit last: a reset in between leaves a record which is skipped */
+static void s_program_record(const uint8_t *pu8Data, uint32_t u32Len)
+{
+    const uint32_t u32Addr = s_u32End;
+
+    flash_program_half_word(u32Addr, (uint16_t)((FLASH_HISTORY_TAG << 8) | u32Len));
+    for (uint32_t i = 0U; i < u32Len; i += 2U) {
+        const uint16_t u16Lo = pu8Data[i];
+        const uint16_t u16Hi = ((i + 1U) < u32Len) ? pu8Data[i + 1U] : 0U;
+        flash_program_half_word(u32Addr + 2U + i, (uint16_t)(u16Lo | (u16Hi << 8)));
+    }
+    flash_program_half_word(u32Addr + FLASH_HISTORY_RECORD(u32Len) - 2U, FLASH_HISTORY_COMMIT);
+
+    s_u32End = u32Addr + FLASH_HISTORY_RECORD(u32Len);
+}
+
+
+static void s_erase(void)
+{
+#if defined(STM32F4)
+    flash_erase_sector(FLASH_HISTORY_SECTOR, FLASH_CR_PROGRAM_X32);
+    /* the data cache may still hold the erased contents */
+    if (0U != (FLASH_ACR & FLASH_ACR_DCEN)) {
+        flash_dcache_disable();
+        flash_dcache_reset();
+        flash_dcache_enable();
+    }
+#else
+    for (uint32_t u32Addr = FLASH_HISTORY_BASE; u32Addr < FLASH_HISTORY_END; u32Addr += FLASH_HISTORY_PAGE) {
+        flash_erase_page(u32Addr);
+    }
+#endif /* defined(STM32F4) */
+
+    s_u32End = FLASH_HISTORY_BASE;
+}
+
+
+/* area full: keep the newest committed records that fit the carry buffer, erase, write them back */
+static void s_compact(void)
+{
+    uint32_t u32Total = 0U;
+    uint32_t u32Carry = 0U;
+    uint32_t u32Addr;
+    uint32_t u32Len;
+
+    for (u32Addr = FLASH_HISTORY_BASE; 0U != (u32Len = s_record_len(u32Addr)); u32Addr += FLASH_HISTORY_RECORD(u32Len)) {
+        if (s_record_committed(u32Addr, u32Len)) {
+            u32Total += 1U + u32Len;
+        }
+    }
+
+    for (u32Addr = FLASH_HISTORY_BASE; 0U != (u32Len = s_record_len(u32Addr)); u32Addr += FLASH_HISTORY_RECORD(u32Len)) {
+        if (s_record_committed(u32Addr, u32Len)) {
+            if (u32Total <= FLASH_HISTORY_CARRY_SIZE) {
+                s_au8Carry[u32Carry] = (uint8_t)u32Len;
+                memcpy(&s_au8Carry[u32Carry + 1U], (const void *)(uintptr_t)(u32Addr + 2U), u32Len);
+                u32Carry += 1U + u32Len;
+            }
+            u32Total -= 1U + u32Len;
+        }
+    }
+
+    s_erase();
+
+    for (uint32_t u32Pos = 0U; u32Pos < u32Carry; u32Pos += 1U + s_au8Carry[u32Pos]) {
+        s_program_record(&s_au8Carry[u32Pos + 1U], s_au8Carry[u32Pos]);
+    }
+}
+
+
+/*-----------------------------------------------------------------------------*/
+static size_t s_next(uint32_t *pu32Cursor, char *pstrBuf, const size_t szSize)
+{
+    uint32_t u32Addr = FLASH_HISTORY_BASE + *pu32Cursor;
+    uint32_t u32Len;
+
+    while ((u32Addr < s_u32End) && (0U != (u32Len = s_record_len(u32Addr)))) {
+        const bool bCommitted = s_record_committed(u32Addr, u32Len);
+        const uint8_t *pu8Data = (const uint8_t *)(uintptr_t)(u32Addr + 2U);
+
+        u32Addr += FLASH_HISTORY_RECORD(u32Len);
+        *pu32Cursor = u32Addr - FLASH_HISTORY_BASE;
+
+        if (bCommitted && (szSize > 0U)) {
+            const size_t szCopy = (u32Len < szSize) ? u32Len : (szSize - 1U);
+            memcpy(pstrBuf, pu8Data, szCopy);
+            pstrBuf[szCopy] = '\0';
+            return u32Len;
+        }
+    }
+
+    return 0U;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+static void s_append(const char *pstrEntry, const size_t szLen)
+{
+    taskENTER_CRITICAL();
+    if ((0U != szLen) && ((s_u32QueueLen + 1U + szLen) <= FLASH_HISTORY_QUEUE_SIZE)) {
+        s_au8Queue[s_u32QueueLen] = (uint8_t)szLen;
+        memcpy(&s_au8Queue[s_u32QueueLen + 1U], pstrEntry, szLen);
+        s_u32QueueLen = s_u32QueueLen + 1U + (uint32_t)szLen;
+    }   /* a full queue drops the entry, it is still in the RAM history */
+    s_xLastPush = xTaskGetTickCount();
+    taskEXIT_CRITICAL();
+}
+
+
+/*-----------------------------------------------------------------------------*/
+static void s_clear(void)
+{
+    taskENTER_CRITICAL();
+    s_u32QueueLen = 0U;
+    s_u32Generation = s_u32Generation + 1U;
+    s_bErase = true;
+    s_xLastPush = xTaskGetTickCount();
+    taskEXIT_CRITICAL();
+}
+
+
+/*-----------------------------------------------------------------------------*/
+const uShellHistoryStore_s *flash_history_store(void)
+{
+    static const uShellHistoryStore_s s_sStore = { s_next, s_append, s_clear };
+
+    if (0U == s_u32End) {
+        s_scan();
+    }
+    return &s_sStore;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+void flash_history_idle(void)
+{
+    if ((0U == s_u32End) || ((0U == s_u32QueueLen) && !s_bErase) ||
+        ((xTaskGetTickCount() - s_xLastPush) < pdMS_TO_TICKS(FLASH_HISTORY_IDLE_MS))) {
+        return;
+    }
+
+    /* the shell task only appends beyond u32Len, or restarts the queue with a clear */
+    taskENTER_CRITICAL();
+    const uint32_t u32Len = s_u32QueueLen;
+    const uint32_t u32Generation = s_u32Generation;
+    const bool bErase = s_bErase;
+    s_bErase = false;
+    taskEXIT_CRITICAL();
+
+    uint32_t u32Pos = 0U;
+
+    /* no switch to a task programming the flash as well (mwrite) while it is unlocked here:
+       its flash_lock() would fail the writes left; the fetch stalls meanwhile anyway */
+    vTaskSuspendAll();
+    flash_unlock();
+    if (bErase) {
+        s_erase();
+    }
+    while (u32Pos < u32Len) {
+        const uint32_t u32RecLen = s_au8Queue[u32Pos];
+        if ((0U == u32RecLen) || ((u32Pos + 1U + u32RecLen) > u32Len)) {
+            break;   /* cleared and refilled meanwhile, erased again at the next idle */
+        }
+        if ((s_u32End + FLASH_HISTORY_RECORD(u32RecLen)) > FLASH_HISTORY_END) {
+            s_compact();
+        }
+        s_program_record(&s_au8Queue[u32Pos + 1U], u32RecLen);
+        u32Pos += 1U + u32RecLen;
+    }
+    flash_lock();
+    (void)xTaskResumeAll();
+
+    taskENTER_CRITICAL();
+    if (u32Generation == s_u32Generation) {
+        memmove(&s_au8Queue[0], &s_au8Queue[u32Pos], s_u32QueueLen - u32Pos);
+        s_u32QueueLen = s_u32QueueLen - u32Pos;
+    }
+    taskEXIT_CRITICAL();
+}
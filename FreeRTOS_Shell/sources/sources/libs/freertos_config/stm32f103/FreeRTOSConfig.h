@@ -1,11 +1,23 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
-/* STM32F103 - Cortex-M3 @ 72MHz */
+/* STM32F103 - Cortex-M3 @ 72MHz (clock_profile: 72 / 48 / 16 MHz) */
+
+/* the core clock of the clock profile in use (libopencm3), read when SysTick is started */
+#if !defined(__ASSEMBLER__)
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern uint32_t rcc_ahb_frequency;
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 #define configUSE_PREEMPTION                    1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
-#define configUSE_TICKLESS_IDLE                 0
-#define configCPU_CLOCK_HZ                      72000000UL
+#define configUSE_TICKLESS_IDLE                 2   /* power_mgr: STOP mode, RTC time base */
+#define configCPU_CLOCK_HZ                      (rcc_ahb_frequency)    /* clock_profile switches it at run time */
 #define configTICK_RATE_HZ                      1000
 #define configMAX_PRIORITIES                    5
 #define configMINIMAL_STACK_SIZE                128
@@ -13,6 +25,7 @@
 #define configUSE_16_BIT_TICKS                  0
 #define configIDLE_SHOULD_YIELD                 1
 #define configUSE_TASK_NOTIFICATIONS            1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2      /* 1: the UART TX room (uart_access) */
 #define configUSE_MUTEXES                       1
 #define configUSE_RECURSIVE_MUTEXES             1
 #define configUSE_COUNTING_SEMAPHORES           1
@@ -24,13 +37,18 @@
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
 
 /* Memory allocation - STM32F103 has 20KB RAM */
-#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_STATIC_ALLOCATION         1   /* active objects embed their task and queue memory */
+#define configKERNEL_PROVIDED_STATIC_MEMORY     1   /* idle and timer task memory from the kernel */
+#if defined(NO_HEAP) && (NO_HEAP == 1)
+#define configSUPPORT_DYNAMIC_ALLOCATION        0   /* heap-free build: no FreeRTOS heap at all */
+#else
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
-#define configTOTAL_HEAP_SIZE                   ((size_t)(14 * 1024))
+#define configTOTAL_HEAP_SIZE                   ((size_t)(6 * 1024))   /* shell and blink tasks */
+#endif
 
 /* Hook functions */
-#define configUSE_IDLE_HOOK                     0
-#define configUSE_TICK_HOOK                     0
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     1   /* mono_time: an epoch a second */
 #define configCHECK_FOR_STACK_OVERFLOW          2
 #define configUSE_MALLOC_FAILED_HOOK            1
 
@@ -74,11 +92,64 @@
 #define INCLUDE_xTaskGetHandle                  1
 
 #define configUSE_TRACE_FACILITY                1
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
+#define configRUN_TIME_COUNTER_TYPE             uint64_t    /* microseconds, no wrap */
+
+/* Run time stats (sys_info): tick count and SysTick, counts through sleep and STOP */
+#if !defined(__ASSEMBLER__)
+#ifdef __cplusplus
+extern "C"
+#endif
+uint64_t sys_info_run_time(void);
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        sys_info_run_time()
 
 /* Cortex-M specific handlers */
 #define vPortSVCHandler     sv_call_handler
 #define xPortPendSVHandler  pend_sv_handler
+#if defined(ISR_PROF) && (ISR_PROF == 1)
+#define xPortSysTickHandler port_sys_tick_handler   /* sys_tick_handler times it (isr_prof) */
+#elif defined(AO_PORT) && (AO_PORT == 4)
+#define xPortSysTickHandler port_sys_tick_handler   /* AO_PORT_BARE_METAL: the superloop tick is the application's */
+#else
 #define xPortSysTickHandler sys_tick_handler
+#endif
+
+/* ISR and critical section latency profiler (isr_prof), the outermost critical section */
+#if defined(ISR_PROF) && (ISR_PROF == 1)
+#if !defined(__ASSEMBLER__)
+#ifdef __cplusplus
+extern "C" {
+#endif
+void isr_prof_critical_enter(void);
+void isr_prof_critical_exit(void);
+#ifdef __cplusplus
+}
+#endif
+#endif
+#define traceCRITICAL_ENTER()                   isr_prof_critical_enter()
+#define traceCRITICAL_EXIT()                    isr_prof_critical_exit()
+#endif
+
+/* Event trace recorder (trace_rec), a task switch record */
+#if defined(TRACE_REC) && (TRACE_REC == 1)
+#if !defined(__ASSEMBLER__)
+#ifdef __cplusplus
+extern "C"
+#endif
+void trace_rec_task_in(void *pvTask);
+#endif
+#define traceTASK_SWITCHED_IN()                 trace_rec_task_in((void *)pxCurrentTCB)
+#endif
+
+/* Tickless idle (power_mgr) */
+#if !defined(__ASSEMBLER__)
+#ifdef __cplusplus
+extern "C"
+#endif
+void power_mgr_sleep(uint32_t u32ExpectedIdleTicks);
+#endif
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) power_mgr_sleep(xExpectedIdleTime)
 
 #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef I2C_MASTER_H
+#define I2C_MASTER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Interrupt driven I2C1 bus manager, PB6 SCL / PB7 SDA (4.7k pull-ups).
+
+        i2c_master_setup();                                         once, from a task or before the scheduler
+        i2c_master_write(0x27, au8Bytes, sizeof(au8Bytes));        from tasks
+        i2c_master_read_byte(0x27, &u8Port);
+        i2c_master_set_speed(0x50, 400000U);                        a fast mode device, once
+
+    A write is one START / ADDR / DATA... / STOP transaction driven by the event and error
+    interrupts, the calling task blocks on its notification until the STOP (or the error)
+    and the CPU is free meanwhile. The callers are serialised by a mutex, so transfers from
+    several tasks queue up in priority order (the mutex wait list), and a low priority
+    client holding the bus inherits the priority of the one waiting. A transfer which does
+    not end within I2C_MASTER_TIMEOUT_MS plus the time for its bytes (stuck bus, no pull-ups)
+    resets the peripheral; STOP mode is held off while one runs (power_mgr_lock()).
+
+    Every device runs at its own SCL rate (the PCF8574 is a 100 kHz part, an EEPROM or a
+    sensor can take 400 kHz): the clock is reprogrammed when the next transfer is for a
+    device at another rate, between transactions, and again from the new APB1 clock after a
+    clock profile switch (i2c_master_resume()).
+
+    Bus recovery: a slave holding SDA low (reset in the middle of a read) is clocked out
+    with up to 9 SCL pulses as GPIO and a STOP, at setup and after a bus error or timeout.
+*/
+
+#define I2C_MASTER_TIMEOUT_MS       5U      /* on top of ~0.1 ms per byte at 100 kHz */
+#define I2C_MASTER_DEFAULT_HZ       100000U /* devices without i2c_master_set_speed() */
+#define I2C_MASTER_MAX_DEVICES      4U      /* addresses with their own rate */
+
+#define I2C_MASTER_OK               0
+#define I2C_MASTER_NACK             (-1)    /* address or data not acknowledged */
+#define I2C_MASTER_ERROR            (-2)    /* bus error, arbitration lost or timeout */
+
+void i2c_master_setup(void);
+
+/* blocks the calling task until the transfer ended, I2C_MASTER_OK or an error */
+int i2c_master_write(uint8_t u8Addr, const uint8_t *pu8Data, uint16_t u16Len);
+
+/* one byte read transaction (a PCF8574 port read), same conventions */
+int i2c_master_read_byte(uint8_t u8Addr, uint8_t *pu8Data);
+
+/* SCL rate for a device, up to 400000 (fast mode); -1 if out of range or the table is full */
+int i2c_master_set_speed(uint8_t u8Addr, uint32_t u32Hz);
+
+/* around a clock change (clock_profile): suspend waits for the transfer running to end and
+   holds the bus, resume programs CCR and TRISE again from the new APB1 clock and releases it */
+void i2c_master_suspend(void);
+void i2c_master_resume(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* I2C_MASTER_H */
@@ -0,0 +1,376 @@
+#include "i2c_master.h"
+#include "power_mgr.h"
+#include "ram_func.h"
+
+#include <libopencm3/stm32/rcc.h>
+#include <libopencm3/stm32/gpio.h>
+#include <libopencm3/stm32/i2c.h>
+#include <libopencm3/cm3/nvic.h>
+#include <libopencm3/cm3/dwt.h>
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+
+/* below configMAX_SYSCALL_INTERRUPT_PRIORITY (numerically higher), the ISRs use the FromISR API */
+#define I2C_MASTER_IRQ_PRIORITY     ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+
+#define I2C_MASTER_IRQS             (I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN)
+#define I2C_MASTER_ERRORS           (I2C_SR1_TIMEOUT | I2C_SR1_OVR | I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR)
+
+#define I2C_MASTER_SCL              GPIO6
+#define I2C_MASTER_SDA              GPIO7
+#define I2C_MASTER_SM_MAX_HZ        100000U
+#define I2C_MASTER_FAST_HZ          400000U
+#define I2C_MASTER_RECOVER_PULSES   9U      /* a slave shifting out a byte and its ACK */
+#define I2C_MASTER_RECOVER_US       5U      /* half a 100 kHz SCL period */
+
+/* the transfer, written by the task before the START and by the ISRs until the end */
+static const uint8_t *s_pu8Data                 = nullptr;
+static uint8_t *s_pu8Rx                         = nullptr;     /* a one byte read, else a write */
+static uint16_t s_u16Len                        = 0U;
+static volatile uint16_t s_u16Pos               = 0U;
+static uint8_t s_u8Addr                         = 0U;
+static volatile bool s_bActive                  = false;
+static volatile int s_iResult                   = I2C_MASTER_OK;
+static TaskHandle_t volatile s_xTask            = nullptr;
+
+static SemaphoreHandle_t s_xMutex               = nullptr;
+static StaticSemaphore_t s_xMutexBuffer;
+
+/* per device SCL rates (0 address = free), the rate programmed now; under the mutex */
+static uint8_t s_au8DevAddr[I2C_MASTER_MAX_DEVICES];
+static uint32_t s_au32DevHz[I2C_MASTER_MAX_DEVICES];
+static uint32_t s_u32Hz                         = I2C_MASTER_DEFAULT_HZ;
+
+
+static void s_delay_us(uint32_t u32Us)
+{
+    const uint32_t u32Start  = DWT_CYCCNT;
+    const uint32_t u32Cycles = (rcc_ahb_frequency / 1000000U) * u32Us;
+
+    while ((DWT_CYCCNT - u32Start) < u32Cycles) {
+    }
+}
+
+
+static void s_pins_i2c(void)
+{
+#if defined(STM32F1)
+    gpio_set_mode(GPIOB, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_OPENDRAIN, I2C_MASTER_SCL | I2C_MASTER_SDA);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    gpio_set_output_options(GPIOB, GPIO_OTYPE_OD, GPIO_OSPEED_50MHZ, I2C_MASTER_SCL | I2C_MASTER_SDA);
+    gpio_set_af(GPIOB, GPIO_AF4, I2C_MASTER_SCL | I2C_MASTER_SDA);
+    gpio_mode_setup(GPIOB, GPIO_MODE_AF, GPIO_PUPD_NONE, I2C_MASTER_SCL | I2C_MASTER_SDA);
+#endif /*defined(STM32F4)*/
+}
+
+
+/* SDA held low by a slave in the middle of a byte: clock it out, then a STOP */
+static void s_bus_recover(void)
+{
+    gpio_set(GPIOB, I2C_MASTER_SCL | I2C_MASTER_SDA);
+#if defined(STM32F1)
+    gpio_set_mode(GPIOB, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_OPENDRAIN, I2C_MASTER_SCL | I2C_MASTER_SDA);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    gpio_mode_setup(GPIOB, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, I2C_MASTER_SCL | I2C_MASTER_SDA);
+#endif /*defined(STM32F4)*/
+    s_delay_us(I2C_MASTER_RECOVER_US);
+
+    for (uint32_t i = 0U; (i < I2C_MASTER_RECOVER_PULSES) && (0U == gpio_get(GPIOB, I2C_MASTER_SDA)); i++) {
+        gpio_clear(GPIOB, I2C_MASTER_SCL);
+        s_delay_us(I2C_MASTER_RECOVER_US);
+        gpio_set(GPIOB, I2C_MASTER_SCL);
+        s_delay_us(I2C_MASTER_RECOVER_US);
+    }
+
+    /* STOP: SDA rises while SCL is high */
+    gpio_clear(GPIOB, I2C_MASTER_SDA);
+    s_delay_us(I2C_MASTER_RECOVER_US);
+    gpio_set(GPIOB, I2C_MASTER_SDA);
+    s_delay_us(I2C_MASTER_RECOVER_US);
+
+    s_pins_i2c();
+}
+
+
+/* CCR and TRISE for u32Hz, the peripheral disabled meanwhile */
+static void s_apply_speed(uint32_t u32Hz)
+{
+    const uint32_t u32Mhz = rcc_apb1_frequency / 1000000U;
+    uint32_t u32Ccr;
+
+    i2c_peripheral_disable(I2C1);
+    i2c_set_clock_frequency(I2C1, u32Mhz);
+    if (u32Hz > I2C_MASTER_SM_MAX_HZ) {
+        /* fast mode, Tlow = 2 Thigh */
+        u32Ccr = rcc_apb1_frequency / (3U * u32Hz);
+        i2c_set_fast_mode(I2C1);
+        i2c_set_dutycycle(I2C1, I2C_CCR_DUTY_DIV2);
+        i2c_set_ccr(I2C1, (u32Ccr < 1U) ? 1U : u32Ccr);
+        i2c_set_trise(I2C1, ((u32Mhz * 300U) / 1000U) + 1U);   /* 300 ns */
+    } else {
+        u32Ccr = rcc_apb1_frequency / (2U * u32Hz);
+        i2c_set_standard_mode(I2C1);
+        i2c_set_ccr(I2C1, (u32Ccr < 4U) ? 4U : u32Ccr);
+        i2c_set_trise(I2C1, u32Mhz + 1U);                       /* 1000 ns */
+    }
+    i2c_peripheral_enable(I2C1);
+    s_u32Hz = u32Hz;
+}
+
+
+/* reset and reprogram, after the bus was released */
+static void s_peripheral_init(void)
+{
+    if (0U == gpio_get(GPIOB, I2C_MASTER_SDA)) {
+        s_bus_recover();
+    }
+    rcc_periph_reset_pulse(RST_I2C1);
+    s_apply_speed(s_u32Hz);
+}
+
+
+static uint32_t s_device_hz(uint8_t u8Addr)
+{
+    for (uint32_t i = 0U; i < I2C_MASTER_MAX_DEVICES; i++) {
+        if ((0U != s_au32DevHz[i]) && (u8Addr == s_au8DevAddr[i])) {
+            return s_au32DevHz[i];
+        }
+    }
+    return I2C_MASTER_DEFAULT_HZ;
+}
+
+
+/* ISR context (or the task with the ISRs masked): stop the interrupts, wake the task */
+static void s_finish(int iResult, BaseType_t *pxWoken)
+{
+    I2C_CR2(I2C1) = I2C_CR2(I2C1) & ~I2C_MASTER_IRQS;
+    s_iResult = iResult;
+    s_bActive = false;
+
+    if (nullptr != s_xTask) {
+        vTaskNotifyGiveFromISR(s_xTask, pxWoken);
+    }
+}
+
+
+/*--------------------------------------------------*/
+void i2c_master_setup(void)
+{
+    if (nullptr != s_xMutex) {
+        return;
+    }
+    s_xMutex = xSemaphoreCreateMutexStatic(&s_xMutexBuffer);
+
+    rcc_periph_clock_enable(RCC_I2C1);
+    rcc_periph_clock_enable(RCC_GPIOB);
+    dwt_enable_cycle_counter();
+
+    /* the pins as GPIO first: a slave left in the middle of a byte by a reset is freed */
+    s_bus_recover();
+    s_peripheral_init();
+
+    nvic_set_priority(NVIC_I2C1_EV_IRQ, I2C_MASTER_IRQ_PRIORITY);
+    nvic_set_priority(NVIC_I2C1_ER_IRQ, I2C_MASTER_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_I2C1_EV_IRQ);
+    nvic_enable_irq(NVIC_I2C1_ER_IRQ);
+}
+
+
+/* one transaction, the task sleeps until the ISRs end it */
+static int s_transfer(uint8_t u8Addr, const uint8_t *pu8Data, uint16_t u16Len, uint8_t *pu8Rx)
+{
+    const TickType_t xTimeout = pdMS_TO_TICKS(I2C_MASTER_TIMEOUT_MS + ((uint32_t)u16Len + 10U) / 10U);
+    int iResult;
+
+    if (nullptr == s_xMutex) {
+        return I2C_MASTER_ERROR;
+    }
+
+    (void)xSemaphoreTake(s_xMutex, portMAX_DELAY);
+    power_mgr_lock();
+
+    const uint32_t u32Hz = s_device_hz(u8Addr);
+    if (u32Hz != s_u32Hz) {
+        s_apply_speed(u32Hz);
+    }
+
+    /* a STOP still going out from the previous transfer */
+    if (0U != (I2C_SR2(I2C1) & I2C_SR2_BUSY)) {
+        vTaskDelay(1);
+        if (0U != (I2C_SR2(I2C1) & I2C_SR2_BUSY)) {
+            s_peripheral_init();
+        }
+    }
+
+    s_pu8Data = pu8Data;
+    s_pu8Rx   = pu8Rx;
+    s_u16Len  = u16Len;
+    s_u16Pos  = 0U;
+    s_u8Addr  = u8Addr;
+    s_iResult = I2C_MASTER_ERROR;
+    s_xTask   = xTaskGetCurrentTaskHandle();
+    s_bActive = true;
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+
+    I2C_CR2(I2C1) = I2C_CR2(I2C1) | I2C_MASTER_IRQS;
+    i2c_send_start(I2C1);
+
+    if (0U == ulTaskNotifyTake(pdTRUE, xTimeout)) {
+        taskENTER_CRITICAL();
+        const bool bStuck = s_bActive;
+        if (true == bStuck) {
+            I2C_CR2(I2C1) = I2C_CR2(I2C1) & ~I2C_MASTER_IRQS;
+            s_bActive = false;
+            s_iResult = I2C_MASTER_ERROR;
+        }
+        taskEXIT_CRITICAL();
+
+        if (true == bStuck) {
+            s_peripheral_init();
+        }
+        (void)ulTaskNotifyTake(pdTRUE, 0);      /* the ISR may have ended it meanwhile */
+    }
+
+    iResult = s_iResult;
+    s_xTask = nullptr;
+
+    power_mgr_unlock();
+    (void)xSemaphoreGive(s_xMutex);
+    return iResult;
+}
+
+
+/*--------------------------------------------------*/
+int i2c_master_write(uint8_t u8Addr, const uint8_t *pu8Data, uint16_t u16Len)
+{
+    if (0U == u16Len) {
+        return I2C_MASTER_ERROR;
+    }
+    return s_transfer(u8Addr, pu8Data, u16Len, nullptr);
+}
+
+
+/*--------------------------------------------------*/
+int i2c_master_read_byte(uint8_t u8Addr, uint8_t *pu8Data)
+{
+    return s_transfer(u8Addr, nullptr, 1U, pu8Data);
+}
+
+
+/*--------------------------------------------------*/
+int i2c_master_set_speed(uint8_t u8Addr, uint32_t u32Hz)
+{
+    int iResult = -1;
+
+    if ((nullptr == s_xMutex) || (0U == u32Hz) || (u32Hz > I2C_MASTER_FAST_HZ)) {
+        return -1;
+    }
+
+    (void)xSemaphoreTake(s_xMutex, portMAX_DELAY);
+    for (uint32_t i = 0U; i < I2C_MASTER_MAX_DEVICES; i++) {
+        if ((0U == s_au32DevHz[i]) || (u8Addr == s_au8DevAddr[i])) {
+            s_au8DevAddr[i] = u8Addr;
+            s_au32DevHz[i]  = u32Hz;
+            iResult = 0;
+            break;
+        }
+    }
+    (void)xSemaphoreGive(s_xMutex);
+    return iResult;
+}
+
+
+/*--------------------------------------------------*/
+void i2c_master_suspend(void)
+{
+    if (nullptr != s_xMutex) {
+        (void)xSemaphoreTake(s_xMutex, portMAX_DELAY);
+    }
+}
+
+
+/*--------------------------------------------------*/
+void i2c_master_resume(void)
+{
+    if (nullptr == s_xMutex) {
+        return;     /* not set up yet, i2c_master_setup() reads the clock then */
+    }
+    s_apply_speed(s_u32Hz);
+    (void)xSemaphoreGive(s_xMutex);
+}
+
+
+/*--------------------------------------------------*/
+/* write: SB -> address, ADDR -> clear, TxE -> next byte, BTF after the last -> STOP
+   read:  SB -> address, ADDR -> NACK, clear and STOP, RxNE -> the byte */
+extern "C" RAM_FUNC void i2c1_ev_isr(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t u32Sr1 = I2C_SR1(I2C1);
+
+    if (0U != (u32Sr1 & I2C_SR1_SB)) {
+        I2C_DR(I2C1) = (uint8_t)((s_u8Addr << 1) | ((nullptr != s_pu8Rx) ? 1U : 0U));
+        return;
+    }
+
+    if (nullptr != s_pu8Rx) {
+        if (0U != (u32Sr1 & I2C_SR1_ADDR)) {
+            /* single byte: NACK before ADDR is cleared, STOP right after (nothing in between) */
+            I2C_CR1(I2C1) = I2C_CR1(I2C1) & ~I2C_CR1_ACK;
+            __asm volatile("cpsid i" ::: "memory");
+            (void)I2C_SR2(I2C1);
+            i2c_send_stop(I2C1);
+            __asm volatile("cpsie i" ::: "memory");
+        } else if (0U != (u32Sr1 & I2C_SR1_RxNE)) {
+            *s_pu8Rx = (uint8_t)I2C_DR(I2C1);
+            s_finish(I2C_MASTER_OK, &xHigherPriorityTaskWoken);
+        }
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        return;
+    }
+
+    if (0U != (u32Sr1 & I2C_SR1_ADDR)) {
+        (void)I2C_SR2(I2C1);
+        u32Sr1 = I2C_SR1(I2C1);
+    }
+
+    if (0U != (u32Sr1 & (I2C_SR1_TxE | I2C_SR1_BTF))) {
+        if (s_u16Pos < s_u16Len) {
+            I2C_DR(I2C1) = s_pu8Data[s_u16Pos];
+            s_u16Pos = s_u16Pos + 1U;
+        } else if (0U != (u32Sr1 & I2C_SR1_BTF)) {
+            i2c_send_stop(I2C1);
+            s_finish(I2C_MASTER_OK, &xHigherPriorityTaskWoken);
+        } else {
+            /* last byte in the shift register: no more TxE, wait for its BTF */
+            I2C_CR2(I2C1) = I2C_CR2(I2C1) & ~I2C_CR2_ITBUFEN;
+        }
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+/*--------------------------------------------------*/
+extern "C" RAM_FUNC void i2c1_er_isr(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    const uint32_t u32Sr1 = I2C_SR1(I2C1);
+
+    I2C_SR1(I2C1) = u32Sr1 & ~I2C_MASTER_ERRORS;   /* rc_w0 */
+
+    /* after a lost arbitration the peripheral is a slave already, no STOP to send */
+    if (0U == (u32Sr1 & I2C_SR1_ARLO)) {
+        i2c_send_stop(I2C1);
+    }
+    if (true == s_bActive) {
+        s_finish((0U != (u32Sr1 & I2C_SR1_AF)) ? I2C_MASTER_NACK : I2C_MASTER_ERROR, &xHigherPriorityTaskWoken);
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
@@ -0,0 +1,101 @@
+#ifndef INPUT_LAT_H
+#define INPUT_LAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+    Button input latency per stage, built with -DUSHELL_INPUT_LAT=ON (INPUT_LAT 1).
+
+    Every burst of edges a ButtonAO debounces is stamped with DWT_CYCCNT along its way:
+
+        edge        EXTI ISR entry of the first edge of the burst (ButtonAO::onISR)
+        post        the edge posted to the ButtonAO queue
+        dequeue     the AO dispatches it and arms the debounce
+        debounce    the debounce timeout sampled a new level
+        notify      the ButtonCallbackFn called for it (and its return)
+
+    inputlat prints per stage count, min, avg and max in microseconds and a histogram of power
+    of two microsecond buckets, plus edge > notify end to end: the debounce (debounceTicks) is
+    the dequeue > debounce stage, the scheduler the post > dequeue one. The edge is the first
+    instruction of the handler, the hardware entry and a higher priority handler running
+    before it are not counted (isrprof has the EXTI vectors). A burst which settles on the
+    level it started from (a glitch) ends at debounce: counted, no notify. The cycles are
+    turned into microseconds at the AHB clock of the sample, a clock profile switch in the
+    middle of a burst makes that one wrong.
+
+    INPUT_LAT_MARKER (-DUSHELL_INPUT_LAT_MARKER=ON) drives PB14 for a logic analyser beside
+    the button pin: high from the post to the dequeue (ISR, queue and scheduler), high again
+    from the debounce to the return of the callback (state machine and callback).
+
+    Without INPUT_LAT the macros are empty and ButtonAO carries no stamps.
+*/
+
+#define INPUT_LAT_HIST_BUCKETS  17U     /* < 2, < 4, ... < 65536, >= 65536 us */
+
+typedef enum {
+    INPUT_LAT_EDGE_POST,
+    INPUT_LAT_POST_DEQUEUE,
+    INPUT_LAT_DEQUEUE_DEBOUNCE,
+    INPUT_LAT_DEBOUNCE_NOTIFY,
+    INPUT_LAT_CALLBACK,
+    INPUT_LAT_EDGE_NOTIFY,          /* end to end */
+    INPUT_LAT_STAGES
+} input_lat_stage_e;
+
+/* the stamps of the burst a ButtonAO is debouncing, one per button */
+typedef struct {
+    uint32_t u32Edge;
+    uint32_t u32Post;
+    uint32_t u32Dequeue;
+    uint32_t u32Debounce;
+    uint32_t u32Notify;
+    uint8_t  u8State;               /* the last stage reached, input_lat.cpp */
+} input_lat_burst_s;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the cycle counter and the marker pin, before the buttons */
+void input_lat_init(void);
+
+/* from the EXTI ISR: the burst was posted (edge stamped at the handler entry), or the edge
+   merged into the burst already queued */
+void input_lat_posted(input_lat_burst_s *psBurst, uint32_t u32Edge);
+void input_lat_coalesced(void);
+
+/* from the ButtonAO task */
+void input_lat_dequeued(input_lat_burst_s *psBurst);
+void input_lat_debounced(input_lat_burst_s *psBurst, bool bChanged);
+void input_lat_notify_begin(input_lat_burst_s *psBurst);
+void input_lat_notify_end(input_lat_burst_s *psBurst);
+void input_lat_burst_end(input_lat_burst_s *psBurst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(INPUT_LAT) && (INPUT_LAT == 1)
+#include <libopencm3/cm3/dwt.h>
+
+#define INPUT_LAT_STAMP()                   DWT_CYCCNT
+#define INPUT_LAT_POSTED(b, edge)           input_lat_posted((b), (edge))
+#define INPUT_LAT_COALESCED()               input_lat_coalesced()
+#define INPUT_LAT_DEQUEUED(b)               input_lat_dequeued(b)
+#define INPUT_LAT_DEBOUNCED(b, changed)     input_lat_debounced((b), (changed))
+#define INPUT_LAT_NOTIFY_BEGIN(b)           input_lat_notify_begin(b)
+#define INPUT_LAT_NOTIFY_END(b)             input_lat_notify_end(b)
+#define INPUT_LAT_BURST_END(b)              input_lat_burst_end(b)
+#else
+#define INPUT_LAT_STAMP()                   0U
+#define INPUT_LAT_POSTED(b, edge)           ((void)(edge))
+#define INPUT_LAT_COALESCED()
+#define INPUT_LAT_DEQUEUED(b)
+#define INPUT_LAT_DEBOUNCED(b, changed)
+#define INPUT_LAT_NOTIFY_BEGIN(b)
+#define INPUT_LAT_NOTIFY_END(b)
+#define INPUT_LAT_BURST_END(b)
+#endif
+
+#endif /* INPUT_LAT_H */
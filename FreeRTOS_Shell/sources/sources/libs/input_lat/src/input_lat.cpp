@@ -0,0 +1,243 @@
+#include "input_lat.h"
+#include "ram_func.h"
+#include "ushell_core_printout.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if defined(INPUT_LAT) && (INPUT_LAT == 1)
+#include <libopencm3/stm32/rcc.h>
+#include <libopencm3/stm32/gpio.h>
+
+#include <string.h>
+
+#define INPUT_LAT_MARKER_PORT   GPIOB
+#define INPUT_LAT_MARKER_PIN    GPIO14
+#define INPUT_LAT_MARKER_RCC    RCC_GPIOB
+
+#if defined(INPUT_LAT_MARKER) && (INPUT_LAT_MARKER == 1)
+#define MARKER_HIGH()           gpio_set(INPUT_LAT_MARKER_PORT, INPUT_LAT_MARKER_PIN)
+#define MARKER_LOW()            gpio_clear(INPUT_LAT_MARKER_PORT, INPUT_LAT_MARKER_PIN)
+#else
+#define MARKER_HIGH()
+#define MARKER_LOW()
+#endif
+
+/* the last stage a burst reached */
+enum {
+    BURST_IDLE,
+    BURST_POSTED,
+    BURST_DEQUEUED,
+    BURST_DEBOUNCED,
+    BURST_NOTIFY
+};
+
+typedef struct {
+    uint32_t u32Count;
+    uint32_t u32Min;            /* ns */
+    uint32_t u32Max;
+    uint64_t u64Sum;
+    uint32_t au32Hist[INPUT_LAT_HIST_BUCKETS];
+} input_lat_stat_s;
+
+static const char *const s_apstrNames[INPUT_LAT_STAGES] = {
+    "edge>post", "post>dequeue", "dequeue>debounce", "debounce>notify", "callback", "edge>notify"
+};
+
+static input_lat_stat_s s_asStats[INPUT_LAT_STAGES];
+static uint32_t s_u32Bursts    = 0U;
+static uint32_t s_u32Coalesced = 0U;    /* bounce edges merged into a queued burst */
+static uint32_t s_u32Glitches  = 0U;    /* bursts back on the level they started from */
+
+
+static void reset(input_lat_stat_s *psStat)
+{
+    memset(psStat, 0, sizeof(*psStat));
+    psStat->u32Min = UINT32_MAX;
+}
+
+
+/* bucket of a sample: by the bit length of its microseconds, 0 below 2 us */
+static uint32_t bucket(uint32_t u32Us)
+{
+    const uint32_t u32Bits = 32U - (uint32_t)__builtin_clz(u32Us | 1U);
+
+    return (u32Bits <= INPUT_LAT_HIST_BUCKETS) ? (u32Bits - 1U) : (INPUT_LAT_HIST_BUCKETS - 1U);
+}
+
+
+/* the cycles from u32From to u32To in ns, at the AHB clock now (a sample ends in the task) */
+static void record(input_lat_stage_e eStage, uint32_t u32From, uint32_t u32To)
+{
+    input_lat_stat_s *psStat = &s_asStats[eStage];
+    const uint64_t    u64Ns  = ((uint64_t)(u32To - u32From) * 1000ULL) / (rcc_ahb_frequency / 1000000UL);
+    const uint32_t    u32Ns  = (u64Ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)u64Ns;
+
+    taskENTER_CRITICAL();                   /* the command copies the stats of a stage at once */
+    psStat->u32Count++;
+    psStat->u64Sum += u32Ns;
+    if (u32Ns < psStat->u32Min) psStat->u32Min = u32Ns;
+    if (u32Ns > psStat->u32Max) psStat->u32Max = u32Ns;
+    psStat->au32Hist[bucket(u32Ns / 1000U)]++;
+    taskEXIT_CRITICAL();
+}
+
+
+extern "C" void input_lat_init(void)
+{
+    for (uint32_t i = 0U; i < INPUT_LAT_STAGES; i++) {
+        reset(&s_asStats[i]);
+    }
+    dwt_enable_cycle_counter();
+
+#if defined(INPUT_LAT_MARKER) && (INPUT_LAT_MARKER == 1)
+    rcc_periph_clock_enable(INPUT_LAT_MARKER_RCC);
+    gpio_clear(INPUT_LAT_MARKER_PORT, INPUT_LAT_MARKER_PIN);
+#if defined(STM32F1)
+    gpio_set_mode(INPUT_LAT_MARKER_PORT, GPIO_MODE_OUTPUT_50_MHZ,
+                  GPIO_CNF_OUTPUT_PUSHPULL, INPUT_LAT_MARKER_PIN);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    gpio_mode_setup(INPUT_LAT_MARKER_PORT, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, INPUT_LAT_MARKER_PIN);
+    gpio_set_output_options(INPUT_LAT_MARKER_PORT, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, INPUT_LAT_MARKER_PIN);
+#endif /*defined(STM32F4)*/
+#endif /*defined(INPUT_LAT_MARKER) && (INPUT_LAT_MARKER == 1)*/
+}
+
+
+/* a new burst replaces the one of the task if it races the end of it (the sample is lost) */
+extern "C" RAM_FUNC void input_lat_posted(input_lat_burst_s *psBurst, uint32_t u32Edge)
+{
+    psBurst->u32Post = DWT_CYCCNT;
+    psBurst->u32Edge = u32Edge;
+    psBurst->u8State = BURST_POSTED;
+    s_u32Bursts++;
+    MARKER_HIGH();
+}
+
+
+extern "C" RAM_FUNC void input_lat_coalesced(void)
+{
+    s_u32Coalesced++;
+}
+
+
+extern "C" void input_lat_dequeued(input_lat_burst_s *psBurst)
+{
+    psBurst->u32Dequeue = DWT_CYCCNT;
+    MARKER_LOW();
+    if (BURST_POSTED != psBurst->u8State) {
+        return;
+    }
+    psBurst->u8State = BURST_DEQUEUED;
+    record(INPUT_LAT_EDGE_POST,    psBurst->u32Edge, psBurst->u32Post);
+    record(INPUT_LAT_POST_DEQUEUE, psBurst->u32Post, psBurst->u32Dequeue);
+}
+
+
+extern "C" void input_lat_debounced(input_lat_burst_s *psBurst, bool bChanged)
+{
+    if (BURST_DEQUEUED != psBurst->u8State) {
+        return;
+    }
+    psBurst->u32Debounce = DWT_CYCCNT;
+    record(INPUT_LAT_DEQUEUE_DEBOUNCE, psBurst->u32Dequeue, psBurst->u32Debounce);
+    if (!bChanged) {
+        s_u32Glitches++;
+        psBurst->u8State = BURST_IDLE;
+        return;
+    }
+    psBurst->u8State = BURST_DEBOUNCED;
+    MARKER_HIGH();
+}
+
+
+/* the first callback of a burst, a long press release notifies twice */
+extern "C" void input_lat_notify_begin(input_lat_burst_s *psBurst)
+{
+    if (BURST_DEBOUNCED != psBurst->u8State) {
+        return;
+    }
+    psBurst->u32Notify = DWT_CYCCNT;
+    psBurst->u8State   = BURST_NOTIFY;
+    record(INPUT_LAT_DEBOUNCE_NOTIFY, psBurst->u32Debounce, psBurst->u32Notify);
+    record(INPUT_LAT_EDGE_NOTIFY,     psBurst->u32Edge,     psBurst->u32Notify);
+}
+
+
+extern "C" void input_lat_notify_end(input_lat_burst_s *psBurst)
+{
+    if (BURST_NOTIFY != psBurst->u8State) {
+        return;
+    }
+    record(INPUT_LAT_CALLBACK, psBurst->u32Notify, DWT_CYCCNT);
+    psBurst->u8State = BURST_IDLE;
+    MARKER_LOW();
+}
+
+
+/* after the debounce: a level change the state machine did not notify ends here */
+extern "C" void input_lat_burst_end(input_lat_burst_s *psBurst)
+{
+    if (BURST_DEBOUNCED == psBurst->u8State) {
+        psBurst->u8State = BURST_IDLE;
+        MARKER_LOW();
+    }
+}
+#endif /*defined(INPUT_LAT) && (INPUT_LAT == 1)*/
+
+
+// -- shell command -----------------------------------------------------------
+
+/* inputlat 0 prints the stages with samples, inputlat 1 prints and resets them */
+extern "C" int inputlat(uint32_t u32Reset)
+{
+#if defined(INPUT_LAT) && (INPUT_LAT == 1)
+    uSHELL_PRINTF("%-16s %8s %9s %9s %9s  (us)\n", "stage", "count", "min", "avg", "max");
+
+    for (uint32_t i = 0U; i < INPUT_LAT_STAGES; i++) {
+        input_lat_stat_s sStat;
+
+        taskENTER_CRITICAL();
+        sStat = s_asStats[i];
+        if (u32Reset != 0U) {
+            reset(&s_asStats[i]);
+        }
+        taskEXIT_CRITICAL();
+
+        if (0U == sStat.u32Count) {
+            continue;
+        }
+        const uint32_t u32Avg = (uint32_t)(sStat.u64Sum / sStat.u32Count);
+        uSHELL_PRINTF("%-16s %8u %7u.%u %7u.%u %7u.%u\n", s_apstrNames[i], (unsigned)sStat.u32Count,
+                      (unsigned)(sStat.u32Min / 1000U), (unsigned)((sStat.u32Min % 1000U) / 100U),
+                      (unsigned)(u32Avg / 1000U), (unsigned)((u32Avg % 1000U) / 100U),
+                      (unsigned)(sStat.u32Max / 1000U), (unsigned)((sStat.u32Max % 1000U) / 100U));
+
+        uSHELL_PRINTF("  hist");
+        for (uint32_t b = 0U; b < INPUT_LAT_HIST_BUCKETS; b++) {
+            if (0U == sStat.au32Hist[b]) {
+                continue;
+            }
+            if (b < (INPUT_LAT_HIST_BUCKETS - 1U)) {
+                uSHELL_PRINTF(" <%u:%u", (unsigned)(1UL << (b + 1U)), (unsigned)sStat.au32Hist[b]);
+            } else {
+                uSHELL_PRINTF(" >=%u:%u", (unsigned)(1UL << b), (unsigned)sStat.au32Hist[b]);
+            }
+        }
+        uSHELL_PRINTF("\n");
+    }
+
+    uSHELL_PRINTF("bursts %u, bounce edges merged %u, glitches %u\n",
+                  (unsigned)s_u32Bursts, (unsigned)s_u32Coalesced, (unsigned)s_u32Glitches);
+    if (u32Reset != 0U) {
+        s_u32Bursts    = 0U;
+        s_u32Coalesced = 0U;
+        s_u32Glitches  = 0U;
+    }
+#else
+    (void)u32Reset;
+    uSHELL_PRINTF("inputlat: built with INPUT_LAT 0\n");
+#endif
+    return 0;
+}
@@ -1,35 +1,41 @@
 #include "ButtonRegistry.hpp"
 #include "ButtonAO.hpp"
+#include "isr_prof.h"
+#include "ram_func.h"
 
 extern "C" {
 #include <libopencm3/stm32/exti.h>
 }
 
-// Generic dispatcher — call for every line in a shared IRQ group
-static void dispatch_exti_line(uint8_t line)
+// Generic dispatcher for the lines of one IRQ vector: EXTI_PR is read
+// once, the pending lines are cleared together (write 1 to clear) and
+// only their bits are walked, so the cost follows the lines that fired;
+// timed per vector for isrprof
+static inline void dispatch_exti_lines(uint32_t lines, isr_prof_source_e eSrc)
 {
-    uint32_t mask = (1u << line);
-    if (exti_get_flag_status(mask)) {
-        exti_reset_request(mask);
-        ButtonAO *ao = ButtonRegistry::find(line);
+    ISR_PROF_ENTER(eSrc);
+    uint32_t pending = EXTI_PR & EXTI_IMR & lines;
+
+    EXTI_PR = pending;
+    for (; pending != 0; pending &= pending - 1) {
+        ButtonAO *ao = ButtonRegistry::at((uint8_t)__builtin_ctz(pending));
         if (ao) ao->onISR();
     }
+    ISR_PROF_EXIT(eSrc);
 }
 
-extern "C" void exti0_isr(void)    { dispatch_exti_line(0);  }
-extern "C" void exti1_isr(void)    { dispatch_exti_line(1);  }
-extern "C" void exti2_isr(void)    { dispatch_exti_line(2);  }
-extern "C" void exti3_isr(void)    { dispatch_exti_line(3);  }
-extern "C" void exti4_isr(void)    { dispatch_exti_line(4);  }
+extern "C" RAM_FUNC void exti0_isr(void)    { dispatch_exti_lines(EXTI0, ISR_PROF_EXTI0);  }
+extern "C" RAM_FUNC void exti1_isr(void)    { dispatch_exti_lines(EXTI1, ISR_PROF_EXTI1);  }
+extern "C" RAM_FUNC void exti2_isr(void)    { dispatch_exti_lines(EXTI2, ISR_PROF_EXTI2);  }
+extern "C" RAM_FUNC void exti3_isr(void)    { dispatch_exti_lines(EXTI3, ISR_PROF_EXTI3);  }
+extern "C" RAM_FUNC void exti4_isr(void)    { dispatch_exti_lines(EXTI4, ISR_PROF_EXTI4);  }
 
-extern "C" void exti9_5_isr(void)
+extern "C" RAM_FUNC void exti9_5_isr(void)
 {
-    for (uint8_t line = 5; line <= 9; ++line)
-        dispatch_exti_line(line);
+    dispatch_exti_lines(EXTI5 | EXTI6 | EXTI7 | EXTI8 | EXTI9, ISR_PROF_EXTI9_5);
 }
 
-extern "C" void exti15_10_isr(void)
+extern "C" RAM_FUNC void exti15_10_isr(void)
 {
-    for (uint8_t line = 10; line <= 15; ++line)
-        dispatch_exti_line(line);
-}
\ No newline at end of file
+    dispatch_exti_lines(EXTI10 | EXTI11 | EXTI12 | EXTI13 | EXTI14 | EXTI15, ISR_PROF_EXTI15_10);
+}
@@ -0,0 +1,84 @@
+#ifndef ISR_PROF_H
+#define ISR_PROF_H
+
+#include <stdint.h>
+#include "trace_rec.h"
+
+/*
+    ISR and critical section latency profiler, built with -DUSHELL_ISR_PROF=ON (ISR_PROF 1).
+
+        extern "C" void usart1_isr(void)
+        {
+            ISR_PROF_ENTER(ISR_PROF_USART1);
+            ...
+            ISR_PROF_EXIT(ISR_PROF_USART1);
+        }
+
+    ENTER takes DWT_CYCCNT into a local, EXIT adds the cycles since to the source: count, min,
+    max, sum and a histogram of power of two buckets (the first below 2^ISR_PROF_HIST_SHIFT
+    cycles, the last open ended). The time is counted from the first instruction of the
+    handler, the hardware entry (12 cycles, more with a lazy FPU stack) is not in it, and it
+    includes the handlers of higher priority that preempted it. With TRACE_REC both macros
+    also put an ISR record in the trace (trace_rec.h), with or without ISR_PROF.
+
+    SysTick is wrapped here (FreeRTOSConfig.h renames the port handler to
+    port_sys_tick_handler). The outermost taskENTER_CRITICAL() .. taskEXIT_CRITICAL() is timed
+    by the port through traceCRITICAL_ENTER/EXIT, i.e. how long BASEPRI kept the kernel aware
+    interrupts masked; the FROM_ISR variants are not counted.
+
+    The shell command isrprof prints the sources that have samples.
+    Without ISR_PROF the macros are empty.
+*/
+
+#define ISR_PROF_HIST_BUCKETS   12U     /* < 64, < 128, ... < 64k, >= 64k cycles */
+#define ISR_PROF_HIST_SHIFT     6U
+
+typedef enum {
+    ISR_PROF_SYSTICK,
+    ISR_PROF_EXTI0,
+    ISR_PROF_EXTI1,
+    ISR_PROF_EXTI2,
+    ISR_PROF_EXTI3,
+    ISR_PROF_EXTI4,
+    ISR_PROF_EXTI9_5,
+    ISR_PROF_EXTI15_10,
+    ISR_PROF_USART1,
+    ISR_PROF_UART_RX_DMA,
+    ISR_PROF_UART_TX_DMA,
+    ISR_PROF_ADC_DMA,
+    ISR_PROF_CAN_RX,
+    ISR_PROF_CAN_TX,
+    ISR_PROF_SPI,
+    ISR_PROF_DMA_COPY,
+    ISR_PROF_CRITICAL,
+    ISR_PROF_SOURCES
+} isr_prof_source_e;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* enables the cycle counter, before the scheduler */
+void isr_prof_init(void);
+
+/* one sample of source eSrc (ISR safe, a source must not preempt itself) */
+void isr_prof_record(isr_prof_source_e eSrc, uint32_t u32Cycles);
+
+void isr_prof_critical_enter(void);
+void isr_prof_critical_exit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(ISR_PROF) && (ISR_PROF == 1)
+#include <libopencm3/cm3/dwt.h>
+
+#define ISR_PROF_ENTER(src)     TRACE_REC_ISR_ENTER(src); const uint32_t u32IsrProfStart = DWT_CYCCNT
+#define ISR_PROF_EXIT(src)      isr_prof_record((src), DWT_CYCCNT - u32IsrProfStart); TRACE_REC_ISR_EXIT(src)
+#else
+#define ISR_PROF_ENTER(src)     TRACE_REC_ISR_ENTER(src)
+#define ISR_PROF_EXIT(src)      TRACE_REC_ISR_EXIT(src)
+#endif
+
+#endif /* ISR_PROF_H */
@@ -0,0 +1,141 @@
+#include "isr_prof.h"
+#include "ram_func.h"
+#include "ushell_core_printout.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <libopencm3/cm3/dwt.h>
+
+#include <string.h>
+
+typedef struct {
+    uint32_t u32Count;
+    uint32_t u32Min;
+    uint32_t u32Max;
+    uint64_t u64Sum;
+    uint32_t au32Hist[ISR_PROF_HIST_BUCKETS];
+} isr_prof_stat_s;
+
+static const char *const s_apstrNames[ISR_PROF_SOURCES] = {
+    "systick", "exti0", "exti1", "exti2", "exti3", "exti4", "exti9_5", "exti15_10",
+    "usart1", "uart_rxdma", "uart_txdma", "adc_dma", "can_rx", "can_tx", "spi", "dma_copy", "critical"
+};
+
+static isr_prof_stat_s s_asStats[ISR_PROF_SOURCES];
+static uint32_t s_u32CriticalStart = 0U;   /* outermost critical section, task level only */
+
+
+static void reset(isr_prof_stat_s *psStat)
+{
+    memset(psStat, 0, sizeof(*psStat));
+    psStat->u32Min = UINT32_MAX;
+}
+
+
+/* bucket of a sample: by its bit length, 0 below 2^ISR_PROF_HIST_SHIFT cycles */
+static uint32_t bucket(uint32_t u32Cycles)
+{
+    const uint32_t u32Bits = 32U - (uint32_t)__builtin_clz(u32Cycles | 1U);
+
+    if (u32Bits <= ISR_PROF_HIST_SHIFT) {
+        return 0U;
+    }
+    const uint32_t u32Bucket = u32Bits - ISR_PROF_HIST_SHIFT;
+    return (u32Bucket < ISR_PROF_HIST_BUCKETS) ? u32Bucket : (ISR_PROF_HIST_BUCKETS - 1U);
+}
+
+
+extern "C" void isr_prof_init(void)
+{
+    for (uint32_t i = 0U; i < ISR_PROF_SOURCES; i++) {
+        reset(&s_asStats[i]);
+    }
+    trace_rec_isr_names(s_apstrNames, ISR_PROF_SOURCES);
+    dwt_enable_cycle_counter();
+}
+
+
+extern "C" void isr_prof_record(isr_prof_source_e eSrc, uint32_t u32Cycles)
+{
+    isr_prof_stat_s *psStat = &s_asStats[eSrc];
+
+    psStat->u32Count++;
+    psStat->u64Sum += u32Cycles;
+    if (u32Cycles < psStat->u32Min) psStat->u32Min = u32Cycles;
+    if (u32Cycles > psStat->u32Max) psStat->u32Max = u32Cycles;
+    psStat->au32Hist[bucket(u32Cycles)]++;
+}
+
+
+/* from vPortEnterCritical()/vPortExitCritical() with interrupts masked, nesting 0 <-> 1 */
+extern "C" void isr_prof_critical_enter(void)
+{
+    s_u32CriticalStart = DWT_CYCCNT;
+}
+
+extern "C" void isr_prof_critical_exit(void)
+{
+    isr_prof_record(ISR_PROF_CRITICAL, DWT_CYCCNT - s_u32CriticalStart);
+}
+
+
+#if defined(ISR_PROF) && (ISR_PROF == 1)
+/* the kernel tick, timed around the port handler; not traced, it would fill the trace ring */
+extern "C" void port_sys_tick_handler(void);
+
+extern "C" RAM_FUNC void sys_tick_handler(void)
+{
+    const uint32_t u32Start = DWT_CYCCNT;
+    port_sys_tick_handler();
+    isr_prof_record(ISR_PROF_SYSTICK, DWT_CYCCNT - u32Start);
+}
+#endif
+
+
+// -- shell command -----------------------------------------------------------
+
+/* isrprof 0 prints the cycles of every source with samples, isrprof 1 prints and resets them */
+extern "C" int isrprof(uint32_t u32Reset)
+{
+#if defined(ISR_PROF) && (ISR_PROF == 1)
+    uSHELL_PRINTF("%-11s %8s %8s %8s %8s  (cycles at %u MHz)\n",
+                  "source", "count", "min", "avg", "max", (unsigned)(configCPU_CLOCK_HZ / 1000000UL));
+
+    for (uint32_t i = 0U; i < ISR_PROF_SOURCES; i++) {
+        isr_prof_stat_s sStat;
+
+        /* a consistent copy, the ISRs update it meanwhile (the copy adds a critical sample) */
+        taskENTER_CRITICAL();
+        sStat = s_asStats[i];
+        if (u32Reset != 0U) {
+            reset(&s_asStats[i]);
+        }
+        taskEXIT_CRITICAL();
+
+        if (0U == sStat.u32Count) {
+            continue;
+        }
+        uSHELL_PRINTF("%-11s %8u %8u %8u %8u\n",
+                      s_apstrNames[i], (unsigned)sStat.u32Count, (unsigned)sStat.u32Min,
+                      (unsigned)(sStat.u64Sum / sStat.u32Count), (unsigned)sStat.u32Max);
+
+        uSHELL_PRINTF("  hist");
+        for (uint32_t b = 0U; b < ISR_PROF_HIST_BUCKETS; b++) {
+            if (0U == sStat.au32Hist[b]) {
+                continue;
+            }
+            if (b < (ISR_PROF_HIST_BUCKETS - 1U)) {
+                uSHELL_PRINTF(" <%u:%u", (unsigned)(1UL << (b + ISR_PROF_HIST_SHIFT)), (unsigned)sStat.au32Hist[b]);
+            } else {
+                uSHELL_PRINTF(" >=%u:%u", (unsigned)(1UL << (b + ISR_PROF_HIST_SHIFT - 1U)), (unsigned)sStat.au32Hist[b]);
+            }
+        }
+        uSHELL_PRINTF("\n");
+    }
+#else
+    (void)u32Reset;
+    uSHELL_PRINTF("isrprof: built with ISR_PROF 0\n");
+#endif
+    return 0;
+}
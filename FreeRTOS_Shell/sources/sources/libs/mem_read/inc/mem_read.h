@@ -0,0 +1,43 @@
+#ifndef MEM_READ_H
+#define MEM_READ_H
+
+#include <stdint.h>
+
+/*
+    Bulk memory read (shell command mread), the block encoded in a buffer and sent with one
+    uSHELL_WRITE, so the output runs at the line rate instead of one printf per field.
+
+        mread <address> <length> <mode>
+
+        mode 0  hex, one line of MEM_READ_BLOCK bytes
+             1  base64, one line per block
+             2  raw binary, the blocks back to back
+             +0x10   the CRC32 of every block after it (hex / base64: " <8 hex>",
+                     raw: 4 bytes little endian)
+
+    The data is framed by two text lines, the end line carries the CRC32 of all of it:
+
+        MR <address> <length> hex|b64|raw[ crc]
+        ...
+        MR END <length> <crc32>
+
+    Only the flash and the SRAM are read (a peripheral register may change when read, an
+    unmapped address faults). tools/mread_decode.py turns a capture of the terminal into
+    the memory image and checks the CRCs. 128 KB of SRAM in raw mode take about 11 s at
+    115200 baud, 22 s in hex (the printf dump needs minutes). A raw dump over a link with
+    XON / XOFF flow control is not safe, the data may stop the host side: use base64.
+
+        mcrc <address> <length>
+
+    The CRC32 (binascii.crc32) and the CRC16 (binascii.crc_hqx(data, 0xFFFF)) of the same
+    ranges, with the cycles of the CRC32 by the CRC unit and by the table (checksum.h).
+*/
+
+#define MEM_READ_BLOCK          96U     /* bytes per block: a multiple of 3 (base64) */
+
+#define MEM_READ_HEX            0U
+#define MEM_READ_BASE64         1U
+#define MEM_READ_RAW            2U
+#define MEM_READ_CRC            0x10U
+
+#endif /* MEM_READ_H */
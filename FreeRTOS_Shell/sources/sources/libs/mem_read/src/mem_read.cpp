@@ -0,0 +1,161 @@
+#include "mem_read.h"
+#include "ushell_core_printout.h"
+#include "ushell_core_utils.h"
+#include "checksum.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <libopencm3/cm3/dwt.h>
+
+/* the regions mread reads: the flash of the part (write cycles of the history log included) and the
+   SRAM up to the top of the stack (_stack, cortex-m-generic.ld) */
+#if defined(STM32F1)
+#define MEM_READ_FLASH_SIZE     (128U * 1024U)   /* F103C8: 64K specified, 128K on the die */
+#else
+#define MEM_READ_FLASH_SIZE     (512U * 1024U)   /* F411CE */
+#endif /*defined(STM32F1)*/
+#define MEM_READ_FLASH_BASE     0x08000000UL
+#define MEM_READ_SRAM_BASE      0x20000000UL
+
+extern "C" uint32_t _stack;
+
+/* the encoded block: hex is the longest, its CRC and the line end */
+static char s_acLine[(MEM_READ_BLOCK * 2U) + 12U];
+
+static const char s_acBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/*--------------------------------------------------*/
+static size_t s_base64(const uint8_t *pu8Data, size_t szLen, char *pcOut)
+{
+    char *pc = pcOut;
+    for (; szLen >= 3U; szLen -= 3U, pu8Data += 3) {
+        const uint32_t u32Triple = ((uint32_t)pu8Data[0] << 16) | ((uint32_t)pu8Data[1] << 8) | pu8Data[2];
+        *pc++ = s_acBase64[(u32Triple >> 18) & 0x3FU];
+        *pc++ = s_acBase64[(u32Triple >> 12) & 0x3FU];
+        *pc++ = s_acBase64[(u32Triple >> 6) & 0x3FU];
+        *pc++ = s_acBase64[u32Triple & 0x3FU];
+    }
+    if (0U != szLen) {
+        const uint32_t u32Triple = ((uint32_t)pu8Data[0] << 16) | ((2U == szLen) ? ((uint32_t)pu8Data[1] << 8) : 0U);
+        *pc++ = s_acBase64[(u32Triple >> 18) & 0x3FU];
+        *pc++ = s_acBase64[(u32Triple >> 12) & 0x3FU];
+        *pc++ = (2U == szLen) ? s_acBase64[(u32Triple >> 6) & 0x3FU] : '=';
+        *pc++ = '=';
+    }
+    return (size_t)(pc - pcOut);
+}
+
+/*--------------------------------------------------*/
+/* szBytes of u32Value as hex digits, the most significant first: the %X of uart_printf puts a
+   0x in front and pads before it, a framing field has to be the same on every build */
+static const char *s_hex(char *pcOut, uint32_t u32Value, size_t szBytes)
+{
+    uint8_t au8Bytes[4];
+    for (size_t i = 0U; i < szBytes; ++i) {
+        au8Bytes[i] = (uint8_t)(u32Value >> (8U * (szBytes - 1U - i)));
+    }
+    pcOut[hexlify_chunk(au8Bytes, szBytes, pcOut)] = '\0';
+    return pcOut;
+}
+
+/*--------------------------------------------------*/
+static bool s_in_region(uint32_t u32Start, uint32_t u32Length, uint32_t u32Base, uint32_t u32Size)
+{
+    return (u32Start >= u32Base) && ((u32Start - u32Base) <= u32Size) && (u32Length <= (u32Size - (u32Start - u32Base)));
+}
+
+/*--------------------------------------------------*/
+static bool s_readable(uint32_t u32Address, uint32_t u32Length)
+{
+    const uint32_t u32SramSize = (uint32_t)(uintptr_t)&_stack - MEM_READ_SRAM_BASE;
+    return s_in_region(u32Address, u32Length, MEM_READ_FLASH_BASE, MEM_READ_FLASH_SIZE) ||
+           s_in_region(u32Address, u32Length, MEM_READ_SRAM_BASE, u32SramSize);
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* mread <address> <length> <mode>: mode 0 hex, 1 base64, 2 raw, +0x10 CRC32 per block */
+extern "C" int mread(uint32_t u32Address, uint32_t u32Length, uint32_t u32Mode)
+{
+    static const char *const s_apstrModes[] = { "hex", "b64", "raw" };
+    const uint32_t u32Format = u32Mode & 0x0FU;
+    const bool bCrc = (0U != (u32Mode & MEM_READ_CRC));
+    char acHex1[9];
+    char acHex2[9];
+
+    if ((u32Format > MEM_READ_RAW) || (0U != (u32Mode & ~(0x0FU | MEM_READ_CRC)))) {
+        uSHELL_PRINTF("usage: mread <address> <length> <mode: 0 hex, 1 base64, 2 raw, +0x10 crc>\n");
+        return -1;
+    }
+    if ((0U == u32Length) || (false == s_readable(u32Address, u32Length))) {
+        uSHELL_PRINTF("mread: 0x%s + %u is not in the flash or the SRAM\n", s_hex(acHex1, u32Address, 4U), (unsigned)u32Length);
+        return -1;
+    }
+
+    uSHELL_PRINTF("MR %s %s %s%s\n", s_hex(acHex1, u32Address, 4U), s_hex(acHex2, u32Length, 4U),
+                  s_apstrModes[u32Format], bCrc ? " crc" : "");
+
+    const uint8_t *pu8Data = (const uint8_t *)(uintptr_t)u32Address;
+    uint32_t u32Total = 0U;
+
+    for (uint32_t u32Done = 0U; u32Done < u32Length; ) {
+        const size_t szBlock = ((u32Length - u32Done) < MEM_READ_BLOCK) ? (size_t)(u32Length - u32Done) : MEM_READ_BLOCK;
+        const uint32_t u32Crc = checksum_crc32(0U, pu8Data, szBlock);
+        u32Total = checksum_crc32(u32Total, pu8Data, szBlock);
+
+        if (MEM_READ_RAW == u32Format) {
+            uSHELL_WRITE((const char *)pu8Data, (int)szBlock);
+            if (true == bCrc) {
+                const uint8_t au8Crc[4] = { (uint8_t)u32Crc, (uint8_t)(u32Crc >> 8), (uint8_t)(u32Crc >> 16), (uint8_t)(u32Crc >> 24) };
+                uSHELL_WRITE((const char *)au8Crc, (int)sizeof(au8Crc));
+            }
+        } else {
+            size_t szLen = (MEM_READ_HEX == u32Format) ? hexlify_chunk(pu8Data, szBlock, s_acLine)
+                                                       : s_base64(pu8Data, szBlock, s_acLine);
+            if (true == bCrc) {
+                const uint8_t au8Crc[4] = { (uint8_t)(u32Crc >> 24), (uint8_t)(u32Crc >> 16), (uint8_t)(u32Crc >> 8), (uint8_t)u32Crc };
+                s_acLine[szLen++] = ' ';
+                szLen += hexlify_chunk(au8Crc, sizeof(au8Crc), &s_acLine[szLen]);
+            }
+            s_acLine[szLen++] = '\n';
+            uSHELL_WRITE(s_acLine, (int)szLen);
+        }
+        pu8Data += szBlock;
+        u32Done += (uint32_t)szBlock;
+    }
+
+    uSHELL_PRINTF("%sMR END %s %s\n", (MEM_READ_RAW == u32Format) ? "\n" : "", s_hex(acHex1, u32Length, 4U), s_hex(acHex2, u32Total, 4U));
+    return 0;
+}
+
+/*--------------------------------------------------*/
+/* mcrc <address> <length>: CRC32 and CRC16 of a range, the cycles of the CRC unit and of the table */
+extern "C" int mcrc(uint32_t u32Address, uint32_t u32Length)
+{
+    char acHex1[9];
+    char acHex2[5];
+
+    if ((0U == u32Length) || (false == s_readable(u32Address, u32Length))) {
+        uSHELL_PRINTF("mcrc: 0x%s + %u is not in the flash or the SRAM\n", s_hex(acHex1, u32Address, 4U), (unsigned)u32Length);
+        return -1;
+    }
+
+    const uint8_t *pu8Data = (const uint8_t *)(uintptr_t)u32Address;
+    dwt_enable_cycle_counter();
+
+    uint32_t u32Start = DWT_CYCCNT;
+    const uint32_t u32Crc = checksum_crc32(0U, pu8Data, u32Length);
+    const uint32_t u32UnitCycles = DWT_CYCCNT - u32Start;
+
+    u32Start = DWT_CYCCNT;
+    const uint32_t u32CrcSw = checksum_crc32_sw(0U, pu8Data, u32Length);
+    const uint32_t u32TableCycles = DWT_CYCCNT - u32Start;
+
+    const uint16_t u16Crc = checksum_crc16(CHECKSUM_CRC16_INIT, pu8Data, u32Length);
+
+    uSHELL_PRINTF("crc32 %s crc16 %s  %u bytes, crc32 %u cycles (table %u)%s\n", s_hex(acHex1, u32Crc, 4U), s_hex(acHex2, u16Crc, 2U),
+                  (unsigned)u32Length, (unsigned)u32UnitCycles, (unsigned)u32TableCycles,
+                  (u32Crc != u32CrcSw) ? " MISMATCH" : "");
+    return (u32Crc != u32CrcSw) ? -1 : 0;
+}
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Memory image from a terminal capture of the shell command mread
+Usage: python3 mread_decode.py capture.bin image.bin   (the capture is read as bytes, raw mode included)
+
+    MR <address> <length> hex|b64|raw[ crc]
+    <blocks of 96 bytes: a hex / base64 line each, or raw with 4 CRC bytes after each one>
+    MR END <length> <crc32>
+
+The text around the dump (the echo of the command, the prompt) is skipped. The CRC of every
+block and the one of the whole dump are checked; a wrong block is reported with its address.
+"""
+
+import argparse
+import base64
+import binascii
+import re
+import struct
+import sys
+
+BLOCK = 96      # MEM_READ_BLOCK of mem_read.h
+HEADER = re.compile(rb'MR ([0-9A-F]{8}) ([0-9A-F]{8}) (hex|b64|raw)( crc)?\r?\n')
+TRAILER = re.compile(rb'\r?\n?MR END ([0-9A-F]{8}) ([0-9A-F]{8})')
+
+
+class DecodeError(Exception):
+    pass
+
+
+def decode_text(body, length, fmt, crc, address):
+    data = bytearray()
+    lines = [line.strip() for line in body.split(b'\n') if line.strip()]
+    for index, line in enumerate(lines):
+        fields = line.split(b' ')
+        block = binascii.unhexlify(fields[0]) if fmt == b'hex' else base64.b64decode(fields[0])
+        if crc:
+            if len(fields) < 2 or int(fields[1], 16) != binascii.crc32(block):
+                raise DecodeError(f"block at 0x{address + index * BLOCK:08X}: CRC mismatch")
+        data += block
+    return bytes(data)
+
+
+def decode_raw(body, length, crc, address):
+    if not crc:
+        return body[:length]
+    data, pos = bytearray(), 0
+    while len(data) < length:
+        size = min(BLOCK, length - len(data))
+        block = body[pos:pos + size]
+        stored, = struct.unpack_from('<I', body, pos + size)
+        if stored != binascii.crc32(block):
+            raise DecodeError(f"block at 0x{address + len(data):08X}: CRC mismatch")
+        data += block
+        pos += size + 4
+    return bytes(data)
+
+
+def decode(capture):
+    header = HEADER.search(capture)
+    if header is None:
+        raise DecodeError("no MR header in the capture")
+    address, length = int(header.group(1), 16), int(header.group(2), 16)
+    fmt, crc = header.group(3), header.group(4) is not None
+    start = header.end()
+
+    if fmt == b'raw':
+        # the size of the binary part is known, the trailer follows it
+        size = length + (4 * ((length + BLOCK - 1) // BLOCK) if crc else 0)
+        body, rest = capture[start:start + size], capture[start + size:]
+        data = decode_raw(body, length, crc, address)
+    else:
+        trailer = TRAILER.search(capture, start)
+        if trailer is None:
+            raise DecodeError("no MR END line, the capture is cut")
+        body, rest = capture[start:trailer.start()], capture[trailer.start():]
+        data = decode_text(body, length, fmt, crc, address)
+
+    trailer = TRAILER.match(rest) if fmt == b'raw' else TRAILER.search(rest)
+    if trailer is None:
+        raise DecodeError("no MR END line, the capture is cut")
+    if len(data) != length or int(trailer.group(1), 16) != length:
+        raise DecodeError(f"{len(data)} bytes decoded, {length} expected")
+    if int(trailer.group(2), 16) != binascii.crc32(data):
+        raise DecodeError("CRC32 of the dump does not match")
+    return address, data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('capture')
+    parser.add_argument('image')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        capture = f.read()
+    try:
+        address, data = decode(capture)
+    except (DecodeError, ValueError, binascii.Error, struct.error) as error:
+        sys.exit(f"mread_decode: {error}")
+    with open(args.image, 'wb') as f:
+        f.write(data)
+    print(f"0x{address:08X}: {len(data)} bytes, CRC32 0x{binascii.crc32(data):08X} OK")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,57 @@
+#ifndef MEM_WRITE_H
+#define MEM_WRITE_H
+
+#include <stdint.h>
+
+/*
+    Bulk binary write into the flash blob area (shell command mwrite): configuration blobs,
+    calibration tables, anything larger than an input line.
+
+        mwrite <address> <length>
+
+    The command erases what the range needs, then leaves the line to a framed binary
+    transfer and comes back to the shell at its end:
+
+        MW READY <address> <length> <block>         the device waits for the frames
+        <block bytes> <CRC32, 4 bytes LE>           host, one frame per block, the last shorter
+        '+'                                         device, the frame is accepted
+        '-'                                         device, CRC error: frames from this one again
+        MW END <length> <crc32>                     the CRC32 read back from the flash
+        MW FAIL <offset> <reason>                   instead, the transfer stopped there
+
+    The host keeps two frames in flight: a frame is acknowledged once its CRC is checked and
+    before it is programmed, so the next one goes out while the flash programs this one and
+    the one after it lands in the RX DMA ring meanwhile (frame buffer and ring as ping-pong).
+    A block programs in less time than it takes on the wire at 115200 (F103 ~2 ms, F411
+    ~0.5 ms for 5.9 ms), so the line does not pause; above ~300 kbaud the F103 sets the pace.
+    After a bad frame or a failure the device drops the input until the line has been quiet
+    for MEM_WRITE_RESYNC_MS, the frame still in flight is not taken for keys.
+
+    Area, kept out of rom by the linker scripts:
+        STM32F411   sector 6, 128K at 0x08040000    erased as a whole (~1-2 s)
+        STM32F103   8 pages, 8K at 0x0801D800       erased page by page (~20 ms each)
+    An erase unit is erased only when the range in it is not blank already, so blobs can be
+    added after each other; what the unit holds outside the range is then lost. The address
+    is word aligned; the last word is padded with 0xFF. The code fetch from flash stalls
+    while it erases or programs, the interrupts in SRAM keep the RX DMA served.
+
+    tools/mwrite_send.py sends a file (pyserial). Over a link with XON / XOFF flow control
+    the sender has to skip the control bytes between the answers.
+*/
+
+#if defined(STM32F4)
+#define MEM_WRITE_BASE          0x08040000U
+#define MEM_WRITE_SIZE          0x00020000U
+#define MEM_WRITE_SECTOR        6U
+#else /* STM32F1 */
+#define MEM_WRITE_BASE          0x0801D800U
+#define MEM_WRITE_SIZE          0x00002000U
+#define MEM_WRITE_PAGE          0x00000400U
+#endif /* defined(STM32F4) */
+
+#define MEM_WRITE_BLOCK         64U     /* bytes per frame: two frames and CRCs fit the RX ring */
+#define MEM_WRITE_TIMEOUT_MS    3000U   /* no byte of a frame for so long: the transfer stops */
+#define MEM_WRITE_RESYNC_MS     50U     /* quiet line before '-' or the final line */
+#define MEM_WRITE_RETRIES       3U      /* CRC errors of a frame before the transfer stops */
+
+#endif /* MEM_WRITE_H */
@@ -0,0 +1,186 @@
+#include "mem_write.h"
+#include "checksum.h"
+#include "uart_access.h"
+#include "power_mgr.h"
+#include "ushell_core_printout.h"
+#include "ushell_core_utils.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <libopencm3/stm32/flash.h>
+
+#define MEM_WRITE_END           (MEM_WRITE_BASE + MEM_WRITE_SIZE)
+#define MEM_WRITE_FRAME         (MEM_WRITE_BLOCK + 4U)
+
+/* what one erase clears: the sector (F411), a page (F103) */
+#if defined(STM32F4)
+#define MEM_WRITE_UNIT          MEM_WRITE_SIZE
+#else
+#define MEM_WRITE_UNIT          MEM_WRITE_PAGE
+#endif /* defined(STM32F4) */
+
+static_assert(0U == (MEM_WRITE_BLOCK % 4U), "MEM_WRITE_BLOCK must be a multiple of the flash word");
+
+/* the frame being programmed, the next one fills the RX ring meanwhile */
+static uint8_t s_au8Frame[MEM_WRITE_FRAME];
+
+
+/*--------------------------------------------------*/
+static bool s_blank(uint32_t u32Addr, uint32_t u32Len)
+{
+    for (uint32_t i = 0U; i < u32Len; i += 4U) {
+        if (0xFFFFFFFFUL != *(volatile const uint32_t *)(uintptr_t)(u32Addr + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*--------------------------------------------------*/
+/* the data cache may still hold the previous contents (F411) */
+static void s_dcache_flush(void)
+{
+#if defined(STM32F4)
+    if (0U != (FLASH_ACR & FLASH_ACR_DCEN)) {
+        flash_dcache_disable();
+        flash_dcache_reset();
+        flash_dcache_enable();
+    }
+#endif /* defined(STM32F4) */
+}
+
+/*--------------------------------------------------*/
+/* the units the range touches, each one only if its part of the range is not blank */
+static void s_erase(uint32_t u32Address, uint32_t u32Length)
+{
+    const uint32_t u32Last = u32Address + u32Length;
+
+    for (uint32_t u32Unit = MEM_WRITE_BASE + (((u32Address - MEM_WRITE_BASE) / MEM_WRITE_UNIT) * MEM_WRITE_UNIT);
+         u32Unit < u32Last; u32Unit += MEM_WRITE_UNIT) {
+        const uint32_t u32From = (u32Unit > u32Address) ? u32Unit : u32Address;
+        const uint32_t u32To = ((u32Unit + MEM_WRITE_UNIT) < u32Last) ? (u32Unit + MEM_WRITE_UNIT) : u32Last;
+
+        if (false == s_blank(u32From, ((u32To - u32From) + 3U) & ~3U)) {
+#if defined(STM32F4)
+            flash_erase_sector(MEM_WRITE_SECTOR, FLASH_CR_PROGRAM_X32);
+#else
+            flash_erase_page(u32Unit);
+#endif /* defined(STM32F4) */
+        }
+    }
+    s_dcache_flush();
+}
+
+/*--------------------------------------------------*/
+/* words, the last one padded with 0xFF (the erased state, left as it is) */
+static void s_program(uint32_t u32Addr, const uint8_t *pu8Data, uint32_t u32Len)
+{
+    for (uint32_t i = 0U; i < u32Len; i += 4U) {
+        uint8_t au8Word[4] = { 0xFFU, 0xFFU, 0xFFU, 0xFFU };
+        uint32_t u32Word;
+
+        memcpy(au8Word, &pu8Data[i], ((u32Len - i) < 4U) ? (size_t)(u32Len - i) : 4U);
+        memcpy(&u32Word, au8Word, sizeof(u32Word));
+#if defined(STM32F4)
+        flash_program_word(u32Addr + i, u32Word);
+#else
+        flash_program_half_word(u32Addr + i, (uint16_t)u32Word);
+        flash_program_half_word(u32Addr + i + 2U, (uint16_t)(u32Word >> 16));
+#endif /* defined(STM32F4) */
+    }
+}
+
+/*--------------------------------------------------*/
+/* u32Value as 8 hex digits, the most significant first (not %X: uart_printf puts a 0x in front) */
+static const char *s_hex32(char *pcOut, uint32_t u32Value)
+{
+    const uint8_t au8Bytes[4] = { (uint8_t)(u32Value >> 24), (uint8_t)(u32Value >> 16), (uint8_t)(u32Value >> 8), (uint8_t)u32Value };
+    pcOut[hexlify_chunk(au8Bytes, sizeof(au8Bytes), pcOut)] = '\0';
+    return pcOut;
+}
+
+/*--------------------------------------------------*/
+/* drop the input until the line is quiet: a frame still in flight, the LF of the command line */
+static void s_drain(void)
+{
+    while (0 < uart_read(s_au8Frame, (int)sizeof(s_au8Frame), MEM_WRITE_RESYNC_MS)) {
+    }
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* mwrite <address> <length>: the frames of mem_write.h programmed into the blob area */
+extern "C" int mwrite(uint32_t u32Address, uint32_t u32Length)
+{
+    char acHex1[9];
+    char acHex2[9];
+
+    if ((0U == u32Length) || (0U != (u32Address & 3U)) || (u32Address < MEM_WRITE_BASE) ||
+        (u32Address >= MEM_WRITE_END) || (u32Length > (MEM_WRITE_END - u32Address))) {
+        uSHELL_PRINTF("mwrite: 0x%s + %u is not a word aligned range of the blob area 0x%s + %u\n",
+                      s_hex32(acHex1, u32Address), (unsigned)u32Length, s_hex32(acHex2, MEM_WRITE_BASE), (unsigned)MEM_WRITE_SIZE);
+        return -1;
+    }
+
+    power_mgr_lock();   /* no STOP during the transfer, it would lose the first byte of a frame */
+
+    flash_unlock();
+    s_erase(u32Address, u32Length);
+    flash_lock();
+
+    s_drain();
+    uSHELL_PRINTF("MW READY %s %s %u\n", s_hex32(acHex1, u32Address), s_hex32(acHex2, u32Length), (unsigned)MEM_WRITE_BLOCK);
+
+    const char *pstrFail = nullptr;
+    uint32_t u32Done = 0U;
+    uint32_t u32Retries = 0U;
+
+    while ((u32Done < u32Length) && (nullptr == pstrFail)) {
+        const uint32_t u32Block = ((u32Length - u32Done) < MEM_WRITE_BLOCK) ? (u32Length - u32Done) : MEM_WRITE_BLOCK;
+
+        if ((int)(u32Block + 4U) != uart_read(s_au8Frame, (int)(u32Block + 4U), MEM_WRITE_TIMEOUT_MS)) {
+            pstrFail = "timeout";
+            break;
+        }
+
+        const uint32_t u32Crc = (uint32_t)s_au8Frame[u32Block] | ((uint32_t)s_au8Frame[u32Block + 1U] << 8) |
+                                ((uint32_t)s_au8Frame[u32Block + 2U] << 16) | ((uint32_t)s_au8Frame[u32Block + 3U] << 24);
+        if (u32Crc != checksum_crc32(0U, s_au8Frame, u32Block)) {
+            if (++u32Retries > MEM_WRITE_RETRIES) {
+                pstrFail = "crc";
+                break;
+            }
+            s_drain();
+            uSHELL_PUTCH('-');
+            continue;
+        }
+        u32Retries = 0U;
+
+        /* the host sends the frame after the next one while this one programs */
+        uSHELL_PUTCH('+');
+
+        const uint32_t u32Addr = u32Address + u32Done;
+        flash_unlock();
+        s_program(u32Addr, s_au8Frame, u32Block);
+        flash_lock();
+        s_dcache_flush();
+
+        if (0 != memcmp((const void *)(uintptr_t)u32Addr, s_au8Frame, u32Block)) {
+            pstrFail = "verify";
+            break;
+        }
+        u32Done += u32Block;
+    }
+
+    if (nullptr != pstrFail) {
+        s_drain();
+        uSHELL_PRINTF("\nMW FAIL %s %s\n", s_hex32(acHex1, u32Done), pstrFail);
+    } else {
+        uSHELL_PRINTF("\nMW END %s %s\n", s_hex32(acHex1, u32Length),
+                      s_hex32(acHex2, checksum_crc32(0U, (const uint8_t *)(uintptr_t)u32Address, u32Length)));
+    }
+
+    power_mgr_unlock();
+    return (nullptr != pstrFail) ? -1 : 0;
+}
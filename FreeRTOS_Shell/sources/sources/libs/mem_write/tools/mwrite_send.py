@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Write a file into the flash blob area through the shell command mwrite
+Usage: python3 mwrite_send.py /dev/ttyUSB0 0x0801D800 blob.bin [--baud 115200]   (pyserial)
+
+    > mwrite <address> <length>
+    < MW READY <address> <length> <block>
+    > <block bytes> <CRC32 LE>      two frames in flight
+    < '+' | '-'                     one answer per frame, '-': again from that frame
+    < MW END <length> <crc32>  |  MW FAIL <offset> <reason>
+
+The CRC32 of the end line is the one read back from the flash, it is checked against the file.
+XON / XOFF bytes between the answers are skipped (UART_ACCESS_FLOW_XONXOFF builds).
+"""
+
+import argparse
+import binascii
+import re
+import struct
+import sys
+import time
+
+import serial
+
+WINDOW = 2              # frames in flight: one programs, one in the RX ring
+READY_TIMEOUT_S = 5.0   # the F411 erases its 128K sector before READY (~1-2 s)
+ANSWER_TIMEOUT_S = 4.0  # above MEM_WRITE_TIMEOUT_MS of the device
+READY = re.compile(rb'MW READY ([0-9A-F]{8}) ([0-9A-F]{8}) (\d+)\r?\n')
+RESULT = re.compile(rb'MW (END ([0-9A-F]{8}) ([0-9A-F]{8})|FAIL ([0-9A-F]{8}) (\w+))\r?\n')
+FLOW = b'\x11\x13'
+
+
+class SendError(Exception):
+    pass
+
+
+def read_until(port, pattern, timeout):
+    data, deadline = b'', time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        data += port.read(port.in_waiting or 1)
+        match = pattern.search(data)
+        if match:
+            return match
+    raise SendError(f"no answer matching {pattern.pattern!r}, got {data[-80:]!r}")
+
+
+def answer(port):
+    deadline = time.monotonic() + ANSWER_TIMEOUT_S
+    while time.monotonic() < deadline:
+        byte = port.read(1)
+        if byte and byte not in FLOW:
+            return byte
+    raise SendError("no answer to a frame")
+
+
+def frames(data, block):
+    for offset in range(0, len(data), block):
+        chunk = data[offset:offset + block]
+        yield chunk + struct.pack('<I', binascii.crc32(chunk))
+
+
+def send(port, address, data):
+    port.reset_input_buffer()
+    port.write(f"mwrite 0x{address:08X} {len(data)}\r".encode())
+    ready = read_until(port, READY, READY_TIMEOUT_S)
+    block = int(ready.group(3))
+    pending = list(frames(data, block))
+
+    start, acked, sent = time.monotonic(), 0, 0
+    while acked < len(pending):
+        while sent < len(pending) and sent - acked < WINDOW:
+            port.write(pending[sent])
+            sent += 1
+        byte = answer(port)
+        if byte == b'+':
+            acked += 1
+        elif byte == b'-':
+            sent = acked    # the device dropped the frame in flight as well
+        else:
+            break           # MW FAIL follows
+    result = read_until(port, RESULT, ANSWER_TIMEOUT_S)
+    if result.group(4) is not None:
+        raise SendError(f"device: failed at offset 0x{result.group(4).decode()} ({result.group(5).decode()})")
+    if int(result.group(3), 16) != binascii.crc32(data):
+        raise SendError("CRC32 read back from the flash does not match the file")
+    return time.monotonic() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('port')
+    parser.add_argument('address', type=lambda text: int(text, 0))
+    parser.add_argument('file')
+    parser.add_argument('--baud', type=int, default=115200)
+    args = parser.parse_args()
+
+    with open(args.file, 'rb') as f:
+        data = f.read()
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        try:
+            seconds = send(port, args.address, data)
+        except SendError as error:
+            sys.exit(f"mwrite_send: {error}")
+    print(f"0x{args.address:08X}: {len(data)} bytes in {seconds:.2f} s, {len(data) / seconds:.0f} B/s, CRC32 OK")
+
+
+if __name__ == '__main__':
+    main()
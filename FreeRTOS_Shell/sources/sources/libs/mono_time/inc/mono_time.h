@@ -0,0 +1,59 @@
+#ifndef MONO_TIME_H
+#define MONO_TIME_H
+
+#include <stdint.h>
+
+/*
+    The monotonic microsecond clock: 64 bit, from the reset on, the one time base of the logs,
+    the traces and the AOs (the ThreadX and Zephyr shells have the same interface).
+
+        const uint64_t u64Start = mono_time_us();       a task or any ISR
+        ...
+        const uint32_t u32Us = (uint32_t)(mono_time_us() - u64Start);
+
+    It is the DWT cycle counter extended by an epoch: the cycle count, the microseconds and
+    the cycles per microsecond at some instant, the time is the microseconds of the epoch and
+    the cycles since it at its rate. A read is the counter, a division and a few loads: no
+    critical section, so an ISR above configMAX_SYSCALL_INTERRUPT_PRIORITY reads it too.
+
+    There are two epochs, a new one goes to the one not published and a sequence number
+    publishes it in one store. A reader takes the published one and checks the number after
+    the counter, it reads again if the epoch changed meanwhile; a reader interrupting the
+    writer sees the previous epoch, complete, and never waits for it. The writers are the
+    tick hook, the clock switch and the STOP wake, each with the kernel interrupts masked.
+
+    A new epoch is taken:
+        - every MONO_TIME_REFRESH_TICKS from the tick hook (mono_time_tick()), far below the
+          wrap of the counter (59 s at 72 MHz, 42 s at 100 MHz),
+        - at a change of the core clock (clock_profile), the cycles before it at the old rate,
+        - after a STOP (power_mgr), the counter stopped: the time in STOP comes from the RTC.
+    The remainder of the cycles stays in the counter of the epoch, so the time of a reader is
+    the same before and after an epoch: it never steps back. The few microseconds between
+    the switch to the HSI and the new epoch (the PLL lock, the STOP wake) are counted at the
+    old rate.
+*/
+
+#define MONO_TIME_REFRESH_TICKS     1000U   /* an epoch a second, configTICK_RATE_HZ 1000 */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* first in main(): the time since the reset handler started the counter, on the reset clock */
+void mono_time_init(void);
+
+/* the microseconds since the reset; any context */
+uint64_t mono_time_us(void);
+
+/* a new epoch after a change of rcc_ahb_frequency, u32StepUs added for the time the counter
+   stood still; with the kernel interrupts masked or before the scheduler */
+void mono_time_rebase(uint32_t u32StepUs);
+
+/* vApplicationTickHook() */
+void mono_time_tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MONO_TIME_H */
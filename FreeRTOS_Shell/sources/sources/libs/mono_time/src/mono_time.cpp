@@ -0,0 +1,92 @@
+#include "mono_time.h"
+
+#include <libopencm3/cm3/dwt.h>
+#include <libopencm3/stm32/rcc.h>
+
+typedef struct {
+    uint64_t u64Us;         /* the time of the epoch */
+    uint32_t u32Cycles;     /* the counter at it */
+    uint32_t u32PerUs;      /* the cycles of a microsecond from it on */
+} mono_time_epoch_s;
+
+static mono_time_epoch_s s_asEpoch[2];
+static volatile uint32_t s_u32Seq   = 0U;   /* the published epoch: s_asEpoch[s_u32Seq & 1] */
+static uint32_t          s_u32Ticks = 0U;
+
+
+static uint32_t s_per_us(void)
+{
+    const uint32_t u32PerUs = rcc_ahb_frequency / 1000000UL;
+    return (0U != u32PerUs) ? u32PerUs : 1U;
+}
+
+
+/* the next epoch from the published one at the cycles of now, then published; one writer at
+   a time (the kernel interrupts masked), the readers never see it half written */
+static void s_publish(uint32_t u32StepUs, uint32_t u32PerUs)
+{
+    const uint32_t u32Seq = s_u32Seq;
+    const mono_time_epoch_s *psOld = &s_asEpoch[u32Seq & 1U];
+    mono_time_epoch_s *psNew = &s_asEpoch[(u32Seq + 1U) & 1U];
+
+    const uint32_t u32Us = (DWT_CYCCNT - psOld->u32Cycles) / psOld->u32PerUs;
+
+    psNew->u64Us     = psOld->u64Us + u32Us + u32StepUs;
+    psNew->u32Cycles = psOld->u32Cycles + (u32Us * psOld->u32PerUs);   /* the remainder stays */
+    psNew->u32PerUs  = u32PerUs;
+
+    __atomic_signal_fence(__ATOMIC_RELEASE);    /* one core: the order of the stores is enough */
+    s_u32Seq = u32Seq + 1U;
+}
+
+
+/*--------------------------------------------------*/
+void mono_time_init(void)
+{
+    /* the reset handler started the counter at 0 (libs/startup), the clock is the reset one */
+    dwt_enable_cycle_counter();
+
+    s_asEpoch[0].u64Us     = 0U;
+    s_asEpoch[0].u32Cycles = 0U;
+    s_asEpoch[0].u32PerUs  = s_per_us();
+    s_u32Ticks = 0U;
+    s_u32Seq   = 0U;
+}
+
+
+/*--------------------------------------------------*/
+uint64_t mono_time_us(void)
+{
+    for (;;) {
+        const uint32_t u32Seq = s_u32Seq;
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+
+        const mono_time_epoch_s *psEpoch = &s_asEpoch[u32Seq & 1U];
+        const uint64_t u64Us     = psEpoch->u64Us;
+        const uint32_t u32Cycles = psEpoch->u32Cycles;
+        const uint32_t u32PerUs  = psEpoch->u32PerUs;
+        const uint32_t u32Now    = DWT_CYCCNT;
+
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+        if (u32Seq == s_u32Seq) {      /* else an epoch came meanwhile, maybe at another rate */
+            return u64Us + ((u32Now - u32Cycles) / u32PerUs);
+        }
+    }
+}
+
+
+/*--------------------------------------------------*/
+void mono_time_rebase(uint32_t u32StepUs)
+{
+    s_publish(u32StepUs, s_per_us());
+}
+
+
+/*--------------------------------------------------*/
+void mono_time_tick(void)
+{
+    if (++s_u32Ticks >= MONO_TIME_REFRESH_TICKS) {
+        s_u32Ticks = 0U;
+        s_publish(0U, s_asEpoch[s_u32Seq & 1U].u32PerUs);
+    }
+}
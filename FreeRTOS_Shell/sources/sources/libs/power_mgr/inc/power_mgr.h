@@ -0,0 +1,72 @@
+#ifndef POWER_MGR_H
+#define POWER_MGR_H
+
+#include <stdint.h>
+#include <libopencm3/stm32/rcc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    STOP mode from the FreeRTOS tickless idle (STM32F103).
+
+        power_mgr_init(&rcc_hse_configs[RCC_CLOCK_HSE8_72MHZ]);     after the peripherals, before the scheduler
+
+        FreeRTOSConfig.h:
+        #define configUSE_TICKLESS_IDLE                 2
+        #define portSUPPRESS_TICKS_AND_SLEEP(xIdle)     power_mgr_sleep(xIdle)
+
+    The kernel calls power_mgr_sleep() from the idle task when every task is blocked, i.e. no
+    AO has an event queued, with the ticks to the next timeout (an armed TimeEvent, a timer or
+    a vTaskDelay). If that is at least POWER_MGR_MIN_STOP_MS, nothing holds STOP off and the
+    kernel confirms, the core enters STOP with the low power regulator: the clocks stop except
+    the LSE, which drives the RTC alarm (EXTI17) at the timeout. Any enabled EXTI line wakes it
+    earlier, the button lines as they are and the UART RX pin (PA10, EXTI10) while in STOP.
+    After the wake the clocks are set up again from the configuration given to init or to the
+    last power_mgr_set_clock() (HSE and PLL lock, ~1-2 ms), the kernel tick is stepped by the
+    RTC time and SysTick restarted. The wake interrupt runs at that point, at the clock of the
+    profile in use. Shorter idle times just wfi.
+
+    STOP is held off:
+        - while output is queued or on the UART (uart_tx_busy()),
+        - for POWER_MGR_RX_AWAKE_MS after an RX wake or the last character received, the
+          USART is stopped in STOP: the character which woke it is lost,
+        - between power_mgr_lock() and power_mgr_unlock() (a peripheral whose clock must run),
+        - always with the console on the SPI slave (USHELL_SPI), the host clocks it any time,
+        - without an LSE crystal (it is started by init, up to POWER_MGR_LSE_TIMEOUT_MS).
+
+    EXTI line 10 and the RTC are taken; the buttons must not use line 10.
+*/
+
+#define POWER_MGR_MIN_STOP_MS       5U      /* shorter idle times sleep with the clocks running */
+#define POWER_MGR_RX_AWAKE_MS       10000U  /* kept awake after an RX wake or the last RX byte */
+#define POWER_MGR_LSE_TIMEOUT_MS    3000U   /* LSE start up at init, no STOP without it */
+#define POWER_MGR_RTC_PRESCALER     1U      /* RTC counts at 32768 / (1 + 1) Hz, ~61 us */
+
+typedef struct {
+    uint32_t u32Stops;      /* times in STOP */
+    uint32_t u32StopMs;     /* total time in STOP */
+    uint32_t u32Aborts;     /* sleeps the kernel cancelled */
+} power_mgr_stats_s;
+
+/* start the LSE and the RTC time base, clock is restored after each STOP */
+void power_mgr_init(const struct rcc_clock_scale *psClock);
+
+/* the configuration restored after STOP from now on (a clock profile switch) */
+void power_mgr_set_clock(const struct rcc_clock_scale *psClock);
+
+/* portSUPPRESS_TICKS_AND_SLEEP(), idle task with the scheduler suspended */
+void power_mgr_sleep(uint32_t u32ExpectedIdleTicks);
+
+/* nested, from tasks or interrupts (atomic): STOP is not entered while locked */
+void power_mgr_lock(void);
+void power_mgr_unlock(void);
+
+void power_mgr_get_stats(power_mgr_stats_s *psStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POWER_MGR_H */
@@ -0,0 +1,307 @@
+#include "power_mgr.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if defined(STM32F1)
+#include <libopencm3/stm32/pwr.h>
+#include <libopencm3/stm32/rtc.h>
+#include <libopencm3/stm32/exti.h>
+#include <libopencm3/stm32/gpio.h>
+#include <libopencm3/stm32/dma.h>
+#include <libopencm3/cm3/nvic.h>
+#include <libopencm3/cm3/scb.h>
+#include <libopencm3/cm3/systick.h>
+#include <libopencm3/cm3/dwt.h>
+
+#include "uart_access.h"
+#include "mono_time.h"
+
+#if !defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI)
+#define POWER_MGR_UART_WAKE
+#endif /*!defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI)*/
+
+#define POWER_MGR_RTC_HZ        (32768U / (POWER_MGR_RTC_PRESCALER + 1U))
+#define POWER_MGR_RTCSEL_LSE    1U          /* RCC_BDCR[9:8] */
+#define POWER_MGR_RX_EXTI       EXTI10      /* USART1 RX, PA10 */
+#define POWER_MGR_RX_DMA_CNDTR  DMA1_CNDTR(DMA_CHANNEL5)   /* uart_access RX ring, counts down per byte */
+#define POWER_MGR_MAX_COUNTS    0x7FFFFFFFU /* alarm range when no task waits with a timeout */
+
+static_assert(POWER_MGR_RTC_PRESCALER >= 1U, "a zero RTC prescaler does not raise the alarm flag reliably");
+
+static const struct rcc_clock_scale *s_psClock = NULL;
+static bool s_bRtcReady                         = false;
+static volatile uint32_t s_u32Locks             = 0U;
+static power_mgr_stats_s s_sStats               = {0U, 0U, 0U};
+
+#if defined(POWER_MGR_UART_WAKE)
+static TickType_t s_xRxSeen   = 0;     /* last RX wake or byte received */
+static uint32_t s_u32RxCndtr  = 0U;
+#endif /*defined(POWER_MGR_UART_WAKE)*/
+
+
+/* CNTH:CNTL are read apart: again when the high half moved meanwhile */
+static uint32_t s_rtc_count(void)
+{
+    uint32_t u32High;
+    uint32_t u32Low;
+
+    do {
+        u32High = RTC_CNTH;
+        u32Low  = RTC_CNTL;
+    } while (u32High != RTC_CNTH);
+
+    return ((u32High & 0xFFFFU) << 16) | (u32Low & 0xFFFFU);
+}
+
+
+/* the APB1 view of the RTC is stale after a reset or STOP until RSF */
+static void s_rtc_sync(void)
+{
+    RTC_CRL = RTC_CRL & ~RTC_CRL_RSF;
+    while (0U == (RTC_CRL & RTC_CRL_RSF)) {
+    }
+}
+
+
+static bool s_lse_start(void)
+{
+    const uint32_t u32Timeout = (rcc_ahb_frequency / 1000U) * POWER_MGR_LSE_TIMEOUT_MS;
+    const uint32_t u32Start   = DWT_CYCCNT;
+
+    rcc_osc_on(RCC_LSE);
+    while (false == rcc_is_osc_ready(RCC_LSE)) {
+        if ((DWT_CYCCNT - u32Start) > u32Timeout) {
+            rcc_osc_off(RCC_LSE);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static bool s_stop_allowed(void)
+{
+    if ((false == s_bRtcReady) || (0U != s_u32Locks) || (0 != uart_tx_busy())) {
+        return false;
+    }
+
+#if defined(UART_ACCESS_SPI)
+    return false;       /* the SPI slave runs on the clock of the host, in STOP its frames are lost */
+#endif /*defined(UART_ACCESS_SPI)*/
+
+#if defined(POWER_MGR_UART_WAKE)
+    const uint32_t u32Cndtr = POWER_MGR_RX_DMA_CNDTR;
+
+    if (u32Cndtr != s_u32RxCndtr) {
+        s_u32RxCndtr = u32Cndtr;
+        s_xRxSeen    = xTaskGetTickCount();
+    }
+    if ((xTaskGetTickCount() - s_xRxSeen) < pdMS_TO_TICKS(POWER_MGR_RX_AWAKE_MS)) {
+        return false;
+    }
+#endif /*defined(POWER_MGR_UART_WAKE)*/
+
+    return true;
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_init(const struct rcc_clock_scale *psClock)
+{
+    s_psClock = psClock;
+
+    rcc_periph_clock_enable(RCC_PWR);
+    rcc_periph_clock_enable(RCC_BKP);
+    pwr_disable_backup_domain_write_protect();
+    dwt_enable_cycle_counter();
+
+    /* the backup domain survives a reset: keep an RTC already running from the LSE */
+    const uint32_t u32Sel = (RCC_BDCR >> 8) & 3U;
+
+    if ((0U == (RCC_BDCR & RCC_BDCR_RTCEN)) || (POWER_MGR_RTCSEL_LSE != u32Sel) || (false == rcc_is_osc_ready(RCC_LSE))) {
+        if (((0U != u32Sel) && (POWER_MGR_RTCSEL_LSE != u32Sel)) || (false == s_lse_start())) {
+            return;     /* another RTC clock (only a backup domain reset changes it) or no crystal */
+        }
+        rcc_set_rtc_clock_source(RCC_LSE);
+        rcc_enable_rtc_clock();
+    }
+
+    s_rtc_sync();
+    rtc_set_prescale_val(POWER_MGR_RTC_PRESCALER);
+    rtc_clear_flag(RTC_ALR);
+    rtc_interrupt_enable(RTC_ALR);
+
+    exti_set_trigger(EXTI17, EXTI_TRIGGER_RISING);
+    exti_enable_request(EXTI17);
+    nvic_set_priority(NVIC_RTC_ALARM_IRQ, configKERNEL_INTERRUPT_PRIORITY);
+    nvic_enable_irq(NVIC_RTC_ALARM_IRQ);
+
+#if defined(POWER_MGR_UART_WAKE)
+    /* the RX wake comes through the EXTI15_10 vector, which has nothing to do for line 10 */
+    exti_select_source(POWER_MGR_RX_EXTI, GPIOA);
+    exti_set_trigger(POWER_MGR_RX_EXTI, EXTI_TRIGGER_FALLING);
+    nvic_enable_irq(NVIC_EXTI15_10_IRQ);
+    s_u32RxCndtr = POWER_MGR_RX_DMA_CNDTR;
+#endif /*defined(POWER_MGR_UART_WAKE)*/
+
+    pwr_set_stop_mode();
+    pwr_voltage_regulator_low_power_in_stop();
+    s_bRtcReady = true;
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_sleep(uint32_t u32ExpectedIdleTicks)
+{
+    if ((u32ExpectedIdleTicks < pdMS_TO_TICKS(POWER_MGR_MIN_STOP_MS)) || (false == s_stop_allowed())) {
+        __asm volatile("wfi");      /* SysTick keeps running, the next tick ends it */
+        return;
+    }
+
+    /* PRIMASK: the wake interrupt stays pending until the clocks and the tick are back */
+    __asm volatile("cpsid i" ::: "memory");
+    __asm volatile("dsb");
+    __asm volatile("isb");
+
+    if (eAbortSleep == eTaskConfirmSleepModeStatus()) {
+        s_sStats.u32Aborts++;
+        __asm volatile("cpsie i" ::: "memory");
+        return;
+    }
+
+    systick_counter_disable();
+
+    /* woken a little early rather than late, the last tick comes from SysTick */
+    uint64_t u64Counts = ((uint64_t)u32ExpectedIdleTicks * POWER_MGR_RTC_HZ) / configTICK_RATE_HZ;
+    if (u64Counts > POWER_MGR_MAX_COUNTS) {
+        u64Counts = POWER_MGR_MAX_COUNTS;
+    }
+    const uint32_t u32Start = s_rtc_count();
+    rtc_set_alarm_time(u32Start + (uint32_t)u64Counts);
+
+#if defined(POWER_MGR_UART_WAKE)
+    EXTI_PR = POWER_MGR_RX_EXTI;
+    exti_enable_request(POWER_MGR_RX_EXTI);
+#endif /*defined(POWER_MGR_UART_WAKE)*/
+
+    SCB_SCR = SCB_SCR | SCB_SCR_SLEEPDEEP;
+    __asm volatile("dsb");
+    __asm volatile("wfi");
+    __asm volatile("isb");
+    SCB_SCR = SCB_SCR & ~SCB_SCR_SLEEPDEEP;
+
+    /* STOP left the core on the HSI */
+    rcc_clock_setup_pll(s_psClock);
+    s_rtc_sync();
+
+    const uint32_t u32Elapsed = s_rtc_count() - u32Start;
+    uint32_t u32Ticks = (uint32_t)(((uint64_t)u32Elapsed * configTICK_RATE_HZ) / POWER_MGR_RTC_HZ);
+    if (u32Ticks >= u32ExpectedIdleTicks) {
+        u32Ticks = u32ExpectedIdleTicks - 1U;
+    }
+    vTaskStepTick(u32Ticks);
+    mono_time_rebase((uint32_t)(((uint64_t)u32Elapsed * 1000000U) / POWER_MGR_RTC_HZ));   /* DWT stopped */
+
+#if defined(POWER_MGR_UART_WAKE)
+    exti_disable_request(POWER_MGR_RX_EXTI);
+    if (0U != (EXTI_PR & POWER_MGR_RX_EXTI)) {
+        EXTI_PR   = POWER_MGR_RX_EXTI;
+        s_xRxSeen = xTaskGetTickCount();
+    }
+#endif /*defined(POWER_MGR_UART_WAKE)*/
+
+    s_sStats.u32Stops++;
+    s_sStats.u32StopMs += (uint32_t)(((uint64_t)u32Elapsed * 1000U) / POWER_MGR_RTC_HZ);
+
+    STK_CVR = 0U;
+    systick_counter_enable();
+    __asm volatile("cpsie i" ::: "memory");
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_set_clock(const struct rcc_clock_scale *psClock)
+{
+    taskENTER_CRITICAL();       /* not in the middle of a sleep in the idle task */
+    s_psClock = psClock;
+    taskEXIT_CRITICAL();
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_lock(void)
+{
+    __atomic_fetch_add(&s_u32Locks, 1U, __ATOMIC_RELAXED);
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_unlock(void)
+{
+    __atomic_fetch_sub(&s_u32Locks, 1U, __ATOMIC_RELAXED);
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_get_stats(power_mgr_stats_s *psStats)
+{
+    taskENTER_CRITICAL();
+    *psStats = s_sStats;
+    taskEXIT_CRITICAL();
+}
+
+
+/*--------------------------------------------------*/
+/* only wakes the core, the sleep reads the time itself */
+extern "C" void rtc_alarm_isr(void)
+{
+    rtc_clear_flag(RTC_ALR);
+    exti_reset_request(EXTI17);
+}
+
+#else /* STM32F4: no tickless port here, the idle task sleeps with the tick running */
+
+/*--------------------------------------------------*/
+void power_mgr_init(const struct rcc_clock_scale *psClock)
+{
+    (void)psClock;
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_sleep(uint32_t u32ExpectedIdleTicks)
+{
+    (void)u32ExpectedIdleTicks;
+    __asm volatile("wfi");
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_set_clock(const struct rcc_clock_scale *psClock)
+{
+    (void)psClock;
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_lock(void)
+{
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_unlock(void)
+{
+}
+
+
+/*--------------------------------------------------*/
+void power_mgr_get_stats(power_mgr_stats_s *psStats)
+{
+    psStats->u32Stops  = 0U;
+    psStats->u32StopMs = 0U;
+    psStats->u32Aborts = 0U;
+}
+
+#endif /* defined(STM32F1) */
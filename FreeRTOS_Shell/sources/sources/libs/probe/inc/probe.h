@@ -0,0 +1,162 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdint.h>
+
+/*
+    Probe points, built with -DUSHELL_PROBE=GPIO|ITM|TRACE (PROBE_OUT 1|2|3): fixed marks on
+    the paths worth timing, instead of a gpio_toggle() added for a measurement and left behind.
+
+        PROBE(AO_BEGIN);
+        m_dispatchFn(m_owner, e);
+        PROBE(AO_END);
+
+    A point is <channel>_BEGIN or <channel>_END, the output is chosen per build:
+        GPIO    one store to the BSRR of the pin of the channel: high at BEGIN, low at END,
+                for a logic analyser or a scope (probe_init() makes the pins outputs)
+        ITM     one store of the id to the stimulus port PROBE_ITM_PORT (the RTT SWO console
+                has port 0); the debugger enables the trace and the port, a store to a full
+                FIFO or to a disabled port is dropped by the ITM
+        TRACE   a TRACE_PROBE record with the id in the trace ring (trace_rec.h, needs
+                -DUSHELL_TRACE=ON): trace 0 / tools/trace2json.py show the channels as slices
+    Without PROBE_OUT the points are empty, as is probe_init().
+
+    Channels, the id of BEGIN is 2 * channel, END is BEGIN + 1:
+        SHELL_LINE  PB5     a command line: parse, handler, result (ushell_core)
+        SHELL_EXEC  PB8     the command handler (ushell_core)
+        AO          PB9     an active object dispatch (ActiveObject.hpp)
+        UART_RX     PB15    the USART IDLE and RX DMA ISRs (uart_access)
+        UART_TX     PA8     uart_write(), the console or a mux line (uart_access)
+        LCD_I2C     PB0     one I2C transaction of the LCD (hd44780_pcf8574)
+    A pin is overridden with -DPROBE_PIN_<channel>="GPIOx, GPIOn". PB14 is the marker of
+    the button latency (input_lat.h), PB12/PB13 the buttons, PB6/PB7 the I2C bus.
+*/
+
+#define PROBE_OUT_GPIO          1
+#define PROBE_OUT_ITM           2
+#define PROBE_OUT_TRACE         3
+
+#if !defined(PROBE_ITM_PORT)
+#define PROBE_ITM_PORT          1U
+#endif
+
+#define PROBE_ID_SHELL_LINE_BEGIN   0U
+#define PROBE_ID_SHELL_LINE_END     1U
+#define PROBE_ID_SHELL_EXEC_BEGIN   2U
+#define PROBE_ID_SHELL_EXEC_END     3U
+#define PROBE_ID_AO_BEGIN           4U
+#define PROBE_ID_AO_END             5U
+#define PROBE_ID_UART_RX_BEGIN      6U
+#define PROBE_ID_UART_RX_END        7U
+#define PROBE_ID_UART_TX_BEGIN      8U
+#define PROBE_ID_UART_TX_END        9U
+#define PROBE_ID_LCD_I2C_BEGIN      10U
+#define PROBE_ID_LCD_I2C_END        11U
+#define PROBE_CHANNELS              6U
+
+#if defined(PROBE_OUT) && (PROBE_OUT == PROBE_OUT_GPIO)
+#include <libopencm3/stm32/rcc.h>
+#include <libopencm3/stm32/gpio.h>
+
+#if !defined(PROBE_PIN_SHELL_LINE)
+#define PROBE_PIN_SHELL_LINE    GPIOB, GPIO5
+#endif
+#if !defined(PROBE_PIN_SHELL_EXEC)
+#define PROBE_PIN_SHELL_EXEC    GPIOB, GPIO8
+#endif
+#if !defined(PROBE_PIN_AO)
+#define PROBE_PIN_AO            GPIOB, GPIO9
+#endif
+#if !defined(PROBE_PIN_UART_RX)
+#define PROBE_PIN_UART_RX       GPIOB, GPIO15
+#endif
+#if !defined(PROBE_PIN_UART_TX)
+#define PROBE_PIN_UART_TX       GPIOA, GPIO8
+#endif
+#if !defined(PROBE_PIN_LCD_I2C)
+#define PROBE_PIN_LCD_I2C       GPIOB, GPIO0
+#endif
+
+/* the BSRR store: the low half sets the pin, the high half clears it */
+#define PROBE_BSRR_(port, pin, shift)   (GPIO_BSRR(port) = ((uint32_t)(pin) << (shift)))
+#define PROBE_HIGH(p)                   PROBE_BSRR_(p, 0U)
+#define PROBE_LOW(p)                    PROBE_BSRR_(p, 16U)
+
+#define PROBE_GPIO_SHELL_LINE_BEGIN     PROBE_HIGH(PROBE_PIN_SHELL_LINE)
+#define PROBE_GPIO_SHELL_LINE_END       PROBE_LOW(PROBE_PIN_SHELL_LINE)
+#define PROBE_GPIO_SHELL_EXEC_BEGIN     PROBE_HIGH(PROBE_PIN_SHELL_EXEC)
+#define PROBE_GPIO_SHELL_EXEC_END       PROBE_LOW(PROBE_PIN_SHELL_EXEC)
+#define PROBE_GPIO_AO_BEGIN             PROBE_HIGH(PROBE_PIN_AO)
+#define PROBE_GPIO_AO_END               PROBE_LOW(PROBE_PIN_AO)
+#define PROBE_GPIO_UART_RX_BEGIN        PROBE_HIGH(PROBE_PIN_UART_RX)
+#define PROBE_GPIO_UART_RX_END          PROBE_LOW(PROBE_PIN_UART_RX)
+#define PROBE_GPIO_UART_TX_BEGIN        PROBE_HIGH(PROBE_PIN_UART_TX)
+#define PROBE_GPIO_UART_TX_END          PROBE_LOW(PROBE_PIN_UART_TX)
+#define PROBE_GPIO_LCD_I2C_BEGIN        PROBE_HIGH(PROBE_PIN_LCD_I2C)
+#define PROBE_GPIO_LCD_I2C_END          PROBE_LOW(PROBE_PIN_LCD_I2C)
+
+#define PROBE(id)                       ((void)(PROBE_GPIO_##id))
+
+/* a push-pull output, low; the clock of its port on */
+#define PROBE_OUTPUT_(port, pin)        probe_output((port), (uint16_t)(pin))
+#define PROBE_OUTPUT(p)                 PROBE_OUTPUT_(p)
+
+static inline void probe_output(uint32_t u32Port, uint16_t u16Pin)
+{
+    rcc_periph_clock_enable((GPIOA == u32Port) ? RCC_GPIOA : (GPIOB == u32Port) ? RCC_GPIOB : RCC_GPIOC);
+    gpio_clear(u32Port, u16Pin);
+#if defined(STM32F1)
+    gpio_set_mode(u32Port, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_PUSHPULL, u16Pin);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    gpio_mode_setup(u32Port, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, u16Pin);
+    gpio_set_output_options(u32Port, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, u16Pin);
+#endif /*defined(STM32F4)*/
+}
+
+/* the pins of the channels, before the first probe point runs */
+static inline void probe_init(void)
+{
+    PROBE_OUTPUT(PROBE_PIN_SHELL_LINE);
+    PROBE_OUTPUT(PROBE_PIN_SHELL_EXEC);
+    PROBE_OUTPUT(PROBE_PIN_AO);
+    PROBE_OUTPUT(PROBE_PIN_UART_RX);
+    PROBE_OUTPUT(PROBE_PIN_UART_TX);
+    PROBE_OUTPUT(PROBE_PIN_LCD_I2C);
+}
+
+#elif defined(PROBE_OUT) && (PROBE_OUT == PROBE_OUT_ITM)
+#include <libopencm3/cm3/common.h>
+#include <libopencm3/cm3/memorymap.h>
+#include <libopencm3/cm3/itm.h>
+
+#define PROBE(id)                       ((void)(ITM_STIM8(PROBE_ITM_PORT) = (uint8_t)PROBE_ID_##id))
+
+/* the trace is set up by the debugger (SWO clock, TPIU, ITM_TER) */
+static inline void probe_init(void)
+{
+}
+
+#elif defined(PROBE_OUT) && (PROBE_OUT == PROBE_OUT_TRACE)
+#include "trace_rec.h"
+
+#if !defined(TRACE_REC) || (TRACE_REC != 1)
+#error "USHELL_PROBE=TRACE records into the trace ring: build with USHELL_TRACE=ON"
+#endif
+
+#define PROBE(id)                       trace_rec_event(TRACE_PROBE, (uint8_t)PROBE_ID_##id, 0U)
+
+/* the ring is started by trace 1 */
+static inline void probe_init(void)
+{
+}
+
+#else
+#define PROBE(id)                       ((void)0)
+
+static inline void probe_init(void)
+{
+}
+#endif /* PROBE_OUT */
+
+#endif /* PROBE_H */
@@ -0,0 +1,29 @@
+#ifndef RAM_FUNC_H
+#define RAM_FUNC_H
+
+/*
+    Hot code and read-only tables placed in SRAM, built with -DUSHELL_RAM_FUNCS=ON (RAM_FUNCS 1).
+
+        extern "C" RAM_FUNC void usart1_isr(void) { ... }
+        RAM_CONST static const uint8_t s_au8Table[] = { ... };
+
+    RAM_FUNC puts a function in a .ramtext input section and RAM_CONST a table in a .data.ramconst
+    one: the linker script (cortex-m-generic.ld, included by linker/stm32f*.ld) places both in
+    .data, so the reset handler copies them from flash with the initialized data. From there they
+    run without flash wait states and outside the ART cache (F411), which the rest of the code then
+    keeps for itself: the time of an ISR no longer depends on what ran before it.
+
+    The functions are never inlined (an inlined copy would run from flash) and are reached with a
+    long call, SRAM is out of the BL range of the flash. What they call in flash still costs the
+    wait states: the marked paths call little else. Without RAM_FUNCS both macros are empty.
+*/
+
+#if defined(RAM_FUNCS) && (RAM_FUNCS == 1) && defined(__arm__)
+#define RAM_FUNC    __attribute__((section(".ramtext"), noinline, long_call))
+#define RAM_CONST   __attribute__((section(".data.ramconst")))
+#else
+#define RAM_FUNC
+#define RAM_CONST
+#endif
+
+#endif /* RAM_FUNC_H */
@@ -0,0 +1,31 @@
+#ifndef REG_MAP_H
+#define REG_MAP_H
+
+#include <stdint.h>
+
+/*
+    Peripheral registers by name (shell commands reg and regw), built with -DUSHELL_REG_MAP=ON
+    (REG_MAP 1). The register database is generated at build time by tools/regmap_gen.py from
+    the libopencm3 headers of the family (REG_MAP_HEADERS in CMakeLists.txt), so the names are
+    the ones of the libopencm3 API:
+
+        reg USART1_BRR              the address, the value and every field of the register
+        reg USART1_CR1.UE           one field
+        reg USART1_*                the registers whose name starts with USART1_
+        regw GPIOC_ODR 0x2000       write the register, then read it back as reg does
+        regw RCC_CFGR.PPRE1 4       read-modify-write of one field (the value checked against its width)
+
+    The names are case insensitive. A name is found in O(1) through the open addressing table
+    of the generator (FNV-1a, the hash of the command lookup), then one string compare. The
+    registers of the instances share the fields of their family (USART_CR1 for USART1..5).
+
+    A read is a real bus access: it clears the flags that clear on read (USART_DR after
+    USART_SR, SPI_DR ...). A peripheral whose clock is off reads as 0 and ignores the writes.
+    The headers cover the whole family: an instance the part does not have (GPIOG, UART5 on
+    the F103C8) reads as 0 or faults.
+
+    Without REG_MAP the commands only say so, the table is left out of the image (~18K of
+    flash on the F103 for the default headers, printed by the generator).
+*/
+
+#endif /* REG_MAP_H */
@@ -0,0 +1,232 @@
+#include "reg_map.h"
+#include "ushell_core_printout.h"
+
+#if defined(REG_MAP) && (REG_MAP == 1)
+#include <ctype.h>
+#include <stddef.h>
+#include <string.h>
+
+/* a field of a register family, its name in s_acRegNames */
+typedef struct {
+    uint16_t u16Name;
+    uint8_t  u8Shift;
+    uint8_t  u8Width;
+} regField_s;
+
+/* a register, its fields are s_asRegFields[u16Fields] .. [u16Fields + u8NrFields - 1] */
+typedef struct {
+    uint32_t u32Address;
+    uint16_t u16Name;
+    uint16_t u16Fields;
+    uint8_t  u8NrFields;
+    uint8_t  u8Bits;        /* 8, 16 or 32: the access width */
+} regEntry_s;
+
+#include "reg_map_table.h"
+
+#define REG_MAP_NOT_FOUND       0xFFFFU
+
+
+/*--------------------------------------------------*/
+/* the names are upper case, so is the hash of the generator */
+static bool s_name_equal(const char *pstrName, const char *pstrTyped, size_t szLen)
+{
+    for (size_t i = 0U; i < szLen; i++) {
+        if (pstrName[i] != (char)toupper((unsigned char)pstrTyped[i])) {
+            return false;
+        }
+    }
+    return ('\0' == pstrName[szLen]);
+}
+
+/*--------------------------------------------------*/
+static uint16_t s_find(const char *pstrTyped, size_t szLen)
+{
+    uint32_t u32Hash = 2166136261U;
+
+    for (size_t i = 0U; i < szLen; i++) {
+        u32Hash = (u32Hash ^ (uint8_t)toupper((unsigned char)pstrTyped[i])) * 16777619U;
+    }
+    for (uint32_t u32Slot = u32Hash & (REG_MAP_SLOTS - 1U); ; u32Slot = (u32Slot + 1U) & (REG_MAP_SLOTS - 1U)) {
+        const uint16_t u16Index = s_au16RegSlots[u32Slot];
+        if ((REG_MAP_NOT_FOUND == u16Index) || s_name_equal(&s_acRegNames[s_asRegs[u16Index].u16Name], pstrTyped, szLen)) {
+            return u16Index;
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+/* the field of the register named after the '.', nullptr if it has none of that name */
+static const regField_s *s_find_field(const regEntry_s *psReg, const char *pstrTyped)
+{
+    for (uint32_t i = 0U; i < psReg->u8NrFields; i++) {
+        const regField_s *psField = &s_asRegFields[psReg->u16Fields + i];
+        if (s_name_equal(&s_acRegNames[psField->u16Name], pstrTyped, strlen(pstrTyped))) {
+            return psField;
+        }
+    }
+    return nullptr;
+}
+
+/*--------------------------------------------------*/
+static uint32_t s_read(const regEntry_s *psReg)
+{
+    switch (psReg->u8Bits) {
+        case 8U:  return *(volatile const uint8_t *)(uintptr_t)psReg->u32Address;
+        case 16U: return *(volatile const uint16_t *)(uintptr_t)psReg->u32Address;
+        default:  return *(volatile const uint32_t *)(uintptr_t)psReg->u32Address;
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_write(const regEntry_s *psReg, uint32_t u32Value)
+{
+    switch (psReg->u8Bits) {
+        case 8U:  *(volatile uint8_t *)(uintptr_t)psReg->u32Address = (uint8_t)u32Value;   break;
+        case 16U: *(volatile uint16_t *)(uintptr_t)psReg->u32Address = (uint16_t)u32Value; break;
+        default:  *(volatile uint32_t *)(uintptr_t)psReg->u32Address = u32Value;           break;
+    }
+}
+
+/*--------------------------------------------------*/
+static uint32_t s_field_mask(const regField_s *psField)
+{
+    return (psField->u8Width >= 32U) ? 0xFFFFFFFFUL : (((1UL << psField->u8Width) - 1UL) << psField->u8Shift);
+}
+
+/*--------------------------------------------------*/
+static void s_print_field(const regField_s *psField, uint32_t u32Value)
+{
+    const uint32_t u32Field = (u32Value & s_field_mask(psField)) >> psField->u8Shift;
+
+    if (1U == psField->u8Width) {
+        uSHELL_PRINTF("  %-14s [%u]    = %u\n", &s_acRegNames[psField->u16Name], (unsigned)psField->u8Shift, (unsigned)u32Field);
+    } else {
+        uSHELL_PRINTF("  %-14s [%u:%u] = %x (%u)\n", &s_acRegNames[psField->u16Name],
+                      (unsigned)(psField->u8Shift + psField->u8Width - 1U), (unsigned)psField->u8Shift,
+                      (unsigned)u32Field, (unsigned)u32Field);
+    }
+}
+
+/*--------------------------------------------------*/
+/* the register, then all its fields or only psOnly */
+static void s_print(const regEntry_s *psReg, const regField_s *psOnly)
+{
+    const uint32_t u32Value = s_read(psReg);
+
+    uSHELL_PRINTF("%s @%x = %.8x\n", &s_acRegNames[psReg->u16Name], (unsigned)psReg->u32Address, (unsigned)u32Value);
+    for (uint32_t i = 0U; i < psReg->u8NrFields; i++) {
+        const regField_s *psField = &s_asRegFields[psReg->u16Fields + i];
+        if ((nullptr == psOnly) || (psOnly == psField)) {
+            s_print_field(psField, u32Value);
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+/* "REG" or "REG.FIELD": the register, the field (nullptr for the whole register); false with
+   the reason printed when one of them is not known */
+static bool s_resolve(const char *pstrCmd, const char *pstrName, const regEntry_s **ppsReg, const regField_s **ppsField)
+{
+    const char *pstrDot = strchr(pstrName, '.');
+    const size_t szLen = (nullptr != pstrDot) ? (size_t)(pstrDot - pstrName) : strlen(pstrName);
+    const uint16_t u16Index = s_find(pstrName, szLen);
+
+    if (REG_MAP_NOT_FOUND == u16Index) {
+        uSHELL_PRINTF("%s: no register %.*s (reg <prefix>* lists them)\n", pstrCmd, (int)szLen, pstrName);
+        return false;
+    }
+    *ppsReg = &s_asRegs[u16Index];
+    *ppsField = nullptr;
+    if (nullptr != pstrDot) {
+        *ppsField = s_find_field(*ppsReg, pstrDot + 1);
+        if (nullptr == *ppsField) {
+            uSHELL_PRINTF("%s: %s has no field %s\n", pstrCmd, &s_acRegNames[(*ppsReg)->u16Name], pstrDot + 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*--------------------------------------------------*/
+/* the registers whose name starts with the szLen characters, in the order of the addresses */
+static int s_list(const char *pstrPrefix, size_t szLen)
+{
+    uint32_t u32Count = 0U;
+
+    for (uint32_t i = 0U; i < REG_MAP_COUNT; i++) {
+        const char *pstrName = &s_acRegNames[s_asRegs[i].u16Name];
+        size_t j = 0U;
+        while ((j < szLen) && (pstrName[j] == (char)toupper((unsigned char)pstrPrefix[j]))) {
+            j++;
+        }
+        if (j == szLen) {
+            uSHELL_PRINTF("%-20s @%x %2u bit, %u fields\n", pstrName, (unsigned)s_asRegs[i].u32Address,
+                          (unsigned)s_asRegs[i].u8Bits, (unsigned)s_asRegs[i].u8NrFields);
+            u32Count++;
+        }
+    }
+    uSHELL_PRINTF("%u of %u registers\n", (unsigned)u32Count, (unsigned)REG_MAP_COUNT);
+    return (0U != u32Count) ? 0 : -1;
+}
+#endif /*defined(REG_MAP) && (REG_MAP == 1)*/
+
+
+// -- shell commands ----------------------------------------------------------
+
+/* reg <name>[.<field>] | reg <prefix>* */
+extern "C" int reg(char *pstrName)
+{
+#if defined(REG_MAP) && (REG_MAP == 1)
+    const size_t szLen = strlen(pstrName);
+    const regEntry_s *psReg = nullptr;
+    const regField_s *psField = nullptr;
+
+    if ((szLen > 0U) && ('*' == pstrName[szLen - 1U])) {
+        return s_list(pstrName, szLen - 1U);
+    }
+    if (false == s_resolve("reg", pstrName, &psReg, &psField)) {
+        return -1;
+    }
+    s_print(psReg, psField);
+#else
+    (void)pstrName;
+    uSHELL_PRINTF("reg: built with REG_MAP 0\n");
+#endif /*defined(REG_MAP) && (REG_MAP == 1)*/
+    return 0;
+}
+
+/* regw <name>[.<field>] <value>: the register, or the field read-modify-written, then read back */
+extern "C" int regw(char *pstrName, uint32_t u32Value)
+{
+#if defined(REG_MAP) && (REG_MAP == 1)
+    const regEntry_s *psReg = nullptr;
+    const regField_s *psField = nullptr;
+
+    if (false == s_resolve("regw", pstrName, &psReg, &psField)) {
+        return -1;
+    }
+    if (nullptr != psField) {
+        const uint32_t u32Mask = s_field_mask(psField);
+        if (0U != ((u32Value >> 1) >> (psField->u8Width - 1U))) {     /* u32Value >> u8Width, 32 included */
+            uSHELL_PRINTF("regw: %u does not fit the %u bits of %s\n", (unsigned)u32Value,
+                          (unsigned)psField->u8Width, &s_acRegNames[psField->u16Name]);
+            return -1;
+        }
+        s_write(psReg, (s_read(psReg) & ~u32Mask) | (u32Value << psField->u8Shift));
+    } else {
+        if ((psReg->u8Bits < 32U) && (0U != (u32Value >> psReg->u8Bits))) {
+            uSHELL_PRINTF("regw: %u does not fit the %u bits of %s\n", (unsigned)u32Value,
+                          (unsigned)psReg->u8Bits, &s_acRegNames[psReg->u16Name]);
+            return -1;
+        }
+        s_write(psReg, u32Value);
+    }
+    s_print(psReg, psField);
+#else
+    (void)pstrName;
+    (void)u32Value;
+    uSHELL_PRINTF("regw: built with REG_MAP 0\n");
+#endif /*defined(REG_MAP) && (REG_MAP == 1)*/
+    return 0;
+}
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""
+Generate the register database of the reg command from the libopencm3 headers
+Usage: python3 regmap_gen.py --cc arm-none-eabi-gcc --include libopencm3/include --define STM32F1
+                             --output reg_map_table.h rcc gpio usart ...
+
+The headers are run through the compiler's preprocessor of the firmware, so the registers
+and their addresses are exactly the ones of the family the firmware is built for:
+
+    register    an object-like macro that expands to MMIO8/16/32(address), directly
+                (RCC_CR) or through a per instance macro (USART1_BRR -> USART_BRR(USART1_BASE))
+    family      the per instance macro (USART_BRR), the register itself for a direct one
+    fields      <family>_<name>_SHIFT with <family>_<name>[_MASK], a <family>_<name>_MASK
+                alone, or a <family>_<name> of one bit written as a shift: (1 << 7)
+                (_LSB and _MSK are taken as _SHIFT and _MASK)
+
+The values of a field (RCC_CFGR_SW_SYSCLKSEL_HSECLK ...) and the single bits inside a
+wider field are left out. The instances share the fields of their family. The names are
+found through an open addressing table of REG_MAP_SLOTS slots (FNV-1a, as ushell_hash()).
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+PROBE_REG = '__regmap_reg__'
+PROBE_VAL = '__regmap_val__'
+MMIO = re.compile(r'\bMMIO(8|16|32)\s*\(')
+CALL = re.compile(r'^([A-Za-z_]\w*)\s*\((.*)\)$')
+SHIFTED_BIT = re.compile(r'^\(?\s*(0x)?1[uUlL]*\s*<<\s*[\w\s()]+\)?$')
+C_EXPR = re.compile(r'^[\s0-9a-fA-FxX()+\-*/<>|&~^]*$')
+EMPTY_SLOT = 0xFFFF
+
+
+class GenError(Exception):
+    pass
+
+
+def fnv1a(text):
+    value = 2166136261
+    for byte in text.encode('ascii'):
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def preprocess(cc, include, defines, source, extra=()):
+    with tempfile.NamedTemporaryFile('w', suffix='.c', delete=False) as f:
+        f.write(source)
+        name = f.name
+    try:
+        command = [cc, '-E', '-P', *extra, f'-I{include}', *(f'-D{d}' for d in defines), name]
+        result = subprocess.run(command, capture_output=True, text=True)
+    finally:
+        os.unlink(name)
+    if result.returncode != 0:
+        raise GenError(f"{' '.join(command)}:\n{result.stderr.strip()}")
+    return result.stdout
+
+
+def c_value(expression):
+    """an integer constant expression of the headers, None for anything else"""
+    text = re.sub(r'\((u?int(8|16|32)_t|unsigned( int| long)?|uint|long)\)', '', expression)
+    text = re.sub(r'\b(0[xX][0-9a-fA-F]+|\d+)[uUlL]+\b', r'\1', text)
+    if not C_EXPR.match(text) or not text.strip():
+        return None
+    try:
+        value = eval(text.replace('/', '//'), {'__builtins__': {}})
+    except (SyntaxError, TypeError, ZeroDivisionError):
+        return None
+    return value & 0xFFFFFFFF if isinstance(value, int) else None
+
+
+def read_macros(cc, include, defines, headers):
+    includes = ''.join(f'#include <libopencm3/stm32/{h}.h>\n' for h in headers)
+    objects, functions = {}, {}
+    for line in preprocess(cc, include, defines, includes, ('-dM',)).splitlines():
+        match = re.match(r'#define\s+([A-Za-z_]\w*)(\([^)]*\))?\s*(.*)$', line)
+        if match:
+            (functions if match.group(2) else objects)[match.group(1)] = match.group(3).strip()
+    return includes, objects, functions
+
+
+def find_registers(cc, include, defines, includes, objects, functions):
+    candidates = {}
+    for name, body in objects.items():
+        if MMIO.search(body):
+            candidates[name] = name
+        else:
+            call = CALL.match(body)
+            if call and call.group(1) in functions and MMIO.search(functions[call.group(1)]):
+                candidates[name] = call.group(1)
+    probe = includes + '#undef MMIO8\n#undef MMIO16\n#undef MMIO32\n'
+    probe += ''.join(f'#define MMIO{w}(addr) {PROBE_REG}({w}, addr)\n' for w in (8, 16, 32))
+    probe += ''.join(f'{PROBE_VAL} "{name}" = {name} ;\n' for name in sorted(candidates))
+    registers = {}
+    for line in preprocess(cc, include, defines, probe).splitlines():
+        match = re.match(rf'{PROBE_VAL}\s+"(\w+)"\s*=\s*\(?\s*{PROBE_REG}\s*\(\s*(8|16|32)\s*,(.*)\)\s*\)?\s*;$', line.strip())
+        if match:
+            address = c_value(match.group(3))
+            if address is not None:
+                registers[match.group(1)] = (address, int(match.group(2)), candidates[match.group(1)])
+    return registers
+
+
+def find_fields(cc, include, defines, includes, objects, families):
+    prefixes = tuple(f'{family}_' for family in families)
+    names = sorted(name for name in objects if name.startswith(prefixes))
+    probe = includes + ''.join(f'{PROBE_VAL} "{name}" = {name} ;\n' for name in names)
+    values = {}
+    for line in preprocess(cc, include, defines, probe).splitlines():
+        match = re.match(rf'{PROBE_VAL}\s+"(\w+)"\s*=(.*);$', line.strip())
+        if match:
+            value = c_value(match.group(2))
+            if value is not None:
+                values[match.group(1)] = value
+
+    fields = {family: [] for family in families}
+    for family in families:
+        own = {re.sub(r'_MSK$', '_MASK', re.sub(r'_LSB$', '_SHIFT', n[len(family) + 1:])): v for n, v in values.items()
+               if n.startswith(f'{family}_') and not any(n.startswith(f'{f}_') and len(f) > len(family) for f in families)}
+        wide = []
+        for key, value in own.items():
+            if key.endswith('_SHIFT'):
+                base = key[:-len('_SHIFT')]
+                mask = own.get(f'{base}_MASK', own.get(base))
+                if mask:
+                    mask = mask if (mask >> value) and not (mask & ((1 << value) - 1)) else (mask << value)
+                    wide.append((base, value, mask))
+            elif key.endswith('_MASK') and f'{key[:-len("_MASK")]}_SHIFT' not in own and value:
+                shift = (value & -value).bit_length() - 1
+                wide.append((key[:-len('_MASK')], shift, value))
+        taken = {base for base, _, _ in wide}
+        bits = []
+        for key, value in own.items():
+            if key.endswith(('_SHIFT', '_MASK')) or key in taken or any(key.startswith(f'{t}_') for t in taken):
+                continue
+            if value and not (value & (value - 1)) and SHIFTED_BIT.match(objects.get(f'{family}_{key}', '')):
+                bits.append((key, value.bit_length() - 1, value))
+        for base, shift, mask in wide:
+            width = bin(mask >> shift).count('1')
+            if (mask >> shift) == (1 << width) - 1 and shift + width <= 32:
+                fields[family].append((base, shift, width))
+        used = 0
+        for _, shift, width in fields[family]:
+            used |= ((1 << width) - 1) << shift
+        fields[family] += [(key, shift, 1) for key, shift, mask in bits if not (used & mask)]
+        fields[family].sort(key=lambda f: (-f[1], f[0]))
+    return fields
+
+
+def write_table(filename, registers, fields, slots, source):
+    names, offsets = bytearray(), {}
+
+    def name_offset(text):
+        if text not in offsets:
+            offsets[text] = len(names)
+            names.extend(text.encode('ascii') + b'\0')
+        return offsets[text]
+
+    field_rows, family_start = [], {}
+    for family in sorted(fields):
+        family_start[family] = len(field_rows)
+        field_rows += [(name_offset(n), s, w, n) for n, s, w in fields[family]]
+
+    reg_rows = []
+    for name in sorted(registers, key=lambda n: (registers[n][0], n)):
+        address, width, family = registers[name]
+        reg_rows.append((name_offset(name), address, width, family_start[family], len(fields[family]), name))
+
+    if len(names) > 0xFFFF or len(reg_rows) >= EMPTY_SLOT or len(field_rows) > 0xFFFF:
+        raise GenError("too many names for the 16 bit indexes, take fewer headers")
+    while slots < 2 * len(reg_rows):
+        slots *= 2
+    table = [EMPTY_SLOT] * slots
+    for index, row in enumerate(reg_rows):
+        slot = fnv1a(row[5]) & (slots - 1)
+        while table[slot] != EMPTY_SLOT:
+            slot = (slot + 1) & (slots - 1)
+        table[slot] = index
+
+    with open(filename, 'w') as f:
+        f.write(f"/* generated by regmap_gen.py from {source}, do not edit */\n")
+        f.write(f"#define REG_MAP_COUNT           {len(reg_rows)}U\n")
+        f.write(f"#define REG_MAP_SLOTS           {slots}U\n\n")
+        f.write("static const char s_acRegNames[] =\n")
+        for start in range(0, len(names), 96):
+            chunk = names[start:start + 96].decode('ascii').replace('\0', '\\0')
+            f.write(f'    "{chunk}"\n')
+        f.write(";\n\nstatic const regField_s s_asRegFields[] = {\n")
+        for offset, shift, width, name in field_rows:
+            f.write(f"    {{ {offset:5}U, {shift:2}U, {width:2}U }},    /* {name} */\n")
+        f.write("    { 0U, 0U, 0U }\n};\n\nstatic const regEntry_s s_asRegs[] = {\n")
+        for offset, address, width, start, count, name in reg_rows:
+            f.write(f"    {{ 0x{address:08X}UL, {offset:5}U, {start:5}U, {count:2}U, {width:2}U }},    /* {name} */\n")
+        f.write("};\n\nstatic const uint16_t s_au16RegSlots[REG_MAP_SLOTS] = {\n")
+        for start in range(0, slots, 16):
+            f.write('    ' + ', '.join(f"0x{v:04X}" for v in table[start:start + 16]) + ',\n')
+        f.write("};\n")
+    return len(reg_rows), len(field_rows), len(names), slots
+
+
+def main():
+    parser = argparse.ArgumentParser(description="libopencm3 register database generator")
+    parser.add_argument('--cc', required=True, help="C compiler of the firmware (its preprocessor is used)")
+    parser.add_argument('--include', required=True, help="libopencm3 include directory")
+    parser.add_argument('--define', action='append', default=[], help="family define, i.e. STM32F1")
+    parser.add_argument('--slots', type=int, default=64, help="minimum hash slots (power of 2)")
+    parser.add_argument('--output', required=True, help="generated table header")
+    parser.add_argument('headers', nargs='+', help="libopencm3/stm32/<header>.h to take the registers from")
+    args = parser.parse_args()
+
+    try:
+        includes, objects, functions = read_macros(args.cc, args.include, args.define, args.headers)
+        registers = find_registers(args.cc, args.include, args.define, includes, objects, functions)
+        if not registers:
+            raise GenError("no registers found")
+        fields = find_fields(args.cc, args.include, args.define, includes, objects,
+                             sorted({family for _, _, family in registers.values()}))
+        counts = write_table(args.output, registers, fields, args.slots,
+                             f"{' '.join(args.headers)} ({' '.join(args.define)})")
+    except (GenError, OSError) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+    regs, nfields, nbytes, slots = counts
+    flash = regs * 12 + nfields * 4 + nbytes + slots * 2
+    print(f"regmap_gen: {regs} registers, {nfields} fields, {nbytes} bytes of names, {slots} slots, ~{flash} bytes of flash")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
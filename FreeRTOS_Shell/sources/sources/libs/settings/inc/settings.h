@@ -0,0 +1,70 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <stdint.h>
+
+/*
+    Run time tunables by name, kept in the internal flash as an append-only log (shell
+    commands set and get):
+
+        set btn.debounce 30         stored, taken by the ButtonAOs at the next reset
+        get btn.debounce            the value, its range and default
+        get btn.*                   the settings whose name starts with btn. (get * all)
+
+    The settings are the rows of settings.cfg. The code reads them with
+    settings_get(SETTING_<ID>) from their RAM copy, an array index. A name (set, get) and a
+    record of the flash find their setting in O(1) through an open addressing table of the
+    FNV-1a hashes of the names, built at compile time, then one compare. The first call scans
+    the log, the last record of a setting wins; it may come from a static constructor (the
+    LcdAO of main), the scan only reads the flash.
+
+    A set programs one record from the shell task, the other tasks stay suspended meanwhile
+    (the fetch stalls anyway); the same value again writes nothing. The area is two banks used
+    in turn, the live one is the bank of the committed header of the higher generation. When
+    the live bank is full the stored values are written from RAM into the other one (erased
+    first if a reset left something there), its header committed last, and only then is the
+    old bank erased: a reset or a power cut at any point leaves one bank with every value.
+    A record of a name no longer in settings.cfg, or out of the range of its setting, is
+    ignored (dropped at the next compaction). The baud rate stays with the baud command
+    (backup registers, kept once confirmed).
+
+    Area, kept out of rom by the linker scripts, a bank per erase unit:
+        STM32F411   sectors 1 and 2, 2 x 16K at 0x08004000  (erase ~250 ms each)
+        STM32F103   2 pages, 2 x 1K at 0x0801D000           (erase ~20 ms each)
+    The 16K sectors of the F411 sit below the code (sector 0 holds the vector table only):
+    the .bin spans them and flashing it leaves the defaults, the .elf and the .hex do not.
+
+    Record: HDR (0x5AC3) | hash lo | hash hi | value lo | value hi | COMMIT (0x0000),
+    halfwords little endian; a record with the COMMIT still erased (reset while programming)
+    is skipped. The first record of a bank is its header: the hash SETTINGS_BANK_MARK and the
+    generation of the bank as the value.
+*/
+
+#if defined(STM32F4)
+#define SETTINGS_BASE       0x08004000U
+#define SETTINGS_BANK       0x00004000U
+#define SETTINGS_SECTOR     1U              /* of the first bank, the second is the next one */
+#else /* STM32F1 */
+#define SETTINGS_BASE       0x0801D000U
+#define SETTINGS_BANK       0x00000400U
+#define SETTINGS_PAGE       0x00000400U
+#endif /* defined(STM32F4) */
+#define SETTINGS_SIZE       (2U * SETTINGS_BANK)
+
+typedef enum {
+#define SETTING(id, name, def, min, max, help)  SETTING_##id,
+#include "settings.cfg"
+#undef SETTING
+    SETTING_COUNT
+} settingId_e;
+
+/* the value of the setting, its default until one is stored */
+uint32_t settings_get(settingId_e eId);
+
+/* store the value (within the range of the setting), 0 or -1 */
+int settings_set(settingId_e eId, uint32_t u32Value);
+
+/* the setting of the name, -1 if none */
+int settings_find(const char *pstrName);
+
+#endif /* SETTINGS_H */
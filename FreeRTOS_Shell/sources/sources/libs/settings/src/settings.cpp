@@ -0,0 +1,418 @@
+#include "settings.h"
+#include "ushell_core_printout.h"
+#include "ushell_core_log.h"
+
+#include <string.h>
+#include <libopencm3/stm32/flash.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+#define SETTINGS_TAG        0x5AC3U
+#define SETTINGS_ERASED     0xFFFFU
+#define SETTINGS_COMMIT     0x0000U
+#define SETTINGS_BANK_MARK  0x00000000U     /* the hash of a bank header, no setting has it */
+
+/* HDR | hash | value | COMMIT */
+#define SETTINGS_RECORD     12U
+
+typedef struct {
+    const char *pstrName;
+    uint32_t    u32Default;
+    uint32_t    u32Min;
+    uint32_t    u32Max;
+    const char *pstrHelp;
+} settingEntry_s;
+
+static constexpr settingEntry_s s_asSettings[SETTING_COUNT] = {
+#define SETTING(id, name, def, min, max, help)  { name, def, min, max, help },
+#include "settings.cfg"
+#undef SETTING
+};
+
+
+/* FNV-1a, the hash of the command lookup (ushell_core_utils.h) */
+static constexpr uint32_t s_hash(const char *s)
+{
+    uint32_t u32Hash = 2166136261U;
+    while ('\0' != *s) {
+        u32Hash = (u32Hash ^ (uint8_t)(*s++)) * 16777619U;
+    }
+    return u32Hash;
+}
+
+
+/* the smallest power of two keeping the load factor <= 0.5 */
+static constexpr uint32_t s_slots(void)
+{
+    uint32_t u32Slots = 2U;
+    while (u32Slots < (2U * SETTING_COUNT)) {
+        u32Slots <<= 1;
+    }
+    return u32Slots;
+}
+
+#define SETTINGS_SLOTS      s_slots()
+
+typedef struct {
+    uint32_t au32Hash[SETTING_COUNT];
+    int8_t   ai8Slot[SETTINGS_SLOTS];   /* the setting, -1 for an empty slot */
+    bool     bUnique;                   /* no two names of the same hash, none is the bank mark */
+} settingsIndex_s;
+
+static constexpr settingsIndex_s s_build_index(void)
+{
+    settingsIndex_s sIndex = {};
+
+    sIndex.bUnique = true;
+    for (uint32_t i = 0U; i < SETTINGS_SLOTS; ++i) {
+        sIndex.ai8Slot[i] = -1;
+    }
+    for (uint32_t u32Id = 0U; u32Id < SETTING_COUNT; ++u32Id) {
+        const uint32_t u32Hash = s_hash(s_asSettings[u32Id].pstrName);
+        uint32_t u32Slot = u32Hash & (SETTINGS_SLOTS - 1U);
+
+        if (SETTINGS_BANK_MARK == u32Hash) {
+            sIndex.bUnique = false;
+        }
+        while (sIndex.ai8Slot[u32Slot] >= 0) {
+            if (sIndex.au32Hash[sIndex.ai8Slot[u32Slot]] == u32Hash) {
+                sIndex.bUnique = false;
+            }
+            u32Slot = (u32Slot + 1U) & (SETTINGS_SLOTS - 1U);
+        }
+        sIndex.au32Hash[u32Id] = u32Hash;
+        sIndex.ai8Slot[u32Slot] = (int8_t)u32Id;
+    }
+    return sIndex;
+}
+
+static constexpr bool s_defaults_in_range(void)
+{
+    for (const settingEntry_s &sEntry : s_asSettings) {
+        if ((sEntry.u32Min > sEntry.u32Default) || (sEntry.u32Default > sEntry.u32Max)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static constexpr settingsIndex_s s_sIndex = s_build_index();
+
+static_assert(SETTING_COUNT <= 32U, "the stored mask holds 32 settings");
+static_assert(s_sIndex.bUnique, "two settings of settings.cfg have the same name (or name hash), or one the bank mark");
+static_assert(s_defaults_in_range(), "a default of settings.cfg is out of its range");
+static_assert(((SETTING_COUNT + 1U) * SETTINGS_RECORD) < SETTINGS_BANK, "the header and the stored values must fit a bank");
+
+/* the values, the default until a record is found or set */
+static uint32_t s_au32Value[SETTING_COUNT];
+static uint32_t s_u32Stored = 0U;       /* bit per setting with a record in the log */
+
+static bool     s_bScanned = false;
+static uint32_t s_u32Bank = 0U;         /* base of the live bank, 0 while none has a header */
+static uint32_t s_u32Gen = 0U;          /* its generation */
+static uint32_t s_u32End = 0U;          /* first free address of the live bank */
+
+
+static inline uint16_t s_read_half(uint32_t u32Addr)
+{
+    return *(volatile const uint16_t *)(uintptr_t)u32Addr;
+}
+
+
+static inline uint32_t s_read_word(uint32_t u32Addr)
+{
+    return (uint32_t)s_read_half(u32Addr) | ((uint32_t)s_read_half(u32Addr + 2U) << 16);
+}
+
+
+/* the setting of the hash, -1 if none: the probe stops at the first empty slot */
+static int s_lookup(uint32_t u32Hash)
+{
+    for (uint32_t u32Slot = u32Hash & (SETTINGS_SLOTS - 1U);; u32Slot = (u32Slot + 1U) & (SETTINGS_SLOTS - 1U)) {
+        const int iId = s_sIndex.ai8Slot[u32Slot];
+        if ((iId < 0) || (s_sIndex.au32Hash[iId] == u32Hash)) {
+            return iId;
+        }
+    }
+}
+
+
+static inline bool s_in_range(uint32_t u32Id, uint32_t u32Value)
+{
+    return (u32Value >= s_asSettings[u32Id].u32Min) && (u32Value <= s_asSettings[u32Id].u32Max);
+}
+
+
+static inline bool s_committed(uint32_t u32Addr)
+{
+    return (SETTINGS_TAG == s_read_half(u32Addr)) && (SETTINGS_COMMIT == s_read_half(u32Addr + SETTINGS_RECORD - 2U));
+}
+
+
+/* the header of a bank, committed once the stored values were copied into it */
+static inline bool s_is_bank(uint32_t u32Bank)
+{
+    return s_committed(u32Bank) && (SETTINGS_BANK_MARK == s_read_word(u32Bank + 2U));
+}
+
+
+static void s_scan(void)
+{
+    uint32_t u32Addr;
+
+    for (uint32_t u32Id = 0U; u32Id < SETTING_COUNT; ++u32Id) {
+        s_au32Value[u32Id] = s_asSettings[u32Id].u32Default;
+    }
+    s_bScanned = true;
+
+    /* both banks have a header after a reset before the old one was erased: the newer wins */
+    for (uint32_t u32Bank = SETTINGS_BASE; u32Bank < (SETTINGS_BASE + SETTINGS_SIZE); u32Bank += SETTINGS_BANK) {
+        const uint32_t u32Gen = s_read_word(u32Bank + 6U);
+        if (s_is_bank(u32Bank) && ((0U == s_u32Bank) || ((int32_t)(u32Gen - s_u32Gen) > 0))) {
+            s_u32Bank = u32Bank;
+            s_u32Gen = u32Gen;
+        }
+    }
+    if (0U == s_u32Bank) {
+        return;
+    }
+
+    const uint32_t u32BankEnd = s_u32Bank + SETTINGS_BANK;
+    for (u32Addr = s_u32Bank + SETTINGS_RECORD;
+         ((u32Addr + SETTINGS_RECORD) <= u32BankEnd) && (SETTINGS_TAG == s_read_half(u32Addr));
+         u32Addr += SETTINGS_RECORD) {
+        if (SETTINGS_COMMIT != s_read_half(u32Addr + SETTINGS_RECORD - 2U)) {
+            continue;
+        }
+        const int iId = s_lookup(s_read_word(u32Addr + 2U));
+        const uint32_t u32Value = s_read_word(u32Addr + 6U);
+        if ((iId >= 0) && s_in_range((uint32_t)iId, u32Value)) {
+            s_au32Value[iId] = u32Value;
+            s_u32Stored |= 1UL << iId;
+        }
+    }
+
+    /* not erased after the last record: nothing is appended there, the next set compacts */
+    s_u32End = ((u32Addr < u32BankEnd) && (SETTINGS_ERASED == s_read_half(u32Addr))) ? u32Addr : u32BankEnd;
+}
+
+
+static inline void s_init(void)
+{
+    if (!s_bScanned) {
+        s_scan();
+    }
+}
+
+
+/* header first, commit last: a reset in between leaves a record which is skipped */
+static bool s_program_record(uint32_t u32Id, uint32_t u32Value)
+{
+    const uint32_t u32Addr = s_u32End;
+    const uint32_t u32Hash = s_sIndex.au32Hash[u32Id];
+
+    flash_program_half_word(u32Addr, SETTINGS_TAG);
+    flash_program_half_word(u32Addr + 2U, (uint16_t)u32Hash);
+    flash_program_half_word(u32Addr + 4U, (uint16_t)(u32Hash >> 16));
+    flash_program_half_word(u32Addr + 6U, (uint16_t)u32Value);
+    flash_program_half_word(u32Addr + 8U, (uint16_t)(u32Value >> 16));
+    flash_program_half_word(u32Addr + SETTINGS_RECORD - 2U, SETTINGS_COMMIT);
+
+    s_u32End = u32Addr + SETTINGS_RECORD;
+    return (u32Hash == s_read_word(u32Addr + 2U)) && (u32Value == s_read_word(u32Addr + 6U)) &&
+           (SETTINGS_COMMIT == s_read_half(u32Addr + SETTINGS_RECORD - 2U));
+}
+
+
+static bool s_blank(uint32_t u32Bank)
+{
+    for (uint32_t u32Addr = u32Bank; u32Addr < (u32Bank + SETTINGS_BANK); u32Addr += 4U) {
+        if (0xFFFFFFFFU != *(volatile const uint32_t *)(uintptr_t)u32Addr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static void s_erase(uint32_t u32Bank)
+{
+#if defined(STM32F4)
+    flash_erase_sector(SETTINGS_SECTOR + ((u32Bank - SETTINGS_BASE) / SETTINGS_BANK), FLASH_CR_PROGRAM_X32);
+    /* the data cache may still hold the erased contents */
+    if (0U != (FLASH_ACR & FLASH_ACR_DCEN)) {
+        flash_dcache_disable();
+        flash_dcache_reset();
+        flash_dcache_enable();
+    }
+#else
+    for (uint32_t u32Addr = u32Bank; u32Addr < (u32Bank + SETTINGS_BANK); u32Addr += SETTINGS_PAGE) {
+        flash_erase_page(u32Addr);
+    }
+#endif /* defined(STM32F4) */
+}
+
+
+/* live bank full (or none yet): the stored values copied from RAM into the other bank with the
+   one of the set (u32Id), its header committed last, then the old bank erased. A failed copy
+   leaves the old bank live, the next set tries again */
+static bool s_compact(uint32_t u32Id, uint32_t u32Value)
+{
+    const uint32_t u32Old = s_u32Bank;
+    const uint32_t u32New = (SETTINGS_BASE == u32Old) ? (SETTINGS_BASE + SETTINGS_BANK) : SETTINGS_BASE;
+    const uint32_t u32Gen = s_u32Gen + 1U;
+    const uint32_t u32OldEnd = s_u32End;
+    bool bOk = true;
+
+    if (!s_blank(u32New)) {
+        s_erase(u32New);
+    }
+    flash_program_half_word(u32New, SETTINGS_TAG);
+    flash_program_half_word(u32New + 2U, (uint16_t)SETTINGS_BANK_MARK);
+    flash_program_half_word(u32New + 4U, (uint16_t)(SETTINGS_BANK_MARK >> 16));
+    flash_program_half_word(u32New + 6U, (uint16_t)u32Gen);
+    flash_program_half_word(u32New + 8U, (uint16_t)(u32Gen >> 16));
+    s_u32End = u32New + SETTINGS_RECORD;
+    for (uint32_t u32Copy = 0U; u32Copy < SETTING_COUNT; ++u32Copy) {
+        if (u32Copy == u32Id) {
+            bOk = s_program_record(u32Id, u32Value) && bOk;
+        } else if (0U != (s_u32Stored & (1UL << u32Copy))) {
+            bOk = s_program_record(u32Copy, s_au32Value[u32Copy]) && bOk;
+        }
+    }
+    if (!bOk || (u32Gen != s_read_word(u32New + 6U))) {
+        s_u32End = u32OldEnd;
+        return false;
+    }
+    flash_program_half_word(u32New + SETTINGS_RECORD - 2U, SETTINGS_COMMIT);
+    if (!s_is_bank(u32New)) {
+        s_u32End = u32OldEnd;
+        return false;
+    }
+
+    s_u32Bank = u32New;
+    s_u32Gen = u32Gen;
+    if (0U != u32Old) {
+        s_erase(u32Old);
+    }
+    return true;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+uint32_t settings_get(settingId_e eId)
+{
+    s_init();
+    return ((uint32_t)eId < SETTING_COUNT) ? s_au32Value[eId] : 0U;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+int settings_set(settingId_e eId, uint32_t u32Value)
+{
+    const uint32_t u32Id = (uint32_t)eId;
+
+    if ((u32Id >= SETTING_COUNT) || !s_in_range(u32Id, u32Value)) {
+        return -1;
+    }
+    s_init();
+    if ((0U != (s_u32Stored & (1UL << u32Id))) && (s_au32Value[u32Id] == u32Value)) {
+        return 0;
+    }
+
+    bool bOk = true;
+
+    /* no switch to a task programming the flash as well (mwrite, the history at idle) while
+       it is unlocked here: its flash_lock() would fail the writes left */
+    vTaskSuspendAll();
+    flash_unlock();
+    if ((0U == s_u32Bank) || ((s_u32End + SETTINGS_RECORD) > (s_u32Bank + SETTINGS_BANK))) {
+        bOk = s_compact(u32Id, u32Value);
+    } else {
+        bOk = s_program_record(u32Id, u32Value);
+    }
+    flash_lock();
+    (void)xTaskResumeAll();
+
+    s_au32Value[u32Id] = u32Value;
+    s_u32Stored |= 1UL << u32Id;
+    return bOk ? 0 : -1;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+int settings_find(const char *pstrName)
+{
+    const int iId = s_lookup(s_hash(pstrName));
+
+    return ((iId >= 0) && (0 == strcmp(s_asSettings[iId].pstrName, pstrName))) ? iId : -1;
+}
+
+
+// -- shell commands ----------------------------------------------------------
+
+static void s_print(uint32_t u32Id)
+{
+    const settingEntry_s *psEntry = &s_asSettings[u32Id];
+
+    uSHELL_PRINTF("%-14s %6u %c  %u .. %u, default %u  %s\n", psEntry->pstrName, (unsigned)s_au32Value[u32Id],
+                  (0U != (s_u32Stored & (1UL << u32Id))) ? '*' : ' ', (unsigned)psEntry->u32Min,
+                  (unsigned)psEntry->u32Max, (unsigned)psEntry->u32Default, psEntry->pstrHelp);
+}
+
+
+/* set <name> <value>: stored, in use from the next reset */
+extern "C" int set(char *pstrName, uint32_t u32Value)
+{
+    const int iId = settings_find(pstrName);
+
+    if (iId < 0) {
+        uSHELL_PRINTF("set: no setting %s (get * lists them)\n", pstrName);
+        return -1;
+    }
+    if (!s_in_range((uint32_t)iId, u32Value)) {
+        uSHELL_PRINTF("set: %s is %u .. %u\n", pstrName, (unsigned)s_asSettings[iId].u32Min,
+                      (unsigned)s_asSettings[iId].u32Max);
+        return -1;
+    }
+    if (0 != settings_set((settingId_e)iId, u32Value)) {
+        uSHELL_PRINTF("set: %s not programmed, the flash reads back another value\n", pstrName);
+        return -1;
+    }
+    uSHELL_PRINTF("%s = %u, from the next reset\n", pstrName, (unsigned)u32Value);
+    return 0;
+}
+
+
+/* get <name>: one setting, get <prefix>*: the settings whose name starts with it */
+extern "C" int get(char *pstrName)
+{
+    const size_t szLen = strlen(pstrName);
+    uint32_t u32Shown = 0U;
+
+    s_init();
+    if ((szLen > 0U) && ('*' == pstrName[szLen - 1U])) {
+        for (uint32_t u32Id = 0U; u32Id < SETTING_COUNT; ++u32Id) {
+            if (0 == strncmp(s_asSettings[u32Id].pstrName, pstrName, szLen - 1U)) {
+                s_print(u32Id);
+                ++u32Shown;
+            }
+        }
+    } else {
+        const int iId = settings_find(pstrName);
+        if (iId >= 0) {
+            s_print((uint32_t)iId);
+            ++u32Shown;
+        }
+    }
+    if (0U == u32Shown) {
+        uSHELL_PRINTF("get: no setting %s (get * lists them)\n", pstrName);
+        return -1;
+    }
+    uSHELL_PRINTF("(* stored) log %u of %u bytes, bank %u generation %u\n",
+                  (unsigned)((0U != s_u32Bank) ? (s_u32End - s_u32Bank) : 0U), (unsigned)SETTINGS_BANK,
+                  (unsigned)((0U != s_u32Bank) ? ((s_u32Bank - SETTINGS_BASE) / SETTINGS_BANK) : 0U), (unsigned)s_u32Gen);
+    return 0;
+}
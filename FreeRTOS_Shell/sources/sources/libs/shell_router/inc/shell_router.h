@@ -0,0 +1,68 @@
+#ifndef SHELL_ROUTER_H
+#define SHELL_ROUTER_H
+
+#include <stdint.h>
+
+/*
+    Gateway mode of the shell, built with -DUSHELL_ROUTER=ON (SHELL_ROUTER 1): the command
+    lines of the host go on to the boards behind this one, a board per link.
+
+        @1 adc 0 0          the line on node 1, the reply comes back tagged with the node
+        @2 sysinfo          while node 1 is still busy: the links run side by side
+        route 0             the nodes: link, state, lines in flight, counters
+        route <n>           node n opened again (its baud rate from the current clock)
+
+    The nodes are the links: 1 is USART2 (PA2 TX, PA3 RX), 2 is USART3 (PB10, PB11) on the
+    STM32F103 and USART6 (PA11, PA12) on the STM32F411, SHELL_ROUTER_BAUD 8N1. The downstream
+    board runs the plain shell: the router opens it in machine mode (#M) and tags each line
+    with a sequence number, "<seq> <command>", which the board answers with "<seq> <rc>"
+    after the output of the command (ushell_core, uSHELL_IMPLEMENTS_MACHINE_TAGS).
+
+    @ is a user shortcut (ushell_root_shortcuts.cfg): shell_router_forward() queues the line
+    on the link and returns, the shell takes the next line at once. Up to SHELL_ROUTER_WINDOW
+    lines per link are in flight, the board keeps the ones it did not get to in its receive
+    ring and runs them in order; a line beyond the window is refused (busy), never waited
+    for. The router task takes the replies of all the links and prints them from outside the
+    console task, whole lines above the prompt (uart_access.h):
+
+        [<node>] <a line of the output>
+        [<node>] #<seq> => <rc>          the end of the line <seq>: its result, or one of
+                                         shell_router_err_e (busy, timeout)
+
+    The replies of a node keep the order of its lines, those of different nodes interleave.
+    A line without its end after SHELL_ROUTER_TIMEOUT_MS is reported timed out and leaves
+    the window, a late end of it is printed as output. An output line of the form
+    "<number> <number>" with the number of a line in flight is taken for its end.
+*/
+
+#define SHELL_ROUTER_LINKS          2U
+#define SHELL_ROUTER_WINDOW         4U      /* lines in flight per link */
+#define SHELL_ROUTER_TIMEOUT_MS     3000U   /* from the line sent to its end */
+
+#if !defined(SHELL_ROUTER_BAUD)
+#define SHELL_ROUTER_BAUD           115200U
+#endif
+
+/* the results the router reports itself, below the uSHELL_ERR_* of the boards */
+typedef enum {
+    SHELL_ROUTER_ERR_NODE    = -100,        /* no such node, or no command after it */
+    SHELL_ROUTER_ERR_BUSY    = -101,        /* the window or the TX ring of the link is full */
+    SHELL_ROUTER_ERR_TIMEOUT = -102         /* no end of the line in time */
+} shell_router_err_e;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the links and the router task: an INIT_LATE entry (startup.h), once the shell is up */
+void shell_router_init(void);
+
+/* "<node> <command>" (the @ taken off): the line queued on the link of the node; from the
+   shell task, never waits. 0, or a shell_router_err_e (printed as the end of the line) */
+int shell_router_forward(const char *pstrArgs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHELL_ROUTER_H */
@@ -0,0 +1,449 @@
+#include "shell_router.h"
+#include "ushell_core_printout.h"
+#include "startup.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <libopencm3/stm32/rcc.h>
+#include <libopencm3/stm32/gpio.h>
+#include <libopencm3/stm32/usart.h>
+#include <libopencm3/cm3/nvic.h>
+
+#include <string.h>
+
+#if defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)
+
+#define SHELL_ROUTER_STACK          384U
+#define SHELL_ROUTER_PRIO           1U      /* the shell's */
+#define SHELL_ROUTER_POLL_MS        100U    /* the timeouts are checked that often */
+
+#define SHELL_ROUTER_RX_SIZE        256U    /* power of 2 */
+#define SHELL_ROUTER_TX_SIZE        256U    /* power of 2 */
+#define SHELL_ROUTER_LINE_MAX       128U    /* a reply line, longer ones are cut */
+#define SHELL_ROUTER_TAG_MAX        12U     /* "<seq> " and the CR */
+
+/* must be allowed to call the FreeRTOS FromISR API */
+#define SHELL_ROUTER_IRQ_PRIORITY   ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+
+static_assert(0U == (SHELL_ROUTER_RX_SIZE & (SHELL_ROUTER_RX_SIZE - 1U)), "SHELL_ROUTER_RX_SIZE must be a power of 2");
+static_assert(0U == (SHELL_ROUTER_TX_SIZE & (SHELL_ROUTER_TX_SIZE - 1U)), "SHELL_ROUTER_TX_SIZE must be a power of 2");
+
+/* the peripherals of a link */
+typedef struct {
+    uint32_t            u32Usart;
+    enum rcc_periph_clken eUsartClock;
+    enum rcc_periph_clken ePortClock;
+    uint32_t            u32Port;
+    uint16_t            u16Tx;
+    uint16_t            u16Rx;
+    uint8_t             u8Irq;
+    const char         *pcName;
+} router_link_hw_s;
+
+/* a line in flight, u32Seq 0: free */
+typedef struct {
+    uint32_t            u32Seq;
+    TickType_t          xSent;
+} router_req_s;
+
+typedef struct {
+    uint8_t             au8Rx[SHELL_ROUTER_RX_SIZE];
+    volatile uint16_t   u16RxHead;          /* free running, written by the ISR */
+    uint16_t            u16RxTail;          /* owned by the router task */
+    uint8_t             au8Tx[SHELL_ROUTER_TX_SIZE];
+    uint16_t            u16TxHead;          /* owned by the shell task */
+    volatile uint16_t   u16TxTail;          /* advanced by the ISR */
+    char                acLine[SHELL_ROUTER_LINE_MAX];
+    uint16_t            u16LineLen;
+    router_req_s        asReq[SHELL_ROUTER_WINDOW];
+    uint32_t            u32NextSeq;
+    volatile bool       bUp;                /* the board answered the #M */
+    uint32_t            u32Sent;
+    uint32_t            u32Done;
+    uint32_t            u32Busy;
+    uint32_t            u32Timeouts;
+    volatile uint32_t   u32RxLost;          /* bytes the ring had no room for */
+} router_link_s;
+
+#if defined(STM32F1)
+static const router_link_hw_s s_asHw[SHELL_ROUTER_LINKS] = {
+    { USART2, RCC_USART2, RCC_GPIOA, GPIOA, GPIO_USART2_TX, GPIO_USART2_RX, NVIC_USART2_IRQ, "USART2" },
+    { USART3, RCC_USART3, RCC_GPIOB, GPIOB, GPIO_USART3_TX, GPIO_USART3_RX, NVIC_USART3_IRQ, "USART3" },
+};
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+static const router_link_hw_s s_asHw[SHELL_ROUTER_LINKS] = {
+    { USART2, RCC_USART2, RCC_GPIOA, GPIOA, GPIO2,  GPIO3,  NVIC_USART2_IRQ, "USART2" },
+    { USART6, RCC_USART6, RCC_GPIOA, GPIOA, GPIO11, GPIO12, NVIC_USART6_IRQ, "USART6" },
+};
+#endif /*defined(STM32F4)*/
+
+static router_link_s s_asLinks[SHELL_ROUTER_LINKS];
+
+static TaskHandle_t s_hTask = NULL;
+static StackType_t s_axStack[SHELL_ROUTER_STACK];
+static StaticTask_t s_sTcb;
+
+
+/*--------------------------------------------------*/
+static uint16_t s_tx_free(const router_link_s *psLink)
+{
+    return (uint16_t)(SHELL_ROUTER_TX_SIZE - (uint16_t)(psLink->u16TxHead - psLink->u16TxTail));
+}
+
+/*--------------------------------------------------*/
+/* the bytes into the TX ring (the caller checked the room), the TXE interrupt sends them */
+static void s_tx_put(uint32_t u32Node, const char *pcData, uint32_t u32Len)
+{
+    router_link_s *psLink = &s_asLinks[u32Node];
+
+    for (uint32_t i = 0U; i < u32Len; i++) {
+        psLink->au8Tx[(uint16_t)(psLink->u16TxHead + i) & (SHELL_ROUTER_TX_SIZE - 1U)] = (uint8_t)pcData[i];
+    }
+    psLink->u16TxHead = (uint16_t)(psLink->u16TxHead + u32Len);
+    usart_enable_tx_interrupt(s_asHw[u32Node].u32Usart);
+}
+
+/*--------------------------------------------------*/
+/* the board in machine mode: a CR ends whatever was typed on it before, #M answers OK 0 in
+   either mode; the lines in flight are forgotten */
+static void s_open(uint32_t u32Node)
+{
+    const router_link_hw_s *psHw = &s_asHw[u32Node];
+    router_link_s *psLink = &s_asLinks[u32Node];
+
+    taskENTER_CRITICAL();
+    memset(psLink->asReq, 0, sizeof(psLink->asReq));
+    psLink->bUp = false;
+    taskEXIT_CRITICAL();
+
+    usart_disable(psHw->u32Usart);
+    usart_set_baudrate(psHw->u32Usart, SHELL_ROUTER_BAUD);
+    usart_enable(psHw->u32Usart);
+    if (s_tx_free(psLink) >= 4U) {
+        s_tx_put(u32Node, "\r#M\r", 4U);
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_link_setup(uint32_t u32Node)
+{
+    const router_link_hw_s *psHw = &s_asHw[u32Node];
+
+    rcc_periph_clock_enable(psHw->ePortClock);
+    rcc_periph_clock_enable(psHw->eUsartClock);
+#if defined(STM32F1)
+    gpio_set_mode(psHw->u32Port, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, psHw->u16Tx);
+    /* RX pulled up: a link without a board is an idle line, not noise */
+    gpio_set_mode(psHw->u32Port, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, psHw->u16Rx);
+    gpio_set(psHw->u32Port, psHw->u16Rx);
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+    const uint8_t u8Af = (USART6 == psHw->u32Usart) ? GPIO_AF8 : GPIO_AF7;
+    gpio_mode_setup(psHw->u32Port, GPIO_MODE_AF, GPIO_PUPD_NONE, psHw->u16Tx);
+    gpio_set_output_options(psHw->u32Port, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, psHw->u16Tx);
+    gpio_mode_setup(psHw->u32Port, GPIO_MODE_AF, GPIO_PUPD_PULLUP, psHw->u16Rx);
+    gpio_set_af(psHw->u32Port, u8Af, psHw->u16Tx | psHw->u16Rx);
+#endif /*defined(STM32F4)*/
+
+    usart_set_baudrate(psHw->u32Usart, SHELL_ROUTER_BAUD);
+    usart_set_databits(psHw->u32Usart, 8);
+    usart_set_stopbits(psHw->u32Usart, USART_STOPBITS_1);
+    usart_set_mode(psHw->u32Usart, USART_MODE_TX_RX);
+    usart_set_parity(psHw->u32Usart, USART_PARITY_NONE);
+    usart_set_flow_control(psHw->u32Usart, USART_FLOWCONTROL_NONE);
+    usart_enable_rx_interrupt(psHw->u32Usart);
+    nvic_set_priority(psHw->u8Irq, SHELL_ROUTER_IRQ_PRIORITY);
+    nvic_enable_irq(psHw->u8Irq);
+    usart_enable(psHw->u32Usart);
+}
+
+/*--------------------------------------------------*/
+/* RXNE into the ring, the task woken at a line end or a half full ring; TXE from the ring */
+static void s_link_isr(uint32_t u32Node)
+{
+    const uint32_t u32Usart = s_asHw[u32Node].u32Usart;
+    router_link_s *psLink = &s_asLinks[u32Node];
+    const uint32_t u32Sr = USART_SR(u32Usart);
+    BaseType_t xWoken = pdFALSE;
+
+    if (0U != (u32Sr & (USART_SR_RXNE | USART_SR_ORE))) {
+        const uint8_t u8Byte = (uint8_t)usart_recv(u32Usart);      /* clears ORE too */
+        const uint16_t u16Used = (uint16_t)(psLink->u16RxHead - psLink->u16RxTail);
+        if (u16Used < SHELL_ROUTER_RX_SIZE) {
+            psLink->au8Rx[psLink->u16RxHead & (SHELL_ROUTER_RX_SIZE - 1U)] = u8Byte;
+            psLink->u16RxHead = (uint16_t)(psLink->u16RxHead + 1U);
+            if ((('\n' == u8Byte) || ((u16Used + 1U) == (SHELL_ROUTER_RX_SIZE / 2U))) && (NULL != s_hTask)) {
+                vTaskNotifyGiveFromISR(s_hTask, &xWoken);
+            }
+        } else {
+            psLink->u32RxLost = psLink->u32RxLost + 1U;
+        }
+    }
+    if ((0U != (u32Sr & USART_SR_TXE)) && (0U != (USART_CR1(u32Usart) & USART_CR1_TXEIE))) {
+        if (psLink->u16TxTail != psLink->u16TxHead) {
+            usart_send(u32Usart, psLink->au8Tx[psLink->u16TxTail & (SHELL_ROUTER_TX_SIZE - 1U)]);
+            psLink->u16TxTail = (uint16_t)(psLink->u16TxTail + 1U);
+        } else {
+            usart_disable_tx_interrupt(u32Usart);
+        }
+    }
+    portYIELD_FROM_ISR(xWoken);
+}
+
+/*--------------------------------------------------*/
+/* decimal digits at *ppc, at least one; *ppc after them */
+static bool s_number(const char **ppc, uint32_t *pu32Value)
+{
+    const char *pc = *ppc;
+    uint32_t u32Value = 0U;
+
+    while ((*pc >= '0') && (*pc <= '9') && (u32Value < 100000000U)) {
+        u32Value = (u32Value * 10U) + (uint32_t)(*pc++ - '0');
+    }
+    if (pc == *ppc) {
+        return false;
+    }
+    *ppc = pc;
+    *pu32Value = u32Value;
+    return true;
+}
+
+/*--------------------------------------------------*/
+/* "<seq> <rc>" of a line in flight: its end, the slot freed */
+static bool s_take_end(uint32_t u32Node, const char *pcLine)
+{
+    router_link_s *psLink = &s_asLinks[u32Node];
+    const char *pc = pcLine;
+    uint32_t u32Seq = 0U;
+    uint32_t u32Rc = 0U;
+
+    if ((false == s_number(&pc, &u32Seq)) || (' ' != *pc++)) {
+        return false;
+    }
+    const bool bNegative = ('-' == *pc);
+    pc += bNegative ? 1 : 0;
+    if ((false == s_number(&pc, &u32Rc)) || ('\0' != *pc) || (0U == u32Seq)) {
+        return false;
+    }
+    const int iRc = bNegative ? -(int)u32Rc : (int)u32Rc;
+    const unsigned uSeq = (unsigned)u32Seq;
+    for (router_req_s &sReq : psLink->asReq) {
+        if (uSeq == sReq.u32Seq) {
+            sReq.u32Seq = 0U;
+            psLink->u32Done++;
+            uSHELL_PRINTF("[%u] #%u => %d\n", (unsigned)(u32Node + 1U), uSeq, iRc);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*--------------------------------------------------*/
+static void s_line(uint32_t u32Node)
+{
+    router_link_s *psLink = &s_asLinks[u32Node];
+
+    psLink->acLine[psLink->u16LineLen] = '\0';
+    if (false == psLink->bUp) {
+        /* the terminal output before the #M (prompt, echo) is not shown */
+        psLink->bUp = (0 == strcmp(psLink->acLine, "OK 0"));
+    } else if ((0U != psLink->u16LineLen) && (false == s_take_end(u32Node, psLink->acLine))) {
+        uSHELL_PRINTF("[%u] %s\n", (unsigned)(u32Node + 1U), psLink->acLine);
+    }
+    psLink->u16LineLen = 0U;
+}
+
+/*--------------------------------------------------*/
+static void s_rx(uint32_t u32Node)
+{
+    router_link_s *psLink = &s_asLinks[u32Node];
+
+    while (psLink->u16RxTail != psLink->u16RxHead) {
+        const char c = (char)psLink->au8Rx[psLink->u16RxTail & (SHELL_ROUTER_RX_SIZE - 1U)];
+        psLink->u16RxTail = (uint16_t)(psLink->u16RxTail + 1U);
+        if ('\n' == c) {
+            s_line(u32Node);
+        } else if ('\r' != c) {
+            psLink->acLine[psLink->u16LineLen++] = c;
+            if (psLink->u16LineLen == (SHELL_ROUTER_LINE_MAX - 1U)) {
+                s_line(u32Node);        /* cut, the rest is the next line */
+            }
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_timeouts(uint32_t u32Node)
+{
+    router_link_s *psLink = &s_asLinks[u32Node];
+    const TickType_t xNow = xTaskGetTickCount();
+
+    for (router_req_s &sReq : psLink->asReq) {
+        uint32_t u32Seq = 0U;
+        taskENTER_CRITICAL();
+        if ((0U != sReq.u32Seq) && ((xNow - sReq.xSent) > pdMS_TO_TICKS(SHELL_ROUTER_TIMEOUT_MS))) {
+            u32Seq = sReq.u32Seq;
+            sReq.u32Seq = 0U;
+        }
+        taskEXIT_CRITICAL();
+        if (0U != u32Seq) {
+            psLink->u32Timeouts++;
+            uSHELL_PRINTF("[%u] #%u => %d\n", (unsigned)(u32Node + 1U), (unsigned)u32Seq, (int)SHELL_ROUTER_ERR_TIMEOUT);
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;) {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SHELL_ROUTER_POLL_MS));
+        for (uint32_t i = 0U; i < SHELL_ROUTER_LINKS; i++) {
+            s_rx(i);
+            s_timeouts(i);
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+extern "C" void usart2_isr(void)
+{
+    s_link_isr(0U);
+}
+
+#if defined(STM32F1)
+extern "C" void usart3_isr(void)
+{
+    s_link_isr(1U);
+}
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+extern "C" void usart6_isr(void)
+{
+    s_link_isr(1U);
+}
+#endif /*defined(STM32F4)*/
+
+#endif /*defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)*/
+
+
+/*--------------------------------------------------*/
+void shell_router_init(void)
+{
+#if defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)
+    for (uint32_t i = 0U; i < SHELL_ROUTER_LINKS; i++) {
+        s_link_setup(i);
+    }
+    s_hTask = xTaskCreateStatic(s_task, "Router", SHELL_ROUTER_STACK, NULL, SHELL_ROUTER_PRIO, s_axStack, &s_sTcb);
+    for (uint32_t i = 0U; i < SHELL_ROUTER_LINKS; i++) {
+        s_open(i);
+    }
+#endif /*defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)*/
+}
+#if defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)
+INIT_LATE(shell_router_init);
+#endif /*defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)*/
+
+/*--------------------------------------------------*/
+int shell_router_forward(const char *pstrArgs)
+{
+#if defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)
+    const char *pcCmd = pstrArgs;
+    uint32_t u32Number = 0U;
+    const bool bNumber = s_number(&pcCmd, &u32Number);
+    const unsigned uNode = (unsigned)u32Number;
+
+    while (' ' == *pcCmd) {
+        pcCmd++;
+    }
+    if ((false == bNumber) || (0U == uNode) || (uNode > SHELL_ROUTER_LINKS) || (pcCmd == pstrArgs) || ('\0' == *pcCmd)) {
+        uSHELL_PRINTF("[%u] => %d (@1..%u <command>)\n", uNode, (int)SHELL_ROUTER_ERR_NODE, (unsigned)SHELL_ROUTER_LINKS);
+        return SHELL_ROUTER_ERR_NODE;
+    }
+    if (NULL == s_hTask) {
+        uSHELL_PRINTF("[%u] => %d (not started yet, the late init)\n", uNode, (int)SHELL_ROUTER_ERR_BUSY);
+        return SHELL_ROUTER_ERR_BUSY;
+    }
+
+    const uint32_t u32Node = uNode - 1U;
+    router_link_s *psLink = &s_asLinks[u32Node];
+    const uint32_t u32Len = (uint32_t)strlen(pcCmd);
+    router_req_s *psFree = nullptr;
+
+    taskENTER_CRITICAL();
+    for (router_req_s &sReq : psLink->asReq) {
+        if (0U == sReq.u32Seq) {
+            psFree = &sReq;
+            break;
+        }
+    }
+    if ((nullptr == psFree) || (s_tx_free(psLink) < (u32Len + SHELL_ROUTER_TAG_MAX))) {
+        taskEXIT_CRITICAL();
+        psLink->u32Busy++;
+        uSHELL_PRINTF("[%u] => %d\n", uNode, (int)SHELL_ROUTER_ERR_BUSY);
+        return SHELL_ROUTER_ERR_BUSY;
+    }
+    if (0U == ++psLink->u32NextSeq) {
+        psLink->u32NextSeq = 1U;
+    }
+    psFree->u32Seq = psLink->u32NextSeq;
+    psFree->xSent = xTaskGetTickCount();
+    taskEXIT_CRITICAL();
+
+    char acTag[SHELL_ROUTER_TAG_MAX];
+    const int iTag = uSHELL_SNPRINTF(acTag, (int)sizeof(acTag), "%u ", (unsigned)psFree->u32Seq);
+    s_tx_put(u32Node, acTag, (uint32_t)iTag);
+    s_tx_put(u32Node, pcCmd, u32Len);
+    s_tx_put(u32Node, "\r", 1U);
+    psLink->u32Sent++;
+    return 0;
+#else
+    (void)pstrArgs;
+    uSHELL_PRINTF("@: built with SHELL_ROUTER 0\n");
+    return -1;
+#endif /*defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)*/
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* route 0: the nodes, route <n>: node n opened again */
+extern "C" int route(uint32_t u32Node)
+{
+#if defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)
+    if (u32Node > SHELL_ROUTER_LINKS) {
+        uSHELL_PRINTF("route: 1..%u, 0 for the list\n", (unsigned)SHELL_ROUTER_LINKS);
+        return -1;
+    }
+    if (NULL == s_hTask) {
+        uSHELL_PRINTF("route: not started yet (the late init)\n");
+        return -1;
+    }
+    if (0U != u32Node) {
+        s_open(u32Node - 1U);
+        uSHELL_PRINTF("route: node %u opened again\n", (unsigned)u32Node);
+        return 0;
+    }
+    uSHELL_PRINTF("%-4s %-7s %-5s %6s %8s %8s %6s %8s %6s\n", "node", "link", "state", "flight", "sent", "done", "busy", "timeout", "lost");
+    for (uint32_t i = 0U; i < SHELL_ROUTER_LINKS; i++) {
+        const router_link_s *psLink = &s_asLinks[i];
+        unsigned uFlight = 0U;
+        for (const router_req_s &sReq : psLink->asReq) {
+            uFlight += (0U != sReq.u32Seq) ? 1U : 0U;
+        }
+        uSHELL_PRINTF("%-4u %-7s %-5s %6u %8u %8u %6u %8u %6u\n", (unsigned)(i + 1U), s_asHw[i].pcName,
+                      (true == psLink->bUp) ? "up" : "down", uFlight, (unsigned)psLink->u32Sent, (unsigned)psLink->u32Done,
+                      (unsigned)psLink->u32Busy, (unsigned)psLink->u32Timeouts, (unsigned)psLink->u32RxLost);
+    }
+    uSHELL_PRINTF("%u baud, %u lines in flight per node, timeout %u ms\n", (unsigned)SHELL_ROUTER_BAUD,
+                  (unsigned)SHELL_ROUTER_WINDOW, (unsigned)SHELL_ROUTER_TIMEOUT_MS);
+#else
+    (void)u32Node;
+    uSHELL_PRINTF("route: built with SHELL_ROUTER 0\n");
+#endif /*defined(SHELL_ROUTER) && (SHELL_ROUTER == 1)*/
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+/*
+    The reset handler (it replaces the weak one of libopencm3) and the late init.
+
+    The reset handler starts the DWT cycle counter (boottime counts the reset handler with it),
+    copies .data and clears .bss four words per ldm / stm, then runs pre_main, the constructors
+    and main() as the libopencm3 one does. It still runs on the reset clock (HSI), where the
+    volatile word loop of libopencm3 spends most of its cycles in the loop itself.
+
+    The init which the prompt does not wait for goes in the .init_late section instead of the
+    constructors or main():
+
+        static void s_late(void) { ... }
+        INIT_LATE(s_late);
+
+    startup_run_late() calls the entries once, in link order, from the idle hook: the shell is
+    up and waits for a key by then. An entry must not block (the idle task runs it) and what it
+    sets up is not there before; the stage "late" of boottime is stamped after the last one.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*startup_late_fn_t)(void);
+
+/* the POSIX simulation (sources/sim_posix) links with the host linker script: a section named
+   as an identifier gets its __start_ / __stop_ symbols there */
+#if defined(USE_POSIX_SIM)
+#define INIT_LATE_SECTION   "init_late"
+#else
+#define INIT_LATE_SECTION   ".init_late"
+#endif
+
+#define INIT_LATE(fn)                                                                       \
+    __attribute__((section(INIT_LATE_SECTION), used))                                       \
+    static const startup_late_fn_t s_pfInitLate_##fn = (fn)
+
+/* the .init_late entries, the first call only */
+void startup_run_late(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STARTUP_H */
@@ -0,0 +1,125 @@
+#include "startup.h"
+#include "boot_time.h"
+
+#if !defined(USE_POSIX_SIM)
+#include <libopencm3/cm3/scb.h>
+#include <libopencm3/cm3/dwt.h>
+#include <libopencm3/cm3/scs.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(USE_POSIX_SIM)
+/* the POSIX simulation: the C runtime of the host starts main(), the late init only */
+extern startup_late_fn_t __start_init_late[], __stop_init_late[];
+#define __init_late_start   __start_init_late
+#define __init_late_end     __stop_init_late
+#else
+/* cortex-m-generic.ld: .bss follows .data, both word aligned */
+extern uint32_t _data_loadaddr, _data, _edata, _ebss;
+
+/* the constructors (cortex-m-generic.ld) and the late init (linker/stm32f*.ld) */
+extern startup_late_fn_t __preinit_array_start[], __preinit_array_end[];
+extern startup_late_fn_t __init_array_start[], __init_array_end[];
+extern startup_late_fn_t __init_late_start[], __init_late_end[];
+
+int main(void);
+#endif
+
+static bool s_bLateDone = false;
+
+
+#if !defined(USE_POSIX_SIM)
+/* 16 bytes per ldm / stm, then the last words one by one */
+static inline __attribute__((always_inline)) uint32_t *s_copy_words(uint32_t *pu32Dst, const uint32_t *pu32Src, uint32_t u32Bytes)
+{
+    __asm volatile(
+        "   subs  %[n], %[n], #16           \n"
+        "   blo   2f                        \n"
+        "1: ldmia %[s]!, {r3, r4, r5, r6}   \n"
+        "   stmia %[d]!, {r3, r4, r5, r6}   \n"
+        "   subs  %[n], %[n], #16           \n"
+        "   bhs   1b                        \n"
+        "2: adds  %[n], %[n], #12           \n"
+        "   blo   4f                        \n"
+        "3: ldr   r3, [%[s]], #4            \n"
+        "   str   r3, [%[d]], #4            \n"
+        "   subs  %[n], %[n], #4            \n"
+        "   bhs   3b                        \n"
+        "4:                                 \n"
+        : [d] "+r" (pu32Dst), [s] "+r" (pu32Src), [n] "+r" (u32Bytes)
+        :
+        : "r3", "r4", "r5", "r6", "cc", "memory");
+    return pu32Dst;
+}
+
+
+static inline __attribute__((always_inline)) void s_zero_words(uint32_t *pu32Dst, uint32_t u32Bytes)
+{
+    __asm volatile(
+        "   movs  r3, #0                    \n"
+        "   movs  r4, #0                    \n"
+        "   movs  r5, #0                    \n"
+        "   movs  r6, #0                    \n"
+        "   subs  %[n], %[n], #16           \n"
+        "   blo   2f                        \n"
+        "1: stmia %[d]!, {r3, r4, r5, r6}   \n"
+        "   subs  %[n], %[n], #16           \n"
+        "   bhs   1b                        \n"
+        "2: adds  %[n], %[n], #12           \n"
+        "   blo   4f                        \n"
+        "3: str   r3, [%[d]], #4            \n"
+        "   subs  %[n], %[n], #4            \n"
+        "   bhs   3b                        \n"
+        "4:                                 \n"
+        : [d] "+r" (pu32Dst), [n] "+r" (u32Bytes)
+        :
+        : "r3", "r4", "r5", "r6", "cc", "memory");
+}
+
+
+void reset_handler(void)
+{
+    /* boottime: the cycles to main(), boot_time_init() reads them */
+    SCS_DEMCR |= SCS_DEMCR_TRCENA;
+    DWT_CYCCNT = 0U;
+    DWT_CTRL  |= DWT_CTRL_CYCCNTENA;
+
+    uint32_t *pu32Bss = s_copy_words(&_data, &_data_loadaddr,
+                                     (uint32_t)((uintptr_t)&_edata - (uintptr_t)&_data));
+    s_zero_words(pu32Bss, (uint32_t)((uintptr_t)&_ebss - (uintptr_t)pu32Bss));
+
+    /* 8 byte stack alignment on the exceptions, the default but on the M3 r1 */
+    SCB_CCR |= SCB_CCR_STKALIGN;
+
+#if defined(STM32F4)
+    /* pre_main of libopencm3 for the F4: the FPU */
+    SCB_CPACR |= SCB_CPACR_FULL * (SCB_CPACR_CP10 | SCB_CPACR_CP11);
+#endif
+
+    for (startup_late_fn_t *ppfFn = __preinit_array_start; ppfFn < __preinit_array_end; ppfFn++) {
+        (*ppfFn)();
+    }
+    for (startup_late_fn_t *ppfFn = __init_array_start; ppfFn < __init_array_end; ppfFn++) {
+        (*ppfFn)();
+    }
+
+    (void)main();
+    while (1);
+}
+#endif /*!defined(USE_POSIX_SIM)*/
+
+
+void startup_run_late(void)
+{
+    if (s_bLateDone) {
+        return;
+    }
+    s_bLateDone = true;
+
+    for (startup_late_fn_t *ppfFn = __init_late_start; ppfFn < __init_late_end; ppfFn++) {
+        (*ppfFn)();
+    }
+    boot_time_mark(BOOT_TIME_LATE);
+}
@@ -2,12 +2,85 @@
 #include "task.h"
 #include "portable.h"
 #include "ushell_core_printout.h"
+#if defined(HEAP_TLSF) && (HEAP_TLSF == 1)
+#include "heap_tlsf.h"
+#endif
+
+#include <libopencm3/cm3/systick.h>
+#include <libopencm3/cm3/scb.h>
+
+#include <stdbool.h>
+
+#define SYS_INFO_SPARE_TASKS    2           /* room for tasks created during a snapshot */
+#define SYS_INFO_US_PER_TICK    (1000000UL / configTICK_RATE_HZ)
+#define SYS_INFO_TOP_MS         1000U       /* top without an interval */
+#define SYS_INFO_MAX_TASKS      12U         /* snapshot room without a heap */
+
+static uint64_t s_u64Ticks   = 0U;          /* xTaskGetTickCount() extended to 64 bits */
+static TickType_t s_xLastTick = 0;
+static uint64_t s_u64LastUs  = 0U;
+
+/* snapshot scratch, grown on the heap with the task count (fixed without a heap); used from the shell task only */
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+static TaskStatus_t *s_psTasks   = NULL;
+static UBaseType_t s_uxCapacity  = 0;
+#else
+static TaskStatus_t s_psTasks[2U * SYS_INFO_MAX_TASKS];      /* top: two snapshots */
+static const UBaseType_t s_uxCapacity = 2U * SYS_INFO_MAX_TASKS;
+#endif
 
+typedef struct {
+    TaskStatus_t *psTasks;
+    UBaseType_t   uxCount;
+    uint64_t      u64Total;     /* run time counter at the snapshot */
+} snapshot_s;
 
-static void printStackWatermarks(void)
+
+/* room for uxSets snapshots of every task, false when the heap has none */
+static bool reserve(UBaseType_t uxSets)
 {
-    TaskStatus_t tasks[10];
-    UBaseType_t  count = uxTaskGetSystemState(tasks, 10, NULL);
+    const UBaseType_t uxNeed = (uxTaskGetNumberOfTasks() + SYS_INFO_SPARE_TASKS) * uxSets;
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    if (uxNeed > s_uxCapacity) {
+        vPortFree(s_psTasks);
+        s_psTasks    = (TaskStatus_t *)pvPortMalloc(uxNeed * sizeof(TaskStatus_t));
+        s_uxCapacity = (NULL != s_psTasks) ? uxNeed : 0;
+    }
+    if (NULL == s_psTasks) {
+        uSHELL_PRINTF("sysinfo: no heap for %u task entries\r\n", (unsigned)uxNeed);
+        return false;
+    }
+#else
+    if (uxNeed > s_uxCapacity) {
+        uSHELL_PRINTF("sysinfo: %u task entries, SYS_INFO_MAX_TASKS too small\r\n", (unsigned)uxNeed);
+        return false;
+    }
+#endif
+    return true;
+}
+
+/* every task in set uxSet of the scratch, one scheduler suspension */
+static void snapshot(snapshot_s *psSnap, UBaseType_t uxSet, UBaseType_t uxSets)
+{
+    const UBaseType_t uxSize = s_uxCapacity / uxSets;
+
+    psSnap->psTasks  = &s_psTasks[uxSet * uxSize];
+    psSnap->u64Total = 0U;
+    psSnap->uxCount  = uxTaskGetSystemState(psSnap->psTasks, uxSize, &psSnap->u64Total);
+}
+
+/* per mille of part in total, 0 for an empty total */
+static uint32_t permille(uint64_t part, uint64_t total)
+{
+    return (0U != total) ? (uint32_t)((part * 1000U) / total) : 0U;
+}
+
+
+static void printStackWatermarks(const snapshot_s *psSnap)
+{
+    const TaskStatus_t *tasks = psSnap->psTasks;
+    const UBaseType_t   count = psSnap->uxCount;
 
     uSHELL_PRINTF("%-16s %s\r\n", "Task", "Free words");
     uSHELL_PRINTF("-----------------------------\r\n");
@@ -18,29 +91,37 @@ static void printStackWatermarks(void)
     }
 }
 
-// FreeRTOSConfig.h requirement: configUSE_TRACE_FACILITY 1
-static void printTaskStates(void)
-{
-    static const char *stateNames[] = {
-        "RUNNING", "READY", "BLOCKED", "SUSPENDED", "DELETED"
-    };
+static const char *const s_stateNames[] = {
+    "RUNNING", "READY", "BLOCKED", "SUSPENDED", "DELETED"
+};
 
-    TaskStatus_t tasks[10];
-    UBaseType_t  count = uxTaskGetSystemState(tasks, 10, NULL);
+// FreeRTOSConfig.h requirement: configUSE_TRACE_FACILITY 1, configGENERATE_RUN_TIME_STATS 1
+// CPU share since reset
+static void printTaskStates(const snapshot_s *psSnap)
+{
+    const TaskStatus_t *tasks = psSnap->psTasks;
+    const UBaseType_t   count = psSnap->uxCount;
+    const uint64_t      total = psSnap->u64Total;
 
-    uSHELL_PRINTF("%-16s %-10s %s\r\n", "Task", "State", "Priority");
-    uSHELL_PRINTF("------------------------------------\r\n");
+    uSHELL_PRINTF("%-16s %-10s %-8s %s\r\n", "Task", "State", "Priority", "CPU %");
+    uSHELL_PRINTF("--------------------------------------------\r\n");
     for (UBaseType_t i = 0; i < count; i++) {
-        uSHELL_PRINTF("  %-16s %-10s %u\r\n",
+        const uint32_t pm = permille(tasks[i].ulRunTimeCounter, total);
+
+        uSHELL_PRINTF("  %-16s %-10s %-8u %3u.%u\r\n",
             tasks[i].pcTaskName,
-            stateNames[tasks[i].eCurrentState],
-            tasks[i].uxCurrentPriority);
+            s_stateNames[tasks[i].eCurrentState],
+            tasks[i].uxCurrentPriority,
+            pm / 10U, pm % 10U);
     }
 }
 
-// Always available, no config needed
+// Needs the heap (configSUPPORT_DYNAMIC_ALLOCATION)
 static void printHeapStats(void)
 {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+    uSHELL_PRINTF("Heap stats:\r\n  no heap (NO_HEAP build)\r\n");
+#else
     HeapStats_t stats;
     vPortGetHeapStats(&stats);
 
@@ -53,6 +134,15 @@ static void printHeapStats(void)
     uSHELL_PRINTF("  Smallest block:    %u bytes\r\n", stats.xSizeOfSmallestFreeBlockInBytes);
     uSHELL_PRINTF("  Alloc calls:       %u\r\n",       stats.xNumberOfSuccessfulAllocations);
     uSHELL_PRINTF("  Free calls:        %u\r\n",       stats.xNumberOfSuccessfulFrees);
+#if defined(HEAP_TLSF) && (HEAP_TLSF == 1)
+    /* 1 - largest / free: the share of the free bytes a single malloc cannot get */
+    TlsfFragStats_t frag;
+    vPortGetTlsfFragStats(&frag);
+    uSHELL_PRINTF("  Fragmentation:     %u.%u %% (TLSF)\r\n", frag.ulFragPermille / 10U, frag.ulFragPermille % 10U);
+    uSHELL_PRINTF("  Worst since reset: %u.%u %% (largest >= %u of %u free)\r\n",
+        frag.ulWorstPermille / 10U, frag.ulWorstPermille % 10U, (unsigned)frag.xWorstLargest, (unsigned)frag.xWorstFree);
+#endif
+#endif
 }
 
 static void printUptime(void)
@@ -80,8 +170,102 @@ static void printTaskCount(void)
 extern "C" {
 #endif
 
+/*
+ * portGET_RUN_TIME_COUNTER_VALUE(): microseconds from the tick count and the
+ * SysTick phase. A DWT cycle count would stop with the core clock in wfi and
+ * STOP, where the idle task spends its time; the tick count is stepped over
+ * STOP by the tickless idle. Called at each context switch (interrupts may
+ * be enabled). While the scheduler is suspended the ticks are pended, not
+ * counted: the time holds (it never runs backwards) until they are.
+ */
+uint64_t sys_info_run_time(void)
+{
+    const UBaseType_t uxMask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    TickType_t xTick = xTaskGetTickCount();
+    uint32_t   u32Cvr = STK_CVR;
+    if (0U != (SCB_ICSR & SCB_ICSR_PENDSTSET)) {
+        xTick++;                            /* wrapped, the tick interrupt is still pending */
+        u32Cvr = STK_CVR;
+    }
+
+    s_u64Ticks += (TickType_t)(xTick - s_xLastTick);
+    s_xLastTick = xTick;
+
+    const uint32_t u32Reload = STK_RVR + 1U;
+    uint64_t u64Us = (s_u64Ticks * SYS_INFO_US_PER_TICK) +
+                     (((u32Reload - 1U - u32Cvr) * SYS_INFO_US_PER_TICK) / u32Reload);
+    if (u64Us < s_u64LastUs) {
+        u64Us = s_u64LastUs;
+    }
+    s_u64LastUs = u64Us;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxMask);
+    return u64Us;
+}
+
+/* top ms n: n refreshes of the CPU share per task over ms each (0 0: one over a second) */
+int top(uint32_t u32Ms, uint32_t u32Count)
+{
+    if (0U == u32Ms) {
+        u32Ms = SYS_INFO_TOP_MS;
+    }
+    if (0U == u32Count) {
+        u32Count = 1U;
+    }
+
+    for (uint32_t n = 0U; n < u32Count; n++) {
+        snapshot_s sBefore;
+        snapshot_s sAfter;
+
+        if (false == reserve(2U)) {
+            return -1;
+        }
+        snapshot(&sBefore, 0U, 2U);
+        vTaskDelay(pdMS_TO_TICKS(u32Ms));
+        snapshot(&sAfter, 1U, 2U);
+
+        const TaskStatus_t *tasks  = sAfter.psTasks;
+        const uint64_t      window = sAfter.u64Total - sBefore.u64Total;
+        uint64_t            idle   = 0U;
+
+        uSHELL_PRINTF("\r\n%-16s %-10s %-8s %s\r\n", "Task", "State", "Priority", "CPU %");
+        for (UBaseType_t i = 0; i < sAfter.uxCount; i++) {
+            uint64_t before = 0U;           /* a task created meanwhile ran all its time here */
+            for (UBaseType_t k = 0; k < sBefore.uxCount; k++) {
+                if (sBefore.psTasks[k].xHandle == tasks[i].xHandle) {
+                    before = sBefore.psTasks[k].ulRunTimeCounter;
+                    break;
+                }
+            }
+            const uint64_t run = tasks[i].ulRunTimeCounter - before;
+            const uint32_t pm  = permille(run, window);
+
+            if (tasks[i].xHandle == xTaskGetIdleTaskHandle()) {
+                idle = run;
+            }
+            uSHELL_PRINTF("  %-16s %-10s %-8u %3u.%u\r\n",
+                tasks[i].pcTaskName,
+                s_stateNames[tasks[i].eCurrentState],
+                tasks[i].uxCurrentPriority,
+                pm / 10U, pm % 10U);
+        }
+
+        const uint32_t load = 1000U - permille(idle, window);
+        uSHELL_PRINTF("Load: %u.%u %% over %u ms\r\n", load / 10U, load % 10U, (unsigned)u32Ms);
+    }
+    return 0;
+}
+
 void sysinfo(void)
 {
+    snapshot_s sSnap = { NULL, 0, 0U };
+
+    /* first: a grown scratch shows in the heap stats of this call already */
+    if (reserve(1U)) {
+        snapshot(&sSnap, 0U, 1U);
+    }
+
     uSHELL_PRINTF("\r\n=== System Info ===\r\n");
     printUptime();
     uSHELL_PRINTF("\r\n");
@@ -89,9 +273,9 @@ void sysinfo(void)
     uSHELL_PRINTF("\r\n");
     printHeapStats();
     uSHELL_PRINTF("\r\n");
-    printTaskStates();
+    printTaskStates(&sSnap);
     uSHELL_PRINTF("\r\n");
-    printStackWatermarks();
+    printStackWatermarks(&sSnap);
     uSHELL_PRINTF("==================\r\n");
 }
 
@@ -0,0 +1,87 @@
+#ifndef TRACE_REC_H
+#define TRACE_REC_H
+
+#include <stdint.h>
+
+/*
+    Event trace recorder, built with -DUSHELL_TRACE=ON (TRACE_REC 1): a flight recorder of
+    the last TRACE_REC_RECORDS events with their DWT_CYCCNT time, for a timeline of the task
+    switches, ISRs, AO posts and dispatches and the shell commands.
+
+    Record (8 bytes, little endian): CYCLES (4) | TYPE (1) | ID (1) | ARG (2)
+        TRACE_TASK_IN           ID task                 (traceTASK_SWITCHED_IN, FreeRTOSConfig.h)
+        TRACE_ISR_ENTER/EXIT    ID isr_prof source      (ISR_PROF_ENTER/EXIT, isr_prof.h)
+        TRACE_AO_POST           ID AO, ARG signal       (ActiveObject post, task or ISR)
+        TRACE_AO_BEGIN/END      ID AO, ARG signal       (around the dispatch)
+        TRACE_CMD_BEGIN/END     ID command, ARG result  (around a shell command)
+        TRACE_PROBE             ID probe point          (PROBE of probe.h, USHELL_PROBE=TRACE)
+    A task is switched out when the next one is switched in. The ids of the tasks, AOs and
+    commands are given out by trace_rec_id() on first use, up to TRACE_REC_NAMES of them.
+
+    The shell command trace 1 clears the ring and starts recording (it runs from reset),
+    trace 0 stops it and prints
+        TH:<cpu hz>                     once
+        TN:<id>,<kind>,<name>           every id, kind t(ask) a(o) c(ommand) i(sr)
+        TR:<hex>                        up to 8 records, oldest first
+    for tools/trace2json.py, which writes a Chrome/Perfetto trace JSON. The cycle counter
+    wraps every 2^32 cycles (~43 s at 100 MHz) and stops in STOP: records further apart
+    than a wrap are misplaced. SysTick is not traced, it would fill the ring every tick.
+    Without TRACE_REC the macros are empty.
+*/
+
+#ifndef TRACE_REC_RECORDS
+#define TRACE_REC_RECORDS       256U     /* power of two, 8 bytes each */
+#endif
+#define TRACE_REC_NAMES         32U
+#define TRACE_REC_NO_ID         0xFFU    /* the name table is full */
+
+typedef enum {
+    TRACE_TASK_IN = 1,
+    TRACE_ISR_ENTER,
+    TRACE_ISR_EXIT,
+    TRACE_AO_POST,
+    TRACE_AO_BEGIN,
+    TRACE_AO_END,
+    TRACE_CMD_BEGIN,
+    TRACE_CMD_END,
+    TRACE_PROBE
+} trace_rec_type_e;
+
+typedef enum {
+    TRACE_KIND_TASK    = 't',
+    TRACE_KIND_AO      = 'a',
+    TRACE_KIND_COMMAND = 'c'
+} trace_rec_kind_e;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* enables the cycle counter, before the scheduler */
+void trace_rec_init(void);
+
+/* one record (task, ISR, before the scheduler starts) */
+void trace_rec_event(trace_rec_type_e eType, uint8_t u8Id, uint16_t u16Arg);
+
+/* the id of pvKey, given out on first use; the name must stay valid (tasks: their TCB name) */
+uint8_t trace_rec_id(trace_rec_kind_e eKind, const void *pvKey, const char *pstrName);
+
+/* names of the ISR ids, from isr_prof */
+void trace_rec_isr_names(const char *const *ppstrNames, uint32_t u32Count);
+
+/* traceTASK_SWITCHED_IN(pxCurrentTCB) */
+void trace_rec_task_in(void *pvTask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(TRACE_REC) && (TRACE_REC == 1)
+#define TRACE_REC_ISR_ENTER(src)    trace_rec_event(TRACE_ISR_ENTER, (uint8_t)(src), 0U)
+#define TRACE_REC_ISR_EXIT(src)     trace_rec_event(TRACE_ISR_EXIT, (uint8_t)(src), 0U)
+#else
+#define TRACE_REC_ISR_ENTER(src)    ((void)(src))
+#define TRACE_REC_ISR_EXIT(src)     ((void)(src))
+#endif
+
+#endif /* TRACE_REC_H */
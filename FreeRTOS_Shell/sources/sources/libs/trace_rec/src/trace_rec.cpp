@@ -0,0 +1,180 @@
+#include "trace_rec.h"
+#include "ushell_core_printout.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <libopencm3/cm3/dwt.h>
+
+#include <string.h>
+
+static_assert(0U == (TRACE_REC_RECORDS & (TRACE_REC_RECORDS - 1U)), "TRACE_REC_RECORDS must be a power of two");
+static_assert(TRACE_REC_NAMES < TRACE_REC_NO_ID, "TRACE_REC_NAMES must leave TRACE_REC_NO_ID");
+
+#define TRACE_REC_LINE_RECORDS  8U
+
+typedef struct {
+    uint32_t u32Cycles;
+    uint8_t  u8Type;
+    uint8_t  u8Id;
+    uint16_t u16Arg;
+} trace_rec_s;
+
+static_assert(8U == sizeof(trace_rec_s), "trace_rec_s is the 8 byte record of the dump");
+
+typedef struct {
+    const void *pvKey;
+    const char *pstrName;
+    uint8_t     u8Kind;
+} trace_rec_name_s;
+
+/* ring of the last records, the head runs free and is masked on access */
+static trace_rec_s s_asRing[TRACE_REC_RECORDS];
+static volatile uint32_t s_u32Head   = 0U;
+static volatile bool     s_bRunning  = true;
+
+static trace_rec_name_s  s_asNames[TRACE_REC_NAMES];
+static volatile uint32_t s_u32Names  = 0U;
+static const char *const *s_ppstrIsrNames = NULL;
+static uint32_t s_u32IsrNames = 0U;
+
+
+/* PRIMASK based so it works from tasks, ISRs, PendSV and before the scheduler starts */
+static inline uint32_t s_trace_lock(void)
+{
+    uint32_t u32Primask;
+    __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (u32Primask) :: "memory");
+    return u32Primask;
+}
+
+static inline void s_trace_unlock(uint32_t u32Primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (u32Primask) : "memory");
+}
+
+
+/*-----------------------------------------------------------------------------*/
+void trace_rec_init(void)
+{
+    dwt_enable_cycle_counter();
+}
+
+
+/*-----------------------------------------------------------------------------*/
+void trace_rec_event(trace_rec_type_e eType, uint8_t u8Id, uint16_t u16Arg)
+{
+    if (false == s_bRunning) {
+        return;
+    }
+
+    const uint32_t u32Primask = s_trace_lock();
+    trace_rec_s *psRec = &s_asRing[s_u32Head & (TRACE_REC_RECORDS - 1U)];
+
+    psRec->u32Cycles = DWT_CYCCNT;
+    psRec->u8Type    = (uint8_t)eType;
+    psRec->u8Id      = u8Id;
+    psRec->u16Arg    = u16Arg;
+    s_u32Head = s_u32Head + 1U;
+
+    s_trace_unlock(u32Primask);
+}
+
+
+/*-----------------------------------------------------------------------------*/
+uint8_t trace_rec_id(trace_rec_kind_e eKind, const void *pvKey, const char *pstrName)
+{
+    uint8_t u8Id = TRACE_REC_NO_ID;
+    const uint32_t u32Primask = s_trace_lock();
+    const uint32_t u32Count = s_u32Names;
+
+    for (uint32_t i = 0U; i < u32Count; i++) {
+        if ((s_asNames[i].pvKey == pvKey) && (s_asNames[i].u8Kind == (uint8_t)eKind)) {
+            u8Id = (uint8_t)i;
+            break;
+        }
+    }
+    if ((TRACE_REC_NO_ID == u8Id) && (u32Count < TRACE_REC_NAMES)) {
+        s_asNames[u32Count].pvKey    = pvKey;
+        s_asNames[u32Count].pstrName = pstrName;
+        s_asNames[u32Count].u8Kind   = (uint8_t)eKind;
+        s_u32Names = u32Count + 1U;
+        u8Id = (uint8_t)u32Count;
+    }
+
+    s_trace_unlock(u32Primask);
+    return u8Id;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+void trace_rec_isr_names(const char *const *ppstrNames, uint32_t u32Count)
+{
+    s_ppstrIsrNames = ppstrNames;
+    s_u32IsrNames   = u32Count;
+}
+
+
+/*-----------------------------------------------------------------------------*/
+/* from vTaskSwitchContext(), the kernel aware interrupts masked */
+void trace_rec_task_in(void *pvTask)
+{
+    if (false == s_bRunning) {
+        return;
+    }
+
+    const uint8_t u8Id = trace_rec_id(TRACE_KIND_TASK, pvTask, pcTaskGetName((TaskHandle_t)pvTask));
+    trace_rec_event(TRACE_TASK_IN, u8Id, 0U);
+}
+
+
+/*-----------------------------------------------------------------------------*/
+/* shell command: trace 1 clears and starts, trace 0 stops and prints for tools/trace2json.py */
+extern "C" int trace(uint32_t u32Start)
+{
+#if defined(TRACE_REC) && (TRACE_REC == 1)
+    static const char acHex[] = "0123456789ABCDEF";
+    char acLine[2U * TRACE_REC_LINE_RECORDS * sizeof(trace_rec_s) + 1U];
+
+    if (0U != u32Start) {
+        const uint32_t u32Primask = s_trace_lock();
+        s_u32Head  = 0U;
+        s_bRunning = true;
+        s_trace_unlock(u32Primask);
+        return 0;
+    }
+
+    s_bRunning = false;     /* the ring holds still while it is printed */
+
+    uSHELL_PRINTF("TH:%u\r\n", (unsigned)configCPU_CLOCK_HZ);
+    for (uint32_t i = 0U; i < s_u32IsrNames; i++) {
+        uSHELL_PRINTF("TN:%u,i,%s\r\n", (unsigned)i, s_ppstrIsrNames[i]);
+    }
+    for (uint32_t i = 0U; i < s_u32Names; i++) {
+        uSHELL_PRINTF("TN:%u,%c,%s\r\n", (unsigned)i, (char)s_asNames[i].u8Kind, s_asNames[i].pstrName);
+    }
+
+    const uint32_t u32Head  = s_u32Head;
+    uint32_t u32Pos = (u32Head > TRACE_REC_RECORDS) ? (u32Head - TRACE_REC_RECORDS) : 0U;
+
+    while (u32Pos != u32Head) {
+        uint32_t u32Len = 0U;
+        for (uint32_t n = 0U; (n < TRACE_REC_LINE_RECORDS) && (u32Pos != u32Head); n++, u32Pos++) {
+            const uint8_t *pu8Rec = (const uint8_t *)&s_asRing[u32Pos & (TRACE_REC_RECORDS - 1U)];
+            for (uint32_t i = 0U; i < sizeof(trace_rec_s); i++) {
+                acLine[u32Len++] = acHex[pu8Rec[i] >> 4];
+                acLine[u32Len++] = acHex[pu8Rec[i] & 0x0FU];
+            }
+        }
+        acLine[u32Len] = '\0';
+        uSHELL_PRINTF("TR:%s\r\n", acLine);
+    }
+
+    if (u32Head > TRACE_REC_RECORDS) {
+        uSHELL_PRINTF("trace: %u older records overwritten\r\n", (unsigned)(u32Head - TRACE_REC_RECORDS));
+    }
+#else
+    (void)u32Start;
+    uSHELL_PRINTF("trace: built with TRACE_REC 0\r\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+Convert the event trace printed by the shell command trace 0 to a Chrome trace JSON
+Usage: python3 trace2json.py [capture.txt] [-o trace.json]   (reads stdin without a capture)
+
+Open the result in https://ui.perfetto.dev or chrome://tracing. The capture lines are
+    TH:<cpu hz>
+    TN:<id>,<kind>,<name>       kind t(ask) a(o) c(ommand) i(sr)
+    TR:<hex>                    8 byte records: CYCLES (4) | TYPE (1) | ID (1) | ARG (2)
+as in trace_rec.h; every other line is ignored. A task runs from its switch in to the next
+one (one row per task), ISRs and AO dispatches are slices on their own rows, AO posts are
+instants on the row of the AO they were posted to, the shell commands are on one row, the
+probe points (probe.h) are slices on the row of their channel.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TASK_IN, ISR_ENTER, ISR_EXIT, AO_POST, AO_BEGIN, AO_END, CMD_BEGIN, CMD_END, PROBE = range(1, 10)
+
+# process per kind of row, so the viewer groups them
+PIDS = {'t': (1, "tasks"), 'i': (2, "interrupts"), 'a': (3, "active objects"), 'c': (4, "shell"),
+        'p': (5, "probes")}
+
+# the probe channels of probe.h: the id of BEGIN is 2 * channel, END is BEGIN + 1
+PROBE_CHANNELS = ["SHELL_LINE", "SHELL_EXEC", "AO", "UART_RX", "UART_TX", "LCD_I2C"]
+
+
+class DecodeError(Exception):
+    pass
+
+
+def read_capture(source):
+    hz, records = None, []
+    names = {('p', channel): name for channel, name in enumerate(PROBE_CHANNELS)}
+    for line in source:
+        line = line.strip()
+        if line.startswith('TH:'):
+            hz = int(line[3:])
+        elif line.startswith('TN:'):
+            ident, kind, name = line[3:].split(',', 2)
+            names[(kind, int(ident))] = name
+        elif line.startswith('TR:'):
+            data = bytes.fromhex(line[3:])
+            if len(data) % 8:
+                raise DecodeError(f"truncated record line '{line[:20]}...'")
+            records.extend(struct.iter_unpack('<IBBH', data))
+    if hz is None:
+        raise DecodeError("no TH: line (not a trace 0 capture?)")
+    return hz, names, records
+
+
+class Timeline:
+    def __init__(self, hz, names):
+        self.hz = hz
+        self.names = names
+        self.events = []
+        self.rows = set()
+        self.open = {}          # (pid, tid) -> open slice count
+
+    def name(self, kind, ident):
+        return self.names.get((kind, ident), f"{kind}{ident}")
+
+    def add(self, ph, kind, ident, ts, name, **extra):
+        pid, tid = PIDS[kind][0], ident
+        if ph == 'B':
+            self.open[(pid, tid)] = self.open.get((pid, tid), 0) + 1
+        elif ph == 'E':
+            if self.open.get((pid, tid), 0) == 0:
+                return          # began before the oldest record
+            self.open[(pid, tid)] -= 1
+        event = {'ph': ph, 'pid': pid, 'tid': tid, 'ts': ts, 'name': name}
+        event.update(extra)
+        self.events.append(event)
+        self.rows.add((kind, ident))
+
+    def close(self, ts):
+        for (pid, tid), count in self.open.items():
+            self.events.extend({'ph': 'E', 'pid': pid, 'tid': tid, 'ts': ts} for _ in range(count))
+
+    def metadata(self):
+        meta = [{'ph': 'M', 'pid': pid, 'name': 'process_name', 'args': {'name': name}}
+                for pid, name in PIDS.values()]
+        meta += [{'ph': 'M', 'pid': PIDS[kind][0], 'tid': ident, 'name': 'thread_name',
+                  'args': {'name': "commands" if kind == 'c' else self.name(kind, ident)}}
+                 for kind, ident in sorted(self.rows)]
+        return meta
+
+
+def convert(hz, names, records):
+    tl = Timeline(hz, names)
+    cycles, last, ts = 0, None, 0.0
+    running = None              # (task id, since)
+
+    for raw, kind, ident, arg in records:
+        # the counter wraps at 2^32: records are taken to be less than one wrap apart
+        cycles += 0 if last is None else (raw - last) & 0xFFFFFFFF
+        last = raw
+        ts = cycles * 1e6 / hz
+
+        if kind == TASK_IN:
+            if running is not None:
+                task, since = running
+                tl.add('X', 't', task, since, tl.name('t', task), dur=ts - since)
+            running = (ident, ts)
+        elif kind == ISR_ENTER:
+            tl.add('B', 'i', ident, ts, tl.name('i', ident))
+        elif kind == ISR_EXIT:
+            tl.add('E', 'i', ident, ts, tl.name('i', ident))
+        elif kind == AO_POST:
+            tl.add('i', 'a', ident, ts, f"post {arg}", s='t', args={'signal': arg})
+        elif kind == AO_BEGIN:
+            tl.add('B', 'a', ident, ts, f"signal {arg}", args={'signal': arg})
+        elif kind == AO_END:
+            tl.add('E', 'a', ident, ts, f"signal {arg}")
+        elif kind == CMD_BEGIN:
+            tl.add('B', 'c', 0, ts, tl.name('c', ident))
+        elif kind == CMD_END:
+            result = arg - 0x10000 if arg & 0x8000 else arg
+            tl.add('E', 'c', 0, ts, tl.name('c', ident), args={'result': result})
+        elif kind == PROBE:
+            channel = ident >> 1
+            tl.add('E' if ident & 1 else 'B', 'p', channel, ts, tl.name('p', channel))
+        else:
+            raise DecodeError(f"unknown record type {kind}")
+
+    if running is not None:
+        task, since = running
+        tl.add('X', 't', task, since, tl.name('t', task), dur=ts - since)
+    tl.close(ts)
+    return {'traceEvents': tl.metadata() + tl.events, 'displayTimeUnit': 'ns'}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="uShell event trace to Chrome trace JSON")
+    parser.add_argument('capture', nargs='?', help="terminal capture (default: stdin)")
+    parser.add_argument('-o', '--output', default='trace.json', help="JSON file (default: trace.json)")
+    args = parser.parse_args()
+
+    source = open(args.capture, 'r', errors='replace') if args.capture else sys.stdin
+    try:
+        with source:
+            hz, names, records = read_capture(source)
+        trace = convert(hz, names, records)
+    except (DecodeError, ValueError, OSError) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+    with open(args.output, 'w') as f:
+        json.dump(trace, f)
+    print(f"{len(records)} records, {len(trace['traceEvents'])} events -> {args.output}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -6,10 +6,67 @@ extern "C" {
 #endif
 
 #include <stdarg.h>
+#include <stdint.h>
 #include "ushell_core_printout.h"
 
 void uart_setup(void);
 
+/* what uart_putchar() does when the TX ring is full */
+typedef enum {
+    UART_TX_BLOCK = 0,      /* wait for room (default) */
+    UART_TX_DROP,           /* discard the new byte */
+    UART_TX_OVERWRITE       /* discard the oldest queued byte */
+} uart_tx_policy_e;
+
+void uart_tx_set_policy(uart_tx_policy_e ePolicy);
+uint32_t uart_tx_dropped(void);
+
+/* uart_write() and uart_printf() from an interrupt handler, of any priority, never wait: the
+   text goes to a ring of its own and comes out a line per write, above the prompt, from the
+   timer task or the next task which writes (src/uart_access_port.h); the bytes which found
+   no room there */
+uint32_t uart_isr_dropped(void);
+
+/* the output of a task other than the console (the task reading the input) is sent a whole
+   line at a time, above the prompt (src/uart_access_port.h); uart_flush() sends the line the
+   caller has in progress, then waits for the line to be idle */
+void uart_flush(void);
+
+/* nonzero while output is queued or still on the line (a low power mode would cut it off) */
+int uart_tx_busy(void);
+
+/* up to len bytes of input as received (binary, no key handling), fewer once nothing arrived
+   for u32TimeoutMs; from a task, a shell command which takes over the line (mwrite) */
+int uart_read(uint8_t *buf, int len, uint32_t u32TimeoutMs);
+
+/* called from the RX interrupt once new input is in the ring, instead of the wait of a reader: an
+   event driven reader (ShellAO) posts itself an event and takes the bytes with uart_read(.., 0);
+   nullptr removes it. -1 if the backend has no RX interrupt (RTT and PTY are polled) */
+typedef void (*uart_rx_hook_t)(void);
+int uart_rx_set_hook(uart_rx_hook_t pfHook);
+
+/* the beat of the console task for the watchdog (watchdog.h): odd while the task which reads
+   the input waits for it, +2 for each of its writes; the output of the other tasks is not
+   counted, so they do not hide a stalled shell */
+const volatile uint32_t *uart_activity(void);
+
+/* binary telemetry next to the shell text (src/uart_access_port.h): a frame of up to
+   UART_CHANNEL_PAYLOAD_MAX bytes on channel 1 .. UART_CHANNELS - 1, the text is channel 0.
+   From a task, never waits: -1 when the channel is off (the shell command chan), or, counted,
+   when the ring has no room for the frame whole; uart_channel_on() saves building a payload */
+#define UART_CHANNELS               (8U)
+#define UART_CHANNEL_PAYLOAD_MAX    (200U)
+
+int uart_channel_write(uint8_t u8Channel, const void *pvData, uint16_t u16Len);
+int uart_channel_on(uint8_t u8Channel);
+void uart_channel_enable(uint8_t u8Mask);      /* bit n: channel n; bit 0, the text, is always on */
+uint32_t uart_channel_dropped(void);            /* the frames of every channel the ring had no room for */
+
+/* runtime baud rate, -1 if the USART can not reach it (or the backend has none, USB CDC, RTT, SPI, PTY);
+   the shell command baud switches it with a confirmation and keeps it across resets */
+int uart_set_baudrate(uint32_t u32Baud);
+uint32_t uart_get_baudrate(void);
+
 
 #ifdef __cplusplus
 }
@@ -1,25 +1,294 @@
 #include "uart_access.h"
+#include "uart_access_port.h"
+#include "isr_prof.h"
+#include "checksum.h"
+#include "ram_func.h"
+#include "probe.h"
+#if !defined(UART_ACCESS_PTY)
 #include "libopencm3/stm32/rcc.h"
 #include "libopencm3/stm32/gpio.h"
 #include "libopencm3/stm32/usart.h"
+#include "libopencm3/stm32/dma.h"
+#include "libopencm3/cm3/nvic.h"
+#include "libopencm3/cm3/scb.h"
+#include "libopencm3/cm3/dwt.h"
+#include "libopencm3/stm32/pwr.h"
+#if defined(STM32F1)
+#include "libopencm3/stm32/f1/bkp.h"
+#endif /*defined(STM32F1)*/
+#if defined(STM32F4)
+#include "libopencm3/stm32/rtc.h"
+#endif /*defined(STM32F4)*/
+#endif /*!defined(UART_ACCESS_PTY)*/
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <timers.h>
 
 #include <stdarg.h>
 #include <stdint.h>
+#include <string.h>
+
+#if !defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)
+/* ================================================
+            RX path configuration
+==================================================*/
+
+/* USART1_RX request: DMA1 channel 5 (F1), DMA2 stream 2 channel 4 (F4) */
+#if defined(STM32F1)
+#define UART_RX_DMA                 DMA1
+#define UART_RX_DMA_CH              DMA_CHANNEL5
+#define UART_RX_DMA_RCC             RCC_DMA1
+#define UART_RX_DMA_IRQ             NVIC_DMA1_CHANNEL5_IRQ
+#define UART_RX_DMA_ISR             dma1_channel5_isr
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+#define UART_RX_DMA                 DMA2
+#define UART_RX_DMA_CH              DMA_STREAM2
+#define UART_RX_DMA_RCC             RCC_DMA2
+#define UART_RX_DMA_IRQ             NVIC_DMA2_STREAM2_IRQ
+#define UART_RX_DMA_ISR             dma2_stream2_isr
+#endif /*defined(STM32F4)*/
+
+/* the DMA writes the ring in circular mode, its counter is the producer index */
+#define UART_RX_BUFFER_SIZE         (256U)
+
+/* below configMAX_SYSCALL_INTERRUPT_PRIORITY (numerically higher), the ISRs use the FromISR API */
+#define UART_RX_IRQ_PRIORITY        ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+
+/* ================================================
+            TX path configuration
+==================================================*/
+
+/* USART1_TX request: DMA1 channel 4 (F1), DMA2 stream 7 channel 4 (F4) */
+#if defined(STM32F1)
+#define UART_TX_DMA                 DMA1
+#define UART_TX_DMA_CH              DMA_CHANNEL4
+#define UART_TX_DMA_IRQ             NVIC_DMA1_CHANNEL4_IRQ
+#define UART_TX_DMA_ISR             dma1_channel4_isr
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+#define UART_TX_DMA                 DMA2
+#define UART_TX_DMA_CH              DMA_STREAM7
+#define UART_TX_DMA_IRQ             NVIC_DMA2_STREAM7_IRQ
+#define UART_TX_DMA_ISR             dma2_stream7_isr
+#endif /*defined(STM32F4)*/
+
+/* the ring holds the bytes not yet handed to the DMA, which sends chunks out of its own buffer
+   (so the oldest bytes can be overwritten while a transfer is running) */
+#define UART_TX_BUFFER_SIZE         (512U)   /* power of 2 */
+#define UART_TX_DMA_CHUNK           (64U)
+
+/* a writer waiting for room sleeps on its notification UART_TX_NOTIFY_INDEX (index 0 belongs to
+   the reader and the AO loops), given by the TX DMA ISR when a chunk is done: the room grows by a
+   chunk at a time, so that is the trigger level. The timeout covers a transfer held by CTS */
+#define UART_TX_NOTIFY_INDEX        (1U)
+#define UART_TX_WAITERS             (UART_MUX_SLOTS + 1U)   /* the lines and the console */
+#define UART_TX_WAIT_MS             (10U)
+
+static_assert(UART_TX_NOTIFY_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES, "configTASK_NOTIFICATION_ARRAY_ENTRIES must have the TX index");
+
+static_assert(0U == (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1U)), "UART_TX_BUFFER_SIZE must be a power of 2");
+static_assert(UART_TX_BUFFER_SIZE >= UART_MUX_COMMIT_MAX, "UART_TX_BUFFER_SIZE must take a line commit at once");
+
+/* ================================================
+            baud rate configuration
+==================================================*/
+
+#define UART_DEFAULT_BAUDRATE       (115200U)
+#define UART_MIN_BAUDRATE           (1200U)
+#define UART_AUTOBAUD               (1U)        /* stored instead of a rate: measure it on the first Enter */
+#define UART_BAUD_MAGIC             (0xBA5DU)   /* marks a valid setting in the backup registers */
+#define UART_BAUD_CONFIRM_MS        (5000U)     /* a new rate is kept only if Enter arrives at it meanwhile */
+#define UART_AUTOBAUD_TIMEOUT_MS    (10000U)    /* no Enter after reset: fall back to the default rate */
+#define UART_BAUD_CMD_ERR           (0xFFU)
+
+/* ================================================
+            flow control configuration
+==================================================*/
+
+/* RX backpressure from the ring fill level (the DMA always empties the data register,
+   so the hardware RTS would never deassert):
+   UART_ACCESS_FLOW_RTSCTS:  RTS (PA12) driven as a GPIO, CTS (PA11) gates the TX in hardware
+   UART_ACCESS_FLOW_XONXOFF: XOFF / XON sent ahead of the queued output */
+#if defined(UART_ACCESS_FLOW_RTSCTS) && defined(UART_ACCESS_FLOW_XONXOFF)
+#error "UART_ACCESS_FLOW_RTSCTS and UART_ACCESS_FLOW_XONXOFF are exclusive"
+#endif /*defined(UART_ACCESS_FLOW_RTSCTS) && defined(UART_ACCESS_FLOW_XONXOFF)*/
+
+#if defined(UART_ACCESS_FLOW_RTSCTS) || defined(UART_ACCESS_FLOW_XONXOFF)
+#define UART_RX_FLOW_CONTROL
+#endif /*defined(UART_ACCESS_FLOW_RTSCTS) || defined(UART_ACCESS_FLOW_XONXOFF)*/
+
+#define UART_RX_HIGH_WATERMARK      ((UART_RX_BUFFER_SIZE * 3U) / 4U)
+#define UART_RX_LOW_WATERMARK       (UART_RX_BUFFER_SIZE / 4U)
+#define UART_XON                    (0x11U)
+#define UART_XOFF                   (0x13U)
+#endif /*!defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)*/
+
+/* ================================================
+            printf configuration
+==================================================*/
+
+/* uart_printf() stack buffer, written out at every '\n' and when full */
+#define UART_PRINTF_LINE_SIZE       (64U)
+
+/* where the formatting engine puts its characters */
+typedef struct {
+    char *pcBuf;
+    int  iPos;
+    int  iSize;     /* usable bytes, without the NUL of uart_snprintf() */
+    bool bDrain;    /* uart_printf(): written out instead of truncated */
+} fmt_sink_s;
+
+/* ================================================
+            output multiplexer
+==================================================*/
+
+/* the line of a task other than the console, from its first byte to its '\n' (uart_access_port.h) */
+typedef struct {
+    TaskHandle_t volatile xTask;    /* taken under a critical section, given back by its owner */
+    uint16_t u16Len;
+    char acLine[UART_MUX_LINE_SIZE];
+} mux_slot_s;
+
+/* what mux_room() found for a commit */
+typedef enum {
+    MUX_ROOM = 0,                   /* it fits now */
+    MUX_WAIT,                       /* UART_TX_BLOCK: it fits later */
+    MUX_DROP                        /* dropped and counted */
+} mux_room_e;
+
+static mux_slot_s s_vsMuxSlot[UART_MUX_SLOTS];
+static TaskHandle_t volatile s_xMuxConsole = nullptr;  /* the task which reads the input */
+static char s_acMuxShadow[UART_MUX_SHADOW_SIZE];       /* the console output since its last '\n' */
+static uint16_t s_u16MuxShadow = 0U;
+static bool s_bMuxShadowLost = false;                  /* longer than the shadow: not replayed */
+static uint16_t s_u16MuxWant = 0U;                     /* room a waiting line needs, kept for it */
+
+/* ================================================
+            interrupt output
+==================================================*/
+
+#if !defined(UART_ACCESS_PTY)
+/* the text of the interrupt handlers (uart_access_port.h): records of a length byte and up to
+   UART_ISR_RECORD_MAX characters, reserved with LDREX / STREX on the head, committed by the
+   store of the length. 0 is a record not committed yet (the drain zeroes what it took), a
+   record never wraps: UART_ISR_PAD takes the rest of the ring instead */
+#define UART_ISR_RING_SIZE          (512U)  /* power of 2 */
+#define UART_ISR_RECORD_MAX         UART_MUX_LINE_SIZE
+#define UART_ISR_PAD                (0xFFU)
+
+static_assert(0U == (UART_ISR_RING_SIZE & (UART_ISR_RING_SIZE - 1U)), "UART_ISR_RING_SIZE must be a power of 2");
+static_assert(UART_ISR_RECORD_MAX < UART_ISR_PAD, "a record length must not read as the pad");
+
+static uint8_t s_vu8IsrRing[UART_ISR_RING_SIZE];
+static uint32_t s_u32IsrHead = 0U;                     /* reserved, free running, by any handler */
+static uint32_t s_u32IsrTail = 0U;                     /* drained, by one task at a time */
+static uint32_t s_u32IsrPend = 0U;                     /* a drain is queued on the timer task */
+static uint32_t s_u32IsrBusy = 0U;                     /* a task drains */
+static uint32_t s_u32IsrDropped = 0U;
+#endif /*!defined(UART_ACCESS_PTY)*/
+
+/* ================================================
+            telemetry channels
+==================================================*/
+
+/* channel, seq, the payload, the CRC16, stuffed (a byte per 254) and the zeros around */
+#define UART_CHANNEL_RAW_MAX        (2U + UART_CHANNEL_PAYLOAD_MAX + 2U)
+#define UART_CHANNEL_FRAME_MAX      (1U + UART_CHANNEL_RAW_MAX + (UART_CHANNEL_RAW_MAX / 254U) + 1U + 1U)
+
+static_assert(UART_CHANNELS <= 8U, "a bit of the enable mask per channel");
+static_assert(UART_CHANNEL_FRAME_MAX <= UART_MUX_COMMIT_MAX, "every TX ring must take a frame at once");
+
+static volatile uint8_t s_u8ChanMask = 0x01U;          /* the text only, a plain terminal until chan */
+static uint8_t s_vu8ChanSeq[UART_CHANNELS];
+static uint32_t s_vu32ChanSent[UART_CHANNELS];
+static uint32_t s_vu32ChanDropped[UART_CHANNELS];
+static uint8_t s_vu8ChanRaw[UART_CHANNEL_RAW_MAX];     /* both written with the scheduler suspended */
+static uint8_t s_vu8ChanFrame[UART_CHANNEL_FRAME_MAX];
 
 /* ================================================
             private interfaces declaration
 ==================================================*/
 
-static void print_int(int value, int width, char pad, int left_align);
-static void print_hex(unsigned int value, int width, char pad, int left_align);
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad, int left_align);
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad, int left_align);
+static mux_room_e mux_room(uint32_t u32Len, uint32_t u32Keep);
+static void mux_console_write(const char *buf, int len);
+static bool mux_line_commit(const char *pcLine, uint16_t u16Len, bool bWait = true);
+static void mux_shadow(const char *buf, uint32_t len);
+static mux_slot_s *mux_slot_take(void);
+
+#if !defined(UART_ACCESS_PTY)
+static void isr_put(const char *buf, int len);
+static bool isr_may_pend(void);
+static void isr_pended(void *pvParam, uint32_t u32Param);
+static void isr_drain(void);
+#endif /*!defined(UART_ACCESS_PTY)*/
+
+static uint32_t chan_encode(uint8_t *pu8Out, const uint8_t *pu8Raw, uint32_t u32Len);
+
+static void fmt_putc(fmt_sink_s *psSink, char c);
+static void fmt_field(fmt_sink_s *psSink, const char *text, int len, int width, char pad, int left_align);
+static uint64_t fmt_divu10(uint64_t n, uint32_t *rem);
+RAM_FUNC static int fmt_utoa(char *end, uint64_t value, unsigned int base);
+RAM_FUNC static void fmt_number(fmt_sink_s *psSink, uint64_t value, bool negative, unsigned int base, int precision, int width, char pad, int left_align);
+static void fmt_float(fmt_sink_s *psSink, double value, int precision, int width, char pad, int left_align);
+RAM_FUNC static void fmt_vformat(fmt_sink_s *psSink, const char *fmt, va_list args);
+
+#if !defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)
+static void rx_dma_setup(void);
+static inline uint16_t rx_dma_head(void);
+static void rx_wait(void);
+static void rx_notify_from_isr(void);
+static void rx_flow_update(void);
+
+static bool rx_wait_for(uint32_t u32Ms);
+static void activity_add(uint32_t u32Step);
+static void activity_output(void);
+
+static void tx_dma_setup(void);
+static void tx_kick(void);
+static void tx_notify_from_isr(void);
+
+static bool baud_valid(uint32_t u32Baud);
+static uint32_t baud_load(void);
+static void baud_store(uint32_t u32Baud);
+static uint32_t baud_detect(void);
+#endif /*!defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)*/
+
+#if !defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)
+/* ================================================
+            private data
+==================================================*/
+
+static volatile uint8_t s_vu8RxBuffer[UART_RX_BUFFER_SIZE];
+static uint16_t s_u16RxTail = 0;                       /* consumer index, owned by the reading task */
+static TaskHandle_t volatile s_xRxTask = nullptr;      /* task blocked in uart_getchar() */
+static volatile uart_rx_hook_t s_pfRxHook = nullptr;   /* uart_rx_set_hook() */
+static volatile uint32_t s_u32Activity = 0U;           /* uart_activity() */
+
+static uint8_t s_vu8TxBuffer[UART_TX_BUFFER_SIZE];
+static uint8_t s_vu8TxDma[UART_TX_DMA_CHUNK];
+static volatile uint16_t s_u16TxHead = 0;              /* free running, masked on access */
+static volatile uint16_t s_u16TxTail = 0;
+static volatile bool s_bTxBusy = false;                /* a DMA transfer is running */
+static volatile uint32_t s_u32TxDropped = 0;
+static volatile uart_tx_policy_e s_eTxPolicy = UART_TX_BLOCK;
+static volatile uint8_t s_u8TxCtrl = 0U;               /* XON / XOFF waiting for the DMA */
+static TaskHandle_t volatile s_vxTxWaiter[UART_TX_WAITERS];    /* in uart_port_tx_wait(), under the critical section */
+
+static volatile bool s_bRxPaused = false;              /* the sender was asked to stop */
+
+static uint32_t s_u32Baudrate = UART_DEFAULT_BAUDRATE;
+#endif /*!defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)*/
 
 /* ================================================
             public interfaces ddefinition
 ==================================================*/
 
 
+#if !defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)
 /*--------------------------------------------------*/
 void uart_setup(void)
 {
@@ -32,6 +301,16 @@ void uart_setup(void)
                   GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, GPIO_USART1_TX);
     gpio_set_mode(GPIOA, GPIO_MODE_INPUT,
                   GPIO_CNF_INPUT_FLOAT, GPIO_USART1_RX);
+
+#if defined(UART_ACCESS_FLOW_RTSCTS)
+    /* CTS pulled down: a line left open does not stall the output; RTS low: ready */
+    gpio_set_mode(GPIOA, GPIO_MODE_INPUT,
+                  GPIO_CNF_INPUT_PULL_UPDOWN, GPIO_USART1_CTS);
+    gpio_clear(GPIOA, GPIO_USART1_CTS);
+    gpio_clear(GPIOA, GPIO_USART1_RTS);
+    gpio_set_mode(GPIOA, GPIO_MODE_OUTPUT_50_MHZ,
+                  GPIO_CNF_OUTPUT_PUSHPULL, GPIO_USART1_RTS);
+#endif /*defined(UART_ACCESS_FLOW_RTSCTS)*/
 #endif /*defined(STM32F1)*/
 
 #if defined(STM32F4)
@@ -49,15 +328,46 @@ void uart_setup(void)
     /* Configure PA10 as USART1_RX - Alternate Function */
     gpio_mode_setup(GPIOA, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO10);
     gpio_set_af(GPIOA, GPIO_AF7, GPIO10);  /* AF7 is USART1 for STM32F411 */
+
+#if defined(UART_ACCESS_FLOW_RTSCTS)
+    /* PA11 as USART1_CTS pulled down: a line left open does not stall the output */
+    gpio_mode_setup(GPIOA, GPIO_MODE_AF, GPIO_PUPD_PULLDOWN, GPIO11);
+    gpio_set_af(GPIOA, GPIO_AF7, GPIO11);
+
+    /* PA12 as RTS, a plain output driven from the RX ring level; low: ready */
+    gpio_clear(GPIOA, GPIO12);
+    gpio_mode_setup(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, GPIO12);
+#endif /*defined(UART_ACCESS_FLOW_RTSCTS)*/
 #endif /*defined(STM32F4)*/
 
+    /* stored rate, or measured on the first Enter when the detection is selected */
+    s_u32Baudrate = baud_load();
+    if (UART_AUTOBAUD == s_u32Baudrate) {
+        s_u32Baudrate = baud_detect();
+    }
+
     /* Setup USART1 parameters */
-    usart_set_baudrate(USART1, 115200);
+    usart_set_baudrate(USART1, s_u32Baudrate);
     usart_set_databits(USART1, 8);
     usart_set_stopbits(USART1, USART_STOPBITS_1);
     usart_set_mode(USART1, USART_MODE_TX_RX);
     usart_set_parity(USART1, USART_PARITY_NONE);
+#if defined(UART_ACCESS_FLOW_RTSCTS)
+    usart_set_flow_control(USART1, USART_FLOWCONTROL_CTS);
+#else
     usart_set_flow_control(USART1, USART_FLOWCONTROL_NONE);
+#endif /*defined(UART_ACCESS_FLOW_RTSCTS)*/
+
+    /* TX through DMA, fed from the ring */
+    tx_dma_setup();
+    usart_enable_tx_dma(USART1);
+
+    /* RX through DMA, IDLE line signals the end of a burst */
+    rx_dma_setup();
+    usart_enable_rx_dma(USART1);
+    usart_enable_idle_interrupt(USART1);
+    nvic_set_priority(NVIC_USART1_IRQ, UART_RX_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_USART1_IRQ);
 
     /* Enable USART1 */
     usart_enable(USART1);
@@ -68,329 +378,387 @@ void uart_setup(void)
 /*--------------------------------------------------*/
 int uart_getchar(void)
 {
-    while (!(USART_SR(USART1) & USART_SR_RXNE)); // Wait for data
-    return usart_recv(USART1);
+    uart_mux_reader();
+    while (s_u16RxTail == rx_dma_head()) {
+        rx_wait();
+    }
+    const uint8_t c = s_vu8RxBuffer[s_u16RxTail];
+    s_u16RxTail = (uint16_t)((s_u16RxTail + 1U) % UART_RX_BUFFER_SIZE);
+    rx_flow_update();
+    return c;
 }
 
 
 
 /*--------------------------------------------------*/
-void uart_putchar(char c)
+/* the reader is woken at IDLE line, so a pasted line is usually complete here;
+   anything else (control keys, partial or too long line) stays for uart_getchar() */
+int uart_getline(char *buf, int maxlen)
 {
-    usart_send_blocking(USART1, c);
+    uart_mux_reader();
+    while (s_u16RxTail == rx_dma_head()) {
+        rx_wait();
+    }
+
+    const uint16_t u16Head = rx_dma_head();
+    uint16_t u16Idx = s_u16RxTail;
+    int consumed = 0;
+    int len = 0;
+
+    while (u16Idx != u16Head) {
+        const uint8_t c = s_vu8RxBuffer[u16Idx];
+        u16Idx = (uint16_t)((u16Idx + 1U) % UART_RX_BUFFER_SIZE);
+        consumed++;
+        if ('\r' == c) {
+            buf[len] = '\0';
+            s_u16RxTail = u16Idx;
+            rx_flow_update();
+            return consumed;
+        }
+        if ('\n' == c) {
+            continue;
+        }
+        if ((c < 0x20U) || (c > 0x7EU) || (len >= maxlen - 1)) {
+            break;
+        }
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
 }
 
 
+
 /*--------------------------------------------------*/
-int uart_printf(const char *fmt, ...)
+/* the ring runs in one or two contiguous parts between the tail and the DMA head */
+int uart_read(uint8_t *buf, int len, uint32_t u32TimeoutMs)
 {
-    va_list args;
-    va_start(args, fmt);
-    while (*fmt) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad = ' ';
-            int width = 0;
-            int left_align = 0;  // Flag for left alignment
-            
-            // Check for left alignment flag '-'
-            if (*fmt == '-') {
-                left_align = 1;
-                fmt++;
-            }
-            
-            // Check for zero padding
-            if (*fmt == '0') {
-                pad = '0';
-                fmt++;
-            }
-            
-            // Parse width
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
-            }
-            
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    int len = 0;
-                    const char *temp = s;
-                    
-                    // Calculate string length
-                    while (*temp++) len++;
-                    
-                    // Left-aligned: print string first, then padding
-                    if (left_align) {
-                        temp = s;
-                        while (*temp) {
-                            uart_putchar(*temp++);
-                        }
-                        // Add padding on the right
-                        for (int i = len; i < width; i++) {
-                            uart_putchar(pad);
-                        }
-                    } 
-                    // Right-aligned: print padding first, then string
-                    else {
-                        // Add padding on the left
-                        for (int i = len; i < width; i++) {
-                            uart_putchar(pad);
-                        }
-                        while (*s) {
-                            uart_putchar(*s++);
-                        }
-                    }
-                    break;
-                }
-                case 'u':
-                    print_int(va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'd':
-                    print_int(va_arg(args, int), width, pad, left_align);
-                    break;
-                case 'x':
-                case 'X':                
-                    print_hex(va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'c':
-                    uart_putchar((char)va_arg(args, int));
-                    break;
-                default:
-                    uart_putchar('%');
-                    uart_putchar(*fmt);
-                    break;
+    int done = 0;
+
+    uart_mux_reader();
+    while (done < len) {
+        const uint16_t u16Head = rx_dma_head();
+        if (s_u16RxTail == u16Head) {
+            if (false == rx_wait_for(u32TimeoutMs)) {
+                break;
             }
-        } else {
-            uart_putchar(*fmt);
+            continue;
         }
-        fmt++;
+        const uint16_t u16End = (u16Head > s_u16RxTail) ? u16Head : (uint16_t)UART_RX_BUFFER_SIZE;
+        while ((s_u16RxTail != u16End) && (done < len)) {
+            buf[done++] = s_vu8RxBuffer[s_u16RxTail++];
+        }
+        s_u16RxTail = (uint16_t)(s_u16RxTail % UART_RX_BUFFER_SIZE);
+        rx_flow_update();
     }
-    va_end(args);
+    return done;
+}
+
+
+
+/*--------------------------------------------------*/
+/* IDLE line: the sender paused, the bytes of the burst are already in the ring */
+extern "C" RAM_FUNC void usart1_isr(void)
+{
+    ISR_PROF_ENTER(ISR_PROF_USART1);
+    PROBE(UART_RX_BEGIN);
+    if (USART_SR(USART1) & (USART_SR_IDLE | USART_SR_ORE)) {
+        (void)USART_DR(USART1); /* SR then DR read clears IDLE and ORE */
+    }
+    rx_flow_update();
+    rx_notify_from_isr();
+    PROBE(UART_RX_END);
+    ISR_PROF_EXIT(ISR_PROF_USART1);
+}
+
+
+
+/*--------------------------------------------------*/
+/* half/full ring: wake the reader before a long burst wraps over unread data */
+extern "C" RAM_FUNC void UART_RX_DMA_ISR(void)
+{
+    ISR_PROF_ENTER(ISR_PROF_UART_RX_DMA);
+    PROBE(UART_RX_BEGIN);
+    dma_clear_interrupt_flags(UART_RX_DMA, UART_RX_DMA_CH, DMA_HTIF | DMA_TCIF);
+    rx_flow_update();
+    rx_notify_from_isr();
+    PROBE(UART_RX_END);
+    ISR_PROF_EXIT(ISR_PROF_UART_RX_DMA);
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_tx_set_policy(uart_tx_policy_e ePolicy)
+{
+    s_eTxPolicy = ePolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_tx_dropped(void)
+{
+    return s_u32TxDropped;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_rx_set_hook(uart_rx_hook_t pfHook)
+{
+    s_pfRxHook = pfHook;
     return 0;
 }
 
 
+
 /*--------------------------------------------------*/
-int uart_snprintf(char *buf, int maxlen, const char *fmt, ...)
+const volatile uint32_t *uart_activity(void)
 {
-    va_list args;
-    va_start(args, fmt);
-    int pos = 0;
+    return &s_u32Activity;
+}
 
-    while (*fmt && pos < maxlen - 1) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad = ' ';
-            int width = 0;
-            int left_align = 0;  // Flag for left alignment
-            
-            // Check for left alignment flag '-'
-            if (*fmt == '-') {
-                left_align = 1;
-                fmt++;
-            }
-            
-            // Check for zero padding
-            if (*fmt == '0') {
-                pad = '0';
-                fmt++;
-            }
-            
-            // Parse width
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
-            }
-            
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    int len = 0;
-                    const char *temp = s;
-                    
-                    // Calculate string length
-                    while (*temp++) len++;
-                    
-                    // Left-aligned: print string first, then padding
-                    if (left_align) {
-                        temp = s;
-                        while (*temp && pos < maxlen - 1) {
-                            buf[pos++] = *temp++;
-                        }
-                        // Add padding on the right
-                        for (int i = len; i < width && pos < maxlen - 1; i++) {
-                            buf[pos++] = pad;
-                        }
-                    } 
-                    // Right-aligned: print padding first, then string
-                    else {
-                        // Add padding on the left
-                        for (int i = len; i < width && pos < maxlen - 1; i++) {
-                            buf[pos++] = pad;
-                        }
-                        while (*s && pos < maxlen - 1) {
-                            buf[pos++] = *s++;
-                        }
-                    }
-                    break;
-                }
-                case 'u':
-                    print_int_to_buf(buf, &pos, maxlen, va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'd':
-                    print_int_to_buf(buf, &pos, maxlen, va_arg(args, int), width, pad, left_align);
-                    break;
-                case 'x':
-                case 'X':
-                    print_hex_to_buf(buf, &pos, maxlen, va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'c':
-                    if (pos < maxlen - 1) {
-                        buf[pos++] = (char)va_arg(args, int);
-                    }
-                    break;
-                default:
-                    if (pos < maxlen - 1) buf[pos++] = '%';
-                    if (pos < maxlen - 1) buf[pos++] = *fmt;
-                    break;
-            }
-        } else {
-            buf[pos++] = *fmt;
+
+
+/*--------------------------------------------------*/
+/* wait until everything queued so far is on the line (i.e. before a reset or a low power mode) */
+void uart_flush(void)
+{
+    uart_mux_flush();
+    while ((s_u16TxHead != s_u16TxTail) || (true == s_bTxBusy)) {
+        if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+            vTaskDelay(1);
         }
-        fmt++;
     }
+    while (!(USART_SR(USART1) & USART_SR_TC)); /* last byte shifted out */
+}
 
-    buf[pos] = '\0';
-    va_end(args);
-    return pos;
+
+
+/*--------------------------------------------------*/
+int uart_tx_busy(void)
+{
+    return ((s_u16TxHead != s_u16TxTail) || (true == s_bTxBusy) || (0U == (USART_SR(USART1) & USART_SR_TC))) ? 1 : 0;
 }
 
 
 
-/* ================================================
-            private interfaces definition
-==================================================*/
+/*--------------------------------------------------*/
+/* the queued output still goes out at the old rate, the RX DMA keeps running */
+int uart_set_baudrate(uint32_t u32Baud)
+{
+    if (false == baud_valid(u32Baud)) {
+        return -1;
+    }
+
+    uart_flush();
+    usart_disable(USART1);
+    usart_set_baudrate(USART1, u32Baud);
+    usart_enable(USART1);
+    s_u32Baudrate = u32Baud;
+    return 0;
+}
+
 
 
 /*--------------------------------------------------*/
-static void print_int(int value, int width, char pad, int left_align)
+uint32_t uart_get_baudrate(void)
 {
-    char buffer[12];
-    int i = 0;
-    int is_negative = 0;
-    
-    if (value < 0) {
-        is_negative = 1;
-        value = -value;
+    return s_u32Baudrate;
+}
+
+
+
+/*--------------------------------------------------*/
+/* shell command: 0 shows the rates, 1 selects the detection at the next reset, any other
+   value switches now and stays (and is stored) only if Enter is received at the new rate */
+extern "C" int baud(uint32_t u32Baud)
+{
+    if (0U == u32Baud) {
+        const uint32_t u32Stored = baud_load();
+        if (UART_AUTOBAUD == u32Stored) {
+            uart_printf("baud: %u, at reset: detected\r\n", s_u32Baudrate);
+        } else {
+            uart_printf("baud: %u, at reset: %u\r\n", s_u32Baudrate, u32Stored);
+        }
+        return 0;
     }
-    
-    do {
-        buffer[i++] = '0' + (value % 10);
-        value /= 10;
-    } while (value);
-    
-    if (is_negative) {
-        buffer[i++] = '-';
+
+    if (UART_AUTOBAUD == u32Baud) {
+        baud_store(UART_AUTOBAUD);
+        uart_printf("baud: after reset press Enter to set the rate\r\n");
+        return 0;
     }
-    
-    // Left-aligned: print number first, then padding
-    if (left_align) {
-        for (int j = i - 1; j >= 0; j--) {
-            uart_putchar(buffer[j]);
-        }
-        for (int j = i; j < width; j++) {
-            uart_putchar(pad);
-        }
+
+    if (false == baud_valid(u32Baud)) {
+        uart_printf("baud: %u not reachable\r\n", u32Baud);
+        return UART_BAUD_CMD_ERR;
+    }
+
+    /* the confirmation timeout needs the tick */
+    if (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) {
+        uart_printf("baud: switching needs the scheduler\r\n");
+        return UART_BAUD_CMD_ERR;
     }
-    // Right-aligned: padding first, then number
-    else {
-        for (int j = i; j < width; j++) {
-            uart_putchar(pad);
+
+    const uint32_t u32Old = s_u32Baudrate;
+    uart_printf("baud: switching to %u, press Enter within %u s\r\n", u32Baud, UART_BAUD_CONFIRM_MS / 1000U);
+    (void)uart_set_baudrate(u32Baud);
+
+    /* whatever arrived before the switch was sent at the old rate */
+    s_u16RxTail = rx_dma_head();
+
+    bool bConfirmed = false;
+    const TickType_t xStart = xTaskGetTickCount();
+    const TickType_t xTimeout = pdMS_TO_TICKS(UART_BAUD_CONFIRM_MS);
+    while (false == bConfirmed) {
+        const TickType_t xElapsed = xTaskGetTickCount() - xStart;
+        if ((xElapsed >= xTimeout) || (false == rx_wait_for((uint32_t)((xTimeout - xElapsed) * portTICK_PERIOD_MS)))) {
+            break;
         }
-        for (int j = i - 1; j >= 0; j--) {
-            uart_putchar(buffer[j]);
+        while ((false == bConfirmed) && (s_u16RxTail != rx_dma_head())) {
+            bConfirmed = ('\r' == s_vu8RxBuffer[s_u16RxTail]);
+            s_u16RxTail = (uint16_t)((s_u16RxTail + 1U) % UART_RX_BUFFER_SIZE);
         }
+        rx_flow_update();
+    }
+
+    if (false == bConfirmed) {
+        (void)uart_set_baudrate(u32Old);
+        uart_printf("baud: no Enter received, back to %u\r\n", u32Old);
+        return UART_BAUD_CMD_ERR;
     }
+
+    baud_store(u32Baud);
+    uart_printf("baud: %u stored\r\n", u32Baud);
+    return 0;
 }
 
 
 
 /*--------------------------------------------------*/
-static void print_hex(unsigned int value, int width, char pad, int left_align)
+/* chunk sent: start the next one */
+extern "C" RAM_FUNC void UART_TX_DMA_ISR(void)
 {
-    const char *hex = "0123456789ABCDEF";
-    char buffer[8];
-    int i = 0;
-    
-    do {
-        buffer[i++] = hex[value & 0xF];
-        value >>= 4;
-    } while (value);
-    
-    // Left-aligned: 0x + number first, then padding
-    if (left_align) {
-        uart_putchar('0');
-        uart_putchar('x');
-        for (int j = i - 1; j >= 0; j--) {
-            uart_putchar(buffer[j]);
-        }
-        for (int j = i + 2; j < width; j++) {
-            uart_putchar(pad);
-        }
+    ISR_PROF_ENTER(ISR_PROF_UART_TX_DMA);
+    dma_clear_interrupt_flags(UART_TX_DMA, UART_TX_DMA_CH, DMA_TCIF);
+    const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    s_bTxBusy = false;
+    tx_kick();
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+    tx_notify_from_isr();
+    ISR_PROF_EXIT(ISR_PROF_UART_TX_DMA);
+}
+#endif /*!defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)*/
+
+
+/*--------------------------------------------------*/
+/* the console writes straight through; any other task fills its line, committed at the '\n' */
+void uart_write(const char *buf, int len)
+{
+    if (len <= 0) {
+        return;
+    }
+#if !defined(UART_ACCESS_PTY)
+    if (pdFALSE != xPortIsInsideInterrupt()) {
+        isr_put(buf, len);
+        return;
+    }
+    if (__atomic_load_n(&s_u32IsrHead, __ATOMIC_RELAXED) != s_u32IsrTail) {
+        isr_drain();            /* the text of a handler which could not queue a drain */
+    }
+#endif /*!defined(UART_ACCESS_PTY)*/
+    if (true == uart_port_tx_early(buf, len)) {
+        return;
+    }
+    PROBE(UART_TX_BEGIN);
+    if ((taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) || (xTaskGetCurrentTaskHandle() == s_xMuxConsole)) {
+        mux_console_write(buf, len);
+        PROBE(UART_TX_END);
+        return;
     }
-    // Right-aligned: padding first, then 0x + number
-    else {
-        for (int j = i + 2; j < width; j++) {
-            uart_putchar(pad);
+
+    mux_slot_s *psSlot = mux_slot_take();
+    if (nullptr == psSlot) {
+        /* every slot has a line in progress: a line per piece, still whole above the prompt */
+        while (len > 0) {
+            const uint16_t u16Len = (len < (int)UART_MUX_LINE_SIZE) ? (uint16_t)len : (uint16_t)UART_MUX_LINE_SIZE;
+            mux_line_commit(buf, u16Len);
+            buf += u16Len;
+            len -= u16Len;
         }
-        uart_putchar('0');
-        uart_putchar('x');
-        for (int j = i - 1; j >= 0; j--) {
-            uart_putchar(buffer[j]);
+        PROBE(UART_TX_END);
+        return;
+    }
+    for (int i = 0; i < len; ++i) {
+        psSlot->acLine[psSlot->u16Len++] = buf[i];
+        if (('\n' == buf[i]) || (UART_MUX_LINE_SIZE == psSlot->u16Len)) {
+            mux_line_commit(psSlot->acLine, psSlot->u16Len);
+            psSlot->u16Len = 0U;
         }
     }
+    if (0U == psSlot->u16Len) {
+        psSlot->xTask = nullptr;
+    }
+    PROBE(UART_TX_END);
 }
 
 
 
 /*--------------------------------------------------*/
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad, int left_align)
+uint32_t uart_isr_dropped(void)
 {
-    char tmp[12];
-    int i = 0;
-    int is_negative = 0;
-    
-    if (value < 0) {
-        is_negative = 1;
-        value = -value;
+#if !defined(UART_ACCESS_PTY)
+    return __atomic_load_n(&s_u32IsrDropped, __ATOMIC_RELAXED);
+#else
+    return 0U;
+#endif /*!defined(UART_ACCESS_PTY)*/
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_putchar(char c)
+{
+    uart_write(&c, 1);
+}
+
+
+
+/*--------------------------------------------------*/
+/* a new console first commits the line it had in progress as any other task */
+void uart_mux_reader(void)
+{
+    if (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) {
+        return;
     }
-    
-    do {
-        tmp[i++] = '0' + (value % 10);
-        value /= 10;
-    } while (value);
-    
-    if (is_negative) {
-        tmp[i++] = '-';
+    const TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+    if (xSelf != s_xMuxConsole) {
+        uart_mux_flush();
+        s_xMuxConsole = xSelf;
     }
-    
-    // Left-aligned: number first, then padding
-    if (left_align) {
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) {
-            buf[(*pos)++] = tmp[j];
-        }
-        for (int j = i; j < width && *pos < maxlen - 1; j++) {
-            buf[(*pos)++] = pad;
-        }
+}
+
+
+
+/*--------------------------------------------------*/
+/* a prompt of a task other than the console ("continue? ") shows up before its '\n' */
+void uart_mux_flush(void)
+{
+    if (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) {
+        return;
     }
-    // Right-aligned: padding first, then number
-    else {
-        for (int j = i; j < width && *pos < maxlen - 1; j++) {
-            buf[(*pos)++] = pad;
-        }
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) {
-            buf[(*pos)++] = tmp[j];
+    const TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+    for (uint32_t i = 0; i < UART_MUX_SLOTS; ++i) {
+        mux_slot_s *psSlot = &s_vsMuxSlot[i];
+        if (xSelf == psSlot->xTask) {
+            if (psSlot->u16Len > 0U) {
+                mux_line_commit(psSlot->acLine, psSlot->u16Len);
+                psSlot->u16Len = 0U;
+            }
+            psSlot->xTask = nullptr;
+            return;
         }
     }
 }
@@ -398,44 +766,1301 @@ static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int wid
 
 
 /*--------------------------------------------------*/
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad, int left_align)
+/* encoded with the scheduler suspended (a writer at a time, the interrupts on), queued whole
+   in one critical section; the room a waiting line needs is left to it, as by the console */
+int uart_channel_write(uint8_t u8Channel, const void *pvData, uint16_t u16Len)
 {
-    const char *hex = "0123456789ABCDEF";
-    char tmp[8];
-    int i = 0;
-    
-    do {
-        tmp[i++] = hex[value & 0xF];
-        value >>= 4;
-    } while (value);
-    
-    // Left-aligned: 0x + number first, then padding
+    if ((0U == u8Channel) || (u8Channel >= UART_CHANNELS) || (u16Len > UART_CHANNEL_PAYLOAD_MAX)) {
+        return -1;
+    }
+    if ((0 == uart_channel_on(u8Channel)) || (taskSCHEDULER_RUNNING != xTaskGetSchedulerState())) {
+        return -1;
+    }
+
+    int iRetVal = -1;
+
+    vTaskSuspendAll();
+    s_vu8ChanRaw[0] = u8Channel;
+    s_vu8ChanRaw[1] = s_vu8ChanSeq[u8Channel]++;
+    memcpy(&s_vu8ChanRaw[2], pvData, u16Len);
+    const uint16_t u16Crc = checksum_crc16(CHECKSUM_CRC16_INIT, s_vu8ChanRaw, 2U + u16Len);
+    s_vu8ChanRaw[2U + u16Len] = (uint8_t)u16Crc;
+    s_vu8ChanRaw[3U + u16Len] = (uint8_t)(u16Crc >> 8);
+    const uint32_t u32Len = chan_encode(s_vu8ChanFrame, s_vu8ChanRaw, 2U + u16Len + 2U);
+
+    taskENTER_CRITICAL();
+    if ((true == uart_port_tx_open()) && (uart_port_tx_free() >= u32Len + s_u16MuxWant)) {
+        uart_port_tx_put((const char *)s_vu8ChanFrame, u32Len);
+        s_vu32ChanSent[u8Channel]++;
+        iRetVal = 0;
+    } else {
+        s_vu32ChanDropped[u8Channel]++;
+    }
+    taskEXIT_CRITICAL();
+    (void)xTaskResumeAll();
+    return iRetVal;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_channel_on(uint8_t u8Channel)
+{
+    return ((u8Channel < UART_CHANNELS) && (0U != (s_u8ChanMask & (1U << u8Channel)))) ? 1 : 0;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_channel_enable(uint8_t u8Mask)
+{
+    s_u8ChanMask = (uint8_t)(u8Mask | 0x01U);
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_channel_dropped(void)
+{
+    uint32_t u32Dropped = 0U;
+
+    for (uint8_t i = 1U; i < UART_CHANNELS; ++i) {
+        u32Dropped += s_vu32ChanDropped[i];
+    }
+    return u32Dropped;
+}
+
+
+
+/*--------------------------------------------------*/
+/* shell command: 0 shows the mask and the frames sent and dropped per channel, any other value
+   is the new mask (bit 0 is the text: chan 1 turns the telemetry off) */
+extern "C" int chan(uint32_t u32Mask)
+{
+    if (u32Mask >= (1UL << UART_CHANNELS)) {
+        uart_printf("chan: a mask of %u bits\r\n", UART_CHANNELS);
+        return -1;
+    }
+    if (0U != u32Mask) {
+        uart_channel_enable((uint8_t)u32Mask);
+    }
+
+    uart_printf("chan: mask 0x%02x\r\n", s_u8ChanMask);
+    for (uint8_t i = 1U; i < UART_CHANNELS; ++i) {
+        if ((0 != uart_channel_on(i)) || (0U != s_vu32ChanSent[i]) || (0U != s_vu32ChanDropped[i])) {
+            uart_printf("  %u %-3s sent %8u dropped %8u\r\n", i, (0 != uart_channel_on(i)) ? "on" : "off",
+                        s_vu32ChanSent[i], s_vu32ChanDropped[i]);
+        }
+    }
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* formatted into a line buffer on the stack, one uart_write() per line */
+RAM_FUNC int uart_vprintf(const char *fmt, va_list args)
+{
+    char line[UART_PRINTF_LINE_SIZE];
+    fmt_sink_s sSink = { line, 0, (int)sizeof(line), true };
+
+    fmt_vformat(&sSink, fmt, args);
+    if (sSink.iPos > 0) {
+        uart_write(line, sSink.iPos);
+    }
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+RAM_FUNC int uart_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args)
+{
+    if (maxlen <= 0) {
+        return 0;
+    }
+    fmt_sink_s sSink = { buf, 0, maxlen - 1, false };
+
+    fmt_vformat(&sSink, fmt, args);
+    buf[sSink.iPos] = '\0';
+    return sSink.iPos;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_snprintf(char *buf, int maxlen, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vsnprintf(buf, maxlen, fmt, args);
+    va_end(args);
+    return ret;
+}
+
+#if defined(UART_ACCESS_NO_NEWLIB_PRINTF)
+
+
+/*--------------------------------------------------*/
+/* linked with -Wl,--wrap=...: every printf family call of the image lands in the
+   engine above and the newlib implementation stays out of the link */
+extern "C" int __wrap_vprintf(const char *fmt, va_list args)
+{
+    return uart_vprintf(fmt, args);
+}
+
+
+
+/*--------------------------------------------------*/
+extern "C" int __wrap_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
+
+
+/*--------------------------------------------------*/
+extern "C" int __wrap_vsnprintf(char *buf, size_t maxlen, const char *fmt, va_list args)
+{
+    return uart_vsnprintf(buf, (int)maxlen, fmt, args);
+}
+
+
+
+/*--------------------------------------------------*/
+extern "C" int __wrap_snprintf(char *buf, size_t maxlen, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vsnprintf(buf, (int)maxlen, fmt, args);
+    va_end(args);
+    return ret;
+}
+
+
+
+/*--------------------------------------------------*/
+/* no size: the largest buffer the engine can describe */
+extern "C" int __wrap_sprintf(char *buf, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vsnprintf(buf, INT32_MAX, fmt, args);
+    va_end(args);
+    return ret;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the compiler turns printf("text\n") into puts("text") and printf("%c") into putchar() */
+extern "C" int __wrap_puts(const char *s)
+{
+    int len = 0;
+    while (s[len]) len++;
+    uart_write(s, len);
+    uart_putchar('\n');
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+extern "C" int __wrap_putchar(int c)
+{
+    uart_putchar((char)c);
+    return c;
+}
+#endif /*defined(UART_ACCESS_NO_NEWLIB_PRINTF)*/
+
+
+
+/* ================================================
+            private interfaces definition
+==================================================*/
+
+
+/*--------------------------------------------------*/
+/* in a critical section: u32Len bytes next to the u32Keep kept for a waiting line */
+static mux_room_e mux_room(uint32_t u32Len, uint32_t u32Keep)
+{
+    if (true == uart_port_tx_open()) {
+        const uint32_t u32Free = uart_port_tx_free();
+        if (u32Len + u32Keep <= u32Free) {
+            return MUX_ROOM;
+        }
+        switch (uart_port_tx_policy()) {
+            case UART_TX_BLOCK:
+                if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+                    return MUX_WAIT;
+                }
+                break;
+            case UART_TX_OVERWRITE:
+                if (true == uart_port_tx_discard(u32Len + u32Keep - u32Free)) {
+                    return MUX_ROOM;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    uart_port_tx_dropped(u32Len);
+    return MUX_DROP;
+}
+
+
+
+/*--------------------------------------------------*/
+/* as much as fits per critical section, into the shadow with it; the room a waiting line
+   needs is left to it, so a console that prints without a pause does not hold it back */
+static void mux_console_write(const char *buf, int len)
+{
+    while (len > 0) {
+        taskENTER_CRITICAL();
+        const uint32_t u32Free = uart_port_tx_free();
+        uint32_t u32Len = (u32Free > s_u16MuxWant) ? (u32Free - s_u16MuxWant) : 0U;
+        if (u32Len > (uint32_t)len) {
+            u32Len = (uint32_t)len;
+        }
+        if (0U == u32Len) {
+            u32Len = ((uint32_t)len < UART_MUX_COMMIT_MAX) ? (uint32_t)len : UART_MUX_COMMIT_MAX;
+            const mux_room_e eRoom = mux_room(u32Len, s_u16MuxWant);
+            if (MUX_ROOM != eRoom) {
+                taskEXIT_CRITICAL();
+                if (MUX_DROP == eRoom) {
+                    uart_port_tx_dropped((uint32_t)len - u32Len);
+                    return;
+                }
+                uart_port_tx_wait();
+                continue;
+            }
+        }
+        uart_port_tx_put(buf, u32Len);
+        mux_shadow(buf, u32Len);
+        taskEXIT_CRITICAL();
+        buf += u32Len;
+        len -= (int)u32Len;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* one critical section for the erase of the console line, the line and the console line
+   again; the parts are taken at the commit, the console may have written meanwhile.
+   A shadow too long to replay leaves the console line as it is, the line goes under it.
+   Without bWait a line which has no room now is dropped; false when the line was not queued */
+static bool mux_line_commit(const char *pcLine, uint16_t u16Len, bool bWait)
+{
+    bool bWaiting = false;
+
+    for (;;) {
+        taskENTER_CRITICAL();
+        const bool bLost = s_bMuxShadowLost;
+        const bool bAround = (true == bLost) || (s_u16MuxShadow > 0U);
+        const char *pcPre = (true == bLost) ? "\n" : UART_MUX_ERASE;
+        const uint32_t u32Pre = (false == bAround) ? 0U : ((true == bLost) ? 1U : (uint32_t)(sizeof(UART_MUX_ERASE) - 1U));
+        const uint32_t u32Nl = ((true == bAround) && ('\n' != pcLine[u16Len - 1U])) ? 1U : 0U;
+        const uint32_t u32Shadow = (true == bLost) ? 0U : s_u16MuxShadow;
+        const uint32_t u32Total = u32Pre + u16Len + u32Nl + u32Shadow;
+
+        const mux_room_e eRoom = mux_room(u32Total, 0U);
+        if ((MUX_WAIT != eRoom) || (false == bWait)) {
+            if (MUX_WAIT == eRoom) {
+                uart_port_tx_dropped(u32Total);
+            }
+            if (MUX_ROOM == eRoom) {
+                uart_port_tx_put(pcPre, u32Pre);
+                uart_port_tx_put(pcLine, u16Len);
+                uart_port_tx_put("\n", u32Nl);
+                uart_port_tx_put(s_acMuxShadow, u32Shadow);
+                if (true == bLost) {
+                    s_bMuxShadowLost = false;   /* the console goes on at the start of a line */
+                }
+            }
+            if (true == bWaiting) {
+                s_u16MuxWant = 0U;
+            }
+            taskEXIT_CRITICAL();
+            return (MUX_ROOM == eRoom);
+        }
+        if (u32Total > s_u16MuxWant) {
+            s_u16MuxWant = (uint16_t)u32Total;
+        }
+        bWaiting = true;
+        taskEXIT_CRITICAL();
+        uart_port_tx_wait();
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* in a critical section, with the console output it follows */
+static void mux_shadow(const char *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; ++i) {
+        if ('\n' == buf[i]) {
+            s_u16MuxShadow = 0U;
+            s_bMuxShadowLost = false;
+        } else if (false == s_bMuxShadowLost) {
+            if (s_u16MuxShadow < UART_MUX_SHADOW_SIZE) {
+                s_acMuxShadow[s_u16MuxShadow++] = buf[i];
+            } else {
+                s_u16MuxShadow = 0U;
+                s_bMuxShadowLost = true;
+            }
+        }
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* the slot of the calling task, or a free one; only its owner writes a taken slot */
+static mux_slot_s *mux_slot_take(void)
+{
+    const TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+    mux_slot_s *psSlot = nullptr;
+
+    for (uint32_t i = 0; i < UART_MUX_SLOTS; ++i) {
+        if (xSelf == s_vsMuxSlot[i].xTask) {
+            return &s_vsMuxSlot[i];
+        }
+    }
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < UART_MUX_SLOTS; ++i) {
+        if (nullptr == s_vsMuxSlot[i].xTask) {
+            psSlot = &s_vsMuxSlot[i];
+            psSlot->xTask = xSelf;
+            psSlot->u16Len = 0U;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return psSlot;
+}
+
+
+
+#if !defined(UART_ACCESS_PTY)
+/*--------------------------------------------------*/
+/* from a handler of any priority, never waits: a record per UART_ISR_RECORD_MAX, what finds no
+   room is dropped and counted; a handler which may call the kernel queues a drain */
+static void isr_put(const char *buf, int len)
+{
+    while (len > 0) {
+        const uint32_t u32Len = ((uint32_t)len < UART_ISR_RECORD_MAX) ? (uint32_t)len : UART_ISR_RECORD_MAX;
+        uint32_t u32Head = __atomic_load_n(&s_u32IsrHead, __ATOMIC_RELAXED);
+        uint32_t u32Off;
+        uint32_t u32Pad;
+        uint32_t u32Next;
+
+        do {
+            u32Off  = u32Head & (UART_ISR_RING_SIZE - 1U);
+            u32Pad  = ((UART_ISR_RING_SIZE - u32Off) < (1U + u32Len)) ? (UART_ISR_RING_SIZE - u32Off) : 0U;
+            u32Next = u32Head + u32Pad + 1U + u32Len;
+            if ((u32Next - __atomic_load_n(&s_u32IsrTail, __ATOMIC_ACQUIRE)) > UART_ISR_RING_SIZE) {
+                (void)__atomic_fetch_add(&s_u32IsrDropped, (uint32_t)len, __ATOMIC_RELAXED);
+                len = 0;
+                break;
+            }
+        } while (false == __atomic_compare_exchange_n(&s_u32IsrHead, &u32Head, u32Next, true,
+                                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        if (0 == len) {
+            break;
+        }
+
+        if (0U != u32Pad) {
+            __atomic_store_n(&s_vu8IsrRing[u32Off], (uint8_t)UART_ISR_PAD, __ATOMIC_RELEASE);
+            u32Off = 0U;
+        }
+        memcpy(&s_vu8IsrRing[u32Off + 1U], buf, u32Len);
+        __atomic_store_n(&s_vu8IsrRing[u32Off], (uint8_t)u32Len, __ATOMIC_RELEASE);
+        buf += u32Len;
+        len -= (int)u32Len;
+    }
+
+    if ((taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) && (true == isr_may_pend()) &&
+        (0U == __atomic_exchange_n(&s_u32IsrPend, 1U, __ATOMIC_RELAXED))) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        if (pdPASS != xTimerPendFunctionCallFromISR(isr_pended, nullptr, 0U, &xHigherPriorityTaskWoken)) {
+            __atomic_store_n(&s_u32IsrPend, 0U, __ATOMIC_RELAXED);     /* the next write drains */
+        }
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* the FromISR API is for the handlers at configMAX_SYSCALL_INTERRUPT_PRIORITY or below */
+static bool isr_may_pend(void)
+{
+    uint32_t u32Ipsr;
+    __asm volatile("mrs %0, ipsr" : "=r"(u32Ipsr));
+    u32Ipsr &= 0x1FFU;
+
+    if (u32Ipsr >= 16U) {
+        return (NVIC_IPR(u32Ipsr - 16U) >= configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    }
+    if (u32Ipsr >= 4U) {
+        return (SCB_SHPR(u32Ipsr - 4U) >= configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    }
+    return false;               /* NMI, HardFault */
+}
+
+
+
+/*--------------------------------------------------*/
+/* the timer task */
+static void isr_pended(void *pvParam, uint32_t u32Param)
+{
+    (void)pvParam;
+    (void)u32Param;
+    __atomic_store_n(&s_u32IsrPend, 0U, __ATOMIC_RELAXED);
+    isr_drain();
+}
+
+
+
+/*--------------------------------------------------*/
+/* the committed records as lines above the prompt, never waiting for room (the timer task
+   must not); one task at a time, another one which finds it busy leaves the rest to it */
+static void isr_drain(void)
+{
+    if (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) {
+        return;                 /* the lines of the boot wait for the first write of a task */
+    }
+    while (0U == __atomic_exchange_n(&s_u32IsrBusy, 1U, __ATOMIC_ACQUIRE)) {
+        uint32_t u32Tail = s_u32IsrTail;
+
+        while (u32Tail != __atomic_load_n(&s_u32IsrHead, __ATOMIC_RELAXED)) {
+            const uint32_t u32Off = u32Tail & (UART_ISR_RING_SIZE - 1U);
+            const uint8_t u8Len = __atomic_load_n(&s_vu8IsrRing[u32Off], __ATOMIC_ACQUIRE);
+            uint32_t u32Take;
+
+            if (0U == u8Len) {
+                break;          /* reserved by a handler, its commit queues a drain again */
+            }
+            if (UART_ISR_PAD == u8Len) {
+                u32Take = UART_ISR_RING_SIZE - u32Off;
+            } else {
+                (void)mux_line_commit((const char *)&s_vu8IsrRing[u32Off + 1U], u8Len, false);
+                u32Take = 1U + u8Len;
+            }
+            memset(&s_vu8IsrRing[u32Off], 0, u32Take);
+            u32Tail += u32Take;
+            __atomic_store_n(&s_u32IsrTail, u32Tail, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&s_u32IsrBusy, 0U, __ATOMIC_RELEASE);
+
+        const uint32_t u32Off = u32Tail & (UART_ISR_RING_SIZE - 1U);
+        if ((u32Tail == __atomic_load_n(&s_u32IsrHead, __ATOMIC_RELAXED)) ||
+            (0U == __atomic_load_n(&s_vu8IsrRing[u32Off], __ATOMIC_ACQUIRE))) {
+            return;             /* nothing committed came meanwhile */
+        }
+    }
+}
+#endif /*!defined(UART_ACCESS_PTY)*/
+
+
+
+/*--------------------------------------------------*/
+/* COBS: each zero is replaced by the distance to the next one, a code byte of 0xFF is a run of
+   254 bytes without a zero; the zeros around are the caller's delimiters, put here */
+static uint32_t chan_encode(uint8_t *pu8Out, const uint8_t *pu8Raw, uint32_t u32Len)
+{
+    uint32_t u32Out = 0U;
+    pu8Out[u32Out++] = 0x00U;
+    uint32_t u32Code = u32Out++;
+    uint8_t u8Run = 1U;
+
+    for (uint32_t i = 0U; i < u32Len; ++i) {
+        if (0x00U != pu8Raw[i]) {
+            pu8Out[u32Out++] = pu8Raw[i];
+            ++u8Run;
+        }
+        if ((0x00U == pu8Raw[i]) || (0xFFU == u8Run)) {
+            pu8Out[u32Code] = u8Run;
+            u32Code = u32Out++;
+            u8Run = 1U;
+        }
+    }
+    pu8Out[u32Code] = u8Run;
+    pu8Out[u32Out++] = 0x00U;
+    return u32Out;
+}
+
+
+
+/*--------------------------------------------------*/
+/* uart_printf() drains the line buffer when it is full and at every '\n',
+   uart_snprintf() truncates at its size */
+static void fmt_putc(fmt_sink_s *psSink, char c)
+{
+    if (psSink->iPos >= psSink->iSize) {
+        if (!psSink->bDrain) {
+            return;
+        }
+        uart_write(psSink->pcBuf, psSink->iPos);
+        psSink->iPos = 0;
+    }
+    psSink->pcBuf[psSink->iPos++] = c;
+    if (psSink->bDrain && ('\n' == c)) {
+        uart_write(psSink->pcBuf, psSink->iPos);
+        psSink->iPos = 0;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* left aligned fields are always padded with spaces */
+static void fmt_field(fmt_sink_s *psSink, const char *text, int len, int width, char pad, int left_align)
+{
+    if (!left_align) {
+        for (int i = len; i < width; i++) fmt_putc(psSink, pad);
+    }
+    for (int i = 0; i < len; i++) fmt_putc(psSink, text[i]);
     if (left_align) {
-        if (*pos < maxlen - 2) {
-            buf[(*pos)++] = '0';
-            buf[(*pos)++] = 'x';
+        for (int i = len; i < width; i++) fmt_putc(psSink, ' ');
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* n / 10 as a multiplication by 0.8 in shifts and adds, then >> 3: the 64 bit
+   division would be the libgcc loop on the Cortex-M; the estimate is off by 1 at most */
+static uint64_t fmt_divu10(uint64_t n, uint32_t *rem)
+{
+    uint64_t q = (n >> 1) + (n >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q += q >> 32;
+    q >>= 3;
+
+    uint32_t r = (uint32_t)(n - ((q << 3) + (q << 1)));
+    if (r > 9U) {
+        q++;
+        r -= 10U;
+    }
+    *rem = r;
+    return q;
+}
+
+
+
+/*--------------------------------------------------*/
+/* writes the digits backwards, ending before end; returns their count */
+RAM_FUNC static int fmt_utoa(char *end, uint64_t value, unsigned int base)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char *p = end;
+
+    if (16U == base) {
+        do { *--p = hex[value & 0xFU]; value >>= 4; } while (value);
+        return (int)(end - p);
+    }
+    while (value > UINT32_MAX) {
+        uint32_t rem;
+        value = fmt_divu10(value, &rem);
+        *--p = (char)('0' + rem);
+    }
+    uint32_t low = (uint32_t)value; /* the rest with the hardware divider */
+    do { *--p = (char)('0' + (low % 10U)); low /= 10U; } while (low);
+    return (int)(end - p);
+}
+
+
+
+/*--------------------------------------------------*/
+/* precision is the minimum number of digits, the sign and 0x go in front of them */
+RAM_FUNC static void fmt_number(fmt_sink_s *psSink, uint64_t value, bool negative, unsigned int base, int precision, int width, char pad, int left_align)
+{
+    char tmp[24];
+    int  i = (int)sizeof(tmp);
+
+    i -= fmt_utoa(&tmp[i], value, base);
+    for (int n = (int)sizeof(tmp) - i; (n < precision) && (i > 3); n++) tmp[--i] = '0';
+    if (16U == base) { tmp[--i] = 'x'; tmp[--i] = '0'; }
+    if (negative)    { tmp[--i] = '-'; }
+
+    fmt_field(psSink, &tmp[i], (int)sizeof(tmp) - i, width, pad, left_align);
+}
+
+
+
+/*--------------------------------------------------*/
+/* fixed point from the bits of the double, integer arithmetic only: a %f argument is a double (the
+   promotion of the varargs), which the single precision FPU of the Cortex-M4F does not handle, soft
+   float calls on either core otherwise. The integer part as a 64 bit integer, the fraction in Q0.64
+   scaled to precision (at most 9) digits in two 32 bit halves and rounded half up; finite values
+   beyond 2^64 print "ovf" */
+static void fmt_float(fmt_sink_s *psSink, double value, int precision, int width, char pad, int left_align)
+{
+    static const uint32_t pow10[] = { 1U, 10U, 100U, 1000U, 10000U, 100000U,
+                                      1000000U, 10000000U, 100000000U, 1000000000U };
+    char tmp[32];
+    int  i = (int)sizeof(tmp);
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const int      biased   = (int)((bits >> 52) & 0x7FFU);
+    const uint64_t mantissa = bits & 0x000FFFFFFFFFFFFFULL;
+    const bool     negative = (0U != (bits >> 63)) && (0U != (bits << 1));   /* -0.0 prints as 0 */
+
+    if ((0x7FF == biased) && (0U != mantissa)) {
+        fmt_field(psSink, "nan", 3, width, ' ', left_align);
+        return;
+    }
+    if (biased >= (1023 + 64)) {
+        const char *text = (0x7FF == biased) ? "-inf" : "-ovf";
+        fmt_field(psSink, negative ? text : &text[1], negative ? 4 : 3, width, ' ', left_align);
+        return;
+    }
+    if (precision < 0) {
+        precision = 6;
+    } else if (precision > 9) {
+        precision = 9;
+    }
+
+    /* value = m / 2^shift */
+    const uint64_t m     = (0 == biased) ? mantissa : (mantissa | (1ULL << 52));
+    const int      shift = 1075 - ((0 == biased) ? 1 : biased);
+    uint64_t ipart = 0U;
+    uint64_t frac  = 0U;
+    if (shift <= 0) {
+        ipart = m << -shift;
+    } else if (shift < 64) {
+        ipart = m >> shift;
+        frac  = (m & ((1ULL << shift) - 1U)) << (64 - shift);
+    } else if ((shift - 64) < 64) {
+        frac  = m >> (shift - 64);
+    }
+
+    /* (frac * 10^precision + 2^63) >> 64, the low half only carries into the high one */
+    const uint64_t scaled = (frac >> 32) * pow10[precision] + (((frac & 0xFFFFFFFFU) * pow10[precision]) >> 32);
+    uint32_t fpart = (uint32_t)((scaled + (1ULL << 31)) >> 32);
+    if (fpart >= pow10[precision]) {
+        fpart -= pow10[precision];
+        ipart++;
+    }
+
+    if (precision > 0) {
+        int n = fmt_utoa(&tmp[i], fpart, 10U);
+        i -= n;
+        for (; n < precision; n++) tmp[--i] = '0';
+        tmp[--i] = '.';
+    }
+    i -= fmt_utoa(&tmp[i], ipart, 10U);
+    if (negative) { tmp[--i] = '-'; }
+
+    fmt_field(psSink, &tmp[i], (int)sizeof(tmp) - i, width, pad, left_align);
+}
+
+
+
+/*--------------------------------------------------*/
+/* supports %s %c %d %i %u %x/%X %p %f %%, the flags - and 0, width and precision
+   (also as *) and the l, ll, z length modifiers */
+RAM_FUNC static void fmt_vformat(fmt_sink_s *psSink, const char *fmt, va_list args)
+{
+    for (; *fmt; fmt++) {
+        if (*fmt != '%') {
+            fmt_putc(psSink, *fmt);
+            continue;
+        }
+        fmt++;
+        char pad        = ' ';
+        int  width      = 0;
+        int  precision  = -1;
+        int  length     = 0;    /* 1: long, 2: long long */
+        int  left_align = 0;
+
+        if (*fmt == '-') { left_align = 1; fmt++; }
+        if (*fmt == '0') { pad = '0';      fmt++; }
+
+        if (*fmt == '*') {
+            width = va_arg(args, int);
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (*fmt - '0');
+            fmt++;
+        }
+        if (*fmt == '.') {
+            fmt++;
+            precision = 0;
+            if (*fmt == '*') {
+                precision = va_arg(args, int);
+                fmt++;
+            }
+            while (*fmt >= '0' && *fmt <= '9') {
+                precision = precision * 10 + (*fmt - '0');
+                fmt++;
+            }
+        }
+        while (*fmt == 'l') { length++; fmt++; }
+        if (*fmt == 'z') {
+            length = (sizeof(size_t) > sizeof(unsigned int)) ? 1 : 0;
+            fmt++;
+        }
+
+        switch (*fmt) {
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                if (nullptr == s) {
+                    s = "(null)";
+                }
+                int len = 0;
+                while (s[len] && ((precision < 0) || (len < precision))) len++;
+                fmt_field(psSink, s, len, width, pad, left_align);
+                break;
+            }
+            case 'c': {
+                const char c = (char)va_arg(args, int);
+                fmt_field(psSink, &c, 1, width, pad, left_align);
+                break;
+            }
+            case 'd':
+            case 'i': {
+                const int64_t value = (length > 1) ? (int64_t)va_arg(args, long long)
+                                    : (length > 0) ? (int64_t)va_arg(args, long)
+                                                   : (int64_t)va_arg(args, int);
+                /* the magnitude in unsigned arithmetic, the minimum included */
+                fmt_number(psSink, (value < 0) ? (0U - (uint64_t)value) : (uint64_t)value,
+                           (value < 0), 10U, precision, width, pad, left_align);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                const uint64_t value = (length > 1) ? (uint64_t)va_arg(args, unsigned long long)
+                                     : (length > 0) ? (uint64_t)va_arg(args, unsigned long)
+                                                    : (uint64_t)va_arg(args, unsigned int);
+                fmt_number(psSink, value, false, ('u' == *fmt) ? 10U : 16U, precision, width, pad, left_align);
+                break;
+            }
+            case 'p':
+                fmt_number(psSink, (uint64_t)(uintptr_t)va_arg(args, void *), false, 16U,
+                           (int)(2U * sizeof(void *)), width, pad, left_align);
+                break;
+            case 'f':
+            case 'F':
+                fmt_float(psSink, va_arg(args, double), precision, width, pad, left_align);
+                break;
+            case '%':
+                fmt_putc(psSink, '%');
+                break;
+            case '\0':
+                return; /* a lone '%' ends the format */
+            default:
+                fmt_putc(psSink, '%');
+                fmt_putc(psSink, *fmt);
+                break;
+        }
+    }
+}
+
+#if !defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)
+/*--------------------------------------------------*/
+static void rx_dma_setup(void)
+{
+    rcc_periph_clock_enable(UART_RX_DMA_RCC);
+
+#if defined(STM32F1)
+    dma_channel_reset(UART_RX_DMA, UART_RX_DMA_CH);
+    dma_set_read_from_peripheral(UART_RX_DMA, UART_RX_DMA_CH);
+    dma_set_peripheral_size(UART_RX_DMA, UART_RX_DMA_CH, DMA_CCR_PSIZE_8BIT);
+    dma_set_memory_size(UART_RX_DMA, UART_RX_DMA_CH, DMA_CCR_MSIZE_8BIT);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    dma_stream_reset(UART_RX_DMA, UART_RX_DMA_CH);
+    dma_channel_select(UART_RX_DMA, UART_RX_DMA_CH, DMA_SxCR_CHSEL_4);
+    dma_set_transfer_mode(UART_RX_DMA, UART_RX_DMA_CH, DMA_SxCR_DIR_PERIPHERAL_TO_MEM);
+    dma_set_peripheral_size(UART_RX_DMA, UART_RX_DMA_CH, DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(UART_RX_DMA, UART_RX_DMA_CH, DMA_SxCR_MSIZE_8BIT);
+#endif /*defined(STM32F4)*/
+
+    dma_set_peripheral_address(UART_RX_DMA, UART_RX_DMA_CH, (uint32_t)(uintptr_t)&USART_DR(USART1));
+    dma_set_memory_address(UART_RX_DMA, UART_RX_DMA_CH, (uint32_t)(uintptr_t)s_vu8RxBuffer);
+    dma_set_number_of_data(UART_RX_DMA, UART_RX_DMA_CH, UART_RX_BUFFER_SIZE);
+    dma_enable_memory_increment_mode(UART_RX_DMA, UART_RX_DMA_CH);
+    dma_enable_circular_mode(UART_RX_DMA, UART_RX_DMA_CH);
+    dma_enable_half_transfer_interrupt(UART_RX_DMA, UART_RX_DMA_CH);
+    dma_enable_transfer_complete_interrupt(UART_RX_DMA, UART_RX_DMA_CH);
+
+    nvic_set_priority(UART_RX_DMA_IRQ, UART_RX_IRQ_PRIORITY);
+    nvic_enable_irq(UART_RX_DMA_IRQ);
+
+#if defined(STM32F1)
+    dma_enable_channel(UART_RX_DMA, UART_RX_DMA_CH);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    dma_enable_stream(UART_RX_DMA, UART_RX_DMA_CH);
+#endif /*defined(STM32F4)*/
+}
+
+
+
+/*--------------------------------------------------*/
+static void tx_dma_setup(void)
+{
+#if defined(STM32F1)
+    rcc_periph_clock_enable(RCC_DMA1);
+    dma_channel_reset(UART_TX_DMA, UART_TX_DMA_CH);
+    dma_set_read_from_memory(UART_TX_DMA, UART_TX_DMA_CH);
+    dma_set_peripheral_size(UART_TX_DMA, UART_TX_DMA_CH, DMA_CCR_PSIZE_8BIT);
+    dma_set_memory_size(UART_TX_DMA, UART_TX_DMA_CH, DMA_CCR_MSIZE_8BIT);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    rcc_periph_clock_enable(RCC_DMA2);
+    dma_stream_reset(UART_TX_DMA, UART_TX_DMA_CH);
+    dma_channel_select(UART_TX_DMA, UART_TX_DMA_CH, DMA_SxCR_CHSEL_4);
+    dma_set_transfer_mode(UART_TX_DMA, UART_TX_DMA_CH, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
+    dma_set_peripheral_size(UART_TX_DMA, UART_TX_DMA_CH, DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(UART_TX_DMA, UART_TX_DMA_CH, DMA_SxCR_MSIZE_8BIT);
+#endif /*defined(STM32F4)*/
+
+    dma_set_peripheral_address(UART_TX_DMA, UART_TX_DMA_CH, (uint32_t)(uintptr_t)&USART_DR(USART1));
+    dma_set_memory_address(UART_TX_DMA, UART_TX_DMA_CH, (uint32_t)(uintptr_t)s_vu8TxDma);
+    dma_enable_memory_increment_mode(UART_TX_DMA, UART_TX_DMA_CH);
+    dma_enable_transfer_complete_interrupt(UART_TX_DMA, UART_TX_DMA_CH);
+
+    nvic_set_priority(UART_TX_DMA_IRQ, UART_RX_IRQ_PRIORITY);
+    nvic_enable_irq(UART_TX_DMA_IRQ);
+}
+
+
+
+/*--------------------------------------------------*/
+/* start a transfer of the oldest queued bytes if the DMA is idle (called in a critical section) */
+static void tx_kick(void)
+{
+    const uint16_t u16Queued = (uint16_t)(s_u16TxHead - s_u16TxTail);
+    if ((true == s_bTxBusy) || ((0U == u16Queued) && (0U == s_u8TxCtrl))) {
+        return;
+    }
+
+    /* a pending XON / XOFF goes ahead of the queued output */
+    uint16_t u16Len = 0U;
+    if (0U != s_u8TxCtrl) {
+        s_vu8TxDma[u16Len++] = s_u8TxCtrl;
+        s_u8TxCtrl = 0U;
+    }
+
+    const uint16_t u16Room = (uint16_t)(UART_TX_DMA_CHUNK - u16Len);
+    const uint16_t u16Take = (u16Queued < u16Room) ? u16Queued : u16Room;
+    for (uint16_t i = 0; i < u16Take; ++i) {
+        s_vu8TxDma[u16Len + i] = s_vu8TxBuffer[(uint16_t)(s_u16TxTail + i) & (UART_TX_BUFFER_SIZE - 1U)];
+    }
+    s_u16TxTail = (uint16_t)(s_u16TxTail + u16Take);
+    u16Len = (uint16_t)(u16Len + u16Take);
+    s_bTxBusy = true;
+
+#if defined(STM32F1)
+    dma_disable_channel(UART_TX_DMA, UART_TX_DMA_CH);
+    dma_set_number_of_data(UART_TX_DMA, UART_TX_DMA_CH, u16Len);
+    dma_enable_channel(UART_TX_DMA, UART_TX_DMA_CH);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    /* the stream disabled itself at the end of the previous transfer */
+    dma_clear_interrupt_flags(UART_TX_DMA, UART_TX_DMA_CH, DMA_TCIF | DMA_HTIF | DMA_TEIF | DMA_DMEIF | DMA_FEIF);
+    dma_set_number_of_data(UART_TX_DMA, UART_TX_DMA_CH, u16Len);
+    dma_enable_stream(UART_TX_DMA, UART_TX_DMA_CH);
+#endif /*defined(STM32F4)*/
+}
+
+
+
+/*--------------------------------------------------*/
+/* until the scheduler starts (and the ring is drained) the bytes go out directly */
+bool uart_port_tx_early(const char *buf, int len)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        return false;
+    }
+    for (int i = 0; i < len; ++i) {
+        usart_send_blocking(USART1, buf[i]);
+    }
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+bool uart_port_tx_open(void)
+{
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_port_tx_free(void)
+{
+    return (uint32_t)(UART_TX_BUFFER_SIZE - (uint16_t)(s_u16TxHead - s_u16TxTail));
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_put(const char *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; ++i) {
+        s_vu8TxBuffer[(uint16_t)(s_u16TxHead + i) & (UART_TX_BUFFER_SIZE - 1U)] = (uint8_t)buf[i];
+    }
+    s_u16TxHead = (uint16_t)(s_u16TxHead + len);
+    tx_kick();
+    activity_output();
+}
+
+
+
+/*--------------------------------------------------*/
+/* the bytes already copied for the DMA are on their way, only the ring gives room */
+bool uart_port_tx_discard(uint32_t len)
+{
+    if (len > (uint16_t)(s_u16TxHead - s_u16TxTail)) {
+        return false;
+    }
+    s_u16TxTail = (uint16_t)(s_u16TxTail + len);
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+/* sleep until the DMA finished a chunk; a notification of an earlier wait which came
+   after its timeout only ends this one early, the caller checks the room again */
+void uart_port_tx_wait(void)
+{
+    const TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+    uint32_t u32Slot = UART_TX_WAITERS;
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0U; i < UART_TX_WAITERS; ++i) {
+        if (nullptr == s_vxTxWaiter[i]) {
+            s_vxTxWaiter[i] = xSelf;
+            u32Slot = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (UART_TX_WAITERS == u32Slot) {
+        vTaskDelay(1);          /* more waiters than writers: not expected, polled */
+        return;
+    }
+    (void)ulTaskNotifyTakeIndexed(UART_TX_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(UART_TX_WAIT_MS));
+
+    taskENTER_CRITICAL();
+    s_vxTxWaiter[u32Slot] = nullptr;
+    taskEXIT_CRITICAL();
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_dropped(uint32_t len)
+{
+    s_u32TxDropped = s_u32TxDropped + len;
+}
+
+
+
+/*--------------------------------------------------*/
+uart_tx_policy_e uart_port_tx_policy(void)
+{
+    return s_eTxPolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+/* producer index: position of the next byte the DMA writes */
+static inline uint16_t rx_dma_head(void)
+{
+    return (uint16_t)((UART_RX_BUFFER_SIZE - dma_get_number_of_data(UART_RX_DMA, UART_RX_DMA_CH)) % UART_RX_BUFFER_SIZE);
+}
+
+
+
+/*--------------------------------------------------*/
+/* block until the ISRs report new data: task notification once the
+   scheduler runs, wfi before (bare metal, early boot) */
+static void rx_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        s_xRxTask = xTaskGetCurrentTaskHandle();
+        if (s_u16RxTail == rx_dma_head()) {
+            activity_add(1U);
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            activity_add(1U);
+        }
+    } else {
+        /* a pending irq still ends wfi with the interrupts masked, so none is missed */
+        __asm__ volatile ("cpsid i" ::: "memory");
+        if (s_u16RxTail == rx_dma_head()) {
+            __asm__ volatile ("wfi");
         }
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) {
-            buf[(*pos)++] = tmp[j];
+        __asm__ volatile ("cpsie i" ::: "memory");
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* rx_wait() with a limit, false if nothing arrived meanwhile (task context only) */
+static bool rx_wait_for(uint32_t u32Ms)
+{
+    if (0U == u32Ms) {
+        return (s_u16RxTail != rx_dma_head());    /* a poll (ShellAO): the notification of the caller is left alone */
+    }
+    s_xRxTask = xTaskGetCurrentTaskHandle();
+    if (s_u16RxTail == rx_dma_head()) {
+        activity_add(1U);
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(u32Ms));
+        activity_add(1U);
+    }
+    return (s_u16RxTail != rx_dma_head());
+}
+
+
+
+/*--------------------------------------------------*/
+/* tasks and the reader itself: atomic, a lost step would flip the waiting parity */
+static void activity_add(uint32_t u32Step)
+{
+    __atomic_fetch_add(&s_u32Activity, u32Step, __ATOMIC_RELAXED);
+}
+
+
+
+/*--------------------------------------------------*/
+static void activity_output(void)
+{
+    if (xTaskGetCurrentTaskHandle() == s_xRxTask) {
+        activity_add(2U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* a chunk is done: the tasks waiting for room try again */
+static void tx_notify_from_isr(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    for (uint32_t i = 0U; i < UART_TX_WAITERS; ++i) {
+        const TaskHandle_t xTask = s_vxTxWaiter[i];
+        if (nullptr != xTask) {
+            vTaskNotifyGiveIndexedFromISR(xTask, UART_TX_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
         }
-        for (int j = i + 2; j < width && *pos < maxlen - 1; j++) {
-            buf[(*pos)++] = pad;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+
+
+/*--------------------------------------------------*/
+static void rx_notify_from_isr(void)
+{
+    const uart_rx_hook_t pfHook = s_pfRxHook;
+    if (nullptr != pfHook) {
+        pfHook();
+    }
+    TaskHandle_t xTask = s_xRxTask;
+    if (nullptr != xTask) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(xTask, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* pause the sender above the high watermark, resume below the low one; called by the ISRs
+   and after the reader consumed (the FromISR mask works in both contexts) */
+static void rx_flow_update(void)
+{
+#if defined(UART_RX_FLOW_CONTROL)
+    const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    const uint16_t u16Used = (uint16_t)((rx_dma_head() + UART_RX_BUFFER_SIZE - s_u16RxTail) % UART_RX_BUFFER_SIZE);
+
+    bool bPause = s_bRxPaused;
+    if (u16Used >= UART_RX_HIGH_WATERMARK) {
+        bPause = true;
+    } else if (u16Used <= UART_RX_LOW_WATERMARK) {
+        bPause = false;
+    }
+
+    if (bPause != s_bRxPaused) {
+        s_bRxPaused = bPause;
+#if defined(UART_ACCESS_FLOW_RTSCTS)
+        if (true == bPause) {
+            gpio_set(GPIOA, GPIO12);
+        } else {
+            gpio_clear(GPIOA, GPIO12);
         }
+#endif /*defined(UART_ACCESS_FLOW_RTSCTS)*/
+
+#if defined(UART_ACCESS_FLOW_XONXOFF)
+        /* replaces a control byte not sent yet: only the last state matters */
+        s_u8TxCtrl = (true == bPause) ? UART_XOFF : UART_XON;
+        tx_kick();
+#endif /*defined(UART_ACCESS_FLOW_XONXOFF)*/
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+#endif /*defined(UART_RX_FLOW_CONTROL)*/
+}
+
+
+
+/*--------------------------------------------------*/
+/* oversampling by 16: the divider can not go below 16 */
+static bool baud_valid(uint32_t u32Baud)
+{
+    return (u32Baud >= UART_MIN_BAUDRATE) && ((rcc_get_usart_clk_freq(USART1) / u32Baud) >= 16U);
+}
+
+
+
+/*--------------------------------------------------*/
+/* the setting lives in the backup domain: it survives a reset (and a power cycle with VBAT) */
+static uint32_t baud_load(void)
+{
+    uint32_t u32Magic = 0U;
+    uint32_t u32Baud = 0U;
+
+    rcc_periph_clock_enable(RCC_PWR);
+
+#if defined(STM32F1)
+    rcc_periph_clock_enable(RCC_BKP);
+    u32Magic = BKP_DR1 & 0xFFFFU;
+    u32Baud = (BKP_DR2 & 0xFFFFU) | ((BKP_DR3 & 0xFFFFU) << 16);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    u32Magic = RTC_BKPXR(0);
+    u32Baud = RTC_BKPXR(1);
+#endif /*defined(STM32F4)*/
+
+    if ((UART_BAUD_MAGIC == u32Magic) && ((UART_AUTOBAUD == u32Baud) || (true == baud_valid(u32Baud)))) {
+        return u32Baud;
+    }
+    return UART_DEFAULT_BAUDRATE;
+}
+
+
+
+/*--------------------------------------------------*/
+static void baud_store(uint32_t u32Baud)
+{
+    pwr_disable_backup_domain_write_protect();
+
+#if defined(STM32F1)
+    BKP_DR2 = u32Baud & 0xFFFFU;
+    BKP_DR3 = u32Baud >> 16;
+    BKP_DR1 = UART_BAUD_MAGIC;
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    RTC_BKPXR(1) = u32Baud;
+    RTC_BKPXR(0) = UART_BAUD_MAGIC;
+#endif /*defined(STM32F4)*/
+
+    pwr_enable_backup_domain_write_protect();
+}
+
+
+
+/*--------------------------------------------------*/
+/* polls PA10 before the USART is enabled: in '\r' (0x0D, LSB first) the start bit is the only
+   low bit before bit0, so the first low pulse is one bit time; that character is lost */
+static uint32_t baud_detect(void)
+{
+    static const uint32_t au32Rates[] = { 9600U, 19200U, 38400U, 57600U, 115200U, 230400U, 460800U, 921600U, 2000000U };
+
+    if (false == dwt_enable_cycle_counter()) {
+        return UART_DEFAULT_BAUDRATE;
     }
-    // Right-aligned: padding first, then 0x + number
-    else {
-        for (int j = i + 2; j < width && *pos < maxlen - 1; j++) {
-            buf[(*pos)++] = pad;
+
+    const uint32_t u32Clock = rcc_ahb_frequency;
+    const uint64_t u64Timeout = (uint64_t)(u32Clock / 1000U) * UART_AUTOBAUD_TIMEOUT_MS;
+    uint64_t u64Waited = 0U;
+    uint32_t u32Last = DWT_CYCCNT;
+    auto expired = [&]() -> bool {
+        const uint32_t u32Now = DWT_CYCCNT;
+        u64Waited += (uint32_t)(u32Now - u32Last);
+        u32Last = u32Now;
+        return (u64Waited >= u64Timeout);
+    };
+
+    for (;;) {
+        /* idle (high) line, then the falling edge of a start bit */
+        while (0U == gpio_get(GPIOA, GPIO10)) {
+            if (true == expired()) {
+                return UART_DEFAULT_BAUDRATE;
+            }
+        }
+        while (0U != gpio_get(GPIOA, GPIO10)) {
+            if (true == expired()) {
+                return UART_DEFAULT_BAUDRATE;
+            }
         }
-        if (*pos < maxlen - 2) {
-            buf[(*pos)++] = '0';
-            buf[(*pos)++] = 'x';
+        const uint32_t u32Start = DWT_CYCCNT;
+        while ((0U == gpio_get(GPIOA, GPIO10)) && ((uint32_t)(DWT_CYCCNT - u32Start) < (u32Clock / UART_MIN_BAUDRATE))) {
         }
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) {
-            buf[(*pos)++] = tmp[j];
+        const uint32_t u32Bit = (uint32_t)(DWT_CYCCNT - u32Start);
+        const uint32_t u32Measured = u32Clock / ((0U == u32Bit) ? 1U : u32Bit);
+
+        /* the standard rates are at least 1.5x apart, 20% off still picks the right one */
+        for (const uint32_t u32Rate : au32Rates) {
+            if ((u32Measured > (u32Rate - (u32Rate / 5U))) && (u32Measured < (u32Rate + (u32Rate / 5U)))) {
+                /* let the rest of the character (and a following LF) go by */
+                uint32_t u32High = DWT_CYCCNT;
+                while ((uint32_t)(DWT_CYCCNT - u32High) < (20U * u32Bit)) {
+                    if (0U == gpio_get(GPIOA, GPIO10)) {
+                        u32High = DWT_CYCCNT;
+                    }
+                    if (true == expired()) {
+                        break;
+                    }
+                }
+                return u32Rate;
+            }
         }
+        /* another key or noise: wait for the next character */
     }
 }
+#endif /*!defined(UART_ACCESS_USB_CDC) && !defined(UART_ACCESS_RTT) && !defined(UART_ACCESS_CAN) && !defined(UART_ACCESS_SPI) && !defined(UART_ACCESS_PTY)*/
 
 /*
 Usage examples:
@@ -0,0 +1,959 @@
+#include "uart_access.h"
+#include "uart_access_port.h"
+#include "isr_prof.h"
+#include "probe.h"
+#include "libopencm3/stm32/rcc.h"
+#include "libopencm3/stm32/gpio.h"
+#include "libopencm3/stm32/can.h"
+#include "libopencm3/cm3/nvic.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <timers.h>
+
+#include <stdint.h>
+
+/*
+ * CAN backend of uart_access (STM32F103 bxCAN, PA11 RX / PA12 TX, a transceiver on the bus).
+ * Same interface as the USART1 backend, the uart_printf() family is shared. The console of a
+ * node is an ISO-TP (ISO 15765-2) channel of 11 bit identifiers, normal addressing:
+ *
+ *      0x700 + node    gateway -> node, the input (and the flow control of the output)
+ *      0x780 + node    node -> gateway, the output (and the flow control of the input)
+ *      0x700           every node: single frames only (functional addressing)
+ *
+ *  - the hardware filter (bank 0, list mode) takes the two input identifiers only, the node
+ *    sees no other traffic of the bus
+ *  - input: the FIFO 0 interrupt drains the frames into the RX ring; a first frame is answered
+ *    by a flow control which grants the consecutive frames the ring has room for (BS), a WAIT
+ *    when it has none, the CTS follows once the reader took some; a single frame which does not
+ *    fit stays in the FIFO (its interrupt masked) until then, so the gateway is throttled,
+ *    never dropped
+ *  - output: the bytes of the TX ring go as one message of up to CAN_ISOTP_TX_PDU_MAX, a single
+ *    frame up to 7, else a first frame and the consecutive frames after the flow control of the
+ *    gateway: its BS and STmin are kept (STmin by a timer of the kernel), the three mailboxes
+ *    in chronological order (TXFP) from the mailbox empty interrupt
+ *  - until the gateway sends a frame the output is discarded and counted, nobody would take
+ *    it and the unacknowledged frames would hold the mailboxes; no flow control for
+ *    CAN_ISOTP_N_BS_MS, a bus-off or a flow control OVFLW closes the channel again
+ *
+ * The node and the bit rate come from the build (UART_ACCESS_CAN_NODE, UART_ACCESS_CAN_BITRATE);
+ * the bit timing is taken from the APB1 clock at uart_setup() and again at uart_set_baudrate()
+ * (a clock profile switch). A gateway on Linux: tools/can_shell.py (the kernel ISO-TP sockets),
+ * every node of the bus in one session.
+ */
+
+/* ================================================
+            CAN configuration
+==================================================*/
+
+#if !defined(UART_ACCESS_CAN_NODE)
+#define UART_ACCESS_CAN_NODE        (1U)
+#endif
+#if !defined(UART_ACCESS_CAN_BITRATE)
+#define UART_ACCESS_CAN_BITRATE     (500000U)
+#endif
+
+#define CAN_ISOTP_FUNC_ID           (0x700U)
+#define CAN_ISOTP_RX_ID             (CAN_ISOTP_FUNC_ID + UART_ACCESS_CAN_NODE)
+#define CAN_ISOTP_TX_ID             (0x780U + UART_ACCESS_CAN_NODE)
+
+static_assert((UART_ACCESS_CAN_NODE >= 1U) && (UART_ACCESS_CAN_NODE <= 0x7FU), "UART_ACCESS_CAN_NODE must be 1 .. 127");
+
+#define CAN_RX_BUFFER_SIZE          (256U)   /* power of 2 */
+#define CAN_TX_BUFFER_SIZE          (512U)   /* power of 2 */
+#define CAN_ISOTP_TX_PDU_MAX        (256U)   /* bytes of an output message, up to 4095 (first frame) */
+
+#define CAN_FRAME_DATA              (7U)     /* bytes of a single or consecutive frame, PCI apart */
+#define CAN_ISOTP_N_BS_MS           (1000U)  /* the flow control of the gateway is due within */
+#define CAN_ISOTP_RX_STMIN          (0U)     /* asked of the gateway: the ISR keeps up with the bus */
+
+/* bit timing: 8 .. 18 time quanta, the sample point at 87.5 % */
+#define CAN_TQ_MIN                  (8U)
+#define CAN_TQ_MAX                  (18U)
+#define CAN_BRP_MAX                 (1024U)
+
+/* protocol control information, the high nibble of the first byte */
+#define ISOTP_PCI_SF                (0x00U)
+#define ISOTP_PCI_FF                (0x10U)
+#define ISOTP_PCI_CF                (0x20U)
+#define ISOTP_PCI_FC                (0x30U)
+#define ISOTP_FC_CTS                (0x00U)
+#define ISOTP_FC_WAIT               (0x01U)
+#define ISOTP_FC_OVFLW              (0x02U)
+
+/* must be allowed to call the FreeRTOS FromISR API */
+#define CAN_IRQ_PRIORITY            ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+
+#define CAN_BAUD_CMD_ERR            (0xFFU)
+
+static_assert(0U == (CAN_RX_BUFFER_SIZE & (CAN_RX_BUFFER_SIZE - 1U)), "CAN_RX_BUFFER_SIZE must be a power of 2");
+static_assert(0U == (CAN_TX_BUFFER_SIZE & (CAN_TX_BUFFER_SIZE - 1U)), "CAN_TX_BUFFER_SIZE must be a power of 2");
+static_assert(CAN_TX_BUFFER_SIZE >= UART_MUX_COMMIT_MAX, "CAN_TX_BUFFER_SIZE must take a line commit at once");
+static_assert((CAN_ISOTP_TX_PDU_MAX > CAN_FRAME_DATA) && (CAN_ISOTP_TX_PDU_MAX <= 4095U), "CAN_ISOTP_TX_PDU_MAX must need a first frame and fit its length");
+
+/* where the output message is */
+typedef enum {
+    ISOTP_TX_IDLE = 0,
+    ISOTP_TX_WAIT_FC,               /* first frame or a block sent, the flow control is due */
+    ISOTP_TX_CF                     /* consecutive frames of the granted block */
+} isotp_tx_state_e;
+
+/* ================================================
+            private interfaces declaration
+==================================================*/
+
+static bool can_timing(uint32_t u32Bitrate, uint32_t *pu32Brp, uint32_t *pu32Ts1, uint32_t *pu32Ts2);
+static bool can_start(uint32_t u32Bitrate);
+static bool can_send(const uint8_t *pu8Data, uint8_t u8Len);
+static void can_close(void);
+static void isotp_rx_frame(uint32_t u32Id, const uint8_t *pu8Data, uint8_t u8Len);
+static void isotp_rx_put(const uint8_t *pu8Data, uint32_t u32Len);
+static void isotp_rx_fc(void);
+static void isotp_tx_fc(const uint8_t *pu8Data, uint8_t u8Len);
+static void tx_kick(void);
+static void isotp_stmin_cb(TimerHandle_t xTimer);
+static void can_rx_wait(void);
+static bool can_rx_wait_for(uint32_t u32Ms);
+static void can_rx_release(void);
+static void activity_add(uint32_t u32Step);
+static void activity_output(void);
+static inline uint16_t can_rx_free(void);
+
+/* ================================================
+            private data
+==================================================*/
+
+static uint32_t s_u32Bitrate = UART_ACCESS_CAN_BITRATE;
+static volatile bool s_bPortOpen = false;              /* a frame of the gateway arrived */
+
+static uint8_t s_vu8RxBuffer[CAN_RX_BUFFER_SIZE];
+static volatile uint16_t s_u16RxHead = 0;              /* free running, written by the RX ISR */
+static volatile uint16_t s_u16RxTail = 0;              /* free running, owned by the reading task */
+static volatile bool s_bRxHeld = false;                /* a single frame waits in the FIFO for room */
+static uint16_t s_u16RxRemain = 0;                     /* bytes of the input message still to come */
+static uint8_t s_u8RxSn = 0;                           /* sequence number of the next consecutive frame */
+static uint8_t s_u8RxBlock = 0;                        /* consecutive frames left in the block, 0: no limit */
+static volatile bool s_bRxFcWait = false;              /* a WAIT sent, the CTS follows once the ring has room */
+static uint8_t s_vu8RxFc[3];                           /* the flow control to send */
+static volatile bool s_bRxFcPending = false;           /* no mailbox was free for it */
+static TaskHandle_t volatile s_xRxTask = nullptr;      /* task blocked in uart_getchar() */
+static volatile uart_rx_hook_t s_pfRxHook = nullptr;   /* uart_rx_set_hook() */
+static volatile uint32_t s_u32Activity = 0U;           /* uart_activity() */
+
+static uint8_t s_vu8TxBuffer[CAN_TX_BUFFER_SIZE];
+static volatile uint16_t s_u16TxHead = 0;              /* free running, masked on access */
+static volatile uint16_t s_u16TxTail = 0;
+static uint8_t s_vu8TxPdu[CAN_ISOTP_TX_PDU_MAX];       /* the output message, out of the ring */
+static uint16_t s_u16TxPduLen = 0;
+static uint16_t s_u16TxPduPos = 0;                     /* bytes of it sent */
+static uint8_t s_u8TxSn = 0;
+static volatile isotp_tx_state_e s_eTxState = ISOTP_TX_IDLE;
+static uint8_t s_u8TxBlockSize = 0;                    /* BS of the gateway, 0: no limit */
+static uint8_t s_u8TxBlockLeft = 0;
+static TickType_t s_xTxStmin = 0;                      /* STmin of the gateway in ticks, 0: back to back */
+static bool s_bTxStminDue = false;                     /* in the timer callback: one paced frame may go */
+static bool s_bTxStminArm = false;                     /* a CTS with STmin: the RX ISR starts the timer */
+static TickType_t s_xTxFcStart = 0;                    /* since when the flow control is due */
+static volatile uint32_t s_u32TxDropped = 0;
+static volatile uart_tx_policy_e s_eTxPolicy = UART_TX_BLOCK;
+
+static TimerHandle_t s_hStmin = nullptr;
+static StaticTimer_t s_sStminTimer;
+
+/* baud 0 */
+static volatile uint32_t s_u32RxFrames = 0U;
+static volatile uint32_t s_u32TxFrames = 0U;
+static volatile uint32_t s_u32RxMessages = 0U;
+static volatile uint32_t s_u32TxMessages = 0U;
+static volatile uint32_t s_u32FcWaits = 0U;            /* WAITs sent, the ring was full */
+static volatile uint32_t s_u32Errors = 0U;             /* sequence errors, timeouts, OVFLW, bus-off */
+
+/* ================================================
+            public interfaces definition
+==================================================*/
+
+/*--------------------------------------------------*/
+void uart_setup(void)
+{
+    rcc_periph_clock_enable(RCC_GPIOA);
+    rcc_periph_clock_enable(RCC_AFIO);
+    rcc_periph_clock_enable(RCC_CAN1);
+
+    /* PA11 = CAN_RX (pulled up, a recessive bus without transceiver), PA12 = CAN_TX */
+    gpio_set_mode(GPIOA, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, GPIO_CAN1_RX);
+    gpio_set(GPIOA, GPIO_CAN1_RX);
+    gpio_set_mode(GPIOA, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, GPIO_CAN1_TX);
+
+    s_hStmin = xTimerCreateStatic("isotp", 1, pdFALSE, nullptr, isotp_stmin_cb, &s_sStminTimer);
+    (void)can_start(s_u32Bitrate);
+
+    nvic_set_priority(NVIC_USB_LP_CAN_RX0_IRQ, CAN_IRQ_PRIORITY);
+    nvic_set_priority(NVIC_USB_HP_CAN_TX_IRQ, CAN_IRQ_PRIORITY);
+    nvic_set_priority(NVIC_CAN_SCE_IRQ, CAN_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_USB_LP_CAN_RX0_IRQ);
+    nvic_enable_irq(NVIC_USB_HP_CAN_TX_IRQ);
+    nvic_enable_irq(NVIC_CAN_SCE_IRQ);
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_getchar(void)
+{
+    uart_mux_reader();
+    while (s_u16RxTail == s_u16RxHead) {
+        can_rx_wait();
+    }
+    const uint8_t c = s_vu8RxBuffer[s_u16RxTail & (CAN_RX_BUFFER_SIZE - 1U)];
+    s_u16RxTail = (uint16_t)(s_u16RxTail + 1U);
+    can_rx_release();
+    return c;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a message carries what the gateway sent at once, so a line is usually complete here;
+   anything else (control keys, partial or too long line) stays for uart_getchar() */
+int uart_getline(char *buf, int maxlen)
+{
+    uart_mux_reader();
+    while (s_u16RxTail == s_u16RxHead) {
+        can_rx_wait();
+    }
+
+    const uint16_t u16Head = s_u16RxHead;
+    uint16_t u16Idx = s_u16RxTail;
+    int len = 0;
+
+    while (u16Idx != u16Head) {
+        const uint8_t c = s_vu8RxBuffer[u16Idx & (CAN_RX_BUFFER_SIZE - 1U)];
+        u16Idx = (uint16_t)(u16Idx + 1U);
+        if ('\r' == c) {
+            buf[len] = '\0';
+            const int consumed = (int)(uint16_t)(u16Idx - s_u16RxTail);
+            s_u16RxTail = u16Idx;
+            can_rx_release();
+            return consumed;
+        }
+        if ('\n' == c) {
+            continue;
+        }
+        if ((c < 0x20U) || (c > 0x7EU) || (len >= maxlen - 1)) {
+            break;
+        }
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_read(uint8_t *buf, int len, uint32_t u32TimeoutMs)
+{
+    int done = 0;
+
+    uart_mux_reader();
+    while (done < len) {
+        if (s_u16RxTail == s_u16RxHead) {
+            if (false == can_rx_wait_for(u32TimeoutMs)) {
+                break;
+            }
+            continue;
+        }
+        while ((s_u16RxTail != s_u16RxHead) && (done < len)) {
+            buf[done++] = s_vu8RxBuffer[s_u16RxTail & (CAN_RX_BUFFER_SIZE - 1U)];
+            s_u16RxTail = (uint16_t)(s_u16RxTail + 1U);
+        }
+        can_rx_release();
+    }
+    return done;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_tx_set_policy(uart_tx_policy_e ePolicy)
+{
+    s_eTxPolicy = ePolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_tx_dropped(void)
+{
+    return s_u32TxDropped;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_rx_set_hook(uart_rx_hook_t pfHook)
+{
+    s_pfRxHook = pfHook;
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+const volatile uint32_t *uart_activity(void)
+{
+    return &s_u32Activity;
+}
+
+
+
+/*--------------------------------------------------*/
+/* wait until everything queued so far was acknowledged on the bus (or the channel closed) */
+void uart_flush(void)
+{
+    uart_mux_flush();
+    while (0 != uart_tx_busy()) {
+        if (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) {
+            break;
+        }
+        uart_port_tx_wait();
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_tx_busy(void)
+{
+    const bool bMailbox = ((CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2) !=
+                           (CAN_TSR(CAN1) & (CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2)));
+
+    return ((true == s_bPortOpen) &&
+            ((s_u16TxHead != s_u16TxTail) || (ISOTP_TX_IDLE != s_eTxState) || (true == bMailbox))) ? 1 : 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the bit timing again from the APB1 clock (clock_profile_set() keeps the rate of the bus);
+   -1 if the clock can not make the rate */
+int uart_set_baudrate(uint32_t u32Baud)
+{
+    uint32_t u32Brp, u32Ts1, u32Ts2;
+
+    if (false == can_timing(u32Baud, &u32Brp, &u32Ts1, &u32Ts2)) {
+        return -1;
+    }
+    taskENTER_CRITICAL();
+    can_close();                /* the init mode aborts the mailboxes */
+    taskEXIT_CRITICAL();
+    return (true == can_start(u32Baud)) ? 0 : -1;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_get_baudrate(void)
+{
+    return s_u32Bitrate;
+}
+
+
+
+/*--------------------------------------------------*/
+/* shell command, same table entry as the USART backend: the bit rate is the one of the bus,
+   0 shows the channel */
+extern "C" int baud(uint32_t u32Baud)
+{
+    if (0U != u32Baud) {
+        uart_printf("baud: the CAN bit rate is the one of the bus (USHELL_CAN_BITRATE)\r\n");
+        return CAN_BAUD_CMD_ERR;
+    }
+    const uint32_t u32Esr = CAN_ESR(CAN1);
+    uart_printf("baud: CAN node %u, %u bit/s, rx 0x%03X tx 0x%03X, %s\r\n",
+                (unsigned)UART_ACCESS_CAN_NODE, s_u32Bitrate, CAN_ISOTP_RX_ID, CAN_ISOTP_TX_ID,
+                (true == s_bPortOpen) ? "open" : "closed");
+    uart_printf("  frames rx %u tx %u, messages rx %u tx %u, waits %u, errors %u, dropped %u\r\n",
+                s_u32RxFrames, s_u32TxFrames, s_u32RxMessages, s_u32TxMessages, s_u32FcWaits, s_u32Errors, s_u32TxDropped);
+    uart_printf("  TEC %u REC %u%s%s\r\n", (u32Esr >> 16) & 0xFFU, (u32Esr >> 24) & 0xFFU,
+                (0U != (u32Esr & CAN_ESR_EPVF)) ? ", error passive" : "",
+                (0U != (u32Esr & CAN_ESR_BOFF)) ? ", bus-off" : "");
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* FIFO 0: every pending frame into the ISO-TP reception, as long as the ring has room for one */
+extern "C" void usb_lp_can_rx0_isr(void)
+{
+    ISR_PROF_ENTER(ISR_PROF_CAN_RX);
+    PROBE(UART_RX_BEGIN);
+    const uint16_t u16Head = s_u16RxHead;
+    const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+
+    while (0U != (CAN_RF0R(CAN1) & CAN_RF0R_FMP0_MASK)) {
+        if (can_rx_free() < CAN_FRAME_DATA) {
+            s_bRxHeld = true;
+            can_disable_irq(CAN1, CAN_IER_FMPIE0);
+            break;
+        }
+        uint32_t u32Id;
+        bool bExt, bRtr;
+        uint8_t u8Fmi, u8Len;
+        uint8_t vu8Data[8];
+        can_receive(CAN1, 0, true, &u32Id, &bExt, &bRtr, &u8Fmi, &u8Len, vu8Data, nullptr);
+        s_u32RxFrames = s_u32RxFrames + 1U;
+        if ((false == bExt) && (false == bRtr) && (u8Len > 0U) && (u8Len <= 8U)) {
+            isotp_rx_frame(u32Id, vu8Data, u8Len);
+        }
+    }
+    tx_kick();
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+
+    if (true == s_bTxStminArm) {
+        s_bTxStminArm = false;
+        BaseType_t xWoken = pdFALSE;
+        (void)xTimerChangePeriodFromISR(s_hStmin, s_xTxStmin, &xWoken);
+        portYIELD_FROM_ISR(xWoken);
+    }
+
+    if (u16Head != s_u16RxHead) {
+        const uart_rx_hook_t pfHook = s_pfRxHook;
+        if (nullptr != pfHook) {
+            pfHook();
+        }
+        TaskHandle_t xTask = s_xRxTask;
+        if (nullptr != xTask) {
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+            vTaskNotifyGiveFromISR(xTask, &xHigherPriorityTaskWoken);
+            portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        }
+    }
+    PROBE(UART_RX_END);
+    ISR_PROF_EXIT(ISR_PROF_CAN_RX);
+}
+
+
+
+/*--------------------------------------------------*/
+/* a mailbox is free: the pending flow control, then the next frames of the output */
+extern "C" void usb_hp_can_tx_isr(void)
+{
+    ISR_PROF_ENTER(ISR_PROF_CAN_TX);
+    CAN_TSR(CAN1) = CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2;
+
+    const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    tx_kick();
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+    ISR_PROF_EXIT(ISR_PROF_CAN_TX);
+}
+
+
+
+/*--------------------------------------------------*/
+/* bus-off: the channel is closed until the gateway talks again (ABOM recovers the controller) */
+extern "C" void can_sce_isr(void)
+{
+    CAN_MSR(CAN1) = CAN_MSR_ERRI;
+    if (0U != (CAN_ESR(CAN1) & CAN_ESR_BOFF)) {
+        const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+        s_u32Errors = s_u32Errors + 1U;
+        can_close();
+        taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+    }
+}
+
+/* ================================================
+            private interfaces definition
+==================================================*/
+
+/*--------------------------------------------------*/
+/* the smallest prescaler which gives CAN_TQ_MIN .. CAN_TQ_MAX quanta per bit; TS1 and TS2 put
+   the sample point at 87.5 % (SJW 1) */
+static bool can_timing(uint32_t u32Bitrate, uint32_t *pu32Brp, uint32_t *pu32Ts1, uint32_t *pu32Ts2)
+{
+    if (0U == u32Bitrate) {
+        return false;
+    }
+    for (uint32_t u32Brp = 1U; u32Brp <= CAN_BRP_MAX; ++u32Brp) {
+        const uint32_t u32Div = u32Bitrate * u32Brp;
+        if (0U != (rcc_apb1_frequency % u32Div)) {
+            continue;
+        }
+        const uint32_t u32Tq = rcc_apb1_frequency / u32Div;
+        if (u32Tq < CAN_TQ_MIN) {
+            return false;
+        }
+        if (u32Tq <= CAN_TQ_MAX) {
+            const uint32_t u32Ts1 = ((u32Tq * 7U) + 4U) / 8U - 1U;     /* the sync quantum apart */
+            *pu32Brp = u32Brp;
+            *pu32Ts1 = u32Ts1;
+            *pu32Ts2 = u32Tq - 1U - u32Ts1;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the controller at u32Bitrate, the filter of the node, the interrupts; from a task, before the
+   scheduler or with the CAN interrupts masked */
+static bool can_start(uint32_t u32Bitrate)
+{
+    uint32_t u32Brp, u32Ts1, u32Ts2;
+
+    if (false == can_timing(u32Bitrate, &u32Brp, &u32Ts1, &u32Ts2)) {
+        return false;
+    }
+    /* automatic bus-off recovery, retransmission on error, the mailboxes in request order */
+    if (0 != can_init(CAN1, false, true, false, false, false, true, CAN_BTR_SJW_1TQ,
+                      (u32Ts1 - 1U) << CAN_BTR_TS1_SHIFT, (u32Ts2 - 1U) << CAN_BTR_TS2_SHIFT,
+                      u32Brp, false, false)) {
+        return false;
+    }
+    /* list mode, 16 bit: the identifier in the top 11 bits, RTR and IDE clear */
+    can_filter_id_list_16bit_init(0, (uint16_t)(CAN_ISOTP_RX_ID << 5), (uint16_t)(CAN_ISOTP_FUNC_ID << 5),
+                                  (uint16_t)(CAN_ISOTP_RX_ID << 5), (uint16_t)(CAN_ISOTP_FUNC_ID << 5), 0, true);
+    can_enable_irq(CAN1, CAN_IER_FMPIE0 | CAN_IER_TMEIE | CAN_IER_BOFIE | CAN_IER_ERRIE);
+    s_u32Bitrate = u32Bitrate;
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+/* one frame of the output identifier, false if the three mailboxes are taken */
+static bool can_send(const uint8_t *pu8Data, uint8_t u8Len)
+{
+    if (can_transmit(CAN1, CAN_ISOTP_TX_ID, false, false, u8Len, (uint8_t *)pu8Data) < 0) {
+        return false;
+    }
+    s_u32TxFrames = s_u32TxFrames + 1U;
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+/* no gateway: the queued output, the message in progress and the frames in the mailboxes are
+   dropped (counted), the output is discarded until the next frame of the gateway; with the
+   CAN interrupts masked */
+static void can_close(void)
+{
+    CAN_TSR(CAN1) = CAN_TSR_ABRQ0 | CAN_TSR_ABRQ1 | CAN_TSR_ABRQ2;
+    s_u32TxDropped = s_u32TxDropped + (uint16_t)(s_u16TxHead - s_u16TxTail);
+    if (ISOTP_TX_IDLE != s_eTxState) {
+        s_u32TxDropped = s_u32TxDropped + (uint32_t)(s_u16TxPduLen - s_u16TxPduPos);
+    }
+    s_u16TxTail = s_u16TxHead;
+    s_eTxState = ISOTP_TX_IDLE;
+    s_bRxFcPending = false;
+    s_bPortOpen = false;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a frame of the filter, in the RX ISR: single, first and consecutive frames of the input, the
+   flow control of the output */
+static void isotp_rx_frame(uint32_t u32Id, const uint8_t *pu8Data, uint8_t u8Len)
+{
+    const uint8_t u8Pci = (uint8_t)(pu8Data[0] & 0xF0U);
+    const bool bPhysical = (CAN_ISOTP_RX_ID == u32Id);
+
+    if (false == s_bPortOpen) {
+        s_u16TxTail = s_u16TxHead;      /* nothing older than the session */
+        s_bPortOpen = true;
+    }
+
+    if (ISOTP_PCI_SF == u8Pci) {
+        const uint8_t u8Size = (uint8_t)(pu8Data[0] & 0x0FU);
+        if ((0U != u8Size) && (u8Size < u8Len)) {
+            s_u16RxRemain = 0U;         /* a single frame ends a message in progress */
+            s_bRxFcWait = false;
+            isotp_rx_put(&pu8Data[1], u8Size);
+            s_u32RxMessages = s_u32RxMessages + 1U;
+        }
+    } else if ((ISOTP_PCI_FF == u8Pci) && (true == bPhysical) && (8U == u8Len)) {
+        const uint16_t u16Size = (uint16_t)(((pu8Data[0] & 0x0FU) << 8) | pu8Data[1]);
+        if (u16Size > CAN_FRAME_DATA) {
+            isotp_rx_put(&pu8Data[2], 6U);
+            s_u16RxRemain = (uint16_t)(u16Size - 6U);
+            s_u8RxSn = 1U;
+            isotp_rx_fc();
+        }
+    } else if ((ISOTP_PCI_CF == u8Pci) && (true == bPhysical) && (0U != s_u16RxRemain) && (false == s_bRxFcWait)) {
+        if ((pu8Data[0] & 0x0FU) != s_u8RxSn) {
+            s_u16RxRemain = 0U;         /* a frame lost: the rest of the message is dropped */
+            s_u32Errors = s_u32Errors + 1U;
+            return;
+        }
+        const uint8_t u8Size = (s_u16RxRemain < CAN_FRAME_DATA) ? (uint8_t)s_u16RxRemain : (uint8_t)CAN_FRAME_DATA;
+        if (u8Size >= u8Len) {
+            s_u16RxRemain = 0U;
+            s_u32Errors = s_u32Errors + 1U;
+            return;
+        }
+        isotp_rx_put(&pu8Data[1], u8Size);
+        s_u16RxRemain = (uint16_t)(s_u16RxRemain - u8Size);
+        s_u8RxSn = (uint8_t)((s_u8RxSn + 1U) & 0x0FU);
+        if (0U == s_u16RxRemain) {
+            s_u32RxMessages = s_u32RxMessages + 1U;
+        } else if ((0U != s_u8RxBlock) && (0U == --s_u8RxBlock)) {
+            isotp_rx_fc();
+        }
+    } else if ((ISOTP_PCI_FC == u8Pci) && (true == bPhysical)) {
+        isotp_tx_fc(pu8Data, u8Len);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+static void isotp_rx_put(const uint8_t *pu8Data, uint32_t u32Len)
+{
+    for (uint32_t i = 0; i < u32Len; ++i) {
+        s_vu8RxBuffer[s_u16RxHead & (CAN_RX_BUFFER_SIZE - 1U)] = pu8Data[i];
+        s_u16RxHead = (uint16_t)(s_u16RxHead + 1U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* the flow control of the input: the rest of the message if the ring takes it, else the block
+   it has room for, a WAIT if none (can_rx_release() sends the CTS); with the CAN interrupts masked */
+static void isotp_rx_fc(void)
+{
+    const uint16_t u16Free = can_rx_free();
+    const uint16_t u16Blocks = (uint16_t)(u16Free / CAN_FRAME_DATA);
+
+    if (s_u16RxRemain <= u16Free) {
+        s_u8RxBlock = 0U;
+    } else if (0U != u16Blocks) {
+        s_u8RxBlock = (u16Blocks > 0xFFU) ? 0xFFU : (uint8_t)u16Blocks;
+    } else {
+        s_bRxFcWait = true;
+        s_u32FcWaits = s_u32FcWaits + 1U;
+    }
+    s_vu8RxFc[0] = (uint8_t)(ISOTP_PCI_FC | ((true == s_bRxFcWait) ? ISOTP_FC_WAIT : ISOTP_FC_CTS));
+    s_vu8RxFc[1] = s_u8RxBlock;
+    s_vu8RxFc[2] = CAN_ISOTP_RX_STMIN;
+    s_bRxFcPending = true;      /* ahead of the output, tx_kick() */
+}
+
+
+
+/*--------------------------------------------------*/
+/* the flow control of the gateway for the output message */
+static void isotp_tx_fc(const uint8_t *pu8Data, uint8_t u8Len)
+{
+    if ((ISOTP_TX_WAIT_FC != s_eTxState) || (u8Len < 3U)) {
+        return;
+    }
+    switch (pu8Data[0] & 0x0FU) {
+        case ISOTP_FC_CTS: {
+            /* STmin: 0 .. 127 ms, 100 .. 900 us (0xF1 .. 0xF9) one tick, a reserved value 127 ms */
+            const uint8_t u8Stmin = pu8Data[2];
+            const uint32_t u32Ms = (u8Stmin <= 0x7FU) ? u8Stmin : ((u8Stmin >= 0xF1U) && (u8Stmin <= 0xF9U)) ? 1U : 0x7FU;
+            s_xTxStmin = (0U == u32Ms) ? 0 : ((pdMS_TO_TICKS(u32Ms) > 0) ? pdMS_TO_TICKS(u32Ms) : 1);
+            s_u8TxBlockSize = pu8Data[1];
+            s_u8TxBlockLeft = s_u8TxBlockSize;
+            s_bTxStminArm = (0 != s_xTxStmin);
+            s_eTxState = ISOTP_TX_CF;
+        } break;
+        case ISOTP_FC_WAIT: {
+            s_xTxFcStart = xTaskGetTickCountFromISR();
+        } break;
+        default: {
+            /* OVFLW or invalid: the message is dropped */
+            s_u32Errors = s_u32Errors + 1U;
+            s_u32TxDropped = s_u32TxDropped + (uint32_t)(s_u16TxPduLen - s_u16TxPduPos);
+            s_eTxState = ISOTP_TX_IDLE;
+        } break;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* called with the CAN interrupts masked (critical section or CAN ISR): the frames for the free
+   mailboxes, the flow control of the input first */
+static void tx_kick(void)
+{
+    uint8_t vu8Frame[8];
+
+    if (true == s_bRxFcPending) {
+        if (false == can_send(s_vu8RxFc, 3U)) {
+            return;
+        }
+        s_bRxFcPending = false;
+    }
+    while (true == s_bPortOpen) {
+        if (ISOTP_TX_IDLE == s_eTxState) {
+            uint16_t u16Len = (uint16_t)(s_u16TxHead - s_u16TxTail);
+            if ((0U == u16Len) || (false == can_available_mailbox(CAN1))) {
+                return;
+            }
+            if (u16Len <= CAN_FRAME_DATA) {
+                vu8Frame[0] = (uint8_t)(ISOTP_PCI_SF | u16Len);
+                for (uint16_t i = 0; i < u16Len; i++) {
+                    vu8Frame[1U + i] = s_vu8TxBuffer[(uint16_t)(s_u16TxTail + i) & (CAN_TX_BUFFER_SIZE - 1U)];
+                }
+                (void)can_send(vu8Frame, (uint8_t)(1U + u16Len));
+                s_u16TxTail = (uint16_t)(s_u16TxTail + u16Len);
+                s_u32TxMessages = s_u32TxMessages + 1U;
+                continue;
+            }
+            if (u16Len > CAN_ISOTP_TX_PDU_MAX) {
+                u16Len = CAN_ISOTP_TX_PDU_MAX;
+            }
+            for (uint16_t i = 0; i < u16Len; i++) {
+                s_vu8TxPdu[i] = s_vu8TxBuffer[(uint16_t)(s_u16TxTail + i) & (CAN_TX_BUFFER_SIZE - 1U)];
+            }
+            s_u16TxTail = (uint16_t)(s_u16TxTail + u16Len);
+            vu8Frame[0] = (uint8_t)(ISOTP_PCI_FF | (u16Len >> 8));
+            vu8Frame[1] = (uint8_t)u16Len;
+            for (uint16_t i = 0; i < 6U; i++) {
+                vu8Frame[2U + i] = s_vu8TxPdu[i];
+            }
+            (void)can_send(vu8Frame, 8U);
+            s_u16TxPduLen = u16Len;
+            s_u16TxPduPos = 6U;
+            s_u8TxSn = 1U;
+            s_xTxFcStart = xPortIsInsideInterrupt() ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+            s_eTxState = ISOTP_TX_WAIT_FC;
+            return;
+        }
+        if (ISOTP_TX_CF != s_eTxState) {
+            return;
+        }
+        if (((0 != s_xTxStmin) && (false == s_bTxStminDue)) || (false == can_available_mailbox(CAN1))) {
+            return;
+        }
+        const uint16_t u16Rest = (uint16_t)(s_u16TxPduLen - s_u16TxPduPos);
+        const uint8_t u8Size = (u16Rest < CAN_FRAME_DATA) ? (uint8_t)u16Rest : (uint8_t)CAN_FRAME_DATA;
+        vu8Frame[0] = (uint8_t)(ISOTP_PCI_CF | s_u8TxSn);
+        for (uint8_t i = 0; i < u8Size; i++) {
+            vu8Frame[1U + i] = s_vu8TxPdu[s_u16TxPduPos + i];
+        }
+        (void)can_send(vu8Frame, (uint8_t)(1U + u8Size));
+        s_u16TxPduPos = (uint16_t)(s_u16TxPduPos + u8Size);
+        s_u8TxSn = (uint8_t)((s_u8TxSn + 1U) & 0x0FU);
+        s_bTxStminDue = false;
+        if (s_u16TxPduPos == s_u16TxPduLen) {
+            s_eTxState = ISOTP_TX_IDLE;
+            s_u32TxMessages = s_u32TxMessages + 1U;
+        } else if ((0U != s_u8TxBlockSize) && (0U == --s_u8TxBlockLeft)) {
+            s_xTxFcStart = xPortIsInsideInterrupt() ? xTaskGetTickCountFromISR() : xTaskGetTickCount();
+            s_eTxState = ISOTP_TX_WAIT_FC;
+            return;
+        }
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* STmin of the gateway is over: the next consecutive frame, only from here while the gateway
+   asks for a gap (the mailbox interrupt would send it early); the mailboxes taken: a tick later */
+static void isotp_stmin_cb(TimerHandle_t xTimer)
+{
+    taskENTER_CRITICAL();
+    const uint8_t u8Sn = s_u8TxSn;
+    s_bTxStminDue = true;
+    tx_kick();
+    s_bTxStminDue = false;
+    const bool bMore = (ISOTP_TX_CF == s_eTxState) && (0 != s_xTxStmin);
+    taskEXIT_CRITICAL();
+
+    if (true == bMore) {
+        (void)xTimerChangePeriod(xTimer, (u8Sn != s_u8TxSn) ? s_xTxStmin : 1, 0);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* the ring works before the scheduler too, nothing waits for room then */
+bool uart_port_tx_early(const char *buf, int len)
+{
+    (void)buf;
+    (void)len;
+    return false;
+}
+
+
+
+/*--------------------------------------------------*/
+/* nobody takes the output before the gateway talks */
+bool uart_port_tx_open(void)
+{
+    return s_bPortOpen;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_port_tx_free(void)
+{
+    if (false == s_bPortOpen) {
+        return 0U;
+    }
+    return (uint32_t)(CAN_TX_BUFFER_SIZE - (uint16_t)(s_u16TxHead - s_u16TxTail));
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_put(const char *buf, uint32_t len)
+{
+    PROBE(UART_TX_BEGIN);
+    for (uint32_t i = 0; i < len; ++i) {
+        s_vu8TxBuffer[(uint16_t)(s_u16TxHead + i) & (CAN_TX_BUFFER_SIZE - 1U)] = (uint8_t)buf[i];
+    }
+    s_u16TxHead = (uint16_t)(s_u16TxHead + len);
+    tx_kick();
+    activity_output();
+    PROBE(UART_TX_END);
+}
+
+
+
+/*--------------------------------------------------*/
+/* the message in progress is out of the ring already, only the ring gives room */
+bool uart_port_tx_discard(uint32_t len)
+{
+    if (len > (uint16_t)(s_u16TxHead - s_u16TxTail)) {
+        return false;
+    }
+    s_u16TxTail = (uint16_t)(s_u16TxTail + len);
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a frame takes 0.25 ms at 500 kbit/s; a gateway which stopped answering closes the channel */
+void uart_port_tx_wait(void)
+{
+    taskENTER_CRITICAL();
+    if ((ISOTP_TX_WAIT_FC == s_eTxState) && ((xTaskGetTickCount() - s_xTxFcStart) > pdMS_TO_TICKS(CAN_ISOTP_N_BS_MS))) {
+        s_u32Errors = s_u32Errors + 1U;
+        can_close();
+    }
+    taskEXIT_CRITICAL();
+    vTaskDelay(1);
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_dropped(uint32_t len)
+{
+    s_u32TxDropped = s_u32TxDropped + len;
+}
+
+
+
+/*--------------------------------------------------*/
+uart_tx_policy_e uart_port_tx_policy(void)
+{
+    return s_eTxPolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+/* block until the RX ISR reports new data: task notification once the
+   scheduler runs, wfi before (bare metal, early boot) */
+static void can_rx_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        s_xRxTask = xTaskGetCurrentTaskHandle();
+        if (s_u16RxTail == s_u16RxHead) {
+            activity_add(1U);
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            activity_add(1U);
+        }
+    } else {
+        /* a pending irq still ends wfi with the interrupts masked, so none is missed */
+        __asm__ volatile ("cpsid i" ::: "memory");
+        if (s_u16RxTail == s_u16RxHead) {
+            __asm__ volatile ("wfi");
+        }
+        __asm__ volatile ("cpsie i" ::: "memory");
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* can_rx_wait() with a limit, false if nothing arrived meanwhile (task context only) */
+static bool can_rx_wait_for(uint32_t u32Ms)
+{
+    if (0U == u32Ms) {
+        return (s_u16RxTail != s_u16RxHead);    /* a poll (ShellAO): the notification of the caller is left alone */
+    }
+    s_xRxTask = xTaskGetCurrentTaskHandle();
+    if (s_u16RxTail == s_u16RxHead) {
+        activity_add(1U);
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(u32Ms));
+        activity_add(1U);
+    }
+    return (s_u16RxTail != s_u16RxHead);
+}
+
+
+
+/*--------------------------------------------------*/
+/* room for a frame again: the single frame held in the FIFO, the CTS after a WAIT */
+static void can_rx_release(void)
+{
+    if ((true == s_bRxHeld) || (true == s_bRxFcWait)) {
+        taskENTER_CRITICAL();
+        if (can_rx_free() >= CAN_FRAME_DATA) {
+            if (true == s_bRxFcWait) {
+                s_bRxFcWait = false;
+                isotp_rx_fc();
+                tx_kick();
+            }
+            if (true == s_bRxHeld) {
+                s_bRxHeld = false;
+                can_enable_irq(CAN1, CAN_IER_FMPIE0);
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* tasks and the reader itself: atomic, a lost step would flip the waiting parity */
+static void activity_add(uint32_t u32Step)
+{
+    __atomic_fetch_add(&s_u32Activity, u32Step, __ATOMIC_RELAXED);
+}
+
+
+
+/*--------------------------------------------------*/
+static void activity_output(void)
+{
+    if (xTaskGetCurrentTaskHandle() == s_xRxTask) {
+        activity_add(2U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+static inline uint16_t can_rx_free(void)
+{
+    return (uint16_t)(CAN_RX_BUFFER_SIZE - (uint16_t)(s_u16RxHead - s_u16RxTail));
+}
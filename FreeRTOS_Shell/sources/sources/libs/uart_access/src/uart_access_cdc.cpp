@@ -0,0 +1,748 @@
+#include "uart_access.h"
+#include "uart_access_port.h"
+#include "libopencm3/stm32/rcc.h"
+#include "libopencm3/stm32/gpio.h"
+#include "libopencm3/cm3/nvic.h"
+#include "libopencm3/usb/usbd.h"
+#include "libopencm3/usb/cdc.h"
+#include "libopencm3/usb/dwc/otg_fs.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include <stdint.h>
+
+/*
+ * USB CDC-ACM backend of uart_access (STM32F411, OTG_FS on PA11/PA12).
+ * Same interface as the USART1 backend, the uart_printf() family is shared.
+ *
+ *  - OUT (host -> shell): 64 byte packets are read into the RX ring by the
+ *    endpoint callback; when the ring can not take a full packet the endpoint
+ *    is NAKed and released by the reader, so the host is throttled, never dropped
+ *  - IN (shell -> host): bytes are queued in the TX ring and sent as 64 byte
+ *    packets from the IN complete callback; the packet buffer is refilled while
+ *    the previous one is still in the endpoint FIFO
+ *  - until the host opens the port (DTR) the output is discarded and counted,
+ *    nobody would read it and a blocked writer would freeze the shell
+ *
+ * Needs the 48 MHz PLLQ clock (the 84 MHz rcc configurations provide it).
+ */
+
+/* ================================================
+            USB CDC configuration
+==================================================*/
+
+#define CDC_PACKET_SIZE             (64U)
+#define CDC_EP_DATA_OUT             (0x01U)
+#define CDC_EP_DATA_IN              (0x82U)
+#define CDC_EP_COMM_IN              (0x83U)
+
+#define CDC_RX_BUFFER_SIZE          (256U)   /* power of 2 */
+#define CDC_TX_BUFFER_SIZE          (512U)   /* power of 2 */
+
+/* must be allowed to call the FreeRTOS FromISR API */
+#define CDC_IRQ_PRIORITY            ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+
+static_assert(0U == (CDC_RX_BUFFER_SIZE & (CDC_RX_BUFFER_SIZE - 1U)), "CDC_RX_BUFFER_SIZE must be a power of 2");
+static_assert(0U == (CDC_TX_BUFFER_SIZE & (CDC_TX_BUFFER_SIZE - 1U)), "CDC_TX_BUFFER_SIZE must be a power of 2");
+static_assert(CDC_RX_BUFFER_SIZE > 2U * CDC_PACKET_SIZE, "CDC_RX_BUFFER_SIZE must hold more than two packets");
+static_assert(CDC_TX_BUFFER_SIZE >= UART_MUX_COMMIT_MAX, "CDC_TX_BUFFER_SIZE must take a line commit at once");
+
+/* ================================================
+            USB descriptors
+==================================================*/
+
+static const struct usb_device_descriptor s_sDevice = {
+    .bLength            = USB_DT_DEVICE_SIZE,
+    .bDescriptorType    = USB_DT_DEVICE,
+    .bcdUSB             = 0x0200,
+    .bDeviceClass       = USB_CLASS_CDC,
+    .bDeviceSubClass    = 0,
+    .bDeviceProtocol    = 0,
+    .bMaxPacketSize0    = 64,
+    .idVendor           = 0x0483,   /* ST, Virtual COM Port */
+    .idProduct          = 0x5740,
+    .bcdDevice          = 0x0200,
+    .iManufacturer      = 1,
+    .iProduct           = 2,
+    .iSerialNumber      = 3,
+    .bNumConfigurations = 1,
+};
+
+static const struct usb_endpoint_descriptor s_vsCommEndpoints[] = {{
+    .bLength            = USB_DT_ENDPOINT_SIZE,
+    .bDescriptorType    = USB_DT_ENDPOINT,
+    .bEndpointAddress   = CDC_EP_COMM_IN,
+    .bmAttributes       = USB_ENDPOINT_ATTR_INTERRUPT,
+    .wMaxPacketSize     = 16,
+    .bInterval          = 255,
+    .extra              = nullptr,
+    .extralen           = 0,
+}};
+
+static const struct usb_endpoint_descriptor s_vsDataEndpoints[] = {{
+    .bLength            = USB_DT_ENDPOINT_SIZE,
+    .bDescriptorType    = USB_DT_ENDPOINT,
+    .bEndpointAddress   = CDC_EP_DATA_OUT,
+    .bmAttributes       = USB_ENDPOINT_ATTR_BULK,
+    .wMaxPacketSize     = CDC_PACKET_SIZE,
+    .bInterval          = 1,
+    .extra              = nullptr,
+    .extralen           = 0,
+}, {
+    .bLength            = USB_DT_ENDPOINT_SIZE,
+    .bDescriptorType    = USB_DT_ENDPOINT,
+    .bEndpointAddress   = CDC_EP_DATA_IN,
+    .bmAttributes       = USB_ENDPOINT_ATTR_BULK,
+    .wMaxPacketSize     = CDC_PACKET_SIZE,
+    .bInterval          = 1,
+    .extra              = nullptr,
+    .extralen           = 0,
+}};
+
+static const struct {
+    struct usb_cdc_header_descriptor          header;
+    struct usb_cdc_call_management_descriptor call_mgmt;
+    struct usb_cdc_acm_descriptor             acm;
+    struct usb_cdc_union_descriptor           cdc_union;
+} __attribute__((packed)) s_sCdcFunctional = {
+    .header = {
+        .bFunctionLength    = sizeof(struct usb_cdc_header_descriptor),
+        .bDescriptorType    = CS_INTERFACE,
+        .bDescriptorSubtype = USB_CDC_TYPE_HEADER,
+        .bcdCDC             = 0x0110,
+    },
+    .call_mgmt = {
+        .bFunctionLength    = sizeof(struct usb_cdc_call_management_descriptor),
+        .bDescriptorType    = CS_INTERFACE,
+        .bDescriptorSubtype = USB_CDC_TYPE_CALL_MANAGEMENT,
+        .bmCapabilities     = 0,
+        .bDataInterface     = 1,
+    },
+    .acm = {
+        .bFunctionLength    = sizeof(struct usb_cdc_acm_descriptor),
+        .bDescriptorType    = CS_INTERFACE,
+        .bDescriptorSubtype = USB_CDC_TYPE_ACM,
+        .bmCapabilities     = 0,
+    },
+    .cdc_union = {
+        .bFunctionLength        = sizeof(struct usb_cdc_union_descriptor),
+        .bDescriptorType        = CS_INTERFACE,
+        .bDescriptorSubtype     = USB_CDC_TYPE_UNION,
+        .bControlInterface      = 0,
+        .bSubordinateInterface0 = 1,
+    },
+};
+
+static const struct usb_interface_descriptor s_sCommInterface = {
+    .bLength            = USB_DT_INTERFACE_SIZE,
+    .bDescriptorType    = USB_DT_INTERFACE,
+    .bInterfaceNumber   = 0,
+    .bAlternateSetting  = 0,
+    .bNumEndpoints      = 1,
+    .bInterfaceClass    = USB_CLASS_CDC,
+    .bInterfaceSubClass = USB_CDC_SUBCLASS_ACM,
+    .bInterfaceProtocol = USB_CDC_PROTOCOL_AT,
+    .iInterface         = 0,
+    .endpoint           = s_vsCommEndpoints,
+    .extra              = &s_sCdcFunctional,
+    .extralen           = sizeof(s_sCdcFunctional),
+};
+
+static const struct usb_interface_descriptor s_sDataInterface = {
+    .bLength            = USB_DT_INTERFACE_SIZE,
+    .bDescriptorType    = USB_DT_INTERFACE,
+    .bInterfaceNumber   = 1,
+    .bAlternateSetting  = 0,
+    .bNumEndpoints      = 2,
+    .bInterfaceClass    = USB_CLASS_DATA,
+    .bInterfaceSubClass = 0,
+    .bInterfaceProtocol = 0,
+    .iInterface         = 0,
+    .endpoint           = s_vsDataEndpoints,
+    .extra              = nullptr,
+    .extralen           = 0,
+};
+
+static const struct usb_interface s_vsInterfaces[] = {{
+    .cur_altsetting     = nullptr,
+    .num_altsetting     = 1,
+    .iface_assoc        = nullptr,
+    .altsetting         = &s_sCommInterface,
+}, {
+    .cur_altsetting     = nullptr,
+    .num_altsetting     = 1,
+    .iface_assoc        = nullptr,
+    .altsetting         = &s_sDataInterface,
+}};
+
+static const struct usb_config_descriptor s_sConfig = {
+    .bLength             = USB_DT_CONFIGURATION_SIZE,
+    .bDescriptorType     = USB_DT_CONFIGURATION,
+    .wTotalLength        = 0,
+    .bNumInterfaces      = 2,
+    .bConfigurationValue = 1,
+    .iConfiguration      = 0,
+    .bmAttributes        = 0x80,
+    .bMaxPower           = 0x32,    /* 100 mA */
+    .interface           = s_vsInterfaces,
+};
+
+static const char *const s_vpstrStrings[] = {
+    "uSTM32Template",
+    "uShell CDC-ACM",
+    "USHELL0001",
+};
+
+/* ================================================
+            private interfaces declaration
+==================================================*/
+
+static void cdc_set_config(usbd_device *usbd_dev, uint16_t wValue);
+static enum usbd_request_return_codes cdc_control_request(usbd_device *usbd_dev, struct usb_setup_data *req,
+                                                          uint8_t **buf, uint16_t *len,
+                                                          usbd_control_complete_callback *complete);
+static void cdc_data_rx_cb(usbd_device *usbd_dev, uint8_t ep);
+static void cdc_data_tx_cb(usbd_device *usbd_dev, uint8_t ep);
+static void cdc_tx_kick(void);
+static void cdc_rx_wait(void);
+static bool cdc_rx_wait_for(uint32_t u32Ms);
+static void activity_add(uint32_t u32Step);
+static void activity_output(void);
+static void cdc_rx_release(void);
+static inline uint16_t cdc_rx_free(void);
+
+/* ================================================
+            private data
+==================================================*/
+
+static usbd_device *s_psUsbDev = nullptr;
+static uint8_t s_vu8ControlBuffer[128];
+static struct usb_cdc_line_coding s_sLineCoding = { 115200, USB_CDC_1_STOP_BITS, USB_CDC_NO_PARITY, 8 };
+
+static volatile bool s_bConfigured = false;             /* SET_CONFIGURATION received */
+static volatile bool s_bPortOpen = false;               /* DTR set by the host terminal */
+
+static uint8_t s_vu8RxBuffer[CDC_RX_BUFFER_SIZE];
+static volatile uint16_t s_u16RxHead = 0;              /* free running, written by the USB ISR */
+static volatile uint16_t s_u16RxTail = 0;              /* free running, owned by the reading task */
+static volatile bool s_bRxNaked = false;               /* OUT endpoint held until the ring has room */
+static TaskHandle_t volatile s_xRxTask = nullptr;      /* task blocked in uart_getchar() */
+static volatile uart_rx_hook_t s_pfRxHook = nullptr;   /* uart_rx_set_hook() */
+static volatile uint32_t s_u32Activity = 0U;           /* uart_activity() */
+
+static uint8_t s_vu8TxBuffer[CDC_TX_BUFFER_SIZE];
+static uint8_t s_vu8TxPacket[CDC_PACKET_SIZE];
+static volatile uint16_t s_u16TxHead = 0;              /* free running, masked on access */
+static volatile uint16_t s_u16TxTail = 0;
+static volatile bool s_bTxBusy = false;                /* a packet is in the IN endpoint */
+static volatile bool s_bTxZlp = false;                 /* last packet was full: end the transfer */
+static volatile uint32_t s_u32TxDropped = 0;
+static volatile uart_tx_policy_e s_eTxPolicy = UART_TX_BLOCK;
+
+/* ================================================
+            public interfaces definition
+==================================================*/
+
+/*--------------------------------------------------*/
+void uart_setup(void)
+{
+    rcc_periph_clock_enable(RCC_GPIOA);
+    rcc_periph_clock_enable(RCC_OTGFS);
+
+    /* PA11 = DM, PA12 = DP */
+    gpio_mode_setup(GPIOA, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO11 | GPIO12);
+    gpio_set_af(GPIOA, GPIO_AF10, GPIO11 | GPIO12);
+
+    s_psUsbDev = usbd_init(&otgfs_usb_driver, &s_sDevice, &s_sConfig,
+                           s_vpstrStrings, 3, s_vu8ControlBuffer, sizeof(s_vu8ControlBuffer));
+
+    /* the Black Pill does not route VBUS to PA9: the session is always valid */
+    OTG_FS_GCCFG = (OTG_FS_GCCFG | OTG_GCCFG_NOVBUSSENS) & ~(OTG_GCCFG_VBUSBSEN | OTG_GCCFG_VBUSASEN);
+
+    usbd_register_set_config_callback(s_psUsbDev, cdc_set_config);
+
+    nvic_set_priority(NVIC_OTG_FS_IRQ, CDC_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_OTG_FS_IRQ);
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_getchar(void)
+{
+    uart_mux_reader();
+    while (s_u16RxTail == s_u16RxHead) {
+        cdc_rx_wait();
+    }
+    const uint8_t c = s_vu8RxBuffer[s_u16RxTail & (CDC_RX_BUFFER_SIZE - 1U)];
+    s_u16RxTail = (uint16_t)(s_u16RxTail + 1U);
+    cdc_rx_release();
+    return c;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a packet carries what the host wrote at once, so a pasted line is usually complete here;
+   anything else (control keys, partial or too long line) stays for uart_getchar() */
+int uart_getline(char *buf, int maxlen)
+{
+    uart_mux_reader();
+    while (s_u16RxTail == s_u16RxHead) {
+        cdc_rx_wait();
+    }
+
+    const uint16_t u16Head = s_u16RxHead;
+    uint16_t u16Idx = s_u16RxTail;
+    int len = 0;
+
+    while (u16Idx != u16Head) {
+        const uint8_t c = s_vu8RxBuffer[u16Idx & (CDC_RX_BUFFER_SIZE - 1U)];
+        u16Idx = (uint16_t)(u16Idx + 1U);
+        if ('\r' == c) {
+            buf[len] = '\0';
+            const int consumed = (int)(uint16_t)(u16Idx - s_u16RxTail);
+            s_u16RxTail = u16Idx;
+            cdc_rx_release();
+            return consumed;
+        }
+        if ('\n' == c) {
+            continue;
+        }
+        if ((c < 0x20U) || (c > 0x7EU) || (len >= maxlen - 1)) {
+            break;
+        }
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_read(uint8_t *buf, int len, uint32_t u32TimeoutMs)
+{
+    int done = 0;
+
+    uart_mux_reader();
+    while (done < len) {
+        if (s_u16RxTail == s_u16RxHead) {
+            if (false == cdc_rx_wait_for(u32TimeoutMs)) {
+                break;
+            }
+            continue;
+        }
+        while ((s_u16RxTail != s_u16RxHead) && (done < len)) {
+            buf[done++] = s_vu8RxBuffer[s_u16RxTail & (CDC_RX_BUFFER_SIZE - 1U)];
+            s_u16RxTail = (uint16_t)(s_u16RxTail + 1U);
+        }
+        cdc_rx_release();
+    }
+    return done;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_tx_set_policy(uart_tx_policy_e ePolicy)
+{
+    s_eTxPolicy = ePolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_tx_dropped(void)
+{
+    return s_u32TxDropped;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_rx_set_hook(uart_rx_hook_t pfHook)
+{
+    s_pfRxHook = pfHook;
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+const volatile uint32_t *uart_activity(void)
+{
+    return &s_u32Activity;
+}
+
+
+
+/*--------------------------------------------------*/
+/* wait until everything queued so far was taken by the host (or the port was closed) */
+void uart_flush(void)
+{
+    uart_mux_flush();
+    while ((true == s_bPortOpen) && ((s_u16TxHead != s_u16TxTail) || (true == s_bTxBusy))) {
+        if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_tx_busy(void)
+{
+    return ((true == s_bPortOpen) && ((s_u16TxHead != s_u16TxTail) || (true == s_bTxBusy))) ? 1 : 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the line coding set by the host is only a label for a USB link */
+int uart_set_baudrate(uint32_t u32Baud)
+{
+    (void)u32Baud;
+    return -1;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_get_baudrate(void)
+{
+    return 0U;
+}
+
+
+
+/*--------------------------------------------------*/
+/* shell command, same table entry as the USART backend */
+extern "C" int baud(uint32_t u32Baud)
+{
+    (void)u32Baud;
+    uart_printf("baud: no baud rate on USB CDC\r\n");
+    return 0xFF;
+}
+
+
+
+/*--------------------------------------------------*/
+extern "C" void otg_fs_isr(void)
+{
+    usbd_poll(s_psUsbDev);
+}
+
+/* ================================================
+            private interfaces definition
+==================================================*/
+
+/*--------------------------------------------------*/
+static void cdc_set_config(usbd_device *usbd_dev, uint16_t wValue)
+{
+    (void)wValue;
+
+    usbd_ep_setup(usbd_dev, CDC_EP_DATA_OUT, USB_ENDPOINT_ATTR_BULK, CDC_PACKET_SIZE, cdc_data_rx_cb);
+    usbd_ep_setup(usbd_dev, CDC_EP_DATA_IN, USB_ENDPOINT_ATTR_BULK, CDC_PACKET_SIZE, cdc_data_tx_cb);
+    usbd_ep_setup(usbd_dev, CDC_EP_COMM_IN, USB_ENDPOINT_ATTR_INTERRUPT, 16, nullptr);
+
+    usbd_register_control_callback(usbd_dev,
+                                   USB_REQ_TYPE_CLASS | USB_REQ_TYPE_INTERFACE,
+                                   USB_REQ_TYPE_TYPE | USB_REQ_TYPE_RECIPIENT,
+                                   cdc_control_request);
+
+    s_bRxNaked = false;
+    s_bTxBusy = false;
+    s_bTxZlp = false;
+    s_bConfigured = true;
+}
+
+
+
+/*--------------------------------------------------*/
+static enum usbd_request_return_codes cdc_control_request(usbd_device *usbd_dev, struct usb_setup_data *req,
+                                                          uint8_t **buf, uint16_t *len,
+                                                          usbd_control_complete_callback *complete)
+{
+    (void)usbd_dev;
+    (void)complete;
+
+    switch (req->bRequest) {
+        case USB_CDC_REQ_SET_CONTROL_LINE_STATE: {
+            /* bit 0 = DTR: a terminal opened / closed the port */
+            const bool bOpen = (0U != (req->wValue & 0x0001U));
+            if ((true == bOpen) && (false == s_bPortOpen)) {
+                s_u16TxTail = s_u16TxHead; /* nothing older than the session */
+            }
+            s_bPortOpen = bOpen && s_bConfigured;
+            if (true == s_bPortOpen) {
+                cdc_tx_kick();
+            }
+            return USBD_REQ_HANDLED;
+        }
+        case USB_CDC_REQ_SET_LINE_CODING: {
+            if (*len < sizeof(struct usb_cdc_line_coding)) {
+                return USBD_REQ_NOTSUPP;
+            }
+            s_sLineCoding = *(const struct usb_cdc_line_coding *)*buf; /* ignored, no physical line */
+            return USBD_REQ_HANDLED;
+        }
+        case USB_CDC_REQ_GET_LINE_CODING: {
+            *buf = (uint8_t *)&s_sLineCoding;
+            *len = sizeof(struct usb_cdc_line_coding);
+            return USBD_REQ_HANDLED;
+        }
+        default:
+            return USBD_REQ_NOTSUPP;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* host packet received: into the ring, or hold the endpoint while a packet would not fit */
+static void cdc_data_rx_cb(usbd_device *usbd_dev, uint8_t ep)
+{
+    uint8_t vu8Packet[CDC_PACKET_SIZE];
+    const uint16_t u16Len = usbd_ep_read_packet(usbd_dev, ep, vu8Packet, sizeof(vu8Packet));
+
+    for (uint16_t i = 0; i < u16Len; i++) {
+        s_vu8RxBuffer[s_u16RxHead & (CDC_RX_BUFFER_SIZE - 1U)] = vu8Packet[i];
+        s_u16RxHead = (uint16_t)(s_u16RxHead + 1U);
+    }
+
+    if (cdc_rx_free() < CDC_PACKET_SIZE) {
+        s_bRxNaked = true;
+        usbd_ep_nak_set(usbd_dev, ep, 1);
+    }
+
+    const uart_rx_hook_t pfHook = s_pfRxHook;
+    if ((u16Len > 0U) && (nullptr != pfHook)) {
+        pfHook();
+    }
+    TaskHandle_t xTask = s_xRxTask;
+    if ((u16Len > 0U) && (nullptr != xTask)) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(xTask, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* packet taken by the host: send the next one */
+static void cdc_data_tx_cb(usbd_device *usbd_dev, uint8_t ep)
+{
+    (void)usbd_dev;
+    (void)ep;
+
+    const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    s_bTxBusy = false;
+    cdc_tx_kick();
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+}
+
+
+
+/*--------------------------------------------------*/
+/* called with the USB interrupt masked (critical section or USB ISR) */
+static void cdc_tx_kick(void)
+{
+    if ((true == s_bTxBusy) || (false == s_bPortOpen)) {
+        return;
+    }
+
+    uint16_t u16Len = (uint16_t)(s_u16TxHead - s_u16TxTail);
+    if (0U == u16Len) {
+        if (true == s_bTxZlp) {
+            /* a full packet ended the data: the zero length packet completes the host read */
+            s_bTxZlp = false;
+            s_bTxBusy = true;
+            usbd_ep_write_packet(s_psUsbDev, CDC_EP_DATA_IN, s_vu8TxPacket, 0);
+        }
+        return;
+    }
+
+    if (u16Len > CDC_PACKET_SIZE) {
+        u16Len = CDC_PACKET_SIZE;
+    }
+    for (uint16_t i = 0; i < u16Len; i++) {
+        s_vu8TxPacket[i] = s_vu8TxBuffer[(uint16_t)(s_u16TxTail + i) & (CDC_TX_BUFFER_SIZE - 1U)];
+    }
+
+    if (u16Len == usbd_ep_write_packet(s_psUsbDev, CDC_EP_DATA_IN, s_vu8TxPacket, u16Len)) {
+        s_u16TxTail = (uint16_t)(s_u16TxTail + u16Len);
+        s_bTxZlp = (CDC_PACKET_SIZE == u16Len);
+        s_bTxBusy = true;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* the ring works before the scheduler too, nothing waits for room then */
+bool uart_port_tx_early(const char *buf, int len)
+{
+    (void)buf;
+    (void)len;
+    return false;
+}
+
+
+
+/*--------------------------------------------------*/
+/* nobody would read the output before the host opens the port */
+bool uart_port_tx_open(void)
+{
+    return s_bPortOpen;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_port_tx_free(void)
+{
+    if (false == s_bPortOpen) {
+        return 0U;
+    }
+    return (uint32_t)(CDC_TX_BUFFER_SIZE - (uint16_t)(s_u16TxHead - s_u16TxTail));
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_put(const char *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; ++i) {
+        s_vu8TxBuffer[(uint16_t)(s_u16TxHead + i) & (CDC_TX_BUFFER_SIZE - 1U)] = (uint8_t)buf[i];
+    }
+    s_u16TxHead = (uint16_t)(s_u16TxHead + len);
+    cdc_tx_kick();
+    activity_output();
+}
+
+
+
+/*--------------------------------------------------*/
+/* the packet in the endpoint is gone already, only the ring gives room */
+bool uart_port_tx_discard(uint32_t len)
+{
+    if (len > (uint16_t)(s_u16TxHead - s_u16TxTail)) {
+        return false;
+    }
+    s_u16TxTail = (uint16_t)(s_u16TxTail + len);
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a packet drains in 1 ms (full speed frame) */
+void uart_port_tx_wait(void)
+{
+    vTaskDelay(1);
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_dropped(uint32_t len)
+{
+    s_u32TxDropped = s_u32TxDropped + len;
+}
+
+
+
+/*--------------------------------------------------*/
+uart_tx_policy_e uart_port_tx_policy(void)
+{
+    return s_eTxPolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+/* block until the USB ISR reports new data: task notification once the
+   scheduler runs, wfi before (bare metal, early boot) */
+static void cdc_rx_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        s_xRxTask = xTaskGetCurrentTaskHandle();
+        if (s_u16RxTail == s_u16RxHead) {
+            activity_add(1U);
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            activity_add(1U);
+        }
+    } else {
+        /* a pending irq still ends wfi with the interrupts masked, so none is missed */
+        __asm__ volatile ("cpsid i" ::: "memory");
+        if (s_u16RxTail == s_u16RxHead) {
+            __asm__ volatile ("wfi");
+        }
+        __asm__ volatile ("cpsie i" ::: "memory");
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* cdc_rx_wait() with a limit, false if nothing arrived meanwhile (task context only) */
+static bool cdc_rx_wait_for(uint32_t u32Ms)
+{
+    if (0U == u32Ms) {
+        return (s_u16RxTail != s_u16RxHead);    /* a poll (ShellAO): the notification of the caller is left alone */
+    }
+    s_xRxTask = xTaskGetCurrentTaskHandle();
+    if (s_u16RxTail == s_u16RxHead) {
+        activity_add(1U);
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(u32Ms));
+        activity_add(1U);
+    }
+    return (s_u16RxTail != s_u16RxHead);
+}
+
+
+
+/*--------------------------------------------------*/
+/* tasks and the reader itself: atomic, a lost step would flip the waiting parity */
+static void activity_add(uint32_t u32Step)
+{
+    __atomic_fetch_add(&s_u32Activity, u32Step, __ATOMIC_RELAXED);
+}
+
+
+
+/*--------------------------------------------------*/
+static void activity_output(void)
+{
+    if (xTaskGetCurrentTaskHandle() == s_xRxTask) {
+        activity_add(2U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* room for a packet again: let the host send the held one */
+static void cdc_rx_release(void)
+{
+    if (true == s_bRxNaked) {
+        taskENTER_CRITICAL();
+        if ((true == s_bRxNaked) && (cdc_rx_free() >= CDC_PACKET_SIZE)) {
+            s_bRxNaked = false;
+            usbd_ep_nak_set(s_psUsbDev, CDC_EP_DATA_OUT, 0);
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+static inline uint16_t cdc_rx_free(void)
+{
+    return (uint16_t)(CDC_RX_BUFFER_SIZE - (uint16_t)(s_u16RxHead - s_u16RxTail));
+}
@@ -0,0 +1,85 @@
+#ifndef UART_ACCESS_PORT_H
+#define UART_ACCESS_PORT_H
+
+#include <stdint.h>
+#include "uart_access.h"
+
+/*
+    Between the output multiplexer (uart_access.cpp, shared) and the TX ring of a backend
+    (USART1, USB CDC, RTT, CAN, SPI, the PTY of the POSIX simulation). uart_write() and uart_putchar() belong to the multiplexer:
+
+    - the console (the task which reads the input) writes straight through, a run of free room
+      per critical section, and what it wrote since its last '\n' (the prompt, the echo of the
+      line in edition) is kept as its shadow
+    - every other task fills a line of its own (one of UART_MUX_SLOTS, taken for as long as a
+      line is in progress), committed at its '\n' in one critical section: the console line is
+      erased, the line written, the shadow replayed, so the line shows up above the prompt
+    - a line waits for room with no lock held (UART_TX_BLOCK), the console keeps the room it
+      needs free meanwhile; UART_TX_DROP drops it whole, UART_TX_OVERWRITE discards the oldest
+      bytes for it
+
+    - a telemetry frame (uart_channel_write()) goes in one critical section, anywhere in the
+      text, and never waits: no room for it whole, it is dropped and counted per channel
+
+    - an interrupt handler takes no critical section and never waits: its text is a record in
+      a ring of its own, reserved by a compare and swap (LDREX / STREX) on the head, so the
+      handlers of every priority and their nesting share it; the length byte stored last
+      commits it. A handler allowed the FromISR API queues the drain on the timer task
+      (xTimerPendFunctionCallFromISR, once until it ran), the records of the others wait for
+      it or for the next write of a task. The drain commits a record as a line and does not
+      wait for room: UART_TX_BLOCK drops it there, counted as by the console
+
+    The text never holds a 0x00, the frames are delimited by one on each side:
+
+        0x00  COBS( channel, seq, payload, CRC16 )  0x00
+
+    COBS (consistent overhead byte stuffing) takes the zeros out of the frame at one byte per
+    254; seq counts the frames of the channel (a gap is a dropped one), the CRC16 is the CCITT
+    one of checksum.h over channel, seq and payload, little endian. tools/chan_demux.py gives
+    the text back with the frames taken out. The binary output of a shell command (adc 1,
+    mread 2) has zeros of its own, it is for a session without the telemetry channels on.
+
+    The uart_port_tx_*() calls except uart_port_tx_early() and uart_port_tx_wait() are made in
+    a critical section.
+*/
+
+#define UART_MUX_SLOTS              (4U)    /* tasks with a line in progress at the same time */
+#define UART_MUX_LINE_SIZE          (80U)   /* a longer line is split */
+#define UART_MUX_SHADOW_SIZE        (160U)  /* the console line; longer, it is no more replayed */
+#define UART_MUX_ERASE              "\r\033[K"
+
+/* the largest commit: the erase, a line, its '\n', the shadow; every TX ring takes it at once */
+#define UART_MUX_COMMIT_MAX         (sizeof(UART_MUX_ERASE) - 1U + UART_MUX_LINE_SIZE + 1U + UART_MUX_SHADOW_SIZE)
+
+/* -- backend ----------------------------------------------------------------- */
+
+/* before the scheduler: sent directly, true; false when the ring takes it as in a task */
+bool uart_port_tx_early(const char *buf, int len);
+
+/* false while the output is discarded (no host on the USB port, no SWO) */
+bool uart_port_tx_open(void);
+
+/* bytes the ring takes now */
+uint32_t uart_port_tx_free(void);
+
+/* queue len bytes (at most uart_port_tx_free()) and start the transfer */
+void uart_port_tx_put(const char *buf, uint32_t len);
+
+/* UART_TX_OVERWRITE: the oldest len queued bytes make room, false if the backend can not */
+bool uart_port_tx_discard(uint32_t len);
+
+/* a task, outside of the critical section: let some of the queued output drain */
+void uart_port_tx_wait(void);
+
+void uart_port_tx_dropped(uint32_t len);
+uart_tx_policy_e uart_port_tx_policy(void);
+
+/* -- multiplexer ------------------------------------------------------------- */
+
+/* from uart_getchar(), uart_getline(), uart_read(): the calling task is the console */
+void uart_mux_reader(void);
+
+/* from uart_flush(): the line the calling task has in progress goes out */
+void uart_mux_flush(void);
+
+#endif /*UART_ACCESS_PORT_H*/
@@ -0,0 +1,490 @@
+#include "uart_access.h"
+#include "uart_access_port.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*
+ * PTY backend of uart_access, the console of the POSIX simulation (sources/sim_posix).
+ * Same interface as the USART1 backend, the uart_printf() family is shared.
+ *
+ *  - uart_setup() opens a pseudo terminal and prints the name of its slave on stderr
+ *    ("uart_access: console on /dev/pts/N"), a terminal program (picocom, screen) or a host
+ *    tool opens it as the serial port of the board; the slave is in raw mode
+ *  - output (shell -> terminal): queued in a ring as in the USART TX ring, written to the
+ *    master side with non blocking writes; what the terminal does not take yet stays queued,
+ *    so the TX policies behave as on the UART with a slow host
+ *  - input (terminal -> shell): non blocking reads of the master side into the RX buffer,
+ *    polled every PTY_POLL_MS (the tasks are threads of the port, a blocking read would keep
+ *    its thread from the scheduler); no RX hook, the ShellAO polls
+ *  - no terminal on the slave (never opened, or closed): the output is discarded as on a USB
+ *    port without a host, Enter after connecting brings the prompt
+ *
+ * A read or a write interrupted by the tick signal of the port (EINTR) is tried again at the
+ * next poll.
+ */
+
+/* ================================================
+            PTY configuration
+==================================================*/
+
+#define PTY_TX_RING_SIZE            (4096U)     /* a power of two */
+#define PTY_RX_BUFFER_SIZE          (256U)      /* a power of two */
+
+#define PTY_POLL_MS                 (1U)        /* input polling period, one tick at 1 kHz */
+#define PTY_FLUSH_STALL_MS          (100U)      /* flush gives up when the terminal stops reading */
+
+static_assert(PTY_TX_RING_SIZE > UART_MUX_COMMIT_MAX, "PTY_TX_RING_SIZE must take a line commit at once");
+static_assert(0U == (PTY_TX_RING_SIZE & (PTY_TX_RING_SIZE - 1U)), "PTY_TX_RING_SIZE must be a power of two");
+static_assert(0U == (PTY_RX_BUFFER_SIZE & (PTY_RX_BUFFER_SIZE - 1U)), "PTY_RX_BUFFER_SIZE must be a power of two");
+
+/* ================================================
+            private interfaces declaration
+==================================================*/
+
+static void pty_open(void);
+static void pty_drain(void);
+static void pty_rx_fill(void);
+static bool pty_rx_empty(void);
+static uint8_t pty_rx_take(void);
+static void pty_wait(void);
+static void pty_rx_wait(void);
+static void activity_add(uint32_t u32Step);
+static void activity_output(void);
+
+/* ================================================
+            private data
+==================================================*/
+
+static int s_iMaster = -1;
+
+static char s_vcTxRing[PTY_TX_RING_SIZE];
+static uint32_t s_u32TxHead = 0U;                      /* free running, masked on access */
+static uint32_t s_u32TxTail = 0U;
+
+static uint8_t s_vu8RxBuffer[PTY_RX_BUFFER_SIZE];
+static uint32_t s_u32RxHead = 0U;                      /* free running, both owned by the reading task */
+static uint32_t s_u32RxTail = 0U;
+
+static volatile uint32_t s_u32TxDropped = 0;
+static TaskHandle_t volatile s_xRxTask = nullptr;      /* task polling in uart_getchar() */
+static volatile uint32_t s_u32Activity = 0U;           /* uart_activity() */
+static volatile uart_tx_policy_e s_eTxPolicy = UART_TX_BLOCK;
+
+/* ================================================
+            public interfaces ddefinition
+==================================================*/
+
+
+/*--------------------------------------------------*/
+void uart_setup(void)
+{
+    pty_open();
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_getchar(void)
+{
+    uart_mux_reader();
+    pty_rx_fill();
+    while (pty_rx_empty()) {
+        pty_rx_wait();
+        pty_rx_fill();
+    }
+    return pty_rx_take();
+}
+
+
+
+/*--------------------------------------------------*/
+/* a pasted line usually arrives in one read; anything else (control keys, partial or too
+   long line) stays for uart_getchar() */
+int uart_getline(char *buf, int maxlen)
+{
+    uart_mux_reader();
+    pty_rx_fill();
+    while (pty_rx_empty()) {
+        pty_rx_wait();
+        pty_rx_fill();
+    }
+
+    uint32_t u32Idx = s_u32RxTail;
+    int consumed = 0;
+    int len = 0;
+
+    while (u32Idx != s_u32RxHead) {
+        const uint8_t c = s_vu8RxBuffer[u32Idx & (PTY_RX_BUFFER_SIZE - 1U)];
+        u32Idx++;
+        consumed++;
+        if ('\r' == c) {
+            buf[len] = '\0';
+            s_u32RxTail = u32Idx;
+            return consumed;
+        }
+        if ('\n' == c) {
+            continue;
+        }
+        if ((c < 0x20U) || (c > 0x7EU) || (len >= maxlen - 1)) {
+            break;
+        }
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* polled like uart_getchar(), the timeout counts in PTY_POLL_MS steps */
+int uart_read(uint8_t *buf, int len, uint32_t u32TimeoutMs)
+{
+    uint32_t u32Waited = 0U;
+    int done = 0;
+
+    uart_mux_reader();
+    while (done < len) {
+        pty_rx_fill();
+        if (pty_rx_empty()) {
+            if (u32Waited >= u32TimeoutMs) {
+                break;
+            }
+            pty_rx_wait();
+            u32Waited += PTY_POLL_MS;
+            continue;
+        }
+        while (!pty_rx_empty() && (done < len)) {
+            buf[done++] = pty_rx_take();
+        }
+        u32Waited = 0U;
+    }
+    return done;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_tx_set_policy(uart_tx_policy_e ePolicy)
+{
+    s_eTxPolicy = ePolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_tx_dropped(void)
+{
+    return s_u32TxDropped;
+}
+
+
+
+/*--------------------------------------------------*/
+/* no RX interrupt: the reader polls the master side */
+int uart_rx_set_hook(uart_rx_hook_t pfHook)
+{
+    (void)pfHook;
+    return -1;
+}
+
+
+
+/*--------------------------------------------------*/
+const volatile uint32_t *uart_activity(void)
+{
+    return &s_u32Activity;
+}
+
+
+
+/*--------------------------------------------------*/
+/* wait until the terminal took everything written so far, or stopped reading */
+void uart_flush(void)
+{
+    uart_mux_flush();
+
+    uint32_t u32Tail = s_u32TxTail;
+    uint32_t u32Stall = 0U;
+
+    while ((s_u32TxHead != s_u32TxTail) && (u32Stall < PTY_FLUSH_STALL_MS)) {
+        pty_wait();
+        if (u32Tail == s_u32TxTail) {
+            u32Stall += PTY_POLL_MS;
+        } else {
+            u32Tail = s_u32TxTail;
+            u32Stall = 0U;
+        }
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_tx_busy(void)
+{
+    return (s_u32TxHead != s_u32TxTail) ? 1 : 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the pseudo terminal has no baud rate */
+int uart_set_baudrate(uint32_t u32Baud)
+{
+    (void)u32Baud;
+    return -1;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_get_baudrate(void)
+{
+    return 0U;
+}
+
+
+
+/*--------------------------------------------------*/
+/* shell command, same table entry as the USART backend */
+extern "C" int baud(uint32_t u32Baud)
+{
+    (void)u32Baud;
+    uart_printf("baud: no baud rate on a PTY\r\n");
+    return 0xFF;
+}
+
+
+/* ================================================
+            private interfaces definition
+==================================================*/
+
+
+/*--------------------------------------------------*/
+/* the slave is opened once for its raw mode and closed: the master sees a hang up until a
+   terminal opens it, the output is discarded until then */
+static void pty_open(void)
+{
+    s_iMaster = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if ((s_iMaster < 0) || (0 != grantpt(s_iMaster)) || (0 != unlockpt(s_iMaster))) {
+        fprintf(stderr, "uart_access: no pseudo terminal (%s)\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    const char *pstrSlave = ptsname(s_iMaster);
+    const int iSlave = open(pstrSlave, O_RDWR | O_NOCTTY);
+    if (iSlave >= 0) {
+        struct termios sTio;
+        if (0 == tcgetattr(iSlave, &sTio)) {
+            cfmakeraw(&sTio);
+            (void)tcsetattr(iSlave, TCSANOW, &sTio);
+        }
+        (void)close(iSlave);
+    }
+    fprintf(stderr, "uart_access: console on %s\n", pstrSlave);
+}
+
+
+
+/*--------------------------------------------------*/
+/* as much of the ring as the master takes now, in a critical section (the writers move the
+   head in one); the ring is emptied when the terminal is gone */
+static void pty_drain(void)
+{
+    while (s_u32TxHead != s_u32TxTail) {
+        const uint32_t u32Tail = s_u32TxTail & (PTY_TX_RING_SIZE - 1U);
+        const uint32_t u32Used = s_u32TxHead - s_u32TxTail;
+        const uint32_t u32Run = (u32Used < PTY_TX_RING_SIZE - u32Tail) ? u32Used : (PTY_TX_RING_SIZE - u32Tail);
+
+        const ssize_t iDone = write(s_iMaster, &s_vcTxRing[u32Tail], u32Run);
+        if (iDone > 0) {
+            s_u32TxTail += (uint32_t)iDone;
+            continue;
+        }
+        if ((iDone < 0) && ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno))) {
+            return;
+        }
+        s_u32TxDropped = s_u32TxDropped + u32Used;
+        s_u32TxTail = s_u32TxHead;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* what arrived, as much as the buffer takes; nothing on EAGAIN, EINTR or EIO (no terminal) */
+static void pty_rx_fill(void)
+{
+    while ((s_u32RxHead - s_u32RxTail) < PTY_RX_BUFFER_SIZE) {
+        const uint32_t u32Head = s_u32RxHead & (PTY_RX_BUFFER_SIZE - 1U);
+        const uint32_t u32Free = PTY_RX_BUFFER_SIZE - (s_u32RxHead - s_u32RxTail);
+        const uint32_t u32Run = (u32Free < PTY_RX_BUFFER_SIZE - u32Head) ? u32Free : (PTY_RX_BUFFER_SIZE - u32Head);
+
+        const ssize_t iDone = read(s_iMaster, &s_vu8RxBuffer[u32Head], u32Run);
+        if (iDone <= 0) {
+            return;
+        }
+        s_u32RxHead += (uint32_t)iDone;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+static bool pty_rx_empty(void)
+{
+    return s_u32RxHead == s_u32RxTail;
+}
+
+
+
+/*--------------------------------------------------*/
+static uint8_t pty_rx_take(void)
+{
+    return s_vu8RxBuffer[(s_u32RxTail++) & (PTY_RX_BUFFER_SIZE - 1U)];
+}
+
+
+
+/*--------------------------------------------------*/
+/* nothing signals the room on the master side: poll, without a scheduler just retry */
+static void pty_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        vTaskDelay(pdMS_TO_TICKS(PTY_POLL_MS));
+    }
+    taskENTER_CRITICAL();
+    pty_drain();
+    taskEXIT_CRITICAL();
+}
+
+
+
+/*--------------------------------------------------*/
+/* a poll for input: the reader waits (odd activity) through the delay, the output left by a
+   full master side goes out meanwhile */
+static void pty_rx_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        s_xRxTask = xTaskGetCurrentTaskHandle();
+        activity_add(1U);
+        vTaskDelay(pdMS_TO_TICKS(PTY_POLL_MS));
+        activity_add(1U);
+    }
+    taskENTER_CRITICAL();
+    pty_drain();
+    taskEXIT_CRITICAL();
+}
+
+
+
+/*--------------------------------------------------*/
+/* tasks and the reader itself: atomic, a lost step would flip the waiting parity */
+static void activity_add(uint32_t u32Step)
+{
+    __atomic_fetch_add(&s_u32Activity, u32Step, __ATOMIC_RELAXED);
+}
+
+
+
+/*--------------------------------------------------*/
+static void activity_output(void)
+{
+    if (xTaskGetCurrentTaskHandle() == s_xRxTask) {
+        activity_add(2U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* the ring takes the output before the scheduler as in a task */
+bool uart_port_tx_early(const char *buf, int len)
+{
+    (void)buf;
+    (void)len;
+    return false;
+}
+
+
+
+/*--------------------------------------------------*/
+/* no terminal on the slave: the master reports a hang up, waiting would never end */
+bool uart_port_tx_open(void)
+{
+    struct pollfd sPoll = { s_iMaster, POLLOUT, 0 };
+    return (poll(&sPoll, 1, 0) >= 0) && (0 == (sPoll.revents & POLLHUP));
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_port_tx_free(void)
+{
+    return PTY_TX_RING_SIZE - (s_u32TxHead - s_u32TxTail);
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_put(const char *buf, uint32_t len)
+{
+    const uint32_t u32Head = s_u32TxHead & (PTY_TX_RING_SIZE - 1U);
+
+    /* at most two copies: up to the end of the ring, then from its start */
+    const uint32_t u32First = (len < PTY_TX_RING_SIZE - u32Head) ? len : (PTY_TX_RING_SIZE - u32Head);
+    memcpy(&s_vcTxRing[u32Head], buf, u32First);
+    memcpy(&s_vcTxRing[0], &buf[u32First], len - u32First);
+    s_u32TxHead += len;
+    pty_drain();
+    activity_output();
+}
+
+
+
+/*--------------------------------------------------*/
+/* the queued bytes are still ours: the oldest make room */
+bool uart_port_tx_discard(uint32_t len)
+{
+    if (len > (s_u32TxHead - s_u32TxTail)) {
+        return false;
+    }
+    s_u32TxTail += len;
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_wait(void)
+{
+    pty_wait();
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_dropped(uint32_t len)
+{
+    s_u32TxDropped = s_u32TxDropped + len;
+}
+
+
+
+/*--------------------------------------------------*/
+uart_tx_policy_e uart_port_tx_policy(void)
+{
+    return s_eTxPolicy;
+}
@@ -0,0 +1,496 @@
+#include "uart_access.h"
+#include "uart_access_port.h"
+#include "libopencm3/cm3/sync.h"
+#if defined(UART_ACCESS_RTT_SWO)
+#include "libopencm3/cm3/memorymap.h"
+#include "libopencm3/cm3/itm.h"
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
+
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * SEGGER RTT backend of uart_access (debug probe, no pins, no peripheral).
+ * Same interface as the USART1 backend, the uart_printf() family is shared.
+ *
+ *  - the control block _SEGGER_RTT lives in RAM, the probe finds it by its
+ *    "SEGGER RTT" id (J-Link) or by the symbol (OpenOCD, probe-rs)
+ *  - output (shell -> host): copied into the up-buffer 0, a memcpy, the probe
+ *    drains it in the background; with UART_ACCESS_RTT_SWO the output goes to
+ *    the ITM stimulus port 0 (SWO pin) instead
+ *  - input (host -> shell): read from the down-buffer 0, polled every
+ *    RTT_POLL_MS because the probe raises no interrupt
+ *  - the default TX policy is UART_TX_DROP: without a probe attached nobody
+ *    drains the buffer and a blocked writer would freeze the shell
+ *
+ * The read offset of the up-buffer belongs to the probe, so UART_TX_OVERWRITE
+ * can not discard the oldest bytes and drops the new ones like UART_TX_DROP.
+ */
+
+/* ================================================
+            RTT configuration
+==================================================*/
+
+#define RTT_UP_BUFFER_SIZE          (1024U)
+#define RTT_DOWN_BUFFER_SIZE        (64U)
+
+#define RTT_MODE_NO_BLOCK_SKIP      (0U)    /* flags seen by the probe */
+#define RTT_MODE_BLOCK_IF_FULL      (2U)
+
+#define RTT_POLL_MS                 (1U)    /* down-buffer polling period, one tick at 1 kHz */
+#define RTT_FLUSH_STALL_MS          (100U)  /* flush gives up when the probe stops reading */
+
+#define RTT_ITM_PORT                (0U)
+
+static_assert(RTT_UP_BUFFER_SIZE > UART_MUX_COMMIT_MAX, "RTT_UP_BUFFER_SIZE must take a line commit at once");
+
+/* ================================================
+            RTT control block
+==================================================*/
+
+/* layout defined by SEGGER, read and written by the probe */
+typedef struct {
+    const char *pcName;
+    char *pcBuffer;
+    uint32_t u32Size;
+    volatile uint32_t u32WrOff;
+    volatile uint32_t u32RdOff;
+    uint32_t u32Flags;
+} rtt_buffer_s;
+
+typedef struct {
+    char acID[16];
+    int32_t i32MaxNumUpBuffers;
+    int32_t i32MaxNumDownBuffers;
+    rtt_buffer_s sUp;
+    rtt_buffer_s sDown;
+} rtt_control_block_s;
+
+/* the name is the one the probe tools look for */
+extern "C" {
+rtt_control_block_s _SEGGER_RTT;
+}
+
+/* ================================================
+            private interfaces declaration
+==================================================*/
+
+static void rtt_init(void);
+static void rtt_wait(void);
+static void rtt_rx_wait(void);
+static void activity_add(uint32_t u32Step);
+static void activity_output(void);
+#if defined(UART_ACCESS_RTT_SWO)
+static bool rtt_swo_enabled(void);
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
+
+/* ================================================
+            private data
+==================================================*/
+
+static char s_vcUpBuffer[RTT_UP_BUFFER_SIZE];
+static char s_vcDownBuffer[RTT_DOWN_BUFFER_SIZE];
+
+static volatile uint32_t s_u32TxDropped = 0;
+static TaskHandle_t volatile s_xRxTask = nullptr;      /* task polling in uart_getchar() */
+static volatile uint32_t s_u32Activity = 0U;           /* uart_activity() */
+static volatile uart_tx_policy_e s_eTxPolicy = UART_TX_DROP;
+
+/* ================================================
+            public interfaces ddefinition
+==================================================*/
+
+
+/*--------------------------------------------------*/
+void uart_setup(void)
+{
+    rtt_init();
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_getchar(void)
+{
+    rtt_buffer_s *psDown = &_SEGGER_RTT.sDown;
+
+    uart_mux_reader();
+    while (psDown->u32RdOff == psDown->u32WrOff) {
+        rtt_rx_wait();
+    }
+    uint32_t u32RdOff = psDown->u32RdOff;
+    const uint8_t c = (uint8_t)psDown->pcBuffer[u32RdOff];
+    u32RdOff = u32RdOff + 1U;
+    psDown->u32RdOff = (u32RdOff < psDown->u32Size) ? u32RdOff : 0U;
+    return c;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the probe writes what the host sent at once, so a pasted line is usually complete here;
+   anything else (control keys, partial or too long line) stays for uart_getchar() */
+int uart_getline(char *buf, int maxlen)
+{
+    rtt_buffer_s *psDown = &_SEGGER_RTT.sDown;
+
+    uart_mux_reader();
+    while (psDown->u32RdOff == psDown->u32WrOff) {
+        rtt_rx_wait();
+    }
+
+    const uint32_t u32WrOff = psDown->u32WrOff;
+    uint32_t u32Idx = psDown->u32RdOff;
+    int consumed = 0;
+    int len = 0;
+
+    while (u32Idx != u32WrOff) {
+        const uint8_t c = (uint8_t)psDown->pcBuffer[u32Idx];
+        u32Idx = (u32Idx + 1U < psDown->u32Size) ? (u32Idx + 1U) : 0U;
+        consumed++;
+        if ('\r' == c) {
+            buf[len] = '\0';
+            psDown->u32RdOff = u32Idx;
+            return consumed;
+        }
+        if ('\n' == c) {
+            continue;
+        }
+        if ((c < 0x20U) || (c > 0x7EU) || (len >= maxlen - 1)) {
+            break;
+        }
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* polled like uart_getchar(), the timeout counts in RTT_POLL_MS steps */
+int uart_read(uint8_t *buf, int len, uint32_t u32TimeoutMs)
+{
+    rtt_buffer_s *psDown = &_SEGGER_RTT.sDown;
+    uint32_t u32Waited = 0U;
+    int done = 0;
+
+    uart_mux_reader();
+    while (done < len) {
+        if (psDown->u32RdOff == psDown->u32WrOff) {
+            if (u32Waited >= u32TimeoutMs) {
+                break;
+            }
+            rtt_rx_wait();
+            u32Waited += RTT_POLL_MS;
+            continue;
+        }
+        uint32_t u32RdOff = psDown->u32RdOff;
+        while ((u32RdOff != psDown->u32WrOff) && (done < len)) {
+            buf[done++] = (uint8_t)psDown->pcBuffer[u32RdOff];
+            u32RdOff = (u32RdOff + 1U < psDown->u32Size) ? (u32RdOff + 1U) : 0U;
+        }
+        psDown->u32RdOff = u32RdOff;
+        u32Waited = 0U;
+    }
+    return done;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_tx_set_policy(uart_tx_policy_e ePolicy)
+{
+    s_eTxPolicy = ePolicy;
+    _SEGGER_RTT.sUp.u32Flags = (UART_TX_BLOCK == ePolicy) ? RTT_MODE_BLOCK_IF_FULL : RTT_MODE_NO_BLOCK_SKIP;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_tx_dropped(void)
+{
+    return s_u32TxDropped;
+}
+
+
+
+/*--------------------------------------------------*/
+/* no RX interrupt: the reader polls the down buffer */
+int uart_rx_set_hook(uart_rx_hook_t pfHook)
+{
+    (void)pfHook;
+    return -1;
+}
+
+
+
+/*--------------------------------------------------*/
+const volatile uint32_t *uart_activity(void)
+{
+    return &s_u32Activity;
+}
+
+
+
+/*--------------------------------------------------*/
+/* wait until the probe took everything written so far, or stopped reading */
+void uart_flush(void)
+{
+    uart_mux_flush();
+#if defined(UART_ACCESS_RTT_SWO)
+    while (0U != (ITM_TCR & ITM_TCR_BUSY)) {
+    }
+#else
+    const rtt_buffer_s *psUp = &_SEGGER_RTT.sUp;
+    uint32_t u32RdOff = psUp->u32RdOff;
+    uint32_t u32Stall = 0U;
+
+    while ((psUp->u32RdOff != psUp->u32WrOff) && (u32Stall < RTT_FLUSH_STALL_MS)) {
+        rtt_wait();
+        if (u32RdOff == psUp->u32RdOff) {
+            u32Stall += RTT_POLL_MS;
+        } else {
+            u32RdOff = psUp->u32RdOff;
+            u32Stall = 0U;
+        }
+    }
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
+}
+
+
+
+/*--------------------------------------------------*/
+/* the RTT ring stays in RAM, only a SWO transfer can be cut off */
+int uart_tx_busy(void)
+{
+#if defined(UART_ACCESS_RTT_SWO)
+    return (0U != (ITM_TCR & ITM_TCR_BUSY)) ? 1 : 0;
+#else
+    return 0;
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
+}
+
+
+
+/*--------------------------------------------------*/
+/* the probe link has no baud rate */
+int uart_set_baudrate(uint32_t u32Baud)
+{
+    (void)u32Baud;
+    return -1;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_get_baudrate(void)
+{
+    return 0U;
+}
+
+
+
+/*--------------------------------------------------*/
+/* shell command, same table entry as the USART backend */
+extern "C" int baud(uint32_t u32Baud)
+{
+    (void)u32Baud;
+    uart_printf("baud: no baud rate on RTT\r\n");
+    return 0xFF;
+}
+
+
+/* ================================================
+            private interfaces definition
+==================================================*/
+
+
+/*--------------------------------------------------*/
+/* the id is written last and in two steps, so the probe never finds a half built
+   block and no complete copy of it sits in the flash image */
+static void rtt_init(void)
+{
+    rtt_control_block_s *psCb = &_SEGGER_RTT;
+
+    psCb->i32MaxNumUpBuffers   = 1;
+    psCb->i32MaxNumDownBuffers = 1;
+
+    psCb->sUp.pcName   = "Terminal";
+    psCb->sUp.pcBuffer = s_vcUpBuffer;
+    psCb->sUp.u32Size  = RTT_UP_BUFFER_SIZE;
+    psCb->sUp.u32WrOff = 0U;
+    psCb->sUp.u32RdOff = 0U;
+    psCb->sUp.u32Flags = (UART_TX_BLOCK == s_eTxPolicy) ? RTT_MODE_BLOCK_IF_FULL : RTT_MODE_NO_BLOCK_SKIP;
+
+    psCb->sDown.pcName   = "Terminal";
+    psCb->sDown.pcBuffer = s_vcDownBuffer;
+    psCb->sDown.u32Size  = RTT_DOWN_BUFFER_SIZE;
+    psCb->sDown.u32WrOff = 0U;
+    psCb->sDown.u32RdOff = 0U;
+    psCb->sDown.u32Flags = RTT_MODE_NO_BLOCK_SKIP;
+
+    memcpy(&psCb->acID[7], "RTT", 4);
+    __dmb();
+    memcpy(&psCb->acID[0], "SEGGER ", 7);
+    __dmb();
+}
+
+
+
+/*--------------------------------------------------*/
+/* nothing signals the probe activity: poll, without a scheduler just spin */
+static void rtt_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        vTaskDelay(pdMS_TO_TICKS(RTT_POLL_MS));
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* a poll for input: the reader waits (odd activity) through the delay */
+static void rtt_rx_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        s_xRxTask = xTaskGetCurrentTaskHandle();
+        activity_add(1U);
+        vTaskDelay(pdMS_TO_TICKS(RTT_POLL_MS));
+        activity_add(1U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* tasks and the reader itself: atomic, a lost step would flip the waiting parity */
+static void activity_add(uint32_t u32Step)
+{
+    __atomic_fetch_add(&s_u32Activity, u32Step, __ATOMIC_RELAXED);
+}
+
+
+
+/*--------------------------------------------------*/
+static void activity_output(void)
+{
+    if (xTaskGetCurrentTaskHandle() == s_xRxTask) {
+        activity_add(2U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* the probe attached, nothing before the scheduler differs */
+bool uart_port_tx_early(const char *buf, int len)
+{
+    (void)buf;
+    (void)len;
+    return false;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a port not enabled by the debugger discards, waiting would never end */
+bool uart_port_tx_open(void)
+{
+#if defined(UART_ACCESS_RTT_SWO)
+    return rtt_swo_enabled();
+#else
+    return true;
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
+}
+
+
+
+/*--------------------------------------------------*/
+/* SWO: a commit as soon as the stimulus FIFO takes a byte, uart_port_tx_put() waits for the
+   rest (the port clock, not the probe, sets the pace) */
+uint32_t uart_port_tx_free(void)
+{
+#if defined(UART_ACCESS_RTT_SWO)
+    return (0U != (ITM_STIM32(RTT_ITM_PORT) & ITM_STIM_FIFOREADY)) ? (uint32_t)UART_MUX_COMMIT_MAX : 0U;
+#else
+    const rtt_buffer_s *psUp = &_SEGGER_RTT.sUp;
+    const uint32_t u32RdOff = psUp->u32RdOff;
+    const uint32_t u32WrOff = psUp->u32WrOff;
+    return (u32RdOff > u32WrOff) ? (u32RdOff - u32WrOff - 1U) : (psUp->u32Size - u32WrOff + u32RdOff - 1U);
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_put(const char *buf, uint32_t len)
+{
+#if defined(UART_ACCESS_RTT_SWO)
+    for (uint32_t i = 0; i < len; ++i) {
+        while (0U == (ITM_STIM32(RTT_ITM_PORT) & ITM_STIM_FIFOREADY)) {
+        }
+        ITM_STIM8(RTT_ITM_PORT) = (uint8_t)buf[i];
+    }
+#else
+    rtt_buffer_s *psUp = &_SEGGER_RTT.sUp;
+    uint32_t u32WrOff = psUp->u32WrOff;
+
+    /* at most two copies: up to the end of the buffer, then from its start */
+    const uint32_t u32First = (len < psUp->u32Size - u32WrOff) ? len : (psUp->u32Size - u32WrOff);
+    memcpy(&psUp->pcBuffer[u32WrOff], buf, u32First);
+    memcpy(&psUp->pcBuffer[0], &buf[u32First], len - u32First);
+    u32WrOff = u32WrOff + len;
+    __dmb(); /* the data is visible before the probe sees the new offset */
+    psUp->u32WrOff = (u32WrOff < psUp->u32Size) ? u32WrOff : (u32WrOff - psUp->u32Size);
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
+    activity_output();
+}
+
+
+
+/*--------------------------------------------------*/
+/* the read offset belongs to the probe: UART_TX_OVERWRITE drops like UART_TX_DROP */
+bool uart_port_tx_discard(uint32_t len)
+{
+    (void)len;
+    return false;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_wait(void)
+{
+    rtt_wait();
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_dropped(uint32_t len)
+{
+    s_u32TxDropped = s_u32TxDropped + len;
+}
+
+
+
+/*--------------------------------------------------*/
+uart_tx_policy_e uart_port_tx_policy(void)
+{
+    return s_eTxPolicy;
+}
+
+
+
+#if defined(UART_ACCESS_RTT_SWO)
+/*--------------------------------------------------*/
+/* the trace and the stimulus port enabled by the debugger */
+static bool rtt_swo_enabled(void)
+{
+    return (0U != (ITM_TCR & ITM_TCR_ITMENA)) && (0U != (ITM_TER[0] & (1U << RTT_ITM_PORT)));
+}
+#endif /*defined(UART_ACCESS_RTT_SWO)*/
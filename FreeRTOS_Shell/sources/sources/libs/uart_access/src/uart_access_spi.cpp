@@ -0,0 +1,741 @@
+#include "uart_access.h"
+#include "uart_access_port.h"
+#include "isr_prof.h"
+#include "probe.h"
+#include "libopencm3/stm32/rcc.h"
+#include "libopencm3/stm32/gpio.h"
+#include "libopencm3/stm32/spi.h"
+#include "libopencm3/stm32/dma.h"
+#include "libopencm3/cm3/nvic.h"
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <timers.h>
+
+#include <stdint.h>
+
+/*
+ * SPI slave backend of uart_access, for a host processor on the board which drives the shell
+ * (SPI2: PB12 NSS, PB13 SCK, PB14 MISO, PB15 MOSI; PB10 the data ready line). Same interface
+ * as the USART1 backend, the uart_printf() family is shared. Mode 0, 8 bit, MSB first, the
+ * host clocks frames of SPI_FRAME_SIZE bytes, one per NSS assertion, full duplex:
+ *
+ *      MOSI    len (0 .. SPI_FRAME_DATA)        len bytes of input        filler
+ *      MISO    len | MORE | BUSY                len bytes of output       filler
+ *
+ *      MORE    more output is queued after this frame
+ *      BUSY    the RX ring had no room for a frame: the input of this frame is not taken, the
+ *              host sends it again
+ *
+ *  - both directions are DMA transfers of a whole frame; the end of the RX one (the frame is
+ *    in) takes the input into the RX ring, then arms the next frame with the oldest output of
+ *    the TX ring. The host leaves a few microseconds between frames for it (SPI_FRAME_GAP_US)
+ *  - data ready is high while output is queued: the host clocks frames until it falls. Output
+ *    which arrives while an empty frame is armed goes in the frame after it (the first byte of
+ *    a frame is in the SPI data register from the arming on), so the host sees an empty frame
+ *    first now and then
+ *  - the output of a frame leaves the TX ring once the frame is complete; a frame the host cut
+ *    short (NSS up before its end) is found by a check SPI_RESYNC_MS after the last complete
+ *    frame, the SPI is reset and the frame armed again: the output is sent again, the frame
+ *    after the cut one may be lost (counted as an error)
+ *  - until the host clocks a first frame the output is discarded and counted, nobody would
+ *    take it; no frame for SPI_HOST_TIMEOUT_MS while output waits closes the port again
+ *
+ * SCK up to the APB1 clock / 2 (18 MHz on the STM32F103, 25 MHz on the STM32F411 at 100 MHz).
+ * The DMA requests of SPI2 are the ones of USART1 on the STM32F103 (DMA1 channels 4 and 5),
+ * free with this backend; the STM32F411 has them on DMA1 streams 3 and 4. MISO is driven while
+ * NSS is up, the port takes no other slave on its bus. A host on Linux: tools/spi_shell.py.
+ */
+
+/* ================================================
+            SPI configuration
+==================================================*/
+
+#define SPI_PORT                    SPI2
+#define SPI_RCC                     RCC_SPI2
+#define SPI_RST                     RST_SPI2
+
+#define SPI_GPIO_PORT               GPIOB
+#define SPI_GPIO_RCC                RCC_GPIOB
+#define SPI_NSS_PIN                 GPIO12
+#define SPI_SCK_PIN                 GPIO13
+#define SPI_MISO_PIN                GPIO14
+#define SPI_MOSI_PIN                GPIO15
+#define SPI_DRDY_PIN                GPIO10      /* high: output queued */
+
+/* SPI2_RX / SPI2_TX requests: DMA1 channels 4 / 5 (F1), DMA1 streams 3 / 4 channel 0 (F4) */
+#if defined(STM32F1)
+#define SPI_DMA                     DMA1
+#define SPI_RX_DMA_CH               DMA_CHANNEL4
+#define SPI_TX_DMA_CH               DMA_CHANNEL5
+#define SPI_DMA_RCC                 RCC_DMA1
+#define SPI_RX_DMA_IRQ              NVIC_DMA1_CHANNEL4_IRQ
+#define SPI_RX_DMA_ISR              dma1_channel4_isr
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+#define SPI_DMA                     DMA1
+#define SPI_RX_DMA_CH               DMA_STREAM3
+#define SPI_TX_DMA_CH               DMA_STREAM4
+#define SPI_DMA_RCC                 RCC_DMA1
+#define SPI_RX_DMA_IRQ              NVIC_DMA1_STREAM3_IRQ
+#define SPI_RX_DMA_ISR              dma1_stream3_isr
+#endif /*defined(STM32F4)*/
+
+#define SPI_FRAME_SIZE              (32U)    /* bytes per NSS assertion, the header in front */
+#define SPI_FRAME_DATA              (SPI_FRAME_SIZE - 1U)
+#define SPI_FRAME_GAP_US            (10U)    /* NSS up between frames at least, the re-arming */
+
+#define SPI_HDR_LEN_MASK            (0x3FU)
+#define SPI_HDR_BUSY                (0x40U)
+#define SPI_HDR_MORE                (0x80U)
+
+#define SPI_RX_BUFFER_SIZE          (256U)   /* power of 2 */
+#define SPI_TX_BUFFER_SIZE          (512U)   /* power of 2 */
+
+#define SPI_RESYNC_MS               (20U)    /* after the last complete frame, a cut one is looked for */
+#define SPI_HOST_TIMEOUT_MS         (1000U)  /* no frame while output waits: the port is closed */
+
+/* must be allowed to call the FreeRTOS FromISR API */
+#define SPI_IRQ_PRIORITY            ((configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1) << (8 - configPRIO_BITS))
+
+#define SPI_BAUD_CMD_ERR            (0xFFU)
+
+static_assert(0U == (SPI_RX_BUFFER_SIZE & (SPI_RX_BUFFER_SIZE - 1U)), "SPI_RX_BUFFER_SIZE must be a power of 2");
+static_assert(0U == (SPI_TX_BUFFER_SIZE & (SPI_TX_BUFFER_SIZE - 1U)), "SPI_TX_BUFFER_SIZE must be a power of 2");
+static_assert(SPI_TX_BUFFER_SIZE >= UART_MUX_COMMIT_MAX, "SPI_TX_BUFFER_SIZE must take a line commit at once");
+static_assert(SPI_RX_BUFFER_SIZE > SPI_FRAME_DATA, "SPI_RX_BUFFER_SIZE must take a frame");
+static_assert((SPI_FRAME_SIZE >= 2U) && (SPI_FRAME_DATA <= SPI_HDR_LEN_MASK), "SPI_FRAME_SIZE must fit the length of the header");
+
+/* ================================================
+            private interfaces declaration
+==================================================*/
+
+static void spi_restart(void);
+static void spi_frame_arm(void);
+static void spi_frame_done(void);
+static void spi_close(void);
+static void spi_resync_cb(TimerHandle_t xTimer);
+static void spi_rx_wait(void);
+static bool spi_rx_wait_for(uint32_t u32Ms);
+static void activity_add(uint32_t u32Step);
+static void activity_output(void);
+static inline uint16_t spi_rx_free(void);
+
+/* ================================================
+            private data
+==================================================*/
+
+static volatile bool s_bPortOpen = false;              /* the host clocked a frame */
+
+static uint8_t s_vu8RxFrame[SPI_FRAME_SIZE];           /* the DMA targets */
+static uint8_t s_vu8TxFrame[SPI_FRAME_SIZE];
+static uint8_t s_u8TxInFlight = 0U;                    /* bytes of the ring in the armed frame */
+static bool s_bRxTake = false;                         /* the armed frame: its input fits the ring */
+
+static uint8_t s_vu8RxBuffer[SPI_RX_BUFFER_SIZE];
+static volatile uint16_t s_u16RxHead = 0;              /* free running, written by the RX ISR */
+static volatile uint16_t s_u16RxTail = 0;              /* free running, owned by the reading task */
+static TaskHandle_t volatile s_xRxTask = nullptr;      /* task blocked in uart_getchar() */
+static volatile uart_rx_hook_t s_pfRxHook = nullptr;   /* uart_rx_set_hook() */
+static volatile uint32_t s_u32Activity = 0U;           /* uart_activity() */
+
+static uint8_t s_vu8TxBuffer[SPI_TX_BUFFER_SIZE];
+static volatile uint16_t s_u16TxHead = 0;              /* free running, masked on access */
+static volatile uint16_t s_u16TxTail = 0;
+static volatile uint32_t s_u32TxDropped = 0;
+static volatile uart_tx_policy_e s_eTxPolicy = UART_TX_BLOCK;
+static volatile TickType_t s_xLastFrame = 0;
+
+static TimerHandle_t s_hResync = nullptr;
+static StaticTimer_t s_sResyncTimer;
+static volatile bool s_bResyncArmed = false;           /* one timer command per SPI_RESYNC_MS */
+
+/* baud 0 */
+static volatile uint32_t s_u32Frames = 0U;
+static volatile uint32_t s_u32RxBytes = 0U;
+static volatile uint32_t s_u32TxBytes = 0U;
+static volatile uint32_t s_u32Busy = 0U;               /* frames answered BUSY, the ring was full */
+static volatile uint32_t s_u32Errors = 0U;             /* bad headers, overruns, cut frames */
+
+/* ================================================
+            public interfaces definition
+==================================================*/
+
+/*--------------------------------------------------*/
+void uart_setup(void)
+{
+    rcc_periph_clock_enable(SPI_GPIO_RCC);
+    rcc_periph_clock_enable(SPI_RCC);
+    rcc_periph_clock_enable(SPI_DMA_RCC);
+
+#if defined(STM32F1)
+    /* NSS pulled up (no host: deselected), SCK and MOSI inputs, MISO the alternate function */
+    gpio_set_mode(SPI_GPIO_PORT, GPIO_MODE_INPUT, GPIO_CNF_INPUT_PULL_UPDOWN, SPI_NSS_PIN);
+    gpio_set(SPI_GPIO_PORT, SPI_NSS_PIN);
+    gpio_set_mode(SPI_GPIO_PORT, GPIO_MODE_INPUT, GPIO_CNF_INPUT_FLOAT, SPI_SCK_PIN | SPI_MOSI_PIN);
+    gpio_set_mode(SPI_GPIO_PORT, GPIO_MODE_OUTPUT_50_MHZ, GPIO_CNF_OUTPUT_ALTFN_PUSHPULL, SPI_MISO_PIN);
+    gpio_clear(SPI_GPIO_PORT, SPI_DRDY_PIN);
+    gpio_set_mode(SPI_GPIO_PORT, GPIO_MODE_OUTPUT_2_MHZ, GPIO_CNF_OUTPUT_PUSHPULL, SPI_DRDY_PIN);
+
+    dma_channel_reset(SPI_DMA, SPI_RX_DMA_CH);
+    dma_set_read_from_peripheral(SPI_DMA, SPI_RX_DMA_CH);
+    dma_set_peripheral_size(SPI_DMA, SPI_RX_DMA_CH, DMA_CCR_PSIZE_8BIT);
+    dma_set_memory_size(SPI_DMA, SPI_RX_DMA_CH, DMA_CCR_MSIZE_8BIT);
+    dma_channel_reset(SPI_DMA, SPI_TX_DMA_CH);
+    dma_set_read_from_memory(SPI_DMA, SPI_TX_DMA_CH);
+    dma_set_peripheral_size(SPI_DMA, SPI_TX_DMA_CH, DMA_CCR_PSIZE_8BIT);
+    dma_set_memory_size(SPI_DMA, SPI_TX_DMA_CH, DMA_CCR_MSIZE_8BIT);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    gpio_mode_setup(SPI_GPIO_PORT, GPIO_MODE_AF, GPIO_PUPD_PULLUP, SPI_NSS_PIN);
+    gpio_mode_setup(SPI_GPIO_PORT, GPIO_MODE_AF, GPIO_PUPD_NONE, SPI_SCK_PIN | SPI_MISO_PIN | SPI_MOSI_PIN);
+    gpio_set_output_options(SPI_GPIO_PORT, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, SPI_MISO_PIN);
+    gpio_set_af(SPI_GPIO_PORT, GPIO_AF5, SPI_NSS_PIN | SPI_SCK_PIN | SPI_MISO_PIN | SPI_MOSI_PIN);
+    gpio_clear(SPI_GPIO_PORT, SPI_DRDY_PIN);
+    gpio_mode_setup(SPI_GPIO_PORT, GPIO_MODE_OUTPUT, GPIO_PUPD_NONE, SPI_DRDY_PIN);
+    gpio_set_output_options(SPI_GPIO_PORT, GPIO_OTYPE_PP, GPIO_OSPEED_2MHZ, SPI_DRDY_PIN);
+
+    dma_stream_reset(SPI_DMA, SPI_RX_DMA_CH);
+    dma_channel_select(SPI_DMA, SPI_RX_DMA_CH, DMA_SxCR_CHSEL_0);
+    dma_set_transfer_mode(SPI_DMA, SPI_RX_DMA_CH, DMA_SxCR_DIR_PERIPHERAL_TO_MEM);
+    dma_set_peripheral_size(SPI_DMA, SPI_RX_DMA_CH, DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(SPI_DMA, SPI_RX_DMA_CH, DMA_SxCR_MSIZE_8BIT);
+    dma_stream_reset(SPI_DMA, SPI_TX_DMA_CH);
+    dma_channel_select(SPI_DMA, SPI_TX_DMA_CH, DMA_SxCR_CHSEL_0);
+    dma_set_transfer_mode(SPI_DMA, SPI_TX_DMA_CH, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
+    dma_set_peripheral_size(SPI_DMA, SPI_TX_DMA_CH, DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(SPI_DMA, SPI_TX_DMA_CH, DMA_SxCR_MSIZE_8BIT);
+#endif /*defined(STM32F4)*/
+
+    dma_set_peripheral_address(SPI_DMA, SPI_RX_DMA_CH, (uint32_t)(uintptr_t)&SPI_DR(SPI_PORT));
+    dma_set_memory_address(SPI_DMA, SPI_RX_DMA_CH, (uint32_t)(uintptr_t)s_vu8RxFrame);
+    dma_enable_memory_increment_mode(SPI_DMA, SPI_RX_DMA_CH);
+    dma_enable_transfer_complete_interrupt(SPI_DMA, SPI_RX_DMA_CH);
+    dma_set_peripheral_address(SPI_DMA, SPI_TX_DMA_CH, (uint32_t)(uintptr_t)&SPI_DR(SPI_PORT));
+    dma_set_memory_address(SPI_DMA, SPI_TX_DMA_CH, (uint32_t)(uintptr_t)s_vu8TxFrame);
+    dma_enable_memory_increment_mode(SPI_DMA, SPI_TX_DMA_CH);
+
+    s_hResync = xTimerCreateStatic("spisync", pdMS_TO_TICKS(SPI_RESYNC_MS), pdFALSE, nullptr, spi_resync_cb, &s_sResyncTimer);
+    spi_restart();
+
+    nvic_set_priority(SPI_RX_DMA_IRQ, SPI_IRQ_PRIORITY);
+    nvic_enable_irq(SPI_RX_DMA_IRQ);
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_getchar(void)
+{
+    uart_mux_reader();
+    while (s_u16RxTail == s_u16RxHead) {
+        spi_rx_wait();
+    }
+    const uint8_t c = s_vu8RxBuffer[s_u16RxTail & (SPI_RX_BUFFER_SIZE - 1U)];
+    s_u16RxTail = (uint16_t)(s_u16RxTail + 1U);
+    return c;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a host sends a line in a frame or a few back to back, so it is usually complete here;
+   anything else (control keys, partial or too long line) stays for uart_getchar() */
+int uart_getline(char *buf, int maxlen)
+{
+    uart_mux_reader();
+    while (s_u16RxTail == s_u16RxHead) {
+        spi_rx_wait();
+    }
+
+    const uint16_t u16Head = s_u16RxHead;
+    uint16_t u16Idx = s_u16RxTail;
+    int len = 0;
+
+    while (u16Idx != u16Head) {
+        const uint8_t c = s_vu8RxBuffer[u16Idx & (SPI_RX_BUFFER_SIZE - 1U)];
+        u16Idx = (uint16_t)(u16Idx + 1U);
+        if ('\r' == c) {
+            buf[len] = '\0';
+            const int consumed = (int)(uint16_t)(u16Idx - s_u16RxTail);
+            s_u16RxTail = u16Idx;
+            return consumed;
+        }
+        if ('\n' == c) {
+            continue;
+        }
+        if ((c < 0x20U) || (c > 0x7EU) || (len >= maxlen - 1)) {
+            break;
+        }
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_read(uint8_t *buf, int len, uint32_t u32TimeoutMs)
+{
+    int done = 0;
+
+    uart_mux_reader();
+    while (done < len) {
+        if (s_u16RxTail == s_u16RxHead) {
+            if (false == spi_rx_wait_for(u32TimeoutMs)) {
+                break;
+            }
+            continue;
+        }
+        while ((s_u16RxTail != s_u16RxHead) && (done < len)) {
+            buf[done++] = s_vu8RxBuffer[s_u16RxTail & (SPI_RX_BUFFER_SIZE - 1U)];
+            s_u16RxTail = (uint16_t)(s_u16RxTail + 1U);
+        }
+    }
+    return done;
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_tx_set_policy(uart_tx_policy_e ePolicy)
+{
+    s_eTxPolicy = ePolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_tx_dropped(void)
+{
+    return s_u32TxDropped;
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_rx_set_hook(uart_rx_hook_t pfHook)
+{
+    s_pfRxHook = pfHook;
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+const volatile uint32_t *uart_activity(void)
+{
+    return &s_u32Activity;
+}
+
+
+
+/*--------------------------------------------------*/
+/* wait until the host took everything queued so far (or the port closed) */
+void uart_flush(void)
+{
+    uart_mux_flush();
+    while (0 != uart_tx_busy()) {
+        if (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()) {
+            break;
+        }
+        uart_port_tx_wait();
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+int uart_tx_busy(void)
+{
+    return ((true == s_bPortOpen) && (s_u16TxHead != s_u16TxTail)) ? 1 : 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the host drives the clock */
+int uart_set_baudrate(uint32_t u32Baud)
+{
+    (void)u32Baud;
+    return -1;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_get_baudrate(void)
+{
+    return 0U;
+}
+
+
+
+/*--------------------------------------------------*/
+/* shell command, same table entry as the USART backend: the clock is the one of the host,
+   0 shows the port */
+extern "C" int baud(uint32_t u32Baud)
+{
+    if (0U != u32Baud) {
+        uart_printf("baud: the SPI clock is the one of the host\r\n");
+        return SPI_BAUD_CMD_ERR;
+    }
+    uart_printf("baud: SPI2 slave, frames of %u bytes, %s, data ready %s\r\n", SPI_FRAME_SIZE,
+                (true == s_bPortOpen) ? "open" : "closed",
+                (0U != gpio_get(SPI_GPIO_PORT, SPI_DRDY_PIN)) ? "high" : "low");
+    uart_printf("  frames %u, bytes rx %u tx %u, busy %u, errors %u, dropped %u\r\n",
+                s_u32Frames, s_u32RxBytes, s_u32TxBytes, s_u32Busy, s_u32Errors, s_u32TxDropped);
+    return 0;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the RX transfer is complete, so is the frame: its input into the ring, the next one armed */
+extern "C" void SPI_RX_DMA_ISR(void)
+{
+    ISR_PROF_ENTER(ISR_PROF_SPI);
+    PROBE(UART_RX_BEGIN);
+    dma_clear_interrupt_flags(SPI_DMA, SPI_RX_DMA_CH, DMA_TCIF);
+
+    const uint16_t u16Head = s_u16RxHead;
+    const UBaseType_t uxSaved = taskENTER_CRITICAL_FROM_ISR();
+    spi_frame_done();
+    spi_frame_arm();
+    taskEXIT_CRITICAL_FROM_ISR(uxSaved);
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if (false == s_bResyncArmed) {
+        s_bResyncArmed = true;
+        (void)xTimerResetFromISR(s_hResync, &xHigherPriorityTaskWoken);
+    }
+    if (u16Head != s_u16RxHead) {
+        const uart_rx_hook_t pfHook = s_pfRxHook;
+        if (nullptr != pfHook) {
+            pfHook();
+        }
+        TaskHandle_t xTask = s_xRxTask;
+        if (nullptr != xTask) {
+            vTaskNotifyGiveFromISR(xTask, &xHigherPriorityTaskWoken);
+        }
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    PROBE(UART_RX_END);
+    ISR_PROF_EXIT(ISR_PROF_SPI);
+}
+
+/* ================================================
+            private interfaces definition
+==================================================*/
+
+/*--------------------------------------------------*/
+/* the SPI from reset (its data register may hold a byte of a cut frame), then the frame; with
+   the RX DMA interrupt masked and NSS up. After the reset CR1 is a slave in mode 0, 8 bit,
+   MSB first, NSS from the pin */
+static void spi_restart(void)
+{
+#if defined(STM32F1)
+    dma_disable_channel(SPI_DMA, SPI_RX_DMA_CH);
+    dma_disable_channel(SPI_DMA, SPI_TX_DMA_CH);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    dma_disable_stream(SPI_DMA, SPI_RX_DMA_CH);
+    dma_disable_stream(SPI_DMA, SPI_TX_DMA_CH);
+#endif /*defined(STM32F4)*/
+
+    rcc_periph_reset_pulse(SPI_RST);
+    spi_set_slave_mode(SPI_PORT);
+    spi_enable_rx_dma(SPI_PORT);
+    s_u8TxInFlight = 0U;        /* not sent: taken again from the ring */
+    spi_frame_arm();
+    spi_enable_tx_dma(SPI_PORT);
+    spi_enable(SPI_PORT);
+}
+
+
+
+/*--------------------------------------------------*/
+/* the header and the output of the next frame, both transfers started (the TX one puts the
+   header in the data register at once); from the RX ISR or with it masked */
+static void spi_frame_arm(void)
+{
+    const uint16_t u16Queued = (true == s_bPortOpen) ? (uint16_t)(s_u16TxHead - s_u16TxTail) : 0U;
+    const uint8_t u8Len = (u16Queued < SPI_FRAME_DATA) ? (uint8_t)u16Queued : (uint8_t)SPI_FRAME_DATA;
+
+    for (uint8_t i = 0; i < u8Len; i++) {
+        s_vu8TxFrame[1U + i] = s_vu8TxBuffer[(uint16_t)(s_u16TxTail + i) & (SPI_TX_BUFFER_SIZE - 1U)];
+    }
+    s_u8TxInFlight = u8Len;
+    s_bRxTake = (spi_rx_free() >= SPI_FRAME_DATA);
+    s_vu8TxFrame[0] = (uint8_t)(u8Len | ((u16Queued > u8Len) ? SPI_HDR_MORE : 0U) |
+                                ((false == s_bRxTake) ? SPI_HDR_BUSY : 0U));
+
+#if defined(STM32F1)
+    dma_disable_channel(SPI_DMA, SPI_RX_DMA_CH);
+    dma_set_number_of_data(SPI_DMA, SPI_RX_DMA_CH, SPI_FRAME_SIZE);
+    dma_enable_channel(SPI_DMA, SPI_RX_DMA_CH);
+    dma_disable_channel(SPI_DMA, SPI_TX_DMA_CH);
+    dma_set_number_of_data(SPI_DMA, SPI_TX_DMA_CH, SPI_FRAME_SIZE);
+    dma_enable_channel(SPI_DMA, SPI_TX_DMA_CH);
+#endif /*defined(STM32F1)*/
+
+#if defined(STM32F4)
+    /* the streams disabled themselves at the end of the frame */
+    dma_clear_interrupt_flags(SPI_DMA, SPI_RX_DMA_CH, DMA_TCIF | DMA_HTIF | DMA_TEIF | DMA_DMEIF | DMA_FEIF);
+    dma_set_number_of_data(SPI_DMA, SPI_RX_DMA_CH, SPI_FRAME_SIZE);
+    dma_enable_stream(SPI_DMA, SPI_RX_DMA_CH);
+    dma_clear_interrupt_flags(SPI_DMA, SPI_TX_DMA_CH, DMA_TCIF | DMA_HTIF | DMA_TEIF | DMA_DMEIF | DMA_FEIF);
+    dma_set_number_of_data(SPI_DMA, SPI_TX_DMA_CH, SPI_FRAME_SIZE);
+    dma_enable_stream(SPI_DMA, SPI_TX_DMA_CH);
+#endif /*defined(STM32F4)*/
+
+    if (0U != u16Queued) {
+        gpio_set(SPI_GPIO_PORT, SPI_DRDY_PIN);
+    } else {
+        gpio_clear(SPI_GPIO_PORT, SPI_DRDY_PIN);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* a complete frame, in the RX ISR: the output it carried leaves the ring, its input goes in
+   (the room was looked at when it was armed, the reader only makes more) */
+static void spi_frame_done(void)
+{
+    s_u32Frames = s_u32Frames + 1U;
+    s_xLastFrame = xTaskGetTickCountFromISR();
+    if (0U != (SPI_SR(SPI_PORT) & SPI_SR_OVR)) {
+        (void)SPI_DR(SPI_PORT);     /* the DR then SR reads clear it */
+        (void)SPI_SR(SPI_PORT);
+        s_u32Errors = s_u32Errors + 1U;
+    }
+
+    if (false == s_bPortOpen) {
+        s_u16TxTail = s_u16TxHead;  /* nothing older than the session */
+        s_bPortOpen = true;
+    }
+    s_u16TxTail = (uint16_t)(s_u16TxTail + s_u8TxInFlight);
+    s_u32TxBytes = s_u32TxBytes + s_u8TxInFlight;
+    s_u8TxInFlight = 0U;
+
+    const uint8_t u8Len = s_vu8RxFrame[0];
+    if (u8Len > SPI_FRAME_DATA) {
+        s_u32Errors = s_u32Errors + 1U;
+        return;
+    }
+    if (0U == u8Len) {
+        return;
+    }
+    if (false == s_bRxTake) {
+        s_u32Busy = s_u32Busy + 1U;
+        return;
+    }
+    for (uint8_t i = 0; i < u8Len; i++) {
+        s_vu8RxBuffer[s_u16RxHead & (SPI_RX_BUFFER_SIZE - 1U)] = s_vu8RxFrame[1U + i];
+        s_u16RxHead = (uint16_t)(s_u16RxHead + 1U);
+    }
+    s_u32RxBytes = s_u32RxBytes + u8Len;
+}
+
+
+
+/*--------------------------------------------------*/
+/* no host: the queued output is dropped (counted) and discarded until the next frame, an
+   empty frame armed; in a critical section */
+static void spi_close(void)
+{
+    s_u32TxDropped = s_u32TxDropped + (uint16_t)(s_u16TxHead - s_u16TxTail);
+    s_u16TxTail = s_u16TxHead;
+    s_bPortOpen = false;
+    spi_restart();
+}
+
+
+
+/*--------------------------------------------------*/
+/* SPI_RESYNC_MS after a complete frame: NSS up with a transfer part way is a frame the host
+   cut short, the SPI starts over at the next one */
+static void spi_resync_cb(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+    s_bResyncArmed = false;
+
+    taskENTER_CRITICAL();
+    const uint16_t u16Left = (uint16_t)dma_get_number_of_data(SPI_DMA, SPI_RX_DMA_CH);
+    if ((0U != u16Left) && (SPI_FRAME_SIZE != u16Left) && (0U != gpio_get(SPI_GPIO_PORT, SPI_NSS_PIN))) {
+        s_u32Errors = s_u32Errors + 1U;
+        spi_restart();
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+
+/*--------------------------------------------------*/
+/* the ring works before the scheduler too, nothing waits for room then */
+bool uart_port_tx_early(const char *buf, int len)
+{
+    (void)buf;
+    (void)len;
+    return false;
+}
+
+
+
+/*--------------------------------------------------*/
+/* nobody takes the output before the host clocks a frame */
+bool uart_port_tx_open(void)
+{
+    return s_bPortOpen;
+}
+
+
+
+/*--------------------------------------------------*/
+uint32_t uart_port_tx_free(void)
+{
+    if (false == s_bPortOpen) {
+        return 0U;
+    }
+    return (uint32_t)(SPI_TX_BUFFER_SIZE - (uint16_t)(s_u16TxHead - s_u16TxTail));
+}
+
+
+
+/*--------------------------------------------------*/
+/* the bytes wait for the host: data ready tells it */
+void uart_port_tx_put(const char *buf, uint32_t len)
+{
+    PROBE(UART_TX_BEGIN);
+    for (uint32_t i = 0; i < len; ++i) {
+        s_vu8TxBuffer[(uint16_t)(s_u16TxHead + i) & (SPI_TX_BUFFER_SIZE - 1U)] = (uint8_t)buf[i];
+    }
+    s_u16TxHead = (uint16_t)(s_u16TxHead + len);
+    if (0U != len) {
+        gpio_set(SPI_GPIO_PORT, SPI_DRDY_PIN);
+    }
+    activity_output();
+    PROBE(UART_TX_END);
+}
+
+
+
+/*--------------------------------------------------*/
+/* the armed frame keeps its bytes, the ones after them go: the tail moves by len and the bytes
+   of the frame are written back in front of it, the end of the frame moves them out */
+bool uart_port_tx_discard(uint32_t len)
+{
+    if (len > (uint16_t)(s_u16TxHead - s_u16TxTail - s_u8TxInFlight)) {
+        return false;
+    }
+    s_u16TxTail = (uint16_t)(s_u16TxTail + len);
+    for (uint8_t i = 0; i < s_u8TxInFlight; i++) {
+        s_vu8TxBuffer[(uint16_t)(s_u16TxTail + i) & (SPI_TX_BUFFER_SIZE - 1U)] = s_vu8TxFrame[1U + i];
+    }
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+/* a frame takes ~20 us at 16 MHz, the host polls at its own pace; a host which stopped
+   clocking closes the port */
+void uart_port_tx_wait(void)
+{
+    taskENTER_CRITICAL();
+    if ((true == s_bPortOpen) && ((xTaskGetTickCount() - s_xLastFrame) > pdMS_TO_TICKS(SPI_HOST_TIMEOUT_MS))) {
+        spi_close();
+    }
+    taskEXIT_CRITICAL();
+    vTaskDelay(1);
+}
+
+
+
+/*--------------------------------------------------*/
+void uart_port_tx_dropped(uint32_t len)
+{
+    s_u32TxDropped = s_u32TxDropped + len;
+}
+
+
+
+/*--------------------------------------------------*/
+uart_tx_policy_e uart_port_tx_policy(void)
+{
+    return s_eTxPolicy;
+}
+
+
+
+/*--------------------------------------------------*/
+/* block until the RX ISR reports new data: task notification once the
+   scheduler runs, wfi before (bare metal, early boot) */
+static void spi_rx_wait(void)
+{
+    if (taskSCHEDULER_RUNNING == xTaskGetSchedulerState()) {
+        s_xRxTask = xTaskGetCurrentTaskHandle();
+        if (s_u16RxTail == s_u16RxHead) {
+            activity_add(1U);
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            activity_add(1U);
+        }
+    } else {
+        /* a pending irq still ends wfi with the interrupts masked, so none is missed */
+        __asm__ volatile ("cpsid i" ::: "memory");
+        if (s_u16RxTail == s_u16RxHead) {
+            __asm__ volatile ("wfi");
+        }
+        __asm__ volatile ("cpsie i" ::: "memory");
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* spi_rx_wait() with a limit, false if nothing arrived meanwhile (task context only) */
+static bool spi_rx_wait_for(uint32_t u32Ms)
+{
+    if (0U == u32Ms) {
+        return (s_u16RxTail != s_u16RxHead);    /* a poll (ShellAO): the notification of the caller is left alone */
+    }
+    s_xRxTask = xTaskGetCurrentTaskHandle();
+    if (s_u16RxTail == s_u16RxHead) {
+        activity_add(1U);
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(u32Ms));
+        activity_add(1U);
+    }
+    return (s_u16RxTail != s_u16RxHead);
+}
+
+
+
+/*--------------------------------------------------*/
+/* tasks and the reader itself: atomic, a lost step would flip the waiting parity */
+static void activity_add(uint32_t u32Step)
+{
+    __atomic_fetch_add(&s_u32Activity, u32Step, __ATOMIC_RELAXED);
+}
+
+
+
+/*--------------------------------------------------*/
+static void activity_output(void)
+{
+    if (xTaskGetCurrentTaskHandle() == s_xRxTask) {
+        activity_add(2U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+static inline uint16_t spi_rx_free(void)
+{
+    return (uint16_t)(SPI_RX_BUFFER_SIZE - (uint16_t)(s_u16RxHead - s_u16RxTail));
+}
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+The shell of the nodes of a CAN bus (uart_access USHELL_CAN), from one Linux gateway
+Usage: python3 can_shell.py can0 --nodes 1,2,5
+       python3 can_shell.py can0 --nodes 1-8 --script cmds.txt [--pipeline]
+
+    gateway -> node     0x700 + node        node -> gateway     0x780 + node
+
+An ISO-TP socket of the kernel per node (CONFIG_CAN_ISOTP, Linux 5.10 or later) does the
+segmentation and the flow control, the line of a command goes out as one message. Each line of
+stdin or of the script is sent to every node ('@3 line' to node 3 only), the output of each node
+is printed with its name in front until no node said anything for --idle seconds. With
+--pipeline the lines of the script go out at once, the node queues them in its RX ring (its flow
+control holds the gateway when it is full) and runs them in order, the answers are collected
+after the last one. A node which does not answer is reported, not waited for.
+"""
+
+import argparse
+import select
+import socket
+import sys
+import time
+
+REQ_BASE = 0x700
+RSP_BASE = 0x780
+
+
+def parse_nodes(text):
+    nodes = []
+    for part in text.split(','):
+        if '-' in part:
+            first, last = part.split('-', 1)
+            nodes += range(int(first, 0), int(last, 0) + 1)
+        else:
+            nodes.append(int(part, 0))
+    for node in nodes:
+        if not 1 <= node <= 0x7F:
+            raise argparse.ArgumentTypeError('node %d: 1 .. 127' % node)
+    return sorted(set(nodes))
+
+
+def open_node(iface, node):
+    if not hasattr(socket, 'CAN_ISOTP'):
+        sys.exit('can_shell: this Python has no CAN_ISOTP sockets (Linux, Python 3.7 or later)')
+    sock = socket.socket(socket.AF_CAN, socket.SOCK_DGRAM, socket.CAN_ISOTP)
+    sock.bind((iface, RSP_BASE + node, REQ_BASE + node))
+    return sock
+
+
+def collect(socks, idle, pending):
+    """the output of the nodes until idle seconds without any; pending: the nodes which owe
+    an answer, the ones still in it are reported"""
+    partial = {node: b'' for node in socks}
+    by_fd = {sock.fileno(): node for node, sock in socks.items()}
+    deadline = time.monotonic() + idle
+    while True:
+        wait = deadline - time.monotonic()
+        if wait <= 0:
+            break
+        ready, _, _ = select.select(list(socks.values()), [], [], wait)
+        for sock in ready:
+            node = by_fd[sock.fileno()]
+            try:
+                data = sock.recv(4096)
+            except OSError as err:
+                print('[node %d] %s' % (node, err), file=sys.stderr)
+                continue
+            pending.discard(node)
+            lines = (partial[node] + data).split(b'\n')
+            partial[node] = lines.pop()
+            for line in lines:
+                print('[node %d] %s' % (node, line.rstrip(b'\r').decode('ascii', 'replace')))
+            deadline = time.monotonic() + idle
+    for node, rest in partial.items():
+        if rest:
+            print('[node %d] %s' % (node, rest.rstrip(b'\r').decode('ascii', 'replace')))
+    for node in sorted(pending):
+        print('[node %d] no answer' % node, file=sys.stderr)
+
+
+def send(socks, line, pending):
+    targets = socks
+    if line.startswith('@'):
+        head, _, line = line.partition(' ')
+        node = int(head[1:], 0)
+        if node not in socks:
+            print('can_shell: node %d is not in --nodes' % node, file=sys.stderr)
+            return
+        targets = {node: socks[node]}
+    for node, sock in targets.items():
+        try:
+            sock.send(line.encode('ascii') + b'\r')
+            pending.add(node)
+        except OSError as err:
+            print('[node %d] %s' % (node, err), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='uShell over CAN ISO-TP, several nodes')
+    parser.add_argument('iface', help='SocketCAN interface (can0, vcan0)')
+    parser.add_argument('--nodes', type=parse_nodes, default=[1], help='1,2,5 or 1-8 (default 1)')
+    parser.add_argument('--script', help='the command lines from a file instead of stdin')
+    parser.add_argument('--pipeline', action='store_true', help='the lines of the script at once')
+    parser.add_argument('--idle', type=float, default=0.3, help='seconds of silence after a command')
+    args = parser.parse_args()
+
+    socks = {node: open_node(args.iface, node) for node in args.nodes}
+    source = open(args.script) if args.script else sys.stdin
+    lines = (line.rstrip('\r\n') for line in source)
+    if args.pipeline:
+        pending = set()
+        for line in lines:
+            send(socks, line, pending)
+        collect(socks, args.idle, pending)
+        return
+    for line in lines:      # stdin: one at a time, as typed
+        pending = set()
+        send(socks, line, pending)
+        collect(socks, args.idle, pending)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""
+Shell text and telemetry frames apart, from a capture or a live port of uart_access
+Usage: python3 chan_demux.py capture.bin [--frames frames.txt]
+       python3 chan_demux.py /dev/ttyUSB0 --baud 115200 [--frames frames.txt]   (pyserial)
+
+    <text> 00 COBS(channel, seq, payload, CRC16) 00 <text> ...
+
+The text (channel 0) has no zero byte, it goes to stdout as received with the frames taken out,
+so the session reads as on a plain terminal. Each frame is one line of the frames file (stderr
+without it): channel, seq and the payload, decoded for the channels of ao_defs.hpp, in hex for
+the others. The CRC16 is the CCITT one (binascii.crc_hqx, 0xFFFF); a gap in seq is a frame the
+target dropped (chan 0 counts them). Bytes between two zeros which do not decode are text again
+(a binary command output, the start of a capture). A frame with an XON / XOFF of the flow control
+(UART_ACCESS_FLOW_XONXOFF) in it is tried again without them.
+"""
+
+import argparse
+import binascii
+import os
+import struct
+import sys
+
+FRAME_MAX = 1 + 2 + 200 + 2 + 1     # stuffed: the code bytes, channel, seq, payload, CRC16
+FLOW = b'\x11\x13'
+
+TASK_STATES = ('running', 'ready', 'blocked', 'suspended', 'deleted', 'invalid')
+STATS_FLAGS = ('heap', 'tasks', 'aos', 'commands', 'tasks cut', 'aos cut')
+
+BUTTON_SIGNALS = ('none', 'raw edge', 'pressed', 'released', 'single click', 'double click',
+                  'long press', 'multi click', 'repeat', 'chord')
+
+
+def cobs_decode(data):
+    out, pos = bytearray(), 0
+    while pos < len(data):
+        code = data[pos]
+        if code == 0 or pos + code > len(data) + 1:
+            return None
+        out += data[pos + 1:pos + code]
+        pos += code
+        if code < 0xFF and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def unframe(stuffed):
+    """channel, seq, payload of a frame, None if it is not one"""
+    for data in (stuffed, bytes(b for b in stuffed if b not in FLOW)):
+        raw = cobs_decode(data)
+        if raw is not None and len(raw) >= 4:
+            stored, = struct.unpack_from('<H', raw, len(raw) - 2)
+            if stored == binascii.crc_hqx(raw[:-2], 0xFFFF) and raw[0] != 0:
+                return raw[0], raw[1], raw[2:-2]
+        if not any(b in FLOW for b in stuffed):
+            break
+    return None
+
+
+def describe(channel, payload):
+    if channel == 1 and len(payload) >= 6:
+        seq, inputs, decimation = struct.unpack_from('<IBB', payload)
+        points = struct.unpack_from(f'<{(len(payload) - 6) // 2}H', payload, 6)
+        first = ' '.join(f'in{i} {points[i * 3]}/{points[i * 3 + 1]}/{points[i * 3 + 2]}' for i in range(inputs))
+        return f"adc seq {seq} inputs {inputs} decimation {decimation} points {len(points) // max(inputs * 3, 1)}: {first}"
+    if channel == 2 and len(payload) == 10:
+        button, signal, param, tick = struct.unpack('<BBII', payload)
+        name = BUTTON_SIGNALS[signal] if signal < len(BUTTON_SIGNALS) else str(signal)
+        return f"button {button} {name} param {param} tick {tick}"
+    if channel == 3 and len(payload) >= 4:
+        tick, = struct.unpack_from('<I', payload)
+        aos = [struct.unpack_from('<5I', payload, 4 + 20 * i) for i in range((len(payload) - 4) // 20)]
+        return f"aostat tick {tick} " + ' | '.join('posts {} drops {} peak {} disp {} cyc {}'.format(*a) for a in aos)
+    if channel == 4 and len(payload) >= 56 and payload[0] == 1:
+        return describe_stats(payload)
+    return payload.hex(' ')
+
+
+def describe_stats(payload):
+    """the stats 0 snapshot, layout 1 (ao_defs.cpp); stats 1 names the task numbers and AO rows"""
+    _, flags, tasks, aos, seq, tick = struct.unpack_from('<BBBBII', payload)
+    heap = struct.unpack_from('<5I', payload, 12)
+    uart = struct.unpack_from('<3I', payload, 32)
+    cmds = struct.unpack_from('<3I', payload, 44)
+    out = [f"stats seq {seq} tick {tick} [{', '.join(n for i, n in enumerate(STATS_FLAGS) if flags & (1 << i))}]",
+           'heap free {} min {} largest {} mallocs {} frees {}'.format(*heap),
+           'uart tx dropped {} isr dropped {} frames dropped {}'.format(*uart),
+           'commands {} errors {} max cyc {}'.format(*cmds)]
+    pos = 56
+    for _ in range(tasks):
+        number, state, prio, free = struct.unpack_from('<BBBH', payload, pos)
+        out.append(f"task {number} {TASK_STATES[min(state, 5)]} prio {prio} free {free}")
+        pos += 5
+    for row in range(aos):
+        used, peak, posts, drops = struct.unpack_from('<BBII', payload, pos)
+        out.append(f"ao {row} used {used} peak {peak} posts {posts} drops {drops}")
+        pos += 10
+    return ' | '.join(out)
+
+
+class Demux:
+    def __init__(self, text, frames):
+        self.text, self.frames = text, frames
+        self.stuffed = None         # between two zeros, None in the text
+        self.seq = {}
+        self.counts = {}            # channel: frames, seq gaps
+        self.bad = 0
+
+    def feed(self, data):
+        plain = bytearray()
+        for byte in data:
+            if self.stuffed is None:
+                if byte == 0:
+                    self.stuffed = bytearray()
+                else:
+                    plain.append(byte)
+            elif byte != 0:
+                self.stuffed.append(byte)
+                if len(self.stuffed) > 2 * FRAME_MAX:   # no frame is that long
+                    plain += self.stuffed
+                    self.stuffed = None
+            elif self.stuffed:
+                frame = unframe(bytes(self.stuffed))
+                if frame is None:
+                    plain += self.stuffed                # the closing zero may open the next one
+                    self.bad += 1
+                    self.stuffed = bytearray()
+                else:
+                    self.flush(plain)
+                    self.frame(*frame)
+                    self.stuffed = None
+        self.flush(plain)
+
+    def flush(self, plain):
+        if plain:
+            self.text.write(plain)
+            self.text.flush()
+            plain.clear()
+
+    def frame(self, channel, seq, payload):
+        frames, gaps = self.counts.get(channel, (0, 0))
+        if channel in self.seq:
+            gaps += (seq - self.seq[channel] - 1) & 0xFF
+        self.seq[channel] = seq
+        self.counts[channel] = (frames + 1, gaps)
+        self.frames.write(f"#{channel} {seq:3} {describe(channel, payload)}\n")
+        self.frames.flush()
+
+    def summary(self):
+        per_channel = ', '.join(f"ch{c} {n} frames {g} missing" for c, (n, g) in sorted(self.counts.items()))
+        return f"chan_demux: {per_channel or 'no frames'}, {self.bad} undecoded"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('source', help='a capture file or a serial port')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--frames', help='the frame lines, stderr without it')
+    args = parser.parse_args()
+
+    frames = open(args.frames, 'w') if args.frames else sys.stderr
+    demux = Demux(sys.stdout.buffer, frames)
+    try:
+        if os.path.isfile(args.source):
+            with open(args.source, 'rb') as f:
+                demux.feed(f.read())
+        else:
+            import serial
+            with serial.Serial(args.source, args.baud, timeout=0.1) as port:
+                while True:
+                    demux.feed(port.read(port.in_waiting or 1))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print(demux.summary(), file=sys.stderr)
+        if frames is not sys.stderr:
+            frames.close()
+
+
+if __name__ == '__main__':
+    main()
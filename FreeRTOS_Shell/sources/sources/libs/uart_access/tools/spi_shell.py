@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+The shell of a board on an SPI bus (uart_access USHELL_SPI), from a Linux host with spidev
+Usage: python3 spi_shell.py /dev/spidev0.0 [--hz 8000000]
+       python3 spi_shell.py /dev/spidev0.0 --script cmds.txt
+
+    MOSI    len   len bytes of input    filler          frames of 32 bytes, mode 0
+    MISO    len | MORE 0x80 | BUSY 0x40   len bytes of output
+
+Each line of stdin or of the script goes out in frames of up to 31 bytes ('\\r' at its end); a
+frame answered BUSY (the RX ring of the board was full) is sent again. Empty frames then collect
+the output until none came for --idle seconds: back to back while the board says MORE, every
+--poll seconds else. The data ready line (PB10) is not needed here, a host processor waits on
+its edge instead of polling.
+"""
+
+import argparse
+import sys
+import time
+
+try:
+    import spidev
+except ImportError:
+    sys.exit('spi_shell: needs the spidev module (pip install spidev)')
+
+FRAME_SIZE = 32
+FRAME_DATA = FRAME_SIZE - 1
+HDR_LEN_MASK = 0x3F
+HDR_BUSY = 0x40
+HDR_MORE = 0x80
+
+
+class Port:
+    def __init__(self, path, hz):
+        bus, _, dev = path.rpartition('spidev')[2].partition('.')
+        self.spi = spidev.SpiDev()
+        self.spi.open(int(bus), int(dev))
+        self.spi.mode = 0
+        self.spi.max_speed_hz = hz
+        self.partial = b''
+        self.more = False
+        self.got = 0
+
+    def frame(self, data=b''):
+        """one frame, True if the board took data; the output it carried is printed"""
+        rsp = self.spi.xfer2([len(data)] + list(data) + [0] * (FRAME_DATA - len(data)))
+        hdr = rsp[0]
+        size = hdr & HDR_LEN_MASK
+        if size > FRAME_DATA:
+            print('spi_shell: bad header 0x%02X' % hdr, file=sys.stderr)
+            size = 0
+        self.show(bytes(rsp[1:1 + size]))
+        self.got = size
+        self.more = bool(hdr & HDR_MORE)
+        return not (data and (hdr & HDR_BUSY))
+
+    def show(self, data):
+        lines = (self.partial + data).split(b'\n')
+        self.partial = lines.pop()
+        for line in lines:
+            print(line.rstrip(b'\r').decode('ascii', 'replace'))
+
+    def send(self, line):
+        data = line.encode('ascii') + b'\r'
+        for pos in range(0, len(data), FRAME_DATA):
+            while not self.frame(data[pos:pos + FRAME_DATA]):
+                pass
+
+    def collect(self, idle, poll):
+        deadline = time.monotonic() + idle
+        while time.monotonic() < deadline:
+            self.frame()
+            if self.got:
+                deadline = time.monotonic() + idle
+            if not self.more:
+                time.sleep(poll)
+        if self.partial:
+            self.show(b'\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='uShell over an SPI slave')
+    parser.add_argument('device', help='spidev device (/dev/spidev0.0)')
+    parser.add_argument('--hz', type=int, default=8000000, help='SCK (default 8 MHz)')
+    parser.add_argument('--script', help='the command lines from a file instead of stdin')
+    parser.add_argument('--idle', type=float, default=0.3, help='seconds of silence after a command')
+    parser.add_argument('--poll', type=float, default=0.002, help='seconds between empty frames')
+    args = parser.parse_args()
+
+    port = Port(args.device, args.hz)
+    port.collect(args.idle, args.poll)      # the banner, the prompt
+    source = open(args.script) if args.script else sys.stdin
+    for line in source:
+        port.send(line.rstrip('\r\n'))
+        port.collect(args.idle, args.poll)
+
+
+if __name__ == '__main__':
+    main()
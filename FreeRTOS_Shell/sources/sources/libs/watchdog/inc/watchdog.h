@@ -0,0 +1,85 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Watchdog supervisor (IWDG), built with -DUSHELL_WATCHDOG=ON (WATCHDOG 1).
+
+        watchdog_init();                    first in main(), it reads the reset cause
+        watchdog_watch(&src, "Shell", uart_activity(), WATCHDOG_SHELL_STALL_MS);
+
+    Every watched task has a beat: a counter it advances itself, odd while it waits for work
+    (an AO blocked on its queue or its signals, the shell blocked for input), even while it
+    works. The supervisor task reads the beats every WATCHDOG_CHECK_MS, no event is posted:
+    a beat that moved or that is odd is alive, a beat that stayed even for the stall time of
+    its source is a task stuck in its work (a dispatch that never returns, a command in a
+    loop, a deadlock). The IWDG is kicked only while every source is alive; with a stalled
+    one its name is recorded and the IWDG resets the part WATCHDOG_TIMEOUT_MS later.
+
+    The AOs watch themselves with AO_HEARTBEAT (on with WATCHDOG, AoConfig.hpp), the AoKernel
+    as one source under AO_COOPERATIVE_KERNEL. A fault of the whole part (hard fault, an ISR
+    that never returns, a higher priority task which takes all the CPU) stops the supervisor
+    itself: the IWDG resets as well, without a name. The stack overflow and malloc failed
+    hooks call watchdog_fault() and reset at once.
+
+    The cause and the name survive the reset in the .noinit RAM (32 bytes of the region at
+    the top of the SRAM, linker scripts); the wdg shell command prints them with the RCC reset flags. The
+    IWDG stops while a debugger halts the core; once started it runs until the next reset,
+    the STOP mode included (the tickless idle sleeps at most WATCHDOG_CHECK_MS).
+*/
+
+#define WATCHDOG_TIMEOUT_MS         2000U   /* IWDG period, from its LSI (~40 kHz F1, ~32 kHz F4) */
+#define WATCHDOG_CHECK_MS           250U    /* the supervisor reads the beats and kicks */
+#define WATCHDOG_AO_STALL_MS        1000U   /* run to completion: one dispatch at most */
+#define WATCHDOG_SHELL_STALL_MS     10000U  /* a command which neither prints nor reads */
+
+/* why the last reset was taken by the watchdog, kept in .noinit */
+typedef enum {
+    WATCHDOG_CAUSE_NONE = 0,
+    WATCHDOG_CAUSE_STALL,           /* a source did not beat for its stall time */
+    WATCHDOG_CAUSE_STACK,           /* vApplicationStackOverflowHook() */
+    WATCHDOG_CAUSE_MALLOC           /* vApplicationMallocFailedHook() */
+} watchdog_cause_e;
+
+/* a watched task, the memory is the caller's (static) */
+typedef struct watchdog_src_s {
+    const char                 *pcName;
+    const volatile uint32_t    *pu32Beat;
+    uint32_t                    u32StallMs;
+    uint32_t                    u32Seen;        /* the beat at the last check */
+    uint32_t                    u32QuietMs;     /* working without a beat for that long */
+    struct watchdog_src_s      *psNext;
+} watchdog_src_s;
+
+/* the reset cause and the record of the last run, the supervisor task (it starts the IWDG);
+   the RCC reset flags are read and cleared with WATCHDOG 0 too */
+void watchdog_init(void);
+
+/* 1 when the last reset left the supply up (pin, software, watchdog, low power): the parts
+   powered with the MCU kept their state (the LCD, its warm start); 0 for a power on or a
+   brown out, and before watchdog_init() */
+int watchdog_warm_reset(void);
+
+/* any time, from a task or before the scheduler */
+void watchdog_watch(watchdog_src_s *psSrc, const char *pcName, const volatile uint32_t *pu32Beat,
+                    uint32_t u32StallMs);
+
+/* the beat of a task of its own: before it blocks for work, after it got some */
+static inline void watchdog_beat(volatile uint32_t *pu32Beat)
+{
+    __atomic_fetch_add(pu32Beat, 1U, __ATOMIC_RELAXED);
+}
+
+/* record the cause and the task name, then reset (the FreeRTOS hooks) */
+void watchdog_fault(watchdog_cause_e eCause, const char *pcName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WATCHDOG_H */
@@ -0,0 +1,245 @@
+#include "watchdog.h"
+#include "ushell_core_printout.h"
+#include "uart_access.h"
+
+#include <libopencm3/stm32/rcc.h>
+
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <libopencm3/stm32/iwdg.h>
+#include <libopencm3/stm32/dbgmcu.h>
+#include <libopencm3/cm3/scb.h>
+
+#include <string.h>
+
+#define WATCHDOG_STACK          96U
+#define WATCHDOG_PRIO           (configMAX_PRIORITIES - 1U)    /* above every watched task */
+#define WATCHDOG_MAGIC          0x57444F47UL                    /* "WDOG" */
+#define WATCHDOG_NAME_LEN       16U
+
+static_assert(WATCHDOG_CHECK_MS * 2U <= WATCHDOG_TIMEOUT_MS, "the IWDG must see two checks per period");
+
+/* in the .noinit RAM at the top of the SRAM, not cleared at the start up (linker scripts) */
+typedef struct {
+    uint32_t u32Magic;
+    uint32_t u32Cause;
+    uint32_t u32Count;      /* watchdog resets in a row, cleared by a power on */
+    char     acName[WATCHDOG_NAME_LEN];
+    uint32_t u32Check;
+} watchdog_record_s;
+
+static_assert(sizeof(watchdog_record_s) == 32U, "32 of the 512 bytes of the .noinit region, the rest for crash_dump and the LCD");
+
+__attribute__((section(".noinit"))) static watchdog_record_s s_sRecord;
+
+static watchdog_record_s s_sLast;           /* the record of the last run, valid or zeroed */
+static watchdog_src_s *s_psFirst = nullptr;
+static const watchdog_src_s *s_psStalled = nullptr;
+
+static StackType_t s_axStack[WATCHDOG_STACK];
+static StaticTask_t s_sTcb;
+
+
+/*--------------------------------------------------*/
+static uint32_t s_check(const watchdog_record_s *psRecord)
+{
+    return ~(psRecord->u32Magic ^ psRecord->u32Cause ^ psRecord->u32Count);
+}
+
+/*--------------------------------------------------*/
+static void s_record(watchdog_cause_e eCause, const char *pcName)
+{
+    s_sRecord.u32Magic = WATCHDOG_MAGIC;
+    s_sRecord.u32Cause = (uint32_t)eCause;
+    s_sRecord.u32Count = s_sLast.u32Count + 1U;
+    memset(s_sRecord.acName, 0, sizeof(s_sRecord.acName));
+    if (nullptr != pcName) {
+        strncpy(s_sRecord.acName, pcName, sizeof(s_sRecord.acName) - 1U);
+    }
+    s_sRecord.u32Check = s_check(&s_sRecord);
+}
+
+/*--------------------------------------------------*/
+/* false at the first stalled source */
+static bool s_check_sources(void)
+{
+    for (watchdog_src_s *psSrc = s_psFirst; psSrc != nullptr; psSrc = psSrc->psNext) {
+        const uint32_t u32Beat = __atomic_load_n(psSrc->pu32Beat, __ATOMIC_RELAXED);
+
+        if ((u32Beat != psSrc->u32Seen) || (0U != (u32Beat & 1U))) {
+            psSrc->u32Seen    = u32Beat;
+            psSrc->u32QuietMs = 0U;
+            continue;
+        }
+        psSrc->u32QuietMs += WATCHDOG_CHECK_MS;
+        if (psSrc->u32QuietMs >= psSrc->u32StallMs) {
+            s_psStalled = psSrc;
+            return false;
+        }
+    }
+    return true;
+}
+
+/*--------------------------------------------------*/
+/* the IWDG starts here, after the slow start up of main() (LSE, LCD) */
+static void s_supervisor_task(void *pvParameters)
+{
+    (void)pvParameters;
+    TickType_t xWake = xTaskGetTickCount();
+
+    DBGMCU_CR |= DBGMCU_CR_IWDG_STOP;
+    iwdg_set_period_ms(WATCHDOG_TIMEOUT_MS);
+    iwdg_start();
+
+    for (;;) {
+        if (true == s_check_sources()) {
+            iwdg_reset();
+        } else {
+            s_record(WATCHDOG_CAUSE_STALL, s_psStalled->pcName);
+            for (;;) {
+                vTaskDelay(portMAX_DELAY);      /* no kick: the IWDG resets */
+            }
+        }
+        vTaskDelayUntil(&xWake, pdMS_TO_TICKS(WATCHDOG_CHECK_MS));
+    }
+}
+
+/*--------------------------------------------------*/
+static const char *s_cause_name(uint32_t u32Cause)
+{
+    switch (u32Cause) {
+        case WATCHDOG_CAUSE_STALL:  return "stall";
+        case WATCHDOG_CAUSE_STACK:  return "stack overflow";
+        case WATCHDOG_CAUSE_MALLOC: return "malloc failed";
+        default:                    return "none";
+    }
+}
+
+/*--------------------------------------------------*/
+/* the RCC flags of the last reset, the most specific first */
+static const char *s_reset_name(uint32_t u32Flags)
+{
+    if (0U != (u32Flags & RCC_CSR_IWDGRSTF)) return "independent watchdog";
+    if (0U != (u32Flags & RCC_CSR_WWDGRSTF)) return "window watchdog";
+    if (0U != (u32Flags & RCC_CSR_SFTRSTF))  return "software";
+    if (0U != (u32Flags & RCC_CSR_LPWRRSTF)) return "low power";
+#if defined(RCC_CSR_BORRSTF)
+    if (0U != (u32Flags & RCC_CSR_BORRSTF))  return "brown out";
+#endif
+    if (0U != (u32Flags & RCC_CSR_PORRSTF))  return "power on";
+    if (0U != (u32Flags & RCC_CSR_PINRSTF))  return "reset pin";
+    return "unknown";
+}
+#endif /*defined(WATCHDOG) && (WATCHDOG == 1)*/
+
+
+/* the resets which took the supply down, the rest left it up */
+#if defined(RCC_CSR_BORRSTF)
+#define WATCHDOG_COLD_FLAGS     (RCC_CSR_PORRSTF | RCC_CSR_BORRSTF)
+#else
+#define WATCHDOG_COLD_FLAGS     (RCC_CSR_PORRSTF)
+#endif
+
+static uint32_t s_u32ResetFlags = 0U;       /* RCC_CSR at the start up, with or without WATCHDOG */
+
+
+/*--------------------------------------------------*/
+void watchdog_init(void)
+{
+    s_u32ResetFlags = RCC_CSR & RCC_CSR_RESET_FLAGS;
+    RCC_CSR |= RCC_CSR_RMVF;
+
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    /* a power on leaves the SRAM random: the record is taken only when it checks */
+    memset(&s_sLast, 0, sizeof(s_sLast));
+    if ((WATCHDOG_MAGIC == s_sRecord.u32Magic) && (s_check(&s_sRecord) == s_sRecord.u32Check) &&
+        (0U == (s_u32ResetFlags & RCC_CSR_PORRSTF))) {
+        s_sLast = s_sRecord;
+        s_sLast.acName[WATCHDOG_NAME_LEN - 1U] = '\0';
+    }
+    memset(&s_sRecord, 0, sizeof(s_sRecord));
+
+    (void)xTaskCreateStatic(s_supervisor_task, "Watchdog", WATCHDOG_STACK, NULL, WATCHDOG_PRIO,
+                            s_axStack, &s_sTcb);
+#endif /*defined(WATCHDOG) && (WATCHDOG == 1)*/
+}
+
+/*--------------------------------------------------*/
+int watchdog_warm_reset(void)
+{
+    return ((0U != s_u32ResetFlags) && (0U == (s_u32ResetFlags & WATCHDOG_COLD_FLAGS))) ? 1 : 0;
+}
+
+/*--------------------------------------------------*/
+void watchdog_watch(watchdog_src_s *psSrc, const char *pcName, const volatile uint32_t *pu32Beat,
+                    uint32_t u32StallMs)
+{
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    psSrc->pcName     = pcName;
+    psSrc->pu32Beat   = pu32Beat;
+    psSrc->u32StallMs = u32StallMs;
+    psSrc->u32Seen    = *pu32Beat;
+    psSrc->u32QuietMs = 0U;
+
+    taskENTER_CRITICAL();
+    psSrc->psNext = s_psFirst;
+    s_psFirst     = psSrc;
+    taskEXIT_CRITICAL();
+#else
+    (void)psSrc;
+    (void)pcName;
+    (void)pu32Beat;
+    (void)u32StallMs;
+#endif /*defined(WATCHDOG) && (WATCHDOG == 1)*/
+}
+
+/*--------------------------------------------------*/
+void watchdog_fault(watchdog_cause_e eCause, const char *pcName)
+{
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    s_record(eCause, pcName);
+    scb_reset_system();
+#else
+    (void)eCause;
+    (void)pcName;
+    for (;;) {
+    }
+#endif /*defined(WATCHDOG) && (WATCHDOG == 1)*/
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* wdg 0: the last reset and the sources, wdg 1: the shell stops beating (the watchdog test) */
+extern "C" int wdg(uint32_t u32Stall)
+{
+#if defined(WATCHDOG) && (WATCHDOG == 1)
+    uSHELL_PRINTF("reset: %s (RCC_CSR %x)\n", s_reset_name(s_u32ResetFlags), (unsigned)s_u32ResetFlags);
+    if (WATCHDOG_CAUSE_NONE != s_sLast.u32Cause) {
+        uSHELL_PRINTF("watchdog: %s of %s, %u in a row\n", s_cause_name(s_sLast.u32Cause),
+                      ('\0' != s_sLast.acName[0]) ? s_sLast.acName : "?", (unsigned)s_sLast.u32Count);
+    } else {
+        uSHELL_PRINTF("watchdog: no fault recorded\n");
+    }
+    uSHELL_PRINTF("IWDG %u ms, check %u ms\n", (unsigned)WATCHDOG_TIMEOUT_MS, (unsigned)WATCHDOG_CHECK_MS);
+    uSHELL_PRINTF("%-12s %10s %8s %8s\n", "source", "beat", "quiet", "stall");
+    for (const watchdog_src_s *psSrc = s_psFirst; psSrc != nullptr; psSrc = psSrc->psNext) {
+        const uint32_t u32Beat = *psSrc->pu32Beat;
+        uSHELL_PRINTF("%-12s %10u %8u %8u%s\n", psSrc->pcName, (unsigned)u32Beat, (unsigned)psSrc->u32QuietMs,
+                      (unsigned)psSrc->u32StallMs, (0U != (u32Beat & 1U)) ? " waiting" : "");
+    }
+    if (0U != u32Stall) {
+        uSHELL_PRINTF("wdg: the shell stops, reset in ~%u ms\n", (unsigned)(WATCHDOG_SHELL_STALL_MS + WATCHDOG_TIMEOUT_MS));
+        uart_flush();
+        for (;;) {
+            __asm__ volatile ("nop");
+        }
+    }
+#else
+    (void)u32Stall;
+    uSHELL_PRINTF("wdg: built with WATCHDOG 0\n");
+#endif /*defined(WATCHDOG) && (WATCHDOG == 1)*/
+    return 0;
+}
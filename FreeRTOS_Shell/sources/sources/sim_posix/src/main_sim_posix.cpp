@@ -0,0 +1,96 @@
+#include <FreeRTOS.h>
+#include <task.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ushell_core.h"
+#include "uart_access.h"
+#include "boot_time.h"
+#include "startup.h"
+#include "bench.h"
+
+#include "LcdAO.hpp"
+#include "LedAO.hpp"
+#include "ShellAO.hpp"
+#include "ao_defs.hpp"
+
+/*
+ * The application of main_freertos_shell.cpp on the FreeRTOS POSIX port: the LedAO, the LcdAO
+ * and the shell over the PTY of uart_access, the LED and the LCD printed on stderr
+ * (sim_gpio.cpp, sim_pcf8574.cpp). No buttons, ADC, flash history, clock profiles or STOP mode.
+ */
+
+// ── Active Object instances ────────────────────────────────────
+
+static LedAO    ledAO(LED_0);
+static LcdAO    lcdAO(LCD_0);
+
+// ── Shell ──────────────────────────────────────────────────────
+#if (AO_SHELL == 1)
+static void onShellStart(Microshell *pShell)
+{
+    (void)pShell;
+    boot_time_mark(BOOT_TIME_PROMPT);
+}
+
+static ShellAO  shellAO(pluginEntry(), "root", onShellStart);
+#else
+static void vTaskShell(void *pvParameters)
+{
+    (void)pvParameters;
+    Microshell *pShell = Microshell::getShellPtr(pluginEntry(), "root");
+    boot_time_mark(BOOT_TIME_PROMPT);
+    pShell->Run();
+}
+#endif
+
+// ── FreeRTOS hooks ─────────────────────────────────────────────
+void vApplicationIdleHook(void)
+{
+    startup_run_late();     // the INIT_LATE entries, once: the shell is up and waits (cmd_sched)
+}
+
+
+void vApplicationMallocFailedHook(void)
+{
+    fprintf(stderr, "sim_posix: out of heap\n");
+    abort();
+}
+
+// ── Main ───────────────────────────────────────────────────────
+int main(void)
+{
+    boot_time_init();       // boottime: stages from here to the prompt
+    boot_time_mark(BOOT_TIME_CLOCK);
+    uart_setup();           // the PTY, its name on stderr
+    boot_time_mark(BOOT_TIME_HW);
+
+    ledAO.init();
+    lcdAO.init();
+    bench_init();           // the bench AO and echo task, nothing without BENCH
+#if (AO_SHELL == 1)
+    shellAO.init();         // polls the PTY, no RX hook
+#endif
+
+    AO_BUS.attach(AO_SLOT_LED_0, ledAO.getAO());
+
+    // The heartbeat: 2 s on, 2 s off, from the LedAO timer (no blink task)
+    static const LedPattern HEARTBEAT = { 4000, 50, 0, false };
+    ledAO.setPattern(HEARTBEAT);
+    lcdAO.print(1, 0, "LED: heartbeat  ");
+
+    boot_time_mark(BOOT_TIME_AO);
+
+#if (AO_SHELL == 0)
+    static StackType_t  shellStack[512];
+    static StaticTask_t shellTcb;
+
+    xTaskCreateStatic(vTaskShell, "Shell", 512, NULL, 1, shellStack, &shellTcb);
+#endif
+
+    boot_time_mark(BOOT_TIME_SCHEDULER);
+    vTaskStartScheduler();
+
+    return 0;
+}
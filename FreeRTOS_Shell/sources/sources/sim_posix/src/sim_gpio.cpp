@@ -0,0 +1,44 @@
+#include "GpioPin.hpp"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * The GPIO ports of the POSIX simulation, behind the GpioPin of USE_POSIX_SIM.
+ *
+ * Every port is its output register: a write applies the mask, a read gives the register
+ * back (no inputs are driven, the buttons are not in the simulation). A pin which changes
+ * is printed on stderr, "gpio: PC13 0": the LED of the board, the heartbeat every 2 s.
+ * The tasks of the port run one at a time, no lock.
+ */
+
+static uint16_t s_au16Odr[GPIO_SIM_PORTS];
+
+
+
+/*--------------------------------------------------*/
+extern "C" void gpio_sim_write(uint32_t port, uint16_t mask, uint16_t value)
+{
+    if (port >= GPIO_SIM_PORTS) {
+        return;
+    }
+
+    const uint16_t u16Old     = s_au16Odr[port];
+    const uint16_t u16New     = (uint16_t)((u16Old & ~mask) | (value & mask));
+    const uint16_t u16Changed = (uint16_t)(u16Old ^ u16New);
+
+    s_au16Odr[port] = u16New;
+    for (unsigned i = 0U; i < 16U; ++i) {
+        if (0U != (u16Changed & (1U << i))) {
+            fprintf(stderr, "gpio: P%c%u %u\n", (char)('A' + port), i, (unsigned)((u16New >> i) & 1U));
+        }
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+extern "C" uint16_t gpio_sim_read(uint32_t port)
+{
+    return (port < GPIO_SIM_PORTS) ? s_au16Odr[port] : 0U;
+}
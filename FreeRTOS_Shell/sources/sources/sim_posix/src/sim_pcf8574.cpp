@@ -0,0 +1,300 @@
+#include "i2c_master.h"
+#include "hd44780_pcf8574.h"
+
+#include <FreeRTOS.h>
+#include <timers.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * The I2C bus of the POSIX simulation: i2c_master.h with a PCF8574 backpack and its HD44780
+ * behind it, so hd44780_pcf8574.cpp and the LcdAO run unchanged.
+ *
+ *  - the PCF8574 (SIM_LCD_ADDR) latches every byte written; a falling edge of EN with RW low
+ *    clocks D4..D7 into the controller, a whole instruction while it is in 8 bit mode (after
+ *    the power up, D0..D3 not wired), else a nibble, high one first
+ *  - the HD44780: DDRAM (2 lines of 40), CGRAM, the address counter and the instructions of
+ *    the driver (clear, home, entry mode, display control, shifts, the addresses); a port read
+ *    gives D4..D7 low, busy flag clear
+ *  - any other address is not acknowledged
+ *
+ * The screen is printed on stderr when it changed, at most every SIM_LCD_REFRESH_MS (a timer of
+ * the kernel): the 16 columns from the display shift, '#' for a CGRAM character.
+ */
+
+#define SIM_LCD_ADDR            0x27U
+#define SIM_LCD_REFRESH_MS      100U
+
+#define SIM_LCD_LINE_ADDR       0x40U       /* DDRAM address of the 2nd line */
+
+/* ================================================
+            private data
+==================================================*/
+
+struct sim_hd44780_s {
+    uint8_t ddram[2][LCD_DDRAM_LINE];
+    uint8_t cgram[LCD_CGRAM_SLOTS * 8U];
+    uint8_t ac;                 /* address counter */
+    bool    inCgram;            /* the last address set was a CGRAM one */
+    bool    increment;          /* entry mode I/D */
+    bool    shiftOnWrite;       /* entry mode S */
+    bool    displayOn;
+    uint8_t shift;              /* display shift, 0 .. LCD_DDRAM_LINE - 1 */
+    bool    fourBit;
+    bool    lowNibble;          /* the high nibble of a 4 bit transfer is in */
+    uint8_t highNibble;
+};
+
+static sim_hd44780_s s_sLcd;
+static uint8_t       s_u8Port;      /* the PCF8574 output latch */
+static bool          s_bDirty;
+static bool          s_bSetup;
+static TimerHandle_t s_hRefresh;
+static StaticTimer_t s_sRefreshTimer;
+
+/* ================================================
+            private interfaces
+==================================================*/
+
+/* DDRAM address to line and column, false outside the two lines */
+static bool sim_lcd_cell(uint8_t u8Addr, uint8_t *pu8Line, uint8_t *pu8Col)
+{
+    const uint8_t u8Line = (u8Addr >= SIM_LCD_LINE_ADDR) ? 1U : 0U;
+    const uint8_t u8Col  = (uint8_t)(u8Addr - (u8Line * SIM_LCD_LINE_ADDR));
+
+    if (u8Col >= LCD_DDRAM_LINE) {
+        return false;
+    }
+    *pu8Line = u8Line;
+    *pu8Col  = u8Col;
+    return true;
+}
+
+
+
+/*--------------------------------------------------*/
+/* the address counter after a data access or a cursor shift, wrapping from line to line */
+static void sim_lcd_step(bool bForward)
+{
+    sim_hd44780_s *p = &s_sLcd;
+
+    if (p->inCgram) {
+        p->ac = (uint8_t)((p->ac + (bForward ? 1U : 0x3FU)) & 0x3FU);
+        return;
+    }
+    if (bForward) {
+        p->ac = (p->ac == (LCD_DDRAM_LINE - 1U)) ? SIM_LCD_LINE_ADDR
+              : (p->ac == (SIM_LCD_LINE_ADDR + LCD_DDRAM_LINE - 1U)) ? 0U
+              : (uint8_t)(p->ac + 1U);
+    } else {
+        p->ac = (p->ac == 0U) ? (uint8_t)(SIM_LCD_LINE_ADDR + LCD_DDRAM_LINE - 1U)
+              : (p->ac == SIM_LCD_LINE_ADDR) ? (uint8_t)(LCD_DDRAM_LINE - 1U)
+              : (uint8_t)(p->ac - 1U);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+static void sim_lcd_shift(bool bRight)
+{
+    s_sLcd.shift = (uint8_t)((s_sLcd.shift + (bRight ? (LCD_DDRAM_LINE - 1U) : 1U)) % LCD_DDRAM_LINE);
+}
+
+
+
+/*--------------------------------------------------*/
+static void sim_lcd_instruction(uint8_t u8Cmd)
+{
+    sim_hd44780_s *p = &s_sLcd;
+
+    if (0U != (u8Cmd & 0x80U)) {                /* set DDRAM address */
+        p->ac      = (uint8_t)(u8Cmd & 0x7FU);
+        p->inCgram = false;
+    } else if (0U != (u8Cmd & 0x40U)) {         /* set CGRAM address */
+        p->ac      = (uint8_t)(u8Cmd & 0x3FU);
+        p->inCgram = true;
+    } else if (0U != (u8Cmd & 0x20U)) {         /* function set: DL */
+        if (p->fourBit != (0U == (u8Cmd & 0x10U))) {
+            p->fourBit   = (0U == (u8Cmd & 0x10U));
+            p->lowNibble = false;
+        }
+    } else if (0U != (u8Cmd & 0x10U)) {         /* cursor or display shift, bit 2 right */
+        if (0U != (u8Cmd & 0x08U)) {
+            sim_lcd_shift(0U != (u8Cmd & 0x04U));
+        } else {
+            sim_lcd_step(0U != (u8Cmd & 0x04U));
+        }
+    } else if (0U != (u8Cmd & 0x08U)) {         /* display control */
+        p->displayOn = (0U != (u8Cmd & 0x04U));
+    } else if (0U != (u8Cmd & 0x04U)) {         /* entry mode set */
+        p->increment    = (0U != (u8Cmd & 0x02U));
+        p->shiftOnWrite = (0U != (u8Cmd & 0x01U));
+    } else if (0U != (u8Cmd & 0x02U)) {         /* return home */
+        p->ac      = 0U;
+        p->inCgram = false;
+        p->shift   = 0U;
+    } else if (0U != (u8Cmd & 0x01U)) {         /* clear display, I/D back to increment */
+        memset(p->ddram, ' ', sizeof(p->ddram));
+        p->ac        = 0U;
+        p->inCgram   = false;
+        p->shift     = 0U;
+        p->increment = true;
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+static void sim_lcd_data(uint8_t u8Data)
+{
+    sim_hd44780_s *p = &s_sLcd;
+    uint8_t u8Line, u8Col;
+
+    if (p->inCgram) {
+        p->cgram[p->ac & 0x3FU] = u8Data;
+    } else if (sim_lcd_cell(p->ac, &u8Line, &u8Col)) {
+        p->ddram[u8Line][u8Col] = u8Data;
+    }
+    sim_lcd_step(p->increment);
+    if (!p->inCgram && p->shiftOnWrite) {
+        sim_lcd_shift(!p->increment);
+    }
+}
+
+
+
+/*--------------------------------------------------*/
+/* a falling edge of EN: the data lines of the byte before it */
+static void sim_lcd_clock(uint8_t u8Latched)
+{
+    sim_hd44780_s *p = &s_sLcd;
+    const uint8_t u8Nibble = (uint8_t)(u8Latched & 0xF0U);
+    const bool    bData    = (0U != (u8Latched & LCD_RS));
+    uint8_t       u8Value;
+
+    if (0U != (u8Latched & LCD_RW)) {           /* a read (busy flag): the pair is clocked out */
+        p->lowNibble = p->fourBit && !p->lowNibble;
+        return;
+    }
+    if (!p->fourBit) {
+        u8Value = u8Nibble;
+    } else if (!p->lowNibble) {
+        p->highNibble = u8Nibble;
+        p->lowNibble  = true;
+        return;
+    } else {
+        u8Value      = (uint8_t)(p->highNibble | (u8Nibble >> 4));
+        p->lowNibble = false;
+    }
+
+    if (bData) {
+        sim_lcd_data(u8Value);
+    } else {
+        sim_lcd_instruction(u8Value);
+    }
+    s_bDirty = true;
+}
+
+
+
+/*--------------------------------------------------*/
+static void sim_lcd_refresh(TimerHandle_t hTimer)
+{
+    (void)hTimer;
+    if (!s_bDirty) {
+        return;
+    }
+    s_bDirty = false;
+
+    for (uint8_t u8Row = 0U; u8Row < LCD_ROWS; ++u8Row) {
+        char line[LCD_COLS + 1];
+
+        for (uint8_t u8Col = 0U; u8Col < LCD_COLS; ++u8Col) {
+            const uint8_t c = s_sLcd.ddram[u8Row][(u8Col + s_sLcd.shift) % LCD_DDRAM_LINE];
+
+            line[u8Col] = !s_sLcd.displayOn ? ' '
+                        : (c < (LCD_CGRAM_CODE + LCD_CGRAM_SLOTS)) ? '#'
+                        : ((c < 0x20U) || (c > 0x7EU)) ? '?'
+                        : (char)c;
+        }
+        line[LCD_COLS] = '\0';
+        fprintf(stderr, "lcd %u |%s|%s\n", u8Row, line, (0U != (s_u8Port & LCD_BL)) ? "" : " (backlight off)");
+    }
+}
+
+/* ================================================
+            public interfaces
+==================================================*/
+
+void i2c_master_setup(void)
+{
+    if (s_bSetup) {
+        return;
+    }
+    s_bSetup = true;
+
+    memset(&s_sLcd, 0, sizeof(s_sLcd));
+    memset(s_sLcd.ddram, ' ', sizeof(s_sLcd.ddram));
+    s_sLcd.increment = true;
+    s_hRefresh = xTimerCreateStatic("lcd", pdMS_TO_TICKS(SIM_LCD_REFRESH_MS), pdTRUE, NULL,
+                                    sim_lcd_refresh, &s_sRefreshTimer);
+    (void)xTimerStart(s_hRefresh, 0);
+}
+
+
+
+/*--------------------------------------------------*/
+int i2c_master_write(uint8_t u8Addr, const uint8_t *pu8Data, uint16_t u16Len)
+{
+    if (u8Addr != SIM_LCD_ADDR) {
+        return I2C_MASTER_NACK;
+    }
+    for (uint16_t i = 0U; i < u16Len; ++i) {
+        if ((0U != (s_u8Port & LCD_EN)) && (0U == (pu8Data[i] & LCD_EN))) {
+            sim_lcd_clock(s_u8Port);
+        }
+        if ((s_u8Port ^ pu8Data[i]) & LCD_BL) {
+            s_bDirty = true;
+        }
+        s_u8Port = pu8Data[i];
+    }
+    return I2C_MASTER_OK;
+}
+
+
+
+/*--------------------------------------------------*/
+int i2c_master_read_byte(uint8_t u8Addr, uint8_t *pu8Data)
+{
+    if (u8Addr != SIM_LCD_ADDR) {
+        return I2C_MASTER_NACK;
+    }
+    *pu8Data = (uint8_t)(s_u8Port & ~(LCD_D4 | LCD_D5 | LCD_D6 | LCD_D7));
+    return I2C_MASTER_OK;
+}
+
+
+
+/*--------------------------------------------------*/
+int i2c_master_set_speed(uint8_t u8Addr, uint32_t u32Hz)
+{
+    (void)u8Addr;
+    return ((0U != u32Hz) && (u32Hz <= 400000U)) ? 0 : -1;
+}
+
+
+
+/*--------------------------------------------------*/
+void i2c_master_suspend(void)
+{
+}
+
+
+
+/*--------------------------------------------------*/
+void i2c_master_resume(void)
+{
+}
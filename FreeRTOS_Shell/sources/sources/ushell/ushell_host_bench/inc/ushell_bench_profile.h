@@ -0,0 +1,13 @@
+#ifndef USHELL_BENCH_PROFILE_H
+#define USHELL_BENCH_PROFILE_H
+
+#include <stddef.h>
+
+/* the largest table on the core of the minimal profile, in the same executable as the full
+   shell: ushell_minimal::Microshell of ushell_core_profile(minimal ...), the same handlers */
+size_t benchProfileShellSize(void);
+
+/* ExecuteBatch() of one line on that shell */
+int benchProfileExecute(const char *pstrLine);
+
+#endif /* USHELL_BENCH_PROFILE_H */
@@ -0,0 +1,34 @@
+#ifndef USHELL_KEY_STREAM_H
+#define USHELL_KEY_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* what one key stream cost the shell; the output of a key is what the shell wrote
+   between the read of that key and the read of the next one, its echo the part of it up to
+   the line end of an entered line (the rest is the command or shortcut the line ran) */
+typedef struct {
+    size_t szKeys;              /* bytes read by the shell, the exit keys not counted */
+    size_t szOut;               /* bytes written to the transport */
+    size_t szRedraws;           /* keys whose output went back to the line start ('\r') */
+    size_t szWorstOut;          /* largest output of a single key ... */
+    size_t szWorstOutAt;        /* ... and the offset of that key in the stream */
+    size_t szWorstEcho;         /* largest echo / redraw of a single key ... */
+    size_t szWorstEchoAt;       /* ... and the offset of that key */
+    double dWorstSec;           /* longest time between two reads ... */
+    size_t szWorstSecAt;        /* ... and the offset of the key it was spent on */
+    double dSec;                /* time in Run() */
+} keyStreamStats_s;
+
+/* one Run() of a fresh shell over the keys, the input line is entered and the shell
+   asked to exit once they are consumed (in the middle of any sequence) */
+void keyStreamRun(const uint8_t *pu8Keys, const size_t szLen, keyStreamStats_s *psStats, const bool bTimed);
+
+/* the same keys through Start() and Poll(), a few bytes per call as from a superloop: the
+   output is the one of keyStreamRun() (the escape sequences never time out, as there) */
+void keyStreamPoll(const uint8_t *pu8Keys, const size_t szLen, keyStreamStats_s *psStats);
+
+/* uSHELL_PRINTF output dropped (it is printf on the host), the transport is never shown */
+void keyStreamMute(const bool bMute);
+
+#endif /* USHELL_KEY_STREAM_H */
@@ -0,0 +1,22 @@
+#ifndef USHELL_ROOT_DATATYPES_H
+#define USHELL_ROOT_DATATYPES_H
+
+/* plugin configuration of the host benchmark: ushell_root_interface.cpp built against the
+   synthetic tables (ushell_bench_commands.cfg is generated per table size by the CMakeLists) */
+
+#include "ushell_core_settings.h"
+
+#define uSHELL_COMMANDS_CONFIG_FILE              "ushell_bench_commands.cfg"
+#if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
+#define uSHELL_USER_SHORTCUTS_CONFIG_FILE        "ushell_bench_shortcuts.cfg"
+#endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+#define uSHELL_SCRIPTS_CONFIG_FILE               "ushell_bench_scripts.cfg"
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+#define uSHELL_COMPLETIONS_CONFIG_FILE           "ushell_bench_completions.cfg"
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+
+#include "ushell_core_datatypes_user.h"
+
+#endif /* USHELL_ROOT_DATATYPES_H */
@@ -0,0 +1,36 @@
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+#include "ushell_root_datatypes.h"
+
+/* the handlers of the largest table, they only take their parameters: the time measured is the shell's */
+#define  BENCH_HANDLER_v(a)                             int a(void) { return 0; }
+#define  BENCH_HANDLER_ii(a)                            int a(num32_t u32First, num32_t u32Second) { return (int)((u32First ^ u32Second) & 0x7FFFU); }
+#define  BENCH_HANDLER_s(a)                             int a(str_t *pstrText) { return (int)(pstrText[0] & 0x7F); }
+
+#define  uSHELL_COMMANDS_TABLE_BEGIN
+#define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+#define  uSHELL_COMMAND(a,b,c)                          BENCH_HANDLER_##b(a)
+#define  uSHELL_COMMANDS_TABLE_END
+#include uSHELL_COMMANDS_CONFIG_FILE
+#undef   uSHELL_COMMANDS_TABLE_BEGIN
+#undef   uSHELL_COMMAND_PARAMS_PATTERN
+#undef   uSHELL_COMMAND
+#undef   uSHELL_COMMANDS_TABLE_END
+
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+/* one step (LEN 1 | IDX 0: cmd0, no arguments) and the end, as ush2bc.py writes it */
+extern const uint8_t g_vu8Script_bench[] = {
+    0x01, 0x00,
+    0x00
+};
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
+void uShellUserHandleShortcut_Dot(const char *pstrArgs) {
+    (void)pstrArgs;
+}
+
+void uShellUserHandleShortcut_Bang(const char *pstrArgs) {
+    (void)pstrArgs;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
@@ -0,0 +1,312 @@
+/*
+    uShell host benchmark: operations per second of the core paths, for each synthetic table
+
+        ushell_host_bench [ms per measure] [-v]
+
+        lookup      ExecuteBatch("cmdN"), every v command of the table in turn
+        miss        ExecuteBatch() of a name which is not in the table
+        parse       ExecuteBatch() of the ii ("cmdN 0x1234 5678") and s ("cmdN text") commands
+        complete    every command name typed key by key (autocomplete on each key), then erased
+        hist add    Execute() of the v commands: parse, run and the history write
+        recall      arrow up through a full history (the keys through the transport, as typed)
+
+    The last row is the largest table on the minimal profile core (ushell_bench_profile.cpp),
+    linked in the same executable: the size of its Microshell, lookup and parse.
+
+    The shell output (the transport and stdout) is dropped while measuring, -v shows it.
+*/
+
+#include "ushell_core.h"
+#include "ushell_core_keys.h"
+#include "ushell_bench_tables.h"
+#include "ushell_bench_profile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#define BENCH_NULL_DEVICE                               "NUL"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define BENCH_NULL_DEVICE                               "/dev/null"
+#endif /*defined(_WIN32)*/
+
+#define BENCH_DEFAULT_MS                                200
+#define BENCH_MISS_PER_ROUND                            64
+#define BENCH_HISTORY_FILL                              16      /* entries recalled in a loop */
+#define BENCH_RECALLS_PER_ROUND                         512
+
+/* one plugin per table size, ushell_root_interface.cpp built with pluginEntry renamed */
+#define  USHELL_BENCH_TABLE(n)                          uShellInst_s *uShellBenchEntry_##n(void);
+USHELL_BENCH_TABLES
+#undef   USHELL_BENCH_TABLE
+
+typedef struct {
+    int iSize;
+    uShellInst_s *(*pfEntry)(void);
+} benchTable_s;
+
+#define  USHELL_BENCH_TABLE(n)                          { n, uShellBenchEntry_##n },
+static const benchTable_s g_vsTables[] = { USHELL_BENCH_TABLES };
+#undef   USHELL_BENCH_TABLE
+
+
+/*==============================================================================
+            transport: scripted keys in, output dropped
+==============================================================================*/
+
+static std::string s_strKeys;
+static size_t s_szKeyPos = 0U;
+
+/* past the script the shell is asked to exit, so a Run() always returns */
+static const char s_vstrExit[] = { '#', 'q', (char)uSHELL_KEY_ENTER };
+
+static int benchRead(uint8_t *pu8Buf, const size_t szLen, const uint32_t u32TimeoutMs) {
+    (void)u32TimeoutMs;
+    for (size_t i = 0U; i < szLen; ++i) {
+        if (s_szKeyPos < s_strKeys.size()) {
+            pu8Buf[i] = (uint8_t)s_strKeys[s_szKeyPos];
+        } else {
+            pu8Buf[i] = (uint8_t)s_vstrExit[(s_szKeyPos - s_strKeys.size()) % sizeof(s_vstrExit)];
+        }
+        ++s_szKeyPos;
+    }
+    return (int)szLen;
+}
+
+static bool s_bVerbose = false;
+
+static void benchWrite(const uint8_t *pu8Buf, const size_t szLen) {
+    if (true == s_bVerbose) {
+        (void)fwrite(pu8Buf, 1U, szLen, stdout);
+    }
+}
+
+static const uShellTransport_s s_sBenchTransport = { benchRead, benchWrite, nullptr };
+
+
+/*==============================================================================
+            stdout muted while measuring (uSHELL_PRINTF is printf on the host)
+==============================================================================*/
+
+static int s_iStdout = -1;
+static int s_iNull = -1;
+
+static void benchMute(const bool bMute) {
+    if ((true == s_bVerbose) || (s_iNull < 0)) {
+        return;
+    }
+    fflush(stdout);
+    dup2(bMute ? s_iNull : s_iStdout, fileno(stdout));
+}
+
+
+/*==============================================================================
+            measures
+==============================================================================*/
+
+typedef std::chrono::steady_clock benchClock;
+
+/* repeats a round (it returns the operations it did and adds its own time) for iMs at least */
+template <typename T>
+static double benchRate(const int iMs, T &&fRound) {
+    const auto budget = std::chrono::milliseconds(iMs);
+    benchClock::duration elapsed = benchClock::duration::zero();
+    uint64_t u64Ops = 0U;
+
+    while (elapsed < budget) {
+        u64Ops += fRound(elapsed);
+    }
+    return (double)u64Ops / std::chrono::duration<double>(elapsed).count();
+}
+
+static std::unique_ptr<Microshell> benchShell(const benchTable_s &sTable) {
+    auto pShell = std::make_unique<Microshell>(sTable.pfEntry(), "bench");
+    pShell->SetTransport(&s_sBenchTransport);
+    return pShell;
+}
+
+/* one Run() over s_strKeys, the exit keys follow */
+static void benchRun(Microshell &shell, uShellInst_s *psInst, benchClock::duration &elapsed) {
+    s_szKeyPos = 0U;
+    psInst->bKeepRuning = true;
+    const auto start = benchClock::now();
+    shell.Run();
+    elapsed += benchClock::now() - start;
+}
+
+static void benchTableRow(const benchTable_s &sTable, const int iMs) {
+    std::vector<std::string> vstrLookup;
+    std::vector<std::string> vstrParse;
+    std::vector<std::string> vstrNames;
+
+    /* the layout of the generated table: v, then ii, then s commands */
+    for (int i = 0; i < sTable.iSize; ++i) {
+        const std::string strName = "cmd" + std::to_string(i);
+        vstrNames.push_back(strName);
+        if (i < (sTable.iSize / 2)) {
+            vstrLookup.push_back(strName);
+        } else if (i < ((sTable.iSize / 2) + (sTable.iSize / 4))) {
+            vstrParse.push_back(strName + " 0x1234 5678");
+        } else {
+            vstrParse.push_back(strName + " text");
+        }
+    }
+
+    benchMute(true);
+    auto pShell = benchShell(sTable);
+    Microshell &shell = *pShell;
+
+    const double dLookup = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        const auto start = benchClock::now();
+        for (const std::string &strLine : vstrLookup) {
+            (void)shell.ExecuteBatch(strLine.c_str(), nullptr, 0);
+        }
+        elapsed += benchClock::now() - start;
+        return vstrLookup.size();
+    });
+
+    const double dMiss = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        const auto start = benchClock::now();
+        for (int i = 0; i < BENCH_MISS_PER_ROUND; ++i) {
+            (void)shell.ExecuteBatch("nosuchcmd", nullptr, 0);
+        }
+        elapsed += benchClock::now() - start;
+        return BENCH_MISS_PER_ROUND;
+    });
+
+    const double dParse = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        const auto start = benchClock::now();
+        for (const std::string &strLine : vstrParse) {
+            (void)shell.ExecuteBatch(strLine.c_str(), nullptr, 0);
+        }
+        elapsed += benchClock::now() - start;
+        return vstrParse.size();
+    });
+
+    const double dHistAdd = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        const auto start = benchClock::now();
+        for (const std::string &strLine : vstrLookup) {
+            (void)shell.Execute(strLine.c_str());
+        }
+        elapsed += benchClock::now() - start;
+        return vstrLookup.size();
+    });
+    pShell.reset();
+
+    /* every name typed and erased again, the autocomplete may have added to the line */
+    s_strKeys.clear();
+    for (const std::string &strName : vstrNames) {
+        s_strKeys += strName;
+        s_strKeys.append(uSHELL_MAX_INPUT_BUF_LEN / 4U, (char)uSHELL_KEY_BACKSPACE);
+    }
+    const double dComplete = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        auto pRunShell = benchShell(sTable);
+        benchRun(*pRunShell, sTable.pfEntry(), elapsed);
+        return vstrNames.size();
+    });
+
+    /* arrow up across the history, the recalled line is erased before the exit */
+    s_strKeys.clear();
+    for (int i = 0; i < BENCH_RECALLS_PER_ROUND; ++i) {
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+        s_strKeys += (char)uSHELL_KEY_ESCAPESEQ;
+#else
+        s_strKeys += (char)uSHELL_KEY_ESCAPESEQ;
+        s_strKeys += (char)uSHELL_KEY_LEFT_BRACKET;
+#endif /*(defined(__MINGW32__) || defined(_MSC_VER))*/
+        s_strKeys += (char)uSHELL_KEY_ESCAPESEQ_ARROW_UP;
+    }
+    s_strKeys.append(uSHELL_MAX_INPUT_BUF_LEN / 4U, (char)uSHELL_KEY_BACKSPACE);
+    const double dRecall = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        auto pRunShell = benchShell(sTable);
+        for (int i = 0; (i < BENCH_HISTORY_FILL) && (i < (int)vstrLookup.size()); ++i) {
+            (void)pRunShell->Execute(vstrLookup[(size_t)i].c_str());
+        }
+        benchRun(*pRunShell, sTable.pfEntry(), elapsed);
+        return BENCH_RECALLS_PER_ROUND;
+    });
+    benchMute(false);
+
+    printf("%8d %11.0f %11.0f %11.0f %11.0f %11.0f %11.0f\n",
+           sTable.iSize, dLookup, dMiss, dParse, dComplete, dHistAdd, dRecall);
+}
+
+
+static void benchProfileRow(const benchTable_s &sTable, const int iMs) {
+    std::vector<std::string> vstrLookup;
+    std::vector<std::string> vstrParse;
+
+    for (int i = 0; i < sTable.iSize; ++i) {
+        const std::string strName = "cmd" + std::to_string(i);
+        if (i < (sTable.iSize / 2)) {
+            vstrLookup.push_back(strName);
+        } else if (i < ((sTable.iSize / 2) + (sTable.iSize / 4))) {
+            vstrParse.push_back(strName + " 0x1234 5678");
+        } else {
+            vstrParse.push_back(strName + " text");
+        }
+    }
+
+    benchMute(true);
+    const double dLookup = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        const auto start = benchClock::now();
+        for (const std::string &strLine : vstrLookup) {
+            (void)benchProfileExecute(strLine.c_str());
+        }
+        elapsed += benchClock::now() - start;
+        return vstrLookup.size();
+    });
+
+    const double dParse = benchRate(iMs, [&](benchClock::duration &elapsed) -> uint64_t {
+        const auto start = benchClock::now();
+        for (const std::string &strLine : vstrParse) {
+            (void)benchProfileExecute(strLine.c_str());
+        }
+        elapsed += benchClock::now() - start;
+        return vstrParse.size();
+    });
+    benchMute(false);
+
+    printf("%8d %11.0f %11s %11.0f   minimal profile, Microshell %zu bytes (full %zu)\n",
+           sTable.iSize, dLookup, "-", dParse, benchProfileShellSize(), sizeof(Microshell));
+}
+
+
+/*==============================================================================
+            main
+==============================================================================*/
+
+int main(int argc, char *argv[]) {
+    int iMs = BENCH_DEFAULT_MS;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp(argv[i], "-v")) {
+            s_bVerbose = true;
+        } else if (atoi(argv[i]) > 0) {
+            iMs = atoi(argv[i]);
+        } else {
+            fprintf(stderr, "usage: %s [ms per measure] [-v]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    s_iStdout = dup(fileno(stdout));
+    s_iNull = open(BENCH_NULL_DEVICE, O_WRONLY);
+
+    printf("uShell %s host benchmark, %d ms per measure, operations per second\n", uSHELL_VERSION, iMs);
+    printf("%8s %11s %11s %11s %11s %11s %11s\n", "commands", "lookup", "miss", "parse", "complete", "hist add", "recall");
+    for (const benchTable_s &sTable : g_vsTables) {
+        benchTableRow(sTable, iMs);
+    }
+    benchProfileRow(g_vsTables[uSHELL_NR_ELEMS(g_vsTables) - 1], iMs);
+    return 0;
+}
@@ -0,0 +1,23 @@
+/*
+    The minimal profile shell of the benchmark, built with uSHELL_NAMESPACE=ushell_minimal and
+    uSHELL_PROFILE_FILE="ushell_core_profile_minimal.h": the names of the core below are those
+    of ushell_minimal, the plugin is the firmware one with pluginEntry renamed.
+*/
+
+#include "ushell_core.h"
+#include "ushell_bench_profile.h"
+
+uShellInst_s *uShellBenchMinimalEntry(void);
+
+static Microshell *benchProfileShell(void) {
+    static Microshell sShell(uShellBenchMinimalEntry(), "minimal");
+    return &sShell;
+}
+
+size_t benchProfileShellSize(void) {
+    return sizeof(Microshell);
+}
+
+int benchProfileExecute(const char *pstrLine) {
+    return benchProfileShell()->ExecuteBatch(pstrLine, nullptr, 0);
+}
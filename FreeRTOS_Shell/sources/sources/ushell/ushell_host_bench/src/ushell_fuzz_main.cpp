@@ -0,0 +1,74 @@
+/*
+    uShell key stream fuzzer: random bytes into the input state machine of the host build
+    (m_CoreProcessKeyPress, the escape sequences, edit mode, history search, binary frames)
+
+        libFuzzer   clang, -DUSHELL_FUZZ_LIBFUZZER=ON:  ushell_fuzz [corpus dir] [libFuzzer options]
+        AFL         CXX=afl-clang-fast++:               afl-fuzz -i sessions -o out -- ushell_fuzz @@
+        plain       ushell_fuzz <file>...  (or the stdin), every stream once
+
+    Beside the sanitizer findings a key whose echo is larger than USHELL_FUZZ_MAX_KEY_OUT
+    is a crash as well: that is a pathological redraw, several lines rewritten for one byte.
+    What a command or a shortcut prints once its line is entered is not echo (### of the
+    seed corpus lists the whole table).
+*/
+
+#include "ushell_key_stream.h"
+#include "ushell_core_settings.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/* four full lines: prompt, input and the colour / cursor sequences around them */
+#define USHELL_FUZZ_MAX_KEY_OUT                         (4U * (uSHELL_MAX_INPUT_BUF_LEN + uSHELL_PROMPT_MAX_LEN + 32U))
+#define USHELL_FUZZ_MAX_INPUT                           (4096U)
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    (void)argc;
+    (void)argv;
+    keyStreamMute(true);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *pu8Data, size_t szSize) {
+    if (szSize > USHELL_FUZZ_MAX_INPUT) {
+        return -1;                                      /* longer streams only repeat the state */
+    }
+    keyStreamStats_s sStats = {};
+    keyStreamRun(pu8Data, szSize, &sStats, false);
+    if (sStats.szWorstEcho > USHELL_FUZZ_MAX_KEY_OUT) {
+        fprintf(stderr, "ushell_fuzz: %zu bytes of echo for the key at %zu (limit %u)\n",
+                sStats.szWorstEcho, sStats.szWorstEchoAt, (unsigned)USHELL_FUZZ_MAX_KEY_OUT);
+        abort();
+    }
+    return 0;
+}
+
+#if !defined(USHELL_FUZZ_LIBFUZZER)
+static bool fuzzRunFile(FILE *pFile) {
+    std::vector<uint8_t> vu8Data;
+    int iChar;
+    while (EOF != (iChar = fgetc(pFile))) {
+        vu8Data.push_back((uint8_t)iChar);
+    }
+    (void)LLVMFuzzerTestOneInput(vu8Data.data(), vu8Data.size());
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    (void)LLVMFuzzerInitialize(&argc, &argv);
+    if (argc < 2) {
+        return fuzzRunFile(stdin) ? 0 : 1;
+    }
+    for (int i = 1; i < argc; ++i) {
+        FILE *pFile = fopen(argv[i], "rb");
+        if (nullptr == pFile) {
+            fprintf(stderr, "ushell_fuzz: cannot open %s\n", argv[i]);
+            return 1;
+        }
+        (void)fuzzRunFile(pFile);
+        fclose(pFile);
+    }
+    return 0;
+}
+#endif /*!defined(USHELL_FUZZ_LIBFUZZER)*/
@@ -0,0 +1,187 @@
+/*
+    key stream transport of the fuzzer and the replay: the shell reads the keys of a buffer,
+    the output is counted per key and dropped
+*/
+
+#include "ushell_key_stream.h"
+#include "ushell_core.h"
+#include "ushell_core_keys.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#define KEY_STREAM_NULL_DEVICE                          "NUL"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define KEY_STREAM_NULL_DEVICE                          "/dev/null"
+#endif /*defined(_WIN32)*/
+
+/* the plugin the streams run on, the largest table of the bench (USHELL_FUZZ_ENTRY) */
+uShellInst_s *USHELL_FUZZ_ENTRY(void);
+
+typedef std::chrono::steady_clock keyStreamClock;
+
+static const uint8_t *s_pu8Keys = nullptr;
+static size_t s_szLen = 0U;
+static size_t s_szPos = 0U;
+static bool s_bTimed = false;
+static bool s_bPolled = false;          /* Poll(): the loop of keyStreamPoll() ends past the stream */
+static uShellInst_s *s_psInst = nullptr;
+static keyStreamStats_s *s_psStats = nullptr;
+static size_t s_szKeyOut = 0U;          /* output of the key read last */
+static size_t s_szKeyEcho = 0U;         /* ... of it, up to the line end of an entered line */
+static bool s_bKeyRan = false;          /* the key entered a line: the rest is not echo */
+static bool s_bKeyRedraw = false;
+static keyStreamClock::time_point s_tLastRead;
+
+/* the output and the time since the previous read belong to the key read then */
+static void keyStreamCloseKey(void) {
+    if (0U == s_szPos) {
+        return;
+    }
+    const size_t szAt = s_szPos - 1U;
+    if (s_szKeyOut > s_psStats->szWorstOut) {
+        s_psStats->szWorstOut = s_szKeyOut;
+        s_psStats->szWorstOutAt = szAt;
+    }
+    if (s_szKeyEcho > s_psStats->szWorstEcho) {
+        s_psStats->szWorstEcho = s_szKeyEcho;
+        s_psStats->szWorstEchoAt = szAt;
+    }
+    if (true == s_bKeyRedraw) {
+        ++s_psStats->szRedraws;
+    }
+    if (true == s_bTimed) {
+        const keyStreamClock::time_point tNow = keyStreamClock::now();
+        const double dSec = std::chrono::duration<double>(tNow - s_tLastRead).count();
+        if (dSec > s_psStats->dWorstSec) {
+            s_psStats->dWorstSec = dSec;
+            s_psStats->szWorstSecAt = szAt;
+        }
+        s_tLastRead = tNow;
+    }
+    s_szKeyOut = 0U;
+    s_szKeyEcho = 0U;
+    s_bKeyRan = false;
+    s_bKeyRedraw = false;
+}
+
+static int keyStreamRead(uint8_t *pu8Buf, const size_t szLen, const uint32_t u32TimeoutMs) {
+    (void)u32TimeoutMs;
+    keyStreamCloseKey();
+    for (size_t i = 0U; i < szLen; ++i) {
+        if (s_szPos < s_szLen) {
+            pu8Buf[i] = s_pu8Keys[s_szPos];
+            ++s_psStats->szKeys;
+        } else {
+            /* past the stream: the line is entered and the loop of Run() ends after it */
+            pu8Buf[i] = (uint8_t)uSHELL_KEY_ENTER;
+            s_psInst->bKeepRuning = s_bPolled;
+        }
+        ++s_szPos;
+    }
+    return (int)szLen;
+}
+
+static void keyStreamWrite(const uint8_t *pu8Buf, const size_t szLen) {
+    s_psStats->szOut += szLen;
+    s_szKeyOut += szLen;
+    if (false == s_bKeyRan) {
+        /* the line end the shell writes before it runs the line (uSHELL_NEWLINE) */
+        const uint8_t *pu8End = (const uint8_t *)memchr(pu8Buf, '\n', szLen);
+        s_szKeyEcho += (nullptr != pu8End) ? ((size_t)(pu8End - pu8Buf) + 1U) : szLen;
+        s_bKeyRan = (nullptr != pu8End);
+    }
+    if (nullptr != memchr(pu8Buf, '\r', szLen)) {
+        s_bKeyRedraw = true;
+    }
+}
+
+static const uShellTransport_s s_sKeyStreamTransport = { keyStreamRead, keyStreamWrite, nullptr };
+
+/* Poll(): what has "arrived", 1 to KEY_STREAM_POLL_SLICE bytes in turn, never waits */
+#define KEY_STREAM_POLL_SLICE                           7U
+static size_t s_szSlice = 0U;
+
+static int keyStreamReadNow(uint8_t *pu8Buf, const size_t szLen, const uint32_t u32TimeoutMs) {
+    s_szSlice = (s_szSlice % KEY_STREAM_POLL_SLICE) + 1U;
+    const size_t szLeft = (s_szPos < s_szLen) ? (s_szLen - s_szPos) : 1U;   /* then the enter */
+    size_t szNow = (szLen < s_szSlice) ? szLen : s_szSlice;
+    szNow = (szNow < szLeft) ? szNow : szLeft;
+    return keyStreamRead(pu8Buf, szNow, u32TimeoutMs);
+}
+
+static const uShellTransport_s s_sKeyStreamPollTransport = { keyStreamReadNow, keyStreamWrite, nullptr };
+
+/*--------------------------------------------------*/
+void keyStreamRun(const uint8_t *pu8Keys, const size_t szLen, keyStreamStats_s *psStats, const bool bTimed) {
+    s_pu8Keys = pu8Keys;
+    s_szLen = szLen;
+    s_szPos = 0U;
+    s_bTimed = bTimed;
+    s_bPolled = false;
+    s_psStats = psStats;
+    s_szKeyOut = 0U;
+    s_szKeyEcho = 0U;
+    s_bKeyRan = false;
+    s_bKeyRedraw = false;
+    s_psInst = USHELL_FUZZ_ENTRY();
+
+    Microshell shell(s_psInst, "fuzz");
+    shell.SetTransport(&s_sKeyStreamTransport);
+    s_psInst->bKeepRuning = true;
+
+    const keyStreamClock::time_point tStart = keyStreamClock::now();
+    s_tLastRead = tStart;
+    shell.Run();
+    keyStreamCloseKey();
+    psStats->dSec += std::chrono::duration<double>(keyStreamClock::now() - tStart).count();
+} /* keyStreamRun() */
+
+/*--------------------------------------------------*/
+void keyStreamPoll(const uint8_t *pu8Keys, const size_t szLen, keyStreamStats_s *psStats) {
+    s_pu8Keys = pu8Keys;
+    s_szLen = szLen;
+    s_szPos = 0U;
+    s_bTimed = false;
+    s_bPolled = true;
+    s_psStats = psStats;
+    s_szKeyOut = 0U;
+    s_szKeyEcho = 0U;
+    s_bKeyRan = false;
+    s_bKeyRedraw = false;
+    s_szSlice = 0U;
+    s_psInst = USHELL_FUZZ_ENTRY();
+
+    Microshell shell(s_psInst, "fuzz");
+    shell.SetTransport(&s_sKeyStreamPollTransport);
+    s_psInst->bKeepRuning = true;
+
+    const keyStreamClock::time_point tStart = keyStreamClock::now();
+    shell.Start();
+    while ((s_szPos <= s_szLen) && shell.Poll(0U)) {
+    }
+    keyStreamCloseKey();
+    psStats->dSec += std::chrono::duration<double>(keyStreamClock::now() - tStart).count();
+} /* keyStreamPoll() */
+
+/*--------------------------------------------------*/
+void keyStreamMute(const bool bMute) {
+    static int s_iStdout = -1;
+    static int s_iNull = -1;
+
+    if (s_iStdout < 0) {
+        s_iStdout = dup(fileno(stdout));
+        s_iNull = open(KEY_STREAM_NULL_DEVICE, O_WRONLY);
+    }
+    if ((s_iStdout < 0) || (s_iNull < 0)) {
+        return;
+    }
+    fflush(stdout);
+    dup2(bMute ? s_iNull : s_iStdout, fileno(stdout));
+} /* keyStreamMute() */
@@ -0,0 +1,93 @@
+/*
+    uShell session replay: captured operator key streams fed to the shell at the full rate
+
+        ushell_replay [-n rounds] <session>...      (the .keys files of sessions/, raw bytes as typed)
+
+        keys/s      input bytes processed per second, Run() of a fresh shell per round
+        out/key     bytes written back per input byte
+        redraws     keys whose output went back to the line start: every one is a full line
+        worst out   the largest output of one key, with its offset in the session
+        worst us    the longest single key, with its offset (the timer read on every key)
+
+    A session that drops in keys/s or gains redraws after a change points at a slow path:
+    the offsets tell which key of the session, the bytes around it tell the sequence.
+    Each session is fed once more through Poll() in small slices; an output of another
+    size than the one of Run() fails the replay.
+*/
+
+#include "ushell_key_stream.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#define REPLAY_DEFAULT_ROUNDS                           200
+
+static bool replayLoad(const char *pstrPath, std::vector<uint8_t> &vu8Keys) {
+    FILE *pFile = fopen(pstrPath, "rb");
+    if (nullptr == pFile) {
+        return false;
+    }
+    int iChar;
+    while (EOF != (iChar = fgetc(pFile))) {
+        vu8Keys.push_back((uint8_t)iChar);
+    }
+    fclose(pFile);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    int iRounds = REPLAY_DEFAULT_ROUNDS;
+    std::vector<const char *> vpstrSessions;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((0 == strcmp(argv[i], "-n")) && ((i + 1) < argc) && (atoi(argv[i + 1]) > 0)) {
+            iRounds = atoi(argv[++i]);
+        } else if ('-' != argv[i][0]) {
+            vpstrSessions.push_back(argv[i]);
+        } else {
+            vpstrSessions.clear();
+            break;
+        }
+    }
+    if (vpstrSessions.empty()) {
+        fprintf(stderr, "usage: %s [-n rounds] <session>...\n", argv[0]);
+        return 1;
+    }
+
+    printf("uShell session replay, %d rounds per session\n", iRounds);
+    printf("%-24s %7s %11s %8s %8s %15s %15s\n", "session", "keys", "keys/s", "out/key", "redraws", "worst out @", "worst us @");
+    for (const char *pstrSession : vpstrSessions) {
+        std::vector<uint8_t> vu8Keys;
+        if ((false == replayLoad(pstrSession, vu8Keys)) || vu8Keys.empty()) {
+            fprintf(stderr, "ushell_replay: cannot read %s\n", pstrSession);
+            return 1;
+        }
+
+        /* the rates untimed, the worst key from one timed round */
+        keyStreamStats_s sRate = {};
+        keyStreamStats_s sTimed = {};
+        keyStreamMute(true);
+        for (int i = 0; i < iRounds; ++i) {
+            keyStreamRun(vu8Keys.data(), vu8Keys.size(), &sRate, false);
+        }
+        keyStreamRun(vu8Keys.data(), vu8Keys.size(), &sTimed, true);
+        keyStreamStats_s sPoll = {};
+        keyStreamPoll(vu8Keys.data(), vu8Keys.size(), &sPoll);
+        keyStreamMute(false);
+        if ((sPoll.szKeys != sTimed.szKeys) || (sPoll.szOut != sTimed.szOut)) {
+            fprintf(stderr, "ushell_replay: %s through Poll(): %zu keys %zu out, Run(): %zu keys %zu out\n",
+                    pstrSession, sPoll.szKeys, sPoll.szOut, sTimed.szKeys, sTimed.szOut);
+            return 1;
+        }
+
+        const char *pstrName = strrchr(pstrSession, '/');
+        printf("%-24s %7zu %11.0f %8.2f %8zu %8zu @%5zu %8.1f @%5zu\n",
+               (nullptr != pstrName) ? (pstrName + 1) : pstrSession, vu8Keys.size(),
+               (double)sRate.szKeys / sRate.dSec, (double)sRate.szOut / (double)sRate.szKeys,
+               sTimed.szRedraws, sTimed.szWorstOut, sTimed.szWorstOutAt,
+               sTimed.dWorstSec * 1e6, sTimed.szWorstSecAt);
+    }
+    return 0;
+}
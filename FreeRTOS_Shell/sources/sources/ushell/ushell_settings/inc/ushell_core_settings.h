@@ -11,7 +11,10 @@
 /* major features */
 #define uSHELL_IMPLEMENTS_HISTORY                1
 #define uSHELL_IMPLEMENTS_SAVE_HISTORY           0
+#define uSHELL_IMPLEMENTS_HISTORY_STORE          1  /* persistent history backend of an instance (SetHistoryStore) */
+#define uSHELL_IMPLEMENTS_HISTORY_SEARCH         1  /* incremental reverse search of the history (Ctrl-R) */
 #define uSHELL_IMPLEMENTS_AUTOCOMPLETE           1
+#define uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL       1  /* parameters completed from the values of the completions table */
 #define uSHELL_IMPLEMENTS_EDITMODE               1
 #define uSHELL_IMPLEMENTS_SMART_PROMPT           1
 #define uSHELL_IMPLEMENTS_COMMAND_HELP           1
@@ -22,18 +25,58 @@
 #define uSHELL_IMPLEMENTS_SHELL_EXIT             1
 #define uSHELL_IMPLEMENTS_CONFIRM_REQUEST        0
 #define uSHELL_IMPLEMENTS_DISABLE_ECHO           0
+#define uSHELL_IMPLEMENTS_MACHINE_MODE           1  /* #M|#m: no echo, prompt or colour, one OK|ERR terminator per line, lines pipelined */
+#define uSHELL_IMPLEMENTS_MACHINE_TAGS           1  /* machine lines "<seq> <command>" answered "<seq> <rc>", pending ones when done */
+#define uSHELL_IMPLEMENTS_ASYNC_COMMANDS         1  /* commands may return uSHELL_ERR_PENDING and complete later */
 /* utilities */
 #define uSHELL_IMPLEMENTS_DUMP                   0
 #define uSHELL_IMPLEMENTS_KEY_DECODER            0
 #define uSHELL_IMPLEMENTS_HEXLIFY                1
+/* performance */
+#define uSHELL_IMPLEMENTS_HASHED_LOOKUP          1  /* compile-time hash table for the command lookup */
+#define uSHELL_IMPLEMENTS_PARAMS_DECODER         1  /* compile-time decoded parameters patterns */
+#define uSHELL_IMPLEMENTS_BINARY_MODE            1  /* length-prefixed binary command frames (#b or SOF byte) */
+#define uSHELL_IMPLEMENTS_SCRIPTS                1  /* flash resident precompiled scripts (#r name) */
+#define uSHELL_IMPLEMENTS_TYPED_DISPATCH         1  /* compile-time generated type-safe command thunks */
+#define uSHELL_IMPLEMENTS_LINE_BURST             1  /* complete buffered lines bypass the per key handling */
+#define uSHELL_IMPLEMENTS_ESCAPE_DECODER         1  /* escape sequences decoded byte by byte by a compile-time trie, a lone ESC times out */
+#define uSHELL_IMPLEMENTS_TRANSPORT              1  /* per instance console backend with bulk read/write */
+#define uSHELL_IMPLEMENTS_FEED                   1  /* Feed(): input pushed by the caller in chunks (an AO) instead of the blocking Run() */
+#define uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE      1  /* literal formats split at compile time (uSHELL_PRINTF_CT) */
+#define uSHELL_IMPLEMENTS_DELTA_RENDER           1  /* input line redrawn by cursor/colour deltas, dumb terminal mode (#t) */
+#define uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL       1  /* compile-time sorted command names, autocomplete ranges by binary search */
+#define uSHELL_IMPLEMENTS_HISTORY_INDEX          1  /* offsets ring of the history entries, indexed access in O(1) */
+#define uSHELL_IMPLEMENTS_HISTORY_COMPRESS       1  /* shared prefixes of the history entries stored once, a repeated command moves to the front */
+#define uSHELL_IMPLEMENTS_COMMAND_STATS          0  /* parse/handler cycles, calls and errors per command (#p) */
+#define uSHELL_IMPLEMENTS_SCRATCH_ARENA          1  /* bump allocator of the handlers (uShellScratchAlloc), released when the handler returns */
+#define uSHELL_IMPLEMENTS_PREPARED_COMMANDS      1  /* Prepare(): a command line parsed once, its handler called again by RunPrepared() */
+#define uSHELL_IMPLEMENTS_LOOPS                  1  /* repeat <n> { ... } and for <var> <from> <to> { ... $var ... }, the body parsed once */
+#define uSHELL_IMPLEMENTS_POSTED_COMMANDS        1  /* Post(): command lines queued by any task or interrupt, run by the shell task between two keys */
+#define uSHELL_IMPLEMENTS_SHORTCUT_TABLE         1  /* compile-time lookup table of the shortcut symbols, a shortcut found in O(1) */
+#define uSHELL_IMPLEMENTS_HOT_SHORTCUTS          1  /* uSHELL_USER_HOT_SHORTCUT: the handler runs on its key, typed on an empty line */
+#define uSHELL_IMPLEMENTS_PACKED_HELP            1  /* help texts packed by the compiler with a table of byte pairs, expanded into the output */
+/* a single precision FPU (__ARM_FP bit 2: the Cortex-M4F of the F411 build, a host build) parses the
+   f parameters in its registers, cheap enough to have them on; without one (the F103) asc2float
+   assembles the float in integers and they are off by default */
+#if !defined(uSHELL_FLOAT_HW)
+#if (defined(__ARM_FP) && (0 != (__ARM_FP & 4))) || !defined(__arm__)
+#define uSHELL_FLOAT_HW                          1
+#else
+#define uSHELL_FLOAT_HW                          0
+#endif /*(defined(__ARM_FP) && (0 != (__ARM_FP & 4))) || !defined(__arm__)*/
+#endif /*!defined(uSHELL_FLOAT_HW)*/
 /* data types */
 #define uSHELL_SUPPORTS_NUMBERS_64BIT            1  /* l (long)   */
 #define uSHELL_SUPPORTS_NUMBERS_32BIT            1  /* i (int)    */
 #define uSHELL_SUPPORTS_NUMBERS_16BIT            0  /* w (word)   */
 #define uSHELL_SUPPORTS_NUMBERS_8BIT             0  /* b (byte)   */
-#define uSHELL_SUPPORTS_NUMBERS_FLOAT            0  /* f (float)  */
+#define uSHELL_SUPPORTS_NUMBERS_FLOAT            uSHELL_FLOAT_HW  /* f (float)  */
+#define uSHELL_SUPPORTS_NUMBERS_FIXED            1  /* q (Q15.16 fixed point, signed) */
 #define uSHELL_SUPPORTS_STRINGS                  1  /* s (string) */
 #define uSHELL_SUPPORTS_BOOLEAN                  1  /* o (bool)   */
+#define uSHELL_SUPPORTS_STRING_VIEWS             1  /* r (range)  */
+#define uSHELL_SUPPORTS_NUMBER_ARRAYS            1  /* a (array of 32 bit numbers, the last parameter) */
+#define uSHELL_SUPPORTS_HEX_BUFFERS              1  /* x (hex string, the bytes decoded in place) */
 #if (1 == uSHELL_SUPPORTS_STRINGS)
 #define uSHELL_SUPPORTS_SPACED_STRINGS           1
 #endif /*(1 == uSHELL_SUPPORTS_STRINGS)*/
@@ -43,14 +86,38 @@
 #define uSHELL_MAX_PARAMS_NUM32                  (5U)
 #define uSHELL_MAX_PARAMS_NUM16                  (0U)
 #define uSHELL_MAX_PARAMS_NUM8                   (0U)
-#define uSHELL_MAX_PARAMS_FLOAT                  (0U)
+#define uSHELL_MAX_PARAMS_FLOAT                  ((1 == uSHELL_FLOAT_HW) ? 2U : 0U)
+#define uSHELL_MAX_PARAMS_FIXED                  (2U)
 #define uSHELL_MAX_PARAMS_STRING                 (5U)
 #define uSHELL_MAX_PARAMS_BOOLEAN                (1U)
+#define uSHELL_MAX_PARAMS_VIEW                   (2U)
+#define uSHELL_MAX_ARRAY_ITEMS                   (16U)  // values of the array parameter, bounded by the input line as well
+#define uSHELL_MAX_PARAMS_HEX                    (1U)
+#define uSHELL_FIXED_FRAC_BITS                   (16U)  // fraction bits of the q parameters, 1.5 -> 0x00018000
 /* implementation specific */
 #define uSHELL_MAX_INPUT_BUF_LEN                 (128U)
 #define uSHELL_PROMPT_MAX_LEN                    (20U)
 #define uSHELL_HISTORY_BUFFER_SIZE               (256) // if set to 0 then the history is disabled
 #define uSHELL_HISTORY_FILEPATH_LENGTH           (32U)
+#define uSHELL_HISTORY_INDEX_DEPTH               (32U)  // entries tracked by the history index, the oldest are dropped beyond
+#define uSHELL_HISTORY_SEARCH_LEN                (24U)  // characters of the Ctrl-R search pattern
+#define uSHELL_ESCAPE_TIMEOUT_MS                 (50U)  // gap after which a started escape sequence is dropped (a lone ESC)
+#define uSHELL_ASYNC_QUEUE_DEPTH                 (4U)   // completions not yet reported (power of 2)
+#define uSHELL_POST_QUEUE_DEPTH                  (2U)   // posted lines not yet run (power of 2)
+/* ushell_core_log.h: uSHELL_LOG_ERROR() .. uSHELL_LOG_TRACE(), levels 1 .. 6 */
+#define uSHELL_LOG_LEVEL_MAX                     (4)    // the levels above are compiled out (debug)
+#define uSHELL_LOG_LEVEL_DEFAULT                 (3)    // the levels above are filtered at start up (info)
+#define uSHELL_LOG_BURST                         (5U)   // lines of a call site per window, the rest counted
+#define uSHELL_LOG_WINDOW_MS                     (1000U)
+#define uSHELL_LOG_TICK_MS()                     (xTaskGetTickCount() * portTICK_PERIOD_MS)  // expanded at the call site (task.h)
+#define uSHELL_SCRATCH_ARENA_SIZE                (256U) // bytes the handler of one command may take from the scratch arena
+#define uSHELL_SCRATCH_ARENA_ALIGN               (8U)   // alignment of every scratch block (power of 2)
+#define uSHELL_LOOP_MAX_STEPS                    (4U)   // commands in the body of a repeat / for
+
+/* overrides of a feature profile, the core built once more by ushell_core_profile() in ushell_core/CMakeLists.txt */
+#if defined(uSHELL_PROFILE_FILE)
+#include uSHELL_PROFILE_FILE
+#endif /* defined(uSHELL_PROFILE_FILE) */
 
 #if (1 == uSHELL_SUPPORTS_COLORS)
 #define uSHELL_PROMPT_COLOR                      "\033[96m"     // Bright Cyan
@@ -78,6 +145,12 @@
 #define uSHELL_RESET_COLOR                       ""
 #endif /* (1 == uSHELL_SUPPORTS_COLORS) */
 
+/* the sequence tags are a part of the machine interface */
+#if (0 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    #undef  uSHELL_IMPLEMENTS_MACHINE_TAGS
+    #define uSHELL_IMPLEMENTS_MACHINE_TAGS       0
+#endif /*(0 == uSHELL_IMPLEMENTS_MACHINE_MODE)*/
+
 /* disable history if no buffer is reserved */
 #if (0 == uSHELL_HISTORY_BUFFER_SIZE)
     #undef  uSHELL_IMPLEMENTS_HISTORY
@@ -112,6 +185,22 @@
     #define uSHELL_SUPPORTS_COLORS               0
 #endif /* (1 == uSHELL_SCRIPT_MODE) */
 
+/* the history index, store, compression and search need the history */
+#if (0 == uSHELL_IMPLEMENTS_HISTORY)
+    #undef  uSHELL_IMPLEMENTS_HISTORY_INDEX
+    #define uSHELL_IMPLEMENTS_HISTORY_INDEX      0
+    #undef  uSHELL_IMPLEMENTS_HISTORY_STORE
+    #define uSHELL_IMPLEMENTS_HISTORY_STORE      0
+    #undef  uSHELL_IMPLEMENTS_HISTORY_COMPRESS
+    #define uSHELL_IMPLEMENTS_HISTORY_COMPRESS   0
+    #undef  uSHELL_IMPLEMENTS_HISTORY_SEARCH
+    #define uSHELL_IMPLEMENTS_HISTORY_SEARCH     0
+#endif /*(0 == uSHELL_IMPLEMENTS_HISTORY)*/
+#if (0 == uSHELL_HISTORY_INDEX_DEPTH)
+    #undef  uSHELL_IMPLEMENTS_HISTORY_INDEX
+    #define uSHELL_IMPLEMENTS_HISTORY_INDEX      0
+#endif /*(0 == uSHELL_HISTORY_INDEX_DEPTH)*/
+
 /* if not explicitely disabled then enable edit mode if autocompl and history are disabled */
 #if ((0 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) && (0 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_EDITMODE))
     #define uSHELL_EDIT_MODE_DEFAULT_ACTIVE
@@ -128,6 +217,72 @@
     #define uSHELL_IMPLEMENTS_CONFIRM_REQUEST    0
 #endif /* ((0 == uSHELL_IMPLEMENTS_HISTORY) && (0 == uSHELL_IMPLEMENTS_SHELL_EXIT)) */
 
+/* the compile-time generated tables need relaxed constexpr (C++14 or newer) */
+#if (defined(__cplusplus) && (__cplusplus < 201402L))
+    #undef uSHELL_IMPLEMENTS_HASHED_LOOKUP
+    #define uSHELL_IMPLEMENTS_HASHED_LOOKUP      0
+    #undef uSHELL_IMPLEMENTS_PARAMS_DECODER
+    #define uSHELL_IMPLEMENTS_PARAMS_DECODER     0
+    #undef uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL
+    #define uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL   0
+    #undef uSHELL_IMPLEMENTS_ESCAPE_DECODER
+    #define uSHELL_IMPLEMENTS_ESCAPE_DECODER     0
+    #undef uSHELL_IMPLEMENTS_SHORTCUT_TABLE
+    #define uSHELL_IMPLEMENTS_SHORTCUT_TABLE     0
+    #undef uSHELL_IMPLEMENTS_PACKED_HELP
+    #define uSHELL_IMPLEMENTS_PACKED_HELP        0
+#endif /* (defined(__cplusplus) && (__cplusplus < 201402L)) */
+
+/* only the help texts are packed */
+#if (0 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+    #undef uSHELL_IMPLEMENTS_PACKED_HELP
+    #define uSHELL_IMPLEMENTS_PACKED_HELP        0
+#endif /* (0 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
+
+/* the hot shortcuts are marked in the shortcut table */
+#if ((0 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE) || (0 == uSHELL_IMPLEMENTS_USER_SHORTCUTS))
+    #undef uSHELL_IMPLEMENTS_HOT_SHORTCUTS
+    #define uSHELL_IMPLEMENTS_HOT_SHORTCUTS      0
+#endif /* ((0 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE) || (0 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)) */
+
+/* the sorted names table and the parameters values serve only the autocomplete */
+#if (0 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    #undef uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL
+    #define uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL   0
+    #undef uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL
+    #define uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL   0
+#endif /* (0 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+
+/* the command thunks are deduced from the functions signatures (auto template parameters, C++17 or newer) */
+#if (defined(__cplusplus) && (__cplusplus < 201703L))
+    #undef uSHELL_IMPLEMENTS_TYPED_DISPATCH
+    #define uSHELL_IMPLEMENTS_TYPED_DISPATCH     0
+#endif /* (defined(__cplusplus) && (__cplusplus < 201703L)) */
+
+/* the formats are template arguments (class non-type template parameters, C++20 or newer) */
+#if (defined(__cplusplus) && (__cplusplus < 202002L))
+    #undef uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE
+    #define uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE  0
+#endif /* (defined(__cplusplus) && (__cplusplus < 202002L)) */
+
+/* binary frames are unpacked using the params decoder */
+#if (0 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+    #undef uSHELL_IMPLEMENTS_BINARY_MODE
+    #define uSHELL_IMPLEMENTS_BINARY_MODE        0
+#endif /* (0 == uSHELL_IMPLEMENTS_PARAMS_DECODER) */
+
+/* precompiled scripts are sequences of binary frames */
+#if (0 == uSHELL_IMPLEMENTS_BINARY_MODE)
+    #undef uSHELL_IMPLEMENTS_SCRIPTS
+    #define uSHELL_IMPLEMENTS_SCRIPTS            0
+#endif /* (0 == uSHELL_IMPLEMENTS_BINARY_MODE) */
+
+/* the loop variable goes into the parameter slots of the params decoder */
+#if (0 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+    #undef uSHELL_IMPLEMENTS_LOOPS
+    #define uSHELL_IMPLEMENTS_LOOPS              0
+#endif /* (0 == uSHELL_IMPLEMENTS_PARAMS_DECODER) */
+
 #if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
     #define uSHELL_INIT_AUTOCOMPL_MODE           true /*true:on, false:off*/
     #define uSHELL_AUTOCOMPL_RELOAD              true
@@ -185,6 +340,14 @@
     #endif /* #if (uSHELL_MAX_PARAMS_FLOAT > 0)*/
 #endif /* #if (1 == uSHELL_SUPPORTS_NUMBERS_FLOAT)*/
 
+/* fixed point is located through the params decoder, parsed in 32 bit integer arithmetic */
+#if ((1 == uSHELL_SUPPORTS_NUMBERS_FIXED) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) && (1 == uSHELL_SUPPORTS_NUMBERS_32BIT))
+    typedef int32_t numq_t;
+    #if (uSHELL_MAX_PARAMS_FIXED > 0)
+        #define uSHELL_IMPLEMENTS_NUMBERS_FIXED
+    #endif /* #if (uSHELL_MAX_PARAMS_FIXED > 0)*/
+#endif /* ((1 == uSHELL_SUPPORTS_NUMBERS_FIXED) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) && (1 == uSHELL_SUPPORTS_NUMBERS_32BIT))*/
+
 #if (1 == uSHELL_SUPPORTS_STRINGS)
     typedef char str_t;
     #if (uSHELL_MAX_PARAMS_STRING > 0)
@@ -199,16 +362,63 @@
     #endif /* #if (uSHELL_MAX_PARAMS_BOOLEAN > 0)*/
 #endif /* #if (1 == uSHELL_SUPPORTS_BOOLEAN)*/
 
+/* views are located through the params decoder */
+#if ((1 == uSHELL_SUPPORTS_STRING_VIEWS) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER))
+    #if (uSHELL_MAX_PARAMS_VIEW > 0)
+        #define uSHELL_IMPLEMENTS_STRING_VIEWS
+    #endif /* #if (uSHELL_MAX_PARAMS_VIEW > 0)*/
+#endif /* ((1 == uSHELL_SUPPORTS_STRING_VIEWS) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER))*/
+
+/* arrays are located through the params decoder as well, their values are 32 bit numbers */
+#if ((1 == uSHELL_SUPPORTS_NUMBER_ARRAYS) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) && (1 == uSHELL_SUPPORTS_NUMBERS_32BIT))
+    #if (uSHELL_MAX_ARRAY_ITEMS > 0)
+        #define uSHELL_IMPLEMENTS_NUMBER_ARRAYS
+    #endif /* #if (uSHELL_MAX_ARRAY_ITEMS > 0)*/
+#endif /* ((1 == uSHELL_SUPPORTS_NUMBER_ARRAYS) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) && (1 == uSHELL_SUPPORTS_NUMBERS_32BIT))*/
+
+/* hex buffers decoded by unhexlify_inplace() */
+#if ((1 == uSHELL_SUPPORTS_HEX_BUFFERS) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) && (1 == uSHELL_IMPLEMENTS_HEXLIFY))
+    #if (uSHELL_MAX_PARAMS_HEX > 0)
+        #define uSHELL_IMPLEMENTS_HEX_BUFFERS
+    #endif /* #if (uSHELL_MAX_PARAMS_HEX > 0)*/
+#endif /* ((1 == uSHELL_SUPPORTS_HEX_BUFFERS) && (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) && (1 == uSHELL_IMPLEMENTS_HEXLIFY))*/
+
 #if !(defined(__linux__) || defined(__MINGW32__) || defined(_MSC_VER))
     #undef uSHELL_IMPLEMENTS_SAVE_HISTORY
     #define uSHELL_IMPLEMENTS_SAVE_HISTORY 0
 #endif /*defined(__linux__) || defined(__MINGW32__) || defined(_MSC_VER)*/
 
+/* the handlers and the values providers of this tree are C functions */
+#define uSHELL_USER_LINKAGE                      extern "C"
+
+/* placement of the hot core paths (key press handling): RAM_FUNC of the port (ram_func.h), else with the code */
+#if !defined(uSHELL_HOT_FUNC)
+    #if defined(RAM_FUNCS) && (RAM_FUNCS == 1)
+        #include "ram_func.h"
+        #define uSHELL_HOT_FUNC                  RAM_FUNC
+    #else
+        #define uSHELL_HOT_FUNC
+    #endif /* defined(RAM_FUNCS) && (RAM_FUNCS == 1) */
+#endif /* !defined(uSHELL_HOT_FUNC) */
+
+/* the probe points of the core on the output of the build (probe.h), else empty */
+#if defined(PROBE_OUT) && (PROBE_OUT != 0) && !defined(uSHELL_PROBE)
+    #include "probe.h"
+    #define uSHELL_PROBE(point)                  PROBE(point)
+#endif /* defined(PROBE_OUT) && (PROBE_OUT != 0) && !defined(uSHELL_PROBE) */
+
+/* cycle counter of the command stats: DWT_CYCCNT, running once the power manager is initialized */
+#if ((1 == uSHELL_IMPLEMENTS_COMMAND_STATS) && !defined(uSHELL_STATS_CYCLES))
+    #define uSHELL_STATS_CYCLES()                (*(volatile uint32_t *)0xE0001004UL)
+#endif /* ((1 == uSHELL_IMPLEMENTS_COMMAND_STATS) && !defined(uSHELL_STATS_CYCLES)) */
+
 /* useful macros */
 #define uSHELL_NR_ELEMS(a) ((int)(sizeof(a)/sizeof(a[0])))
 
 /* configuration files */
 #define uSHELL_DATA_TYPES_CONFIG_FILE  "ushell_core_datatypes.cfg"
 #define uSHELL_PROMPT_CONFIG_FILE      "ushell_core_prompt.cfg"
+#define uSHELL_ESCAPE_CONFIG_FILE      "ushell_core_escape.cfg"
+#define uSHELL_INFO_PAIRS_CONFIG_FILE  "ushell_core_info_pairs.cfg"
 
 #endif /* USHELL_CORE_SETTINGS_H */
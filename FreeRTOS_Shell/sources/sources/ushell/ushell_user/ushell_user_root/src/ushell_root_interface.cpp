@@ -1,10 +1,17 @@
 #include "ushell_core_settings.h"
 #include "ushell_core_datatypes.h"
 #include "ushell_root_datatypes.h"
+#if (defined(TRACE_REC) && (1 == TRACE_REC))
+#include "trace_rec.h"
+#endif /*(defined(TRACE_REC) && (1 == TRACE_REC))*/
+#if ((1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP) || (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) || (1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH) || (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) || (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA) || (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE) || (1 == uSHELL_IMPLEMENTS_PACKED_HELP))
+#include "ushell_core_utils.h"
+#endif /*((1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP) || (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) || (1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH) || (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) || (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA) || (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE) || (1 == uSHELL_IMPLEMENTS_PACKED_HELP))*/
 
 
 /* user commands dispatcher */
 static int uShellExecuteCommand( const command_s *psCmd );
+static int uShellDispatchCommand( const command_s *psCmd );
 
 /* disable warnings */
 #if defined (__GNUC__) && defined(__AVR__)
@@ -12,15 +19,21 @@ static int uShellExecuteCommand( const command_s *psCmd );
     #pragma GCC diagnostic ignored "-Wmissing-braces"
 #endif /*defined (__GNUC__) && defined(__AVR__)*/
 
+#if (0 == uSHELL_IMPLEMENTS_TYPED_DISPATCH)
 #if (defined(__GNUC__) && (defined(__xtensa__) || defined(__ARM_ARCH)))
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-function-type"
 #endif /*(defined(__GNUC__) && defined(__xtensa__))*/
+#endif /*(0 == uSHELL_IMPLEMENTS_TYPED_DISPATCH)*/
 
 /** \brief define array of functions (basic properties) */
-#define  uSHELL_COMMANDS_TABLE_BEGIN                        static const fctDef_s g_vsFuncDefArray[] = {
+#define  uSHELL_COMMANDS_TABLE_BEGIN                        static constexpr fctDef_s g_vsFuncDefArray[] = {
 #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+#define  uSHELL_COMMAND(a,b,c)                                  { #a, #b, (uint8_t)b##_type },
+#else
 #define  uSHELL_COMMAND(a,b,c)                                  { #a, #b },
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
 #define  uSHELL_COMMANDS_TABLE_END                          };
 #include uSHELL_COMMANDS_CONFIG_FILE
 #undef   uSHELL_COMMANDS_TABLE_BEGIN
@@ -28,6 +41,29 @@ static int uShellExecuteCommand( const command_s *psCmd );
 #undef   uSHELL_COMMAND
 #undef   uSHELL_COMMANDS_TABLE_END
 
+#if (1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH)
+/** \brief every command signature must be the one described by its parameters pattern */
+#define  uSHELL_COMMANDS_TABLE_BEGIN
+#define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+#define  uSHELL_COMMAND(a,b,c)                                  static_assert(ushell_thunk_s<a>::matches(#b), "parameters pattern mismatch: " #a);
+#define  uSHELL_COMMANDS_TABLE_END
+#include uSHELL_COMMANDS_CONFIG_FILE
+#undef   uSHELL_COMMANDS_TABLE_BEGIN
+#undef   uSHELL_COMMAND_PARAMS_PATTERN
+#undef   uSHELL_COMMAND
+#undef   uSHELL_COMMANDS_TABLE_END
+
+/** \brief define array of typed thunks (no function pointer casts, small commands get inlined) */
+#define  uSHELL_COMMANDS_TABLE_BEGIN                        static constexpr PFEXEC g_vpfThunksArray[] = {
+#define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+#define  uSHELL_COMMAND(a,b,c)                                  ushell_thunk_s<a>::run,
+#define  uSHELL_COMMANDS_TABLE_END                          };
+#include uSHELL_COMMANDS_CONFIG_FILE
+#undef   uSHELL_COMMANDS_TABLE_BEGIN
+#undef   uSHELL_COMMAND_PARAMS_PATTERN
+#undef   uSHELL_COMMAND
+#undef   uSHELL_COMMANDS_TABLE_END
+#else
 /** \brief define array of functions (extended properties) */
 #define  uSHELL_COMMANDS_TABLE_BEGIN                        static const fctDefEx_s g_vsFuncDefExArray[] = {
 #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
@@ -56,17 +92,69 @@ static int uShellExecuteCommand( const command_s *psCmd );
 #undef   uSHELL_COMMAND_PARAMS_PATTERN
 #undef   uSHELL_COMMAND
 #undef   uSHELL_COMMANDS_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH)*/
 
 /* end of disable warnings */
 #if (defined (__GNUC__) && (defined(__AVR__) || defined(__xtensa__)))
     #pragma GCC diagnostic pop
 #endif /*defined (__GNUC__) && defined(__AVR__)*/
 
+/* decoded parameters patterns, generated at compile time (flash resident) */
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+#define  uSHELL_COMMANDS_TABLE_BEGIN                        static constexpr paramsDecoder_s g_vsParamsDecoderArray[] = {
+#define  uSHELL_COMMAND_PARAMS_PATTERN(t)                       ushell_build_params_decoder(#t),
+#define  uSHELL_COMMAND(a,b,c)
+#define  uSHELL_COMMANDS_TABLE_END                          };
+#include uSHELL_COMMANDS_CONFIG_FILE
+#undef   uSHELL_COMMANDS_TABLE_BEGIN
+#undef   uSHELL_COMMAND_PARAMS_PATTERN
+#undef   uSHELL_COMMAND
+#undef   uSHELL_COMMANDS_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+
+/* command lookup table, generated at compile time (flash resident) */
+#if (1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)
+static constexpr auto g_sFuncHashTable = ushell_build_hash_table(g_vsFuncDefArray);
+#endif /*(1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)*/
+
+/* precompiled scripts, the bytecode is generated from scripts/<name>.ush by the ushell_user_scripts target */
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+#define  uSHELL_SCRIPTS_TABLE_BEGIN
+#define  uSHELL_SCRIPT(a,b)                                     extern const uint8_t g_vu8Script_##a[];
+#define  uSHELL_SCRIPTS_TABLE_END
+#include uSHELL_SCRIPTS_CONFIG_FILE
+#undef   uSHELL_SCRIPTS_TABLE_BEGIN
+#undef   uSHELL_SCRIPT
+#undef   uSHELL_SCRIPTS_TABLE_END
+
+#define  uSHELL_SCRIPTS_TABLE_BEGIN                         static const script_s g_vsScriptsArray[] = {
+#define  uSHELL_SCRIPT(a,b)                                     { #a, b, g_vu8Script_##a },
+#define  uSHELL_SCRIPTS_TABLE_END                           };
+#include uSHELL_SCRIPTS_CONFIG_FILE
+#undef   uSHELL_SCRIPTS_TABLE_BEGIN
+#undef   uSHELL_SCRIPT
+#undef   uSHELL_SCRIPTS_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+
 /* info for functions */
 #if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
-    #define  uSHELL_COMMANDS_TABLE_BEGIN                    static const char* const g_vstrInfoArray[] = {
+#if (1 == uSHELL_IMPLEMENTS_PACKED_HELP)
+    /* packed by the compiler, the plain texts are not kept */
+    #define  uSHELL_COMMANDS_TABLE_BEGIN
     #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+    #define  uSHELL_COMMAND(a,b,c)                              static constexpr auto g_sInfo_##a = ushell_info_pack<ushell_info_packed_size(c)>(c);
+    #define  uSHELL_COMMANDS_TABLE_END
+    #include uSHELL_COMMANDS_CONFIG_FILE
+    #undef   uSHELL_COMMANDS_TABLE_BEGIN
+    #undef   uSHELL_COMMAND_PARAMS_PATTERN
+    #undef   uSHELL_COMMAND
+    #undef   uSHELL_COMMANDS_TABLE_END
+    #define  uSHELL_COMMAND(a,b,c)                              g_sInfo_##a.vstrPacked,
+#else
     #define  uSHELL_COMMAND(a,b,c)                              c,
+#endif /*(1 == uSHELL_IMPLEMENTS_PACKED_HELP)*/
+    #define  uSHELL_COMMANDS_TABLE_BEGIN                    static const char* const g_vstrInfoArray[] = {
+    #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
     #define  uSHELL_COMMANDS_TABLE_END                      };
     #include uSHELL_COMMANDS_CONFIG_FILE
     #undef   uSHELL_COMMANDS_TABLE_BEGIN
@@ -75,19 +163,60 @@ static int uShellExecuteCommand( const command_s *psCmd );
     #undef   uSHELL_COMMANDS_TABLE_END
 #endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
 
-/* autocomplete index array */
-#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-static int g_viAutocompleteIndexArray[uSHELL_NR_ELEMS(g_vsFuncDefArray)] = {0};
-#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+/* autocomplete: command names sorted at compile time (flash resident) or a candidates bitset */
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+static constexpr auto g_sFuncSortedIndex = ushell_build_sorted_index(g_vsFuncDefArray);
+#elif (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+static uint32_t g_vu32AutocompleteSet[uSHELL_AUTOCOMPL_SET_WORDS(uSHELL_NR_ELEMS(g_vsFuncDefArray))] = {0};
+#endif /*(1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)*/
+
+/* parameters autocomplete: the values lists stay in flash, every entry gets a provider */
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+#define  uSHELL_COMPLETIONS_TABLE_BEGIN
+#define  uSHELL_COMPLETION_LIST(a,b,...)                        static const char *const g_vstrCompl_##a##_##b[] = { __VA_ARGS__ }; \
+                                                            static const char *uShellCompl_##a##_##b(int iIndex) { \
+                                                                return (iIndex < uSHELL_NR_ELEMS(g_vstrCompl_##a##_##b)) ? g_vstrCompl_##a##_##b[iIndex] : nullptr; \
+                                                            }
+#define  uSHELL_COMPLETION_FUNC(a,b,c)
+#define  uSHELL_COMPLETIONS_TABLE_END
+#include uSHELL_COMPLETIONS_CONFIG_FILE
+#undef   uSHELL_COMPLETIONS_TABLE_BEGIN
+#undef   uSHELL_COMPLETION_LIST
+#undef   uSHELL_COMPLETION_FUNC
+#undef   uSHELL_COMPLETIONS_TABLE_END
+
+/* the scripts names are offered to the #r shortcut */
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+static const char *uShellComplScripts(int iIndex) {
+    return (iIndex < uSHELL_NR_ELEMS(g_vsScriptsArray)) ? g_vsScriptsArray[iIndex].pstrScriptName : nullptr;
+}
+#define  uSHELL_COMPLETION_SCRIPTS                              ,{ "#r", 0, uShellComplScripts }
+#else
+#define  uSHELL_COMPLETION_SCRIPTS
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+
+#define  uSHELL_COMPLETIONS_TABLE_BEGIN                     static const completion_s g_vsCompletionsArray[] = { { "", 0, nullptr } uSHELL_COMPLETION_SCRIPTS
+#define  uSHELL_COMPLETION_LIST(a,b,...)                        ,{ #a, b, uShellCompl_##a##_##b }
+#define  uSHELL_COMPLETION_FUNC(a,b,c)                          ,{ #a, b, c }
+#define  uSHELL_COMPLETIONS_TABLE_END                       };
+#include uSHELL_COMPLETIONS_CONFIG_FILE
+#undef   uSHELL_COMPLETIONS_TABLE_BEGIN
+#undef   uSHELL_COMPLETION_LIST
+#undef   uSHELL_COMPLETION_FUNC
+#undef   uSHELL_COMPLETIONS_TABLE_END
+#undef   uSHELL_COMPLETION_SCRIPTS
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
 
 /* user shortcuts array */
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
 #define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN                  static shortcut_s g_vsShortcutsArray[] = { { ' ', nullptr }
 #define  uSHELL_USER_SHORTCUT(a,b,c)                            ,{ a, uShellUserHandleShortcut_##b }
+#define  uSHELL_USER_HOT_SHORTCUT(a,b,c)                        ,{ a, uShellUserHandleShortcut_##b }
 #define  uSHELL_USER_SHORTCUTS_TABLE_END                    };
 #include uSHELL_USER_SHORTCUTS_CONFIG_FILE
 #undef   uSHELL_USER_SHORTCUTS_TABLE_BEGIN
 #undef   uSHELL_USER_SHORTCUT
+#undef   uSHELL_USER_HOT_SHORTCUT
 #undef   uSHELL_USER_SHORTCUTS_TABLE_END
 #else
 static shortcut_s g_vsShortcutsArray[] =                    { { ' ', nullptr } };
@@ -95,15 +224,66 @@ static shortcut_s g_vsShortcutsArray[] =                    { { ' ', nullptr } }
 
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
     /* user shortcuts help info array */
-    #define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN              static const char* const g_vstrShortcutsInfoArray[] = {
+#if (1 == uSHELL_IMPLEMENTS_PACKED_HELP)
+    #define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN
+    #define  uSHELL_USER_SHORTCUT(a,b,c)                        static constexpr auto g_sShortcutInfo_##b = ushell_info_pack<ushell_info_packed_size(c)>(c);
+    #define  uSHELL_USER_HOT_SHORTCUT(a,b,c)                    uSHELL_USER_SHORTCUT(a,b,c)
+    #define  uSHELL_USER_SHORTCUTS_TABLE_END
+    #include uSHELL_USER_SHORTCUTS_CONFIG_FILE
+    #undef   uSHELL_USER_SHORTCUTS_TABLE_BEGIN
+    #undef   uSHELL_USER_SHORTCUT
+    #undef   uSHELL_USER_HOT_SHORTCUT
+    #undef   uSHELL_USER_SHORTCUTS_TABLE_END
+    #define  uSHELL_USER_SHORTCUT(a,b,c)                        g_sShortcutInfo_##b.vstrPacked,
+    #define  uSHELL_USER_HOT_SHORTCUT(a,b,c)                    g_sShortcutInfo_##b.vstrPacked,
+#else
     #define  uSHELL_USER_SHORTCUT(a,b,c)                        c,
+    #define  uSHELL_USER_HOT_SHORTCUT(a,b,c)                    c,
+#endif /*(1 == uSHELL_IMPLEMENTS_PACKED_HELP)*/
+    #define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN              static const char* const g_vstrShortcutsInfoArray[] = {
     #define  uSHELL_USER_SHORTCUTS_TABLE_END                };
     #include uSHELL_USER_SHORTCUTS_CONFIG_FILE
     #undef   uSHELL_USER_SHORTCUTS_TABLE_BEGIN
     #undef   uSHELL_USER_SHORTCUT
+    #undef   uSHELL_USER_HOT_SHORTCUT
     #undef   uSHELL_USER_SHORTCUTS_TABLE_END
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
 
+#if (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+/* symbols of the shortcuts array (the core '#' in the slot 0), looked up through a table indexed by the symbol */
+#if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
+#define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN                  static constexpr shortcutKey_s g_vsShortcutKeysArray[] = { { '#', false }
+#define  uSHELL_USER_SHORTCUT(a,b,c)                            ,{ a, false }
+#define  uSHELL_USER_HOT_SHORTCUT(a,b,c)                        ,{ a, (1 == uSHELL_IMPLEMENTS_HOT_SHORTCUTS) }
+#define  uSHELL_USER_SHORTCUTS_TABLE_END                    };
+#include uSHELL_USER_SHORTCUTS_CONFIG_FILE
+#undef   uSHELL_USER_SHORTCUTS_TABLE_BEGIN
+#undef   uSHELL_USER_SHORTCUT
+#undef   uSHELL_USER_HOT_SHORTCUT
+#undef   uSHELL_USER_SHORTCUTS_TABLE_END
+#else
+static constexpr shortcutKey_s g_vsShortcutKeysArray[] =    { { '#', false } };
+#endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+
+static constexpr shortcutTable_s g_sShortcutTable = ushell_build_shortcut_table(g_vsShortcutKeysArray);
+static_assert(true == g_sShortcutTable.bValid, "a shortcut symbol is taken twice or is not a punctuation character");
+#endif /*(1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+/* commands statistics, indexed as the commands array */
+static cmdStats_s g_vsCmdStatsArray[uSHELL_NR_ELEMS(g_vsFuncDefArray)];
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+/* scratch arena of the plugin handlers, released by the core after every command */
+alignas(uSHELL_SCRATCH_ARENA_ALIGN) static uint8_t g_vu8ScratchArena[uSHELL_SCRATCH_ARENA_SIZE];
+static scratchArena_s g_sScratchArena = { g_vu8ScratchArena, sizeof(g_vu8ScratchArena), 0U, 0U };
+
+void *uShellScratchAlloc(const size_t szSize) {
+    return ushell_scratch_alloc(&g_sScratchArena, szSize);
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)*/
+
 /* partial initialization of the shell instance structure */
 static uShellInst_s sShellInstance = {
     .psFuncDefArray                                         = g_vsFuncDefArray,
@@ -114,14 +294,40 @@ static uShellInst_s sShellInstance = {
     .ppstrShortcutsInfoArray                                = g_vstrShortcutsInfoArray,
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
 #endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
-#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
-    .piAutocompleteIndexArray                               = g_viAutocompleteIndexArray,
-#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+    .piSortedIndexArray                                     = g_sFuncSortedIndex.viIndex,
+#elif (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    .pu32AutocompleteSet                                    = g_vu32AutocompleteSet,
+#endif /* (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
 #if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
     .bKeepRuning                                            = true,
 #endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
     .iNrFunctions                                           = uSHELL_NR_ELEMS(g_vsFuncDefArray),
     .iNrShortcuts                                           = uSHELL_NR_ELEMS(g_vsShortcutsArray),
+#if (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+    .psShortcutTable                                        = &g_sShortcutTable,
+#endif /*(1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)*/
+#if (1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)
+    .piFuncHashTable                                        = g_sFuncHashTable.viSlots,
+    .iFuncHashTableSize                                     = uSHELL_NR_ELEMS(g_sFuncHashTable.viSlots),
+#endif /*(1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)*/
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+    .psParamsDecoderArray                                   = g_vsParamsDecoderArray,
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+    .psScriptsArray                                         = g_vsScriptsArray,
+    .iNrScripts                                             = uSHELL_NR_ELEMS(g_vsScriptsArray),
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+    .psCompletionsArray                                     = g_vsCompletionsArray,
+    .iNrCompletions                                         = uSHELL_NR_ELEMS(g_vsCompletionsArray),
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+    .psCmdStatsArray                                        = g_vsCmdStatsArray,
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+    .psScratchArena                                         = &g_sScratchArena,
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)*/
     .pfExec                                                 = uShellExecuteCommand,
     .vstrPrompt                                             = {0},
     .iPromptLength                                          = 0
@@ -129,12 +335,35 @@ static uShellInst_s sShellInstance = {
 
 
 /**
- * @brief Execute a shell command based on parsed command structure
+ * @brief Execute a shell command based on parsed command structure, traced with TRACE_REC
  * @param psCmd Pointer to command structure with parsed parameters
  * @return Error code from uSHELL_ERR_* enumeration
  */
 static int uShellExecuteCommand( const command_s *psCmd ){
-    /* void:v, (byte)u8:b:vb, (word)u16:w:vw, (int)u32:i:vi, (long)u64:l:vl, float:f:vf, string:s:vs, bool:o:vo */
+#if (defined(TRACE_REC) && (1 == TRACE_REC))
+    const fctDef_s *psDef = &g_vsFuncDefArray[psCmd->iFctIndex];
+    const uint8_t u8Id = trace_rec_id(TRACE_KIND_COMMAND, psDef, psDef->pstrFctName);
+
+    trace_rec_event(TRACE_CMD_BEGIN, u8Id, 0U);
+    const int iRetVal = uShellDispatchCommand(psCmd);
+    trace_rec_event(TRACE_CMD_END, u8Id, (uint16_t)iRetVal);
+    return iRetVal;
+#else
+    return uShellDispatchCommand(psCmd);
+#endif /*(defined(TRACE_REC) && (1 == TRACE_REC))*/
+} /* uShellExecuteCommand() */
+
+
+/**
+ * @brief Call the user function of a command with its decoded parameters
+ * @param psCmd Pointer to command structure with parsed parameters
+ * @return Error code from uSHELL_ERR_* enumeration
+ */
+static int uShellDispatchCommand( const command_s *psCmd ){
+#if (1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH)
+    return g_vpfThunksArray[psCmd->iFctIndex](psCmd);
+#else
+    /* void:v, (byte)u8:b:vb, (word)u16:w:vw, (int)u32:i:vi, (long)u64:l:vl, float:f:vf, string:s:vs, bool:o:vo, view:r:vr, array:a:va, hex:x:vx, fixed:q:vq */
     switch(g_vsFuncDefExArray[psCmd->iFctIndex].eParamType) {
         case v_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.v_fct          ();
         case i_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.i_fct          (psCmd->vi[0]);
@@ -142,10 +371,25 @@ static int uShellExecuteCommand( const command_s *psCmd ){
         case ii_type         :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.ii_fct         (psCmd->vi[0], psCmd->vi[1]);
         case ss_type         :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.ss_fct         (psCmd->vs[0], psCmd->vs[1]);
         case is_type         :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.is_fct         (psCmd->vi[0], psCmd->vs[0]);
+        case si_type         :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.si_fct         (psCmd->vs[0], psCmd->vi[0]);
         case lio_type        :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.lio_fct        (psCmd->vl[0], psCmd->vi[0], psCmd->vo[0]);
+        case iii_type        :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.iii_fct        (psCmd->vi[0], psCmd->vi[1], psCmd->vi[2]);
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+        case r_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.r_fct          (psCmd->vr[0]);
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+        case a_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.a_fct          (psCmd->va[0]);
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+        case x_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.x_fct          (psCmd->vx[0]);
+#endif /* defined(uSHELL_IMPLEMENTS_HEX_BUFFERS) */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+        case q_type          :return g_vsFuncDefExArray[psCmd->iFctIndex].uFctType.q_fct          (psCmd->vq[0]);
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED) */
         default              :return uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM;
     }
-} /* uShellExecuteCommand() */
+#endif /*(1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH)*/
+} /* uShellDispatchCommand() */
 
 
 /**
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""
+Compile a uShell script (.ush) into flash resident bytecode
+Usage: python3 ush2bc.py --table ushell_scripts_table.txt --name selftest --output ushell_script_selftest.cpp selftest.ush
+
+The table is ushell_scripts_table.h preprocessed with the firmware settings, so the
+function indexes and the parameter patterns are exactly the ones built into the shell.
+Every script line becomes one step: LEN | IDX | ARGS (same layout as the binary frames),
+the script ends with a 0 length.
+"""
+
+import argparse
+import fractions
+import os
+import shlex
+import struct
+import sys
+
+# packed size of every numeric parameter type (little endian)
+NUMERIC_SIZES = {'b': 1, 'w': 2, 'i': 4, 'l': 8, 'o': 1}
+
+
+class ScriptError(Exception):
+    pass
+
+
+def read_table(filename):
+    commands = {}
+    max_step_len = 128
+    signed_types = False
+    fixed_frac_bits = 16
+    with open(filename, 'r') as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 3 and fields[0] == 'uSHELL_SCRIPT_COMMAND':
+                commands[fields[1]] = (len(commands), fields[2])
+            elif len(fields) == 2 and fields[0] == 'uSHELL_SCRIPT_MAX_STEP_LEN':
+                max_step_len = int(fields[1].strip('()uU'), 0)
+            elif len(fields) == 2 and fields[0] == 'uSHELL_SCRIPT_SIGNED_TYPES':
+                signed_types = (fields[1] == '1')
+            elif len(fields) == 2 and fields[0] == 'uSHELL_SCRIPT_FIXED_FRAC_BITS' and fields[1][:1] in '(0123456789':
+                fixed_frac_bits = int(fields[1].strip('()uU'), 0)
+    if not commands:
+        raise ScriptError(f"no commands found in {filename}")
+    return commands, max_step_len, signed_types, fixed_frac_bits
+
+
+def parse_number(token, signed_types):
+    """same formats as asc2int(): decimal, 0x.., 0b.., 0o.."""
+    text = token.lower()
+    negative = signed_types and text.startswith('-')
+    if negative:
+        text = text[1:]
+    base = 10
+    if len(text) > 1 and text[0] == '0' and text[1] in 'xbo':
+        base = {'x': 16, 'b': 2, 'o': 8}[text[1]]
+        text = text[2:]
+    if not text:
+        return 0
+    if any(c not in '0123456789abcdef'[:base] for c in text):
+        raise ScriptError(f"invalid number '{token}'")
+    value = int(text, base)
+    return -value if negative else value
+
+
+def parse_fixed(token, frac_bits):
+    """same as asc2fixed(): [-]int[.frac], the fraction rounded half up to frac_bits"""
+    negative = token.startswith('-')
+    text = token[1:] if negative else token
+    whole, dot, frac = text.partition('.')
+    if (not whole and not frac) or (dot and not frac) or any(c not in '0123456789' for c in whole + frac):
+        raise ScriptError(f"invalid fixed point number '{token}'")
+    value = (int(whole or '0') << frac_bits)
+    if frac:
+        value += ((fractions.Fraction(int(frac), 10 ** len(frac)) * (2 << frac_bits)).__floor__() + 1) >> 1
+    if value > ((1 << 31) if negative else (1 << 31) - 1):
+        raise ScriptError(f"value too big for 'q': {token}")
+    return ((-value if negative else value) & 0xFFFFFFFF).to_bytes(4, 'little')
+
+
+def pack_param(mark, token, signed_types, fixed_frac_bits):
+    if mark in NUMERIC_SIZES:
+        size = NUMERIC_SIZES[mark]
+        value = parse_number(token, signed_types)
+        limit = 1 if mark == 'o' else (1 << (8 * size)) - 1
+        if value > limit or value < -(1 << (8 * size - 1)):
+            raise ScriptError(f"value too big for '{mark}': {token}")
+        return (value & ((1 << (8 * size)) - 1)).to_bytes(size, 'little')
+    if mark == 'q':
+        return parse_fixed(token, fixed_frac_bits)
+    if mark == 'f':
+        try:
+            return struct.pack('<f', float(token))
+        except ValueError:
+            raise ScriptError(f"invalid float '{token}'")
+    if mark in 'sr':
+        data = token.encode('ascii')
+        if b'\0' in data:
+            raise ScriptError("strings can not contain NUL")
+        return data + b'\0'
+    if mark == 'x':
+        # a length byte and the bytes, as unhexlify_inplace() leaves them from the digits
+        try:
+            data = bytes.fromhex(token) if len(token) % 2 == 0 else b''
+        except ValueError:
+            data = b''
+        if not data or len(data) > 255:
+            raise ScriptError(f"invalid hex bytes '{token}'")
+        return bytes([len(data)]) + data
+    raise ScriptError(f"unsupported parameter type '{mark}'")
+
+
+def compile_line(tokens, commands, signed_types, fixed_frac_bits):
+    name, args = tokens[0], tokens[1:]
+    if name not in commands:
+        raise ScriptError(f"command not found '{name}'")
+    index, pattern = commands[name]
+    marks = '' if pattern == 'v' else pattern
+    if marks.endswith('a') and len(args) >= len(marks):
+        # the array is the last parameter, every remaining token is one of its 32 bit values
+        marks = marks[:-1] + 'i' * (len(args) - len(marks) + 1)
+    elif len(args) != len(marks):
+        raise ScriptError(f"wrong number of arguments for {name}:{pattern}")
+    step = bytes([index])
+    for mark, token in zip(marks, args):
+        step += pack_param(mark, token, signed_types, fixed_frac_bits)
+    return step
+
+
+def compile_script(filename, commands, max_step_len, signed_types, fixed_frac_bits):
+    steps = []
+    with open(filename, 'r') as f:
+        for lineno, line in enumerate(f, 1):
+            text = line.strip()
+            if not text or text.startswith('#'):
+                continue
+            try:
+                step = compile_line(shlex.split(text), commands, signed_types, fixed_frac_bits)
+                if len(step) >= min(max_step_len, 256):
+                    raise ScriptError(f"step too long ({len(step)} bytes)")
+            except (ScriptError, ValueError) as e:
+                raise ScriptError(f"{filename}:{lineno}: {e}")
+            steps.append((text, step))
+    return steps
+
+
+def write_source(filename, name, script, steps):
+    with open(filename, 'w') as f:
+        f.write(f"/* generated by ush2bc.py from {os.path.basename(script)}, do not edit */\n")
+        f.write("#include <stdint.h>\n\n")
+        f.write(f"extern const uint8_t g_vu8Script_{name}[] = {{\n")
+        for text, step in steps:
+            data = ', '.join(f"0x{b:02X}" for b in bytes([len(step)]) + step)
+            f.write(f"    /* {text.replace('*/', '* /')} */\n    {data},\n")
+        f.write("    0x00\n};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="uShell script to bytecode compiler")
+    parser.add_argument('--table', required=True, help="preprocessed ushell_scripts_table.h")
+    parser.add_argument('--name', required=True, help="script name (as listed in ushell_root_scripts.cfg)")
+    parser.add_argument('--output', required=True, help="generated C++ source")
+    parser.add_argument('script', help="input .ush file")
+    args = parser.parse_args()
+
+    try:
+        commands, max_step_len, signed_types, fixed_frac_bits = read_table(args.table)
+        steps = compile_script(args.script, commands, max_step_len, signed_types, fixed_frac_bits)
+    except (ScriptError, OSError) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+    write_source(args.output, args.name, args.script, steps)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
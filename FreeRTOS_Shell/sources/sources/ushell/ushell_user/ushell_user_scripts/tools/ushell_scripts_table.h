@@ -0,0 +1,19 @@
+/*
+    command table as seen by the firmware, preprocessed (-E -P) by the
+    ushell_user_scripts target and consumed by ush2bc.py
+*/
+#include "ushell_core_settings.h"
+
+#define  uSHELL_COMMANDS_TABLE_BEGIN
+#define  uSHELL_COMMAND_PARAMS_PATTERN(t)
+#define  uSHELL_COMMAND(a,b,c)                      uSHELL_SCRIPT_COMMAND a b
+#define  uSHELL_COMMANDS_TABLE_END
+#include "ushell_root_commands.cfg"
+#undef   uSHELL_COMMANDS_TABLE_BEGIN
+#undef   uSHELL_COMMAND_PARAMS_PATTERN
+#undef   uSHELL_COMMAND
+#undef   uSHELL_COMMANDS_TABLE_END
+
+uSHELL_SCRIPT_MAX_STEP_LEN uSHELL_MAX_INPUT_BUF_LEN
+uSHELL_SCRIPT_SIGNED_TYPES uSHELL_SUPPORTS_SIGNED_TYPES
+uSHELL_SCRIPT_FIXED_FRAC_BITS uSHELL_FIXED_FRAC_BITS
@@ -0,0 +1,138 @@
+// bench.rs
+//
+// `bench` command: on-target microbenchmarks in DWT cycles, the scheduler
+// rows of the C++ shells' bench (same names and columns, compared by
+// ushell_core/tools/bench_matrix.py).
+//
+//   bench 0         every benchmark, one line each
+//   bench <n>       only the n-th
+//
+// The command only records the request: shell_task runs it with
+// `run_pending` once the lines it read are done, so the table comes after
+// the result of the command, not in the middle of it. Each benchmark runs
+// BENCH_SAMPLES times: min, median and max cycles, less the cost of reading
+// the counter twice.
+//
+//   ctx switch         spawn of `bench_wake`, a software task of higher
+//                      priority, until it runs: the spawn and the dispatch
+//   irq->task          a software pended IRQ (SPI2, unused) bound to
+//                      `bench_irq`, until it runs: pend and entry
+
+use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+
+use cortex_m::peripheral::{DCB, DWT};
+use ushell2::log_simple;
+
+/// Odd: the median is a sample.
+const BENCH_SAMPLES: usize = 31;
+
+const BENCH_NAMES: [&str; 2] = ["ctx switch", "irq->task"];
+
+/// Cycles a sample waits for its task, far above the dispatch (100 us at 100 MHz).
+const REPLY_CYCLES: u32 = 10_000;
+
+/// `bench <n>` + 1, 0 while none is pending.
+static REQUEST: AtomicU32 = AtomicU32::new(0);
+
+static CPU_HZ: AtomicU32 = AtomicU32::new(0);
+
+/// CYCCNT of the spawn or of the pend, then the cycles since, stored by the task.
+static WAKE_STAMP: AtomicU32 = AtomicU32::new(0);
+static WAKE_CYCLES: AtomicU32 = AtomicU32::new(0);
+static WOKEN: AtomicBool = AtomicBool::new(false);
+
+/// From init: start the cycle counter, keep the SYSCLK for the header.
+pub fn bench_init(dcb: &mut DCB, dwt: &mut DWT, sysclk_hz: u32) {
+    dcb.enable_trace();
+    dwt.enable_cycle_counter();
+    CPU_HZ.store(sysclk_hz, Ordering::Relaxed);
+}
+
+/// bench 0 runs every benchmark, bench n only the n-th.
+pub fn bench(index: u32) {
+    if index as usize > BENCH_NAMES.len() {
+        log_simple!("bench: 1..{}, 0 for all", BENCH_NAMES.len());
+        return;
+    }
+    REQUEST.store(index + 1, Ordering::Relaxed);
+}
+
+/// From `bench_wake` and `bench_irq`.
+pub fn woken() {
+    let cycles = DWT::cycle_count().wrapping_sub(WAKE_STAMP.load(Ordering::Relaxed));
+    WAKE_CYCLES.store(cycles, Ordering::Relaxed);
+    WOKEN.store(true, Ordering::Release);
+}
+
+/// The request of the last `bench`, if any, from shell_task outside its
+/// locks: `spawn_wake` spawns `bench_wake`, `pend_irq` pends SPI2.
+pub fn run_pending(spawn_wake: fn() -> bool, pend_irq: fn()) {
+    let index = match REQUEST.swap(0, Ordering::Relaxed) {
+        0 => return,
+        request => (request - 1) as usize,
+    };
+    let overhead = calibrate();
+    let mut samples = [0u32; BENCH_SAMPLES];
+
+    log_simple!(
+        "{:>2} {:<18} {:>8} {:>8} {:>8}  (cycles at {} MHz, {} samples)",
+        "#", "bench", "min", "median", "max",
+        CPU_HZ.load(Ordering::Relaxed) / 1_000_000, BENCH_SAMPLES
+    );
+    for (i, name) in BENCH_NAMES.iter().enumerate() {
+        if index != 0 && index - 1 != i {
+            continue;
+        }
+        let mut failed = false;
+        for sample in samples.iter_mut() {
+            WOKEN.store(false, Ordering::Relaxed);
+            WAKE_STAMP.store(DWT::cycle_count(), Ordering::Relaxed);
+            let started = match i {
+                0 => spawn_wake(),
+                _ => {
+                    pend_irq();
+                    true
+                }
+            };
+            match started.then(wait_woken).flatten() {
+                Some(cycles) => *sample = cycles.saturating_sub(overhead),
+                None => {
+                    failed = true;
+                    break;
+                }
+            }
+        }
+        if failed {
+            log_simple!("{:>2} {:<18} {:>8}", i + 1, name, "failed");
+            continue;
+        }
+        samples.sort_unstable();
+        log_simple!(
+            "{:>2} {:<18} {:>8} {:>8} {:>8}",
+            i + 1, name, samples[0], samples[BENCH_SAMPLES / 2], samples[BENCH_SAMPLES - 1]
+        );
+    }
+}
+
+/// Two reads of the counter back to back, taken off every sample.
+fn calibrate() -> u32 {
+    (0..8)
+        .map(|_| {
+            let start = DWT::cycle_count();
+            DWT::cycle_count().wrapping_sub(start)
+        })
+        .min()
+        .unwrap_or(0)
+}
+
+/// The task preempts at once; the wait only covers the few cycles the pend
+/// takes to be seen, and a task which does not run at all.
+fn wait_woken() -> Option<u32> {
+    let start = DWT::cycle_count();
+    while !WOKEN.load(Ordering::Acquire) {
+        if DWT::cycle_count().wrapping_sub(start) > REPLY_CYCLES {
+            return None;
+        }
+    }
+    Some(WAKE_CYCLES.load(Ordering::Relaxed))
+}
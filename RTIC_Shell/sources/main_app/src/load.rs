@@ -0,0 +1,100 @@
+// load.rs
+//
+// `load` command: the CPU load from the idle count, the meter of the C++
+// shells' load_meter (same lines).
+//
+//   load 0          the load of the last second, the 10 s and 60 s averages
+//
+// `idle` counts its turns instead of sleeping in wfi; `led_blink`, the 1 Hz
+// TIM2 task, hands the count of each second to `second`. The first second
+// calibrates what an idle second counts (raised when a later one counts more),
+// the load is the part of it the second did not count. The averages are
+// exponential ones, updated once a second.
+//
+// The counting keeps the core from sleeping: no wfi while the meter runs.
+
+use core::cell::Cell;
+use core::sync::atomic::{AtomicU32, Ordering};
+
+use cortex_m::interrupt::{self, Mutex};
+use ushell2::log_simple;
+
+/// (1 - e^(-1/n)) * 1024: the part of the difference a second adds to the n s average.
+const ALPHA_10: i32 = 97;
+const ALPHA_60: i32 = 17;
+
+/// Turns of `idle` in the current second.
+static TURNS: AtomicU32 = AtomicU32::new(0);
+
+#[derive(Clone, Copy)]
+struct Meter {
+    calib: u32,     // turns in an idle second, 0 before the first one
+    turns: u32,     // of the last second
+    load: u32,      // of the last second, per mille
+    avg10: i32,     // per mille << 10
+    avg60: i32,
+    seconds: u32,   // since the calibration
+}
+
+static METER: Mutex<Cell<Meter>> = Mutex::new(Cell::new(Meter {
+    calib: 0, turns: 0, load: 0, avg10: 0, avg60: 0, seconds: 0,
+}));
+
+fn average(avg: &mut i32, sample: u32, alpha: i32) {
+    *avg += (((sample as i32) << 10) - *avg) * alpha / 1024;
+}
+
+/// A turn of `idle`.
+#[inline(always)]
+pub fn idle_turn() {
+    TURNS.fetch_add(1, Ordering::Relaxed);
+}
+
+/// From `led_blink`, once a second: the count of the second ends.
+pub fn second() {
+    let turns = TURNS.swap(0, Ordering::Relaxed);
+
+    interrupt::free(|cs| {
+        let cell = METER.borrow(cs);
+        let mut m = cell.get();
+        let first = m.calib == 0;
+
+        if turns > m.calib {
+            m.calib = turns;
+        }
+        let full = m.calib as u64;
+        let idle = (turns as u64 * 1000 + full / 2) / full.max(1);
+        m.load = if idle < 1000 { 1000 - idle as u32 } else { 0 };
+        m.turns = turns;
+
+        if first {
+            m.avg10 = (m.load as i32) << 10;
+            m.avg60 = (m.load as i32) << 10;
+        }
+        average(&mut m.avg10, m.load, ALPHA_10);
+        average(&mut m.avg60, m.load, ALPHA_60);
+        m.seconds += 1;
+        cell.set(m);
+    });
+}
+
+/// load 0 prints the loads; there is no LCD on this board.
+pub fn load(action: u32) {
+    if action != 0 {
+        log_simple!("load: no LCD, 0 prints");
+        return;
+    }
+    let m = interrupt::free(|cs| METER.borrow(cs).get());
+
+    if m.calib == 0 {
+        log_simple!("load: calibrating, the first second");
+        return;
+    }
+    let avg10 = ((m.avg10 + 512) >> 10) as u32;
+    let avg60 = ((m.avg60 + 512) >> 10) as u32;
+    log_simple!(
+        "Load: {}.{} % (1 s)  {}.{} % (10 s)  {}.{} % (60 s)",
+        m.load / 10, m.load % 10, avg10 / 10, avg10 % 10, avg60 / 10, avg60 % 10
+    );
+    log_simple!("Idle turns: {}/s of {}/s, over {} s", m.turns, m.calib, m.seconds);
+}
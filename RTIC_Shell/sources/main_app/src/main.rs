@@ -15,10 +15,11 @@ use stm32f4xx_hal::{
 use uart_hal::{
     RX_QUEUE_SIZE, TX_BUFFER_SIZE,
     UartTx, UartRx,
-    handle_tx_ready,
+    handle_tx_dma,
     init_uart_globals,
+    tx_dma_init,
     LOGGER_WRITER,
-    RxQueueReader,
+    RxQueueReader, RxProducer, RxConsumer,
 };
 
 use ushell_dispatcher::{generate_commands_dispatcher, generate_shortcuts_dispatcher};
@@ -28,6 +29,9 @@ use ushell2::{log_info, log_simple};
 use ushell2::logger::{init_logger, LogLevel, LoggerConfig};
 use ushell_ctx::{ShellCtx, ShellConfig};
 
+mod bench;
+mod load;
+
 // Shell configuration constants
 pub const PROMPT:                &str  = ">> ";
 pub const MAX_INPUT_LEN:        usize  = 128;
@@ -66,21 +70,22 @@ static LED_TOGGLE_COUNT: core::sync::atomic::AtomicU32 =
 // ============================================================================
 // RTIC application
 // ============================================================================
-#[app(device = stm32f4xx_hal::pac, peripherals = true, dispatchers = [EXTI0])]
+#[app(device = stm32f4xx_hal::pac, peripherals = true, dispatchers = [EXTI0, EXTI1])]
 mod app {
     use super::*;
 
     #[shared]
     struct Shared {
-        uart_tx:       UartTx,
         tx_buffer:     Deque<u8, TX_BUFFER_SIZE>,
-        rx_queue:      Queue<u8, RX_QUEUE_SIZE>,
         shell_pending: bool,
     }
 
     #[local]
     struct Local {
+        uart_tx:     UartTx,
         uart_rx:     UartRx,
+        rx_producer: RxProducer,
+        rx_consumer: RxConsumer,
         led:         Pin<'C', 13, Output<PushPull>>,
         blink_timer: CounterHz<pac::TIM2>,
         shell:       MyShell,
@@ -89,9 +94,10 @@ mod app {
     // -----------------------------------------------------------------------
     // init — hardware setup only
     // -----------------------------------------------------------------------
-    #[init]
+    #[init(local = [rx_queue: Queue<u8, RX_QUEUE_SIZE> = Queue::new()])]
     fn init(ctx: init::Context) -> (Shared, Local) {
-        let dp = ctx.device;
+        let dp       = ctx.device;
+        let mut core = ctx.core;
 
         let rcc    = dp.RCC.constrain();
         let clocks = rcc.cfgr
@@ -100,6 +106,8 @@ mod app {
             .pclk2(100.MHz())
             .freeze();
 
+        bench::bench_init(&mut core.DCB, &mut core.DWT, clocks.sysclk().raw());
+
         let gpioc = dp.GPIOC.split();
         let led   = gpioc.pc13.into_push_pull_output();
 
@@ -113,13 +121,16 @@ mod app {
 
         let (uart_tx, mut uart_rx) = serial.split();
         uart_rx.listen();
+        tx_dma_init(&uart_tx);
 
         let mut blink_timer = Timer::new(dp.TIM2, &clocks).counter_hz();
         blink_timer.start(1.Hz()).unwrap();
         blink_timer.listen(stm32f4xx_hal::timer::Event::Update);
 
         let tx_buffer: Deque<u8, TX_BUFFER_SIZE> = Deque::new();
-        let rx_queue:  Queue<u8, RX_QUEUE_SIZE>  = Queue::new();
+        // The RX queue lives in init's 'static local and is split once: the
+        // ISR enqueues, the shell dequeues, neither locks the other out.
+        let (rx_producer, rx_consumer) = ctx.local.rx_queue.split();
 
         // Wire logger — write_bytes is a no-op until init_uart_globals runs
         // in shell_task, so early log calls are silently dropped.
@@ -134,6 +145,7 @@ mod app {
         // are hidden inside ushell_ctx; main only sees function pointers.
         let shell = MyShell::new(ShellConfig {
             get_commands:        commands::get_commands,
+            get_name_lcp:        commands::get_name_lcp,
             get_datatypes:       commands::get_datatypes,
             get_shortcuts:       shortcuts::get_shortcuts,
             is_shortcut:         shortcuts::is_supported_shortcut,
@@ -145,25 +157,25 @@ mod app {
         shell_task::spawn().ok();
 
         (
-            Shared { uart_tx, tx_buffer, rx_queue, shell_pending: true },
-            Local  { uart_rx, led, blink_timer, shell },
+            Shared { tx_buffer, shell_pending: true },
+            Local  { uart_tx, uart_rx, rx_producer, rx_consumer, led, blink_timer, shell },
         )
     }
 
     // -----------------------------------------------------------------------
-    // USART2 ISR — RX ingestion + TX draining
+    // USART2 ISR — RX ingestion
     // -----------------------------------------------------------------------
     #[task(
         binds  = USART2,
-        local  = [uart_rx],
-        shared = [uart_tx, tx_buffer, rx_queue, shell_pending],
+        local  = [uart_rx, rx_producer],
+        shared = [shell_pending],
         priority = 3,
     )]
     fn usart2_isr(mut ctx: usart2_isr::Context) {
         if ctx.local.uart_rx.is_rx_not_empty() {
             match ctx.local.uart_rx.read() {
                 Ok(byte) => {
-                    ctx.shared.rx_queue.lock(|q| { let _ = q.enqueue(byte); });
+                    let _ = ctx.local.rx_producer.enqueue(byte);
                     ctx.shared.shell_pending.lock(|pending| {
                         if !*pending {
                             *pending = true;
@@ -174,16 +186,26 @@ mod app {
                 Err(_) => {}
             }
         }
+    }
 
-        ctx.shared.uart_tx.lock(|uart_tx| {
-            ctx.shared.tx_buffer.lock(|tx_buf| {
-                handle_tx_ready(uart_tx, tx_buf);
-            });
+    // -----------------------------------------------------------------------
+    // DMA1 stream 6 ISR — TX draining, a Deque segment per transfer
+    // (also pended by write_bytes to start the DMA when it is idle)
+    // -----------------------------------------------------------------------
+    #[task(
+        binds  = DMA1_STREAM6,
+        local  = [uart_tx],
+        shared = [tx_buffer],
+        priority = 3,
+    )]
+    fn dma1_stream6_isr(mut ctx: dma1_stream6_isr::Context) {
+        ctx.shared.tx_buffer.lock(|tx_buf| {
+            handle_tx_dma(ctx.local.uart_tx, tx_buf);
         });
     }
 
     // -----------------------------------------------------------------------
-    // TIM2 ISR — LED blink (business logic)
+    // TIM2 ISR — LED blink (business logic), the second of the load meter
     // -----------------------------------------------------------------------
     #[task(
         binds  = TIM2,
@@ -193,6 +215,7 @@ mod app {
     fn led_blink(ctx: led_blink::Context) {
         ctx.local.blink_timer.clear_flags(TimerFlag::Update);
         LED_TOGGLE_COUNT.fetch_add(1, core::sync::atomic::Ordering::Relaxed);
+        load::second();
 
         if *ctx.local.state {
             ctx.local.led.set_high();
@@ -204,12 +227,25 @@ mod app {
         *ctx.local.state = !*ctx.local.state;
     }
 
+    // -----------------------------------------------------------------------
+    // bench — the tasks of the ctx switch and irq->task rows, above shell_task
+    // -----------------------------------------------------------------------
+    #[task(priority = 2)]
+    async fn bench_wake(_: bench_wake::Context) {
+        bench::woken();
+    }
+
+    #[task(binds = SPI2, priority = 2)]
+    fn bench_irq(_: bench_irq::Context) {
+        bench::woken();
+    }
+
     // -----------------------------------------------------------------------
     // Shell task — one-time UART global init, then byte processing
     // -----------------------------------------------------------------------
     #[task(
-        shared = [uart_tx, tx_buffer, rx_queue, shell_pending],
-        local  = [shell, initialized: bool = false],
+        shared = [tx_buffer, shell_pending],
+        local  = [shell, rx_consumer, initialized: bool = false],
         priority = 1,
     )]
     async fn shell_task(mut ctx: shell_task::Context) {
@@ -219,44 +255,56 @@ mod app {
             // never moved or dropped afterwards.
             unsafe {
                 ctx.shared.tx_buffer.lock(|tx_buf| {
-                    ctx.shared.uart_tx.lock(|uart_tx| {
-                        init_uart_globals(
-                            core::mem::transmute::<
-                                &mut Deque<u8, TX_BUFFER_SIZE>,
-                                &'static mut Deque<u8, TX_BUFFER_SIZE>,
-                            >(tx_buf),
-                            core::mem::transmute::<
-                                &mut UartTx,
-                                &'static mut UartTx,
-                            >(uart_tx),
-                        );
-                    });
+                    init_uart_globals(
+                        core::mem::transmute::<
+                            &mut Deque<u8, TX_BUFFER_SIZE>,
+                            &'static mut Deque<u8, TX_BUFFER_SIZE>,
+                        >(tx_buf),
+                    );
                 });
             }
 
             log_simple!("System initialized");
-            log_simple!("UART configured with step-based shell");
+            log_simple!("UART configured with step-based shell (DMA TX)");
             log_simple!("Starting step-based shell...");
             log_simple!("Type '##' for available commands");
 
             *ctx.local.initialized = true;
         }
 
-        ctx.shared.rx_queue.lock(|rx_queue| {
-            let mut reader = RxQueueReader::new(rx_queue);
+        loop {
+            // No lock around the reader: the ISR keeps enqueueing while the
+            // commands run, at no cost to its latency.
+            let mut reader = RxQueueReader::new(ctx.local.rx_consumer);
             while !reader.is_empty() {
                 if !ctx.local.shell.step(&mut reader) {
                     log_info!("Shell exited");
                     break;
                 }
             }
-        });
 
-        ctx.shared.shell_pending.lock(|pending| { *pending = false; });
+            // a `bench` of the lines above, once they are done
+            bench::run_pending(
+                || bench_wake::spawn().is_ok(),
+                || rtic::pend(pac::Interrupt::SPI2),
+            );
+
+            // a byte enqueued after the loop saw the queue empty found pending
+            // still set and spawned nothing: take it here
+            let rx_consumer = &*ctx.local.rx_consumer;
+            let more = ctx.shared.shell_pending.lock(|pending| {
+                *pending = rx_consumer.ready();
+                *pending
+            });
+            if !more {
+                break;
+            }
+        }
     }
 
+    // idle counts for the load meter (load.rs) instead of sleeping in wfi
     #[idle]
     fn idle(_: idle::Context) -> ! {
-        loop { cortex_m::asm::wfi(); }
+        loop { load::idle_turn(); }
     }
 }
@@ -7,10 +7,14 @@
 //! - Exposes plain function pointers (`write_bytes`, `flush_noop`) that can be
 //!   handed directly to `CallbackWriter` or any other sink.
 //! - Provides a ready-made `fmt::Write` impl (`UartWriter`) for logger integration.
-//! - Provides `RxQueueReader` so the shell can drain the RTIC-owned RX queue
-//!   without knowing about the queue internals.
-//! - Provides `handle_tx_ready`, a single-call ISR helper that drains one byte
-//!   from the TX buffer and manages the TX-interrupt arm/disarm logic.
+//! - Provides `RxQueueReader` so the shell can drain its end of the RX queue
+//!   without knowing about the queue internals. The queue is split once in
+//!   `init` (`RxProducer` to the RX ISR, `RxConsumer` to the shell task):
+//!   neither side takes a lock, the RX interrupt never waits for the shell.
+//! - Provides `tx_dma_init` / `handle_tx_dma`: the TX buffer is drained by
+//!   DMA1 stream 6 (channel 4, USART2_TX), one contiguous segment of the
+//!   Deque per transfer, the next one chained from the transfer-complete
+//!   interrupt — a couple of interrupts per line instead of one per byte.
 //! - Provides `init_uart_globals` for the one-time wiring of RTIC shared
 //!   resources into the global state.
 //!
@@ -21,15 +25,11 @@
 
 #![no_std]
 
-use stm32f4xx_hal::{pac, serial::{Tx, Rx}};
+use core::sync::atomic::{AtomicUsize, Ordering};
 
-// These traits are not included in the blanket `prelude::*`; they must be
-// imported explicitly.  The compiler error messages name them precisely.
-use stm32f4xx_hal::prelude::_stm32f4xx_hal_serial_TxListen; // .listen() / .unlisten()
-use stm32f4xx_hal::prelude::_stm32f4xx_hal_serial_TxISR;    // .is_tx_empty()
-use stm32f4xx_hal::prelude::_embedded_hal_serial_nb_Write;   // .write(byte)
+use stm32f4xx_hal::{pac, serial::{Tx, Rx}};
 
-use heapless::{Deque, spsc::Queue};
+use heapless::{Deque, spsc::{Consumer, Producer}};
 
 // ---------------------------------------------------------------------------
 // Public size constants
@@ -38,7 +38,7 @@ use heapless::{Deque, spsc::Queue};
 /// Capacity of the interrupt-driven RX byte queue.
 pub const RX_QUEUE_SIZE: usize = 128;
 
-/// Capacity of the software TX ring buffer that feeds the USART TX interrupt.
+/// Capacity of the software TX ring buffer drained by the TX DMA.
 pub const TX_BUFFER_SIZE: usize = 512;
 
 // ---------------------------------------------------------------------------
@@ -51,13 +51,18 @@ pub type UartTx = Tx<pac::USART2>;
 /// The USART2 RX half, as produced by `serial.split()`.
 pub type UartRx = Rx<pac::USART2>;
 
+/// The enqueue end of the RX queue, owned by the RX ISR.
+pub type RxProducer = Producer<'static, u8, RX_QUEUE_SIZE>;
+
+/// The dequeue end of the RX queue, owned by the shell task.
+pub type RxConsumer = Consumer<'static, u8, RX_QUEUE_SIZE>;
+
 // ---------------------------------------------------------------------------
 // Internal global state
 // ---------------------------------------------------------------------------
 
 struct GlobalUartState {
     tx_buffer: core::cell::UnsafeCell<Option<&'static mut Deque<u8, TX_BUFFER_SIZE>>>,
-    uart_tx:   core::cell::UnsafeCell<Option<&'static mut UartTx>>,
 }
 
 // Safety: accesses are coordinated by RTIC's priority-based interrupt masking.
@@ -67,9 +72,12 @@ unsafe impl Sync for GlobalUartState {}
 
 static mut GLOBAL_UART: GlobalUartState = GlobalUartState {
     tx_buffer: core::cell::UnsafeCell::new(None),
-    uart_tx:   core::cell::UnsafeCell::new(None),
 };
 
+/// Bytes at the front of the TX buffer the DMA is sending (0: DMA idle).
+/// Only touched by [`handle_tx_dma`], i.e. at the DMA ISR priority.
+static TX_DMA_IN_FLIGHT: AtomicUsize = AtomicUsize::new(0);
+
 // ---------------------------------------------------------------------------
 // Global logger writer instance
 // ---------------------------------------------------------------------------
@@ -88,99 +96,171 @@ pub static mut LOGGER_WRITER: UartWriter = UartWriter;
 // One-time initialisation
 // ---------------------------------------------------------------------------
 
-/// Register the RTIC-owned `tx_buffer` and `uart_tx` with the global state.
+/// Register the RTIC-owned `tx_buffer` with the global state.
 ///
-/// Must be called **exactly once**, from the RTIC task that holds locks on
-/// both resources.  Use `core::mem::transmute` to extend lifetimes to
+/// Must be called **exactly once**, from the RTIC task that holds the lock
+/// on the resource.  Use `core::mem::transmute` to extend the lifetime to
 /// `'static` — this is sound because RTIC shared resources live for the
 /// entire programme lifetime.
 ///
 /// # Safety
-/// - Both references must remain valid for `'static`.
+/// - The reference must remain valid for `'static`.
 /// - Must be called before the first call to [`write_bytes`].
 /// - Must be called exactly once.
-pub unsafe fn init_uart_globals(
-    tx_buf:  &'static mut Deque<u8, TX_BUFFER_SIZE>,
-    uart_tx: &'static mut UartTx,
-) {
+pub unsafe fn init_uart_globals(tx_buf: &'static mut Deque<u8, TX_BUFFER_SIZE>) {
     *(*core::ptr::addr_of_mut!(GLOBAL_UART.tx_buffer)).get() = Some(tx_buf);
-    *(*core::ptr::addr_of_mut!(GLOBAL_UART.uart_tx)).get()   = Some(uart_tx);
 }
 
 // ---------------------------------------------------------------------------
 // Public write / flush — suitable as bare function pointers
 // ---------------------------------------------------------------------------
 
-/// Enqueue `bytes` into the TX ring buffer and arm the TX interrupt.
+/// Enqueue `bytes` into the TX ring buffer and kick the TX DMA.
 ///
 /// This is a plain `fn` (not a closure) so it can be stored in a
 /// `CallbackWriter<fn(&[u8]), fn()>` or any other function-pointer slot.
 ///
+/// The DMA is not started here: the DMA1_STREAM6 interrupt is pended, and
+/// [`handle_tx_dma`] — the only place a transfer is started or retired —
+/// starts one if the DMA is idle.  So a write racing with a completion can
+/// not start a second transfer over the first.
+///
 /// Silently drops bytes that exceed the buffer capacity.
 /// No-ops silently before [`init_uart_globals`] has been called.
 pub fn write_bytes(bytes: &[u8]) {
-    // Safety: write_bytes is called only from tasks at or below the USART ISR
+    // Safety: write_bytes is called only from tasks at or below the DMA ISR
     // priority.  The ISR exclusively pops (pop_front) while we push
-    // (push_back), so there is no aliased mutable access to the Deque.
-    //
-    // Deref note: `Option<&'static mut T>::as_mut()` yields
-    // `Option<&mut &'static mut T>`, not `Option<&mut T>`.
-    // We therefore deref one extra level with `**uart_tx` to obtain the plain
-    // `&mut UartTx` that the HAL trait methods expect.
+    // (push_back), so there is no aliased mutable access to the Deque; the
+    // bytes the DMA reads are at the front, push_back does not move them.
     unsafe {
         let tx_buf_ptr = core::ptr::addr_of!(GLOBAL_UART.tx_buffer);
-        let tx_ptr     = core::ptr::addr_of!(GLOBAL_UART.uart_tx);
 
         if let Some(tx_buf) = (*(*tx_buf_ptr).get()).as_mut() {
-            if let Some(uart_tx) = (*(*tx_ptr).get()).as_mut() {
-                for &b in bytes {
-                    if tx_buf.push_back(b).is_err() {
-                        break; // buffer full — drop the remainder
-                    }
+            for &b in bytes {
+                if tx_buf.push_back(b).is_err() {
+                    break; // buffer full — drop the remainder
                 }
-                // uart_tx : &mut &'static mut UartTx  →  **  →  &mut UartTx
-                (**uart_tx).listen();
             }
+            pac::NVIC::pend(pac::Interrupt::DMA1_STREAM6);
         }
     }
 }
 
-/// No-op flush — TX draining is handled entirely by the USART TX interrupt.
+/// No-op flush — TX draining is handled entirely by the TX DMA.
 ///
 /// Provided as a companion to [`write_bytes`] for APIs that require a paired
 /// `fn()` flush pointer (e.g. `CallbackWriter`).
 pub fn flush_noop() {}
 
 // ---------------------------------------------------------------------------
-// ISR TX helper
+// TX DMA (DMA1 stream 6, channel 4 = USART2_TX on the F411)
+//
+// Programmed through its registers: the HAL `Transfer` owns its buffer for
+// the time of a transfer, while here the buffer is the RTIC-owned Deque that
+// keeps taking bytes at its back meanwhile.
 // ---------------------------------------------------------------------------
 
-/// Drive the TX side of the USART interrupt.
+const RCC_AHB1ENR:  *mut u32 = 0x4002_3830 as *mut u32;
+const RCC_AHB1ENR_DMA1EN: u32 = 1 << 21;
+
+const USART2_DR:    u32      = 0x4000_4404;
+const USART2_CR3:   *mut u32 = 0x4000_4414 as *mut u32;
+const USART_CR3_DMAT: u32 = 1 << 7;
+
+const DMA1_HISR:    *const u32 = 0x4002_6004 as *const u32;
+const DMA1_HIFCR:   *mut u32   = 0x4002_600C as *mut u32;
+const DMA1_S6CR:    *mut u32   = 0x4002_60A0 as *mut u32;
+const DMA1_S6NDTR:  *mut u32   = 0x4002_60A4 as *mut u32;
+const DMA1_S6PAR:   *mut u32   = 0x4002_60A8 as *mut u32;
+const DMA1_S6M0AR:  *mut u32   = 0x4002_60AC as *mut u32;
+
+// stream 6 flags in HISR / HIFCR: FEIF, DMEIF, TEIF, HTIF, TCIF
+const DMA_S6_TCIF:  u32 = 1 << 21;
+const DMA_S6_TEIF:  u32 = 1 << 19;
+const DMA_S6_ALL:   u32 = 0b11_1101 << 16;
+
+const DMA_SXCR_EN:  u32 = 1 << 0;
+const DMA_SXCR_TEIE: u32 = 1 << 2;
+const DMA_SXCR_TCIE: u32 = 1 << 4;
+const DMA_SXCR_DIR_M2P: u32 = 0b01 << 6;
+const DMA_SXCR_MINC: u32 = 1 << 10;
+const DMA_SXCR_PL_MEDIUM: u32 = 0b01 << 16;
+const DMA_SXCR_CHSEL_4: u32 = 4 << 25;
+
+/// Set up DMA1 stream 6 for the USART2 TX and switch the USART to DMA TX.
 ///
-/// Call this from your USART ISR whenever the TX data register is empty.
-/// Pops one byte from `tx_buf`, writes it to `uart_tx`, and keeps the TX
-/// interrupt armed.  When the buffer empties the interrupt is disarmed, so
-/// the ISR stops re-entering.
+/// Call once from `init`, after the USART is configured (`uart_tx` is the
+/// proof).  The transfers are started by [`handle_tx_dma`].
+pub fn tx_dma_init(_uart_tx: &UartTx) {
+    // Safety: one-time setup in `init`, interrupts disabled; DMA1 stream 6
+    // and USART2 CR3.DMAT are used by nothing else.
+    unsafe {
+        RCC_AHB1ENR.write_volatile(RCC_AHB1ENR.read_volatile() | RCC_AHB1ENR_DMA1EN);
+
+        DMA1_S6CR.write_volatile(0);
+        while DMA1_S6CR.read_volatile() & DMA_SXCR_EN != 0 {}
+        DMA1_HIFCR.write_volatile(DMA_S6_ALL);
+
+        DMA1_S6PAR.write_volatile(USART2_DR);
+        // byte to byte (PSIZE = MSIZE = 0), direct mode, no FIFO
+        DMA1_S6CR.write_volatile(
+            DMA_SXCR_CHSEL_4 | DMA_SXCR_PL_MEDIUM | DMA_SXCR_MINC
+                | DMA_SXCR_DIR_M2P | DMA_SXCR_TCIE | DMA_SXCR_TEIE,
+        );
+
+        USART2_CR3.write_volatile(USART2_CR3.read_volatile() | USART_CR3_DMAT);
+    }
+}
+
+/// Drive the TX DMA: call from the DMA1_STREAM6 ISR.
+///
+/// - a transfer is done (or failed): its bytes leave the front of `tx_buf`
+/// - the DMA is idle: the first contiguous segment of `tx_buf` (up to the
+///   wrap of the ring) goes out in one transfer, the rest from the next
+///   completion
 ///
-/// # Example (inside `usart2_isr`)
+/// Also reached through [`write_bytes`] pending the interrupt: with a
+/// transfer in flight that is a no-op, the completion chains the new bytes.
+///
+/// # Example (inside `dma1_stream6_isr`)
 /// ```ignore
-/// ctx.shared.uart_tx.lock(|uart_tx| {
-///     ctx.shared.tx_buffer.lock(|tx_buf| {
-///         uart_hal::handle_tx_ready(uart_tx, tx_buf);
-///     });
+/// ctx.shared.tx_buffer.lock(|tx_buf| {
+///     uart_hal::handle_tx_dma(ctx.local.uart_tx, tx_buf);
 /// });
 /// ```
-pub fn handle_tx_ready(uart_tx: &mut UartTx, tx_buf: &mut Deque<u8, TX_BUFFER_SIZE>) {
-    if uart_tx.is_tx_empty() {
-        match tx_buf.pop_front() {
-            Some(byte) => {
-                let _ = uart_tx.write(byte);
-                uart_tx.listen();   // keep armed while data remains
+pub fn handle_tx_dma(_uart_tx: &mut UartTx, tx_buf: &mut Deque<u8, TX_BUFFER_SIZE>) {
+    // Safety: the DMA stream 6 registers belong to this function (see
+    // tx_dma_init); it runs at a single priority, so it does not preempt
+    // itself.
+    unsafe {
+        let in_flight = TX_DMA_IN_FLIGHT.load(Ordering::Relaxed);
+        let flags = DMA1_HISR.read_volatile();
+
+        if in_flight != 0 {
+            if flags & (DMA_S6_TCIF | DMA_S6_TEIF) == 0 {
+                return; // still sending — the completion comes back here
             }
-            None => {
-                uart_tx.unlisten(); // buffer drained — silence the TX interrupt
+            // A failed transfer is retired like a done one, not retried:
+            // the output goes on rather than stalling on the same bytes.
+            DMA1_HIFCR.write_volatile(DMA_S6_ALL);
+            for _ in 0..in_flight {
+                let _ = tx_buf.pop_front();
             }
+            TX_DMA_IN_FLIGHT.store(0, Ordering::Relaxed);
+        }
+
+        let (segment, _) = tx_buf.as_slices();
+        if segment.is_empty() {
+            return; // drained — no interrupt until the next write
         }
+
+        DMA1_HIFCR.write_volatile(DMA_S6_ALL);
+        DMA1_S6M0AR.write_volatile(segment.as_ptr() as u32);
+        DMA1_S6NDTR.write_volatile(segment.len() as u32);
+        TX_DMA_IN_FLIGHT.store(segment.len(), Ordering::Relaxed);
+        // the bytes pushed by write_bytes are in memory before the DMA reads them
+        core::sync::atomic::compiler_fence(Ordering::Release);
+        DMA1_S6CR.write_volatile(DMA1_S6CR.read_volatile() | DMA_SXCR_EN);
     }
 }
 
@@ -206,37 +286,37 @@ impl core::fmt::Write for UartWriter {
 // RX queue reader
 // ---------------------------------------------------------------------------
 
-/// A thin, lifetime-scoped wrapper around the RTIC-owned RX byte queue.
+/// A thin, lifetime-scoped wrapper around the consumer end of the RX queue.
 ///
-/// Construct inside the shell task while holding the `rx_queue` lock, then
-/// pass to the shell's `step` method for byte-by-byte consumption.
+/// Construct inside the shell task from its local `RxConsumer`, then pass to
+/// the shell's `step` method for byte-by-byte consumption. No lock: the RX
+/// ISR enqueues on its `RxProducer` meanwhile, the single-producer /
+/// single-consumer queue only needs the atomic head and tail of each end.
 ///
 /// # Example
 /// ```ignore
-/// ctx.shared.rx_queue.lock(|rx_queue| {
-///     let mut reader = RxQueueReader::new(rx_queue);
-///     while !reader.is_empty() {
-///         shell.step(&mut reader);
-///     }
-/// });
+/// let mut reader = RxQueueReader::new(ctx.local.rx_consumer);
+/// while !reader.is_empty() {
+///     shell.step(&mut reader);
+/// }
 /// ```
 pub struct RxQueueReader<'a> {
-    queue: &'a mut Queue<u8, RX_QUEUE_SIZE>,
+    consumer: &'a mut RxConsumer,
 }
 
 impl<'a> RxQueueReader<'a> {
-    /// Wrap the RTIC-owned RX queue for the duration of a lock scope.
-    pub fn new(queue: &'a mut Queue<u8, RX_QUEUE_SIZE>) -> Self {
-        Self { queue }
+    /// Wrap the shell task's end of the RX queue.
+    pub fn new(consumer: &'a mut RxConsumer) -> Self {
+        Self { consumer }
     }
 
     /// Dequeue and return the next byte, or `None` if empty.
     pub fn read_byte(&mut self) -> Option<u8> {
-        self.queue.dequeue()
+        self.consumer.dequeue()
     }
 
     /// Returns `true` when no bytes are waiting.
     pub fn is_empty(&self) -> bool {
-        self.queue.is_empty()
+        !self.consumer.ready()
     }
 }
@@ -0,0 +1,163 @@
+// Generated by ushell_core/tools/ushell_keygen.py from ushell_core_escape.cfg, do not edit:
+// a new sequence goes to the .cfg, then
+// python3 ushell_core/tools/ushell_keygen.py ushell_core/ushell_core_config/inc/ushell_core_escape.cfg \
+//     RTIC_Shell/sources/ushell/ushell2/src/input/key_table.rs \
+//     Embassy_Shell/sources/ushell/ushell2/src/input/key_table.rs
+
+use super::key_reader::Key;
+
+pub const STATES: usize = 16;
+pub const CLASSES: usize = 33;
+
+/// The state of no sequence on its way.
+pub const GROUND: u8 = 0;
+
+/// Action of a transition: nothing.
+pub const ACT_NONE: u8 = 0;
+/// Action of a transition: the byte as `Key::Char`.
+pub const ACT_CHAR: u8 = 1;
+/// Action of a transition: `KEYS[action - ACT_KEY]`.
+pub const ACT_KEY: u8 = 2;
+
+/// The class of every byte.
+pub static CLASS: [u8; 256] = [
+    0, 0, 0, 0, 1, 0, 0, 0, 2, 3, 4, 5, 0, 4, 6, 0,
+    7, 0, 0, 0, 0, 8, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10,
+    10, 11, 12, 13, 14, 15, 16, 17, 18, 10, 10, 19, 10, 10, 10, 10,
+    20, 21, 22, 23, 24, 20, 25, 20, 26, 20, 20, 20, 20, 20, 20, 27,
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 28, 29, 20, 20, 20, 20,
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 30, 31,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+];
+
+/// `(action << 8) | next state` per state and byte class.
+pub static NEXT: [[u16; CLASSES]; STATES] = [
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+        0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+        0x0100, 0x0D00, 0x0000,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100,
+        0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0100, 0x0003, 0x0100, 0x0002,
+        0x0100, 0x0D00, 0x0000,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000A, 0x000B, 0x000F,
+        0x0000, 0x0200, 0x0300, 0x0400, 0x0500, 0x0700, 0x0600, 0x0000, 0x0800, 0x0000,
+        0x0A00, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0200, 0x0300, 0x0400, 0x0500, 0x0700, 0x0600, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000C,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0600, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0900, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0A00, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0700, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0B00, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0C00, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0600, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0700, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000E, 0x000F, 0x000F, 0x000D, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0400, 0x0500, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0400, 0x0500, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x000F, 0x000F,
+    ],
+    [
+        0x0000, 0x0E00, 0x0D00, 0x1400, 0x1300, 0x0F00, 0x1000, 0x1100, 0x1200, 0x0001,
+        0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F, 0x000F,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x000F, 0x000F,
+    ],
+];
+
+/// The keys of the actions from `ACT_KEY` on.
+pub static KEYS: [Key; 19] = [
+    Key::ArrowUp,
+    Key::ArrowDown,
+    Key::ArrowRight,
+    Key::ArrowLeft,
+    Key::Home,
+    Key::End,
+    Key::ShiftTab,
+    Key::Insert,
+    Key::Delete,
+    Key::PageUp,
+    Key::PageDown,
+    Key::Backspace,
+    Key::CtrlD,
+    Key::CtrlK,
+    Key::CtrlN,
+    Key::CtrlP,
+    Key::CtrlU,
+    Key::Enter,
+    Key::Tab,
+];
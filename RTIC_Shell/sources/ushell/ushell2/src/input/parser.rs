@@ -20,7 +20,7 @@ use core::iter::Iterator;
 use core::option::Option::{self, None, Some};
 
 use crate::autocomplete::Autocomplete;
-use crate::history::History;
+use crate::history::{History, HISTORY_INDEX_DEPTH};
 use crate::input::buffer::InputBuffer;
 use crate::input::key_reader::Key;
 use crate::input::renderer::DisplayRenderer;
@@ -40,6 +40,7 @@ use crate::input::renderer::StdWriter;
 /// # Fields
 /// - `renderer`: DisplayRenderer instance for terminal output
 /// - `shell_commands`: Static list of available shell commands and their descriptions.
+/// - `shell_name_lcp`: Prefix index of `shell_commands` (generated `get_name_lcp()`), empty if none.
 /// - `shell_datatypes`: Description of supported argument types.
 /// - `shell_shortcuts`: Description of available keyboard shortcuts.
 /// - `autocomplete`: Autocomplete engine for input suggestions.
@@ -57,6 +58,7 @@ pub struct InputParser<
 > {
     renderer: DisplayRenderer<W>,
     shell_commands: &'static [(&'static str, &'static str)],
+    shell_name_lcp: &'static [u8],
     shell_datatypes: &'static str,
     shell_shortcuts: &'static str,
     autocomplete: Autocomplete<'a, NAC, FNL>,
@@ -65,9 +67,9 @@ pub struct InputParser<
     temp_commands: Vec<&'a str, NAC>,
 
     #[cfg(feature = "heap-history")]
-    history: Box<History<HTC>>,
+    history: Box<History<HTC, HISTORY_INDEX_DEPTH>>,
     #[cfg(not(feature = "heap-history"))]
-    history: History<HTC>,
+    history: History<HTC, HISTORY_INDEX_DEPTH>,
 
     #[cfg(feature = "heap-input-buffer")]
     buffer: Box<InputBuffer<IML>>,
@@ -91,6 +93,8 @@ impl<
     /// # Parameters
     /// - `writer`: UnifiedWriter implementation for output (StdWriter for hosted, CallbackWriter for embedded)
     /// - `shell_commands`: A static list of command names and their descriptions.
+    /// - `shell_name_lcp`: The prefix index of `shell_commands` (sorted by name), used by the
+    ///   autocomplete to find the matches by binary search; `&[]` to scan the list instead.
     /// - `shell_datatypes`: A static string describing supported argument types.
     /// - `shell_shortcuts`: A static string listing available keyboard shortcuts.
     /// - `prompt`: The prompt string displayed to the user during input.
@@ -103,6 +107,7 @@ impl<
     pub fn new(
         writer: W,
         shell_commands: &'static [(&'static str, &'static str)],
+        shell_name_lcp: &'static [u8],
         shell_datatypes: &'static str,
         shell_shortcuts: &'static str,
         prompt: &'static str,
@@ -111,9 +116,9 @@ impl<
         // No need to pre-populate all candidates here
 
         #[cfg(feature = "heap-history")]
-        let history = Box::new(History::<HTC>::new());
+        let history = Box::new(History::<HTC, HISTORY_INDEX_DEPTH>::new());
         #[cfg(not(feature = "heap-history"))]
-        let history = History::<HTC>::new();
+        let history = History::<HTC, HISTORY_INDEX_DEPTH>::new();
 
         #[cfg(feature = "heap-input-buffer")]
         let buffer = Box::new(InputBuffer::<IML>::new());
@@ -124,10 +129,12 @@ impl<
         let log_writer = renderer.writer_mut();
         log_writer.write_str("Shell started (try ###)\n\r");
         log_writer.write_str(prompt);
+        renderer.prompt_shown();
 
         Self {
             renderer,
             shell_commands,
+            shell_name_lcp,
             shell_datatypes,
             shell_shortcuts,
             autocomplete: Autocomplete::<'a, NAC, FNL>::new(),
@@ -164,10 +171,12 @@ impl<
         self.buffer.chars().take(FNL).collect()
     }
 
+    /// Sends what changed in the buffer since the last frame.
     fn render_buffer(&mut self) {
-        let buf_str = self.buffer.to_string();
+        let edit = self.buffer.take_edit();
         let cursor_pos = self.buffer.cursor().min(self.buffer.len());
-        self.renderer.render(self.prompt, &buf_str, cursor_pos);
+        self.renderer
+            .render_edit(self.prompt, self.buffer.as_chars(), cursor_pos, edit);
     }
 
     /// Handles a single character input from the user.
@@ -186,29 +195,7 @@ impl<
         if self.buffer.insert(ch) {
             let autocomplete_input: String<FNL> = self.buffer.chars().take(FNL).collect();
 
-            // Collect commands for this first character
-            // We need to provide &'a [&'a str] to the closure, but we're in a method with lifetime 'self
-            // However, the actual command strings are 'static (from shell_commands), so this is safe
-            self.temp_commands.clear();
-            if let Some(first_char) = autocomplete_input.chars().next() {
-                for &(cmd_name, _) in self.shell_commands {
-                    if let Some(first) = cmd_name.chars().next() {
-                        if first == first_char {
-                            let _ = self.temp_commands.push(cmd_name);
-                        }
-                    }
-                }
-            }
-
-            // SAFETY: The command strings are 'static (from shell_commands: &'static [...]),
-            // and 'static outlives 'a, so it's safe to transmute the slice lifetime.
-            // We're only extending the lifetime of the slice reference, not the strings themselves.
-            let temp_commands_static: &'a [&'a str] = unsafe {
-                core::mem::transmute::<&[&str], &'a [&'a str]>(self.temp_commands.as_slice())
-            };
-
-            self.autocomplete
-                .update_input(&autocomplete_input, |_| temp_commands_static);
+            self.update_autocomplete(&autocomplete_input);
 
             let suggestion = self.autocomplete.current_input();
 
@@ -243,25 +230,7 @@ impl<
         if self.buffer.backspace() {
             let autocomplete_input = self.buffer_to_autocomplete_input();
 
-            // Collect commands for this first character
-            self.temp_commands.clear();
-            if let Some(first_char) = autocomplete_input.chars().next() {
-                for &(cmd_name, _) in self.shell_commands {
-                    if let Some(first) = cmd_name.chars().next() {
-                        if first == first_char {
-                            let _ = self.temp_commands.push(cmd_name);
-                        }
-                    }
-                }
-            }
-
-            // SAFETY: Same justification as handle_char - commands are 'static
-            let temp_commands_static: &'a [&'a str] = unsafe {
-                core::mem::transmute::<&[&str], &'a [&'a str]>(self.temp_commands.as_slice())
-            };
-
-            self.autocomplete
-                .update_input(&autocomplete_input, |_| temp_commands_static);
+            self.update_autocomplete(&autocomplete_input);
         } else {
             self.renderer.bell();
         }
@@ -298,6 +267,46 @@ impl<
         self.render_buffer();
     }
 
+    /// Feeds the autocomplete with the command name part of the input.
+    ///
+    /// With the prefix index of the command table the matches are taken by binary
+    /// search; without it, the commands of the first character are collected first.
+    ///
+    fn update_autocomplete(&mut self, autocomplete_input: &String<FNL>) {
+        if self.shell_name_lcp.len() == self.shell_commands.len() {
+            self.autocomplete.update_input_indexed(
+                autocomplete_input,
+                self.shell_commands,
+                self.shell_name_lcp,
+            );
+            return;
+        }
+
+        // Collect commands for this first character
+        // We need to provide &'a [&'a str] to the closure, but we're in a method with lifetime 'self
+        // However, the actual command strings are 'static (from shell_commands), so this is safe
+        self.temp_commands.clear();
+        if let Some(first_char) = autocomplete_input.chars().next() {
+            for &(cmd_name, _) in self.shell_commands {
+                if let Some(first) = cmd_name.chars().next() {
+                    if first == first_char {
+                        let _ = self.temp_commands.push(cmd_name);
+                    }
+                }
+            }
+        }
+
+        // SAFETY: The command strings are 'static (from shell_commands: &'static [...]),
+        // and 'static outlives 'a, so it's safe to transmute the slice lifetime.
+        // We're only extending the lifetime of the slice reference, not the strings themselves.
+        let temp_commands_static: &'a [&'a str] = unsafe {
+            core::mem::transmute::<&[&str], &'a [&'a str]>(self.temp_commands.as_slice())
+        };
+
+        self.autocomplete
+            .update_input(autocomplete_input, |_| temp_commands_static);
+    }
+
     /// Handles the up arrow key event to navigate backward through command history.
     ///
     /// - Retrieves the previous command from history.
@@ -382,7 +391,7 @@ impl<
         self.render_buffer();
     }
 
-    /// Handles hashtag commands (e.g., #q, ##, #l, #c, #N).
+    /// Handles hashtag commands (e.g., #q, ##, #l, #c, #t, #N).
     ///
     /// Returns:
     /// - A tuple of `(continue_running, maybe_history_command)`
@@ -395,6 +404,7 @@ impl<
     /// - `##` - List all (commands + shortcuts + arg types).
     /// - `#l` - Show command history.
     /// - `#c` - Clear command history.
+    /// - `#t` / `#T` - Dumb terminal (no escape sequences) / ANSI terminal.
     /// - `#N` - Execute command from history at index N.
     ///
     pub fn handle_hashtag(&mut self, stripped: &str) -> (bool, Option<String<IML>>) {
@@ -458,6 +468,14 @@ impl<
                 self.history.clear();
                 writer.write_str("History cleared.\n\r");
             }
+            "t" => {
+                writer.write_str("ANSI off\n\r");
+                self.renderer.set_dumb_terminal(true);
+            }
+            "T" => {
+                writer.write_str("ANSI on\n\r");
+                self.renderer.set_dumb_terminal(false);
+            }
             _ => {
                 // Try to parse as a number for history command execution
                 if let Ok(index) = stripped.parse::<usize>() {
@@ -523,7 +541,7 @@ impl<
     /// - Full line editing capabilities (arrow keys, home/end, delete, etc.)
     /// - Autocompletion (Tab/Shift+Tab)
     /// - Command history (Up/Down arrows)
-    /// - Hashtag command support (#q, ##, #h, #c, #N)
+    /// - Hashtag command support (#q, ##, #h, #c, #t, #N)
     /// - Command execution via the provided callback
     /// - Automatic history management
     ///
@@ -543,6 +561,7 @@ impl<
     /// - `##` - List all (commands + shortcuts + arg types)
     /// - `#l` - Show command history
     /// - `#c` - Clear command history
+    /// - `#t` / `#T` - Dumb / ANSI terminal
     /// - `#N` - Execute command from history at index N
     ///
     /// # Example (Embedded with UART)
@@ -632,6 +651,7 @@ impl<
                             exec_command(&cmd);
                         }
                     }
+                    self.renderer.invalidate();
                     self.render_buffer();
                 }
                 Key::Tab => {
@@ -1,6 +1,6 @@
-use core::fmt::Write;
 use core::ops::FnMut;
 
+use crate::input::buffer::Edit;
 /// Import and re-export the unified writer from logger
 ///
 use crate::logger::UnifiedWriter;
@@ -71,17 +71,102 @@ where
     }
 }
 
+// Costs of the terminal operations in bytes, the same model as the delta
+// renderer of the C++ shell (ushell_core.cpp, m_Render*), so both pick the
+// same operations for the same edit.
+
+/// bytes of ESC [ n C|D
+const fn csi_cost(n: usize) -> usize {
+    if n < 10 {
+        4
+    } else if n < 100 {
+        5
+    } else {
+        6
+    }
+}
+
+/// bytes of the cheapest move back over n columns
+const fn back_cost(n: usize) -> usize {
+    if n < csi_cost(n) { n } else { csi_cost(n) }
+}
+
+/// bytes of ESC [ @
+const ICH_COST: usize = 3;
+
+/// bytes of ESC [ P | ESC [ n P
+const fn dch_cost(n: usize) -> usize {
+    if n == 1 { 3 } else { csi_cost(n) }
+}
+
+/// The input line as the terminal shows it after the last frame.
+#[derive(Clone, Copy)]
+struct Frame {
+    len: usize,
+    cursor: usize,
+    /// `logger::lines_out()` when it was drawn: a log line since then has
+    /// moved the terminal off it.
+    log_mark: u32,
+}
+
 /// DisplayRenderer: handles terminal output
 /// Generic over the writer type to support both std and no_std environments
 ///
+/// Keeps the length and cursor of the line on the terminal; a frame sends
+/// only the characters from the first one which changed, or lets the terminal
+/// shift the tail (insert / delete character) when that is cheaper. The cost
+/// of typing or editing in the middle of a line does not grow with its length.
+///
 pub struct DisplayRenderer<W: UnifiedWriter> {
     writer: W,
+    frame: Frame,
+    /// false: the screen is not known, the next frame redraws the line.
+    drawn: bool,
+    /// No escape sequences at all: backspaces and spaces.
+    dumb: bool,
 }
 
 impl<W: UnifiedWriter> DisplayRenderer<W> {
     /// Create a new DisplayRenderer with the given writer
     pub fn new(writer: W) -> Self {
-        Self { writer }
+        Self {
+            writer,
+            frame: Frame {
+                len: 0,
+                cursor: 0,
+                log_mark: 0,
+            },
+            drawn: false,
+            dumb: false,
+        }
+    }
+
+    /// A terminal without escape sequences (`#t` of the shell): the cursor is
+    /// moved by backspaces and rewriting, the line erased with spaces.
+    pub fn set_dumb_terminal(&mut self, dumb: bool) {
+        self.dumb = dumb;
+    }
+
+    pub fn is_dumb_terminal(&self) -> bool {
+        self.dumb
+    }
+
+    /// Something else was written over the line (command output, a new
+    /// prompt): the next frame redraws it.
+    #[inline]
+    pub fn invalidate(&mut self) {
+        self.drawn = false;
+    }
+
+    /// The prompt was just written on a line of its own.
+    #[inline]
+    pub fn prompt_shown(&mut self) {
+        self.frame = Frame {
+            len: 0,
+            cursor: 0,
+            log_mark: crate::logger::lines_out(),
+        };
+        self.drawn = true;
     }
 
     /// Provides mutable access to the underlying writer
@@ -117,18 +202,192 @@ impl<W: UnifiedWriter> DisplayRenderer<W> {
 
         // Position cursor
         let cursor_position = prompt.len() + safe_cursor_pos + 1;
-        self.write_cursor_position(cursor_position);
+        self.write_csi(cursor_position, b'G');
 
         self.writer.flush();
+        self.drawn = false;
     }
 
-    /// Helper to write cursor position escape sequence
+    /// Brings the line on the terminal to `chars` with the cursor at `cursor`,
+    /// `edit` being what changed since the last frame
+    /// ([`InputBuffer::take_edit`](crate::input::buffer::InputBuffer::take_edit)).
+    ///
+    /// - Redraws prompt and line when the screen is not known (first frame,
+    ///   after [`invalidate`](Self::invalidate) or a log line).
+    /// - An insertion or deletion in the middle of the line is sent as
+    ///   ESC [ @ / ESC [ n P when the terminal shifting the tail costs less
+    ///   than sending it.
+    /// - Else only the characters from the first changed one are sent, the
+    ///   columns left over are erased.
     ///
-    fn write_cursor_position(&mut self, position: usize) {
-        use core::fmt::Write as FmtWrite;
-        let mut buf = heapless::String::<16>::new();
-        let _ = write!(&mut buf, "\x1B[{}G", position);
-        self.writer.write_str(buf.as_str());
+    pub fn render_edit(&mut self, prompt: &str, chars: &[char], cursor: usize, edit: Edit) {
+        let len = chars.len();
+        let cursor = cursor.min(len);
+        let log_mark = crate::logger::lines_out();
+
+        let (shown_len, shown_cursor) = (self.frame.len, self.frame.cursor);
+
+        if self.drawn && self.frame.log_mark == log_mark {
+            match edit {
+                Edit::None => self.move_cursor(chars, shown_cursor, cursor),
+                Edit::Insert { at } if at < len => self.insert(chars, shown_cursor, at, cursor),
+                Edit::Delete { at, count } if at <= len => {
+                    self.delete(chars, shown_cursor, shown_len, at, count, cursor)
+                }
+                edit => {
+                    let from = edit.first().min(shown_len);
+                    self.tail(chars, from, shown_cursor, shown_len, cursor)
+                }
+            }
+        } else {
+            self.writer.write_bytes(b"\r");
+            self.writer.write_str(prompt);
+            self.write_chars(chars);
+            if self.dumb {
+                // no ESC [ K: what is left of the last line drawn
+                self.erase(shown_len.saturating_sub(len));
+            } else {
+                self.writer.write_str("\x1B[K");
+            }
+            self.move_cursor(chars, len, cursor);
+        }
+
+        self.writer.flush();
+        self.frame = Frame { len, cursor, log_mark };
+        self.drawn = true;
+    }
+
+    /// the character at `at` was inserted: the terminal shifts the tail right
+    /// (ESC [ @) when that is cheaper than sending the tail and coming back
+    fn insert(&mut self, chars: &[char], shown_cursor: usize, at: usize, cursor: usize) {
+        let tail = chars.len() - at - 1;
+
+        self.move_cursor(chars, shown_cursor, at);
+        if !self.dumb && ICH_COST < tail + back_cost(tail) {
+            self.writer.write_bytes(b"\x1B[@");
+            self.write_chars(&chars[at..at + 1]);
+            self.move_cursor(chars, at + 1, cursor);
+        } else {
+            self.tail(chars, at, at, chars.len() - 1, cursor);
+        }
+    }
+
+    /// `count` characters were taken out at `at`: the terminal shifts the tail
+    /// left (ESC [ n P) when that is cheaper than sending the tail, erasing the
+    /// columns left over and coming back
+    fn delete(
+        &mut self,
+        chars: &[char],
+        shown_cursor: usize,
+        shown_len: usize,
+        at: usize,
+        count: usize,
+        cursor: usize,
+    ) {
+        let tail = chars.len() - at;
+        let redraw = tail + if count == 1 { 2 } else { 3 } + back_cost(tail);
+
+        self.move_cursor(chars, shown_cursor, at);
+        if !self.dumb && tail > 0 && dch_cost(count) < redraw {
+            if count == 1 {
+                self.writer.write_bytes(b"\x1B[P");
+            } else {
+                self.write_csi(count, b'P');
+            }
+            self.move_cursor(chars, at, cursor);
+        } else {
+            self.tail(chars, at, at, shown_len, cursor);
+        }
+    }
+
+    /// the screen shows `shown_len` characters, the cursor at `shown_cursor`,
+    /// the first `same` of them are still those of `chars`: only the rest is
+    /// sent, then the cursor goes to `cursor`
+    fn tail(&mut self, chars: &[char], same: usize, shown_cursor: usize, shown_len: usize, cursor: usize) {
+        let len = chars.len();
+        let same = same.min(len);
+
+        self.move_cursor(chars, shown_cursor, same);
+        self.write_chars(&chars[same..]);
+        if shown_len > len {
+            self.erase(shown_len - len);
+        }
+        self.move_cursor(chars, len, cursor);
+    }
+
+    /// from column `from` to `to` of the line (the characters up to the
+    /// farther one are those on the screen)
+    fn move_cursor(&mut self, chars: &[char], from: usize, to: usize) {
+        if to < from {
+            let steps = from - to;
+            if self.dumb || steps < csi_cost(steps) {
+                self.repeat(b'\x08', steps);
+            } else {
+                self.write_csi(steps, b'D');
+            }
+        } else if to > from {
+            let steps = to - from;
+            if self.dumb || steps < csi_cost(steps) {
+                self.write_chars(&chars[from..to]);
+            } else {
+                self.write_csi(steps, b'C');
+            }
+        }
+    }
+
+    /// clear `count` columns from the cursor on, the cursor does not move
+    fn erase(&mut self, count: usize) {
+        if self.dumb || count == 1 {
+            self.repeat(b' ', count);
+            self.repeat(b'\x08', count);
+        } else if count > 0 {
+            self.writer.write_bytes(b"\x1B[K");
+        }
+    }
+
+    fn repeat(&mut self, byte: u8, mut count: usize) {
+        let chunk = [byte; 16];
+        while count > 0 {
+            let n = count.min(chunk.len());
+            self.writer.write_bytes(&chunk[..n]);
+            count -= n;
+        }
+    }
+
+    /// UTF-8 of `chars`, through a stack chunk
+    fn write_chars(&mut self, chars: &[char]) {
+        let mut chunk = [0u8; 32];
+        let mut used = 0;
+        for &ch in chars {
+            if used + ch.len_utf8() > chunk.len() {
+                self.writer.write_bytes(&chunk[..used]);
+                used = 0;
+            }
+            used += ch.encode_utf8(&mut chunk[used..]).len();
+        }
+        if used != 0 {
+            self.writer.write_bytes(&chunk[..used]);
+        }
+    }
+
+    /// ESC [ n `op`
+    fn write_csi(&mut self, mut n: usize, op: u8) {
+        let mut seq = [0u8; 24];
+        let mut at = seq.len();
+        at -= 1;
+        seq[at] = op;
+        loop {
+            at -= 1;
+            seq[at] = b'0' + (n % 10) as u8;
+            n /= 10;
+            if n == 0 {
+                break;
+            }
+        }
+        at -= 2;
+        seq[at] = 0x1B;
+        seq[at + 1] = b'[';
+        self.writer.write_bytes(&seq[at..]);
     }
 
     /// Emits an audible bell sound in the terminal.
@@ -149,8 +408,13 @@ impl<W: UnifiedWriter> DisplayRenderer<W> {
     /// - Can be used to visually separate sections or indicate limits.
     ///
     pub fn boundary_marker(&mut self) {
+        if self.dumb {
+            return;
+        }
         self.writer.write_str("\x1B[31m|\x1B[0m\x1B[1D \x1B[1D");
         self.writer.flush();
+        // the column under the cursor is now blank
+        self.drawn = false;
     }
 }
 
@@ -265,6 +529,47 @@ mod tests {
         assert!(output.contains("Hi"));
     }
 
+    #[test]
+    fn test_render_edit_sends_only_the_change() {
+        let mut renderer = DisplayRenderer::new(MockWriter::new());
+        renderer.prompt_shown();
+
+        renderer.render_edit(">", &['a'], 1, Edit::Insert { at: 0 });
+        assert_eq!(renderer.writer.as_str(), "a");
+
+        // mid-line insert: the terminal shifts the tail
+        renderer.writer.buffer.clear();
+        let line = ['a', 'x', 'b', 'c', 'd', 'e'];
+        renderer.frame = Frame { len: 5, cursor: 1, log_mark: renderer.frame.log_mark };
+        renderer.render_edit(">", &line, 2, Edit::Insert { at: 1 });
+        assert_eq!(renderer.writer.as_str(), "\x1B[@x");
+
+        renderer.writer.buffer.clear();
+        renderer.render_edit(">", &['a', 'b', 'c', 'd', 'e'], 1, Edit::Delete { at: 1, count: 1 });
+        assert_eq!(renderer.writer.as_str(), "\x08\x1B[P");
+    }
+
+    #[test]
+    fn test_render_edit_redraws_after_invalidate() {
+        let mut renderer = DisplayRenderer::new(MockWriter::new());
+        renderer.prompt_shown();
+        renderer.invalidate();
+        renderer.render_edit(">", &['h', 'i'], 2, Edit::None);
+        assert_eq!(renderer.writer.as_str(), "\r>hi\x1B[K");
+    }
+
+    #[test]
+    fn test_dumb_terminal_no_escapes() {
+        let mut renderer = DisplayRenderer::new(MockWriter::new());
+        renderer.set_dumb_terminal(true);
+        renderer.prompt_shown();
+        renderer.render_edit(">", &['a', 'b', 'c'], 3, Edit::From(0));
+        renderer.render_edit(">", &['a', 'c'], 1, Edit::Delete { at: 1, count: 1 });
+        renderer.render_edit(">", &['a', 'c'], 0, Edit::None);
+
+        assert!(!renderer.writer.as_str().contains('\x1B'));
+    }
+
     #[cfg(not(feature = "hosted"))]
     #[test]
     fn test_callback_writer() {
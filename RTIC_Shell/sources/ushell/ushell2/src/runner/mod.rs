@@ -203,6 +203,8 @@ mod async_impl {
 
 pub struct ShellConfig<const IML: usize, const EBS: usize> {
     pub get_commands: fn() -> &'static [(&'static str, &'static str)],
+    /// The prefix index of the command table (`commands::get_name_lcp`), `|| &[]` for none.
+    pub get_name_lcp: fn() -> &'static [u8],
     pub get_datatypes: fn() -> &'static str,
     pub get_shortcuts: fn() -> &'static str,
     pub is_shortcut: fn(&str) -> bool,
@@ -271,12 +273,14 @@ pub async fn run_shell<
 
     // Get static data references once before loop instead of calling every iteration
     let commands = (config.get_commands)();
+    let name_lcp = (config.get_name_lcp)();
     let datatypes = (config.get_datatypes)();
     let shortcuts = (config.get_shortcuts)();
 
     let mut parser = InputParser::<CallbackWriter<fn(&[u8]), fn()>, NAC, FNL, IML, HTC>::new(
         writer,
         commands,
+        name_lcp,
         datatypes,
         shortcuts,
         config.prompt,
@@ -334,12 +338,14 @@ pub fn run_shell<
 
     // Get static data references once before loop
     let commands = (config.get_commands)();
+    let name_lcp = (config.get_name_lcp)();
     let datatypes = (config.get_datatypes)();
     let shortcuts = (config.get_shortcuts)();
 
     let mut parser = InputParser::<CallbackWriter<fn(&[u8]), fn()>, NAC, FNL, IML, HTC>::new(
         writer,
         commands,
+        name_lcp,
         datatypes,
         shortcuts,
         config.prompt,
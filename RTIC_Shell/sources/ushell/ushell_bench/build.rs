@@ -0,0 +1,81 @@
+//! Writes the synthetic command tables of the benchmarks into OUT_DIR: per size a
+//! commands.cfg for `generate_commands_dispatcher!` (the format of ushell_usercode), the
+//! functions it points to and the module generated from it, included by `src/lib.rs`.
+//!
+//! Command `i` is `<letter>cmd<i>`, the letters in turn (about size / 26 names per first
+//! letter, as autocomplete sees them), with the descriptors of the real tables in turn:
+//! `v`, `D`, `sDh` and `tB`.
+
+use std::env;
+use std::fmt::Write as _;
+use std::fs;
+use std::path::Path;
+
+/// The table sizes, also `SIZES` of the crate.
+const SIZES: [usize; 3] = [10, 100, 1000];
+
+/// Descriptor, parameters of the function, arguments of a command line.
+const SHAPES: [(&str, &str, &str); 4] = [
+    ("v", "", ""),
+    ("D", "baud: u32", " 115200"),
+    ("sDh", "port: &str, baud: u32, data: &[u8]", " \"uart 2\" 9600 DEADBEEF01020304"),
+    ("tB", "on: bool, level: u8", " true 0x7F"),
+];
+
+/// The command lines of a table: this many commands spread over it.
+const LINES: usize = 8;
+
+fn name(i: usize) -> String {
+    format!("{}cmd{:04}", (b'a' + (i % 26) as u8) as char, i)
+}
+
+fn main() {
+    let out_dir = env::var("OUT_DIR").unwrap();
+    let mut tables = String::new();
+
+    for size in SIZES {
+        let mut groups: Vec<Vec<String>> = vec![Vec::new(); SHAPES.len()];
+        let _ = writeln!(tables, "pub mod f{size} {{");
+        for i in 0..size {
+            let (_, params, _) = SHAPES[i % SHAPES.len()];
+            let args: String = params
+                .split(", ")
+                .filter(|p| !p.is_empty())
+                .map(|p| format!("{},", p.split(':').next().unwrap()))
+                .collect();
+            let _ = writeln!(
+                tables,
+                "    pub fn {}({params}) {{ core::hint::black_box(({args})); }}",
+                name(i)
+            );
+            groups[i % SHAPES.len()].push(format!("crate::f{size}::{}", name(i)));
+        }
+        let lines: Vec<String> = (0..LINES)
+            .map(|k| k * size / LINES)
+            .map(|i| format!("{:?}", format!("{}{}", name(i), SHAPES[i % SHAPES.len()].2)))
+            .collect();
+        let _ = writeln!(tables, "    pub static LINES: &[&str] = &[{}];", lines.join(", "));
+        let _ = writeln!(tables, "}}\n");
+
+        let cfg: Vec<String> = SHAPES
+            .iter()
+            .zip(&groups)
+            .filter(|(_, paths)| !paths.is_empty())
+            .map(|((desc, _, _), paths)| format!("{desc:<6}: {}", paths.join("\n        ")))
+            .collect();
+        let cfg_path = Path::new(&out_dir).join(format!("commands_{size}.cfg"));
+        fs::write(&cfg_path, cfg.join(",\n")).unwrap();
+
+        let _ = writeln!(
+            tables,
+            "ushell_dispatcher::generate_commands_dispatcher! {{\n    mod t{size};\n    \
+             hexstr_size       = crate::MAX_HEXSTR_LEN;\n    \
+             error_buffer_size = crate::ERROR_BUFFER_SIZE;\n    \
+             path              = {:?}\n}}\n",
+            cfg_path.to_str().unwrap()
+        );
+    }
+
+    fs::write(Path::new(&out_dir).join("tables.rs"), tables).unwrap();
+    println!("cargo:rerun-if-changed=build.rs");
+}
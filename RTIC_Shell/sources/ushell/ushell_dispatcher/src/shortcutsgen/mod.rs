@@ -7,8 +7,9 @@
 //! ## Purpose
 //! - Parses a shortcut mapping file at compile time.
 //! - Registers shortcut keys mapped to function paths.
-//! - Provides a dispatcher function that matches input strings to registered shortcuts
-//!   and invokes the corresponding function.
+//! - Provides a dispatcher function that looks the first two bytes of the input up in two
+//!   tables indexed by `byte - 0x20` (prefix, then key) and invokes the corresponding
+//!   function with the rest of the line: one load per byte, whatever the number of shortcuts.
 //! - Includes helper functions to list all available shortcuts and check if a shortcut is supported.
 //!
 //! ## Macro Input Format
@@ -84,8 +85,8 @@ pub fn generate_shortcuts_dispatcher_from_file(input: TokenStream) -> TokenStrea
     let raw = std::fs::read_to_string(&full_path)
         .unwrap_or_else(|_| panic!("Failed to read shortcut file: {:?}", full_path));
 
-    let mut match_arms = vec![];
-    let mut prefixes = std::collections::HashSet::new();
+    // (prefix, key) of every shortcut, in the order of the file, with its function
+    let mut entries: Vec<(u8, u8, syn::Path)> = vec![];
     let mut shortcut_keys = vec![];
     let mut buffer = String::new();
 
@@ -98,7 +99,6 @@ pub fn generate_shortcuts_dispatcher_from_file(input: TokenStream) -> TokenStrea
         if line.ends_with("},") {
             if let Some((prefix, rest)) = buffer.split_once(':') {
                 let prefix = prefix.trim();
-                prefixes.insert(prefix.to_string());
 
                 for entry in rest.split(',') {
                     let entry = entry.trim().trim_matches('{').trim_matches('}').trim();
@@ -110,13 +110,28 @@ pub fn generate_shortcuts_dispatcher_from_file(input: TokenStream) -> TokenStrea
                         let func = func.trim();
                         if let Ok(path) = syn::parse_str::<syn::Path>(func) {
                             let full_key = format!("{}{}", prefix, key);
-                            shortcut_keys.push(full_key.clone());
-                            match_arms.push(quote! {
-                                #full_key => {
-                                    #path(param);
-                                    Ok(())
-                                },
-                            });
+                            // the line is split after its first two bytes: a shortcut is a
+                            // prefix and a key, one printable ASCII character each
+                            let printable = |b: &u8| (0x20..0x7F).contains(b);
+                            let bytes = full_key.as_bytes();
+                            if bytes.len() != 2 || !bytes.iter().all(printable) {
+                                return syn::Error::new(
+                                    proc_macro2::Span::call_site(),
+                                    format!("Shortcut '{}': a prefix and a key of one printable ASCII character each", full_key),
+                                )
+                                .to_compile_error()
+                                .into();
+                            }
+                            if entries.iter().any(|(p, k, _)| (*p, *k) == (bytes[0], bytes[1])) {
+                                return syn::Error::new(
+                                    proc_macro2::Span::call_site(),
+                                    format!("Shortcut '{}' defined twice", full_key),
+                                )
+                                .to_compile_error()
+                                .into();
+                            }
+                            entries.push((bytes[0], bytes[1], path));
+                            shortcut_keys.push(full_key);
                         } else {
                             panic!("Invalid function path: {}", func);
                         }
@@ -127,45 +142,73 @@ pub fn generate_shortcuts_dispatcher_from_file(input: TokenStream) -> TokenStrea
         }
     }
 
-    // Check if all prefixes are ASCII for optimization
-    let all_ascii = prefixes.iter().all(|p| p.is_ascii());
-
-    let support_fn = if all_ascii {
-        // Optimized ASCII version using byte comparison
-        let prefix_bytes: Vec<_> = prefixes
-            .iter()
-            .map(|p| {
-                let byte = p.as_bytes()[0];
-                quote! { #byte }
+    // Two lookup tables indexed by `byte - 0x20`: the prefix byte gives a row of
+    // `KEYS` (0: not a prefix), the key byte the handler in it. A handler is a wrapper
+    // `fn(&str)` around the function, the parameter is the rest of the line, not copied.
+    let mut prefixes: Vec<u8> = vec![];
+    for (prefix, _, _) in &entries {
+        if !prefixes.contains(prefix) {
+            prefixes.push(*prefix);
+        }
+    }
+    let prefix_index: Vec<u8> = (0x20u8..0x80)
+        .map(|b| prefixes.iter().position(|p| *p == b).map_or(0, |i| i as u8 + 1))
+        .collect();
+
+    let mut wrappers = vec![];
+    let mut rows = vec![];
+    for prefix in &prefixes {
+        let cells: Vec<_> = (0x20u8..0x80)
+            .map(|b| match entries.iter().position(|(p, k, _)| (*p, *k) == (*prefix, b)) {
+                Some(i) => {
+                    let wrapper = quote::format_ident!("__shortcut_{}", i);
+                    quote! { Some(#wrapper) }
+                }
+                None => quote! { None },
             })
             .collect();
+        rows.push(quote! { [ #( #cells ),* ] });
+    }
+    for (i, (_, _, path)) in entries.iter().enumerate() {
+        let wrapper = quote::format_ident!("__shortcut_{}", i);
+        wrappers.push(quote! {
+            #[inline(always)]
+            fn #wrapper(param: &str) {
+                let _ = #path(param);
+            }
+        });
+    }
+    let rows_len = rows.len();
 
-        quote! {
-            #[inline]
-            pub fn is_supported_shortcut(input: &str) -> bool {
-                let trimmed = input.trim();
-                if trimmed.is_empty() {
-                    return false;
-                }
-                let first_byte = trimmed.as_bytes()[0];
-                matches!(first_byte, #( #prefix_bytes )|*)
+    let table = quote! {
+        /// A shortcut handler, the parameter is a slice of the line.
+        pub type Handler = fn(&str);
+
+        #( #wrappers )*
+
+        /// Row of `KEYS` + 1 per prefix byte - 0x20, 0 for none.
+        static PREFIX_INDEX: [u8; 96] = [ #( #prefix_index ),* ];
+
+        /// The handler per key byte - 0x20, a row per prefix.
+        static KEYS: [[Option<Handler>; 96]; #rows_len] = [ #( #rows ),* ];
+
+        /// The handler of the first two bytes of the line, if they are a shortcut.
+        #[inline(always)]
+        fn lookup(prefix: u8, key: u8) -> Option<Handler> {
+            let row = *PREFIX_INDEX.get(prefix.wrapping_sub(0x20) as usize)? as usize;
+            if row == 0 {
+                return None;
             }
+            *KEYS[row - 1].get(key.wrapping_sub(0x20) as usize)?
         }
-    } else {
-        // Non-ASCII version using string comparison
-        let supported_checks = prefixes.iter().map(|p| {
-            quote! { c == #p }
-        });
+    };
 
-        quote! {
-            #[inline]
-            pub fn is_supported_shortcut(input: &str) -> bool {
-                let trimmed = input.trim();
-                if trimmed.is_empty() {
-                    return false;
-                }
-                let c = &trimmed[0..1];
-                #( #supported_checks )||*
+    let support_fn = quote! {
+        #[inline]
+        pub fn is_supported_shortcut(input: &str) -> bool {
+            match input.trim().as_bytes().first() {
+                Some(&first) => PREFIX_INDEX.get(first.wrapping_sub(0x20) as usize).is_some_and(|&row| row != 0),
+                None => false,
             }
         }
     };
@@ -182,27 +225,24 @@ pub fn generate_shortcuts_dispatcher_from_file(input: TokenStream) -> TokenStrea
         #[inline]
         pub fn dispatch<'a>(input: &'a str, error_buffer: &'a mut heapless::String<{ #error_buffer_size }>) -> Result<(), &'a str> {
             let trimmed = input.trim();
-            let (key, param) = if trimmed.len() >= 2 {
-                let key = &trimmed[..2];
-                let param = trimmed[2..].trim();
-                (key, param)
-            } else {
-                (trimmed, "")
-            };
-            match key {
-                #( #match_arms )*
-                _ => {
-                    error_buffer.clear();
-                    use core::fmt::Write;
-                    let _ = write!(error_buffer, "Unknown shortcut: {}", key);
-                    Err(error_buffer.as_str())
-                },
+            if let [prefix, key, ..] = *trimmed.as_bytes() {
+                if let Some(handler) = lookup(prefix, key) {
+                    // both bytes are ASCII: byte 2 starts a character
+                    handler(trimmed[2..].trim());
+                    return Ok(());
+                }
             }
+            let key = trimmed.char_indices().nth(2).map_or(trimmed, |(end, _)| &trimmed[..end]);
+            error_buffer.clear();
+            use core::fmt::Write;
+            let _ = write!(error_buffer, "Unknown shortcut: {}", key);
+            Err(error_buffer.as_str())
         }
     };
 
     let expanded = quote! {
         pub mod #mod_name {
+            #table
             #dispatch_fn
             #support_fn
             #list_fn
@@ -59,6 +59,7 @@ use ushell2::{log_info, log_error};
 // These are derived directly from `InputParser::new`'s signature in parser.rs:
 //
 //   shell_commands:  &'static [(&'static str, &'static str)]
+//   shell_name_lcp:  &'static [u8]
 //   shell_datatypes: &'static str
 //   shell_shortcuts: &'static str
 //
@@ -68,6 +69,9 @@ use ushell2::{log_info, log_error};
 /// Returns the static command table passed to `InputParser`.
 pub type GetCommandsFn  = fn() -> &'static [(&'static str, &'static str)];
 
+/// Returns the prefix index of the command table passed to `InputParser`.
+pub type GetNameLcpFn   = fn() -> &'static [u8];
+
 /// Returns the static datatype-description string passed to `InputParser`.
 pub type GetDatatypesFn = fn() -> &'static str;
 
@@ -97,6 +101,7 @@ pub type DispatchFn<const E: usize> =
 /// ```ignore
 /// let config = ShellConfig {
 ///     get_commands:        commands::get_commands,
+///     get_name_lcp:        commands::get_name_lcp,
 ///     get_datatypes:       commands::get_datatypes,
 ///     get_shortcuts:       shortcuts::get_shortcuts,
 ///     is_shortcut:         shortcuts::is_supported_shortcut,
@@ -109,6 +114,8 @@ pub type DispatchFn<const E: usize> =
 pub struct ShellConfig<const E: usize> {
     /// Returns `&'static [(&'static str, &'static str)]` — the command table.
     pub get_commands:        GetCommandsFn,
+    /// Returns `&'static [u8]` — the prefix index of the command table (autocomplete).
+    pub get_name_lcp:        GetNameLcpFn,
     /// Returns `&'static str` — human-readable datatype descriptions.
     pub get_datatypes:       GetDatatypesFn,
     /// Returns `&'static str` — human-readable shortcut descriptions.
@@ -178,6 +185,7 @@ impl<
         let parser = InputParser::new(
             writer,
             (config.get_commands)(),    // &'static [(&'static str, &'static str)]
+            (config.get_name_lcp)(),    // &'static [u8]
             (config.get_datatypes)(),   // &'static str
             (config.get_shortcuts)(),   // &'static str
             config.prompt,              // &'static str
@@ -200,15 +208,13 @@ impl<
     ///
     /// # Example (inside the RTIC shell task)
     /// ```ignore
-    /// ctx.shared.rx_queue.lock(|rx_queue| {
-    ///     let mut reader = RxQueueReader::new(rx_queue);
-    ///     while !reader.is_empty() {
-    ///         if !ctx.local.shell.step(&mut reader) {
-    ///             log_info!("Shell exited");
-    ///             break;
-    ///         }
+    /// let mut reader = RxQueueReader::new(ctx.local.rx_consumer);
+    /// while !reader.is_empty() {
+    ///     if !ctx.local.shell.step(&mut reader) {
+    ///         log_info!("Shell exited");
+    ///         break;
     ///     }
-    /// });
+    /// }
     /// ```
     pub fn step(&mut self, reader: &mut RxQueueReader) -> bool {
         // Decode one raw byte into an ANSI key event (handles multi-byte sequences)
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# Renode regression run of a build: time to prompt and command round trip against the
+# budgets of test/renode/shell_perf.robot
+#
+#   ./renode_test.sh f103|f411 [renode-test options, e.g. --variable PROMPT_BUDGET_S:0.8]
+
+TARGET=${1:-f103}
+shift
+
+case ${TARGET} in
+    f103) PLATFORM=platforms/cpus/stm32f103.repl ;;
+    f411) PLATFORM=platforms/cpus/stm32f4.repl ;;
+    *)    echo "usage: $0 f103|f411 [renode-test options]"; exit 1 ;;
+esac
+
+BUILD_DIR=$(pwd)/build_stm32${TARGET}
+
+if [[ ! -f ${BUILD_DIR}/stm32app.elf ]]; then
+    echo "no ${BUILD_DIR}/stm32app.elf, run ./build_${TARGET}.sh first"
+    exit 1
+fi
+
+renode-test $(pwd)/test/renode/shell_perf.robot \
+    --variable ELF:${BUILD_DIR}/stm32app.elf \
+    --variable PLATFORM:${PLATFORM} \
+    --results-dir ${BUILD_DIR}/renode_test \
+    "$@"
@@ -3,7 +3,13 @@
 #include "hd44780_pcf8574.h"
 #include "ushell_core.h"
 #include "ushell_core_printout.h"
+#include "ushell_core_log.h"
 #include "uart_access.h"
+#include "bench.h"
+#include "mono_time.h"
+#include "cmd_sched.h"
+#include "load_meter.h"
+#include "tx_pools.h"
 
 #if defined(STM32F4)
 #  include "stm32f4xx_hal.h"
@@ -22,7 +28,6 @@
 
 /* ── Interfaces declaration ─────────────────────────────────────────────── */
 
-bool queue_is_valid(TX_QUEUE *q);
 void LCD_Post(uint8_t row, uint8_t col, const char *text);
 
 
@@ -80,6 +85,13 @@ static void shell_thread_entry(ULONG initial_input)
 
 /* ── LCD ────────────────────────────────────────────────────────────────── */
 
+/* An active object: LCD_Post() fills a block of the LCD event channel and
+ * queues its pointer without waiting (tx_pools.h, nothing copied through the
+ * queue), it never prints; the queue's send-notify sets LCD_EVT_MSG, a 2 s timer sets
+ * LCD_EVT_RETRY while the display is down; the LCD thread waits on the
+ * event flags only and drains the queue. What cannot be shown is counted,
+ * the LCD thread reports the new drops itself. */
+
 #define LCD_MSG_LEN   32   /* Max characters per message */
 
 typedef struct {
@@ -88,74 +100,138 @@ typedef struct {
     char    text[LCD_MSG_LEN];
 } LcdMessage_t;
 
-#define LCD_QUEUE_MSG_WORDS     ((sizeof(LcdMessage_t) + sizeof(ULONG) - 1) / sizeof(ULONG))
-#define LCD_QUEUE_CAPACITY      5          
+#define LCD_QUEUE_CAPACITY      5          /* blocks and queued pointers */
+
+#define LCD_EVT_MSG     0x1UL   /* a message was queued */
+#define LCD_EVT_RETRY   0x2UL   /* the display is down: init it again */
 
 static TX_THREAD lcd_thread;
-static TX_QUEUE  lcd_queue;
+static tx_evt_channel_s lcd_channel;
+static TX_EVENT_FLAGS_GROUP lcd_events;
+static TX_TIMER  lcd_retry_timer;
 static ULONG lcd_stack[2048 / sizeof(ULONG)];
-static ULONG lcd_queue_storage[LCD_QUEUE_CAPACITY * LCD_QUEUE_MSG_WORDS];
+static ULONG lcd_queue_storage[LCD_QUEUE_CAPACITY];
+static ULONG lcd_pool_storage[TX_EVT_POOL_BYTES(sizeof(LcdMessage_t), LCD_QUEUE_CAPACITY) / sizeof(ULONG)];
+
+static bool lcd_queue_ready = false;        /* set once, by tx_application_define() */
+static ULONG lcd_dropped_full = 0; /* no free block or the queue was full */
+static ULONG lcd_dropped_down = 0; /* taken while the display was down */
+
+static void lcd_queue_notify(TX_QUEUE *queue)
+{
+    (void)queue;
+    (void)tx_event_flags_set(&lcd_events, LCD_EVT_MSG, TX_OR);
+}
+
+static void lcd_retry_expired(ULONG input)
+{
+    (void)input;
+    (void)tx_event_flags_set(&lcd_events, LCD_EVT_RETRY, TX_OR);
+}
 
 void LCD_Post(uint8_t row, uint8_t col, const char *text) {
 
-    if (!queue_is_valid(&lcd_queue)) {
-        uSHELL_PRINTF("Queue is invalid..\n");
+    if (!lcd_queue_ready) {
+        lcd_dropped_full++;
         return;
     }
 
-    LcdMessage_t msg;
-    msg.row = row;
-    msg.col = col;
+    LcdMessage_t *msg = (LcdMessage_t *)tx_evt_alloc(&lcd_channel);
+    if (msg == TX_NULL) {
+        lcd_dropped_full++;
+        return;
+    }
+    msg->row = row;
+    msg->col = col;
 
     /* Safe string copy */
     uint8_t i = 0;
     while (text[i] && i < LCD_MSG_LEN - 1) {
-        msg.text[i] = text[i];
+        msg->text[i] = text[i];
         i++;
     }
-    msg.text[i] = '\0';
+    msg->text[i] = '\0';
 
-    UINT status = tx_queue_send(&lcd_queue, &msg, TX_NO_WAIT);
-    if (status != TX_SUCCESS){
-        uSHELL_PRINTF("Failed to send LCD message\n");
+    if (!tx_evt_post(&lcd_channel, msg)) {
+        lcd_dropped_full++;
     }
 }
 
+/* the line of load 1, in the place of "System Ready" */
+static void load_show(const char *line) {
+    LCD_Post(0, 0, line);
+}
+
+/* The display is brought up in the background: a display which does not
+ * answer is tried again every LCD_RETRY_MS, the messages posted meanwhile
+ * are dropped (the LED thread posts its line again every 2 s). */
+#define LCD_RETRY_MS  2000
+
+static void lcd_show_splash(HD44780_PCF8574 &lcd)
+{
+    lcd.clear();
+    lcd.setCursor(0, 0);
+    lcd.print("System Ready");
+    lcd.setCursor(0, 1);
+    lcd.print("STM32F103");
+}
+
 static void lcd_thread_entry(ULONG initial_input)
 {
     (void)initial_input;
 
     static HD44780_PCF8574 lcd(0x27, 16, 2);   /* PCF8574 at 0x27, 16x2 display */
 
-    if (!lcd.init()) {
+    bool ready = lcd.init();
+    if (ready) {
+        lcd_show_splash(lcd);
+    } else {
         /* I2C probe failed: wrong address, missing component, or
          * PICSimLab PCF8574 not connected on I2C1 (PB6=SCL, PB7=SDA).
          * Try 0x3F if you have a PCF8574A backpack. */
-        uSHELL_PRINTF("LCD I2C FAIL - check address & wiring\n");
-        while (!lcd.ok()) {
-            uSHELL_PRINTF("LCD retry...\n");
-            tx_thread_sleep(MS_TO_TICKS(50)); /* 50 ms */
-            lcd.init();
-        }
+        uSHELL_LOG_ERROR("LCD I2C FAIL - check address & wiring, retried every %u ms", (unsigned)LCD_RETRY_MS);
+        (void)tx_timer_activate(&lcd_retry_timer);
     }
 
-    uSHELL_PRINTF("LCD OK\n");
+    ULONG reported = 0;
 
-    lcd.clear();
-    lcd.setCursor(0, 0);
-    lcd.print("System Ready");
-    lcd.setCursor(0, 1);
-    lcd.print("STM32F103");
+    while (1) {
+        ULONG events = 0;
+        (void)tx_event_flags_get(&lcd_events, LCD_EVT_MSG | LCD_EVT_RETRY, TX_OR_CLEAR, &events, TX_WAIT_FOREVER);
+
+        if (!ready && (events & LCD_EVT_RETRY)) {
+            ready = lcd.init();
+            if (ready) {
+                (void)tx_timer_deactivate(&lcd_retry_timer);
+                uSHELL_LOG_INFO("LCD OK");
+                lcd_show_splash(lcd);
+            }
+        }
 
-    LcdMessage_t msg;
+        /* every message queued since the flag was set */
+        LcdMessage_t *msg;
+        while ((msg = (LcdMessage_t *)tx_evt_receive(&lcd_channel, TX_NO_WAIT)) != TX_NULL) {
+            if (!ready) {
+                lcd_dropped_down++;
+            } else {
+                lcd.setCursor(msg->col, msg->row);
+                lcd.print(msg->text);
+                if (!lcd.ok()) {       /* an I2C error: init again at the next attempt */
+                    ready = false;
+                    (void)tx_timer_activate(&lcd_retry_timer);
+                }
+            }
+            tx_evt_release(msg);
+        }
 
-    while (1) {
-        /* Block until a message arrives (no timeout = wait forever) */
-        if (tx_queue_receive(&lcd_queue, &msg, TX_WAIT_FOREVER) == TX_SUCCESS) {
-            lcd.setCursor(msg.col, msg.row);
-            lcd.print(msg.text);
+        const ULONG dropped = lcd_dropped_full + lcd_dropped_down;
+        if (dropped != reported) {
+            uSHELL_LOG_WARN("LCD: %lu messages dropped (%lu queue full, %lu display down)",
+                            (unsigned long)(dropped - reported), (unsigned long)lcd_dropped_full,
+                            (unsigned long)lcd_dropped_down);
+            reported = dropped;
         }
-    }    
+    }
 }
 
 
@@ -171,13 +247,29 @@ void tx_application_define(void *first_unused_memory)
     (void)first_unused_memory;
     UINT status;
 
+#if defined(TX_EXECUTION_PROFILE_ENABLE)
+    /* the cycle counter of the profile runs before the first thread */
+    _tx_execution_initialize();
+#endif
+    mono_time_init();       /* mono_time_us() from here on, the refresh timer */
+
     led_init();
+    uart_start();
+
+    /* shell handler scratch (byte pool) */
+    status = tx_pools_init();
+    if (status != TX_SUCCESS){
+        uSHELL_PRINTF("Failed to create the scratch pool\n");
+        while (1); /* Handle error — pool creation failed */
+    }
 
-    status = tx_queue_create(
-        &lcd_queue,                     /* Control block          */
+    status = tx_evt_channel_create(
+        &lcd_channel,                   /* Control blocks         */
         (CHAR*)"LCD Queue",             /* Name                   */
-        LCD_QUEUE_MSG_WORDS,            /* message size           */
-        lcd_queue_storage,              /* Storage buffer         */
+        sizeof(LcdMessage_t),           /* event (block) size     */
+        lcd_pool_storage,               /* Block pool storage     */
+        sizeof(lcd_pool_storage),       /* Pool size in bytes     */
+        lcd_queue_storage,              /* Queue of pointers      */
         sizeof(lcd_queue_storage)       /* Buffer size in bytes   */
     );
 
@@ -186,6 +278,21 @@ void tx_application_define(void *first_unused_memory)
         while (1); /* Handle error — queue creation failed */
     }
 
+    /* the LCD thread waits on these flags: the queue's send-notify and the retry timer */
+    status = tx_event_flags_create(&lcd_events, (CHAR*)"LCD Events");
+    if (status == TX_SUCCESS) {
+        status = tx_queue_send_notify(&lcd_channel.sQueue, lcd_queue_notify);
+    }
+    if (status == TX_SUCCESS) {
+        status = tx_timer_create(&lcd_retry_timer, (CHAR*)"LCD Retry", lcd_retry_expired, 0,
+                                 MS_TO_TICKS(LCD_RETRY_MS), MS_TO_TICKS(LCD_RETRY_MS), TX_NO_ACTIVATE);
+    }
+    if (status != TX_SUCCESS) {
+        uSHELL_PRINTF("Failed to create LCD events\n");
+        while (1) {} /* Handle error — typically halt or assert */
+    }
+    lcd_queue_ready = true;
+
     /* ── LED ───────────────────────────────────── */
     /* Create LED thread: priority 10, preemption-threshold 10 (disabled),
        no time-slice, auto-start */
@@ -245,18 +352,21 @@ void tx_application_define(void *first_unused_memory)
     if (status != TX_SUCCESS) {
         uSHELL_PRINTF("Failed to create SHELL thread\n");
         while (1) {} /* Handle error — typically halt or assert */
-    }    
+    }
+
+    /* ── BENCH ─────────────────────────────────── */
+    /* echo and wake threads of the bench command (empty without BENCH) */
+    bench_init();
+
+    /* ── SCHED ─────────────────────────────────── */
+    /* timers and thread of the every / sched commands */
+    cmd_sched_init();
+
+    /* ── LOAD ──────────────────────────────────── */
+    /* the idle counting thread of the load command, load 1 puts it on the LCD */
+    load_meter_init(load_show);
 }
 
 #ifdef __cplusplus
 }
 #endif
-
-/* ───────────────────────────────────────────────────────────────────────── */
-/* ── Helpers ────────────────────────────────────────────────────────────── */
-/* ───────────────────────────────────────────────────────────────────────── */
-
-bool queue_is_valid(TX_QUEUE *q)
-{
-    return tx_queue_info_get(q, NULL, NULL, NULL, NULL, NULL, NULL) == TX_SUCCESS;
-}
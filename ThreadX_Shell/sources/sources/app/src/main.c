@@ -5,7 +5,8 @@
  *   1. HAL_Init()            – flash latency, SysTick 1 ms base
  *   2. SystemClock_Config()  – bring up PLL (72 MHz F1 / 100 MHz F4)
  *   3. uart_init()           – UART peripheral before any uart_printf
- *   4. tx_kernel_enter()     – hand control to ThreadX (never returns)
+ *   4. sys_info_paint_isr_stack() – fill the ISR stack for its peak usage
+ *   5. tx_kernel_enter()     – hand control to ThreadX (never returns)
  *
  * NOTE: Do NOT start SysTick yourself. ThreadX takes ownership of it
  *       inside tx_kernel_enter() via tx_initialize_low_level().
@@ -21,6 +22,7 @@
 
 #include "tx_api.h"
 #include "uart_access.h"
+#include "sys_info.h"
 
 /* ── Forward declarations ───────────────────────────────────────────────── */
 void tx_application_define(void *first_unused_memory);   /* app_threadx.c */
@@ -39,7 +41,10 @@ int main(void)
     /* 3. Init UART so uart_printf() works from the very first thread tick. */
     uart_setup();
 
-    /* 4. Start the ThreadX kernel — calls tx_application_define() then
+    /* 4. Fill the ISR stack (this one) so sysinfo can report its peak. */
+    sys_info_paint_isr_stack();
+
+    /* 5. Start the ThreadX kernel — calls tx_application_define() then
           schedules threads.  Never returns. */
     tx_kernel_enter();
 
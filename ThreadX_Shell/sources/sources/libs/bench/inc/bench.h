@@ -0,0 +1,47 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/*
+    On-target microbenchmarks in DWT cycles, built with -DUSHELL_BENCH=ON (BENCH 1).
+
+        bench 0         every benchmark, one line each
+        bench <n>       only the n-th
+
+    Each benchmark runs BENCH_SAMPLES times from the shell thread and prints the min, median
+    and max cycles, less the cost of reading the counter twice. The interrupts stay enabled:
+    the min and the median are the code, the max also has the ISRs that hit a sample.
+
+        asc2int hex / dec       asc2int() of "0x1234ABCD" / "4294967295"
+        hexlify 16B             hexlify() of 16 bytes
+        unhexlify 16B           unhexlify() of 32 hex digits
+        strtok_ex 4 tok         strtok_ex() through "bench 1 0x20 text"
+        lookup hit / miss       Microshell::FindCommand(), the parser's table lookup
+        queue round trip        tx_queue_send() to an echo thread of higher priority and
+                                tx_queue_receive() of its answer: two switches, two copies
+        ctx switch              tx_semaphore_put() to a thread of higher priority until it
+                                runs: the put and one switch
+        irq->task               a software pended IRQ (SPI2, unused) whose handler puts the
+                                same semaphore, until the thread runs: entry, handler, switch
+
+    The names and the columns are those of the FreeRTOS shell, whose AO, UART and LCD rows
+    have no counterpart here (ushell_core/tools/bench_matrix.py compares the builds).
+    bench_init() creates the echo and wake threads, their queues and the semaphore, and
+    enables the IRQ. Without BENCH the command only says so and bench_init() is empty.
+*/
+
+#define BENCH_SAMPLES   31U     /* odd: the median is a sample */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* from tx_application_define(), with the other threads */
+void bench_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H */
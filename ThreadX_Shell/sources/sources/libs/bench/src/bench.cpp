@@ -0,0 +1,322 @@
+#include "bench.h"
+#include "ushell_core_printout.h"
+
+#if defined(BENCH) && (BENCH == 1)
+#if defined(STM32F1)
+#  include "stm32f1xx_hal.h"
+#elif defined(STM32F4)
+#  include "stm32f4xx_hal.h"
+#else
+#  error "Define STM32F1 or STM32F4 in your build system"
+#endif
+
+#include "ushell_core.h"
+#include "ushell_core_utils.h"
+
+#include "tx_api.h"
+
+#include <string.h>
+
+#define BENCH_THREAD_STACK  512U
+#define BENCH_THREAD_PRIO   3U      /* above the shell thread: the send switches to it at once */
+#define BENCH_IRQ           SPI2_IRQn   /* no SPI2 in the firmware: pended by software only */
+#define BENCH_IRQ_PRIO      6U      /* below the UART (5) */
+#define BENCH_REPLY_TICKS   ((100U * TX_TIMER_TICKS_PER_SECOND) / 1000U)
+
+#define BENCH_START()       const uint32_t u32BenchStart = DWT->CYCCNT
+#define BENCH_STOP()        (DWT->CYCCNT - u32BenchStart)
+
+typedef struct {
+    const char *pstrName;
+    bool (*pfRun)(uint32_t *pu32Cycles);    /* one sample, false if it could not be taken */
+} bench_s;
+
+static uint32_t s_au32Samples[BENCH_SAMPLES];
+static uint32_t s_u32Overhead = 0U;
+static volatile uint32_t s_u32Sink;         /* the results of the pure functions are kept */
+
+static TX_QUEUE s_sPing;
+static TX_QUEUE s_sPong;                    /* the answers of the echo and of the wake thread */
+static ULONG s_aulPingStorage[1];
+static ULONG s_aulPongStorage[1];
+static TX_SEMAPHORE s_sWake;
+static TX_THREAD s_sEchoThread;
+static TX_THREAD s_sWakeThread;
+static ULONG s_aulEchoStack[BENCH_THREAD_STACK / sizeof(ULONG)];
+static ULONG s_aulWakeStack[BENCH_THREAD_STACK / sizeof(ULONG)];
+static volatile uint32_t s_u32WakeStamp;    /* CYCCNT of the put or of the pend */
+
+
+// -- echo and wake threads ---------------------------------------------------
+
+static void s_echo_thread(ULONG ulInput)
+{
+    (void)ulInput;
+    ULONG ulValue;
+
+    for (;;) {
+        if (TX_SUCCESS == tx_queue_receive(&s_sPing, &ulValue, TX_WAIT_FOREVER)) {
+            (void)tx_queue_send(&s_sPong, &ulValue, TX_WAIT_FOREVER);
+        }
+    }
+}
+
+
+/* woken by a put of the shell thread or of the bench IRQ, answers the cycles since */
+static void s_wake_thread(ULONG ulInput)
+{
+    (void)ulInput;
+
+    for (;;) {
+        if (TX_SUCCESS == tx_semaphore_get(&s_sWake, TX_WAIT_FOREVER)) {
+            ULONG ulCycles = DWT->CYCCNT - s_u32WakeStamp;
+            (void)tx_queue_send(&s_sPong, &ulCycles, TX_NO_WAIT);
+        }
+    }
+}
+
+
+/* the weak handler of the startup file */
+extern "C" void SPI2_IRQHandler(void)
+{
+    (void)tx_semaphore_put(&s_sWake);
+}
+
+
+// -- the benchmarks ----------------------------------------------------------
+
+static bool s_asc2int_hex(uint32_t *pu32Cycles)
+{
+    BIGNUM_T number = 0;
+    BENCH_START();
+    const bool bOk = asc2int("0x1234ABCD", &number);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)number;
+    return bOk;
+}
+
+
+static bool s_asc2int_dec(uint32_t *pu32Cycles)
+{
+    BIGNUM_T number = 0;
+    BENCH_START();
+    const bool bOk = asc2int("4294967295", &number);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)number;
+    return bOk;
+}
+
+
+static const uint8_t s_au8Bytes[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+
+static bool s_hexlify(uint32_t *pu32Cycles)
+{
+    char acHex[(2U * sizeof(s_au8Bytes)) + 1U];
+    BENCH_START();
+    hexlify(s_au8Bytes, sizeof(s_au8Bytes), acHex);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)acHex[0];
+    return true;
+}
+
+
+static bool s_unhexlify(uint32_t *pu32Cycles)
+{
+    uint8_t au8Bytes[sizeof(s_au8Bytes)];
+    size_t szLen = 0U;
+    BENCH_START();
+    const bool bOk = unhexlify("00112233445566778899aabbccddeeff", au8Bytes, &szLen);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = au8Bytes[0];
+    return bOk;
+}
+
+
+static bool s_strtok_ex(uint32_t *pu32Cycles)
+{
+    char acLine[] = "bench 1 0x20 text";    /* strtok_ex() writes into it, a copy per sample */
+    char *pstrSave = NULL;
+    uint32_t u32Tokens = 0U;
+    BENCH_START();
+    for (char *pstrTok = strtok_ex(acLine, " ", &pstrSave); NULL != pstrTok; pstrTok = strtok_ex(NULL, " ", &pstrSave)) {
+        u32Tokens++;
+    }
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = u32Tokens;
+    return (4U == u32Tokens);
+}
+
+
+/* the shell is already up: it is the caller */
+static bool s_lookup_hit(uint32_t *pu32Cycles)
+{
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+    BENCH_START();
+    const int iIndex = pShell->FindCommand("bench");
+    *pu32Cycles = BENCH_STOP();
+    return (iIndex >= 0);
+}
+
+
+static bool s_lookup_miss(uint32_t *pu32Cycles)
+{
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+    BENCH_START();
+    const int iIndex = pShell->FindCommand("nosuchcmd");
+    *pu32Cycles = BENCH_STOP();
+    return (uSHELL_ERR_FUNCTION_NOT_FOUND == iIndex);
+}
+
+
+static bool s_queue_round_trip(uint32_t *pu32Cycles)
+{
+    ULONG ulValue = 0U;
+    BENCH_START();
+    ULONG ulSent = u32BenchStart;
+    (void)tx_queue_send(&s_sPing, &ulSent, TX_WAIT_FOREVER);
+    const UINT uStatus = tx_queue_receive(&s_sPong, &ulValue, BENCH_REPLY_TICKS);
+    *pu32Cycles = BENCH_STOP();
+    return (TX_SUCCESS == uStatus) && (ulValue == ulSent);
+}
+
+
+/* the cycles are the wake thread's, measured when it runs */
+static bool s_receive_wake(uint32_t *pu32Cycles)
+{
+    ULONG ulCycles = 0U;
+    const UINT uStatus = tx_queue_receive(&s_sPong, &ulCycles, BENCH_REPLY_TICKS);
+    *pu32Cycles = (uint32_t)ulCycles;
+    return (TX_SUCCESS == uStatus);
+}
+
+
+static bool s_ctx_switch(uint32_t *pu32Cycles)
+{
+    s_u32WakeStamp = DWT->CYCCNT;
+    (void)tx_semaphore_put(&s_sWake);
+    return s_receive_wake(pu32Cycles);
+}
+
+
+static bool s_irq_to_task(uint32_t *pu32Cycles)
+{
+    s_u32WakeStamp = DWT->CYCCNT;
+    NVIC_SetPendingIRQ(BENCH_IRQ);
+    return s_receive_wake(pu32Cycles);
+}
+
+
+static const bench_s s_asBenches[] = {
+    { "asc2int hex",        s_asc2int_hex      },
+    { "asc2int dec",        s_asc2int_dec      },
+    { "hexlify 16B",        s_hexlify          },
+    { "unhexlify 16B",      s_unhexlify        },
+    { "strtok_ex 4 tok",    s_strtok_ex        },
+    { "lookup hit",         s_lookup_hit       },
+    { "lookup miss",        s_lookup_miss      },
+    { "queue round trip",   s_queue_round_trip },
+    { "ctx switch",         s_ctx_switch       },
+    { "irq->task",          s_irq_to_task      },
+};
+
+#define BENCH_COUNT     (sizeof(s_asBenches) / sizeof(s_asBenches[0]))
+
+
+/* two reads of the counter back to back, taken off every sample */
+static void s_calibrate(void)
+{
+    s_u32Overhead = UINT32_MAX;
+    for (uint32_t i = 0U; i < 8U; i++) {
+        BENCH_START();
+        const uint32_t u32Cycles = BENCH_STOP();
+        if (u32Cycles < s_u32Overhead) {
+            s_u32Overhead = u32Cycles;
+        }
+    }
+}
+
+
+static void s_sort(uint32_t *pu32Values, uint32_t u32Count)
+{
+    for (uint32_t i = 1U; i < u32Count; i++) {
+        const uint32_t u32Value = pu32Values[i];
+        uint32_t j = i;
+        while ((j > 0U) && (pu32Values[j - 1U] > u32Value)) {
+            pu32Values[j] = pu32Values[j - 1U];
+            j--;
+        }
+        pu32Values[j] = u32Value;
+    }
+}
+
+
+static void s_run(uint32_t u32Index)
+{
+    const bench_s &sBench = s_asBenches[u32Index];
+
+    for (uint32_t i = 0U; i < BENCH_SAMPLES; i++) {
+        uint32_t u32Cycles = 0U;
+        if (false == sBench.pfRun(&u32Cycles)) {
+            uSHELL_PRINTF("\r%2u %-18s %8s\n", (unsigned)(u32Index + 1U), sBench.pstrName, "failed");
+            return;
+        }
+        s_au32Samples[i] = (u32Cycles > s_u32Overhead) ? (u32Cycles - s_u32Overhead) : 0U;
+    }
+    s_sort(s_au32Samples, BENCH_SAMPLES);
+
+    uSHELL_PRINTF("\r%2u %-18s %8u %8u %8u\n", (unsigned)(u32Index + 1U), sBench.pstrName,
+                  (unsigned)s_au32Samples[0], (unsigned)s_au32Samples[BENCH_SAMPLES / 2U],
+                  (unsigned)s_au32Samples[BENCH_SAMPLES - 1U]);
+}
+#endif /*defined(BENCH) && (BENCH == 1)*/
+
+
+/*--------------------------------------------------*/
+void bench_init(void)
+{
+#if defined(BENCH) && (BENCH == 1)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    (void)tx_queue_create(&s_sPing, (CHAR *)"Bench Ping", TX_1_ULONG, s_aulPingStorage, sizeof(s_aulPingStorage));
+    (void)tx_queue_create(&s_sPong, (CHAR *)"Bench Pong", TX_1_ULONG, s_aulPongStorage, sizeof(s_aulPongStorage));
+    (void)tx_semaphore_create(&s_sWake, (CHAR *)"Bench Sem", 0U);
+    (void)tx_thread_create(&s_sEchoThread, (CHAR *)"Bench Echo", s_echo_thread, 0U, s_aulEchoStack,
+                           sizeof(s_aulEchoStack), BENCH_THREAD_PRIO, BENCH_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+    (void)tx_thread_create(&s_sWakeThread, (CHAR *)"Bench Wake", s_wake_thread, 0U, s_aulWakeStack,
+                           sizeof(s_aulWakeStack), BENCH_THREAD_PRIO, BENCH_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+    /* the port masks with PRIMASK: any priority above PendSV (the lowest) may put */
+    HAL_NVIC_SetPriority(BENCH_IRQ, BENCH_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(BENCH_IRQ);
+#endif /*defined(BENCH) && (BENCH == 1)*/
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* bench 0 runs every benchmark, bench n only the n-th */
+extern "C" int bench(uint32_t u32Index)
+{
+#if defined(BENCH) && (BENCH == 1)
+    if (u32Index > BENCH_COUNT) {
+        uSHELL_PRINTF("bench: 1..%u, 0 for all\n", (unsigned)BENCH_COUNT);
+        return -1;
+    }
+
+    s_calibrate();
+    uSHELL_PRINTF("%2s %-18s %8s %8s %8s  (cycles at %u MHz, %u samples)\n", "#", "bench",
+                  "min", "median", "max", (unsigned)(SystemCoreClock / 1000000UL), (unsigned)BENCH_SAMPLES);
+    for (uint32_t i = 0U; i < BENCH_COUNT; i++) {
+        if ((0U == u32Index) || ((u32Index - 1U) == i)) {
+            s_run(i);
+        }
+    }
+#else
+    (void)u32Index;
+    uSHELL_PRINTF("bench: built with BENCH 0\n");
+#endif /*defined(BENCH) && (BENCH == 1)*/
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef CMD_SCHED_H
+#define CMD_SCHED_H
+
+#include <stdint.h>
+
+/*
+    Periodic shell commands: a command line parsed once and run again every N ms on target,
+    the link carries its output only instead of a command and a parse per poll.
+
+        every 500 "sysinfo"     run sysinfo every 500 ms, in the first free slot
+        sched 0                 the slots: period, runs, overruns, last result, line
+        sched <n>               stop the n-th
+
+    every parses the line with Microshell::Prepare() into the slot (the line is kept with
+    it, its strings point there) and activates a ThreadX timer of its own. The expiration
+    function runs in the timer thread, where nothing may wait: it only sets the flag of its
+    slot in the event group of the scheduler thread, which calls Microshell::RunPrepared().
+    A period which comes while the flag of the last one is still set is an overrun (counted,
+    the run is not queued twice). Each run is framed by two tagged lines for the host:
+
+        @<slot> <run>
+        <the output of the command>
+        @<slot> => <result>
+
+    The scheduler thread has the priority of the shell thread, uart_printf() writes its
+    lines whole. The commands run while the shell takes other lines, so the ones to poll
+    with are those which read a state (sysinfo, txprof 0); a command which reads the console
+    itself is not for a slot. The scratch of the handlers is the byte pool (tx_pools.h),
+    which takes the calls of both threads.
+*/
+
+#define CMD_SCHED_SLOTS         3U
+#define CMD_SCHED_MIN_MS        10U     /* the shortest period */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the scheduler thread, its event group and the timers, from tx_application_define() */
+void cmd_sched_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMD_SCHED_H */
@@ -0,0 +1,157 @@
+#include "cmd_sched.h"
+#include "ushell_core.h"
+#include "ushell_core_printout.h"
+
+#include "tx_api.h"
+
+#include <string.h>
+
+#define CMD_SCHED_STACK     1024U
+#define CMD_SCHED_PRIO      31U     /* the shell thread's */
+#define CMD_SCHED_TICKS(ms) ((((ms) * TX_TIMER_TICKS_PER_SECOND) + 999U) / 1000U)
+
+typedef struct {
+    preparedCmd_s   sCmd;           /* the line and its parse */
+    TX_TIMER        sTimer;
+    uint32_t        u32PeriodMs;    /* 0: free */
+    uint32_t        u32Runs;
+    uint32_t        u32Overruns;    /* periods while the last run waited for the thread */
+    int             iLastResult;
+} cmd_sched_slot_s;
+
+static cmd_sched_slot_s s_asSlots[CMD_SCHED_SLOTS];
+
+static TX_EVENT_FLAGS_GROUP s_sEvents;
+static TX_THREAD s_sThread;
+static ULONG s_aulStack[CMD_SCHED_STACK / sizeof(ULONG)];
+
+
+/*--------------------------------------------------*/
+/* the parse left a NUL after each token of the line, they are printed with a space */
+static void s_print_line(const preparedCmd_s *psCmd)
+{
+    size_t szEnd = sizeof(psCmd->vstrLine);
+    while ((szEnd > 0U) && ('\0' == psCmd->vstrLine[szEnd - 1U])) {
+        szEnd--;
+    }
+    for (size_t i = 0U; i < szEnd; i += strlen(&psCmd->vstrLine[i]) + 1U) {
+        if ('\0' != psCmd->vstrLine[i]) {
+            uSHELL_PRINTF("%s ", &psCmd->vstrLine[i]);
+        }
+    }
+    uSHELL_PRINTF("\n");
+}
+
+/*--------------------------------------------------*/
+/* timer thread: the flag of the slot, the run is the scheduler thread's */
+static void s_timer_expired(ULONG ulSlot)
+{
+    ULONG ulFlags = 0U;
+
+    (void)tx_event_flags_info_get(&s_sEvents, NULL, &ulFlags, NULL, NULL, NULL);
+    if (0U != (ulFlags & (1UL << ulSlot))) {
+        s_asSlots[ulSlot].u32Overruns++;
+    }
+    (void)tx_event_flags_set(&s_sEvents, 1UL << ulSlot, TX_OR);
+}
+
+/*--------------------------------------------------*/
+static void s_thread(ULONG ulInput)
+{
+    (void)ulInput;
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+
+    for (;;) {
+        ULONG ulBits = 0U;
+        (void)tx_event_flags_get(&s_sEvents, (1UL << CMD_SCHED_SLOTS) - 1U, TX_OR_CLEAR, &ulBits, TX_WAIT_FOREVER);
+
+        for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+            cmd_sched_slot_s *psSlot = &s_asSlots[i];
+
+            /* stopped between the period and the run */
+            if ((0U == (ulBits & (1UL << i))) || (0U == psSlot->u32PeriodMs)) {
+                continue;
+            }
+            psSlot->u32Runs++;
+            uSHELL_PRINTF("\r@%u %u\n", (unsigned)(i + 1U), (unsigned)psSlot->u32Runs);
+            psSlot->iLastResult = pShell->RunPrepared(&psSlot->sCmd);
+            uSHELL_PRINTF("\r@%u => %d\n", (unsigned)(i + 1U), psSlot->iLastResult);
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+void cmd_sched_init(void)
+{
+    (void)tx_event_flags_create(&s_sEvents, (CHAR *)"Sched Events");
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        /* the period is set at the start */
+        (void)tx_timer_create(&s_asSlots[i].sTimer, (CHAR *)"Sched", s_timer_expired, (ULONG)i,
+                              CMD_SCHED_TICKS(CMD_SCHED_MIN_MS), CMD_SCHED_TICKS(CMD_SCHED_MIN_MS), TX_NO_ACTIVATE);
+    }
+    (void)tx_thread_create(&s_sThread, (CHAR *)"Sched Thread", s_thread, 0U, s_aulStack, sizeof(s_aulStack),
+                           CMD_SCHED_PRIO, CMD_SCHED_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+
+// -- shell commands ----------------------------------------------------------
+
+/* every <ms> "<command>": the slot taken, or the parse error of the line */
+extern "C" int every(uint32_t u32PeriodMs, char *pstrCommand)
+{
+    if (u32PeriodMs < CMD_SCHED_MIN_MS) {
+        uSHELL_PRINTF("every: %u ms at least\n", (unsigned)CMD_SCHED_MIN_MS);
+        return -1;
+    }
+
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        cmd_sched_slot_s *psSlot = &s_asSlots[i];
+        if (0U != psSlot->u32PeriodMs) {
+            continue;
+        }
+
+        const int iRetVal = Microshell::getShellPtr(NULL, NULL)->Prepare(pstrCommand, &psSlot->sCmd);
+        if (uSHELL_ERR_OK != iRetVal) {
+            uSHELL_PRINTF("every: \"%s\" does not parse (%d)\n", pstrCommand, iRetVal);
+            return iRetVal;
+        }
+        psSlot->u32Runs     = 0U;
+        psSlot->u32Overruns = 0U;
+        psSlot->iLastResult = 0;
+        psSlot->u32PeriodMs = u32PeriodMs;
+        (void)tx_timer_change(&psSlot->sTimer, CMD_SCHED_TICKS(u32PeriodMs), CMD_SCHED_TICKS(u32PeriodMs));
+        (void)tx_timer_activate(&psSlot->sTimer);
+        uSHELL_PRINTF("every: slot %u, each %u ms: ", (unsigned)(i + 1U), (unsigned)u32PeriodMs);
+        s_print_line(&psSlot->sCmd);
+        return (int)(i + 1U);
+    }
+    uSHELL_PRINTF("every: the %u slots are taken (sched <n> stops one)\n", (unsigned)CMD_SCHED_SLOTS);
+    return -1;
+}
+
+/* sched 0 lists the slots, sched n stops the n-th */
+extern "C" int sched(uint32_t u32Slot)
+{
+    if (u32Slot > CMD_SCHED_SLOTS) {
+        uSHELL_PRINTF("sched: 1..%u, 0 for the list\n", (unsigned)CMD_SCHED_SLOTS);
+        return -1;
+    }
+
+    if (0U != u32Slot) {
+        cmd_sched_slot_s *psSlot = &s_asSlots[u32Slot - 1U];
+        (void)tx_timer_deactivate(&psSlot->sTimer);     /* tx_timer_change() needs it stopped */
+        psSlot->u32PeriodMs = 0U;
+        return 0;
+    }
+
+    uSHELL_PRINTF("%2s %8s %8s %8s %6s  %s\n", "#", "ms", "runs", "overrun", "result", "command");
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        const cmd_sched_slot_s *psSlot = &s_asSlots[i];
+        if (0U != psSlot->u32PeriodMs) {
+            uSHELL_PRINTF("%2u %8u %8u %8u %6d  ", (unsigned)(i + 1U), (unsigned)psSlot->u32PeriodMs,
+                          (unsigned)psSlot->u32Runs, (unsigned)psSlot->u32Overruns, psSlot->iLastResult);
+            s_print_line(&psSlot->sCmd);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef CRASH_DUMP_H
+#define CRASH_DUMP_H
+
+#include <stdint.h>
+
+/*
+    Post-mortem dump of a HardFault, built with -DUSHELL_CRASH_DUMP=ON (CRASH_DUMP 1, the
+    default). HardFault_Handler() (the weak vector of the startup file) takes the exception
+    frame of the faulting context (MSP or PSP, from EXC_RETURN) and r4..r11, then saves into
+    the .noinit RAM (linker scripts):
+
+        r0..r3 r12 lr pc xpsr, r4..r11, the sp before the frame, EXC_RETURN
+        CFSR HFSR MMFAR BFAR
+        the thread that faulted (tx_thread_identify), "main" before the kernel, the
+        exception number of an ISR
+        CRASH_DUMP_STACK_WORDS words above the sp, kept inside the SRAM
+
+    and resets (a halt on a breakpoint instead while a debugger is attached). The
+    MemManage, BusFault and UsageFault handlers are not enabled: they escalate to the
+    HardFault (HFSR FORCED), the CFSR tells which one it was.
+
+    The dump survives the resets other than a power on (the checksum fails then) until the
+    next fault overwrites it or crash 1 clears it; the shell command crash prints it with
+    the addr2line line of the pc, the lr and the stack words that look like return
+    addresses (odd, in the flash):
+
+        crash 0     print the dump of the last fault
+        crash 1     clear it
+        crash 2     take a fault (UDF) to try it out
+*/
+
+#define CRASH_DUMP_STACK_WORDS      24U     /* words above the sp of the faulting context */
+#define CRASH_DUMP_NAME_LEN         16U     /* the thread name, cut to fit */
+
+#endif /* CRASH_DUMP_H */
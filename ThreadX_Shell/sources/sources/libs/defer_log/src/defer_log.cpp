@@ -0,0 +1,126 @@
+#include "defer_log.h"
+#include "ushell_core_printout.h"
+
+#include "tx_api.h"
+
+static_assert(0U == (DLOG_BUFFER_SIZE & (DLOG_BUFFER_SIZE - 1U)), "DLOG_BUFFER_SIZE must be a power of two");
+static_assert(DLOG_MAX_FRAME < 256U, "DLOG_MAX_FRAME must fit the LEN byte");
+
+/* ring of LEN | frame records, head and tail run free and are masked on access */
+static uint8_t ring[DLOG_BUFFER_SIZE];
+static volatile uint32_t ring_head = 0U;
+static volatile uint32_t ring_tail = 0U;
+static volatile uint32_t dropped   = 0U;
+
+/*--------------------------------------------------*/
+/* PRIMASK based so it works from threads, ISRs and before the kernel starts */
+static inline uint32_t dlog_lock(void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (primask) :: "memory");
+    return primask;
+}
+
+/*--------------------------------------------------*/
+static inline void dlog_unlock(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+
+/*--------------------------------------------------*/
+static void ring_copy_in(uint32_t pos, const uint8_t *data, uint32_t len)
+{
+    const uint32_t idx   = pos & (DLOG_BUFFER_SIZE - 1U);
+    const uint32_t first = (len < (DLOG_BUFFER_SIZE - idx)) ? len : (DLOG_BUFFER_SIZE - idx);
+
+    memcpy(&ring[idx], data, first);
+    memcpy(&ring[0], data + first, len - first);
+}
+
+/*--------------------------------------------------*/
+static void ring_copy_out(uint32_t pos, uint8_t *data, uint32_t len)
+{
+    const uint32_t idx   = pos & (DLOG_BUFFER_SIZE - 1U);
+    const uint32_t first = (len < (DLOG_BUFFER_SIZE - idx)) ? len : (DLOG_BUFFER_SIZE - idx);
+
+    memcpy(data, &ring[idx], first);
+    memcpy(data + first, &ring[0], len - first);
+}
+
+/*--------------------------------------------------*/
+void dlog_commit(const uint8_t *frame, uint32_t len)
+{
+    const uint32_t primask = dlog_lock();
+    const uint32_t head = ring_head;
+
+    if ((len > DLOG_MAX_FRAME) || ((len + 1U) > (DLOG_BUFFER_SIZE - (head - ring_tail)))) {
+        dropped = dropped + 1U;
+    } else {
+        const uint8_t len8 = (uint8_t)len;
+        ring_copy_in(head, &len8, 1U);
+        ring_copy_in(head + 1U, frame, len);
+        ring_head = head + 1U + len;
+    }
+
+    dlog_unlock(primask);
+}
+
+/*--------------------------------------------------*/
+uint32_t dlog_read(uint8_t *frame, uint32_t size)
+{
+    uint32_t len = 0U;
+    const uint32_t primask = dlog_lock();
+    const uint32_t tail = ring_tail;
+
+    if (tail != ring_head) {
+        uint8_t len8;
+        ring_copy_out(tail, &len8, 1U);
+        if (len8 <= size) {
+            ring_copy_out(tail + 1U, frame, len8);
+            len = len8;
+        }
+        ring_tail = tail + 1U + len8;   /* a frame that does not fit the caller is skipped */
+    }
+
+    dlog_unlock(primask);
+    return len;
+}
+
+/*--------------------------------------------------*/
+uint32_t dlog_dropped(void)
+{
+    return dropped;
+}
+
+/*--------------------------------------------------*/
+uint32_t dlog_ticks(void)
+{
+    return (uint32_t)tx_time_get();
+}
+
+/*--------------------------------------------------*/
+/* shell command: print the queued frames for tools/dlog_decode.py */
+int dlog(void)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    uint8_t frame[DLOG_MAX_FRAME];
+    char line[2U * (DLOG_MAX_FRAME + 1U) + 1U];
+    uint32_t len;
+
+    while (0U != (len = dlog_read(frame, sizeof(frame)))) {
+        line[0] = hex[len >> 4];
+        line[1] = hex[len & 0x0FU];
+        for (uint32_t i = 0U; i < len; ++i) {
+            line[2U + 2U * i]      = hex[frame[i] >> 4];
+            line[2U + 2U * i + 1U] = hex[frame[i] & 0x0FU];
+        }
+        line[2U + 2U * len] = '\0';
+        uSHELL_PRINTF("DL:%s\r\n", line);
+    }
+
+    if (0U != dropped) {
+        uSHELL_PRINTF("dlog: %d frames dropped\r\n", (int)dropped);
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+Decode the deferred log frames printed by the shell command dlog
+Usage: python3 dlog_decode.py firmware.elf [capture.txt]   (reads stdin without a capture)
+
+The format strings are read from the .deflog section of the ELF the target runs, a frame is
+    DL:<hex> = LEN | ID (2) | TICKS (4) | ARGS
+with the arguments packed as in defer_log.h; every other line is passed through unchanged.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+# %[flags][width][.precision][length]conversion
+CONVERSION = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diuxXocsfFeEgGp%])')
+
+
+class DecodeError(Exception):
+    pass
+
+
+def read_section(filename, name):
+    """the bytes of a section of an ELF32 little endian file"""
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+        raise DecodeError(f"{filename}: not an ELF32 little endian file")
+    shoff, = struct.unpack_from('<I', data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x2E)
+
+    def header(index):
+        # name, type, flags, addr, offset, size
+        return struct.unpack_from('<IIIIII', data, shoff + index * shentsize)
+
+    strtab = header(shstrndx)
+    for index in range(shnum):
+        sh = header(index)
+        start = strtab[4] + sh[0]
+        if data[start:data.index(b'\0', start)].decode('ascii') == name:
+            return data[sh[4]:sh[4] + sh[5]]
+    raise DecodeError(f"{filename}: no {name} section (no DLOG() in the firmware?)")
+
+
+def format_string(strings, ident):
+    if ident >= len(strings):
+        raise DecodeError(f"id 0x{ident:04X} outside .deflog")
+    end = strings.find(b'\0', ident)
+    return strings[ident:end].decode('utf-8', 'replace')
+
+
+def decode_args(fmt, payload):
+    """python % format and the values, walking the conversions like the target packed them"""
+    pyfmt, values, pos = '', [], 0
+    last = 0
+    for m in CONVERSION.finditer(fmt):
+        flags, width, precision, length, conv = m.groups()
+        pyfmt += fmt[last:m.start()].replace('%', '%%')
+        last = m.end()
+        if conv == '%':
+            pyfmt += '%%'
+            continue
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conv == 's':
+            size = payload[pos]
+            values.append(payload[pos + 1:pos + 1 + size].decode('utf-8', 'replace'))
+            pos += 1 + size
+            pyfmt += spec + 's'
+        elif conv in 'fFeEgG':
+            values.append(struct.unpack_from('<f', payload, pos)[0])
+            pos += 4
+            pyfmt += spec + conv
+        elif conv == 'p':
+            values.append(struct.unpack_from('<I', payload, pos)[0])
+            pos += 4
+            pyfmt += '0x%08x'
+        else:
+            wide = (length == 'll')
+            code = {'d': 'q', 'i': 'q'}.get(conv, 'Q') if wide else {'d': 'i', 'i': 'i'}.get(conv, 'I')
+            values.append(struct.unpack_from('<' + code, payload, pos)[0])
+            pos += 8 if wide else 4
+            pyfmt += spec + {'u': 'd', 'i': 'd'}.get(conv, conv)
+    pyfmt += fmt[last:].replace('%', '%%')
+    if pos != len(payload):
+        raise DecodeError(f"arguments do not match '{fmt.strip()}' ({len(payload)} bytes, {pos} expected)")
+    return pyfmt % tuple(values)
+
+
+def decode_line(strings, line):
+    frame = bytes.fromhex(line[3:].strip())
+    if len(frame) < 7 or frame[0] != len(frame) - 1:
+        raise DecodeError("truncated frame")
+    ident, ticks = struct.unpack_from('<HI', frame, 1)
+    text = decode_args(format_string(strings, ident), frame[7:])
+    return f"[{ticks:10d}] {text.rstrip()}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="uShell deferred log decoder")
+    parser.add_argument('elf', help="firmware ELF with the .deflog section")
+    parser.add_argument('capture', nargs='?', help="terminal capture (default: stdin)")
+    args = parser.parse_args()
+
+    try:
+        strings = read_section(args.elf, '.deflog')
+    except (DecodeError, OSError) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+    source = open(args.capture, 'r', errors='replace') if args.capture else sys.stdin
+    with source:
+        for line in source:
+            line = line.rstrip('\r\n')
+            if not line.startswith('DL:'):
+                print(line)
+                continue
+            try:
+                print(decode_line(strings, line))
+            except (DecodeError, ValueError, IndexError, struct.error) as e:
+                print(f"{line}   <{e}>")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,43 @@
+#ifndef LOAD_METER_H
+#define LOAD_METER_H
+
+#include <stdint.h>
+
+/*
+    CPU load from an idle count: no timer of its own and no run time stats of the kernel.
+
+        load 0      the load of the last second, the 10 s and 60 s averages
+        load 1      the same, and the load of each second on the LCD
+        load 2      the LCD line off
+
+    A thread of the lowest priority counts the turns of its loop, each one checks the
+    time and relinquishes to the threads of its priority (the shell and the scheduler
+    thread are there too). The first second after the start is the calibration: the
+    turns of a second with nothing else to run; a later second which counts more raises
+    it, the start was not idle. The load of a second is the part of the turns it lost,
+    the seconds the thread did not run at all count as loaded in full.
+
+    The 10 s and 60 s averages are exponential ones, as the load averages of Unix, in
+    fixed point: a second adds (1 - e^(-1/10)) and (1 - e^(-1/60)) of its difference.
+    The loop keeps the core busy: ThreadX idles in a loop of its own anyway (no
+    TX_ENABLE_WFI).
+*/
+
+/* the LCD line of load 1, 16 characters; from the load thread */
+typedef void (*load_meter_show_fn_t)(const char *pstrLine);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the load thread, from tx_application_define(); pfShow NULL: no LCD */
+void load_meter_init(load_meter_show_fn_t pfShow);
+
+/* the load of the last second, in per mille; 0 before the calibration */
+uint32_t load_meter_permille(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOAD_METER_H */
@@ -0,0 +1,166 @@
+#include "load_meter.h"
+#include "ushell_core_printout.h"
+
+#include "tx_api.h"
+
+#define LOAD_METER_STACK    512U
+#define LOAD_METER_PRIO     31U     /* the lowest, the shell thread's */
+
+/* (1 - e^(-1/n)) * 1024: the part of the difference a second adds to the n s average */
+#define LOAD_METER_A10      97
+#define LOAD_METER_A60      17
+#define LOAD_METER_SECONDS_MAX  300U    /* the 60 s average has settled after a gap this long */
+
+static TX_THREAD s_sThread;
+static ULONG s_aulStack[LOAD_METER_STACK / sizeof(ULONG)];
+
+static load_meter_show_fn_t s_pfShow = NULL;
+static bool s_bLcd = false;
+
+/* by the load thread, read by the shell under TX_DISABLE */
+static uint32_t s_u32Calib   = 0U;      /* turns in an idle second, 0 before the first one */
+static uint32_t s_u32Turns   = 0U;      /* of the last second */
+static uint32_t s_u32Load    = 0U;      /* of the last second, per mille */
+static int32_t  s_i32Avg10   = 0;       /* per mille << 10 */
+static int32_t  s_i32Avg60   = 0;
+static uint32_t s_u32Seconds = 0U;      /* since the calibration */
+
+
+/*--------------------------------------------------*/
+static void s_average(int32_t *pi32Avg, int32_t i32Sample, int32_t i32Alpha)
+{
+    *pi32Avg += (((i32Sample << 10) - *pi32Avg) * i32Alpha) / 1024;
+}
+
+/*--------------------------------------------------*/
+/* "Load  12.3 %    ", the 16 characters of the line */
+static void s_show(uint32_t u32Permille)
+{
+    char vstrLine[17] = "Load   0.0 %    ";
+
+    vstrLine[9] = (char)('0' + (u32Permille % 10U));
+    u32Permille /= 10U;
+    for (uint32_t i = 7U; (i >= 5U); i--) {
+        vstrLine[i] = (char)('0' + (u32Permille % 10U));
+        u32Permille /= 10U;
+        if (0U == u32Permille) {
+            break;
+        }
+    }
+    s_pfShow(vstrLine);
+}
+
+/*--------------------------------------------------*/
+/* the turns of u32Seconds (more than one: the thread did not run in between) */
+static void s_second(uint32_t u32Turns, uint32_t u32Seconds)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    const uint32_t u32PerSecond = u32Turns / u32Seconds;
+    uint32_t u32Calib = s_u32Calib;
+    bool bFirst = false;
+
+    if (u32PerSecond > u32Calib) {
+        bFirst   = (0U == u32Calib);
+        u32Calib = u32PerSecond;
+    }
+    const uint64_t u64Full = (uint64_t)u32Calib * u32Seconds;
+    const uint64_t u64Idle = (((uint64_t)u32Turns * 1000U) + (u64Full / 2U)) / u64Full;
+    const uint32_t u32Load = (u64Idle < 1000U) ? (1000U - (uint32_t)u64Idle) : 0U;
+
+    /* the averages are this thread's, the shell reads them under TX_DISABLE */
+    int32_t i32Avg10 = bFirst ? (int32_t)(u32Load << 10) : s_i32Avg10;
+    int32_t i32Avg60 = bFirst ? (int32_t)(u32Load << 10) : s_i32Avg60;
+    for (uint32_t i = 0U; (i < u32Seconds) && (i < LOAD_METER_SECONDS_MAX); i++) {
+        s_average(&i32Avg10, (int32_t)u32Load, LOAD_METER_A10);
+        s_average(&i32Avg60, (int32_t)u32Load, LOAD_METER_A60);
+    }
+
+    TX_DISABLE
+    s_u32Calib    = u32Calib;
+    s_u32Turns    = u32PerSecond;
+    s_u32Load     = u32Load;
+    s_i32Avg10    = i32Avg10;
+    s_i32Avg60    = i32Avg60;
+    s_u32Seconds += u32Seconds;
+    TX_RESTORE
+
+    if (s_bLcd && (NULL != s_pfShow)) {
+        s_show(u32Load);
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_thread(ULONG ulInput)
+{
+    (void)ulInput;
+    ULONG ulStart = tx_time_get();
+    uint32_t u32Turns = 0U;
+
+    for (;;) {
+        u32Turns++;
+        const ULONG ulElapsed = tx_time_get() - ulStart;
+        if (ulElapsed >= TX_TIMER_TICKS_PER_SECOND) {
+            const uint32_t u32Seconds = (uint32_t)(ulElapsed / TX_TIMER_TICKS_PER_SECOND);
+            s_second(u32Turns, u32Seconds);
+            ulStart += (ULONG)u32Seconds * TX_TIMER_TICKS_PER_SECOND;
+            u32Turns = 0U;
+        }
+        tx_thread_relinquish();     /* the other threads of the lowest priority run first */
+    }
+}
+
+/*--------------------------------------------------*/
+void load_meter_init(load_meter_show_fn_t pfShow)
+{
+    s_pfShow = pfShow;
+    (void)tx_thread_create(&s_sThread, (CHAR *)"Load Thread", s_thread, 0U, s_aulStack, sizeof(s_aulStack),
+                           LOAD_METER_PRIO, LOAD_METER_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/*--------------------------------------------------*/
+uint32_t load_meter_permille(void)
+{
+    return s_u32Load;
+}
+
+
+// -- shell command -----------------------------------------------------------
+
+/* load 0 prints the loads, 1 and shows each second on the LCD, 2 stops the LCD line */
+extern "C" int load(uint32_t u32Action)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (u32Action > 2U) {
+        uSHELL_PRINTF("load: 0 print, 1 and on the LCD, 2 LCD off\r\n");
+        return -1;
+    }
+    if (0U != u32Action) {
+        s_bLcd = (1U == u32Action);
+        if (NULL == s_pfShow) {
+            uSHELL_PRINTF("load: no LCD\r\n");
+        }
+    }
+
+    TX_DISABLE
+    const uint32_t u32Calib   = s_u32Calib;
+    const uint32_t u32Turns   = s_u32Turns;
+    const uint32_t u32Load    = s_u32Load;
+    const uint32_t u32Avg10   = (uint32_t)((s_i32Avg10 + 512) >> 10);
+    const uint32_t u32Avg60   = (uint32_t)((s_i32Avg60 + 512) >> 10);
+    const uint32_t u32Seconds = s_u32Seconds;
+    TX_RESTORE
+
+    if (0U == u32Calib) {
+        uSHELL_PRINTF("load: calibrating, the first second\r\n");
+        return 0;
+    }
+    uSHELL_PRINTF("Load: %u.%u %% (1 s)  %u.%u %% (10 s)  %u.%u %% (60 s)\r\n",
+        (unsigned)(u32Load / 10U), (unsigned)(u32Load % 10U),
+        (unsigned)(u32Avg10 / 10U), (unsigned)(u32Avg10 % 10U),
+        (unsigned)(u32Avg60 / 10U), (unsigned)(u32Avg60 % 10U));
+    uSHELL_PRINTF("Idle turns: %u/s of %u/s, over %u s\r\n",
+        (unsigned)u32Turns, (unsigned)u32Calib, (unsigned)u32Seconds);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#ifndef MONO_TIME_H
+#define MONO_TIME_H
+
+#include <stdint.h>
+
+/*
+    The monotonic microsecond clock: 64 bit, from the start of the kernel on, the one time
+    base of the logs, the traces and the threads (the FreeRTOS and Zephyr shells have the
+    same interface).
+
+        const uint64_t u64Start = mono_time_us();       a thread or any ISR
+        ...
+        const uint32_t u32Us = (uint32_t)(mono_time_us() - u64Start);
+
+    It is the DWT cycle counter extended by an epoch: the cycle count and the microseconds at
+    some instant, the time is the microseconds of the epoch and the cycles since it at
+    SystemCoreClock (fixed after SystemClock_Config()). A read is the counter, a division and
+    a few loads: no interrupt lock, an ISR of any priority reads it too.
+
+    There are two epochs, a new one goes to the one not published and a sequence number
+    publishes it in one store. A reader takes the published one and checks the number after
+    the counter, it reads again if the epoch changed meanwhile; a reader interrupting the
+    writer sees the previous epoch, complete, and never waits for it. The writer is a ThreadX
+    timer of MONO_TIME_REFRESH_MS (the timer thread), far below the wrap of the counter (59 s
+    at 72 MHz, 42 s at 100 MHz). The remainder of the cycles stays in the counter of the
+    epoch, the time of a reader never steps back.
+*/
+
+#define MONO_TIME_REFRESH_MS    1000U   /* an epoch a second */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the counter and the refresh timer, from tx_application_define() before the first thread */
+void mono_time_init(void);
+
+/* the microseconds since mono_time_init(); any context */
+uint64_t mono_time_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MONO_TIME_H */
@@ -0,0 +1,76 @@
+#include "mono_time.h"
+
+#if defined(STM32F1)
+#  include "stm32f1xx_hal.h"
+#elif defined(STM32F4)
+#  include "stm32f4xx_hal.h"
+#else
+#  error "Define STM32F1 or STM32F4 in your build system"
+#endif
+
+#include "tx_api.h"
+
+typedef struct {
+    uint64_t u64Us;         /* the time of the epoch */
+    uint32_t u32Cycles;     /* the counter at it */
+} mono_time_epoch_s;
+
+static mono_time_epoch_s s_asEpoch[2];
+static volatile uint32_t s_u32Seq   = 0U;   /* the published epoch: s_asEpoch[s_u32Seq & 1] */
+static uint32_t          s_u32PerUs = 1U;
+static TX_TIMER          s_sRefresh;
+
+
+/* the next epoch from the published one at the cycles of now, then published; the timer
+   thread is the only writer, the readers never see it half written */
+static void s_refresh(ULONG ulInput)
+{
+    (void)ulInput;
+    const uint32_t u32Seq = s_u32Seq;
+    const mono_time_epoch_s *psOld = &s_asEpoch[u32Seq & 1U];
+    mono_time_epoch_s *psNew = &s_asEpoch[(u32Seq + 1U) & 1U];
+
+    const uint32_t u32Us = (DWT->CYCCNT - psOld->u32Cycles) / s_u32PerUs;
+
+    psNew->u64Us     = psOld->u64Us + u32Us;
+    psNew->u32Cycles = psOld->u32Cycles + (u32Us * s_u32PerUs);    /* the remainder stays */
+
+    __atomic_signal_fence(__ATOMIC_RELEASE);    /* one core: the order of the stores is enough */
+    s_u32Seq = u32Seq + 1U;
+}
+
+
+/*--------------------------------------------------*/
+void mono_time_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;    /* running already with TX_EXECUTION_PROFILE_ENABLE */
+
+    s_u32PerUs = (SystemCoreClock >= 1000000U) ? (SystemCoreClock / 1000000U) : 1U;
+    s_asEpoch[0].u64Us     = 0U;
+    s_asEpoch[0].u32Cycles = DWT->CYCCNT;
+    s_u32Seq = 0U;
+
+    const ULONG ulTicks = ((ULONG)MONO_TIME_REFRESH_MS * TX_TIMER_TICKS_PER_SECOND) / 1000U;
+    (void)tx_timer_create(&s_sRefresh, (CHAR *)"Mono Time", s_refresh, 0U, ulTicks, ulTicks, TX_AUTO_ACTIVATE);
+}
+
+
+/*--------------------------------------------------*/
+uint64_t mono_time_us(void)
+{
+    for (;;) {
+        const uint32_t u32Seq = s_u32Seq;
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+
+        const mono_time_epoch_s *psEpoch = &s_asEpoch[u32Seq & 1U];
+        const uint64_t u64Us     = psEpoch->u64Us;
+        const uint32_t u32Cycles = psEpoch->u32Cycles;
+        const uint32_t u32Now    = DWT->CYCCNT;
+
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+        if (u32Seq == s_u32Seq) {      /* else an epoch came meanwhile */
+            return u64Us + ((u32Now - u32Cycles) / s_u32PerUs);
+        }
+    }
+}
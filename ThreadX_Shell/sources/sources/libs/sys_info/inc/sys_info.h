@@ -0,0 +1,34 @@
+#ifndef SYS_INFO_H
+#define SYS_INFO_H
+
+#include <stdint.h>
+
+/*
+    Stack usage: a stack is filled with SYS_INFO_STACK_FILL before it is used, its peak
+    is the part above the lowest word which no longer holds the pattern (the stacks
+    grow down). ThreadX fills the thread stacks in tx_thread_create() with the same
+    pattern (TX_STACK_FILL), the ISR stack (MSP, the main() stack reused by the kernel
+    for the interrupts) is filled by sys_info_paint_isr_stack().
+
+    The shell command sysinfo prints the threads with their stack size, peak and free
+    bytes, and the ISR stack against the _Min_Stack_Size reserved by the linker script.
+*/
+
+#define SYS_INFO_STACK_FILL     0xEFEFEFEFUL    /* TX_STACK_FILL */
+#define SYS_INFO_STACK_MARGIN   64U             /* bytes below the sp left alone while painting */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* fill the free part of the ISR stack, from main() before tx_kernel_enter() */
+void sys_info_paint_isr_stack(void);
+
+/* bytes at the low end of the stack [pvStart, pvStart + u32Size) still holding the fill */
+uint32_t sys_info_stack_unused(const void *pvStart, uint32_t u32Size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYS_INFO_H */
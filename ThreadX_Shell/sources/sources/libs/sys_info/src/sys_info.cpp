@@ -0,0 +1,215 @@
+#include "sys_info.h"
+#include "ushell_core_printout.h"
+
+#include "tx_api.h"
+#include "tx_queue.h"
+#include "tx_thread.h"
+
+static_assert(SYS_INFO_STACK_FILL == TX_STACK_FILL, "SYS_INFO_STACK_FILL must be the ThreadX stack fill");
+
+/* linker script symbols, _Min_Stack_Size is an absolute value */
+extern "C" char _estack[];
+extern "C" char _Min_Stack_Size[];
+extern "C" uint32_t SystemCoreClock;
+
+static const char *const s_stateNames[] = {
+    "READY", "COMPLETED", "TERMINATED", "SUSPENDED", "SLEEP", "QUEUE", "SEMAPHORE",
+    "EVENT", "BLOCK MEM", "BYTE MEM", "IO", "FILE", "TCP/IP", "MUTEX", "PRIO CHG"
+};
+
+/*--------------------------------------------------*/
+static inline uint32_t isr_stack_size(void)
+{
+    return (uint32_t)(uintptr_t)_Min_Stack_Size;
+}
+
+/*--------------------------------------------------*/
+/* peak and free bytes of one stack, the percentage of the peak and a mark once it is full */
+static void printStack(const char *name, const char *state, uint32_t prio, const void *start, uint32_t size)
+{
+    const uint32_t unused = sys_info_stack_unused(start, size);
+    const uint32_t peak   = size - unused;
+    const uint32_t pct    = (0U != size) ? ((peak * 100U) / size) : 0U;
+
+    uSHELL_PRINTF("  %-16s %-10s %-4u %5u %5u %5u %3u%%%s\r\n",
+        name, state, (unsigned)prio, (unsigned)size, (unsigned)peak, (unsigned)unused,
+        (unsigned)pct, (0U == unused) ? " !" : "");
+}
+
+/*--------------------------------------------------*/
+static void printStacks(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    TX_THREAD *thread = _tx_thread_created_ptr;
+    ULONG      count  = _tx_thread_created_count;
+    TX_RESTORE
+
+    uint32_t spare = 0U;
+
+    uSHELL_PRINTF("%-18s %-10s %-4s %5s %5s %5s %s\r\n", "Thread", "State", "Prio", "Size", "Peak", "Free", "Used");
+    uSHELL_PRINTF("-----------------------------------------------------------\r\n");
+    for (ULONG i = 0U; (i < count) && (TX_NULL != thread); i++) {
+        const UINT state = thread->tx_thread_state;
+
+        printStack(thread->tx_thread_name,
+            (state < (sizeof(s_stateNames) / sizeof(s_stateNames[0]))) ? s_stateNames[state] : "?",
+            thread->tx_thread_priority, thread->tx_thread_stack_start, (uint32_t)thread->tx_thread_stack_size);
+        spare += sys_info_stack_unused(thread->tx_thread_stack_start, (uint32_t)thread->tx_thread_stack_size);
+        thread = thread->tx_thread_created_next;
+    }
+    printStack("ISR (MSP)", "-", 0U, _estack - isr_stack_size(), isr_stack_size());
+    uSHELL_PRINTF("Never used by the threads: %u bytes\r\n", (unsigned)spare);
+}
+
+/*--------------------------------------------------*/
+static void printUptime(void)
+{
+    const ULONG ticks = tx_time_get();
+    const ULONG ms    = (ULONG)(((uint64_t)ticks * 1000U) / TX_TIMER_TICKS_PER_SECOND);
+    const ULONG sec   = ms / 1000U;
+
+    uSHELL_PRINTF("Uptime: %02u:%02u.%03u (ticks: %u)\r\n",
+        (unsigned)(sec / 60U), (unsigned)(sec % 60U), (unsigned)(ms % 1000U), (unsigned)ticks);
+    uSHELL_PRINTF("Threads: %u\r\n", (unsigned)_tx_thread_created_count);
+}
+
+#if defined(TX_EXECUTION_PROFILE_ENABLE)
+
+/*--------------------------------------------------*/
+/* cycles as ms at the core clock and as a share of the total, 0.1 % */
+static void printTime(const char *name, EXECUTION_TIME cycles, EXECUTION_TIME total)
+{
+    const EXECUTION_TIME perMs  = SystemCoreClock / 1000U;
+    const uint32_t       ms     = (uint32_t)(cycles / perMs);
+    const uint32_t       permil = (0U != total) ? (uint32_t)((cycles * 1000U) / total) : 0U;
+
+    uSHELL_PRINTF("  %-16s %10u %3u.%u%%", name, (unsigned)ms, (unsigned)(permil / 10U), (unsigned)(permil % 10U));
+}
+
+/*--------------------------------------------------*/
+/* run time of the threads, the ISRs and the idle loop; the counters of the kernel */
+static void printProfile(void)
+{
+    TX_INTERRUPT_SAVE_AREA
+    EXECUTION_TIME threads = 0U, isr = 0U, idle = 0U;
+
+    (void)_tx_execution_thread_total_time_get(&threads);
+    (void)_tx_execution_isr_time_get(&isr);
+    (void)_tx_execution_idle_time_get(&idle);
+    const EXECUTION_TIME total = threads + isr + idle;
+
+    TX_DISABLE
+    TX_THREAD *thread = _tx_thread_created_ptr;
+    ULONG      count  = _tx_thread_created_count;
+    TX_RESTORE
+
+    uSHELL_PRINTF("%-18s %10s %6s %8s %8s %8s %8s\r\n", "Thread", "Run ms", "Run", "Resumed", "Suspend", "Preempt", "Slices");
+    uSHELL_PRINTF("---------------------------------------------------------------------------\r\n");
+    for (ULONG i = 0U; (i < count) && (TX_NULL != thread); i++) {
+        EXECUTION_TIME cycles = 0U;
+        ULONG resumed = 0U, suspended = 0U, solicited = 0U, byIsr = 0U, inversions = 0U, slices = 0U;
+
+        (void)_tx_execution_thread_time_get(thread, &cycles);
+        (void)tx_thread_performance_info_get(thread, &resumed, &suspended, &solicited, &byIsr, &inversions,
+                                             &slices, nullptr, nullptr, nullptr, nullptr);
+        printTime(thread->tx_thread_name, cycles, total);
+        uSHELL_PRINTF(" %8u %8u %8u %8u\r\n", (unsigned)resumed, (unsigned)suspended,
+                      (unsigned)(solicited + byIsr), (unsigned)slices);
+        thread = thread->tx_thread_created_next;
+    }
+    printTime("ISR", isr, total);
+    uSHELL_PRINTF("\r\n");
+    printTime("Idle", idle, total);
+    uSHELL_PRINTF("\r\n");
+
+    TX_DISABLE
+    TX_QUEUE *queue = _tx_queue_created_ptr;
+    count           = _tx_queue_created_count;
+    TX_RESTORE
+
+    uSHELL_PRINTF("\r\n%-18s %8s %8s %8s %8s %8s %8s\r\n", "Queue", "Sent", "Received", "Empty", "Full", "Full err", "Timeout");
+    uSHELL_PRINTF("---------------------------------------------------------------------------\r\n");
+    for (ULONG i = 0U; (i < count) && (TX_NULL != queue); i++) {
+        ULONG sent = 0U, received = 0U, empty = 0U, full = 0U, fullErrors = 0U, timeouts = 0U;
+
+        (void)tx_queue_performance_info_get(queue, &sent, &received, &empty, &full, &fullErrors, &timeouts);
+        uSHELL_PRINTF("  %-16s %8u %8u %8u %8u %8u %8u\r\n", queue->tx_queue_name, (unsigned)sent,
+                      (unsigned)received, (unsigned)empty, (unsigned)full, (unsigned)fullErrors, (unsigned)timeouts);
+        queue = queue->tx_queue_created_next;
+    }
+}
+
+#endif /* defined(TX_EXECUTION_PROFILE_ENABLE) */
+
+
+extern "C" {
+
+/*--------------------------------------------------*/
+/* the ISR stack is the main() stack: painted from its reserved bottom up to below the sp */
+void sys_info_paint_isr_stack(void)
+{
+    uint32_t *sp;
+    __asm volatile ("mov %0, sp" : "=r" (sp));
+
+    uint32_t *word = (uint32_t *)(void *)(_estack - isr_stack_size());
+    uint32_t *stop = sp - (SYS_INFO_STACK_MARGIN / sizeof(uint32_t));
+
+    while (word < stop) {
+        *word++ = SYS_INFO_STACK_FILL;
+    }
+}
+
+/*--------------------------------------------------*/
+uint32_t sys_info_stack_unused(const void *pvStart, uint32_t u32Size)
+{
+    const uint32_t *word = (const uint32_t *)pvStart;
+    const uint32_t *end  = word + (u32Size / sizeof(uint32_t));
+
+    while ((word < end) && (SYS_INFO_STACK_FILL == *word)) {
+        word++;
+    }
+    return (uint32_t)((const uint8_t *)word - (const uint8_t *)pvStart);
+}
+
+} /* extern "C" */
+
+
+/*--------------------------------------------------*/
+/* shell command: uptime, threads and the stack peaks since reset */
+int sysinfo(void)
+{
+    uSHELL_PRINTF("\r\n=== System Info ===\r\n");
+    printUptime();
+    uSHELL_PRINTF("\r\n");
+    printStacks();
+    uSHELL_PRINTF("==================\r\n");
+
+    return 0;
+}
+
+
+/*--------------------------------------------------*/
+/* shell command: execution profile since the start or the last reset (1: print, then reset);
+   the counters of the kernel run from the start */
+int txprof(uint32_t u32Action)
+{
+#if defined(TX_EXECUTION_PROFILE_ENABLE)
+    uSHELL_PRINTF("\r\n=== Execution Profile === (%u MHz)\r\n", (unsigned)(SystemCoreClock / 1000000UL));
+    printProfile();
+    uSHELL_PRINTF("==================\r\n");
+
+    if (1U == u32Action) {
+        (void)_tx_execution_thread_total_time_reset();
+        (void)_tx_execution_isr_time_reset();
+        (void)_tx_execution_idle_time_reset();
+        uSHELL_PRINTF("times reset\r\n");
+    }
+#else
+    (void)u32Action;
+    uSHELL_PRINTF("txprof: built without TX_EXECUTION_PROFILE_ENABLE (USHELL_TX_PROFILE)\r\n");
+#endif /* defined(TX_EXECUTION_PROFILE_ENABLE) */
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef TX_POOLS_H
+#define TX_POOLS_H
+
+#include "tx_api.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+    ThreadX pools instead of the newlib heap: O(1) and deterministic, nothing copied twice.
+
+    Event channel: a block pool of fixed size events and a queue of pointers to them (one ULONG
+    per message). The sender takes a block, fills it and posts the pointer; the receiver reads
+    the event in place and releases the block. A block which could not be posted is released
+    by tx_evt_post(). The queue is tx_queue_send_notify()-able like any other.
+
+        static ULONG s_aulQueue[4];
+        static UCHAR s_aucPool[TX_EVT_POOL_BYTES(sizeof(msg_s), 4)];
+        tx_evt_channel_create(&ch, (CHAR *)"LCD", sizeof(msg_s), s_aucPool, sizeof(s_aucPool),
+                              s_aulQueue, sizeof(s_aulQueue));
+
+    Shell scratch: the buffers a command handler needs for the length of a call, from one byte
+    pool (TX_SCRATCH_POOL_BYTES); tx_scratch_alloc() does not wait, NULL while the pool has no
+    room. tx_pools_init() creates it, from tx_application_define().
+*/
+
+#define TX_SCRATCH_POOL_BYTES   512U
+
+/* bytes of a block pool of n events of size sz (ThreadX keeps a pointer per block) */
+#define TX_EVT_POOL_BYTES(sz, n) \
+    ((((((sz) + sizeof(ULONG) - 1U) / sizeof(ULONG)) * sizeof(ULONG)) + sizeof(UCHAR *)) * (n))
+
+typedef struct {
+    TX_BLOCK_POOL sPool;
+    TX_QUEUE      sQueue;
+} tx_evt_channel_s;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the scratch byte pool */
+UINT tx_pools_init(void);
+
+/* queue storage of depth pointers: depth * sizeof(ULONG) bytes */
+UINT tx_evt_channel_create(tx_evt_channel_s *psChannel, CHAR *pstrName, ULONG ulEventSize,
+                           VOID *pvPoolMem, ULONG ulPoolBytes, ULONG *pulQueueMem, ULONG ulQueueBytes);
+
+/* a free event block, NULL while none is (no wait) */
+VOID *tx_evt_alloc(tx_evt_channel_s *psChannel);
+
+/* queue the event without waiting; false (and the block released) if the queue is full */
+bool tx_evt_post(tx_evt_channel_s *psChannel, VOID *pvEvent);
+
+/* the next event, NULL on timeout; the receiver gives it back with tx_evt_release() */
+VOID *tx_evt_receive(tx_evt_channel_s *psChannel, ULONG ulWait);
+
+void tx_evt_release(VOID *pvEvent);
+
+/* command handler scratch, NULL while the pool has no room */
+void *tx_scratch_alloc(size_t szBytes);
+void tx_scratch_free(void *pvBuffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TX_POOLS_H */
@@ -0,0 +1,81 @@
+#include "tx_pools.h"
+
+static TX_BYTE_POOL s_sScratchPool;
+static ULONG s_aulScratchMem[TX_SCRATCH_POOL_BYTES / sizeof(ULONG)];
+static bool s_bScratchReady = false;
+
+/*--------------------------------------------------*/
+UINT tx_pools_init(void)
+{
+    const UINT uStatus = tx_byte_pool_create(&s_sScratchPool, (CHAR *)"Shell Scratch", s_aulScratchMem,
+                                             sizeof(s_aulScratchMem));
+    s_bScratchReady = (TX_SUCCESS == uStatus);
+    return uStatus;
+}
+
+/*--------------------------------------------------*/
+UINT tx_evt_channel_create(tx_evt_channel_s *psChannel, CHAR *pstrName, ULONG ulEventSize,
+                           VOID *pvPoolMem, ULONG ulPoolBytes, ULONG *pulQueueMem, ULONG ulQueueBytes)
+{
+    UINT uStatus = tx_block_pool_create(&psChannel->sPool, pstrName, ulEventSize, pvPoolMem, ulPoolBytes);
+    if (TX_SUCCESS == uStatus) {
+        uStatus = tx_queue_create(&psChannel->sQueue, pstrName, TX_1_ULONG, pulQueueMem, ulQueueBytes);
+    }
+    return uStatus;
+}
+
+/*--------------------------------------------------*/
+VOID *tx_evt_alloc(tx_evt_channel_s *psChannel)
+{
+    VOID *pvEvent = TX_NULL;
+    if (TX_SUCCESS != tx_block_allocate(&psChannel->sPool, &pvEvent, TX_NO_WAIT)) {
+        return TX_NULL;
+    }
+    return pvEvent;
+}
+
+/*--------------------------------------------------*/
+bool tx_evt_post(tx_evt_channel_s *psChannel, VOID *pvEvent)
+{
+    ULONG ulPointer = (ULONG)(uintptr_t)pvEvent;
+    if (TX_SUCCESS != tx_queue_send(&psChannel->sQueue, &ulPointer, TX_NO_WAIT)) {
+        (void)tx_block_release(pvEvent);
+        return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------*/
+VOID *tx_evt_receive(tx_evt_channel_s *psChannel, ULONG ulWait)
+{
+    ULONG ulPointer = 0U;
+    if (TX_SUCCESS != tx_queue_receive(&psChannel->sQueue, &ulPointer, ulWait)) {
+        return TX_NULL;
+    }
+    return (VOID *)(uintptr_t)ulPointer;
+}
+
+/*--------------------------------------------------*/
+void tx_evt_release(VOID *pvEvent)
+{
+    (void)tx_block_release(pvEvent);
+}
+
+/*--------------------------------------------------*/
+void *tx_scratch_alloc(size_t szBytes)
+{
+    VOID *pvBuffer = TX_NULL;
+    if (!s_bScratchReady ||
+        (TX_SUCCESS != tx_byte_allocate(&s_sScratchPool, &pvBuffer, (ULONG)szBytes, TX_NO_WAIT))) {
+        return nullptr;
+    }
+    return pvBuffer;
+}
+
+/*--------------------------------------------------*/
+void tx_scratch_free(void *pvBuffer)
+{
+    if (nullptr != pvBuffer) {
+        (void)tx_byte_release(pvBuffer);
+    }
+}
@@ -6,10 +6,20 @@ extern "C" {
 #endif
 
 #include <stdarg.h>
+#include <stdint.h>
 #include "ushell_core_printout.h"
 
+/* configure USART1, call before tx_kernel_enter() */
 void uart_setup(void);
 
+/* create the RTOS objects, call from tx_application_define() */
+void uart_start(void);
+
+/* runtime baud rate, -1 if the USART can not reach it; the shell
+   command baud switches it with a confirmation and keeps it across resets */
+int uart_set_baudrate(uint32_t baudrate);
+uint32_t uart_get_baudrate(void);
+
 
 #ifdef __cplusplus
 }
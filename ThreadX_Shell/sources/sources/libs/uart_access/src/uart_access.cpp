@@ -8,16 +8,80 @@
 #  error "Define STM32F1 or STM32F4 in your build system"
 #endif
 
+#include "tx_api.h"
+
 #include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * USART1 is interrupt driven (RXNE / TXE) and both directions go through
+ * a software ring, so no thread polls the peripheral:
+ *   - RX: the ISR stores the received bytes and sets UART_EVT_RX at IDLE
+ *         line, CR or a half full ring, uart_getchar() sleeps on the event
+ *         flags group (a pasted line is usually complete when it wakes up)
+ *   - TX: uart_putchar() queues the byte and arms TXEIE, the ISR feeds the
+ *         data register; a full ring suspends the writer on UART_EVT_TX_SPACE
+ *
+ * The flags group can only be created once the kernel is initialized, so
+ * until uart_start() runs (from tx_application_define) RX is busy waited
+ * and TX is the blocking HAL transfer.
+ *
+ * The baud rate is kept in the backup registers (it survives a reset); the
+ * stored value UART_AUTOBAUD makes uart_setup() measure the start bit of
+ * the first Enter instead, with a fall back to the default rate.
+ */
+
+#define UART_RX_BUFFER_SIZE     256U    /* power of 2 */
+#define UART_TX_BUFFER_SIZE     512U    /* power of 2 */
+#define UART_IRQ_PRIORITY       5U
+
+#define UART_EVT_RX             0x01U
+#define UART_EVT_TX_SPACE       0x02U
+
+#define UART_DEFAULT_BAUDRATE       115200U
+#define UART_MIN_BAUDRATE           1200U
+#define UART_AUTOBAUD               1U          /* stored instead of a rate: measure it on the first Enter */
+#define UART_BAUD_MAGIC             0xBA5DU     /* marks a valid setting in the backup registers */
+#define UART_BAUD_CONFIRM_MS        5000U       /* a new rate is kept only if Enter arrives at it meanwhile */
+#define UART_AUTOBAUD_TIMEOUT_MS    10000U      /* no Enter after reset: fall back to the default rate */
+#define UART_BAUD_CMD_ERR           0xFFU
+
+static_assert(0U == (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1U)), "UART_RX_BUFFER_SIZE must be a power of 2");
+static_assert(0U == (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1U)), "UART_TX_BUFFER_SIZE must be a power of 2");
+
+/* ================================================
+            printf configuration
+==================================================*/
+
+/* uart_printf() stack buffer, written out at every '\n' and when full */
+#define UART_PRINTF_LINE_SIZE       (64U)
+
+/* where the formatting engine puts its characters */
+typedef struct {
+    char *pcBuf;
+    int  iPos;
+    int  iSize;     /* usable bytes, without the NUL of uart_snprintf() */
+    bool bDrain;    /* uart_printf(): written out instead of truncated */
+} fmt_sink_s;
 
 /* ================================================
             private interfaces declaration
 ==================================================*/
 
-static void print_int(int value, int width, char pad, int left_align);
-static void print_hex(unsigned int value, int width, char pad, int left_align);
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad, int left_align);
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad, int left_align);
+static void fmt_putc(fmt_sink_s *psSink, char c);
+static void fmt_field(fmt_sink_s *psSink, const char *text, int len, int width, char pad, int left_align);
+static uint64_t fmt_divu10(uint64_t n, uint32_t *rem);
+static int fmt_utoa(char *end, uint64_t value, unsigned int base);
+static void fmt_number(fmt_sink_s *psSink, uint64_t value, bool negative, unsigned int base, int precision, int width, char pad, int left_align);
+static void fmt_float(fmt_sink_s *psSink, double value, int precision, int width, char pad, int left_align);
+static void fmt_vformat(fmt_sink_s *psSink, const char *fmt, va_list args);
+static bool can_suspend(void);
+static void uart_reinit(uint32_t baudrate);
+static bool baud_valid(uint32_t baudrate);
+static uint32_t baud_load(void);
+static void baud_store(uint32_t baudrate);
+static uint32_t baud_detect(void);
 
 /* ================================================
             module-level state
@@ -25,6 +89,20 @@ static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value
 
 static UART_HandleTypeDef huart1;
 
+static TX_EVENT_FLAGS_GROUP uart_events;
+static volatile bool        uart_started = false;
+
+/* RX ring: head written by the ISR only, tail by the reader only */
+static uint8_t           rx_ring[UART_RX_BUFFER_SIZE];
+static volatile uint16_t rx_head = 0;
+static volatile uint16_t rx_tail = 0;
+
+/* TX ring: head written by the writers (interrupts off), tail by the ISR only */
+static uint8_t           tx_ring[UART_TX_BUFFER_SIZE];
+static volatile uint16_t tx_head = 0;
+static volatile uint16_t tx_tail = 0;
+static volatile bool     tx_waiting = false;
+
 /* ================================================
             HAL MSP hook  (GPIO + clock wiring)
 ==================================================*/
@@ -71,6 +149,61 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
     gpio.Alternate = GPIO_AF7_USART1;
     HAL_GPIO_Init(GPIOA, &gpio);
 #endif
+
+    HAL_NVIC_SetPriority(USART1_IRQn, UART_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
+/* ================================================
+            USART1 interrupt
+==================================================*/
+
+extern "C" void USART1_IRQHandler(void)
+{
+#if defined(TX_EXECUTION_PROFILE_ENABLE)
+    _tx_execution_isr_enter();
+#endif
+    USART_TypeDef *uart = huart1.Instance;
+    const uint32_t sr   = uart->SR;
+    ULONG events        = 0;
+
+    /* reading DR after SR also clears a pending overrun or IDLE flag */
+    if (sr & (USART_SR_RXNE | USART_SR_ORE)) {
+        const uint8_t byte = (uint8_t)uart->DR;
+        const uint16_t head = rx_head;
+        const uint16_t next = (uint16_t)((head + 1U) & (UART_RX_BUFFER_SIZE - 1U));
+        if (next != rx_tail) {
+            rx_ring[head] = byte;
+            rx_head = next;
+        } /* else: reader too slow, the byte is lost */
+        if (('\r' == byte) || (((next - rx_tail) & (UART_RX_BUFFER_SIZE - 1U)) >= (UART_RX_BUFFER_SIZE / 2U))) {
+            events |= UART_EVT_RX;
+        }
+    } else if (sr & USART_SR_IDLE) {
+        (void)uart->DR;
+        events |= UART_EVT_RX;
+    }
+
+    if ((sr & USART_SR_TXE) && (uart->CR1 & USART_CR1_TXEIE)) {
+        const uint16_t tail = tx_tail;
+        if (tail != tx_head) {
+            uart->DR = tx_ring[tail];
+            tx_tail = (uint16_t)((tail + 1U) & (UART_TX_BUFFER_SIZE - 1U));
+        } else {
+            __HAL_UART_DISABLE_IT(&huart1, UART_IT_TXE);
+        }
+        if (tx_waiting) {
+            tx_waiting = false;
+            events |= UART_EVT_TX_SPACE;
+        }
+    }
+
+    if (events && uart_started) {
+        tx_event_flags_set(&uart_events, events, TX_OR);
+    }
+#if defined(TX_EXECUTION_PROFILE_ENABLE)
+    _tx_execution_isr_exit();
+#endif
 }
 
 /* ================================================
@@ -80,8 +213,10 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
 /*--------------------------------------------------*/
 void uart_setup(void)
 {
+    const uint32_t stored = baud_load();
+
     huart1.Instance          = USART1;
-    huart1.Init.BaudRate     = 115200;
+    huart1.Init.BaudRate     = (UART_AUTOBAUD == stored) ? UART_DEFAULT_BAUDRATE : stored;
     huart1.Init.WordLength   = UART_WORDLENGTH_8B;
     huart1.Init.StopBits     = UART_STOPBITS_1;
     huart1.Init.Parity       = UART_PARITY_NONE;
@@ -90,231 +225,693 @@ void uart_setup(void)
     huart1.Init.OverSampling = UART_OVERSAMPLING_16;
 
     HAL_UART_Init(&huart1);
+
+    /* the pins are wired by the MSP hook now, the interrupts are still off */
+    if (UART_AUTOBAUD == stored) {
+        uart_reinit(baud_detect());
+    }
+
+    __HAL_UART_ENABLE_IT(&huart1, UART_IT_RXNE);
+    __HAL_UART_ENABLE_IT(&huart1, UART_IT_IDLE);
+}
+
+/*--------------------------------------------------*/
+void uart_start(void)
+{
+    if (TX_SUCCESS == tx_event_flags_create(&uart_events, (CHAR*)"UART Events")) {
+        uart_started = true;
+    }
 }
 
 /*--------------------------------------------------*/
 int uart_getchar(void)
 {
-    uint8_t byte;
-    HAL_UART_Receive(&huart1, &byte, 1, HAL_MAX_DELAY);
+    while (rx_tail == rx_head) {
+        if (can_suspend()) {
+            ULONG actual;
+            tx_event_flags_get(&uart_events, UART_EVT_RX, TX_OR_CLEAR, &actual, TX_WAIT_FOREVER);
+        }
+    }
+
+    const uint16_t tail = rx_tail;
+    const uint8_t byte  = rx_ring[tail];
+    rx_tail = (uint16_t)((tail + 1U) & (UART_RX_BUFFER_SIZE - 1U));
     return (int)byte;
 }
 
+/*--------------------------------------------------*/
+int uart_getline(char *buf, int maxlen)
+{
+    while (rx_tail == rx_head) {
+        if (can_suspend()) {
+            ULONG actual;
+            tx_event_flags_get(&uart_events, UART_EVT_RX, TX_OR_CLEAR, &actual, TX_WAIT_FOREVER);
+        }
+    }
+
+    /* anything else than a complete line (control keys, partial or too long line) stays for uart_getchar() */
+    const uint16_t head = rx_head;
+    uint16_t idx = rx_tail;
+    int consumed = 0;
+    int len = 0;
+
+    while (idx != head) {
+        const uint8_t c = rx_ring[idx];
+        idx = (uint16_t)((idx + 1U) & (UART_RX_BUFFER_SIZE - 1U));
+        consumed++;
+        if ('\r' == c) {
+            buf[len] = '\0';
+            rx_tail = idx;
+            return consumed;
+        }
+        if ('\n' == c) {
+            continue;
+        }
+        if ((c < 0x20U) || (c > 0x7EU) || (len >= maxlen - 1)) {
+            break;
+        }
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
+}
+
 /*--------------------------------------------------*/
 void uart_putchar(char c)
 {
-    HAL_UART_Transmit(&huart1, (uint8_t *)&c, 1, HAL_MAX_DELAY);
+    const bool suspend = can_suspend();
+
+    /* no thread to suspend (init or ISR context): one blocking byte, if the ring is idle */
+    if (!suspend && (tx_tail == tx_head) && !(huart1.Instance->CR1 & USART_CR1_TXEIE)) {
+        HAL_UART_Transmit(&huart1, (uint8_t *)&c, 1, HAL_MAX_DELAY);
+        return;
+    }
+
+    for (;;) {
+        UINT posture = tx_interrupt_control(TX_INT_DISABLE);
+        const uint16_t head = tx_head;
+        const uint16_t next = (uint16_t)((head + 1U) & (UART_TX_BUFFER_SIZE - 1U));
+        if (next != tx_tail) {
+            tx_ring[head] = (uint8_t)c;
+            tx_head = next;
+            __HAL_UART_ENABLE_IT(&huart1, UART_IT_TXE);
+            tx_interrupt_control(posture);
+            return;
+        }
+        tx_waiting = suspend;
+        tx_interrupt_control(posture);
+
+        if (!suspend) {
+            return; /* ring full and nobody to wait: drop */
+        }
+
+        /* the ISR frees a slot per byte; the 1 tick timeout only bounds a missed wakeup */
+        ULONG actual;
+        tx_event_flags_get(&uart_events, UART_EVT_TX_SPACE, TX_OR_CLEAR, &actual, 1);
+    }
 }
 
 /*--------------------------------------------------*/
-int uart_printf(const char *fmt, ...)
+void uart_write(const char *buf, int len)
 {
-    va_list args;
-    va_start(args, fmt);
-    while (*fmt) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad      = ' ';
-            int  width    = 0;
-            int  left_align = 0;
+    for (int i = 0; i < len; ++i) {
+        uart_putchar(buf[i]);
+    }
+}
 
-            if (*fmt == '-') { left_align = 1; fmt++; }
-            if (*fmt == '0') { pad = '0';      fmt++; }
+/*--------------------------------------------------*/
+int uart_set_baudrate(uint32_t baudrate)
+{
+    if (!baud_valid(baudrate)) {
+        return -1;
+    }
 
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
-            }
+    /* the queued output still goes out at the old rate */
+    while ((tx_tail != tx_head) || (huart1.Instance->CR1 & USART_CR1_TXEIE)) {
+        if (can_suspend()) {
+            tx_thread_sleep(1);
+        }
+    }
+    while (!(huart1.Instance->SR & USART_SR_TC)) {
+    }
 
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    int len = 0;
-                    const char *tmp = s;
-                    while (*tmp++) len++;
-
-                    if (left_align) {
-                        tmp = s;
-                        while (*tmp) uart_putchar(*tmp++);
-                        for (int i = len; i < width; i++) uart_putchar(' ');
-                    } else {
-                        for (int i = len; i < width; i++) uart_putchar(pad);
-                        while (*s) uart_putchar(*s++);
-                    }
-                    break;
-                }
-                case 'd':
-                    print_int(va_arg(args, int), width, pad, left_align);
-                    break;
-                case 'x':
-                case 'X':
-                    print_hex(va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'c':
-                    uart_putchar((char)va_arg(args, int));
-                    break;
-                default:
-                    uart_putchar('%');
-                    uart_putchar(*fmt);
-                    break;
-            }
+    uart_reinit(baudrate);
+    __HAL_UART_ENABLE_IT(&huart1, UART_IT_RXNE);
+    __HAL_UART_ENABLE_IT(&huart1, UART_IT_IDLE);
+    return 0;
+}
+
+/*--------------------------------------------------*/
+uint32_t uart_get_baudrate(void)
+{
+    return huart1.Init.BaudRate;
+}
+
+/*--------------------------------------------------*/
+/* shell command: 0 shows the rates, 1 selects the detection at the next reset, any other
+   value switches now and stays (and is stored) only if Enter is received at the new rate */
+int baud(uint32_t baudrate)
+{
+    if (0U == baudrate) {
+        const uint32_t stored = baud_load();
+        if (UART_AUTOBAUD == stored) {
+            uart_printf("baud: %d, at reset: detected\r\n", (int)huart1.Init.BaudRate);
         } else {
-            uart_putchar(*fmt);
+            uart_printf("baud: %d, at reset: %d\r\n", (int)huart1.Init.BaudRate, (int)stored);
         }
-        fmt++;
+        return 0;
+    }
+
+    if (UART_AUTOBAUD == baudrate) {
+        baud_store(UART_AUTOBAUD);
+        uart_printf("baud: after reset press Enter to set the rate\r\n");
+        return 0;
+    }
+
+    if (!baud_valid(baudrate)) {
+        uart_printf("baud: %d not reachable\r\n", (int)baudrate);
+        return UART_BAUD_CMD_ERR;
+    }
+
+    const uint32_t old = huart1.Init.BaudRate;
+    uart_printf("baud: switching to %d, press Enter within %d s\r\n", (int)baudrate, (int)(UART_BAUD_CONFIRM_MS / 1000U));
+    (void)uart_set_baudrate(baudrate);
+
+    /* whatever arrived before the switch was sent at the old rate */
+    rx_tail = rx_head;
+
+    /* the ISR raises UART_EVT_RX on CR (or IDLE line) */
+    bool confirmed = false;
+    const ULONG start   = tx_time_get();
+    const ULONG timeout = (ULONG)((UART_BAUD_CONFIRM_MS * TX_TIMER_TICKS_PER_SECOND) / 1000U);
+    while (!confirmed) {
+        const ULONG elapsed = tx_time_get() - start;
+        if (elapsed >= timeout) {
+            break;
+        }
+        if (can_suspend() && (rx_tail == rx_head)) {
+            ULONG actual;
+            tx_event_flags_get(&uart_events, UART_EVT_RX, TX_OR_CLEAR, &actual, timeout - elapsed);
+        }
+        while (!confirmed && (rx_tail != rx_head)) {
+            confirmed = ('\r' == rx_ring[rx_tail]);
+            rx_tail = (uint16_t)((rx_tail + 1U) & (UART_RX_BUFFER_SIZE - 1U));
+        }
+    }
+
+    if (!confirmed) {
+        (void)uart_set_baudrate(old);
+        uart_printf("baud: no Enter received, back to %d\r\n", (int)old);
+        return UART_BAUD_CMD_ERR;
+    }
+
+    baud_store(baudrate);
+    uart_printf("baud: %d stored\r\n", (int)baudrate);
+    return 0;
+}
+
+/*--------------------------------------------------*/
+/* formatted into a line buffer on the stack, one uart_write() per line */
+int uart_vprintf(const char *fmt, va_list args)
+{
+    char line[UART_PRINTF_LINE_SIZE];
+    fmt_sink_s sSink = { line, 0, (int)sizeof(line), true };
+
+    fmt_vformat(&sSink, fmt, args);
+    if (sSink.iPos > 0) {
+        uart_write(line, sSink.iPos);
     }
-    va_end(args);
     return 0;
 }
 
+/*--------------------------------------------------*/
+int uart_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
+/*--------------------------------------------------*/
+int uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args)
+{
+    if (maxlen <= 0) {
+        return 0;
+    }
+    fmt_sink_s sSink = { buf, 0, maxlen - 1, false };
+
+    fmt_vformat(&sSink, fmt, args);
+    buf[sSink.iPos] = '\0';
+    return sSink.iPos;
+}
+
 /*--------------------------------------------------*/
 int uart_snprintf(char *buf, int maxlen, const char *fmt, ...)
 {
     va_list args;
     va_start(args, fmt);
-    int pos = 0;
+    const int ret = uart_vsnprintf(buf, maxlen, fmt, args);
+    va_end(args);
+    return ret;
+}
 
-    while (*fmt && pos < maxlen - 1) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad      = ' ';
-            int  width    = 0;
-            int  left_align = 0;
+#if defined(UART_ACCESS_NO_NEWLIB_PRINTF)
+/*--------------------------------------------------*/
+/* linked with -Wl,--wrap=...: every printf family call of the image lands in the
+   engine above and the newlib implementation stays out of the link */
+extern "C" int __wrap_vprintf(const char *fmt, va_list args)
+{
+    return uart_vprintf(fmt, args);
+}
 
-            if (*fmt == '-') { left_align = 1; fmt++; }
-            if (*fmt == '0') { pad = '0';      fmt++; }
+/*--------------------------------------------------*/
+extern "C" int __wrap_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
 
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
-            }
+/*--------------------------------------------------*/
+extern "C" int __wrap_vsnprintf(char *buf, size_t maxlen, const char *fmt, va_list args)
+{
+    return uart_vsnprintf(buf, (int)maxlen, fmt, args);
+}
 
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    int len = 0;
-                    const char *tmp = s;
-                    while (*tmp++) len++;
-
-                    if (left_align) {
-                        tmp = s;
-                        while (*tmp && pos < maxlen - 1) buf[pos++] = *tmp++;
-                        for (int i = len; i < width && pos < maxlen - 1; i++) buf[pos++] = ' ';
-                    } else {
-                        for (int i = len; i < width && pos < maxlen - 1; i++) buf[pos++] = pad;
-                        while (*s && pos < maxlen - 1) buf[pos++] = *s++;
-                    }
-                    break;
-                }
-                case 'd':
-                    print_int_to_buf(buf, &pos, maxlen, va_arg(args, int), width, pad, left_align);
-                    break;
-                case 'x':
-                case 'X':
-                    print_hex_to_buf(buf, &pos, maxlen, va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'c':
-                    if (pos < maxlen - 1) buf[pos++] = (char)va_arg(args, int);
-                    break;
-                default:
-                    if (pos < maxlen - 1) buf[pos++] = '%';
-                    if (pos < maxlen - 1) buf[pos++] = *fmt;
-                    break;
-            }
-        } else {
-            buf[pos++] = *fmt;
-        }
-        fmt++;
-    }
+/*--------------------------------------------------*/
+extern "C" int __wrap_snprintf(char *buf, size_t maxlen, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vsnprintf(buf, (int)maxlen, fmt, args);
+    va_end(args);
+    return ret;
+}
 
-    buf[pos] = '\0';
+/*--------------------------------------------------*/
+/* no size: the largest buffer the engine can describe */
+extern "C" int __wrap_sprintf(char *buf, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vsnprintf(buf, INT32_MAX, fmt, args);
     va_end(args);
-    return pos;
+    return ret;
+}
+
+/*--------------------------------------------------*/
+/* the compiler turns printf("text\n") into puts("text") and printf("%c") into putchar() */
+extern "C" int __wrap_puts(const char *s)
+{
+    int len = 0;
+    while (s[len]) len++;
+    uart_write(s, len);
+    uart_putchar('\n');
+    return 0;
+}
+
+/*--------------------------------------------------*/
+extern "C" int __wrap_putchar(int c)
+{
+    uart_putchar((char)c);
+    return c;
 }
+#endif /*defined(UART_ACCESS_NO_NEWLIB_PRINTF)*/
 
 /* ================================================
             private interfaces definition
 ==================================================*/
 
 /*--------------------------------------------------*/
-static void print_int(int value, int width, char pad, int left_align)
+static bool can_suspend(void)
 {
-    char buf[12];
-    int  i           = 0;
-    int  is_negative = (value < 0);
-
-    if (is_negative) value = -value;
+    /* tx_thread_identify() returns the interrupted thread inside an ISR, so check IPSR too */
+    return uart_started && (0U == __get_IPSR()) && (TX_NULL != tx_thread_identify());
+}
 
-    do { buf[i++] = '0' + (value % 10); value /= 10; } while (value);
-    if (is_negative) buf[i++] = '-';
+/*--------------------------------------------------*/
+/* uart_printf() drains the line buffer when it is full and at every '\n',
+   uart_snprintf() truncates at its size */
+static void fmt_putc(fmt_sink_s *psSink, char c)
+{
+    if (psSink->iPos >= psSink->iSize) {
+        if (!psSink->bDrain) {
+            return;
+        }
+        uart_write(psSink->pcBuf, psSink->iPos);
+        psSink->iPos = 0;
+    }
+    psSink->pcBuf[psSink->iPos++] = c;
+    if (psSink->bDrain && ('\n' == c)) {
+        uart_write(psSink->pcBuf, psSink->iPos);
+        psSink->iPos = 0;
+    }
+}
 
+/*--------------------------------------------------*/
+/* left aligned fields are always padded with spaces */
+static void fmt_field(fmt_sink_s *psSink, const char *text, int len, int width, char pad, int left_align)
+{
+    if (!left_align) {
+        for (int i = len; i < width; i++) fmt_putc(psSink, pad);
+    }
+    for (int i = 0; i < len; i++) fmt_putc(psSink, text[i]);
     if (left_align) {
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
-        for (int j = i; j < width; j++)  uart_putchar(' ');
-    } else {
-        for (int j = i; j < width; j++)  uart_putchar(pad);
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
+        for (int i = len; i < width; i++) fmt_putc(psSink, ' ');
     }
 }
 
 /*--------------------------------------------------*/
-static void print_hex(unsigned int value, int width, char pad, int left_align)
+/* n / 10 as a multiplication by 0.8 in shifts and adds, then >> 3: the 64 bit
+   division would be the libgcc loop on the Cortex-M; the estimate is off by 1 at most */
+static uint64_t fmt_divu10(uint64_t n, uint32_t *rem)
 {
-    const char hex[] = "0123456789ABCDEF";
-    char buf[8];
-    int  i = 0;
+    uint64_t q = (n >> 1) + (n >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q += q >> 32;
+    q >>= 3;
+
+    uint32_t r = (uint32_t)(n - ((q << 3) + (q << 1)));
+    if (r > 9U) {
+        q++;
+        r -= 10U;
+    }
+    *rem = r;
+    return q;
+}
 
-    do { buf[i++] = hex[value & 0xF]; value >>= 4; } while (value);
+/*--------------------------------------------------*/
+/* writes the digits backwards, ending before end; returns their count */
+static int fmt_utoa(char *end, uint64_t value, unsigned int base)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char *p = end;
 
-    if (left_align) {
-        uart_putchar('0'); uart_putchar('x');
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
-        for (int j = i + 2; j < width; j++) uart_putchar(' ');
-    } else {
-        for (int j = i + 2; j < width; j++) uart_putchar(pad);
-        uart_putchar('0'); uart_putchar('x');
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
+    if (16U == base) {
+        do { *--p = hex[value & 0xFU]; value >>= 4; } while (value);
+        return (int)(end - p);
+    }
+    while (value > UINT32_MAX) {
+        uint32_t rem;
+        value = fmt_divu10(value, &rem);
+        *--p = (char)('0' + rem);
     }
+    uint32_t low = (uint32_t)value; /* the rest with the hardware divider */
+    do { *--p = (char)('0' + (low % 10U)); low /= 10U; } while (low);
+    return (int)(end - p);
 }
 
 /*--------------------------------------------------*/
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad, int left_align)
+/* precision is the minimum number of digits, the sign and 0x go in front of them */
+static void fmt_number(fmt_sink_s *psSink, uint64_t value, bool negative, unsigned int base, int precision, int width, char pad, int left_align)
 {
-    char tmp[12];
-    int  i           = 0;
-    int  is_negative = (value < 0);
+    char tmp[24];
+    int  i = (int)sizeof(tmp);
 
-    if (is_negative) value = -value;
+    i -= fmt_utoa(&tmp[i], value, base);
+    for (int n = (int)sizeof(tmp) - i; (n < precision) && (i > 3); n++) tmp[--i] = '0';
+    if (16U == base) { tmp[--i] = 'x'; tmp[--i] = '0'; }
+    if (negative)    { tmp[--i] = '-'; }
 
-    do { tmp[i++] = '0' + (value % 10); value /= 10; } while (value);
-    if (is_negative) tmp[i++] = '-';
+    fmt_field(psSink, &tmp[i], (int)sizeof(tmp) - i, width, pad, left_align);
+}
 
-    if (left_align) {
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
-        for (int j = i; j < width && *pos < maxlen - 1; j++)  buf[(*pos)++] = ' ';
-    } else {
-        for (int j = i; j < width && *pos < maxlen - 1; j++)  buf[(*pos)++] = pad;
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
+/*--------------------------------------------------*/
+/* fixed point from the bits of the double, integer arithmetic only: a %f argument is a double (the
+   promotion of the varargs), which the single precision FPU of the Cortex-M4F does not handle, soft
+   float calls on either core otherwise. The integer part as a 64 bit integer, the fraction in Q0.64
+   scaled to precision (at most 9) digits in two 32 bit halves and rounded half up; finite values
+   beyond 2^64 print "ovf" */
+static void fmt_float(fmt_sink_s *psSink, double value, int precision, int width, char pad, int left_align)
+{
+    static const uint32_t pow10[] = { 1U, 10U, 100U, 1000U, 10000U, 100000U,
+                                      1000000U, 10000000U, 100000000U, 1000000000U };
+    char tmp[32];
+    int  i = (int)sizeof(tmp);
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const int      biased   = (int)((bits >> 52) & 0x7FFU);
+    const uint64_t mantissa = bits & 0x000FFFFFFFFFFFFFULL;
+    const bool     negative = (0U != (bits >> 63)) && (0U != (bits << 1));   /* -0.0 prints as 0 */
+
+    if ((0x7FF == biased) && (0U != mantissa)) {
+        fmt_field(psSink, "nan", 3, width, ' ', left_align);
+        return;
+    }
+    if (biased >= (1023 + 64)) {
+        const char *text = (0x7FF == biased) ? "-inf" : "-ovf";
+        fmt_field(psSink, negative ? text : &text[1], negative ? 4 : 3, width, ' ', left_align);
+        return;
+    }
+    if (precision < 0) {
+        precision = 6;
+    } else if (precision > 9) {
+        precision = 9;
+    }
+
+    /* value = m / 2^shift */
+    const uint64_t m     = (0 == biased) ? mantissa : (mantissa | (1ULL << 52));
+    const int      shift = 1075 - ((0 == biased) ? 1 : biased);
+    uint64_t ipart = 0U;
+    uint64_t frac  = 0U;
+    if (shift <= 0) {
+        ipart = m << -shift;
+    } else if (shift < 64) {
+        ipart = m >> shift;
+        frac  = (m & ((1ULL << shift) - 1U)) << (64 - shift);
+    } else if ((shift - 64) < 64) {
+        frac  = m >> (shift - 64);
     }
+
+    /* (frac * 10^precision + 2^63) >> 64, the low half only carries into the high one */
+    const uint64_t scaled = (frac >> 32) * pow10[precision] + (((frac & 0xFFFFFFFFU) * pow10[precision]) >> 32);
+    uint32_t fpart = (uint32_t)((scaled + (1ULL << 31)) >> 32);
+    if (fpart >= pow10[precision]) {
+        fpart -= pow10[precision];
+        ipart++;
+    }
+
+    if (precision > 0) {
+        int n = fmt_utoa(&tmp[i], fpart, 10U);
+        i -= n;
+        for (; n < precision; n++) tmp[--i] = '0';
+        tmp[--i] = '.';
+    }
+    i -= fmt_utoa(&tmp[i], ipart, 10U);
+    if (negative) { tmp[--i] = '-'; }
+
+    fmt_field(psSink, &tmp[i], (int)sizeof(tmp) - i, width, pad, left_align);
 }
 
 /*--------------------------------------------------*/
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad, int left_align)
+/* supports %s %c %d %i %u %x/%X %p %f %%, the flags - and 0, width and precision
+   (also as *) and the l, ll, z length modifiers */
+static void fmt_vformat(fmt_sink_s *psSink, const char *fmt, va_list args)
 {
-    const char hex[] = "0123456789ABCDEF";
-    char tmp[8];
-    int  i = 0;
+    for (; *fmt; fmt++) {
+        if (*fmt != '%') {
+            fmt_putc(psSink, *fmt);
+            continue;
+        }
+        fmt++;
+        char pad        = ' ';
+        int  width      = 0;
+        int  precision  = -1;
+        int  length     = 0;    /* 1: long, 2: long long */
+        int  left_align = 0;
 
-    do { tmp[i++] = hex[value & 0xF]; value >>= 4; } while (value);
+        if (*fmt == '-') { left_align = 1; fmt++; }
+        if (*fmt == '0') { pad = '0';      fmt++; }
 
-    if (left_align) {
-        if (*pos < maxlen - 2) { buf[(*pos)++] = '0'; buf[(*pos)++] = 'x'; }
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
-        for (int j = i + 2; j < width && *pos < maxlen - 1; j++) buf[(*pos)++] = ' ';
-    } else {
-        for (int j = i + 2; j < width && *pos < maxlen - 1; j++) buf[(*pos)++] = pad;
-        if (*pos < maxlen - 2) { buf[(*pos)++] = '0'; buf[(*pos)++] = 'x'; }
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
+        if (*fmt == '*') {
+            width = va_arg(args, int);
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (*fmt - '0');
+            fmt++;
+        }
+        if (*fmt == '.') {
+            fmt++;
+            precision = 0;
+            if (*fmt == '*') {
+                precision = va_arg(args, int);
+                fmt++;
+            }
+            while (*fmt >= '0' && *fmt <= '9') {
+                precision = precision * 10 + (*fmt - '0');
+                fmt++;
+            }
+        }
+        while (*fmt == 'l') { length++; fmt++; }
+        if (*fmt == 'z') {
+            length = (sizeof(size_t) > sizeof(unsigned int)) ? 1 : 0;
+            fmt++;
+        }
+
+        switch (*fmt) {
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                if (nullptr == s) {
+                    s = "(null)";
+                }
+                int len = 0;
+                while (s[len] && ((precision < 0) || (len < precision))) len++;
+                fmt_field(psSink, s, len, width, pad, left_align);
+                break;
+            }
+            case 'c': {
+                const char c = (char)va_arg(args, int);
+                fmt_field(psSink, &c, 1, width, pad, left_align);
+                break;
+            }
+            case 'd':
+            case 'i': {
+                const int64_t value = (length > 1) ? (int64_t)va_arg(args, long long)
+                                    : (length > 0) ? (int64_t)va_arg(args, long)
+                                                   : (int64_t)va_arg(args, int);
+                /* the magnitude in unsigned arithmetic, the minimum included */
+                fmt_number(psSink, (value < 0) ? (0U - (uint64_t)value) : (uint64_t)value,
+                           (value < 0), 10U, precision, width, pad, left_align);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                const uint64_t value = (length > 1) ? (uint64_t)va_arg(args, unsigned long long)
+                                     : (length > 0) ? (uint64_t)va_arg(args, unsigned long)
+                                                    : (uint64_t)va_arg(args, unsigned int);
+                fmt_number(psSink, value, false, ('u' == *fmt) ? 10U : 16U, precision, width, pad, left_align);
+                break;
+            }
+            case 'p':
+                fmt_number(psSink, (uint64_t)(uintptr_t)va_arg(args, void *), false, 16U,
+                           (int)(2U * sizeof(void *)), width, pad, left_align);
+                break;
+            case 'f':
+            case 'F':
+                fmt_float(psSink, va_arg(args, double), precision, width, pad, left_align);
+                break;
+            case '%':
+                fmt_putc(psSink, '%');
+                break;
+            case '\0':
+                return; /* a lone '%' ends the format */
+            default:
+                fmt_putc(psSink, '%');
+                fmt_putc(psSink, *fmt);
+                break;
+        }
+    }
+}
+
+/*--------------------------------------------------*/
+/* the MSP hook only runs at the first init, a byte received at the old rate is dropped */
+static void uart_reinit(uint32_t baudrate)
+{
+    huart1.Init.BaudRate = baudrate;
+    HAL_UART_Init(&huart1);
+    (void)huart1.Instance->SR;
+    (void)huart1.Instance->DR;
+}
+
+/*--------------------------------------------------*/
+/* oversampling by 16: the divider can not go below 16 */
+static bool baud_valid(uint32_t baudrate)
+{
+    return (baudrate >= UART_MIN_BAUDRATE) && ((HAL_RCC_GetPCLK2Freq() / baudrate) >= 16U);
+}
+
+/*--------------------------------------------------*/
+/* backup domain: survives a reset (and a power cycle with VBAT) */
+static uint32_t baud_load(void)
+{
+    __HAL_RCC_PWR_CLK_ENABLE();
+#if defined(STM32F1)
+    __HAL_RCC_BKP_CLK_ENABLE();
+    const uint32_t magic    = BKP->DR1 & 0xFFFFU;
+    const uint32_t baudrate = (BKP->DR2 & 0xFFFFU) | ((BKP->DR3 & 0xFFFFU) << 16);
+#elif defined(STM32F4)
+    const uint32_t magic    = RTC->BKP0R;
+    const uint32_t baudrate = RTC->BKP1R;
+#endif
+
+    if ((UART_BAUD_MAGIC == magic) && ((UART_AUTOBAUD == baudrate) || baud_valid(baudrate))) {
+        return baudrate;
+    }
+    return UART_DEFAULT_BAUDRATE;
+}
+
+/*--------------------------------------------------*/
+static void baud_store(uint32_t baudrate)
+{
+    SET_BIT(PWR->CR, PWR_CR_DBP);
+#if defined(STM32F1)
+    BKP->DR2 = baudrate & 0xFFFFU;
+    BKP->DR3 = baudrate >> 16;
+    BKP->DR1 = UART_BAUD_MAGIC;
+#elif defined(STM32F4)
+    RTC->BKP1R = baudrate;
+    RTC->BKP0R = UART_BAUD_MAGIC;
+#endif
+    CLEAR_BIT(PWR->CR, PWR_CR_DBP);
+}
+
+/*--------------------------------------------------*/
+/* polls PA10: in '\r' (0x0D, LSB first) the start bit is the only low bit before bit0,
+   so the first low pulse is one bit time; that character is lost */
+static uint32_t baud_detect(void)
+{
+    static const uint32_t rates[] = { 9600U, 19200U, 38400U, 57600U, 115200U, 230400U, 460800U, 921600U, 2000000U };
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+    const uint32_t clock   = SystemCoreClock;
+    const uint64_t timeout = (uint64_t)(clock / 1000U) * UART_AUTOBAUD_TIMEOUT_MS;
+    uint64_t waited = 0U;
+    uint32_t last   = DWT->CYCCNT;
+    auto expired = [&]() -> bool {
+        const uint32_t now = DWT->CYCCNT;
+        waited += (uint32_t)(now - last);
+        last = now;
+        return (waited >= timeout);
+    };
+
+    for (;;) {
+        /* idle (high) line, then the falling edge of a start bit */
+        while (!(GPIOA->IDR & GPIO_PIN_10)) {
+            if (expired()) return UART_DEFAULT_BAUDRATE;
+        }
+        while (GPIOA->IDR & GPIO_PIN_10) {
+            if (expired()) return UART_DEFAULT_BAUDRATE;
+        }
+        const uint32_t start = DWT->CYCCNT;
+        while (!(GPIOA->IDR & GPIO_PIN_10) && ((uint32_t)(DWT->CYCCNT - start) < (clock / UART_MIN_BAUDRATE))) {
+        }
+        const uint32_t bit      = (uint32_t)(DWT->CYCCNT - start);
+        const uint32_t measured = clock / ((0U == bit) ? 1U : bit);
+
+        /* the standard rates are at least 1.5x apart, 20% off still picks the right one */
+        for (const uint32_t rate : rates) {
+            if ((measured > (rate - (rate / 5U))) && (measured < (rate + (rate / 5U)))) {
+                /* let the rest of the character (and a following LF) go by */
+                uint32_t high = DWT->CYCCNT;
+                while (((uint32_t)(DWT->CYCCNT - high) < (20U * bit)) && !expired()) {
+                    if (!(GPIOA->IDR & GPIO_PIN_10)) high = DWT->CYCCNT;
+                }
+                return rate;
+            }
+        }
+        /* another key or noise: wait for the next character */
     }
 }
 
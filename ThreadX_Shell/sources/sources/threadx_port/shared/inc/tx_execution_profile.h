@@ -0,0 +1,49 @@
+/* tx_execution_profile.h — execution profile of the threads, the ISRs and the idle time */
+
+#ifndef TX_EXECUTION_PROFILE_H
+#define TX_EXECUTION_PROFILE_H
+
+/*
+    The interface of the ThreadX execution profile kit (utility/execution_profile_kit,
+    not part of this tree), implemented in tx_execution_profile.c on the DWT cycle
+    counter. tx_api.h includes this file with TX_EXECUTION_PROFILE_ENABLE: every
+    TX_THREAD gets its tx_thread_execution_time_total, the scheduler calls the thread
+    enter / exit hooks at every switch.
+
+    Every cycle belongs to one of: the running thread, an ISR, the idle loop of the
+    scheduler. The hooks close the running interval and give it to its owner, the time
+    between a thread exit and the next enter is idle. An ISR is counted from the hooks of
+    its handler (SysTick in tx_initialize_low_level.S, the handlers of the firmware):
+    one without them adds its cycles to what it interrupted. The SysTick hooks also
+    bound every interval to a tick, far below the wrap of the 32 bit counter.
+*/
+
+/* included by tx_api.h after tx_port.h: its types only, no TX_THREAD yet */
+typedef ULONG64     EXECUTION_TIME;
+typedef ULONG       EXECUTION_TIME_SOURCE_TYPE;
+
+#define TX_EXECUTION_TIME_SOURCE    (*((volatile EXECUTION_TIME_SOURCE_TYPE *)0xE0001004UL))   /* DWT->CYCCNT */
+
+struct TX_THREAD_STRUCT;
+
+/* the hooks: the scheduler and the ISRs, interrupts masked or not */
+VOID _tx_execution_thread_enter(VOID);
+VOID _tx_execution_thread_exit(VOID);
+VOID _tx_execution_isr_enter(VOID);
+VOID _tx_execution_isr_exit(VOID);
+
+/* starts the DWT cycle counter, from tx_application_define() before the first thread */
+VOID _tx_execution_initialize(VOID);
+
+/* the cycles since the initialization or the last reset */
+UINT _tx_execution_thread_time_get(struct TX_THREAD_STRUCT *thread_ptr, EXECUTION_TIME *total_time);
+UINT _tx_execution_thread_total_time_get(EXECUTION_TIME *total_time);
+UINT _tx_execution_isr_time_get(EXECUTION_TIME *total_time);
+UINT _tx_execution_idle_time_get(EXECUTION_TIME *total_time);
+
+UINT _tx_execution_thread_time_reset(struct TX_THREAD_STRUCT *thread_ptr);
+UINT _tx_execution_thread_total_time_reset(VOID);
+UINT _tx_execution_isr_time_reset(VOID);
+UINT _tx_execution_idle_time_reset(VOID);
+
+#endif /* TX_EXECUTION_PROFILE_H */
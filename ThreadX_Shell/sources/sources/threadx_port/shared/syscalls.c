@@ -90,7 +90,8 @@ int _write(int fd, char *ptr, int len)
     return len;
 }
 
-/* _sbrk: heap management – required if you use malloc/new */
+/* _sbrk: heap management – required if you use malloc/new (the shell handlers and the
+   LCD messages take ThreadX pools instead, tx_pools.h) */
 extern char _end;       /* defined by linker script */
 void *_sbrk(int incr) 
 {
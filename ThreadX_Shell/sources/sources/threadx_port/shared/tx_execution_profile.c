@@ -0,0 +1,213 @@
+/* tx_execution_profile.c – execution profile hooks of the scheduler and the ISRs on the DWT cycle counter */
+#include "tx_api.h"
+
+#if defined(TX_EXECUTION_PROFILE_ENABLE)
+
+#include "tx_thread.h"
+
+#define DEMCR               (*((volatile ULONG *)0xE000EDFCUL))
+#define DEMCR_TRCENA        (1UL << 24)
+#define DWT_CTRL            (*((volatile ULONG *)0xE0001000UL))
+#define DWT_CTRL_CYCCNTENA  (1UL << 0)
+
+static EXECUTION_TIME             s_isrTime;
+static EXECUTION_TIME             s_idleTime;
+static EXECUTION_TIME_SOURCE_TYPE s_stamp;      /* start of the open interval */
+static TX_THREAD                 *s_owner;      /* its thread, TX_NULL: idle */
+static UINT                       s_isrNesting;
+
+/* the cycles since s_stamp, the next interval starts now */
+static EXECUTION_TIME s_close(void)
+{
+    const EXECUTION_TIME_SOURCE_TYPE now = TX_EXECUTION_TIME_SOURCE;
+    const EXECUTION_TIME_SOURCE_TYPE delta = now - s_stamp;
+
+    s_stamp = now;
+    return (EXECUTION_TIME)delta;
+}
+
+/* the interval before an ISR or a switch: to the thread it ran in, else idle */
+static void s_closeOwner(void)
+{
+    const EXECUTION_TIME delta = s_close();
+
+    if (TX_NULL != s_owner) {
+        s_owner->tx_thread_execution_time_total += delta;
+    } else {
+        s_idleTime += delta;
+    }
+}
+
+VOID _tx_execution_initialize(VOID)
+{
+    DEMCR    |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+    s_stamp   = TX_EXECUTION_TIME_SOURCE;
+}
+
+/*--------------------------------------------------*/
+/* from the scheduler, _tx_thread_current_ptr is the thread about to run */
+VOID _tx_execution_thread_enter(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    s_closeOwner();
+    s_owner = _tx_thread_current_ptr;
+    if (TX_NULL != s_owner) {
+        s_owner->tx_thread_execution_time_last_start = s_stamp;
+    }
+    TX_RESTORE
+}
+
+/*--------------------------------------------------*/
+/* from the scheduler, the thread switched out: idle until the next enter */
+VOID _tx_execution_thread_exit(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    s_closeOwner();
+    s_owner = TX_NULL;
+    TX_RESTORE
+}
+
+/*--------------------------------------------------*/
+/* the outermost ISR opens its interval, a nested one is part of it */
+VOID _tx_execution_isr_enter(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    if (0U == s_isrNesting++) {
+        s_closeOwner();
+    }
+    TX_RESTORE
+}
+
+/*--------------------------------------------------*/
+VOID _tx_execution_isr_exit(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    if ((0U != s_isrNesting) && (0U == --s_isrNesting)) {
+        s_isrTime += s_close();
+    }
+    TX_RESTORE
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_thread_time_get(TX_THREAD *thread_ptr, EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if ((TX_NULL == thread_ptr) || (TX_NULL == total_time)) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    *total_time = thread_ptr->tx_thread_execution_time_total;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_thread_total_time_get(EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (TX_NULL == total_time) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    EXECUTION_TIME total  = 0U;
+    TX_THREAD     *thread = _tx_thread_created_ptr;
+    for (ULONG i = 0U; (i < _tx_thread_created_count) && (TX_NULL != thread); i++) {
+        total += thread->tx_thread_execution_time_total;
+        thread = thread->tx_thread_created_next;
+    }
+    *total_time = total;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_isr_time_get(EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (TX_NULL == total_time) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    *total_time = s_isrTime;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_idle_time_get(EXECUTION_TIME *total_time)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (TX_NULL == total_time) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    *total_time = s_idleTime;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_thread_time_reset(TX_THREAD *thread_ptr)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    if (TX_NULL == thread_ptr) {
+        return TX_PTR_ERROR;
+    }
+    TX_DISABLE
+    thread_ptr->tx_thread_execution_time_total = 0U;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_thread_total_time_reset(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    TX_THREAD *thread = _tx_thread_created_ptr;
+    for (ULONG i = 0U; (i < _tx_thread_created_count) && (TX_NULL != thread); i++) {
+        thread->tx_thread_execution_time_total = 0U;
+        thread = thread->tx_thread_created_next;
+    }
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_isr_time_reset(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    s_isrTime = 0U;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+/*--------------------------------------------------*/
+UINT _tx_execution_idle_time_reset(VOID)
+{
+    TX_INTERRUPT_SAVE_AREA
+
+    TX_DISABLE
+    s_idleTime = 0U;
+    TX_RESTORE
+    return TX_SUCCESS;
+}
+
+#endif /* defined(TX_EXECUTION_PROFILE_ENABLE) */
@@ -21,6 +21,9 @@
 #define TX_SEMAPHORE_ENABLE_PERFORMANCE_INFO
 #define TX_QUEUE_ENABLE_PERFORMANCE_INFO
 
+/* Execution profile (TX_EXECUTION_PROFILE_ENABLE): set by the CMake option USHELL_TX_PROFILE,
+   the hooks are in threadx_port/shared/tx_execution_profile.c */
+
 /* Disable preemption-threshold feature to save memory if unused */
 /* #define TX_DISABLE_PREEMPTION_THRESHOLD */
 
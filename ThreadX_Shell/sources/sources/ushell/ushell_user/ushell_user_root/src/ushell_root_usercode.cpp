@@ -1,10 +1,10 @@
 #include "ushell_core_printout.h"
 #include "ushell_core_settings.h"
 #include "ushell_core_utils.h"
+#include "tx_pools.h"
 
 #include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
 #include <string.h>
 
 /*
@@ -35,7 +35,7 @@ int vhexlify(void) {
 
 #define TEST_LEN 16U
     const uint8_t pu8InBuf[TEST_LEN] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
-    char *pstrOutBuf = (char *)malloc(TEST_LEN * 2 + 1);
+    char *pstrOutBuf = (char *)tx_scratch_alloc(TEST_LEN * 2 + 1);
 
     if (nullptr != pstrOutBuf) {
         for (unsigned int i = 0; i < TEST_LEN; ++i) {
@@ -44,10 +44,10 @@ int vhexlify(void) {
 
         hexlify(pu8InBuf, TEST_LEN, pstrOutBuf);
         uSHELL_PRINTF("result: [%s]\n", pstrOutBuf);
-        free(pstrOutBuf);
+        tx_scratch_free(pstrOutBuf);
         iRetVal = 0;
     } else {
-        uSHELL_PRINTF("malloc failed\n");
+        uSHELL_PRINTF("scratch alloc failed\n");
     }
 
     return iRetVal;
@@ -77,7 +77,7 @@ int sunhexlify(char *s) {
 
     size_t szLen = strlen(s);
     if (0 != szLen) {
-        uint8_t *pu8Buf = (uint8_t *)malloc(szLen / 2 + 1);
+        uint8_t *pu8Buf = (uint8_t *)tx_scratch_alloc(szLen / 2 + 1);
 
         if (nullptr != pu8Buf) {
             size_t szOutLen = 0;
@@ -90,9 +90,9 @@ int sunhexlify(char *s) {
             } else {
                 uSHELL_PRINTF("unhexlify failed (len || content)\n");
             }
-            free(pu8Buf);
+            tx_scratch_free(pu8Buf);
         } else {
-            uSHELL_PRINTF("malloc failed\n");
+            uSHELL_PRINTF("scratch alloc failed\n");
         }
     } else {
         uSHELL_PRINTF("empty string\n");
@@ -131,13 +131,78 @@ int sstest(char *s1, char *s2) {
 /*---------------------------------------------------------------*/
 int liotest(uint64_t l, uint32_t i, bool o) {
     uSHELL_PRINTF("--> liotest()\n");
-    uSHELL_PRINTF("l = %d\n", l);
+    uSHELL_PRINTF("l = %llu\n", (unsigned long long)l);
     uSHELL_PRINTF("i = %d\n", i);
     uSHELL_PRINTF("o = %d\n", o);
 
     return 0;
 }
 
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+/*---------------------------------------------------------------*/
+int rtest(strview_s r) {
+    uSHELL_PRINTF("--> rtest()\n");
+    uSHELL_PRINTF("r = ");
+    for (size_t i = 0; i < r.szLen; ++i) {
+        uSHELL_PRINTF("%c", r.pstr[i]);
+    }
+    uSHELL_PRINTF(" (len:%d)\n", (int)r.szLen);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+/*---------------------------------------------------------------*/
+int atest(numarray_s a) {
+    uSHELL_PRINTF("--> atest()\n");
+    for (size_t i = 0; i < a.szCount; ++i) {
+        uSHELL_PRINTF("a[%d] = %d\n", (int)i, a.pu32Items[i]);
+    }
+    uSHELL_PRINTF("(count:%d)\n", (int)a.szCount);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+/*---------------------------------------------------------------*/
+int xtest(hexbuf_s x) {
+    uSHELL_PRINTF("--> xtest()\n");
+    for (size_t i = 0; i < x.szLen; ++i) {
+        uSHELL_PRINTF("x[%d] = 0x%02X\n", (int)i, (unsigned int)x.pu8Data[i]);
+    }
+    uSHELL_PRINTF("(len:%d)\n", (int)x.szLen);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_HEX_BUFFERS) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+/*---------------------------------------------------------------*/
+int qtest(numq_t q) {
+    const uint32_t u32Magnitude = (q < 0) ? (0U - (uint32_t)q) : (uint32_t)q;
+    const uint32_t u32Frac = ((u32Magnitude & ((1U << uSHELL_FIXED_FRAC_BITS) - 1U)) * 10000U) >> uSHELL_FIXED_FRAC_BITS;
+    uSHELL_PRINTF("--> qtest()\n");
+    uSHELL_PRINTF("q = %s%u.%04u (raw:%x)\n", (q < 0) ? "-" : "", (unsigned)(u32Magnitude >> uSHELL_FIXED_FRAC_BITS), (unsigned)u32Frac, (unsigned)q);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED) */
+
+///////////////////////////////////////////////////////////////////
+//               PARAMETERS VALUES PROVIDERS                     //
+///////////////////////////////////////////////////////////////////
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+/*---------------------------------------------------------------*/
+const char *stest_values(int iIndex) {
+    static const char *const vstrValues[] = {"hello", "help", "world"};
+
+    return (iIndex < uSHELL_NR_ELEMS(vstrValues)) ? vstrValues[iIndex] : nullptr;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+
 ///////////////////////////////////////////////////////////////////
 //               USER SHORTCUTS HANDLERS                         //
 ///////////////////////////////////////////////////////////////////
@@ -155,4 +220,10 @@ void uShellUserHandleShortcut_Slash(const char *pstrArgs) {
 
 } /* uShellUserHandleShortcut_Slash() */
 
+/******************************************************************************/
+void uShellUserHandleShortcut_Bang(const char *pstrArgs) {
+    uSHELL_PRINTF("[!] hot shortcut registered but not implemented | args[%s]\n", pstrArgs);
+
+} /* uShellUserHandleShortcut_Bang() */
+
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
@@ -157,36 +157,57 @@ g_pfnVectors:
   .type   Reset_Handler, %function
 
 Reset_Handler:
-  /* 1. Copy .data section from Flash to SRAM */
+  /* 1. Copy .data section from Flash to SRAM, 16 bytes per ldm / stm      */
   ldr   r0, =_sdata          /* destination start (SRAM)                   */
-  ldr   r1, =_edata          /* destination end   (SRAM)                   */
-  ldr   r2, =_sidata         /* source start      (Flash, LMA)             */
-  movs  r3, #0
-  b     LoopCopyDataInit
+  ldr   r2, =_edata          /* destination end   (SRAM)                   */
+  ldr   r1, =_sidata         /* source start      (Flash, LMA)             */
+  subs  r2, r2, r0           /* bytes                                      */
+  subs  r2, r2, #16
+  blo   CopyDataTail
+
+CopyDataBlock:
+  ldmia r1!, {r3, r4, r5, r6}
+  stmia r0!, {r3, r4, r5, r6}
+  subs  r2, r2, #16
+  bhs   CopyDataBlock
 
-CopyDataInit:
-  ldr   r4, [r2, r3]
-  str   r4, [r0, r3]
-  adds  r3, r3, #4
+CopyDataTail:                /* the last 0..3 words                        */
+  adds  r2, r2, #12
+  blo   FillZerobssInit
 
-LoopCopyDataInit:
-  adds  r4, r0, r3
-  cmp   r4, r1
-  bcc   CopyDataInit
+CopyDataWord:
+  ldr   r3, [r1], #4
+  str   r3, [r0], #4
+  subs  r2, r2, #4
+  bhs   CopyDataWord
 
-  /* 2. Zero-fill .bss section */
-  ldr   r2, =_sbss
-  ldr   r4, =_ebss
+  /* 2. Zero-fill .bss section, 16 bytes per stm                           */
+FillZerobssInit:
+  ldr   r0, =_sbss
+  ldr   r2, =_ebss
+  subs  r2, r2, r0
   movs  r3, #0
-  b     LoopFillZerobss
+  movs  r4, #0
+  movs  r5, #0
+  movs  r6, #0
+  subs  r2, r2, #16
+  blo   FillZerobssTail
+
+FillZerobssBlock:
+  stmia r0!, {r3, r4, r5, r6}
+  subs  r2, r2, #16
+  bhs   FillZerobssBlock
+
+FillZerobssTail:
+  adds  r2, r2, #12
+  blo   FillZerobssDone
 
-FillZerobss:
-  str   r3, [r2]
-  adds  r2, r2, #4
+FillZerobssWord:
+  str   r3, [r0], #4
+  subs  r2, r2, #4
+  bhs   FillZerobssWord
 
-LoopFillZerobss:
-  cmp   r2, r4
-  bcc   FillZerobss
+FillZerobssDone:
 
   /* 3. Call SystemInit() to configure clocks / FPU */
   bl    SystemInit
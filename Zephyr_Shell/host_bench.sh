@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# Host run of the shell, no board in the loop: build for native_sim (or qemu_cortex_m3), start
+# it on its PTY and measure the command round trip and the echo with bench_matrix.py. Two runs,
+# before and after a change of ushell_core, side by side:
+#
+#   ./host_bench.sh native_sim before
+#   ./host_bench.sh native_sim after
+#   python3 ../ushell_core/tools/bench_matrix.py table build_host/before.json build_host/after.json
+#
+# The times are the host's (native_sim) or QEMU's, compare runs of the same machine only.
+
+BOARD=${1:-native_sim}
+NAME=${2:-${BOARD}}
+OUT=$(pwd)/build_host
+BUILD=${OUT}/${BOARD}
+TOOLS=$(pwd)/../ushell_core/tools
+
+trap 'trap - EXIT && kill -- -$$ 2>/dev/null' EXIT
+
+case ${BOARD} in
+    native_sim*)
+        west build -p always -b ${BOARD} -d ${BUILD} || exit 1
+        ${BUILD}/zephyr/zephyr.exe > ${BUILD}/run.log 2>&1 &
+        ;;
+    qemu_cortex_m3)
+        west build -p always -b ${BOARD} -d ${BUILD} -- -DQEMU_PTY=1 || exit 1
+        west build -d ${BUILD} -t run > ${BUILD}/run.log 2>&1 &
+        ;;
+    *)
+        echo "host_bench: native_sim or qemu_cortex_m3"
+        exit 1
+        ;;
+esac
+
+# "uart connected to pseudotty: /dev/pts/N" (native_sim), "char device redirected to /dev/pts/N" (QEMU)
+PTY=
+for i in $(seq 100); do
+    PTY=$(grep -o '/dev/pts/[0-9]*' ${BUILD}/run.log 2>/dev/null | head -1)
+    [[ -n ${PTY} ]] && break
+    sleep 0.1
+done
+if [[ -z ${PTY} ]]; then
+    echo "host_bench: no PTY in ${BUILD}/run.log"
+    exit 1
+fi
+
+python3 ${TOOLS}/bench_matrix.py run ${PTY} --target ${NAME} --language cpp -o ${OUT}/${NAME}.json
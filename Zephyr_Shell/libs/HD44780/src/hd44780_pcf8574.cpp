@@ -9,8 +9,11 @@
  *   ─────────────────────────────────────────────────────
  *   I2C_HandleTypeDef / HAL_I2C_*  →  struct device + i2c_write()
  *   HAL_I2C_MspInit (GPIO/clocks)  →  devicetree (automatic)
- *   tx_thread_sleep()              →  k_msleep()
- *   uSHELL_PRINTF / HAL guards     →  printk / printk  (Zephyr logging)
+ *   tx_thread_sleep()              →  k_usleep() / k_busy_wait()
+ *   uSHELL_PRINTF / HAL guards     →  printk / LOG_ERR  (Zephyr logging)
+ *
+ * The bytes of a whole update are queued and written in one i2c_write()
+ * (see the header); nothing is logged per transfer.
  */
 
 #include "hd44780_pcf8574.h"
@@ -20,7 +23,7 @@
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/logging/log.h>
 
-LOG_MODULE_REGISTER(hd44780, LOG_LEVEL_DBG);
+LOG_MODULE_REGISTER(hd44780, LOG_LEVEL_INF);
 
 /* ── HD44780 instruction set ─────────────────────────────────────────────── */
 #define HD_CLEARDISPLAY   0x01
@@ -41,12 +44,27 @@ LOG_MODULE_REGISTER(hd44780, LOG_LEVEL_DBG);
 #define HD_2LINE          0x08
 #define HD_5x8DOTS        0x00
 
+/* HD44780U datasheet, fosc 270 kHz (the slowest one); the other commands take
+ * 37 us, less than the next nibble's three bytes at 100 kHz */
+#define HD_POWERUP_US     40000UL     /* Vcc above 2.7 V */
+#define HD_RESET1_US      4100UL      /* after the 1st 0x30 */
+#define HD_RESET2_US      100UL       /* after the 2nd and 3rd 0x30 */
+#define HD_CLEAR_US       1520UL      /* clear display, return home */
+
 static const uint8_t ROW_OFFSETS[] = { 0x00, 0x40, 0x14, 0x54 };
 
 /* ── Delay helper ────────────────────────────────────────────────────────── */
-static inline void lcd_delay_ms(uint32_t ms)
+/*
+ * Wait at least us, counted from the end of the transfer: the thread sleeps
+ * from a millisecond up (k_usleep rounds up to ticks), a spin below.
+ */
+static void lcd_wait_us(uint32_t us)
 {
-    k_msleep(ms);
+    if (us >= 1000UL) {
+        k_usleep((int32_t)us);
+    } else {
+        k_busy_wait(us);
+    }
 }
 
 /* ── Constructor ─────────────────────────────────────────────────────────── */
@@ -57,36 +75,49 @@ HD44780_PCF8574::HD44780_PCF8574(uint8_t i2c_address, uint8_t cols, uint8_t rows
       _backlight(LCD_BL),
       _displayCtrl(HD_DISPLAY_ON),
       _i2c_ok(false),
-      _i2c_dev(nullptr)
+      _i2c_dev(nullptr),
+      _len(0)
 {}
 
-/* ── Low-level I2C byte write ────────────────────────────────────────────── */
-bool HD44780_PCF8574::i2c_write_byte(uint8_t data)
+/* ── I2C byte queue ──────────────────────────────────────────────────────── */
+void HD44780_PCF8574::i2c_put(uint8_t data)
 {
-    if (!_i2c_dev) return false;
+    if (_len == sizeof(_buf)) {
+        i2c_flush();
+    }
+    _buf[_len++] = data;
+}
 
-    /*
-     * i2c_write(dev, buf, len, addr) — Zephyr takes the 7-bit address
-     * directly; no manual left-shift needed (unlike HAL).
-     */
-    int ret = i2c_write(_i2c_dev, &data, 1, _addr);
-    _i2c_ok = (ret == 0);
+/*
+ * One transaction for the queued bytes. i2c_write(dev, buf, len, addr) takes
+ * the 7-bit address directly; with CONFIG_I2C_STM32_INTERRUPT the thread
+ * sleeps until the STOP.
+ */
+bool HD44780_PCF8574::i2c_flush(void)
+{
+    if (_len == 0) {
+        return _i2c_ok;
+    }
+    if (!_i2c_dev) {
+        _len = 0;
+        return false;
+    }
+    _i2c_ok = (0 == i2c_write(_i2c_dev, _buf, _len, _addr));
+    _len = 0;
     return _i2c_ok;
 }
 
 /* ── EN strobe ───────────────────────────────────────────────────────────── */
 void HD44780_PCF8574::lcd_pulse_enable(uint8_t data)
 {
-    i2c_write_byte(data | LCD_EN);
-    lcd_delay_ms(5);
-    i2c_write_byte(data & ~LCD_EN);
-    lcd_delay_ms(5);
+    i2c_put(data | LCD_EN);
+    i2c_put(data & ~LCD_EN);
 }
 
 /* ── Send one nibble ─────────────────────────────────────────────────────── */
 void HD44780_PCF8574::lcd_write4bits(uint8_t nibble)
 {
-    i2c_write_byte(nibble | _backlight);
+    i2c_put(nibble | _backlight);
     lcd_pulse_enable(nibble | _backlight);
 }
 
@@ -102,6 +133,7 @@ void HD44780_PCF8574::lcd_send(uint8_t value, uint8_t mode)
 void HD44780_PCF8574::command(uint8_t cmd)
 {
     lcd_send(cmd, 0);
+    i2c_flush();
 }
 
 /* ── Public API ──────────────────────────────────────────────────────────── */
@@ -118,45 +150,47 @@ bool HD44780_PCF8574::init(void)
     printk("LCD: HD44780_PCF8574::init()\n");
 
     if (!device_is_ready(_i2c_dev)) {
-        printk("LCD: I2C bus not ready\n");
+        LOG_ERR("I2C bus not ready");
         _i2c_ok = false;
         return false;
     }
 
-    lcd_delay_ms(10);
+    /* Vcc came up with the MCU: only the rest of the power up time */
+    const int64_t up_us = k_ticks_to_us_floor64(k_uptime_ticks());
+    if (up_us < (int64_t)HD_POWERUP_US) {
+        lcd_wait_us((uint32_t)(HD_POWERUP_US - up_us));
+    }
 
     /* Probe — send backlight byte and check ACK */
-    if (!i2c_write_byte(_backlight)) {
-        printk("LCD: probe FAIL (no ACK at 0x%02X)\n", _addr);
+    _len = 0;
+    i2c_put(_backlight);
+    if (!i2c_flush()) {
+        LOG_ERR("probe FAIL (no ACK at 0x%02X)", _addr);
         return false;
     }
 
     printk("LCD: probe OK at 0x%02X\n", _addr);
-    lcd_delay_ms(10);
 
     /* 3-step reset sequence (HD44780 datasheet §4.4) */
-    lcd_write4bits(0x30); lcd_delay_ms(10);
-    lcd_write4bits(0x30); lcd_delay_ms(5);
-    lcd_write4bits(0x30); lcd_delay_ms(5);
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET1_US);
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET2_US);
+    lcd_write4bits(0x30); i2c_flush(); lcd_wait_us(HD_RESET2_US);
 
     /* Switch to 4-bit mode */
     lcd_write4bits(0x20);
-    lcd_delay_ms(5);
+    i2c_flush();
 
     /* Function set: 4-bit, 2-line, 5×8 dots */
     command(HD_FUNCTIONSET | HD_4BITMODE | HD_2LINE | HD_5x8DOTS);
-    lcd_delay_ms(5);
 
     /* Display on, cursor off, blink off */
     _displayCtrl = HD_DISPLAY_ON;
     command(HD_DISPLAYCONTROL | _displayCtrl);
-    lcd_delay_ms(5);
 
     clear();
 
     /* Entry mode: left-to-right, no shift */
     command(HD_ENTRYMODESET | HD_ENTRY_LEFT | HD_ENTRY_SHIFTDEC);
-    lcd_delay_ms(5);
 
     printk("LCD: init done\n");
     return _i2c_ok;
@@ -165,36 +199,46 @@ bool HD44780_PCF8574::init(void)
 void HD44780_PCF8574::clear(void)
 {
     command(HD_CLEARDISPLAY);
-    lcd_delay_ms(10);
+    lcd_wait_us(HD_CLEAR_US);
 }
 
 void HD44780_PCF8574::home(void)
 {
     command(HD_RETURNHOME);
-    lcd_delay_ms(10);
+    lcd_wait_us(HD_CLEAR_US);
 }
 
 void HD44780_PCF8574::setCursor(uint8_t col, uint8_t row)
 {
     if (row >= _rows) row = _rows - 1;
     if (col >= _cols) col = _cols - 1;
-    command(HD_SETDDRAMADDR | (col + ROW_OFFSETS[row]));
+    lcd_send(HD_SETDDRAMADDR | (col + ROW_OFFSETS[row]), 0);   /* queued, see header */
 }
 
 void HD44780_PCF8574::write(char c)
 {
     lcd_send(static_cast<uint8_t>(c), LCD_RS);
+    i2c_flush();
 }
 
+/* The whole string in one transaction (after a queued cursor move) */
 void HD44780_PCF8574::print(const char *str)
 {
-    while (*str) write(*str++);
+    while (*str) lcd_send(static_cast<uint8_t>(*str++), LCD_RS);
+    i2c_flush();
+}
+
+void HD44780_PCF8574::print(const char *buf, uint8_t len)
+{
+    while (len--) lcd_send(static_cast<uint8_t>(*buf++), LCD_RS);
+    i2c_flush();
 }
 
 void HD44780_PCF8574::setBacklight(bool on)
 {
     _backlight = on ? LCD_BL : 0;
-    i2c_write_byte(_backlight);
+    i2c_put(_backlight);
+    i2c_flush();
 }
 
 void HD44780_PCF8574::displayOn(bool on)
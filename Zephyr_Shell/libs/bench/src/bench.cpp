@@ -0,0 +1,305 @@
+/**
+ * @file bench.cpp
+ * @brief shell command bench — Zephyr backend
+ *
+ * On-target microbenchmarks in DWT cycles, built with -DUSHELL_BENCH=ON
+ * (BENCH 1): the rows of the FreeRTOS and ThreadX shells the kernel has,
+ * same names and columns (ushell_core/tools/bench_matrix.py compares them).
+ *
+ *   bench 0         every benchmark, one line each
+ *   bench <n>       only the n-th
+ *
+ * Each benchmark runs BENCH_SAMPLES times from the shell thread; min, median
+ * and max cycles, less the cost of reading the counter twice.
+ *
+ *   queue round trip   k_msgq_put() to an echo thread of higher priority and
+ *                      k_msgq_get() of its answer: two switches, two copies
+ *   ctx switch         k_sem_give() to a thread of higher priority until it
+ *                      runs: the give and one switch
+ *   irq->task          a software pended IRQ (SPI2, no SPI driver in the
+ *                      build) whose handler gives the same semaphore, until
+ *                      the thread runs: entry, handler, switch
+ *
+ * The threads, the queues and the semaphore are static; the IRQ is connected
+ * and the cycle counter started at SYS_INIT. Without BENCH the command only
+ * says so.
+ */
+
+#include "ushell_core_printout.h"
+
+#include <stdint.h>
+
+#if defined(BENCH) && (BENCH == 1)
+#include "ushell_core.h"
+#include "ushell_core_utils.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/irq.h>
+#include <cmsis_core.h>
+
+#define BENCH_SAMPLES       31U     /* odd: the median is a sample */
+#define BENCH_THREAD_STACK  512U
+#define BENCH_THREAD_PRIO   2       /* above the shell thread (6): the put switches at once */
+#define BENCH_IRQ           SPI2_IRQn
+#define BENCH_IRQ_PRIO      2U
+#define BENCH_REPLY         K_MSEC(100)
+
+#define BENCH_START()       const uint32_t u32BenchStart = DWT->CYCCNT
+#define BENCH_STOP()        (DWT->CYCCNT - u32BenchStart)
+
+typedef struct {
+    const char *pstrName;
+    bool (*pfRun)(uint32_t *pu32Cycles);    /* one sample, false if it could not be taken */
+} bench_s;
+
+static uint32_t s_au32Samples[BENCH_SAMPLES];
+static uint32_t s_u32Overhead = 0U;
+static volatile uint32_t s_u32Sink;         /* the results of the pure functions are kept */
+static volatile uint32_t s_u32WakeStamp;    /* CYCCNT of the give or of the pend */
+
+K_MSGQ_DEFINE(s_sPing, sizeof(uint32_t), 1, 4);
+K_MSGQ_DEFINE(s_sPong, sizeof(uint32_t), 1, 4);    /* the answers of the echo and wake threads */
+K_SEM_DEFINE(s_sWake, 0, 1);
+
+
+/*--------------------------------------------------*/
+static void s_echo_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+    uint32_t u32Value;
+
+    for (;;) {
+        if (0 == k_msgq_get(&s_sPing, &u32Value, K_FOREVER)) {
+            (void)k_msgq_put(&s_sPong, &u32Value, K_FOREVER);
+        }
+    }
+}
+
+/* woken by a give of the shell thread or of the bench IRQ, answers the cycles since */
+static void s_wake_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+
+    for (;;) {
+        if (0 == k_sem_take(&s_sWake, K_FOREVER)) {
+            const uint32_t u32Cycles = DWT->CYCCNT - s_u32WakeStamp;
+            (void)k_msgq_put(&s_sPong, &u32Cycles, K_NO_WAIT);
+        }
+    }
+}
+
+K_THREAD_DEFINE(s_tBenchEcho, BENCH_THREAD_STACK, s_echo_thread, NULL, NULL, NULL, BENCH_THREAD_PRIO, 0, 0);
+K_THREAD_DEFINE(s_tBenchWake, BENCH_THREAD_STACK, s_wake_thread, NULL, NULL, NULL, BENCH_THREAD_PRIO, 0, 0);
+
+/*--------------------------------------------------*/
+static void s_bench_isr(const void *arg)
+{
+    ARG_UNUSED(arg);
+    k_sem_give(&s_sWake);
+}
+
+static int s_bench_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    IRQ_CONNECT(BENCH_IRQ, BENCH_IRQ_PRIO, s_bench_isr, NULL, 0);
+    irq_enable(BENCH_IRQ);
+    return 0;
+}
+
+SYS_INIT(s_bench_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+
+/*--------------------------------------------------*/
+static bool s_asc2int_hex(uint32_t *pu32Cycles)
+{
+    BIGNUM_T number = 0;
+    BENCH_START();
+    const bool bOk = asc2int("0x1234ABCD", &number);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)number;
+    return bOk;
+}
+
+static bool s_asc2int_dec(uint32_t *pu32Cycles)
+{
+    BIGNUM_T number = 0;
+    BENCH_START();
+    const bool bOk = asc2int("4294967295", &number);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)number;
+    return bOk;
+}
+
+static const uint8_t s_au8Bytes[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+
+static bool s_hexlify(uint32_t *pu32Cycles)
+{
+    char acHex[(2U * sizeof(s_au8Bytes)) + 1U];
+    BENCH_START();
+    hexlify(s_au8Bytes, sizeof(s_au8Bytes), acHex);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = (uint32_t)acHex[0];
+    return true;
+}
+
+static bool s_unhexlify(uint32_t *pu32Cycles)
+{
+    uint8_t au8Bytes[sizeof(s_au8Bytes)];
+    size_t szLen = 0U;
+    BENCH_START();
+    const bool bOk = unhexlify("00112233445566778899aabbccddeeff", au8Bytes, &szLen);
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = au8Bytes[0];
+    return bOk;
+}
+
+static bool s_strtok_ex(uint32_t *pu32Cycles)
+{
+    char acLine[] = "bench 1 0x20 text";    /* strtok_ex() writes into it, a copy per sample */
+    char *pstrSave = NULL;
+    uint32_t u32Tokens = 0U;
+    BENCH_START();
+    for (char *pstrTok = strtok_ex(acLine, " ", &pstrSave); NULL != pstrTok; pstrTok = strtok_ex(NULL, " ", &pstrSave)) {
+        u32Tokens++;
+    }
+    *pu32Cycles = BENCH_STOP();
+    s_u32Sink = u32Tokens;
+    return (4U == u32Tokens);
+}
+
+/* the shell is already up: it is the caller */
+static bool s_lookup_hit(uint32_t *pu32Cycles)
+{
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+    BENCH_START();
+    const int iIndex = pShell->FindCommand("bench");
+    *pu32Cycles = BENCH_STOP();
+    return (iIndex >= 0);
+}
+
+static bool s_lookup_miss(uint32_t *pu32Cycles)
+{
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+    BENCH_START();
+    const int iIndex = pShell->FindCommand("nosuchcmd");
+    *pu32Cycles = BENCH_STOP();
+    return (uSHELL_ERR_FUNCTION_NOT_FOUND == iIndex);
+}
+
+static bool s_queue_round_trip(uint32_t *pu32Cycles)
+{
+    uint32_t u32Value = 0U;
+    BENCH_START();
+    (void)k_msgq_put(&s_sPing, &u32BenchStart, K_FOREVER);
+    const int iRet = k_msgq_get(&s_sPong, &u32Value, BENCH_REPLY);
+    *pu32Cycles = BENCH_STOP();
+    return (0 == iRet) && (u32Value == u32BenchStart);
+}
+
+/* the cycles are the wake thread's, measured when it runs */
+static bool s_ctx_switch(uint32_t *pu32Cycles)
+{
+    s_u32WakeStamp = DWT->CYCCNT;
+    k_sem_give(&s_sWake);
+    return (0 == k_msgq_get(&s_sPong, pu32Cycles, BENCH_REPLY));
+}
+
+static bool s_irq_to_task(uint32_t *pu32Cycles)
+{
+    s_u32WakeStamp = DWT->CYCCNT;
+    NVIC_SetPendingIRQ(BENCH_IRQ);
+    return (0 == k_msgq_get(&s_sPong, pu32Cycles, BENCH_REPLY));
+}
+
+static const bench_s s_asBenches[] = {
+    { "asc2int hex",        s_asc2int_hex      },
+    { "asc2int dec",        s_asc2int_dec      },
+    { "hexlify 16B",        s_hexlify          },
+    { "unhexlify 16B",      s_unhexlify        },
+    { "strtok_ex 4 tok",    s_strtok_ex        },
+    { "lookup hit",         s_lookup_hit       },
+    { "lookup miss",        s_lookup_miss      },
+    { "queue round trip",   s_queue_round_trip },
+    { "ctx switch",         s_ctx_switch       },
+    { "irq->task",          s_irq_to_task      },
+};
+
+#define BENCH_COUNT     (sizeof(s_asBenches) / sizeof(s_asBenches[0]))
+
+/*--------------------------------------------------*/
+/* two reads of the counter back to back, taken off every sample */
+static void s_calibrate(void)
+{
+    s_u32Overhead = UINT32_MAX;
+    for (uint32_t i = 0U; i < 8U; i++) {
+        BENCH_START();
+        const uint32_t u32Cycles = BENCH_STOP();
+        if (u32Cycles < s_u32Overhead) {
+            s_u32Overhead = u32Cycles;
+        }
+    }
+}
+
+static void s_sort(uint32_t *pu32Values, uint32_t u32Count)
+{
+    for (uint32_t i = 1U; i < u32Count; i++) {
+        const uint32_t u32Value = pu32Values[i];
+        uint32_t j = i;
+        while ((j > 0U) && (pu32Values[j - 1U] > u32Value)) {
+            pu32Values[j] = pu32Values[j - 1U];
+            j--;
+        }
+        pu32Values[j] = u32Value;
+    }
+}
+
+static void s_run(uint32_t u32Index)
+{
+    const bench_s &sBench = s_asBenches[u32Index];
+
+    for (uint32_t i = 0U; i < BENCH_SAMPLES; i++) {
+        uint32_t u32Cycles = 0U;
+        if (false == sBench.pfRun(&u32Cycles)) {
+            uSHELL_PRINTF("\r%2u %-18s %8s\n", (unsigned)(u32Index + 1U), sBench.pstrName, "failed");
+            return;
+        }
+        s_au32Samples[i] = (u32Cycles > s_u32Overhead) ? (u32Cycles - s_u32Overhead) : 0U;
+    }
+    s_sort(s_au32Samples, BENCH_SAMPLES);
+
+    uSHELL_PRINTF("\r%2u %-18s %8u %8u %8u\n", (unsigned)(u32Index + 1U), sBench.pstrName,
+                  (unsigned)s_au32Samples[0], (unsigned)s_au32Samples[BENCH_SAMPLES / 2U],
+                  (unsigned)s_au32Samples[BENCH_SAMPLES - 1U]);
+}
+#endif /*defined(BENCH) && (BENCH == 1)*/
+
+/*--------------------------------------------------*/
+/* bench 0 runs every benchmark, bench n only the n-th */
+extern "C" int bench(uint32_t u32Index)
+{
+#if defined(BENCH) && (BENCH == 1)
+    if (u32Index > BENCH_COUNT) {
+        uSHELL_PRINTF("bench: 1..%u, 0 for all\n", (unsigned)BENCH_COUNT);
+        return -1;
+    }
+
+    s_calibrate();
+    uSHELL_PRINTF("%2s %-18s %8s %8s %8s  (cycles at %u MHz, %u samples)\n", "#", "bench",
+                  "min", "median", "max", (unsigned)(sys_clock_hw_cycles_per_sec() / 1000000U),
+                  (unsigned)BENCH_SAMPLES);
+    for (uint32_t i = 0U; i < BENCH_COUNT; i++) {
+        if ((0U == u32Index) || ((u32Index - 1U) == i)) {
+            s_run(i);
+        }
+    }
+#else
+    (void)u32Index;
+    uSHELL_PRINTF("bench: built with BENCH 0\n");
+#endif /*defined(BENCH) && (BENCH == 1)*/
+    return 0;
+}
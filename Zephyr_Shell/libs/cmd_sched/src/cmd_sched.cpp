@@ -0,0 +1,190 @@
+/**
+ * @file cmd_sched.cpp
+ * @brief shell commands every / sched — Zephyr backend
+ *
+ * Periodic shell commands: a command line parsed once and run again every
+ * N ms on target, the link carries its output only instead of a command and
+ * a parse per poll. Same commands and tagged lines as the FreeRTOS and
+ * ThreadX shells.
+ *
+ *   every 500 "work"    run work every 500 ms, in the first free slot
+ *   sched 0             the slots: period, runs, overruns, last result, line
+ *   sched <n>           stop the n-th
+ *
+ * every parses the line with Microshell::Prepare() into the slot (the line
+ * is kept with it, its strings point there) and starts a k_timer of its own.
+ * The expiry runs in the interrupt: it only sets the bit of its slot and
+ * gives the semaphore of the scheduler thread, which calls
+ * Microshell::RunPrepared(). A period which comes while the bit of the last
+ * one is still set is an overrun (counted, the run is not queued twice).
+ * Each run is framed by two tagged lines for the host:
+ *
+ *   @<slot> <run>
+ *   <the output of the command>
+ *   @<slot> => <result>
+ *
+ * The scheduler thread has the priority of the shell thread. The commands
+ * run while the shell takes other lines, so the ones to poll with are those
+ * which read a state (sysinfo, work, zbus); a command which reads the
+ * console itself is not for a slot. The timers are set up at SYS_INIT.
+ */
+
+#include "ushell_core.h"
+#include "ushell_core_printout.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/atomic.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#define CMD_SCHED_SLOTS         3U
+#define CMD_SCHED_MIN_MS        10U     /* the shortest period */
+#define CMD_SCHED_THREAD_STACK  1024U
+#define CMD_SCHED_THREAD_PRIO   6       /* the shell thread's */
+
+typedef struct {
+    preparedCmd_s   sCmd;               /* the line and its parse */
+    struct k_timer  sTimer;
+    uint32_t        u32PeriodMs;        /* 0: free */
+    uint32_t        u32Runs;
+    uint32_t        u32Overruns;        /* periods while the last run waited for the thread */
+    int             iLastResult;
+} cmd_sched_slot_s;
+
+static cmd_sched_slot_s s_asSlots[CMD_SCHED_SLOTS];
+static atomic_t s_aPending = ATOMIC_INIT(0);
+
+K_SEM_DEFINE(s_sSchedWake, 0, 1);
+
+
+/*--------------------------------------------------*/
+/* the parse left a NUL after each token of the line, they are printed with a space */
+static void s_print_line(const preparedCmd_s *psCmd)
+{
+    size_t szEnd = sizeof(psCmd->vstrLine);
+    while ((szEnd > 0U) && ('\0' == psCmd->vstrLine[szEnd - 1U])) {
+        szEnd--;
+    }
+    for (size_t i = 0U; i < szEnd; i += strlen(&psCmd->vstrLine[i]) + 1U) {
+        if ('\0' != psCmd->vstrLine[i]) {
+            uSHELL_PRINTF("%s ", &psCmd->vstrLine[i]);
+        }
+    }
+    uSHELL_PRINTF("\n");
+}
+
+/*--------------------------------------------------*/
+/* interrupt: the bit of the slot, the run is the scheduler thread's */
+static void s_timer_expiry(struct k_timer *psTimer)
+{
+    const uint32_t u32Slot = (uint32_t)(uintptr_t)k_timer_user_data_get(psTimer);
+    const atomic_val_t aOld = atomic_or(&s_aPending, (atomic_val_t)(1UL << u32Slot));
+
+    if (0 != (aOld & (atomic_val_t)(1UL << u32Slot))) {
+        s_asSlots[u32Slot].u32Overruns++;
+    }
+    k_sem_give(&s_sSchedWake);
+}
+
+/*--------------------------------------------------*/
+static void s_sched_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+    Microshell *pShell = Microshell::getShellPtr(NULL, NULL);
+
+    for (;;) {
+        (void)k_sem_take(&s_sSchedWake, K_FOREVER);
+        const atomic_val_t aBits = atomic_clear(&s_aPending);
+
+        for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+            cmd_sched_slot_s *psSlot = &s_asSlots[i];
+
+            /* stopped between the period and the run */
+            if ((0 == (aBits & (atomic_val_t)(1UL << i))) || (0U == psSlot->u32PeriodMs)) {
+                continue;
+            }
+            psSlot->u32Runs++;
+            uSHELL_PRINTF("\r@%u %u\n", (unsigned)(i + 1U), (unsigned)psSlot->u32Runs);
+            psSlot->iLastResult = pShell->RunPrepared(&psSlot->sCmd);
+            uSHELL_PRINTF("\r@%u => %d\n", (unsigned)(i + 1U), psSlot->iLastResult);
+        }
+    }
+}
+
+K_THREAD_DEFINE(s_tCmdSched, CMD_SCHED_THREAD_STACK, s_sched_thread, NULL, NULL, NULL, CMD_SCHED_THREAD_PRIO, 0, 0);
+
+/*--------------------------------------------------*/
+static int s_cmd_sched_init(void)
+{
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        k_timer_init(&s_asSlots[i].sTimer, s_timer_expiry, NULL);
+        k_timer_user_data_set(&s_asSlots[i].sTimer, (void *)(uintptr_t)i);
+    }
+    return 0;
+}
+
+SYS_INIT(s_cmd_sched_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+
+// -- shell commands ----------------------------------------------------------
+
+/* every <ms> "<command>": the slot taken, or the parse error of the line */
+extern "C" int every(uint32_t u32PeriodMs, char *pstrCommand)
+{
+    if (u32PeriodMs < CMD_SCHED_MIN_MS) {
+        uSHELL_PRINTF("every: %u ms at least\n", (unsigned)CMD_SCHED_MIN_MS);
+        return -1;
+    }
+
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        cmd_sched_slot_s *psSlot = &s_asSlots[i];
+        if (0U != psSlot->u32PeriodMs) {
+            continue;
+        }
+
+        const int iRetVal = Microshell::getShellPtr(NULL, NULL)->Prepare(pstrCommand, &psSlot->sCmd);
+        if (uSHELL_ERR_OK != iRetVal) {
+            uSHELL_PRINTF("every: \"%s\" does not parse (%d)\n", pstrCommand, iRetVal);
+            return iRetVal;
+        }
+        psSlot->u32Runs     = 0U;
+        psSlot->u32Overruns = 0U;
+        psSlot->iLastResult = 0;
+        psSlot->u32PeriodMs = u32PeriodMs;
+        k_timer_start(&psSlot->sTimer, K_MSEC(u32PeriodMs), K_MSEC(u32PeriodMs));
+        uSHELL_PRINTF("every: slot %u, each %u ms: ", (unsigned)(i + 1U), (unsigned)u32PeriodMs);
+        s_print_line(&psSlot->sCmd);
+        return (int)(i + 1U);
+    }
+    uSHELL_PRINTF("every: the %u slots are taken (sched <n> stops one)\n", (unsigned)CMD_SCHED_SLOTS);
+    return -1;
+}
+
+/* sched 0 lists the slots, sched n stops the n-th */
+extern "C" int sched(uint32_t u32Slot)
+{
+    if (u32Slot > CMD_SCHED_SLOTS) {
+        uSHELL_PRINTF("sched: 1..%u, 0 for the list\n", (unsigned)CMD_SCHED_SLOTS);
+        return -1;
+    }
+
+    if (0U != u32Slot) {
+        cmd_sched_slot_s *psSlot = &s_asSlots[u32Slot - 1U];
+        k_timer_stop(&psSlot->sTimer);
+        psSlot->u32PeriodMs = 0U;
+        return 0;
+    }
+
+    uSHELL_PRINTF("%2s %8s %8s %8s %6s  %s\n", "#", "ms", "runs", "overrun", "result", "command");
+    for (uint32_t i = 0U; i < CMD_SCHED_SLOTS; i++) {
+        const cmd_sched_slot_s *psSlot = &s_asSlots[i];
+        if (0U != psSlot->u32PeriodMs) {
+            uSHELL_PRINTF("%2u %8u %8u %8u %6d  ", (unsigned)(i + 1U), (unsigned)psSlot->u32PeriodMs,
+                          (unsigned)psSlot->u32Runs, (unsigned)psSlot->u32Overruns, psSlot->iLastResult);
+            s_print_line(&psSlot->sCmd);
+        }
+    }
+    return 0;
+}
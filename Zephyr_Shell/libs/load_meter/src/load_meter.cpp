@@ -0,0 +1,180 @@
+/**
+ * @file load_meter.cpp
+ * @brief shell command load — Zephyr backend
+ *
+ * CPU load from an idle count, the same command as on ThreadX: no timer of
+ * its own and no thread runtime stats of the kernel (CONFIG_SCHED_THREAD_USAGE).
+ *
+ *   load 0      the load of the last second, the 10 s and 60 s averages
+ *   load 1      the same, and the load of each second on the LCD
+ *   load 2      the LCD line off
+ *
+ * A thread of the lowest application priority counts the turns of its loop,
+ * each one reads the uptime and yields to the threads of that priority (the
+ * log thread is there). The first second after the start is the calibration:
+ * the turns of a second with nothing else to run; a later second which counts
+ * more raises it, the start was not idle. The load of a second is the part of
+ * the turns it lost, the seconds the thread did not run at all count as
+ * loaded in full.
+ *
+ * The 10 s and 60 s averages are exponential ones, as the load averages of
+ * Unix, in fixed point: a second adds (1 - e^(-1/10)) and (1 - e^(-1/60)) of
+ * its difference. The loop keeps the core out of the idle thread and its WFI.
+ * The LCD line is the one of LCD_Post() (src/main.cpp), weak: none without
+ * ENABLE_LCD.
+ */
+
+#include "ushell_core_printout.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+#include <stdint.h>
+
+#define LOAD_METER_THREAD_STACK 512U
+#define LOAD_METER_THREAD_PRIO  K_LOWEST_APPLICATION_THREAD_PRIO
+
+/* (1 - e^(-1/n)) * 1024: the part of the difference a second adds to the n s average */
+#define LOAD_METER_A10          97
+#define LOAD_METER_A60          17
+#define LOAD_METER_SECONDS_MAX  300U    /* the 60 s average has settled after a gap this long */
+
+void LCD_Post(uint8_t row, uint8_t col, const char *text) __attribute__((weak));
+
+static struct k_spinlock s_sLock;
+static bool s_bLcd = false;
+
+/* by the load thread, read by the shell under s_sLock */
+static uint32_t s_u32Calib   = 0U;      /* turns in an idle second, 0 before the first one */
+static uint32_t s_u32Turns   = 0U;      /* of the last second */
+static uint32_t s_u32Load    = 0U;      /* of the last second, per mille */
+static int32_t  s_i32Avg10   = 0;       /* per mille << 10 */
+static int32_t  s_i32Avg60   = 0;
+static uint32_t s_u32Seconds = 0U;      /* since the calibration */
+
+
+/*--------------------------------------------------*/
+static void s_average(int32_t *pi32Avg, int32_t i32Sample, int32_t i32Alpha)
+{
+    *pi32Avg += (((i32Sample << 10) - *pi32Avg) * i32Alpha) / 1024;
+}
+
+/*--------------------------------------------------*/
+/* "Load  12.3 %    ", the 16 characters of the line, in the place of "System Ready" */
+static void s_show(uint32_t u32Permille)
+{
+    char vstrLine[17] = "Load   0.0 %    ";
+
+    vstrLine[9] = (char)('0' + (u32Permille % 10U));
+    u32Permille /= 10U;
+    for (uint32_t i = 7U; (i >= 5U); i--) {
+        vstrLine[i] = (char)('0' + (u32Permille % 10U));
+        u32Permille /= 10U;
+        if (0U == u32Permille) {
+            break;
+        }
+    }
+    LCD_Post(0, 0, vstrLine);
+}
+
+/*--------------------------------------------------*/
+/* the turns of u32Seconds (more than one: the thread did not run in between) */
+static void s_second(uint32_t u32Turns, uint32_t u32Seconds)
+{
+    const uint32_t u32PerSecond = u32Turns / u32Seconds;
+    uint32_t u32Calib = s_u32Calib;
+    bool bFirst = false;
+
+    if (u32PerSecond > u32Calib) {
+        bFirst   = (0U == u32Calib);
+        u32Calib = u32PerSecond;
+    }
+    const uint64_t u64Full = (uint64_t)u32Calib * u32Seconds;
+    const uint64_t u64Idle = (((uint64_t)u32Turns * 1000U) + (u64Full / 2U)) / u64Full;
+    const uint32_t u32Load = (u64Idle < 1000U) ? (1000U - (uint32_t)u64Idle) : 0U;
+
+    /* the averages are this thread's, the shell reads them under s_sLock */
+    int32_t i32Avg10 = bFirst ? (int32_t)(u32Load << 10) : s_i32Avg10;
+    int32_t i32Avg60 = bFirst ? (int32_t)(u32Load << 10) : s_i32Avg60;
+    for (uint32_t i = 0U; (i < u32Seconds) && (i < LOAD_METER_SECONDS_MAX); i++) {
+        s_average(&i32Avg10, (int32_t)u32Load, LOAD_METER_A10);
+        s_average(&i32Avg60, (int32_t)u32Load, LOAD_METER_A60);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&s_sLock);
+    s_u32Calib    = u32Calib;
+    s_u32Turns    = u32PerSecond;
+    s_u32Load     = u32Load;
+    s_i32Avg10    = i32Avg10;
+    s_i32Avg60    = i32Avg60;
+    s_u32Seconds += u32Seconds;
+    k_spin_unlock(&s_sLock, key);
+
+    if (s_bLcd && (NULL != LCD_Post)) {
+        s_show(u32Load);
+    }
+}
+
+/*--------------------------------------------------*/
+static void s_load_thread(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    uint32_t u32Start = k_uptime_get_32();
+    uint32_t u32Turns = 0U;
+
+    for (;;) {
+        u32Turns++;
+        const uint32_t u32Elapsed = k_uptime_get_32() - u32Start;
+        if (u32Elapsed >= 1000U) {
+            const uint32_t u32Seconds = u32Elapsed / 1000U;
+            s_second(u32Turns, u32Seconds);
+            u32Start += u32Seconds * 1000U;
+            u32Turns = 0U;
+        }
+        k_yield();      /* the other threads of the lowest priority run first */
+    }
+}
+
+K_THREAD_DEFINE(s_tLoad, LOAD_METER_THREAD_STACK, s_load_thread, NULL, NULL, NULL, LOAD_METER_THREAD_PRIO, 0, 0);
+
+
+// -- shell command -----------------------------------------------------------
+
+/* load 0 prints the loads, 1 and shows each second on the LCD, 2 stops the LCD line */
+extern "C" int load(uint32_t u32Action)
+{
+    if (u32Action > 2U) {
+        uSHELL_PRINTF("load: 0 print, 1 and on the LCD, 2 LCD off\r\n");
+        return -1;
+    }
+    if (0U != u32Action) {
+        s_bLcd = (1U == u32Action);
+        if (NULL == LCD_Post) {
+            uSHELL_PRINTF("load: no LCD\r\n");
+        }
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&s_sLock);
+    const uint32_t u32Calib   = s_u32Calib;
+    const uint32_t u32Turns   = s_u32Turns;
+    const uint32_t u32Load    = s_u32Load;
+    const uint32_t u32Avg10   = (uint32_t)((s_i32Avg10 + 512) >> 10);
+    const uint32_t u32Avg60   = (uint32_t)((s_i32Avg60 + 512) >> 10);
+    const uint32_t u32Seconds = s_u32Seconds;
+    k_spin_unlock(&s_sLock, key);
+
+    if (0U == u32Calib) {
+        uSHELL_PRINTF("load: calibrating, the first second\r\n");
+        return 0;
+    }
+    uSHELL_PRINTF("Load: %u.%u %% (1 s)  %u.%u %% (10 s)  %u.%u %% (60 s)\r\n",
+        (unsigned)(u32Load / 10U), (unsigned)(u32Load % 10U),
+        (unsigned)(u32Avg10 / 10U), (unsigned)(u32Avg10 % 10U),
+        (unsigned)(u32Avg60 / 10U), (unsigned)(u32Avg60 % 10U));
+    uSHELL_PRINTF("Idle turns: %u/s of %u/s, over %u s\r\n",
+        (unsigned)u32Turns, (unsigned)u32Calib, (unsigned)u32Seconds);
+    return 0;
+}
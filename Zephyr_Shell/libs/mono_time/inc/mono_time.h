@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file mono_time.h
+ * @brief monotonic microsecond clock — Zephyr backend
+ *
+ * 64 bit, from the boot on, the one time base of the logs, the traces and
+ * the threads; the same interface as on FreeRTOS and ThreadX.
+ *
+ *   const uint64_t u64Start = mono_time_us();      a thread or any ISR
+ *   ...
+ *   const uint32_t u32Us = (uint32_t)(mono_time_us() - u64Start);
+ *
+ * On the STM32 boards it is the DWT cycle counter extended by an epoch: the
+ * cycle count and the microseconds at some instant, the time is the
+ * microseconds of the epoch and the cycles since it at the CPU clock. A read
+ * is the counter, a division and a few loads, no irq_lock(): a zero latency
+ * ISR reads it too. Two epochs, a new one goes to the one not published and
+ * a sequence number publishes it in one store; a reader checks the number
+ * after the counter and reads again if the epoch changed meanwhile. The
+ * writer is a k_timer of MONO_TIME_REFRESH_MS (the system clock ISR), far
+ * below the wrap of the counter; the remainder of the cycles stays in the
+ * epoch, the time never steps back. The counter and the timer start at
+ * SYS_INIT (POST_KERNEL).
+ *
+ * The host boards (native_sim, qemu_cortex_m3) have no DWT to count with:
+ * there it is the 64 bit cycle count of the kernel timer (k_cycle_get_64()).
+ */
+
+#define MONO_TIME_REFRESH_MS    1000U   /**< an epoch a second */
+
+/** The microseconds since the boot; any context. */
+uint64_t mono_time_us(void);
+
+#ifdef __cplusplus
+}
+#endif
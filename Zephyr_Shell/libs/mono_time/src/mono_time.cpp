@@ -0,0 +1,99 @@
+/**
+ * @file mono_time.cpp
+ * @brief monotonic microsecond clock — Zephyr backend
+ *
+ * The DWT cycle counter and its epochs (mono_time.h), or the kernel timer on
+ * the host boards (MONO_TIME_KERNEL).
+ */
+
+#include "mono_time.h"
+
+#include <zephyr/kernel.h>
+
+#if defined(MONO_TIME_KERNEL) && (MONO_TIME_KERNEL == 1)
+
+/*--------------------------------------------------*/
+uint64_t mono_time_us(void)
+{
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+    return k_cyc_to_us_floor64(k_cycle_get_64());
+#else
+    return k_ticks_to_us_floor64((uint64_t)k_uptime_ticks());
+#endif
+}
+
+#else
+#include <zephyr/init.h>
+#include <cmsis_core.h>
+
+typedef struct {
+    uint64_t u64Us;         /* the time of the epoch */
+    uint32_t u32Cycles;     /* the counter at it */
+} mono_time_epoch_s;
+
+static mono_time_epoch_s s_asEpoch[2];
+static volatile uint32_t s_u32Seq   = 0U;   /* the published epoch: s_asEpoch[s_u32Seq & 1] */
+static uint32_t          s_u32PerUs = 1U;
+
+
+/* the next epoch from the published one at the cycles of now, then published; the timer
+   ISR is the only writer, the readers never see it half written */
+static void s_refresh(struct k_timer *psTimer)
+{
+    ARG_UNUSED(psTimer);
+    const uint32_t u32Seq = s_u32Seq;
+    const mono_time_epoch_s *psOld = &s_asEpoch[u32Seq & 1U];
+    mono_time_epoch_s *psNew = &s_asEpoch[(u32Seq + 1U) & 1U];
+
+    const uint32_t u32Us = (DWT->CYCCNT - psOld->u32Cycles) / s_u32PerUs;
+
+    psNew->u64Us     = psOld->u64Us + u32Us;
+    psNew->u32Cycles = psOld->u32Cycles + (u32Us * s_u32PerUs);    /* the remainder stays */
+
+    __atomic_signal_fence(__ATOMIC_RELEASE);    /* one core: the order of the stores is enough */
+    s_u32Seq = u32Seq + 1U;
+}
+
+K_TIMER_DEFINE(s_sRefresh, s_refresh, NULL);
+
+
+/*--------------------------------------------------*/
+static int s_mono_time_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    const uint32_t u32PerUs = (uint32_t)(sys_clock_hw_cycles_per_sec() / 1000000);
+    s_u32PerUs = (0U != u32PerUs) ? u32PerUs : 1U;
+
+    /* the boot so far from the kernel, the cycles from here on */
+    s_asEpoch[0].u64Us     = k_ticks_to_us_floor64((uint64_t)k_uptime_ticks());
+    s_asEpoch[0].u32Cycles = DWT->CYCCNT;
+    s_u32Seq = 0U;
+
+    k_timer_start(&s_sRefresh, K_MSEC(MONO_TIME_REFRESH_MS), K_MSEC(MONO_TIME_REFRESH_MS));
+    return 0;
+}
+
+SYS_INIT(s_mono_time_init, POST_KERNEL, 0);
+
+
+/*--------------------------------------------------*/
+uint64_t mono_time_us(void)
+{
+    for (;;) {
+        const uint32_t u32Seq = s_u32Seq;
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+
+        const mono_time_epoch_s *psEpoch = &s_asEpoch[u32Seq & 1U];
+        const uint64_t u64Us     = psEpoch->u64Us;
+        const uint32_t u32Cycles = psEpoch->u32Cycles;
+        const uint32_t u32Now    = DWT->CYCCNT;
+
+        __atomic_signal_fence(__ATOMIC_ACQUIRE);
+        if (u32Seq == s_u32Seq) {      /* else an epoch came meanwhile */
+            return u64Us + ((u32Now - u32Cycles) / s_u32PerUs);
+        }
+    }
+}
+#endif /* MONO_TIME_KERNEL */
@@ -0,0 +1,193 @@
+/**
+ * @file sys_info.cpp
+ * @brief shell command sysinfo — Zephyr backend
+ *
+ * Same report as on FreeRTOS and ThreadX: uptime, threads and the peak of
+ * every stack since reset. The kernel fills the stacks with 0xAA at thread
+ * creation (CONFIG_INIT_STACKS), the peak is the part above the lowest byte
+ * which no longer holds it. The ISR stack is painted by the kernel as well
+ * and is scanned the same way.
+ *
+ * The CPU share of every thread since reset is the table of the FreeRTOS
+ * sysinfo (same columns), from the cycles of the runtime stats; the time of
+ * an ISR counts for the thread it interrupted. The stack scan and the cycles
+ * are what the thread analyzer reports, read here so that the lines go to
+ * the shell in these formats instead of through printk. The queues of the
+ * application (the LCD lines) are printed by its sys_info_queues(), if any.
+ *
+ * prj.conf:
+ *   CONFIG_INIT_STACKS=y
+ *   CONFIG_THREAD_STACK_INFO=y
+ *   CONFIG_THREAD_MONITOR=y
+ *   CONFIG_THREAD_NAME=y
+ *   CONFIG_THREAD_RUNTIME_STATS=y
+ */
+
+#include "ushell_core_printout.h"
+
+#include <zephyr/kernel.h>
+
+#define SYS_INFO_STACK_FILL     0xAAU       /* CONFIG_INIT_STACKS pattern */
+
+K_KERNEL_STACK_ARRAY_DECLARE(z_interrupt_stacks, CONFIG_MP_MAX_NUM_CPUS, CONFIG_ISR_STACK_SIZE);
+
+/* the queues of the application, a table of its own (bus.cpp) */
+extern "C" void sys_info_queues(void) __attribute__((weak));
+
+/* bytes never used by a thread, summed over the iteration */
+static size_t s_szSpare = 0U;
+
+/* threads of the iteration, the cycles of all of them */
+static uint32_t s_u32Threads = 0U;
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+static uint64_t s_u64Cycles  = 0U;
+#endif
+
+/*--------------------------------------------------*/
+static void printStack(const char *name, const char *state, int prio, size_t size, size_t unused)
+{
+    const size_t peak = size - unused;
+    const unsigned pct = (0U != size) ? (unsigned)((peak * 100U) / size) : 0U;
+
+    uSHELL_PRINTF("  %-16s %-10s %-4d %5u %5u %5u %3u%%%s\r\n",
+        name, state, prio, (unsigned)size, (unsigned)peak, (unsigned)unused,
+        pct, (0U == unused) ? " !" : "");
+}
+
+/*--------------------------------------------------*/
+static void printThread(const struct k_thread *cthread, void *user_data)
+{
+    struct k_thread *thread = (struct k_thread *)cthread;
+    const char *name = k_thread_name_get(thread);
+    char state[16];
+    size_t unused = 0U;
+
+    ARG_UNUSED(user_data);
+
+    if (0 != k_thread_stack_space_get(thread, &unused)) {
+        unused = 0U;
+    }
+    s_szSpare += unused;
+    printStack(((NULL != name) && ('\0' != name[0])) ? name : "?",
+        k_thread_state_str(thread, state, sizeof(state)),
+        thread->base.prio, thread->stack_info.size, unused);
+}
+
+/*--------------------------------------------------*/
+static void printStacks(void)
+{
+    uSHELL_PRINTF("%-18s %-10s %-4s %5s %5s %5s %s\r\n", "Thread", "State", "Prio", "Size", "Peak", "Free", "Used");
+    uSHELL_PRINTF("-----------------------------------------------------------\r\n");
+    s_szSpare = 0U;
+    k_thread_foreach_unlocked(printThread, NULL);
+#if !defined(CONFIG_ARCH_POSIX)
+    /* native_sim runs the ISRs on the stack of the thread they interrupt */
+    const uint8_t *isr   = (const uint8_t *)K_KERNEL_STACK_BUFFER(z_interrupt_stacks[0]);
+    const size_t   size  = K_KERNEL_STACK_SIZEOF(z_interrupt_stacks[0]);
+    size_t         unused = 0U;
+
+    while ((unused < size) && (SYS_INFO_STACK_FILL == isr[unused])) {
+        unused++;
+    }
+    printStack("ISR", "-", 0, size, unused);
+#endif /* !defined(CONFIG_ARCH_POSIX) */
+    uSHELL_PRINTF("Never used by the threads: %u bytes\r\n", (unsigned)s_szSpare);
+}
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+
+/*--------------------------------------------------*/
+static uint64_t threadCycles(struct k_thread *thread)
+{
+    k_thread_runtime_stats_t stats;
+
+    return (0 == k_thread_runtime_stats_get(thread, &stats)) ? stats.execution_cycles : 0U;
+}
+
+/*--------------------------------------------------*/
+static void countThread(const struct k_thread *cthread, void *user_data)
+{
+    ARG_UNUSED(user_data);
+
+    s_u32Threads++;
+    s_u64Cycles += threadCycles((struct k_thread *)cthread);
+}
+
+/*--------------------------------------------------*/
+static void printShare(const struct k_thread *cthread, void *user_data)
+{
+    struct k_thread *thread = (struct k_thread *)cthread;
+    const char *name = k_thread_name_get(thread);
+    const uint64_t cycles = threadCycles(thread);
+    const uint32_t pm = (0U != s_u64Cycles) ? (uint32_t)((cycles * 1000U) / s_u64Cycles) : 0U;
+    char state[16];
+
+    ARG_UNUSED(user_data);
+
+    uSHELL_PRINTF("  %-16s %-10s %-8d %3u.%u\r\n",
+        ((NULL != name) && ('\0' != name[0])) ? name : "?",
+        k_thread_state_str(thread, state, sizeof(state)),
+        thread->base.prio, (unsigned)(pm / 10U), (unsigned)(pm % 10U));
+}
+
+#else
+
+/*--------------------------------------------------*/
+static void countThread(const struct k_thread *cthread, void *user_data)
+{
+    ARG_UNUSED(cthread);
+    ARG_UNUSED(user_data);
+
+    s_u32Threads++;
+}
+
+#endif /* defined(CONFIG_THREAD_RUNTIME_STATS) */
+
+/*--------------------------------------------------*/
+/* the FreeRTOS "Task State Priority CPU %" table, the share since reset */
+static void printShares(void)
+{
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+    uSHELL_PRINTF("%-16s %-10s %-8s %s\r\n", "Task", "State", "Priority", "CPU %");
+    uSHELL_PRINTF("--------------------------------------------\r\n");
+    k_thread_foreach_unlocked(printShare, NULL);
+#else
+    uSHELL_PRINTF("CPU %%: built without CONFIG_THREAD_RUNTIME_STATS\r\n");
+#endif /* defined(CONFIG_THREAD_RUNTIME_STATS) */
+}
+
+/*--------------------------------------------------*/
+static void printUptime(void)
+{
+    const int64_t  ms  = k_uptime_get();
+    const uint32_t sec = (uint32_t)(ms / 1000);
+
+    s_u32Threads = 0U;
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+    s_u64Cycles  = 0U;
+#endif
+    k_thread_foreach_unlocked(countThread, NULL);
+
+    uSHELL_PRINTF("Uptime: %02u:%02u.%03u (ticks: %u)\r\n",
+        (unsigned)(sec / 60U), (unsigned)(sec % 60U), (unsigned)(ms % 1000), (unsigned)k_uptime_ticks());
+    uSHELL_PRINTF("Threads: %u\r\n", (unsigned)s_u32Threads);
+}
+
+/*--------------------------------------------------*/
+/* shell command: uptime, the CPU share of the threads, the stack peaks since reset and the queues */
+int sysinfo(void)
+{
+    uSHELL_PRINTF("\r\n=== System Info ===\r\n");
+    printUptime();
+    uSHELL_PRINTF("\r\n");
+    printShares();
+    uSHELL_PRINTF("\r\n");
+    printStacks();
+    if (NULL != sys_info_queues) {
+        uSHELL_PRINTF("\r\n");
+        sys_info_queues();
+    }
+    uSHELL_PRINTF("==================\r\n");
+
+    return 0;
+}
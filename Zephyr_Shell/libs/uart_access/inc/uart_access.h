@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdarg.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -9,28 +12,62 @@ extern "C" {
  * @brief UART interface — Zephyr backend
  *
  * Drop-in replacement for the STM32 HAL version.
- * Same public API; underneath it uses Zephyr's UART poll driver.
+ * Same public API; underneath it uses Zephyr's interrupt driven UART
+ * API for RX and TX, and it is the log backend of the console
+ * (uart_log_backend.c).
  *
  * prj.conf requirements:
  *   CONFIG_SERIAL=y
  *   CONFIG_UART_CONSOLE=y
  *   CONFIG_UART_INTERRUPT_DRIVEN=y
+ *   CONFIG_RING_BUFFER=y
+ *   CONFIG_LOG_MODE_DEFERRED=y, CONFIG_LOG_BACKEND_UART=n
  */
 
 /** Initialise the UART handle (resolves zephyr,console chosen node). */
 void uart_setup(void);
 
-/** Blocking single-character receive. Returns byte or -1 on error. */
+/** Blocking single-character receive (the thread sleeps). Returns byte or -1 on error. */
 int  uart_getchar(void);
 
-/** Blocking single-character transmit. */
+/** Single-character transmit, queued like uart_write(). */
 void uart_putchar(char c);
 
+/**
+ * Transmit of len bytes (the shell's bulk write, uSHELL_WRITE), queued on the
+ * TX ring; waits only while the ring is full. From an ISR what does not fit
+ * is dropped (uart_tx_dropped_get()).
+ */
+void uart_write(const char *buf, int len);
+
+/**
+ * Log backend side (uart_log_backend.c): one message between begin and end,
+ * written above the shell's line in edition, which is restored after it.
+ * uart_tx_panic() writes the rest of the ring and everything after it polled.
+ */
+void uart_log_begin(void);
+void uart_log_write(const char *buf, int len);
+void uart_log_end(void);
+void uart_tx_panic(void);
+
+/** Bytes the TX ring could not take (an ISR writer, a UART which did not move). */
+uint32_t uart_tx_dropped_get(void);
+
+/**
+ * Runtime baud rate (CONFIG_UART_USE_RUNTIME_CONFIGURE).
+ * Returns 0, or -1 if the driver rejects the rate. Not kept across a reset.
+ */
+int  uart_set_baudrate(uint32_t baudrate);
+uint32_t uart_get_baudrate(void);
+
 /**
  * Minimal printf over UART.
- * Supports: %s  %d  %x/%X  %c  + width / zero-pad / left-align.
+ * Supports: %s  %c  %d/%i  %u  %x/%X  %p  %f (fixed point, up to 9 decimals)  %%
+ * + width / precision / zero-pad / left-align and the l, ll, z length modifiers.
+ * Formatted into a 64 byte stack buffer, one uart_write() per line.
  */
 int  uart_printf(const char *fmt, ...);
+int  uart_vprintf(const char *fmt, va_list args);
 
 /**
  * Minimal snprintf into caller-supplied buffer.
@@ -38,6 +75,7 @@ int  uart_printf(const char *fmt, ...);
  * Returns number of characters written (excluding NUL).
  */
 int  uart_snprintf(char *buf, int maxlen, const char *fmt, ...);
+int  uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args);
 
 #ifdef __cplusplus
 }
@@ -9,10 +9,25 @@
  * Pin mux, clock gating and baud-rate come from the board's devicetree
  * (and prj.conf / app.overlay) — no manual register writes needed.
  *
+ * RX is interrupt driven: the UART ISR drains the FIFO into a ring buffer
+ * and gives a semaphore, uart_getchar() sleeps on it (no polling while idle).
+ * TX is interrupt driven too: uart_write() queues the bytes on a ring the
+ * same ISR feeds to the FIFO, the caller only waits when the ring is full.
+ * The log messages (printk and LOG_*, deferred to the log thread) reach the
+ * ring through uart_log_backend.c and uart_log_write(): they are printed
+ * above the line in edition, which is written again after them. Until
+ * uart_setup() and after a panic the bytes go out with uart_poll_out().
+ *
+ * The baud rate can be changed at runtime (shell command baud); the new
+ * rate is kept only if Enter arrives at it within UART_BAUD_CONFIRM_MS.
+ * It is not stored: after a reset the devicetree rate applies again.
+ *
  * prj.conf:
  *   CONFIG_SERIAL=y
  *   CONFIG_UART_CONSOLE=y
  *   CONFIG_UART_INTERRUPT_DRIVEN=y
+ *   CONFIG_RING_BUFFER=y
+ *   CONFIG_UART_USE_RUNTIME_CONFIGURE=y
  */
 
 #include "uart_access.h"
@@ -20,16 +35,40 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/uart.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/ring_buffer.h>
 #include <stdarg.h>
+#include <string.h>
+
+/* ================================================
+            printf configuration
+==================================================*/
+
+/* uart_printf() stack buffer, written out at every '\n' and when full */
+#define UART_PRINTF_LINE_SIZE       (64U)
+
+/* where the formatting engine puts its characters */
+typedef struct {
+    char *pcBuf;
+    int  iPos;
+    int  iSize;     /* usable bytes, without the NUL of uart_snprintf() */
+    bool bDrain;    /* uart_printf(): written out instead of truncated */
+} fmt_sink_s;
 
 /* ================================================
             private interfaces declaration
 ==================================================*/
 
-static void print_int(int value, int width, char pad, int left_align);
-static void print_hex(unsigned int value, int width, char pad, int left_align);
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad, int left_align);
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad, int left_align);
+static void fmt_putc(fmt_sink_s *psSink, char c);
+static void fmt_field(fmt_sink_s *psSink, const char *text, int len, int width, char pad, int left_align);
+static uint64_t fmt_divu10(uint64_t n, uint32_t *rem);
+static int fmt_utoa(char *end, uint64_t value, unsigned int base);
+static void fmt_number(fmt_sink_s *psSink, uint64_t value, bool negative, unsigned int base, int precision, int width, char pad, int left_align);
+static void fmt_float(fmt_sink_s *psSink, double value, int precision, int width, char pad, int left_align);
+static void fmt_vformat(fmt_sink_s *psSink, const char *fmt, va_list args);
+static void uart_isr(const struct device *dev, void *user_data);
+static void uart_tx_put(const char *buf, int len);
+static void uart_tx_track(const char *buf, int len);
 
 /* ================================================
             module-level state
@@ -42,6 +81,46 @@ static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value
  */
 static const struct device *uart_dev = nullptr;
 
+/**
+ * RX ring: written by the UART ISR only, read by the shell thread only,
+ * so the single producer / single consumer ring_buf needs no lock.
+ * The semaphore counts "data arrived" events (capped at 1).
+ */
+#define UART_RX_BUFFER_SIZE 256
+RING_BUF_DECLARE(uart_rx_ring, UART_RX_BUFFER_SIZE);
+K_SEM_DEFINE(uart_rx_sem, 0, 1);
+static volatile uint32_t uart_rx_dropped = 0;
+
+/**
+ * TX ring: filled by the writers under uart_tx_lock (the ISR disables the TX
+ * interrupt under it too, once the ring is empty), drained by the UART ISR.
+ * uart_tx_sem is given whenever the ISR made room. The writers of the threads
+ * take uart_tx_mutex, the log thread for a whole message (uart_log_begin()).
+ */
+#define UART_TX_BUFFER_SIZE     512
+#define UART_TX_CHUNK           16          /* bytes per FIFO fill */
+#define UART_TX_WAIT_MS         100         /* a full ring which does not move: the rest is dropped */
+RING_BUF_DECLARE(uart_tx_ring, UART_TX_BUFFER_SIZE);
+K_SEM_DEFINE(uart_tx_sem, 0, 1);
+K_MUTEX_DEFINE(uart_tx_mutex);
+static struct k_spinlock uart_tx_lock;
+static bool uart_tx_irq = false;            /* uart_setup() done, no panic */
+static volatile uint32_t uart_tx_dropped = 0;
+
+/**
+ * The line in edition: the bytes written since the last '\n' (the prompt,
+ * the echo and the cursor moves of the shell), sent again after the log
+ * lines which cleared it. -1: longer than the copy, not restored.
+ */
+#define UART_TX_LINE_SIZE       160
+static char uart_tx_line[UART_TX_LINE_SIZE];
+static int  uart_tx_line_len = 0;
+static bool uart_log_open    = false;       /* a log message is being written */
+static bool uart_log_newline = true;        /* its last byte was a '\n' */
+
+#define UART_BAUD_CONFIRM_MS    5000
+#define UART_BAUD_CMD_ERR       0xFF
+
 /* ================================================
             public interfaces definition
 ==================================================*/
@@ -55,6 +134,10 @@ void uart_setup(void)
         /* Nothing we can do without a working UART; trap here in debug. */
         k_panic();
     }
+
+    uart_irq_callback_user_data_set(uart_dev, uart_isr, nullptr);
+    uart_irq_rx_enable(uart_dev);
+    uart_tx_irq = true;
 }
 
 /*--------------------------------------------------*/
@@ -63,232 +146,602 @@ int uart_getchar(void)
     if (!uart_dev) return -1;
 
     uint8_t byte;
-    /* Spin until a character arrives (matches HAL_MAX_DELAY behaviour). */
-    while (uart_poll_in(uart_dev, &byte) != 0) {
-        k_yield(); /* be cooperative while waiting */
+    /* Sleep until the ISR queues a character (matches HAL_MAX_DELAY behaviour). */
+    while (ring_buf_get(&uart_rx_ring, &byte, 1) == 0) {
+        k_sem_take(&uart_rx_sem, K_FOREVER);
     }
     return (int)byte;
 }
 
+/*--------------------------------------------------*/
+int uart_getline(char *buf, int maxlen)
+{
+    if (!uart_dev || maxlen <= 0) return 0;
+
+    while (ring_buf_is_empty(&uart_rx_ring)) {
+        k_sem_take(&uart_rx_sem, K_FOREVER);
+    }
+
+    /* no IDLE line event through this API: only the bytes already queued are looked at,
+       anything else than a complete line stays for uart_getchar() */
+    const uint32_t avail = ring_buf_peek(&uart_rx_ring, (uint8_t *)buf, (uint32_t)maxlen);
+    int len = 0;
+
+    for (uint32_t i = 0; i < avail; i++) {
+        const uint8_t c = (uint8_t)buf[i];
+        if (c == '\r') {
+            buf[len] = '\0';
+            ring_buf_get(&uart_rx_ring, nullptr, i + 1);
+            return (int)(i + 1);
+        }
+        if (c == '\n') continue;
+        if (c < 0x20 || c > 0x7E || len >= maxlen - 1) break;
+        buf[len++] = (char)c;
+    }
+    buf[0] = '\0';
+    return 0;
+}
+
 /*--------------------------------------------------*/
 void uart_putchar(char c)
+{
+    uart_write(&c, 1);
+}
+
+/*--------------------------------------------------*/
+void uart_write(const char *buf, int len)
+{
+    if (!uart_dev || len <= 0) return;
+
+    const bool thread = !k_is_in_isr();
+    if (thread) {
+        (void)k_mutex_lock(&uart_tx_mutex, K_FOREVER);
+    }
+    if (uart_log_open && !uart_log_newline) {
+        /* a printk() without its '\n' yet: the shell goes on below it */
+        uart_tx_put("\r\n", 2);
+        uart_log_newline = true;
+    }
+    uart_tx_put(buf, len);
+    uart_tx_track(buf, len);
+    if (thread) {
+        (void)k_mutex_unlock(&uart_tx_mutex);
+    }
+}
+
+/*--------------------------------------------------*/
+void uart_log_begin(void)
+{
+    if (!k_is_in_isr()) {
+        (void)k_mutex_lock(&uart_tx_mutex, K_FOREVER);
+    }
+}
+
+/*--------------------------------------------------*/
+void uart_log_write(const char *buf, int len)
+{
+    if (!uart_dev) {
+        /* the first messages, the log thread may run before main() */
+        uart_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+    }
+    if (len <= 0 || !device_is_ready(uart_dev)) return;
+
+    if (!uart_log_open) {
+        uart_log_open = true;
+        if (uart_tx_line_len > 0) {
+            uart_tx_put("\r\033[K", 4);     /* the line in edition, written again at uart_log_end() */
+        } else if (uart_tx_line_len < 0) {
+            uart_tx_put("\r\n", 2);         /* too long to restore: the log starts below it */
+            uart_tx_line_len = 0;
+        }
+    }
+    uart_tx_put(buf, len);
+    uart_log_newline = ('\n' == buf[len - 1]);
+}
+
+/*--------------------------------------------------*/
+void uart_log_end(void)
+{
+    if (uart_log_open && uart_log_newline) {
+        uart_log_open = false;
+        if (uart_tx_line_len > 0) {
+            uart_tx_put(uart_tx_line, uart_tx_line_len);
+        }
+    }
+    if (!k_is_in_isr()) {
+        (void)k_mutex_unlock(&uart_tx_mutex);
+    }
+}
+
+/*--------------------------------------------------*/
+void uart_tx_panic(void)
 {
     if (!uart_dev) return;
-    uart_poll_out(uart_dev, (unsigned char)c);
+
+    /* the fault path cannot sleep: the rest of the ring and everything after it polled */
+    const k_spinlock_key_t key = k_spin_lock(&uart_tx_lock);
+    uart_tx_irq = false;
+    uart_irq_tx_disable(uart_dev);
+    uint8_t byte;
+    while (ring_buf_get(&uart_tx_ring, &byte, 1) == 1) {
+        uart_poll_out(uart_dev, byte);
+    }
+    k_spin_unlock(&uart_tx_lock, key);
 }
 
 /*--------------------------------------------------*/
-int uart_printf(const char *fmt, ...)
+uint32_t uart_tx_dropped_get(void)
 {
-    va_list args;
-    va_start(args, fmt);
+    return uart_tx_dropped;
+}
 
-    while (*fmt) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad       = ' ';
-            int  width     = 0;
-            int  left_align = 0;
+/*--------------------------------------------------*/
+int uart_set_baudrate(uint32_t baudrate)
+{
+    struct uart_config cfg;
+    if (!uart_dev || uart_config_get(uart_dev, &cfg) != 0) return -1;
 
-            if (*fmt == '-') { left_align = 1; fmt++; }
-            if (*fmt == '0') { pad = '0';      fmt++; }
+    /* the ring drained, then the last byte out of the data register */
+    while (uart_tx_irq && !ring_buf_is_empty(&uart_tx_ring)) {
+        k_sem_take(&uart_tx_sem, K_MSEC(UART_TX_WAIT_MS));
+    }
+    k_busy_wait(2U * 10U * 1000000U / cfg.baudrate + 1U);
 
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
-            }
+    cfg.baudrate = baudrate;
+    return (uart_configure(uart_dev, &cfg) == 0) ? 0 : -1;
+}
 
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    int len = 0;
-                    const char *tmp = s;
-                    while (*tmp++) len++;
-
-                    if (left_align) {
-                        tmp = s;
-                        while (*tmp) uart_putchar(*tmp++);
-                        for (int i = len; i < width; i++) uart_putchar(' ');
-                    } else {
-                        for (int i = len; i < width; i++) uart_putchar(pad);
-                        while (*s) uart_putchar(*s++);
-                    }
-                    break;
-                }
-                case 'd':
-                    print_int(va_arg(args, int), width, pad, left_align);
-                    break;
-                case 'x':
-                case 'X':
-                    print_hex(va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'c':
-                    uart_putchar((char)va_arg(args, int));
-                    break;
-                default:
-                    uart_putchar('%');
-                    uart_putchar(*fmt);
-                    break;
-            }
-        } else {
-            uart_putchar(*fmt);
+/*--------------------------------------------------*/
+uint32_t uart_get_baudrate(void)
+{
+    struct uart_config cfg;
+    if (!uart_dev || uart_config_get(uart_dev, &cfg) != 0) return 0;
+    return cfg.baudrate;
+}
+
+/*--------------------------------------------------*/
+/* shell command: 0 shows the rate, any other value switches now and stays
+   only if Enter is received at the new rate (1, detection at reset, is not supported) */
+int baud(uint32_t baudrate)
+{
+    const uint32_t old = uart_get_baudrate();
+
+    if (baudrate == 0) {
+        uart_printf("baud: %d\r\n", (int)old);
+        return 0;
+    }
+    if (baudrate == 1) {
+        uart_printf("baud: no detection, the devicetree sets the rate at reset\r\n");
+        return UART_BAUD_CMD_ERR;
+    }
+
+    uart_printf("baud: switching to %d, press Enter within %d s\r\n", (int)baudrate, UART_BAUD_CONFIRM_MS / 1000);
+    if (uart_set_baudrate(baudrate) != 0) {
+        uart_printf("baud: %d not reachable\r\n", (int)baudrate);
+        return UART_BAUD_CMD_ERR;
+    }
+
+    /* whatever arrived before the switch was sent at the old rate */
+    ring_buf_get(&uart_rx_ring, nullptr, UART_RX_BUFFER_SIZE);
+
+    bool confirmed = false;
+    const int64_t deadline = k_uptime_get() + UART_BAUD_CONFIRM_MS;
+    while (!confirmed) {
+        const int64_t left = deadline - k_uptime_get();
+        if (left <= 0) break;
+
+        uint8_t byte;
+        if (ring_buf_get(&uart_rx_ring, &byte, 1) == 0) {
+            k_sem_take(&uart_rx_sem, K_MSEC(left));
+            continue;
         }
-        fmt++;
+        confirmed = (byte == '\r');
     }
 
-    va_end(args);
+    if (!confirmed) {
+        (void)uart_set_baudrate(old);
+        uart_printf("baud: no Enter received, back to %d\r\n", (int)old);
+        return UART_BAUD_CMD_ERR;
+    }
+
+    uart_printf("baud: %d\r\n", (int)baudrate);
+    return 0;
+}
+
+/*--------------------------------------------------*/
+/* formatted into a line buffer on the stack, one uart_write() per line */
+int uart_vprintf(const char *fmt, va_list args)
+{
+    char line[UART_PRINTF_LINE_SIZE];
+    fmt_sink_s sSink = { line, 0, (int)sizeof(line), true };
+
+    fmt_vformat(&sSink, fmt, args);
+    if (sSink.iPos > 0) {
+        uart_write(line, sSink.iPos);
+    }
     return 0;
 }
 
+/*--------------------------------------------------*/
+int uart_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const int ret = uart_vprintf(fmt, args);
+    va_end(args);
+    return ret;
+}
+
+/*--------------------------------------------------*/
+int uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args)
+{
+    if (maxlen <= 0) {
+        return 0;
+    }
+    fmt_sink_s sSink = { buf, 0, maxlen - 1, false };
+
+    fmt_vformat(&sSink, fmt, args);
+    buf[sSink.iPos] = '\0';
+    return sSink.iPos;
+}
+
 /*--------------------------------------------------*/
 int uart_snprintf(char *buf, int maxlen, const char *fmt, ...)
 {
-    /* Pure string formatting — no UART device needed. */
     va_list args;
     va_start(args, fmt);
-    int pos = 0;
+    const int ret = uart_vsnprintf(buf, maxlen, fmt, args);
+    va_end(args);
+    return ret;
+}
 
-    while (*fmt && pos < maxlen - 1) {
-        if (*fmt == '%') {
-            fmt++;
-            char pad       = ' ';
-            int  width     = 0;
-            int  left_align = 0;
+/* ================================================
+            private interfaces definition
+==================================================*/
 
-            if (*fmt == '-') { left_align = 1; fmt++; }
-            if (*fmt == '0') { pad = '0';      fmt++; }
+/*--------------------------------------------------*/
+/* queued while the ISR drains, polled before uart_setup() and after a panic */
+static void uart_tx_put(const char *buf, int len)
+{
+    if (!uart_tx_irq) {
+        for (int i = 0; i < len; i++) {
+            uart_poll_out(uart_dev, (unsigned char)buf[i]);
+        }
+        return;
+    }
 
-            while (*fmt >= '0' && *fmt <= '9') {
-                width = width * 10 + (*fmt - '0');
-                fmt++;
+    while (len > 0) {
+        const k_spinlock_key_t key = k_spin_lock(&uart_tx_lock);
+        const uint32_t queued = ring_buf_put(&uart_tx_ring, (const uint8_t *)buf, (uint32_t)len);
+        if (queued > 0U) {
+            uart_irq_tx_enable(uart_dev);
+        }
+        k_spin_unlock(&uart_tx_lock, key);
+
+        buf += queued;
+        len -= (int)queued;
+        if (len > 0) {
+            /* an ISR cannot wait for room, a thread only as long as the UART moves */
+            if (k_is_in_isr() || (0 != k_sem_take(&uart_tx_sem, K_MSEC(UART_TX_WAIT_MS)))) {
+                uart_tx_dropped = uart_tx_dropped + (uint32_t)len;
+                return;
             }
+        }
+    }
+}
 
-            switch (*fmt) {
-                case 's': {
-                    const char *s = va_arg(args, const char *);
-                    int len = 0;
-                    const char *tmp = s;
-                    while (*tmp++) len++;
-
-                    if (left_align) {
-                        tmp = s;
-                        while (*tmp && pos < maxlen - 1) buf[pos++] = *tmp++;
-                        for (int i = len; i < width && pos < maxlen - 1; i++) buf[pos++] = ' ';
-                    } else {
-                        for (int i = len; i < width && pos < maxlen - 1; i++) buf[pos++] = pad;
-                        while (*s && pos < maxlen - 1) buf[pos++] = *s++;
-                    }
-                    break;
-                }
-                case 'd':
-                    print_int_to_buf(buf, &pos, maxlen, va_arg(args, int), width, pad, left_align);
-                    break;
-                case 'x':
-                case 'X':
-                    print_hex_to_buf(buf, &pos, maxlen, va_arg(args, unsigned int), width, pad, left_align);
-                    break;
-                case 'c':
-                    if (pos < maxlen - 1) buf[pos++] = (char)va_arg(args, int);
-                    break;
-                default:
-                    if (pos < maxlen - 1) buf[pos++] = '%';
-                    if (pos < maxlen - 1) buf[pos++] = *fmt;
-                    break;
-            }
+/*--------------------------------------------------*/
+/* the copy of the line in edition follows the shell output */
+static void uart_tx_track(const char *buf, int len)
+{
+    int start = len;
+    while ((start > 0) && ('\n' != buf[start - 1])) {
+        start--;
+    }
+    if (start > 0) {
+        uart_tx_line_len = 0;       /* a new line: only what follows the '\n' */
+    }
+    const int tail = len - start;
+    if ((uart_tx_line_len < 0) || (uart_tx_line_len + tail > UART_TX_LINE_SIZE)) {
+        uart_tx_line_len = -1;
+        return;
+    }
+    memcpy(&uart_tx_line[uart_tx_line_len], &buf[start], (size_t)tail);
+    uart_tx_line_len += tail;
+}
+
+/*--------------------------------------------------*/
+static void uart_isr(const struct device *dev, void *user_data)
+{
+    ARG_UNUSED(user_data);
+
+    if (!uart_irq_update(dev)) return;
+
+    if (uart_irq_tx_ready(dev)) {
+        const k_spinlock_key_t key = k_spin_lock(&uart_tx_lock);
+        uint8_t *data;
+        const uint32_t len = ring_buf_get_claim(&uart_tx_ring, &data, UART_TX_CHUNK);
+        if (len > 0U) {
+            const int sent = uart_fifo_fill(dev, data, (int)len);
+            ring_buf_get_finish(&uart_tx_ring, (sent > 0) ? (uint32_t)sent : 0U);
         } else {
-            buf[pos++] = *fmt;
+            ring_buf_get_finish(&uart_tx_ring, 0U);
+            uart_irq_tx_disable(dev);
         }
-        fmt++;
+        k_spin_unlock(&uart_tx_lock, key);
+        k_sem_give(&uart_tx_sem);
     }
 
-    buf[pos] = '\0';
-    va_end(args);
-    return pos;
+    while (uart_irq_rx_ready(dev)) {
+        uint8_t chunk[16];
+        const int len = uart_fifo_read(dev, chunk, sizeof(chunk));
+        if (len <= 0) break;
+
+        const uint32_t queued = ring_buf_put(&uart_rx_ring, chunk, (uint32_t)len);
+        if (queued < (uint32_t)len) {
+            /* reader too slow: the new bytes are lost, the queued ones kept */
+            uart_rx_dropped = uart_rx_dropped + ((uint32_t)len - queued);
+        }
+        k_sem_give(&uart_rx_sem);
+    }
 }
 
-/* ================================================
-            private interfaces definition
-==================================================*/
+/*--------------------------------------------------*/
+/* uart_printf() drains the line buffer when it is full and at every '\n',
+   uart_snprintf() truncates at its size */
+static void fmt_putc(fmt_sink_s *psSink, char c)
+{
+    if (psSink->iPos >= psSink->iSize) {
+        if (!psSink->bDrain) {
+            return;
+        }
+        uart_write(psSink->pcBuf, psSink->iPos);
+        psSink->iPos = 0;
+    }
+    psSink->pcBuf[psSink->iPos++] = c;
+    if (psSink->bDrain && ('\n' == c)) {
+        uart_write(psSink->pcBuf, psSink->iPos);
+        psSink->iPos = 0;
+    }
+}
 
 /*--------------------------------------------------*/
-static void print_int(int value, int width, char pad, int left_align)
+/* left aligned fields are always padded with spaces */
+static void fmt_field(fmt_sink_s *psSink, const char *text, int len, int width, char pad, int left_align)
 {
-    char buf[12];
-    int  i            = 0;
-    int  is_negative  = (value < 0);
+    if (!left_align) {
+        for (int i = len; i < width; i++) fmt_putc(psSink, pad);
+    }
+    for (int i = 0; i < len; i++) fmt_putc(psSink, text[i]);
+    if (left_align) {
+        for (int i = len; i < width; i++) fmt_putc(psSink, ' ');
+    }
+}
 
-    if (is_negative) value = -value;
+/*--------------------------------------------------*/
+/* n / 10 as a multiplication by 0.8 in shifts and adds, then >> 3: the 64 bit
+   division would be the libgcc loop on the Cortex-M; the estimate is off by 1 at most */
+static uint64_t fmt_divu10(uint64_t n, uint32_t *rem)
+{
+    uint64_t q = (n >> 1) + (n >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q += q >> 32;
+    q >>= 3;
+
+    uint32_t r = (uint32_t)(n - ((q << 3) + (q << 1)));
+    if (r > 9U) {
+        q++;
+        r -= 10U;
+    }
+    *rem = r;
+    return q;
+}
 
-    do { buf[i++] = '0' + (value % 10); value /= 10; } while (value);
-    if (is_negative) buf[i++] = '-';
+/*--------------------------------------------------*/
+/* writes the digits backwards, ending before end; returns their count */
+static int fmt_utoa(char *end, uint64_t value, unsigned int base)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char *p = end;
 
-    if (left_align) {
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
-        for (int j = i; j < width; j++)   uart_putchar(' ');
-    } else {
-        for (int j = i; j < width; j++)   uart_putchar(pad);
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
+    if (16U == base) {
+        do { *--p = hex[value & 0xFU]; value >>= 4; } while (value);
+        return (int)(end - p);
+    }
+    while (value > UINT32_MAX) {
+        uint32_t rem;
+        value = fmt_divu10(value, &rem);
+        *--p = (char)('0' + rem);
     }
+    uint32_t low = (uint32_t)value; /* the rest with the hardware divider */
+    do { *--p = (char)('0' + (low % 10U)); low /= 10U; } while (low);
+    return (int)(end - p);
 }
 
 /*--------------------------------------------------*/
-static void print_hex(unsigned int value, int width, char pad, int left_align)
+/* precision is the minimum number of digits, the sign and 0x go in front of them */
+static void fmt_number(fmt_sink_s *psSink, uint64_t value, bool negative, unsigned int base, int precision, int width, char pad, int left_align)
 {
-    const char hex[] = "0123456789ABCDEF";
-    char buf[8];
-    int  i = 0;
+    char tmp[24];
+    int  i = (int)sizeof(tmp);
 
-    do { buf[i++] = hex[value & 0xF]; value >>= 4; } while (value);
+    i -= fmt_utoa(&tmp[i], value, base);
+    for (int n = (int)sizeof(tmp) - i; (n < precision) && (i > 3); n++) tmp[--i] = '0';
+    if (16U == base) { tmp[--i] = 'x'; tmp[--i] = '0'; }
+    if (negative)    { tmp[--i] = '-'; }
 
-    if (left_align) {
-        uart_putchar('0'); uart_putchar('x');
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
-        for (int j = i + 2; j < width; j++) uart_putchar(' ');
-    } else {
-        for (int j = i + 2; j < width; j++) uart_putchar(pad);
-        uart_putchar('0'); uart_putchar('x');
-        for (int j = i - 1; j >= 0; j--) uart_putchar(buf[j]);
-    }
+    fmt_field(psSink, &tmp[i], (int)sizeof(tmp) - i, width, pad, left_align);
 }
 
 /*--------------------------------------------------*/
-static void print_int_to_buf(char *buf, int *pos, int maxlen, int value, int width, char pad, int left_align)
+/* fixed point from the bits of the double, integer arithmetic only: a %f argument is a double (the
+   promotion of the varargs), which the single precision FPU of the Cortex-M4F does not handle, soft
+   float calls on either core otherwise. The integer part as a 64 bit integer, the fraction in Q0.64
+   scaled to precision (at most 9) digits in two 32 bit halves and rounded half up; finite values
+   beyond 2^64 print "ovf" */
+static void fmt_float(fmt_sink_s *psSink, double value, int precision, int width, char pad, int left_align)
 {
-    char tmp[12];
-    int  i            = 0;
-    int  is_negative  = (value < 0);
+    static const uint32_t pow10[] = { 1U, 10U, 100U, 1000U, 10000U, 100000U,
+                                      1000000U, 10000000U, 100000000U, 1000000000U };
+    char tmp[32];
+    int  i = (int)sizeof(tmp);
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const int      biased   = (int)((bits >> 52) & 0x7FFU);
+    const uint64_t mantissa = bits & 0x000FFFFFFFFFFFFFULL;
+    const bool     negative = (0U != (bits >> 63)) && (0U != (bits << 1));   /* -0.0 prints as 0 */
+
+    if ((0x7FF == biased) && (0U != mantissa)) {
+        fmt_field(psSink, "nan", 3, width, ' ', left_align);
+        return;
+    }
+    if (biased >= (1023 + 64)) {
+        const char *text = (0x7FF == biased) ? "-inf" : "-ovf";
+        fmt_field(psSink, negative ? text : &text[1], negative ? 4 : 3, width, ' ', left_align);
+        return;
+    }
+    if (precision < 0) {
+        precision = 6;
+    } else if (precision > 9) {
+        precision = 9;
+    }
 
-    if (is_negative) value = -value;
+    /* value = m / 2^shift */
+    const uint64_t m     = (0 == biased) ? mantissa : (mantissa | (1ULL << 52));
+    const int      shift = 1075 - ((0 == biased) ? 1 : biased);
+    uint64_t ipart = 0U;
+    uint64_t frac  = 0U;
+    if (shift <= 0) {
+        ipart = m << -shift;
+    } else if (shift < 64) {
+        ipart = m >> shift;
+        frac  = (m & ((1ULL << shift) - 1U)) << (64 - shift);
+    } else if ((shift - 64) < 64) {
+        frac  = m >> (shift - 64);
+    }
 
-    do { tmp[i++] = '0' + (value % 10); value /= 10; } while (value);
-    if (is_negative) tmp[i++] = '-';
+    /* (frac * 10^precision + 2^63) >> 64, the low half only carries into the high one */
+    const uint64_t scaled = (frac >> 32) * pow10[precision] + (((frac & 0xFFFFFFFFU) * pow10[precision]) >> 32);
+    uint32_t fpart = (uint32_t)((scaled + (1ULL << 31)) >> 32);
+    if (fpart >= pow10[precision]) {
+        fpart -= pow10[precision];
+        ipart++;
+    }
 
-    if (left_align) {
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
-        for (int j = i; j < width && *pos < maxlen - 1; j++)   buf[(*pos)++] = ' ';
-    } else {
-        for (int j = i; j < width && *pos < maxlen - 1; j++)   buf[(*pos)++] = pad;
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
+    if (precision > 0) {
+        int n = fmt_utoa(&tmp[i], fpart, 10U);
+        i -= n;
+        for (; n < precision; n++) tmp[--i] = '0';
+        tmp[--i] = '.';
     }
+    i -= fmt_utoa(&tmp[i], ipart, 10U);
+    if (negative) { tmp[--i] = '-'; }
+
+    fmt_field(psSink, &tmp[i], (int)sizeof(tmp) - i, width, pad, left_align);
 }
 
 /*--------------------------------------------------*/
-static void print_hex_to_buf(char *buf, int *pos, int maxlen, unsigned int value, int width, char pad, int left_align)
+/* supports %s %c %d %i %u %x/%X %p %f %%, the flags - and 0, width and precision
+   (also as *) and the l, ll, z length modifiers */
+static void fmt_vformat(fmt_sink_s *psSink, const char *fmt, va_list args)
 {
-    const char hex[] = "0123456789ABCDEF";
-    char tmp[8];
-    int  i = 0;
+    for (; *fmt; fmt++) {
+        if (*fmt != '%') {
+            fmt_putc(psSink, *fmt);
+            continue;
+        }
+        fmt++;
+        char pad        = ' ';
+        int  width      = 0;
+        int  precision  = -1;
+        int  length     = 0;    /* 1: long, 2: long long */
+        int  left_align = 0;
 
-    do { tmp[i++] = hex[value & 0xF]; value >>= 4; } while (value);
+        if (*fmt == '-') { left_align = 1; fmt++; }
+        if (*fmt == '0') { pad = '0';      fmt++; }
 
-    if (left_align) {
-        if (*pos < maxlen - 2) { buf[(*pos)++] = '0'; buf[(*pos)++] = 'x'; }
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
-        for (int j = i + 2; j < width && *pos < maxlen - 1; j++) buf[(*pos)++] = ' ';
-    } else {
-        for (int j = i + 2; j < width && *pos < maxlen - 1; j++) buf[(*pos)++] = pad;
-        if (*pos < maxlen - 2) { buf[(*pos)++] = '0'; buf[(*pos)++] = 'x'; }
-        for (int j = i - 1; j >= 0 && *pos < maxlen - 1; j--) buf[(*pos)++] = tmp[j];
+        if (*fmt == '*') {
+            width = va_arg(args, int);
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (*fmt - '0');
+            fmt++;
+        }
+        if (*fmt == '.') {
+            fmt++;
+            precision = 0;
+            if (*fmt == '*') {
+                precision = va_arg(args, int);
+                fmt++;
+            }
+            while (*fmt >= '0' && *fmt <= '9') {
+                precision = precision * 10 + (*fmt - '0');
+                fmt++;
+            }
+        }
+        while (*fmt == 'l') { length++; fmt++; }
+        if (*fmt == 'z') {
+            length = (sizeof(size_t) > sizeof(unsigned int)) ? 1 : 0;
+            fmt++;
+        }
+
+        switch (*fmt) {
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                if (nullptr == s) {
+                    s = "(null)";
+                }
+                int len = 0;
+                while (s[len] && ((precision < 0) || (len < precision))) len++;
+                fmt_field(psSink, s, len, width, pad, left_align);
+                break;
+            }
+            case 'c': {
+                const char c = (char)va_arg(args, int);
+                fmt_field(psSink, &c, 1, width, pad, left_align);
+                break;
+            }
+            case 'd':
+            case 'i': {
+                const int64_t value = (length > 1) ? (int64_t)va_arg(args, long long)
+                                    : (length > 0) ? (int64_t)va_arg(args, long)
+                                                   : (int64_t)va_arg(args, int);
+                /* the magnitude in unsigned arithmetic, the minimum included */
+                fmt_number(psSink, (value < 0) ? (0U - (uint64_t)value) : (uint64_t)value,
+                           (value < 0), 10U, precision, width, pad, left_align);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                const uint64_t value = (length > 1) ? (uint64_t)va_arg(args, unsigned long long)
+                                     : (length > 0) ? (uint64_t)va_arg(args, unsigned long)
+                                                    : (uint64_t)va_arg(args, unsigned int);
+                fmt_number(psSink, value, false, ('u' == *fmt) ? 10U : 16U, precision, width, pad, left_align);
+                break;
+            }
+            case 'p':
+                fmt_number(psSink, (uint64_t)(uintptr_t)va_arg(args, void *), false, 16U,
+                           (int)(2U * sizeof(void *)), width, pad, left_align);
+                break;
+            case 'f':
+            case 'F':
+                fmt_float(psSink, va_arg(args, double), precision, width, pad, left_align);
+                break;
+            case '%':
+                fmt_putc(psSink, '%');
+                break;
+            case '\0':
+                return; /* a lone '%' ends the format */
+            default:
+                fmt_putc(psSink, '%');
+                fmt_putc(psSink, *fmt);
+                break;
+        }
     }
 }
 
@@ -0,0 +1,72 @@
+/*
+ * uart_log_backend.c — the Zephyr log backend of the shell console.
+ *
+ * MUST remain a .c file, for the same reason as src/lcd_objects.c:
+ * LOG_BACKEND_DEFINE and LOG_OUTPUT_DEFINE place their objects with
+ * STRUCT_SECTION_ITERABLE and designated initialisers.
+ *
+ * With CONFIG_LOG_MODE_DEFERRED a LOG_*() or printk() call only stores the
+ * message and returns; the log thread formats it here and passes the text to
+ * uart_log_write(), which queues it on the TX ring of uSHELL_PRINTF(), above
+ * the line in edition of the shell. It replaces the UART backend of Zephyr
+ * (CONFIG_LOG_BACKEND_UART=n), which polls every character out next to the
+ * shell output.
+ */
+
+#include "uart_access.h"
+
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_backend_std.h>
+#include <zephyr/logging/log_output.h>
+
+#define UART_LOG_OUTPUT_SIZE    64      /* formatted bytes per uart_log_write() */
+
+static uint8_t uart_log_buf[UART_LOG_OUTPUT_SIZE];
+
+/*--------------------------------------------------*/
+static int uart_log_out(uint8_t *data, size_t length, void *ctx)
+{
+    ARG_UNUSED(ctx);
+
+    uart_log_write((const char *)data, (int)length);
+    return (int)length;
+}
+
+LOG_OUTPUT_DEFINE(uart_log_output, uart_log_out, uart_log_buf, sizeof(uart_log_buf));
+
+/*--------------------------------------------------*/
+static void uart_log_process(const struct log_backend *const backend, union log_msg_generic *msg)
+{
+    ARG_UNUSED(backend);
+
+    uart_log_begin();
+    log_output_msg_process(&uart_log_output, &msg->log, log_backend_std_get_flags());
+    uart_log_end();
+}
+
+/*--------------------------------------------------*/
+static void uart_log_dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+    ARG_UNUSED(backend);
+
+    uart_log_begin();
+    log_output_dropped_process(&uart_log_output, cnt);
+    uart_log_end();
+}
+
+/*--------------------------------------------------*/
+static void uart_log_panic(const struct log_backend *const backend)
+{
+    ARG_UNUSED(backend);
+
+    uart_tx_panic();
+    log_output_flush(&uart_log_output);
+}
+
+static const struct log_backend_api uart_log_api = {
+    .process = uart_log_process,
+    .dropped = uart_log_dropped,
+    .panic   = uart_log_panic,
+};
+
+LOG_BACKEND_DEFINE(log_backend_ushell, uart_log_api, true);
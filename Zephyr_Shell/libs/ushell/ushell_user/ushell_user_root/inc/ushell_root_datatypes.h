@@ -7,6 +7,12 @@
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
 #define uSHELL_USER_SHORTCUTS_CONFIG_FILE        "ushell_root_shortcuts.cfg"
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+#define uSHELL_SCRIPTS_CONFIG_FILE               "ushell_root_scripts.cfg"
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+#define uSHELL_COMPLETIONS_CONFIG_FILE           "ushell_root_completions.cfg"
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
 
 #include "ushell_core_datatypes_user.h"
 
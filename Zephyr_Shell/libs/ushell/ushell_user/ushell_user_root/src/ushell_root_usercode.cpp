@@ -131,13 +131,78 @@ int sstest(char *s1, char *s2) {
 /*---------------------------------------------------------------*/
 int liotest(uint64_t l, uint32_t i, bool o) {
     uSHELL_PRINTF("--> liotest()\n");
-    uSHELL_PRINTF("l = %d\n", l);
+    uSHELL_PRINTF("l = %llu\n", (unsigned long long)l);
     uSHELL_PRINTF("i = %d\n", i);
     uSHELL_PRINTF("o = %d\n", o);
 
     return 0;
 }
 
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+/*---------------------------------------------------------------*/
+int rtest(strview_s r) {
+    uSHELL_PRINTF("--> rtest()\n");
+    uSHELL_PRINTF("r = ");
+    for (size_t i = 0; i < r.szLen; ++i) {
+        uSHELL_PRINTF("%c", r.pstr[i]);
+    }
+    uSHELL_PRINTF(" (len:%d)\n", (int)r.szLen);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+/*---------------------------------------------------------------*/
+int atest(numarray_s a) {
+    uSHELL_PRINTF("--> atest()\n");
+    for (size_t i = 0; i < a.szCount; ++i) {
+        uSHELL_PRINTF("a[%d] = %d\n", (int)i, a.pu32Items[i]);
+    }
+    uSHELL_PRINTF("(count:%d)\n", (int)a.szCount);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+/*---------------------------------------------------------------*/
+int xtest(hexbuf_s x) {
+    uSHELL_PRINTF("--> xtest()\n");
+    for (size_t i = 0; i < x.szLen; ++i) {
+        uSHELL_PRINTF("x[%d] = 0x%02X\n", (int)i, (unsigned int)x.pu8Data[i]);
+    }
+    uSHELL_PRINTF("(len:%d)\n", (int)x.szLen);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_HEX_BUFFERS) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+/*---------------------------------------------------------------*/
+int qtest(numq_t q) {
+    const uint32_t u32Magnitude = (q < 0) ? (0U - (uint32_t)q) : (uint32_t)q;
+    const uint32_t u32Frac = ((u32Magnitude & ((1U << uSHELL_FIXED_FRAC_BITS) - 1U)) * 10000U) >> uSHELL_FIXED_FRAC_BITS;
+    uSHELL_PRINTF("--> qtest()\n");
+    uSHELL_PRINTF("q = %s%u.%04u (raw:%x)\n", (q < 0) ? "-" : "", (unsigned)(u32Magnitude >> uSHELL_FIXED_FRAC_BITS), (unsigned)u32Frac, (unsigned)q);
+
+    return 0;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED) */
+
+///////////////////////////////////////////////////////////////////
+//               PARAMETERS VALUES PROVIDERS                     //
+///////////////////////////////////////////////////////////////////
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+/*---------------------------------------------------------------*/
+const char *stest_values(int iIndex) {
+    static const char *const vstrValues[] = {"hello", "help", "world"};
+
+    return (iIndex < uSHELL_NR_ELEMS(vstrValues)) ? vstrValues[iIndex] : nullptr;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+
 ///////////////////////////////////////////////////////////////////
 //               USER SHORTCUTS HANDLERS                         //
 ///////////////////////////////////////////////////////////////////
@@ -155,4 +220,10 @@ void uShellUserHandleShortcut_Slash(const char *pstrArgs) {
 
 } /* uShellUserHandleShortcut_Slash() */
 
+/******************************************************************************/
+void uShellUserHandleShortcut_Bang(const char *pstrArgs) {
+    uSHELL_PRINTF("[!] hot shortcut registered but not implemented | args[%s]\n", pstrArgs);
+
+} /* uShellUserHandleShortcut_Bang() */
+
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# Renode regression run of the build: time to prompt and command round trip against the
+# budgets of test/renode/shell_perf.robot (stm32_min_dev is an STM32F103)
+#
+#   ./renode_test.sh [renode-test options, e.g. --variable PROMPT_BUDGET_S:0.8]
+
+ELF=$(pwd)/build/zephyr/zephyr.elf
+
+if [[ ! -f ${ELF} ]]; then
+    echo "no ${ELF}, run ./build.sh first"
+    exit 1
+fi
+
+renode-test $(pwd)/test/renode/shell_perf.robot \
+    --variable ELF:${ELF} \
+    --variable PLATFORM:platforms/cpus/stm32f103.repl \
+    --results-dir $(pwd)/build/renode_test \
+    "$@"
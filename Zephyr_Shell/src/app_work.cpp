@@ -0,0 +1,99 @@
+/**
+ * @file app_work.cpp
+ * @brief delayable work items of the application, shell command work
+ *
+ * prj.conf:
+ *   CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE  the stack all the handlers share
+ */
+
+#include "app_work.h"
+#include "ushell_core_printout.h"
+
+static app_work_t *s_psList = nullptr;
+
+/*--------------------------------------------------*/
+/* every item runs through here: count it, schedule the next period, call its handler */
+static void app_work_run(struct k_work *kwork)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(kwork);
+    app_work_t *work = CONTAINER_OF(dwork, app_work_t, dwork);
+
+    work->runs++;
+    if (0U != work->period_ms) {
+        (void)k_work_schedule(&work->dwork, K_MSEC(work->period_ms));
+    }
+    work->handler(work);
+}
+
+
+extern "C" {
+
+/*--------------------------------------------------*/
+void app_work_init(app_work_t *work, const char *name, uint32_t period_ms, app_work_handler_t handler)
+{
+    work->name      = name;
+    work->period_ms = period_ms;
+    work->handler   = handler;
+    work->runs      = 0U;
+    k_work_init_delayable(&work->dwork, app_work_run);
+
+    const unsigned int key = irq_lock();
+    work->next = s_psList;
+    s_psList   = work;
+    irq_unlock(key);
+}
+
+/*--------------------------------------------------*/
+int app_work_schedule(app_work_t *work, k_timeout_t delay)
+{
+    return k_work_schedule(&work->dwork, delay);
+}
+
+/*--------------------------------------------------*/
+int app_work_reschedule(app_work_t *work, k_timeout_t delay)
+{
+    return k_work_reschedule(&work->dwork, delay);
+}
+
+/*--------------------------------------------------*/
+bool app_work_cancel(app_work_t *work)
+{
+    return (0 == (k_work_cancel_delayable(&work->dwork) & K_WORK_RUNNING));
+}
+
+} /* extern "C" */
+
+
+/*--------------------------------------------------*/
+static const char *workState(int busy)
+{
+    if (busy & K_WORK_RUNNING) {
+        return "RUNNING";
+    } else if (busy & K_WORK_CANCELING) {
+        return "CANCELING";
+    } else if (busy & K_WORK_QUEUED) {
+        return "QUEUED";
+    } else if (busy & K_WORK_DELAYED) {
+        return "DELAYED";
+    }
+    return "IDLE";
+}
+
+/*--------------------------------------------------*/
+/* shell command: the work items, their state, the time to the next run, period and runs */
+int work(void)
+{
+    uSHELL_PRINTF("%-18s %-10s %8s %8s %8s\r\n", "Work", "State", "Next ms", "Period", "Runs");
+    uSHELL_PRINTF("-------------------------------------------------------\r\n");
+    for (app_work_t *item = s_psList; nullptr != item; item = item->next) {
+        const int busy = k_work_delayable_busy_get(&item->dwork);
+        const uint32_t next = (busy & K_WORK_DELAYED) ?
+            (uint32_t)k_ticks_to_ms_ceil32(k_work_delayable_remaining_get(&item->dwork)) : 0U;
+
+        uSHELL_PRINTF("  %-16s %-10s %8u %8u %8u\r\n", item->name, workState(busy),
+            (unsigned)next, (unsigned)item->period_ms, (unsigned)item->runs);
+    }
+    uSHELL_PRINTF("Queue: system work queue, %u bytes of stack\r\n", (unsigned)CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE);
+
+    return 0;
+}
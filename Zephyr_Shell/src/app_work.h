@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+ * app_work.h — periodic and one-shot activities as delayable work items.
+ *
+ * An activity without a blocking wait (the LED blink, the button debounce)
+ * needs no thread and no stack of its own: it is a k_work_delayable on the
+ * system work queue, the one all of them share. An app_work_t adds the name,
+ * the period (0: one-shot) and a run counter to it and is linked into the
+ * list the shell command work prints. The handler runs on the work queue:
+ * it must not block, a periodic item is scheduled again before it is called.
+ */
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct app_work app_work_t;
+typedef void (*app_work_handler_t)(app_work_t *work);
+
+struct app_work {
+    const char             *name;
+    uint32_t                period_ms;  /* 0: one-shot */
+    app_work_handler_t      handler;
+    uint32_t                runs;
+    struct k_work_delayable dwork;
+    app_work_t             *next;       /* list of the work command */
+};
+
+/* once per item, from a thread, before it is scheduled */
+void app_work_init(app_work_t *work, const char *name, uint32_t period_ms, app_work_handler_t handler);
+
+/* the first run after delay; no change if it is already scheduled */
+int app_work_schedule(app_work_t *work, k_timeout_t delay);
+
+/* the next run after delay, an earlier one is moved (debounce) */
+int app_work_reschedule(app_work_t *work, k_timeout_t delay);
+
+/* stops a periodic item too; false if it is still running */
+bool app_work_cancel(app_work_t *work);
+
+#ifdef __cplusplus
+}
+#endif
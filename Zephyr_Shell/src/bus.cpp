@@ -0,0 +1,165 @@
+/**
+ * @file bus.cpp
+ * @brief zbus helpers of the application: statistics, the button, shell command zbus
+ *
+ * bus_stat_lis observes every channel and counts its publishes, bus_publish()
+ * counts the ones which failed (a full net_buf pool of the LCD subscriber, a
+ * channel still locked at the timeout), bus_received() the ones the LCD thread
+ * took: the difference is what waits in the pool, the queue line of sysinfo. The button is the devicetree alias
+ * sw0: its edges are debounced by the one-shot work item "button" (app_work.h),
+ * which publishes the new state on button_chan.
+ *
+ * prj.conf:
+ *   CONFIG_ZBUS=y
+ *   CONFIG_ZBUS_CHANNEL_NAME=y
+ *   CONFIG_ZBUS_MSG_SUBSCRIBER=y
+ */
+
+#include "bus_objects.h"
+#include "app_work.h"
+#include "ushell_core_printout.h"
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/printk.h>
+
+#define BUTTON_DEBOUNCE_MS  20
+#define BUTTON_PUB_MS       10      /* wait for the channel lock, from the work queue */
+
+
+extern "C" {
+
+/*--------------------------------------------------*/
+void bus_stat_cb(const struct zbus_channel *chan)
+{
+    BusChanStat_t *stat = (BusChanStat_t *)zbus_chan_user_data(chan);
+
+    if (nullptr != stat) {
+        atomic_inc(&stat->published);
+    }
+}
+
+/*--------------------------------------------------*/
+int bus_publish(const struct zbus_channel *chan, const void *msg, k_timeout_t timeout)
+{
+    const int ret = zbus_chan_pub(chan, msg, timeout);
+
+    if (0 != ret) {
+        BusChanStat_t *stat = (BusChanStat_t *)zbus_chan_user_data(chan);
+        if (nullptr != stat) {
+            atomic_inc(&stat->failed);
+        }
+    }
+    return ret;
+}
+
+/*--------------------------------------------------*/
+void bus_received(const struct zbus_channel *chan)
+{
+    BusChanStat_t *stat = (BusChanStat_t *)zbus_chan_user_data(chan);
+
+    if (nullptr != stat) {
+        /* this one included, the publish is counted before the take */
+        const atomic_val_t waiting = atomic_get(&stat->published) - atomic_get(&stat->received);
+        if (waiting > atomic_get(&stat->peak)) {
+            atomic_set(&stat->peak, waiting);
+        }
+        atomic_inc(&stat->received);
+    }
+}
+
+/*--------------------------------------------------*/
+void sys_info_queues(void)
+{
+    const atomic_val_t published = atomic_get(&lcd_chan_stat.published);
+    const atomic_val_t received  = atomic_get(&lcd_chan_stat.received);
+
+    uSHELL_PRINTF("%-18s %8s %8s %8s %8s %8s %8s\r\n", "Queue", "Sent", "Received", "Waiting", "Peak", "Size", "Dropped");
+    uSHELL_PRINTF("---------------------------------------------------------------------------\r\n");
+    uSHELL_PRINTF("  %-16s %8u %8u %8u %8u %8u %8u\r\n", "lcd_sub", (unsigned)published, (unsigned)received,
+        (unsigned)(published - received), (unsigned)atomic_get(&lcd_chan_stat.peak),
+        (unsigned)CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_POOL_SIZE, (unsigned)atomic_get(&lcd_chan_stat.failed));
+}
+
+} /* extern "C" */
+
+
+/* ── Button ───────────────────────────────────────────────────────────── */
+#if DT_NODE_HAS_STATUS(DT_ALIAS(sw0), okay)
+
+static const struct gpio_dt_spec button = GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios);
+static struct gpio_callback button_cb_data;
+static app_work_t button_work;
+static ButtonMsg_t button_state;
+
+/*--------------------------------------------------*/
+/* the level once it has been stable for BUTTON_DEBOUNCE_MS, published on change */
+static void button_debounced(app_work_t *work)
+{
+    ARG_UNUSED(work);
+
+    const bool pressed = (gpio_pin_get_dt(&button) > 0);
+    if (pressed == button_state.pressed) {
+        return;
+    }
+    button_state.pressed = pressed;
+    if (pressed) {
+        button_state.presses++;
+    }
+    (void)bus_publish(&button_chan, &button_state, K_MSEC(BUTTON_PUB_MS));
+}
+
+/*--------------------------------------------------*/
+static void button_edge(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(cb);
+    ARG_UNUSED(pins);
+
+    (void)app_work_reschedule(&button_work, K_MSEC(BUTTON_DEBOUNCE_MS));
+}
+
+#endif /* DT_NODE_HAS_STATUS(DT_ALIAS(sw0), okay) */
+
+/*--------------------------------------------------*/
+extern "C" void bus_button_init(void)
+{
+#if DT_NODE_HAS_STATUS(DT_ALIAS(sw0), okay)
+    if (!gpio_is_ready_dt(&button)) {
+        printk("Button GPIO not ready\n");
+        return;
+    }
+    app_work_init(&button_work, "button", 0U, button_debounced);
+    if ((0 != gpio_pin_configure_dt(&button, GPIO_INPUT)) ||
+        (0 != gpio_pin_interrupt_configure_dt(&button, GPIO_INT_EDGE_BOTH))) {
+        printk("Button GPIO setup failed\n");
+        return;
+    }
+    gpio_init_callback(&button_cb_data, button_edge, BIT(button.pin));
+    (void)gpio_add_callback(button.port, &button_cb_data);
+#endif /* DT_NODE_HAS_STATUS(DT_ALIAS(sw0), okay) */
+}
+
+
+/* ── Shell command ────────────────────────────────────────────────────── */
+
+/*--------------------------------------------------*/
+static bool printChannel(const struct zbus_channel *chan)
+{
+    const BusChanStat_t *stat = (const BusChanStat_t *)zbus_chan_user_data(chan);
+
+    uSHELL_PRINTF("  %-16s %5u %9u %7u\r\n", zbus_chan_name(chan), (unsigned)chan->message_size,
+        (nullptr != stat) ? (unsigned)atomic_get(&stat->published) : 0U,
+        (nullptr != stat) ? (unsigned)atomic_get(&stat->failed) : 0U);
+    return true;    /* next channel */
+}
+
+/*--------------------------------------------------*/
+/* shell command: the channels with their message size, publishes and failed publishes */
+int zbus(void)
+{
+    uSHELL_PRINTF("%-18s %5s %9s %7s\r\n", "Channel", "Size", "Published", "Failed");
+    uSHELL_PRINTF("-------------------------------------------\r\n");
+    (void)zbus_iterate_over_channels(printChannel);
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * bus_objects.c — definitions of the zbus channels and observers.
+ *
+ * MUST remain a .c file, for the same reason as lcd_objects.c: the zbus
+ * macros place their objects with STRUCT_SECTION_ITERABLE and designated
+ * initialisers.
+ */
+
+#include "bus_objects.h"
+
+/* ── Observers ───────────────────────────────────────────────────────── */
+ZBUS_MSG_SUBSCRIBER_DEFINE(lcd_sub);
+ZBUS_LISTENER_DEFINE(lcd_view_lis, lcd_view_cb);
+ZBUS_LISTENER_DEFINE(bus_stat_lis, bus_stat_cb);
+
+/* ── Channel statistics ──────────────────────────────────────────────── */
+BusChanStat_t led_chan_stat;
+BusChanStat_t button_chan_stat;
+BusChanStat_t lcd_chan_stat;
+
+/* ── Channels ────────────────────────────────────────────────────────── */
+ZBUS_CHAN_DEFINE(led_chan,
+    LedStateMsg_t,
+    NULL,                                   /* no validator */
+    &led_chan_stat,
+    ZBUS_OBSERVERS(lcd_view_lis, bus_stat_lis),
+    ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(button_chan,
+    ButtonMsg_t,
+    NULL,
+    &button_chan_stat,
+    ZBUS_OBSERVERS(lcd_view_lis, bus_stat_lis),
+    ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(lcd_chan,
+    LcdMessage_t,
+    NULL,
+    &lcd_chan_stat,
+    ZBUS_OBSERVERS(lcd_sub, bus_stat_lis),
+    ZBUS_MSG_INIT(0)
+);
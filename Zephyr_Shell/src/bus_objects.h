@@ -0,0 +1,79 @@
+#pragma once
+
+/*
+ * bus_objects.h — the zbus channels of the application and their observers.
+ *
+ * Same rule as lcd_objects.h: ZBUS_CHAN_DEFINE / ZBUS_LISTENER_DEFINE /
+ * ZBUS_MSG_SUBSCRIBER_DEFINE are iterable section macros too and live in
+ * bus_objects.c (a plain C file); the callbacks of the listeners are C++,
+ * in main.cpp and bus.cpp, with C linkage.
+ *
+ *   channel      message        published by            observed by
+ *   led_chan     LedStateMsg_t  led work                lcd_view_lis, bus_stat_lis
+ *   button_chan  ButtonMsg_t    button work (sw0)       lcd_view_lis, bus_stat_lis
+ *   lcd_chan     LcdMessage_t   LCD_Post()              lcd_sub, bus_stat_lis
+ *
+ * A publish stores the one message in the channel; the listeners run in the
+ * context of the publisher and read it in place (zbus_chan_const_msg), the
+ * LCD thread is a message subscriber: it gets every line in order, from the
+ * net_buf pool of CONFIG_ZBUS_MSG_SUBSCRIBER_NET_BUF_POOL_SIZE. Another
+ * observer is one more entry in ZBUS_OBSERVERS(), the producers are unchanged.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "lcd_objects.h"   /* LcdMessage_t */
+
+/* ── Messages ────────────────────────────────────────────────────────── */
+typedef struct {
+    bool     on;
+    uint32_t toggles;
+} LedStateMsg_t;
+
+typedef struct {
+    bool     pressed;
+    uint32_t presses;
+} ButtonMsg_t;
+
+/* ── Statistics of a channel (its user data) ─────────────────────────── */
+typedef struct {
+    atomic_t published;     /* counted by bus_stat_lis */
+    atomic_t failed;        /* publishes bus_publish() could not make */
+    atomic_t received;      /* taken by the message subscriber, bus_received() */
+    atomic_t peak;          /* most messages waiting for it, seen at a take */
+} BusChanStat_t;
+
+/* ── Channels and observers ──────────────────────────────────────────── */
+ZBUS_CHAN_DECLARE(led_chan, button_chan, lcd_chan);
+ZBUS_OBS_DECLARE(lcd_sub, lcd_view_lis, bus_stat_lis);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern BusChanStat_t led_chan_stat;
+extern BusChanStat_t button_chan_stat;
+extern BusChanStat_t lcd_chan_stat;
+
+/* lcd_view_lis (main.cpp): the LED state and the button as LCD lines */
+void lcd_view_cb(const struct zbus_channel *chan);
+
+/* bus_stat_lis (bus.cpp): one more publish of the channel */
+void bus_stat_cb(const struct zbus_channel *chan);
+
+/* zbus_chan_pub() counting the failures in the statistics of the channel */
+int bus_publish(const struct zbus_channel *chan, const void *msg, k_timeout_t timeout);
+
+/* a message of the channel taken by its message subscriber (lcd_sub) */
+void bus_received(const struct zbus_channel *chan);
+
+/* sysinfo: the messages of lcd_chan waiting for lcd_sub, its net_buf pool */
+void sys_info_queues(void);
+
+/* sw0 (if the devicetree has it) publishes button_chan, debounced */
+void bus_button_init(void);
+
+#ifdef __cplusplus
+}
+#endif
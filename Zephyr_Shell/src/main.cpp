@@ -5,18 +5,23 @@
 #include <new>
 
 #include "lcd_objects.h"   /* kernel objects defined in lcd_objects.c */
+#include "bus_objects.h"   /* zbus channels defined in bus_objects.c */
+#include "app_work.h"      /* periodic / one-shot work items */
 #include "hd44780_pcf8574.h"
 #include "ushell_core.h"
 #include "ushell_core_printout.h"
+#include "ushell_core_log.h"
 #include "uart_access.h"
 
-#define ENABLE_LCD      1U
+#ifndef ENABLE_LCD
+#define ENABLE_LCD      1U     /* 0U: the host builds (CMakeLists.txt) */
+#endif
 #define ENABLE_LED      1U
 #define ENABLE_SHELL    1U
 
 /* ── LCD public API — forward declaration ─────────────────────────────── */
 /* Provide a no-op fallback when LCD is disabled so any caller
- * (e.g. the LED thread) still links cleanly regardless of ENABLE_LCD. */
+ * (e.g. the LCD view listener) still links cleanly regardless of ENABLE_LCD. */
 #if (1 == ENABLE_LCD)
 void LCD_Post(uint8_t row, uint8_t col, const char *text);
 #else
@@ -38,19 +43,21 @@ static const struct gpio_dt_spec led = GPIO_DT_SPEC_GET(LED_NODE, gpios);
  *
  * Lower number = higher priority in Zephyr.
  *
- * LCD must be the most urgent of the three so it
- * always drains the queue before the LED thread can post the next item.
+ * LCD     4  — services lcd_chan, blocks on the I2C transfers
+ * Shell   6  — wakes instantly on any UART keypress
+ * Load    K_LOWEST_APPLICATION_THREAD_PRIO — the idle count of the load
+ *            command (libs/load_meter), runs when nothing else does
  *
- * LCD     4  — services the display queue; must run before LED can post
- * LED     5  — sleeps 99% of the time in k_msleep(3000)
- * Shell   6  — lowest, wakes instantly on any UART keypress
+ * The LED blink has no thread: it is the periodic work item "led" on the
+ * system work queue (app_work.h), it never blocks.
  */
 /* Stack sizes are defined in lcd_objects.h */
 
-#define LCD_PRIORITY        4   /* highest of the three — owns the queue  */
-#define LED_PRIORITY        5
+#define LCD_PRIORITY        4
 #define SHELL_PRIORITY      6
 
+#define LED_PERIOD_MS       3000U
+
 /* ── LCD hardware constants ───────────────────────────────────────────────
  *
   * Try 0x3F if you have a PCF8574A backpack instead of PCF8574.
@@ -59,9 +66,10 @@ static const struct gpio_dt_spec led = GPIO_DT_SPEC_GET(LED_NODE, gpios);
 #define LCD_COLS            16
 #define LCD_ROWS            2
 
-/* ── LCD message queue, semaphore, stacks, and thread data ──────────────
+/* ── Thread stacks and thread data ───────────────────────────────────────
  * Defined in lcd_objects.c (must be a .c file — see that file for why).
- * Declared via lcd_objects.h, already included above.
+ * Declared via lcd_objects.h, already included above. The zbus channels
+ * (LED state, button, LCD lines) are in bus_objects.c.
  */
 
 /* ── LCD driver storage ───────────────────────────────────────────────────
@@ -87,31 +95,60 @@ static HD44780_PCF8574 *lcd = nullptr;
 
 
 #if (1 == ENABLE_LED)
-/* ── LED thread ───────────────────────────────────────────────────────── */
-static void led_thread(void *p1, void *p2, void *p3)
+/* ── LED work ─────────────────────────────────────────────────────────── */
+static app_work_t led_work;
+static LedStateMsg_t led_state = { true, 0U };  /* configured active */
+
+static void led_blink(app_work_t *work)
 {
-    THREAD_UNUSED_ARGS;
+    ARG_UNUSED(work);
 
+    gpio_pin_toggle_dt(&led);
+    led_state.on = !led_state.on;
+    led_state.toggles++;
+    /* the observers of led_chan draw it on the LCD, count it, ... */
+    (void)bus_publish(&led_chan, &led_state, K_MSEC(100));
+}
+
+static void led_init(void)
+{
     if (!gpio_is_ready_dt(&led)) {
         printk("LED GPIO not ready\n");
         return;
     }
     gpio_pin_configure_dt(&led, GPIO_OUTPUT_ACTIVE);
+    app_work_init(&led_work, "led", LED_PERIOD_MS, led_blink);
+}
+#endif /*(1 == ENABLE_LED)*/
 
-    /* Block until LCD init is complete (or has given up).
-     * Either way the semaphore will be given, so LED always starts. */
-#if (1 == ENABLE_LCD)
-    k_sem_take(&lcd_ready_sem, K_FOREVER);
-#endif /*(1 == ENABLE_LCD)*/
+/* The LED starts blinking once the LCD init is complete (or has given up),
+ * its first toggle one period later. */
+static void led_start(void)
+{
+#if (1 == ENABLE_LED)
+    if (gpio_is_ready_dt(&led)) {
+        (void)app_work_schedule(&led_work, K_MSEC(LED_PERIOD_MS));
+    }
+#endif /*(1 == ENABLE_LED)*/
+}
 
-    int i = 0;
-    while (1) {
-        gpio_pin_toggle_dt(&led);
-        LCD_Post(1, 0, (i = 1 - i) == 0 ? "LED: ON         " : "LED: OFF        ");
-        k_msleep(3000);
+
+/* ── LCD view (lcd_view_lis) ──────────────────────────────────────────────
+ *
+ * A listener runs in the context of the publisher, the channel is locked
+ * meanwhile: it reads the message in place and publishes the line on
+ * lcd_chan (another channel) without waiting.
+ */
+extern "C" void lcd_view_cb(const struct zbus_channel *chan)
+{
+    if (&led_chan == chan) {
+        const LedStateMsg_t *state = (const LedStateMsg_t *)zbus_chan_const_msg(chan);
+        LCD_Post(1, 0, state->on ? "LED: ON         " : "LED: OFF        ");
+    } else if (&button_chan == chan) {
+        const ButtonMsg_t *button = (const ButtonMsg_t *)zbus_chan_const_msg(chan);
+        LCD_Post(0, 0, button->pressed ? "Button: pressed " : "System Ready    ");
     }
 }
-#endif /*(1 == ENABLE_LED)*/
 
 
 #if (1 == ENABLE_SHELL)
@@ -142,8 +179,8 @@ void LCD_Post(uint8_t row, uint8_t col, const char *text)
      *     reorder or coalesce the assignments in ways that interact badly
      *     with the k_msgq memcpy.
      *
-     * Zero-initialising the struct first guarantees every byte sent through
-     * the queue is deterministic, and the manual copy loop works on every
+     * Zero-initialising the struct first guarantees every byte published on
+     * lcd_chan is deterministic, and the manual copy loop works on every
      * Zephyr libc variant without any Kconfig requirement. */
     memset(&msg, 0, sizeof(msg));
     {
@@ -157,10 +194,12 @@ void LCD_Post(uint8_t row, uint8_t col, const char *text)
     msg.row = row;
     msg.col = col;
 
-    /* K_NO_WAIT: never block the caller. */
-    int ret = k_msgq_put(&lcd_queue, &msg, K_NO_WAIT);
+    /* K_NO_WAIT: never block the caller (a listener of another channel
+     * may be the one posting). Fails with the net_buf pool of lcd_sub
+     * exhausted: the LCD thread is behind. */
+    int ret = bus_publish(&lcd_chan, &msg, K_NO_WAIT);
     if (ret != 0) {
-        printk("LCD queue full — message dropped (row=%d)\n", row);
+        uSHELL_LOG_WARN("LCD publish failed (%d), message dropped (row %d)", ret, row);
     }
 }
 
@@ -215,7 +254,7 @@ static void lcd_thread_entry(void *p1, void *p2, void *p3)
         lcd->~HD44780_PCF8574();
         lcd = nullptr;
 
-        k_sem_give(&lcd_ready_sem);   /* unblock LED regardless */
+        led_start();                  /* blink regardless */
         return;
     }
 
@@ -226,17 +265,19 @@ static void lcd_thread_entry(void *p1, void *p2, void *p3)
     lcd->setCursor(0, 1);
     lcd->print("STM32F103");
 
-    /* Signal LED thread: display is ready, start posting messages */
-    k_sem_give(&lcd_ready_sem);
-    printk("Semaphore given — LED should start now\n");
+    /* Display is ready: the LED work starts publishing */
+    led_start();
+    printk("LED work scheduled\n");
 
     printk("LCD entering message loop\n");   /* sentinel — must appear in log */
 
+    const struct zbus_channel *chan;
     LcdMessage_t msg;
     while (1) {
-        /* Block forever until a message arrives.
-         * Any printk here will confirm the thread is alive and draining. */
-        if (k_msgq_get(&lcd_queue, &msg, K_FOREVER) == 0) {
+        /* Block forever until a line arrives: lcd_sub is a message
+         * subscriber, every publish of lcd_chan is kept in order. */
+        if ((zbus_sub_wait_msg(&lcd_sub, &chan, &msg, K_FOREVER) == 0) && (&lcd_chan == chan)) {
+            bus_received(chan);     /* the queue line of sysinfo */
             lcd->setCursor(msg.col, msg.row);
             lcd->print(msg.text);
         }
@@ -256,27 +297,15 @@ int main(void)
 
     printk("Entered main\n");
 
-#if (1 == ENABLE_LED)
+    bus_button_init();
+
     /* ── LED ──────────────────────────────────────────────────────────── */
-    printk("Starting led thread\n");
-    /* Check k_thread_create return value — a NULL tid means the
-     * thread was not created (e.g. out of thread objects or bad params). */
-    k_tid_t led_tid = k_thread_create(
-        &led_thread_data,
-        led_stack_area,
-        K_THREAD_STACK_SIZEOF(led_stack_area),
-        led_thread,
-        NULL, NULL, NULL,
-        LED_PRIORITY,
-        0,
-        K_NO_WAIT
-    );
-    if (!led_tid) {
-        printk("ERROR: failed to create LED thread\n");
-    } else {
-        k_thread_name_set(&led_thread_data, "led");
-    }
+#if (1 == ENABLE_LED)
+    led_init();
 #endif /*(1 == ENABLE_LED)*/
+#if (0 == ENABLE_LCD)
+    led_start();
+#endif /*(0 == ENABLE_LCD)*/
 
 
     /* ── LCD ──────────────────────────────────────────────────────────── */
@@ -294,9 +323,8 @@ int main(void)
     );
     if (!lcd_tid) {
         printk("ERROR: failed to create LCD thread\n");
-        /* Give the semaphore so the LED thread is never permanently blocked
-         * if LCD thread creation itself fails. */
-        k_sem_give(&lcd_ready_sem);
+        /* Start the LED here, its start in the LCD thread never comes */
+        led_start();
     } else {
         k_thread_name_set(&lcd_thread_data, "lcd");
     }
@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+"""
+Compare the five shells on workloads of their own: one run per board, one table of all
+Usage: python3 bench_matrix.py run /dev/ttyUSB0 --target freertos [--elf stm32app.elf]
+                                  [--manifest commands.json] [--count 50] [--bench] -o freertos.json
+       python3 bench_matrix.py table freertos.json threadx.json zephyr.json embassy.json rtic.json
+
+run measures from the host, through the console (pyserial):
+
+    round trip      a void command and its output until the prompt is back, --count times
+    echo            a key until its echo (erased again with DEL), --count times
+    bench           with --bench, the lines of `bench 0`: min/median/max cycles per row,
+                    the same names on every shell (the rows its kernel has)
+    footprint       with --elf, the flash (loaded segments at 0x08000000) and the static RAM
+                    (allocated sections at 0x20000000); the stacks the Rust runtimes take
+                    below the end of the RAM are not in a section and not counted
+
+The void command is the first of the target in the manifest of ushell_cmdgen.py
+(--manifest), vtest / init without it. table writes markdown: the host times in us (median,
+min..max), the footprint, and for every bench row the median cycles and their time at the
+clock of the board, '-' where a shell has no such row.
+"""
+
+import argparse
+import json
+import re
+import statistics
+import struct
+import sys
+import time
+
+ANSI = re.compile(rb'\x1b\[[0-9;?]*[ -/]*[@-~]')
+BENCH_CLOCK = re.compile(r'cycles at (\d+) MHz')
+BENCH_ROW = re.compile(r'^\s*(\d+) (\S.*?)\s+(\d+)\s+(\d+)\s+(\d+)\s*$')
+BENCH_FAILED = re.compile(r'^\s*(\d+) (\S.*?)\s+failed\s*$')
+DEFAULT_PROBE = {'cpp': 'vtest', 'rust': 'init'}
+LANGUAGES = {'freertos': 'cpp', 'threadx': 'cpp', 'zephyr': 'cpp', 'embassy': 'rust', 'rtic': 'rust'}
+TIMEOUT_S = 2.0
+QUIET_S = 0.5           # no more output: the bench lines of the Rust shells follow the prompt
+FLASH_BASE = 0x08000000
+RAM_BASE = 0x20000000
+SHF_ALLOC = 0x2
+PT_LOAD = 1
+
+
+class MatrixError(Exception):
+    pass
+
+
+# -- console -------------------------------------------------------------------------------
+
+def clean(data):
+    return ANSI.sub(b'', data).replace(b'\r', b'').decode('ascii', 'replace')
+
+
+def read_quiet(port, quiet=QUIET_S, limit=TIMEOUT_S * 5):
+    """everything up to `quiet` seconds without a byte"""
+    data, last, deadline = b'', time.monotonic(), time.monotonic() + limit
+    while time.monotonic() < deadline and time.monotonic() - last < quiet:
+        chunk = port.read(port.in_waiting or 1)
+        if chunk:
+            data, last = data + chunk, time.monotonic()
+    return data
+
+
+def read_until(port, done, timeout=TIMEOUT_S):
+    data, deadline = b'', time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        data += port.read(port.in_waiting or 1)
+        if done(data):
+            return data
+    raise MatrixError(f"no answer, got {data[-80:]!r}")
+
+
+def detect_prompt(port):
+    """the last line an Enter leaves on the console"""
+    port.reset_input_buffer()
+    port.write(b'\r')
+    lines = [line for line in clean(read_quiet(port)).split('\n') if line.strip()]
+    if not lines:
+        raise MatrixError("no prompt after an Enter")
+    return lines[-1]
+
+
+def summary(values):
+    return {'min': min(values), 'median': statistics.median(values), 'max': max(values)}
+
+
+def round_trip(port, probe, prompt, count):
+    line = (probe + '\r').encode()
+    times = []
+    for _ in range(count):
+        port.reset_input_buffer()
+        start = time.perf_counter()
+        port.write(line)
+        read_until(port, lambda data: clean(data).endswith(prompt) and probe in clean(data))
+        times.append((time.perf_counter() - start) * 1e6)
+    return summary(times)
+
+
+def echo(port, count):
+    times = []
+    for _ in range(count):
+        port.reset_input_buffer()
+        start = time.perf_counter()
+        port.write(b'x')
+        read_until(port, lambda data: b'x' in data)
+        times.append((time.perf_counter() - start) * 1e6)
+        port.write(b'\x7f')
+        read_quiet(port, quiet=0.05)
+    return summary(times)
+
+
+def bench(port):
+    port.reset_input_buffer()
+    port.write(b'bench 0\r')
+    text = clean(read_quiet(port))
+    clock = BENCH_CLOCK.search(text)
+    if not clock:
+        raise MatrixError(f"no bench header, got {text[-120:]!r}")
+    rows = {}
+    for line in text.split('\n'):
+        row = BENCH_ROW.match(line)
+        if row:
+            rows[row.group(2)] = {'min': int(row.group(3)), 'median': int(row.group(4)),
+                                  'max': int(row.group(5))}
+        elif BENCH_FAILED.match(line):
+            rows[BENCH_FAILED.match(line).group(2)] = None
+    return int(clock.group(1)), rows
+
+
+# -- ELF footprint -------------------------------------------------------------------------
+
+def footprint(filename):
+    """flash and static RAM bytes of a 32 bit little endian ELF"""
+    with open(filename, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4] != 1 or elf[5] != 1:
+        raise MatrixError(f"{filename}: not a 32 bit little endian ELF")
+    e_phoff, e_shoff = struct.unpack_from('<II', elf, 0x1C)
+    e_phentsize, e_phnum, e_shentsize, e_shnum = struct.unpack_from('<HHHH', elf, 0x2A)
+
+    flash = 0
+    for i in range(e_phnum):
+        p_type, _, _, p_paddr, p_filesz = struct.unpack_from('<IIIII', elf, e_phoff + i * e_phentsize)
+        if p_type == PT_LOAD and (p_paddr & 0xFF000000) == FLASH_BASE:
+            flash += p_filesz
+
+    ram = 0
+    for i in range(e_shnum):
+        _, _, sh_flags, sh_addr, _, sh_size = struct.unpack_from('<IIIIII', elf, e_shoff + i * e_shentsize)
+        if (sh_flags & SHF_ALLOC) and (sh_addr & 0xFF000000) == RAM_BASE:
+            ram += sh_size
+    return {'flash': flash, 'ram': ram}
+
+
+# -- commands ------------------------------------------------------------------------------
+
+def probe_of(target, language, manifest):
+    if manifest:
+        with open(manifest, 'r') as f:
+            commands = json.load(f)['targets'][target]['commands']
+        for command in commands:
+            if not command['params']:
+                return command['name']
+    return DEFAULT_PROBE[language]
+
+
+def run(args):
+    import serial
+
+    language = LANGUAGES.get(args.target, args.language)
+    if language not in DEFAULT_PROBE:
+        raise MatrixError(f"target '{args.target}': give --language cpp or rust")
+    result = {'target': args.target, 'language': language, 'baud': args.baud, 'samples': args.count}
+    if args.elf:
+        result['footprint'] = footprint(args.elf)
+
+    with serial.Serial(args.port, args.baud, timeout=0.05) as port:
+        prompt = detect_prompt(port)
+        probe = probe_of(args.target, language, args.manifest)
+        result.update({'prompt': prompt, 'probe': probe})
+        result['round_trip_us'] = round_trip(port, probe, prompt, args.count)
+        result['echo_us'] = echo(port, args.count)
+        if args.bench:
+            result['cpu_mhz'], result['bench'] = bench(port)
+
+    with open(args.output, 'w') as f:
+        json.dump(result, f, indent=2)
+        f.write('\n')
+    print(f"{args.target}: round trip {result['round_trip_us']['median']:.0f} us, "
+          f"echo {result['echo_us']['median']:.0f} us -> {args.output}")
+
+
+def us(times):
+    if not times:
+        return '-'
+    return f"{times['median']:.0f} ({times['min']:.0f}..{times['max']:.0f})"
+
+
+def table(args):
+    results = []
+    for filename in args.results:
+        with open(filename, 'r') as f:
+            results.append(json.load(f))
+
+    head = '| | ' + ' | '.join(r['target'] for r in results) + ' |'
+    rule = '|---' * (len(results) + 1) + '|'
+    lines = [head, rule]
+    lines.append('| round trip us | ' + ' | '.join(us(r.get('round_trip_us')) for r in results) + ' |')
+    lines.append('| echo us | ' + ' | '.join(us(r.get('echo_us')) for r in results) + ' |')
+    for key, label in (('flash', 'flash bytes'), ('ram', 'static RAM bytes')):
+        cells = [str(r['footprint'][key]) if 'footprint' in r else '-' for r in results]
+        lines.append(f"| {label} | " + ' | '.join(cells) + ' |')
+    lines.append('| clock MHz | ' + ' | '.join(str(r.get('cpu_mhz', '-')) for r in results) + ' |')
+
+    names = []
+    for r in results:
+        names.extend(name for name in r.get('bench', {}) if name not in names)
+    for name in names:
+        cells = []
+        for r in results:
+            rows = r.get('bench', {})
+            if name not in rows:
+                cells.append('-')
+            elif rows[name] is None:
+                cells.append('failed')
+            else:
+                cycles = rows[name]['median']
+                cells.append(f"{cycles} cyc / {cycles / r['cpu_mhz']:.2f} us")
+        lines.append(f"| {name} | " + ' | '.join(cells) + ' |')
+    print('\n'.join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare the shells: host latencies, footprint, bench rows')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('run', help='measure one board')
+    p.add_argument('port', help='serial port of the console')
+    p.add_argument('--target', required=True, help='freertos, threadx, zephyr, embassy, rtic (or a name of yours)')
+    p.add_argument('--language', help='cpp or rust, for a target not in the list')
+    p.add_argument('--baud', type=int, default=115200)
+    p.add_argument('--count', type=int, default=50, help='samples of the round trip and of the echo')
+    p.add_argument('--manifest', help='commands.json of ushell_cmdgen.py --manifest')
+    p.add_argument('--elf', help='the image of the build, for its footprint')
+    p.add_argument('--bench', action='store_true', help='run bench 0 (a build with the bench rows)')
+    p.add_argument('-o', '--output', required=True, help='JSON of the run')
+    p.set_defaults(func=run)
+
+    p = sub.add_parser('table', help='markdown table of runs')
+    p.add_argument('results', nargs='+', help='JSON files of bench_matrix.py run')
+    p.set_defaults(func=table)
+
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except (MatrixError, OSError, KeyError, ValueError) as error:
+        print(f"bench_matrix: {error}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,292 @@
+#!/usr/bin/env python3
+"""
+Generate the command tables of the C++ and the Rust shells from one definition
+Usage: python3 ushell_cmdgen.py [--check] [--manifest commands.json] ushell_commands.def
+
+Every target of the definition gets its table written in the format of its language:
+
+    cpp     ushell_root_commands.cfg, the uSHELL_COMMAND_PARAMS_PATTERN / uSHELL_COMMAND
+            X-macros, a section per parameters pattern (the ones of the target only)
+    rust    commands.cfg, the descriptor DSL of generate_commands_dispatcher_from_file!
+            ("<descriptor> : <path> <path>, ..."), CRLF like the rest of the Rust trees
+
+The parameters are written in types of their own (u32, str, bool ...), each language has
+its letters for them; a command using a type its language does not have is an error.
+
+--check writes nothing, it fails when a table differs from what would be generated.
+--manifest writes the definitions as JSON for the host tools, per target: name, parameters
+(the portable types and the pattern of the language), help and, for the C++ ones, the
+index of the binary frames (SOF | LEN | IDX | ARGS | CRC16) with the size of every
+argument on the wire (the layout of ush2bc.py too).
+"""
+
+import argparse
+import json
+import os
+import shlex
+import sys
+
+# portable type: (C++ letter, C++ params type, C++ section name, Rust letter, wire size)
+# wire size: bytes of a packed little endian value, 'cstr' NUL terminated, 'rest' the
+# rest of the frame in 32 bit values (an array is the last parameter), 'bytes8' a length
+# byte and the raw bytes
+TYPES = {
+    'u8':    ('b', 'num8_t',     '8 bit',                'B', 1),
+    'u16':   ('w', 'num16_t',    '16 bit',               'W', 2),
+    'u32':   ('i', 'num32_t',    'integer',              'D', 4),
+    'u64':   ('l', 'num64_t',    'long',                 'Q', 8),
+    'i8':    (None, None, None,                          'b', None),
+    'i16':   (None, None, None,                          'w', None),
+    'i32':   (None, None, None,                          'd', None),
+    'i64':   (None, None, None,                          'q', None),
+    'u128':  (None, None, None,                          'X', None),
+    'i128':  (None, None, None,                          'x', None),
+    'usize': (None, None, None,                          'Z', None),
+    'isize': (None, None, None,                          'z', None),
+    'f32':   ('f', 'numfp_t',    'float',                'f', 4),
+    'f64':   (None, None, None,                          'F', None),
+    'bool':  ('o', 'bool',       'bool',                 't', 1),
+    'char':  (None, None, None,                          'c', None),
+    'str':   ('s', 'str_t*',     'string',               's', 'cstr'),
+    'hex':   ('x', 'hexbuf_s',   'hex -> bytes',         'h', 'bytes8'),
+    'fixq':  ('q', 'numq_t',     'fixed point',          None, 4),
+    'view':  ('r', 'strview_s',  'range -> string view', None, 'cstr'),
+    'array': ('a', 'numarray_s', 'array of integers',    None, 'rest'),
+}
+
+# the C++ types the profiles leave out by default, their patterns are compiled in by
+# the setting only (and come last, the binary indexes of the others do not move)
+CPP_GUARDS = {
+    'r': 'uSHELL_IMPLEMENTS_STRING_VIEWS',
+    'a': 'uSHELL_IMPLEMENTS_NUMBER_ARRAYS',
+    'q': 'uSHELL_IMPLEMENTS_NUMBERS_FIXED',
+    'x': 'uSHELL_IMPLEMENTS_HEX_BUFFERS',
+}
+
+CPP_WIDTH = 104
+CPP_RULE = '/*' + '=' * 101 + '*/'
+CPP_DASH = '/*' + '-' * 101 + '*/'
+CPP_GAP = '\n' * 5
+
+
+class GenError(Exception):
+    pass
+
+
+class Command:
+    def __init__(self, name, params, targets, text, path, line):
+        self.name = name
+        self.params = params
+        self.targets = targets
+        self.text = text
+        self.path = path
+        self.line = line
+
+    def pattern(self, language):
+        column = 0 if language == 'cpp' else 3
+        letters = ''.join(TYPES[p][column] for p in self.params)
+        return letters or 'v'
+
+
+def read_definition(filename):
+    targets, commands = {}, []
+    with open(filename, 'r') as f:
+        for number, text in enumerate(f, 1):
+            where = f"{filename}:{number}"
+            try:
+                fields = shlex.split(text, comments=True)
+            except ValueError as error:
+                raise GenError(f"{where}: {error}")
+            if not fields:
+                continue
+            if fields[0] == 'target' and len(fields) == 4:
+                name, language, table = fields[1:]
+                if language not in ('cpp', 'rust'):
+                    raise GenError(f"{where}: language '{language}', not cpp or rust")
+                path = os.path.normpath(os.path.join(os.path.dirname(filename), table))
+                targets[name] = (language, path)
+            elif fields[0] == 'command' and len(fields) in (5, 6):
+                name, params, names, help_text = fields[1:5]
+                path = fields[5] if len(fields) == 6 else f"crate::uc::{name}"
+                params = [] if params == '-' else params.split(',')
+                for param in params:
+                    if param not in TYPES:
+                        raise GenError(f"{where}: unknown parameter type '{param}'")
+                if 'array' in params[:-1]:
+                    raise GenError(f"{where}: an array is the last parameter")
+                commands.append(Command(name, params, names.split(','), help_text, path, where))
+            else:
+                raise GenError(f"{where}: expected 'target <name> <cpp|rust> <table>' or "
+                               f"'command <name> <params> <targets> \"<help>\" [<path>]'")
+    if not targets:
+        raise GenError(f"{filename}: no target")
+    return targets, commands
+
+
+def commands_of(target, language, targets, commands):
+    """the commands of a target, in the order of the definition"""
+    selected, names = [], set()
+    for command in commands:
+        wanted = set()
+        for name in command.targets:
+            if name == 'all':
+                wanted.update(targets)
+            elif name in ('cpp', 'rust'):
+                wanted.update(t for t, (l, _) in targets.items() if l == name)
+            elif name in targets:
+                wanted.add(name)
+            else:
+                raise GenError(f"{command.line}: unknown target '{name}'")
+        if target not in wanted:
+            continue
+        if command.name in names:
+            raise GenError(f"{command.line}: '{command.name}' defined twice for {target}")
+        column = 0 if language == 'cpp' else 3
+        missing = [p for p in command.params if TYPES[p][column] is None]
+        if missing:
+            raise GenError(f"{command.line}: no {', '.join(missing)} in the {language} shell ({target})")
+        names.add(command.name)
+        selected.append(command)
+    return selected
+
+
+def cpp_patterns(commands):
+    """patterns in the order they first appear, the guarded ones last; with their commands"""
+    patterns = {}
+    for command in commands:
+        patterns.setdefault(command.pattern('cpp'), []).append(command)
+    guarded = lambda pattern: any(letter in CPP_GUARDS for letter in pattern)
+    return sorted(patterns.items(), key=lambda item: guarded(item[0]))
+
+
+def cpp_table(commands):
+    out = ['uSHELL_COMMANDS_TABLE_BEGIN\n']
+    letters = {TYPES[t][0]: t for t in TYPES if TYPES[t][0]}
+
+    for pattern, group in cpp_patterns(commands):
+        types = [letters[letter] for letter in pattern] if pattern != 'v' else []
+        if types:
+            label = 'Parameter' if len(types) == 1 else 'Parameters'
+            names = ', '.join(TYPES[t][2] for t in types)
+            title = f"{label}: {','.join(pattern)} ({names})"
+            params = ','.join(TYPES[t][1] for t in types)
+        else:
+            title, params = 'Parameter: v (void)', 'void'
+        guards = sorted({CPP_GUARDS[letter] for letter in pattern if letter in CPP_GUARDS})
+        condition = ' && '.join(f"defined({g})" for g in guards)
+
+        out.append('\n\n' if len(out) == 1 else CPP_GAP)
+        out.append(CPP_RULE + '\n')
+        out.append('/*' + (' ' * 42 + title).ljust(101) + '*/\n')
+        out.append(CPP_RULE + '\n')
+        if guards:
+            out.append(f"#if {condition}\n")
+        out.append(f"uSHELL_COMMAND_PARAMS_PATTERN({pattern})\n")
+        out.append(f"#ifndef {pattern}_params\n")
+        define = f"#define {pattern}_params"
+        out.append(define + params.rjust(CPP_WIDTH + 1 - len(define)) + '\n')
+        out.append('#endif\n')
+        out.append(CPP_DASH + '\n')
+        for command in group:
+            head = f"uSHELL_COMMAND({command.name},"
+            text = command.text.replace('\\', '\\\\').replace('"', '\\"')    # a C string literal
+            out.append(head + pattern.rjust(CPP_WIDTH - len(head)) + f', "{text}")\n')
+        if guards:
+            out.append(f"#endif /* {condition} */\n")
+
+    out.append(CPP_GAP)
+    out.append(CPP_RULE + '\n')
+    out.append('/*' + (' ' * 42 + 'Generated by ushell_cmdgen.py').ljust(101) + '*/\n')
+    out.append(CPP_RULE + '\n')
+    out.append('// a new command (or pattern): ushell_core/ushell_commands.def, then run\n')
+    out.append('// python3 ushell_core/tools/ushell_cmdgen.py ushell_core/ushell_commands.def\n')
+    out.append('\n\n\n')
+    out.append('uSHELL_COMMANDS_TABLE_END\n')
+    return ''.join(out)
+
+
+def rust_table(commands):
+    """no comments: the DSL has none"""
+    groups = {}
+    for command in commands:
+        groups.setdefault(command.pattern('rust'), []).append(command.path)
+    lines = []
+    for pattern, paths in groups.items():
+        lines.append(f"{pattern.ljust(6)}: {paths[0]}")
+        lines.extend(' ' * 8 + path for path in paths[1:])
+        lines[-1] += ','
+    return '\r\n'.join(lines)
+
+
+def manifest(targets, commands):
+    result = {'targets': {}}
+    for target, (language, _) in targets.items():
+        selected = commands_of(target, language, targets, commands)
+        entries = []
+        if language == 'cpp':
+            ordered = [c for _, group in cpp_patterns(selected) for c in group]
+        else:
+            ordered = selected
+        for index, command in enumerate(ordered):
+            entry = {
+                'name': command.name,
+                'params': command.params,
+                'pattern': command.pattern(language),
+                'help': command.text,
+            }
+            if language == 'cpp':
+                # the index of the binary frames holds while the guarded patterns
+                # before it are compiled in
+                entry['index'] = index
+                entry['wire'] = [TYPES[p][4] for p in command.params]
+                guards = sorted({CPP_GUARDS[l] for l in entry['pattern'] if l in CPP_GUARDS})
+                if guards:
+                    entry['requires'] = guards
+            entries.append(entry)
+        result['targets'][target] = {
+            'language': language,
+            'binary': language == 'cpp',
+            'commands': entries,
+        }
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate the C++ and Rust command tables from one definition')
+    parser.add_argument('definition', help='ushell_commands.def')
+    parser.add_argument('--check', action='store_true', help='fail if a table is out of date, write nothing')
+    parser.add_argument('--manifest', help='write the definitions as JSON for the host tools')
+    args = parser.parse_args()
+
+    try:
+        targets, commands = read_definition(args.definition)
+        stale = []
+        for target, (language, path) in targets.items():
+            selected = commands_of(target, language, targets, commands)
+            text = cpp_table(selected) if language == 'cpp' else rust_table(selected)
+            current = None
+            if os.path.exists(path):
+                with open(path, 'r', newline='') as f:
+                    current = f.read()
+            if current == text:
+                continue
+            if args.check:
+                stale.append(path)
+            else:
+                with open(path, 'w', newline='') as f:
+                    f.write(text)
+                print(f"{target}: {path} ({len(selected)} commands)")
+        if args.manifest:
+            with open(args.manifest, 'w') as f:
+                json.dump(manifest(targets, commands), f, indent=2)
+                f.write('\n')
+        if stale:
+            raise GenError('out of date: ' + ', '.join(stale))
+    except (GenError, OSError) as error:
+        print(f"ushell_cmdgen: {error}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
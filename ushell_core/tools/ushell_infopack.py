@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""
+Learn the byte pairs of the packed help texts (uSHELL_IMPLEMENTS_PACKED_HELP)
+Usage: python3 ushell_infopack.py [--check] [-o ushell_core_info_pairs.cfg] [cfg ...]
+
+The help of the commands, of the user shortcuts and the caption of the core shortcuts are
+packed by the compiler (ushell_core_utils.h) with a table of up to 128 pairs: the code
+0x80 + n stands for the two bytes of the pair n, a byte or a code of an earlier pair each.
+The pairs are applied in their order, every pair once over the text from the left, the same
+way here and in the constexpr packer; the core expands the codes straight into the output.
+
+The pairs are learned over all the tables given (the root commands and shortcuts of the
+three trees and the core caption without any), most frequent pair first while it saves
+a byte (3 uses for its 2 bytes in the table). No pair holds the '|' of the help (the short
+help ends there) and a code expands to at most 8 levels of pairs (the stack of the core).
+
+--check writes nothing, it fails when the table differs from what would be learned; the
+sizes are printed in both cases.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+PAIRS_MAX = 128
+DEPTH_MAX = 8
+MIN_USES = 3
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+CORE = os.path.join(ROOT, 'ushell_core', 'ushell_core', 'src', 'ushell_core.cpp')
+OUTPUT = os.path.join(ROOT, 'ushell_core', 'ushell_core_config', 'inc', 'ushell_core_info_pairs.cfg')
+TABLES = [
+    'FreeRTOS_Shell/sources/sources/ushell/ushell_user/ushell_user_root/inc/ushell_root_commands.cfg',
+    'FreeRTOS_Shell/sources/sources/ushell/ushell_user/ushell_user_root/inc/ushell_root_shortcuts.cfg',
+    'ThreadX_Shell/sources/sources/ushell/ushell_user/ushell_user_root/inc/ushell_root_commands.cfg',
+    'ThreadX_Shell/sources/sources/ushell/ushell_user/ushell_user_root/inc/ushell_root_shortcuts.cfg',
+    'Zephyr_Shell/libs/ushell/ushell_user/ushell_user_root/inc/ushell_root_commands.cfg',
+    'Zephyr_Shell/libs/ushell/ushell_user/ushell_user_root/inc/ushell_root_shortcuts.cfg',
+]
+
+LITERAL = re.compile(r'"((?:[^"\\]|\\.)*)"')
+ESCAPES = {'n': 10, 'r': 13, 't': 9, '\\': 92, '"': 34, "'": 39, '0': 0}
+
+
+def unescape(text):
+    out, i = bytearray(), 0
+    while i < len(text):
+        if text[i] != '\\':
+            out.append(ord(text[i]))
+            i += 1
+        elif text[i + 1] == 'x':
+            digits = re.match(r'[0-9a-fA-F]+', text[i + 2:]).group(0)
+            out.append(int(digits, 16))
+            i += 2 + len(digits)
+        else:
+            out.append(ESCAPES[text[i + 1]])
+            i += 2
+    return bytes(out)
+
+
+def table_texts(filename):
+    """the help of every uSHELL_COMMAND / uSHELL_USER_(HOT_)SHORTCUT line"""
+    texts = []
+    with open(filename) as f:
+        for line in f:
+            if re.match(r'\s*uSHELL_(COMMAND|USER_SHORTCUT|USER_HOT_SHORTCUT)\(', line):
+                literals = LITERAL.findall(line)
+                if literals:
+                    texts.append(b''.join(unescape(s) for s in literals))
+    return texts
+
+
+def caption_text(filename):
+    """the core shortcuts caption, all of its optional lines"""
+    with open(filename) as f:
+        source = f.read()
+    start = source.index('s_vstrCoreShortcutCaption[] =')
+    body = source[start:source.index(';', start)]
+    return [b''.join(unescape(s) for s in LITERAL.findall(body))]
+
+
+def apply_pair(text, pair, code):
+    out, i = bytearray(), 0
+    while i < len(text):
+        if (i + 1 < len(text)) and (text[i] == pair[0]) and (text[i + 1] == pair[1]):
+            out.append(code)
+            i += 2
+        else:
+            out.append(text[i])
+            i += 1
+    return bytes(out)
+
+
+def learn(texts):
+    pairs, depth = [], {}
+    while len(pairs) < PAIRS_MAX:
+        counts = {}
+        for text in texts:
+            for a, b in zip(text, text[1:]):
+                if (ord('|') not in (a, b)) and (max(depth.get(a, 0), depth.get(b, 0)) < DEPTH_MAX):
+                    counts[(a, b)] = counts.get((a, b), 0) + 1
+        if not counts:
+            break
+        pair, uses = max(counts.items(), key=lambda item: (item[1], -item[0][0], -item[0][1]))
+        if uses < MIN_USES:
+            break
+        code = 0x80 + len(pairs)
+        texts = [apply_pair(text, pair, code) for text in texts]
+        depth[code] = 1 + max(depth.get(pair[0], 0), depth.get(pair[1], 0))
+        pairs.append(pair)
+    return pairs, texts
+
+
+def expand(pairs, code):
+    if code < 0x80:
+        return bytes([code])
+    a, b = pairs[code - 0x80]
+    return expand(pairs, a) + expand(pairs, b)
+
+
+def show(byte):
+    if byte >= 0x80:
+        return f'0x{byte:02X}'
+    if chr(byte) in '\\\'':
+        return f"'\\{chr(byte)}'"
+    if 0x20 <= byte < 0x7F:
+        return f"'{chr(byte)}'"
+    return {9: "'\\t'", 10: "'\\n'", 13: "'\\r'"}.get(byte, f'0x{byte:02X}')
+
+
+def render(pairs):
+    out = ["uSHELL_INFO_PAIRS_TABLE_BEGIN\n\n",
+           "/* generated by ushell_core/tools/ushell_infopack.py, the code of a pair is 0x80 + its index */\n\n"]
+    for n, (a, b) in enumerate(pairs):
+        text = expand(pairs, 0x80 + n).decode('ascii').encode('unicode_escape').decode('ascii').replace('*/', '*\\/')
+        out.append(f"uSHELL_INFO_PAIR( {show(a):>6}, {show(b):>6} )    /* 0x{0x80 + n:02X} \"{text}\" */\n")
+    out.append("\nuSHELL_INFO_PAIRS_TABLE_END\n")
+    return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Learn the byte pairs of the packed help texts')
+    parser.add_argument('tables', nargs='*', help='command / shortcut tables, the root ones of the trees without any')
+    parser.add_argument('-o', '--output', default=OUTPUT, help='the pairs table, ushell_core_info_pairs.cfg')
+    parser.add_argument('--check', action='store_true', help='fail if the pairs table is out of date, write nothing')
+    args = parser.parse_args()
+
+    texts = caption_text(CORE)
+    for table in (args.tables or [os.path.join(ROOT, t) for t in TABLES]):
+        texts += table_texts(table)
+    for text in texts:
+        if any((byte == 0) or (byte >= 0x80) for byte in text):
+            print(f"ushell_infopack: not 7 bit ASCII: {text!r}", file=sys.stderr)
+            return 1
+
+    pairs, packed = learn(texts)
+    raw_size = sum(len(t) + 1 for t in texts)
+    packed_size = sum(len(t) + 1 for t in packed) + 2 * len(pairs)
+    print(f"ushell_infopack: {len(texts)} texts, {raw_size} bytes, packed {packed_size} with the "
+          f"{len(pairs)} pairs ({100 - (100 * packed_size) // raw_size}% less)")
+
+    table = render(pairs)
+    if args.check:
+        with open(args.output) as f:
+            if f.read() != table:
+                print(f"ushell_infopack: {args.output} is out of date", file=sys.stderr)
+                return 1
+        return 0
+    with open(args.output, 'w') as f:
+        f.write(table)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
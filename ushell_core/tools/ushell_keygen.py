@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+"""
+Generate the key decoder table of the Rust shells from the escape sequences of the C++ core
+Usage: python3 ushell_keygen.py [--check] [--define NAME] ushell_core_escape.cfg key_table.rs ...
+
+The C++ core builds its trie from ushell_core_escape.cfg at compile time (ushell_core.cpp,
+m_EscapeFeed()); the Rust shells (ushell2 input::key_reader) decode the same sequences with a
+state machine written here as two tables in flash:
+
+    CLASS[byte]             the class of the byte, the bytes which behave the same in every
+                            state share one, ~30 of them
+    NEXT[state][class]      the next state in the low byte, the action in the high one:
+                            0 none, 1 the byte as Key::Char, 2 + i the key KEYS[i]
+
+State 0 is the ground (plain keys), 1 the introducer (ESC) seen, then one state per inner node
+of the trie and the skip state last (the rest of an unknown CSI, up to its final byte). A byte
+costs the two loads whatever the state, the rules are those of m_EscapeFeed():
+
+    - ESC starts a new sequence, the one on its way is dropped
+    - a control byte ends the sequence and is handled as a plain key
+    - a byte not in the table right after the ESC is a plain key (Alt+key, the ESC dropped)
+    - a byte not in the table inside a CSI skips the rest of it up to its final byte
+      (0x40 .. 0x7E), inside any other sequence it ends it
+
+The preprocessor of the .cfg is evaluated for the --define names (none: the xterm / VT100 rows,
+ESC [ F for End), a sequence which is the start of another one is an error as in the core.
+
+--check writes nothing, it fails when a table differs from what would be generated.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+ESC = 0x1B
+GROUND, INTRO = 0, 1
+NONE, CHAR = 0, 1
+
+# ushell_core_keys.h uSHELL_ESCKEY_* -> key_reader::Key
+KEYS = {
+    'UP':       'ArrowUp',
+    'DOWN':     'ArrowDown',
+    'RIGHT':    'ArrowRight',
+    'LEFT':     'ArrowLeft',
+    'HOME':     'Home',
+    'END':      'End',
+    'INSERT':   'Insert',
+    'DELETE':   'Delete',
+    'PAGEUP':   'PageUp',
+    'PAGEDOWN': 'PageDown',
+    'SHIFTTAB': 'ShiftTab',
+}
+
+# the plain keys of the ground state, the printable bytes are Key::Char
+PLAIN = {
+    0x15: 'CtrlU',
+    0x0B: 'CtrlK',
+    0x04: 'CtrlD',
+    0x0E: 'CtrlN',
+    0x10: 'CtrlP',
+    0x0D: 'Enter',
+    0x0A: 'Enter',
+    0x09: 'Tab',
+    0x7F: 'Backspace',
+    0x08: 'Backspace',
+}
+
+
+class GenError(Exception):
+    pass
+
+
+def c_bytes(literal, where):
+    out, pos = [], 0
+    while pos < len(literal):
+        if literal[pos] != '\\':
+            out.append(ord(literal[pos]))
+            pos += 1
+            continue
+        hexa = re.match(r'\\x([0-9A-Fa-f]{1,2})', literal[pos:])
+        if hexa:
+            out.append(int(hexa.group(1), 16))
+            pos += len(hexa.group(0))
+        elif pos + 1 < len(literal) and literal[pos + 1] in '\\"\'':
+            out.append(ord(literal[pos + 1]))
+            pos += 2
+        else:
+            raise GenError(f"{where}: escape '{literal[pos:pos + 2]}' not supported")
+    return bytes(out)
+
+
+def condition(text, defines, where):
+    expr = re.sub(r'defined\s*\(\s*(\w+)\s*\)', lambda m: str(m.group(1) in defines), text)
+    expr = expr.replace('||', ' or ').replace('&&', ' and ')
+    expr = re.sub(r'!(?!=)', ' not ', expr)
+    if re.search(r'[^\sA-Za-z()]', expr) or set(re.findall(r'\w+', expr)) - {'True', 'False', 'and', 'or', 'not'}:
+        raise GenError(f"{where}: '#if {text}' not supported")
+    return eval(expr, {'__builtins__': {}})
+
+
+def read_sequences(filename, defines):
+    with open(filename, 'r') as f:
+        text = f.read()
+    text = re.sub(r'/\*.*?\*/', lambda m: '\n' * m.group(0).count('\n'), text, flags=re.S)
+    stack, sequences = [], []
+    for number, line in enumerate(text.split('\n'), 1):
+        where = f"{filename}:{number}"
+        line = line.strip()
+        active = all(taken for taken, _ in stack)
+        if line.startswith('#if'):
+            taken = condition(line[3:], defines, where) if active else False
+            stack.append((taken, taken))
+        elif line.startswith('#else'):
+            if not stack:
+                raise GenError(f"{where}: #else without #if")
+            _, done = stack.pop()
+            stack.append((not done, True))
+        elif line.startswith('#endif'):
+            if not stack:
+                raise GenError(f"{where}: #endif without #if")
+            stack.pop()
+        elif line.startswith('uSHELL_ESCAPE_SEQ') and active:
+            row = re.match(r'uSHELL_ESCAPE_SEQ\s*\(\s*"((?:[^"\\]|\\.)*)"\s*,\s*(\w+)\s*\)$', line)
+            if not row:
+                raise GenError(f"{where}: expected uSHELL_ESCAPE_SEQ(\"<bytes>\", <KEY>)")
+            if row.group(2) not in KEYS:
+                raise GenError(f"{where}: key '{row.group(2)}' has no key_reader::Key")
+            sequences.append((c_bytes(row.group(1), where), row.group(2), where))
+    if stack:
+        raise GenError(f"{filename}: #if without #endif")
+    if not sequences:
+        raise GenError(f"{filename}: no sequence")
+    return sequences
+
+
+def build(sequences):
+    """the trie of the sequences as states, then the rows of every state for the 256 bytes"""
+    keys = []
+    children = [{}]                 # per inner node: byte -> ('node', index) | ('key', name)
+    csi = [False]
+    for seq, key, where in sequences:
+        if key not in keys:
+            keys.append(key)
+        node = 0
+        for pos, byte in enumerate(seq):
+            step = children[node].get(byte)
+            last = pos == len(seq) - 1
+            if step is not None and (step[0] == 'key' or last):
+                raise GenError(f"{where}: a sequence is the start of another one")
+            if last:
+                children[node][byte] = ('key', key)
+            elif step is None:
+                children.append({})
+                csi.append(csi[node] or (node == 0 and byte == ord('[')))
+                children[node][byte] = ('node', len(children) - 1)
+                node = len(children) - 1
+            else:
+                node = step[1]
+
+    skip = len(children) + 1        # ground, then the nodes from INTRO on, then skip
+    action = lambda key: 2 + keys.index(key)
+
+    ground = []
+    for byte in range(256):
+        if byte == ESC:
+            ground.append((INTRO, NONE))
+        elif byte in PLAIN:
+            ground.append((GROUND, 2 + len(keys) + sorted(set(PLAIN.values())).index(PLAIN[byte])))
+        elif 0x20 <= byte < 0x7F:
+            ground.append((GROUND, CHAR))
+        else:
+            ground.append((GROUND, NONE))
+
+    rows = [ground]
+    for node, inner in enumerate(children):
+        row = []
+        for byte in range(256):
+            step = inner.get(byte)
+            if byte == ESC:
+                row.append((INTRO, NONE))
+            elif byte < 0x20:
+                row.append(ground[byte])
+            elif step is not None:
+                row.append((GROUND, action(step[1])) if step[0] == 'key' else (INTRO + step[1], NONE))
+            elif node == 0:
+                row.append(ground[byte])
+            elif csi[node] and not 0x40 <= byte <= 0x7E:
+                row.append((skip, NONE))
+            else:
+                row.append((GROUND, NONE))
+        rows.append(row)
+    row = []
+    for byte in range(256):
+        if byte == ESC:
+            row.append((INTRO, NONE))
+        elif byte < 0x20:
+            row.append(ground[byte])
+        elif 0x40 <= byte <= 0x7E:
+            row.append((GROUND, NONE))
+        else:
+            row.append((skip, NONE))
+    rows.append(row)
+
+    if len(rows) > 256 or 2 + len(keys) + len(set(PLAIN.values())) > 256:
+        raise GenError('too many states or keys for the 8 bit fields of the table')
+    return [KEYS[k] for k in keys] + sorted(set(PLAIN.values())), rows
+
+
+def rust_table(source, keys, rows):
+    columns, classes = {}, []
+    for byte in range(256):
+        column = tuple(row[byte] for row in rows)
+        classes.append(columns.setdefault(column, len(columns)))
+    table = [[None] * len(columns) for _ in rows]
+    for byte, cls in enumerate(classes):
+        for state, row in enumerate(rows):
+            nxt, act = row[byte]
+            table[state][cls] = (act << 8) | nxt
+
+    out = ['// Generated by ushell_core/tools/ushell_keygen.py from ' + source + ', do not edit:\n',
+           '// a new sequence goes to the .cfg, then\n',
+           '// python3 ushell_core/tools/ushell_keygen.py ushell_core/ushell_core_config/inc/' + source + ' \\\n',
+           '//     RTIC_Shell/sources/ushell/ushell2/src/input/key_table.rs \\\n',
+           '//     Embassy_Shell/sources/ushell/ushell2/src/input/key_table.rs\n',
+           '\n',
+           'use super::key_reader::Key;\n',
+           '\n',
+           f'pub const STATES: usize = {len(rows)};\n',
+           f'pub const CLASSES: usize = {len(columns)};\n',
+           '\n',
+           '/// The state of no sequence on its way.\n',
+           'pub const GROUND: u8 = 0;\n',
+           '\n',
+           '/// Action of a transition: nothing.\n',
+           f'pub const ACT_NONE: u8 = {NONE};\n',
+           '/// Action of a transition: the byte as `Key::Char`.\n',
+           f'pub const ACT_CHAR: u8 = {CHAR};\n',
+           '/// Action of a transition: `KEYS[action - ACT_KEY]`.\n',
+           'pub const ACT_KEY: u8 = 2;\n',
+           '\n',
+           '/// The class of every byte.\n',
+           'pub static CLASS: [u8; 256] = [\n']
+    for first in range(0, 256, 16):
+        out.append('    ' + ' '.join(f'{c},' for c in classes[first:first + 16]) + '\n')
+    out.append('];\n\n')
+    out.append('/// `(action << 8) | next state` per state and byte class.\n')
+    out.append('pub static NEXT: [[u16; CLASSES]; STATES] = [\n')
+    for row in table:
+        cells = [f'0x{cell:04X},' for cell in row]
+        out.append('    [\n')
+        for first in range(0, len(cells), 10):
+            out.append('        ' + ' '.join(cells[first:first + 10]) + '\n')
+        out.append('    ],\n')
+    out.append('];\n\n')
+    out.append('/// The keys of the actions from `ACT_KEY` on.\n')
+    out.append(f'pub static KEYS: [Key; {len(keys)}] = [\n')
+    for key in keys:
+        out.append(f'    Key::{key},\n')
+    out.append('];\n')
+    return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate the Rust key decoder table from the C++ escape sequences')
+    parser.add_argument('escapes', help='ushell_core_escape.cfg')
+    parser.add_argument('tables', nargs='+', help='the key_table.rs to write')
+    parser.add_argument('--check', action='store_true', help='fail if a table is out of date, write nothing')
+    parser.add_argument('--define', action='append', default=[], help='a name defined for the #if of the .cfg')
+    args = parser.parse_args()
+
+    try:
+        keys, rows = build(read_sequences(args.escapes, set(args.define)))
+        source = os.path.basename(args.escapes)
+        text = rust_table(source, keys, rows)
+        stale = []
+        for path in args.tables:
+            current = None
+            if os.path.exists(path):
+                with open(path, 'r', newline='') as f:
+                    current = f.read()
+            if current == text:
+                continue
+            if args.check:
+                stale.append(path)
+            else:
+                with open(path, 'w', newline='') as f:
+                    f.write(text)
+                print(f"{path} ({len(rows)} states)")
+        if stale:
+            raise GenError('out of date: ' + ', '.join(stale))
+    except (GenError, OSError) as error:
+        print(f"ushell_keygen: {error}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
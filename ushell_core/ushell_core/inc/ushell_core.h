@@ -0,0 +1,531 @@
+/*
+MIT License Copyright (c) 2022, Victor Marian Popa (victormarianpopa@gmail.com)
+*/
+
+#ifndef USHELL_CORE_H
+#define USHELL_CORE_H
+
+#include "ushell_core_datatypes.h"
+
+#if ((1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+#include <atomic>
+#endif /* ((1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)) */
+
+#define uSHELL_VERSION "1.0.0"
+
+/* placement of the hot paths, the settings of the trees without RAM functions leave it out */
+#if !defined(uSHELL_HOT_FUNC)
+#define uSHELL_HOT_FUNC
+#endif /* !defined(uSHELL_HOT_FUNC) */
+
+/* probe points of the tree (SHELL_LINE_BEGIN/END, SHELL_EXEC_BEGIN/END), empty without them */
+#if !defined(uSHELL_PROBE)
+#define uSHELL_PROBE(point)
+#endif /* !defined(uSHELL_PROBE) */
+
+/*==============================================================================
+            MICROSHELL CLASS DEFINITION
+==============================================================================*/
+
+uSHELL_NAMESPACE_BEGIN
+
+class Microshell {
+  public:
+    static Microshell *getShellPtr(uShellInst_s *psShellInst, const char *pstrPromptExt);
+    void Run(void);
+#if (1 == uSHELL_IMPLEMENTS_FEED)
+    /* event driven input instead of Run(): Start() prints the first prompt, each Feed() takes the
+       bytes which arrived and returns once they are handled, false after the exit command */
+    void Start(void);
+    bool Feed(const char *pstrBuf, const size_t szLen);
+    /* an escape sequence is open: Feed() with no bytes after uSHELL_ESCAPE_TIMEOUT_MS drops it */
+    bool FeedPending(void) const;
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    /* the same from a superloop: Feed() with what the transport has now (pfRead with a 0 timeout,
+       which returns at once), returns at once; u32NowMs, a millisecond clock of the caller, times
+       the gap after a lone ESC. false after the exit command */
+    bool Poll(const uint32_t u32NowMs);
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+#endif /* (1 == uSHELL_IMPLEMENTS_FEED) */
+#if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
+    bool Execute(const char *pstrCommand);
+    int ExecuteBatch(const char *pstrBatch, int *piStatusArray, const int iMaxStatus);
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+    bool ExecuteView(const char *pstrBuffer, const size_t szLen);
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+    bool ExecuteScript(const char *pstrScriptName);
+#endif /* (1 == uSHELL_IMPLEMENTS_SCRIPTS) */
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    /* called by a handler before returning uSHELL_ERR_PENDING, the ticket goes with the job */
+    int AsyncBegin(void);
+    /* called once by the task which finished the job (single producer, may run on another task) */
+    bool AsyncComplete(const int iTicket, const int iRetVal, const char *pstrOutput);
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    /* a command line queued by any task or interrupt (a button callback), run by the shell task before it reads
+       the next key, above the line in edition; lock free, false if the line is too long or the queue is full */
+    bool Post(const char *pstrCommand);
+    /* the shell task: the posted lines now (i.e. ShellAO on the event of the poster), Run() and Feed() call it */
+    void RunPosted(void);
+#endif /* (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS) */
+
+    /* index of a command in the table of this instance (the lookup of the parser), uSHELL_ERR_FUNCTION_NOT_FOUND if there is none */
+    int FindCommand(const char *pstrFctName);
+#if (1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS)
+    /* a command line parsed once into a caller owned slot, RunPrepared() calls its handler again without the
+       lookup and the parse (i.e. a periodic job on another task); uSHELL_ERR_OK or the parse error, after which
+       the slot holds no command and RunPrepared() returns uSHELL_ERR_FUNCTION_NOT_FOUND */
+    int Prepare(const char *pstrCommand, preparedCmd_s *psPrepared);
+    int RunPrepared(const preparedCmd_s *psPrepared);
+#endif /* (1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS) */
+
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    /* console of this instance, nullptr selects the build's default (uSHELL_GETCH / uSHELL_WRITE) */
+    void SetTransport(const uShellTransport_s *psTransport);
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_STORE)
+    /* persistent history of this instance, its entries are loaded into the history; nullptr detaches it */
+    void SetHistoryStore(const uShellHistoryStore_s *psStore);
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY_STORE) */
+
+    /* independent instance; every instance needs its own plugin (uShellInst_s keeps the prompt and autocomplete state) */
+    Microshell(uShellInst_s *psShellInst, const char *pstrPromptExt);
+    Microshell(const Microshell &) = delete;
+    Microshell &operator=(const Microshell &) = delete;
+
+  private:
+    /* shell core private functions */
+    void m_Init(const char *pstrPromptExt);
+    bool m_Execute(void);
+    void m_CoreStop(void);
+    void m_CoreSetPrompt(const char *pstrPromptExt);
+    void m_CoreExecuteEnterKey(void);
+    int m_CoreParseCommand(void);
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+    int m_CoreDecodeParam(const paramsDecoder_s *psDecoder, char *pstrToken, const size_t szLen, int *piNrParamsRead);
+#if defined(BIGNUM_T)
+    void m_CoreStoreNumber(void *pvDest, const uint8_t u8ValSize, const uint32_t u32Val);
+#endif /* defined(BIGNUM_T) */
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+    int m_CoreArrayAppend(const char *pstrToken, const size_t szLen);
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+    void m_CoreParseExecuteCommand(void);
+    int m_CoreExec(void);
+    int m_CoreSearchFunction(const char *pstrFctName);
+    int m_CoreSearchFunction(const char *pstrFctName, const size_t szLen);
+#if ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) && defined(uSHELL_IMPLEMENTS_STRING_VIEWS))
+    int m_CoreParseView(const char *pstrBuffer, const size_t szLen);
+#endif /* ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) && defined(uSHELL_IMPLEMENTS_STRING_VIEWS)) */
+    void m_CorePrintError(const int iError);
+    void m_CorePutString(const char *pstrArray);
+    char m_TransportGetch(void);
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    bool m_TransportGetchTimeout(char *pcByte, const uint32_t u32TimeoutMs);
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+    void m_TransportPutch(const char cChar);
+    void m_TransportWrite(const char *pstrBuf, const size_t szLen);
+    bool m_TransportRead(uint8_t *pu8Buf, size_t szLen);
+    int m_TransportGetLine(char *pstrBuf, const int iMaxLen);
+    uSHELL_HOT_FUNC void m_CoreProcessKeyPress(const char cKeyPressed);
+#if (1 == uSHELL_IMPLEMENTS_LINE_BURST)
+    bool m_CoreProcessLineBurst(void);
+#endif /* (1 == uSHELL_IMPLEMENTS_LINE_BURST) */
+    void m_CoreResetInput(const bool bFull);
+    void m_CoreRemoveTrailingSpaces(void);
+    void m_CorePrintMessage(const int iFeatIdx, const int iStatusIdx);
+    void m_CorePrintPrompt(void);
+
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+    void m_CoreExit(void);
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+    void m_CoreShowInfo(const char *pstrArgs);
+    void m_CoreShowCmdInfo(const int iFctIndex, const bool bParamInfo);
+    void m_CoreShowShortcuts(void);
+    void m_CoreShowTypes(void);
+    void m_CorePutChars(const char *pstrArray, int iNrChars, const bool bNewLine);
+    void m_CorePutInfo(const char *pstrInfo, int iNrChars, const bool bNewLine);
+#endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
+    void m_CoreShowCmd(int iFctIndex);
+    void m_CoreShowCmdsList(void);
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+    void m_CoreShowStats(const bool bReset);
+#endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_STATS) */
+
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+#if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
+    int m_CoreHandleBorderedStrings(char **ppstrToken, char **ppstrRest, int *pIntArgCounter);
+    void m_CoreSetStringBorder(const char *pstrStringBorder);
+#endif /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS)*/
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+
+    /* core key handlers */
+    void m_CoreHandleKeyEnter(void);
+    void m_CoreHandleKeyDefault(const char cKeyPressed);
+    bool m_CoreHandleShortcuts(void);
+    bool m_CoreIsShortcutSymbol(const char cKey);
+    int m_CoreFindShortcut(const char cKey);
+#if (1 == uSHELL_IMPLEMENTS_HOT_SHORTCUTS)
+    bool m_CoreIsHotShortcut(const char cKey);
+#endif /*(1 == uSHELL_IMPLEMENTS_HOT_SHORTCUTS)*/
+    void m_CoreHandleShortcut_Hash(const char *pstrArgs);
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)
+    void m_CoreHandleKeyArrowUpDown(const dir_e eDir);
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)*/
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    void m_CoreHandleKeyArrowLeftRight(const dir_e eDir);
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    escapeDecoder_s m_sEscape = {};
+    void m_EscapeStart(void);
+    bool m_EscapeFeed(const char cByte);
+    void m_EscapeHandleKey(const uint8_t u8Key);
+#else
+    void m_CoreHandleKeyEscapeSeq(void);
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+    void m_CoreHandleKeyBackspace(void);
+    void m_CoreHandleKeyDelete(void);
+    void m_CoreCmdLineDelete(void);
+
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+    bool m_CoreConfirmRequest(void);
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    bool m_EditMoveCursor(const dir_e eDir);
+    void m_EditMoveCursorDirSteps(const dir_e eDir, const int iSteps);
+    void m_EditInsertUnderCursor(const char cKeyPressed);
+    void m_EditDeleteUnderCursor(void);
+    void m_EditDeleteBackward(void);
+    void m_EditDeleteBackwardToHome(void);
+    void m_EditDeleteForwardToEnd(void);
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    void m_CoreHandleKeyInsert(void);
+#endif /* !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE) */
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+    /* history wrapper functions */
+    void m_HistoryInit(const char *pstrFileName);
+    void m_HistoryDeInit(void);
+    void m_HistoryWrite(void);
+    void m_HistoryReset(void);
+    void m_HistoryList(void);
+    void m_HistoryExecuteEntry(const char *pstrIndex);
+    void m_HistoryRead(const dir_e eDir);
+    char *m_HistoryGetEntry(int iIndex);
+    void m_HistoryEnable(const bool bEnable);
+
+    /* Embedded history implementation functions */
+    void m_HistoryInitCore(history_s *pHistory, char *pDataBuffer, size_t szCapacity);
+    bool m_HistoryPush(history_s *pHistory, bool bTriggerAutosave);
+    bool m_HistoryGetPrevEntry(history_s *pHistory, char *pBuffer, size_t szBufferSize);
+    bool m_HistoryGetNextEntry(history_s *pHistory, char *pBuffer, size_t szBufferSize);
+    bool m_HistoryGetFirstEntry(const history_s *pHistory, char *pBuffer, size_t szBufferSize);
+    bool m_HistoryGetLastEntry(const history_s *pHistory, char *pBuffer, size_t szBufferSize);
+    void m_HistorySetIndex(history_s *pHistory, size_t szIndex);
+    bool m_HistoryIsEmpty(const history_s *pHistory);
+    bool m_HistoryGetEntryAtIndex(const history_s *pHistory, size_t szIndex, char *pBuffer, size_t szBufferSize);
+    void m_HistoryClear(history_s *pHistory);
+    void m_HistoryGetFreeSpace(const history_s *pHistory, size_t *pszFreeBytes);
+    size_t m_HistoryGetEntrySize(const history_s *pHistory);
+    void m_HistoryIteratorInit(historyIter_s *pIter, const history_s *pHistory);
+    bool m_HistoryIteratorNext(historyIter_s *pIter, char *pBuffer, size_t szBufferSize);
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+    bool m_HistoryIteratorFindPrev(historyIter_s *pIter, const char *pstrPattern, size_t szPatternLen);
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)*/
+    void m_HistoryShow(const history_s *pHistory);
+
+    /* Helpers */
+    void m_HistoryWriteLengthAt(char *pBuffer, size_t szCapacity, size_t szPos, uint16_t u16Len);
+    uint16_t m_HistoryReadLengthAt(const char *pBuffer, size_t szCapacity, size_t szPos);
+    size_t m_HistoryEntryTotalSize(uint16_t u16DataLen);
+    size_t m_HistoryFindNextEntryPos(const history_s *pHistory, size_t szPos);
+    size_t m_HistoryEntryPosAtIndex(const history_s *pHistory, size_t szIndex);
+    size_t m_HistoryCalculateUsedSpace(const history_s *pHistory);
+    void m_HistoryRemoveOldestEntry(history_s *pHistory);
+    size_t m_HistoryRecordSizeAt(const history_s *pHistory, size_t szPos);
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    size_t m_HistoryDecodeAt(const history_s *pHistory, size_t szPos, char *pBuffer, size_t szBufferSize);
+    void m_HistoryCompressNewest(history_s *pHistory, const char *pstrNext, size_t szNextLen);
+    void m_HistoryRemoveEntry(history_s *pHistory, size_t szIndex);
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+    size_t m_HistoryEntryLengthAt(const history_s *pHistory, size_t szPos);
+    char m_HistoryCharAt(const history_s *pHistory, size_t szPos, size_t szOffset);
+    bool m_HistoryEntryContains(const history_s *pHistory, size_t szPos, const char *pstrPattern, size_t szPatternLen);
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)*/
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+
+#if ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))
+    void m_HistoryReload(void);
+    void m_HistorySetFilePath(history_s *pHistory, const char *pstrFilePath);
+    bool m_HistoryLoadFromFile(history_s *pHistory);
+    void m_HistoryEnableAutoSave(history_s *pHistory, bool bEnable);
+    bool m_HistoryAppendToFile(history_s *pHistory, const char *pstrEntry);
+    void m_HistoryInitFile(const char *pstrFileName);
+#endif /*((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))*/
+
+    /* autocomplete functions */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    void m_AutocomplInit(void);
+    void m_AutocomplFill(const bool bFull);
+    void m_AutocomplReInit(void);
+    void m_AutocomplReset(const bool bReinit);
+    void m_AutocomplGetCommon(void);
+    void m_AutocomplFilter(void);
+    void m_AutocomplInsEndSpace(void);
+    void m_AutocomplRead(const dir_e eDir);
+    void m_AutocomplEnable(const bool bEnable);
+    const char *m_AutocomplCandidate(const int iElem);
+#if (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+    int m_AutocomplSetIndex(const int iElem);
+#endif /* (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+    bool m_AutocomplArgFilter(void);
+    const char *m_AutocomplArgValue(const int iElem);
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+    /* binary frames mode */
+    void m_BinaryHandleFrame(void);
+    int m_BinaryExecuteFrame(uint8_t *pu8Frame, const size_t szLength);
+    void m_BinarySendResponse(const int iRetVal);
+#endif /* (1 == uSHELL_IMPLEMENTS_BINARY_MODE) */
+
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    /* machine interface: no echo, prompt or colour, one terminator per line */
+    void m_MachineEnable(const bool bEnable);
+    void m_MachineProcessKey(const char cKeyPressed);
+    void m_MachineExecuteLine(void);
+    void m_MachineTerminate(const int iRetVal);
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    void m_MachineReportDone(const asyncDone_s *psDone);
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+    bool m_MachineTakeTag(void);
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_MODE) */
+
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+    /* precompiled scripts */
+    int m_ScriptSearch(const char *pstrScriptName);
+    int m_ScriptRun(const script_s *psScript, int *piStep);
+    void m_ScriptShowList(void);
+    void m_ScriptHandleShortcut(const char *pstrArgs);
+#endif /* (1 == uSHELL_IMPLEMENTS_SCRIPTS) */
+
+#if (1 == uSHELL_IMPLEMENTS_LOOPS)
+    /* repeat / for lines */
+    bool m_LoopHandle(void);
+    int m_LoopCompile(const char *pstrVar, int *piStep);
+    int m_LoopRun(const uint32_t u32From, const uint32_t u32Turns, const int32_t i32Step, uint32_t *pu32Turn, int *piStep);
+    bool m_LoopIsVariable(const char *pstrToken, const size_t szLen) const;
+    int m_LoopStoreVariable(command_s *psCmd, const uint32_t u32VarSlots, const uint32_t u32Value);
+#endif /* (1 == uSHELL_IMPLEMENTS_LOOPS) */
+
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    /* asynchronous commands */
+    void m_AsyncReport(void);
+    void m_AsyncPrintPending(void);
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+#if ((1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+    /* the prompt and the line in edition again, after lines printed above it */
+    void m_CoreRedrawLine(void);
+#endif /* ((1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)) */
+
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    /* input line rendering: only the changed part is sent, known cursor column */
+    int m_RenderCursor(void);
+    void m_RenderMove(const int iFrom, const int iTo);
+    void m_RenderRepeat(const char cChar, int iCount);
+    void m_RenderErase(const int iCount);
+    void m_RenderTail(int iSame, const int iCursor, const int iOldLen, const int iNewCursor);
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    void m_RenderInsert(const int iAt);
+    void m_RenderDelete(const int iCursor, const int iAt, const int iCount);
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+    void m_RenderColor(const char *pstrColor);
+    int m_RenderPrintf(const char *pstrFormat, ...);
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+    /* Ctrl-R: the line shows the match, the hint and the pattern, the cursor after the pattern */
+    void m_SearchStart(void);
+    bool m_SearchHandleKey(const char cKeyPressed);
+    bool m_SearchFind(const size_t szFrom);
+    void m_SearchShowMatch(void);
+    void m_SearchStop(void);
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH) */
+
+#if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
+    void keydecoder(void);
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
+
+    char m_pstrInput[uSHELL_MAX_INPUT_BUF_LEN] = {0};
+    int m_iInputPos = 0;
+    int m_iCursorPos = 0;
+    command_s m_sCommand = {};
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+    uint32_t m_u32StatsMark = 0U; /* cycles at the parse start of the command in execution */
+#endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_STATS) */
+#if (1 == uSHELL_IMPLEMENTS_LOOPS)
+    loopBody_s m_sLoop = {};
+    const char *m_pstrLoopVar = nullptr; /* name of the variable while a body is parsed */
+    uint32_t m_u32LoopVarSlots = 0U;     /* ... and the parameters of the step it was given to */
+#endif /* (1 == uSHELL_IMPLEMENTS_LOOPS) */
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    autocomplete_s m_sAutocomplete = {};
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+    /* Embedded history implementation */
+    history_s m_sHistory = {};
+    char m_historyBuffer[uSHELL_HISTORY_BUFFER_SIZE] = {0};
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    uint16_t m_historyIndex[uSHELL_HISTORY_INDEX_DEPTH] = {0};
+#endif
+    bool m_bHistoryEnabled = false;
+    bool m_bHistoryInitialized = false;
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_STORE)
+    const uShellHistoryStore_s *m_psHistoryStore = nullptr;
+#endif
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    char m_HistoryFilePath[uSHELL_HISTORY_FILEPATH_LENGTH] = {0};
+#endif
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+    historyIter_s m_sSearch = {};    /* on the current match, at the entries count while there is none */
+    char m_vstrSearch[uSHELL_HISTORY_SEARCH_LEN + 1] = {0};
+    int m_iSearchLen = 0;
+    bool m_bSearchActive = false;
+#endif
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+#if defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    bool m_bEditMode = true;
+#else
+    bool m_bEditMode = false;
+#endif /* defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE) */
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) */
+
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+    bool m_bEchoOn = true;
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+    bool m_bBinaryMode = false;
+#endif /* (1 == uSHELL_IMPLEMENTS_BINARY_MODE) */
+
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    bool m_bDumbTerminal = false; /* no escape sequences at all (#t), plain \b and spaces */
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    bool m_bMachineMode = false;
+    bool m_bMachineOverflow = false; /* the line in reception did not fit the input buffer */
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    bool m_bMachineDumbSaved = false; /* terminal mode to restore when the machine mode ends */
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+    bool m_bMachineTagged = false;   /* the line in execution started with a sequence tag */
+    uint32_t m_u32MachineSeq = 0;    /* ... that tag */
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    machineTag_s m_vsMachineTags[uSHELL_ASYNC_QUEUE_DEPTH] = {}; /* tagged lines still pending */
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_MODE) */
+
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    asyncDone_s m_vsAsyncQueue[uSHELL_ASYNC_QUEUE_DEPTH] = {};
+    std::atomic<uint8_t> m_u8AsyncHead{0}; /* written by the completing task */
+    std::atomic<uint8_t> m_u8AsyncTail{0}; /* written by the shell task */
+    int m_iAsyncTicket = 0;                /* last ticket handed out */
+    int m_iAsyncBegun = 0;                 /* ticket taken by the command in execution */
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    char m_vstrPostLines[uSHELL_POST_QUEUE_DEPTH][uSHELL_MAX_INPUT_BUF_LEN] = {};
+    std::atomic<bool> m_vbPostReady[uSHELL_POST_QUEUE_DEPTH] = {}; /* set by the poster, cleared by the shell task */
+    std::atomic<uint8_t> m_u8PostHead{0};  /* taken by the posters (compare and swap) */
+    std::atomic<uint8_t> m_u8PostTail{0};  /* written by the shell task */
+#endif /* (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS) */
+
+    static const char *m_pstrCoreShortcutCaption;
+#if (defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))
+    char m_cStringBorderSymbol = 0;
+#endif /*(defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))*/
+
+    /* delimiters/separators */
+    static constexpr const char *m_pstrTokenSeparator = " ";
+#if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
+    static constexpr const char *m_pstrBatchSeparators = ";\r\n";
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+
+    /* data types related */
+#define  uSHELL_DATA_TYPES_TABLE_BEGIN      enum typemarks_e {
+#define  uSHELL_DATA_TYPE(a, b)                 uSHELL_TYPE_##a,
+#define  uSHELL_DATA_TYPES_TABLE_END        uSHELL_TYPE_LAST };
+#include uSHELL_DATA_TYPES_CONFIG_FILE
+#undef   uSHELL_DATA_TYPES_TABLE_BEGIN
+#undef   uSHELL_DATA_TYPE
+#undef   uSHELL_DATA_TYPES_TABLE_END
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+    static const char m_vstrTypeMarks[uSHELL_TYPE_LAST];
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
+    static const char *m_vstrTypeNames[uSHELL_TYPE_LAST];
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+    static const typeDecoder_s m_vsTypeDecoders[uSHELL_TYPE_LAST];
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+
+    /* prompt related */
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+#define  uSHELL_PROMPT_TABLE_BEGIN      enum prompti_e {
+#define  uSHELL_PROMPT_CELL(a, b, c)        uSHELL_PROMPTI_##a,
+#define  uSHELL_PROMPT_TABLE_END        uSHELL_PROMPTI_LAST };
+#include uSHELL_PROMPT_CONFIG_FILE
+#undef   uSHELL_PROMPT_TABLE_BEGIN
+#undef   uSHELL_PROMPT_CELL
+#undef   uSHELL_PROMPT_TABLE_END
+
+#define  uSHELL_PROMPT_TABLE_BEGIN      char m_pstrPrompt[uSHELL_PROMPTI_LAST + 1] = ""
+#define  uSHELL_PROMPT_CELL(a, b, c)        ":"
+#define  uSHELL_PROMPT_TABLE_END        ;
+#include uSHELL_PROMPT_CONFIG_FILE
+#undef   uSHELL_PROMPT_TABLE_BEGIN
+#undef   uSHELL_PROMPT_CELL
+#undef   uSHELL_PROMPT_TABLE_END
+    static const char m_pstrPromptInfo[uSHELL_PROMPTI_LAST + 1];
+    static const char m_pstrPromptInfoEditMode[uSHELL_PROMPTI_LAST + 1];
+    void m_CoreUpdatePrompt(const prompti_e ePromptIndex, const bool bOnOff);
+#endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    const uShellTransport_s *m_psTransport = nullptr;
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+
+#if (1 == uSHELL_IMPLEMENTS_FEED)
+    const char *m_pcFeed = nullptr; /* the rest of the chunk in Feed(), read before the transport */
+    size_t m_szFeedLeft = 0;
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    uint32_t m_u32PollInputMs = 0; /* u32NowMs of the last Poll() with input */
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+#endif /* (1 == uSHELL_IMPLEMENTS_FEED) */
+
+    uShellInst_s *m_pInst = nullptr;
+};
+
+uSHELL_NAMESPACE_END
+uSHELL_NAMESPACE_USE
+
+#endif /* USHELL_CORE_H */
@@ -0,0 +1,5306 @@
+/*
+MIT License Copyright (c) 2022, Victor Marian Popa (victormarianpopa@gmail.com)
+*/
+
+#include "ushell_core.h"
+
+#include "ushell_core_keys.h"
+#include "ushell_core_printout.h"
+#include "ushell_core_utils.h"
+
+#include <cctype>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+uSHELL_NAMESPACE_BEGIN
+
+/*==============================================================================
+                LOCAL DEFINES
+==============================================================================*/
+
+/* read/check tilde in escape sequence*/
+#if (defined(__MINGW32__) || defined(_MSC_VER)) /* i.e MinGW or Microsoft VisualStudio for Windows console */
+#define uSHELL_CORE_KEYHANDLE_SKIP_TILDE   true
+#define uSHELL_CORE_KEYHANDLE_SKIP_BRACKET true
+#else
+#define uSHELL_CORE_KEYHANDLE_SKIP_TILDE   (uSHELL_KEY_TILDE        == m_TransportGetch())
+#define uSHELL_CORE_KEYHANDLE_SKIP_BRACKET (uSHELL_KEY_LEFT_BRACKET == m_TransportGetch())
+#endif
+
+/* first byte of an escape sequence */
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+#define uSHELL_CORE_IS_ESCAPE_INTRO(c)     ((uSHELL_KEY_ESCAPESEQ == (c)) || (uSHELL_KEY_ESCAPESEQ1 == (c)))
+#else
+#define uSHELL_CORE_IS_ESCAPE_INTRO(c)     (uSHELL_KEY_ESCAPESEQ == (c))
+#endif
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+#define uSHELL_HISTORY_METADATA_SIZE  2U  // embedded metadata: shared prefix length + suffix length at start
+#else
+#define uSHELL_HISTORY_METADATA_SIZE  4U  // embedded metadata: 2 bytes at start + 2 bytes at end
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+/* request : SOF | LEN | IDX | ARGS[LEN-1] | CRC16
+   response: SOF | 4   | RET (int32)        | CRC16
+   - ARGS are packed little-endian in the order of the params pattern, strings are NUL terminated
+   - CRC16 (CRC-16/CCITT-FALSE, little-endian) covers LEN and the LEN payload bytes
+   - IDX 0xFF with no args leaves the binary mode */
+#define uSHELL_BINARY_SOF                   (0xB5U)
+#define uSHELL_BINARY_EXIT_INDEX            (0xFFU)
+#define uSHELL_BINARY_CRC_INIT              (0xFFFFU)
+#endif /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE)*/
+
+/* bytes Poll() takes from the transport per call, the rest waits for the next one */
+#if ((1 == uSHELL_IMPLEMENTS_FEED) && (1 == uSHELL_IMPLEMENTS_TRANSPORT))
+#if !defined(uSHELL_POLL_CHUNK_SIZE)
+#define uSHELL_POLL_CHUNK_SIZE              (32U)
+#endif /* !defined(uSHELL_POLL_CHUNK_SIZE) */
+#endif /* ((1 == uSHELL_IMPLEMENTS_FEED) && (1 == uSHELL_IMPLEMENTS_TRANSPORT)) */
+
+/* a pending command has not failed, its result is reported later */
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+#define uSHELL_CMD_SUCCEEDED(x)             (((x) >= 0) || (uSHELL_ERR_PENDING == (x)))
+static_assert((0 == (uSHELL_ASYNC_QUEUE_DEPTH & (uSHELL_ASYNC_QUEUE_DEPTH - 1))) && (uSHELL_ASYNC_QUEUE_DEPTH <= 128U),
+              "uSHELL_ASYNC_QUEUE_DEPTH must be a power of 2, max 128");
+#else
+#define uSHELL_CMD_SUCCEEDED(x)             ((x) >= 0)
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+static_assert((0 == (uSHELL_POST_QUEUE_DEPTH & (uSHELL_POST_QUEUE_DEPTH - 1))) && (uSHELL_POST_QUEUE_DEPTH <= 128U),
+              "uSHELL_POST_QUEUE_DEPTH must be a power of 2, max 128");
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+
+/* the command stats mark the parse start, the handler time is taken around pfExec */
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+#define uSHELL_STATS_MARK()                 (m_u32StatsMark = uSHELL_STATS_CYCLES())
+#define uSHELL_STATS_BAR_WIDTH              (20U)
+#else
+#define uSHELL_STATS_MARK()
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+
+/* the scratch blocks taken by a handler are released when it returns; restoring the
+   level seen on entry keeps the blocks of a caller executing nested commands */
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+#define uSHELL_SCRATCH_MARK()               const size_t szScratchMark = m_pInst->psScratchArena->szUsed
+#define uSHELL_SCRATCH_RELEASE()            (m_pInst->psScratchArena->szUsed = szScratchMark)
+#else
+#define uSHELL_SCRATCH_MARK()
+#define uSHELL_SCRATCH_RELEASE()
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)*/
+
+/* the history index keeps the entries positions on 16 bit */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+static_assert(uSHELL_HISTORY_BUFFER_SIZE <= 65536, "uSHELL_HISTORY_BUFFER_SIZE must not exceed 64K with the history index");
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)*/
+
+/* the compressed history keeps the lengths on 8 bit */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+static_assert(uSHELL_MAX_INPUT_BUF_LEN <= 256U, "uSHELL_MAX_INPUT_BUF_LEN must not exceed 256 with the compressed history");
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+
+/* repeat <n> { <cmd> [; <cmd>] } and for <var> <from> <to> [<step>] { ... $var ... } */
+#if (1 == uSHELL_IMPLEMENTS_LOOPS)
+#if !defined(BIGNUM_T)
+#error "uSHELL_IMPLEMENTS_LOOPS needs the numbers (the loop variable is one)"
+#endif /* !defined(BIGNUM_T) */
+#define uSHELL_LOOP_BODY_OPEN               '{'
+#define uSHELL_LOOP_BODY_CLOSE              '}'
+#define uSHELL_LOOP_STEP_SEPARATORS         ";"
+#define uSHELL_LOOP_VAR_MARK                '$'
+#define uSHELL_LOOP_VAR_MAX_LEN             (16U)
+static_assert(uSHELL_MAX_PARAMS_TOTAL <= 32U, "the parameters a loop variable goes to are a 32 bit mask");
+#endif /*(1 == uSHELL_IMPLEMENTS_LOOPS)*/
+
+/* concatenate strings */
+#define FRMT(a,b)       a b uSHELL_RESET_COLOR
+
+/* defines */
+#define uSHELL_NEWLINE      "\n\r"
+#define uSHELL_INVALID_VALUE (-1)
+
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+/* the core output goes through the render layer, a dumb terminal gets it without escape sequences */
+#undef  uSHELL_PRINTF
+#define uSHELL_PRINTF(...)  m_RenderPrintf(__VA_ARGS__)
+#if (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE)
+#undef  uSHELL_PRINTF_CT
+#define uSHELL_PRINTF_CT(fmt, ...)                                      \
+    do {                                                                \
+        if (true == m_bDumbTerminal) {                                  \
+            m_RenderPrintf(fmt __VA_OPT__(,) __VA_ARGS__);              \
+        } else {                                                        \
+            ushell_printf_ct<fmt>(__VA_ARGS__);                         \
+        }                                                               \
+    } while (0)
+#endif /* (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE) */
+#define uSHELL_SET_COLOR(c) m_RenderColor(c)
+#define uSHELL_RENDER_FORMAT_SIZE (128U)
+#else
+#define uSHELL_SET_COLOR(c) m_CorePutString(c)
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+/*==============================================================================
+            DEFAULT TRANSPORT (the build's console, blocking reads)
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+static int s_DefaultTransportRead(uint8_t *pu8Buf, const size_t szLen, const uint32_t u32TimeoutMs) {
+    (void)u32TimeoutMs;
+    for (size_t i = 0; i < szLen; ++i) {
+        pu8Buf[i] = (uint8_t)uSHELL_GETCH();
+    }
+    return (int)szLen;
+} /* s_DefaultTransportRead() */
+
+/*----------------------------------------------------------------------------*/
+static void s_DefaultTransportWrite(const uint8_t *pu8Buf, const size_t szLen) {
+    uSHELL_WRITE((const char *)pu8Buf, (int)szLen);
+} /* s_DefaultTransportWrite() */
+
+/*----------------------------------------------------------------------------*/
+static int s_DefaultTransportReadLine(char *pstrBuf, const int iMaxLen) {
+    (void)pstrBuf;
+    (void)iMaxLen;
+    return uSHELL_GETLINE(pstrBuf, iMaxLen);
+} /* s_DefaultTransportReadLine() */
+
+static const uShellTransport_s s_sDefaultTransport = { s_DefaultTransportRead, s_DefaultTransportWrite, s_DefaultTransportReadLine };
+#endif /*(1 == uSHELL_IMPLEMENTS_TRANSPORT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+/*==============================================================================
+            ESCAPE SEQUENCES TRIE (compile-time, from uSHELL_ESCAPE_CONFIG_FILE)
+==============================================================================*/
+
+typedef struct {
+    const char *pstrSeq;     /* the bytes after the introducer */
+    uint8_t u8Key;
+} escapeSeq_s;
+
+/* the alternatives of a byte are chained by u8Next, a node with a key is a leaf */
+typedef struct {
+    char cByte;
+    uint8_t u8Child;         /* first node of the next byte, 0 if none */
+    uint8_t u8Next;          /* next alternative for the same byte, 0 if none */
+    uint8_t u8Key;           /* key of the sequence ending here, uSHELL_ESCKEY_NONE on the way */
+} escapeNode_s;
+
+#define  uSHELL_ESCAPE_TABLE_BEGIN      static constexpr escapeSeq_s s_vsEscapeSeqArray[] = {
+#define  uSHELL_ESCAPE_SEQ(a, b)            { a, uSHELL_ESCKEY_##b },
+#define  uSHELL_ESCAPE_TABLE_END        };
+#include uSHELL_ESCAPE_CONFIG_FILE
+#undef   uSHELL_ESCAPE_TABLE_BEGIN
+#undef   uSHELL_ESCAPE_SEQ
+#undef   uSHELL_ESCAPE_TABLE_END
+
+/* the root and one node per byte of the table at most */
+static constexpr int s_EscapeTrieSize(void) {
+    int iSize = 1;
+    for (const escapeSeq_s &sSeq : s_vsEscapeSeqArray) {
+        for (const char *pc = sSeq.pstrSeq; '\0' != *pc; ++pc) {
+            ++iSize;
+        }
+    }
+    return iSize;
+}
+
+template <int N>
+struct escapeTrie_s {
+    escapeNode_s vsNodes[N];
+    bool bPrefixFree;        /* no sequence is the start of another one */
+};
+
+static constexpr escapeTrie_s<s_EscapeTrieSize()> s_EscapeBuildTrie(void) {
+    escapeTrie_s<s_EscapeTrieSize()> sTrie{};
+    int iCount = 1;
+
+    sTrie.bPrefixFree = true;
+    for (const escapeSeq_s &sSeq : s_vsEscapeSeqArray) {
+        int iNode = 0;
+        for (const char *pc = sSeq.pstrSeq; '\0' != *pc; ++pc) {
+            int iChild = sTrie.vsNodes[iNode].u8Child;
+            int iLast = 0;
+            while ((0 != iChild) && (*pc != sTrie.vsNodes[iChild].cByte)) {
+                iLast = iChild;
+                iChild = sTrie.vsNodes[iChild].u8Next;
+            }
+            if (0 == iChild) {
+                iChild = iCount++;
+                sTrie.vsNodes[iChild].cByte = *pc;
+                if (0 == iLast) {
+                    sTrie.vsNodes[iNode].u8Child = (uint8_t)iChild;
+                } else {
+                    sTrie.vsNodes[iLast].u8Next = (uint8_t)iChild;
+                }
+            }
+            if (uSHELL_ESCKEY_NONE != sTrie.vsNodes[iChild].u8Key) {
+                sTrie.bPrefixFree = false;
+            }
+            iNode = iChild;
+        }
+        if (0 != sTrie.vsNodes[iNode].u8Child) {
+            sTrie.bPrefixFree = false;
+        }
+        sTrie.vsNodes[iNode].u8Key = sSeq.u8Key;
+    }
+    return sTrie;
+}
+
+static_assert(s_EscapeTrieSize() <= 256, "uSHELL_ESCAPE_CONFIG_FILE: too many bytes for the 8 bit links of the trie");
+static constexpr auto s_sEscapeTrie = s_EscapeBuildTrie();
+static_assert(true == s_sEscapeTrie.bPrefixFree, "uSHELL_ESCAPE_CONFIG_FILE: a sequence is the start of another one");
+#endif /* (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER) */
+
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+/*==============================================================================
+            DUMB TERMINAL FILTER
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* copy without the escape sequences (ESC [ params final), false if it does not fit;
+   a sequence with a conversion inside is kept, its argument is still to be consumed */
+static bool s_RenderStrip(const char *pstrSrc, char *pstrDst, const size_t szSize) {
+    size_t szPos = 0;
+
+    while ('\0' != *pstrSrc) {
+        if (('\033' == pstrSrc[0]) && ('[' == pstrSrc[1])) {
+            const char *pstrEnd = pstrSrc + 2;
+            while ((*pstrEnd >= 0x30) && (*pstrEnd <= 0x3F)) {
+                ++pstrEnd;
+            }
+            if ((*pstrEnd >= 0x40) && (*pstrEnd <= 0x7E)) {
+                pstrSrc = pstrEnd + 1;
+                continue;
+            }
+        }
+        if (szPos >= (szSize - 1)) {
+            return false;
+        }
+        pstrDst[szPos++] = *pstrSrc++;
+    }
+    pstrDst[szPos] = '\0';
+    return true;
+} /* s_RenderStrip() */
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+
+/*==============================================================================
+            PUBLIC INTERFACES IMPLEMENTATION
+==============================================================================*/
+
+Microshell *Microshell::getShellPtr(uShellInst_s *psShellInst, const char *pstrPromptExt) {
+    static Microshell uShellInstance(psShellInst, pstrPromptExt);
+    return &uShellInstance;
+} /* getShell() */
+
+/*----------------------------------------------------------------------------*/
+int Microshell::FindCommand(const char *pstrFctName) {
+    return m_CoreSearchFunction(pstrFctName);
+} /* FindCommand() */
+
+#if ((1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS) || (1 == uSHELL_IMPLEMENTS_LOOPS))
+/*----------------------------------------------------------------------------*/
+/* a parse kept after the line it was made on: the pointers into pstrFrom are moved to the same
+   offsets in pstrTo, a copy of the tokenized line, and the array points to the values of its own copy */
+static void s_RebaseCommand(command_s *psCmd, const char *pstrFrom, char *pstrTo) {
+    if (nullptr != psCmd->pstrFctName) {
+        psCmd->pstrFctName = pstrTo + (psCmd->pstrFctName - pstrFrom);
+    }
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+    for (unsigned int i = 0U; (i < psCmd->iNrStrings) && (i < uSHELL_MAX_PARAMS_STRING); ++i) {
+        psCmd->vs[i] = pstrTo + (psCmd->vs[i] - pstrFrom);
+    }
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+    for (unsigned int i = 0U; (i < psCmd->iNrViews) && (i < uSHELL_MAX_PARAMS_VIEW); ++i) {
+        psCmd->vr[i].pstr = pstrTo + (psCmd->vr[i].pstr - pstrFrom);
+    }
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+    psCmd->va[0].pu32Items = psCmd->vu32Items;
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+    for (unsigned int i = 0U; (i < psCmd->iNrHexBufs) && (i < uSHELL_MAX_PARAMS_HEX); ++i) {
+        psCmd->vx[i].pu8Data = (uint8_t *)pstrTo + (psCmd->vx[i].pu8Data - (const uint8_t *)pstrFrom);
+    }
+#endif /* defined(uSHELL_IMPLEMENTS_HEX_BUFFERS) */
+} /* s_RebaseCommand() */
+#endif /* ((1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS) || (1 == uSHELL_IMPLEMENTS_LOOPS)) */
+
+#if ((1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+/*----------------------------------------------------------------------------*/
+/* exchange of two buffers in place, no copy of either on the stack */
+static void s_SwapBytes(void *pvA, void *pvB, size_t szLen) {
+    uint8_t *pu8A = (uint8_t *)pvA;
+    uint8_t *pu8B = (uint8_t *)pvB;
+    while (szLen-- > 0U) {
+        const uint8_t u8Tmp = *pu8A;
+        *pu8A++ = *pu8B;
+        *pu8B++ = u8Tmp;
+    }
+} /* s_SwapBytes() */
+#endif /* ((1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)) */
+
+#if (1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS)
+/*----------------------------------------------------------------------------*/
+/* the parser works on the input buffer and m_sCommand, which belong to the command in execution when a
+   handler prepares one (i.e. every 500 "adc 0 0"): the slot lends its storage for the parse and takes the
+   result back, the pointers into the input buffer are moved to the copy of the line; no history, no echo.
+   A failed parse leaves the slot empty, with no command for RunPrepared() to call */
+int Microshell::Prepare(const char *pstrCommand, preparedCmd_s *psPrepared) {
+    if (nullptr == psPrepared) {
+        return uSHELL_ERR_FUNCTION_NOT_FOUND;
+    }
+    memset(psPrepared, 0, sizeof(*psPrepared));
+    psPrepared->sCmd.iFctIndex = uSHELL_ERR_FUNCTION_NOT_FOUND;
+    if (nullptr == pstrCommand) {
+        return uSHELL_ERR_FUNCTION_NOT_FOUND;
+    }
+    if (strlen(pstrCommand) >= uSHELL_MAX_INPUT_BUF_LEN) {
+        return uSHELL_ERR_LINE_TOO_LONG;
+    }
+    strcpy(psPrepared->vstrLine, pstrCommand);
+    s_SwapBytes(m_pstrInput, psPrepared->vstrLine, sizeof(m_pstrInput));
+    s_SwapBytes(&m_sCommand, &psPrepared->sCmd, sizeof(m_sCommand));
+    const int iRetVal = m_CoreParseCommand();
+    s_SwapBytes(m_pstrInput, psPrepared->vstrLine, sizeof(m_pstrInput));
+    s_SwapBytes(&m_sCommand, &psPrepared->sCmd, sizeof(m_sCommand));
+
+    if (uSHELL_ERR_OK != iRetVal) {
+        memset(psPrepared, 0, sizeof(*psPrepared));
+        psPrepared->sCmd.iFctIndex = uSHELL_ERR_FUNCTION_NOT_FOUND;
+        return iRetVal;
+    }
+    s_RebaseCommand(&psPrepared->sCmd, m_pstrInput, psPrepared->vstrLine);
+    return iRetVal;
+} /* Prepare() */
+
+/*----------------------------------------------------------------------------*/
+/* the handler only: no stats and no scratch arena, it may run on another task while the shell parses the
+   next line; a handler which writes into its string parameters sees its own changes at the next call.
+   A slot which holds no command of this table (a failed Prepare(), another instance) is not run */
+int Microshell::RunPrepared(const preparedCmd_s *psPrepared) {
+    if ((nullptr == psPrepared) || (psPrepared->sCmd.iFctIndex < 0) || (psPrepared->sCmd.iFctIndex >= m_pInst->iNrFunctions)) {
+        return uSHELL_ERR_FUNCTION_NOT_FOUND;
+    }
+    return m_pInst->pfExec(&psPrepared->sCmd);
+} /* RunPrepared() */
+#endif /* (1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS) */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::Run(void) {
+    m_CorePrintPrompt();
+    while (m_Execute()) {
+    }
+    m_CoreStop();
+} /* Run() */
+
+#if (1 == uSHELL_IMPLEMENTS_FEED)
+/*----------------------------------------------------------------------------*/
+void Microshell::Start(void) {
+    m_CorePrintPrompt();
+} /* Start() */
+
+/*----------------------------------------------------------------------------*/
+/* the bytes go through the key handling of m_Execute() one by one (no line burst, the
+   chunk is already in RAM); a read of the handlers (the rest of a binary frame, a
+   confirmation) takes the bytes left in the chunk first, then blocks on the transport */
+bool Microshell::Feed(const char *pstrBuf, const size_t szLen) {
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+    if (false == m_pInst->bKeepRuning) {
+        return false;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    m_AsyncReport();
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    RunPosted();
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    if ((0 == szLen) && (true == m_sEscape.bActive)) {
+        m_sEscape = {}; /* the gap after a lone ESC */
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+    m_pcFeed = pstrBuf;
+    m_szFeedLeft = szLen;
+    while (m_szFeedLeft > 0) {
+        const char cByte = *m_pcFeed++;
+        --m_szFeedLeft;
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+        if (true == m_bBinaryMode) {
+            if (uSHELL_BINARY_SOF == (uint8_t)cByte) {
+                m_BinaryHandleFrame();
+            }
+        } else
+#endif /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE)*/
+        m_CoreProcessKeyPress(cByte);
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+        if (false == m_pInst->bKeepRuning) {
+            m_szFeedLeft = 0;
+            m_CoreStop();
+        }
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+    }
+    m_pcFeed = nullptr;
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+    return m_pInst->bKeepRuning;
+#else
+    return true;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+} /* Feed() */
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::FeedPending(void) const {
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    return m_sEscape.bActive;
+#else
+    return false;
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+} /* FeedPending() */
+
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+/*----------------------------------------------------------------------------*/
+/* nothing read and an escape sequence open for less than uSHELL_ESCAPE_TIMEOUT_MS: its rest may
+   still come, so it is not the gap of Feed() yet */
+bool Microshell::Poll(const uint32_t u32NowMs) {
+    char vcChunk[uSHELL_POLL_CHUNK_SIZE];
+    const int iRead = m_psTransport->pfRead((uint8_t *)vcChunk, sizeof(vcChunk), 0U);
+    const size_t szRead = (iRead > 0) ? (size_t)iRead : 0U;
+
+    if (szRead > 0) {
+        m_u32PollInputMs = u32NowMs;
+    }
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    else if ((true == m_sEscape.bActive) && ((uint32_t)(u32NowMs - m_u32PollInputMs) < uSHELL_ESCAPE_TIMEOUT_MS)) {
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+        return m_pInst->bKeepRuning;
+#else
+        return true;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+    return Feed(vcChunk, szRead);
+} /* Poll() */
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+#endif /* (1 == uSHELL_IMPLEMENTS_FEED) */
+
+#if (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER)
+/*----------------------------------------------------------------------------*/
+bool Microshell::Execute(const char *pstrCommand) {
+    bool bRetVal = false;
+    unsigned int iLen = (unsigned int)strlen(pstrCommand) + 1;
+    if ((nullptr != pstrCommand) && (iLen < uSHELL_MAX_INPUT_BUF_LEN)) {
+        strcpy(m_pstrInput, pstrCommand);
+        m_iInputPos = iLen;
+        memset(&m_sCommand, 0, sizeof(m_sCommand)); /* no leftovers from the previous command */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+        // Use the proper pHistory write mechanism (which handles both memory and file)
+        m_HistoryWrite();
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY) */
+        uSHELL_STATS_MARK();
+        if ((uSHELL_ERR_OK == m_CoreParseCommand()) && uSHELL_CMD_SUCCEEDED(m_CoreExec())) {
+            bRetVal = true;
+        }
+    }
+    return bRetVal;
+} /* Execute() */
+
+/*----------------------------------------------------------------------------*/
+/* run a ';' or newline separated list of commands without history and echo;
+   the status (parse error or return value) of each command is stored in
+   piStatusArray (optional); returns the number of commands executed */
+int Microshell::ExecuteBatch(const char *pstrBatch, int *piStatusArray, const int iMaxStatus) {
+    int iNrCommands = 0;
+
+    while ((nullptr != pstrBatch) && ('\0' != *pstrBatch)) {
+        pstrBatch += strspn(pstrBatch, m_pstrBatchSeparators);
+        pstrBatch += strspn(pstrBatch, m_pstrTokenSeparator);
+        size_t szLen = strcspn(pstrBatch, m_pstrBatchSeparators);
+        if (0 == szLen) {
+            continue; /* empty command or end of the batch */
+        }
+        if ((nullptr != piStatusArray) && (iNrCommands >= iMaxStatus)) {
+            break;
+        }
+        int iRetVal = uSHELL_ERR_LINE_TOO_LONG;
+        if (szLen < uSHELL_MAX_INPUT_BUF_LEN) {
+            m_CoreResetInput(true);
+            memcpy(m_pstrInput, pstrBatch, szLen);
+            m_iInputPos = (int)szLen;
+            uSHELL_STATS_MARK();
+            if (uSHELL_ERR_OK == (iRetVal = m_CoreParseCommand())) {
+                iRetVal = m_CoreExec();
+            }
+        }
+        if (nullptr != piStatusArray) {
+            piStatusArray[iNrCommands] = iRetVal;
+        }
+        ++iNrCommands;
+        pstrBatch += szLen;
+    }
+    m_CoreResetInput(true);
+    return iNrCommands;
+} /* ExecuteBatch() */
+
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+/*----------------------------------------------------------------------------*/
+/* execute a command held in a caller owned, read-only buffer (i.e. RX DMA buffer,
+   flash resident script) without copying it; the buffer must stay valid until
+   the command returns and the command is not written into the history */
+bool Microshell::ExecuteView(const char *pstrBuffer, const size_t szLen) {
+    bool bRetVal = false;
+    if (nullptr != pstrBuffer) {
+        memset(&m_sCommand, 0, sizeof(m_sCommand));
+        uSHELL_STATS_MARK();
+        if ((uSHELL_ERR_OK == m_CoreParseView(pstrBuffer, szLen)) && uSHELL_CMD_SUCCEEDED(m_CoreExec())) {
+            bRetVal = true;
+        }
+    }
+    return bRetVal;
+} /* ExecuteView() */
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+/*----------------------------------------------------------------------------*/
+/* run a precompiled script (i.e. a boot sequence), stops at the first failing step */
+bool Microshell::ExecuteScript(const char *pstrScriptName) {
+    bool bRetVal = false;
+    const int iIndex = m_ScriptSearch(pstrScriptName);
+    if (uSHELL_ERR_ITEM_NOT_FOUND != iIndex) {
+        int iStep = 0;
+        bRetVal = uSHELL_CMD_SUCCEEDED(m_ScriptRun(&m_pInst->psScriptsArray[iIndex], &iStep));
+    }
+    return bRetVal;
+} /* ExecuteScript() */
+#endif /* (1 == uSHELL_IMPLEMENTS_SCRIPTS) */
+#endif /* (1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) */
+
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+/*----------------------------------------------------------------------------*/
+/* hand out the ticket of the command in execution; the handler passes it to the
+   job (i.e. a worker task) and returns uSHELL_ERR_PENDING */
+int Microshell::AsyncBegin(void) {
+    m_iAsyncTicket = (m_iAsyncTicket % 0x7FFF) + 1;
+    m_iAsyncBegun = m_iAsyncTicket;
+    return m_iAsyncTicket;
+} /* AsyncBegin() */
+
+/*----------------------------------------------------------------------------*/
+/* queue the result of a pending command, reported by the shell task before it reads
+   the next key; lock free for a single completing task, returns false if the queue is full */
+bool Microshell::AsyncComplete(const int iTicket, const int iRetVal, const char *pstrOutput) {
+    const uint8_t u8Head = m_u8AsyncHead.load(std::memory_order_relaxed);
+    if ((uint8_t)(u8Head - m_u8AsyncTail.load(std::memory_order_acquire)) >= uSHELL_ASYNC_QUEUE_DEPTH) {
+        return false;
+    }
+    m_vsAsyncQueue[u8Head & (uSHELL_ASYNC_QUEUE_DEPTH - 1)] = { iTicket, iRetVal, pstrOutput };
+    m_u8AsyncHead.store((uint8_t)(u8Head + 1), std::memory_order_release);
+    return true;
+} /* AsyncComplete() */
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+/*----------------------------------------------------------------------------*/
+/* many posters: a slot is taken by a compare and swap of the head, filled, then marked ready; an interrupt
+   which posts over a task in the middle of it takes the next slot, the shell task waits for the order */
+bool Microshell::Post(const char *pstrCommand) {
+    if (nullptr == pstrCommand) {
+        return false;
+    }
+    const size_t szLen = strlen(pstrCommand);
+    if (szLen >= uSHELL_MAX_INPUT_BUF_LEN) {
+        return false;
+    }
+    uint8_t u8Head = m_u8PostHead.load(std::memory_order_relaxed);
+    do {
+        if ((uint8_t)(u8Head - m_u8PostTail.load(std::memory_order_acquire)) >= uSHELL_POST_QUEUE_DEPTH) {
+            return false;
+        }
+    } while (false == m_u8PostHead.compare_exchange_weak(u8Head, (uint8_t)(u8Head + 1), std::memory_order_relaxed));
+
+    char *pstrLine = m_vstrPostLines[u8Head & (uSHELL_POST_QUEUE_DEPTH - 1)];
+    memcpy(pstrLine, pstrCommand, szLen);
+    memset(&pstrLine[szLen], 0, uSHELL_MAX_INPUT_BUF_LEN - szLen); /* the parser splits the line in place */
+    m_vbPostReady[u8Head & (uSHELL_POST_QUEUE_DEPTH - 1)].store(true, std::memory_order_release);
+    return true;
+} /* Post() */
+
+/*----------------------------------------------------------------------------*/
+/* the line in edition waits in the slot of the posted line while it runs (swapped, as Prepare() lends its slot),
+   then is printed again under the output; a queue of lines per call at most, a posted command which posts one
+   more leaves it to the next key. Kept in the binary and machine modes, and inside an escape sequence */
+void Microshell::RunPosted(void) {
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+    if (true == m_bBinaryMode) {
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE)*/
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    if (true == m_bMachineMode) {
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_MACHINE_MODE)*/
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    if (true == m_sEscape.bActive) {
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+    uint8_t u8Tail = m_u8PostTail.load(std::memory_order_relaxed);
+    if (false == m_vbPostReady[u8Tail & (uSHELL_POST_QUEUE_DEPTH - 1)].load(std::memory_order_acquire)) {
+        return;
+    }
+
+    const int iInputPos = m_iInputPos;
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    const int iCursorPos = m_iCursorPos;
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
+    const uint8_t u8Last = (uint8_t)(u8Tail + uSHELL_POST_QUEUE_DEPTH);
+    m_CorePutString("\r\033[K");
+    do {
+        char *pstrLine = m_vstrPostLines[u8Tail & (uSHELL_POST_QUEUE_DEPTH - 1)];
+        uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "\r[post] %s\n"), pstrLine);
+        s_SwapBytes(m_pstrInput, pstrLine, sizeof(m_pstrInput));
+        m_iInputPos = (int)strlen(m_pstrInput);
+        memset(&m_sCommand, 0, sizeof(m_sCommand)); /* no leftovers from the previous command */
+        m_CoreParseExecuteCommand();
+        s_SwapBytes(m_pstrInput, pstrLine, sizeof(m_pstrInput));
+        m_vbPostReady[u8Tail & (uSHELL_POST_QUEUE_DEPTH - 1)].store(false, std::memory_order_relaxed);
+        m_u8PostTail.store(++u8Tail, std::memory_order_release);
+    } while ((u8Tail != u8Last) &&
+             (true == m_vbPostReady[u8Tail & (uSHELL_POST_QUEUE_DEPTH - 1)].load(std::memory_order_acquire)));
+
+    m_iInputPos = iInputPos;
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    m_iCursorPos = iCursorPos;
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
+    m_CoreRedrawLine();
+} /* RunPosted() */
+#endif /* (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS) */
+
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+/*----------------------------------------------------------------------------*/
+/* swap the console of this instance (i.e. UART at boot, USB-CDC once enumerated) */
+void Microshell::SetTransport(const uShellTransport_s *psTransport) {
+    m_psTransport = (nullptr != psTransport) ? psTransport : &s_sDefaultTransport;
+} /* SetTransport() */
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_STORE)
+/*----------------------------------------------------------------------------*/
+/* attach the persistent history (i.e. the flash log) and replay it, oldest first; the
+   entries go through the usual push so duplicates and the buffer limits still apply */
+void Microshell::SetHistoryStore(const uShellHistoryStore_s *psStore) {
+    m_psHistoryStore = psStore;
+    if ((nullptr != psStore) && (true == m_bHistoryInitialized)) {
+        uint32_t u32Cursor = 0U;
+        while (0U != psStore->pfNext(&u32Cursor, m_pstrInput, sizeof(m_pstrInput))) {
+            m_HistoryPush(&m_sHistory, false);
+        }
+        m_pstrInput[0] = '\0';
+    }
+} /* SetHistoryStore() */
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY_STORE) */
+
+/*==============================================================================
+            PRIVATE INTERFACES IMPLEMENTATION
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+Microshell::Microshell(uShellInst_s *psShellInst, const char *pstrPromptExt) {
+    m_pInst = psShellInst;
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    m_psTransport = &s_sDefaultTransport;
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+    m_Init(pstrPromptExt);
+} /* Microshell() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_Init(const char *pstrPromptExt) {
+#if (defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))
+    m_cStringBorderSymbol = uSHELL_KEY_QUOTATION_MARK;
+#endif /*(defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))*/
+    m_CoreSetPrompt(pstrPromptExt);
+#if ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))
+    m_HistoryInit(pstrPromptExt);
+#elif (1 == uSHELL_IMPLEMENTS_HISTORY)
+    m_HistoryInit(nullptr);
+#endif /* ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    m_AutocomplInit();
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+#if defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    m_CoreUpdatePrompt(uSHELL_PROMPTI_EDIT, true);
+#else
+    m_CoreUpdatePrompt(uSHELL_PROMPTI_EDIT, false);
+#endif /*defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
+#if (0 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+    m_pInst->psShortcutsArray[0] = {'#', nullptr}; /* core shortcut, dispatched to the instance */
+#endif /*(0 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)*/
+    m_CoreResetInput(true);
+#if (1 == uSHELL_SCRIPT_MODE)
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "uShell v%s [script mode]\n"), uSHELL_VERSION);
+#else
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "uShell v%s [info: ###]\n"), uSHELL_VERSION);
+#endif /* (1 == uSHELL_SCRIPT_MODE) */
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+    m_pInst->bKeepRuning = true;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+} /* m_Init() */
+
+/*----------------------------------------------------------------------------*/
+inline bool Microshell::m_Execute(void) {
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    m_AsyncReport();
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+#if (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)
+    RunPosted();
+#endif /*(1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)*/
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+    if (true == m_bBinaryMode) {
+        if (uSHELL_BINARY_SOF == (uint8_t)m_TransportGetch()) {
+            m_BinaryHandleFrame();
+        }
+    } else
+#endif /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE)*/
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    if (true == m_sEscape.bActive) {
+        /* the rest of a sequence follows at once, a lone ESC is dropped after the gap */
+        char cByte = 0;
+        if (true == m_TransportGetchTimeout(&cByte, uSHELL_ESCAPE_TIMEOUT_MS)) {
+            m_CoreProcessKeyPress(cByte);
+        } else {
+            m_sEscape = {};
+        }
+    } else
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+#if (1 == uSHELL_IMPLEMENTS_LINE_BURST)
+    if ((0 == m_iInputPos) && (true == m_CoreProcessLineBurst())) {
+        /* a complete line was taken at once */
+    } else
+#endif /*(1 == uSHELL_IMPLEMENTS_LINE_BURST)*/
+    m_CoreProcessKeyPress(m_TransportGetch());
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+    return m_pInst->bKeepRuning;
+#else
+    return true;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+} /* m_Execute() */
+
+/*----------------------------------------------------------------------------*/
+/* after the exit command */
+void Microshell::m_CoreStop(void) {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+    m_HistoryDeInit();
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_LIST_COLOR, "uShell exit!\n\r"));
+} /* m_CoreStop() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreParseExecuteCommand(void) {
+    int iRetVal = 0;
+    uSHELL_PROBE(SHELL_LINE_BEGIN);
+    uSHELL_STATS_MARK();
+    if (uSHELL_ERR_OK == (iRetVal = m_CoreParseCommand())) {
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+        m_iAsyncBegun = 0;
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+        if ((iRetVal = m_CoreExec()) >= 0) {
+            uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %d (0x%X)\n"), iRetVal, iRetVal);
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+        } else if (uSHELL_ERR_PENDING == iRetVal) {
+            m_AsyncPrintPending();
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+        } else {
+            m_CorePrintError(iRetVal); /* execution errors */
+        }
+    } else {
+        m_CorePrintError(iRetVal); /* parsing errors */
+    }
+    uSHELL_PROBE(SHELL_LINE_END);
+} /* m_CoreParseExecuteCommand() */
+
+/*----------------------------------------------------------------------------*/
+/* call the handler of the parsed command; with the command stats the parse time
+   (since the mark) and the handler time are added to the entry of the command */
+int Microshell::m_CoreExec(void) {
+    uSHELL_SCRATCH_MARK();
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+    const uint32_t u32Start = uSHELL_STATS_CYCLES();
+    uSHELL_PROBE(SHELL_EXEC_BEGIN);
+    const int iRetVal = m_pInst->pfExec(&m_sCommand);
+    uSHELL_PROBE(SHELL_EXEC_END);
+    const uint32_t u32Exec = uSHELL_STATS_CYCLES() - u32Start;
+    uSHELL_SCRATCH_RELEASE();
+    const uint32_t u32Parse = u32Start - m_u32StatsMark;
+    cmdStats_s *psStats = &m_pInst->psCmdStatsArray[m_sCommand.iFctIndex];
+
+    ++psStats->u32Calls;
+    if (!uSHELL_CMD_SUCCEEDED(iRetVal)) {
+        ++psStats->u32Errors;
+    }
+    psStats->u64ParseCycles += u32Parse;
+    psStats->u64ExecCycles += u32Exec;
+    if (u32Parse > psStats->u32ParseMax) {
+        psStats->u32ParseMax = u32Parse;
+    }
+    if (u32Exec > psStats->u32ExecMax) {
+        psStats->u32ExecMax = u32Exec;
+    }
+    return iRetVal;
+#else
+    uSHELL_PROBE(SHELL_EXEC_BEGIN);
+    const int iRetVal = m_pInst->pfExec(&m_sCommand);
+    uSHELL_PROBE(SHELL_EXEC_END);
+    uSHELL_SCRATCH_RELEASE();
+    return iRetVal;
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+} /* m_CoreExec() */
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreParseCommand(void) {
+    int iRetVal = uSHELL_ERR_OK;
+    char *pstrRest = m_pstrInput;
+    char *pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
+    m_sCommand.pstrFctName = pstrToken;
+    if (uSHELL_ERR_FUNCTION_NOT_FOUND != (m_sCommand.iFctIndex = m_CoreSearchFunction(pstrToken))) {
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+        const paramsDecoder_s *psDecoder = &m_pInst->psParamsDecoderArray[m_pInst->psFuncDefArray[m_sCommand.iFctIndex].u8ParamsPattern];
+        bool bIsVoidFct = (0 == psDecoder->u8NrParams);
+        int iNrParamsExpected = psDecoder->u8NrParams;
+#else
+        bool bIsVoidFct = ('v' == m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[0]);
+        int iNrParamsExpected = (int)strlen(m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef);
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+        bool bHasParams = (nullptr != pstrRest);
+
+        if ((true == bHasParams) && (false == bIsVoidFct)) {
+            int iNrParamsRead = 0;
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+#if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
+            /* check if the first param is a bordered string */
+            iRetVal = m_CoreHandleBorderedStrings(&pstrToken, &pstrRest, &iNrParamsRead);
+#endif /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS) */
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS) */
+            while ((uSHELL_ERR_OK == iRetVal) && (nullptr != (pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest)))) {
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+                iRetVal = m_CoreDecodeParam(psDecoder, pstrToken, strlen(pstrToken), &iNrParamsRead);
+#else
+                switch (m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[(m_sCommand.iTypIndex)++]) {
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+                case 'l': { /* [l]ong <==> 64 bit */
+                    if (m_sCommand.iNrNums64 < uSHELL_MAX_PARAMS_NUM64) {
+                        BIGNUM_T numVal = 0;
+                        if (false == asc2int(pstrToken, &numVal)) {
+                            iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                        } else {
+                            if (numVal > uSHELL_MAX_VALUE_64BIT) {
+                                iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+                            } else {
+                                m_sCommand.vl[m_sCommand.iNrNums64++] = (num64_t)numVal;
+                                ++iNrParamsRead;
+                            }
+                        }
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_64BIT;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+                case 'i': { /* [i]nteger <==> 32 bit */
+                    if (m_sCommand.iNrNums32 < uSHELL_MAX_PARAMS_NUM32) {
+                        BIGNUM_T numVal = 0;
+                        if (false == asc2int(pstrToken, &numVal)) {
+                            iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                        } else {
+                            if (numVal > uSHELL_MAX_VALUE_32BIT) {
+                                iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+                            } else {
+                                m_sCommand.vi[m_sCommand.iNrNums32++] = (num32_t)numVal;
+                                ++iNrParamsRead;
+                            }
+                        }
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_32BIT;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+                case 'w': { /* [w]ord <==> 16 bit */
+                    if (m_sCommand.iNrNums16 < uSHELL_MAX_PARAMS_NUM16) {
+                        BIGNUM_T numVal = 0;
+                        if (false == asc2int(pstrToken, &numVal)) {
+                            iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                        } else {
+                            if (numVal > uSHELL_MAX_VALUE_16BIT) {
+                                iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+                            } else {
+                                m_sCommand.vw[m_sCommand.iNrNums16++] = (num16_t)numVal;
+                                ++iNrParamsRead;
+                            }
+                        }
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_16BIT;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+                case 'b': { /* [b]yte <==> 8 bit */
+                    if (m_sCommand.iNrNums8 < uSHELL_MAX_PARAMS_NUM8) {
+                        BIGNUM_T numVal = 0;
+                        if (false == asc2int(pstrToken, &numVal)) {
+                            iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                        } else {
+                            if (numVal > uSHELL_MAX_VALUE_8BIT) {
+                                iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+                            } else {
+                                m_sCommand.vb[m_sCommand.iNrNums8++] = (num8_t)numVal;
+                                ++iNrParamsRead;
+                            }
+                        }
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_8BIT;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+                case 'f': {
+                    float numVal = 0;
+                    if (m_sCommand.iNrNumsFloat < uSHELL_MAX_PARAMS_FLOAT) {
+                        if (false == asc2float(pstrToken, &numVal)) {
+                            iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                        } else {
+                            m_sCommand.vf[m_sCommand.iNrNumsFloat++] = numVal;
+                            ++iNrParamsRead;
+                        }
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_FLOAT;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+                case 's': { /* [s]tring <==> (char*) */
+                    if (m_sCommand.iNrStrings < uSHELL_MAX_PARAMS_STRING) {
+                        m_sCommand.vs[m_sCommand.iNrStrings++] = pstrToken;
+                        ++iNrParamsRead;
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_STRING;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+#if defined(uSHELL_IMPLEMENTS_BOOLEAN)
+                case 'o': { /* b[o]ol <==> bool */
+                    if (m_sCommand.iNrBools < uSHELL_MAX_PARAMS_BOOLEAN) {
+                        BIGNUM_T numVal = 0;
+                        if (false == asc2int(pstrToken, &numVal)) {
+                            iRetVal = uSHELL_ERR_INVALID_NUMBER;
+                        } else {
+                            if (numVal > uSHELL_MAX_VALUE_BOOLEAN) {
+                                iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+                            } else {
+                                m_sCommand.vo[m_sCommand.iNrBools++] = (bool)numVal;
+                                ++iNrParamsRead;
+                            }
+                        }
+                    } else {
+                        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                    }
+                    if (uSHELL_ERR_OK != iRetVal) {
+                        m_sCommand.eDataType = uSHELL_DATA_TYPE_BOOL;
+                    }
+                } break;
+#endif /*defined(uSHELL_IMPLEMENTS_BOOLEAN)*/
+                // default: {
+                default: { /* unsuported type or more params than defined */
+                    if (m_sCommand.iTypIndex != iNrParamsExpected) {
+                        iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+                    } else {
+                        iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+                    }
+                } break;
+                } /* switch(...)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+#if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
+                if (uSHELL_ERR_OK == iRetVal) {
+                    iRetVal = m_CoreHandleBorderedStrings(&pstrToken, &pstrRest, &iNrParamsRead);
+                }
+#endif        /* (1 == uSHELL_SUPPORTS_SPACED_STRINGS) */
+#endif        /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+            } /* while(...) */
+            if (uSHELL_ERR_OK != iRetVal) {
+                m_sCommand.iErrorInfo = m_sCommand.iTypIndex - 1;
+            } else {
+                if (m_sCommand.iTypIndex != iNrParamsExpected) {
+                    iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+                }
+            }
+        } else {
+            if (((true == bIsVoidFct) && (true == bHasParams)) || ((false == bIsVoidFct) && (false == bHasParams))) {
+                iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+            }
+        }
+    } else {
+        iRetVal = uSHELL_ERR_FUNCTION_NOT_FOUND;
+    }
+    return iRetVal;
+} /* m_CoreParseCommand() */
+
+#if ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) && defined(uSHELL_IMPLEMENTS_STRING_VIEWS))
+/*----------------------------------------------------------------------------*/
+/* non destructive variant of m_CoreParseCommand(), the arguments are ranges of the
+   caller's buffer; commands needing NUL terminated arguments (string, float) or
+   decoding in place (hex) are parsed from a copy of the buffer */
+int Microshell::m_CoreParseView(const char *pstrBuffer, const size_t szLen) {
+    int iRetVal = uSHELL_ERR_OK;
+    const char *pstrCursor = pstrBuffer;
+    const char *pstrEnd = pstrBuffer + szLen;
+    strview_s sToken = {nullptr, 0};
+
+    if ((false == strtok_view(&pstrCursor, pstrEnd, m_pstrTokenSeparator, &sToken)) ||
+        (uSHELL_ERR_FUNCTION_NOT_FOUND == (m_sCommand.iFctIndex = m_CoreSearchFunction(sToken.pstr, sToken.szLen)))) {
+        return uSHELL_ERR_FUNCTION_NOT_FOUND;
+    }
+    m_sCommand.pstrFctName = m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFctName;
+
+    const paramsDecoder_s *psDecoder = &m_pInst->psParamsDecoderArray[m_pInst->psFuncDefArray[m_sCommand.iFctIndex].u8ParamsPattern];
+#if (defined(uSHELL_IMPLEMENTS_STRINGS) || defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT) || defined(uSHELL_IMPLEMENTS_HEX_BUFFERS))
+    for (int i = 0; (i < psDecoder->u8NrParams) && (i < (int)uSHELL_MAX_PARAMS_TOTAL); ++i) {
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+        const bool bIsString = (uSHELL_DATA_TYPE_STRING == psDecoder->vu8Types[i]);
+#else
+        const bool bIsString = false;
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+        const bool bIsFloat = (uSHELL_DATA_TYPE_FLOAT == psDecoder->vu8Types[i]);
+#else
+        const bool bIsFloat = false;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+        const bool bIsHex = (uSHELL_DATA_TYPE_HEXBUF == psDecoder->vu8Types[i]);
+#else
+        const bool bIsHex = false;
+#endif /*defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)*/
+        if ((true == bIsString) || (true == bIsFloat) || (true == bIsHex)) {
+            if (szLen >= uSHELL_MAX_INPUT_BUF_LEN) {
+                return uSHELL_ERR_LINE_TOO_LONG;
+            }
+            m_CoreResetInput(true);
+            memcpy(m_pstrInput, pstrBuffer, szLen);
+            m_iInputPos = (int)szLen;
+            memset(&m_sCommand, 0, sizeof(m_sCommand));
+            return m_CoreParseCommand();
+        }
+    }
+#endif /*(defined(uSHELL_IMPLEMENTS_STRINGS) || defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT) || defined(uSHELL_IMPLEMENTS_HEX_BUFFERS))*/
+
+    int iNrParamsRead = 0;
+    while ((uSHELL_ERR_OK == iRetVal) && (true == strtok_view(&pstrCursor, pstrEnd, m_pstrTokenSeparator, &sToken))) {
+#if (defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))
+        /* a bordered view keeps the separators; the borders are not part of it */
+        if (m_cStringBorderSymbol == *sToken.pstr) {
+            const char *pstrClose = (const char *)memchr(sToken.pstr + 1, m_cStringBorderSymbol, (size_t)(pstrEnd - sToken.pstr - 1));
+            if (nullptr == pstrClose) {
+                m_sCommand.eDataType = uSHELL_DATA_TYPE_VIEW;
+                iRetVal = uSHELL_ERR_STRING_NOT_CLOSED;
+                break;
+            }
+            sToken.pstr += 1;
+            sToken.szLen = (size_t)(pstrClose - sToken.pstr);
+            pstrCursor = pstrClose + 1;
+        }
+#endif /*(defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))*/
+        /* the token is only read, a view never writes into the buffer */
+        iRetVal = m_CoreDecodeParam(psDecoder, (char *)sToken.pstr, sToken.szLen, &iNrParamsRead);
+    }
+    if (uSHELL_ERR_OK != iRetVal) {
+        m_sCommand.iErrorInfo = m_sCommand.iTypIndex - 1;
+    } else if (m_sCommand.iTypIndex != psDecoder->u8NrParams) {
+        iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+    }
+    return iRetVal;
+} /* m_CoreParseView() */
+#endif /* ((1 == uSHELL_SUPPORTS_COMMAND_AS_PARAMETER) && defined(uSHELL_IMPLEMENTS_STRING_VIEWS)) */
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreDecodeParam(const paramsDecoder_s *psDecoder, char *pstrToken, const size_t szLen, int *piNrParamsRead) {
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+    /* the tokens after the first value of the array (the last parameter) are values of it as well */
+    if ((m_sCommand.iNrArrays > 0) && (m_sCommand.iTypIndex == psDecoder->u8NrParams)) {
+        return m_CoreArrayAppend(pstrToken, szLen);
+    }
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)*/
+    const int iSlot = (m_sCommand.iTypIndex)++;
+    if (iSlot >= psDecoder->u8NrParams) {
+        return uSHELL_ERR_WRONG_NUMBER_ARGS;
+    }
+    if (iSlot >= (int)uSHELL_MAX_PARAMS_TOTAL) {
+        m_sCommand.eDataType = uSHELL_DATA_TYPE_LAST;
+        return uSHELL_ERR_TOO_MANY_ARGS;
+    }
+    const int iType = psDecoder->vu8Types[iSlot];
+    if ((iType >= uSHELL_TYPE_LAST) || (uSHELL_TYPE_VOID == iType)) {
+        return uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+    }
+
+    int iRetVal = uSHELL_ERR_OK;
+    const typeDecoder_s *psType = &m_vsTypeDecoders[iType];
+    uint8_t *pu8Base = (uint8_t *)&m_sCommand;
+    unsigned int *piCount = (unsigned int *)(pu8Base + psType->u16CntOffset);
+
+    if (*piCount < psType->u8MaxParams) {
+        void *pvDest = pu8Base + psType->u16ValOffset + (*piCount * psType->u8ValSize);
+#if (1 == uSHELL_IMPLEMENTS_LOOPS)
+        if (true == m_LoopIsVariable(pstrToken, szLen)) {
+            /* a 0 until the turns store the value (m_LoopStoreVariable), an integer parameter only */
+            bool bInteger = (psType->maxValue > 0U); /* not a float, a string or a view */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+            bInteger = bInteger && (uSHELL_TYPE_FIXED != iType);
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+            bInteger = bInteger && (uSHELL_TYPE_ARRAY != iType);
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)*/
+            iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+            if (true == bInteger) {
+                m_u32LoopVarSlots |= (1UL << iSlot);
+                iRetVal = uSHELL_ERR_OK;
+            }
+        } else
+#endif /*(1 == uSHELL_IMPLEMENTS_LOOPS)*/
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+        if (uSHELL_TYPE_STRING == iType) {
+            *(str_t **)pvDest = pstrToken;
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+        if (uSHELL_TYPE_VIEW == iType) {
+            ((strview_s *)pvDest)->pstr = pstrToken;
+            ((strview_s *)pvDest)->szLen = szLen;
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_STRING_VIEWS)*/
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+        if (uSHELL_TYPE_HEXBUF == iType) {
+            /* the bytes take the place of the digits, no buffer of their own */
+            if (false == unhexlify_inplace(pstrToken, szLen, &((hexbuf_s *)pvDest)->szLen)) {
+                iRetVal = uSHELL_ERR_INVALID_NUMBER;
+            } else {
+                ((hexbuf_s *)pvDest)->pu8Data = (uint8_t *)pstrToken;
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+        if (uSHELL_TYPE_ARRAY == iType) {
+            if ((iSlot + 1) != psDecoder->u8NrParams) {
+                iRetVal = uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM; /* the values of an array run to the line end */
+            } else {
+                ((numarray_s *)pvDest)->pu32Items = m_sCommand.vu32Items;
+                iRetVal = m_CoreArrayAppend(pstrToken, szLen);
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+        if (uSHELL_TYPE_FLOAT == iType) {
+            if (false == asc2float(pstrToken, (numfp_t *)pvDest)) {
+                iRetVal = uSHELL_ERR_INVALID_NUMBER;
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+        if (uSHELL_TYPE_FIXED == iType) {
+            iRetVal = asc2fixed(pstrToken, szLen, (numq_t *)pvDest);
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+        if (psType->u8ValSize > sizeof(uint32_t)) {
+            BIGNUM_T numVal = 0;
+            if (uSHELL_ERR_OK == (iRetVal = asc2int_max(pstrToken, szLen, psType->maxValue, &numVal))) {
+                *(num64_t *)pvDest = numVal;
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+        {
+#if defined(BIGNUM_T)
+            /* 'b', 'w', 'i' and 'o' never leave the 32 bit arithmetic */
+            uint32_t u32Val = 0;
+            if (uSHELL_ERR_OK == (iRetVal = asc2int32_max(pstrToken, szLen, (uint32_t)psType->maxValue, &u32Val))) {
+                m_CoreStoreNumber(pvDest, psType->u8ValSize, u32Val);
+            }
+#else
+            iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+#endif /*defined(BIGNUM_T)*/
+        }
+        if (uSHELL_ERR_OK == iRetVal) {
+            ++(*piCount);
+            ++(*piNrParamsRead);
+        }
+    } else {
+        iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+    }
+    if (uSHELL_ERR_OK != iRetVal) {
+        m_sCommand.eDataType = (dataType_e)iType;
+    }
+    return iRetVal;
+} /* m_CoreDecodeParam() */
+
+#if defined(BIGNUM_T)
+/*----------------------------------------------------------------------------*/
+/* the targets of at most 32 bits, the 64 bit ones are stored by their callers */
+void Microshell::m_CoreStoreNumber(void *pvDest, const uint8_t u8ValSize, const uint32_t u32Val) {
+    switch (u8ValSize) {
+        case sizeof(uint8_t) : { *(uint8_t  *)pvDest = (uint8_t)u32Val;  } break;
+        case sizeof(uint16_t): { *(uint16_t *)pvDest = (uint16_t)u32Val; } break;
+        default              : { *(uint32_t *)pvDest = u32Val;           } break;
+    }
+} /* m_CoreStoreNumber() */
+#endif /* defined(BIGNUM_T) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+/*----------------------------------------------------------------------------*/
+/* one more value of the array parameter, up to uSHELL_MAX_ARRAY_ITEMS */
+int Microshell::m_CoreArrayAppend(const char *pstrToken, const size_t szLen) {
+    numarray_s *psArray = &m_sCommand.va[0];
+    int iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+    if (psArray->szCount < uSHELL_MAX_ARRAY_ITEMS) {
+        uint32_t u32Val = 0;
+        if (uSHELL_ERR_OK == (iRetVal = asc2int32_max(pstrToken, szLen, uSHELL_MAX_VALUE_32BIT, &u32Val))) {
+            m_sCommand.vu32Items[psArray->szCount++] = (num32_t)u32Val;
+        }
+    }
+    if (uSHELL_ERR_OK != iRetVal) {
+        m_sCommand.eDataType = uSHELL_DATA_TYPE_ARRAY;
+    }
+    return iRetVal;
+} /* m_CoreArrayAppend() */
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CorePrintError(const int iError) {
+    static const char *pstrErrorUnknown = " ?";
+    static const char *pstrErrorCaption = " : ";
+    const char *pstrErrorString = nullptr;
+    bool bIsTooManyArgsError = false;
+    bool bIsInvalidNumError = false;
+    bool bIsNumBigValueError = false;
+
+    switch(iError) {
+        case uSHELL_ERR_FUNCTION_NOT_FOUND       : { pstrErrorString = "command not found";}                 break;
+        case uSHELL_ERR_WRONG_NUMBER_ARGS        : { pstrErrorString = "wrong number of arguments";}         break;
+        case uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM    : { pstrErrorString = "data type not implem/enabled";}      break;
+        case uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM: { pstrErrorString = "params pattern not implem/enabled";} break;
+        case uSHELL_ERR_STRING_NOT_CLOSED        : { pstrErrorString = "string not closed"; }                break;
+        case uSHELL_ERR_INVALID_FRAME            : { pstrErrorString = "invalid frame"; }                    break;
+        case uSHELL_ERR_LINE_TOO_LONG            : { pstrErrorString = "line too long"; }                    break;
+        case uSHELL_ERR_TOO_MANY_ARGS            : { bIsTooManyArgsError = true;} break;
+        case uSHELL_ERR_INVALID_NUMBER           : { bIsInvalidNumError  = true;} break;
+        case uSHELL_ERR_VALUE_TOO_BIG            : { bIsNumBigValueError = true;} break;
+        default                                  : { pstrErrorString = pstrErrorUnknown;} break;
+    }
+    if((true == bIsInvalidNumError) || (true == bIsTooManyArgsError) || (true == bIsNumBigValueError)) {
+        const char *pstrErrorDescription = bIsInvalidNumError  ? "invalid " :
+                                           bIsTooManyArgsError ? "too many args of type " :
+                                           bIsNumBigValueError ? "value too big for " : pstrErrorUnknown;
+        const char *pstrErrorDetail = (m_sCommand.eDataType < uSHELL_DATA_TYPE_LAST) ? m_vstrTypeNames[m_sCommand.eDataType] : pstrErrorUnknown;
+
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r%s%s%s (arg:%d) | %s:%s\n"), pstrErrorCaption, pstrErrorDescription, pstrErrorDetail, (m_sCommand.iErrorInfo + 1), m_sCommand.pstrFctName, m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef);
+    } else {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r%s%s | %s:%s\n"), pstrErrorCaption, pstrErrorString, m_sCommand.pstrFctName, ((uSHELL_ERR_FUNCTION_NOT_FOUND == iError) ? pstrErrorUnknown : m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef));
+    }
+} /* m_CorePrintError() */
+
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+#if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreHandleBorderedStrings(char **ppstrToken, char **ppstrRest, int *pIntArgCounter) {
+    int iRetVal = uSHELL_ERR_OK;
+    bool bFound = false;
+
+    while ((nullptr != *ppstrRest) && (*m_pstrTokenSeparator == **ppstrRest)) {
+        (*ppstrRest)++; /* cleanup the leading separators */
+    }
+    while ((nullptr != *ppstrRest) && (m_cStringBorderSymbol == **ppstrRest)) {
+        *ppstrToken = *ppstrRest + 1;
+        while ('\0' != *((*ppstrRest)++)) {
+            if (m_cStringBorderSymbol == **ppstrRest) {
+                bFound = true;
+                break;
+            }
+        }
+        if (true == bFound) {
+            bFound = false;
+            **ppstrRest = '\0';
+            while(*m_pstrTokenSeparator == *(++(*ppstrRest)));   /* cleanup the trailing separators */
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+            const paramsDecoder_s *psDecoder = &m_pInst->psParamsDecoderArray[m_pInst->psFuncDefArray[m_sCommand.iFctIndex].u8ParamsPattern];
+            const int iSlot = (m_sCommand.iTypIndex)++;
+            if((iSlot < psDecoder->u8NrParams) && (iSlot < (int)uSHELL_MAX_PARAMS_TOTAL) && (uSHELL_DATA_TYPE_STRING == psDecoder->vu8Types[iSlot])) {
+#else
+            if('s' == m_pInst->psFuncDefArray[m_sCommand.iFctIndex].pstrFuncParamDef[(m_sCommand.iTypIndex)++]) {
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+                if(m_sCommand.iNrStrings < uSHELL_MAX_PARAMS_STRING) {
+                    m_sCommand.vs[m_sCommand.iNrStrings++] = *ppstrToken;
+                    ++(*pIntArgCounter);
+                } else {
+                    iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                }
+            } else {
+                iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+            }
+        } else {
+            iRetVal = uSHELL_ERR_STRING_NOT_CLOSED;
+        }
+    }
+    if (uSHELL_ERR_OK != iRetVal) {
+        m_sCommand.eDataType = uSHELL_DATA_TYPE_STRING;
+    }
+    return iRetVal;
+} /* m_CoreHandleBorderedStrings() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreSetStringBorder(const char *pstrStringBorder) {
+    int iLen = (int)strlen(pstrStringBorder);
+    if (iLen > 1) {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, ": only one symbol expected\n\r"));
+    } else {
+        m_cStringBorderSymbol = (0 == iLen) ? uSHELL_KEY_QUOTATION_MARK : *pstrStringBorder;
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+        m_pInst->vstrPrompt[uSHELL_PROMPTI_LAST] = m_cStringBorderSymbol;
+#endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
+    }
+} /* m_CoreSetStringBorder() */
+#endif /* (1 == uSHELL_SUPPORTS_SPACED_STRINGS) */
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreResetInput(const bool bFull) {
+    memset(m_pstrInput, 0, sizeof(m_pstrInput));
+    m_iInputPos = 0;
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    m_iCursorPos = 0;
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    m_bEditMode = false;
+#endif /*!defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+    if (true == bFull) {
+        memset(&m_sCommand, 0, sizeof(m_sCommand));
+    }
+} /* m_CoreResetInput() */
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_CorePutString(const char *pstrArray) {
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    if (true == m_bDumbTerminal) {
+        char vstrPlain[uSHELL_RENDER_FORMAT_SIZE];
+        if (true == s_RenderStrip(pstrArray, vstrPlain, sizeof(vstrPlain))) {
+            pstrArray = vstrPlain;
+        }
+        m_TransportWrite(pstrArray, strlen(pstrArray));
+        return;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+    m_TransportWrite(pstrArray, strlen(pstrArray));
+} /*m_CorePutString() */
+
+/*----------------------------------------------------------------------------*/
+inline char Microshell::m_TransportGetch(void) {
+#if (1 == uSHELL_IMPLEMENTS_FEED)
+    if (m_szFeedLeft > 0) {
+        --m_szFeedLeft;
+        return *m_pcFeed++;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_FEED) */
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    uint8_t u8Byte = 0;
+    (void)m_psTransport->pfRead(&u8Byte, 1, uSHELL_TRANSPORT_WAIT_FOREVER);
+    return (char)u8Byte;
+#else
+    return (char)uSHELL_GETCH();
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+} /* m_TransportGetch() */
+
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+/*----------------------------------------------------------------------------*/
+/* false if nothing came within u32TimeoutMs (the build's console blocks) */
+inline bool Microshell::m_TransportGetchTimeout(char *pcByte, const uint32_t u32TimeoutMs) {
+#if (1 == uSHELL_IMPLEMENTS_FEED)
+    if (m_szFeedLeft > 0) {
+        --m_szFeedLeft;
+        *pcByte = *m_pcFeed++;
+        return true;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_FEED) */
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    uint8_t u8Byte = 0;
+    if (1 != m_psTransport->pfRead(&u8Byte, 1, u32TimeoutMs)) {
+        return false;
+    }
+    *pcByte = (char)u8Byte;
+#else
+    (void)u32TimeoutMs;
+    *pcByte = (char)uSHELL_GETCH();
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+    return true;
+} /* m_TransportGetchTimeout() */
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_TransportPutch(const char cChar) {
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    m_psTransport->pfWrite((const uint8_t *)&cChar, 1);
+#else
+    uSHELL_PUTCH(cChar);
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+} /* m_TransportPutch() */
+
+/*----------------------------------------------------------------------------*/
+/* one backend call for the whole buffer */
+inline void Microshell::m_TransportWrite(const char *pstrBuf, const size_t szLen) {
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    if (szLen > 0) {
+        m_psTransport->pfWrite((const uint8_t *)pstrBuf, szLen);
+    }
+#else
+    for (size_t i = 0; i < szLen; ++i) {
+        uSHELL_PUTCH(pstrBuf[i]);
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+} /* m_TransportWrite() */
+
+/*----------------------------------------------------------------------------*/
+/* false if the transport timed out before szLen bytes */
+inline bool Microshell::m_TransportRead(uint8_t *pu8Buf, size_t szLen) {
+#if (1 == uSHELL_IMPLEMENTS_FEED)
+    const size_t szFed = (szLen < m_szFeedLeft) ? szLen : m_szFeedLeft;
+    if (szFed > 0) {
+        memcpy(pu8Buf, m_pcFeed, szFed);
+        m_pcFeed += szFed;
+        m_szFeedLeft -= szFed;
+        pu8Buf += szFed;
+        szLen -= szFed;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_FEED) */
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    return ((0 == szLen) || ((int)szLen == m_psTransport->pfRead(pu8Buf, szLen, uSHELL_TRANSPORT_WAIT_FOREVER)));
+#else
+    for (size_t i = 0; i < szLen; ++i) {
+        pu8Buf[i] = (uint8_t)uSHELL_GETCH();
+    }
+    return true;
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+} /* m_TransportRead() */
+
+/*----------------------------------------------------------------------------*/
+inline int Microshell::m_TransportGetLine(char *pstrBuf, const int iMaxLen) {
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+    return (nullptr != m_psTransport->pfReadLine) ? m_psTransport->pfReadLine(pstrBuf, iMaxLen) : 0;
+#else
+    (void)pstrBuf;
+    (void)iMaxLen;
+    return uSHELL_GETLINE(pstrBuf, iMaxLen);
+#endif /* (1 == uSHELL_IMPLEMENTS_TRANSPORT) */
+} /* m_TransportGetLine() */
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_CoreRemoveTrailingSpaces(void) {
+    /* stops at the line start: a line of spaces (or an empty one) must not read before the buffer */
+    while ((m_iInputPos > 0) && (uSHELL_KEY_SPACE == m_pstrInput[m_iInputPos - 1])) {
+        --m_iInputPos;
+    }
+    m_pstrInput[m_iInputPos] = '\0';
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if (m_iCursorPos > m_iInputPos) {
+        m_iCursorPos = m_iInputPos; /* the edit cursor was on one of the spaces */
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+} /* m_CoreRemoveTrailingSpaces() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreCmdLineDelete(void) {
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    const int iOldLen = m_iInputPos;
+    const int iCursor = m_RenderCursor();
+    m_CoreResetInput(false);
+    m_RenderTail(0, iCursor, iOldLen, 0);
+#else
+    m_CoreResetInput(false);
+    uSHELL_PRINTF("\r\033[%dC\033[K", m_pInst->iPromptLength);
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    m_AutocomplReset(uSHELL_AUTOCOMPL_RELOAD);
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+} /* m_CoreCmdLineDelete() */
+
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+inline void Microshell::m_CoreUpdatePrompt(const prompti_e ePromptIndex, const bool bOnOff) {
+    m_pInst->vstrPrompt[ePromptIndex] = ((true == bOnOff) ? m_pstrPromptInfo[ePromptIndex] : tolower(m_pstrPromptInfo[ePromptIndex]));
+} /* m_CoreUpdatePrompt() */
+#endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
+
+/*==============================================================================
+                  KEY HANDLE
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+uSHELL_HOT_FUNC void Microshell::m_CoreProcessKeyPress(const char cKeyPressed) {
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    if (true == m_bMachineMode) {
+        m_MachineProcessKey(cKeyPressed);
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_MACHINE_MODE)*/
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    if ((true == m_sEscape.bActive) && (true == m_EscapeFeed(cKeyPressed))) {
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+    /* a start of frame on an empty line carries a single binary command */
+    if ((0 == m_iInputPos) && (uSHELL_BINARY_SOF == (uint8_t)cKeyPressed)) {
+        m_BinaryHandleFrame();
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+    if ((true == m_bSearchActive) && (true == m_SearchHandleKey(cKeyPressed))) {
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)*/
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+    if (uSHELL_CORE_IS_ESCAPE_INTRO(cKeyPressed)) {
+        m_EscapeStart(); /* the key is handled once the sequence is decoded */
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+#if (0 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    m_CorePutString("\033[?25l"); /* hide cursor */
+#endif /* (0 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    if (true == m_sAutocomplete.bEnabled) {
+        m_sAutocomplete.cCrtKey = cKeyPressed;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+    switch (cKeyPressed) {
+    case uSHELL_KEY_ENTER: {
+        m_CoreHandleKeyEnter();
+    } break;
+    case uSHELL_KEY_BACKSPACE: {
+        m_CoreHandleKeyBackspace();
+    } break;
+#if (0 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+    case uSHELL_KEY_ESCAPESEQ1: /* fall through (needed for _MSC_VER for INS/DEL on numeric pad*/
+#endif                          /*(defined(__MINGW32__) || defined(_MSC_VER)) */
+    case uSHELL_KEY_ESCAPESEQ: {
+        m_CoreHandleKeyEscapeSeq();
+    } break;
+#endif /*(0 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+#if (defined(SERIAL_TERMINAL) && !defined(__AVR__))
+    case uSHELL_KEY_DELETE: {
+        m_CoreHandleKeyDelete();
+    } break;
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    case uSHELL_KEY_INSERT: {
+        m_CoreHandleKeyInsert();
+    } break;
+#else
+    case uSHELL_KEY_INSERT:
+        break; /*ignore */
+#endif /*!defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+#endif /* ( defined(SERIAL_TERMINAL) && !defined(__AVR__)) ) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    case uSHELL_KEY_TAB: {
+        m_CoreHandleKeyInsert();
+    } break;
+#else
+    case uSHELL_KEY_TAB:
+        break; /*ignore */
+#endif /*!defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
+#endif /* defined(uSHELL_IMPLEMENTS_EDITMODE) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    case uSHELL_KEY_CTRL_U: {
+        m_EditDeleteBackwardToHome();
+    } break;
+    case uSHELL_KEY_CTRL_K: {
+        m_EditDeleteForwardToEnd();
+    } break;
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+    case uSHELL_KEY_CTRL_R: {
+        m_SearchStart();
+    } break;
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH) */
+    default: {
+        m_CoreHandleKeyDefault(cKeyPressed);
+    } break;
+    }
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    if (true == m_sAutocomplete.bEnabled) {
+        m_sAutocomplete.cPrevKey = cKeyPressed;
+    }
+#endif                            /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+#if (0 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    m_CorePutString("\033[?25h"); /* show cursor */
+#endif /* (0 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+
+} /* m_CoreProcessKeyPress() */
+
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_IMPLEMENTS_LINE_BURST)
+bool Microshell::m_CoreProcessLineBurst(void) {
+    /* the backend hands over a line only if it is already complete (IDLE line or CR seen),
+       so the echo, edit and autocomplete work per key is skipped and the line is parsed once */
+    if (m_TransportGetLine(m_pstrInput, (int)sizeof(m_pstrInput)) <= 0) {
+        return false;
+    }
+    m_iInputPos = (int)strlen(m_pstrInput);
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    if (true == m_bMachineMode) {
+        m_MachineExecuteLine();
+        return true;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_MODE) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if (true == m_bEditMode) {
+        m_iCursorPos = m_iInputPos;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+    if (true == m_bEchoOn) {
+        m_CorePutString(m_pstrInput);
+    }
+#else
+    m_CorePutString(m_pstrInput);
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    if (true == m_sAutocomplete.bEnabled) {
+        m_sAutocomplete.cCrtKey = uSHELL_KEY_ENTER;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+    m_CoreHandleKeyEnter();
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    if (true == m_sAutocomplete.bEnabled) {
+        m_sAutocomplete.cPrevKey = uSHELL_KEY_ENTER;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+    return true;
+} /* m_CoreProcessLineBurst() */
+#endif /*(1 == uSHELL_IMPLEMENTS_LINE_BURST)*/
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreExecuteEnterKey(void) {
+    if (false == m_CoreHandleShortcuts()) {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+        m_HistoryWrite();
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+#if (1 == uSHELL_IMPLEMENTS_LOOPS)
+        if (true == m_LoopHandle()) {
+            return;
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_LOOPS) */
+        m_CoreParseExecuteCommand();
+    }
+} /*m_CoreExecuteEnterKey()*/
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreHandleKeyEnter(void) {
+    m_CoreRemoveTrailingSpaces();
+    if (m_iInputPos >= 0) {
+        m_CorePutString(uSHELL_NEWLINE);
+        if (m_iInputPos > 0) {
+            m_CoreExecuteEnterKey();
+            m_CoreResetInput(true);
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+            m_AutocomplReset(uSHELL_AUTOCOMPL_RELOAD);
+        } else {
+            m_AutocomplReInit();
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+        }
+    }
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    if (true == m_bMachineMode) {
+        return; /* the line was #M, no prompt from now on */
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_MODE) */
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+    if (true == m_bEchoOn) {
+        m_CorePrintPrompt();
+    }
+#else
+    m_CorePrintPrompt();
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+} /* m_CoreHandleKeyEnter() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreHandleKeyDefault(const char cKeyPressed) {
+    if (true == uSHELL_ISPRINT(cKeyPressed)) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+        if ((true == m_bEditMode) && (m_iCursorPos < m_iInputPos)) {
+            m_EditInsertUnderCursor(cKeyPressed);
+        } else {
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+            if (m_iInputPos < (int)(sizeof(m_pstrInput) - 1)) {
+                *(m_pstrInput + m_iInputPos++) = cKeyPressed;
+                *(m_pstrInput + m_iInputPos) = '\0';
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+                if (true == m_bEditMode) {
+                    m_iCursorPos = m_iInputPos;
+                }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+                if (true == m_bEchoOn) {
+                    m_TransportPutch(cKeyPressed);
+                }
+#else
+            m_TransportPutch(cKeyPressed);
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+#if (1 == uSHELL_IMPLEMENTS_HOT_SHORTCUTS)
+                if ((1 == m_iInputPos) && (true == m_CoreIsHotShortcut(cKeyPressed))) {
+                    m_CoreHandleKeyEnter(); /* a hot shortcut runs on its key, the line is not waited for */
+                    return;
+                }
+#endif /* (1 == uSHELL_IMPLEMENTS_HOT_SHORTCUTS) */
+            } else {
+                /* print ] and block the movement of the cursor and insertion of data in the input buffer */
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+                uSHELL_SET_COLOR(uSHELL_ERROR_COLOR);
+                m_TransportPutch(']');
+                uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+                m_TransportPutch('\b');
+#else
+                m_CorePutString(FRMT(uSHELL_ERROR_COLOR, "]\033[0m\033[D"));
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+            }
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplGetCommon();
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+    }
+} /* m_CoreHandleKeyDefault() */
+
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_EscapeStart(void) {
+    m_sEscape = {};
+    m_sEscape.bActive = true;
+} /* m_EscapeStart() */
+
+/*----------------------------------------------------------------------------*/
+/* one byte after the introducer; false if it is not part of a sequence (ESC and a
+   plain key, i.e. Alt+key): the ESC is dropped and the byte handled as a key */
+bool Microshell::m_EscapeFeed(const char cByte) {
+    if (uSHELL_CORE_IS_ESCAPE_INTRO(cByte)) {
+        /* a new sequence cancels the one on its way (a key pressed before the last one ended) */
+        m_EscapeStart();
+        return true;
+    }
+    if ((uint8_t)cByte < 0x20) {
+        /* a control key (Enter, Backspace, Ctrl-x) is never inside a sequence */
+        m_sEscape = {};
+        return false;
+    }
+    if (true == m_sEscape.bSkip) {
+        /* an unknown CSI ends with its final byte, i.e. ESC [ 1 5 ~ */
+        if ((cByte >= 0x40) && (cByte <= 0x7E)) {
+            m_sEscape = {};
+        }
+        return true;
+    }
+
+    int iNode = s_sEscapeTrie.vsNodes[m_sEscape.u8Node].u8Child;
+    while ((0 != iNode) && (cByte != s_sEscapeTrie.vsNodes[iNode].cByte)) {
+        iNode = s_sEscapeTrie.vsNodes[iNode].u8Next;
+    }
+
+    if (0 != iNode) {
+        const uint8_t u8Key = s_sEscapeTrie.vsNodes[iNode].u8Key;
+        if (uSHELL_ESCKEY_NONE != u8Key) {
+            m_sEscape = {};
+            m_EscapeHandleKey(u8Key);
+        } else {
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+            if ((0 == m_sEscape.u8Node) && (uSHELL_KEY_LEFT_BRACKET == cByte)) {
+                m_sEscape.bCsi = true;
+            }
+#endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
+            m_sEscape.u8Node = (uint8_t)iNode;
+        }
+        return true;
+    }
+
+    if (0 == m_sEscape.u8Node) {
+        m_sEscape = {};
+        return false;
+    }
+    /* not in the table: the rest of a CSI is skipped, any other sequence ends here */
+    if ((true == m_sEscape.bCsi) && !((cByte >= 0x40) && (cByte <= 0x7E))) {
+        m_sEscape.bSkip = true;
+    } else {
+        m_sEscape = {};
+    }
+    return true;
+} /* m_EscapeFeed() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_EscapeHandleKey(const uint8_t u8Key) {
+#if (0 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    m_CorePutString("\033[?25l"); /* hide cursor */
+#endif /* (0 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    if (true == m_sAutocomplete.bEnabled) {
+        m_sAutocomplete.cCrtKey = uSHELL_KEY_ESCAPESEQ;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+    switch (u8Key) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)
+    case uSHELL_ESCKEY_UP: {
+        m_CoreHandleKeyArrowUpDown(uSHELL_DIR_FORWARD);
+    } break;
+    case uSHELL_ESCKEY_DOWN: {
+        m_CoreHandleKeyArrowUpDown(uSHELL_DIR_BACKWARD);
+    } break;
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    case uSHELL_ESCKEY_LEFT: {
+        m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_BACKWARD);
+    } break;
+    case uSHELL_ESCKEY_RIGHT: {
+        m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_FORWARD);
+    } break;
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+    case uSHELL_ESCKEY_DELETE: {
+        m_CoreHandleKeyDelete();
+    } break;
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    case uSHELL_ESCKEY_HOME: {
+        m_EditMoveCursor(uSHELL_DIR_HOME);
+    } break;
+    case uSHELL_ESCKEY_END: {
+        m_EditMoveCursor(uSHELL_DIR_END);
+    } break;
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+    case uSHELL_ESCKEY_INSERT: {
+        m_CoreHandleKeyInsert();
+    } break;
+#endif /*!defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+    default:
+        break; /* disabled (page up / down, the keys of the features not built) */
+    }
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    if (true == m_sAutocomplete.bEnabled) {
+        m_sAutocomplete.cPrevKey = uSHELL_KEY_ESCAPESEQ;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+#if (0 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    m_CorePutString("\033[?25h"); /* show cursor */
+#endif /* (0 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+} /* m_EscapeHandleKey() */
+#else
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreHandleKeyEscapeSeq(void) {
+    if (uSHELL_CORE_KEYHANDLE_SKIP_BRACKET) { /* skip the [ */
+        switch (m_TransportGetch()) {         /* get the ecape sequence */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)
+        case uSHELL_KEY_ESCAPESEQ_ARROW_UP: {
+            m_CoreHandleKeyArrowUpDown(uSHELL_DIR_FORWARD);
+        } break;
+        case uSHELL_KEY_ESCAPESEQ_ARROW_DOWN: {
+            m_CoreHandleKeyArrowUpDown(uSHELL_DIR_BACKWARD);
+        } break;
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        case uSHELL_KEY_ESCAPESEQ_ARROW_LEFT: {
+            m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_BACKWARD);
+        } break;
+        case uSHELL_KEY_ESCAPESEQ_ARROW_RIGHT: {
+            m_CoreHandleKeyArrowLeftRight(uSHELL_DIR_FORWARD);
+        } break;
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || defined(uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+        case uSHELL_KEY_ESCAPESEQ1_DELETE: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+                m_CoreHandleKeyDelete();
+            }
+        } break;
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+        case uSHELL_KEY_ESCAPESEQ_HOME: {
+            m_EditMoveCursor(uSHELL_DIR_HOME);
+        } break;
+        case uSHELL_KEY_ESCAPESEQ_END: {
+            m_EditMoveCursor(uSHELL_DIR_END);
+        } break;
+#endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
+        case uSHELL_KEY_ESCAPESEQ1_HOME: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+                m_EditMoveCursor(uSHELL_DIR_HOME);
+            }
+        } break;
+        case uSHELL_KEY_ESCAPESEQ1_END: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+                m_EditMoveCursor(uSHELL_DIR_END);
+            }
+        } break;
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+        case uSHELL_KEY_ESCAPESEQ1_INSERT: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+                m_CoreHandleKeyInsert();
+            }
+        } break;
+#else
+        case uSHELL_KEY_ESCAPESEQ1_INSERT: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) { /*ignore*/
+            }
+        } break;
+#endif /*!defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)*/
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+        case uSHELL_KEY_TILDE: {
+            m_CoreHandleKeyDelete();
+        } break; /*1B5B7E for INS DEL, etc is DEL */
+#endif           /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
+#else            /* not (1 == uSHELL_IMPLEMENTS_EDITMODE), disable keys */
+        case uSHELL_KEY_ESCAPESEQ_HOME:
+            break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ_END:
+            break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_HOME: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+            }
+        } break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_END: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+            }
+        } break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_INSERT: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+            }
+        } break; /* disabled */
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+        case uSHELL_KEY_TILDE:
+            break; /* disabled */
+#endif /*!(defined(__MINGW32__) || defined(_MSC_VER))*/
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+        case uSHELL_KEY_ESCAPESEQ1_PAGEUP: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+            }
+        } break; /* disabled */
+        case uSHELL_KEY_ESCAPESEQ1_PAGEDOWN: {
+            if (uSHELL_CORE_KEYHANDLE_SKIP_TILDE) {
+            }
+        } break; /* disabled */
+        default:
+            break;
+        } /* switch(m_TransportGetch()) */
+    }     /* uSHELL_CORE_KEYHANDLE_SKIP_BRACKET */
+} /* m_CoreHandleKeyEscapeSeq() */
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY)
+void Microshell::m_CoreHandleKeyArrowUpDown(const dir_e eDir) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if (true == m_bEditMode) {
+        switch (eDir) {
+        case uSHELL_DIR_FORWARD: {
+            m_EditMoveCursor(uSHELL_DIR_HOME);
+        } break; /* arrow up-  > home */
+        case uSHELL_DIR_BACKWARD: {
+            m_EditMoveCursor(uSHELL_DIR_END);
+        } break; /* arrow down-> end  */
+        default:
+            break;
+        }
+    } else
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+    {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+        m_HistoryRead(eDir);
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplGetCommon();
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+    }
+} /* m_CoreHandleKeyArrowUpDown() */
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY) */
+
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+void Microshell::m_CoreHandleKeyArrowLeftRight(const dir_e eDir) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if (false == m_EditMoveCursor(eDir)) {
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplRead(eDir);
+        if (true == m_bEditMode) {
+            m_iCursorPos = m_iInputPos;
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+    }
+#else /* not (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    m_AutocomplRead(eDir);
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+} /* m_CoreHandleKeyArrowLeftRight() */
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+#if !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreHandleKeyInsert(void) {
+    m_bEditMode = !m_bEditMode;
+    if (m_iInputPos > 0) {
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        /* only the mode marks of the prompt change, then back to the end of the input */
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+        const char *pstrMarks = (m_bEditMode ? m_pstrPromptInfoEditMode : m_pInst->vstrPrompt);
+        const int iMarksLen = (int)(sizeof(m_pstrPromptInfo) - 1);
+#else  /* (0 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+        const char *pstrMarks = (m_bEditMode ? "E" : m_pInst->vstrPrompt);
+        const int iMarksLen = 1;
+#endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+        m_TransportPutch('\r');
+        uSHELL_SET_COLOR(uSHELL_PROMPT_COLOR);
+        m_TransportWrite(pstrMarks, (size_t)iMarksLen);
+        uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+        if (true == m_bDumbTerminal) {
+            m_TransportWrite(m_pInst->vstrPrompt + iMarksLen, (size_t)(m_pInst->iPromptLength - iMarksLen));
+            m_TransportWrite(m_pstrInput, (size_t)m_iInputPos);
+        } else {
+            uSHELL_PRINTF("\033[%dC", (m_pInst->iPromptLength - iMarksLen) + m_iInputPos);
+        }
+#elif (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%s\033[%dC"), (m_bEditMode ? m_pstrPromptInfoEditMode : m_pInst->vstrPrompt), m_iInputPos + (m_bEditMode ? (m_pInst->iPromptLength - ((int)(sizeof(m_pstrPromptInfo))) + 1) : 0));
+#else  /* (0 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+        uSHELL_PRINTF(FRMT(uSHELL_PROMPT_COLOR, "\r%c\033[%dC"), (m_bEditMode ? 'E' : m_pInst->vstrPrompt[0]), (m_iInputPos + (m_pInst->iPromptLength - 1)));
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+        if (true == m_bEditMode) {
+            m_iCursorPos = m_iInputPos;
+        }
+    }
+} /* m_CoreHandleKeyInsert() */
+#endif /* !defined(uSHELL_EDIT_MODE_DEFAULT_ACTIVE) */
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreHandleKeyDelete(void) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if (true == m_bEditMode) {
+        m_EditDeleteUnderCursor();
+    } else {
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+        m_CoreCmdLineDelete();
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+} /* m_CoreHandleKeyDelete() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreHandleKeyBackspace(void) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if (true == m_bEditMode) {
+        m_EditDeleteBackward();
+    } else {
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+        if (m_iInputPos > 0) {
+            m_pstrInput[--m_iInputPos] = '\0';
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+            m_RenderTail(m_iInputPos, m_iInputPos + 1, m_iInputPos + 1, m_iInputPos);
+#else
+            m_CorePutString("\033[D \033[D");
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+        }
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplReInit();
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+} /* m_CoreHandleKeyBackspace() */
+
+/*----------------------------------------------------------------------------*/
+inline bool Microshell::m_CoreIsShortcutSymbol(const char cKey) {
+#if (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+    return ushell_is_shortcut_symbol(cKey);
+#else
+    return (((cKey > 0x20) && (cKey < 0x30)) || ((cKey > 0x39) && (cKey < 0x41)) || ((cKey > 0x5A) && (cKey < 0x61)) || ((cKey > 0x7A) && (cKey < 0x7F)));
+#endif /*(1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)*/
+} /* m_CoreIsShortcutSymbol() */
+
+/*----------------------------------------------------------------------------*/
+/* index of the shortcut into psShortcutsArray (0: the core '#'), uSHELL_SHORTCUT_FREE if none */
+inline int Microshell::m_CoreFindShortcut(const char cKey) {
+#if (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+    const unsigned uIndex = (unsigned)(uint8_t)cKey - uSHELL_SHORTCUT_TABLE_FIRST;
+    return (uIndex < uSHELL_SHORTCUT_TABLE_SIZE) ? m_pInst->psShortcutTable->vi8Slots[uIndex] : uSHELL_SHORTCUT_FREE;
+#else
+    for (int i = 0; i < m_pInst->iNrShortcuts; ++i) {
+        if (cKey == m_pInst->psShortcutsArray[i].cSymbol) {
+            return i;
+        }
+    }
+    return uSHELL_SHORTCUT_FREE;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)*/
+} /* m_CoreFindShortcut() */
+
+#if (1 == uSHELL_IMPLEMENTS_HOT_SHORTCUTS)
+/*----------------------------------------------------------------------------*/
+inline bool Microshell::m_CoreIsHotShortcut(const char cKey) {
+    const unsigned uIndex = (unsigned)(uint8_t)cKey - uSHELL_SHORTCUT_TABLE_FIRST;
+    return (uIndex < uSHELL_SHORTCUT_TABLE_SIZE) && (0U != (m_pInst->psShortcutTable->vu32Hot[uIndex / 32U] & (1UL << (uIndex % 32U))));
+} /* m_CoreIsHotShortcut() */
+#endif /*(1 == uSHELL_IMPLEMENTS_HOT_SHORTCUTS)*/
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_CoreHandleShortcuts(void) {
+    bool bRetVal = false;
+    char cKey = *m_pstrInput;
+    const int i = m_CoreFindShortcut(cKey);
+    if (uSHELL_SHORTCUT_FREE != i) {
+        if ((0 == i) || (nullptr != m_pInst->psShortcutsArray[i].pfShortcut)) {
+            char *pstrArgs = m_pstrInput;
+            while(uSHELL_KEY_SPACE == *(++pstrArgs));
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+            if (i > 0) {
+                m_HistoryWrite();
+            }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY) */
+            if (0 == i) {
+                m_CoreHandleShortcut_Hash(pstrArgs);
+            } else {
+                m_pInst->psShortcutsArray[i].pfShortcut(pstrArgs);
+            }
+        } else {
+            m_CorePrintMessage(4, 2); /* callback not implemented */
+        }
+        bRetVal = true;
+    } else if (true == m_CoreIsShortcutSymbol(cKey)) {
+        m_CorePrintMessage(5, 11); /* shortcut not registered*/
+        bRetVal = true;
+    }
+    return bRetVal;
+} /* m_CoreHandleShortcuts() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreHandleShortcut_Hash(const char *pstrArgs) {
+    int iError = 1;
+    const char cKey = *pstrArgs;
+
+    if ('\0' != cKey) {
+#if ((0 == uSHELL_IMPLEMENTS_COMMAND_HELP) || (1 == uSHELL_IMPLEMENTS_SHELL_EXIT) || (1 == uSHELL_IMPLEMENTS_KEY_DECODER) || (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) || (1 == uSHELL_IMPLEMENTS_HISTORY) || (1 == uSHELL_IMPLEMENTS_BINARY_MODE) || (1 == uSHELL_IMPLEMENTS_COMMAND_STATS) || (1 == uSHELL_IMPLEMENTS_MACHINE_MODE))
+        bool bNoParams = ('\0' == *(pstrArgs + 1));
+#endif
+        switch (cKey) {
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP) /* full info */
+        case '#': {
+            if (bNoParams) {
+                m_CoreShowCmdsList();            /* ## prints the command list only */
+            } else if ('#' == *(pstrArgs + 1)) { /* ### prints the full list */
+                if ('\0' == *(pstrArgs + 2)) {
+                    m_CoreShowCmdsList();
+                    m_CoreShowTypes();
+                    m_CoreShowShortcuts();
+                } else {
+                    m_CorePrintMessage(6, 2); /* ### ... sub-shortcut not implemented */
+                }
+            } else {
+                m_CoreShowInfo(pstrArgs + 1); /* evaluates other options of the ## sub-shortcut */
+            }
+            iError = 0;
+        } break; /* function's info*/
+#else            /* minimal info */
+        case '#': {
+            if (bNoParams) {
+                m_CoreShowCmdsList();
+                iError = 0;
+            }
+        } break; /* list commands */
+#endif           /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+        case 'q': {
+            if (bNoParams) {
+                m_CoreExit();
+                iError = 0;
+            }
+        } break; /* exit shell */
+#endif           /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT) */
+#if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
+        case 'k': {
+            if (bNoParams) {
+                keydecoder();
+                iError = 0;
+            }
+        } break; /* key decoder */
+#endif           /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+        case 'E': {
+            if (bNoParams) {
+                m_bEchoOn = true;
+                m_CorePrintMessage(2, 1); /* echo on*/
+                iError = 0;
+            }
+        } break; /* echo on*/
+        case 'e': {
+            if (bNoParams) {
+                m_bEchoOn = false;
+                m_CorePrintMessage(2, 0); /* echo off */
+                iError = 0;
+            }
+        } break; /* echo off */
+#endif           /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+        case 'M': {
+            if (bNoParams) {
+                if (false == m_bMachineMode) {
+                    m_MachineEnable(true);
+                    m_MachineTerminate(uSHELL_ERR_OK); /* the first line of the machine interface */
+                }
+                iError = 0;
+            }
+        } break; /* machine mode on */
+        case 'm': {
+            if (bNoParams) {
+                m_MachineEnable(false);
+                iError = 0;
+            }
+        } break; /* machine mode off */
+#endif           /* (1 == uSHELL_IMPLEMENTS_MACHINE_MODE) */
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        case 'T': {
+            if (bNoParams) {
+                m_bDumbTerminal = false;
+                m_CorePrintMessage(12, 1); /* ansi on */
+                iError = 0;
+            }
+        } break; /* ansi terminal */
+        case 't': {
+            if (bNoParams) {
+                m_bDumbTerminal = true;
+                m_CorePrintMessage(12, 0); /* ansi off */
+                iError = 0;
+            }
+        } break; /* dumb terminal */
+#endif           /*(1 == uSHELL_IMPLEMENTS_DELTA_RENDER)*/
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+        case 'b': {
+            if (bNoParams) {
+                m_bBinaryMode = true;
+                m_CorePrintMessage(10, 1); /* binary on */
+                iError = 0;
+            }
+        } break; /* binary frames mode */
+#endif           /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE)*/
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+        case 'p': {
+            if (bNoParams) {
+                m_CoreShowStats(false);
+                iError = 0;
+            }
+        } break; /* commands stats */
+        case 'P': {
+            if (bNoParams) {
+                m_CoreShowStats(true);
+                iError = 0;
+            }
+        } break; /* commands stats, then reset */
+#endif           /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+        case 'r': {
+            m_ScriptHandleShortcut(pstrArgs + 1);
+            iError = 0;
+        } break; /* list or run precompiled scripts */
+#endif           /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        case 'A': {
+            if (bNoParams) {
+                m_AutocomplEnable(true);
+                iError = 0;
+            }
+        } break; /* autocomplete on */
+        case 'a': {
+            if (bNoParams) {
+                m_AutocomplEnable(false);
+                iError = 0;
+            }
+        } break; /* autocomplete off */
+#endif           /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+#if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
+        case 's': {
+            m_CoreSetStringBorder(pstrArgs + 1);
+            iError = 0;
+        } break; /* set string bordering character */
+#endif           /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+#endif           /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS)*/
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+        case 'H': {
+            if (bNoParams) {
+                m_HistoryEnable(true);
+                iError = 0;
+            }
+        } break; /* pHistory on */
+        case 'h': {
+            if (bNoParams) {
+                m_HistoryEnable(false);
+                iError = 0;
+            }
+        } break; /* pHistory off */
+        case 'l': {
+            if (bNoParams) {
+                m_HistoryList();
+                iError = 0;
+            }
+        } break; /* view pHistory */
+#if ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))
+        case 'L': {
+            if (bNoParams) {
+                m_HistoryReload();
+                iError = 0;
+            }
+        } break; /* reload pHistory */
+#endif           /*((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))*/
+        case 'c': {
+            if (bNoParams) {
+                m_HistoryReset();
+                iError = 0;
+            }
+        } break; /* clear pHistory */
+        default: {
+            m_HistoryExecuteEntry(pstrArgs);
+            iError = 0;
+        } break; /* try execute pHistory at index */
+#else
+        default: {
+            iError = 2;
+        } break;
+#endif    /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+        } /*switch(...)*/
+    } else {
+        iError = 3; /*if(..)*/
+    }
+    switch (iError) {
+    case 1: {
+        m_CorePrintMessage(7, 8); /* args unsupported */
+    } break;
+    case 2: {
+        m_CorePrintMessage(6, 8); /* sub-shortcut unsupported */
+    } break;
+    case 3: {
+        m_CorePrintMessage(6, 9); /* sub-shortcut missing */
+    } break;
+    default:
+        break;
+    }
+} /* m_CoreHandleShortcut_Hash() */
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_CoreSearchFunction(const char *pstrFctName) {
+    if (nullptr == pstrFctName) {
+        return uSHELL_ERR_FUNCTION_NOT_FOUND;
+    }
+    return m_CoreSearchFunction(pstrFctName, strlen(pstrFctName));
+} /* m_CoreSearchFunction() */
+
+/*----------------------------------------------------------------------------*/
+/* the name is not required to be NUL terminated (i.e. a view into the caller's buffer) */
+int Microshell::m_CoreSearchFunction(const char *pstrFctName, const size_t szLen) {
+#if (1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)
+    const int iMask = m_pInst->iFuncHashTableSize - 1;
+    int iSlot = (int)(ushell_hash_n(pstrFctName, szLen) & (uint32_t)iMask);
+    /* the table is never full, so the probing always ends on an empty slot */
+    while (uSHELL_HASH_SLOT_EMPTY != m_pInst->piFuncHashTable[iSlot]) {
+        const int i = m_pInst->piFuncHashTable[iSlot];
+        const char *pstrName = m_pInst->psFuncDefArray[i].pstrFctName;
+        if ((0 == strncmp(pstrFctName, pstrName, szLen)) && ('\0' == pstrName[szLen])) {
+            return i;
+        }
+        iSlot = (iSlot + 1) & iMask;
+    }
+#else
+    for (int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        const char *pstrName = m_pInst->psFuncDefArray[i].pstrFctName;
+        if ((0 == strncmp(pstrFctName, pstrName, szLen)) && ('\0' == pstrName[szLen])) {
+            return i;
+        }
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP) */
+    return uSHELL_ERR_FUNCTION_NOT_FOUND;
+} /* m_CoreSearchFunction() */
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_CoreSetPrompt(const char *pstrPromptExt) {
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+#if (defined(uSHELL_IMPLEMENTS_STRINGS) && (1 == uSHELL_SUPPORTS_SPACED_STRINGS))
+    uSHELL_SNPRINTF(m_pInst->vstrPrompt, sizeof(m_pInst->vstrPrompt), "%s%c:%s> ", m_pstrPrompt, m_cStringBorderSymbol, pstrPromptExt);
+#else
+    uSHELL_SNPRINTF(m_pInst->vstrPrompt, sizeof(m_pInst->vstrPrompt), "%s:%s> ", m_pstrPrompt, pstrPromptExt);
+#endif
+#else
+    uSHELL_SNPRINTF(m_pInst->vstrPrompt, sizeof(m_pInst->vstrPrompt), "e:%s> ", pstrPromptExt);
+#endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+    m_pInst->iPromptLength = (int)strlen(m_pInst->vstrPrompt);
+}
+
+/*==============================================================================
+        CORE: EXIT FEATURE IMPLEMENTATION
+==============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+bool Microshell::m_CoreConfirmRequest(void) {
+    bool bConfirmed = false;
+    m_CorePutString("Are you sure? (y/n): ");
+    do {
+        char cRead = m_TransportGetch();
+        if ('y' == cRead) {
+            m_TransportPutch(cRead);
+            bConfirmed = true;
+            break;
+        } else if ('n' == cRead) {
+            m_TransportPutch(cRead);
+            break;
+        }
+    } while (1);
+    m_CorePutString(uSHELL_NEWLINE);
+    return bConfirmed;
+} /* m_CoreConfirmRequest() */
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
+
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+inline void Microshell::m_CoreExit(void) {
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+    if (true == m_CoreConfirmRequest()) {
+#endif /* (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
+        m_pInst->bKeepRuning = false;
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)*/
+} /* m_CoreExit() */
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+
+/*==============================================================================
+        CORE: COMMANDS LIST / DETAILS
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_CorePutChars(const char *pstrArray, int iNrChars, const bool bNewLine) {
+    if (iNrChars > 0) {
+        m_TransportWrite(pstrArray, (size_t)iNrChars);
+    }
+    if (true == bNewLine) {
+        m_CorePutString(uSHELL_NEWLINE);
+    }
+} /* m_CorePutChars() */
+
+/*----------------------------------------------------------------------------*/
+/* a help text, iNrChars of it as stored: the codes of the packed ones expanded into the output in chunks */
+void Microshell::m_CorePutInfo(const char *pstrInfo, int iNrChars, const bool bNewLine) {
+#if (1 == uSHELL_IMPLEMENTS_PACKED_HELP)
+    char vstrChunk[32];
+    size_t szChunk = 0;
+    for (int i = 0; i < iNrChars; ++i) {
+        uint8_t vu8Stack[uSHELL_INFO_PAIR_DEPTH + 1];
+        int iTop = 0;
+        vu8Stack[0] = (uint8_t)pstrInfo[i];
+        while (iTop >= 0) {
+            const uint8_t u8Code = vu8Stack[iTop--];
+            if (u8Code < uSHELL_INFO_CODE_FIRST) {
+                vstrChunk[szChunk++] = (char)u8Code;
+                if (sizeof(vstrChunk) == szChunk) {
+                    m_TransportWrite(vstrChunk, szChunk);
+                    szChunk = 0;
+                }
+            } else {
+                vu8Stack[++iTop] = g_vu8InfoPairs[u8Code - uSHELL_INFO_CODE_FIRST][1];
+                vu8Stack[++iTop] = g_vu8InfoPairs[u8Code - uSHELL_INFO_CODE_FIRST][0];
+            }
+        }
+    }
+    m_TransportWrite(vstrChunk, szChunk);
+    if (true == bNewLine) {
+        m_CorePutString(uSHELL_NEWLINE);
+    }
+#else
+    m_CorePutChars(pstrInfo, iNrChars, bNewLine);
+#endif /* (1 == uSHELL_IMPLEMENTS_PACKED_HELP) */
+} /* m_CorePutInfo() */
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_CoreShowTypes(void) {
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%s\n\r\t"), "DATATYPES");
+
+    uSHELL_SET_COLOR(uSHELL_INFO_BODY_COLOR);
+    for (int i = 0; i < uSHELL_DATA_TYPE_LAST; ++i) {
+        uSHELL_PRINTF(" %c-%s |", m_vstrTypeMarks[i], m_vstrTypeNames[i]);
+    }
+    uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+    m_CorePutString(uSHELL_NEWLINE);
+} /* m_CoreShowTypes() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreShowShortcuts(void) {
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%s\n\r"), "SHORTCUTS CORE");
+    uSHELL_SET_COLOR(uSHELL_INFO_BODY_COLOR);
+    m_CorePutInfo(m_pstrCoreShortcutCaption, (int)strlen(m_pstrCoreShortcutCaption), false);
+    uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+
+#if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
+    uSHELL_PRINTF(FRMT(uSHELL_INFO_HEADER_COLOR, "%s\n\r"), "SHORTCUTS USER");
+    uSHELL_SET_COLOR(uSHELL_INFO_BODY_COLOR);
+    for (int i = 0; i < (m_pInst->iNrShortcuts - 1); ++i) {
+        m_CorePutInfo(m_pInst->ppstrShortcutsInfoArray[i], (int)strlen(m_pInst->ppstrShortcutsInfoArray[i]), false);
+    }
+    uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+#endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+} /* m_CoreShowShortcuts() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreShowCmd(int iFctIndex) {
+    uSHELL_PRINTF_CT(FRMT(uSHELL_INFO_LIST_COLOR, "%3d %15s : %-15s"), iFctIndex, m_pInst->psFuncDefArray[iFctIndex].pstrFctName, m_pInst->psFuncDefArray[iFctIndex].pstrFuncParamDef);
+} /* m_CoreShowCmd() */
+
+/*----------------------------------------------------------------------------*/
+/* disable warnings */
+#if defined(__GNUC__) && defined(__AVR__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif /*defined (__GNUC__) && defined(__AVR__)*/
+
+void Microshell::m_CoreShowCmdInfo(const int iFctIndex, const bool bParamInfo) {
+    if (false == bParamInfo) {
+        m_CoreShowCmd(iFctIndex);
+    } else {
+        uSHELL_PRINTF_CT(FRMT(uSHELL_INFO_LIST_COLOR, "%s "), m_pInst->psFuncDefArray[iFctIndex].pstrFctName);
+    }
+    const char *pstrInfo = m_pInst->ppstrInfoArray[iFctIndex];
+    const char *pstrParams = strchr(pstrInfo, '|');
+    if (nullptr != pstrParams) {
+        m_CorePutInfo(pstrInfo, (int)(pstrParams - pstrInfo), true);
+    } else {
+        m_CorePutInfo(pstrInfo, (int)strlen(pstrInfo), false);
+        m_CorePutString("\n");
+    }
+    if (true == bParamInfo) {
+        uSHELL_PRINTF_CT("Params: [ %s ]\n", m_pInst->psFuncDefArray[iFctIndex].pstrFuncParamDef);
+        if (nullptr == pstrParams) {
+            m_CorePutString("\tnone");
+        } else {
+            m_CorePutInfo(pstrParams + 1, (int)strlen(pstrParams + 1), false);
+        }
+        m_CorePutString("\n");
+    }
+} /* m_CoreShowCmdInfo() */
+
+/* end of disable warnings */
+#if defined(__GNUC__) && defined(__AVR__)
+#pragma GCC diagnostic pop
+#endif /*defined (__GNUC__) && defined(__AVR__)*/
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreShowInfo(const char *pstrArgs) {
+    bool bFound = false;
+    BIGNUM_T numVal = 0;
+
+    while (' ' == *pstrArgs) {
+        ++pstrArgs;
+    };
+    if (true == m_CoreIsShortcutSymbol(*pstrArgs)) {
+        m_CorePrintMessage(6, 2); /* sub-shortcut unimplemented */
+        bFound = true;
+    } else if ((true == asc2int(pstrArgs, &numVal)) && ((int)numVal < m_pInst->iNrFunctions)) {
+        m_CoreShowCmdInfo((int)numVal, true);
+        bFound = true;
+    } else {
+        int iIndex = m_CoreSearchFunction(pstrArgs);
+        if (uSHELL_ERR_FUNCTION_NOT_FOUND != iIndex) {
+            m_CoreShowCmdInfo(iIndex, true);
+            bFound = true;
+        } else {
+            for (iIndex = 0; iIndex < m_pInst->iNrFunctions; ++iIndex) {
+                if (nullptr != strstr(m_pInst->psFuncDefArray[iIndex].pstrFctName, pstrArgs)) {
+                    m_CoreShowCmdInfo(iIndex, false);
+                    bFound = true;
+                }
+            }
+        }
+    }
+    if (false == bFound) {
+        m_CorePrintMessage(8, 11); /* command not registered */
+    }
+} /* m_CoreShowInfo() */
+#endif /* (1 == uSHELL_IMPLEMENTS_COMMAND_HELP) */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreShowCmdsList(void) {
+    uSHELL_PRINTF_CT(FRMT(uSHELL_INFO_HEADER_COLOR, "%s\n"), "COMMANDS");
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+    for (int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        m_CoreShowCmd(i);
+        const char *pstrParams = strchr(m_pInst->ppstrInfoArray[i], '|');
+        if (nullptr != pstrParams) {
+            m_CorePutInfo(m_pInst->ppstrInfoArray[i], (int)(pstrParams - m_pInst->ppstrInfoArray[i]), true);
+        } else {
+            m_CorePutInfo(m_pInst->ppstrInfoArray[i], (int)strlen(m_pInst->ppstrInfoArray[i]), false);
+            m_CorePutString("\n");
+        }
+    }
+#else  // no function description
+    uSHELL_SET_COLOR(uSHELL_INFO_LIST_COLOR);
+    for (int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        uSHELL_PRINTF_CT("%3d %15s : %-15s\n", i, m_pInst->psFuncDefArray[i].pstrFctName, m_pInst->psFuncDefArray[i].pstrFuncParamDef);
+    }
+    uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
+
+} /* m_CoreShowCmdsList() */
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+/*----------------------------------------------------------------------------*/
+/* the executed commands with their average/max cycles, the bar is the share of
+   each command in the total handler time */
+void Microshell::m_CoreShowStats(const bool bReset) {
+    const cmdStats_s *psStatsArray = m_pInst->psCmdStatsArray;
+    uint64_t u64Total = 0U;
+
+    for (int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        u64Total += psStatsArray[i].u64ExecCycles;
+    }
+    uSHELL_PRINTF_CT(FRMT(uSHELL_INFO_HEADER_COLOR, "%s\n"), "COMMANDS STATS (cycles)");
+    uSHELL_PRINTF_CT(FRMT(uSHELL_INFO_BODY_COLOR, "%3s %-12s %6s %5s %8s %8s %8s %8s %s\n"), "idx", "name", "calls", "errs", "parse", "p.max", "exec", "e.max", "share");
+    uSHELL_SET_COLOR(uSHELL_INFO_LIST_COLOR);
+    for (int i = 0; i < m_pInst->iNrFunctions; ++i) {
+        const cmdStats_s *psStats = &psStatsArray[i];
+        if (0U == psStats->u32Calls) {
+            continue;
+        }
+        char vstrBar[uSHELL_STATS_BAR_WIDTH + 1] = {0};
+        const uint32_t u32Width = (0U == u64Total) ? 0U : (uint32_t)((psStats->u64ExecCycles * uSHELL_STATS_BAR_WIDTH) / u64Total);
+        memset(vstrBar, '#', u32Width);
+        uSHELL_PRINTF_CT("%3d %-12s %6u %5u %8u %8u %8u %8u %s\n", i, m_pInst->psFuncDefArray[i].pstrFctName,
+                         (unsigned)psStats->u32Calls, (unsigned)psStats->u32Errors,
+                         (unsigned)(psStats->u64ParseCycles / psStats->u32Calls), (unsigned)psStats->u32ParseMax,
+                         (unsigned)(psStats->u64ExecCycles / psStats->u32Calls), (unsigned)psStats->u32ExecMax, vstrBar);
+    }
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+    uSHELL_PRINTF_CT("scratch peak %u of %u bytes\n", (unsigned)m_pInst->psScratchArena->szPeak, (unsigned)m_pInst->psScratchArena->szSize);
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)*/
+    uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+    if (true == bReset) {
+        memset(m_pInst->psCmdStatsArray, 0, (size_t)m_pInst->iNrFunctions * sizeof(cmdStats_s));
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+        m_pInst->psScratchArena->szPeak = 0U;
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)*/
+    }
+} /* m_CoreShowStats() */
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CorePrintMessage(const int iFeatIdx, const int iStatIdx)
+{
+    /*       index:                         0      1               2                 3          4           5           6               7                8                9           10         11                12     */
+    static const char *pstrFeatArray[] = { " ",   "autocomplete", "echo",            "history", "callback", "shortcut", "sub-shortcut", "args",          "command",       "fopen",    "binary", "script",           "ansi" };
+    static const char *pstrStatArray[] = { "off", "on",           "not implemented", "noentry", "failed",   "empty",    "reset",        "uninitialized", "not supported", "missing",  "nofile", "not registered" };
+    uSHELL_PRINTF_CT(FRMT(uSHELL_WARNING_COLOR, ": %s %s\n"), pstrFeatArray[iFeatIdx], pstrStatArray[iStatIdx]);
+} /* m_CorePrintMessage() */
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_CorePrintPrompt(void) {
+    uSHELL_PRINTF_CT(FRMT(uSHELL_PROMPT_COLOR, "%s"), m_pInst->vstrPrompt);
+} /*m_CorePrintPrompt() */
+
+#if ((1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS))
+/*----------------------------------------------------------------------------*/
+void Microshell::m_CoreRedrawLine(void) {
+    m_CorePrintPrompt();
+    if (m_iInputPos > 0) {
+        uSHELL_PRINTF("%.*s", m_iInputPos, m_pstrInput);
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+        if ((true == m_bEditMode) && (m_iCursorPos < m_iInputPos)) {
+            m_EditMoveCursorDirSteps(uSHELL_DIR_BACKWARD, (m_iInputPos - m_iCursorPos));
+        }
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE)*/
+    }
+} /* m_CoreRedrawLine() */
+#endif /* ((1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) || (1 == uSHELL_IMPLEMENTS_POSTED_COMMANDS)) */
+
+/*==============================================================================
+              BINARY MODE IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_BinaryHandleFrame(void) {
+    int iRetVal = uSHELL_ERR_INVALID_FRAME;
+    uint8_t *pu8Frame = (uint8_t *)m_pstrInput;
+    const uint8_t u8Length = (uint8_t)m_TransportGetch();
+    uint8_t vu8Crc[2] = { 0, 0 };
+
+    if ((u8Length > 0) && (u8Length < uSHELL_MAX_INPUT_BUF_LEN) &&
+        (true == m_TransportRead(pu8Frame, u8Length)) && (true == m_TransportRead(vu8Crc, sizeof(vu8Crc)))) {
+        const uint16_t u16Crc = (uint16_t)(vu8Crc[0] | (vu8Crc[1] << 8));
+        if (u16Crc == crc16_ccitt(crc16_ccitt(uSHELL_BINARY_CRC_INIT, &u8Length, 1), pu8Frame, u8Length)) {
+            iRetVal = m_BinaryExecuteFrame(pu8Frame, u8Length);
+        }
+    }
+    m_BinarySendResponse(iRetVal);
+    m_CoreResetInput(true);
+    if (false == m_bBinaryMode) {
+        m_CorePrintPrompt();
+    }
+} /* m_BinaryHandleFrame() */
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_BinaryExecuteFrame(uint8_t *pu8Frame, const size_t szLength) {
+    const int iFctIndex = pu8Frame[0];
+
+    uSHELL_STATS_MARK();
+    if (uSHELL_BINARY_EXIT_INDEX == iFctIndex) {
+        if (1 != szLength) {
+            return uSHELL_ERR_WRONG_NUMBER_ARGS;
+        }
+        m_bBinaryMode = false;
+        return uSHELL_ERR_OK;
+    }
+    if (iFctIndex >= m_pInst->iNrFunctions) {
+        return uSHELL_ERR_FUNCTION_NOT_FOUND;
+    }
+
+    int iRetVal = uSHELL_ERR_OK;
+    size_t szPos = 1;
+    uint8_t *pu8Base = (uint8_t *)&m_sCommand;
+    const paramsDecoder_s *psDecoder = &m_pInst->psParamsDecoderArray[m_pInst->psFuncDefArray[iFctIndex].u8ParamsPattern];
+
+    memset(&m_sCommand, 0, sizeof(m_sCommand));
+    m_sCommand.iFctIndex = iFctIndex;
+    m_sCommand.pstrFctName = m_pInst->psFuncDefArray[iFctIndex].pstrFctName;
+
+    while ((uSHELL_ERR_OK == iRetVal) && (m_sCommand.iTypIndex < psDecoder->u8NrParams)) {
+        const int iSlot = (m_sCommand.iTypIndex)++;
+        if (iSlot >= (int)uSHELL_MAX_PARAMS_TOTAL) {
+            iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+            break;
+        }
+        const int iType = psDecoder->vu8Types[iSlot];
+        if ((iType >= uSHELL_TYPE_LAST) || (uSHELL_TYPE_VOID == iType)) {
+            iRetVal = uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM;
+            break;
+        }
+        const typeDecoder_s *psType = &m_vsTypeDecoders[iType];
+        unsigned int *piCount = (unsigned int *)(pu8Base + psType->u16CntOffset);
+        if (*piCount >= psType->u8MaxParams) {
+            iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+            break;
+        }
+        void *pvDest = pu8Base + psType->u16ValOffset + (*piCount * psType->u8ValSize);
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+        if (uSHELL_TYPE_STRING == iType) {
+            const uint8_t *pu8End = (const uint8_t *)memchr(&pu8Frame[szPos], '\0', szLength - szPos);
+            if (nullptr == pu8End) {
+                iRetVal = uSHELL_ERR_STRING_NOT_CLOSED;
+            } else {
+                *(str_t **)pvDest = (str_t *)&pu8Frame[szPos];
+                szPos = (size_t)(pu8End - pu8Frame) + 1;
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+        if (uSHELL_TYPE_VIEW == iType) {
+            const uint8_t *pu8End = (const uint8_t *)memchr(&pu8Frame[szPos], '\0', szLength - szPos);
+            if (nullptr == pu8End) {
+                iRetVal = uSHELL_ERR_STRING_NOT_CLOSED;
+            } else {
+                ((strview_s *)pvDest)->pstr = (const char *)&pu8Frame[szPos];
+                ((strview_s *)pvDest)->szLen = (size_t)(pu8End - &pu8Frame[szPos]);
+                szPos = (size_t)(pu8End - pu8Frame) + 1;
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_STRING_VIEWS)*/
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+        if (uSHELL_TYPE_HEXBUF == iType) {
+            /* a length byte and the raw bytes, left in the frame */
+            const size_t szBytes = (szPos < szLength) ? pu8Frame[szPos] : 0U;
+            if ((0U == szBytes) || ((szPos + 1U + szBytes) > szLength)) {
+                iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+            } else {
+                *(hexbuf_s *)pvDest = { &pu8Frame[szPos + 1U], szBytes };
+                szPos += 1U + szBytes;
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+        if (uSHELL_TYPE_ARRAY == iType) {
+            /* the rest of the frame, 32 bit little endian values */
+            const size_t szCount = (szLength - szPos) / sizeof(num32_t);
+            if ((iSlot + 1) != psDecoder->u8NrParams) {
+                iRetVal = uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM;
+            } else if ((0 == szCount) || (0 != ((szLength - szPos) % sizeof(num32_t)))) {
+                iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+            } else if (szCount > uSHELL_MAX_ARRAY_ITEMS) {
+                iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+            } else {
+                for (size_t i = 0; i < szCount; ++i, szPos += sizeof(num32_t)) {
+                    m_sCommand.vu32Items[i] = (num32_t)pu8Frame[szPos] | ((num32_t)pu8Frame[szPos + 1] << 8) |
+                                              ((num32_t)pu8Frame[szPos + 2] << 16) | ((num32_t)pu8Frame[szPos + 3] << 24);
+                }
+                *(numarray_s *)pvDest = { m_sCommand.vu32Items, szCount };
+            }
+        } else
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)*/
+        if ((szPos + psType->u8ValSize) > szLength) {
+            iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+        } else {
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+            if (uSHELL_TYPE_FLOAT == iType) {
+                memcpy(pvDest, &pu8Frame[szPos], sizeof(numfp_t));
+            } else
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+            if (psType->u8ValSize > sizeof(uint32_t)) {
+                BIGNUM_T numVal = 0;
+                for (int i = psType->u8ValSize - 1; i >= 0; --i) {
+                    numVal = (BIGNUM_T)((numVal << 8) | pu8Frame[szPos + i]);
+                }
+                *(num64_t *)pvDest = numVal;
+            } else
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+            {
+#if defined(BIGNUM_T)
+                uint32_t u32Val = 0;
+                for (int i = psType->u8ValSize - 1; i >= 0; --i) {
+                    u32Val = (u32Val << 8) | pu8Frame[szPos + i];
+                }
+                if (u32Val > (uint32_t)psType->maxValue) {
+                    iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+                } else {
+                    m_CoreStoreNumber(pvDest, psType->u8ValSize, u32Val);
+                }
+#endif /* defined(BIGNUM_T) */
+            }
+            szPos += psType->u8ValSize;
+        }
+        if (uSHELL_ERR_OK == iRetVal) {
+            ++(*piCount);
+        } else {
+            m_sCommand.eDataType = (dataType_e)iType;
+        }
+    }
+    if ((uSHELL_ERR_OK == iRetVal) && (szPos != szLength)) {
+        iRetVal = uSHELL_ERR_WRONG_NUMBER_ARGS;
+    }
+    if (uSHELL_ERR_OK == iRetVal) {
+        iRetVal = m_CoreExec();
+    }
+    return iRetVal;
+} /* m_BinaryExecuteFrame() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_BinarySendResponse(const int iRetVal) {
+    /* SOF | LEN | RET | CRC16, sent with one write */
+    uint8_t vu8Response[8] = { uSHELL_BINARY_SOF, 4, (uint8_t)iRetVal, (uint8_t)(iRetVal >> 8), (uint8_t)(iRetVal >> 16), (uint8_t)(iRetVal >> 24), 0, 0 };
+    const uint16_t u16Crc = crc16_ccitt(uSHELL_BINARY_CRC_INIT, &vu8Response[1], 5);
+
+    vu8Response[6] = (uint8_t)(u16Crc & 0xFF);
+    vu8Response[7] = (uint8_t)(u16Crc >> 8);
+    m_TransportWrite((const char *)vu8Response, sizeof(vu8Response));
+} /* m_BinarySendResponse() */
+
+#endif /* (1 == uSHELL_IMPLEMENTS_BINARY_MODE) */
+
+/*==============================================================================
+              ASYNC COMMANDS IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AsyncPrintPending(void) {
+    if (m_iAsyncBegun > 0) {
+        uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> pending [#%d]\n"), m_iAsyncBegun);
+    } else {
+        uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> pending\n"));
+    }
+} /* m_AsyncPrintPending() */
+
+/*----------------------------------------------------------------------------*/
+/* print the queued completions above the line in edition, then restore the line */
+void Microshell::m_AsyncReport(void) {
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+    if (true == m_bBinaryMode) {
+        return; /* kept until the text mode is back */
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE)*/
+    uint8_t u8Tail = m_u8AsyncTail.load(std::memory_order_relaxed);
+    if (u8Tail == m_u8AsyncHead.load(std::memory_order_acquire)) {
+        return;
+    }
+
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+    if (true == m_bMachineMode) {
+        /* the output of the job, then its terminator; no line in edition to restore */
+        do {
+            m_MachineReportDone(&m_vsAsyncQueue[u8Tail & (uSHELL_ASYNC_QUEUE_DEPTH - 1)]);
+            m_u8AsyncTail.store(++u8Tail, std::memory_order_release);
+        } while (u8Tail != m_u8AsyncHead.load(std::memory_order_acquire));
+        return;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_MACHINE_MODE)*/
+
+    m_CorePutString("\r\033[K");
+    do {
+        const asyncDone_s *psDone = &m_vsAsyncQueue[u8Tail & (uSHELL_ASYNC_QUEUE_DEPTH - 1)];
+        if (psDone->iRetVal >= 0) {
+            uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> [#%d] %d (0x%X)\n"), psDone->iTicket, psDone->iRetVal, psDone->iRetVal);
+        } else {
+            uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r: [#%d] failed %d\n"), psDone->iTicket, psDone->iRetVal);
+        }
+        if (nullptr != psDone->pstrOutput) {
+            uSHELL_PRINTF(FRMT(uSHELL_INFO_BODY_COLOR, "%s\n\r"), psDone->pstrOutput);
+        }
+        m_u8AsyncTail.store(++u8Tail, std::memory_order_release);
+    } while (u8Tail != m_u8AsyncHead.load(std::memory_order_acquire));
+
+    m_CoreRedrawLine();
+} /* m_AsyncReport() */
+
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+
+/*==============================================================================
+              MACHINE MODE IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+
+/*----------------------------------------------------------------------------*/
+/* #M / #m: the core output without escape sequences while on, the terminal mode comes back after */
+void Microshell::m_MachineEnable(const bool bEnable) {
+    if (bEnable == m_bMachineMode) {
+        return;
+    }
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    if (true == bEnable) {
+        m_bMachineDumbSaved = m_bDumbTerminal;
+        m_bDumbTerminal = true;
+    } else {
+        m_bDumbTerminal = m_bMachineDumbSaved;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_DELTA_RENDER)*/
+    m_bMachineOverflow = false;
+#if ((1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) && (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS))
+    for (machineTag_s &sTag : m_vsMachineTags) {
+        sTag.iTicket = 0; /* the jobs still pending report by their ticket from now on */
+    }
+#endif /* ((1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) && (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)) */
+    m_bMachineMode = bEnable;
+} /* m_MachineEnable() */
+
+/*----------------------------------------------------------------------------*/
+/* the keys go into the line without any output, CR or LF ends it (the LF of a CR LF is an empty line) */
+void Microshell::m_MachineProcessKey(const char cKeyPressed) {
+    if (('\r' == cKeyPressed) || ('\n' == cKeyPressed)) {
+        m_MachineExecuteLine();
+    } else if (true == uSHELL_ISPRINT(cKeyPressed)) {
+        if (m_iInputPos < (int)(sizeof(m_pstrInput) - 1)) {
+            m_pstrInput[m_iInputPos++] = cKeyPressed;
+            m_pstrInput[m_iInputPos] = '\0';
+        } else {
+            m_bMachineOverflow = true;
+        }
+    }
+} /* m_MachineProcessKey() */
+
+/*----------------------------------------------------------------------------*/
+/* one terminator per line which is not empty, the output of the command before it; the next
+   lines may already wait in the receive buffer, the host does not wait for the terminator */
+void Microshell::m_MachineExecuteLine(void) {
+    m_CoreRemoveTrailingSpaces();
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+    (void)m_MachineTakeTag();
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+    if (true == m_bMachineOverflow) {
+        m_bMachineOverflow = false;
+        m_MachineTerminate(uSHELL_ERR_LINE_TOO_LONG);
+    } else if (m_iInputPos > 0) {
+        if (true == m_CoreHandleShortcuts()) {
+            m_MachineTerminate(uSHELL_ERR_OK);
+            if (false == m_bMachineMode) {
+                m_CorePrintPrompt(); /* #m, back to the terminal */
+            }
+        } else {
+            int iRetVal;
+            uSHELL_STATS_MARK();
+            if (uSHELL_ERR_OK == (iRetVal = m_CoreParseCommand())) {
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+                m_iAsyncBegun = 0;
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+                iRetVal = m_CoreExec();
+            }
+            m_MachineTerminate(iRetVal);
+        }
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+    } else if (true == m_bMachineTagged) {
+        m_MachineTerminate(uSHELL_ERR_OK); /* a tag alone: the host syncs on it */
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+    }
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+    m_bMachineTagged = false;
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+    m_CoreResetInput(true);
+} /* m_MachineExecuteLine() */
+
+/*----------------------------------------------------------------------------*/
+/* OK <return value> | ERR <uSHELL_ERR_* or the error of the handler> | PENDING <ticket>, the
+   DONE <ticket> <return value> of that job comes later between the terminators of other lines;
+   a tagged line gets <seq> <return value> only, for a pending one once the job is done */
+void Microshell::m_MachineTerminate(const int iRetVal) {
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+    if (true == m_bMachineTagged) {
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+        if (uSHELL_ERR_PENDING == iRetVal) {
+            for (machineTag_s &sTag : m_vsMachineTags) {
+                if (0 == sTag.iTicket) {
+                    sTag = { m_iAsyncBegun, m_u32MachineSeq };
+                    return;
+                }
+            }
+            /* no free slot: the untagged PENDING / DONE pair, the host matches the ticket */
+            uSHELL_PRINTF("%u PENDING %d\n", (unsigned)m_u32MachineSeq, m_iAsyncBegun);
+            return;
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+        uSHELL_PRINTF("%u %d\n", (unsigned)m_u32MachineSeq, iRetVal);
+        return;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+    if (iRetVal >= 0) {
+        uSHELL_PRINTF("OK %d\n", iRetVal);
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+    } else if (uSHELL_ERR_PENDING == iRetVal) {
+        uSHELL_PRINTF("PENDING %d\n", m_iAsyncBegun);
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+    } else {
+        uSHELL_PRINTF("ERR %d\n", iRetVal);
+    }
+} /* m_MachineTerminate() */
+
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+/*----------------------------------------------------------------------------*/
+/* the output of the job, then <seq> <return value> if its line was tagged, DONE <ticket> <return value> else */
+void Microshell::m_MachineReportDone(const asyncDone_s *psDone) {
+    if (nullptr != psDone->pstrOutput) {
+        uSHELL_PRINTF("%s\n", psDone->pstrOutput);
+    }
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+    for (machineTag_s &sTag : m_vsMachineTags) {
+        if (psDone->iTicket == sTag.iTicket) {
+            sTag.iTicket = 0;
+            uSHELL_PRINTF("%u %d\n", (unsigned)sTag.u32Seq, psDone->iRetVal);
+            return;
+        }
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+    uSHELL_PRINTF("DONE %d %d\n", psDone->iTicket, psDone->iRetVal);
+} /* m_MachineReportDone() */
+#endif /* (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS) */
+
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS)
+/*----------------------------------------------------------------------------*/
+/* <seq> <command>: decimal digits and a space (or the line end) in front of the line, which
+   no command name or shortcut starts with; taken off the line, false if there is none */
+bool Microshell::m_MachineTakeTag(void) {
+    uint32_t u32Seq = 0;
+    int iPos = 0;
+    while ((iPos < m_iInputPos) && (m_pstrInput[iPos] >= '0') && (m_pstrInput[iPos] <= '9')) {
+        if (u32Seq > ((UINT32_MAX - 9U) / 10U)) {
+            return false; /* not a tag, the line fails as a command */
+        }
+        u32Seq = (u32Seq * 10U) + (uint32_t)(m_pstrInput[iPos++] - '0');
+    }
+    if ((0 == iPos) || ((iPos < m_iInputPos) && (uSHELL_KEY_SPACE != m_pstrInput[iPos]))) {
+        return false;
+    }
+    while ((iPos < m_iInputPos) && (uSHELL_KEY_SPACE == m_pstrInput[iPos])) {
+        ++iPos;
+    }
+    m_iInputPos -= iPos;
+    memmove(m_pstrInput, &m_pstrInput[iPos], (size_t)m_iInputPos + 1U);
+    m_u32MachineSeq = u32Seq;
+    m_bMachineTagged = true;
+    return true;
+} /* m_MachineTakeTag() */
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) */
+
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_MODE) */
+
+/*==============================================================================
+              SCRIPTS IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_ScriptSearch(const char *pstrScriptName) {
+    if (nullptr != pstrScriptName) {
+        for (int i = 0; i < m_pInst->iNrScripts; ++i) {
+            if (0 == strcmp(pstrScriptName, m_pInst->psScriptsArray[i].pstrScriptName)) {
+                return i;
+            }
+        }
+    }
+    return uSHELL_ERR_ITEM_NOT_FOUND;
+} /* m_ScriptSearch() */
+
+/*----------------------------------------------------------------------------*/
+/* every step is the body of a binary frame (index + packed args) prefixed by its
+   length; the steps are executed without any text parsing, a 0 length ends the script */
+int Microshell::m_ScriptRun(const script_s *psScript, int *piStep) {
+    int iRetVal = uSHELL_ERR_OK;
+    const uint8_t *pu8Code = psScript->pu8Code;
+    uint8_t *pu8Frame = (uint8_t *)m_pstrInput;
+
+    *piStep = 0;
+    while (uSHELL_CMD_SUCCEEDED(iRetVal) && (0 != *pu8Code)) {
+        const uint8_t u8Length = *pu8Code++;
+        ++(*piStep);
+        if (u8Length >= uSHELL_MAX_INPUT_BUF_LEN) {
+            iRetVal = uSHELL_ERR_INVALID_FRAME;
+            break;
+        }
+        /* the handlers get writable strings, so the step is copied out of flash */
+        memcpy(pu8Frame, pu8Code, u8Length);
+        iRetVal = m_BinaryExecuteFrame(pu8Frame, u8Length);
+        pu8Code += u8Length;
+    }
+    m_CoreResetInput(false);
+    return iRetVal;
+} /* m_ScriptRun() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_ScriptShowList(void) {
+    if (0 == m_pInst->iNrScripts) {
+        m_CorePrintMessage(11, 5); /* script empty */
+    }
+    uSHELL_SET_COLOR(uSHELL_INFO_LIST_COLOR);
+    for (int i = 0; i < m_pInst->iNrScripts; ++i) {
+        uSHELL_PRINTF("%3d | %s : %s\n", i, m_pInst->psScriptsArray[i].pstrScriptName, m_pInst->psScriptsArray[i].pstrScriptInfo);
+    }
+    uSHELL_SET_COLOR(uSHELL_RESET_COLOR);
+} /* m_ScriptShowList() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_ScriptHandleShortcut(const char *pstrArgs) {
+    while (uSHELL_KEY_SPACE == *pstrArgs) {
+        ++pstrArgs;
+    }
+    if ('\0' == *pstrArgs) {
+        m_ScriptShowList();
+    } else {
+        const int iIndex = m_ScriptSearch(pstrArgs);
+        if (uSHELL_ERR_ITEM_NOT_FOUND == iIndex) {
+            m_CorePrintMessage(11, 9); /* script missing */
+        } else {
+            int iStep = 0;
+            const int iRetVal = m_ScriptRun(&m_pInst->psScriptsArray[iIndex], &iStep);
+            if (uSHELL_CMD_SUCCEEDED(iRetVal)) {
+                uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %d steps\n"), iStep);
+            } else {
+                uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r: step %d failed\n"), iStep);
+                if (uSHELL_ERR_INVALID_FRAME != iRetVal) {
+                    m_CorePrintError(iRetVal);
+                }
+            }
+        }
+    }
+} /* m_ScriptHandleShortcut() */
+
+#endif /* (1 == uSHELL_IMPLEMENTS_SCRIPTS) */
+
+/*==============================================================================
+              LOOPS IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_LOOPS)
+
+/*----------------------------------------------------------------------------*/
+/* repeat <n> { <cmd> [; <cmd> ...] } runs the steps n times, for <var> <from> <to> [<step>] { ... $var ... }
+   once per value, up or down, $var in a number parameter of a step taking the value of the turn; the body is
+   parsed once, the turns only call the handlers of the steps (no lookup, no parse, no output of their own);
+   false if the line is no loop, which is left to the command parser */
+bool Microshell::m_LoopHandle(void) {
+    static const char *pstrUsage = "\r : repeat <n> { <cmd> [; <cmd>] } | for <var> <from> <to> [<step>] { ... $var ... }\n";
+    const size_t szWord = strcspn(m_pstrInput, m_pstrTokenSeparator);
+    const bool bFor = ((3U == szWord) && (0 == strncmp(m_pstrInput, "for", szWord)));
+    char *pstrOpen = strchr(m_pstrInput, uSHELL_LOOP_BODY_OPEN);
+
+    if ((nullptr == pstrOpen) || ((false == bFor) && ((6U != szWord) || (0 != strncmp(m_pstrInput, "repeat", szWord))))) {
+        return false;
+    }
+
+    /* header: the numbers before the body, the body: what the braces hold (the line has no trailing spaces) */
+    char *pstrClose = &m_pstrInput[strlen(m_pstrInput) - 1U];
+    char vstrVar[uSHELL_LOOP_VAR_MAX_LEN] = {0};
+    uint32_t vu32Args[3] = {0U, 0U, 1U};    /* repeat: turns, for: from, to, step */
+    int iNrArgs = 0;
+    bool bValid = (uSHELL_LOOP_BODY_CLOSE == *pstrClose);
+
+    *pstrOpen = '\0';
+    *pstrClose = '\0';
+    char *pstrRest = &m_pstrInput[szWord];
+    char *pstrToken = nullptr;
+    if ((true == bValid) && (true == bFor)) {
+        pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest);
+        bValid = (nullptr != pstrToken) && (uSHELL_LOOP_VAR_MARK != pstrToken[0]) && (strlen(pstrToken) < sizeof(vstrVar));
+        if (true == bValid) {
+            strcpy(vstrVar, pstrToken);
+        }
+    }
+    while ((true == bValid) && (nullptr != (pstrToken = strtok_ex(pstrRest, m_pstrTokenSeparator, &pstrRest)))) {
+        bValid = (iNrArgs < (bFor ? 3 : 1)) &&
+                 (uSHELL_ERR_OK == asc2int32_max(pstrToken, strlen(pstrToken), UINT32_MAX, &vu32Args[iNrArgs++]));
+    }
+    bValid = bValid && (iNrArgs >= (bFor ? 2 : 1)) && (0U != vu32Args[2]);
+    if (false == bValid) {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "%s"), pstrUsage);
+        return true;
+    }
+
+    uint32_t u32Turns = vu32Args[0];
+    int32_t i32Step = 0;
+    if (true == bFor) {
+        const uint32_t u32Span = (vu32Args[1] >= vu32Args[0]) ? (vu32Args[1] - vu32Args[0]) : (vu32Args[0] - vu32Args[1]);
+        if ((vu32Args[2] > (uint32_t)INT32_MAX) || ((u32Span / vu32Args[2]) >= UINT32_MAX)) {
+            uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "%s"), pstrUsage);
+            return true;
+        }
+        u32Turns = (u32Span / vu32Args[2]) + 1U;
+        i32Step = (vu32Args[1] >= vu32Args[0]) ? (int32_t)vu32Args[2] : -(int32_t)vu32Args[2];
+    }
+
+    int iStep = 0;
+    memset(m_sLoop.vstrBody, 0, sizeof(m_sLoop.vstrBody));
+    strcpy(m_sLoop.vstrBody, pstrOpen + 1);
+    int iRetVal = m_LoopCompile(bFor ? vstrVar : nullptr, &iStep);
+    if (uSHELL_ERR_OK != iRetVal) {
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r: step %d failed\n"), iStep);
+        if (iStep > (int)uSHELL_LOOP_MAX_STEPS) {
+            uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r : %u steps at most\n"), (unsigned)uSHELL_LOOP_MAX_STEPS);
+        } else {
+            m_CorePrintError(iRetVal);
+        }
+        return true;
+    }
+
+    uint32_t u32Turn = 0U;
+    iRetVal = m_LoopRun(vu32Args[0], u32Turns, i32Step, &u32Turn, &iStep);
+    if (uSHELL_CMD_SUCCEEDED(iRetVal)) {
+        uSHELL_PRINTF(FRMT(uSHELL_SUCCESS_COLOR, "\r=> %u turns of %d steps\n"), (unsigned)u32Turns, m_sLoop.iNrSteps);
+    } else {
+        /* the error is told with the command of the step */
+        m_sCommand = m_sLoop.vsSteps[iStep];
+        uSHELL_PRINTF(FRMT(uSHELL_ERROR_COLOR, "\r: turn %u step %d failed\n"), (unsigned)(u32Turn + 1U), iStep + 1);
+        m_CorePrintError(iRetVal);
+    }
+    return true;
+} /* m_LoopHandle() */
+
+/*----------------------------------------------------------------------------*/
+/* every step of m_sLoop.vstrBody is parsed in the input buffer, then its tokens are put back in place of
+   its text and the parse points there; the ';' of the steps are their ends (no ';' inside their strings) */
+int Microshell::m_LoopCompile(const char *pstrVar, int *piStep) {
+    int iRetVal = uSHELL_ERR_OK;
+    char *pstrStep = m_sLoop.vstrBody;
+
+    m_sLoop.iNrSteps = 0;
+    m_pstrLoopVar = pstrVar;
+    *piStep = 0;
+    while ((uSHELL_ERR_OK == iRetVal) && ('\0' != *pstrStep)) {
+        const size_t szLen = strcspn(pstrStep, uSHELL_LOOP_STEP_SEPARATORS);
+        const bool bLast = ('\0' == pstrStep[szLen]);
+
+        if (strspn(pstrStep, m_pstrTokenSeparator) < szLen) {
+            ++(*piStep);
+            if (m_sLoop.iNrSteps >= (int)uSHELL_LOOP_MAX_STEPS) {
+                iRetVal = uSHELL_ERR_TOO_MANY_ARGS;
+                break;
+            }
+            memset(m_pstrInput, 0, sizeof(m_pstrInput));
+            memcpy(m_pstrInput, pstrStep, szLen);
+            memset(&m_sCommand, 0, sizeof(m_sCommand));
+            m_u32LoopVarSlots = 0U;
+            if (uSHELL_ERR_OK == (iRetVal = m_CoreParseCommand())) {
+                command_s *psStep = &m_sLoop.vsSteps[m_sLoop.iNrSteps];
+                memcpy(pstrStep, m_pstrInput, szLen);
+                pstrStep[szLen] = '\0';
+                *psStep = m_sCommand;
+                s_RebaseCommand(psStep, m_pstrInput, pstrStep);
+                m_sLoop.vu32VarSlots[m_sLoop.iNrSteps++] = m_u32LoopVarSlots;
+            }
+        }
+        pstrStep += bLast ? szLen : (szLen + 1U);
+    }
+    m_pstrLoopVar = nullptr;
+    return iRetVal;
+} /* m_LoopCompile() */
+
+/*----------------------------------------------------------------------------*/
+/* the turns, until the first step which fails: its turn and index are left in pu32Turn and piStep */
+int Microshell::m_LoopRun(const uint32_t u32From, const uint32_t u32Turns, const int32_t i32Step, uint32_t *pu32Turn, int *piStep) {
+    int iRetVal = uSHELL_ERR_OK;
+    uint32_t u32Value = u32From;
+
+    for (*pu32Turn = 0U; *pu32Turn < u32Turns; ++(*pu32Turn), u32Value += (uint32_t)i32Step) {
+        for (*piStep = 0; *piStep < m_sLoop.iNrSteps; ++(*piStep)) {
+            command_s *psStep = &m_sLoop.vsSteps[*piStep];
+            const uint32_t u32VarSlots = m_sLoop.vu32VarSlots[*piStep];
+
+            if ((0U != u32VarSlots) && (uSHELL_ERR_OK != (iRetVal = m_LoopStoreVariable(psStep, u32VarSlots, u32Value)))) {
+                return iRetVal;
+            }
+            uSHELL_SCRATCH_MARK();
+            iRetVal = m_pInst->pfExec(psStep);
+            uSHELL_SCRATCH_RELEASE();
+            if (!uSHELL_CMD_SUCCEEDED(iRetVal)) {
+                return iRetVal;
+            }
+        }
+    }
+    return iRetVal;
+} /* m_LoopRun() */
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_LoopIsVariable(const char *pstrToken, const size_t szLen) const {
+    return (nullptr != m_pstrLoopVar) && (szLen > 1U) && (uSHELL_LOOP_VAR_MARK == pstrToken[0]) &&
+           ((szLen - 1U) == strlen(m_pstrLoopVar)) && (0 == strncmp(pstrToken + 1, m_pstrLoopVar, szLen - 1U));
+} /* m_LoopIsVariable() */
+
+/*----------------------------------------------------------------------------*/
+/* the values of a type are stored in the order of their parameters: the n-th slot of a type
+   is the one of the n-th parameter of that type in the pattern */
+int Microshell::m_LoopStoreVariable(command_s *psCmd, const uint32_t u32VarSlots, const uint32_t u32Value) {
+    const paramsDecoder_s *psDecoder = &m_pInst->psParamsDecoderArray[m_pInst->psFuncDefArray[psCmd->iFctIndex].u8ParamsPattern];
+    unsigned int vuTypeIndex[uSHELL_TYPE_LAST] = {0U};
+
+    for (int iSlot = 0; iSlot < (int)psDecoder->u8NrParams; ++iSlot) {
+        const int iType = psDecoder->vu8Types[iSlot];
+        const unsigned int uIndex = vuTypeIndex[iType]++;
+        if (0U == (u32VarSlots & (1UL << iSlot))) {
+            continue;
+        }
+        const typeDecoder_s *psType = &m_vsTypeDecoders[iType];
+        if ((BIGNUM_T)u32Value > psType->maxValue) {
+            psCmd->eDataType = (dataType_e)iType;
+            psCmd->iErrorInfo = iSlot;
+            return uSHELL_ERR_VALUE_TOO_BIG;
+        }
+        void *pvDest = (uint8_t *)psCmd + psType->u16ValOffset + (uIndex * psType->u8ValSize);
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+        if (psType->u8ValSize > sizeof(uint32_t)) {
+            *(num64_t *)pvDest = u32Value;
+            continue;
+        }
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+        m_CoreStoreNumber(pvDest, psType->u8ValSize, u32Value);
+    }
+    return uSHELL_ERR_OK;
+} /* m_LoopStoreVariable() */
+
+#endif /* (1 == uSHELL_IMPLEMENTS_LOOPS) */
+
+/*==============================================================================
+              HISTORY IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryWriteLengthAt(char *pBuffer, size_t szCapacity, size_t szPos, uint16_t u16Len) {
+    pBuffer[szPos % szCapacity] = (u16Len >> 8) & 0xFF;
+    pBuffer[(szPos + 1) % szCapacity] = u16Len & 0xFF;
+}
+
+/*----------------------------------------------------------------------------*/
+uint16_t Microshell::m_HistoryReadLengthAt(const char *pBuffer, size_t szCapacity, size_t szPos) {
+    uint8_t u8High = pBuffer[szPos % szCapacity];
+    uint8_t u8Low = pBuffer[(szPos + 1) % szCapacity];
+    return (u8High << 8) | u8Low;
+}
+
+/*----------------------------------------------------------------------------*/
+inline size_t Microshell::m_HistoryEntryTotalSize(uint16_t u16DataLen) {
+    return uSHELL_HISTORY_METADATA_SIZE + u16DataLen;
+}
+
+/*----------------------------------------------------------------------------*/
+size_t Microshell::m_HistoryCalculateUsedSpace(const history_s *pHistory) {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    // Kept up to date by push and remove (also right for a full buffer, head == tail)
+    return pHistory->szUsedBytes;
+#else
+    if (pHistory->szEntryCount == 0) {
+        return 0;
+    }
+
+    // Calculate distance from tail to head in circular buffer (head on tail means full)
+    if (pHistory->szDataHeadPos > pHistory->szOldestEntryPos) {
+        return pHistory->szDataHeadPos - pHistory->szOldestEntryPos;
+    } else {
+        return (pHistory->szDataBufferSize - pHistory->szOldestEntryPos) + pHistory->szDataHeadPos;
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)*/
+}
+
+/*----------------------------------------------------------------------------*/
+size_t Microshell::m_HistoryRecordSizeAt(const history_s *pHistory, size_t szPos) {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    // [prefix][suffix len][suffix...]
+    return m_HistoryEntryTotalSize((uint8_t)pHistory->pDataBuffer[(szPos + 1) % pHistory->szDataBufferSize]);
+#else
+    return m_HistoryEntryTotalSize(m_HistoryReadLengthAt(pHistory->pDataBuffer, pHistory->szDataBufferSize, szPos));
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+}
+
+/*----------------------------------------------------------------------------*/
+size_t Microshell::m_HistoryFindNextEntryPos(const history_s *pHistory, size_t szPos) {
+    return (szPos + m_HistoryRecordSizeAt(pHistory, szPos)) % pHistory->szDataBufferSize;
+}
+
+/*----------------------------------------------------------------------------*/
+size_t Microshell::m_HistoryEntryPosAtIndex(const history_s *pHistory, size_t szIndex) {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    return pHistory->pu16EntryIndex[(pHistory->szIndexFirst + szIndex) % pHistory->szIndexCapacity];
+#else
+    // Traverse from tail to find the requested entry
+    size_t szPos = pHistory->szOldestEntryPos;
+    for (size_t i = 0; i < szIndex; i++) {
+        szPos = m_HistoryFindNextEntryPos(pHistory, szPos);
+    }
+    return szPos;
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)*/
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryRemoveOldestEntry(history_s *pHistory) {
+    if (pHistory->szEntryCount == 0) {
+        return;
+    }
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    pHistory->szUsedBytes -= m_HistoryRecordSizeAt(pHistory, pHistory->szOldestEntryPos);
+    pHistory->szIndexFirst = (pHistory->szIndexFirst + 1) % pHistory->szIndexCapacity;
+#endif
+
+    // Move tail forward to skip the oldest entry
+    pHistory->szOldestEntryPos = m_HistoryFindNextEntryPos(pHistory, pHistory->szOldestEntryPos);
+    pHistory->szEntryCount--;
+}
+
+void Microshell::m_HistoryInitCore(history_s *pHistory, char *pDataBuffer, size_t szCapacity) {
+    pHistory->pDataBuffer = pDataBuffer;
+    pHistory->szDataBufferSize = szCapacity;
+    pHistory->szDataHeadPos = 0;
+    pHistory->szOldestEntryPos = 0;
+    pHistory->szEntryCount = 0;
+    pHistory->szCurrentIndex = 0;
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    // The index ring is the one of the instance, sized by uSHELL_HISTORY_INDEX_DEPTH
+    pHistory->pu16EntryIndex = m_historyIndex;
+    pHistory->szIndexCapacity = uSHELL_NR_ELEMS(m_historyIndex);
+    pHistory->szIndexFirst = 0;
+    pHistory->szUsedBytes = 0;
+#endif
+
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    pHistory->pstrFilePath = NULL;
+    pHistory->bAutoSave = false;
+#endif
+
+    // Clear buffer
+    memset(pDataBuffer, 0, szCapacity);
+}
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+/*----------------------------------------------------------------------------*/
+size_t Microshell::m_HistoryDecodeAt(const history_s *pHistory, size_t szPos, char *pBuffer, size_t szBufferSize) {
+    const char *pData = pHistory->pDataBuffer;
+    const size_t szCapacity = pHistory->szDataBufferSize;
+    size_t szPrefix = (uint8_t)pData[szPos % szCapacity];
+    size_t szLen = szPrefix + (uint8_t)pData[(szPos + 1) % szCapacity];
+
+    if (szLen > szBufferSize - 1) {
+        szLen = szBufferSize - 1;
+    }
+
+    // The own suffix, the prefix is shared with the next newer entry
+    size_t szNeed = (szPrefix < szLen) ? szPrefix : szLen;
+    for (size_t i = szNeed; i < szLen; i++) {
+        pBuffer[i] = pData[(szPos + 2 + i - szPrefix) % szCapacity];
+    }
+
+    // Each newer entry gives the characters beyond its own shared prefix, the newest one is whole
+    for (size_t n = 0; (szNeed > 0) && (n < pHistory->szEntryCount); n++) {
+        szPos = m_HistoryFindNextEntryPos(pHistory, szPos);
+        szPrefix = (uint8_t)pData[szPos % szCapacity];
+        for (size_t i = szPrefix; i < szNeed; i++) {
+            pBuffer[i] = pData[(szPos + 2 + i - szPrefix) % szCapacity];
+        }
+        if (szPrefix < szNeed) {
+            szNeed = szPrefix;
+        }
+    }
+    pBuffer[szLen] = '\0';
+
+    return szLen;
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryCompressNewest(history_s *pHistory, const char *pstrNext, size_t szNextLen) {
+    char *pData = pHistory->pDataBuffer;
+    const size_t szCapacity = pHistory->szDataBufferSize;
+    const size_t szPos = m_HistoryEntryPosAtIndex(pHistory, pHistory->szEntryCount - 1);
+    const size_t szLen = (uint8_t)pData[(szPos + 1) % szCapacity];   // the newest entry is whole
+    size_t szShared = 0;
+
+    while ((szShared < szLen) && (szShared < szNextLen) && (pData[(szPos + 2 + szShared) % szCapacity] == pstrNext[szShared])) {
+        szShared++;
+    }
+    if (0 == szShared) {
+        return;
+    }
+
+    // Keep only the suffix, the prefix is found in the entry pushed next
+    for (size_t i = szShared; i < szLen; i++) {
+        pData[(szPos + 2 + i - szShared) % szCapacity] = pData[(szPos + 2 + i) % szCapacity];
+    }
+    pData[szPos % szCapacity] = (char)szShared;
+    pData[(szPos + 1) % szCapacity] = (char)(szLen - szShared);
+    pHistory->szDataHeadPos = (szPos + 2 + szLen - szShared) % szCapacity;
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    pHistory->szUsedBytes -= szShared;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryRemoveEntry(history_s *pHistory, size_t szIndex) {
+    if (0 == szIndex) {
+        m_HistoryRemoveOldestEntry(pHistory);
+        return;
+    }
+
+    char *pData = pHistory->pDataBuffer;
+    const size_t szCapacity = pHistory->szDataBufferSize;
+    const size_t szPrevPos = m_HistoryEntryPosAtIndex(pHistory, szIndex - 1);
+    const size_t szPos = m_HistoryFindNextEntryPos(pHistory, szPrevPos);
+    const size_t szNextPos = m_HistoryFindNextEntryPos(pHistory, szPos);
+
+    // The previous entry shares with the one after the removed entry at least what both shared
+    char acPrev[uSHELL_MAX_INPUT_BUF_LEN];
+    const size_t szPrevLen = m_HistoryDecodeAt(pHistory, szPrevPos, acPrev, sizeof(acPrev));
+    size_t szShared = 0;
+    if ((szIndex + 1) < pHistory->szEntryCount) {
+        const size_t szPrevPrefix = (uint8_t)pData[szPrevPos % szCapacity];
+        const size_t szPrefix = (uint8_t)pData[szPos % szCapacity];
+        szShared = (szPrevPrefix < szPrefix) ? szPrevPrefix : szPrefix;
+    }
+
+    // Rewrite it in place, it never outgrows the two records
+    pData[szPrevPos % szCapacity] = (char)szShared;
+    pData[(szPrevPos + 1) % szCapacity] = (char)(szPrevLen - szShared);
+    for (size_t i = szShared; i < szPrevLen; i++) {
+        pData[(szPrevPos + 2 + i - szShared) % szCapacity] = acPrev[i];
+    }
+
+    // Close the gap, the newer records move back
+    const size_t szNewEnd = (szPrevPos + 2 + szPrevLen - szShared) % szCapacity;
+    const size_t szGap = (szNextPos + szCapacity - szNewEnd) % szCapacity;
+    const size_t szMove = (pHistory->szDataHeadPos + szCapacity - szNextPos) % szCapacity;
+    for (size_t i = 0; i < szMove; i++) {
+        pData[(szNewEnd + i) % szCapacity] = pData[(szNextPos + i) % szCapacity];
+    }
+    pHistory->szDataHeadPos = (pHistory->szDataHeadPos + szCapacity - szGap) % szCapacity;
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    pHistory->szUsedBytes -= szGap;
+    for (size_t j = szIndex; (j + 1) < pHistory->szEntryCount; j++) {
+        const uint16_t u16Next = pHistory->pu16EntryIndex[(pHistory->szIndexFirst + j + 1) % pHistory->szIndexCapacity];
+        pHistory->pu16EntryIndex[(pHistory->szIndexFirst + j) % pHistory->szIndexCapacity] = (uint16_t)((u16Next + szCapacity - szGap) % szCapacity);
+    }
+#endif
+
+    pHistory->szEntryCount--;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryPush(history_s *pHistory, bool bTriggerAutosave) {
+    // Trim m_pstrInput in place
+    char *pstrTrimmed = trim_whitespace_inplace(m_pstrInput);
+    size_t szLen = strlen(pstrTrimmed);
+
+    // Reject if empty or too large for uint16_t length field
+    if (szLen == 0 || szLen > 65535) {
+        return false;
+    }
+
+    size_t szNeeded = m_HistoryEntryTotalSize(szLen);
+
+    // Check if entry can possibly fit in buffer
+    if (szNeeded > pHistory->szDataBufferSize) {
+        return false;
+    }
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    // A repeated command moves to the front, a repeat of the newest one is rejected
+    if (pHistory->szEntryCount > 0) {
+        size_t szDuplicate = pHistory->szEntryCount;
+        {
+            char acEntry[uSHELL_MAX_INPUT_BUF_LEN];
+            size_t szPos = pHistory->szOldestEntryPos;
+
+            for (size_t i = 0; i < pHistory->szEntryCount; i++) {
+                if ((szLen == m_HistoryDecodeAt(pHistory, szPos, acEntry, sizeof(acEntry))) && (0 == memcmp(acEntry, pstrTrimmed, szLen))) {
+                    szDuplicate = i;
+                    break;
+                }
+                szPos = m_HistoryFindNextEntryPos(pHistory, szPos);
+            }
+        }
+
+        if (szDuplicate == (pHistory->szEntryCount - 1)) {
+            return false;
+        }
+        if (szDuplicate < pHistory->szEntryCount) {
+            m_HistoryRemoveEntry(pHistory, szDuplicate);
+        }
+    }
+
+    // The current newest entry keeps only what it does not share with the new one
+    if (pHistory->szEntryCount > 0) {
+        m_HistoryCompressNewest(pHistory, pstrTrimmed, szLen);
+    }
+#else
+    // Check for duplicates in ENTIRE pHistory
+    // If found anywhere, reject the new entry
+    if (pHistory->szEntryCount > 0) {
+        size_t szPos = pHistory->szOldestEntryPos;
+
+        for (size_t i = 0; i < pHistory->szEntryCount; i++) {
+            uint16_t entry_len = m_HistoryReadLengthAt(pHistory->pDataBuffer, pHistory->szDataBufferSize, szPos);
+
+            if (entry_len == szLen) {
+                // Lengths match, compare data
+                bool is_duplicate = true;
+                size_t data_pos = (szPos + 2) % pHistory->szDataBufferSize;
+                for (size_t j = 0; j < szLen; j++) {
+                    if (pHistory->pDataBuffer[(data_pos + j) % pHistory->szDataBufferSize] != pstrTrimmed[j]) {
+                        is_duplicate = false;
+                        break;
+                    }
+                }
+
+                if (is_duplicate) {
+                    return false; // Duplicate found anywhere in pHistory
+                }
+            }
+
+            szPos = m_HistoryFindNextEntryPos(pHistory, szPos);
+        }
+    }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+
+    // Remove oldest entries until we have enough space
+    size_t used = m_HistoryCalculateUsedSpace(pHistory);
+    while (pHistory->szEntryCount > 0 && (pHistory->szDataBufferSize - used) < szNeeded) {
+        // Get size of oldest entry before removing it
+        size_t oldest_size = m_HistoryRecordSizeAt(pHistory, pHistory->szOldestEntryPos);
+
+        m_HistoryRemoveOldestEntry(pHistory);
+        used -= oldest_size;
+    }
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    // Make room in the index too
+    if (pHistory->szEntryCount == pHistory->szIndexCapacity) {
+        m_HistoryRemoveOldestEntry(pHistory);
+    }
+#endif
+
+    // Double-check we have space (should always be true at this point)
+    if ((pHistory->szDataBufferSize - used) < szNeeded) {
+        return false;
+    }
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    // Write entry whole: [0][len][data...], compressed when the next one is pushed
+#else
+    // Write entry with embedded metadata: [len_hi][len_lo][data...][len_hi][len_lo]
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+    size_t write_pos = pHistory->szDataHeadPos;
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    pHistory->pu16EntryIndex[(pHistory->szIndexFirst + pHistory->szEntryCount) % pHistory->szIndexCapacity] = (uint16_t)write_pos;
+    pHistory->szUsedBytes += szNeeded;
+#endif
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    pHistory->pDataBuffer[write_pos] = 0;
+    pHistory->pDataBuffer[(write_pos + 1) % pHistory->szDataBufferSize] = (char)szLen;
+#else
+    // Write leading length (2 bytes)
+    m_HistoryWriteLengthAt(pHistory->pDataBuffer, pHistory->szDataBufferSize, write_pos, (uint16_t)szLen);
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+    write_pos = (write_pos + 2) % pHistory->szDataBufferSize;
+
+    // Write data
+    for (size_t i = 0; i < szLen; i++) {
+        pHistory->pDataBuffer[(write_pos + i) % pHistory->szDataBufferSize] = pstrTrimmed[i];
+    }
+    write_pos = (write_pos + szLen) % pHistory->szDataBufferSize;
+
+#if (0 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    // Write trailing length (2 bytes) - enables backward traversal
+    m_HistoryWriteLengthAt(pHistory->pDataBuffer, pHistory->szDataBufferSize, write_pos, (uint16_t)szLen);
+    write_pos = (write_pos + 2) % pHistory->szDataBufferSize;
+#endif /*(0 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+
+    // Update head position and counts
+    pHistory->szDataHeadPos = write_pos;
+    pHistory->szEntryCount++;
+    pHistory->szCurrentIndex = pHistory->szEntryCount - 1;
+
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    // Auto-save to file if enabled AND explicitly requested (not during load)
+    if (bTriggerAutosave && pHistory->bAutoSave && pHistory->pstrFilePath) {
+        m_HistoryAppendToFile(pHistory, pstrTrimmed);
+    }
+#else 
+    (void)bTriggerAutosave;
+#endif
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_STORE)
+    // Queue to the persistent store, the replay at attach does not trigger it
+    if (bTriggerAutosave && (nullptr != m_psHistoryStore)) {
+        m_psHistoryStore->pfAppend(pstrTrimmed, szLen);
+    }
+#endif
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryGetPrevEntry(history_s *pHistory, char *pBuffer, size_t szBufferSize) {
+    if (pHistory->szEntryCount == 0) {
+        return false;
+    }
+
+    if (pHistory->szCurrentIndex == 0) {
+        pHistory->szCurrentIndex = pHistory->szEntryCount - 1;
+    } else {
+        pHistory->szCurrentIndex--;
+    }
+
+    return m_HistoryGetEntryAtIndex(pHistory, pHistory->szCurrentIndex, pBuffer, szBufferSize);
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryGetNextEntry(history_s *pHistory, char *pBuffer, size_t szBufferSize) {
+    if (pHistory->szEntryCount == 0) {
+        return false;
+    }
+
+    pHistory->szCurrentIndex = (pHistory->szCurrentIndex + 1) % pHistory->szEntryCount;
+
+    return m_HistoryGetEntryAtIndex(pHistory, pHistory->szCurrentIndex, pBuffer, szBufferSize);
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryGetFirstEntry(const history_s *pHistory, char *pBuffer, size_t szBufferSize) {
+    return m_HistoryGetEntryAtIndex(pHistory, 0, pBuffer, szBufferSize);
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryGetLastEntry(const history_s *pHistory, char *pBuffer, size_t szBufferSize) {
+    if (pHistory->szEntryCount == 0) {
+        return false;
+    }
+    return m_HistoryGetEntryAtIndex(pHistory, pHistory->szEntryCount - 1, pBuffer, szBufferSize);
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistorySetIndex(history_s *pHistory, size_t szIndex) {
+    if (szIndex < pHistory->szEntryCount) {
+        pHistory->szCurrentIndex = szIndex;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryIsEmpty(const history_s *pHistory) {
+    return pHistory->szEntryCount == 0;
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryGetEntryAtIndex(const history_s *pHistory, size_t szIndex, char *pBuffer, size_t szBufferSize) {
+    if (szIndex >= pHistory->szEntryCount || szBufferSize == 0) {
+        return false;
+    }
+
+    size_t szPos = m_HistoryEntryPosAtIndex(pHistory, szIndex);
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    m_HistoryDecodeAt(pHistory, szPos, pBuffer, szBufferSize);
+#else
+    // Read entry length and data
+    uint16_t u16len = m_HistoryReadLengthAt(pHistory->pDataBuffer, pHistory->szDataBufferSize, szPos);
+    size_t copy_len = u16len < szBufferSize - 1 ? u16len : szBufferSize - 1;
+
+    // Copy data (skip the 2-byte leading length)
+    size_t data_pos = (szPos + 2) % pHistory->szDataBufferSize;
+    for (size_t i = 0; i < copy_len; i++) {
+        pBuffer[i] = pHistory->pDataBuffer[(data_pos + i) % pHistory->szDataBufferSize];
+    }
+    pBuffer[copy_len] = '\0';
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryClear(history_s *pHistory) {
+    pHistory->szDataHeadPos = 0;
+    pHistory->szOldestEntryPos = 0;
+    pHistory->szEntryCount = 0;
+    pHistory->szCurrentIndex = 0;
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    pHistory->szIndexFirst = 0;
+    pHistory->szUsedBytes = 0;
+#endif
+
+    // Clear the buffer
+    memset(pHistory->pDataBuffer, 0, pHistory->szDataBufferSize);
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryGetFreeSpace(const history_s *pHistory, size_t *pszFreeBytes) {
+    size_t szUsedBytes = m_HistoryCalculateUsedSpace(pHistory);
+    *pszFreeBytes = pHistory->szDataBufferSize - szUsedBytes;
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryShow(const history_s *pHistory) {
+    if (m_HistoryIsEmpty(pHistory)) {
+        m_CorePrintMessage(3, 5); /*pHistory empty*/
+        return;
+    }
+
+    // Traverse and display all entries
+    size_t szPos = pHistory->szOldestEntryPos;
+    for (size_t i = 0; i < pHistory->szEntryCount; i++) {
+        uSHELL_PRINTF("%3d : ", (unsigned int)i);
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+        // Print the entry data (rebuilt from the shared prefixes)
+        char acEntry[uSHELL_MAX_INPUT_BUF_LEN];
+        const size_t szLen = m_HistoryDecodeAt(pHistory, szPos, acEntry, sizeof(acEntry));
+        for (size_t j = 0; j < szLen; j++) {
+            m_TransportPutch(acEntry[j]);
+        }
+#else
+        uint16_t u16len = m_HistoryReadLengthAt(pHistory->pDataBuffer, pHistory->szDataBufferSize, szPos);
+
+        // Print the entry data (skip 2-byte leading length)
+        size_t data_pos = (szPos + 2) % pHistory->szDataBufferSize;
+        for (size_t j = 0; j < u16len; j++) {
+            m_TransportPutch(pHistory->pDataBuffer[(data_pos + j) % pHistory->szDataBufferSize]);
+        }
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+        uSHELL_PRINTF("\n");
+
+        // Move to next entry
+        szPos = m_HistoryFindNextEntryPos(pHistory, szPos);
+    }
+
+    size_t szFreeBytes = 0;
+    m_HistoryGetFreeSpace(pHistory, &szFreeBytes);
+    uSHELL_PRINTF("Entries: %d | Free bytes: %d\n", (unsigned int)pHistory->szEntryCount, (unsigned int)szFreeBytes);
+}
+
+/*----------------------------------------------------------------------------*/
+size_t Microshell::m_HistoryGetEntrySize(const history_s *pHistory) {
+    return pHistory->szEntryCount;
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryIteratorInit(historyIter_s *pIter, const history_s *pHistory) {
+    pIter->pHistory = pHistory;
+    pIter->szIndex = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryIteratorNext(historyIter_s *pIter, char *pBuffer, size_t szBufferSize) {
+    if (pIter->szIndex >= pIter->pHistory->szEntryCount) {
+        return false;
+    }
+
+    bool result = m_HistoryGetEntryAtIndex(pIter->pHistory, pIter->szIndex, pBuffer, szBufferSize);
+    pIter->szIndex++;
+
+    return result;
+}
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+/*----------------------------------------------------------------------------*/
+size_t Microshell::m_HistoryEntryLengthAt(const history_s *pHistory, size_t szPos) {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    return (size_t)(uint8_t)pHistory->pDataBuffer[szPos % pHistory->szDataBufferSize] +
+           (size_t)(uint8_t)pHistory->pDataBuffer[(szPos + 1) % pHistory->szDataBufferSize];
+#else
+    return m_HistoryReadLengthAt(pHistory->pDataBuffer, pHistory->szDataBufferSize, szPos);
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+}
+
+/*----------------------------------------------------------------------------*/
+char Microshell::m_HistoryCharAt(const history_s *pHistory, size_t szPos, size_t szOffset) {
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)
+    // A character of the shared prefix is in the suffix of a newer entry
+    for (size_t n = 0; n < pHistory->szEntryCount; n++) {
+        const size_t szPrefix = (uint8_t)pHistory->pDataBuffer[szPos % pHistory->szDataBufferSize];
+        if (szOffset >= szPrefix) {
+            return pHistory->pDataBuffer[(szPos + 2 + szOffset - szPrefix) % pHistory->szDataBufferSize];
+        }
+        szPos = m_HistoryFindNextEntryPos(pHistory, szPos);
+    }
+    return '\0';
+#else
+    return pHistory->pDataBuffer[(szPos + 2 + szOffset) % pHistory->szDataBufferSize];
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_COMPRESS)*/
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryEntryContains(const history_s *pHistory, size_t szPos, const char *pstrPattern, size_t szPatternLen) {
+    const size_t szLen = m_HistoryEntryLengthAt(pHistory, szPos);
+
+    // Matched in place, the entry is not copied
+    for (size_t i = 0; (i + szPatternLen) <= szLen; i++) {
+        size_t j = 0;
+        while ((j < szPatternLen) && (m_HistoryCharAt(pHistory, szPos, i + j) == pstrPattern[j])) {
+            j++;
+        }
+        if (j == szPatternLen) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryIteratorFindPrev(historyIter_s *pIter, const char *pstrPattern, size_t szPatternLen) {
+    // Newest first from the entry before the iterator, the iterator stays if none matches
+    for (size_t i = pIter->szIndex; i > 0; i--) {
+        if (m_HistoryEntryContains(pIter->pHistory, m_HistoryEntryPosAtIndex(pIter->pHistory, i - 1), pstrPattern, szPatternLen)) {
+            pIter->szIndex = i - 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)*/
+
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistorySetFilePath(history_s *pHistory, const char *pstrFilePath) {
+    pHistory->pstrFilePath = (char *)pstrFilePath;
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryLoadFromFile(history_s *pHistory) {
+    if (!pHistory->pstrFilePath) {
+        return false;
+    }
+
+    FILE *pFile = fopen(pHistory->pstrFilePath, "r");
+    if (!pFile) {
+        m_CorePrintMessage(9, 4); /*fopen failed*/
+        return false;
+    }
+
+    // Clear current pHistory
+    m_HistoryClear(pHistory);
+
+    // Read and push lines directly using m_pstrInput
+    while (fgets(m_pstrInput, uSHELL_MAX_INPUT_BUF_LEN, pFile)) {
+        // Remove trailing newline
+        size_t szLen = strlen(m_pstrInput);
+        if (szLen > 0 && m_pstrInput[szLen - 1] == '\n') {
+            m_pstrInput[szLen - 1] = '\0';
+            szLen--;
+        }
+        if (szLen > 0 && m_pstrInput[szLen - 1] == '\r') {
+            m_pstrInput[szLen - 1] = '\0';
+        }
+
+        // Push to pHistory WITHOUT triggering auto-save (false parameter)
+        m_HistoryPush(pHistory, false);
+    }
+
+    fclose(pFile);
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryEnableAutoSave(history_s *pHistory, bool bEnable) {
+    pHistory->bAutoSave = bEnable;
+}
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_HistoryAppendToFile(history_s *pHistory, const char *pstrEntry) {
+    if (!pHistory->pstrFilePath) {
+        return false;
+    }
+
+    FILE *pFile = fopen(pHistory->pstrFilePath, "a");
+    if (!pFile) {
+        m_CorePrintMessage(9, 4); /*fopen failed*/
+        return false;
+    }
+
+    fprintf(pFile, "%s\n", pstrEntry);
+    fclose(pFile);
+
+    return true;
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+
+/*==============================================================================
+        HISTORY WRAPPER FUNCTIONS
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryInit(const char *pstrFileName) {
+    // Initialize the advanced history implementation (no separate metadata array)
+    m_HistoryInitCore(&m_sHistory, m_historyBuffer, sizeof(m_historyBuffer));
+
+    m_bHistoryInitialized = true;
+    m_bHistoryEnabled = uSHELL_INIT_HISTORY_MODE;
+
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+    m_CoreUpdatePrompt(uSHELL_PROMPTI_HISTORY, m_bHistoryEnabled);
+#endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    if (nullptr != pstrFileName) {
+        m_HistoryInitFile(pstrFileName);
+        m_HistoryReload();
+    }
+#else
+    (void)pstrFileName;
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
+} /* m_HistoryInit() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryDeInit(void) {
+    if (true == m_bHistoryInitialized) {
+        m_HistoryClear(&m_sHistory);
+        m_bHistoryInitialized = false;
+        m_bHistoryEnabled = false;
+    }
+} /* m_HistoryDeInit() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryRead(const dir_e eDir) {
+    if ((true == m_bHistoryEnabled) && (false == m_HistoryIsEmpty(&m_sHistory))) {
+        // Clear the current line BEFORE loading pHistory into m_pstrInput
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        const int iOldLen = m_iInputPos;
+        const int iCursor = m_RenderCursor();
+        m_CoreResetInput(false);
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplReset(uSHELL_AUTOCOMPL_RELOAD);
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#else
+        m_CoreCmdLineDelete();
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+
+        bool success = false;
+
+        if (uSHELL_DIR_BACKWARD == eDir) {
+            success = m_HistoryGetPrevEntry(&m_sHistory, m_pstrInput, sizeof(m_pstrInput));
+        } else {
+            success = m_HistoryGetNextEntry(&m_sHistory, m_pstrInput, sizeof(m_pstrInput));
+        }
+
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        if (!success) {
+            m_pstrInput[0] = '\0';
+        }
+        m_iInputPos = (int)strlen(m_pstrInput);
+        m_RenderTail(0, iCursor, iOldLen, m_iInputPos);
+#else
+        if (success) {
+            m_iInputPos = (int)strlen(m_pstrInput);
+            uSHELL_PRINTF("\r\033[%dC\033[K%s", m_pInst->iPromptLength, m_pstrInput);
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+    }
+} /* m_HistoryRead() */
+
+/*----------------------------------------------------------------------------*/
+char *Microshell::m_HistoryGetEntry(const int iIndex) {
+    if ((true == m_bHistoryInitialized) && (true == m_bHistoryEnabled)) {
+        if (m_HistoryGetEntryAtIndex(&m_sHistory, (size_t)iIndex, m_pstrInput, sizeof(m_pstrInput))) {
+            return m_pstrInput;
+        }
+    }
+    return nullptr;
+} /* m_HistoryGetEntry() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryExecuteEntry(const char *pstrIndex) {
+    BIGNUM_T iIndex = 0;
+    if (true == asc2int((pstrIndex), &iIndex)) {
+        m_CoreCmdLineDelete();
+        m_TransportPutch('\r');
+        char *pstrHistItem = m_HistoryGetEntry((int)iIndex);
+        if (nullptr != pstrHistItem) {
+            // m_pstrInput is already populated by m_HistoryGetEntry
+#if !(defined(__MINGW32__) || defined(_MSC_VER))
+            uSHELL_PRINTF("> %s\n", m_pstrInput);
+#endif /* (defined(__MINGW32__) || defined(_MSC_VER)) */
+            m_CoreExecuteEnterKey();
+        } else {
+            m_CorePrintMessage(3, 3); /* pHistory noentry or invalid index */
+        }
+    } else {
+        m_CorePrintMessage(6, 2); /* sub-shortcut unimplemented */
+    }
+} /* m_HistoryExecuteEntry() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryWrite(void) {
+    if (true == m_bHistoryEnabled) {
+        // Push to pHistory - it handles duplicates, trimming, and auto-save internally
+        m_HistoryPush(&m_sHistory, true);
+    }
+} /* m_HistoryWrite() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryReset(void) {
+    if (true == m_bHistoryInitialized) {
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+        if (true == m_CoreConfirmRequest()) {
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST) */
+            m_HistoryClear(&m_sHistory);
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_STORE)
+            if (nullptr != m_psHistoryStore) {
+                m_psHistoryStore->pfClear();
+            }
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY_STORE) */
+            m_CorePrintMessage(3, 6); /* pHistory reset */
+#if (1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST)
+        }
+#endif /*(1 == uSHELL_IMPLEMENTS_CONFIRM_REQUEST) */
+    }
+} /* m_HistoryReset() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryList(void) {
+    if (true == m_bHistoryInitialized) {
+        if (true == m_bHistoryEnabled) {
+            m_HistoryShow(&m_sHistory);
+        } else {
+            m_CorePrintMessage(3, 0); /* pHistory off */
+        }
+    } else {
+        m_CorePrintMessage(3, 7); /* pHistory uninitialized */
+    }
+} /* m_HistoryList() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryEnable(bool bEnable) {
+    if (true == m_bHistoryInitialized) {
+        m_bHistoryEnabled = bEnable;
+        m_CorePrintMessage(3, (int)bEnable); /* pHistory on/off*/
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+        m_CoreUpdatePrompt(uSHELL_PROMPTI_HISTORY, bEnable);
+#endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+    }
+} /* m_HistoryEnable() */
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+
+#if ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryReload(void) {
+    if (true == m_bHistoryInitialized) {
+        if (!m_HistoryLoadFromFile(&m_sHistory)) {
+            m_CorePrintMessage(3, 10); /* pHistory nofile */
+        }
+    }
+} /* m_HistoryReload() */
+#endif /* ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)) */
+
+#if ((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))
+/*----------------------------------------------------------------------------*/
+void Microshell::m_HistoryInitFile(const char *pstrFileName) {
+    uSHELL_SNPRINTF(m_HistoryFilePath, sizeof(m_HistoryFilePath), ".hist_%s", pstrFileName);
+    m_HistorySetFilePath(&m_sHistory, m_HistoryFilePath);
+
+    // Enable auto-save for new entries
+    m_HistoryEnableAutoSave(&m_sHistory, true);
+} /* m_HistoryInitFile() */
+#endif /*((1 == uSHELL_IMPLEMENTS_HISTORY) && (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY))*/
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH)
+/*==============================================================================
+            HISTORY SEARCH IMPLEMENTATION
+==============================================================================*/
+
+/* shown between the match and the pattern */
+#define uSHELL_SEARCH_HINT          " (r-search) "
+#define uSHELL_SEARCH_HINT_LEN      ((int)sizeof(uSHELL_SEARCH_HINT) - 1)
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_SearchStart(void) {
+    if ((true == m_bHistoryEnabled) && (false == m_HistoryIsEmpty(&m_sHistory))) {
+        m_CoreCmdLineDelete();
+        m_HistoryIteratorInit(&m_sSearch, &m_sHistory);
+        m_sSearch.szIndex = m_HistoryGetEntrySize(&m_sHistory);
+        m_vstrSearch[0] = '\0';
+        m_iSearchLen = 0;
+        m_bSearchActive = true;
+        m_CorePutString(uSHELL_SEARCH_HINT);
+    }
+} /* m_SearchStart() */
+
+/*----------------------------------------------------------------------------*/
+/* false if the key ends the search, it is then handled as usual on the accepted match */
+bool Microshell::m_SearchHandleKey(const char cKeyPressed) {
+    const size_t szCount = m_HistoryGetEntrySize(&m_sHistory);
+
+    if (uSHELL_KEY_CTRL_R == cKeyPressed) {
+        /* the next older match */
+        if ((m_iSearchLen > 0) && (m_sSearch.szIndex < szCount)) {
+            m_SearchFind(m_sSearch.szIndex);
+        }
+        return true;
+    }
+
+    if (uSHELL_KEY_BACKSPACE == cKeyPressed) {
+        if (m_iSearchLen > 0) {
+            m_vstrSearch[--m_iSearchLen] = '\0';
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+            m_RenderMove(1, 0);
+            m_RenderErase(1);
+#else
+            m_CorePutString("\033[D \033[D");
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+            /* the newest match of the shorter pattern */
+            if (m_iSearchLen > 0) {
+                m_SearchFind(szCount);
+            }
+        }
+        return true;
+    }
+
+    if (true == uSHELL_ISPRINT(cKeyPressed)) {
+        if (m_iSearchLen < (int)uSHELL_HISTORY_SEARCH_LEN) {
+            m_vstrSearch[m_iSearchLen++] = cKeyPressed;
+            m_vstrSearch[m_iSearchLen] = '\0';
+            m_TransportPutch(cKeyPressed);
+            /* the current match is kept as long as it contains the pattern */
+            m_SearchFind((m_sSearch.szIndex < szCount) ? (m_sSearch.szIndex + 1) : szCount);
+        }
+        return true;
+    }
+
+    m_SearchStop();
+    return false;
+} /* m_SearchHandleKey() */
+
+/*----------------------------------------------------------------------------*/
+/* the newest match older than the entry szFrom, the line is redrawn only if it changes */
+bool Microshell::m_SearchFind(const size_t szFrom) {
+    historyIter_s sIter = m_sSearch;
+    sIter.szIndex = szFrom;
+
+    if (false == m_HistoryIteratorFindPrev(&sIter, m_vstrSearch, (size_t)m_iSearchLen)) {
+        return false;
+    }
+    if (sIter.szIndex != m_sSearch.szIndex) {
+        m_sSearch.szIndex = sIter.szIndex;
+        m_SearchShowMatch();
+    }
+    return true;
+} /* m_SearchFind() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_SearchShowMatch(void) {
+    const size_t szPos = m_HistoryEntryPosAtIndex(&m_sHistory, m_sSearch.szIndex);
+    const int iNewLen = (int)m_HistoryEntryLengthAt(&m_sHistory, szPos);
+    const int iOldVisible = m_iInputPos + uSHELL_SEARCH_HINT_LEN + m_iSearchLen;
+    int iSame = 0;
+
+    /* the characters the old match has in common with the new one stay on the screen */
+    while ((iSame < m_iInputPos) && (iSame < iNewLen) && (m_pstrInput[iSame] == m_HistoryCharAt(&m_sHistory, szPos, (size_t)iSame))) {
+        iSame++;
+    }
+
+    m_HistoryGetEntryAtIndex(&m_sHistory, m_sSearch.szIndex, m_pstrInput, sizeof(m_pstrInput));
+    m_iInputPos = (int)strlen(m_pstrInput);
+
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    const int iNewVisible = m_iInputPos + uSHELL_SEARCH_HINT_LEN + m_iSearchLen;
+    m_RenderMove(iOldVisible, iSame);
+    m_TransportWrite(m_pstrInput + iSame, (size_t)(m_iInputPos - iSame));
+    m_CorePutString(uSHELL_SEARCH_HINT);
+    m_TransportWrite(m_vstrSearch, (size_t)m_iSearchLen);
+    if (iOldVisible > iNewVisible) {
+        m_RenderErase(iOldVisible - iNewVisible);
+    }
+#else
+    (void)iOldVisible;
+    uSHELL_PRINTF("\r\033[%dC\033[K%s" uSHELL_SEARCH_HINT "%s", m_pInst->iPromptLength, m_pstrInput, m_vstrSearch);
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+} /* m_SearchShowMatch() */
+
+/*----------------------------------------------------------------------------*/
+/* the hint and the pattern are erased, the match stays on the line for editing */
+void Microshell::m_SearchStop(void) {
+    const int iTrailer = uSHELL_SEARCH_HINT_LEN + m_iSearchLen;
+
+    m_bSearchActive = false;
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+    m_RenderMove(iTrailer, 0);
+    m_RenderErase(iTrailer);
+#else
+    uSHELL_PRINTF("\033[%dD\033[K", iTrailer);
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    if (true == m_bEditMode) {
+        m_iCursorPos = m_iInputPos;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+
+    /* up/down go on from the match */
+    if (m_sSearch.szIndex < m_HistoryGetEntrySize(&m_sHistory)) {
+        m_HistorySetIndex(&m_sHistory, m_sSearch.szIndex);
+    }
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    m_AutocomplGetCommon();
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+} /* m_SearchStop() */
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY_SEARCH) */
+
+/*==============================================================================
+            AUTOCOMPLETE IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+void Microshell::m_AutocomplInit(void) {
+    m_sAutocomplete.bEnabled = uSHELL_INIT_AUTOCOMPL_MODE;
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+    m_CoreUpdatePrompt(uSHELL_PROMPTI_AUTOCOMPLETE, m_sAutocomplete.bEnabled);
+#endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
+    m_AutocomplFill(uSHELL_AUTOCOMPL_RELOAD);
+} /* m_AutocomplInit() */
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_AutocomplReInit(void) {
+    if (true == m_sAutocomplete.bEnabled) {
+        m_sAutocomplete.bFirstFilter = true;
+    }
+} /* m_AutocomplReInit() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplReset(bool bReinit) {
+#if (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+    memset(m_pInst->pu32AutocompleteSet, 0, (size_t)uSHELL_AUTOCOMPL_SET_WORDS(m_pInst->iNrFunctions) * sizeof(uint32_t));
+#endif /* (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+    m_sAutocomplete.iSearchPos = 0;
+    m_sAutocomplete.iSavedSearchPos = 0;
+    m_sAutocomplete.iSearchIndex = 0;
+    m_sAutocomplete.bFirstFilter = true;
+    m_sAutocomplete.bFoundExactMatch = false;
+    m_sAutocomplete.iNrCrtElems = 0;
+    m_AutocomplFill(bReinit);
+} /* m_AutocomplReset() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplGetCommon(void) {
+    if (true == m_sAutocomplete.bEnabled) {
+        int iCount = 0;
+        const char *pstrRef = nullptr, *pstrCrt = nullptr;
+#if (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+        bool bFound = false;
+        char cRef = '\0', cCrt = '\0';
+#endif /* (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+
+        m_AutocomplFilter();
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+        const int iBase = m_sAutocomplete.iArgStart;
+        const bool bNames = (nullptr == m_sAutocomplete.pfValues); /* the common part of the values is found by their filter */
+#else
+        const int iBase = 0;
+        const bool bNames = true;
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+        if ((true == bNames) && (m_sAutocomplete.iNrCrtElems > 0)) {
+            if (m_sAutocomplete.iNrCrtElems > 1) {
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+                /* the common part of a sorted range is the one of its first and last names,
+                   a name equal to it (exact match) sorts first */
+                pstrRef = m_AutocomplCandidate(0);
+                pstrCrt = m_AutocomplCandidate(m_sAutocomplete.iNrCrtElems - 1);
+                iCount = m_sAutocomplete.iSavedSearchPos;
+                while (('\0' != pstrRef[iCount]) && (pstrRef[iCount] == pstrCrt[iCount])) {
+                    ++iCount;
+                }
+                m_sAutocomplete.iSearchPos = iCount;
+                if ('\0' == pstrRef[iCount]) {
+                    m_sAutocomplete.bFoundExactMatch = true;
+                }
+#else
+                const int iWords = uSHELL_AUTOCOMPL_SET_WORDS(m_pInst->iNrFunctions);
+                while (false == bFound) {
+                    iCount = 0;
+                    pstrRef = m_AutocomplCandidate(0);
+                    /* every candidate against the first one (itself included), in the order of the set */
+                    for (int iWord = 0; iWord < iWords; ++iWord) {
+                        for (uint32_t u32Bits = m_pInst->pu32AutocompleteSet[iWord]; 0U != u32Bits; u32Bits &= (u32Bits - 1U)) {
+                            pstrCrt = m_pInst->psFuncDefArray[(iWord * 32) + __builtin_ctz(u32Bits)].pstrFctName;
+                            if ((cRef = pstrRef[m_sAutocomplete.iSearchPos]) == (cCrt = pstrCrt[m_sAutocomplete.iSearchPos])) {
+                                ++iCount;
+                            }
+                            if (('\0' == cRef) || ('\0' == cCrt)) {
+                                m_sAutocomplete.bFoundExactMatch = true;
+                            }
+                        }
+                    }
+                    if (iCount == m_sAutocomplete.iNrCrtElems) {
+                        ++(m_sAutocomplete.iSearchPos);
+                    } else {
+                        bFound = true;
+                    }
+                }
+#endif /* (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+            } else { /*1 == m_sAutocomplete.iNrCrtElems */
+                m_sAutocomplete.iSearchPos = (int)strlen(m_AutocomplCandidate(0));
+                m_sAutocomplete.bFoundExactMatch = true;
+            }
+        }
+        if (m_sAutocomplete.iNrCrtElems > 0) {
+            const char *pstrFirst = m_AutocomplCandidate(0);
+            for (int i = m_sAutocomplete.iSavedSearchPos; i < m_sAutocomplete.iSearchPos; ++i) {
+                char cCrtChar = pstrFirst[i - iBase];
+                m_pstrInput[i] = cCrtChar;
+                ++m_iInputPos;
+                m_TransportPutch(cCrtChar);
+            }
+            if (1 == m_sAutocomplete.iNrCrtElems) {
+                m_AutocomplInsEndSpace();
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+                if ((true == bNames) && (true == m_sAutocomplete.bFoundExactMatch)) {
+                    (void)m_AutocomplArgFilter(); /* the arrows offer the values of the first parameter */
+                }
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+            }
+        }
+    }
+} /* m_AutocomplGetCommon() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplRead(const dir_e eDir) {
+    if (true == m_sAutocomplete.bEnabled) {
+        if (uSHELL_KEY_BACKSPACE == m_sAutocomplete.cPrevKey) {
+            m_AutocomplReset(false);
+        }
+        if (m_sAutocomplete.iNrCrtElems != 0) {
+            switch (eDir) {
+            case uSHELL_DIR_FORWARD: {
+                if (true == m_sAutocomplete.bFoundExactMatch) {
+                    m_sAutocomplete.iSearchIndex++;
+                }
+            } break;
+            case uSHELL_DIR_BACKWARD: {
+                m_sAutocomplete.iSearchIndex--;
+            } break;
+            default:
+                break;
+            }
+            if (false == m_sAutocomplete.bFoundExactMatch) {
+                m_sAutocomplete.bFoundExactMatch = true;
+            }
+            m_sAutocomplete.iSearchIndex = (uSHELL_INVALID_VALUE == m_sAutocomplete.iSearchIndex) ? (m_sAutocomplete.iNrCrtElems - 1) : m_sAutocomplete.iSearchIndex;
+            m_sAutocomplete.iSearchIndex %= m_sAutocomplete.iNrCrtElems;
+            const char *pstrCandidate = m_AutocomplCandidate(m_sAutocomplete.iSearchIndex);
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+            const int iBase = m_sAutocomplete.iArgStart; /* a parameter value replaces only the last word */
+#else
+            const int iBase = 0;
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+            /* the screen keeps the part the new candidate has in common with the shown one */
+            const int iOldLen = m_iInputPos;
+            int iSame = iBase;
+            while ((iSame < iOldLen) && (m_pstrInput[iSame] == pstrCandidate[iSame - iBase])) {
+                ++iSame;
+            }
+#else
+            uSHELL_PRINTF("\r\033[%dC\033[K", m_pInst->iPromptLength);
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+#if (defined(__MINGW32__) || defined(_MSC_VER))
+            strncpy_s(m_pstrInput + iBase, sizeof(m_pstrInput) - iBase, pstrCandidate, sizeof(m_pstrInput) - iBase - 1);
+#else
+            strncpy(m_pstrInput + iBase, pstrCandidate, sizeof(m_pstrInput) - iBase - 1);
+#endif /*(defined(__MINGW32__) || defined(_MSC_VER))*/
+            m_pstrInput[sizeof(m_pstrInput) - 1] = '\0';           
+            m_iInputPos = (int)strlen(m_pstrInput);
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+            /* exact match: the ending space is sent with the rest */
+            m_pstrInput[m_iInputPos++] = uSHELL_KEY_SPACE;
+            m_pstrInput[m_iInputPos] = '\0';
+            m_RenderTail(iSame, iOldLen, iOldLen, m_iInputPos);
+#else
+            m_AutocomplInsEndSpace();
+            uSHELL_PRINTF("\r\033[%dC\033[K%s", m_pInst->iPromptLength, m_pstrInput);
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+        }
+    }
+} /* m_AutocomplRead() */
+
+/*----------------------------------------------------------------------------*/
+const char *Microshell::m_AutocomplCandidate(const int iElem) {
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+    if (nullptr != m_sAutocomplete.pfValues) {
+        return m_AutocomplArgValue(iElem);
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+    return m_pInst->psFuncDefArray[m_pInst->piSortedIndexArray[m_sAutocomplete.iFirstElem + iElem]].pstrFctName;
+#else
+    return m_pInst->psFuncDefArray[m_AutocomplSetIndex(iElem)].pstrFctName;
+#endif /* (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+} /* m_AutocomplCandidate() */
+
+#if (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+/*----------------------------------------------------------------------------*/
+/* bits of the commands of word iWord of the set, the last word is the rest of the table */
+static inline uint32_t s_AutocomplFullWord(const int iWord, const int iNrFunctions) {
+    const int iBits = iNrFunctions - (iWord * 32);
+    return (iBits >= 32) ? 0xFFFFFFFFU : ((1U << iBits) - 1U);
+}
+
+/*----------------------------------------------------------------------------*/
+/* the command of the iElem-th candidate: the set bits are counted a word at a time */
+int Microshell::m_AutocomplSetIndex(const int iElem) {
+    const uint32_t *pu32Set = m_pInst->pu32AutocompleteSet;
+    int iLeft = iElem, iWord = 0;
+    uint32_t u32Bits = pu32Set[0];
+
+    for (int iCount = __builtin_popcount(u32Bits); iLeft >= iCount; iCount = __builtin_popcount(u32Bits)) {
+        iLeft -= iCount;
+        u32Bits = pu32Set[++iWord]; /* iElem < iNrCrtElems: the bit is in a later word */
+    }
+    while (iLeft-- > 0) {
+        u32Bits &= (u32Bits - 1U); /* the lowest set bits before it */
+    }
+    return (iWord * 32) + __builtin_ctz(u32Bits);
+} /* m_AutocomplSetIndex() */
+#endif /* (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+/*----------------------------------------------------------------------------*/
+/* the names starting with the input are a range of the sorted table: two binary searches */
+void Microshell::m_AutocomplFilter(void) {
+    const size_t szLen = strlen(m_pstrInput);
+    int iLow = 0, iHigh = m_pInst->iNrFunctions, iMid = 0;
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+    if (true == m_AutocomplArgFilter()) {
+        return;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+    m_sAutocomplete.iSavedSearchPos = (int)szLen;
+    while (iLow < iHigh) { /* first name not below the input */
+        iMid = (iLow + iHigh) / 2;
+        if (strncmp(m_pInst->psFuncDefArray[m_pInst->piSortedIndexArray[iMid]].pstrFctName, m_pstrInput, szLen) < 0) {
+            iLow = iMid + 1;
+        } else {
+            iHigh = iMid;
+        }
+    }
+    m_sAutocomplete.iFirstElem = iLow;
+    iHigh = m_pInst->iNrFunctions;
+    while (iLow < iHigh) { /* first name above the input */
+        iMid = (iLow + iHigh) / 2;
+        if (strncmp(m_pInst->psFuncDefArray[m_pInst->piSortedIndexArray[iMid]].pstrFctName, m_pstrInput, szLen) <= 0) {
+            iLow = iMid + 1;
+        } else {
+            iHigh = iMid;
+        }
+    }
+    m_sAutocomplete.bFirstFilter = false;
+    m_sAutocomplete.iNrCrtElems = iLow - m_sAutocomplete.iFirstElem;
+} /* m_AutocomplFilter() */
+#else
+/*----------------------------------------------------------------------------*/
+/* the first filter tests every command, a later one only the candidates left: the new set is
+   the old one with the names which no longer match cleared */
+void Microshell::m_AutocomplFilter(void) {
+    const int iWords = uSHELL_AUTOCOMPL_SET_WORDS(m_pInst->iNrFunctions);
+    uint32_t *pu32Set = m_pInst->pu32AutocompleteSet;
+    int iCount = 0;
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+    if (true == m_AutocomplArgFilter()) {
+        return;
+    }
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+    m_sAutocomplete.iSavedSearchPos = (int)strlen(m_pstrInput);
+    for (int iWord = 0; iWord < iWords; ++iWord) {
+        uint32_t u32Bits = (true == m_sAutocomplete.bFirstFilter) ? s_AutocomplFullWord(iWord, m_pInst->iNrFunctions) : pu32Set[iWord];
+        uint32_t u32Kept = 0U;
+        while (0U != u32Bits) {
+            const uint32_t u32Bit = u32Bits & (0U - u32Bits);
+            const char *pstrCrtItem = m_pInst->psFuncDefArray[(iWord * 32) + __builtin_ctz(u32Bits)].pstrFctName;
+            if (0 == strncmp(pstrCrtItem, m_pstrInput, m_sAutocomplete.iSavedSearchPos)) {
+                u32Kept |= u32Bit;
+                ++iCount;
+            }
+            u32Bits ^= u32Bit;
+        }
+        pu32Set[iWord] = u32Kept;
+    }
+    if (true == m_sAutocomplete.bFirstFilter) {
+        m_sAutocomplete.bFirstFilter = false;
+    }
+    m_sAutocomplete.iNrCrtElems = iCount;
+} /* m_AutocomplFilter() */
+#endif /* (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+/*----------------------------------------------------------------------------*/
+/* after the name and a space the last word of the input is a parameter: its values come
+   from the completions table, the common part is found here (the values are not sorted);
+   returns false while the name itself is typed */
+bool Microshell::m_AutocomplArgFilter(void) {
+    const char *pstrSpace = strchr(m_pstrInput, uSHELL_KEY_SPACE);
+
+    if (nullptr == pstrSpace) {
+        m_sAutocomplete.pfValues = nullptr;
+        m_sAutocomplete.iArgStart = 0;
+        return false;
+    }
+
+    const size_t szInput = strlen(m_pstrInput);
+    const size_t szName = (size_t)(pstrSpace - m_pstrInput);
+    const char *pstrToken = m_pstrInput + szInput;
+    PFCOMPL pfValues = nullptr;
+    int iParam = 0;
+
+    /* parameters before the one in completion */
+    for (const char *p = pstrSpace + 1; p < (m_pstrInput + szInput); ++p) {
+        if ((uSHELL_KEY_SPACE != *p) && (uSHELL_KEY_SPACE == p[-1])) {
+            pstrToken = p;
+            ++iParam;
+        }
+    }
+    if (uSHELL_KEY_SPACE != m_pstrInput[szInput - 1]) {
+        --iParam;
+    } else {
+        pstrToken = m_pstrInput + szInput;
+    }
+
+    for (int i = 0; (i < m_pInst->iNrCompletions) && (nullptr == pfValues); ++i) {
+        const completion_s *psCompletion = &m_pInst->psCompletionsArray[i];
+        if ((iParam == psCompletion->iParam) && (0 == strncmp(psCompletion->pstrName, m_pstrInput, szName)) && ('\0' == psCompletion->pstrName[szName])) {
+            pfValues = psCompletion->pfValues;
+        }
+    }
+
+    /* another parameter: the values are cycled from the first one */
+    if ((pfValues != m_sAutocomplete.pfValues) || ((int)(pstrToken - m_pstrInput) != m_sAutocomplete.iArgStart)) {
+        m_sAutocomplete.iSearchIndex = 0;
+    }
+    m_sAutocomplete.pfValues = pfValues;
+    m_sAutocomplete.iArgStart = (int)(pstrToken - m_pstrInput);
+    m_sAutocomplete.iSavedSearchPos = (int)szInput;
+    m_sAutocomplete.bFirstFilter = true; /* the names are filtered again from the full table */
+    m_sAutocomplete.iNrCrtElems = 0;
+
+    if (nullptr != pfValues) {
+        const size_t szPrefix = szInput - (size_t)m_sAutocomplete.iArgStart;
+        const char *pstrFirst = nullptr, *pstrValue = nullptr;
+        size_t szCommon = 0, szShortest = 0;
+
+        for (int i = 0; nullptr != (pstrValue = pfValues(i)); ++i) {
+            if (0 == strncmp(pstrValue, pstrToken, szPrefix)) {
+                const size_t szLen = strlen(pstrValue);
+                if (nullptr == pstrFirst) {
+                    pstrFirst = pstrValue;
+                    szCommon = szShortest = szLen;
+                } else {
+                    size_t j = szPrefix;
+                    while ((j < szCommon) && (pstrFirst[j] == pstrValue[j])) {
+                        ++j;
+                    }
+                    szCommon = j;
+                    szShortest = (szLen < szShortest) ? szLen : szShortest;
+                }
+                ++(m_sAutocomplete.iNrCrtElems);
+            }
+        }
+        m_sAutocomplete.iSearchPos = m_sAutocomplete.iArgStart + (int)szCommon;
+        m_sAutocomplete.bFoundExactMatch = (szShortest == szCommon);
+    }
+    return true;
+} /* m_AutocomplArgFilter() */
+
+/*----------------------------------------------------------------------------*/
+/* iElem-th value matching the part of the parameter typed when it was filtered */
+const char *Microshell::m_AutocomplArgValue(const int iElem) {
+    const char *pstrPrefix = m_pstrInput + m_sAutocomplete.iArgStart;
+    const size_t szPrefix = (size_t)(m_sAutocomplete.iSavedSearchPos - m_sAutocomplete.iArgStart);
+    const char *pstrValue = nullptr;
+    int iCount = 0;
+
+    for (int i = 0; nullptr != (pstrValue = m_sAutocomplete.pfValues(i)); ++i) {
+        if ((0 == strncmp(pstrValue, pstrPrefix, szPrefix)) && (iCount++ == iElem)) {
+            break;
+        }
+    }
+    return (nullptr != pstrValue) ? pstrValue : "";
+} /* m_AutocomplArgValue() */
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplFill(const bool bFull) {
+    if (true == bFull) {
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+        m_sAutocomplete.pfValues = nullptr;
+        m_sAutocomplete.iArgStart = 0;
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL) */
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+        m_sAutocomplete.iFirstElem = 0;
+#else
+        for (int iWord = 0; iWord < uSHELL_AUTOCOMPL_SET_WORDS(m_pInst->iNrFunctions); ++iWord) {
+            m_pInst->pu32AutocompleteSet[iWord] = s_AutocomplFullWord(iWord, m_pInst->iNrFunctions);
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+        m_sAutocomplete.iNrCrtElems = m_pInst->iNrFunctions;
+    } else {
+        m_AutocomplGetCommon();
+    }
+} /* m_AutocomplFill() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplInsEndSpace(void) {
+    if ((true == m_sAutocomplete.bFoundExactMatch)) {
+        m_pstrInput[m_iInputPos++] = uSHELL_KEY_SPACE;
+        m_pstrInput[m_iInputPos] = '\0';
+        m_TransportPutch(uSHELL_KEY_SPACE);
+    }
+} /* m_AutocomplInsEndSpace() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_AutocomplEnable(const bool bEnable) {
+    m_sAutocomplete.bEnabled = bEnable;
+    m_CorePrintMessage(1, (int)bEnable); /* autocomplete on/off */
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+    m_CoreUpdatePrompt(uSHELL_PROMPTI_AUTOCOMPLETE, bEnable);
+#endif /* (1 == uSHELL_IMPLEMENTS_SMART_PROMPT) */
+} /* m_AutocomplEnable() */
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+/*==============================================================================
+               DELTA RENDER IMPLEMENTATION
+==============================================================================*/
+
+/* bytes of ESC [ n C|D */
+#define uSHELL_RENDER_CSI_COST(n)   (((n) < 10) ? 4 : (((n) < 100) ? 5 : 6))
+/* bytes of the cheapest move back over n columns */
+#define uSHELL_RENDER_BACK_COST(n)  (((n) < uSHELL_RENDER_CSI_COST(n)) ? (n) : uSHELL_RENDER_CSI_COST(n))
+/* bytes of ESC [ @ and of ESC [ P | ESC [ n P */
+#define uSHELL_RENDER_ICH_COST      (3)
+#define uSHELL_RENDER_DCH_COST(n)   ((1 == (n)) ? 3 : uSHELL_RENDER_CSI_COST(n))
+
+/*----------------------------------------------------------------------------*/
+/* terminal cursor in the input line, 0 is the first column after the prompt */
+inline int Microshell::m_RenderCursor(void) {
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+    return ((true == m_bEditMode) ? m_iCursorPos : m_iInputPos);
+#else
+    return m_iInputPos;
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+} /* m_RenderCursor() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_RenderRepeat(const char cChar, int iCount) {
+    char vcChunk[16];
+    memset(vcChunk, cChar, sizeof(vcChunk));
+
+    while (iCount > 0) {
+        const int iLen = (iCount < (int)sizeof(vcChunk)) ? iCount : (int)sizeof(vcChunk);
+        m_TransportWrite(vcChunk, (size_t)iLen);
+        iCount -= iLen;
+    }
+} /* m_RenderRepeat() */
+
+/*----------------------------------------------------------------------------*/
+/* cheapest move: backspaces or the characters already on the screen for a few
+   columns, ESC [ n D|C for longer distances */
+void Microshell::m_RenderMove(const int iFrom, const int iTo) {
+    if (iTo < iFrom) {
+        const int iSteps = iFrom - iTo;
+        if ((true == m_bDumbTerminal) || (iSteps < uSHELL_RENDER_CSI_COST(iSteps))) {
+            m_RenderRepeat('\b', iSteps);
+        } else {
+            uSHELL_PRINTF("\033[%dD", iSteps);
+        }
+    } else if (iTo > iFrom) {
+        const int iSteps = iTo - iFrom;
+        if ((true == m_bDumbTerminal) || (iSteps < uSHELL_RENDER_CSI_COST(iSteps))) {
+            m_TransportWrite(m_pstrInput + iFrom, (size_t)iSteps);
+        } else {
+            uSHELL_PRINTF("\033[%dC", iSteps);
+        }
+    }
+} /* m_RenderMove() */
+
+/*----------------------------------------------------------------------------*/
+/* clear iCount columns from the cursor on, the cursor does not move */
+void Microshell::m_RenderErase(const int iCount) {
+    if ((true == m_bDumbTerminal) || (1 == iCount)) {
+        m_RenderRepeat(' ', iCount);
+        m_RenderRepeat('\b', iCount);
+    } else if (iCount > 0) {
+        m_CorePutString("\033[K");
+    }
+} /* m_RenderErase() */
+
+/*----------------------------------------------------------------------------*/
+/* the screen shows the old line (iOldLen characters, cursor at iCursor) and its first
+   iSame characters are still in m_pstrInput: only the rest is sent, then the cursor
+   goes to iNewCursor */
+void Microshell::m_RenderTail(int iSame, const int iCursor, const int iOldLen, const int iNewCursor) {
+    const int iNewLen = (int)strlen(m_pstrInput);
+
+    if (iSame > iNewLen) {
+        iSame = iNewLen;
+    }
+    m_RenderMove(iCursor, iSame);
+    m_TransportWrite(m_pstrInput + iSame, (size_t)(iNewLen - iSame));
+    if (iOldLen > iNewLen) {
+        m_RenderErase(iOldLen - iNewLen);
+    }
+    m_RenderMove(iNewLen, iNewCursor);
+} /* m_RenderTail() */
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+/*----------------------------------------------------------------------------*/
+/* the character at iAt was inserted, the cursor is still there: the terminal shifts the
+   tail right (ESC [ @) when that is cheaper than sending the tail and coming back */
+void Microshell::m_RenderInsert(const int iAt) {
+    const int iNewLen = (int)strlen(m_pstrInput);
+    const int iTail = iNewLen - iAt - 1;
+
+    if ((false == m_bDumbTerminal) && (uSHELL_RENDER_ICH_COST < (iTail + uSHELL_RENDER_BACK_COST(iTail)))) {
+        m_CorePutString("\033[@");
+        m_TransportWrite(m_pstrInput + iAt, 1U);
+    } else {
+        m_RenderTail(iAt, iAt, iNewLen - 1, iAt + 1);
+    }
+} /* m_RenderInsert() */
+
+/*----------------------------------------------------------------------------*/
+/* iCount characters were taken out at iAt, the cursor is at iCursor: the terminal shifts
+   the tail left (ESC [ n P) when that is cheaper than sending the tail, erasing the
+   columns left over and coming back */
+void Microshell::m_RenderDelete(const int iCursor, const int iAt, const int iCount) {
+    const int iTail = (int)strlen(m_pstrInput) - iAt;
+    const int iRedraw = iTail + ((1 == iCount) ? 2 : 3) + uSHELL_RENDER_BACK_COST(iTail);
+
+    m_RenderMove(iCursor, iAt);
+    if ((false == m_bDumbTerminal) && (iTail > 0) && (uSHELL_RENDER_DCH_COST(iCount) < iRedraw)) {
+        if (1 == iCount) {
+            m_CorePutString("\033[P");
+        } else {
+            uSHELL_PRINTF("\033[%dP", iCount);
+        }
+    } else {
+        m_RenderTail(iAt, iAt, iAt + iTail + iCount, iAt);
+    }
+} /* m_RenderDelete() */
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+
+/*----------------------------------------------------------------------------*/
+inline void Microshell::m_RenderColor(const char *pstrColor) {
+    if (false == m_bDumbTerminal) {
+        m_TransportWrite(pstrColor, strlen(pstrColor));
+    }
+} /* m_RenderColor() */
+
+/*----------------------------------------------------------------------------*/
+int Microshell::m_RenderPrintf(const char *pstrFormat, ...) {
+    char vstrPlain[uSHELL_RENDER_FORMAT_SIZE];
+    const char *pstrOutFormat = pstrFormat;
+    va_list args;
+    int iRetVal;
+
+    if ((true == m_bDumbTerminal) && (true == s_RenderStrip(pstrFormat, vstrPlain, sizeof(vstrPlain)))) {
+        pstrOutFormat = vstrPlain;
+    }
+    va_start(args, pstrFormat);
+    iRetVal = uSHELL_VPRINTF(pstrOutFormat, args);
+    va_end(args);
+
+    return iRetVal;
+} /* m_RenderPrintf() */
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+
+/*==============================================================================
+               EDITMODE IMPLEMENTATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE)
+/*----------------------------------------------------------------------------*/
+void Microshell::m_EditMoveCursorDirSteps(const dir_e eDir, const int iSteps) {
+    if (iSteps > 1) {
+        uSHELL_PRINTF("\033[%d%c", iSteps, ((uSHELL_DIR_FORWARD == eDir) ? 'C' : 'D'));
+    } else {
+        uSHELL_PRINTF("\033[%c", ((uSHELL_DIR_FORWARD == eDir) ? 'C' : 'D'));
+    }
+} /*m_EditMoveCursorDirSteps() */
+
+/*----------------------------------------------------------------------------*/
+bool Microshell::m_EditMoveCursor(const dir_e eDir) {
+    if (true == m_bEditMode) {
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        const int iCursor = m_iCursorPos;
+        switch (eDir) {
+        case uSHELL_DIR_FORWARD: {
+            if (m_iCursorPos < m_iInputPos) {
+                ++m_iCursorPos;
+            }
+        } break;
+        case uSHELL_DIR_BACKWARD: {
+            if (m_iCursorPos > 0) {
+                --m_iCursorPos;
+            }
+        } break;
+        case uSHELL_DIR_HOME: {
+            m_iCursorPos = 0;
+        } break;
+        case uSHELL_DIR_END: {
+            m_iCursorPos = m_iInputPos;
+        } break;
+        default:
+            break;
+        }
+        m_RenderMove(iCursor, m_iCursorPos);
+#else
+        switch (eDir) {
+        case uSHELL_DIR_FORWARD: {
+            if ((m_iInputPos <= ((int)(sizeof(m_pstrInput) - 1))) && (m_iCursorPos < m_iInputPos)) {
+                m_EditMoveCursorDirSteps(uSHELL_DIR_FORWARD, 1);
+                ++m_iCursorPos;
+            } else {
+                m_CorePutString("\033[D\033[C");
+            }
+        } break;
+        case uSHELL_DIR_BACKWARD: {
+            if (m_iCursorPos > 0) {
+                m_EditMoveCursorDirSteps(uSHELL_DIR_BACKWARD, 1);
+                --m_iCursorPos;
+            }
+        } break;
+        case uSHELL_DIR_HOME: {
+            if (m_iCursorPos > 0) {
+                m_EditMoveCursorDirSteps(uSHELL_DIR_BACKWARD, m_iCursorPos);
+                m_iCursorPos = 0;
+            }
+        } break;
+        case uSHELL_DIR_END: {
+            if (m_iCursorPos < m_iInputPos) {
+                m_EditMoveCursorDirSteps(uSHELL_DIR_FORWARD, (m_iInputPos - m_iCursorPos));
+                m_iCursorPos = m_iInputPos;
+            }
+        } break;
+        default:
+            break;
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+        return true;
+    }
+    return false;
+} /*m_EditMoveCursor()*/
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_EditDeleteUnderCursor(void) {
+    if ((m_iInputPos > 0) && (m_iInputPos > m_iCursorPos)) {
+        memmove(m_pstrInput + m_iCursorPos, m_pstrInput + m_iCursorPos + 1, (size_t)(m_iInputPos - m_iCursorPos));
+        m_iInputPos--;
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        m_RenderDelete(m_iCursorPos, m_iCursorPos, 1);
+#else
+        if (m_iInputPos - m_iCursorPos > 0) {
+            uSHELL_PRINTF("\033[K%s\033[%dD", (m_pstrInput + m_iCursorPos), (m_iInputPos - m_iCursorPos));
+        } else {
+            uSHELL_PRINTF("\033[K%s", (m_pstrInput + m_iCursorPos));
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+    }
+} /* m_EditDeleteUnderCursor() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_EditDeleteBackward(void) {
+    if (m_iCursorPos > 0) {
+        memmove(m_pstrInput + m_iCursorPos - 1, m_pstrInput + m_iCursorPos, (size_t)(m_iInputPos - m_iCursorPos + 1));
+        --m_iInputPos;
+        --m_iCursorPos;
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        m_RenderDelete(m_iCursorPos + 1, m_iCursorPos, 1);
+#else
+        uSHELL_PRINTF("\033[D \033[D\033[K%s", (m_pstrInput + m_iCursorPos));
+        if (m_iInputPos > m_iCursorPos) {
+            m_EditMoveCursorDirSteps(uSHELL_DIR_BACKWARD, (m_iInputPos - m_iCursorPos));
+        }
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+    }
+} /* m_EditDeleteBackward() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_EditInsertUnderCursor(const char cKeyPressed) {
+    if (m_iInputPos < ((int)(sizeof(m_pstrInput) - 1))) {
+        memmove(m_pstrInput + m_iCursorPos + 1, m_pstrInput + m_iCursorPos, (size_t)(m_iInputPos - m_iCursorPos + 1));
+        *(m_pstrInput + m_iCursorPos++) = cKeyPressed;
+        *(m_pstrInput + ++m_iInputPos) = '\0';
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+        m_RenderInsert(m_iCursorPos - 1);
+#else
+        uSHELL_PRINTF("%s\33[%dD", (m_pstrInput + m_iCursorPos - 1), (m_iInputPos - m_iCursorPos));
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+    }
+} /* m_EditInsertUnderCursor() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_EditDeleteBackwardToHome(void) {
+    if (m_iCursorPos > 0) {
+        int iLen = m_iInputPos - m_iCursorPos;
+        if (iLen > 0) {
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+            const int iOldLen = m_iInputPos;
+            const int iCursor = m_iCursorPos;
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+            memmove(m_pstrInput, m_pstrInput + m_iCursorPos, (size_t)iLen);
+            memset(&m_pstrInput[iLen], 0, m_iCursorPos);
+            m_iCursorPos = 0;
+            m_iInputPos = iLen;
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+            m_RenderDelete(iCursor, 0, iOldLen - iLen);
+#else
+            uSHELL_PRINTF("\r\033[%dC\033[K%s\033[%dD", m_pInst->iPromptLength, m_pstrInput, iLen);
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+        } else {
+            m_CoreCmdLineDelete();
+        }
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplReset((0 == m_iInputPos));
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+    }
+} /* m_EditDeleteBackwardToHome() */
+
+/*----------------------------------------------------------------------------*/
+void Microshell::m_EditDeleteForwardToEnd(void) {
+    int iLen = m_iInputPos - m_iCursorPos;
+    if (iLen > 0) {
+        if (m_iCursorPos > 0) {
+            memset(&m_pstrInput[m_iCursorPos], 0, iLen);
+            m_iInputPos = m_iCursorPos;
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+            m_RenderErase(iLen);
+#else
+            m_CorePutString("\033[K");
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+        } else {
+            m_CoreCmdLineDelete();
+        }
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+        m_AutocomplReset((0 == m_iInputPos));
+#endif /* (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+    }
+} /* m_EditDeleteForwardToEnd() */
+#endif /* (1 == uSHELL_IMPLEMENTS_EDITMODE) */
+
+/*----------------------------------------------------------------------------*/
+#if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
+void Microshell::keydecoder(void) {
+    char cRead;
+    m_CorePutString(":exit:$\n\r");
+    do {
+        if (uSHELL_KEY_ENTER == (cRead = m_TransportGetch())) {
+            uSHELL_PRINTF("%02X\n", uSHELL_KEY_ENTER);
+        } else {
+            uSHELL_PRINTF("%02X|%c ", (unsigned char)cRead, (true == uSHELL_ISPRINT(cRead)) ? cRead : ' ');
+        }
+    } while ('$' != cRead);
+    m_CorePutString(uSHELL_NEWLINE);
+}
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
+
+/*==============================================================================
+            PRIVATE VARIABLES INITIALIZATION
+==============================================================================*/
+
+#if (1 == uSHELL_IMPLEMENTS_SMART_PROMPT)
+#define  uSHELL_PROMPT_TABLE_BEGIN      const char Microshell::m_pstrPromptInfo[uSHELL_PROMPTI_LAST + 1] = ""
+#define  uSHELL_PROMPT_CELL(a, b, c)        #b
+#define  uSHELL_PROMPT_TABLE_END        ;
+#include uSHELL_PROMPT_CONFIG_FILE
+#undef   uSHELL_PROMPT_TABLE_BEGIN
+#undef   uSHELL_PROMPT_CELL
+#undef   uSHELL_PROMPT_TABLE_END
+
+#define  uSHELL_PROMPT_TABLE_BEGIN      const char Microshell::m_pstrPromptInfoEditMode[uSHELL_PROMPTI_LAST + 1] = ""
+#define  uSHELL_PROMPT_CELL(a, b, c)        #c
+#define  uSHELL_PROMPT_TABLE_END        ;
+#include uSHELL_PROMPT_CONFIG_FILE
+#undef   uSHELL_PROMPT_TABLE_BEGIN
+#undef   uSHELL_PROMPT_CELL
+#undef   uSHELL_PROMPT_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_SMART_PROMPT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+#define  uSHELL_DATA_TYPES_TABLE_BEGIN  const char Microshell::m_vstrTypeMarks[uSHELL_TYPE_LAST] = {
+#define  uSHELL_DATA_TYPE(a, b)             b,
+#define  uSHELL_DATA_TYPES_TABLE_END    };
+#include uSHELL_DATA_TYPES_CONFIG_FILE
+#undef   uSHELL_DATA_TYPES_TABLE_BEGIN
+#undef   uSHELL_DATA_TYPE
+#undef   uSHELL_DATA_TYPES_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
+
+#define  uSHELL_DATA_TYPES_TABLE_BEGIN  const char *Microshell::m_vstrTypeNames[uSHELL_TYPE_LAST] = {
+#define  uSHELL_DATA_TYPE(a, b)             #a,
+#define  uSHELL_DATA_TYPES_TABLE_END    };
+#include uSHELL_DATA_TYPES_CONFIG_FILE
+#undef   uSHELL_DATA_TYPES_TABLE_BEGIN
+#undef   uSHELL_DATA_TYPE
+#undef   uSHELL_DATA_TYPES_TABLE_END
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+/* storage of every data type inside command_s: value array, counter, element size, max params, max value */
+#if defined(BIGNUM_T)
+#define  uSHELL_TYPE_DECODER(v, n, t, m, x) { (uint16_t)offsetof(command_s, v), (uint16_t)offsetof(command_s, n), (uint8_t)sizeof(t), (uint8_t)(m), (BIGNUM_T)(x) }
+#define  uSHELL_TYPE_DECODER_VOID           { 0, 0, 0, 0, 0 }
+#else
+#define  uSHELL_TYPE_DECODER(v, n, t, m, x) { (uint16_t)offsetof(command_s, v), (uint16_t)offsetof(command_s, n), (uint8_t)sizeof(t), (uint8_t)(m) }
+#define  uSHELL_TYPE_DECODER_VOID           { 0, 0, 0, 0 }
+#endif /* defined(BIGNUM_T) */
+#define  uSHELL_TYPE_DECODER_8BIT           uSHELL_TYPE_DECODER(vb, iNrNums8,     num8_t,  uSHELL_MAX_PARAMS_NUM8,    uSHELL_MAX_VALUE_8BIT)
+#define  uSHELL_TYPE_DECODER_16BIT          uSHELL_TYPE_DECODER(vw, iNrNums16,    num16_t, uSHELL_MAX_PARAMS_NUM16,   uSHELL_MAX_VALUE_16BIT)
+#define  uSHELL_TYPE_DECODER_32BIT          uSHELL_TYPE_DECODER(vi, iNrNums32,    num32_t, uSHELL_MAX_PARAMS_NUM32,   uSHELL_MAX_VALUE_32BIT)
+#define  uSHELL_TYPE_DECODER_64BIT          uSHELL_TYPE_DECODER(vl, iNrNums64,    num64_t, uSHELL_MAX_PARAMS_NUM64,   uSHELL_MAX_VALUE_64BIT)
+#define  uSHELL_TYPE_DECODER_FLOAT          uSHELL_TYPE_DECODER(vf, iNrNumsFloat, numfp_t, uSHELL_MAX_PARAMS_FLOAT,   0)
+#define  uSHELL_TYPE_DECODER_FIXED          uSHELL_TYPE_DECODER(vq, iNrNumsFixed, numq_t,  uSHELL_MAX_PARAMS_FIXED,   0xFFFFFFFFU)
+#define  uSHELL_TYPE_DECODER_STRING         uSHELL_TYPE_DECODER(vs, iNrStrings,   str_t*,  uSHELL_MAX_PARAMS_STRING,  0)
+#define  uSHELL_TYPE_DECODER_BOOL           uSHELL_TYPE_DECODER(vo, iNrBools,     bool,    uSHELL_MAX_PARAMS_BOOLEAN, uSHELL_MAX_VALUE_BOOLEAN)
+#define  uSHELL_TYPE_DECODER_VIEW           uSHELL_TYPE_DECODER(vr, iNrViews,     strview_s, uSHELL_MAX_PARAMS_VIEW,  0)
+#define  uSHELL_TYPE_DECODER_ARRAY          uSHELL_TYPE_DECODER(va, iNrArrays,    numarray_s, 1,                      uSHELL_MAX_VALUE_32BIT)
+#define  uSHELL_TYPE_DECODER_HEXBUF         uSHELL_TYPE_DECODER(vx, iNrHexBufs,   hexbuf_s, uSHELL_MAX_PARAMS_HEX,    0)
+
+#define  uSHELL_DATA_TYPES_TABLE_BEGIN  const typeDecoder_s Microshell::m_vsTypeDecoders[uSHELL_TYPE_LAST] = {
+#define  uSHELL_DATA_TYPE(a, b)             uSHELL_TYPE_DECODER_##a,
+#define  uSHELL_DATA_TYPES_TABLE_END    };
+#include uSHELL_DATA_TYPES_CONFIG_FILE
+#undef   uSHELL_DATA_TYPES_TABLE_BEGIN
+#undef   uSHELL_DATA_TYPE
+#undef   uSHELL_DATA_TYPES_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+
+/* packed by the compiler with the help texts (uSHELL_IMPLEMENTS_PACKED_HELP) */
+static constexpr char s_vstrCoreShortcutCaption[] = "\t##|#|i|s : info short|all|i|substr s\n\r"
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+                                                     "\t#q : quit\n\r"
+#endif /* (1 == uSHELL_IMPLEMENTS_SHELL_EXIT) */
+#if (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO)
+                                                     "\t#E|e : echo on|off\n\r"
+#endif /* (1 == uSHELL_IMPLEMENTS_DISABLE_ECHO) */
+#if (1 == uSHELL_IMPLEMENTS_MACHINE_MODE)
+                                                     "\t#M|m : machine interface on|off\n\r"
+#endif /* (1 == uSHELL_IMPLEMENTS_MACHINE_MODE) */
+#if (1 == uSHELL_IMPLEMENTS_DELTA_RENDER)
+                                                     "\t#T|t : terminal ansi|dumb\n\r"
+#endif /* (1 == uSHELL_IMPLEMENTS_DELTA_RENDER) */
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+                                                     "\t#b : binary frames mode\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_BINARY_MODE) */
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+                                                     "\t#p|P : commands stats|and reset\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS) */
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+                                                     "\t#r|r s : scripts list|run s\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS) */
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+                                                     "\t#A|a : autocomplete on|off\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE) */
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+                                                     "\t#H|h|l|L|c|i : history on|off|list|load|clear|exec i\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY) */
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+#if (1 == uSHELL_SUPPORTS_SPACED_STRINGS)
+                                                     "\t#sD : set string delimiter set D|reset; default \"\n\r"
+#endif /*defined(uSHELL_IMPLEMENTS_STRINGS)*/
+#endif /*(1 == uSHELL_SUPPORTS_SPACED_STRINGS)*/
+#if (1 == uSHELL_IMPLEMENTS_KEY_DECODER)
+                                                     "\t#k : keydecoder\n\r"
+#endif /*(1 == uSHELL_IMPLEMENTS_KEY_DECODER)*/
+    ;
+#if (1 == uSHELL_IMPLEMENTS_PACKED_HELP)
+static constexpr auto s_sCoreShortcutCaption = ushell_info_pack<ushell_info_packed_size(s_vstrCoreShortcutCaption)>(s_vstrCoreShortcutCaption);
+const char *Microshell::m_pstrCoreShortcutCaption = s_sCoreShortcutCaption.vstrPacked;
+#else
+const char *Microshell::m_pstrCoreShortcutCaption = s_vstrCoreShortcutCaption;
+#endif /*(1 == uSHELL_IMPLEMENTS_PACKED_HELP)*/
+
+uSHELL_NAMESPACE_END
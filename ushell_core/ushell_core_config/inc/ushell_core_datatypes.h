@@ -0,0 +1,435 @@
+#ifndef USHELL_CORE_DATATYPES_H
+#define USHELL_CORE_DATATYPES_H
+
+/* disable warning like: padding added after data member */
+#ifdef _MSC_VER
+#pragma warning(disable : 4820)
+#endif
+
+#include "ushell_core_settings.h"
+
+#include <cstddef>
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+#include <cstdio>
+#endif /*(1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)*/
+
+/* the core built for a feature profile (uSHELL_PROFILE_FILE) is put in the namespace uSHELL_NAMESPACE,
+   so that shells of different profiles link side by side; the handlers and the views stay global */
+#if defined(uSHELL_NAMESPACE)
+#define  uSHELL_NAMESPACE_BEGIN             namespace uSHELL_NAMESPACE {
+#define  uSHELL_NAMESPACE_END               }
+#define  uSHELL_NAMESPACE_USE               using namespace uSHELL_NAMESPACE;
+#else
+#define  uSHELL_NAMESPACE_BEGIN
+#define  uSHELL_NAMESPACE_END
+#define  uSHELL_NAMESPACE_USE
+#endif /* defined(uSHELL_NAMESPACE) */
+
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+/** \brief read-only view into the parsed buffer (not NUL terminated) */
+typedef struct {
+    const char *pstr;
+    size_t      szLen;
+} strview_s;
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+/** \brief values of the array parameter, valid until the command returns (an async job copies them) */
+typedef struct {
+    const num32_t *pu32Items;
+    size_t         szCount;
+} numarray_s;
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+/** \brief bytes of a hex parameter, decoded in place over its digits in the parsed buffer */
+typedef struct {
+    uint8_t *pu8Data;
+    size_t   szLen;
+} hexbuf_s;
+#endif /* defined(uSHELL_IMPLEMENTS_HEX_BUFFERS) */
+
+uSHELL_NAMESPACE_BEGIN
+
+#define  uSHELL_DATA_TYPES_TABLE_BEGIN      typedef enum dataType_e_ {
+#define  uSHELL_DATA_TYPE(a, b)                 uSHELL_DATA_TYPE_##a,
+#define  uSHELL_DATA_TYPES_TABLE_END        uSHELL_DATA_TYPE_LAST } dataType_e;
+#include uSHELL_DATA_TYPES_CONFIG_FILE
+#undef   uSHELL_DATA_TYPES_TABLE_BEGIN
+#undef   uSHELL_DATA_TYPE
+#undef   uSHELL_DATA_TYPES_TABLE_END
+
+/** \brief microshell core errors */
+enum {
+    uSHELL_ERR_OK                        =  0,
+    uSHELL_ERR_ITEM_NOT_FOUND            = -1,
+    uSHELL_ERR_FUNCTION_NOT_FOUND        = -2,
+    uSHELL_ERR_WRONG_NUMBER_ARGS         = -3,
+    uSHELL_ERR_PARAM_TYPE_NOT_IMPLEM     = -4,
+    uSHELL_ERR_PARAMS_PATTERN_NOT_IMPLEM = -5,
+    uSHELL_ERR_STRING_NOT_CLOSED         = -6,
+    uSHELL_ERR_TOO_MANY_ARGS             = -7,
+    uSHELL_ERR_INVALID_NUMBER            = -8,
+    uSHELL_ERR_VALUE_TOO_BIG             = -9,
+    uSHELL_ERR_INVALID_FRAME             = -10,
+    uSHELL_ERR_LINE_TOO_LONG             = -11,
+    uSHELL_ERR_PENDING                   = -12,  /* not an error: the command completes later (async) */
+    uSHELL_ERR_LAST
+};
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+typedef enum {
+    uSHELL_DEINIT_RESET = 0,
+    uSHELL_DEINIT_FULL,
+    uSHELL_DEINIT_PARTIAL,
+    uSHELL_DEINIT_LAST
+} deinit_e;
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY)*/
+
+#if (1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+typedef enum {
+    uSHELL_DIR_BACKWARD = 0,
+    uSHELL_DIR_FORWARD,
+    uSHELL_DIR_HOME,
+    uSHELL_DIR_END,
+    uSHELL_DIR_LAST
+} dir_e;
+#endif /*(1 == uSHELL_IMPLEMENTS_EDITMODE) || (1 == uSHELL_IMPLEMENTS_HISTORY) || (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY)
+typedef struct {
+    char *pDataBuffer;       // Buffer pointer
+    size_t szDataBufferSize; // Buffer capacity
+    size_t szDataHeadPos;    // Next write position
+    size_t szOldestEntryPos; // Oldest entry position
+    size_t szEntryCount;     // Number of entries
+    size_t szCurrentIndex;   // Navigation position
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_INDEX)
+    uint16_t *pu16EntryIndex; // Entries positions ring
+    size_t szIndexCapacity;   // Index slots
+    size_t szIndexFirst;      // Slot of the oldest entry
+    size_t szUsedBytes;       // Bytes taken by the entries
+#endif
+#if (1 == uSHELL_IMPLEMENTS_SAVE_HISTORY)
+    char *pstrFilePath;
+    bool bAutoSave;
+#endif
+} history_s;
+
+typedef struct {
+    const history_s *pHistory;
+    size_t szIndex;
+} historyIter_s;
+#endif /* (1 == uSHELL_IMPLEMENTS_HISTORY) */
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+/** \brief values offered for a parameter: the iIndex-th one, nullptr after the last */
+typedef const char *(*PFCOMPL)(int iIndex);
+
+/** \brief parameter of a command (or shortcut, i.e. "#r") completed from a values provider */
+typedef struct {
+    const char    *const pstrName;
+    const int      iParam;       /* 0 based, in the order of the parameters pattern */
+    const PFCOMPL  pfValues;
+} completion_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+
+#if (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+#if (0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+/** \brief words of the candidates set of a table of iNrFunctions commands, one bit per command */
+#define uSHELL_AUTOCOMPL_SET_WORDS(n)   (((n) + 31) / 32)
+#endif /*(0 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)*/
+typedef struct {
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+    PFCOMPL pfValues;        /* not nullptr while a parameter is completed */
+    int  iArgStart;          /* position of the parameter in the input, 0 for the command names */
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+    int  iFirstElem;         /* the candidates are the sorted names [iFirstElem, iFirstElem + iNrCrtElems) */
+#endif /*(1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)*/
+    int  iNrCrtElems;
+    int  iSearchPos;
+    int  iSavedSearchPos;
+    int  iSearchIndex;
+    char cPrevKey;
+    char cCrtKey;
+    bool bFirstFilter;
+    bool bFoundExactMatch;
+    bool bEnabled;
+} autocomplete_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)
+/** \brief escape sequence on its way through the trie */
+typedef struct {
+    uint8_t u8Node;          /* trie node of the bytes received, 0 right after the introducer */
+    bool bActive;            /* the introducer was received */
+    bool bCsi;               /* ESC [ : an unknown sequence is skipped up to its final byte */
+    bool bSkip;              /* inside such an unknown sequence */
+} escapeDecoder_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_ESCAPE_DECODER)*/
+
+/* parsing storage structure */
+typedef struct {
+    const char*  pstrFctName;
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)             /* 64 bit -> 'l' ([l]ong) */
+    num64_t      vl[uSHELL_MAX_PARAMS_NUM64];
+    unsigned int iNrNums64;
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)             /* 32 bit -> 'i' ([i]nteger) */
+    num32_t      vi[uSHELL_MAX_PARAMS_NUM32];
+    unsigned int iNrNums32;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)             /* 16 bit -> 'w' ([w]ord) */
+    num16_t      vw[uSHELL_MAX_PARAMS_NUM16];
+    unsigned int iNrNums16;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT) */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)              /* 8 bit -> 'b' ([b]yte) */
+    num8_t       vb[uSHELL_MAX_PARAMS_NUM8];
+    unsigned int iNrNums8;
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT) */
+#ifdef uSHELL_IMPLEMENTS_NUMBERS_FLOAT                   /* float /double -> 'f' ([f]loat) */
+    numfp_t      vf[uSHELL_MAX_PARAMS_FLOAT];
+    unsigned int iNrNumsFloat;
+#endif /* uSHELL_IMPLEMENTS_NUMBERS_FLOAT */
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)             /* Q(31-F).F -> 'q' ([q] format) */
+    numq_t       vq[uSHELL_MAX_PARAMS_FIXED];
+    unsigned int iNrNumsFixed;
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED) */
+#if defined(uSHELL_IMPLEMENTS_STRINGS)                   /* char* -> 's' ([s]tring) */
+    str_t*       vs[uSHELL_MAX_PARAMS_STRING];
+    unsigned int iNrStrings;
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+#if defined(uSHELL_IMPLEMENTS_BOOLEAN)                   /* bool -> 'o' (b[o]ol) */
+    bool         vo[uSHELL_MAX_PARAMS_BOOLEAN];
+    unsigned int iNrBools;
+#endif /*defined(uSHELL_IMPLEMENTS_BOOLEAN)*/
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)              /* {ptr,len} -> 'r' ([r]ange) */
+    strview_s    vr[uSHELL_MAX_PARAMS_VIEW];
+    unsigned int iNrViews;
+#endif /*defined(uSHELL_IMPLEMENTS_STRING_VIEWS)*/
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)              /* {ptr,count} -> 'a' ([a]rray), the last parameter */
+    numarray_s   va[1];
+    unsigned int iNrArrays;
+    num32_t      vu32Items[uSHELL_MAX_ARRAY_ITEMS];   /* the values va[0] points to */
+#endif /*defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)*/
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)               /* {ptr,len} -> 'x' (he[x] bytes) */
+    hexbuf_s     vx[uSHELL_MAX_PARAMS_HEX];
+    unsigned int iNrHexBufs;
+#endif /*defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)*/
+    int         iFctIndex;
+    int         iTypIndex;
+    int         iErrorInfo;
+    dataType_e  eDataType;
+} command_s;
+
+#if (1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS)
+/** \brief a command parsed once (Microshell::Prepare), its strings and views point into the copy of the line it holds */
+typedef struct {
+    char      vstrLine[uSHELL_MAX_INPUT_BUF_LEN];
+    command_s sCmd;
+} preparedCmd_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_PREPARED_COMMANDS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_LOOPS)
+/** \brief body of a repeat / for parsed once: the steps point into the copy of the body, the loop variable
+    is stored at every turn into the parameter slots marked in vu32VarSlots (bit n: parameter n) */
+typedef struct {
+    char      vstrBody[uSHELL_MAX_INPUT_BUF_LEN];
+    command_s vsSteps[uSHELL_LOOP_MAX_STEPS];
+    uint32_t  vu32VarSlots[uSHELL_LOOP_MAX_STEPS];
+    int       iNrSteps;
+} loopBody_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_LOOPS)*/
+
+typedef struct {
+    const char* const pstrFctName;
+    const char* const pstrFuncParamDef;
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+    const uint8_t     u8ParamsPattern;   /* index in the params decoder array */
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+} fctDef_s;
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+#define uSHELL_MAX_PARAMS_TOTAL (uSHELL_MAX_PARAMS_NUM64 + uSHELL_MAX_PARAMS_NUM32 + uSHELL_MAX_PARAMS_NUM16 + uSHELL_MAX_PARAMS_NUM8 + \
+                                 uSHELL_MAX_PARAMS_FLOAT + uSHELL_MAX_PARAMS_FIXED + uSHELL_MAX_PARAMS_STRING + \
+                                 uSHELL_MAX_PARAMS_BOOLEAN + uSHELL_MAX_PARAMS_VIEW + uSHELL_MAX_PARAMS_HEX)
+
+/** \brief parameters pattern decoded at build time (0 params <==> void) */
+typedef struct {
+    uint8_t u8NrParams;
+    uint8_t vu8Types[uSHELL_MAX_PARAMS_TOTAL];   /* dataType_e of every slot */
+} paramsDecoder_s;
+
+/** \brief location and limits of the storage used by a data type inside command_s */
+typedef struct {
+    uint16_t u16ValOffset;
+    uint16_t u16CntOffset;
+    uint8_t  u8ValSize;
+    uint8_t  u8MaxParams;
+#if defined(BIGNUM_T)
+    BIGNUM_T maxValue;
+#endif /* defined(BIGNUM_T) */
+} typeDecoder_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+
+/** \brief command execution function pointer */
+typedef int (*PFEXEC)(const command_s *psCmd);
+
+/** \brief shortcut execution function pointer */
+typedef void (*PFSHORTCUT)(const char *pstrArgs);
+
+#if (1 == uSHELL_IMPLEMENTS_TRANSPORT)
+#define uSHELL_TRANSPORT_WAIT_FOREVER   (0xFFFFFFFFU)
+
+/** \brief console backend of an instance (UART, USB-CDC, RTT, semihosting ...)
+    pfRead returns the number of bytes read (less than szLen at timeout),
+    pfReadLine follows the uSHELL_GETLINE contract and may be nullptr */
+typedef struct {
+    int  (*pfRead)(uint8_t *pu8Buf, const size_t szLen, const uint32_t u32TimeoutMs);
+    void (*pfWrite)(const uint8_t *pu8Buf, const size_t szLen);
+    int  (*pfReadLine)(char *pstrBuf, const int iMaxLen);
+} uShellTransport_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_TRANSPORT)*/
+
+#if (1 == uSHELL_IMPLEMENTS_HISTORY_STORE)
+/** \brief persistent history backend of an instance (flash log, EEPROM ...)
+    pfNext copies the entry after *pu32Cursor (0 starts with the oldest) and returns its length, 0 at the end,
+    pfAppend queues an entry and must not block, pfClear drops the stored entries */
+typedef struct {
+    size_t (*pfNext)(uint32_t *pu32Cursor, char *pstrBuf, const size_t szSize);
+    void   (*pfAppend)(const char *pstrEntry, const size_t szLen);
+    void   (*pfClear)(void);
+} uShellHistoryStore_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_HISTORY_STORE)*/
+
+/** \brief structure with the shortcut mapping */
+typedef struct {
+    char cSymbol;
+    PFSHORTCUT pfShortcut;
+} shortcut_s;
+
+#define uSHELL_SHORTCUT_FREE            (-1)    /* a shortcut symbol with nothing registered */
+
+#if (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+#define uSHELL_SHORTCUT_TABLE_FIRST     (0x20)  /* the table covers 0x20 .. 0x7F */
+#define uSHELL_SHORTCUT_TABLE_SIZE      (96)
+
+/** \brief symbol of a shortcut, as generated from the shortcuts table */
+typedef struct {
+    char cSymbol;
+    bool bHot;
+} shortcutKey_s;
+
+/** \brief direct lookup of the shortcuts, indexed by the symbol (generated by the compiler) */
+typedef struct {
+    int8_t   vi8Slots[uSHELL_SHORTCUT_TABLE_SIZE];              /* index into psShortcutsArray or uSHELL_SHORTCUT_FREE */
+    uint32_t vu32Hot[uSHELL_SHORTCUT_TABLE_SIZE / 32];          /* run on the key, typed on an empty line */
+    bool     bValid;                                            /* false: a symbol is taken twice or is not a shortcut symbol */
+} shortcutTable_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)*/
+
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+/** \brief precompiled script: length prefixed binary frames ended by a 0 length */
+typedef struct {
+    const char    *const pstrScriptName;
+    const char    *const pstrScriptInfo;
+    const uint8_t *const pu8Code;
+} script_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)
+/** \brief completion of a pending command, queued by the task which ran it */
+typedef struct {
+    int         iTicket;
+    int         iRetVal;
+    const char *pstrOutput;   /* optional, must stay valid until reported */
+} asyncDone_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS)*/
+
+#if ((1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) && (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS))
+/** \brief sequence tag of a tagged machine line whose command is still pending */
+typedef struct {
+    int      iTicket;         /* 0: free */
+    uint32_t u32Seq;
+} machineTag_s;
+#endif /*((1 == uSHELL_IMPLEMENTS_MACHINE_TAGS) && (1 == uSHELL_IMPLEMENTS_ASYNC_COMMANDS))*/
+
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+/** \brief execution statistics of a command, parallel to the commands array;
+    the parse time covers the tokenizing and decoding of the arguments, the handler time the pfExec call */
+typedef struct {
+    uint32_t    u32Calls;
+    uint32_t    u32Errors;
+    uint64_t    u64ParseCycles;
+    uint64_t    u64ExecCycles;
+    uint32_t    u32ParseMax;
+    uint32_t    u32ExecMax;
+} cmdStats_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+/** \brief scratch arena of the handlers, szUsed goes back to 0 after every command */
+typedef struct {
+    uint8_t    *pu8Base;
+    size_t      szSize;
+    size_t      szUsed;
+    size_t      szPeak;
+} scratchArena_s;
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)*/
+
+/** \brief main structure */
+typedef struct {
+    const fctDef_s         *const psFuncDefArray;
+    shortcut_s             *psShortcutsArray;
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_HELP)
+    const char* const*      ppstrInfoArray;
+#if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
+    const char* const*      ppstrShortcutsInfoArray;
+#endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_HELP)*/
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+    const int16_t          *const piSortedIndexArray;
+#elif (1 == uSHELL_IMPLEMENTS_AUTOCOMPLETE)
+    uint32_t               *pu32AutocompleteSet;    /* the candidates, bit i of word i / 32 the command i */
+#endif /* (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+#if (1 == uSHELL_IMPLEMENTS_SHELL_EXIT)
+    bool                    bKeepRuning;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHELL_EXIT)*/
+    const int               iNrFunctions;
+    const int               iNrShortcuts;
+#if (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+    const shortcutTable_s  *const psShortcutTable;
+#endif /*(1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)*/
+#if (1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)
+    const int16_t          *const piFuncHashTable;
+    const int               iFuncHashTableSize;
+#endif /*(1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)*/
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+    const paramsDecoder_s  *const psParamsDecoderArray;
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)*/
+#if (1 == uSHELL_IMPLEMENTS_SCRIPTS)
+    const script_s         *const psScriptsArray;
+    const int               iNrScripts;
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRIPTS)*/
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+    const completion_s     *const psCompletionsArray;
+    const int               iNrCompletions;
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+#if (1 == uSHELL_IMPLEMENTS_COMMAND_STATS)
+    cmdStats_s             *psCmdStatsArray;
+#endif /*(1 == uSHELL_IMPLEMENTS_COMMAND_STATS)*/
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+    scratchArena_s         *psScratchArena;
+#endif /*(1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)*/
+    PFEXEC                  pfExec;
+    char                    vstrPrompt[uSHELL_PROMPT_MAX_LEN];
+    int                     iPromptLength;
+} uShellInst_s;
+
+uSHELL_NAMESPACE_END
+uSHELL_NAMESPACE_USE
+
+uShellInst_s *pluginEntry(void);
+
+#endif /* USHELL_CORE_DATATYPES_H */
\ No newline at end of file
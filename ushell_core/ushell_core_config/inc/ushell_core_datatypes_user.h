@@ -3,16 +3,35 @@
 
 #include "ushell_core_settings.h"
 
+/* linkage of the handlers and the values providers, extern "C" where the tree defines them so */
+#if !defined(uSHELL_USER_LINKAGE)
+#define  uSHELL_USER_LINKAGE                        extern
+#endif /*!defined(uSHELL_USER_LINKAGE)*/
+
 #if (1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)
 #define  uSHELL_USER_SHORTCUTS_TABLE_BEGIN
 #define  uSHELL_USER_SHORTCUT(a,b,c)                void uShellUserHandleShortcut_##b( const char *pstrArgs );
+#define  uSHELL_USER_HOT_SHORTCUT(a,b,c)            void uShellUserHandleShortcut_##b( const char *pstrArgs );
 #define  uSHELL_USER_SHORTCUTS_TABLE_END
 #include uSHELL_USER_SHORTCUTS_CONFIG_FILE
 #undef   uSHELL_USER_SHORTCUTS_TABLE_BEGIN
 #undef   uSHELL_USER_SHORTCUT
+#undef   uSHELL_USER_HOT_SHORTCUT
 #undef   uSHELL_USER_SHORTCUTS_TABLE_END
 #endif /*(1 == uSHELL_IMPLEMENTS_USER_SHORTCUTS)*/
 
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)
+#define  uSHELL_COMPLETIONS_TABLE_BEGIN
+#define  uSHELL_COMPLETION_LIST(a,b,...)
+#define  uSHELL_COMPLETION_FUNC(a,b,c)              uSHELL_USER_LINKAGE const char *c(int iIndex);
+#define  uSHELL_COMPLETIONS_TABLE_END
+#include uSHELL_COMPLETIONS_CONFIG_FILE             /* values providers prototypes */
+#undef   uSHELL_COMPLETIONS_TABLE_BEGIN
+#undef   uSHELL_COMPLETION_LIST
+#undef   uSHELL_COMPLETION_FUNC
+#undef   uSHELL_COMPLETIONS_TABLE_END
+#endif /*(1 == uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL)*/
+
 #define  uSHELL_COMMANDS_TABLE_BEGIN
 #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
 #define  uSHELL_COMMAND(a,b,c)
@@ -25,7 +44,7 @@
 #undef   uSHELL_COMMAND
 #undef   uSHELL_COMMAND_PARAMS_PATTERN
 #define  uSHELL_COMMAND_PARAMS_PATTERN(t)
-#define  uSHELL_COMMAND(a,b,c)                      extern int a(b##_params);
+#define  uSHELL_COMMAND(a,b,c)                      uSHELL_USER_LINKAGE int a(b##_params);
 #include uSHELL_COMMANDS_CONFIG_FILE                /* functions's prototypes */
 #undef   uSHELL_COMMANDS_TABLE_BEGIN
 #undef   uSHELL_COMMAND_PARAMS_PATTERN
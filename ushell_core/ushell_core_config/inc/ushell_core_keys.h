@@ -11,6 +11,7 @@
 #define uSHELL_KEY_ESCAPE                    (0x1B)
 #define uSHELL_KEY_CTRL_U                    (0x15)
 #define uSHELL_KEY_CTRL_K                    (0x0B)
+#define uSHELL_KEY_CTRL_R                    (0x12)
 #define uSHELL_KEY_QUOTATION_MARK            '"'
 
 /*key codes specific to the build environment */
@@ -49,6 +50,20 @@
     #define uSHELL_KEY_ESCAPESEQ_ARROW_LEFT  (0x44) /* 0x1B5B44     \033 [ D */
 #endif
 
+/* keys decoded from the escape sequences (ushell_core_escape.cfg) */
+#define uSHELL_ESCKEY_NONE                   (0)
+#define uSHELL_ESCKEY_UP                     (1)
+#define uSHELL_ESCKEY_DOWN                   (2)
+#define uSHELL_ESCKEY_RIGHT                  (3)
+#define uSHELL_ESCKEY_LEFT                   (4)
+#define uSHELL_ESCKEY_HOME                   (5)
+#define uSHELL_ESCKEY_END                    (6)
+#define uSHELL_ESCKEY_INSERT                 (7)
+#define uSHELL_ESCKEY_DELETE                 (8)
+#define uSHELL_ESCKEY_PAGEUP                 (9)
+#define uSHELL_ESCKEY_PAGEDOWN               (10)
+#define uSHELL_ESCKEY_SHIFTTAB               (11)
+
 /* the ENTER key */
 #if (defined(__MINGW32__) || defined(_MSC_VER)) || defined(SERIAL_TERMINAL) /* i.e MinGW or Microsoft VisualStudio for Windows console */
     #define uSHELL_KEY_ENTER                 (0x0D)
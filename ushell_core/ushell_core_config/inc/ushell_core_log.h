@@ -0,0 +1,164 @@
+#ifndef USHELL_CORE_LOG_H
+#define USHELL_CORE_LOG_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_printout.h"
+
+#include <stdint.h>
+
+/*
+ * Leveled log lines for the C++ code of the application (callbacks, driver error paths),
+ * the levels of the LogLevel of the Rust shell:
+ *
+ *     uSHELL_LOG_WARN("LCD queue full, row %d", row);     ->  "[ WARN] LCD queue full, row 1\n"
+ *
+ * Filtered twice:
+ *  - at compile time, the levels above uSHELL_LOG_LEVEL_MAX expand to nothing, their
+ *    arguments are not evaluated
+ *  - at run time, the levels above uShellLog::SetLevel() (uSHELL_LOG_LEVEL_DEFAULT at start)
+ *    cost a load and a compare
+ *
+ * Every call site has its own rate limit: at most uSHELL_LOG_BURST lines in a window of
+ * uSHELL_LOG_WINDOW_MS, the rest is counted and reported by the first line of the next
+ * window ("[ WARN] 37 lines suppressed"). The clock is uSHELL_LOG_TICK_MS(), expanded at the
+ * call site (the RTOS header is the caller's); without it there is no limit. The counters of
+ * a site are not locked: two tasks logging from the same site at once may let a line more
+ * through, never less.
+ *
+ * A line is one uSHELL_PRINTF() call: the label, the format and uSHELL_LOG_EOL are joined
+ * at compile time, so the format must be a string literal.
+ */
+
+#define uSHELL_LOG_LEVEL_NONE       0
+#define uSHELL_LOG_LEVEL_ERROR      1
+#define uSHELL_LOG_LEVEL_WARN       2
+#define uSHELL_LOG_LEVEL_INFO       3
+#define uSHELL_LOG_LEVEL_DEBUG      4
+#define uSHELL_LOG_LEVEL_VERBOSE    5
+#define uSHELL_LOG_LEVEL_TRACE      6
+
+#ifndef uSHELL_LOG_LEVEL_MAX
+#define uSHELL_LOG_LEVEL_MAX        uSHELL_LOG_LEVEL_DEBUG
+#endif /* uSHELL_LOG_LEVEL_MAX */
+
+#ifndef uSHELL_LOG_LEVEL_DEFAULT
+#define uSHELL_LOG_LEVEL_DEFAULT    uSHELL_LOG_LEVEL_INFO
+#endif /* uSHELL_LOG_LEVEL_DEFAULT */
+
+#ifndef uSHELL_LOG_BURST
+#define uSHELL_LOG_BURST            (5U)
+#endif /* uSHELL_LOG_BURST */
+
+#ifndef uSHELL_LOG_WINDOW_MS
+#define uSHELL_LOG_WINDOW_MS        (1000U)
+#endif /* uSHELL_LOG_WINDOW_MS */
+
+#ifndef uSHELL_LOG_EOL
+#define uSHELL_LOG_EOL              "\n"
+#endif /* uSHELL_LOG_EOL */
+
+#define uSHELL_LOG_TAG_(color, label)   color "[" label "]" uSHELL_RESET_COLOR " "
+
+/* the state of one call site, zero initialised */
+typedef struct {
+    uint32_t u32WindowMs;   /* start of the current window */
+    uint16_t u16Lines;      /* printed in it */
+    uint16_t u16Dropped;    /* suppressed in it, reported by the next window */
+} uShellLogSite_s;
+
+class uShellLog {
+public:
+    /* one for the image: the static of an inline function (C++11, no inline variable) */
+    static volatile uint8_t &Level(void) {
+        static volatile uint8_t u8Level = uSHELL_LOG_LEVEL_DEFAULT;
+        return u8Level;
+    }
+
+    /* at most uSHELL_LOG_LEVEL_MAX, the levels above are not in the image */
+    static void SetLevel(uint8_t u8NewLevel) {
+        Level() = (u8NewLevel > uSHELL_LOG_LEVEL_MAX) ? (uint8_t)uSHELL_LOG_LEVEL_MAX : u8NewLevel;
+    }
+
+    static const char *Name(uint8_t u8Lvl) {
+        static const char *const vpstrNames[] = { "none", "error", "warn", "info", "debug", "verbose", "trace" };
+        return (u8Lvl <= uSHELL_LOG_LEVEL_TRACE) ? vpstrNames[u8Lvl] : "?";
+    }
+
+    /* -1: the line is suppressed, else the lines suppressed before it to report */
+    static int32_t Admit(uShellLogSite_s *psSite, uint32_t u32NowMs) {
+        if ((uint32_t)(u32NowMs - psSite->u32WindowMs) >= uSHELL_LOG_WINDOW_MS) {
+            const int32_t i32Dropped = psSite->u16Dropped;
+            psSite->u32WindowMs = u32NowMs;
+            psSite->u16Lines    = 1U;
+            psSite->u16Dropped  = 0U;
+            return i32Dropped;
+        }
+        if (psSite->u16Lines < uSHELL_LOG_BURST) {
+            psSite->u16Lines++;
+            return 0;
+        }
+        if (psSite->u16Dropped < UINT16_MAX) {
+            psSite->u16Dropped++;
+        }
+        return -1;
+    }
+};
+
+#if defined(uSHELL_LOG_TICK_MS)
+#define uSHELL_LOG_AT_(lvl, tag, fmt, ...)                                                          \
+    do {                                                                                            \
+        if ((lvl) <= uShellLog::Level()) {                                                          \
+            static uShellLogSite_s s_sLogSite_;                                                     \
+            const uint32_t u32NowMs_ = (uint32_t)uSHELL_LOG_TICK_MS();                              \
+            const int32_t i32Dropped_ = uShellLog::Admit(&s_sLogSite_, u32NowMs_);                  \
+            if (i32Dropped_ > 0) {                                                                  \
+                uSHELL_PRINTF(tag "%d lines suppressed" uSHELL_LOG_EOL, (int)i32Dropped_);          \
+            }                                                                                       \
+            if (i32Dropped_ >= 0) {                                                                 \
+                uSHELL_PRINTF(tag fmt uSHELL_LOG_EOL, ##__VA_ARGS__);                               \
+            }                                                                                       \
+        }                                                                                           \
+    } while (0)
+#else
+#define uSHELL_LOG_AT_(lvl, tag, fmt, ...)                                                          \
+    do {                                                                                            \
+        if ((lvl) <= uShellLog::Level()) {                                                          \
+            uSHELL_PRINTF(tag fmt uSHELL_LOG_EOL, ##__VA_ARGS__);                                   \
+        }                                                                                           \
+    } while (0)
+#endif /* defined(uSHELL_LOG_TICK_MS) */
+
+#define uSHELL_LOG_OFF_(...)        do { } while (0)
+
+#if (uSHELL_LOG_LEVEL_MAX >= uSHELL_LOG_LEVEL_ERROR)
+#define uSHELL_LOG_ERROR(fmt, ...)      uSHELL_LOG_AT_(uSHELL_LOG_LEVEL_ERROR, uSHELL_LOG_TAG_(uSHELL_ERROR_COLOR, "ERROR"), fmt, ##__VA_ARGS__)
+#else
+#define uSHELL_LOG_ERROR(...)           uSHELL_LOG_OFF_()
+#endif
+#if (uSHELL_LOG_LEVEL_MAX >= uSHELL_LOG_LEVEL_WARN)
+#define uSHELL_LOG_WARN(fmt, ...)       uSHELL_LOG_AT_(uSHELL_LOG_LEVEL_WARN, uSHELL_LOG_TAG_(uSHELL_WARNING_COLOR, " WARN"), fmt, ##__VA_ARGS__)
+#else
+#define uSHELL_LOG_WARN(...)            uSHELL_LOG_OFF_()
+#endif
+#if (uSHELL_LOG_LEVEL_MAX >= uSHELL_LOG_LEVEL_INFO)
+#define uSHELL_LOG_INFO(fmt, ...)       uSHELL_LOG_AT_(uSHELL_LOG_LEVEL_INFO, uSHELL_LOG_TAG_(uSHELL_SUCCESS_COLOR, " INFO"), fmt, ##__VA_ARGS__)
+#else
+#define uSHELL_LOG_INFO(...)            uSHELL_LOG_OFF_()
+#endif
+#if (uSHELL_LOG_LEVEL_MAX >= uSHELL_LOG_LEVEL_DEBUG)
+#define uSHELL_LOG_DEBUG(fmt, ...)      uSHELL_LOG_AT_(uSHELL_LOG_LEVEL_DEBUG, uSHELL_LOG_TAG_(uSHELL_DEBUG_COLOR, "DEBUG"), fmt, ##__VA_ARGS__)
+#else
+#define uSHELL_LOG_DEBUG(...)           uSHELL_LOG_OFF_()
+#endif
+#if (uSHELL_LOG_LEVEL_MAX >= uSHELL_LOG_LEVEL_VERBOSE)
+#define uSHELL_LOG_VERBOSE(fmt, ...)    uSHELL_LOG_AT_(uSHELL_LOG_LEVEL_VERBOSE, uSHELL_LOG_TAG_(uSHELL_VERBOSE_COLOR, " VERB"), fmt, ##__VA_ARGS__)
+#else
+#define uSHELL_LOG_VERBOSE(...)         uSHELL_LOG_OFF_()
+#endif
+#if (uSHELL_LOG_LEVEL_MAX >= uSHELL_LOG_LEVEL_TRACE)
+#define uSHELL_LOG_TRACE(fmt, ...)      uSHELL_LOG_AT_(uSHELL_LOG_LEVEL_TRACE, uSHELL_LOG_TAG_(uSHELL_INFO_COLOR, "TRACE"), fmt, ##__VA_ARGS__)
+#else
+#define uSHELL_LOG_TRACE(...)           uSHELL_LOG_OFF_()
+#endif
+
+#endif /* USHELL_CORE_LOG_H */
@@ -6,18 +6,25 @@
 extern "C" {
 #endif
 
-/* microcontrollers */
-#if (defined(__GNUC__) && (defined(__AVR__) || defined(__xtensa__) || defined(__ARM_ARCH)))
+/* microcontrollers, and the POSIX simulation of the FreeRTOS tree (its uart_access is a PTY) */
+#if (defined(__GNUC__) && (defined(__AVR__) || defined(__xtensa__) || defined(__ARM_ARCH))) || defined(USE_POSIX_SIM)
 
     #include <stdarg.h>
     int uart_getchar        (void);
     void uart_putchar       (char c);
     int  uart_printf        (const char *format, ...);
     int  uart_snprintf(char *buf, int maxlen, const char *fmt, ...);
+    int  uart_vprintf       (const char *fmt, va_list args);
+    int  uart_vsnprintf(char *buf, int maxlen, const char *fmt, va_list args);
+    int  uart_getline       (char *buf, int maxlen);
+    void uart_write         (const char *buf, int len);
     #define uSHELL_PRINTF   uart_printf
     #define uSHELL_SNPRINTF uart_snprintf
+    #define uSHELL_VPRINTF  uart_vprintf
     #define uSHELL_GETCH()  uart_getchar()
     #define uSHELL_PUTCH(x) uart_putchar(x)
+    #define uSHELL_GETLINE(b, n) uart_getline(b, n)
+    #define uSHELL_WRITE(b, n) uart_write(b, n)
 
 /* linux PC terminal */
 #elif (defined(__GNUC__) && defined(__linux__) && (defined(__x86_64__) || defined(__i386__)))
@@ -29,6 +36,8 @@ extern "C" {
     #define uSHELL_VPRINTF  vprintf
     #define uSHELL_GETCH()  fgetc(stdin)
     #define uSHELL_PUTCH(x) putchar(x)
+    #define uSHELL_GETLINE(b, n) (0)
+    #define uSHELL_WRITE(b, n) (void)fwrite(b, 1, (size_t)(n), stdout)
 
 /* i.e MinGW or Microsoft VisualStudio for Windows terminal */
 #elif (defined(__MINGW32__) || defined(_MSC_VER))
@@ -41,22 +50,40 @@ extern "C" {
     #define uSHELL_VPRINTF   vprintf
     #define uSHELL_GETCH()  _getch()
     #define uSHELL_PUTCH(x) _putch(x)
+    #define uSHELL_GETLINE(b, n) (0)
+    #define uSHELL_WRITE(b, n) do { for (int i_ = 0; i_ < (int)(n); ++i_) { _putch((b)[i_]); } } while (0)
 
 #else /* build environment not defined  */
     #error "Build variant not defined, please define it..."
 #endif
 
+/*
+ * uSHELL_GETLINE(buf, maxlen): waits for input, then if the receive buffer already
+ * holds a complete line (printable characters ended by CR, LF skipped as the key
+ * handling ignores it too) moves it into buf (NUL terminated, without the CR) and
+ * returns the number of bytes consumed.
+ * Otherwise nothing is consumed and 0 is returned, the input goes key by key.
+ * Backends without a receive buffer define it as (0).
+ *
+ * uSHELL_WRITE(buf, len): sends len bytes with one call (a single lock / ring copy
+ * on the microcontroller backends instead of one per character).
+ */
+
 /* if crosscompiled for microcontroller */
 #if defined (SERIAL_TERMINAL)
     #undef  uSHELL_PRINTF
     #undef  uSHELL_GETCH
     #undef  uSHELL_PUTCH
+    #undef  uSHELL_GETLINE
+    #undef  uSHELL_WRITE
     #define uSHELL_PRINTF   uart_printf
     #ifndef uSHELL_SNPRINTF
         #define uSHELL_SNPRINTF snprintf
     #endif
     #define uSHELL_GETCH()  uart_getchar()
     #define uSHELL_PUTCH(x) uart_putchar(x)
+    #define uSHELL_GETLINE(b, n) uart_getline(b, n)
+    #define uSHELL_WRITE(b, n) uart_write(b, n)
 #endif /*defined (SERIAL_TERMINAL) */
 
 #ifdef __cplusplus
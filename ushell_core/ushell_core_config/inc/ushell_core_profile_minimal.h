@@ -0,0 +1,80 @@
+#ifndef USHELL_CORE_PROFILE_MINIMAL_H
+#define USHELL_CORE_PROFILE_MINIMAL_H
+
+/*
+    Minimal production profile: commands typed or sent as lines, parsed and executed, nothing
+    else. Included by ushell_core_settings.h after the features of the tree (uSHELL_PROFILE_FILE),
+    the data types and the buffer sizes stay those of the tree so that the command table is shared.
+
+        ushell_core_profile(minimal ushell_core_profile_minimal.h ...)    ushell_minimal::Microshell
+*/
+
+/* major features */
+#undef  uSHELL_IMPLEMENTS_HISTORY
+#define uSHELL_IMPLEMENTS_HISTORY                0
+#undef  uSHELL_IMPLEMENTS_SAVE_HISTORY
+#define uSHELL_IMPLEMENTS_SAVE_HISTORY           0
+#undef  uSHELL_IMPLEMENTS_HISTORY_STORE
+#define uSHELL_IMPLEMENTS_HISTORY_STORE          0
+#undef  uSHELL_IMPLEMENTS_HISTORY_SEARCH
+#define uSHELL_IMPLEMENTS_HISTORY_SEARCH         0
+#undef  uSHELL_IMPLEMENTS_AUTOCOMPLETE
+#define uSHELL_IMPLEMENTS_AUTOCOMPLETE           0
+#undef  uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL
+#define uSHELL_IMPLEMENTS_PARAMS_AUTOCOMPL       0
+#undef  uSHELL_IMPLEMENTS_EDITMODE
+#define uSHELL_IMPLEMENTS_EDITMODE               0
+#undef  uSHELL_IMPLEMENTS_SMART_PROMPT
+#define uSHELL_IMPLEMENTS_SMART_PROMPT           0
+#undef  uSHELL_IMPLEMENTS_COMMAND_HELP
+#define uSHELL_IMPLEMENTS_COMMAND_HELP           0
+#undef  uSHELL_IMPLEMENTS_USER_SHORTCUTS
+#define uSHELL_IMPLEMENTS_USER_SHORTCUTS         0
+
+/* minor features */
+#undef  uSHELL_SUPPORTS_COLORS
+#define uSHELL_SUPPORTS_COLORS                   0
+#undef  uSHELL_IMPLEMENTS_CONFIRM_REQUEST
+#define uSHELL_IMPLEMENTS_CONFIRM_REQUEST        0
+#undef  uSHELL_IMPLEMENTS_ASYNC_COMMANDS
+#define uSHELL_IMPLEMENTS_ASYNC_COMMANDS         0
+#undef  uSHELL_IMPLEMENTS_MACHINE_MODE
+#define uSHELL_IMPLEMENTS_MACHINE_MODE           0
+#undef  uSHELL_IMPLEMENTS_KEY_DECODER
+#define uSHELL_IMPLEMENTS_KEY_DECODER            0
+#undef  uSHELL_IMPLEMENTS_DUMP
+#define uSHELL_IMPLEMENTS_DUMP                   0
+
+/* performance: the lookup, the parameters decoding and the line burst are kept */
+#undef  uSHELL_IMPLEMENTS_BINARY_MODE
+#define uSHELL_IMPLEMENTS_BINARY_MODE            0
+#undef  uSHELL_IMPLEMENTS_SCRIPTS
+#define uSHELL_IMPLEMENTS_SCRIPTS                0
+#undef  uSHELL_IMPLEMENTS_ESCAPE_DECODER
+#define uSHELL_IMPLEMENTS_ESCAPE_DECODER         0
+#undef  uSHELL_IMPLEMENTS_DELTA_RENDER
+#define uSHELL_IMPLEMENTS_DELTA_RENDER           0
+#undef  uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL
+#define uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL       0
+#undef  uSHELL_IMPLEMENTS_HISTORY_INDEX
+#define uSHELL_IMPLEMENTS_HISTORY_INDEX          0
+#undef  uSHELL_IMPLEMENTS_HISTORY_COMPRESS
+#define uSHELL_IMPLEMENTS_HISTORY_COMPRESS       0
+#undef  uSHELL_IMPLEMENTS_COMMAND_STATS
+#define uSHELL_IMPLEMENTS_COMMAND_STATS          0
+#undef  uSHELL_IMPLEMENTS_SCRATCH_ARENA
+#define uSHELL_IMPLEMENTS_SCRATCH_ARENA          0
+#undef  uSHELL_IMPLEMENTS_PREPARED_COMMANDS
+#define uSHELL_IMPLEMENTS_PREPARED_COMMANDS      0
+#undef  uSHELL_IMPLEMENTS_LOOPS
+#define uSHELL_IMPLEMENTS_LOOPS                  0
+#undef  uSHELL_IMPLEMENTS_POSTED_COMMANDS
+#define uSHELL_IMPLEMENTS_POSTED_COMMANDS        0
+#undef  uSHELL_IMPLEMENTS_SHORTCUT_TABLE
+#define uSHELL_IMPLEMENTS_SHORTCUT_TABLE         0
+#undef  uSHELL_IMPLEMENTS_HOT_SHORTCUTS
+#define uSHELL_IMPLEMENTS_HOT_SHORTCUTS          0
+#undef  uSHELL_IMPLEMENTS_PACKED_HELP
+#define uSHELL_IMPLEMENTS_PACKED_HELP            0
+
+#endif /* USHELL_CORE_PROFILE_MINIMAL_H */
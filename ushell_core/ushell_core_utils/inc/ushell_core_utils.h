@@ -0,0 +1,698 @@
+#ifndef USHELL_CORE_UTILS_H
+#define USHELL_CORE_UTILS_H
+
+#include "ushell_core_settings.h"
+#include "ushell_core_datatypes.h"
+#if (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE)
+#include "ushell_core_printout.h"
+#endif /* (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE) */
+
+#include <stddef.h>
+#if ((1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH) || (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE))
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#endif /* ((1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH) || (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE)) */
+
+uSHELL_NAMESPACE_BEGIN
+
+#define uSHELL_ISPRINT(c) (((c) >= 0x20) && ((c) <= 0x7e))
+
+char *strtok_ex(char *str, const char *delim, char **saveptr);
+
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+bool strtok_view(const char **ppstrCursor, const char *pstrEnd, const char *delim, strview_s *psToken);
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+
+#if defined(BIGNUM_T)
+bool asc2int(const char *s, BIGNUM_T *pNumber);
+bool asc2int_n(const char *s, size_t szLen, BIGNUM_T *pNumber);
+int asc2int_max(const char *s, size_t szLen, const BIGNUM_T maxValue, BIGNUM_T *pNumber);
+/* the same for the targets of at most 32 bits, no 64 bit arithmetic */
+int asc2int32_max(const char *s, size_t szLen, const uint32_t u32MaxValue, uint32_t *pu32Number);
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+/* [-]digits[.digits] as a Q(31-F).F fixed point number, F = uSHELL_FIXED_FRAC_BITS */
+int asc2fixed(const char *s, size_t szLen, numq_t *pNumber);
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED) */
+int dump(BIGNUM_T address, num32_t length, bool show_address);
+#endif /* defined(BIGNUM_T) */
+
+#ifdef uSHELL_IMPLEMENTS_NUMBERS_FLOAT
+bool asc2float(const char *s, numfp_t *pFloatTypeVar);
+#endif /* uSHELL_IMPLEMENTS_NUMBERS_FLOAT*/
+
+#if (1 == uSHELL_IMPLEMENTS_HEXLIFY)
+/* upper case digits, 2 * length characters and the terminator */
+void hexlify(const uint8_t *bytes, size_t length, char *output);
+/* either case, false for an odd length or a character which is not hex */
+bool unhexlify(const char *hexstr, uint8_t *output, size_t *out_len);
+/* the bytes of length digits written over them (the 'x' parameter), false for an empty or odd length too */
+bool unhexlify_inplace(char *hexstr, size_t length, size_t *out_len);
+
+/* streaming: hexlify_chunk() writes 2 * length characters without the terminator and returns their number;
+   unhexlify_chunk() takes chunks of any length (a pair may be split between two chunks) and writes
+   *out_len bytes (at most (length + 1) / 2), unhexlify_stream_end() is false if a character is left over */
+typedef struct {
+    char cPending;
+    bool bPending;
+} unhexlifyStream_s;
+
+size_t hexlify_chunk(const uint8_t *bytes, size_t length, char *output);
+void unhexlify_stream_init(unhexlifyStream_s *psStream);
+bool unhexlify_chunk(unhexlifyStream_s *psStream, const char *hexstr, size_t length, uint8_t *output, size_t *out_len);
+bool unhexlify_stream_end(const unhexlifyStream_s *psStream);
+#endif /* (1 == uSHELL_IMPLEMENTS_HEXLIFY) */
+
+char *trim_whitespace_inplace(char *str);
+bool strings_equal_trimmed(const char *s1, const char *s2);
+
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+/* bump allocation, nullptr once the arena is exhausted; the blocks are never freed one by one */
+void *ushell_scratch_alloc(scratchArena_s *psArena, size_t szSize);
+/* scratch memory of the calling handler, valid until it returns (not for the jobs of async commands);
+   provided by the plugin, i.e. char *pstrBuf = (char *)uShellScratchAlloc(szLen + 1); */
+void *uShellScratchAlloc(size_t szSize);
+#endif /* (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA) */
+
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+uint16_t crc16_ccitt(uint16_t u16Crc, const uint8_t *pu8Data, size_t szLength);
+#endif /* (1 == uSHELL_IMPLEMENTS_BINARY_MODE) */
+
+#if (1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP)
+#define uSHELL_HASH_SLOT_EMPTY (-1)
+
+/** \brief FNV-1a string hash, usable both at compile time and at runtime */
+constexpr uint32_t ushell_hash(const char *s) {
+    uint32_t u32Hash = 2166136261U;
+    while ('\0' != *s) {
+        u32Hash = (u32Hash ^ (uint8_t)(*s++)) * 16777619U;
+    }
+    return u32Hash;
+}
+
+/** \brief same hash over the first szLen characters (lookup of not terminated names) */
+constexpr uint32_t ushell_hash_n(const char *s, size_t szLen) {
+    uint32_t u32Hash = 2166136261U;
+    while (szLen--) {
+        u32Hash = (u32Hash ^ (uint8_t)(*s++)) * 16777619U;
+    }
+    return u32Hash;
+}
+
+/** \brief number of slots: smallest power of two keeping the load factor <= 0.5 */
+constexpr int ushell_hash_table_size(int iNrElems) {
+    int iSize = 2;
+    while (iSize < (2 * iNrElems)) {
+        iSize <<= 1;
+    }
+    return iSize;
+}
+
+/** \brief open addressing table holding indexes into the function definitions array */
+template <int N>
+struct hashTable_s {
+    int16_t viSlots[N];
+};
+
+/** \brief build the command lookup table (linear probing), evaluated by the compiler */
+template <int M>
+constexpr hashTable_s<ushell_hash_table_size(M)> ushell_build_hash_table(const fctDef_s (&vsFuncDefArray)[M]) {
+    constexpr int iSize = ushell_hash_table_size(M);
+    hashTable_s<iSize> sTable{};
+    for (int i = 0; i < iSize; ++i) {
+        sTable.viSlots[i] = uSHELL_HASH_SLOT_EMPTY;
+    }
+    for (int i = 0; i < M; ++i) {
+        int iSlot = (int)(ushell_hash(vsFuncDefArray[i].pstrFctName) & (uint32_t)(iSize - 1));
+        while (uSHELL_HASH_SLOT_EMPTY != sTable.viSlots[iSlot]) {
+            iSlot = (iSlot + 1) & (iSize - 1);
+        }
+        sTable.viSlots[iSlot] = (int16_t)i;
+    }
+    return sTable;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_HASHED_LOOKUP) */
+
+#if (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL)
+/** \brief strcmp() usable at compile time, same (unsigned char) order as strncmp() */
+constexpr int ushell_strcmp(const char *s1, const char *s2) {
+    while (('\0' != *s1) && (*s1 == *s2)) {
+        ++s1;
+        ++s2;
+    }
+    return (int)(uint8_t)(*s1) - (int)(uint8_t)(*s2);
+}
+
+/** \brief indexes into the function definitions array, in the order of the names */
+template <int N>
+struct sortedIndex_s {
+    int16_t viIndex[N];
+};
+
+/** \brief sort the command names (insertion sort), evaluated by the compiler */
+template <int M>
+constexpr sortedIndex_s<M> ushell_build_sorted_index(const fctDef_s (&vsFuncDefArray)[M]) {
+    sortedIndex_s<M> sIndex{};
+    for (int i = 0; i < M; ++i) {
+        int j = i;
+        while ((j > 0) && (ushell_strcmp(vsFuncDefArray[sIndex.viIndex[j - 1]].pstrFctName, vsFuncDefArray[i].pstrFctName) > 0)) {
+            sIndex.viIndex[j] = sIndex.viIndex[j - 1];
+            --j;
+        }
+        sIndex.viIndex[j] = (int16_t)i;
+    }
+    return sIndex;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_SORTED_AUTOCOMPL) */
+
+#if (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE)
+/** \brief the punctuation characters, the symbols a shortcut line may start with */
+constexpr bool ushell_is_shortcut_symbol(char cKey) {
+    return (((cKey > 0x20) && (cKey < 0x30)) || ((cKey > 0x39) && (cKey < 0x41)) || ((cKey > 0x5A) && (cKey < 0x61)) || ((cKey > 0x7A) && (cKey < 0x7F)));
+}
+
+/** \brief build the shortcut lookup table (slot of every symbol), evaluated by the compiler */
+template <int M>
+constexpr shortcutTable_s ushell_build_shortcut_table(const shortcutKey_s (&vsShortcutKeysArray)[M]) {
+    shortcutTable_s sTable{};
+    sTable.bValid = (M <= 127);
+    for (int i = 0; i < uSHELL_SHORTCUT_TABLE_SIZE; ++i) {
+        sTable.vi8Slots[i] = uSHELL_SHORTCUT_FREE;
+    }
+    for (int i = 0; i < M; ++i) {
+        const int iIndex = (int)(uint8_t)vsShortcutKeysArray[i].cSymbol - uSHELL_SHORTCUT_TABLE_FIRST;
+        if ((false == ushell_is_shortcut_symbol(vsShortcutKeysArray[i].cSymbol)) || (uSHELL_SHORTCUT_FREE != sTable.vi8Slots[iIndex])) {
+            sTable.bValid = false;
+            continue;
+        }
+        sTable.vi8Slots[iIndex] = (int8_t)i;
+        if (true == vsShortcutKeysArray[i].bHot) {
+            sTable.vu32Hot[iIndex / 32] |= (1UL << (iIndex % 32));
+        }
+    }
+    return sTable;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_SHORTCUT_TABLE) */
+
+#if (1 == uSHELL_IMPLEMENTS_PACKED_HELP)
+#define uSHELL_INFO_CODE_FIRST      (0x80)  /* the code 0x80 + n stands for the two bytes of the pair n */
+#define uSHELL_INFO_PAIR_DEPTH      (8)     /* levels of pairs a code expands to at most */
+#define uSHELL_INFO_PACK_MAX_LEN    (512)   /* longest help text */
+
+/** \brief pairs of the packed help texts, learned by ushell_core/tools/ushell_infopack.py */
+#define  uSHELL_INFO_PAIRS_TABLE_BEGIN      static constexpr uint8_t g_vu8InfoPairs[][2] = {
+#define  uSHELL_INFO_PAIR(a, b)                 { (uint8_t)(a), (uint8_t)(b) },
+#define  uSHELL_INFO_PAIRS_TABLE_END        };
+#include uSHELL_INFO_PAIRS_CONFIG_FILE
+#undef   uSHELL_INFO_PAIRS_TABLE_BEGIN
+#undef   uSHELL_INFO_PAIR
+#undef   uSHELL_INFO_PAIRS_TABLE_END
+
+/** \brief levels of pairs of a code, 0 for a plain byte */
+constexpr int ushell_info_depth(uint8_t u8Code) {
+    if (u8Code < uSHELL_INFO_CODE_FIRST) {
+        return 0;
+    }
+    const int iFirst = ushell_info_depth(g_vu8InfoPairs[u8Code - uSHELL_INFO_CODE_FIRST][0]);
+    const int iSecond = ushell_info_depth(g_vu8InfoPairs[u8Code - uSHELL_INFO_CODE_FIRST][1]);
+    return 1 + ((iFirst > iSecond) ? iFirst : iSecond);
+}
+
+/** \brief a pair refers to earlier ones only, holds no '|' (the end of the short help) and fits the expansion stack */
+constexpr bool ushell_info_pairs_valid(void) {
+    for (int i = 0; i < uSHELL_NR_ELEMS(g_vu8InfoPairs); ++i) {
+        for (int j = 0; j < 2; ++j) {
+            const uint8_t u8Code = g_vu8InfoPairs[i][j];
+            if ((0U == u8Code) || ('|' == u8Code) || (u8Code >= (uSHELL_INFO_CODE_FIRST + i))) {
+                return false;
+            }
+        }
+        if (ushell_info_depth((uint8_t)(uSHELL_INFO_CODE_FIRST + i)) > uSHELL_INFO_PAIR_DEPTH) {
+            return false;
+        }
+    }
+    return (uSHELL_NR_ELEMS(g_vu8InfoPairs) <= 128);
+}
+static_assert(true == ushell_info_pairs_valid(), "the pairs table of the help texts does not hold, run ushell_infopack.py");
+
+/** \brief a help text packed by the compiler, NUL terminated */
+template <size_t N>
+struct packedInfo_s {
+    static_assert(N > 0U, "a help text is longer than uSHELL_INFO_PACK_MAX_LEN or not 7 bit ASCII");
+    char vstrPacked[N];
+};
+
+/** \brief the pairs applied in their order, each over the text from the left; the packed length,
+    -1 for a text which is too long or not 7 bit ASCII */
+constexpr int ushell_info_pack_into(const char *pstrText, char *pstrPacked) {
+    int iLen = 0;
+    while ('\0' != pstrText[iLen]) {
+        if ((iLen >= uSHELL_INFO_PACK_MAX_LEN) || ((uint8_t)pstrText[iLen] >= uSHELL_INFO_CODE_FIRST)) {
+            return -1;
+        }
+        pstrPacked[iLen] = pstrText[iLen];
+        ++iLen;
+    }
+    for (int i = 0; i < uSHELL_NR_ELEMS(g_vu8InfoPairs); ++i) {
+        int iOut = 0;
+        for (int iIn = 0; iIn < iLen; ++iOut) {
+            if (((iIn + 1) < iLen) && (g_vu8InfoPairs[i][0] == (uint8_t)pstrPacked[iIn]) && (g_vu8InfoPairs[i][1] == (uint8_t)pstrPacked[iIn + 1])) {
+                pstrPacked[iOut] = (char)(uSHELL_INFO_CODE_FIRST + i);
+                iIn += 2;
+            } else {
+                pstrPacked[iOut] = pstrPacked[iIn++];
+            }
+        }
+        iLen = iOut;
+    }
+    pstrPacked[iLen] = '\0';
+    return iLen;
+}
+
+/** \brief size of the packed text (its NUL included), the template argument of ushell_info_pack() */
+constexpr size_t ushell_info_packed_size(const char *pstrText) {
+    char vstrPacked[uSHELL_INFO_PACK_MAX_LEN + 1] = {};
+    const int iLen = ushell_info_pack_into(pstrText, vstrPacked);
+    return (iLen < 0) ? 0U : (size_t)iLen + 1U;   /* 0: packedInfo_s does not compile */
+}
+
+/** \brief pack a help text, evaluated by the compiler (the plain text is not kept) */
+template <size_t N>
+constexpr packedInfo_s<N> ushell_info_pack(const char *pstrText) {
+    char vstrPacked[uSHELL_INFO_PACK_MAX_LEN + 1] = {};
+    packedInfo_s<N> sInfo{};
+    (void)ushell_info_pack_into(pstrText, vstrPacked);
+    for (size_t i = 0; i < N; ++i) {
+        sInfo.vstrPacked[i] = vstrPacked[i];
+    }
+    return sInfo;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_PACKED_HELP) */
+
+#if (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER)
+/** \brief map a parameter type mark to its data type (uSHELL_DATA_TYPE_LAST if not enabled) */
+constexpr dataType_e ushell_param_type(char cMark) {
+    return
+#define  uSHELL_DATA_TYPES_TABLE_BEGIN
+#define  uSHELL_DATA_TYPE(a, b)             (b == cMark) ? uSHELL_DATA_TYPE_##a :
+#define  uSHELL_DATA_TYPES_TABLE_END        uSHELL_DATA_TYPE_LAST;
+#include uSHELL_DATA_TYPES_CONFIG_FILE
+#undef   uSHELL_DATA_TYPES_TABLE_BEGIN
+#undef   uSHELL_DATA_TYPE
+#undef   uSHELL_DATA_TYPES_TABLE_END
+}
+
+/** \brief decode a parameters pattern (i.e. "lio"), evaluated by the compiler */
+constexpr paramsDecoder_s ushell_build_params_decoder(const char *pstrParamDef) {
+    paramsDecoder_s sDecoder{};
+    if ('v' != pstrParamDef[0]) {
+        for (int i = 0; '\0' != pstrParamDef[i]; ++i) {
+            if (i < (int)uSHELL_MAX_PARAMS_TOTAL) {
+                sDecoder.vu8Types[i] = (uint8_t)ushell_param_type(pstrParamDef[i]);
+            }
+            ++sDecoder.u8NrParams;
+        }
+    }
+    return sDecoder;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_PARAMS_DECODER) */
+
+#if (1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH)
+/** \brief parameter mark and command_s storage of every C++ parameter type */
+template <typename T>
+struct ushell_param_s;
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT)
+template <>
+struct ushell_param_s<num64_t> {
+    static constexpr char cMark = 'l';
+    static inline num64_t get(const command_s *psCmd, unsigned int i) { return psCmd->vl[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_64BIT) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT)
+template <>
+struct ushell_param_s<num32_t> {
+    static constexpr char cMark = 'i';
+    static inline num32_t get(const command_s *psCmd, unsigned int i) { return psCmd->vi[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_32BIT) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT)
+template <>
+struct ushell_param_s<num16_t> {
+    static constexpr char cMark = 'w';
+    static inline num16_t get(const command_s *psCmd, unsigned int i) { return psCmd->vw[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_16BIT) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT)
+template <>
+struct ushell_param_s<num8_t> {
+    static constexpr char cMark = 'b';
+    static inline num8_t get(const command_s *psCmd, unsigned int i) { return psCmd->vb[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_8BIT) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT)
+template <>
+struct ushell_param_s<numfp_t> {
+    static constexpr char cMark = 'f';
+    static inline numfp_t get(const command_s *psCmd, unsigned int i) { return psCmd->vf[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FLOAT) */
+
+#if defined(uSHELL_IMPLEMENTS_STRINGS)
+template <>
+struct ushell_param_s<str_t *> {
+    static constexpr char cMark = 's';
+    static inline str_t *get(const command_s *psCmd, unsigned int i) { return psCmd->vs[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_STRINGS) */
+
+#if defined(uSHELL_IMPLEMENTS_BOOLEAN)
+template <>
+struct ushell_param_s<bool> {
+    static constexpr char cMark = 'o';
+    static inline bool get(const command_s *psCmd, unsigned int i) { return psCmd->vo[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_BOOLEAN) */
+
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+template <>
+struct ushell_param_s<strview_s> {
+    static constexpr char cMark = 'r';
+    static inline strview_s get(const command_s *psCmd, unsigned int i) { return psCmd->vr[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+template <>
+struct ushell_param_s<numq_t> {
+    static constexpr char cMark = 'q';
+    static inline numq_t get(const command_s *psCmd, unsigned int i) { return psCmd->vq[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED) */
+
+#if defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS)
+template <>
+struct ushell_param_s<numarray_s> {
+    static constexpr char cMark = 'a';
+    static inline numarray_s get(const command_s *psCmd, unsigned int i) { return psCmd->va[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBER_ARRAYS) */
+
+#if defined(uSHELL_IMPLEMENTS_HEX_BUFFERS)
+template <>
+struct ushell_param_s<hexbuf_s> {
+    static constexpr char cMark = 'x';
+    static inline hexbuf_s get(const command_s *psCmd, unsigned int i) { return psCmd->vx[i]; }
+};
+#endif /* defined(uSHELL_IMPLEMENTS_HEX_BUFFERS) */
+
+/** \brief index of the parameter at szPos inside its command_s array (same typed parameters before it) */
+template <typename T, typename... Args>
+constexpr unsigned int ushell_param_slot(size_t szPos) {
+    const bool vbSameType[] = { std::is_same<T, Args>::value... };
+    unsigned int uSlot = 0;
+    for (size_t i = 0; i < szPos; ++i) {
+        uSlot += vbSameType[i] ? 1U : 0U;
+    }
+    return uSlot;
+}
+
+/** \brief typed call of a command: unpacks command_s straight into the command signature */
+template <auto pFct>
+struct ushell_thunk_s;
+
+template <typename... Args, int (*pFct)(Args...)>
+struct ushell_thunk_s<pFct> {
+    static int run(const command_s *psCmd) {
+        return invoke(psCmd, std::index_sequence_for<Args...>{});
+    }
+
+    /** \brief true if the signature is the one described by the parameters pattern (i.e. "lio") */
+    static constexpr bool matches(const char *pstrPattern) {
+        const char vcMarks[] = { ushell_param_s<Args>::cMark..., '\0' };
+        if (0 == sizeof...(Args)) {
+            return ('v' == pstrPattern[0]) && ('\0' == pstrPattern[1]);
+        }
+        for (size_t i = 0; i < sizeof...(Args); ++i) {
+            if (vcMarks[i] != pstrPattern[i]) {
+                return false;
+            }
+        }
+        return ('\0' == pstrPattern[sizeof...(Args)]);
+    }
+
+private:
+    template <size_t... K>
+    static inline int invoke(const command_s *psCmd, std::index_sequence<K...>) {
+        (void)psCmd; // unused for the void pattern
+        return pFct(ushell_param_s<Args>::get(psCmd, ushell_param_slot<Args, Args...>(K))...);
+    }
+};
+#endif /* (1 == uSHELL_IMPLEMENTS_TYPED_DISPATCH) */
+
+#if (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE)
+/* line buffer of uSHELL_PRINTF_CT, written out with uSHELL_WRITE when full and at the end */
+#define uSHELL_FMT_LINE_SIZE 64U
+
+/** \brief literal format usable as a template argument (i.e. ushell_printf_ct<"%3d %s">) */
+template <size_t N>
+struct ushell_fmt_string_s {
+    char vcData[N];
+    constexpr ushell_fmt_string_s(const char (&vcFormat)[N]) : vcData{} {
+        for (size_t i = 0; i < N; ++i) {
+            vcData[i] = vcFormat[i];
+        }
+    }
+};
+
+/** \brief one piece of a format: a literal run (cConv 0) or an argument conversion */
+struct ushell_fmt_segment_s {
+    uint16_t u16Offset;
+    uint16_t u16Length;
+    char cConv;
+    char cPad;
+    uint8_t u8Width;
+    bool bLeftAlign;
+};
+
+/** \brief split a format into segments, false for what only uSHELL_PRINTF supports (precision, %x, %f, ...);
+           the h, l, ll, z length modifiers are accepted and ignored */
+template <typename F>
+constexpr bool ushell_fmt_parse(const char *pstrFmt, F &&fSegment) {
+    size_t szLiteral = 0;
+    size_t i = 0;
+    auto literal = [&](size_t szEnd) {
+        if (szEnd > szLiteral) {
+            fSegment(ushell_fmt_segment_s{ (uint16_t)szLiteral, (uint16_t)(szEnd - szLiteral), '\0', ' ', 0U, false });
+        }
+    };
+    while ('\0' != pstrFmt[i]) {
+        if ('%' != pstrFmt[i]) {
+            ++i;
+            continue;
+        }
+        literal(i);
+        if ('%' == pstrFmt[++i]) {
+            szLiteral = i++; /* the second '%' starts the next literal */
+            continue;
+        }
+        ushell_fmt_segment_s sSeg{ 0U, 0U, '\0', ' ', 0U, false };
+        for (; ('-' == pstrFmt[i]) || ('0' == pstrFmt[i]); ++i) {
+            if ('-' == pstrFmt[i]) {
+                sSeg.bLeftAlign = true;
+            } else {
+                sSeg.cPad = '0';
+            }
+        }
+        unsigned int uWidth = 0U;
+        for (; (pstrFmt[i] >= '0') && (pstrFmt[i] <= '9'); ++i) {
+            uWidth = uWidth * 10U + (unsigned int)(pstrFmt[i] - '0');
+            if (uWidth > 255U) {
+                return false;
+            }
+        }
+        sSeg.u8Width = (uint8_t)uWidth;
+        while (('h' == pstrFmt[i]) || ('l' == pstrFmt[i]) || ('z' == pstrFmt[i])) {
+            ++i; /* the size comes from the argument type */
+        }
+        switch (pstrFmt[i]) {
+            case 's': case 'c': case 'd': case 'i': case 'u':
+                sSeg.cConv = pstrFmt[i];
+                break;
+            default:
+                return false;
+        }
+        fSegment(sSeg);
+        szLiteral = ++i;
+    }
+    literal(i);
+    return true;
+}
+
+/** \brief segments of a format and the segment of every argument, evaluated by the compiler */
+template <size_t NSeg, size_t NArg>
+struct ushell_fmt_plan_s {
+    ushell_fmt_segment_s vsSegments[(NSeg > 0) ? NSeg : 1];
+    size_t vszArgSegment[(NArg > 0) ? NArg : 1];
+};
+
+template <ushell_fmt_string_s S>
+struct ushell_fmt_s {
+    static constexpr size_t count(bool bArgsOnly) {
+        size_t szCount = 0;
+        ushell_fmt_parse(S.vcData, [&](const ushell_fmt_segment_s &sSeg) {
+            szCount += ((false == bArgsOnly) || ('\0' != sSeg.cConv)) ? 1U : 0U;
+        });
+        return szCount;
+    }
+
+    static constexpr bool bValid = ushell_fmt_parse(S.vcData, [](const ushell_fmt_segment_s &) {});
+    static constexpr size_t szSegments = count(false);
+    static constexpr size_t szArgs = count(true);
+
+    static constexpr ushell_fmt_plan_s<szSegments, szArgs> build(void) {
+        ushell_fmt_plan_s<szSegments, szArgs> sPlan{};
+        size_t szSeg = 0;
+        size_t szArg = 0;
+        ushell_fmt_parse(S.vcData, [&](const ushell_fmt_segment_s &sSeg) {
+            if ('\0' != sSeg.cConv) {
+                sPlan.vszArgSegment[szArg++] = szSeg;
+            }
+            sPlan.vsSegments[szSeg++] = sSeg;
+        });
+        return sPlan;
+    }
+
+    static constexpr ushell_fmt_plan_s<szSegments, szArgs> sPlan = build();
+};
+
+/** \brief output of uSHELL_PRINTF_CT: literals are copied, the buffer leaves with one uSHELL_WRITE */
+struct ushell_fmt_sink_s {
+    char vcBuf[uSHELL_FMT_LINE_SIZE];
+    int iPos = 0;
+
+    inline void flush(void) {
+        if (iPos > 0) {
+            uSHELL_WRITE(vcBuf, iPos);
+            iPos = 0;
+        }
+    }
+
+    inline void put(const char *pstrData, size_t szLen) {
+        while (szLen > 0) {
+            if (iPos == (int)sizeof(vcBuf)) {
+                flush();
+            }
+            const size_t szChunk = ((sizeof(vcBuf) - (size_t)iPos) < szLen) ? (sizeof(vcBuf) - (size_t)iPos) : szLen;
+            memcpy(&vcBuf[iPos], pstrData, szChunk);
+            iPos += (int)szChunk;
+            pstrData += szChunk;
+            szLen -= szChunk;
+        }
+    }
+
+    inline void fill(char cPad, int iCount) {
+        for (; iCount > 0; --iCount) {
+            put(&cPad, 1);
+        }
+    }
+
+    /* a negative number keeps its sign in front of the zero padding */
+    inline void field(const ushell_fmt_segment_s &sSeg, const char *pstrData, size_t szLen, bool bNegative = false) {
+        const int iPad = (int)sSeg.u8Width - (int)szLen - (bNegative ? 1 : 0);
+        if (true == sSeg.bLeftAlign) {
+            put("-", bNegative ? 1U : 0U);
+            put(pstrData, szLen);
+            fill(' ', iPad);
+        } else if ('0' == sSeg.cPad) {
+            put("-", bNegative ? 1U : 0U);
+            fill('0', iPad);
+            put(pstrData, szLen);
+        } else {
+            fill(' ', iPad);
+            put("-", bNegative ? 1U : 0U);
+            put(pstrData, szLen);
+        }
+    }
+};
+
+/** \brief decimal digits written backwards before pcEnd, 32 bit division unless the type is wider */
+template <typename U>
+inline size_t ushell_fmt_utoa(char *pcEnd, U value) {
+    char *pc = pcEnd;
+    do {
+        *--pc = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (0U != value);
+    return (size_t)(pcEnd - pc);
+}
+
+/** \brief one argument, converted by its C++ type as printf would convert it for cConv */
+template <char cConv, typename T>
+inline void ushell_fmt_put_arg(ushell_fmt_sink_s &sSink, const ushell_fmt_segment_s &sSeg, const T &arg) {
+    if constexpr ('s' == cConv) {
+        static_assert(std::is_convertible<const T &, const char *>::value, "uSHELL_PRINTF_CT: %s needs a string");
+        const char *pstrArg = arg;
+        sSink.field(sSeg, pstrArg, strlen(pstrArg));
+    } else {
+        static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "uSHELL_PRINTF_CT: %c %d %i %u need an integer");
+        using promoted_t = decltype(+arg);
+        if constexpr ('c' == cConv) {
+            const char cArg = (char)arg;
+            sSink.field(sSeg, &cArg, 1U);
+        } else if constexpr ('u' == cConv) {
+            char vcDigits[20];
+            const size_t szLen = ushell_fmt_utoa(&vcDigits[sizeof(vcDigits)], static_cast<std::make_unsigned_t<promoted_t>>(arg));
+            sSink.field(sSeg, &vcDigits[sizeof(vcDigits) - szLen], szLen);
+        } else {
+            const auto value = static_cast<std::make_signed_t<promoted_t>>(arg);
+            using magnitude_t = std::make_unsigned_t<promoted_t>;
+            const magnitude_t magnitude = (value < 0) ? (magnitude_t)(0U - (magnitude_t)value) : (magnitude_t)value;
+            char vcDigits[20];
+            const size_t szLen = ushell_fmt_utoa(&vcDigits[sizeof(vcDigits)], magnitude);
+            sSink.field(sSeg, &vcDigits[sizeof(vcDigits) - szLen], szLen, (value < 0));
+        }
+    }
+}
+
+template <ushell_fmt_string_s S>
+inline void ushell_fmt_put_literals(ushell_fmt_sink_s &sSink, size_t szFrom, size_t szTo) {
+    for (size_t i = szFrom; i < szTo; ++i) {
+        const ushell_fmt_segment_s &sSeg = ushell_fmt_s<S>::sPlan.vsSegments[i];
+        sSink.put(&S.vcData[sSeg.u16Offset], sSeg.u16Length);
+    }
+}
+
+template <ushell_fmt_string_s S, size_t... K, typename... Args>
+inline void ushell_fmt_emit(ushell_fmt_sink_s &sSink, std::index_sequence<K...>, const Args &...args) {
+    using fmt_t = ushell_fmt_s<S>;
+    size_t szNext = 0;
+    ((ushell_fmt_put_literals<S>(sSink, szNext, fmt_t::sPlan.vszArgSegment[K]),
+      ushell_fmt_put_arg<fmt_t::sPlan.vsSegments[fmt_t::sPlan.vszArgSegment[K]].cConv>(sSink, fmt_t::sPlan.vsSegments[fmt_t::sPlan.vszArgSegment[K]], args),
+      szNext = fmt_t::sPlan.vszArgSegment[K] + 1U), ...);
+    ushell_fmt_put_literals<S>(sSink, szNext, fmt_t::szSegments);
+}
+
+/** \brief printf of a literal format split by the compiler: at runtime only copies and integer conversions */
+template <ushell_fmt_string_s S, typename... Args>
+inline void ushell_printf_ct(const Args &...args) {
+    static_assert(ushell_fmt_s<S>::bValid, "uSHELL_PRINTF_CT: only %s %c %d %i %u %% with - 0, width and length, use uSHELL_PRINTF");
+    static_assert(ushell_fmt_s<S>::szArgs == sizeof...(Args), "uSHELL_PRINTF_CT: the number of arguments does not match the format");
+    ushell_fmt_sink_s sSink;
+    ushell_fmt_emit<S>(sSink, std::index_sequence_for<Args...>{}, args...);
+    sSink.flush();
+}
+
+#define uSHELL_PRINTF_CT(fmt, ...) ushell_printf_ct<fmt>(__VA_ARGS__)
+#else
+#define uSHELL_PRINTF_CT(...)      uSHELL_PRINTF(__VA_ARGS__)
+#endif /* (1 == uSHELL_IMPLEMENTS_FORMAT_PRECOMPILE) */
+
+uSHELL_NAMESPACE_END
+uSHELL_NAMESPACE_USE
+
+#endif /* USHELL_CORE_UTILS_H */
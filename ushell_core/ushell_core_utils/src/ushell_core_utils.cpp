@@ -0,0 +1,831 @@
+#include "ushell_core_utils.h"
+
+#include "ushell_core_printout.h"
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+uSHELL_NAMESPACE_BEGIN
+
+/*----------------------------------------------------------------------------*/
+char *strtok_ex(char *str, const char *delim, char **saveptr) {
+    if (!delim || (!str && !*saveptr) || !*delim) {
+        return nullptr;
+    }
+
+    if (!str) {
+        str = *saveptr;
+    }
+
+    // Skip leading delimiters
+    while (*str) {
+        const char *d = delim;
+        while (*d && *str != *d)
+            ++d;
+        if (!*d)
+            break; // Not a delimiter
+        ++str;
+    }
+
+    if (!*str) {
+        return nullptr;
+    }
+
+    char *ppstrToken = str;
+
+    // Find end of ppstrToken
+    while (*str) {
+        const char *d = delim;
+        while (*d && *str != *d)
+            ++d;
+        if (*d)
+            break; // Found delimiter
+        ++str;
+    }
+
+    if (*str) {
+        *str = '\0';
+        *saveptr = str + 1;
+    } else {
+        *saveptr = nullptr;
+    }
+
+    return ppstrToken;
+}
+
+#if defined(uSHELL_IMPLEMENTS_STRING_VIEWS)
+/*----------------------------------------------------------------------------*/
+bool strtok_view(const char **ppstrCursor, const char *pstrEnd, const char *delim, strview_s *psToken) {
+    const char *str = *ppstrCursor;
+
+    if (!str || !delim || !*delim) {
+        return false;
+    }
+
+    // Skip leading delimiters (the buffer is never written)
+    while ((str < pstrEnd) && *str && strchr(delim, *str)) {
+        ++str;
+    }
+
+    if ((str >= pstrEnd) || !*str) {
+        *ppstrCursor = str;
+        return false;
+    }
+
+    psToken->pstr = str;
+
+    // Find end of token
+    while ((str < pstrEnd) && *str && !strchr(delim, *str)) {
+        ++str;
+    }
+
+    psToken->szLen = (size_t)(str - psToken->pstr);
+    *ppstrCursor = str;
+
+    return true;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_STRING_VIEWS) */
+
+/*----------------------------------------------------------------------------*/
+#if defined(BIGNUM_T)
+/* digit value of every character, 0xFF for the ones that are not digits (any base <= 16) */
+static const uint8_t g_vu8DigitLut[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* 0..9 */
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* A..F */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* a..f */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#if (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+/*----------------------------------------------------------------------------*/
+/* convert 4 decimal digits at once (SWAR), false if any of them is not a digit */
+static inline bool swar_4digits(const char *s, uint32_t *pu32Value) {
+    uint32_t u32Chunk;
+    memcpy(&u32Chunk, s, sizeof(u32Chunk));
+    // every byte in '0'..'9': high nibble is 3 and adding 6 does not carry into it
+    if ((u32Chunk & 0xF0F0F0F0U) != 0x30303030U || ((u32Chunk + 0x06060606U) & 0xF0F0F0F0U) != 0x30303030U) {
+        return false;
+    }
+    u32Chunk -= 0x30303030U;
+    u32Chunk = (u32Chunk * 10U) + (u32Chunk >> 8); // byte 0: d0d1, byte 2: d2d3 (first char is the lowest byte)
+    *pu32Value = ((u32Chunk & 0xFFU) * 100U) + ((u32Chunk >> 16) & 0xFFU);
+    return true;
+}
+#endif /* little endian */
+
+/*----------------------------------------------------------------------------*/
+/* numValue * mul + add if it stays <= maxValue: no division, the 32 bit width by one 32x32->64
+   multiply (UMULL), the 64 bit one by the overflow builtins (no __aeabi_uldivmod on the Cortex-M) */
+static inline bool asc2num_step(uint32_t *pNumber, const uint32_t mul, const uint32_t add, const uint32_t maxValue) {
+    const uint64_t u64Value = ((uint64_t)*pNumber * mul) + add;
+    if (u64Value > maxValue) {
+        return false;
+    }
+    *pNumber = (uint32_t)u64Value;
+    return true;
+}
+
+#if (defined(uSHELL_SUPPORTS_NUMBERS_64BIT) && (1 == uSHELL_SUPPORTS_NUMBERS_64BIT))
+static inline bool asc2num_step(uint64_t *pNumber, const uint32_t mul, const uint32_t add, const uint64_t maxValue) {
+    uint64_t u64Value = 0;
+#if defined(__GNUC__)
+    if (__builtin_mul_overflow(*pNumber, (uint64_t)mul, &u64Value) || __builtin_add_overflow(u64Value, (uint64_t)add, &u64Value)) {
+        return false;
+    }
+#else
+    if (*pNumber > ((maxValue - add) / mul)) {
+        return false;
+    }
+    u64Value = (*pNumber * mul) + add;
+#endif /* defined(__GNUC__) */
+    if (u64Value > maxValue) {
+        return false;
+    }
+    *pNumber = u64Value;
+    return true;
+}
+#endif /* (defined(uSHELL_SUPPORTS_NUMBERS_64BIT) && (1 == uSHELL_SUPPORTS_NUMBERS_64BIT)) */
+
+/*----------------------------------------------------------------------------*/
+/* digits only (no sign, no prefix); the accumulation stops as soon as the value exceeds
+   maxValue but the rest is still validated, so a malformed number is always reported as such */
+template <typename T>
+static int asc2num(const char *s, const char *e, const int base, const T maxValue, T *pNumber) {
+    T numValue = 0;
+    bool bTooBig = false;
+
+#if (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+    if (10 == base) {
+        uint32_t u32Chunk = 0;
+        while (((e - s) >= 4) && (false == bTooBig) && swar_4digits(s, &u32Chunk)) {
+            if (false == asc2num_step(&numValue, 10000U, u32Chunk, maxValue)) {
+                bTooBig = true;
+            } else {
+                s += 4;
+            }
+        }
+    }
+#endif /* little endian */
+
+    while (s < e) {
+        const uint8_t digit = g_vu8DigitLut[(uint8_t)*s++];
+        if (digit >= base) {
+            return uSHELL_ERR_INVALID_NUMBER;
+        }
+        if ((false == bTooBig) && (false == asc2num_step(&numValue, (uint32_t)base, digit, maxValue))) {
+            bTooBig = true;
+        }
+    }
+
+    *pNumber = numValue;
+    return (true == bTooBig) ? uSHELL_ERR_VALUE_TOO_BIG : uSHELL_ERR_OK;
+}
+
+/*----------------------------------------------------------------------------*/
+/* the sign (signed types only) and the 0x / 0b / 0o prefix, the base of the digits after them */
+static int asc2num_prefix(const char **ps, const char *e, bool *pbNegative) {
+    const char *s = *ps;
+
+    *pbNegative = false;
+#if (1 == uSHELL_SUPPORTS_SIGNED_TYPES)
+    if (*s == '-') {
+        *pbNegative = true;
+        s++;
+    }
+#endif
+
+    int base = 10;
+    if ((*s == '0') && ((e - s) > 1)) {
+        if (tolower(*(s + 1)) == 'x') {
+            base = 16;
+            s += 2;
+        } else if (tolower(*(s + 1)) == 'b') {
+            base = 2;
+            s += 2;
+        } else if (tolower(*(s + 1)) == 'o') {
+            base = 8;
+            s += 2;
+        }
+    }
+
+    *ps = s;
+    return base;
+}
+
+/*----------------------------------------------------------------------------*/
+/* a negative number is stored as the two's complement in the width of maxValue, its magnitude
+   bounded by the signed range of that width: -128 for a byte, -2^31 for an integer ... */
+template <typename T>
+static int asc2num_signed(const char *s, const char *e, const int base, const bool bNegative, const T maxValue, T *pNumber) {
+    if (false == bNegative) {
+        return asc2num<T>(s, e, base, maxValue, pNumber);
+    }
+    T numValue = 0;
+    const int iRetVal = asc2num<T>(s, e, base, (T)((maxValue >> 1) + 1U), &numValue);
+    if (uSHELL_ERR_OK == iRetVal) {
+        *pNumber = (T)(((T)0 - numValue) & maxValue);
+    }
+    return iRetVal;
+}
+
+/*----------------------------------------------------------------------------*/
+int asc2int32_max(const char *s, size_t szLen, const uint32_t u32MaxValue, uint32_t *pu32Number) {
+    if (!s || (0 == szLen)) {
+        return uSHELL_ERR_INVALID_NUMBER;
+    }
+
+    const char *e = s + szLen;
+    bool bNegative = false;
+    const int base = asc2num_prefix(&s, e, &bNegative);
+
+    uint32_t u32Value = 0;
+    const int iRetVal = asc2num_signed<uint32_t>(s, e, base, bNegative, u32MaxValue, &u32Value);
+    if (uSHELL_ERR_OK == iRetVal) {
+        *pu32Number = u32Value;
+    }
+    return iRetVal;
+}
+
+/*----------------------------------------------------------------------------*/
+int asc2int_max(const char *s, size_t szLen, const BIGNUM_T maxValue, BIGNUM_T *pNumber) {
+    if (maxValue <= (BIGNUM_T)UINT32_MAX) {
+        // the 8, 16, 32 bit targets never leave the native width
+        uint32_t u32Value = 0;
+        const int iRetVal = asc2int32_max(s, szLen, (uint32_t)maxValue, &u32Value);
+        if (uSHELL_ERR_OK == iRetVal) {
+            *pNumber = u32Value;
+        }
+        return iRetVal;
+    }
+
+#if (defined(uSHELL_SUPPORTS_NUMBERS_64BIT) && (1 == uSHELL_SUPPORTS_NUMBERS_64BIT))
+    if (!s || (0 == szLen)) {
+        return uSHELL_ERR_INVALID_NUMBER;
+    }
+
+    const char *e = s + szLen;
+    bool bNegative = false;
+    const int base = asc2num_prefix(&s, e, &bNegative);
+
+    uint64_t u64Value = 0;
+    const int iRetVal = asc2num_signed<uint64_t>(s, e, base, bNegative, (uint64_t)maxValue, &u64Value);
+    if (uSHELL_ERR_OK == iRetVal) {
+        *pNumber = u64Value;
+    }
+    return iRetVal;
+#else
+    return uSHELL_ERR_VALUE_TOO_BIG;
+#endif /* (defined(uSHELL_SUPPORTS_NUMBERS_64BIT) && (1 == uSHELL_SUPPORTS_NUMBERS_64BIT)) */
+}
+
+#if defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED)
+static_assert((uSHELL_FIXED_FRAC_BITS > 0) && (uSHELL_FIXED_FRAC_BITS < 28), "the fraction is folded in 32 bits (10 * 2^(F + 1))");
+
+/*----------------------------------------------------------------------------*/
+/* [-]digits[.digits] in Q(31-F).F, 32 bit integer arithmetic only: the integer part through
+   asc2num, the fraction folded from its last digit, q = (d * 2^(F + 1) + q) / 10, every digit
+   counts and the result is rounded to the nearest of the F bits */
+int asc2fixed(const char *s, size_t szLen, numq_t *pNumber) {
+    if (!s || (0 == szLen)) {
+        return uSHELL_ERR_INVALID_NUMBER;
+    }
+
+    const char *e = s + szLen;
+    bool bNegative = false;
+    if (*s == '-') {
+        bNegative = true;
+        s++;
+    }
+
+    const char *pstrDot = (const char *)memchr(s, '.', (size_t)(e - s));
+    const char *pstrIntEnd = (nullptr != pstrDot) ? pstrDot : e;
+    if ((s == e) || ((nullptr != pstrDot) && ((pstrDot + 1) == e))) {
+        return uSHELL_ERR_INVALID_NUMBER;
+    }
+
+    uint32_t u32Int = 0;
+    int iRetVal = asc2num<uint32_t>(s, pstrIntEnd, 10, 0x80000000U >> uSHELL_FIXED_FRAC_BITS, &u32Int);
+
+    uint32_t u32Frac = 0;
+    if (nullptr != pstrDot) {
+        for (const char *p = e - 1; p > pstrDot; --p) {
+            const uint8_t digit = g_vu8DigitLut[(uint8_t)*p];
+            if (digit > 9U) {
+                return uSHELL_ERR_INVALID_NUMBER;
+            }
+            u32Frac = (((uint32_t)digit << (uSHELL_FIXED_FRAC_BITS + 1)) + u32Frac) / 10U;
+        }
+        u32Frac = (u32Frac + 1U) >> 1;
+    }
+
+    if (uSHELL_ERR_OK == iRetVal) {
+        const uint32_t u32Magnitude = (u32Int << uSHELL_FIXED_FRAC_BITS) + u32Frac;
+        if (u32Magnitude > ((true == bNegative) ? 0x80000000U : 0x7FFFFFFFU)) {
+            iRetVal = uSHELL_ERR_VALUE_TOO_BIG;
+        } else {
+            *pNumber = (numq_t)((true == bNegative) ? (0U - u32Magnitude) : u32Magnitude);
+        }
+    }
+    return iRetVal;
+}
+#endif /* defined(uSHELL_IMPLEMENTS_NUMBERS_FIXED) */
+
+/*----------------------------------------------------------------------------*/
+bool asc2int(const char *s, BIGNUM_T *pNumber) {
+    if (!s) {
+        return false;
+    }
+
+    return asc2int_n(s, strlen(s), pNumber);
+}
+
+/*----------------------------------------------------------------------------*/
+bool asc2int_n(const char *s, size_t szLen, BIGNUM_T *pNumber) {
+    return (uSHELL_ERR_OK == asc2int_max(s, szLen, (BIGNUM_T)~(BIGNUM_T)0, pNumber));
+}
+#endif /* defined(BIGNUM_T) */
+
+/*----------------------------------------------------------------------------*/
+#ifdef uSHELL_IMPLEMENTS_NUMBERS_FLOAT
+/* the exponents of the parser: 9 decimals at most, 10^38 is the last power below FLT_MAX */
+#define uSHELL_FLOAT_POW10_MIN  (-9)
+#define uSHELL_FLOAT_POW10_MAX  (38)
+
+#if (0 == uSHELL_FLOAT_HW)
+/* 10^k, k = uSHELL_FLOAT_POW10_MIN .. uSHELL_FLOAT_POW10_MAX, as u32Mant * 2^i16Exp with the top bit of
+   u32Mant set; exact up to 10^13, the others rounded once per step (2^-32 each, far below the 2^-24 of
+   a float) */
+struct pow10Q_s {
+    uint32_t u32Mant;
+    int16_t i16Exp;
+};
+
+struct pow10Table_s {
+    pow10Q_s vsPow10[uSHELL_FLOAT_POW10_MAX - uSHELL_FLOAT_POW10_MIN + 1];
+};
+
+/* to 32 bits with the top one set, rounded to the nearest */
+static constexpr pow10Q_s pow10_normalize(uint64_t u64Mant, int iExp) {
+    while (u64Mant < 0x80000000ULL) {
+        u64Mant <<= 1;
+        --iExp;
+    }
+    while (u64Mant >= 0x100000000ULL) {
+        u64Mant = (u64Mant >> 1) + (u64Mant & 1U);
+        ++iExp;
+    }
+    return pow10Q_s{ (uint32_t)u64Mant, (int16_t)iExp };
+}
+
+static constexpr pow10Table_s pow10_table() {
+    pow10Table_s sTable{};
+    const int iOne = -uSHELL_FLOAT_POW10_MIN;
+    sTable.vsPow10[iOne] = pow10Q_s{ 0x80000000U, -31 };
+    for (int k = iOne + 1; k <= (uSHELL_FLOAT_POW10_MAX - uSHELL_FLOAT_POW10_MIN); ++k) {
+        const pow10Q_s sLast = sTable.vsPow10[k - 1];
+        sTable.vsPow10[k] = pow10_normalize((uint64_t)sLast.u32Mant * 10U, sLast.i16Exp);
+    }
+    for (int k = iOne - 1; k >= 0; --k) {
+        const pow10Q_s sLast = sTable.vsPow10[k + 1];
+        sTable.vsPow10[k] = pow10_normalize((((uint64_t)sLast.u32Mant << 32) + 5U) / 10U, sLast.i16Exp - 32);
+    }
+    return sTable;
+}
+
+static constexpr pow10Table_s g_sPow10Table = pow10_table();
+static_assert((0xEE6B2800U == g_sPow10Table.vsPow10[9 - uSHELL_FLOAT_POW10_MIN].u32Mant) &&
+              (-2 == g_sPow10Table.vsPow10[9 - uSHELL_FLOAT_POW10_MIN].i16Exp), "10^9 is exact");
+
+/* M * 10^iExp10 assembled in the bits of a float: the 64 bit product of the mantissas, rounded to the
+   nearest even of 24 bits; false beyond FLT_MAX. No subnormals, the smallest value is 10^-9 */
+static bool float_from_decimal(uint32_t u32Mantissa, int iExp10, bool bNegative, numfp_t *pFloatTypeVar) {
+    uint32_t u32Bits = (true == bNegative) ? 0x80000000U : 0U;
+
+    if (0U != u32Mantissa) {
+        const pow10Q_s &sPow10 = g_sPow10Table.vsPow10[iExp10 - uSHELL_FLOAT_POW10_MIN];
+        const int iLeading = __builtin_clz(u32Mantissa);
+        uint64_t u64Product = (uint64_t)(u32Mantissa << iLeading) * sPow10.u32Mant;
+        int iExp = (int)sPow10.i16Exp - iLeading;
+        if (u64Product < 0x8000000000000000ULL) {
+            u64Product <<= 1;
+            --iExp;
+        }
+
+        uint32_t u32Mant24 = (uint32_t)(u64Product >> 40);
+        const uint64_t u64Rest = u64Product & 0xFFFFFFFFFFULL;
+        if ((u64Rest > 0x8000000000ULL) || ((0x8000000000ULL == u64Rest) && (0U != (u32Mant24 & 1U)))) {
+            if (0x1000000U == ++u32Mant24) {
+                u32Mant24 >>= 1;
+                ++iExp;
+            }
+        }
+
+        const int iBiased = iExp + 63 + 127;  /* u32Mant24 * 2^(iExp + 40) = 1.f * 2^(iExp + 63) */
+        if (iBiased >= 0xFF) {
+            return false;
+        }
+        u32Bits |= ((uint32_t)iBiased << 23) | (u32Mant24 & 0x7FFFFFU);
+    }
+
+    static_assert(sizeof(numfp_t) == sizeof(u32Bits), "the mantissa is assembled for a single precision float");
+    memcpy(pFloatTypeVar, &u32Bits, sizeof(u32Bits));
+    return true;
+}
+#endif /* (0 == uSHELL_FLOAT_HW) */
+
+/* single precision only: the digits go into a 32 bit mantissa (9 significant ones, 9 decimals at
+   most, the integer digits beyond are powers of ten), then M * 10^e: with an FPU (uSHELL_FLOAT_HW)
+   one conversion and one power of ten in its registers, without one the bits of the float
+   are assembled in integers, no soft float call on either; false beyond FLT_MAX */
+bool asc2float(const char *s, numfp_t *pFloatTypeVar) {
+    bool bNegative = false, bFraction = false;
+    uint32_t u32Mantissa = 0;
+    unsigned int uScale = 0, uDropped = 0;
+
+    if (!s || *s == '\0') {
+        return false;
+    }
+
+    if (*s == '-') {
+        bNegative = true;
+        s++;
+    }
+
+    while (*s) {
+        if (*s == '.') {
+            if (bFraction || *(s + 1) == '\0') {
+                return false;
+            }
+            bFraction = true;
+        } else if (isdigit(*s)) {
+            if ((u32Mantissa < 100000000U) && (uScale < 9U)) {
+                u32Mantissa = u32Mantissa * 10U + (uint32_t)(*s - '0');
+                uScale += bFraction ? 1U : 0U;
+            } else if (false == bFraction) {
+                ++uDropped;
+            }
+        } else {
+            return false;
+        }
+        s++;
+    }
+
+    /* a digit is dropped only after 9 of them, beyond 10^38 the value is above FLT_MAX */
+    const int iExp10 = (int)uDropped - (int)uScale;
+    if (iExp10 > uSHELL_FLOAT_POW10_MAX) {
+        return false;
+    }
+
+#if (1 == uSHELL_FLOAT_HW)
+    /* the powers rounded once by the compiler (exact up to 10^10), one multiplication or division */
+    static const numfp_t vfPow10[uSHELL_FLOAT_POW10_MAX + 1] = {
+        1.0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f,
+        1e10f, 1e11f, 1e12f, 1e13f, 1e14f, 1e15f, 1e16f, 1e17f, 1e18f, 1e19f,
+        1e20f, 1e21f, 1e22f, 1e23f, 1e24f, 1e25f, 1e26f, 1e27f, 1e28f, 1e29f,
+        1e30f, 1e31f, 1e32f, 1e33f, 1e34f, 1e35f, 1e36f, 1e37f, 1e38f
+    };
+    const numfp_t fptMantissa = (numfp_t)u32Mantissa;
+    const numfp_t fptValue = (iExp10 < 0) ? (fptMantissa / vfPow10[-iExp10]) : (fptMantissa * vfPow10[iExp10]);
+    if (!(fptValue <= (numfp_t)3.40282347e+38f)) {
+        return false;
+    }
+    *pFloatTypeVar = bNegative ? -fptValue : fptValue;
+    return true;
+#else
+    return float_from_decimal(u32Mantissa, iExp10, bNegative, pFloatTypeVar);
+#endif /* (1 == uSHELL_FLOAT_HW) */
+}
+#endif /* uSHELL_IMPLEMENTS_NUMBERS_FLOAT */
+
+/*----------------------------------------------------------------------------*/
+int dump(BIGNUM_T address, num32_t length, bool show_address) {
+#define uSHELL_DUMP_ELEM_PER_LINE (16)
+
+#if defined(__GNUC__) && defined(__AVR__)
+    char *p = (char *)((int)address);
+#else
+    char *p = (char *)address;
+#endif
+
+    if (!p) {
+        return 0;
+    }
+
+    int nr_lines = length / uSHELL_DUMP_ELEM_PER_LINE;
+    int last_line_len = length % uSHELL_DUMP_ELEM_PER_LINE;
+    if (last_line_len)
+        nr_lines++;
+
+    for (int i = 0; i < nr_lines; ++i) {
+        int index = i * uSHELL_DUMP_ELEM_PER_LINE;
+        if (show_address)
+            uSHELL_PRINTF("%p | ", (p + index));
+
+        for (int k = 0; k < 2; ++k) {
+            for (int j = 0; j < uSHELL_DUMP_ELEM_PER_LINE; ++j) {
+                unsigned char crt_byte = *(p + index + j);
+                if ((i == nr_lines - 1) && last_line_len && j >= last_line_len)
+                    uSHELL_PRINTF((k == 0) ? "   " : " ");
+                else
+                    uSHELL_PRINTF("%c", uSHELL_ISPRINT(crt_byte) ? crt_byte : '.');
+            }
+            uSHELL_PRINTF(" | ");
+        }
+        uSHELL_PRINTF("\n");
+    }
+    return length;
+}
+
+#if (1 == uSHELL_IMPLEMENTS_HEXLIFY)
+#if (defined(_MSC_VER) || (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)))
+#define uSHELL_HEX_LITTLE_ENDIAN
+#endif /* little endian */
+
+/* the two characters of every byte, as they are stored (high digit at the lower address) */
+struct hexPairs_s {
+    uint16_t vu16Pair[256];
+};
+
+static constexpr hexPairs_s hex_build_pairs(void) {
+    const char vcDigits[] = "0123456789ABCDEF";
+    hexPairs_s sTable{};
+    for (int i = 0; i < 256; ++i) {
+        const uint16_t u16High = (uint16_t)(uint8_t)vcDigits[i >> 4];
+        const uint16_t u16Low = (uint16_t)(uint8_t)vcDigits[i & 0x0F];
+#if defined(uSHELL_HEX_LITTLE_ENDIAN)
+        sTable.vu16Pair[i] = (uint16_t)(u16High | (u16Low << 8));
+#else
+        sTable.vu16Pair[i] = (uint16_t)((u16High << 8) | u16Low);
+#endif /* defined(uSHELL_HEX_LITTLE_ENDIAN) */
+    }
+    return sTable;
+}
+
+static constexpr hexPairs_s s_sHexPairs = hex_build_pairs();
+
+/* high bit of every byte of u32Word (all bytes < 0x80) which lies in [u8Low, u8High] */
+static inline uint32_t hex_swar_in_range(uint32_t u32Word, uint8_t u8Low, uint8_t u8High) {
+    const uint32_t u32Above = u32Word + (0x80808080U - (0x01010101U * u8Low));
+    const uint32_t u32Past = u32Word + (0x80808080U - (0x01010101U * (uint32_t)(u8High + 1U)));
+    return u32Above & ~u32Past & 0x80808080U;
+}
+
+/* four hex characters (the first in the low byte) to two bytes (the first in the low byte), false if one is not hex */
+static inline bool hex_swar_decode(uint32_t u32Chars, uint32_t *pu32Bytes) {
+    if (0U != (u32Chars & 0x80808080U)) {
+        return false;
+    }
+    const uint32_t u32Digit = hex_swar_in_range(u32Chars, '0', '9');
+    const uint32_t u32Alpha = hex_swar_in_range(u32Chars | 0x20202020U, 'a', 'f');
+    if (0x80808080U != (u32Digit | u32Alpha)) {
+        return false;
+    }
+    /* '0'..'9' -> 0..9, 'a'..'f' / 'A'..'F' -> 1..6 + 9 */
+    const uint32_t u32Nibbles = (u32Chars & 0x0F0F0F0FU) + ((u32Alpha >> 7) * 9U);
+    const uint32_t u32Pairs = ((u32Nibbles & 0x000F000FU) << 4) | ((u32Nibbles >> 8) & 0x000F000FU);
+    *pu32Bytes = (u32Pairs & 0xFFU) | ((u32Pairs >> 8) & 0xFF00U);
+    return true;
+}
+
+static inline uint32_t hex_load4(const char *pc) {
+    return (uint32_t)(uint8_t)pc[0] | ((uint32_t)(uint8_t)pc[1] << 8) | ((uint32_t)(uint8_t)pc[2] << 16) | ((uint32_t)(uint8_t)pc[3] << 24);
+}
+
+/* one byte from two characters, -1 if one is not hex */
+static inline int hex_decode_pair(const char *pc) {
+    uint32_t u32Bytes = 0U;
+    /* the pair is repeated to fill the word, only the low byte of the result is used */
+    const uint32_t u32Pair = (uint32_t)(uint8_t)pc[0] | ((uint32_t)(uint8_t)pc[1] << 8);
+    return hex_swar_decode(u32Pair | (u32Pair << 16), &u32Bytes) ? (int)(u32Bytes & 0xFFU) : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+size_t hexlify_chunk(const uint8_t *bytes, size_t length, char *output) {
+    const uint16_t *pu16Pairs = s_sHexPairs.vu16Pair;
+    size_t i = 0;
+    for (; (i + 4U) <= length; i += 4U) {
+#if defined(uSHELL_HEX_LITTLE_ENDIAN)
+        const uint32_t u32First = (uint32_t)pu16Pairs[bytes[i]] | ((uint32_t)pu16Pairs[bytes[i + 1U]] << 16);
+        const uint32_t u32Second = (uint32_t)pu16Pairs[bytes[i + 2U]] | ((uint32_t)pu16Pairs[bytes[i + 3U]] << 16);
+#else
+        const uint32_t u32First = ((uint32_t)pu16Pairs[bytes[i]] << 16) | (uint32_t)pu16Pairs[bytes[i + 1U]];
+        const uint32_t u32Second = ((uint32_t)pu16Pairs[bytes[i + 2U]] << 16) | (uint32_t)pu16Pairs[bytes[i + 3U]];
+#endif /* defined(uSHELL_HEX_LITTLE_ENDIAN) */
+        memcpy(&output[i * 2U], &u32First, sizeof(u32First));
+        memcpy(&output[(i * 2U) + 4U], &u32Second, sizeof(u32Second));
+    }
+    for (; i < length; ++i) {
+        memcpy(&output[i * 2U], &pu16Pairs[bytes[i]], sizeof(uint16_t));
+    }
+    return length * 2U;
+}
+
+/*----------------------------------------------------------------------------*/
+void hexlify(const uint8_t *bytes, size_t length, char *output) {
+    output[hexlify_chunk(bytes, length, output)] = '\0'; // Null-terminate the string
+}
+
+/*----------------------------------------------------------------------------*/
+/* szPairs bytes from 2 * szPairs characters, 8 characters per round */
+static bool hex_decode(const char *hexstr, size_t szPairs, uint8_t *output) {
+    size_t i = 0;
+    for (; (i + 4U) <= szPairs; i += 4U) {
+        uint32_t u32Low = 0U;
+        uint32_t u32High = 0U;
+        if ((false == hex_swar_decode(hex_load4(&hexstr[i * 2U]), &u32Low)) ||
+            (false == hex_swar_decode(hex_load4(&hexstr[(i * 2U) + 4U]), &u32High))) {
+            return false;
+        }
+        output[i] = (uint8_t)u32Low;
+        output[i + 1U] = (uint8_t)(u32Low >> 8);
+        output[i + 2U] = (uint8_t)u32High;
+        output[i + 3U] = (uint8_t)(u32High >> 8);
+    }
+    for (; i < szPairs; ++i) {
+        const int iByte = hex_decode_pair(&hexstr[i * 2U]);
+        if (iByte < 0) {
+            return false;
+        }
+        output[i] = (uint8_t)iByte;
+    }
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool unhexlify(const char *hexstr, uint8_t *output, size_t *out_len) {
+    const size_t len = strlen(hexstr);
+
+    // Must be even length
+    if (len % 2 != 0) {
+        return false;
+    }
+
+    *out_len = len / 2;
+    return hex_decode(hexstr, *out_len, output);
+}
+
+/*----------------------------------------------------------------------------*/
+/* the bytes over the digits: byte i is stored after the digits 2 * i .. 2 * i + 7 are read, every
+   write is behind the reads still to come */
+bool unhexlify_inplace(char *hexstr, size_t length, size_t *out_len) {
+    if ((0 == length) || (0 != (length % 2))) {
+        return false;
+    }
+
+    *out_len = length / 2;
+    return hex_decode(hexstr, *out_len, (uint8_t *)hexstr);
+}
+
+/*----------------------------------------------------------------------------*/
+void unhexlify_stream_init(unhexlifyStream_s *psStream) {
+    psStream->cPending = '\0';
+    psStream->bPending = false;
+}
+
+/*----------------------------------------------------------------------------*/
+bool unhexlify_chunk(unhexlifyStream_s *psStream, const char *hexstr, size_t length, uint8_t *output, size_t *out_len) {
+    size_t szBytes = 0;
+
+    /* the character left by the previous chunk pairs with the first one of this chunk */
+    if ((true == psStream->bPending) && (length > 0)) {
+        const char vcPair[2] = { psStream->cPending, hexstr[0] };
+        const int iByte = hex_decode_pair(vcPair);
+        if (iByte < 0) {
+            return false;
+        }
+        output[szBytes++] = (uint8_t)iByte;
+        psStream->bPending = false;
+        ++hexstr;
+        --length;
+    }
+    if (false == hex_decode(hexstr, length / 2, &output[szBytes])) {
+        return false;
+    }
+    szBytes += length / 2;
+    if (0 != (length % 2)) {
+        psStream->cPending = hexstr[length - 1];
+        psStream->bPending = true;
+    }
+    *out_len = szBytes;
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool unhexlify_stream_end(const unhexlifyStream_s *psStream) {
+    return (false == psStream->bPending);
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_HEXLIFY) */
+
+/*----------------------------------------------------------------------------*/
+char *trim_whitespace_inplace(char *str) {
+    if (!str)
+        return str;
+
+    // Trim leading whitespace
+    while (*str && isspace((unsigned char)*str)) {
+        str++;
+    }
+
+    // Trim trailing whitespace (null terminate)
+    char *end = str + strlen(str) - 1;
+    while (end > str && isspace((unsigned char)*end)) {
+        *end = '\0';
+        end--;
+    }
+
+    return str;
+}
+
+/*----------------------------------------------------------------------------*/
+bool strings_equal_trimmed(const char *s1, const char *s2) {
+    // Skip leading whitespace
+    while (*s1 && isspace((unsigned char)*s1))
+        s1++;
+    while (*s2 && isspace((unsigned char)*s2))
+        s2++;
+
+    // Compare content
+    while (*s1 && *s2) {
+        if (*s1 != *s2)
+            return false;
+        s1++;
+        s2++;
+    }
+
+    // Skip trailing whitespace
+    while (*s1 && isspace((unsigned char)*s1))
+        s1++;
+    while (*s2 && isspace((unsigned char)*s2))
+        s2++;
+
+    return (*s1 == '\0' && *s2 == '\0');
+}
+
+/*----------------------------------------------------------------------------*/
+void trim_whitespace(const char *input, char *output, size_t output_size) {
+    if (output_size == 0)
+        return;
+
+    // Skip leading whitespace
+    while (*input && isspace((unsigned char)*input)) {
+        input++;
+    }
+
+    // Copy string
+    size_t len = 0;
+    while (*input && len < output_size - 1) {
+        output[len++] = *input++;
+    }
+    output[len] = '\0';
+
+    // Remove trailing whitespace
+    while (len > 0 && isspace((unsigned char)output[len - 1])) {
+        output[--len] = '\0';
+    }
+}
+
+#if (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA)
+/*----------------------------------------------------------------------------*/
+void *ushell_scratch_alloc(scratchArena_s *psArena, size_t szSize) {
+    const size_t szAligned = (psArena->szUsed + (uSHELL_SCRATCH_ARENA_ALIGN - 1U)) & ~(size_t)(uSHELL_SCRATCH_ARENA_ALIGN - 1U);
+
+    if ((0U == szSize) || (szAligned > psArena->szSize) || (szSize > (psArena->szSize - szAligned))) {
+        return nullptr;
+    }
+    psArena->szUsed = szAligned + szSize;
+    if (psArena->szUsed > psArena->szPeak) {
+        psArena->szPeak = psArena->szUsed;
+    }
+    return psArena->pu8Base + szAligned;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_SCRATCH_ARENA) */
+
+#if (1 == uSHELL_IMPLEMENTS_BINARY_MODE)
+/*----------------------------------------------------------------------------*/
+uint16_t crc16_ccitt(uint16_t u16Crc, const uint8_t *pu8Data, size_t szLength) {
+    // CRC-16/CCITT-FALSE: poly 0x1021, start with 0xFFFF
+    while (szLength--) {
+        u16Crc ^= (uint16_t)(*pu8Data++) << 8;
+        for (int i = 0; i < 8; ++i) {
+            u16Crc = (u16Crc & 0x8000U) ? (uint16_t)((u16Crc << 1) ^ 0x1021U) : (uint16_t)(u16Crc << 1);
+        }
+    }
+    return u16Crc;
+}
+#endif /* (1 == uSHELL_IMPLEMENTS_BINARY_MODE) */
+
+uSHELL_NAMESPACE_END